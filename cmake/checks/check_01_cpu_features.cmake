@@ -1,6 +1,6 @@
 ## ---------------------------------------------------------------------
 ##
-## Copyright (C) 2012 - 2015 by the deal.II authors
+## Copyright (C) 2012 - 2017 by the deal.II authors
 ##
 ## This file is part of the deal.II library.
 ##
@@ -27,7 +27,10 @@
 #   DEAL_II_HAVE_SSE2                    *)
 #   DEAL_II_HAVE_AVX                     *)
 #   DEAL_II_HAVE_AVX512                  *)
+#   DEAL_II_HAVE_NEON                    *)
+#   DEAL_II_HAVE_VSX                     *)
 #   DEAL_II_COMPILER_VECTORIZATION_LEVEL
+#   DEAL_II_HAVE_BUILTIN_CPU_SUPPORTS
 #   DEAL_II_HAVE_OPENMP_SIMD             *)
 #   DEAL_II_OPENMP_SIMD_PRAGMA
 #
@@ -75,6 +78,8 @@ IF(DEAL_II_ALLOW_PLATFORM_INTROSPECTION)
     UNSET(DEAL_II_HAVE_SSE2 CACHE)
     UNSET(DEAL_II_HAVE_AVX CACHE)
     UNSET(DEAL_II_HAVE_AVX512 CACHE)
+    UNSET(DEAL_II_HAVE_NEON CACHE)
+    UNSET(DEAL_II_HAVE_VSX CACHE)
   ENDIF()
   SET(DEAL_II_CHECK_CPU_FEATURES_SAVED
     "${CMAKE_REQUIRED_FLAGS}" CACHE INTERNAL "" FORCE
@@ -207,19 +212,86 @@ IF(DEAL_II_ALLOW_PLATFORM_INTROSPECTION)
     }
     "
     DEAL_II_HAVE_AVX512)
+
+  #
+  # 128 bit vectorization on 64 bit ARM (NEON) and POWER (VSX) processors.
+  # These use the same vectorization level as SSE2.
+  #
+  CHECK_CXX_SOURCE_RUNS(
+    "
+    #if !defined(__ARM_NEON) || !defined(__aarch64__)
+    #error \"__ARM_NEON flag not set, no support for NEON\"
+    #endif
+    #include <arm_neon.h>
+    int main()
+    {
+    volatile double in[2] = {1.0, 2.25};
+    double out[2];
+    float64x2_t a = vld1q_f64 ((const double *)in);
+    float64x2_t b = vdupq_n_f64 (in[1]);
+    vst1q_f64 (out, vmulq_f64 (b, vaddq_f64 (a, b)));
+    if (out[0] != 7.3125 || out[1] != 10.125)
+      return 1;
+    return 0;
+    }
+    "
+    DEAL_II_HAVE_NEON)
+
+  CHECK_CXX_SOURCE_RUNS(
+    "
+    #ifndef __VSX__
+    #error \"__VSX__ flag not set, no support for VSX\"
+    #endif
+    #include <altivec.h>
+    #undef vector
+    #undef pixel
+    #undef bool
+    int main()
+    {
+    volatile double in[2] = {1.0, 2.25};
+    double out[2];
+    __vector double a = vec_xl (0, (const double *)in);
+    __vector double b = vec_splats (in[1]);
+    vec_xst (vec_mul (b, vec_add (a, b)), 0, out);
+    if (out[0] != 7.3125 || out[1] != 10.125)
+      return 1;
+    return 0;
+    }
+    "
+    DEAL_II_HAVE_VSX)
 ENDIF()
 
 IF(DEAL_II_HAVE_AVX512)
   SET(DEAL_II_COMPILER_VECTORIZATION_LEVEL 3)
 ELSEIF(DEAL_II_HAVE_AVX)
   SET(DEAL_II_COMPILER_VECTORIZATION_LEVEL 2)
-ELSEIF(DEAL_II_HAVE_SSE2)
+ELSEIF(DEAL_II_HAVE_SSE2 OR DEAL_II_HAVE_NEON OR DEAL_II_HAVE_VSX)
   SET(DEAL_II_COMPILER_VECTORIZATION_LEVEL 1)
 ELSE()
   SET(DEAL_II_COMPILER_VECTORIZATION_LEVEL 0)
 ENDIF()
 
 
+#
+# Check whether the compiler provides __builtin_cpu_supports to query the
+# instruction set extensions of the processor at run time. This is used to
+# check that the processor running a program supports the level of
+# vectorization deal.II was compiled for, see
+# Utilities::System::get_cpu_vectorization_level().
+#
+CHECK_CXX_SOURCE_COMPILES(
+  "
+  int main()
+  {
+    __builtin_cpu_init ();
+    return (__builtin_cpu_supports (\"sse2\") +
+            __builtin_cpu_supports (\"avx\") +
+            __builtin_cpu_supports (\"avx512f\"));
+  }
+  "
+  DEAL_II_HAVE_BUILTIN_CPU_SUPPORTS)
+
+
 #
 # OpenMP 4.0 can be used for vectorization (supported by gcc-4.9.1 and
 # later). Only the vectorization instructions
@@ -19,6 +19,8 @@
 #   DEAL_II_HAVE_GETHOSTNAME
 #   DEAL_II_HAVE_GETPID
 #   DEAL_II_HAVE_JN
+#   DEAL_II_HAVE_MADVISE
+#   DEAL_II_HAVE_NUMA_SYSCALLS
 #   DEAL_II_HAVE_SYS_RESOURCE_H
 #   DEAL_II_HAVE_UNISTD_H
 #   DEAL_II_MSVC
@@ -40,6 +42,27 @@ CHECK_INCLUDE_FILE_CXX("unistd.h" DEAL_II_HAVE_UNISTD_H)
 CHECK_CXX_SYMBOL_EXISTS("gethostname" "unistd.h" DEAL_II_HAVE_GETHOSTNAME)
 CHECK_CXX_SYMBOL_EXISTS("getpid" "unistd.h" DEAL_II_HAVE_GETPID)
 
+#
+# Check for the functions used to request transparent huge pages and an
+# interleaved placement of large memory blocks on the NUMA nodes. The
+# latter are called as system calls so that we do not need libnuma.
+#
+CHECK_CXX_SYMBOL_EXISTS("MADV_HUGEPAGE" "sys/mman.h" DEAL_II_HAVE_MADVISE)
+CHECK_CXX_SOURCE_COMPILES(
+  "
+  #include <linux/mempolicy.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+  int main()
+  {
+    unsigned long mask = 0;
+    syscall(SYS_get_mempolicy, (int *)0, &mask, 64, (void *)0, MPOL_F_MEMS_ALLOWED);
+    syscall(SYS_mbind, (void *)0, 0, MPOL_INTERLEAVE, &mask, 64, 0);
+    return 0;
+  }
+  "
+  DEAL_II_HAVE_NUMA_SYSCALLS)
+
 #
 # Do we have the Bessel function jn?
 #
@@ -1,6 +1,6 @@
 ## ---------------------------------------------------------------------
 ##
-## Copyright (C) 2012 - 2015 by the deal.II authors
+## Copyright (C) 2012 - 2017 by the deal.II authors
 ##
 ## This file is part of the deal.II library.
 ##
@@ -68,6 +68,35 @@ MACRO(FEATURE_TRILINOS_FIND_EXTERNAL var)
       ENDIF()
     ENDIF()
 
+    #
+    # Tpetra is optional. We use it with 64bit global indices, so the
+    # respective template instantiation has to be enabled in Trilinos:
+    #
+    SET(TRILINOS_WITH_TPETRA FALSE)
+    ITEM_MATCHES(_module_found Tpetra ${Trilinos_PACKAGE_LIST})
+    IF(_module_found)
+      DEAL_II_FIND_FILE(TPETRA_CONFIG_H TpetraCore_config.h
+        HINTS ${Trilinos_INCLUDE_DIRS}
+        NO_DEFAULT_PATH NO_CMAKE_ENVIRONMENT_PATH NO_CMAKE_PATH
+        NO_SYSTEM_ENVIRONMENT_PATH NO_CMAKE_SYSTEM_PATH NO_CMAKE_FIND_ROOT_PATH
+        )
+      IF(EXISTS ${TPETRA_CONFIG_H})
+        FILE(STRINGS "${TPETRA_CONFIG_H}" TPETRA_LONG_LONG_STRING
+          REGEX "#define HAVE_TPETRA_INST_INT_LONG_LONG")
+        IF(NOT "${TPETRA_LONG_LONG_STRING}" STREQUAL "")
+          SET(TRILINOS_WITH_TPETRA TRUE)
+        ENDIF()
+      ENDIF()
+      UNSET(TPETRA_CONFIG_H CACHE)
+    ENDIF()
+    IF(TRILINOS_WITH_TPETRA)
+      MESSAGE(STATUS "Found Tpetra")
+    ELSE()
+      MESSAGE(STATUS "Module Tpetra not found or not instantiated for "
+        "64bit global indices, disabling the Tpetra wrappers"
+        )
+    ENDIF()
+
     IF(NOT ${var})
       MESSAGE(STATUS "Could not find a sufficient Trilinos installation: "
         "Missing ${_modules_missing}"
@@ -196,6 +225,10 @@ MACRO(FEATURE_TRILINOS_CONFIGURE_EXTERNAL)
 
   IF (TRILINOS_WITH_MPI)
     SET(DEAL_II_EXPAND_EPETRA_VECTOR "LinearAlgebra::EpetraWrappers::Vector")
+
+    IF (TRILINOS_WITH_TPETRA)
+      SET(DEAL_II_TRILINOS_WITH_TPETRA TRUE)
+    ENDIF()
   ENDIF()
 ENDMACRO()
 
@@ -0,0 +1,26 @@
+## ---------------------------------------------------------------------
+##
+## Copyright (C) 2017 by the deal.II authors
+##
+## This file is part of the deal.II library.
+##
+## The deal.II library is free software; you can use it, redistribute
+## it, and/or modify it under the terms of the GNU Lesser General
+## Public License as published by the Free Software Foundation; either
+## version 2.1 of the License, or (at your option) any later version.
+## The full text of the license can be found in the file LICENSE at
+## the top level of the deal.II distribution.
+##
+## ---------------------------------------------------------------------
+
+#
+# Configuration for the LIKWID library:
+#
+
+#
+# The LIKWID marker regions add a small overhead to every instrumented
+# function. Therefore, disable the feature per default:
+#
+SET(DEAL_II_WITH_LIKWID FALSE CACHE BOOL "")
+
+CONFIGURE_FEATURE(LIKWID)
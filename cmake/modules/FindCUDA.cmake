@@ -1,6 +1,6 @@
 ## ---------------------------------------------------------------------
 ##
-## Copyright (C) 2014 - 2016 by the deal.II authors
+## Copyright (C) 2014 - 2017 by the deal.II authors
 ##
 ## This file is part of the deal.II library.
 ##
@@ -43,7 +43,7 @@ IF(CUDA_FOUND)
   MESSAGE(STATUS "Configured to use CUDA installation at ${CUDA_TOOLKIT_ROOT_DIR}")
 ENDIF()
 
-SET(_cuda_libraries ${CUDA_LIBRARIES})
+SET(_cuda_libraries ${CUDA_LIBRARIES} ${CUDA_cusparse_LIBRARY})
 SET(_cuda_include_dirs ${CUDA_INCLUDE_DIRS})
 DEAL_II_PACKAGE_HANDLE(CUDA
   LIBRARIES REQUIRED _cuda_libraries
@@ -0,0 +1,272 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_jacobian_free_inverse_h
+#define dealii_jacobian_free_inverse_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/lac/linear_operator.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_gmres.h>
+#include <deal.II/algorithms/operator.h>
+#include <deal.II/algorithms/any_data.h>
+
+#include <functional>
+
+DEAL_II_NAMESPACE_OPEN
+
+class ParameterHandler;
+
+namespace Algorithms
+{
+  /**
+   * An operator applying the inverse of the Jacobian of a nonlinear residual
+   * without ever assembling the Jacobian, to be used as the
+   * <tt>inverse_derivative</tt> of Newton. This turns Newton into a
+   * Jacobian-free Newton-Krylov method: the linear system of each Newton
+   * step is solved with SolverGMRES, whose products with the Jacobian are
+   * computed as finite differences of the residual,
+   * @f[
+   *   J(u) v \approx \frac{F(u+hv) - F(u)}{h},
+   *   \qquad h = \epsilon \frac{1+\|u\|}{\|v\|},
+   * @f]
+   * or by a user supplied function computing the directional derivative,
+   * e.g. with automatic differentiation, see set_directional_derivative().
+   *
+   * The relative tolerance of GMRES is chosen by the forcing terms of
+   * Eisenstat and Walker (choice 2): the linear system of step $k$ is
+   * solved to the relative accuracy
+   * $\eta_k = \gamma (\|F(u_k)\|/\|F(u_{k-1})\|)^\alpha$, which is
+   * safeguarded against a too rapid decrease and limited to
+   * $\eta_{\max}$. Thus, the linear systems are only solved accurately
+   * once Newton converges quadratically. The absolute tolerance and the
+   * maximal number of iterations are taken from #control.
+   *
+   * The preconditioner given to set_preconditioner() is only set up anew
+   * when the event Algorithms::bad_derivative or Algorithms::initial is
+   * received. Since Newton raises bad_derivative only when the residual
+   * reduction falls behind the <tt>Assemble threshold</tt>, the
+   * preconditioner is lagged over several Newton steps, like the Jacobian
+   * in the classical variant.
+   *
+   * @code
+   *   ResidualOperator residual;
+   *   Algorithms::JacobianFreeInverse<Vector<double> > inverse (residual);
+   *   inverse.set_preconditioner (linear_operator(preconditioner),
+   *                               [&](const Vector<double> &u)
+   *                               {
+   *                                 assemble_approximate_jacobian(u);
+   *                                 preconditioner.initialize(approximate_jacobian);
+   *                               });
+   *   Algorithms::Newton<Vector<double> > newton (residual, inverse);
+   *   newton.threshold (0.1);
+   * @endcode
+   *
+   * When called by Newton, the residual operator is evaluated at the
+   * perturbed iterates by prepending a vector <tt>"Newton iterate"</tt> to
+   * the AnyData <tt>in</tt> given to this operator, which shadows the
+   * actual iterate for all accesses by name.
+   *
+   * The function solve() provides the same functionality outside of the
+   * Algorithms framework. Together with the constructor taking a residual
+   * function, it can be plugged into SUNDIALS::KINSOL:
+   * @code
+   *   SUNDIALS::KINSOL<VectorType> kinsol (data);
+   *   kinsol.residual = ...;
+   *   Algorithms::JacobianFreeInverse<VectorType> inverse (kinsol.residual);
+   *   kinsol.setup_jacobian = [&](const VectorType &, const VectorType &)
+   *   {
+   *     inverse.notify (Algorithms::Events::bad_derivative);
+   *     return 0;
+   *   };
+   *   kinsol.solve_jacobian_system = [&](const VectorType &u, const VectorType &f,
+   *                                      const VectorType &rhs, VectorType &dst)
+   *   {
+   *     inverse.solve (u, f, rhs, dst);
+   *     return 0;
+   *   };
+   * @endcode
+   */
+  template <typename VectorType>
+  class JacobianFreeInverse : public OperatorBase
+  {
+  public:
+    /**
+     * Constructor, receiving the operator computing the residual that is
+     * also used by Newton.
+     */
+    JacobianFreeInverse (OperatorBase &residual);
+
+    /**
+     * Constructor, receiving a function that computes the residual
+     * <tt>dst</tt> $=F($<tt>src</tt>$)$, with the same signature as
+     * SUNDIALS::KINSOL::residual. A nonzero return value is treated as an
+     * error.
+     */
+    JacobianFreeInverse (const std::function<int (const VectorType &src,
+                                                  VectorType       &dst)> &residual);
+
+    /**
+     * Declare the parameters of the linear solver and the forcing terms.
+     */
+    static void declare_parameters (ParameterHandler &param);
+
+    /**
+     * Read the parameters in the ParameterHandler.
+     */
+    void parse_parameters (ParameterHandler &param);
+
+    /**
+     * Set the preconditioner used by GMRES. The function @p setup is called
+     * with the current Newton iterate before the next linear solve whenever
+     * the preconditioner needs to be updated, see the class documentation.
+     */
+    void set_preconditioner (const LinearOperator<VectorType,VectorType> &preconditioner,
+                             const std::function<void (const VectorType &u)> &setup
+                             = std::function<void (const VectorType &)>());
+
+    /**
+     * Compute the products with the Jacobian by the given function
+     * rather than by finite differences. The function is called with the
+     * arguments <tt>(dst, u, v)</tt> and needs to set <tt>dst</tt> to the
+     * derivative of the residual at <tt>u</tt> in direction <tt>v</tt>.
+     */
+    void set_directional_derivative (const std::function<void (VectorType       &dst,
+                                                               const VectorType &u,
+                                                               const VectorType &v)> &derivative);
+
+    /**
+     * Solve the Newton system for the update. Reads the vectors
+     * <tt>"Newton residual"</tt> and <tt>"Newton iterate"</tt> from @p in
+     * and writes the result to the first vector of @p out.
+     */
+    virtual void operator() (AnyData &out, const AnyData &in);
+
+    /**
+     * Mark the preconditioner for an update with the events
+     * Algorithms::bad_derivative and Algorithms::initial, and restart the
+     * sequence of forcing terms with Algorithms::initial,
+     * Algorithms::new_time, and Algorithms::new_timestep_size.
+     */
+    virtual void notify (const Event &);
+
+    /**
+     * Solve $J(u)$ <tt>dst</tt> $=$ <tt>rhs</tt> with the forcing term of
+     * the current Newton step, where @p f is the residual at @p u. The
+     * residual is evaluated without additional data, i.e., this function
+     * can only be called on objects not constructed from an OperatorBase
+     * that relies on data from the AnyData argument. Throws
+     * SolverControl::NoConvergence if GMRES does not converge.
+     */
+    void solve (const VectorType &u,
+                const VectorType &f,
+                const VectorType &rhs,
+                VectorType       &dst);
+
+    /**
+     * Control object for GMRES. The reduction is overwritten by the forcing
+     * term of each solve.
+     */
+    ReductionControl control;
+
+    /**
+     * Additional data of GMRES. Right preconditioning is used by default,
+     * which makes the residual norm checked by GMRES match the residual of
+     * the Newton system.
+     */
+    typename SolverGMRES<VectorType>::AdditionalData additional_data;
+
+    /**
+     * The relative size $\epsilon$ of the finite difference step. The
+     * default is the square root of the machine accuracy.
+     */
+    double difference_step;
+
+    /**
+     * The factor $\gamma$ of the forcing terms.
+     */
+    double forcing_gamma;
+
+    /**
+     * The exponent $\alpha$ of the forcing terms.
+     */
+    double forcing_alpha;
+
+    /**
+     * The maximal forcing term $\eta_{\max}$, also used for the first step.
+     */
+    double forcing_max;
+
+  private:
+    /**
+     * Evaluate the residual at @p u into @p dst, forwarding @p in to the
+     * residual operator if there is one.
+     */
+    void evaluate_residual (const VectorType &u,
+                            const AnyData    &in,
+                            VectorType       &dst);
+
+    /**
+     * The implementation of solve() with the additional data for the
+     * residual operator.
+     */
+    void solve (const VectorType &u,
+                const VectorType &f,
+                const VectorType &rhs,
+                const AnyData    &in,
+                VectorType       &dst);
+
+    /**
+     * The operator computing the residual, if given.
+     */
+    SmartPointer<OperatorBase, JacobianFreeInverse<VectorType> > residual;
+
+    /**
+     * The function computing the residual, if given.
+     */
+    std::function<int (const VectorType &, VectorType &)> residual_function;
+
+    /**
+     * The function computing the directional derivative, if given.
+     */
+    std::function<void (VectorType &, const VectorType &, const VectorType &)> directional_derivative;
+
+    /**
+     * The preconditioner and the function setting it up. The flag
+     * indicates whether a preconditioner has been given.
+     */
+    LinearOperator<VectorType,VectorType> preconditioner;
+    std::function<void (const VectorType &)> setup_preconditioner;
+    bool use_preconditioner;
+
+    /**
+     * Whether the preconditioner needs to be set up before the next solve.
+     */
+    bool preconditioner_outdated;
+
+    /**
+     * The residual norm and the forcing term of the previous Newton step,
+     * or zero at the start of a sequence.
+     */
+    double last_residual_norm;
+    double last_forcing;
+  };
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,285 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_jacobian_free_inverse_templates_h
+#define dealii_jacobian_free_inverse_templates_h
+
+
+#include <deal.II/algorithms/jacobian_free_inverse.h>
+
+#include <deal.II/base/parameter_handler.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/vector_memory.h>
+
+#include <cmath>
+#include <limits>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Algorithms
+{
+  template <typename VectorType>
+  JacobianFreeInverse<VectorType>::JacobianFreeInverse (OperatorBase &residual)
+    :
+    additional_data (30, true),
+    difference_step (std::sqrt(std::numeric_limits<double>::epsilon())),
+    forcing_gamma (0.9),
+    forcing_alpha (2.),
+    forcing_max (0.9),
+    residual (&residual),
+    use_preconditioner (false),
+    preconditioner_outdated (true),
+    last_residual_norm (0.),
+    last_forcing (0.)
+  {}
+
+
+
+  template <typename VectorType>
+  JacobianFreeInverse<VectorType>::JacobianFreeInverse
+  (const std::function<int (const VectorType &, VectorType &)> &residual)
+    :
+    additional_data (30, true),
+    difference_step (std::sqrt(std::numeric_limits<double>::epsilon())),
+    forcing_gamma (0.9),
+    forcing_alpha (2.),
+    forcing_max (0.9),
+    residual_function (residual),
+    use_preconditioner (false),
+    preconditioner_outdated (true),
+    last_residual_norm (0.),
+    last_forcing (0.)
+  {}
+
+
+
+  template <typename VectorType>
+  void
+  JacobianFreeInverse<VectorType>::declare_parameters (ParameterHandler &param)
+  {
+    param.enter_subsection("Jacobian-free inverse");
+    ReductionControl::declare_parameters (param);
+    param.declare_entry("Basis size", "30", Patterns::Integer(1));
+    param.declare_entry("Difference step", "1.5e-8", Patterns::Double(0.));
+    param.declare_entry("Forcing gamma", "0.9", Patterns::Double(0.,1.));
+    param.declare_entry("Forcing alpha", "2.", Patterns::Double(1.,2.));
+    param.declare_entry("Forcing maximum", "0.9", Patterns::Double(0.,1.));
+    param.leave_subsection();
+  }
+
+
+
+  template <typename VectorType>
+  void
+  JacobianFreeInverse<VectorType>::parse_parameters (ParameterHandler &param)
+  {
+    param.enter_subsection("Jacobian-free inverse");
+    control.parse_parameters (param);
+    additional_data.max_n_tmp_vectors = param.get_integer("Basis size") + 2;
+    difference_step = param.get_double("Difference step");
+    forcing_gamma = param.get_double("Forcing gamma");
+    forcing_alpha = param.get_double("Forcing alpha");
+    forcing_max = param.get_double("Forcing maximum");
+    param.leave_subsection ();
+  }
+
+
+
+  template <typename VectorType>
+  void
+  JacobianFreeInverse<VectorType>::set_preconditioner
+  (const LinearOperator<VectorType,VectorType> &preconditioner,
+   const std::function<void (const VectorType &)> &setup)
+  {
+    this->preconditioner = preconditioner;
+    setup_preconditioner = setup;
+    use_preconditioner = true;
+    preconditioner_outdated = true;
+  }
+
+
+
+  template <typename VectorType>
+  void
+  JacobianFreeInverse<VectorType>::set_directional_derivative
+  (const std::function<void (VectorType &, const VectorType &, const VectorType &)> &derivative)
+  {
+    directional_derivative = derivative;
+  }
+
+
+
+  template <typename VectorType>
+  void
+  JacobianFreeInverse<VectorType>::notify (const Event &e)
+  {
+    if (e.test(Events::bad_derivative) || e.test(Events::initial))
+      preconditioner_outdated = true;
+    if (e.test(Events::initial) || e.test(Events::new_time) ||
+        e.test(Events::new_timestep_size))
+      {
+        last_residual_norm = 0.;
+        last_forcing = 0.;
+      }
+  }
+
+
+
+  template <typename VectorType>
+  void
+  JacobianFreeInverse<VectorType>::evaluate_residual (const VectorType &u,
+                                                      const AnyData    &in,
+                                                      VectorType       &dst)
+  {
+    if (residual != nullptr)
+      {
+        // the name lookup of AnyData finds the first entry, so the
+        // perturbed iterate shadows the one in 'in'
+        AnyData src;
+        src.add<const VectorType *>(&u, "Newton iterate");
+        src.merge(in);
+        AnyData out;
+        out.add<VectorType *>(&dst, "Residual");
+        (*residual)(out, src);
+      }
+    else
+      {
+        const int err = residual_function(u, dst);
+        AssertThrow (err == 0,
+                     ExcMessage("The residual function returned an error"));
+        (void)err;
+      }
+  }
+
+
+
+  template <typename VectorType>
+  void
+  JacobianFreeInverse<VectorType>::operator() (AnyData &out, const AnyData &in)
+  {
+    LogStream::Prefix prefix("JFNK");
+    VectorType &dst = *out.entry<VectorType *>(0);
+    const VectorType &f = *in.read_ptr<VectorType>("Newton residual");
+    const VectorType &u = *in.read_ptr<VectorType>("Newton iterate");
+    solve (u, f, f, in, dst);
+  }
+
+
+
+  template <typename VectorType>
+  void
+  JacobianFreeInverse<VectorType>::solve (const VectorType &u,
+                                          const VectorType &f,
+                                          const VectorType &rhs,
+                                          VectorType       &dst)
+  {
+    solve (u, f, rhs, AnyData(), dst);
+  }
+
+
+
+  template <typename VectorType>
+  void
+  JacobianFreeInverse<VectorType>::solve (const VectorType &u,
+                                          const VectorType &f,
+                                          const VectorType &rhs,
+                                          const AnyData    &in,
+                                          VectorType       &dst)
+  {
+    if (preconditioner_outdated)
+      {
+        if (setup_preconditioner)
+          setup_preconditioner(u);
+        preconditioner_outdated = false;
+      }
+
+    // forcing term of Eisenstat and Walker, choice 2, with their safeguard
+    // against an oversolving of the first steps
+    const double residual_norm = f.l2_norm();
+    double forcing = forcing_max;
+    if (last_residual_norm > 0.)
+      {
+        forcing = forcing_gamma * std::pow(residual_norm/last_residual_norm,
+                                           forcing_alpha);
+        const double safeguard = forcing_gamma * std::pow(last_forcing, forcing_alpha);
+        if (safeguard > 0.1)
+          forcing = std::max(forcing, safeguard);
+        forcing = std::min(forcing, forcing_max);
+      }
+    last_residual_norm = residual_norm;
+    last_forcing = forcing;
+    control.set_reduction(forcing);
+    if (control.log_history())
+      deallog << "Forcing term: " << forcing << std::endl;
+
+    GrowingVectorMemory<VectorType> mem;
+    typename VectorMemory<VectorType>::Pointer perturbed(mem);
+    typename VectorMemory<VectorType>::Pointer perturbed_residual(mem);
+    perturbed->reinit(u, true);
+    perturbed_residual->reinit(u, true);
+    const double u_norm = u.l2_norm();
+
+    LinearOperator<VectorType,VectorType> jacobian;
+    jacobian.reinit_range_vector = [&u] (VectorType &v, const bool omit_zeroing_entries)
+    {
+      v.reinit(u, omit_zeroing_entries);
+    };
+    jacobian.reinit_domain_vector = jacobian.reinit_range_vector;
+    jacobian.vmult = [&] (VectorType &result, const VectorType &v)
+    {
+      if (directional_derivative)
+        {
+          directional_derivative(result, u, v);
+          return;
+        }
+
+      const double v_norm = v.l2_norm();
+      if (v_norm == 0.)
+        {
+          result = 0.;
+          return;
+        }
+      const double h = difference_step * (1. + u_norm) / v_norm;
+      *perturbed = u;
+      perturbed->add(h, v);
+      evaluate_residual(*perturbed, in, *perturbed_residual);
+      result = *perturbed_residual;
+      result.add(-1., f);
+      result *= 1./h;
+    };
+    jacobian.vmult_add = [&] (VectorType &result, const VectorType &v)
+    {
+      typename VectorMemory<VectorType>::Pointer tmp(mem);
+      tmp->reinit(result, true);
+      jacobian.vmult(*tmp, v);
+      result += *tmp;
+    };
+
+    SolverGMRES<VectorType> solver (control, mem, additional_data);
+    dst = 0.;
+    if (use_preconditioner)
+      solver.solve(jacobian, dst, rhs, preconditioner);
+    else
+      solver.solve(jacobian, dst, rhs, PreconditionIdentity());
+  }
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
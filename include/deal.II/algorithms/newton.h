@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2010 - 2016 by the deal.II authors
+// Copyright (C) 2010 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -42,7 +42,11 @@ namespace Algorithms
    * costly, this method applies an adaptive reassembling strategy. Only if
    * the reduction factor for the residual is more than #threshold, the event
    * Algorithms::bad_derivative is submitted to #inverse_derivative. It is up
-   * to this object to implement reassembling accordingly.
+   * to this object to implement reassembling accordingly. If assembling the
+   * derivative is too expensive altogether, a JacobianFreeInverse can be
+   * used as #inverse_derivative, which solves the linear systems with GMRES
+   * on directional derivatives of #residual and uses this event to update
+   * its preconditioner.
    *
    * <h3>Contents of the AnyData objects</h3>
    *
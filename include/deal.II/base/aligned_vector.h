@@ -54,6 +54,10 @@ DEAL_II_NAMESPACE_OPEN
  * is a bit more memory-consuming than std::vector because of alignment, so it
  * is recommended to only use this vector on long vectors.
  *
+ * The memory is allocated by Utilities::System::posix_memalign(), so large
+ * vectors can be placed on huge pages or interleaved over the NUMA nodes of
+ * the machine with Utilities::System::set_memory_allocation_policy().
+ *
  * @p author Katharina Kormann, Martin Kronbichler, 2011
  */
 template < class T >
@@ -0,0 +1,499 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_base_bounding_box_tree_h
+#define dealii_base_bounding_box_tree_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/bounding_box.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/point.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * A static R-tree of axis-parallel bounding boxes, each associated with an
+ * object of type @p DataType, that allows to find all boxes containing a given
+ * point in logarithmic time.
+ *
+ * The tree is built once from a list of boxes with the sort-tile-recursive
+ * packing algorithm of S. T. Leutenegger, M. A. Lopez, J. Edgington, "STR: A
+ * simple and efficient algorithm for R-tree packing", Proceedings of the 13th
+ * International Conference on Data Engineering, pp. 497-506, 1997. The boxes
+ * are sorted into slabs along the coordinate directions by their centers and
+ * grouped into leaves of max_entries_per_node boxes, and the same is repeated
+ * on the bounding boxes of the groups until a single node remains. Since the
+ * tree is packed completely, all levels are stored as contiguous arrays
+ * without any pointers, which gives a small memory footprint and good cache
+ * behavior during queries.
+ *
+ * Small changes of the boxes, e.g. after refining a few cells of a mesh, can
+ * be applied without building the tree again: replace() puts a new box into
+ * the position of an existing entry and enlarges the boxes of the nodes above
+ * it, remove() masks an entry out of the results, and insert() adds an entry
+ * to a list of unsorted entries that is searched linearly in every query.
+ * Queries stay correct but become slower with every change, so the tree
+ * should be built again once n_unsorted_entries() has grown to a fraction of
+ * size().
+ *
+ * A typical use case is the location of points in a mesh, where the boxes
+ * are the bounding boxes of the cells and @p DataType is a cell iterator, see
+ * GridTools::Cache::get_cell_bounding_boxes_rtree().
+ */
+template <int spacedim, typename DataType = unsigned int, typename Number = double>
+class BoundingBoxTree
+{
+public:
+  /**
+   * The number of boxes grouped in a node of the tree.
+   */
+  static const unsigned int max_entries_per_node = 8;
+
+  /**
+   * Constructor. Create an empty tree.
+   */
+  BoundingBoxTree () = default;
+
+  /**
+   * Constructor. Build the tree from the given boxes, see build().
+   */
+  BoundingBoxTree (const std::vector<std::pair<BoundingBox<spacedim,Number>,DataType> > &entries);
+
+  /**
+   * Build the tree from the given list of boxes and associated data,
+   * replacing the current content.
+   */
+  void build (const std::vector<std::pair<BoundingBox<spacedim,Number>,DataType> > &entries);
+
+  /**
+   * Remove all entries.
+   */
+  void clear ();
+
+  /**
+   * Return the number of boxes stored in the tree, not counting the removed
+   * ones.
+   */
+  unsigned int size () const;
+
+  /**
+   * Return the number of positions of the tree, i.e., the number of boxes
+   * passed to build() plus the number of boxes added with insert(),
+   * including the removed ones. The positions number the boxes passed to
+   * build() in the order of the leaves of the tree, followed by the inserted
+   * ones, and do not change until the tree is built again.
+   */
+  unsigned int n_positions () const;
+
+  /**
+   * Return the data of the entry at position @p position.
+   */
+  const DataType &get_data (const unsigned int position) const;
+
+  /**
+   * Return whether the entry at position @p position has not been removed.
+   */
+  bool position_used (const unsigned int position) const;
+
+  /**
+   * Replace the box and the data of the entry at position @p position,
+   * which may have been removed before. The bounding boxes of the nodes
+   * above the entry are enlarged to contain the new box, but never shrunk.
+   */
+  void replace (const unsigned int                 position,
+                const BoundingBox<spacedim,Number> &box,
+                const DataType                     &data);
+
+  /**
+   * Remove the entry at position @p position, i.e., do not return it from
+   * queries anymore. The position can be reused with replace().
+   */
+  void remove (const unsigned int position);
+
+  /**
+   * Add an entry without building the tree again and return its position.
+   * The entry is not sorted into the tree, but searched linearly in every
+   * query.
+   */
+  unsigned int insert (const BoundingBox<spacedim,Number> &box,
+                       const DataType                     &data);
+
+  /**
+   * Return the number of positions added with insert() since the tree was
+   * built.
+   */
+  unsigned int n_unsorted_entries () const;
+
+  /**
+   * Fill @p results with the data of all boxes that contain the point @p p,
+   * including their boundary. The vector is cleared first, so that it can be
+   * reused for many queries without allocating memory.
+   */
+  void find_boxes_containing (const Point<spacedim,Number> &p,
+                              std::vector<DataType>        &results) const;
+
+  /**
+   * Return an estimate for the memory consumption, in bytes, of this object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * Sort the entries of @p order in the range [@p begin, @p end) into the
+   * tiles of the sort-tile-recursive algorithm, starting with the coordinate
+   * direction @p direction.
+   */
+  void sort_tiles (const std::vector<Point<spacedim,Number> > &centers,
+                   const unsigned int                          direction,
+                   const typename std::vector<unsigned int>::iterator &begin,
+                   const typename std::vector<unsigned int>::iterator &end) const;
+
+  /**
+   * Recursively descend into the children of the node @p node on level @p
+   * level.
+   */
+  void find_boxes_containing (const Point<spacedim,Number> &p,
+                              const unsigned int            level,
+                              const unsigned int            node,
+                              std::vector<DataType>        &results) const;
+
+  /**
+   * The boxes of all levels of the tree. Entry 0 holds the boxes passed to
+   * build() in the order of the leaves, followed by the boxes added with
+   * insert(), and entry $l$ the bounding boxes of groups of
+   * max_entries_per_node consecutive entries of level $l-1$. The last level
+   * contains at most max_entries_per_node boxes.
+   */
+  std::vector<std::vector<BoundingBox<spacedim,Number> > > levels;
+
+  /**
+   * The data associated with the boxes of level 0.
+   */
+  std::vector<DataType> data;
+
+  /**
+   * Whether the entries of level 0 have not been removed.
+   */
+  std::vector<bool> used;
+
+  /**
+   * The number of boxes passed to build(), i.e., the number of entries of
+   * level 0 that are sorted into the tree.
+   */
+  unsigned int n_sorted_entries = 0;
+
+  /**
+   * The number of entries that have not been removed.
+   */
+  unsigned int n_used_entries = 0;
+};
+
+
+/*---------------------- Inline functions: BoundingBoxTree ------------------*/
+
+#ifndef DOXYGEN
+
+template <int spacedim, typename DataType, typename Number>
+const unsigned int BoundingBoxTree<spacedim,DataType,Number>::max_entries_per_node;
+
+
+
+template <int spacedim, typename DataType, typename Number>
+inline
+BoundingBoxTree<spacedim,DataType,Number>::BoundingBoxTree
+(const std::vector<std::pair<BoundingBox<spacedim,Number>,DataType> > &entries)
+{
+  build(entries);
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+inline
+void
+BoundingBoxTree<spacedim,DataType,Number>::clear ()
+{
+  levels.clear();
+  data.clear();
+  used.clear();
+  n_sorted_entries = 0;
+  n_used_entries = 0;
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+inline
+unsigned int
+BoundingBoxTree<spacedim,DataType,Number>::size () const
+{
+  return n_used_entries;
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+inline
+unsigned int
+BoundingBoxTree<spacedim,DataType,Number>::n_positions () const
+{
+  return data.size();
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+inline
+const DataType &
+BoundingBoxTree<spacedim,DataType,Number>::get_data (const unsigned int position) const
+{
+  AssertIndexRange(position, data.size());
+  return data[position];
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+inline
+bool
+BoundingBoxTree<spacedim,DataType,Number>::position_used (const unsigned int position) const
+{
+  AssertIndexRange(position, used.size());
+  return used[position];
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+inline
+unsigned int
+BoundingBoxTree<spacedim,DataType,Number>::n_unsorted_entries () const
+{
+  return data.size() - n_sorted_entries;
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+void
+BoundingBoxTree<spacedim,DataType,Number>::replace
+(const unsigned int                 position,
+ const BoundingBox<spacedim,Number> &box,
+ const DataType                     &new_data)
+{
+  AssertIndexRange(position, data.size());
+  levels[0][position] = box;
+  data[position] = new_data;
+  if (used[position] == false)
+    {
+      used[position] = true;
+      ++n_used_entries;
+    }
+
+  // the node on level l above a sorted entry is the one with index
+  // position/max_entries_per_node^l
+  if (position < n_sorted_entries)
+    for (unsigned int l=1, node=position/max_entries_per_node; l<levels.size();
+         ++l, node/=max_entries_per_node)
+      levels[l][node].merge_with(box);
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+inline
+void
+BoundingBoxTree<spacedim,DataType,Number>::remove (const unsigned int position)
+{
+  AssertIndexRange(position, used.size());
+  if (used[position])
+    {
+      used[position] = false;
+      --n_used_entries;
+    }
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+unsigned int
+BoundingBoxTree<spacedim,DataType,Number>::insert
+(const BoundingBox<spacedim,Number> &box,
+ const DataType                     &new_data)
+{
+  if (levels.empty())
+    levels.resize(1);
+  levels[0].push_back(box);
+  data.push_back(new_data);
+  used.push_back(true);
+  ++n_used_entries;
+  return data.size() - 1;
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+void
+BoundingBoxTree<spacedim,DataType,Number>::sort_tiles
+(const std::vector<Point<spacedim,Number> >         &centers,
+ const unsigned int                                  direction,
+ const typename std::vector<unsigned int>::iterator &begin,
+ const typename std::vector<unsigned int>::iterator &end) const
+{
+  std::sort(begin, end, [&](const unsigned int a, const unsigned int b)
+  {
+    return centers[a][direction] < centers[b][direction];
+  });
+
+  const std::size_t n_entries = end - begin;
+  if (direction + 1 == spacedim || n_entries <= max_entries_per_node)
+    return;
+
+  // split into slabs of whole leaves such that each remaining direction
+  // gets the same number of subdivisions
+  const std::size_t n_leaves = (n_entries + max_entries_per_node - 1) /
+                               max_entries_per_node;
+  const std::size_t n_slabs =
+    static_cast<std::size_t>(std::ceil(std::pow(static_cast<double>(n_leaves),
+                                                1./(spacedim-direction))));
+  const std::size_t slab_size = max_entries_per_node *
+                                ((n_leaves + n_slabs - 1) / n_slabs);
+  for (std::size_t start = 0; start < n_entries; start += slab_size)
+    sort_tiles(centers, direction+1, begin+start,
+               begin+std::min(start+slab_size, n_entries));
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+void
+BoundingBoxTree<spacedim,DataType,Number>::build
+(const std::vector<std::pair<BoundingBox<spacedim,Number>,DataType> > &entries)
+{
+  clear();
+  if (entries.empty())
+    return;
+
+  std::vector<Point<spacedim,Number> > centers(entries.size());
+  for (unsigned int i=0; i<entries.size(); ++i)
+    {
+      const auto &points = entries[i].first.get_boundary_points();
+      centers[i] = points.first + points.second;
+    }
+
+  std::vector<unsigned int> order(entries.size());
+  for (unsigned int i=0; i<entries.size(); ++i)
+    order[i] = i;
+  sort_tiles(centers, 0, order.begin(), order.end());
+
+  levels.resize(1);
+  levels[0].reserve(entries.size());
+  data.reserve(entries.size());
+  for (unsigned int i=0; i<entries.size(); ++i)
+    {
+      levels[0].push_back(entries[order[i]].first);
+      data.push_back(entries[order[i]].second);
+    }
+  used.resize(entries.size(), true);
+  n_sorted_entries = entries.size();
+  n_used_entries = entries.size();
+
+  while (levels.back().size() > max_entries_per_node)
+    {
+      const std::vector<BoundingBox<spacedim,Number> > &children = levels.back();
+      std::vector<BoundingBox<spacedim,Number> > parents;
+      parents.reserve((children.size()+max_entries_per_node-1)/max_entries_per_node);
+      for (unsigned int i=0; i<children.size(); i+=max_entries_per_node)
+        {
+          parents.push_back(children[i]);
+          const unsigned int end = std::min<unsigned int>(i+max_entries_per_node,
+                                                          children.size());
+          for (unsigned int j=i+1; j<end; ++j)
+            parents.back().merge_with(children[j]);
+        }
+      levels.push_back(std::move(parents));
+    }
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+void
+BoundingBoxTree<spacedim,DataType,Number>::find_boxes_containing
+(const Point<spacedim,Number> &p,
+ const unsigned int            level,
+ const unsigned int            node,
+ std::vector<DataType>        &results) const
+{
+  const std::vector<BoundingBox<spacedim,Number> > &boxes = levels[level];
+  const unsigned int end = std::min<unsigned int>((node+1)*max_entries_per_node,
+                                                  level == 0 ?
+                                                  n_sorted_entries :
+                                                  boxes.size());
+  for (unsigned int i=node*max_entries_per_node; i<end; ++i)
+    if (boxes[i].point_inside(p))
+      {
+        if (level == 0)
+          {
+            if (used[i])
+              results.push_back(data[i]);
+          }
+        else
+          find_boxes_containing(p, level-1, i, results);
+      }
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+inline
+void
+BoundingBoxTree<spacedim,DataType,Number>::find_boxes_containing
+(const Point<spacedim,Number> &p,
+ std::vector<DataType>        &results) const
+{
+  results.clear();
+  if (n_sorted_entries > 0)
+    find_boxes_containing(p, levels.size()-1, 0, results);
+
+  for (unsigned int i=n_sorted_entries; i<data.size(); ++i)
+    if (used[i] && levels[0][i].point_inside(p))
+      results.push_back(data[i]);
+}
+
+
+
+template <int spacedim, typename DataType, typename Number>
+inline
+std::size_t
+BoundingBoxTree<spacedim,DataType,Number>::memory_consumption () const
+{
+  std::size_t memory = sizeof(*this);
+  for (unsigned int l=0; l<levels.size(); ++l)
+    memory += levels[l].capacity() * sizeof(BoundingBox<spacedim,Number>);
+  return memory + data.capacity() * sizeof(DataType) + used.capacity() / 8;
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
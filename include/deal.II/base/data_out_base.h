@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2016 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -1121,13 +1121,36 @@ namespace DataOutBase
      */
     ZlibCompressionLevel compression_level;
 
+    /**
+     * Flag determining whether the vertices of the patches that are at the
+     * same location are written only once to VTU files, with the values of
+     * the data fields taken from one of the patches sharing the vertex, see
+     * DataOutFilter. Since deal.II writes the corners of each cell
+     * separately in order to represent discontinuous fields, this reduces
+     * the number of points by up to a factor of <tt>2<sup>dim</sup></tt> for
+     * low subdivisions, but gives an output that does not faithfully
+     * represent discontinuous fields. The default is <tt>false</tt>.
+     */
+    bool filter_duplicate_vertices;
+
+    /**
+     * Flag determining whether the point coordinates and the data fields are
+     * written as <tt>Float32</tt> in VTU files, rather than as
+     * <tt>Float64</tt>, which halves the size of these parts of the file.
+     * Single precision is sufficient for visualization in most cases. The
+     * default is <tt>false</tt>.
+     */
+    bool single_precision;
+
     /**
      * Constructor.
      */
     VtkFlags (const double       time   = std::numeric_limits<double>::min(),
               const unsigned int cycle  = std::numeric_limits<unsigned int>::min(),
               const bool print_date_and_time = true,
-              const ZlibCompressionLevel compression_level = best_compression);
+              const ZlibCompressionLevel compression_level = best_compression,
+              const bool filter_duplicate_vertices = false,
+              const bool single_precision = false);
   };
 
 
@@ -1224,11 +1247,20 @@ namespace DataOutBase
      */
     bool xdmf_hdf5_output;
 
+    /**
+     * Whether the node coordinates and the data sets are stored as single
+     * precision numbers in HDF5 files, rather than with double precision.
+     * This halves the size of the files, and the XDMF entries created from
+     * the filter refer to the data accordingly.
+     */
+    bool single_precision;
+
     /**
      * Constructor.
      */
     DataOutFilterFlags (const bool filter_duplicate_vertices = false,
-                        const bool xdmf_hdf5_output = false);
+                        const bool xdmf_hdf5_output = false,
+                        const bool single_precision = false);
 
     /**
      * Declare all flags with name and type as offered by this class, for use
@@ -1345,6 +1377,14 @@ namespace DataOutBase
       vertices_per_cell (numbers::invalid_unsigned_int)
     {}
 
+    /**
+     * Return the flags this filter was set up with.
+     */
+    const DataOutBase::DataOutFilterFlags &get_flags() const
+    {
+      return flags;
+    };
+
     /**
      * Write a point with the specified index into the filtered data set. If
      * the point already exists and we are filtering redundant values, the
@@ -1443,6 +1483,75 @@ namespace DataOutBase
   };
 
 
+
+  /**
+   * Base class for handing the output data to an in-situ visualization or
+   * in-transit analysis framework (such as ParaView Catalyst or ADIOS2)
+   * instead of writing it to a file. The data of the patches are first
+   * converted into flat arrays of node coordinates, cell connectivity and
+   * nodal fields through a DataOutFilter, which are then passed to the
+   * execute() function of a derived class. The derived class can hand the
+   * arrays to the framework without further copies.
+   *
+   * Since in-situ processing is typically not needed in every time step,
+   * the adaptor only runs every @p output_interval steps, see
+   * is_output_step().
+   */
+  class InSituAdaptor
+  {
+  public:
+    /**
+     * Constructor. The data is passed to execute() in all steps that are
+     * divisible by @p output_interval. The given flags determine how the
+     * patches are converted into the flat arrays.
+     */
+    InSituAdaptor (const unsigned int        output_interval = 1,
+                   const DataOutFilterFlags &flags = DataOutFilterFlags(false, true));
+
+    /**
+     * Destructor.
+     */
+    virtual ~InSituAdaptor () = default;
+
+    /**
+     * Return whether the data of the given step is to be processed.
+     */
+    bool is_output_step (const unsigned int step) const;
+
+    /**
+     * Return the flags used for converting the patches into flat arrays.
+     */
+    const DataOutFilterFlags &get_filter_flags () const;
+
+    /**
+     * Process the data of one step. The array @p node_data contains the
+     * coordinates of the nodes, with 2 or 3 entries per node depending on
+     * the space dimension, and @p cell_data contains the node indices of
+     * each cell in the vertex order of the HDF5/XDMF output. The nodal
+     * fields can be accessed through DataOutFilter::get_data_set() of
+     * @p data_filter. All data are only valid during this call.
+     */
+    virtual
+    void
+    execute (const unsigned int               step,
+             const double                     time,
+             const DataOutFilter             &data_filter,
+             const std::vector<double>       &node_data,
+             const std::vector<unsigned int> &cell_data) = 0;
+
+  private:
+    /**
+     * The interval of steps in which the data is processed.
+     */
+    const unsigned int output_interval;
+
+    /**
+     * The flags for the conversion of the patches.
+     */
+    const DataOutFilterFlags flags;
+  };
+
+
   /**
    * Provide a data type specifying the presently supported output formats.
    */
@@ -1893,7 +2002,9 @@ namespace DataOutBase
    * DataOutInterface::get_dataset_names() and
    * DataOutInterface::get_vector_data_ranges() functions. The second argument
    * to this function specifies the names of the files that form the parallel
-   * set.
+   * set. The last argument has to be the flags the pieces were written with,
+   * such that the data types of the record match the ones of the pieces, see
+   * VtkFlags::single_precision.
    *
    * @note Use DataOutBase::write_vtu() and DataOutInterface::write_vtu()
    * for writing each piece. Also note that
@@ -1913,7 +2024,8 @@ namespace DataOutBase
   write_pvtu_record (std::ostream                                                                  &out,
                      const std::vector<std::string>                                                &piece_names,
                      const std::vector<std::string>                                                &data_names,
-                     const std::vector<std::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges);
+                     const std::vector<std::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
+                     const VtkFlags                                                                &flags = VtkFlags());
 
   /**
    * In ParaView it is possible to visualize time-dependent data tagged with
@@ -2143,6 +2255,32 @@ namespace DataOutBase
                             const std::string &solution_filename,
                             MPI_Comm comm);
 
+  /**
+   * Write the data in data_filter to HDF5 file(s), placing the mesh data and
+   * the solution values into the HDF5 groups @p mesh_group_name and
+   * @p solution_group_name, respectively. An empty group name refers to
+   * the root of the file. If a group name is given, the corresponding file
+   * is not overwritten but opened for appending if it already exists.
+   *
+   * This allows to write time series where the mesh is only stored once
+   * per mesh generation while each time step only appends its solution
+   * values, for example by passing <tt>write_mesh_file=true</tt> and a
+   * group name like "mesh_0" after each mesh change, and
+   * <tt>write_mesh_file=false</tt> with group names like "step_17" in all
+   * other time steps. Group names must not contain slashes. The XDMF
+   * entries referencing the data are created by
+   * DataOutInterface::create_xdmf_entry() with the same group names.
+   */
+  template <int dim, int spacedim>
+  void write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &patches,
+                            const DataOutFilter &data_filter,
+                            const bool write_mesh_file,
+                            const std::string &mesh_filename,
+                            const std::string &solution_filename,
+                            const std::string &mesh_group_name,
+                            const std::string &solution_group_name,
+                            MPI_Comm comm);
+
   /**
    * DataOutFilter is an intermediate data format that reduces the amount of
    * data that will be written to files. The object filled by this function
@@ -2155,6 +2293,19 @@ namespace DataOutBase
                             const std::vector<std::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
                             DataOutFilter &filtered_data);
 
+  /**
+   * Hand the data of the given patches to an in-situ adaptor, provided the
+   * adaptor is set to process the given step. See the InSituAdaptor class
+   * for more information.
+   */
+  template <int dim, int spacedim>
+  void write_in_situ (const std::vector<Patch<dim,spacedim> > &patches,
+                      const std::vector<std::string>          &data_names,
+                      const std::vector<std::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
+                      const unsigned int                       step,
+                      const double                             time,
+                      InSituAdaptor                           &adaptor);
+
   /**
    * Given an input stream that contains data written by
    * write_deal_II_intermediate(), determine the <tt>dim</tt> and
@@ -2464,6 +2615,45 @@ public:
   void write_vtu_in_parallel (const char *filename,
                               MPI_Comm comm) const;
 
+  /**
+   * Collective MPI call to write the solution from all processes in @p
+   * mpi_communicator into a set of @p n_groups VTU files in @p directory,
+   * together with a <code>.pvtu</code> record that lists them. This sits
+   * between writing one file per process, which creates a large number of
+   * files on big machines, and write_vtu_in_parallel(), where all processes
+   * write into the same file and contend for it on the parallel file system.
+   *
+   * The processes are split into @p n_groups groups of consecutive ranks,
+   * which usually corresponds to the processes on the same or on
+   * neighboring nodes. Each process compresses its own patches as in
+   * write_vtu(), and sends the result to the first process of its group.
+   * That process writes the file of the group as an ordinary stream, with
+   * one piece per process. It does not need to store more than one piece
+   * at a time.
+   *
+   * The files are named
+   * <code>directory/filename_without_extension_counter.group.vtu</code>,
+   * where @p counter is padded with leading zeros to @p n_digits_for_counter
+   * digits (no padding if left at its default value) and the group number
+   * is padded to the number of digits of the largest group number. The
+   * master record
+   * <code>directory/filename_without_extension_counter.pvtu</code> is
+   * written by the process with rank zero, and its name without @p
+   * directory is returned on all processes, e.g. for use in
+   * DataOutBase::write_pvd_record(). The @p directory must be empty or end
+   * with a slash.
+   *
+   * If @p n_groups is zero or larger than the number of processes, every
+   * process writes its own file.
+   */
+  std::string
+  write_vtu_with_pvtu_record (const std::string  &directory,
+                              const std::string  &filename_without_extension,
+                              const unsigned int  counter,
+                              const MPI_Comm     &mpi_communicator,
+                              const unsigned int  n_digits_for_counter = numbers::invalid_unsigned_int,
+                              const unsigned int  n_groups = 0) const;
+
   /**
    * Some visualization programs, such as ParaView, can read several separate
    * VTU files that all form part of the same simulation, in order to
@@ -2539,6 +2729,20 @@ public:
                                const double cur_time,
                                MPI_Comm comm) const;
 
+  /**
+   * Create an XDMFEntry based on the data in the data_filter. This assumes
+   * the mesh and solution data were written to the given groups of the
+   * respective files, see DataOutBase::write_hdf5_parallel(). Several
+   * entries of a time series can thus reference the same mesh data.
+   */
+  XDMFEntry create_xdmf_entry (const DataOutBase::DataOutFilter &data_filter,
+                               const std::string &h5_mesh_filename,
+                               const std::string &h5_solution_filename,
+                               const std::string &h5_mesh_group_name,
+                               const std::string &h5_solution_group_name,
+                               const double cur_time,
+                               MPI_Comm comm) const;
+
   /**
    * Write an XDMF file based on the provided vector of XDMFEntry objects.
    * Below is an example of how to use this function with HDF5 and the
@@ -2593,6 +2797,20 @@ public:
                             const std::string &solution_filename,
                             MPI_Comm comm) const;
 
+  /**
+   * Write the data in data_filter to the given groups of the HDF5 file(s),
+   * appending to existing files. See DataOutBase::write_hdf5_parallel() for
+   * a discussion of how to use this function for time series that reuse
+   * the mesh data.
+   */
+  void write_hdf5_parallel (const DataOutBase::DataOutFilter &data_filter,
+                            const bool write_mesh_file,
+                            const std::string &mesh_filename,
+                            const std::string &solution_filename,
+                            const std::string &mesh_group_name,
+                            const std::string &solution_group_name,
+                            MPI_Comm comm) const;
+
   /**
    * DataOutFilter is an intermediate data format that reduces the amount of
    * data that will be written to files. The object filled by this function
@@ -2601,6 +2819,16 @@ public:
    */
   void write_filtered_data (DataOutBase::DataOutFilter &filtered_data) const;
 
+  /**
+   * Hand the data of this object to an in-situ visualization or analysis
+   * framework through the given adaptor, rather than writing it to a file.
+   * Nothing is done if the adaptor is not set to process the given step.
+   * See DataOutBase::InSituAdaptor for more information.
+   */
+  void write_in_situ (DataOutBase::InSituAdaptor &adaptor,
+                      const unsigned int          step,
+                      const double                time) const;
+
 
   /**
    * Write data and grid to <tt>out</tt> according to the given data format.
@@ -3015,11 +3243,33 @@ public:
             const unsigned int dim,
             const unsigned int spacedim);
 
+  /**
+   * Constructor that sets all members to provided parameters, where the
+   * mesh and solution data are located in the given groups of the HDF5
+   * files. An empty group name refers to the root of the file.
+   */
+  XDMFEntry(const std::string &mesh_filename,
+            const std::string &solution_filename,
+            const std::string &mesh_group_name,
+            const std::string &solution_group_name,
+            const double time,
+            const unsigned int nodes,
+            const unsigned int cells,
+            const unsigned int dim,
+            const unsigned int spacedim);
+
   /**
    * Record an attribute and associated dimensionality.
    */
   void add_attribute(const std::string &attr_name, const unsigned int dimension);
 
+  /**
+   * Set the number of bytes of the floating point numbers of the node
+   * coordinates and attributes in the HDF5 file, 8 for double precision
+   * (the default) or 4 for single precision.
+   */
+  void set_precision(const unsigned int n_bytes);
+
   /**
    * Read or write the data of this object for serialization
    */
@@ -3029,11 +3279,14 @@ public:
     ar &valid
     &h5_sol_filename
     &h5_mesh_filename
+    &h5_sol_group_name
+    &h5_mesh_group_name
     &entry_time
     &num_nodes
     &num_cells
     &dimension
-    &attribute_dims;
+    &attribute_dims
+    &precision;
   }
 
   /**
@@ -3058,6 +3311,18 @@ private:
    */
   std::string h5_mesh_filename;
 
+  /**
+   * The HDF5 group within the solution file holding the solution data, or
+   * an empty string if the data are located at the root of the file.
+   */
+  std::string h5_sol_group_name;
+
+  /**
+   * The HDF5 group within the mesh file holding the mesh data, or an empty
+   * string if the data are located at the root of the file.
+   */
+  std::string h5_mesh_group_name;
+
   /**
    * The simulation time associated with this entry.
    */
@@ -3088,6 +3353,11 @@ private:
    * The attributes associated with this entry and their dimension.
    */
   std::map<std::string, unsigned int> attribute_dims;
+
+  /**
+   * The number of bytes of the floating point data in the HDF5 file.
+   */
+  unsigned int precision;
 };
 
 
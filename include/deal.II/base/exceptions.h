@@ -1131,6 +1131,15 @@ namespace StandardExceptions
   DeclException1 (ExcCudaError,
                   char *,
                   << arg1);
+
+  /**
+   * This exception is raised if a function of the cuSPARSE library returns
+   * an error. The constructor takes the status returned by the function.
+   */
+  DeclException1 (ExcCusparseError,
+                  int,
+                  << "There was an error in a cuSPARSE function, which "
+                  << "returned the status " << arg1 << ".");
 #endif
 //@}
 
@@ -1248,6 +1257,15 @@ namespace StandardExceptions
 // correctly to nvcc.
 #define AssertCuda(error_code) AssertThrow(error_code == cudaSuccess, \
                                            dealii::ExcCudaError(cudaGetErrorString(error_code)))
+
+/**
+ * An assertion that checks that the status returned by a cuSPARSE function
+ * is equal to CUSPARSE_STATUS_SUCCESS.
+ *
+ * @ingroup Exceptions
+ */
+#define AssertCusparse(error_code) AssertThrow(error_code == CUSPARSE_STATUS_SUCCESS, \
+                                               dealii::ExcCusparseError(error_code))
 #endif
 
 using namespace StandardExceptions;
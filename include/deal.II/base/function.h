@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1998 - 2016 by the deal.II authors
+// Copyright (C) 1998 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -238,6 +238,29 @@ public:
   virtual void vector_values (const std::vector<Point<dim> > &points,
                               std::vector<std::vector<Number> > &values) const;
 
+  /**
+   * Return the value of the specified component of the function at the
+   * points stored in the lanes of a vectorized point, as returned for
+   * example by FEEvaluation::quadrature_point() in matrix-free loops. Lane
+   * <tt>v</tt> of the result contains the value at the point with
+   * coordinates <tt>p[d][v]</tt>.
+   *
+   * The default implementation calls value() for each lane separately.
+   * Derived classes with a closed-form expression can override this function
+   * to evaluate the expression on all lanes at once with the arithmetic
+   * operations of VectorizedArray, saving a virtual function call per lane.
+   * This is done by the constant functions and several of the analytic
+   * functions in namespace Functions, e.g., Functions::CosineFunction.
+   *
+   * The function has a different name than value() so that classes which
+   * only override value() do not hide it. The values are returned as
+   * double numbers; for functions with complex values, the imaginary part
+   * must be zero.
+   */
+  virtual VectorizedArray<double>
+  vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                    const unsigned int                         component = 0) const;
+
   /**
    * Return the gradient of the specified component of the function at the
    * given point.
@@ -399,6 +422,10 @@ namespace Functions
     virtual void vector_value_list (const std::vector<Point<dim> > &points,
                                     std::vector<Vector<Number> >   &return_values) const;
 
+    virtual VectorizedArray<double>
+    vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                      const unsigned int                         component = 0) const;
+
     virtual Tensor<1,dim, Number> gradient (const Point<dim> &p,
                                             const unsigned int component = 0) const;
 
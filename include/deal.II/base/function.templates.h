@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1998 - 2016 by the deal.II authors
+// Copyright (C) 1998 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -21,12 +21,50 @@
 
 #include <deal.II/base/tensor_function.h>
 #include <deal.II/base/point.h>
+#include <deal.II/base/vectorization.h>
 #include <deal.II/lac/vector.h>
+
+#include <complex>
 #include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
 
+namespace internal
+{
+  namespace FunctionImplementation
+  {
+    /**
+     * Convert a function value to the double number stored in the lanes of
+     * the result of Function::vectorized_value().
+     */
+    template <typename Number>
+    inline
+    double
+    to_vectorized_lane (const Number &value)
+    {
+      return value;
+    }
+
+
+
+    template <typename Number>
+    inline
+    double
+    to_vectorized_lane (const std::complex<Number> &value)
+    {
+      Assert (value.imag() == Number(),
+              ExcMessage ("Function::vectorized_value() and "
+                          "TensorFunction::vectorized_value() return real "
+                          "numbers, but the function has a value with nonzero "
+                          "imaginary part."));
+      return value.real();
+    }
+  }
+}
+
+
+
 template <int dim, typename Number>
 const unsigned int Function<dim, Number>::dimension;
 
@@ -115,6 +153,25 @@ void Function<dim, Number>::vector_values (
 }
 
 
+
+template <int dim, typename Number>
+VectorizedArray<double>
+Function<dim, Number>::vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                                         const unsigned int                         component) const
+{
+  VectorizedArray<double> result;
+  for (unsigned int v=0; v<VectorizedArray<double>::n_array_elements; ++v)
+    {
+      Point<dim> lane_point;
+      for (unsigned int d=0; d<dim; ++d)
+        lane_point[d] = p[d][v];
+      result[v] = internal::FunctionImplementation::to_vectorized_lane
+                  (this->value (lane_point, component));
+    }
+  return result;
+}
+
+
 template <int dim, typename Number>
 Tensor<1,dim,Number> Function<dim, Number>::gradient (const Point<dim> &,
                                                       const unsigned int) const
@@ -412,6 +469,20 @@ namespace Functions
 
 
 
+
+  template <int dim, typename Number>
+  VectorizedArray<double>
+  ConstantFunction<dim, Number>::vectorized_value (const Point<dim,VectorizedArray<double> > &,
+                                                   const unsigned int component) const
+  {
+    Assert (component < this->n_components,
+            ExcIndexRange (component, 0, this->n_components));
+    return make_vectorized_array (internal::FunctionImplementation::to_vectorized_lane
+                                  (function_value_vector[component]));
+  }
+
+
+
   template <int dim, typename Number>
   std::size_t
   ConstantFunction<dim, Number>::memory_consumption () const
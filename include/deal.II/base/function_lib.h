@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2016 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -59,6 +59,9 @@ namespace Functions
     virtual void value_list (const std::vector<Point<dim> > &points,
                              std::vector<double>            &values,
                              const unsigned int              component = 0) const;
+    virtual VectorizedArray<double>
+    vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                      const unsigned int                         component = 0) const;
     virtual Tensor<1,dim> gradient (const Point<dim>   &p,
                                     const unsigned int  component = 0) const;
     virtual void vector_gradient (const Point<dim>   &p,
@@ -93,6 +96,10 @@ namespace Functions
                              std::vector<double>            &values,
                              const unsigned int              component = 0) const;
 
+    virtual VectorizedArray<double>
+    vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                      const unsigned int                         component = 0) const;
+
     virtual void vector_value_list (const std::vector<Point<dim> > &points,
                                     std::vector<Vector<double> > &values) const;
 
@@ -160,6 +167,14 @@ namespace Functions
                              std::vector<double>            &values,
                              const unsigned int              component = 0) const;
 
+    /**
+     * The values at the points of a vectorized point, evaluated on all lanes
+     * at once.
+     */
+    virtual VectorizedArray<double>
+    vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                      const unsigned int                         component = 0) const;
+
     /**
      * Gradient at a single point.
      */
@@ -216,6 +231,10 @@ namespace Functions
                              std::vector<double>            &values,
                              const unsigned int              component = 0) const;
 
+    virtual VectorizedArray<double>
+    vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                      const unsigned int                         component = 0) const;
+
     virtual void vector_value_list (const std::vector<Point<dim> > &points,
                                     std::vector<Vector<double> > &values) const;
 
@@ -319,6 +338,14 @@ namespace Functions
                              std::vector<double>            &values,
                              const unsigned int              component = 0) const;
 
+    /**
+     * The values at the points of a vectorized point, evaluated on all lanes
+     * at once.
+     */
+    virtual VectorizedArray<double>
+    vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                      const unsigned int                         component = 0) const;
+
     /**
      * Gradient at a single point.
      */
@@ -645,6 +672,14 @@ namespace Functions
     virtual double value (const Point<dim>   &p,
                           const unsigned int  component = 0) const;
 
+    /**
+     * Return the value of the function at the points of a vectorized point,
+     * evaluated on all lanes at once.
+     */
+    virtual VectorizedArray<double>
+    vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                      const unsigned int                         component = 0) const;
+
     /**
      * Return the gradient of the specified component of the function at the
      * given point.
@@ -697,6 +732,14 @@ namespace Functions
     virtual double value (const Point<dim>   &p,
                           const unsigned int  component = 0) const;
 
+    /**
+     * Return the value of the function at the points of a vectorized point,
+     * evaluated on all lanes at once.
+     */
+    virtual VectorizedArray<double>
+    vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                      const unsigned int                         component = 0) const;
+
     /**
      * Return the gradient of the specified component of the function at the
      * given point.
@@ -302,6 +302,34 @@ public:
   virtual void vector_value (const Point<dim>   &p,
                              Vector<double>     &values) const;
 
+  /**
+   * Set <tt>values</tt> to the values of the specified component of the
+   * function at the <tt>points</tt>. This overload looks up the thread-local
+   * parser objects only once for the whole list and then runs the
+   * precompiled bytecode of the given component on each point, which is
+   * considerably cheaper than calling value() repeatedly.
+   */
+  virtual void value_list (const std::vector<Point<dim> > &points,
+                           std::vector<double>            &values,
+                           const unsigned int              component = 0) const;
+
+  /**
+   * Set <tt>values</tt> to the values of all components of the function at
+   * the <tt>points</tt>, evaluating all components for one point before
+   * moving on to the next one. The output array shall have the right size
+   * beforehand.
+   */
+  virtual void vector_value_list (const std::vector<Point<dim> > &points,
+                                  std::vector<Vector<double> >   &values) const;
+
+  /**
+   * For each component of the function, fill a vector of values, one for
+   * each point. Same as vector_value_list() but with the component index in
+   * the outer array.
+   */
+  virtual void vector_values (const std::vector<Point<dim> >    &points,
+                              std::vector<std::vector<double> > &values) const;
+
   /**
    * @addtogroup Exceptions
    * @{
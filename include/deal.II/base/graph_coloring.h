@@ -1,7 +1,7 @@
 
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2013 - 2016 by the deal.II authors
+// Copyright (C) 2013 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -19,10 +19,13 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/types.h>
 #include <boost/unordered_map.hpp>
 #include <boost/unordered_set.hpp>
 
+#include <algorithm>
 #include <functional>
 #include <set>
 #include <vector>
@@ -428,6 +431,302 @@ namespace GraphColoring
 
       return coloring;
     }
+
+
+    /**
+     * A simple integer hash that is used as a tie breaker between the
+     * priorities of the vertices in make_parallel_graph_coloring(). Using
+     * the hash rather than the vertex number avoids long chains of
+     * neighboring vertices with decreasing priority, which would serialize
+     * the coloring.
+     */
+    inline
+    unsigned int
+    vertex_hash (const unsigned int vertex)
+    {
+      unsigned int hash = vertex;
+      hash = ((hash >> 16) ^ hash) * 0x45d9f3bu;
+      hash = ((hash >> 16) ^ hash) * 0x45d9f3bu;
+      hash = (hash >> 16) ^ hash;
+      return hash;
+    }
+
+
+
+    /**
+     * Compute the conflict graph of the given iterators in parallel: The
+     * conflict indices of all iterators are determined, sorted by index to
+     * find the iterators sharing an index, and the neighbors of each
+     * iterator are collected from the iterators sharing one of its indices.
+     * Two iterators are connected by an edge in the graph if their conflict
+     * indices have a nonempty intersection. The neighbor lists are sorted.
+     */
+    template <typename Iterator>
+    void
+    make_conflict_graph (const std::vector<Iterator> &iterators,
+                         const std::function<std::vector<types::global_dof_index> (const Iterator &)> &get_conflict_indices,
+                         std::vector<std::vector<unsigned int> > &graph)
+    {
+      const unsigned int n_vertices = iterators.size();
+      std::vector<std::vector<types::global_dof_index> > conflict_indices(n_vertices);
+      parallel::apply_to_subranges
+      (0U, n_vertices, [&] (const unsigned int begin, const unsigned int end)
+      {
+        for (unsigned int v=begin; v<end; ++v)
+          {
+            conflict_indices[v] = get_conflict_indices(iterators[v]);
+            std::sort(conflict_indices[v].begin(), conflict_indices[v].end());
+            conflict_indices[v].erase(std::unique(conflict_indices[v].begin(),
+                                                  conflict_indices[v].end()),
+                                      conflict_indices[v].end());
+          }
+      }, 32);
+
+      // sort all pairs of conflict index and vertex by the index, which
+      // places the vertices sharing an index next to each other
+      std::vector<std::pair<types::global_dof_index,unsigned int> > index_vertex_pairs;
+      {
+        std::size_t n_pairs = 0;
+        for (unsigned int v=0; v<n_vertices; ++v)
+          n_pairs += conflict_indices[v].size();
+        index_vertex_pairs.reserve(n_pairs);
+      }
+      for (unsigned int v=0; v<n_vertices; ++v)
+        for (unsigned int i=0; i<conflict_indices[v].size(); ++i)
+          index_vertex_pairs.emplace_back(conflict_indices[v][i], v);
+      std::sort(index_vertex_pairs.begin(), index_vertex_pairs.end());
+
+      // compress the list into the unique indices and the start of their
+      // vertices in the sorted list of pairs
+      std::vector<types::global_dof_index> unique_indices;
+      std::vector<std::size_t> index_start;
+      for (std::size_t i=0; i<index_vertex_pairs.size(); ++i)
+        if (i==0 || index_vertex_pairs[i].first != index_vertex_pairs[i-1].first)
+          {
+            unique_indices.push_back(index_vertex_pairs[i].first);
+            index_start.push_back(i);
+          }
+      index_start.push_back(index_vertex_pairs.size());
+
+      graph.clear();
+      graph.resize(n_vertices);
+      parallel::apply_to_subranges
+      (0U, n_vertices, [&] (const unsigned int begin, const unsigned int end)
+      {
+        for (unsigned int v=begin; v<end; ++v)
+          {
+            std::vector<unsigned int> &neighbors = graph[v];
+            for (unsigned int i=0; i<conflict_indices[v].size(); ++i)
+              {
+                const std::size_t index
+                  = std::lower_bound(unique_indices.begin(), unique_indices.end(),
+                                     conflict_indices[v][i]) - unique_indices.begin();
+                for (std::size_t j=index_start[index]; j<index_start[index+1]; ++j)
+                  if (index_vertex_pairs[j].second != v)
+                    neighbors.push_back(index_vertex_pairs[j].second);
+              }
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                            neighbors.end());
+          }
+      }, 32);
+    }
+
+
+
+    /**
+     * Color the vertices of the given graph with the parallel algorithm of
+     * Jones and Plassmann: Each vertex is given a priority, here its degree
+     * with the hash of the vertex number as a tie breaker. In each round,
+     * all uncolored vertices whose neighbors with higher priority are
+     * already colored pick the smallest color not used by any of their
+     * neighbors. These vertices are independent of each other, so the
+     * rounds can be run in parallel without synchronization, and the
+     * result does not depend on the number of threads. The function returns
+     * the number of colors.
+     */
+    inline
+    unsigned int
+    make_jones_plassmann_coloring (const std::vector<std::vector<unsigned int> > &graph,
+                                   std::vector<unsigned int>                     &colors)
+    {
+      const unsigned int n_vertices = graph.size();
+      const unsigned int invalid_color = numbers::invalid_unsigned_int;
+      colors.clear();
+      colors.resize(n_vertices, invalid_color);
+
+      const auto has_higher_priority = [&graph] (const unsigned int v,
+                                                 const unsigned int w)
+      {
+        if (graph[v].size() != graph[w].size())
+          return graph[v].size() > graph[w].size();
+        const unsigned int hash_v = vertex_hash(v), hash_w = vertex_hash(w);
+        return hash_v != hash_w ? hash_v > hash_w : v > w;
+      };
+
+      std::vector<unsigned int> worklist(n_vertices);
+      for (unsigned int v=0; v<n_vertices; ++v)
+        worklist[v] = v;
+      std::vector<unsigned int> new_colors;
+      while (worklist.empty() == false)
+        {
+          // choose the colors of the vertices that are ready in this round,
+          // reading only the colors of the vertices colored in earlier
+          // rounds
+          new_colors.resize(worklist.size());
+          parallel::apply_to_subranges
+          (0U, static_cast<unsigned int>(worklist.size()),
+           [&] (const unsigned int begin, const unsigned int end)
+          {
+            std::vector<bool> color_used;
+            for (unsigned int k=begin; k<end; ++k)
+              {
+                const unsigned int v = worklist[k];
+                new_colors[k] = invalid_color;
+                bool is_ready = true;
+                for (unsigned int j=0; j<graph[v].size(); ++j)
+                  if (colors[graph[v][j]] == invalid_color &&
+                      has_higher_priority(graph[v][j], v))
+                    {
+                      is_ready = false;
+                      break;
+                    }
+                if (is_ready == false)
+                  continue;
+
+                // a vertex with d neighbors always finds a free color among
+                // the first d+1 colors
+                color_used.assign(graph[v].size()+1, false);
+                for (unsigned int j=0; j<graph[v].size(); ++j)
+                  if (colors[graph[v][j]] < color_used.size())
+                    color_used[colors[graph[v][j]]] = true;
+                new_colors[k] = std::find(color_used.begin(), color_used.end(),
+                                          false) - color_used.begin();
+              }
+          }, 64);
+
+          unsigned int n_remaining = 0;
+          for (unsigned int k=0; k<worklist.size(); ++k)
+            if (new_colors[k] == invalid_color)
+              worklist[n_remaining++] = worklist[k];
+            else
+              colors[worklist[k]] = new_colors[k];
+          worklist.resize(n_remaining);
+        }
+
+      unsigned int n_colors = 0;
+      for (unsigned int v=0; v<n_vertices; ++v)
+        n_colors = std::max(n_colors, colors[v]+1);
+      return n_colors;
+    }
+
+
+
+    /**
+     * Recolor the vertices of the given graph with a valid coloring by one
+     * pass of the iterated greedy algorithm of Culberson: The color classes
+     * are visited in the order of increasing number of vertices, and all
+     * vertices of a class pick the smallest color not used by the neighbors
+     * recolored before. This typically removes some of the small colors
+     * created last by make_jones_plassmann_coloring(). Since the vertices of a class are independent, each
+     * class is processed in parallel, and the resulting coloring never
+     * uses more colors than the original one. The function returns the new
+     * number of colors.
+     */
+    inline
+    unsigned int
+    make_iterated_greedy_coloring (const std::vector<std::vector<unsigned int> > &graph,
+                                   const unsigned int                             n_colors,
+                                   std::vector<unsigned int>                     &colors)
+    {
+      const unsigned int n_vertices = graph.size();
+      std::vector<std::vector<unsigned int> > color_classes(n_colors);
+      for (unsigned int v=0; v<n_vertices; ++v)
+        color_classes[colors[v]].push_back(v);
+      std::stable_sort(color_classes.begin(), color_classes.end(),
+                       [] (const std::vector<unsigned int> &a,
+                           const std::vector<unsigned int> &b)
+      {
+        return a.size() < b.size();
+      });
+
+      std::vector<unsigned int> new_colors(n_vertices, numbers::invalid_unsigned_int);
+      for (unsigned int c=0; c<n_colors; ++c)
+        {
+          const std::vector<unsigned int> &color_class = color_classes[c];
+          parallel::apply_to_subranges
+          (0U, static_cast<unsigned int>(color_class.size()),
+           [&] (const unsigned int begin, const unsigned int end)
+          {
+            std::vector<bool> color_used;
+            for (unsigned int k=begin; k<end; ++k)
+              {
+                const unsigned int v = color_class[k];
+                color_used.assign(graph[v].size()+1, false);
+                for (unsigned int j=0; j<graph[v].size(); ++j)
+                  if (new_colors[graph[v][j]] < color_used.size())
+                    color_used[new_colors[graph[v][j]]] = true;
+                new_colors[v] = std::find(color_used.begin(), color_used.end(),
+                                          false) - color_used.begin();
+              }
+          }, 64);
+        }
+      colors.swap(new_colors);
+
+      unsigned int new_n_colors = 0;
+      for (unsigned int v=0; v<n_vertices; ++v)
+        new_n_colors = std::max(new_n_colors, colors[v]+1);
+      return new_n_colors;
+    }
+
+
+
+    /**
+     * Balance the sizes of the colors of a valid coloring of the given
+     * graph: Vertices of colors with more than the average number of
+     * vertices are moved to the smallest color that has fewer vertices than
+     * the average and is not used by any of their neighbors. The number of
+     * colors does not change. This corresponds to the shuffling strategy of
+     * Lu et al., "Balanced coloring for parallel computing applications",
+     * IPDPS 2015.
+     */
+    inline
+    void
+    balance_coloring (const std::vector<std::vector<unsigned int> > &graph,
+                      const unsigned int                             n_colors,
+                      std::vector<unsigned int>                     &colors)
+    {
+      const unsigned int n_vertices = graph.size();
+      if (n_colors < 2)
+        return;
+
+      std::vector<unsigned int> color_sizes(n_colors, 0);
+      for (unsigned int v=0; v<n_vertices; ++v)
+        ++color_sizes[colors[v]];
+      const unsigned int target_size = (n_vertices + n_colors - 1) / n_colors;
+
+      // the colors are marked by the vertex that is currently processed in
+      // order to not clear the array for every vertex
+      std::vector<unsigned int> color_used_by(n_colors, numbers::invalid_unsigned_int);
+      for (unsigned int v=0; v<n_vertices; ++v)
+        if (color_sizes[colors[v]] > target_size)
+          {
+            for (unsigned int j=0; j<graph[v].size(); ++j)
+              color_used_by[colors[graph[v][j]]] = v;
+            unsigned int best_color = colors[v];
+            for (unsigned int c=0; c<n_colors; ++c)
+              if (color_used_by[c] != v && color_sizes[c] < target_size &&
+                  color_sizes[c] < color_sizes[best_color])
+                best_color = c;
+            if (best_color != colors[v])
+              {
+                --color_sizes[colors[v]];
+                ++color_sizes[best_color];
+                colors[v] = best_color;
+              }
+          }
+    }
+
   }
 
 
@@ -495,6 +794,9 @@ namespace GraphColoring
    * @note The algorithm used in this function is described in a paper by
    * Turcksin, Kronbichler and Bangerth, see
    * @ref workstream_paper.
+   * The function make_parallel_graph_coloring() computes a coloring with
+   * the same properties with an algorithm that runs in parallel as a whole
+   * and that balances the sizes of the colors.
    *
    * @param[in] begin The first element of a range of iterators for which a
    * coloring is sought.
@@ -542,6 +844,71 @@ namespace GraphColoring
     return internal::gather_colors(partition_coloring);
   }
 
+
+
+  /**
+   * Create a partitioning of the given range of iterators so that iterators
+   * that point to conflicting objects will be placed into different
+   * partitions, like make_graph_coloring(), but with an algorithm that runs
+   * in parallel as a whole and that produces colors of similar size.
+   *
+   * The function first computes the conflict graph in parallel, calling
+   * @p get_conflict_indices exactly once for each iterator, and finds the
+   * iterators that conflict through a sorted list of all conflict indices
+   * rather than by comparing the conflict indices of pairs of iterators.
+   * The graph is then colored with the algorithm of Jones and Plassmann,
+   * which colors an independent set of vertices in each round in parallel,
+   * followed by a parallel recoloring pass that reduces the number of
+   * colors. The result is deterministic and does not depend on the number of
+   * threads. Finally, if @p balance_colors is set, vertices are moved from
+   * the colors with more than the average number of iterators to the
+   * smaller colors where possible. This avoids the typical outcome of
+   * greedy colorings with a few large colors followed by many small ones,
+   * which leave threads idle in the colored WorkStream::run().
+   *
+   * The coloring only depends on the range of iterators and their conflict
+   * indices. When the mesh and the degrees of freedom do not change, the
+   * returned object can therefore be computed once and be passed to many
+   * calls of the colored WorkStream::run() functions.
+   *
+   * The arguments and the return value have the same meaning as for
+   * make_graph_coloring(). The function @p get_conflict_indices is called
+   * concurrently from several threads. An empty range results in an empty
+   * coloring.
+   */
+  template <typename Iterator>
+  std::vector<std::vector<Iterator> >
+  make_parallel_graph_coloring(const Iterator &begin,
+                               const typename identity<Iterator>::type &end,
+                               const std::function<std::vector<types::global_dof_index> (const typename identity<Iterator>::type &)> &get_conflict_indices,
+                               const bool balance_colors = true)
+  {
+    std::vector<Iterator> iterators;
+    for (Iterator it=begin; it!=end; ++it)
+      iterators.push_back(it);
+    if (iterators.empty())
+      return std::vector<std::vector<Iterator> >();
+
+    std::vector<std::vector<unsigned int> > graph;
+    internal::make_conflict_graph (iterators, get_conflict_indices, graph);
+
+    std::vector<unsigned int> colors;
+    unsigned int n_colors = internal::make_jones_plassmann_coloring (graph, colors);
+    n_colors = internal::make_iterated_greedy_coloring (graph, n_colors, colors);
+    if (balance_colors)
+      internal::balance_coloring (graph, n_colors, colors);
+
+    std::vector<unsigned int> color_sizes(n_colors, 0);
+    for (unsigned int v=0; v<colors.size(); ++v)
+      ++color_sizes[colors[v]];
+    std::vector<std::vector<Iterator> > coloring(n_colors);
+    for (unsigned int c=0; c<n_colors; ++c)
+      coloring[c].reserve(color_sizes[c]);
+    for (unsigned int v=0; v<colors.size(); ++v)
+      coloring[colors[v]].push_back(iterators[v]);
+    return coloring;
+  }
+
 } // End graph_coloring namespace
 
 DEAL_II_NAMESPACE_CLOSE
@@ -23,11 +23,17 @@
 #include <boost/serialization/vector.hpp>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <iterator>
 
 
 #ifdef DEAL_II_WITH_TRILINOS
 #  include <Epetra_Map.h>
+#  ifdef DEAL_II_TRILINOS_WITH_TPETRA
+#    include <Teuchos_RCP.hpp>
+#    include <Tpetra_Map.hpp>
+#  endif
 #endif
 
 #if defined(DEAL_II_WITH_MPI) || defined(DEAL_II_WITH_PETSC)
@@ -63,6 +69,15 @@ DEAL_II_NAMESPACE_OPEN
  * in the
  * @ref distributed_paper "Distributed Computing paper".
  *
+ * Indices and ranges may be added in any order. They are collected without
+ * sorting and only sorted and merged once the set is queried, in compress().
+ * For sets that consist of many small ranges close to each other, as e.g.
+ * the locally relevant degrees of freedom of discontinuous elements,
+ * compress() additionally builds a bitmap of the covered index interval, so
+ * that is_element() and index_within_set() take constant time rather than
+ * a binary search over the ranges. Once compressed, all 'const' functions
+ * read the data without taking a lock.
+ *
  * @author Wolfgang Bangerth, 2009
  */
 class IndexSet
@@ -111,12 +126,12 @@ public:
   /**
    * Copy constructor.
    */
-  IndexSet (const IndexSet &) = default;
+  IndexSet (const IndexSet &is);
 
   /**
    * Copy assignment operator.
    */
-  IndexSet &operator= (const IndexSet &) = default;
+  IndexSet &operator= (const IndexSet &is);
 
   /**
    * Move constructor. Create a new IndexSet by transferring the internal data
@@ -414,6 +429,19 @@ public:
    */
   Epetra_Map make_trilinos_map (const MPI_Comm &communicator = MPI_COMM_WORLD,
                                 const bool      overlapping  = false) const;
+
+#ifdef DEAL_II_TRILINOS_WITH_TPETRA
+  /**
+   * Same as make_trilinos_map(), but create a Tpetra::Map with 64-bit global
+   * indices. Since Tpetra objects share their maps, the map is returned as a
+   * reference-counted pointer that can be handed to the constructors of
+   * Tpetra vectors and matrices directly.
+   */
+  Teuchos::RCP<const Tpetra::Map<TrilinosWrappers::types::tpetra_local_ordinal,
+                                 TrilinosWrappers::types::tpetra_global_ordinal> >
+  make_tpetra_map (const MPI_Comm &communicator = MPI_COMM_WORLD,
+                   const bool      overlapping  = false) const;
+#endif
 #endif
 
 
@@ -817,7 +845,8 @@ private:
 
   /**
    * A set of contiguous ranges of indices that make up (part of) this index
-   * set. This variable is always kept sorted.
+   * set. This variable is sorted by compress(), whereas ranges added after
+   * the last call to compress() are simply appended.
    *
    * The variable is marked "mutable" so that it can be changed by compress(),
    * though this of course doesn't change anything about the external
@@ -833,7 +862,7 @@ private:
    * though this of course doesn't change anything about the external
    * representation of this index set.
    */
-  mutable bool is_compressed;
+  mutable std::atomic<bool> is_compressed;
 
   /**
    * The overall size of the index range. Elements of this index set have to
@@ -852,6 +881,27 @@ private:
    */
   mutable size_type largest_range;
 
+  /**
+   * For sets consisting of many ranges that lie close to each other, a
+   * bitmap of the indices between @p lookup_begin and the end of the last
+   * range, with the bit (i - lookup_begin) % 64 of the word (i -
+   * lookup_begin) / 64 set if the index i is in the set. Empty otherwise.
+   * Set up by compress() and used for constant-time access in
+   * is_element() and index_within_set().
+   */
+  mutable std::vector<std::uint64_t> lookup_bits;
+
+  /**
+   * For each word in @p lookup_bits, the number of elements of the set
+   * before the first index represented by the word.
+   */
+  mutable std::vector<size_type> lookup_offsets;
+
+  /**
+   * The first index represented in @p lookup_bits.
+   */
+  mutable size_type lookup_begin;
+
   /**
    * A mutex that is used to synchronize operations of the do_compress() function
    * that is called from many 'const' functions via compress().
@@ -862,6 +912,14 @@ private:
    * Actually perform the compress() operation.
    */
   void do_compress() const;
+
+  /**
+   * Return the number of elements of the set before @p index if @p index
+   * is represented in @p lookup_bits and an element of the set,
+   * numbers::invalid_dof_index if it is represented but not an element, and
+   * numbers::invalid_dof_index-1 if it is not represented.
+   */
+  size_type lookup_index_within_set (const size_type index) const;
 };
 
 
@@ -1374,7 +1432,8 @@ IndexSet::IndexSet ()
   :
   is_compressed (true),
   index_space_size (0),
-  largest_range (numbers::invalid_unsigned_int)
+  largest_range (numbers::invalid_unsigned_int),
+  lookup_begin (0)
 {}
 
 
@@ -1384,23 +1443,61 @@ IndexSet::IndexSet (const size_type size)
   :
   is_compressed (true),
   index_space_size (size),
-  largest_range (numbers::invalid_unsigned_int)
+  largest_range (numbers::invalid_unsigned_int),
+  lookup_begin (0)
 {}
 
 
 
+inline
+IndexSet::IndexSet (const IndexSet &is)
+  :
+  is_compressed (true),
+  index_space_size (0),
+  largest_range (numbers::invalid_unsigned_int),
+  lookup_begin (0)
+{
+  *this = is;
+}
+
+
+
+inline
+IndexSet &IndexSet::operator= (const IndexSet &is)
+{
+  // compress the other set first so that we copy a consistent state
+  is.compress ();
+
+  ranges = is.ranges;
+  is_compressed = true;
+  index_space_size = is.index_space_size;
+  largest_range = is.largest_range;
+  lookup_bits = is.lookup_bits;
+  lookup_offsets = is.lookup_offsets;
+  lookup_begin = is.lookup_begin;
+
+  return *this;
+}
+
+
+
 inline
 IndexSet::IndexSet (IndexSet &&is)
   :
   ranges (std::move(is.ranges)),
-  is_compressed (is.is_compressed),
+  is_compressed (is.is_compressed.load()),
   index_space_size (is.index_space_size),
-  largest_range (is.largest_range)
+  largest_range (is.largest_range),
+  lookup_bits (std::move(is.lookup_bits)),
+  lookup_offsets (std::move(is.lookup_offsets)),
+  lookup_begin (is.lookup_begin)
 {
   is.ranges.clear ();
   is.is_compressed = true;
   is.index_space_size = 0;
   is.largest_range = numbers::invalid_unsigned_int;
+  is.lookup_bits.clear ();
+  is.lookup_offsets.clear ();
 
   compress ();
 }
@@ -1411,14 +1508,19 @@ inline
 IndexSet &IndexSet::operator= (IndexSet &&is)
 {
   ranges = std::move (is.ranges);
-  is_compressed = is.is_compressed;
+  is_compressed = is.is_compressed.load();
   index_space_size = is.index_space_size;
   largest_range = is.largest_range;
+  lookup_bits = std::move (is.lookup_bits);
+  lookup_offsets = std::move (is.lookup_offsets);
+  lookup_begin = is.lookup_begin;
 
   is.ranges.clear ();
   is.is_compressed = true;
   is.index_space_size = 0;
   is.largest_range = numbers::invalid_unsigned_int;
+  is.lookup_bits.clear ();
+  is.lookup_offsets.clear ();
 
   compress ();
 
@@ -1529,6 +1631,8 @@ IndexSet::clear ()
   // reset so that there are no indices in the set any more; however,
   // as documented, the index set retains its size
   ranges.clear ();
+  lookup_bits.clear ();
+  lookup_offsets.clear ();
   is_compressed = true;
   largest_range = numbers::invalid_unsigned_int;
 }
@@ -1561,7 +1665,7 @@ inline
 void
 IndexSet::compress () const
 {
-  if (is_compressed == true)
+  if (is_compressed.load(std::memory_order_acquire) == true)
     return;
 
   do_compress();
@@ -1576,16 +1680,12 @@ IndexSet::add_index (const size_type index)
   Assert (index < index_space_size,
           ExcIndexRangeType<size_type> (index, 0, index_space_size));
 
-  const Range new_range(index, index+1);
-  if (ranges.size() == 0 || index > ranges.back().end)
-    ranges.push_back(new_range);
-  else if (index == ranges.back().end)
+  // extend the last range if possible, and otherwise append the index
+  // without sorting, which is left to compress()
+  if (ranges.size() > 0 && index == ranges.back().end)
     ranges.back().end++;
   else
-    ranges.insert (Utilities::lower_bound (ranges.begin(),
-                                           ranges.end(),
-                                           new_range),
-                   new_range);
+    ranges.emplace_back(index, index+1);
   is_compressed = false;
 }
 
@@ -1597,6 +1697,16 @@ void
 IndexSet::add_indices (const ForwardIterator &begin,
                        const ForwardIterator &end)
 {
+  // sort unsorted input once, so that consecutive indices can be merged
+  // into ranges below
+  if (std::is_sorted(begin, end) == false)
+    {
+      std::vector<size_type> sorted_indices(begin, end);
+      std::sort(sorted_indices.begin(), sorted_indices.end());
+      add_indices(sorted_indices.begin(), sorted_indices.end());
+      return;
+    }
+
   // insert each element of the range. if some of them happen to be
   // consecutive, merge them to a range
   for (ForwardIterator p=begin; p!=end;)
@@ -1605,9 +1715,9 @@ IndexSet::add_indices (const ForwardIterator &begin,
       size_type       end_index   = begin_index + 1;
       ForwardIterator q = p;
       ++q;
-      while ((q != end) && (*q == end_index))
+      while ((q != end) && (*q <= end_index))
         {
-          ++end_index;
+          end_index = std::max<size_type>(end_index, *q + 1);
           ++q;
         }
 
@@ -1618,6 +1728,33 @@ IndexSet::add_indices (const ForwardIterator &begin,
 
 
 
+inline
+IndexSet::size_type
+IndexSet::lookup_index_within_set (const size_type index) const
+{
+  if (index < lookup_begin || index - lookup_begin >= 64*lookup_bits.size())
+    return numbers::invalid_dof_index-1;
+
+  const size_type word = (index - lookup_begin) / 64;
+  const unsigned int bit = (index - lookup_begin) % 64;
+  const std::uint64_t bits = lookup_bits[word];
+  if ((bits & (std::uint64_t(1) << bit)) == 0)
+    return numbers::invalid_dof_index;
+
+  // count the elements before the index within the word
+  std::uint64_t lower_bits = bits & ((std::uint64_t(1) << bit) - 1);
+#ifdef __GNUC__
+  const unsigned int n_lower = __builtin_popcountll(lower_bits);
+#else
+  unsigned int n_lower = 0;
+  for ( ; lower_bits != 0; lower_bits &= lower_bits - 1)
+    ++n_lower;
+#endif
+  return lookup_offsets[word] + n_lower;
+}
+
+
+
 inline
 bool
 IndexSet::is_element (const size_type index) const
@@ -1632,6 +1769,14 @@ IndexSet::is_element (const size_type index) const
           index < ranges[largest_range].end)
         return true;
 
+      // constant-time lookup for fragmented sets
+      if (lookup_bits.empty() == false)
+        {
+          const size_type position = lookup_index_within_set(index);
+          if (position != numbers::invalid_dof_index-1)
+            return position != numbers::invalid_dof_index;
+        }
+
       // get the element after which we would have to insert a range that
       // consists of all elements from this element to the end of the index
       // range plus one. after this call we know that if p!=end() then
@@ -1804,6 +1949,14 @@ IndexSet::index_within_set (const size_type n) const
   if (n >= main_range->begin && n < main_range->end)
     return (n-main_range->begin) + main_range->nth_index_in_set;
 
+  // constant-time lookup for fragmented sets
+  if (lookup_bits.empty() == false)
+    {
+      const size_type position = lookup_index_within_set(n);
+      if (position != numbers::invalid_dof_index-1)
+        return position;
+    }
+
   Range r(n, n);
   std::vector<Range>::const_iterator range_begin, range_end;
   if (n<main_range->begin)
@@ -1923,7 +2076,16 @@ inline
 void
 IndexSet::serialize (Archive &ar, const unsigned int)
 {
-  ar &ranges &is_compressed &index_space_size &largest_range;
+  // the lookup table is not stored but set up again by compress(). the
+  // stored data is always compressed
+  compress();
+  bool compressed = true;
+  ar &ranges &compressed &index_space_size &largest_range;
+  if (Archive::is_loading::value)
+    {
+      is_compressed = false;
+      compress();
+    }
 }
 
 DEAL_II_NAMESPACE_CLOSE
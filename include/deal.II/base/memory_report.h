@@ -0,0 +1,144 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_memory_report_h
+#define dealii_memory_report_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/mpi.h>
+
+#include <cstddef>
+#include <iosfwd>
+#include <list>
+#include <string>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/**
+ * A hierarchical breakdown of the memory consumed by an object and its
+ * subobjects. While the <code>memory_consumption()</code> functions of the
+ * library (see the MemoryConsumption namespace) return a single number, the
+ * <code>memory_report()</code> functions of the major classes, such as
+ * Triangulation::memory_report(), DoFHandler::memory_report(),
+ * ConstraintMatrix::memory_report(), MatrixFree::memory_report() or
+ * LinearAlgebra::distributed::Vector::memory_report(), return an object of
+ * this class that lists how these numbers are composed, e.g., the cells and
+ * faces of each level of a triangulation, the cached degree of freedom
+ * indices of a DoFHandler, or the ghost buffers of a vector. The reports of
+ * several objects can be collected into a single one, which is then printed
+ * for the current process or as minimum, average, maximum and sum over all
+ * processes of an MPI communicator:
+ * @code
+ *   MemoryReport report ("Simulation");
+ *   report.add (triangulation.memory_report());
+ *   report.add (dof_handler.memory_report());
+ *   report.add (constraints.memory_report());
+ *   report.add (matrix_free.memory_report());
+ *   report.add (solution.memory_report());
+ *   report.print (std::cout, MPI_COMM_WORLD);
+ * @endcode
+ *
+ * Each entry of the report has a name and a number of bytes. The number of
+ * bytes of an entry is the sum of its own number and those of its
+ * children, so an entry only needs to record the memory that is not
+ * accounted for by its children.
+ *
+ * @ingroup memory
+ */
+class MemoryReport
+{
+public:
+  /**
+   * Constructor. Create an entry with the given name that accounts for
+   * @p bytes bytes in addition to those of the children to be added later.
+   */
+  explicit MemoryReport (const std::string &name,
+                         const std::size_t  bytes = 0);
+
+  /**
+   * Add a child entry with the given name and number of bytes and return a
+   * reference to it, in order to add further children to it. The reference
+   * stays valid when other children are added to the present object.
+   */
+  MemoryReport &add (const std::string &name,
+                     const std::size_t  bytes = 0);
+
+  /**
+   * Add a copy of the given report as a child and return a reference to
+   * it.
+   */
+  MemoryReport &add (const MemoryReport &report);
+
+  /**
+   * Add @p bytes to the number of bytes recorded for this entry itself.
+   */
+  void add_bytes (const std::size_t bytes);
+
+  /**
+   * Return the name of this entry.
+   */
+  const std::string &get_name () const;
+
+  /**
+   * Return the number of bytes of this entry, including all its children.
+   */
+  std::size_t total_bytes () const;
+
+  /**
+   * Return the children of this entry.
+   */
+  const std::list<MemoryReport> &get_children () const;
+
+  /**
+   * Print the report of the current process, with one line per entry in
+   * megabytes and the children indented below their parent.
+   */
+  void print (std::ostream &out) const;
+
+  /**
+   * Print the minimum, average and maximum over all processes of
+   * @p mpi_comm of each entry, together with the sum over all processes.
+   * The entries need not be the same on all processes; an entry that is
+   * missing on some processes counts as zero bytes there. This is a
+   * collective operation. Output is only generated on the process with
+   * rank zero.
+   */
+  void print (std::ostream   &out,
+              const MPI_Comm &mpi_comm) const;
+
+private:
+  /**
+   * The name of the entry.
+   */
+  std::string name;
+
+  /**
+   * The number of bytes not accounted for by the children.
+   */
+  std::size_t bytes;
+
+  /**
+   * The children. A list is used in order to keep the references returned
+   * by add() valid.
+   */
+  std::list<MemoryReport> children;
+};
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -19,6 +19,8 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/array_view.h>
 
+#include <functional>
+#include <map>
 #include <vector>
 
 #if !defined(DEAL_II_WITH_MPI) && !defined(DEAL_II_WITH_PETSC)
@@ -108,11 +110,49 @@ namespace Utilities
      * something to the current processor. The resulting list is not sorted.
      * It may contain duplicate entries if processors enter the same
      * destination more than once in their destinations list.
+     *
+     * This function sends an empty message to each destination with the
+     * algorithm described in sparse_data_exchange(). If the data to be sent
+     * is already known, it is cheaper to exchange it with that function
+     * directly.
      */
     std::vector<unsigned int>
     compute_point_to_point_communication_pattern (const MPI_Comm &mpi_comm,
                                                   const std::vector<unsigned int> &destinations);
 
+    /**
+     * Consider an unstructured communication pattern where every process in
+     * an MPI universe wants to send an array of objects to a subset of the
+     * other processors, without the receivers knowing who is going to send
+     * them something. This function sends the arrays in @p data_to_send,
+     * indexed by the rank of the destination, and returns the arrays sent to
+     * the current process, indexed by the rank of their origin. Arrays sent
+     * by a process to itself are copied directly.
+     *
+     * The exchange uses the nonblocking consensus algorithm of Hoefler,
+     * Siebert, and Lumsdaine ("Scalable communication protocols for dynamic
+     * sparse data exchange", 2010): the data is sent with synchronous
+     * nonblocking sends while incoming messages are probed for and received.
+     * Once all sends of a process have been received, it enters a
+     * nonblocking barrier, and the exchange is complete as soon as all
+     * processes have. The cost of this scheme is proportional to the number
+     * of messages and the logarithm of the number of processes, as opposed to
+     * gathering the destinations of all processes, whose cost grows linearly
+     * with the number of processes. For MPI versions older than 3.0 that do
+     * not provide a nonblocking barrier, the receivers are identified by
+     * such a gather operation, though.
+     *
+     * The data is transferred as a sequence of bytes, so @p T needs to be a
+     * type that can be copied with std::memcpy(), like the integer and
+     * floating point types. This is a collective operation over all
+     * processors in the
+     * @ref GlossMPICommunicator "communicator".
+     */
+    template <typename T>
+    std::map<unsigned int, std::vector<T> >
+    sparse_data_exchange (const MPI_Comm                                &mpi_comm,
+                          const std::map<unsigned int, std::vector<T> > &data_to_send);
+
     /**
      * Given a
      * @ref GlossMPICommunicator "communicator",
@@ -401,6 +441,11 @@ namespace Utilities
      * initialized in the beginning, and destroyed at the end automatically
      * (internally by calling sc_init(), p4est_init(), and sc_finalize()).
      *
+     * If deal.II is configured with LIKWID, the marker API for the collection
+     * of hardware performance counters is initialized in the beginning and
+     * finalized at the end, see PerformanceCounters::initialize() and
+     * PerformanceCounters::finalize().
+     *
      * If a program uses MPI one would typically just create an object of this
      * type at the beginning of <code>main()</code>. The constructor of this
      * class then runs <code>MPI_Init()</code> with the given arguments. At
@@ -457,16 +502,54 @@ namespace Utilities
        * Consequently, this extends to the current class: the best place to
        * create an object of this type is also at or close to the top of
        * <code>main()</code>.
+       *
+       * @param[in] pin_threads If set to true, each MPI process on a node is
+       * restricted to its own set of cores via
+       * MultithreadInfo::set_thread_affinity(), in order to keep the worker
+       * threads of different processes from competing for the same cores in
+       * hybrid MPI+thread runs. If the MPI launcher has given each process
+       * access to only part of the cores of the node, these cores are used.
+       * Otherwise, the cores of the node are ordered by NUMA domain and split
+       * into contiguous sets according to the rank of the process among the
+       * processes on the node, so that the cores of a process share a NUMA
+       * domain where possible. With automatic choice of @p max_num_threads,
+       * the number of threads is then the number of cores in the set.
+       *
+       * @param[in] thread_multiple If set to true, MPI is initialized with
+       * the thread support level <code>MPI_THREAD_MULTIPLE</code> rather than
+       * <code>MPI_THREAD_SERIALIZED</code>, which allows several threads to
+       * call MPI at the same time. This is needed by ProgressEngine. If the
+       * MPI library does not provide this level, the program continues with
+       * the level provided, which can be checked with
+       * has_thread_multiple_support().
        */
       MPI_InitFinalize (int    &argc,
                         char ** &argv,
-                        const unsigned int max_num_threads = numbers::invalid_unsigned_int);
+                        const unsigned int max_num_threads = numbers::invalid_unsigned_int,
+                        const bool pin_threads = false,
+                        const bool thread_multiple = false);
 
       /**
-       * Destructor. Calls <tt>MPI_Finalize()</tt> in case this class owns the
-       * MPI process.
+       * Destructor. Stops the ProgressEngine and calls
+       * <tt>MPI_Finalize()</tt> in case this class owns the MPI process.
        */
       ~MPI_InitFinalize();
+
+      /**
+       * Return whether MPI was initialized with the thread support level
+       * <code>MPI_THREAD_MULTIPLE</code>, i.e., whether several threads may
+       * call MPI at the same time. This is only the case if it was requested
+       * in the constructor and provided by the MPI library. If deal.II is not
+       * configured with MPI, false is returned.
+       */
+      bool has_thread_multiple_support () const;
+
+    private:
+      /**
+       * Whether the thread support level <code>MPI_THREAD_MULTIPLE</code> is
+       * available, see has_thread_multiple_support().
+       */
+      bool thread_multiple_support;
     };
 
     /**
@@ -491,6 +574,48 @@ namespace Utilities
                        const ArrayView<const T> &values,
                        const MPI_Comm           &mpi_communicator,
                        const ArrayView<T>       &output);
+
+      // the untyped implementation of sparse_data_exchange(), which sends the
+      // bytes in send_data[i] to destinations[i] and receives the messages
+      // sent to the current process into the memory returned by
+      // get_receive_buffer(origin, n_bytes)
+      void sparse_data_exchange (const MPI_Comm                                &mpi_comm,
+                                 const std::vector<unsigned int>               &destinations,
+                                 const std::vector<ArrayView<const char> >     &send_data,
+                                 const std::function<char *(const unsigned int,
+                                                            const unsigned int)> &get_receive_buffer);
+    }
+
+    template <typename T>
+    std::map<unsigned int, std::vector<T> >
+    sparse_data_exchange (const MPI_Comm                                &mpi_comm,
+                          const std::map<unsigned int, std::vector<T> > &data_to_send)
+    {
+      std::vector<unsigned int> destinations;
+      std::vector<ArrayView<const char> > send_data;
+      destinations.reserve(data_to_send.size());
+      send_data.reserve(data_to_send.size());
+      for (const auto &rank_and_data : data_to_send)
+        {
+          destinations.push_back(rank_and_data.first);
+          send_data.emplace_back(reinterpret_cast<const char *>(rank_and_data.second.data()),
+                                 rank_and_data.second.size()*sizeof(T));
+        }
+
+      std::map<unsigned int, std::vector<T> > received_data;
+      internal::sparse_data_exchange
+      (mpi_comm, destinations, send_data,
+       [&received_data](const unsigned int origin,
+                        const unsigned int n_bytes) -> char *
+      {
+        Assert(n_bytes % sizeof(T) == 0, ExcInternalError());
+        Assert(received_data.find(origin) == received_data.end(),
+               ExcInternalError());
+        std::vector<T> &data = received_data[origin];
+        data.resize(n_bytes/sizeof(T));
+        return reinterpret_cast<char *>(data.data());
+      });
+      return received_data;
     }
 
     // Since these depend on N they must live in the header file
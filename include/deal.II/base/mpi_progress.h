@@ -0,0 +1,232 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mpi_progress_h
+#define dealii_mpi_progress_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/mpi.h>
+
+#include <atomic>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace Utilities
+{
+  namespace MPI
+  {
+    /**
+     * A progress engine for non-blocking MPI communication. Most MPI
+     * libraries only make progress on outstanding non-blocking messages when
+     * the application calls into MPI, e.g. via <code>MPI_Test</code> or
+     * <code>MPI_Wait</code>. For messages larger than the eager limit of the
+     * library, this means that a ghost exchange started with
+     * LinearAlgebra::distributed::Vector::update_ghost_values_start() often
+     * does not proceed at all while the application works on the cells that
+     * do not need the ghost values, e.g. in MatrixFree::cell_loop(), and the
+     * whole transfer happens in update_ghost_values_finish(). This class
+     * makes the requested overlap of communication and computation happen
+     * by testing the outstanding requests while the computation runs.
+     *
+     * The class keeps a list of the requests of all exchanges in flight.
+     * Utilities::MPI::Partitioner adds the requests of an exchange to this
+     * list when starting it (in export_to_ghosted_array_start() and
+     * import_from_ghosted_array_start()) and removes them before waiting for
+     * them in the respective finish functions. The engine is disabled by
+     * default, in which case none of this happens. It can be enabled in two
+     * modes:
+     * <ul>
+     * <li> Mode::polling: The requests are tested whenever poll() is called.
+     * MatrixFree::cell_loop() calls this function after every
+     * get_poll_interval() cell batches (on the serial path, the range of
+     * inner cells is split accordingly) and after each partition of the
+     * threaded loop, and WorkStream::run() calls it after every chunk of
+     * items processed by a worker thread. Users can call poll() from their
+     * own loops, too.
+     * <li> Mode::thread: In addition, a separate thread tests the requests
+     * every get_poll_interval() microseconds. This thread mostly sleeps, but
+     * it should be given a core not used by the worker threads for the best
+     * results, see MultithreadInfo::set_thread_limit().
+     * </ul>
+     *
+     * Since the requests may be tested by a different thread than the one
+     * that started the exchange, both modes require the MPI library to be
+     * initialized with <code>MPI_THREAD_MULTIPLE</code>, which can be
+     * requested in the constructor of MPI_InitFinalize and checked with
+     * MPI_InitFinalize::has_thread_multiple_support(). enable() throws an
+     * exception otherwise. Each request is only ever tested by one thread at
+     * a time. The engine does not help for MPI libraries that have their own
+     * asynchronous progress (e.g. with <code>MPICH_ASYNC_PROGRESS</code>),
+     * and it costs one <code>MPI_Testall</code> call per outstanding exchange
+     * at each poll.
+     *
+     * @code
+     *   Utilities::MPI::MPI_InitFinalize mpi_init (argc, argv,
+     *                                              numbers::invalid_unsigned_int,
+     *                                              false, true);
+     *   if (mpi_init.has_thread_multiple_support())
+     *     Utilities::MPI::ProgressEngine::enable
+     *       (Utilities::MPI::ProgressEngine::polling, 16);
+     *   ... matrix_free.cell_loop (...) ...
+     * @endcode
+     *
+     * All functions of this class are static and thread-safe.
+     */
+    class ProgressEngine
+    {
+    public:
+      /**
+       * The ways the outstanding requests are tested.
+       */
+      enum Mode
+      {
+        /**
+         * The requests are not tracked at all.
+         */
+        disabled,
+        /**
+         * The requests are tested when poll() is called.
+         */
+        polling,
+        /**
+         * The requests are tested when poll() is called and by a separate
+         * progress thread.
+         */
+        thread
+      };
+
+      /**
+       * Enable the engine in the given @p mode. In the polling mode, @p
+       * poll_interval is the number of cell batches after which
+       * MatrixFree::cell_loop() calls poll(). In the thread mode, it is the
+       * time in microseconds the progress thread sleeps between two tests;
+       * poll() is then called every 16 cell batches. Calling this function
+       * again with a different mode switches between the modes.
+       *
+       * The MPI library must have been initialized with
+       * <code>MPI_THREAD_MULTIPLE</code>. Without MPI, this function does
+       * nothing.
+       */
+      static void enable (const Mode         mode,
+                          const unsigned int poll_interval = 16);
+
+      /**
+       * Disable the engine and stop the progress thread if it is running.
+       * This is done by the destructor of MPI_InitFinalize before MPI is
+       * finalized.
+       */
+      static void disable ();
+
+      /**
+       * Return the current mode.
+       */
+      static Mode get_mode ();
+
+      /**
+       * Return the number of cell batches after which MatrixFree::cell_loop()
+       * calls poll(), or zero if the engine is disabled.
+       */
+      static unsigned int get_poll_interval ();
+
+      /**
+       * Test all outstanding requests once to make the MPI library progress
+       * on them. If another thread is testing the requests at the same time,
+       * this function returns right away. It also returns right away if the
+       * engine is disabled, so it is cheap to call it from inner loops.
+       */
+      static void poll ();
+
+#ifdef DEAL_II_WITH_MPI
+      /**
+       * Add the requests of a non-blocking exchange to the list of requests
+       * tested by poll(). Nothing is done if the engine is disabled. The
+       * vector must not be changed or destroyed before it has been removed
+       * again with remove_requests().
+       *
+       * Requests completed by the engine are set to
+       * <code>MPI_REQUEST_NULL</code> (or, for persistent requests, become
+       * inactive) as specified by <code>MPI_Testall</code>, so they can be
+       * waited for as usual.
+       */
+      static void add_requests (std::vector<MPI_Request> &requests);
+
+      /**
+       * Remove the requests added with add_requests(), which must happen
+       * before the requests are waited for or freed. If another thread tests
+       * them at the moment, this function waits until the test is done. It
+       * is safe to call this function for requests that were not added.
+       */
+      static void remove_requests (const std::vector<MPI_Request> &requests);
+#endif
+
+    private:
+      /**
+       * Test all requests, called by poll() and the progress thread. If @p
+       * wait_for_lock is false, return immediately if another thread holds
+       * the lock on the list of requests.
+       */
+      static void test_requests (const bool wait_for_lock);
+
+      /**
+       * The current mode, stored as an atomic variable to make the check in
+       * poll() cheap.
+       */
+      static std::atomic<int> current_mode;
+
+      /**
+       * The number of cell batches between two calls to poll() from
+       * MatrixFree::cell_loop().
+       */
+      static std::atomic<unsigned int> cell_batch_interval;
+    };
+
+
+
+    /* ----------------------- inline functions ----------------------- */
+
+    inline
+    ProgressEngine::Mode
+    ProgressEngine::get_mode ()
+    {
+      return static_cast<Mode>(current_mode.load());
+    }
+
+
+
+    inline
+    unsigned int
+    ProgressEngine::get_poll_interval ()
+    {
+      return current_mode.load() == disabled ? 0 : cell_batch_interval.load();
+    }
+
+
+
+    inline
+    void
+    ProgressEngine::poll ()
+    {
+      if (current_mode.load() != disabled)
+        test_requests (false);
+    }
+  } // end of namespace MPI
+} // end of namespace Utilities
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2000 - 2016 by the deal.II authors
+// Copyright (C) 2000 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -22,6 +22,8 @@
 #include <deal.II/base/types.h>
 #include <deal.II/base/exceptions.h>
 
+#include <vector>
+
 DEAL_II_NAMESPACE_OPEN
 
 /**
@@ -101,6 +103,53 @@ public:
    */
   static bool is_running_single_threaded ();
 
+  /**
+   * Return the numbers of the cores the current process may run on, i.e.,
+   * its affinity mask as set by the MPI launcher, the batch system, or
+   * set_thread_affinity(). At the moment the affinity mask can only be
+   * queried on Linux; on other systems, all cores from zero to n_cores()-1
+   * are returned.
+   */
+  static std::vector<unsigned int> available_cores ();
+
+  /**
+   * Return the cores of available_cores() grouped by the NUMA domains
+   * (memory controllers) they belong to, with the domains in ascending
+   * order. Domains that contain none of the available cores are left out.
+   * Algorithms that partition work among the threads, like the partitioners
+   * of MatrixFree and WorkStream, can use this information to keep the
+   * threads working on the same data in the same domain.
+   *
+   * The topology is read from the <tt>/sys</tt> file system on Linux. If
+   * it is not available, all cores are placed into a single group.
+   */
+  static std::vector<std::vector<unsigned int> > numa_domains ();
+
+  /**
+   * Return the cores of available_cores() grouped by the last level cache
+   * they share, in the same format as numa_domains(). If the information
+   * is not available, all cores are placed into a single group.
+   */
+  static std::vector<std::vector<unsigned int> > cache_groups ();
+
+  /**
+   * Restrict the calling thread and all worker threads of the TBB to the
+   * given set of cores. It is used by Utilities::MPI::MPI_InitFinalize to
+   * give each MPI process on a node its own set of cores in hybrid
+   * MPI+thread runs, which avoids that the threads of different processes
+   * move between the sockets and compete for the same cores. The worker
+   * threads are restricted when they enter the task scheduler, so this
+   * function can be called at any time. An empty set removes the
+   * restriction set by an earlier call for threads entering the scheduler
+   * afterwards, but does not reset the affinity of those that already have
+   * it.
+   *
+   * The threads may run on any of the given cores, i.e., they are not
+   * pinned to individual cores. At the moment this function is only
+   * implemented on Linux and does nothing on other systems.
+   */
+  static void set_thread_affinity (const std::vector<unsigned int> &cores);
+
 private:
 
   /**
@@ -180,6 +180,38 @@ namespace numbers
    */
   bool is_finite (const std::complex<long double> &x);
 
+  /**
+   * Return whether @p value is greater than @p reference. For a
+   * VectorizedArray, the comparison needs to hold for all of its entries.
+   * This function is used for assertions in templates that are instantiated
+   * both for scalar and vectorized number types.
+   */
+  template <typename Number>
+  bool value_is_greater_than (const Number &value,
+                              const double  reference);
+
+  /**
+   * Same as above, for all entries of a VectorizedArray.
+   */
+  template <typename Number>
+  bool value_is_greater_than (const VectorizedArray<Number> &value,
+                              const double                   reference);
+
+  /**
+   * Return whether @p value is less than @p reference. For a
+   * VectorizedArray, the comparison needs to hold for all of its entries.
+   */
+  template <typename Number>
+  bool value_is_less_than (const Number &value,
+                           const double  reference);
+
+  /**
+   * Same as above, for all entries of a VectorizedArray.
+   */
+  template <typename Number>
+  bool value_is_less_than (const VectorizedArray<Number> &value,
+                           const double                   reference);
+
   /**
    * A structure that, together with its partial specializations
    * NumberTraits<std::complex<number> >, provides traits and member functions
@@ -327,6 +359,26 @@ namespace numbers
   }
 
 
+
+  template <typename Number>
+  inline
+  bool value_is_greater_than (const Number &value,
+                              const double  reference)
+  {
+    return value > reference;
+  }
+
+
+
+  template <typename Number>
+  inline
+  bool value_is_less_than (const Number &value,
+                           const double  reference)
+  {
+    return value < reference;
+  }
+
+
   template <typename number>
   const number &
   NumberTraits<number>::conjugate (const number &x)
@@ -19,10 +19,12 @@
 
 #include <deal.II/base/config.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/synchronous_iterator.h>
 #include <deal.II/base/thread_management.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <tuple>
 #include <memory>
@@ -774,6 +776,76 @@ namespace parallel
 #endif
     };
   }
+
+
+
+  /**
+   * A variant of apply_to_subranges() for loops that are executed many
+   * times over the same range and the same data, such as the initialization
+   * and the matrix-vector products of a sparse matrix. As opposed to the
+   * other function, the range <code>[begin,end)</code> is split into a fixed
+   * set of at most four chunks per thread, each at least @p grainsize
+   * elements long, and the chunks are scheduled with the affinity partitioner
+   * stored in @p partitioner. TBB records which thread worked on which chunk
+   * and, in subsequent loops with the same @p partitioner object, assigns the
+   * same chunks to the same threads again as far as the load allows. The
+   * chunks are computed in the same way as for the vector operations of
+   * Vector and LinearAlgebra::distributed::Vector, so for large ranges a
+   * loop over the rows of a matrix is split at the same indices as the loops
+   * over a vector of matching size.
+   *
+   * On systems with non-uniform memory access (NUMA), memory pages are
+   * placed close to the processor that touches them first. If the first
+   * access to a data array is done by a loop through this function, e.g. by
+   * setting it to zero, and all later loops over the array use the same @p
+   * partitioner and @p grainsize, each thread mostly works on data in the
+   * memory bank attached to its socket.
+   *
+   * Without multithreading, or if the range contains fewer than four times
+   * @p grainsize elements, this function simply calls
+   * <code>f(begin,end)</code>.
+   */
+  template <typename Function>
+  void apply_to_subranges (const std::size_t            begin,
+                           const std::size_t            end,
+                           const Function              &f,
+                           const std::size_t            grainsize,
+                           internal::TBBPartitioner    &partitioner)
+  {
+    if (end <= begin)
+      return;
+#ifdef DEAL_II_WITH_THREADS
+    Assert (grainsize > 0, ExcMessage("The grain size must be positive"));
+    const std::size_t size = end - begin;
+    if (size >= 4*grainsize && MultithreadInfo::n_threads() > 1)
+      {
+        // same layout as in internal::VectorOperations::TBBForFunctor
+        std::size_t n_chunks = std::min(static_cast<std::size_t>(4*MultithreadInfo::n_threads()),
+                                        size / grainsize);
+        std::size_t chunk_size = size / n_chunks;
+        if (chunk_size > 512)
+          chunk_size = ((chunk_size + 511)/512)*512;
+        n_chunks = (size + chunk_size - 1) / chunk_size;
+
+        std::shared_ptr<tbb::affinity_partitioner> tbb_partitioner =
+          partitioner.acquire_one_partitioner();
+        tbb::parallel_for (tbb::blocked_range<std::size_t> (0, n_chunks, 1),
+                           [&] (const tbb::blocked_range<std::size_t> &range)
+        {
+          const std::size_t chunk_begin = begin + range.begin() * chunk_size;
+          const std::size_t chunk_end = std::min(end, begin + range.end() * chunk_size);
+          f (chunk_begin, chunk_end);
+        },
+        *tbb_partitioner);
+        partitioner.release_one_partitioner(tbb_partitioner);
+        return;
+      }
+#else
+    (void) grainsize;
+    (void) partitioner;
+#endif
+    f (begin, end);
+  }
 }
 
 
@@ -373,14 +373,27 @@ public:
    * If the input file does not exist, a default one with the same name is created
    * for you, and an exception is thrown.
    *
+   * If a communicator other than MPI_COMM_SELF is given, the function
+   * needs to be called on all processes of @p mpi_communicator. The input
+   * file is then only read by the process with rank zero and sent to the
+   * other processes (see the collective variants of
+   * ParameterHandler::parse_input() and
+   * ParameterHandler::parse_input_from_xml()), and the default input file and
+   * the output file are only written by the process with rank zero. This
+   * avoids that all processes of a large parallel job access the file system
+   * at the same time.
+   *
    * @param filename Input file name
    * @param output_filename Output file name
    * @param output_style_for_prm_format How to write the output file if format is `prm`
+   * @param prm The ParameterHandler to use
+   * @param mpi_communicator The processes that read the parameters together
    */
   static void initialize(const std::string &filename="",
                          const std::string &output_filename="",
                          const ParameterHandler::OutputStyle output_style_for_prm_format=ParameterHandler::ShortText,
-                         ParameterHandler &prm = ParameterAcceptor::prm);
+                         ParameterHandler &prm = ParameterAcceptor::prm,
+                         const MPI_Comm &mpi_communicator = MPI_COMM_SELF);
 
   /**
    * Call declare_all_parameters(), read the parameters from the `input_stream`
@@ -19,6 +19,7 @@
 
 #include <deal.II/base/config.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/patterns.h>
 
@@ -943,6 +944,23 @@ public:
   virtual void parse_input (const std::string &filename,
                             const std::string &last_line = "");
 
+  /**
+   * Parse the given file like the previous function, but collectively on
+   * all processes of the MPI communicator @p mpi_communicator: Only the
+   * process with rank zero looks up and reads the file, and sends its
+   * content to all other processes, which then parse it from memory. At
+   * large process counts, this avoids that all processes access the file
+   * system at the same time, which can take a long time on parallel file
+   * systems.
+   *
+   * If the file can not be found, all processes throw
+   * PathSearch::ExcFileNotFound, just like the previous function does. All
+   * processes of the communicator must call this function.
+   */
+  void parse_input (const std::string &filename,
+                    const MPI_Comm    &mpi_communicator,
+                    const std::string &last_line = "");
+
   /**
    * Parse input from a string to populate known parameter fields. The lines
    * in the string must be separated by <tt>@\n</tt> characters.
@@ -963,6 +981,16 @@ public:
    */
   virtual void parse_input_from_xml (std::istream &input);
 
+  /**
+   * Parse the given XML file collectively on all processes of the MPI
+   * communicator @p mpi_communicator. As for the collective parse_input()
+   * function, only the process with rank zero reads the file and sends its
+   * content to the other processes. If the file can not be opened, all
+   * processes throw ExcIO.
+   */
+  void parse_input_from_xml (const std::string &filename,
+                             const MPI_Comm    &mpi_communicator);
+
   /**
    * Clear all contents.
    */
@@ -195,6 +195,20 @@ namespace Functions
     virtual double value (const Point< dim >     &p,
                           const unsigned int  component = 0)    const;
 
+    /**
+     * Return the values of the given component at all the given points. This
+     * forwards to the batched evaluation of FunctionParser.
+     */
+    virtual void value_list (const std::vector<Point<dim> > &points,
+                             std::vector<double>            &values,
+                             const unsigned int              component = 0) const;
+
+    /**
+     * Return all components of the function at all the given points.
+     */
+    virtual void vector_value_list (const std::vector<Point<dim> > &points,
+                                    std::vector<Vector<double> >   &values) const;
+
     /**
      * Set the time to a specific value for time-dependent functions.
      *
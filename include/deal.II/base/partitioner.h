@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2011 - 2016 by the deal.II authors
+// Copyright (C) 2011 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -21,6 +21,7 @@
 #include <deal.II/base/types.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/memory_report.h>
 #include <deal.II/base/index_set.h>
 #include <deal.II/base/array_view.h>
 
@@ -37,6 +38,97 @@ namespace Utilities
 {
   namespace MPI
   {
+#ifdef DEAL_II_WITH_MPI
+    class Partitioner;
+
+    /**
+     * A set of persistent MPI requests for the data exchange of a
+     * Partitioner, as created by MPI_Recv_init() and MPI_Send_init(). The
+     * requests are bound to the arrays and the communication channel of the
+     * exchange they were set up for and are simply restarted with
+     * MPI_Startall() by later exchanges on the same arrays, which saves the
+     * setup of the messages inside MPI on every call. If an exchange is
+     * started with different arrays, the requests are freed and set up
+     * again.
+     *
+     * Objects of this class are owned by the caller of the exchange
+     * functions of Partitioner, as it is the caller who owns the arrays,
+     * e.g. LinearAlgebra::distributed::Vector.
+     */
+    class PersistentRequests
+    {
+    public:
+      /**
+       * Constructor. Creates an empty object.
+       */
+      PersistentRequests ();
+
+      /**
+       * Destructor. Frees the requests.
+       */
+      ~PersistentRequests ();
+
+      /**
+       * The requests are bound to the arrays of their owner and can
+       * therefore not be copied.
+       */
+      PersistentRequests (const PersistentRequests &) = delete;
+
+      /**
+       * The requests are bound to the arrays of their owner and can
+       * therefore not be copied.
+       */
+      PersistentRequests &operator= (const PersistentRequests &) = delete;
+
+      /**
+       * Free all requests. Requests of an exchange that is still ongoing are
+       * completed by MPI before they are deallocated. Nothing is done if MPI
+       * has already been finalized.
+       */
+      void clear ();
+
+      /**
+       * Swap the content of this object with @p other, which is valid when
+       * the owners of the two objects exchange their arrays as well.
+       */
+      void swap (PersistentRequests &other);
+
+    private:
+      /**
+       * The persistent requests, with the receive operations first.
+       */
+      std::vector<MPI_Request> requests;
+
+      /**
+       * The partitioner, the communication channel, the size of the data
+       * type, and the start of the arrays the requests were set up with,
+       * used to detect whether the requests can be reused.
+       */
+      const Partitioner *partitioner;
+      unsigned int       communication_channel;
+      std::size_t        number_size;
+      const void        *send_array;
+      const void        *receive_array;
+      std::size_t        ghost_array_size;
+
+      /**
+       * Return whether the requests were set up with the given arguments.
+       * Otherwise, free the requests and store the given arguments, with the
+       * requests to be set up by the caller.
+       */
+      bool check_and_bind (const Partitioner *partitioner,
+                           const unsigned int communication_channel,
+                           const std::size_t  number_size,
+                           const void        *send_array,
+                           const void        *receive_array,
+                           const std::size_t  ghost_array_size);
+
+      friend class Partitioner;
+    };
+#endif
+
+
+
     /**
      * This class defines a model for the partitioning of a vector (or, in
      * fact, any linear data structure) among processors using MPI.
@@ -388,16 +480,40 @@ namespace Utilities
        * communication that will be finalized in the
        * export_to_ghosted_array_finish() call.
        *
+       * The entries are sent as the type @p TransferNumber of the
+       * temporary storage and ghost arrays, which can be of lower precision
+       * than the type @p Number of the locally owned array, e.g. @p float
+       * for @p double data, in order to reduce the volume of the
+       * communication. The values are then rounded when they are packed into
+       * @p temporary_storage.
+       *
        * This functionality is used in
        * LinearAlgebra::distributed::Vector::update_ghost_values().
        */
+      template <typename Number, typename TransferNumber>
+      void
+      export_to_ghosted_array_start(const unsigned int                     communication_channel,
+                                    const ArrayView<const Number>         &locally_owned_array,
+                                    const ArrayView<TransferNumber>       &temporary_storage,
+                                    const ArrayView<TransferNumber>       &ghost_array,
+                                    std::vector<MPI_Request>              &requests) const;
+
+      /**
+       * Same as the function above, but use the persistent MPI requests in
+       * @p persistent_requests for the communication, which are set up in
+       * the first call with the given arrays and reused in subsequent calls
+       * with the same arrays. The active requests are copied into @p
+       * requests, so that the exchange is finished by
+       * export_to_ghosted_array_finish() as usual.
+       */
       template <typename Number>
       void
       export_to_ghosted_array_start(const unsigned int              communication_channel,
                                     const ArrayView<const Number>  &locally_owned_array,
                                     const ArrayView<Number>        &temporary_storage,
                                     const ArrayView<Number>        &ghost_array,
-                                    std::vector<MPI_Request>       &requests) const;
+                                    std::vector<MPI_Request>       &requests,
+                                    PersistentRequests             &persistent_requests) const;
 
       /**
        * Finish the exports of the data in a locally owned array to the range
@@ -465,6 +581,23 @@ namespace Utilities
                                       const ArrayView<Number>      &temporary_storage,
                                       std::vector<MPI_Request>     &requests) const;
 
+      /**
+       * Same as the function above, but use the persistent MPI requests in
+       * @p persistent_requests for the communication, which are set up in
+       * the first call with the given arrays and reused in subsequent calls
+       * with the same arrays. The active requests are copied into @p
+       * requests, so that the exchange is finished by
+       * import_from_ghosted_array_finish() as usual.
+       */
+      template <typename Number>
+      void
+      import_from_ghosted_array_start(const VectorOperation::values vector_operation,
+                                      const unsigned int            communication_channel,
+                                      const ArrayView<Number>      &ghost_array,
+                                      const ArrayView<Number>      &temporary_storage,
+                                      std::vector<MPI_Request>     &requests,
+                                      PersistentRequests           &persistent_requests) const;
+
       /**
        * Finishes importing the data from an array indexed by the ghost
        * indices of this class into a specified locally owned array, combining
@@ -496,16 +629,23 @@ namespace Utilities
        * import_to_ghosted_array_finish() call. This must be the same array as
        * passed to that function, otherwise MPI will likely throw an error.
        *
+       * The type @p TransferNumber of @p temporary_array and @p ghost_array
+       * can be of lower precision than the type @p Number of the locally
+       * owned array, in which case the ghost data must have been converted
+       * to @p TransferNumber before import_from_ghosted_array_start() was
+       * called with these arrays. The received values are converted back
+       * when they are combined with the locally owned entries.
+       *
        * This functionality is used in
        * LinearAlgebra::distributed::Vector::compress().
        */
-      template <typename Number>
+      template <typename Number, typename TransferNumber>
       void
-      import_from_ghosted_array_finish(const VectorOperation::values  vector_operation,
-                                       const ArrayView<const Number> &temporary_array,
-                                       const ArrayView<Number>       &locally_owned_storage,
-                                       const ArrayView<Number>       &ghost_array,
-                                       std::vector<MPI_Request>      &requests) const;
+      import_from_ghosted_array_finish(const VectorOperation::values          vector_operation,
+                                       const ArrayView<const TransferNumber> &temporary_array,
+                                       const ArrayView<Number>               &locally_owned_storage,
+                                       const ArrayView<TransferNumber>       &ghost_array,
+                                       std::vector<MPI_Request>              &requests) const;
 #endif
 
       /**
@@ -513,6 +653,13 @@ namespace Utilities
        */
       std::size_t memory_consumption() const;
 
+      /**
+       * Return a breakdown of the memory consumption returned by
+       * memory_consumption() into the index sets, the import data and the
+       * ghost data.
+       */
+      MemoryReport memory_report() const;
+
       /**
        * Exception
        */
@@ -639,6 +786,133 @@ namespace Utilities
 
 
 
+#ifdef DEAL_II_WITH_MPI
+    /**
+     * A class that splits the data exchange described by a Partitioner into
+     * a part between processes that share the memory of a compute node and a
+     * part between processes on different nodes. The processes on a node are
+     * given by a communicator @p communicator_sm, typically obtained by
+     * <code>MPI_Comm_split_type</code> with <code>MPI_COMM_TYPE_SHARED</code>
+     * from the communicator of the partitioner.
+     *
+     * If the arrays of all processes on a node are allocated in a shared
+     * memory window (<code>MPI_Win_allocate_shared</code>), the ghost entries
+     * owned by the other processes of the node can be read directly from
+     * their memory rather than being sent as MPI messages, and only the
+     * remaining ghost entries are exchanged with the remote partitioner
+     * returned by get_remote_partitioner(). This is used by
+     * LinearAlgebra::distributed::Vector when it is initialized with a
+     * shared memory communicator.
+     *
+     * The arrays are expected in the usual layout of a vector, i.e., the
+     * locally owned entries followed by the ghost entries in the order of
+     * Partitioner::ghost_indices().
+     */
+    class SharedMemoryExchange
+    {
+    public:
+      /**
+       * Constructor. This is a collective operation on the communicator of
+       * @p partitioner.
+       */
+      SharedMemoryExchange (const std::shared_ptr<const Partitioner> &partitioner,
+                            const MPI_Comm                            communicator_sm);
+
+      /**
+       * Return the partitioner describing the full data exchange.
+       */
+      const std::shared_ptr<const Partitioner> &get_partitioner () const;
+
+      /**
+       * Return a partitioner for the exchange of the entries with processes
+       * outside the current node. Its ghost indices are a subset of the ghost
+       * indices of get_partitioner() in the sense of the second argument to
+       * Partitioner::set_ghost_indices(), so it is used with the full ghost
+       * array.
+       */
+      const Partitioner &get_remote_partitioner () const;
+
+      /**
+       * Return the communicator of the processes on the current node.
+       */
+      const MPI_Comm &get_shared_memory_communicator () const;
+
+      /**
+       * Copy the ghost entries owned by other processes of the current node
+       * into @p ghost_array. The argument @p shared_arrays contains the
+       * array of each process on the node, in the order of the ranks in the
+       * shared memory communicator.
+       *
+       * The caller must make sure that the other processes are not changing
+       * their locally owned entries during this call.
+       */
+      template <typename Number>
+      void
+      export_to_ghosted_array_shared (const std::vector<ArrayView<const Number> > &shared_arrays,
+                                      const ArrayView<Number>                       &ghost_array) const;
+
+      /**
+       * Add the entries of the ghost arrays of the other processes of the
+       * current node that correspond to locally owned entries of the current
+       * process into @p locally_owned_array. The argument @p shared_arrays
+       * is as in export_to_ghosted_array_shared().
+       */
+      template <typename Number>
+      void
+      import_from_ghosted_array_shared (const std::vector<ArrayView<const Number> > &shared_arrays,
+                                        const ArrayView<Number>                       &locally_owned_array) const;
+
+      /**
+       * Return an estimate of the memory consumption of this object in bytes.
+       */
+      std::size_t memory_consumption () const;
+
+    private:
+      /**
+       * A contiguous range of entries copied between the array of the
+       * current process and the one of the process with rank @p rank in the
+       * shared memory communicator.
+       */
+      struct Transfer
+      {
+        unsigned int rank;
+        unsigned int local_start;
+        unsigned int remote_start;
+        unsigned int length;
+      };
+
+      /**
+       * The partitioner describing the full data exchange.
+       */
+      std::shared_ptr<const Partitioner> partitioner;
+
+      /**
+       * The partitioner for the entries exchanged with other nodes.
+       */
+      std::shared_ptr<const Partitioner> remote_partitioner;
+
+      /**
+       * The communicator of the current node.
+       */
+      MPI_Comm communicator_sm;
+
+      /**
+       * The ranges of ghost entries read from the locally owned entries of
+       * other processes of the node, with @p local_start counted from the
+       * beginning of the ghost array.
+       */
+      std::vector<Transfer> ghost_transfers;
+
+      /**
+       * The ranges of locally owned entries that receive contributions from
+       * the ghost entries of other processes of the node.
+       */
+      std::vector<Transfer> import_transfers;
+    };
+#endif
+
+
+
     /*----------------------- Inline functions ----------------------------------*/
 
 #ifndef DOXYGEN
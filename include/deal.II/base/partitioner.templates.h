@@ -17,9 +17,11 @@
 #define dealii_partitioner_templates_h
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/mpi_progress.h>
 #include <deal.II/base/partitioner.h>
 #include <deal.II/lac/la_parallel_vector.h>
 
+#include <algorithm>
 #include <type_traits>
 
 
@@ -34,13 +36,38 @@ namespace Utilities
 
 #ifdef DEAL_II_WITH_MPI
 
-    template <typename Number>
+    namespace internal
+    {
+      // Pack the entries of the locally owned array described by the given
+      // list of contiguous index ranges into consecutive positions behind
+      // @p target, with a block copy per range. The entries are converted
+      // to the type of the target array, which may be of lower precision
+      template <typename Number, typename TransferNumber>
+      inline
+      TransferNumber *
+      pack_ranges (const std::vector<std::pair<unsigned int, unsigned int> >::const_iterator &begin,
+                   const std::vector<std::pair<unsigned int, unsigned int> >::const_iterator &end,
+                   const ArrayView<const Number> &locally_owned_array,
+                   TransferNumber                *target)
+      {
+        for (std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
+             range = begin; range != end; ++range)
+          target = std::copy(locally_owned_array.begin() + range->first,
+                             locally_owned_array.begin() + range->second,
+                             target);
+        return target;
+      }
+    }
+
+
+
+    template <typename Number, typename TransferNumber>
     void
-    Partitioner::export_to_ghosted_array_start(const unsigned int             communication_channel,
-                                               const ArrayView<const Number> &locally_owned_array,
-                                               const ArrayView<Number>       &temporary_storage,
-                                               const ArrayView<Number>       &ghost_array,
-                                               std::vector<MPI_Request>      &requests) const
+    Partitioner::export_to_ghosted_array_start(const unsigned int               communication_channel,
+                                               const ArrayView<const Number>   &locally_owned_array,
+                                               const ArrayView<TransferNumber> &temporary_storage,
+                                               const ArrayView<TransferNumber> &ghost_array,
+                                               std::vector<MPI_Request>        &requests) const
     {
       AssertDimension(locally_owned_array.size(), local_size());
       AssertDimension(temporary_storage.size(), n_import_indices());
@@ -68,17 +95,17 @@ namespace Utilities
       AssertIndexRange(n_ghost_indices(), n_ghost_indices_in_larger_set+1);
       const bool use_larger_set = (n_ghost_indices_in_larger_set > n_ghost_indices() &&
                                    ghost_array.size() == n_ghost_indices_in_larger_set);
-      Number *ghost_array_ptr = use_larger_set ?
-                                ghost_array.begin()+
-                                n_ghost_indices_in_larger_set-n_ghost_indices()
-                                : ghost_array.begin();
+      TransferNumber *ghost_array_ptr = use_larger_set ?
+                                        ghost_array.begin()+
+                                        n_ghost_indices_in_larger_set-n_ghost_indices()
+                                        : ghost_array.begin();
 
       for (unsigned int i=0; i<n_ghost_targets; i++)
         {
           // allow writing into ghost indices even though we are in a
           // const function
           const int ierr = MPI_Irecv (ghost_array_ptr,
-                                      ghost_targets_data[i].second*sizeof(Number),
+                                      ghost_targets_data[i].second*sizeof(TransferNumber),
                                       MPI_BYTE,
                                       ghost_targets_data[i].first,
                                       ghost_targets_data[i].first + communication_channel,
@@ -88,22 +115,20 @@ namespace Utilities
           ghost_array_ptr += ghost_targets()[i].second;
         }
 
-      Number *temp_array_ptr = temporary_storage.begin();
+      TransferNumber *temp_array_ptr = temporary_storage.begin();
       for (unsigned int i=0; i<n_import_targets; i++)
         {
           // copy the data to be sent to the import_data field
-          std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
-          my_imports = import_indices_data.begin()+import_indices_chunks_by_rank_data[i],
-          end_my_imports = import_indices_data.begin()+import_indices_chunks_by_rank_data[i+1];
-          unsigned int index = 0;
-          for ( ; my_imports!= end_my_imports; ++my_imports)
-            for (unsigned int j=my_imports->first; j<my_imports->second; j++)
-              temp_array_ptr[index++] = locally_owned_array[j];
-          AssertDimension(index, import_targets_data[i].second);
+          const TransferNumber *end_of_packed_data =
+            internal::pack_ranges(import_indices_data.begin()+import_indices_chunks_by_rank_data[i],
+                                  import_indices_data.begin()+import_indices_chunks_by_rank_data[i+1],
+                                  locally_owned_array, temp_array_ptr);
+          (void)end_of_packed_data;
+          AssertDimension(end_of_packed_data-temp_array_ptr, import_targets_data[i].second);
 
           // start the send operations
           const int ierr = MPI_Isend (temp_array_ptr,
-                                      import_targets_data[i].second*sizeof(Number),
+                                      import_targets_data[i].second*sizeof(TransferNumber),
                                       MPI_BYTE,
                                       import_targets_data[i].first,
                                       my_pid + communication_channel,
@@ -112,6 +137,106 @@ namespace Utilities
           AssertThrowMPI (ierr);
           temp_array_ptr += import_targets_data[i].second;
         }
+
+      // let the progress engine test the requests while the caller works on
+      // other data
+      Utilities::MPI::ProgressEngine::add_requests (requests);
+    }
+
+
+
+    template <typename Number>
+    void
+    Partitioner::export_to_ghosted_array_start(const unsigned int             communication_channel,
+                                               const ArrayView<const Number> &locally_owned_array,
+                                               const ArrayView<Number>       &temporary_storage,
+                                               const ArrayView<Number>       &ghost_array,
+                                               std::vector<MPI_Request>      &requests,
+                                               PersistentRequests            &persistent_requests) const
+    {
+      AssertDimension(locally_owned_array.size(), local_size());
+      AssertDimension(temporary_storage.size(), n_import_indices());
+      Assert(ghost_array.size() == n_ghost_indices() ||
+             ghost_array.size() == n_ghost_indices_in_larger_set,
+             ExcGhostIndexArrayHasWrongSize(ghost_array.size(), n_ghost_indices(),
+                                            n_ghost_indices_in_larger_set));
+
+      const unsigned int n_import_targets = import_targets_data.size();
+      const unsigned int n_ghost_targets = ghost_targets_data.size();
+
+      Assert(requests.size() == 0,
+             ExcMessage("Another operation seems to still be running. "
+                        "Call update_ghost_values_finish() first."));
+
+      // set up the persistent requests in the first call with the given
+      // arrays, in the same layout as the non-persistent version above
+      if (persistent_requests.check_and_bind(this, communication_channel, sizeof(Number),
+                                             temporary_storage.begin(), ghost_array.begin(),
+                                             ghost_array.size()) == false)
+        {
+          persistent_requests.requests.resize(n_ghost_targets+n_import_targets);
+
+          AssertIndexRange(n_ghost_indices(), n_ghost_indices_in_larger_set+1);
+          const bool use_larger_set = (n_ghost_indices_in_larger_set > n_ghost_indices() &&
+                                       ghost_array.size() == n_ghost_indices_in_larger_set);
+          Number *ghost_array_ptr = use_larger_set ?
+                                    ghost_array.begin()+
+                                    n_ghost_indices_in_larger_set-n_ghost_indices()
+                                    : ghost_array.begin();
+          for (unsigned int i=0; i<n_ghost_targets; i++)
+            {
+              const int ierr = MPI_Recv_init (ghost_array_ptr,
+                                              ghost_targets_data[i].second*sizeof(Number),
+                                              MPI_BYTE,
+                                              ghost_targets_data[i].first,
+                                              ghost_targets_data[i].first + communication_channel,
+                                              communicator,
+                                              &persistent_requests.requests[i]);
+              AssertThrowMPI (ierr);
+              ghost_array_ptr += ghost_targets_data[i].second;
+            }
+
+          Number *temp_array_ptr = temporary_storage.begin();
+          for (unsigned int i=0; i<n_import_targets; i++)
+            {
+              const int ierr = MPI_Send_init (temp_array_ptr,
+                                              import_targets_data[i].second*sizeof(Number),
+                                              MPI_BYTE,
+                                              import_targets_data[i].first,
+                                              my_pid + communication_channel,
+                                              communicator,
+                                              &persistent_requests.requests[n_ghost_targets+i]);
+              AssertThrowMPI (ierr);
+              temp_array_ptr += import_targets_data[i].second;
+            }
+        }
+      AssertDimension(persistent_requests.requests.size(),
+                      n_ghost_targets+n_import_targets);
+      requests = persistent_requests.requests;
+
+      // as in the non-persistent case, first start the receives, then pack
+      // the data and start the sends
+      if (n_ghost_targets > 0)
+        {
+          const int ierr = MPI_Startall (n_ghost_targets, requests.data());
+          AssertThrowMPI (ierr);
+        }
+
+      if (n_import_targets > 0)
+        {
+          const Number *end_of_packed_data =
+            internal::pack_ranges(import_indices_data.begin(), import_indices_data.end(),
+                                  locally_owned_array, temporary_storage.begin());
+          (void)end_of_packed_data;
+          AssertDimension(end_of_packed_data-temporary_storage.begin(), n_import_indices());
+
+          const int ierr = MPI_Startall (n_import_targets, requests.data()+n_ghost_targets);
+          AssertThrowMPI (ierr);
+        }
+
+      // let the progress engine test the requests while the caller works on
+      // other data
+      Utilities::MPI::ProgressEngine::add_requests (requests);
     }
 
 
@@ -121,6 +246,8 @@ namespace Utilities
     Partitioner::export_to_ghosted_array_finish(const ArrayView<Number>  &ghost_array,
                                                 std::vector<MPI_Request> &requests) const
     {
+      Utilities::MPI::ProgressEngine::remove_requests (requests);
+
       Assert(ghost_array.size() == n_ghost_indices() ||
              ghost_array.size() == n_ghost_indices_in_larger_set,
              ExcGhostIndexArrayHasWrongSize(ghost_array.size(), n_ghost_indices(),
@@ -279,6 +406,135 @@ namespace Utilities
 
           ghost_array_ptr += ghost_targets_data[i].second;
         }
+
+      // let the progress engine test the requests while the caller works on
+      // other data
+      Utilities::MPI::ProgressEngine::add_requests (requests);
+    }
+
+
+
+    template <typename Number>
+    void
+    Partitioner::import_from_ghosted_array_start(const VectorOperation::values vector_operation,
+                                                 const unsigned int            communication_channel,
+                                                 const ArrayView<Number>      &ghost_array,
+                                                 const ArrayView<Number>      &temporary_storage,
+                                                 std::vector<MPI_Request>     &requests,
+                                                 PersistentRequests           &persistent_requests) const
+    {
+      AssertDimension(temporary_storage.size(), n_import_indices());
+      Assert(ghost_array.size() == n_ghost_indices() ||
+             ghost_array.size() == n_ghost_indices_in_larger_set,
+             ExcGhostIndexArrayHasWrongSize(ghost_array.size(), n_ghost_indices(),
+                                            n_ghost_indices_in_larger_set));
+
+      (void)vector_operation;
+
+      // same shortcuts as in the non-persistent version above
+#ifndef DEBUG
+      if (vector_operation == VectorOperation::insert)
+        return;
+#endif
+      if (n_ghost_indices()==0 && n_import_indices()==0)
+        return;
+
+      const unsigned int n_import_targets = import_targets_data.size();
+      const unsigned int n_ghost_targets  = ghost_targets_data.size();
+
+      Assert(requests.size() == 0,
+             ExcMessage("Another compress operation seems to still be running. "
+                        "Call compress_finish() first."));
+
+      // set channels in different range from update_ghost_values channels
+      const unsigned int channel = communication_channel + 401;
+
+      // set up the persistent requests in the first call with the given
+      // arrays, in the same layout as the non-persistent version above
+      if (persistent_requests.check_and_bind(this, channel, sizeof(Number),
+                                             ghost_array.begin(), temporary_storage.begin(),
+                                             ghost_array.size()) == false)
+        {
+          persistent_requests.requests.resize(n_import_targets+n_ghost_targets);
+
+          Number *temp_array_ptr = temporary_storage.begin();
+          for (unsigned int i=0; i<n_import_targets; i++)
+            {
+              AssertThrow (static_cast<std::size_t>(import_targets_data[i].second)*
+                           sizeof(Number) <
+                           static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                           ExcMessage("Index overflow: Maximum message size in MPI is 2GB. "
+                                      "The number of ghost entries times the size of 'Number' "
+                                      "exceeds this value. This is not supported."));
+              const int ierr = MPI_Recv_init (temp_array_ptr,
+                                              import_targets_data[i].second*sizeof(Number),
+                                              MPI_BYTE,
+                                              import_targets_data[i].first,
+                                              import_targets_data[i].first + channel,
+                                              communicator,
+                                              &persistent_requests.requests[i]);
+              AssertThrowMPI (ierr);
+              temp_array_ptr += import_targets_data[i].second;
+            }
+
+          Number *ghost_array_ptr = ghost_array.begin();
+          for (unsigned int i=0; i<n_ghost_targets; i++)
+            {
+              AssertThrow (static_cast<std::size_t>(ghost_targets_data[i].second)*
+                           sizeof(Number) <
+                           static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                           ExcMessage("Index overflow: Maximum message size in MPI is 2GB. "
+                                      "The number of ghost entries times the size of 'Number' "
+                                      "exceeds this value. This is not supported."));
+              const int ierr = MPI_Send_init (ghost_array_ptr,
+                                              ghost_targets_data[i].second*sizeof(Number),
+                                              MPI_BYTE,
+                                              ghost_targets_data[i].first,
+                                              this_mpi_process() + channel,
+                                              communicator,
+                                              &persistent_requests.requests[n_import_targets+i]);
+              AssertThrowMPI (ierr);
+              ghost_array_ptr += ghost_targets_data[i].second;
+            }
+        }
+      AssertDimension(persistent_requests.requests.size(),
+                      n_import_targets+n_ghost_targets);
+      requests = persistent_requests.requests;
+
+      if (n_import_targets > 0)
+        {
+          const int ierr = MPI_Startall (n_import_targets, requests.data());
+          AssertThrowMPI (ierr);
+        }
+
+      // in case we want to import only from a subset of the ghosts, move the
+      // data to send to the front of the array before starting the sends
+      AssertIndexRange(n_ghost_indices(), n_ghost_indices_in_larger_set+1);
+      if (n_ghost_indices_in_larger_set > n_ghost_indices() &&
+          ghost_array.size() == n_ghost_indices_in_larger_set)
+        {
+          Number *ghost_array_ptr = ghost_array.begin();
+          for (std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
+               my_ghosts = ghost_indices_subset_data.begin();
+               my_ghosts != ghost_indices_subset_data.end(); ++my_ghosts)
+            for (unsigned int j=my_ghosts->first; j<my_ghosts->second; ++j, ++ghost_array_ptr)
+              if (ghost_array_ptr != ghost_array.begin() + j)
+                {
+                  *ghost_array_ptr = ghost_array[j];
+                  ghost_array[j] = Number();
+                }
+          AssertDimension(ghost_array_ptr-ghost_array.begin(), n_ghost_indices());
+        }
+
+      if (n_ghost_targets > 0)
+        {
+          const int ierr = MPI_Startall (n_ghost_targets, requests.data()+n_import_targets);
+          AssertThrowMPI (ierr);
+        }
+
+      // let the progress engine test the requests while the caller works on
+      // other data
+      Utilities::MPI::ProgressEngine::add_requests (requests);
     }
 
 
@@ -308,14 +564,16 @@ namespace Utilities
 
 
 
-    template <typename Number>
+    template <typename Number, typename TransferNumber>
     void
-    Partitioner::import_from_ghosted_array_finish(const VectorOperation::values  vector_operation,
-                                                  const ArrayView<const Number> &temporary_storage,
-                                                  const ArrayView<Number>       &locally_owned_array,
-                                                  const ArrayView<Number>       &ghost_array,
-                                                  std::vector<MPI_Request>      &requests) const
+    Partitioner::import_from_ghosted_array_finish(const VectorOperation::values          vector_operation,
+                                                  const ArrayView<const TransferNumber> &temporary_storage,
+                                                  const ArrayView<Number>               &locally_owned_array,
+                                                  const ArrayView<TransferNumber>       &ghost_array,
+                                                  std::vector<MPI_Request>              &requests) const
     {
+      Utilities::MPI::ProgressEngine::remove_requests (requests);
+
       AssertDimension(locally_owned_array.size(), local_size());
       AssertDimension(temporary_storage.size(), n_import_indices());
       Assert(ghost_array.size() == n_ghost_indices() ||
@@ -334,7 +592,7 @@ namespace Utilities
                                   "vector_operation argument was passed to "
                                   "import_from_ghosted_array_start as is passed "
                                   "to import_from_ghosted_array_finish."));
-          std::memset(ghost_array.begin(), 0, sizeof(Number)*ghost_array.size());
+          std::memset(ghost_array.begin(), 0, sizeof(TransferNumber)*ghost_array.size());
           return;
         }
 #endif
@@ -357,7 +615,7 @@ namespace Utilities
                                         MPI_STATUSES_IGNORE);
           AssertThrowMPI(ierr);
 
-          const Number *read_position = temporary_storage.begin();
+          const TransferNumber *read_position = temporary_storage.begin();
           std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
           my_imports = import_indices_data.begin();
 
@@ -367,8 +625,13 @@ namespace Utilities
           // the ones already present
           if (vector_operation != dealii::VectorOperation::insert)
             for ( ; my_imports!=import_indices_data.end(); ++my_imports)
-              for (unsigned int j=my_imports->first; j<my_imports->second; j++)
-                locally_owned_array[j] += *read_position++;
+              {
+                Number *write_position = locally_owned_array.begin() + my_imports->first;
+                const unsigned int n_entries = my_imports->second - my_imports->first;
+                for (unsigned int j=0; j<n_entries; ++j)
+                  write_position[j] += read_position[j];
+                read_position += n_entries;
+              }
           else
             for ( ; my_imports!=import_indices_data.end(); ++my_imports)
               for (unsigned int j=my_imports->first; j<my_imports->second;
@@ -378,13 +641,15 @@ namespace Utilities
                 // The rationale is that during interpolation on two elements sharing
                 // the face, values on this face obtained from each side might
                 // be different due to additions being done in different order.
-                Assert(*read_position == Number() ||
-                       internal::get_abs(locally_owned_array[j] - *read_position) <=
-                       internal::get_abs(locally_owned_array[j] + *read_position) *
+                // The precision is the one of the transferred data, as the
+                // values might have been rounded to a lower precision.
+                Assert(*read_position == TransferNumber() ||
+                       internal::get_abs(locally_owned_array[j] - Number(*read_position)) <=
+                       internal::get_abs(locally_owned_array[j] + Number(*read_position)) *
                        100000. *
-                       std::numeric_limits<typename numbers::NumberTraits<Number>::real_type>::epsilon(),
+                       std::numeric_limits<typename numbers::NumberTraits<TransferNumber>::real_type>::epsilon(),
                        typename LinearAlgebra::distributed::Vector<Number>::
-                       ExcNonMatchingElements(*read_position, locally_owned_array[j],
+                       ExcNonMatchingElements(Number(*read_position), locally_owned_array[j],
                                               my_pid));
           AssertDimension(read_position-temporary_storage.begin(), n_import_indices());
         }
@@ -402,13 +667,53 @@ namespace Utilities
 
       // clear the ghost array in case we did not yet do that in the _start
       // function
-      std::memset(ghost_array.begin(), 0, sizeof(Number)*n_ghost_indices());
+      std::memset(ghost_array.begin(), 0, sizeof(TransferNumber)*n_ghost_indices());
 
       // clear the compress requests
       requests.resize(0);
     }
 
 
+
+
+    template <typename Number>
+    void
+    SharedMemoryExchange::export_to_ghosted_array_shared (const std::vector<ArrayView<const Number> > &shared_arrays,
+                                                          const ArrayView<Number>                       &ghost_array) const
+    {
+      AssertDimension(ghost_array.size(), partitioner->n_ghost_indices());
+      for (const Transfer &transfer : ghost_transfers)
+        {
+          AssertIndexRange(transfer.rank, shared_arrays.size());
+          AssertIndexRange(transfer.remote_start+transfer.length,
+                           shared_arrays[transfer.rank].size()+1);
+          const Number *source = shared_arrays[transfer.rank].begin() + transfer.remote_start;
+          std::copy(source, source+transfer.length,
+                    ghost_array.begin()+transfer.local_start);
+        }
+    }
+
+
+
+    template <typename Number>
+    void
+    SharedMemoryExchange::import_from_ghosted_array_shared (const std::vector<ArrayView<const Number> > &shared_arrays,
+                                                            const ArrayView<Number>                       &locally_owned_array) const
+    {
+      AssertDimension(locally_owned_array.size(), partitioner->local_size());
+      for (const Transfer &transfer : import_transfers)
+        {
+          AssertIndexRange(transfer.rank, shared_arrays.size());
+          AssertIndexRange(transfer.remote_start+transfer.length,
+                           shared_arrays[transfer.rank].size()+1);
+          const Number *source = shared_arrays[transfer.rank].begin() + transfer.remote_start;
+          Number *destination = locally_owned_array.begin() + transfer.local_start;
+          for (unsigned int j=0; j<transfer.length; ++j)
+            destination[j] += source[j];
+        }
+    }
+
+
 #endif  // ifdef DEAL_II_WITH_MPI
 #endif  // ifndef DOXYGEN
 
@@ -0,0 +1,161 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_performance_counters_h
+#define dealii_performance_counters_h
+
+
+#include <deal.II/base/config.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * Functions to mark regions of a program in which hardware performance
+ * counters are collected with the marker API of the LIKWID library. When
+ * the program is run through <code>likwid-perfctr -m -g GROUP</code>, LIKWID
+ * reports the run time, the number of calls and the derived metrics of the
+ * selected performance group, such as GFLOP/s for the group FLOPS_DP or the
+ * memory bandwidth in GB/s for the group MEM, separately for each region.
+ *
+ * Regions are entered and left for the calling thread only. Besides the
+ * regions defined by user code, the library defines regions for some
+ * performance critical operations, namely "SparseMatrix::vmult",
+ * "MatrixFree::cell_loop", "MatrixFree::loop" and
+ * "PreconditionChebyshev::vmult". In addition,
+ * each section of a TimerOutput object is also a LIKWID region of the same
+ * name.
+ *
+ * The regions are only recorded if deal.II has been configured with
+ * <code>DEAL_II_WITH_LIKWID=ON</code>. Otherwise, all functions of this
+ * namespace are empty inline functions, such that the instrumentation does
+ * not cause any overhead.
+ *
+ * @ingroup utilities
+ */
+namespace PerformanceCounters
+{
+  /**
+   * Initialize the marker API. This function is called by the constructor
+   * of Utilities::MPI::MPI_InitFinalize, so it only needs to be called by
+   * programs that do not create an object of this class. It must be called
+   * before any region is entered.
+   */
+  void initialize ();
+
+  /**
+   * Finalize the marker API and write the collected counters for
+   * likwid-perfctr. This function is called by the destructor of
+   * Utilities::MPI::MPI_InitFinalize.
+   */
+  void finalize ();
+
+  /**
+   * Start collecting the counters of the region @p region_name on the
+   * calling thread.
+   */
+  void start_region (const char *region_name);
+
+  /**
+   * Stop collecting the counters of the region @p region_name on the calling
+   * thread.
+   */
+  void stop_region (const char *region_name);
+
+  /**
+   * A class that starts a region when it is constructed and stops it when it
+   * is destroyed.
+   */
+  class Region
+  {
+  public:
+    /**
+     * Constructor. Start the region @p region_name, which must stay valid
+     * until the object is destroyed.
+     */
+    explicit Region (const char *region_name);
+
+    /**
+     * Destructor. Stop the region.
+     */
+    ~Region ();
+
+  private:
+    /**
+     * The name of the region.
+     */
+    const char *region_name;
+  };
+}
+
+
+/* ---------------- inline functions ----------------- */
+
+#ifndef DEAL_II_WITH_LIKWID
+
+namespace PerformanceCounters
+{
+  inline
+  void
+  initialize ()
+  {}
+
+
+
+  inline
+  void
+  finalize ()
+  {}
+
+
+
+  inline
+  void
+  start_region (const char *)
+  {}
+
+
+
+  inline
+  void
+  stop_region (const char *)
+  {}
+}
+
+#endif
+
+
+
+namespace PerformanceCounters
+{
+  inline
+  Region::Region (const char *region_name)
+    :
+    region_name (region_name)
+  {
+    start_region (region_name);
+  }
+
+
+
+  inline
+  Region::~Region ()
+  {
+    stop_region (region_name);
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -23,6 +23,7 @@
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/point.h>
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -129,6 +130,24 @@ namespace Polynomials
                 const unsigned int n_derivatives,
                 number *values) const;
 
+    /**
+     * Evaluate the polynomial and its derivatives at several points at
+     * once. On exit, <tt>values[k][e], k=0,...,n_derivatives</tt>, contains
+     * the <tt>k</tt>th derivative at the point <tt>points[e]</tt>, so @p
+     * values has to provide space for @p n_derivatives + 1 arrays.
+     *
+     * The loops over the coefficients (or the roots in case of the product
+     * form) are shared by all points, and the innermost loop runs over the
+     * @p n_entries points, which the compiler can vectorize. No memory is
+     * allocated. The type @p Number2 can be a floating point type or
+     * VectorizedArray, in which case a single call evaluates the polynomial
+     * for <tt>n_entries * VectorizedArray::n_array_elements</tt> points.
+     */
+    template <std::size_t n_entries, typename Number2>
+    void values_of_array (const std::array<Number2,n_entries> &points,
+                          const unsigned int                   n_derivatives,
+                          std::array<Number2,n_entries>       *values) const;
+
     /**
      * Degree of the polynomial. This is the degree reflected by the number of
      * coefficients provided by the constructor. Leading non-zero coefficients
@@ -652,6 +671,75 @@ namespace Polynomials
 
 
 
+  template <typename number>
+  template <std::size_t n_entries, typename Number2>
+  inline
+  void
+  Polynomial<number>::values_of_array (const std::array<Number2,n_entries> &points,
+                                       const unsigned int                   n_derivatives,
+                                       std::array<Number2,n_entries>       *values) const
+  {
+    // both representations compute the scaled derivatives p^(k)(x)/k! in a
+    // Horner-like fashion, starting from the highest derivative because it
+    // uses the value of the next lower derivative from the previous step
+    if (in_lagrange_product_form == true)
+      {
+        for (unsigned int e=0; e<n_entries; ++e)
+          values[0][e] = 1.;
+        for (unsigned int k=1; k<=n_derivatives; ++k)
+          for (unsigned int e=0; e<n_entries; ++e)
+            values[k][e] = 0.;
+
+        const unsigned int n_supp = lagrange_support_points.size();
+        for (unsigned int i=0; i<n_supp; ++i)
+          {
+            const number x_i = lagrange_support_points[i];
+            for (unsigned int e=0; e<n_entries; ++e)
+              {
+                const Number2 v = points[e] - x_i;
+                for (unsigned int k=n_derivatives; k>0; --k)
+                  values[k][e] = values[k][e] * v + values[k-1][e];
+                values[0][e] *= v;
+              }
+          }
+      }
+    else
+      {
+        Assert (coefficients.size() > 0, ExcEmptyObject());
+
+        const unsigned int m = coefficients.size();
+        for (unsigned int e=0; e<n_entries; ++e)
+          values[0][e] = coefficients.back();
+        for (unsigned int k=1; k<=n_derivatives; ++k)
+          for (unsigned int e=0; e<n_entries; ++e)
+            values[k][e] = 0.;
+
+        for (int j=m-2; j>=0; --j)
+          {
+            const number a_j = coefficients[j];
+            for (unsigned int e=0; e<n_entries; ++e)
+              {
+                for (unsigned int k=n_derivatives; k>0; --k)
+                  values[k][e] = values[k][e] * points[e] + values[k-1][e];
+                values[0][e] = values[0][e] * points[e] + a_j;
+              }
+          }
+      }
+
+    // transform the scaled derivatives into the actual derivatives and apply
+    // the Lagrange weight
+    number k_faculty = in_lagrange_product_form ? lagrange_weight : 1.;
+    for (unsigned int k=0; k<=n_derivatives; ++k)
+      {
+        if (k_faculty != static_cast<number>(1.))
+          for (unsigned int e=0; e<n_entries; ++e)
+            values[k][e] = values[k][e] * k_faculty;
+        k_faculty *= static_cast<number>(k+1);
+      }
+  }
+
+
+
   template <typename number>
   template <class Archive>
   inline
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1998 - 2016 by the deal.II authors
+// Copyright (C) 1998 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -268,9 +268,11 @@ protected:
 
   /**
    * Stores the one-dimensional tensor basis objects in case this object
-   * can be represented by a tensor product.
+   * can be represented by a tensor product. The objects are set up by the
+   * constructors and not changed afterwards, so copies of this object
+   * share them.
    */
-  std::unique_ptr<std::array<Quadrature<1>,dim>> tensor_basis;
+  std::shared_ptr<std::array<Quadrature<1>,dim>> tensor_basis;
 };
 
 
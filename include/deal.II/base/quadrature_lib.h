@@ -33,6 +33,12 @@ DEAL_II_NAMESPACE_OPEN
  * href="http://en.wikipedia.org/wiki/Numerical_Recipes">Numerical
  * Recipes</a>.
  *
+ * The formulas are only computed the first time a formula with a given
+ * number of points is requested in a given dimension. All further objects
+ * with the same number of points are copied from a thread-safe global
+ * cache, which avoids repeating the Newton iteration and the tensor product
+ * when, e.g., FEValues objects are created repeatedly.
+ *
  * @author Guido Kanschat, 2001
  */
 template <int dim>
@@ -69,6 +75,9 @@ public:
  * Karniadakis, G.E. and Sherwin, S.J.: Spectral/hp element methods for
  * computational fluid dynamics. Oxford: Oxford University Press, 2005
  *
+ * As for QGauss, the formulas are computed once for each number of points
+ * and dimension and copied from a global cache afterwards.
+ *
  * @author Guido Kanschat, 2005, 2006; F. Prill, 2006
  */
 template <int dim>
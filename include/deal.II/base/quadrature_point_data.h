@@ -18,6 +18,7 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/base/array_view.h>
 #include <deal.II/base/quadrature.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/grid/tria.h>
@@ -151,6 +152,83 @@ private:
 };
 
 
+
+/**
+ * A class for storing the same number of objects of a single, concrete type
+ * @p DataType at each active cell represented by iterators of type
+ * @p CellIteratorType, in one contiguous array.
+ *
+ * In contrast to CellDataStorage, the objects are neither allocated one by
+ * one on the heap nor looked up in a map: The data of a cell is found at the
+ * position given by the active cell index times the number of data points
+ * per cell. Accessing the data via get_data() is thus a constant-time
+ * operation returning an ArrayView into the array. The price for this is
+ * that all cells store objects of the same type @p DataType, rather than of
+ * different classes derived from a common base class, and that the data is
+ * invalidated whenever the active cell indices change, i.e., when the
+ * triangulation is refined, coarsened or repartitioned. In that case,
+ * initialize() must be called again before the data is accessed, possibly
+ * in combination with
+ * parallel::distributed::ContinuousQuadratureDataTransfer.
+ */
+template <typename CellIteratorType, typename DataType>
+class ContiguousCellDataStorage : public Subscriptor
+{
+public:
+  /**
+   * Default constructor.
+   */
+  ContiguousCellDataStorage();
+
+  /**
+   * Set up the storage for @p number_of_data_points_per_cell default
+   * constructed objects on each active cell of the triangulation that
+   * @p cell_start belongs to. The objects of all active cells are created,
+   * but only the cells in the range from @p cell_start until, but not
+   * including, @p cell_end that are locally owned are expected to be
+   * accessed. All data previously stored in this object is discarded.
+   *
+   * @pre @p DataType needs to be default constructible.
+   */
+  void initialize(const CellIteratorType &cell_start,
+                  const CellIteratorType &cell_end,
+                  const unsigned int      number_of_data_points_per_cell);
+
+  /**
+   * Clear all the data stored in this object.
+   */
+  void clear();
+
+  /**
+   * Return the number of data points stored on each cell.
+   */
+  unsigned int n_data_points_per_cell() const;
+
+  /**
+   * Return the data located at the active @p cell.
+   */
+  ArrayView<DataType> get_data(const CellIteratorType &cell);
+
+  /**
+   * Return a read-only view of the data located at the active @p cell.
+   */
+  ArrayView<const DataType> get_data(const CellIteratorType &cell) const;
+
+private:
+  /**
+   * The number of data points on each cell.
+   */
+  unsigned int data_points_per_cell;
+
+  /**
+   * The data of all cells, with the data of the active cell with index
+   * <code>i</code> starting at position
+   * <code>i*data_points_per_cell</code>.
+   */
+  std::vector<DataType> data;
+};
+
+
 /**
  * An abstract class which specifies requirements for data on
  * a single quadrature point to be transferable during refinement or repartitioning.
@@ -361,6 +439,15 @@ namespace parallel
       void prepare_for_coarsening_and_refinement (parallel::distributed::Triangulation<dim> &tria,
                                                   CellDataStorage<CellIteratorType,DataType> &data_storage);
 
+      /**
+       * Same as above for data stored in a ContiguousCellDataStorage
+       * object. Since the active cell indices change with the mesh, the
+       * user is expected to call ContiguousCellDataStorage::initialize() on
+       * @p data_storage for the new mesh before calling interpolate().
+       */
+      void prepare_for_coarsening_and_refinement (parallel::distributed::Triangulation<dim> &tria,
+                                                  ContiguousCellDataStorage<CellIteratorType,DataType> &data_storage);
+
       /**
        * Interpolate the data previously stored in this object before the mesh
        * was refined or coarsened onto the quadrature points of the currently active
@@ -374,6 +461,13 @@ namespace parallel
       void interpolate ();
 
     private:
+      /**
+       * Set up the projection matrices for @p number_of_values values per
+       * quadrature point on the locally owned cells and attach the data to
+       * the triangulation.
+       */
+      void register_data_attach (const unsigned int number_of_values);
+
       /**
        * A callback function used to pack the data on the current mesh into
        * objects that can later be retrieved after refinement, coarsening and
@@ -448,6 +542,12 @@ namespace parallel
        */
       CellDataStorage<CellIteratorType,DataType> *data_storage;
 
+      /**
+       * A pointer to the ContiguousCellDataStorage class whose data will be
+       * transfered, if the data is stored in this format.
+       */
+      ContiguousCellDataStorage<CellIteratorType,DataType> *contiguous_data_storage;
+
       /**
        * A pointer to the distributed triangulation to which cell data is attached.
        */
@@ -586,6 +686,85 @@ CellDataStorage<CellIteratorType,DataType>::get_data(const CellIteratorType &cel
   return res;
 }
 
+//--------------------------------------------------------------------
+//                      ContiguousCellDataStorage
+//--------------------------------------------------------------------
+
+template <typename CellIteratorType, typename DataType>
+ContiguousCellDataStorage<CellIteratorType,DataType>::ContiguousCellDataStorage()
+  :
+  data_points_per_cell (0)
+{}
+
+
+
+template <typename CellIteratorType, typename DataType>
+void
+ContiguousCellDataStorage<CellIteratorType,DataType>::initialize(const CellIteratorType &cell_start,
+    const CellIteratorType &cell_end,
+    const unsigned int      number)
+{
+  data.clear();
+  data_points_per_cell = number;
+  if (cell_start == cell_end)
+    return;
+
+  // create the objects in one go rather than on each cell, which also
+  // places the data of the cells in the order of the active cell index
+  data.resize(static_cast<std::size_t>(cell_start->get_triangulation().n_active_cells()) *
+              number);
+}
+
+
+
+template <typename CellIteratorType, typename DataType>
+void
+ContiguousCellDataStorage<CellIteratorType,DataType>::clear()
+{
+  std::vector<DataType>().swap(data);
+  data_points_per_cell = 0;
+}
+
+
+
+template <typename CellIteratorType, typename DataType>
+inline
+unsigned int
+ContiguousCellDataStorage<CellIteratorType,DataType>::n_data_points_per_cell() const
+{
+  return data_points_per_cell;
+}
+
+
+
+template <typename CellIteratorType, typename DataType>
+inline
+ArrayView<DataType>
+ContiguousCellDataStorage<CellIteratorType,DataType>::get_data(const CellIteratorType &cell)
+{
+  const std::size_t start = static_cast<std::size_t>(cell->active_cell_index()) *
+                            data_points_per_cell;
+  Assert(start + data_points_per_cell <= data.size(),
+         ExcMessage("Could not find data for the cell. Did you call "
+                    "initialize() after the last change of the triangulation?"));
+  return ArrayView<DataType>(data.data() + start, data_points_per_cell);
+}
+
+
+
+template <typename CellIteratorType, typename DataType>
+inline
+ArrayView<const DataType>
+ContiguousCellDataStorage<CellIteratorType,DataType>::get_data(const CellIteratorType &cell) const
+{
+  const std::size_t start = static_cast<std::size_t>(cell->active_cell_index()) *
+                            data_points_per_cell;
+  Assert(start + data_points_per_cell <= data.size(),
+         ExcMessage("Could not find data for the cell. Did you call "
+                    "initialize() after the last change of the triangulation?"));
+  return ArrayView<const DataType>(data.data() + start, data_points_per_cell);
+}
+
 //--------------------------------------------------------------------
 //                    ContinuousQuadratureDataTransfer
 //--------------------------------------------------------------------
@@ -657,6 +836,68 @@ void unpack_to_cell_data
 }
 
 
+/*
+ * Same as above for the data of ContiguousCellDataStorage.
+ */
+template <typename CellIteratorType, typename DataType>
+void pack_cell_data
+(const CellIteratorType &cell,
+ const ContiguousCellDataStorage<CellIteratorType,DataType> *data_storage,
+ FullMatrix<double> &matrix_data)
+{
+  static_assert(std::is_base_of<TransferableQuadraturePointData, DataType>::value,
+                "User's DataType class should be derived from QPData");
+
+  const ArrayView<const DataType> qpd = data_storage->get_data(cell);
+
+  const unsigned int n = matrix_data.n();
+
+  std::vector<double> single_qp_data(n);
+  Assert (qpd.size() == matrix_data.m(),
+          ExcDimensionMismatch(qpd.size(), matrix_data.m()));
+  for (unsigned int q = 0; q < qpd.size(); q++)
+    {
+      qpd[q].pack_values(single_qp_data);
+      Assert (single_qp_data.size() == n,
+              ExcDimensionMismatch(single_qp_data.size(),n));
+
+      for (unsigned int i = 0; i < n; i++)
+        matrix_data(q,i) = single_qp_data[i];
+    }
+}
+
+
+
+
+/*
+ * Same as above for the data of ContiguousCellDataStorage.
+ */
+template <typename CellIteratorType, typename DataType>
+void unpack_to_cell_data
+(const CellIteratorType &cell,
+ const FullMatrix<double> &values_at_qp,
+ ContiguousCellDataStorage<CellIteratorType,DataType> *data_storage)
+{
+  static_assert(std::is_base_of<TransferableQuadraturePointData, DataType>::value,
+                "User's DataType class should be derived from QPData");
+
+  const ArrayView<DataType> qpd = data_storage->get_data(cell);
+
+  const unsigned int n = values_at_qp.n();
+
+  std::vector<double> single_qp_data(n);
+  Assert(qpd.size() == values_at_qp.m(),
+         ExcDimensionMismatch(qpd.size(), values_at_qp.m()));
+
+  for (unsigned int q = 0; q < qpd.size(); q++)
+    {
+      for (unsigned int i = 0; i < n; i++)
+        single_qp_data[i] = values_at_qp(q,i);
+      qpd[q].unpack_values(single_qp_data);
+    }
+}
+
+
 #ifdef DEAL_II_WITH_P4EST
 
 namespace parallel
@@ -676,6 +917,7 @@ namespace parallel
       project_to_qp_matrix(n_q_points,projection_fe->dofs_per_cell),
       offset(0),
       data_storage(nullptr),
+      contiguous_data_storage(nullptr),
       triangulation(nullptr)
     {
       Assert(projection_fe->n_components() == 1,
@@ -706,7 +948,7 @@ namespace parallel
     (parallel::distributed::Triangulation<dim> &tr_,
      CellDataStorage<CellIteratorType,DataType> &data_storage_)
     {
-      Assert (data_storage == nullptr,
+      Assert (data_storage == nullptr && contiguous_data_storage == nullptr,
               ExcMessage("This function can be called only once"));
       triangulation = &tr_;
       data_storage = &data_storage_;
@@ -722,6 +964,38 @@ namespace parallel
             number_of_values = qpd[0]->number_of_values();
             break;
           }
+      register_data_attach (number_of_values);
+    }
+
+
+
+    template <int dim, typename DataType>
+    void ContinuousQuadratureDataTransfer<dim,DataType>::prepare_for_coarsening_and_refinement
+    (parallel::distributed::Triangulation<dim> &tr_,
+     ContiguousCellDataStorage<CellIteratorType,DataType> &data_storage_)
+    {
+      Assert (data_storage == nullptr && contiguous_data_storage == nullptr,
+              ExcMessage("This function can be called only once"));
+      triangulation = &tr_;
+      contiguous_data_storage = &data_storage_;
+      unsigned int number_of_values = 0;
+      for (typename parallel::distributed::Triangulation<dim>::active_cell_iterator it = triangulation->begin_active();
+           it != triangulation->end(); it++)
+        if (it->is_locally_owned())
+          {
+            number_of_values = contiguous_data_storage->get_data(it)[0].number_of_values();
+            break;
+          }
+      register_data_attach (number_of_values);
+    }
+
+
+
+    template <int dim, typename DataType>
+    void ContinuousQuadratureDataTransfer<dim,DataType>::register_data_attach
+    (const unsigned int local_number_of_values)
+    {
+      unsigned int number_of_values = local_number_of_values;
       // some processors may have no data stored, thus get the maximum among all processors:
       number_of_values = Utilities::MPI::max(number_of_values, triangulation->get_communicator ());
       Assert (number_of_values > 0,
@@ -754,6 +1028,7 @@ namespace parallel
 
       // invalidate the pointers
       data_storage = nullptr;
+      contiguous_data_storage = nullptr;
       triangulation = nullptr;
     }
 
@@ -767,7 +1042,10 @@ namespace parallel
     {
       double *data_store = reinterpret_cast<double *>(data);
 
-      pack_cell_data(cell,data_storage,matrix_quadrature);
+      if (contiguous_data_storage != nullptr)
+        pack_cell_data(cell,contiguous_data_storage,matrix_quadrature);
+      else
+        pack_cell_data(cell,data_storage,matrix_quadrature);
 
       // project to FE
       project_to_fe_matrix.mmult(matrix_dofs, matrix_quadrature);
@@ -804,8 +1082,12 @@ namespace parallel
                 // now we do the usual business of evaluating FE on quadrature points:
                 project_to_qp_matrix.mmult(matrix_quadrature,matrix_dofs_child);
 
-                // finally, put back into the map:
-                unpack_to_cell_data(cell->child(child),matrix_quadrature,data_storage);
+                // finally, put back into the storage:
+                if (contiguous_data_storage != nullptr)
+                  unpack_to_cell_data(cell->child(child),matrix_quadrature,
+                                      contiguous_data_storage);
+                else
+                  unpack_to_cell_data(cell->child(child),matrix_quadrature,data_storage);
               }
         }
       else
@@ -814,8 +1096,11 @@ namespace parallel
           // rhs_quadrature points.
           project_to_qp_matrix.mmult(matrix_quadrature,matrix_dofs);
 
-          // finally, put back into the map:
-          unpack_to_cell_data(cell,matrix_quadrature,data_storage);
+          // finally, put back into the storage:
+          if (contiguous_data_storage != nullptr)
+            unpack_to_cell_data(cell,matrix_quadrature,contiguous_data_storage);
+          else
+            unpack_to_cell_data(cell,matrix_quadrature,data_storage);
         }
     }
 
@@ -1248,11 +1248,13 @@ namespace internal
 
         // scale last row and column as mentioned
         // above
-        tmp.data[2][0] /= 2;
-        tmp.data[2][1] /= 2;
-        tmp.data[0][2] /= 2;
-        tmp.data[1][2] /= 2;
-        tmp.data[2][2] /= 4;
+        const Number half = internal::NumberType<Number>::value(0.5),
+                     quarter = internal::NumberType<Number>::value(0.25);
+        tmp.data[2][0] *= half;
+        tmp.data[2][1] *= half;
+        tmp.data[0][2] *= half;
+        tmp.data[1][2] *= half;
+        tmp.data[2][2] *= quarter;
 
         return tmp;
       }
@@ -1362,6 +1364,35 @@ namespace internal
       }
     };
 
+
+    /**
+     * The inversion with pivoting cannot be done on all entries of a
+     * VectorizedArray at once, since the pivots differ between them.
+     * Therefore, invert the tensor of each entry separately.
+     */
+    template <typename Number>
+    struct Inverse<4,3,VectorizedArray<Number> >
+    {
+      static dealii::SymmetricTensor<4,3,VectorizedArray<Number> >
+      value (const dealii::SymmetricTensor<4,3,VectorizedArray<Number> > &t)
+      {
+        const unsigned int n_components
+          = dealii::SymmetricTensor<4,3,Number>::n_independent_components;
+        dealii::SymmetricTensor<4,3,VectorizedArray<Number> > tmp;
+        for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+          {
+            dealii::SymmetricTensor<4,3,Number> t_v;
+            for (unsigned int i=0; i<n_components; ++i)
+              t_v.access_raw_entry(i) = t.access_raw_entry(i)[v];
+            const dealii::SymmetricTensor<4,3,Number> inverse_v
+              = Inverse<4,3,Number>::value(t_v);
+            for (unsigned int i=0; i<n_components; ++i)
+              tmp.access_raw_entry(i)[v] = inverse_v.access_raw_entry(i);
+          }
+        return tmp;
+      }
+    };
+
   }
 }
 
@@ -3114,6 +3145,131 @@ eigenvectors (const SymmetricTensor<2,dim,Number>         &T,
 
 
 
+/**
+ * Return the eigenvalues of a symmetric 1x1 tensor of rank 2 whose entries
+ * are of type VectorizedArray.
+ *
+ * @relates SymmetricTensor
+ */
+template <typename Number>
+inline
+std::array<VectorizedArray<Number>,1>
+eigenvalues (const SymmetricTensor<2,1,VectorizedArray<Number> > &T)
+{
+  return { {T[0][0]} };
+}
+
+
+
+/**
+ * Return the eigenvalues of a symmetric 2x2 tensor of rank 2 whose entries
+ * are of type VectorizedArray, sorted in descending order. The roots of the
+ * characteristic polynomial are computed for all entries of the
+ * VectorizedArray at once and without branches, i.e., a diagonal tensor is
+ * not treated separately as in the scalar case. Negative values of the
+ * discriminant caused by round-off are set to zero.
+ *
+ * @relates SymmetricTensor
+ */
+template <typename Number>
+inline
+std::array<VectorizedArray<Number>,2>
+eigenvalues (const SymmetricTensor<2,2,VectorizedArray<Number> > &T)
+{
+  const VectorizedArray<Number> tr_T = trace(T);
+  const VectorizedArray<Number> det_T = determinant(T);
+  const VectorizedArray<Number> sqrt_desc
+    = std::sqrt(std::max(tr_T*tr_T - 4.0*det_T,
+                         VectorizedArray<Number>()));
+  return { {0.5*(tr_T + sqrt_desc), 0.5*(tr_T - sqrt_desc)} };
+}
+
+
+
+/**
+ * Return the eigenvalues of a symmetric 3x3 tensor of rank 2 whose entries
+ * are of type VectorizedArray, sorted in descending order. Since the
+ * trigonometric solution of the characteristic equation involves branches
+ * and an inverse cosine, the eigenvalues are computed separately for each
+ * entry of the VectorizedArray.
+ *
+ * @relates SymmetricTensor
+ */
+template <typename Number>
+inline
+std::array<VectorizedArray<Number>,3>
+eigenvalues (const SymmetricTensor<2,3,VectorizedArray<Number> > &T)
+{
+  std::array<VectorizedArray<Number>,3> eig_vals;
+  for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+    {
+      SymmetricTensor<2,3,Number> T_v;
+      for (unsigned int i=0; i<3; ++i)
+        for (unsigned int j=i; j<3; ++j)
+          T_v[i][j] = T[i][j][v];
+      const std::array<Number,3> eig_vals_v = eigenvalues(T_v);
+      for (unsigned int i=0; i<3; ++i)
+        eig_vals[i][v] = eig_vals_v[i];
+    }
+  return eig_vals;
+}
+
+
+
+/**
+ * Return the eigenvalues and eigenvectors of a symmetric 1x1 tensor of rank 2
+ * whose entries are of type VectorizedArray.
+ *
+ * @relates SymmetricTensor
+ */
+template <typename Number>
+inline
+std::array<std::pair<VectorizedArray<Number>, Tensor<1,1,VectorizedArray<Number> > >,1>
+eigenvectors (const SymmetricTensor<2,1,VectorizedArray<Number> > &T,
+              const SymmetricTensorEigenvectorMethod /*method*/ = SymmetricTensorEigenvectorMethod::ql_implicit_shifts)
+{
+  Tensor<1,1,VectorizedArray<Number> > unit_vector;
+  unit_vector[0] = Number(1.);
+  return { {std::make_pair(T[0][0], unit_vector)} };
+}
+
+
+
+/**
+ * Return the eigenvalues and eigenvectors of a rank-2 symmetric tensor whose
+ * entries are of type VectorizedArray, sorted in descending order of the
+ * eigenvalues. Since the iterative algorithms and the sorting depend on the
+ * values, the eigenvectors are computed with the given @p method separately
+ * for each entry of the VectorizedArray.
+ *
+ * @relates SymmetricTensor
+ */
+template <int dim, typename Number>
+std::array<std::pair<VectorizedArray<Number>, Tensor<1,dim,VectorizedArray<Number> > >,dim>
+eigenvectors (const SymmetricTensor<2,dim,VectorizedArray<Number> > &T,
+              const SymmetricTensorEigenvectorMethod method = SymmetricTensorEigenvectorMethod::ql_implicit_shifts)
+{
+  std::array<std::pair<VectorizedArray<Number>, Tensor<1,dim,VectorizedArray<Number> > >,dim> eig_vals_vecs;
+  for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+    {
+      SymmetricTensor<2,dim,Number> T_v;
+      for (unsigned int i=0; i<dim; ++i)
+        for (unsigned int j=i; j<dim; ++j)
+          T_v[i][j] = T[i][j][v];
+      const std::array<std::pair<Number, Tensor<1,dim,Number> >,dim> eig_vals_vecs_v
+        = eigenvectors(T_v, method);
+      for (unsigned int i=0; i<dim; ++i)
+        {
+          eig_vals_vecs[i].first[v] = eig_vals_vecs_v[i].first;
+          for (unsigned int d=0; d<dim; ++d)
+            eig_vals_vecs[i].second[d][v] = eig_vals_vecs_v[i].second[d];
+        }
+    }
+  return eig_vals_vecs;
+}
+
+
+
 /**
  * Return the transpose of the given symmetric tensor. Since we are working
  * with symmetric objects, the transpose is of course the same as the original
@@ -3150,7 +3306,7 @@ deviator (const SymmetricTensor<2,dim,Number> &t)
   SymmetricTensor<2,dim,Number> tmp = t;
 
   // subtract scaled trace from the diagonal
-  const Number tr = trace(t) / dim;
+  const Number tr = trace(t) / internal::NumberType<Number>::value(dim);
   for (unsigned int i=0; i<dim; ++i)
     tmp.data[i] -= tr;
 
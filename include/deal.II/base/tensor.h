@@ -2032,10 +2032,9 @@ l1_norm (const Tensor<2,dim,Number> &t)
     {
       Number sum = internal::NumberType<Number>::value(0.0);
       for (unsigned int i=0; i<dim; ++i)
-        sum += std::fabs(t[i][j]);
+        sum += std::abs(t[i][j]);
 
-      if (sum > max)
-        max = sum;
+      max = std::max(max, sum);
     }
 
   return max;
@@ -2059,10 +2058,9 @@ linfty_norm (const Tensor<2,dim,Number> &t)
     {
       Number sum = internal::NumberType<Number>::value(0.0);
       for (unsigned int j=0; j<dim; ++j)
-        sum += std::fabs(t[i][j]);
+        sum += std::abs(t[i][j]);
 
-      if (sum > max)
-        max = sum;
+      max = std::max(max, sum);
     }
 
   return max;
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2015 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -90,6 +90,17 @@ public:
   virtual void value_list (const std::vector<Point<dim> > &points,
                            std::vector<value_type> &values) const;
 
+  /**
+   * Return the value of the function at the points stored in the lanes of a
+   * vectorized point, as returned by FEEvaluation::quadrature_point(). Like
+   * Function::vectorized_value(), the default implementation calls value()
+   * for each lane, and derived classes can override it to evaluate all lanes
+   * at once. The entries are returned as double numbers; for functions with
+   * complex values, the imaginary part must be zero.
+   */
+  virtual Tensor<rank,dim,VectorizedArray<double> >
+  vectorized_value (const Point<dim,VectorizedArray<double> > &p) const;
+
   /**
    * Return the gradient of the function at the given point.
    */
@@ -134,6 +145,9 @@ public:
   virtual void value_list (const std::vector<Point<dim> > &points,
                            std::vector<typename dealii::TensorFunction<rank, dim, Number>::value_type> &values) const;
 
+  virtual Tensor<rank,dim,VectorizedArray<double> >
+  vectorized_value (const Point<dim,VectorizedArray<double> > &p) const;
+
   virtual typename dealii::TensorFunction<rank, dim, Number>::gradient_type gradient (const Point<dim> &p) const;
 
   virtual void gradient_list (const std::vector<Point<dim> > &points,
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2015 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -17,7 +17,9 @@
 #define dealii_tensor_function_templates_h
 
 #include <deal.II/base/tensor_function.h>
+#include <deal.II/base/function.templates.h>
 #include <deal.II/base/tensor.h>
+#include <deal.II/base/vectorization.h>
 #include <deal.II/lac/vector.h>
 
 #include <vector>
@@ -57,6 +59,29 @@ TensorFunction<rank, dim, Number>::value_list (
 }
 
 
+
+template <int rank, int dim, typename Number>
+Tensor<rank,dim,VectorizedArray<double> >
+TensorFunction<rank, dim, Number>::vectorized_value (const Point<dim,VectorizedArray<double> > &p) const
+{
+  Tensor<rank,dim,VectorizedArray<double> > result;
+  for (unsigned int v=0; v<VectorizedArray<double>::n_array_elements; ++v)
+    {
+      Point<dim> lane_point;
+      for (unsigned int d=0; d<dim; ++d)
+        lane_point[d] = p[d][v];
+      const value_type lane_value = this->value (lane_point);
+      for (unsigned int i=0; i<value_type::n_independent_components; ++i)
+        {
+          const TableIndices<rank> indices = value_type::unrolled_to_component_indices(i);
+          result[indices][v] = internal::FunctionImplementation::to_vectorized_lane
+                               (lane_value[indices]);
+        }
+    }
+  return result;
+}
+
+
 template <int rank, int dim, typename Number>
 typename TensorFunction<rank, dim, Number>::gradient_type
 TensorFunction<rank, dim, Number>::gradient (const Point<dim> &) const
@@ -116,6 +141,22 @@ ConstantTensorFunction<rank, dim, Number>::value_list (
 }
 
 
+
+template <int rank, int dim, typename Number>
+Tensor<rank,dim,VectorizedArray<double> >
+ConstantTensorFunction<rank, dim, Number>::vectorized_value (const Point<dim,VectorizedArray<double> > &) const
+{
+  Tensor<rank,dim,VectorizedArray<double> > result;
+  for (unsigned int i=0; i<Tensor<rank,dim,Number>::n_independent_components; ++i)
+    {
+      const TableIndices<rank> indices = Tensor<rank,dim,Number>::unrolled_to_component_indices(i);
+      result[indices] = internal::FunctionImplementation::to_vectorized_lane
+                        (_value[indices]);
+    }
+  return result;
+}
+
+
 template <int rank, int dim, typename Number>
 typename TensorFunction<rank, dim, Number>::gradient_type
 ConstantTensorFunction<rank, dim, Number>::gradient (const Point<dim> &) const
@@ -27,6 +27,7 @@
 #  include <condition_variable>
 #endif
 
+#include <atomic>
 #include <iterator>
 #include <vector>
 #include <list>
@@ -473,6 +474,153 @@ namespace Threads
   typedef DummyBarrier         Barrier;
 #endif
 
+
+
+  /**
+   * A table of lightweight spin locks, one for each index in a range
+   * $[0,n)$. The typical use is to guard the rows of a matrix or the entries
+   * of a vector when several threads add into the same global object, e.g.
+   * when calling ConstraintMatrix::distribute_local_to_global() from the
+   * worker function of WorkStream::run() without a coloring of the cells.
+   * Since each lock only takes a single byte and is held just for the time to
+   * add a row of a cell matrix, this is much cheaper than assigning a Mutex
+   * to each row or serializing the whole copy operation, and contention only
+   * happens when two threads actually write into the same row at the same
+   * time.
+   *
+   * The locks are busy-waiting, so they should only be used for short
+   * critical sections. In non-multithread mode, the table still works but
+   * the locks are of course never contended.
+   *
+   * <h3>Copy semantics</h3>
+   *
+   * Like for the Mutex class, copying an object does not transfer any lock
+   * state, i.e., the copied-to object has the same size but all its locks are
+   * released.
+   */
+  class SpinLockTable
+  {
+  public:
+    /**
+     * Scoped lock class. Locks the given index of the table in the
+     * constructor and releases it again in the destructor, see the
+     * documentation of Mutex::ScopedLock.
+     */
+    class ScopedLock
+    {
+    public:
+      /**
+       * Constructor. Acquire the lock for the given index.
+       */
+      ScopedLock (SpinLockTable     &table,
+                  const std::size_t  index)
+        :
+        table (table),
+        index (index)
+      {
+        table.acquire (index);
+      }
+
+      /**
+       * Destructor. Release the lock.
+       */
+      ~ScopedLock ()
+      {
+        table.release (index);
+      }
+
+    private:
+      /**
+       * The table and the index to be released in the destructor.
+       */
+      SpinLockTable     &table;
+      const std::size_t  index;
+    };
+
+    /**
+     * Constructor. Create a table with @p n locks, all of them released.
+     */
+    explicit SpinLockTable (const std::size_t n = 0)
+    {
+      reinit (n);
+    }
+
+    /**
+     * Copy constructor. As discussed in this class's documentation, no lock
+     * state is copied from the object given as argument.
+     */
+    SpinLockTable (const SpinLockTable &other)
+    {
+      reinit (other.size());
+    }
+
+    /**
+     * Copy operator. As discussed in this class's documentation, no lock
+     * state is copied from the object given as argument.
+     */
+    SpinLockTable &operator = (const SpinLockTable &other)
+    {
+      reinit (other.size());
+      return *this;
+    }
+
+    /**
+     * Change the number of locks to @p n and release all of them. This
+     * function must not be called while any lock is held.
+     */
+    void reinit (const std::size_t n)
+    {
+      if (n != n_locks)
+        {
+          locks.reset (n > 0 ? new std::atomic<bool>[n] : nullptr);
+          n_locks = n;
+        }
+      for (std::size_t i=0; i<n_locks; ++i)
+        locks[i].store (false, std::memory_order_relaxed);
+    }
+
+    /**
+     * Return the number of locks in the table.
+     */
+    std::size_t size () const
+    {
+      return n_locks;
+    }
+
+    /**
+     * Acquire the lock with the given index, waiting until it becomes
+     * available.
+     */
+    void acquire (const std::size_t index)
+    {
+      Assert (index < n_locks, ExcIndexRange(index, 0, n_locks));
+      while (locks[index].exchange (true, std::memory_order_acquire))
+        // wait with plain loads until the lock appears free instead of
+        // hammering the cache line with atomic exchanges
+        while (locks[index].load (std::memory_order_relaxed))
+          ;
+    }
+
+    /**
+     * Release the lock with the given index.
+     */
+    void release (const std::size_t index)
+    {
+      Assert (index < n_locks, ExcIndexRange(index, 0, n_locks));
+      locks[index].store (false, std::memory_order_release);
+    }
+
+  private:
+    /**
+     * The number of locks.
+     */
+    std::size_t n_locks = 0;
+
+    /**
+     * The lock flags.
+     */
+    std::unique_ptr<std::atomic<bool>[]> locks;
+  };
 }
 
 
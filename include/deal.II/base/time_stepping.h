@@ -52,11 +52,22 @@ namespace TimeStepping
    *     in MATLAB)
    *   - FEHLBERG (fifth order)
    *   - CASH_KARP (firth order)
+   * - Low-storage explicit methods (see LowStorageRungeKutta::initialize):
+   *   - LOW_STORAGE_RK_STAGE3_ORDER3 (three stages, third order)
+   *   - LOW_STORAGE_RK_STAGE5_ORDER4 (five stages, fourth order)
+   * - Implicit-explicit additive methods (see IMEXRungeKutta::initialize):
+   *   - IMEX_EULER (forward-backward Euler, first order)
+   *   - IMEX_ARS_222 (Ascher-Ruuth-Spiteri, two implicit stages, second
+   *     order)
+   *   - IMEX_ARS_443 (Ascher-Ruuth-Spiteri, four implicit stages, third
+   *     order)
    */
   enum runge_kutta_method { FORWARD_EULER, RK_THIRD_ORDER, RK_CLASSIC_FOURTH_ORDER,
                             BACKWARD_EULER, IMPLICIT_MIDPOINT, CRANK_NICOLSON,
                             SDIRK_TWO_STAGES, HEUN_EULER, BOGACKI_SHAMPINE, DOPRI,
                             FEHLBERG, CASH_KARP,
+                            LOW_STORAGE_RK_STAGE3_ORDER3, LOW_STORAGE_RK_STAGE5_ORDER4,
+                            IMEX_EULER, IMEX_ARS_222, IMEX_ARS_443,
                             invalid
                           };
 
@@ -603,6 +614,265 @@ namespace TimeStepping
      */
     Status status;
   };
+
+
+  /**
+   * LowStorageRungeKutta is derived from RungeKutta and implements explicit
+   * methods whose Butcher tableau has the structure $a_{ij} = b_j$ for all
+   * $j < i-1$, such as the schemes of Kennedy, Carpenter and Lewis (2000).
+   * This allows to run the method on two registers in addition to the
+   * solution: after evaluating the stage derivative $k_s$ at the stage
+   * vector $r_s$, the solution is updated by $y \mathrel{+}= \Delta t\, b_s
+   * k_s$ and the next stage vector is $r_{s+1} = y + \Delta t (a_{s+1,s} -
+   * b_s) k_s$, where $y$ already contains the update. In contrast to
+   * ExplicitRungeKutta, which keeps all stage derivatives, the memory and
+   * the memory traffic of a time step do not depend on the number of
+   * stages, which makes the schemes with more stages than order attractive
+   * for large problems whose time step is limited by stability.
+   *
+   * The function evolve_one_time_step() taking the registers as arguments
+   * lets the user keep them between time steps and uses a right hand side
+   * function that writes into a given vector, so no vectors are allocated
+   * during a time step.
+   */
+  template <typename VectorType>
+  class LowStorageRungeKutta : public RungeKutta<VectorType>
+  {
+  public:
+    using RungeKutta<VectorType>::evolve_one_time_step;
+
+    /**
+     * Default constructor. This constructor creates an object for which
+     * you will want to call <code>initialize(runge_kutta_method)</code>
+     * before it can be used.
+     */
+    LowStorageRungeKutta() = default;
+
+    /**
+     * Constructor. This function calls initialize(runge_kutta_method).
+     */
+    LowStorageRungeKutta(const runge_kutta_method method);
+
+    /**
+     * Initialize the low-storage Runge-Kutta method.
+     */
+    void initialize(const runge_kutta_method method);
+
+    /**
+     * This function is used to advance from time @p t to t+ @p delta_t. The
+     * argument @p id_minus_tau_J_inverse is not used for explicit methods.
+     * evolve_one_time_step returns the time at the end of the time step.
+     */
+    double evolve_one_time_step
+    (const std::function<VectorType (const double, const VectorType &)>                &f,
+     const std::function<VectorType (const double, const double, const VectorType &)>  &id_minus_tau_J_inverse,
+     double                                                                      t,
+     double                                                                      delta_t,
+     VectorType                                                                  &y);
+
+    /**
+     * This function is used to advance from time @p t to t+ @p delta_t
+     * without the unused id_minus_tau_J_inverse argument.
+     * evolve_one_time_step returns the time at the end of the time step.
+     */
+    double evolve_one_time_step
+    (const std::function<VectorType (const double, const VectorType &)> &f,
+     double                                                       t,
+     double                                                       delta_t,
+     VectorType                                                   &y);
+
+    /**
+     * This function is used to advance from time @p t to t+ @p delta_t. The
+     * function @p f sets its last argument to $f(t,y)$ for the time and the
+     * vector given as the first two arguments. The two registers @p vec_ri
+     * and @p vec_ki need not be initialized; they are set to the layout of
+     * @p y on the first call and can be kept by the caller for the
+     * following time steps. evolve_one_time_step returns the time at the end
+     * of the time step.
+     */
+    double evolve_one_time_step
+    (const std::function<void (const double, const VectorType &, VectorType &)> &f,
+     double                                                               t,
+     double                                                               delta_t,
+     VectorType                                                           &y,
+     VectorType                                                           &vec_ri,
+     VectorType                                                           &vec_ki);
+
+    /**
+     * Return the coefficients of the method: the entries $a_{s+1,s}$ below
+     * the diagonal of the Butcher tableau, the weights $b_s$, and the
+     * stage times $c_s$. This allows to implement the update of the stages
+     * directly in user code, e.g., fused into a matrix-free operator
+     * evaluation.
+     */
+    void get_coefficients(std::vector<double> &ai,
+                          std::vector<double> &bi,
+                          std::vector<double> &ci) const;
+
+    /**
+     * This structure stores the name of the method used.
+     */
+    struct Status : public TimeStepping<VectorType>::Status
+    {
+      Status ()
+        :
+        method (invalid)
+      {}
+
+      runge_kutta_method method;
+    };
+
+    /**
+     * Return the status of the current object.
+     */
+    const Status &get_status() const;
+
+  private:
+    /**
+     * The entries $a_{s+1,s}$ of the Butcher tableau.
+     */
+    std::vector<double> ai;
+
+    /**
+     * Status structure of the object.
+     */
+    Status status;
+  };
+
+
+
+  /**
+   * IMEXRungeKutta implements additive implicit-explicit Runge-Kutta
+   * methods for equations of the form $ \frac{\partial y}{\partial t} =
+   * f_E(t,y) + f_I(t,y) $, where the non-stiff part $f_E$ is treated
+   * explicitly and the stiff part $f_I$ implicitly with a diagonally
+   * implicit method. Each implicit stage solves $Y_i - \tau f_I(t_i,Y_i) =
+   * R_i$ with $\tau = a^I_{ii}\Delta t$ and the explicit terms collected in
+   * $R_i$ by a Newton iteration based on the user-supplied function
+   * $(I-\tau J)^{-1}$, with $J$ the Jacobian of $f_I$. For an $f_I$ that is
+   * linear in $y$, the first Newton step already solves the stage.
+   *
+   * The methods are stiffly accurate, i.e., the solution at the end of the
+   * step is the last stage vector, and the explicit derivative of the last
+   * stage is never evaluated.
+   */
+  template <typename VectorType>
+  class IMEXRungeKutta : public TimeStepping<VectorType>
+  {
+  public:
+    /**
+     * Default constructor. initialize(runge_kutta_method) and
+     * set_newton_solver_parameters(unsigned int,double) need to be called
+     * before the object can be used.
+     */
+    IMEXRungeKutta() = default;
+
+    /**
+     * Constructor. This function calls initialize(runge_kutta_method) and
+     * initialize the maximum number of iterations and the tolerance of the
+     * Newton solver.
+     */
+    IMEXRungeKutta(const runge_kutta_method method,
+                   const unsigned int       max_it    = 100,
+                   const double             tolerance = 1e-6);
+
+    /**
+     * Initialize the implicit-explicit Runge-Kutta method.
+     */
+    void initialize(const runge_kutta_method method);
+
+    /**
+     * This function is used to advance from time @p t to t+ @p delta_t. @p F
+     * needs to contain two functions, the explicit part $f_E$ followed by
+     * the implicit part $f_I$, and @p J_inverse the function computing
+     * $(I-\tau J)^{-1}$ for the Jacobian $J$ of $f_I$. evolve_one_time_step
+     * returns the time at the end of the time step.
+     */
+    double evolve_one_time_step
+    (std::vector<std::function<VectorType (const double, const VectorType &)> >               &F,
+     std::vector<std::function<VectorType (const double, const double, const VectorType &)> > &J_inverse,
+     double                                                                                   t,
+     double                                                                                   delta_t,
+     VectorType                                                                               &y);
+
+    /**
+     * This function is used to advance from time @p t to t+ @p delta_t. @p
+     * f_explicit and @p f_implicit are the non-stiff and the stiff part of
+     * the right hand side, and @p id_minus_tau_J_inverse computes $
+     * (I-\tau J)^{-1}$ for the Jacobian $J$ of @p f_implicit. The input
+     * parameters this function receives are the time, $ \tau $, and a
+     * vector. evolve_one_time_step returns the time at the end of the time
+     * step.
+     */
+    double evolve_one_time_step
+    (const std::function<VectorType (const double, const VectorType &)>               &f_explicit,
+     const std::function<VectorType (const double, const VectorType &)>               &f_implicit,
+     const std::function<VectorType (const double, const double, const VectorType &)> &id_minus_tau_J_inverse,
+     double                                                                           t,
+     double                                                                           delta_t,
+     VectorType                                                                       &y);
+
+    /**
+     * Set the maximum number of iterations and the tolerance used by the
+     * Newton solver.
+     */
+    void set_newton_solver_parameters(const unsigned int max_it,
+                                      const double       tolerance);
+
+    /**
+     * Structure that stores the name of the method, the maximal number of
+     * Newton iterations over the stages of the last step and the norm of
+     * the residual when exiting the Newton solver of the last stage.
+     */
+    struct Status : public TimeStepping<VectorType>::Status
+    {
+      Status ()
+        :
+        method (invalid),
+        n_iterations (numbers::invalid_unsigned_int),
+        norm_residual (numbers::signaling_nan<double>())
+      {}
+
+      runge_kutta_method method;
+      unsigned int       n_iterations;
+      double             norm_residual;
+    };
+
+    /**
+     * Return the status of the current object.
+     */
+    const Status &get_status() const;
+
+  private:
+    /**
+     * Number of stages of the method.
+     */
+    unsigned int n_stages;
+
+    /**
+     * Butcher tableau coefficients of the explicit and the implicit part.
+     * Both parts share the stage times @p c and are stiffly accurate, so no
+     * weights are stored.
+     */
+    std::vector<std::vector<double> > a_explicit;
+    std::vector<std::vector<double> > a_implicit;
+    std::vector<double> c;
+
+    /**
+     * Maximum number of iterations of the Newton solver.
+     */
+    unsigned int max_it;
+
+    /**
+     * Tolerance of the Newton solver.
+     */
+    double tolerance;
+
+    /**
+     * Status structure of the object.
+     */
+    Status status;
+  };
 }
 
 DEAL_II_NAMESPACE_CLOSE
@@ -19,6 +19,7 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/time_stepping.h>
 
+#include <cmath>
 #include <functional>
 
 DEAL_II_NAMESPACE_OPEN
@@ -832,6 +833,383 @@ namespace TimeStepping
         f_stages[i] = f(t+this->c[i]*delta_t,Y);
       }
   }
+
+
+
+  // ----------------------------------------------------------------------
+  // LowStorageRungeKutta
+  // ----------------------------------------------------------------------
+
+  template <typename VectorType>
+  LowStorageRungeKutta<VectorType>::LowStorageRungeKutta(const runge_kutta_method method)
+  {
+    initialize(method);
+  }
+
+
+
+  template <typename VectorType>
+  void LowStorageRungeKutta<VectorType>::initialize(const runge_kutta_method method)
+  {
+    status.method = method;
+    ai.clear();
+    this->b.clear();
+    this->c.clear();
+
+    switch (method)
+      {
+      case (LOW_STORAGE_RK_STAGE3_ORDER3) :
+      {
+        // Kennedy, Carpenter, Lewis, Appl. Numer. Math. 35:177-219, 2000,
+        // RK3(2)3[2R+]
+        this->n_stages = 3;
+        ai.push_back(0.755726351946097);
+        ai.push_back(0.386954477304099);
+        this->b.push_back(0.245170287303492);
+        this->b.push_back(0.184896052186740);
+        this->b.push_back(0.569933660509768);
+
+        break;
+      }
+      case (LOW_STORAGE_RK_STAGE5_ORDER4) :
+      {
+        // Kennedy, Carpenter, Lewis, Appl. Numer. Math. 35:177-219, 2000,
+        // RK4(3)5[2R+]C
+        this->n_stages = 5;
+        ai.push_back(970286171893./4311952581923.);
+        ai.push_back(6584761158862./12103376702013.);
+        ai.push_back(2251764453980./15575788980749.);
+        ai.push_back(26877169314380./34165994151039.);
+        this->b.push_back(1153189308089./22510343858157.);
+        this->b.push_back(1772645290293./4653164025191.);
+        this->b.push_back(-1672844663538./4480602732383.);
+        this->b.push_back(2114624349019./3568978502595.);
+        this->b.push_back(5198255086312./14908931495163.);
+
+        break;
+      }
+      default :
+      {
+        AssertThrow(false,ExcMessage("Unimplemented low-storage Runge-Kutta method."));
+      }
+      }
+
+    // the stage times follow from the structure of the tableau
+    this->c.push_back(0.0);
+    double sum_b = 0.;
+    for (unsigned int s=1; s<this->n_stages; ++s)
+      {
+        this->c.push_back(sum_b + ai[s-1]);
+        sum_b += this->b[s-1];
+      }
+  }
+
+
+
+  template <typename VectorType>
+  double LowStorageRungeKutta<VectorType>::evolve_one_time_step
+  (const std::function<VectorType (const double, const VectorType &)> &f,
+   const std::function<VectorType (const double, const double, const VectorType &)> &/*id_minus_tau_J_inverse*/,
+   double                                                             t,
+   double                                                             delta_t,
+   VectorType                                                         &y)
+  {
+    return evolve_one_time_step(f,t,delta_t,y);
+  }
+
+
+
+  template <typename VectorType>
+  double LowStorageRungeKutta<VectorType>::evolve_one_time_step
+  (const std::function<VectorType (const double, const VectorType &)> &f,
+   double                                                             t,
+   double                                                             delta_t,
+   VectorType                                                         &y)
+  {
+    VectorType vec_ri, vec_ki;
+    return evolve_one_time_step([&f](const double time, const VectorType &src, VectorType &dst)
+    {
+      dst = f(time, src);
+    },
+    t, delta_t, y, vec_ri, vec_ki);
+  }
+
+
+
+  template <typename VectorType>
+  double LowStorageRungeKutta<VectorType>::evolve_one_time_step
+  (const std::function<void (const double, const VectorType &, VectorType &)> &f,
+   double                                                                     t,
+   double                                                                     delta_t,
+   VectorType                                                                 &y,
+   VectorType                                                                 &vec_ri,
+   VectorType                                                                 &vec_ki)
+  {
+    Assert(this->n_stages > 0 && ai.size()+1 == this->n_stages,
+           ExcMessage("The method has not been initialized."));
+    if (vec_ri.size() != y.size())
+      vec_ri.reinit(y, true);
+    if (vec_ki.size() != y.size())
+      vec_ki.reinit(y, true);
+
+    for (unsigned int s=0; s<this->n_stages; ++s)
+      {
+        // the first stage is evaluated at the solution itself
+        f(t+this->c[s]*delta_t, s==0 ? y : vec_ri, vec_ki);
+        if (s+1 < this->n_stages)
+          {
+            vec_ri = y;
+            vec_ri.add(ai[s]*delta_t, vec_ki);
+          }
+        y.add(this->b[s]*delta_t, vec_ki);
+      }
+
+    return (t+delta_t);
+  }
+
+
+
+  template <typename VectorType>
+  void LowStorageRungeKutta<VectorType>::get_coefficients(std::vector<double> &ai,
+                                                          std::vector<double> &bi,
+                                                          std::vector<double> &ci) const
+  {
+    ai = this->ai;
+    bi = this->b;
+    ci = this->c;
+  }
+
+
+
+  template <typename VectorType>
+  const typename LowStorageRungeKutta<VectorType>::Status &LowStorageRungeKutta<VectorType>::get_status() const
+  {
+    return status;
+  }
+
+
+
+  // ----------------------------------------------------------------------
+  // IMEXRungeKutta
+  // ----------------------------------------------------------------------
+
+  template <typename VectorType>
+  IMEXRungeKutta<VectorType>::IMEXRungeKutta(const runge_kutta_method method,
+                                             const unsigned int       max_it,
+                                             const double             tolerance)
+    :
+    max_it(max_it),
+    tolerance(tolerance)
+  {
+    initialize(method);
+  }
+
+
+
+  template <typename VectorType>
+  void IMEXRungeKutta<VectorType>::initialize(const runge_kutta_method method)
+  {
+    status.method = method;
+    a_explicit.clear();
+    a_implicit.clear();
+    c.clear();
+
+    // all methods have an explicit first stage and are stiffly accurate,
+    // i.e., the last row of both tableaus contains the weights
+    switch (method)
+      {
+      case (IMEX_EULER) :
+      {
+        n_stages = 2;
+        a_explicit.push_back(std::vector<double>());
+        a_explicit.push_back(std::vector<double>(1, 1.0));
+        a_implicit.push_back(std::vector<double>(1, 0.0));
+        a_implicit.push_back(std::vector<double>(2, 0.0));
+        a_implicit[1][1] = 1.0;
+        c.push_back(0.0);
+        c.push_back(1.0);
+
+        break;
+      }
+      case (IMEX_ARS_222) :
+      {
+        // Ascher, Ruuth, Spiteri, Appl. Numer. Math. 25:151-167, 1997
+        const double gamma = 1.0 - 1.0/std::sqrt(2.0);
+        const double delta = 1.0 - 1.0/(2.0*gamma);
+        n_stages = 3;
+        a_explicit.push_back(std::vector<double>());
+        a_explicit.push_back(std::vector<double>(1, gamma));
+        a_explicit.push_back(std::vector<double>(2, delta));
+        a_explicit[2][1] = 1.0-delta;
+        a_implicit.push_back(std::vector<double>(1, 0.0));
+        a_implicit.push_back(std::vector<double>(2, 0.0));
+        a_implicit[1][1] = gamma;
+        a_implicit.push_back(std::vector<double>(3, 0.0));
+        a_implicit[2][1] = 1.0-gamma;
+        a_implicit[2][2] = gamma;
+        c.push_back(0.0);
+        c.push_back(gamma);
+        c.push_back(1.0);
+
+        break;
+      }
+      case (IMEX_ARS_443) :
+      {
+        // Ascher, Ruuth, Spiteri, Appl. Numer. Math. 25:151-167, 1997
+        n_stages = 5;
+        a_explicit.resize(n_stages);
+        a_implicit.resize(n_stages);
+        for (unsigned int i=0; i<n_stages; ++i)
+          {
+            a_explicit[i].resize(i, 0.0);
+            a_implicit[i].resize(i+1, 0.0);
+          }
+        a_explicit[1][0] = 0.5;
+        a_explicit[2][0] = 11.0/18.0;
+        a_explicit[2][1] = 1.0/18.0;
+        a_explicit[3][0] = 5.0/6.0;
+        a_explicit[3][1] = -5.0/6.0;
+        a_explicit[3][2] = 0.5;
+        a_explicit[4][0] = 0.25;
+        a_explicit[4][1] = 1.75;
+        a_explicit[4][2] = 0.75;
+        a_explicit[4][3] = -1.75;
+        a_implicit[1][1] = 0.5;
+        a_implicit[2][1] = 1.0/6.0;
+        a_implicit[2][2] = 0.5;
+        a_implicit[3][1] = -0.5;
+        a_implicit[3][2] = 0.5;
+        a_implicit[3][3] = 0.5;
+        a_implicit[4][1] = 1.5;
+        a_implicit[4][2] = -1.5;
+        a_implicit[4][3] = 0.5;
+        a_implicit[4][4] = 0.5;
+        c.push_back(0.0);
+        c.push_back(0.5);
+        c.push_back(2.0/3.0);
+        c.push_back(0.5);
+        c.push_back(1.0);
+
+        break;
+      }
+      default :
+      {
+        AssertThrow(false,ExcMessage("Unimplemented implicit-explicit Runge-Kutta method."));
+      }
+      }
+  }
+
+
+
+  template <typename VectorType>
+  double IMEXRungeKutta<VectorType>::evolve_one_time_step(
+    std::vector<std::function<VectorType (const double, const VectorType &)> > &F,
+    std::vector<std::function<VectorType (const double, const double, const VectorType &)> > &J_inverse,
+    double t,
+    double delta_t,
+    VectorType &y)
+  {
+    AssertThrow(F.size()==2,
+                ExcMessage("IMEX methods need the explicit and the implicit part of the right hand side."));
+    AssertThrow(J_inverse.size()==1,
+                ExcMessage("IMEX methods need one function computing the inverse of the implicit part."));
+
+    return evolve_one_time_step(F[0],F[1],J_inverse[0],t,delta_t,y);
+  }
+
+
+
+  template <typename VectorType>
+  double IMEXRungeKutta<VectorType>::evolve_one_time_step
+  (const std::function<VectorType (const double, const VectorType &)>               &f_explicit,
+   const std::function<VectorType (const double, const VectorType &)>               &f_implicit,
+   const std::function<VectorType (const double, const double, const VectorType &)> &id_minus_tau_J_inverse,
+   double                                                                           t,
+   double                                                                           delta_t,
+   VectorType                                                                       &y)
+  {
+    const VectorType old_y(y);
+    std::vector<VectorType> f_explicit_stages(n_stages-1, y);
+    std::vector<VectorType> f_implicit_stages(n_stages-1, y);
+    VectorType rhs(y), residual(y);
+    status.n_iterations = 0;
+
+    for (unsigned int i=0; i<n_stages; ++i)
+      {
+        const double stage_t = t+c[i]*delta_t;
+        rhs = old_y;
+        for (unsigned int j=0; j<i; ++j)
+          {
+            if (a_explicit[i][j] != 0.)
+              rhs.add(delta_t*a_explicit[i][j], f_explicit_stages[j]);
+            if (a_implicit[i][j] != 0.)
+              rhs.add(delta_t*a_implicit[i][j], f_implicit_stages[j]);
+          }
+
+        // Solve y - tau f_I(t,y) = rhs with Newton's method, starting from
+        // the solution of the previous stage
+        const double tau = delta_t*a_implicit[i][i];
+        VectorType tendency;
+        if (tau == 0.)
+          y = rhs;
+        else
+          {
+            tendency = f_implicit(stage_t,y);
+            residual = y;
+            residual.add(-tau, tendency);
+            residual.add(-1., rhs);
+            double norm_residual = residual.l2_norm();
+            unsigned int it=0;
+            while (norm_residual >= tolerance && it<max_it)
+              {
+                y.add(-1., id_minus_tau_J_inverse(stage_t,tau,residual));
+                tendency = f_implicit(stage_t,y);
+                residual = y;
+                residual.add(-tau, tendency);
+                residual.add(-1., rhs);
+                norm_residual = residual.l2_norm();
+                ++it;
+              }
+            status.n_iterations = std::max(status.n_iterations, it);
+            status.norm_residual = norm_residual;
+          }
+
+        // Only evaluate the derivatives of the stage that are used by later
+        // stages. The last stage is the solution of the step.
+        if (i+1 < n_stages)
+          {
+            bool explicit_used = false, implicit_used = false;
+            for (unsigned int k=i+1; k<n_stages; ++k)
+              {
+                explicit_used |= (a_explicit[k][i] != 0.);
+                implicit_used |= (a_implicit[k][i] != 0.);
+              }
+            if (explicit_used)
+              f_explicit_stages[i] = f_explicit(stage_t,y);
+            if (implicit_used)
+              f_implicit_stages[i] = (tau == 0.) ? f_implicit(stage_t,y) : tendency;
+          }
+      }
+
+    return (t+delta_t);
+  }
+
+
+
+  template <typename VectorType>
+  void IMEXRungeKutta<VectorType>::set_newton_solver_parameters(unsigned int max_it_, double tolerance_)
+  {
+    max_it = max_it_;
+    tolerance = tolerance_;
+  }
+
+
+
+  template <typename VectorType>
+  const typename IMEXRungeKutta<VectorType>::Status &IMEXRungeKutta<VectorType>::get_status() const
+  {
+    return status;
+  }
 }
 
 DEAL_II_NAMESPACE_CLOSE
@@ -19,6 +19,8 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/conditional_ostream.h>
 #include <deal.II/base/mpi.h>
+#include <deal.II/base/performance_counters.h>
+#include <deal.II/base/thread_local_storage.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/utilities.h>
 
@@ -26,6 +28,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -396,7 +399,6 @@ private:
 
 
 
-//TODO: The following class is not thread-safe
 /**
  * This class can be used to generate formatted output from time measurements
  * of different subsections in a program. It is possible to create several
@@ -550,12 +552,94 @@ private:
  * sure that we only generate output on a single processor. See the step-32,
  * step-40, and step-42 tutorial programs for this kind of usage of this class.
  *
+ * Alternatively, the variation of the section times among the processes can
+ * be shown by print_wall_time_statistics(), which prints the minimum,
+ * average, and maximum of the wall time of each section over all processes
+ * of a communicator.
+ *
+ *
+ * <h3>Nested sections and multithreaded programs</h3>
+ *
+ * Sections may be entered while another section is active. The class keeps
+ * track of the sections that were active when a section was entered and
+ * records the times in a call tree, which can be printed with
+ * print_call_tree(). The summary table of print_summary() and the data
+ * returned by get_summary_data() accumulate the times of a section over all
+ * positions in the call tree.
+ *
+ * The sections active on a thread as well as the call tree and the
+ * measured times are stored separately for each thread, such that sections
+ * may be entered and left concurrently on several threads without any
+ * synchronization. The data of all threads are merged when they are printed
+ * or returned, which must not happen while sections are active on other
+ * threads. Note that CPU times are measured for the whole process, so CPU
+ * times of sections that run concurrently on several threads are counted
+ * several times. If the object has been constructed with an MPI
+ * communicator, the barrier placed at the start and the end of each section
+ * requires that all processes enter and leave the sections in the same order
+ * on a single thread.
+ *
+ * If deal.II is configured with LIKWID, each section is also recorded as a
+ * region of the LIKWID marker API, see the namespace PerformanceCounters,
+ * such that hardware performance counters like floating point operations or
+ * memory transfer can be collected for the sections.
+ *
+ * Entering a section by its name requires a lookup of the name in a map
+ * protected by a mutex. In loops where the overhead of this lookup matters,
+ * compared to the work inside the section, a section can be registered once
+ * with register_section() and the returned handle be used for entering and
+ * leaving the section:
+ * @code
+ *   const TimerOutput::SectionHandle local_section =
+ *     timer.register_section ("Local integrals");
+ *   for (const auto &cell : dof_handler.active_cell_iterators())
+ *     {
+ *       TimerOutput::Scope timer_section(timer, local_section);
+ *       ...
+ *     }
+ * @endcode
+ *
  * @ingroup utilities
  * @author M. Kronbichler, 2009.
  */
 class TimerOutput
 {
 public:
+  /**
+   * A handle to a section of a TimerOutput object, as returned by
+   * TimerOutput::register_section(). Entering and leaving a section through
+   * its handle avoids looking up the name of the section.
+   */
+  class SectionHandle
+  {
+  public:
+    /**
+     * Constructor. Create an invalid handle.
+     */
+    SectionHandle ();
+
+  private:
+    /**
+     * Constructor. Create a handle to the section with the given index and
+     * name.
+     */
+    SectionHandle (const unsigned int  index,
+                   const std::string *name);
+
+    /**
+     * The index of the section in the TimerOutput object.
+     */
+    unsigned int index;
+
+    /**
+     * A pointer to the name of the section, which is stored as a key of
+     * TimerOutput::section_indices and thus never moves.
+     */
+    const std::string *name;
+
+    friend class TimerOutput;
+  };
+
   /**
    * Helper class to enter/exit sections in TimerOutput be constructing a
    * simple scope-based object. The purpose of this class is explained in the
@@ -570,6 +654,13 @@ public:
      */
     Scope(dealii::TimerOutput &timer_, const std::string &section_name);
 
+    /**
+     * Enter the section given by a handle returned by
+     * TimerOutput::register_section(). Exit automatically when calling stop()
+     * or destructor runs.
+     */
+    Scope(dealii::TimerOutput &timer_, const SectionHandle &section);
+
     /**
      * Destructor calls stop()
      */
@@ -588,9 +679,9 @@ public:
     dealii::TimerOutput &timer;
 
     /**
-     * Name of the section we need to exit
+     * Handle of the section we need to exit
      */
-    const std::string section_name;
+    const SectionHandle section;
 
     /**
      * Do we still need to exit the section we are in?
@@ -758,6 +849,19 @@ public:
    */
   void enter_subsection (const std::string &section_name);
 
+  /**
+   * Register a section with the given name, unless it already exists, and
+   * return a handle to it. The handle can be used to enter and leave the
+   * section without looking up its name. The handle stays valid until this
+   * object is destroyed, also when reset() is called.
+   */
+  SectionHandle register_section (const std::string &section_name);
+
+  /**
+   * Open the section given by a handle returned by register_section().
+   */
+  void enter_subsection (const SectionHandle &section);
+
   /**
    * Same as @p enter_subsection.
    */
@@ -771,13 +875,21 @@ public:
    */
   void leave_subsection (const std::string &section_name = std::string());
 
+  /**
+   * Leave the section given by a handle returned by register_section().
+   */
+  void leave_subsection (const SectionHandle &section);
+
   /**
    * Same as @p leave_subsection.
    */
   void exit_section (const std::string &section_name = std::string());
 
   /**
-   * Get a map with the collected data of the specified type for each subsection
+   * Get a map with the collected data of the specified type for each
+   * subsection, accumulated over all threads and all positions of the
+   * subsection in the call tree. CPU times are only measured if the
+   * OutputType given to the constructor includes them.
    */
   std::map<std::string, double> get_summary_data (const OutputData kind) const;
 
@@ -787,6 +899,25 @@ public:
    */
   void print_summary () const;
 
+  /**
+   * Print a formatted table with the tree of nested sections, where each
+   * section is listed below the section that was active when it was
+   * entered, together with the number of calls, the time spent in it, and
+   * the fraction of the time of the enclosing section. The wall times are
+   * shown unless the object was constructed to output CPU times only.
+   */
+  void print_call_tree () const;
+
+  /**
+   * Print a formatted table with the minimum, average, and maximum of the
+   * wall time of each section over all processes of the communicator
+   * @p mpi_comm, together with the ranks of the processes where the
+   * minimum and maximum are attained. This is a collective operation that
+   * requires all processes to have entered the same sections. Output is
+   * generated on all processes whose stream is active.
+   */
+  void print_wall_time_statistics (const MPI_Comm mpi_comm) const;
+
   /**
    * By calling this function, all output can be disabled. This function
    * together with enable_output() can be useful if one wants to control the
@@ -832,16 +963,96 @@ private:
    */
   struct Section
   {
-    Timer  timer;
     double total_cpu_time;
     double total_wall_time;
     unsigned int n_calls;
   };
 
   /**
-   * A list of all the sections and their information.
+   * A node of the call tree of the sections. The root of the tree, which
+   * does not correspond to a section, is stored at position zero.
+   */
+  struct CallTreeNode
+  {
+    /**
+     * Constructor.
+     */
+    CallTreeNode (const unsigned int section,
+                  const unsigned int parent);
+
+    /**
+     * The index of the section of this node.
+     */
+    unsigned int section;
+
+    /**
+     * The position of the enclosing node.
+     */
+    unsigned int parent;
+
+    /**
+     * The positions of the nodes of the sections entered within this node.
+     */
+    std::vector<unsigned int> children;
+
+    /**
+     * The data collected for this node.
+     */
+    Section data;
+  };
+
+  /**
+   * A section that has been entered and not exited on a thread.
+   */
+  struct ActiveSection
+  {
+    unsigned int section;
+    const std::string *name;
+    unsigned int node;
+    std::chrono::steady_clock::time_point wall_start_time;
+    CPUClock::time_point cpu_start_time;
+  };
+
+  /**
+   * All data collected on a thread: the call tree with the accumulated
+   * times, and the list of the sections that have been entered and not
+   * exited, in the order in which they have been entered. Elements of the
+   * latter may be removed in the middle if an argument is given to the
+   * exit_section() function.
+   */
+  struct ThreadData
+  {
+    /**
+     * Constructor. Set up the root of the call tree.
+     */
+    ThreadData ();
+
+    std::vector<CallTreeNode> call_tree;
+    std::vector<ActiveSection> active_sections;
+  };
+
+  /**
+   * Merge the call trees of all threads into @p call_tree.
    */
-  std::map<std::string, Section> sections;
+  void merge_call_trees (std::vector<CallTreeNode> &call_tree) const;
+
+  /**
+   * Return the data of all sections that have been entered at least once,
+   * accumulated over all threads and positions in the call tree.
+   */
+  std::map<std::string, Section> get_section_data () const;
+
+  /**
+   * The names of the registered sections, indexed by the index of the
+   * section, and the index of each name.
+   */
+  std::vector<std::string> section_names;
+  std::map<std::string, unsigned int> section_indices;
+
+  /**
+   * The data collected on each thread.
+   */
+  mutable Threads::ThreadLocalStorage<ThreadData> thread_data;
 
   /**
    * The stream object to which we are to output.
@@ -854,24 +1065,16 @@ private:
    */
   bool output_is_enabled;
 
-  /**
-   * A list of the sections that have been entered and not exited. The list is
-   * kept in the order in which sections have been entered, but elements may
-   * be removed in the middle if an argument is given to the exit_section()
-   * function.
-   */
-  std::list<std::string> active_sections;
-
   /**
    * mpi communicator
    */
   MPI_Comm            mpi_communicator;
 
   /**
-   * A lock that makes sure that this class gives reasonable results even when
-   * used with several threads.
+   * A lock that protects the names of the sections and the output stream
+   * when the class is used with several threads.
    */
-  Threads::Mutex mutex;
+  mutable Threads::Mutex mutex;
 };
 
 
@@ -986,15 +1189,47 @@ TimerOutput::exit_section (const std::string &section_name)
   leave_subsection(section_name);
 }
 
+inline
+TimerOutput::SectionHandle::SectionHandle ()
+  :
+  index (numbers::invalid_unsigned_int),
+  name (nullptr)
+{}
+
+
+
+inline
+TimerOutput::SectionHandle::SectionHandle (const unsigned int  index,
+                                           const std::string *name)
+  :
+  index (index),
+  name (name)
+{}
+
+
+
 inline
 TimerOutput::Scope::Scope(dealii::TimerOutput &timer_,
                           const std::string &section_name_)
   :
   timer(timer_),
-  section_name(section_name_),
+  section(timer_.register_section(section_name_)),
+  in(true)
+{
+  timer.enter_subsection(section);
+}
+
+
+
+inline
+TimerOutput::Scope::Scope(dealii::TimerOutput &timer_,
+                          const SectionHandle &section_)
+  :
+  timer(timer_),
+  section(section_),
   in(true)
 {
-  timer.enter_section(section_name);
+  timer.enter_subsection(section);
 }
 
 inline
@@ -1015,7 +1250,7 @@ TimerOutput::Scope::stop()
   if (!in) return;
   in=false;
 
-  timer.exit_section(section_name);
+  timer.leave_subsection(section);
 }
 
 
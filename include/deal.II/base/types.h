@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2009 - 2016 by the deal.II authors
+// Copyright (C) 2009 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -154,6 +154,20 @@ namespace TrilinosWrappers
      */
     typedef int int_type;
 #endif
+
+    /**
+     * Declare type of integer used for global indices in the Tpetra package
+     * of Trilinos. As opposed to Epetra, Tpetra is templated on the index
+     * types, and we always use 64-bit global indices, independently of the
+     * setting of DEAL_II_WITH_64BIT_INDICES.
+     */
+    typedef long long tpetra_global_ordinal;
+
+    /**
+     * Declare type of integer used for local indices in the Tpetra package
+     * of Trilinos.
+     */
+    typedef int tpetra_local_ordinal;
   }
 }
 
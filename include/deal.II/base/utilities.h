@@ -19,6 +19,8 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/exceptions.h>
 
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <utility>
 #include <functional>
@@ -377,6 +379,22 @@ namespace Utilities
   std::vector<unsigned long long int>
   invert_permutation (const std::vector<unsigned long long int> &permutation);
 
+  /**
+   * Return the index along a Hilbert space-filling curve of the point with
+   * the integer coordinates @p coordinates, each of which must be smaller
+   * than $2^{n\_bits}$. Consecutive indices on the curve belong to points that
+   * are neighbors, so sorting points by this index gives an ordering with
+   * better locality than the z-order of a Morton curve. The @p n_bits per
+   * coordinate direction times @p dim must not exceed 64.
+   *
+   * The index is computed with the algorithm of J. Skilling, Programming the
+   * Hilbert curve, AIP Conf. Proc. 707, 381 (2004).
+   */
+  template <int dim>
+  std::uint64_t
+  hilbert_index (const std::array<unsigned int,dim> &coordinates,
+                 const unsigned int                  n_bits);
+
   /**
    * A namespace for utility functions that probe system properties.
    *
@@ -435,6 +453,24 @@ namespace Utilities
     std::string get_hostname ();
 
 
+    /**
+     * Return the most capable instruction set extension for vectorization
+     * supported by the processor this program runs on, using the numbering
+     * of DEAL_II_COMPILER_VECTORIZATION_LEVEL: 0 for none, 1 for SSE2 (or
+     * NEON and VSX on ARM and POWER processors), 2 for AVX, and 3 for
+     * AVX-512F.
+     *
+     * The width of VectorizedArray is fixed when deal.II is compiled, and
+     * the library can only run on processors that support at least that
+     * level. When the same installation is used on machines with different
+     * processors, e.g. on the partitions of a cluster, this function allows
+     * to detect a mismatch before executing an unsupported instruction. If
+     * the compiler does not provide a way to query the processor, this
+     * function returns DEAL_II_COMPILER_VECTORIZATION_LEVEL.
+     */
+    unsigned int get_cpu_vectorization_level ();
+
+
     /**
      * Return the present time as HH:MM:SS.
      */
@@ -446,11 +482,86 @@ namespace Utilities
      */
     std::string get_date ();
 
+    /**
+     * A structure describing how posix_memalign() places large memory
+     * blocks, such as the arrays of AlignedVector, Vector and
+     * LinearAlgebra::distributed::Vector. Streaming kernels on vectors of
+     * many gigabytes spend a noticeable fraction of their time on misses of
+     * the translation lookaside buffer (TLB) with the default page size of
+     * 4 kB, which huge pages of 2 MB avoid.
+     */
+    struct MemoryAllocationPolicy
+    {
+      /**
+       * The placement of the pages of a memory block on the NUMA nodes of
+       * the machine.
+       */
+      enum NumaPlacement
+      {
+        /**
+         * Leave the placement to the operating system, which puts each page
+         * on the NUMA node of the thread that first writes into it.
+         */
+        first_touch,
+        /**
+         * Distribute the pages round-robin over all NUMA nodes the process
+         * may use, which is preferable for data that is not accessed with
+         * the same thread partitioning as it was initialized with.
+         */
+        interleave
+      };
+
+      /**
+       * Constructor. Sets the default policy, i.e., neither huge pages nor
+       * interleaving.
+       */
+      MemoryAllocationPolicy ();
+
+      /**
+       * Whether to align large memory blocks to the size of huge pages and
+       * to ask the operating system to back them by transparent huge pages.
+       * This needs transparent huge pages to be enabled at least in
+       * <code>madvise</code> mode on Linux.
+       */
+      bool use_huge_pages;
+
+      /**
+       * The placement of large memory blocks on the NUMA nodes.
+       */
+      NumaPlacement numa_placement;
+
+      /**
+       * The minimal size in bytes of a memory block for the settings above
+       * to apply. Smaller blocks are always allocated in the default way,
+       * given that the alignment to huge pages may waste up to 2 MB per
+       * block. The default is 16 MB.
+       */
+      std::size_t minimum_size;
+    };
+
+    /**
+     * Set the policy used by all subsequent calls of posix_memalign() that
+     * do not specify a policy, i.e., by all the vector classes of deal.II.
+     * This is typically called once at the beginning of a program.
+     *
+     * The settings are advice to the operating system: they are silently
+     * ignored if the system does not support them, e.g., if transparent
+     * huge pages are disabled or the program does not run on Linux.
+     */
+    void set_memory_allocation_policy (const MemoryAllocationPolicy &policy);
+
+    /**
+     * Return the policy set by set_memory_allocation_policy().
+     */
+    MemoryAllocationPolicy get_memory_allocation_policy ();
+
     /**
      * Call the system function posix_memalign, or a replacement function if
      * not available, to allocate memory with a certain minimal alignment. The
      * first argument will then return a pointer to this memory block that can
-     * be released later on through a standard <code>free</code> call.
+     * be released later on through a standard <code>free</code> call. The
+     * memory block is placed according to the policy set by
+     * set_memory_allocation_policy().
      *
      * @param memptr The address of a pointer variable that will after this
      * call point to the allocated memory.
@@ -461,6 +572,13 @@ namespace Utilities
      * leaving this task to the calling site.
      */
     void posix_memalign (void **memptr, size_t alignment, size_t size);
+
+    /**
+     * Same as above, but place the memory block according to the given
+     * @p policy rather than the one of set_memory_allocation_policy().
+     */
+    void posix_memalign (void **memptr, size_t alignment, size_t size,
+                         const MemoryAllocationPolicy &policy);
   }
 
 
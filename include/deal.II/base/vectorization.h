@@ -30,7 +30,7 @@
 // #define DEAL_II_COMPILER_VECTORIZATION_LEVEL 3
 // #elif defined (__AVX__)
 // #define DEAL_II_COMPILER_VECTORIZATION_LEVEL 2
-// #elif defined (__SSE2__)
+// #elif defined (__SSE2__) || defined (__ARM_NEON) || defined (__VSX__)
 // #define DEAL_II_COMPILER_VECTORIZATION_LEVEL 1
 // #else
 // #define DEAL_II_COMPILER_VECTORIZATION_LEVEL 0
@@ -48,8 +48,17 @@
 
 #if DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 2 // AVX, AVX-512
 #include <immintrin.h>
-#elif DEAL_II_COMPILER_VECTORIZATION_LEVEL == 1 // SSE2
+#elif DEAL_II_COMPILER_VECTORIZATION_LEVEL == 1 && defined(__SSE2__) // SSE2
 #include <emmintrin.h>
+#elif DEAL_II_COMPILER_VECTORIZATION_LEVEL == 1 && defined(__ARM_NEON) && defined(__aarch64__) // NEON
+#include <arm_neon.h>
+#elif DEAL_II_COMPILER_VECTORIZATION_LEVEL == 1 && defined(__VSX__) // VSX
+#include <altivec.h>
+// altivec.h defines the keywords 'vector', 'pixel' and 'bool' as macros,
+// which conflict with C++
+#undef vector
+#undef pixel
+#undef bool
 #endif
 
 
@@ -117,7 +126,12 @@ struct EnableIfScalar<VectorizedArray<Number> >
  * Bulldozer processors and newer, four doubles and eight floats are used when
  * deal.II is configured e.g. using gcc with --with-cpu=native or --with-
  * cpu=corei7-avx. On compilations with AVX-512 support, eight doubles and
- * sixteen floats are used.
+ * sixteen floats are used. On 64 bit ARM processors with NEON and on POWER
+ * processors with VSX, two doubles and four floats are used.
+ * Since the width is part of the interface of all classes using this type,
+ * it can not be changed at run time, and a program can only run on
+ * processors supporting the instruction set deal.II was compiled for. Use
+ * Utilities::System::get_cpu_vectorization_level() to check this.
  *
  * This behavior of this class is made similar to the basic data types double
  * and float. The definition of a vectorized array does not initialize the
@@ -2042,7 +2056,7 @@ vectorized_transpose_and_store(const bool                    add_into,
 // for safety, also check that __SSE2__ is defined in case the user manually
 // set some conflicting compile flags which prevent compilation
 
-#elif DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 1
+#elif DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 1 && defined(__SSE2__)
 
 /**
  * Specialization for double and SSE2.
@@ -2705,6 +2719,1316 @@ vectorized_transpose_and_store(const bool                    add_into,
 
 
 
+#elif DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 1 && defined(__ARM_NEON) && defined(__aarch64__)
+
+/**
+ * Specialization for double and ARM NEON.
+ */
+template <>
+class VectorizedArray<double>
+{
+public:
+  /**
+   * This gives the number of vectors collected in this class.
+   */
+  static const unsigned int n_array_elements = 2;
+
+  /**
+   * This function can be used to set all data fields to a given scalar.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator = (const double x)
+  {
+    data = vdupq_n_f64(x);
+    return *this;
+  }
+
+  /**
+   * Access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  double &
+  operator [] (const unsigned int comp)
+  {
+    AssertIndexRange (comp, 2);
+    return *(reinterpret_cast<double *>(&data)+comp);
+  }
+
+  /**
+   * Constant access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  const double &
+  operator [] (const unsigned int comp) const
+  {
+    AssertIndexRange (comp, 2);
+    return *(reinterpret_cast<const double *>(&data)+comp);
+  }
+
+  /**
+   * Addition.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator += (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data += vec.data;
+#else
+    data = vaddq_f64(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Subtraction.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator -= (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data -= vec.data;
+#else
+    data = vsubq_f64(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Multiplication.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator *= (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data *= vec.data;
+#else
+    data = vmulq_f64(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Division.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator /= (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data /= vec.data;
+#else
+    data = vdivq_f64(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address. The memory need not be aligned by 16 bytes, as opposed
+   * to casting a double address to VectorizedArray<double>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void load (const double *ptr)
+  {
+    data = vld1q_f64 (ptr);
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address. The memory need not be aligned by
+   * 16 bytes, as opposed to casting a double address to
+   * VectorizedArray<double>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void store (double *ptr) const
+  {
+    vst1q_f64 (ptr, data);
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address and with given offsets, each entry from the offset
+   * providing one element of the vectorized array.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   this->operator[](v) = base_ptr[offsets[v]];
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void gather (const double       *base_ptr,
+               const unsigned int *offsets)
+  {
+    for (unsigned int i=0; i<2; ++i)
+      *(reinterpret_cast<double *>(&data)+i) = base_ptr[offsets[i]];
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address and the given offsets, filling the
+   * elements of the vectorized array into each offset.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   base_ptr[offsets[v]] = this->operator[](v);
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void scatter (const unsigned int *offsets,
+                double             *base_ptr) const
+  {
+    for (unsigned int i=0; i<2; ++i)
+      base_ptr[offsets[i]] = *(reinterpret_cast<const double *>(&data)+i);
+  }
+
+  /**
+   * Actual data field. Since this class represents a POD data type, it
+   * remains public.
+   */
+  float64x2_t data;
+
+private:
+  /**
+   * Return the square root of this field. Not for use in user code. Use
+   * sqrt(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_sqrt () const
+  {
+    VectorizedArray res;
+    res.data = vsqrtq_f64(data);
+    return res;
+  }
+
+  /**
+   * Return the absolute value of this field. Not for use in user code. Use
+   * abs(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_abs () const
+  {
+    VectorizedArray res;
+    res.data = vabsq_f64(data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise maximum of this field and another one. Not for
+   * use in user code. Use max(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_max (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vmaxq_f64 (data, other.data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise minimum of this field and another one. Not for
+   * use in user code. Use min(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_min (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vminq_f64 (data, other.data);
+    return res;
+  }
+
+  /**
+   * Make a few functions friends.
+   */
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::sqrt (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::abs  (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::max  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::min  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+};
+
+
+
+/**
+ * Specialization for double and ARM NEON.
+ */
+template <>
+inline
+void vectorized_load_and_transpose(const unsigned int      n_entries,
+                                   const double            *in,
+                                   const unsigned int      *offsets,
+                                   VectorizedArray<double> *out)
+{
+  const unsigned int n_chunks = n_entries/2;
+  for (unsigned int i=0; i<n_chunks; ++i)
+    {
+      float64x2_t u0 = vld1q_f64(in+2*i+offsets[0]);
+      float64x2_t u1 = vld1q_f64(in+2*i+offsets[1]);
+      out[2*i+0].data = vzip1q_f64 (u0, u1);
+      out[2*i+1].data = vzip2q_f64 (u0, u1);
+    }
+  for (unsigned int i=2*n_chunks; i<n_entries; ++i)
+    for (unsigned int v=0; v<2; ++v)
+      out[i][v] = in[offsets[v]+i];
+}
+
+
+
+/**
+ * Specialization for double and ARM NEON.
+ */
+template <>
+inline
+void
+vectorized_transpose_and_store(const bool                     add_into,
+                               const unsigned int             n_entries,
+                               const VectorizedArray<double> *in,
+                               const unsigned int            *offsets,
+                               double                        *out)
+{
+  const unsigned int n_chunks = n_entries/2;
+  if (add_into)
+    {
+      for (unsigned int i=0; i<n_chunks; ++i)
+        {
+          float64x2_t u0 = in[2*i+0].data;
+          float64x2_t u1 = in[2*i+1].data;
+          float64x2_t res0 = vzip1q_f64 (u0, u1);
+          float64x2_t res1 = vzip2q_f64 (u0, u1);
+          vst1q_f64(out+2*i+offsets[0], vaddq_f64(vld1q_f64(out+2*i+offsets[0]), res0));
+          vst1q_f64(out+2*i+offsets[1], vaddq_f64(vld1q_f64(out+2*i+offsets[1]), res1));
+        }
+      for (unsigned int i=2*n_chunks; i<n_entries; ++i)
+        for (unsigned int v=0; v<2; ++v)
+          out[offsets[v]+i] += in[i][v];
+    }
+  else
+    {
+      for (unsigned int i=0; i<n_chunks; ++i)
+        {
+          float64x2_t u0 = in[2*i+0].data;
+          float64x2_t u1 = in[2*i+1].data;
+          float64x2_t res0 = vzip1q_f64 (u0, u1);
+          float64x2_t res1 = vzip2q_f64 (u0, u1);
+          vst1q_f64(out+2*i+offsets[0], res0);
+          vst1q_f64(out+2*i+offsets[1], res1);
+        }
+      for (unsigned int i=2*n_chunks; i<n_entries; ++i)
+        for (unsigned int v=0; v<2; ++v)
+          out[offsets[v]+i] = in[i][v];
+    }
+}
+
+
+
+/**
+ * Specialization for float and ARM NEON.
+ */
+template <>
+class VectorizedArray<float>
+{
+public:
+  /**
+   * This gives the number of vectors collected in this class.
+   */
+  static const unsigned int n_array_elements = 4;
+
+  /**
+   * This function can be used to set all data fields to a given scalar.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator = (const float x)
+  {
+    data = vdupq_n_f32(x);
+    return *this;
+  }
+
+  /**
+   * Access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  float &
+  operator [] (const unsigned int comp)
+  {
+    AssertIndexRange (comp, 4);
+    return *(reinterpret_cast<float *>(&data)+comp);
+  }
+
+  /**
+   * Constant access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  const float &
+  operator [] (const unsigned int comp) const
+  {
+    AssertIndexRange (comp, 4);
+    return *(reinterpret_cast<const float *>(&data)+comp);
+  }
+
+  /**
+   * Addition.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator += (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data += vec.data;
+#else
+    data = vaddq_f32(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Subtraction.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator -= (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data -= vec.data;
+#else
+    data = vsubq_f32(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Multiplication.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator *= (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data *= vec.data;
+#else
+    data = vmulq_f32(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Division.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator /= (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data /= vec.data;
+#else
+    data = vdivq_f32(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address. The memory need not be aligned by 16 bytes, as opposed
+   * to casting a float address to VectorizedArray<float>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void load (const float *ptr)
+  {
+    data = vld1q_f32 (ptr);
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address. The memory need not be aligned by
+   * 16 bytes, as opposed to casting a float address to
+   * VectorizedArray<float>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void store (float *ptr) const
+  {
+    vst1q_f32 (ptr, data);
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address and with given offsets, each entry from the offset
+   * providing one element of the vectorized array.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   this->operator[](v) = base_ptr[offsets[v]];
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void gather (const float        *base_ptr,
+               const unsigned int *offsets)
+  {
+    for (unsigned int i=0; i<4; ++i)
+      *(reinterpret_cast<float *>(&data)+i) = base_ptr[offsets[i]];
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address and the given offsets, filling the
+   * elements of the vectorized array into each offset.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   base_ptr[offsets[v]] = this->operator[](v);
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void scatter (const unsigned int *offsets,
+                float              *base_ptr) const
+  {
+    for (unsigned int i=0; i<4; ++i)
+      base_ptr[offsets[i]] = *(reinterpret_cast<const float *>(&data)+i);
+  }
+
+  /**
+   * Actual data field. Since this class represents a POD data type, it
+   * remains public.
+   */
+  float32x4_t data;
+
+private:
+  /**
+   * Return the square root of this field. Not for use in user code. Use
+   * sqrt(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_sqrt () const
+  {
+    VectorizedArray res;
+    res.data = vsqrtq_f32(data);
+    return res;
+  }
+
+  /**
+   * Return the absolute value of this field. Not for use in user code. Use
+   * abs(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_abs () const
+  {
+    VectorizedArray res;
+    res.data = vabsq_f32(data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise maximum of this field and another one. Not for
+   * use in user code. Use max(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_max (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vmaxq_f32 (data, other.data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise minimum of this field and another one. Not for
+   * use in user code. Use min(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_min (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vminq_f32 (data, other.data);
+    return res;
+  }
+
+  /**
+   * Make a few functions friends.
+   */
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::sqrt (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::abs  (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::max  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::min  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+};
+
+
+
+/**
+ * Specialization for float and ARM NEON.
+ */
+template <>
+inline
+void vectorized_load_and_transpose(const unsigned int      n_entries,
+                                   const float            *in,
+                                   const unsigned int     *offsets,
+                                   VectorizedArray<float> *out)
+{
+  // the 4x4 transpose is done by two rounds of interleaving of the lower
+  // and upper halves of pairs of vectors
+  const unsigned int n_chunks = n_entries/4;
+  for (unsigned int i=0; i<n_chunks; ++i)
+    {
+      float32x4_t u0 = vld1q_f32(in+4*i+offsets[0]);
+      float32x4_t u1 = vld1q_f32(in+4*i+offsets[1]);
+      float32x4_t u2 = vld1q_f32(in+4*i+offsets[2]);
+      float32x4_t u3 = vld1q_f32(in+4*i+offsets[3]);
+      float32x4_t v0 = vzip1q_f32 (u0, u2);
+      float32x4_t v1 = vzip2q_f32 (u0, u2);
+      float32x4_t v2 = vzip1q_f32 (u1, u3);
+      float32x4_t v3 = vzip2q_f32 (u1, u3);
+      out[4*i+0].data = vzip1q_f32 (v0, v2);
+      out[4*i+1].data = vzip2q_f32 (v0, v2);
+      out[4*i+2].data = vzip1q_f32 (v1, v3);
+      out[4*i+3].data = vzip2q_f32 (v1, v3);
+    }
+  for (unsigned int i=4*n_chunks; i<n_entries; ++i)
+    for (unsigned int v=0; v<4; ++v)
+      out[i][v] = in[offsets[v]+i];
+}
+
+
+
+/**
+ * Specialization for float and ARM NEON.
+ */
+template <>
+inline
+void
+vectorized_transpose_and_store(const bool                    add_into,
+                               const unsigned int            n_entries,
+                               const VectorizedArray<float> *in,
+                               const unsigned int           *offsets,
+                               float                        *out)
+{
+  const unsigned int n_chunks = n_entries/4;
+  for (unsigned int i=0; i<n_chunks; ++i)
+    {
+      float32x4_t u0 = in[4*i+0].data;
+      float32x4_t u1 = in[4*i+1].data;
+      float32x4_t u2 = in[4*i+2].data;
+      float32x4_t u3 = in[4*i+3].data;
+      float32x4_t t0 = vzip1q_f32 (u0, u2);
+      float32x4_t t1 = vzip2q_f32 (u0, u2);
+      float32x4_t t2 = vzip1q_f32 (u1, u3);
+      float32x4_t t3 = vzip2q_f32 (u1, u3);
+      u0 = vzip1q_f32 (t0, t2);
+      u1 = vzip2q_f32 (t0, t2);
+      u2 = vzip1q_f32 (t1, t3);
+      u3 = vzip2q_f32 (t1, t3);
+
+      // Cannot use the same store instructions in both paths of the 'if'
+      // because the compiler cannot know that there is no aliasing between
+      // pointers
+      if (add_into)
+        {
+          u0 = vaddq_f32(vld1q_f32(out+4*i+offsets[0]), u0);
+          vst1q_f32(out+4*i+offsets[0], u0);
+          u1 = vaddq_f32(vld1q_f32(out+4*i+offsets[1]), u1);
+          vst1q_f32(out+4*i+offsets[1], u1);
+          u2 = vaddq_f32(vld1q_f32(out+4*i+offsets[2]), u2);
+          vst1q_f32(out+4*i+offsets[2], u2);
+          u3 = vaddq_f32(vld1q_f32(out+4*i+offsets[3]), u3);
+          vst1q_f32(out+4*i+offsets[3], u3);
+        }
+      else
+        {
+          vst1q_f32(out+4*i+offsets[0], u0);
+          vst1q_f32(out+4*i+offsets[1], u1);
+          vst1q_f32(out+4*i+offsets[2], u2);
+          vst1q_f32(out+4*i+offsets[3], u3);
+        }
+    }
+  if (add_into)
+    for (unsigned int i=4*n_chunks; i<n_entries; ++i)
+      for (unsigned int v=0; v<4; ++v)
+        out[offsets[v]+i] += in[i][v];
+  else
+    for (unsigned int i=4*n_chunks; i<n_entries; ++i)
+      for (unsigned int v=0; v<4; ++v)
+        out[offsets[v]+i] = in[i][v];
+}
+
+
+
+#elif DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 1 && defined(__VSX__)
+
+/**
+ * Specialization for double and POWER VSX.
+ */
+template <>
+class VectorizedArray<double>
+{
+public:
+  /**
+   * This gives the number of vectors collected in this class.
+   */
+  static const unsigned int n_array_elements = 2;
+
+  /**
+   * This function can be used to set all data fields to a given scalar.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator = (const double x)
+  {
+    data = vec_splats(x);
+    return *this;
+  }
+
+  /**
+   * Access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  double &
+  operator [] (const unsigned int comp)
+  {
+    AssertIndexRange (comp, 2);
+    return *(reinterpret_cast<double *>(&data)+comp);
+  }
+
+  /**
+   * Constant access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  const double &
+  operator [] (const unsigned int comp) const
+  {
+    AssertIndexRange (comp, 2);
+    return *(reinterpret_cast<const double *>(&data)+comp);
+  }
+
+  /**
+   * Addition.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator += (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data += vec.data;
+#else
+    data = vec_add(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Subtraction.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator -= (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data -= vec.data;
+#else
+    data = vec_sub(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Multiplication.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator *= (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data *= vec.data;
+#else
+    data = vec_mul(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Division.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator /= (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data /= vec.data;
+#else
+    data = vec_div(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address. The memory need not be aligned by 16 bytes, as opposed
+   * to casting a double address to VectorizedArray<double>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void load (const double *ptr)
+  {
+    data = vec_xl (0, ptr);
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address. The memory need not be aligned by
+   * 16 bytes, as opposed to casting a double address to
+   * VectorizedArray<double>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void store (double *ptr) const
+  {
+    vec_xst (data, 0, ptr);
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address and with given offsets, each entry from the offset
+   * providing one element of the vectorized array.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   this->operator[](v) = base_ptr[offsets[v]];
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void gather (const double       *base_ptr,
+               const unsigned int *offsets)
+  {
+    for (unsigned int i=0; i<2; ++i)
+      *(reinterpret_cast<double *>(&data)+i) = base_ptr[offsets[i]];
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address and the given offsets, filling the
+   * elements of the vectorized array into each offset.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   base_ptr[offsets[v]] = this->operator[](v);
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void scatter (const unsigned int *offsets,
+                double             *base_ptr) const
+  {
+    for (unsigned int i=0; i<2; ++i)
+      base_ptr[offsets[i]] = *(reinterpret_cast<const double *>(&data)+i);
+  }
+
+  /**
+   * Actual data field. Since this class represents a POD data type, it
+   * remains public.
+   */
+  __vector double data;
+
+private:
+  /**
+   * Return the square root of this field. Not for use in user code. Use
+   * sqrt(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_sqrt () const
+  {
+    VectorizedArray res;
+    res.data = vec_sqrt(data);
+    return res;
+  }
+
+  /**
+   * Return the absolute value of this field. Not for use in user code. Use
+   * abs(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_abs () const
+  {
+    VectorizedArray res;
+    res.data = vec_abs(data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise maximum of this field and another one. Not for
+   * use in user code. Use max(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_max (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vec_max (data, other.data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise minimum of this field and another one. Not for
+   * use in user code. Use min(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_min (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vec_min (data, other.data);
+    return res;
+  }
+
+  /**
+   * Make a few functions friends.
+   */
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::sqrt (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::abs  (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::max  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::min  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+};
+
+
+
+/**
+ * Specialization for double and POWER VSX.
+ */
+template <>
+inline
+void vectorized_load_and_transpose(const unsigned int      n_entries,
+                                   const double            *in,
+                                   const unsigned int      *offsets,
+                                   VectorizedArray<double> *out)
+{
+  const unsigned int n_chunks = n_entries/2;
+  for (unsigned int i=0; i<n_chunks; ++i)
+    {
+      __vector double u0 = vec_xl(0, in+2*i+offsets[0]);
+      __vector double u1 = vec_xl(0, in+2*i+offsets[1]);
+      out[2*i+0].data = vec_mergeh (u0, u1);
+      out[2*i+1].data = vec_mergel (u0, u1);
+    }
+  for (unsigned int i=2*n_chunks; i<n_entries; ++i)
+    for (unsigned int v=0; v<2; ++v)
+      out[i][v] = in[offsets[v]+i];
+}
+
+
+
+/**
+ * Specialization for double and POWER VSX.
+ */
+template <>
+inline
+void
+vectorized_transpose_and_store(const bool                     add_into,
+                               const unsigned int             n_entries,
+                               const VectorizedArray<double> *in,
+                               const unsigned int            *offsets,
+                               double                        *out)
+{
+  const unsigned int n_chunks = n_entries/2;
+  if (add_into)
+    {
+      for (unsigned int i=0; i<n_chunks; ++i)
+        {
+          __vector double u0 = in[2*i+0].data;
+          __vector double u1 = in[2*i+1].data;
+          __vector double res0 = vec_mergeh (u0, u1);
+          __vector double res1 = vec_mergel (u0, u1);
+          vec_xst(vec_add(vec_xl(0, out+2*i+offsets[0]), res0), 0, out+2*i+offsets[0]);
+          vec_xst(vec_add(vec_xl(0, out+2*i+offsets[1]), res1), 0, out+2*i+offsets[1]);
+        }
+      for (unsigned int i=2*n_chunks; i<n_entries; ++i)
+        for (unsigned int v=0; v<2; ++v)
+          out[offsets[v]+i] += in[i][v];
+    }
+  else
+    {
+      for (unsigned int i=0; i<n_chunks; ++i)
+        {
+          __vector double u0 = in[2*i+0].data;
+          __vector double u1 = in[2*i+1].data;
+          __vector double res0 = vec_mergeh (u0, u1);
+          __vector double res1 = vec_mergel (u0, u1);
+          vec_xst(res0, 0, out+2*i+offsets[0]);
+          vec_xst(res1, 0, out+2*i+offsets[1]);
+        }
+      for (unsigned int i=2*n_chunks; i<n_entries; ++i)
+        for (unsigned int v=0; v<2; ++v)
+          out[offsets[v]+i] = in[i][v];
+    }
+}
+
+
+
+/**
+ * Specialization for float and POWER VSX.
+ */
+template <>
+class VectorizedArray<float>
+{
+public:
+  /**
+   * This gives the number of vectors collected in this class.
+   */
+  static const unsigned int n_array_elements = 4;
+
+  /**
+   * This function can be used to set all data fields to a given scalar.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator = (const float x)
+  {
+    data = vec_splats(x);
+    return *this;
+  }
+
+  /**
+   * Access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  float &
+  operator [] (const unsigned int comp)
+  {
+    AssertIndexRange (comp, 4);
+    return *(reinterpret_cast<float *>(&data)+comp);
+  }
+
+  /**
+   * Constant access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  const float &
+  operator [] (const unsigned int comp) const
+  {
+    AssertIndexRange (comp, 4);
+    return *(reinterpret_cast<const float *>(&data)+comp);
+  }
+
+  /**
+   * Addition.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator += (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data += vec.data;
+#else
+    data = vec_add(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Subtraction.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator -= (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data -= vec.data;
+#else
+    data = vec_sub(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Multiplication.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator *= (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data *= vec.data;
+#else
+    data = vec_mul(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Division.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator /= (const VectorizedArray &vec)
+  {
+#ifdef DEAL_II_COMPILER_USE_VECTOR_ARITHMETICS
+    data /= vec.data;
+#else
+    data = vec_div(data,vec.data);
+#endif
+    return *this;
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address. The memory need not be aligned by 16 bytes, as opposed
+   * to casting a float address to VectorizedArray<float>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void load (const float *ptr)
+  {
+    data = vec_xl (0, ptr);
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address. The memory need not be aligned by
+   * 16 bytes, as opposed to casting a float address to
+   * VectorizedArray<float>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void store (float *ptr) const
+  {
+    vec_xst (data, 0, ptr);
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address and with given offsets, each entry from the offset
+   * providing one element of the vectorized array.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   this->operator[](v) = base_ptr[offsets[v]];
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void gather (const float        *base_ptr,
+               const unsigned int *offsets)
+  {
+    for (unsigned int i=0; i<4; ++i)
+      *(reinterpret_cast<float *>(&data)+i) = base_ptr[offsets[i]];
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address and the given offsets, filling the
+   * elements of the vectorized array into each offset.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   base_ptr[offsets[v]] = this->operator[](v);
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void scatter (const unsigned int *offsets,
+                float              *base_ptr) const
+  {
+    for (unsigned int i=0; i<4; ++i)
+      base_ptr[offsets[i]] = *(reinterpret_cast<const float *>(&data)+i);
+  }
+
+  /**
+   * Actual data field. Since this class represents a POD data type, it
+   * remains public.
+   */
+  __vector float data;
+
+private:
+  /**
+   * Return the square root of this field. Not for use in user code. Use
+   * sqrt(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_sqrt () const
+  {
+    VectorizedArray res;
+    res.data = vec_sqrt(data);
+    return res;
+  }
+
+  /**
+   * Return the absolute value of this field. Not for use in user code. Use
+   * abs(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_abs () const
+  {
+    VectorizedArray res;
+    res.data = vec_abs(data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise maximum of this field and another one. Not for
+   * use in user code. Use max(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_max (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vec_max (data, other.data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise minimum of this field and another one. Not for
+   * use in user code. Use min(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_min (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vec_min (data, other.data);
+    return res;
+  }
+
+  /**
+   * Make a few functions friends.
+   */
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::sqrt (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::abs  (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::max  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::min  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+};
+
+
+
+/**
+ * Specialization for float and POWER VSX.
+ */
+template <>
+inline
+void vectorized_load_and_transpose(const unsigned int      n_entries,
+                                   const float            *in,
+                                   const unsigned int     *offsets,
+                                   VectorizedArray<float> *out)
+{
+  // the 4x4 transpose is done by two rounds of interleaving of the lower
+  // and upper halves of pairs of vectors
+  const unsigned int n_chunks = n_entries/4;
+  for (unsigned int i=0; i<n_chunks; ++i)
+    {
+      __vector float u0 = vec_xl(0, in+4*i+offsets[0]);
+      __vector float u1 = vec_xl(0, in+4*i+offsets[1]);
+      __vector float u2 = vec_xl(0, in+4*i+offsets[2]);
+      __vector float u3 = vec_xl(0, in+4*i+offsets[3]);
+      __vector float v0 = vec_mergeh (u0, u2);
+      __vector float v1 = vec_mergel (u0, u2);
+      __vector float v2 = vec_mergeh (u1, u3);
+      __vector float v3 = vec_mergel (u1, u3);
+      out[4*i+0].data = vec_mergeh (v0, v2);
+      out[4*i+1].data = vec_mergel (v0, v2);
+      out[4*i+2].data = vec_mergeh (v1, v3);
+      out[4*i+3].data = vec_mergel (v1, v3);
+    }
+  for (unsigned int i=4*n_chunks; i<n_entries; ++i)
+    for (unsigned int v=0; v<4; ++v)
+      out[i][v] = in[offsets[v]+i];
+}
+
+
+
+/**
+ * Specialization for float and POWER VSX.
+ */
+template <>
+inline
+void
+vectorized_transpose_and_store(const bool                    add_into,
+                               const unsigned int            n_entries,
+                               const VectorizedArray<float> *in,
+                               const unsigned int           *offsets,
+                               float                        *out)
+{
+  const unsigned int n_chunks = n_entries/4;
+  for (unsigned int i=0; i<n_chunks; ++i)
+    {
+      __vector float u0 = in[4*i+0].data;
+      __vector float u1 = in[4*i+1].data;
+      __vector float u2 = in[4*i+2].data;
+      __vector float u3 = in[4*i+3].data;
+      __vector float t0 = vec_mergeh (u0, u2);
+      __vector float t1 = vec_mergel (u0, u2);
+      __vector float t2 = vec_mergeh (u1, u3);
+      __vector float t3 = vec_mergel (u1, u3);
+      u0 = vec_mergeh (t0, t2);
+      u1 = vec_mergel (t0, t2);
+      u2 = vec_mergeh (t1, t3);
+      u3 = vec_mergel (t1, t3);
+
+      // Cannot use the same store instructions in both paths of the 'if'
+      // because the compiler cannot know that there is no aliasing between
+      // pointers
+      if (add_into)
+        {
+          u0 = vec_add(vec_xl(0, out+4*i+offsets[0]), u0);
+          vec_xst(u0, 0, out+4*i+offsets[0]);
+          u1 = vec_add(vec_xl(0, out+4*i+offsets[1]), u1);
+          vec_xst(u1, 0, out+4*i+offsets[1]);
+          u2 = vec_add(vec_xl(0, out+4*i+offsets[2]), u2);
+          vec_xst(u2, 0, out+4*i+offsets[2]);
+          u3 = vec_add(vec_xl(0, out+4*i+offsets[3]), u3);
+          vec_xst(u3, 0, out+4*i+offsets[3]);
+        }
+      else
+        {
+          vec_xst(u0, 0, out+4*i+offsets[0]);
+          vec_xst(u1, 0, out+4*i+offsets[1]);
+          vec_xst(u2, 0, out+4*i+offsets[2]);
+          vec_xst(u3, 0, out+4*i+offsets[3]);
+        }
+    }
+  if (add_into)
+    for (unsigned int i=4*n_chunks; i<n_entries; ++i)
+      for (unsigned int v=0; v<4; ++v)
+        out[offsets[v]+i] += in[i][v];
+  else
+    for (unsigned int i=4*n_chunks; i<n_entries; ++i)
+      for (unsigned int v=0; v<4; ++v)
+        out[offsets[v]+i] = in[i][v];
+}
+
+
+
 #endif // if DEAL_II_COMPILER_VECTORIZATION_LEVEL > 0
 
 
@@ -3088,6 +4412,35 @@ operator - (const VectorizedArray<Number> &u)
 }
 
 
+
+namespace numbers
+{
+  template <typename Number>
+  inline
+  bool value_is_greater_than (const VectorizedArray<Number> &value,
+                              const double                   reference)
+  {
+    for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+      if (!(value[v] > reference))
+        return false;
+    return true;
+  }
+
+
+
+  template <typename Number>
+  inline
+  bool value_is_less_than (const VectorizedArray<Number> &value,
+                           const double                   reference)
+  {
+    for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+      if (!(value[v] < reference))
+        return false;
+    return true;
+  }
+}
+
+
 DEAL_II_NAMESPACE_CLOSE
 
 
@@ -19,6 +19,7 @@
 
 #include <deal.II/base/config.h>
 #include <deal.II/base/graph_coloring.h>
+#include <deal.II/base/mpi_progress.h>
 #include <deal.II/base/multithread_info.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/template_constraints.h>
@@ -30,10 +31,14 @@
 #  include <tbb/pipeline.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <list>
 #include <vector>
 #include <utility>
 #include <memory>
 #include <functional>
+#include <thread>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -135,6 +140,17 @@ DEAL_II_NAMESPACE_OPEN
  * CopyData can be resized in accordance with the number of local DoFs on the
  * current cell.
  *
+ * For many threads, running only one copier at a time may limit the
+ * parallel speedup. The function run_with_conflicts() instead runs the
+ * copiers of different items concurrently unless they write into
+ * overlapping parts of the global object, at the price of giving up the
+ * fixed order of the copiers.
+ *
+ * All of these functions create the scratch data objects anew in each call.
+ * If they are called many times, e.g., once per time step, the scratch data
+ * objects can instead be kept in a ScratchDataPool that is passed in place of
+ * the sample scratch data.
+ *
  * The functions in this namespace only really work in parallel when
  * multithread mode was selected during deal.II configuration. Otherwise they
  * simply work on each item sequentially.
@@ -145,6 +161,178 @@ DEAL_II_NAMESPACE_OPEN
 namespace WorkStream
 {
 
+  /**
+   * A collection of ScratchData objects that persists across several calls
+   * of the WorkStream functions. Each of the run() functions creates copies
+   * of the sample scratch data object when a thread first needs one and
+   * throws them away at the end, so code that calls run() many times, for
+   * example in every step of a time stepping scheme, pays for the repeated
+   * construction of the scratch objects (e.g., of FEValues objects). When a
+   * ScratchDataPool is passed to run() in place of the sample scratch data,
+   * the scratch objects are instead kept in the pool and handed out again
+   * in later calls.
+   *
+   * The pool keeps a separate list of objects for each thread, and an
+   * object is always used by the thread that created it. Since the object
+   * is copy-constructed by that thread, its memory is placed by the
+   * first-touch policy of the operating system on the NUMA domain of that
+   * thread, and it stays close to the thread as long as the threads of the
+   * task scheduler are not moved between domains. Each list may contain
+   * more than one object: the worker functions may start tasks themselves
+   * and then call Threads::TaskGroup::join_all() or a similar function,
+   * which the TBB scheduler may use to run another instance of the worker
+   * function on the current thread, which then needs its own scratch
+   * object. Objects are marked as used while they are in use, and no
+   * synchronization is necessary because each list is only accessed by a
+   * single thread.
+   *
+   * The pool must not be used by two calls of run() at the same time.
+   *
+   * @ingroup threads
+   */
+  template <typename ScratchData>
+  class ScratchDataPool
+  {
+  public:
+    /**
+     * Constructor. The objects of the pool will be created as copies of the
+     * given sample, of which the pool keeps its own copy.
+     */
+    explicit ScratchDataPool (const ScratchData &sample_scratch_data);
+
+    /**
+     * Constructor. Same as above, but the sample is shared with the caller
+     * rather than copied. The sample must not be changed while the pool
+     * exists.
+     */
+    explicit ScratchDataPool (const std::shared_ptr<const ScratchData> &sample_scratch_data);
+
+    /**
+     * Return an object of the current thread that is currently not in use
+     * and mark it as used. If there is no such object, a new object is
+     * created as a copy of the sample on the current thread.
+     */
+    ScratchData &acquire ();
+
+    /**
+     * Mark an object obtained by acquire() on the current thread as unused
+     * again, so that it can be handed out by later calls to acquire().
+     */
+    void release (ScratchData &scratch_data);
+
+    /**
+     * Delete all objects of all threads, for example because the sample has
+     * been changed. This function must not be called while objects are in
+     * use.
+     */
+    void clear ();
+
+  private:
+    /**
+     * A structure that contains a pointer to a scratch data object
+     * along with a flag that indicates whether this object is currently
+     * in use.
+     */
+    struct ScratchDataObject
+    {
+      ScratchDataObject (ScratchData *p,
+                         const bool   in_use)
+        :
+        scratch_data (p),
+        currently_in_use (in_use)
+      {}
+
+      std::shared_ptr<ScratchData> scratch_data;
+      bool                         currently_in_use;
+    };
+
+    /**
+     * The sample from which new objects are copied.
+     */
+    std::shared_ptr<const ScratchData> sample_scratch_data;
+
+    /**
+     * The list of objects of each thread. The objects are held by
+     * shared_ptr so that they are deleted on all threads when the thread
+     * local object is destroyed.
+     */
+    Threads::ThreadLocalStorage<std::list<ScratchDataObject> > objects;
+  };
+
+
+
+  template <typename ScratchData>
+  inline
+  ScratchDataPool<ScratchData>::ScratchDataPool (const ScratchData &sample_scratch_data)
+    :
+    sample_scratch_data (std::make_shared<const ScratchData>(sample_scratch_data))
+  {}
+
+
+
+  template <typename ScratchData>
+  inline
+  ScratchDataPool<ScratchData>::ScratchDataPool (const std::shared_ptr<const ScratchData> &sample_scratch_data)
+    :
+    sample_scratch_data (sample_scratch_data)
+  {
+    Assert (sample_scratch_data.get() != nullptr,
+            ExcMessage ("The sample scratch data must not be a null pointer."));
+  }
+
+
+
+  template <typename ScratchData>
+  inline
+  ScratchData &
+  ScratchDataPool<ScratchData>::acquire ()
+  {
+    std::list<ScratchDataObject> &list = objects.get();
+
+    // see if there is an unused object. if so, grab it and mark it as used
+    for (auto &object : list)
+      if (object.currently_in_use == false)
+        {
+          object.currently_in_use = true;
+          return *object.scratch_data;
+        }
+
+    // if no object was found, create one on the current thread and mark it
+    // as used
+    list.emplace_back (new ScratchData(*sample_scratch_data), true);
+    return *list.back().scratch_data;
+  }
+
+
+
+  template <typename ScratchData>
+  inline
+  void
+  ScratchDataPool<ScratchData>::release (ScratchData &scratch_data)
+  {
+    for (auto &object : objects.get())
+      if (object.scratch_data.get() == &scratch_data)
+        {
+          Assert (object.currently_in_use == true, ExcInternalError());
+          object.currently_in_use = false;
+          return;
+        }
+    Assert (false,
+            ExcMessage ("The object passed to ScratchDataPool::release() was "
+                        "not acquired from this pool on the current thread."));
+  }
+
+
+
+  template <typename ScratchData>
+  inline
+  void
+  ScratchDataPool<ScratchData>::clear ()
+  {
+    objects.clear ();
+  }
+
+
 #ifdef DEAL_II_WITH_THREADS
 
   namespace internal
@@ -186,53 +374,6 @@ namespace WorkStream
          */
         struct ItemType
         {
-          /**
-           * A structure that contains a pointer to a scratch data object
-           * along with a flag that indicates whether this object is currently
-           * in use.
-           */
-          struct ScratchDataObject
-          {
-            std::shared_ptr<ScratchData> scratch_data;
-            bool                         currently_in_use;
-
-            /**
-             * Default constructor.
-             */
-            ScratchDataObject ()
-              :
-              currently_in_use (false)
-            {}
-
-            ScratchDataObject (ScratchData *p,
-                               const bool in_use)
-              :
-              scratch_data (p),
-              currently_in_use (in_use)
-            {}
-
-//TODO: when we push back an object to the list of scratch objects, in
-//  Worker::operator(), we first create an object and then copy
-//  it to the end of this list. this involves having two objects
-//      of the current type having pointers to it, each with their own
-//      currently_in_use flag. there is probably little harm in this because
-//      the original one goes out of scope right away again, but it's
-//      certainly awkward. one way to avoid this would be to use unique_ptr
-//      but we'd need to figure out a way to use it in non-C++11 mode
-            ScratchDataObject (const ScratchDataObject &o)
-              :
-              scratch_data (o.scratch_data),
-              currently_in_use (o.currently_in_use)
-            {}
-          };
-
-
-          /**
-           * Typedef to a list of scratch data objects. The rationale for this
-           * list is provided in the variables that use these lists.
-           */
-          typedef std::list<ScratchDataObject> ScratchDataList;
-
           /**
            * A list of iterators that need to be worked on. Only the first
            * n_items are relevant.
@@ -254,43 +395,11 @@ namespace WorkStream
           unsigned int          n_items;
 
           /**
-           * Pointer to a thread local variable identifying the scratch data
-           * objects this thread will use. The initial implementation of this
-           * class using thread local variables provided only a single scratch
-           * object per thread. This doesn't work, because the worker
-           * functions may start tasks itself and then call
-           * Threads::TaskGroup::join_all() or a similar function, which the
-           * TBB scheduler may use to run something else on the current thread
-           * -- for example another instance of the worker function.
-           * Consequently, there would be two instances of the worker function
-           * that use the same scratch object if we only provided a single
-           * scratch object per thread. The solution is to provide a list of
-           * scratch objects for each thread, together with a flag indicating
-           * whether this scratch object is currently used. If a thread needs
-           * a scratch object, it walks this list until it finds an unused
-           * object, or, if there is none, creates one itself. Note that we
-           * need not use synchronization primitives for this process since
-           * the lists are thread-local and we are guaranteed that only a
-           * single thread accesses them as long as we have no yield point in
-           * between the accesses to the list.
-           *
-           * The pointers to scratch objects stored in each of these lists
-           * must be so that they are deleted on all threads when the thread
-           * local object is destroyed. This is achieved by using shared_ptr.
-           *
-           * Note that when a worker needs to create a scratch object, it
-           * allocates it using sample_scratch_data to copy from. This has the
-           * advantage of a first-touch initialization, i.e., the memory for
-           * the scratch data object is allocated and initialized by the same
-           * thread that will later use it.
-           */
-          Threads::ThreadLocalStorage<ScratchDataList> *scratch_data;
-
-          /**
-           * Pointer to a sample scratch data object, to be used to initialize
-           * the scratch data objects created for each individual thread.
+           * Pointer to the pool of scratch data objects the worker takes its
+           * scratch object from. See the documentation of ScratchDataPool for
+           * why this is a list of objects per thread.
            */
-          const ScratchData *sample_scratch_data;
+          ScratchDataPool<ScratchData> *scratch_data_pool;
 
           /**
            * Flag is true if the buffer is used and false if the buffer can be
@@ -306,8 +415,7 @@ namespace WorkStream
           ItemType ()
             :
             n_items (0),
-            scratch_data (nullptr),
-            sample_scratch_data (nullptr),
+            scratch_data_pool (nullptr),
             currently_in_use (false)
           {}
         };
@@ -315,20 +423,20 @@ namespace WorkStream
 
         /**
          * Constructor. Take an iterator range, the size of a buffer that can
-         * hold items, and the sample additional data object that will be
+         * hold items, the pool of scratch data objects the worker function
+         * invocations use, and the sample copy data object that will be
          * passed to each worker and copier function invocation.
          */
-        IteratorRangeToItemStream (const Iterator       &begin,
-                                   const Iterator       &end,
-                                   const unsigned int    buffer_size,
-                                   const unsigned int    chunk_size,
-                                   const ScratchData    &sample_scratch_data,
-                                   const CopyData       &sample_copy_data)
+        IteratorRangeToItemStream (const Iterator               &begin,
+                                   const Iterator               &end,
+                                   const unsigned int            buffer_size,
+                                   const unsigned int            chunk_size,
+                                   ScratchDataPool<ScratchData> &scratch_data_pool,
+                                   const CopyData               &sample_copy_data)
           :
           tbb::filter (/*is_serial=*/true),
           remaining_iterator_range (begin, end),
           item_buffer (buffer_size),
-          sample_scratch_data (sample_scratch_data),
           chunk_size (chunk_size)
         {
           // initialize the elements of the ring buffer
@@ -339,8 +447,7 @@ namespace WorkStream
 
               item_buffer[element].work_items.resize (chunk_size,
                                                       remaining_iterator_range.second);
-              item_buffer[element].scratch_data = &thread_local_scratch;
-              item_buffer[element].sample_scratch_data = &sample_scratch_data;
+              item_buffer[element].scratch_data_pool = &scratch_data_pool;
               item_buffer[element].copy_datas.resize (chunk_size,
                                                       sample_copy_data);
               item_buffer[element].currently_in_use = false;
@@ -413,45 +520,6 @@ namespace WorkStream
          */
         std::vector<ItemType>        item_buffer;
 
-        /**
-         * Pointer to a thread local variable identifying the scratch data
-         * objects this thread will use. The initial implementation of this
-         * class using thread local variables provided only a single scratch
-         * object per thread. This doesn't work, because the worker functions
-         * may start tasks itself and then call Threads::TaskGroup::join_all()
-         * or a similar function, which the TBB scheduler may use to run
-         * something else on the current thread -- for example another
-         * instance of the worker function. Consequently, there would be two
-         * instances of the worker function that use the same scratch object
-         * if we only provided a single scratch object per thread. The
-         * solution is to provide a list of scratch objects for each thread,
-         * together with a flag indicating whether this scratch object is
-         * currently used. If a thread needs a scratch object, it walks this
-         * list until it finds an unused object, or, if there is none, creates
-         * one itself. Note that we need not use synchronization primitives
-         * for this process since the lists are thread-local and we are
-         * guaranteed that only a single thread accesses them as long as we
-         * have no yield point in between the accesses to the list.
-         *
-         * The pointers to scratch objects stored in each of these lists must
-         * be so that they are deleted on all threads when the thread local
-         * object is destroyed. This is achieved by using shared_ptr.
-         *
-         * Note that when a worker needs to create a scratch object, it
-         * allocates it using sample_scratch_data to copy from. This has the
-         * advantage of a first-touch initialization, i.e., the memory for the
-         * scratch data object is allocated and initialized by the same thread
-         * that will later use it.
-         */
-        Threads::ThreadLocalStorage<typename ItemType::ScratchDataList> thread_local_scratch;
-
-        /**
-         * A reference to a sample scratch data that will be used to
-         * initialize the thread-local pointers to a scratch data object each
-         * of the worker tasks uses.
-         */
-        const ScratchData &sample_scratch_data;
-
         /**
          * Number of elements of the iterator range that each thread should
          * work on sequentially; a large number makes sure that each thread
@@ -502,44 +570,9 @@ namespace WorkStream
 
           ItemType *current_item = static_cast<ItemType *> (item);
 
-          // we need to find an unused scratch data object in the list that
-          // corresponds to the current thread and then mark it as used. if
-          // we can't find one, create one
-          //
-          // as discussed in the discussion of the documentation of the
-          // IteratorRangeToItemStream::scratch_data variable, there is no
-          // need to synchronize access to this variable using a mutex
-          // as long as we have no yield-point in between. this means that
-          // we can't take an iterator into the list now and expect it to
-          // still be valid after calling the worker, but we at least do
-          // not have to lock the following section
-          ScratchData *scratch_data = nullptr;
-          {
-            typename ItemType::ScratchDataList &
-            scratch_data_list = current_item->scratch_data->get();
-
-            // see if there is an unused object. if so, grab it and mark
-            // it as used
-            for (typename ItemType::ScratchDataList::iterator
-                 p = scratch_data_list.begin();
-                 p != scratch_data_list.end(); ++p)
-              if (p->currently_in_use == false)
-                {
-                  scratch_data = p->scratch_data.get();
-                  p->currently_in_use = true;
-                  break;
-                }
-
-            // if no object was found, create one and mark it as used
-            if (scratch_data == nullptr)
-              {
-                scratch_data = new ScratchData(*current_item->sample_scratch_data);
-
-                typename ItemType::ScratchDataList::value_type
-                new_scratch_object (scratch_data, true);
-                scratch_data_list.push_back (new_scratch_object);
-              }
-          }
+          // get an unused scratch data object of the current thread from
+          // the pool, which marks it as used
+          ScratchData &scratch_data = current_item->scratch_data_pool->acquire();
 
           // then call the worker function on each element of the chunk we were
           // given. since these worker functions are called on separate threads,
@@ -551,7 +584,7 @@ namespace WorkStream
                 {
                   if (worker)
                     worker (current_item->work_items[i],
-                            *scratch_data,
+                            scratch_data,
                             current_item->copy_datas[i]);
                 }
               catch (const std::exception &exc)
@@ -564,22 +597,12 @@ namespace WorkStream
                 }
             }
 
-          // finally mark the scratch object as unused again. as above, there
-          // is no need to lock anything here since the object we work on
-          // is thread-local
-          {
-            typename ItemType::ScratchDataList &
-            scratch_data_list = current_item->scratch_data->get();
+          // let the MPI progress engine test outstanding messages, if it is
+          // enabled
+          Utilities::MPI::ProgressEngine::poll();
 
-            for (typename ItemType::ScratchDataList::iterator p =
-                   scratch_data_list.begin(); p != scratch_data_list.end();
-                 ++p)
-              if (p->scratch_data.get() == scratch_data)
-                {
-                  Assert(p->currently_in_use == true, ExcInternalError());
-                  p->currently_in_use = false;
-                }
-          }
+          // finally mark the scratch object as unused again
+          current_item->scratch_data_pool->release (scratch_data);
 
           // if there is no copier, mark current item as usable again
           if (copier_exist==false)
@@ -696,142 +719,189 @@ namespace WorkStream
     namespace Implementation3
     {
       /**
-       * A structure that contains a pointer to scratch and copy data objects
-       * along with a flag that indicates whether this object is currently in
-       * use.
+       * A class that manages calling the worker and copier functions. Unlike
+       * the other implementations, parallel_for is used instead of a
+       * pipeline.
        */
       template <typename Iterator,
                 typename ScratchData,
                 typename CopyData>
-      struct ScratchAndCopyDataObjects
+      class WorkerAndCopier
       {
-        std::shared_ptr<ScratchData> scratch_data;
-        std::shared_ptr<CopyData>    copy_data;
-        bool                         currently_in_use;
-
+      public:
         /**
-         * Default constructor.
+         * Constructor.
          */
-        ScratchAndCopyDataObjects ()
+        WorkerAndCopier (const std::function<void (const Iterator &,
+                                                   ScratchData &,
+                                                   CopyData &)> &worker,
+                         const std::function<void (const CopyData &)> &copier,
+                         ScratchDataPool<ScratchData> &scratch_data_pool,
+                         const CopyData               &sample_copy_data)
           :
-          currently_in_use (false)
+          worker (worker),
+          copier (copier),
+          scratch_data_pool (scratch_data_pool),
+          copy_data_pool (std::shared_ptr<const CopyData>(std::shared_ptr<const CopyData>(),
+                                                          &sample_copy_data))
         {}
 
-        ScratchAndCopyDataObjects (ScratchData *p,
-                                   CopyData *q,
-                                   const bool in_use)
-          :
-          scratch_data (p),
-          copy_data (q),
-          currently_in_use (in_use)
-        {}
 
-//TODO: when we push back an object to the list of scratch objects, in
-//      Worker::operator(), we first create an object and then copy
-//      it to the end of this list. this involves having two objects
-//      of the current type having pointers to it, each with their own
-//      currently_in_use flag. there is probably little harm in this because
-//      the original one goes out of scope right away again, but it's
-//      certainly awkward. one way to avoid this would be to use unique_ptr
-//      but we'd need to figure out a way to use it in non-C++11 mode
-        ScratchAndCopyDataObjects (const ScratchAndCopyDataObjects &o)
-          :
-          scratch_data (o.scratch_data),
-          copy_data (o.copy_data),
-          currently_in_use (o.currently_in_use)
-        {}
-      };
+        /**
+         * The function that calls the worker and the copier functions on a
+         * range of items denoted by the two arguments.
+         */
+        void operator() (const tbb::blocked_range<typename std::vector<Iterator>::const_iterator> &range)
+        {
+          // get unused scratch and copy data objects of the current
+          // thread, which marks them as used
+          ScratchData &scratch_data = scratch_data_pool.acquire();
+          CopyData    &copy_data    = copy_data_pool.acquire();
 
+          // then call the worker and copier functions on each
+          // element of the chunk we were given.
+          for (typename std::vector<Iterator>::const_iterator p=range.begin();
+               p != range.end(); ++p)
+            {
+              try
+                {
+                  if (worker)
+                    worker (*p,
+                            scratch_data,
+                            copy_data);
+                  if (copier)
+                    copier (copy_data);
+                }
+              catch (const std::exception &exc)
+                {
+                  Threads::internal::handle_std_exception (exc);
+                }
+              catch (...)
+                {
+                  Threads::internal::handle_unknown_exception ();
+                }
+            }
 
+          // let the MPI progress engine test outstanding messages, if it is
+          // enabled
+          Utilities::MPI::ProgressEngine::poll();
 
+          // finally mark the objects as unused again
+          copy_data_pool.release (copy_data);
+          scratch_data_pool.release (scratch_data);
+        }
 
+      private:
+        /**
+         * Pointer to the function that does the assembling on the sequence of
+         * cells.
+         */
+        const std::function<void (const Iterator &,
+                                  ScratchData &,
+                                  CopyData &)> worker;
+
+        /**
+         * Pointer to the function that does the copying from local
+         * contribution to global object.
+         */
+        const std::function<void (const CopyData &)> copier;
 
+        /**
+         * The pool of scratch data objects. The copy data objects are kept
+         * in a pool of the same kind that only lives as long as the current
+         * object.
+         */
+        ScratchDataPool<ScratchData> &scratch_data_pool;
+        ScratchDataPool<CopyData>     copy_data_pool;
+      };
+    }
+
+
+    /**
+     * A namespace for the implementation of a variant of the WorkStream
+     * pattern where the copiers of several items may run concurrently as
+     * long as the sets of indices they write into do not overlap, see
+     * WorkStream::run_with_conflicts().
+     */
+    namespace Implementation4
+    {
       /**
-       * A class that manages calling the worker and copier functions. Unlike
-       * the other implementations, parallel_for is used instead of a
-       * pipeline.
+       * A class that calls the worker function on a range of items and
+       * attempts to run the copier of each item right away. The indices an
+       * item writes into are mapped to a table of locks with a hash, and the
+       * copier of an item only runs if all its locks could be acquired.
+       * Otherwise, the copy data of the item is kept and the copier is tried
+       * again after the worker of the next item. No thread ever waits for a
+       * lock while holding another one, so the scheme cannot deadlock.
        */
       template <typename Iterator,
                 typename ScratchData,
                 typename CopyData>
-      class WorkerAndCopier
+      class WorkerAndConflictingCopier
       {
       public:
         /**
          * Constructor.
          */
-        WorkerAndCopier (const std::function<void (const Iterator &,
-                                                   ScratchData &,
-                                                   CopyData &)> &worker,
-                         const std::function<void (const CopyData &)> &copier,
-                         const ScratchData    &sample_scratch_data,
-                         const CopyData       &sample_copy_data)
+        WorkerAndConflictingCopier (const std::function<void (const Iterator &,
+                                                              ScratchData &,
+                                                              CopyData &)> &worker,
+                                    const std::function<void (const CopyData &)> &copier,
+                                    const std::function<void (const Iterator &,
+                                                              std::vector<types::global_dof_index> &)> &get_conflict_indices,
+                                    ScratchDataPool<ScratchData> &scratch_data_pool,
+                                    const CopyData               &sample_copy_data)
           :
           worker (worker),
           copier (copier),
-          sample_scratch_data (sample_scratch_data),
-          sample_copy_data (sample_copy_data)
-        {}
+          get_conflict_indices (get_conflict_indices),
+          scratch_data_pool (scratch_data_pool),
+          sample_copy_data (sample_copy_data),
+          locks (n_locks)
+        {
+          for (auto &lock : locks)
+            lock.store(false);
+        }
 
 
         /**
          * The function that calls the worker and the copier functions on a
-         * range of items denoted by the two arguments.
+         * range of items denoted by the argument.
          */
         void operator() (const tbb::blocked_range<typename std::vector<Iterator>::const_iterator> &range)
         {
-          // we need to find an unused scratch and corresponding copy
-          // data object in the list that corresponds to the current
-          // thread and then mark it as used. If we can't find one,
-          // create one as discussed in the discussion of the documentation
-          // of the IteratorRangeToItemStream::scratch_data variable,
-          // there is no need to synchronize access to this variable
-          // using a mutex as long as we have no yield-point in between.
-          // This means that we can't take an iterator into the list
-          // now and expect it to still be valid after calling the worker,
-          // but we at least do not have to lock the following section.
-          ScratchData *scratch_data = nullptr;
-          CopyData    *copy_data    = nullptr;
-          {
-            ScratchAndCopyDataList &scratch_and_copy_data_list = data.get();
-
-            // see if there is an unused object. if so, grab it and mark
-            // it as used
-            for (typename ScratchAndCopyDataList::iterator
-                 p = scratch_and_copy_data_list.begin();
-                 p != scratch_and_copy_data_list.end(); ++p)
-              if (p->currently_in_use == false)
-                {
-                  scratch_data = p->scratch_data.get();
-                  copy_data    = p->copy_data.get();
-                  p->currently_in_use = true;
-                  break;
-                }
-
-            // if no element in the list was found, create one and mark it as used
-            if (scratch_data == nullptr)
-              {
-                Assert (copy_data==nullptr, ExcInternalError());
-                scratch_data = new ScratchData(sample_scratch_data);
-                copy_data    = new CopyData(sample_copy_data);
-
-                scratch_and_copy_data_list.emplace_back (scratch_data, copy_data, true);
-              }
-          }
-
-          // then call the worker and copier functions on each
-          // element of the chunk we were given.
+          // get an unused scratch data object of the current thread, which
+          // marks it as used and makes this work also when the worker itself
+          // starts parallel tasks that end up in this function on the same
+          // thread
+          ScratchData &scratch_data = scratch_data_pool.acquire();
+
+          std::list<PendingCopy> pending_copies;
+          std::vector<types::global_dof_index> conflict_indices;
           for (typename std::vector<Iterator>::const_iterator p=range.begin();
                p != range.end(); ++p)
             {
               try
                 {
+                  PendingCopy copy;
+                  copy.copy_data = get_copy_data();
                   if (worker)
-                    worker (*p,
-                            *scratch_data,
-                            *copy_data);
-                  if (copier)
-                    copier (*copy_data);
+                    worker (*p, scratch_data, *copy.copy_data);
+
+                  conflict_indices.clear();
+                  get_conflict_indices (*p, conflict_indices);
+                  copy.lock_indices.resize(conflict_indices.size());
+                  for (unsigned int i=0; i<conflict_indices.size(); ++i)
+                    copy.lock_indices[i] = conflict_indices[i] % n_locks;
+                  std::sort (copy.lock_indices.begin(), copy.lock_indices.end());
+                  copy.lock_indices.erase (std::unique(copy.lock_indices.begin(),
+                                                       copy.lock_indices.end()),
+                                           copy.lock_indices.end());
+
+                  if (try_copy(copy) == false)
+                    pending_copies.push_back(copy);
+
+                  retry_pending_copies(pending_copies);
                 }
               catch (const std::exception &exc)
                 {
@@ -843,56 +913,146 @@ namespace WorkStream
                 }
             }
 
-          // finally mark the scratch object as unused again. as above, there
-          // is no need to lock anything here since the object we work on
-          // is thread-local
-          {
-            ScratchAndCopyDataList &scratch_and_copy_data_list = data.get();
-
-            for (typename ScratchAndCopyDataList::iterator p =
-                   scratch_and_copy_data_list.begin(); p != scratch_and_copy_data_list.end();
-                 ++p)
-              if (p->scratch_data.get() == scratch_data)
+          // the items of this range are done when all copiers have run. the
+          // locks are only held by copiers running on other threads, so
+          // we only need to retry until they are done
+          try
+            {
+              while (pending_copies.empty() == false)
                 {
-                  Assert(p->currently_in_use == true, ExcInternalError());
-                  p->currently_in_use = false;
+                  retry_pending_copies(pending_copies);
+                  if (pending_copies.empty() == false)
+                    std::this_thread::yield();
                 }
-          }
+            }
+          catch (const std::exception &exc)
+            {
+              Threads::internal::handle_std_exception (exc);
+            }
+          catch (...)
+            {
+              Threads::internal::handle_unknown_exception ();
+            }
+
+          // let the MPI progress engine test outstanding messages, if it is
+          // enabled
+          Utilities::MPI::ProgressEngine::poll();
 
+          scratch_data_pool.release (scratch_data);
         }
 
       private:
-        typedef
-        typename Implementation3::ScratchAndCopyDataObjects<Iterator,ScratchData,CopyData>
-        ScratchAndCopyDataObjects;
+        /**
+         * The copy data of an item whose copier has not run yet, together
+         * with the positions in the table of locks of the indices the copier
+         * writes into, sorted and without duplicates.
+         */
+        struct PendingCopy
+        {
+          std::shared_ptr<CopyData> copy_data;
+          std::vector<unsigned int> lock_indices;
+        };
+
+        /**
+         * Take a copy data object out of the list of unused objects of the
+         * current thread, or create a copy of the sample if the list is
+         * empty. In contrast to the scratch data, the copy data objects
+         * may be handed to a copier that runs after the next worker of the
+         * same range, so they are not taken from a ScratchDataPool.
+         */
+        std::shared_ptr<CopyData>
+        get_copy_data ()
+        {
+          std::list<std::shared_ptr<CopyData> > &list = unused_copy_data.get();
+          if (list.empty())
+            return std::make_shared<CopyData>(sample_copy_data);
+          std::shared_ptr<CopyData> object = list.back();
+          list.pop_back();
+          return object;
+        }
 
         /**
-         * Typedef to a list of scratch data objects. The rationale for this
-         * list is provided in the variables that use these lists.
+         * Try to acquire all locks of @p copy. If this succeeds, run the
+         * copier, release the locks, put the copy data object back into the
+         * list of unused objects and return true. Otherwise, return false
+         * without holding any lock.
          */
-        typedef std::list<ScratchAndCopyDataObjects> ScratchAndCopyDataList;
+        bool try_copy (const PendingCopy &copy)
+        {
+          for (unsigned int i=0; i<copy.lock_indices.size(); ++i)
+            if (locks[copy.lock_indices[i]].exchange(true, std::memory_order_acquire) == true)
+              {
+                for (unsigned int j=0; j<i; ++j)
+                  locks[copy.lock_indices[j]].store(false, std::memory_order_release);
+                return false;
+              }
+
+          try
+            {
+              copier (*copy.copy_data);
+            }
+          catch (...)
+            {
+              for (const unsigned int lock : copy.lock_indices)
+                locks[lock].store(false, std::memory_order_release);
+              throw;
+            }
 
-        Threads::ThreadLocalStorage<ScratchAndCopyDataList> data;
+          for (const unsigned int lock : copy.lock_indices)
+            locks[lock].store(false, std::memory_order_release);
+          unused_copy_data.get().push_back(copy.copy_data);
+          return true;
+        }
 
         /**
-         * Pointer to the function that does the assembling on the sequence of
-         * cells.
+         * Try once to run the copier of each of the @p pending_copies, and
+         * remove the ones that succeeded.
+         */
+        void retry_pending_copies (std::list<PendingCopy> &pending_copies)
+        {
+          for (typename std::list<PendingCopy>::iterator p=pending_copies.begin();
+               p != pending_copies.end(); )
+            if (try_copy(*p))
+              p = pending_copies.erase(p);
+            else
+              ++p;
+        }
+
+        /**
+         * Pointers to the worker and copier functions, and to the function
+         * returning the indices the copier writes into.
          */
         const std::function<void (const Iterator &,
                                   ScratchData &,
                                   CopyData &)> worker;
+        const std::function<void (const CopyData &)> copier;
+        const std::function<void (const Iterator &,
+                                  std::vector<types::global_dof_index> &)> get_conflict_indices;
 
         /**
-         * Pointer to the function that does the copying from local
-         * contribution to global object.
+         * The pool of scratch data objects and a reference to the sample
+         * copy data for when we need it.
          */
-        const std::function<void (const CopyData &)> copier;
+        ScratchDataPool<ScratchData> &scratch_data_pool;
+        const CopyData               &sample_copy_data;
+
+        /**
+         * The list of the copy data objects of each thread that are
+         * currently not used.
+         */
+        Threads::ThreadLocalStorage<std::list<std::shared_ptr<CopyData> > > unused_copy_data;
+
+        /**
+         * The number of locks. Indices with the same remainder modulo this
+         * number share a lock, which only leads to spurious conflicts.
+         */
+        static const unsigned int n_locks = 1U << 16;
 
         /**
-         * References to sample scratch and copy data for when we need them.
+         * The table of locks, where a value of true means that a copier
+         * holding the lock is currently running.
          */
-        const ScratchData    &sample_scratch_data;
-        const CopyData       &sample_copy_data;
+        std::vector<std::atomic<bool> > locks;
       };
     }
 
@@ -951,6 +1111,27 @@ namespace WorkStream
        const unsigned int                         chunk_size = 8);
 
 
+  /**
+   * Same as the function above, but take the scratch data objects from the
+   * given @p scratch_data_pool, which keeps them for later calls, rather
+   * than creating them from a sample. See ScratchDataPool for more
+   * information.
+   */
+  template <typename Worker,
+            typename Copier,
+            typename Iterator,
+            typename ScratchData,
+            typename CopyData>
+  void
+  run (const std::vector<std::vector<Iterator> > &colored_iterators,
+       Worker                                     worker,
+       Copier                                     copier,
+       ScratchDataPool<ScratchData>              &scratch_data_pool,
+       const CopyData                            &sample_copy_data,
+       const unsigned int queue_length = 2*MultithreadInfo::n_threads(),
+       const unsigned int                         chunk_size = 8);
+
+
   /**
    * This is one of two main functions of the WorkStream concept, doing work
    * as described in the introduction to this namespace. It corresponds to
@@ -999,6 +1180,39 @@ namespace WorkStream
        const CopyData                          &sample_copy_data,
        const unsigned int queue_length = 2*MultithreadInfo::n_threads(),
        const unsigned int                       chunk_size = 8)
+  {
+    // create a pool that lives as long as this call. the pool shares the
+    // sample with the caller rather than copying it
+    ScratchDataPool<ScratchData>
+    scratch_data_pool (std::shared_ptr<const ScratchData>(std::shared_ptr<const ScratchData>(),
+                                                          &sample_scratch_data));
+    run (begin, end, worker, copier, scratch_data_pool, sample_copy_data,
+         queue_length, chunk_size);
+  }
+
+
+  /**
+   * Same as the function above, but take the scratch data objects from the
+   * given @p scratch_data_pool, which keeps them for later calls, rather
+   * than creating them from a sample. Code that calls this function many
+   * times, e.g., once per time step, thereby avoids the repeated
+   * construction of the scratch data objects. See ScratchDataPool for more
+   * information.
+   */
+  template <typename Worker,
+            typename Copier,
+            typename Iterator,
+            typename ScratchData,
+            typename CopyData>
+  void
+  run (const Iterator                          &begin,
+       const typename identity<Iterator>::type &end,
+       Worker                                   worker,
+       Copier                                   copier,
+       ScratchDataPool<ScratchData>            &scratch_data_pool,
+       const CopyData                          &sample_copy_data,
+       const unsigned int queue_length = 2*MultithreadInfo::n_threads(),
+       const unsigned int                       chunk_size = 8)
   {
     Assert (queue_length > 0,
             ExcMessage ("The queue length must be at least one, and preferably "
@@ -1019,9 +1233,8 @@ namespace WorkStream
     if (MultithreadInfo::n_threads()==1)
 #endif
       {
-        // need to copy the sample since it is marked const
-        ScratchData scratch_data = sample_scratch_data;
-        CopyData    copy_data    = sample_copy_data;
+        ScratchData &scratch_data = scratch_data_pool.acquire();
+        CopyData     copy_data    = sample_copy_data;
 
         for (Iterator i=begin; i!=end; ++i)
           {
@@ -1035,6 +1248,7 @@ namespace WorkStream
                 (copier))
               copier (copy_data);
           }
+        scratch_data_pool.release (scratch_data);
       }
 #ifdef DEAL_II_WITH_THREADS
     else // have TBB and use more than one thread
@@ -1047,7 +1261,7 @@ namespace WorkStream
             iterator_range_to_item_stream (begin, end,
                                            queue_length,
                                            chunk_size,
-                                           sample_scratch_data,
+                                           scratch_data_pool,
                                            sample_copy_data);
 
             internal::Implementation2::Worker<Iterator, ScratchData, CopyData> worker_filter (worker);
@@ -1086,7 +1300,7 @@ namespace WorkStream
 
             run (all_iterators,
                  worker, copier,
-                 sample_scratch_data,
+                 scratch_data_pool,
                  sample_copy_data,
                  queue_length,
                  chunk_size);
@@ -1110,6 +1324,29 @@ namespace WorkStream
        const CopyData                            &sample_copy_data,
        const unsigned int                         queue_length,
        const unsigned int                         chunk_size)
+  {
+    ScratchDataPool<ScratchData>
+    scratch_data_pool (std::shared_ptr<const ScratchData>(std::shared_ptr<const ScratchData>(),
+                                                          &sample_scratch_data));
+    run (colored_iterators, worker, copier, scratch_data_pool, sample_copy_data,
+         queue_length, chunk_size);
+  }
+
+
+
+  template <typename Worker,
+            typename Copier,
+            typename Iterator,
+            typename ScratchData,
+            typename CopyData>
+  void
+  run (const std::vector<std::vector<Iterator> > &colored_iterators,
+       Worker                                     worker,
+       Copier                                     copier,
+       ScratchDataPool<ScratchData>              &scratch_data_pool,
+       const CopyData                            &sample_copy_data,
+       const unsigned int                         queue_length,
+       const unsigned int                         chunk_size)
   {
     Assert (queue_length > 0,
             ExcMessage ("The queue length must be at least one, and preferably "
@@ -1125,9 +1362,8 @@ namespace WorkStream
     if (MultithreadInfo::n_threads()==1)
 #endif
       {
-        // need to copy the sample since it is marked const
-        ScratchData scratch_data = sample_scratch_data;
-        CopyData    copy_data    = sample_copy_data;
+        ScratchData &scratch_data = scratch_data_pool.acquire();
+        CopyData     copy_data    = sample_copy_data;
 
         for (unsigned int color=0; color<colored_iterators.size(); ++color)
           for (typename std::vector<Iterator>::const_iterator p = colored_iterators[color].begin();
@@ -1142,6 +1378,7 @@ namespace WorkStream
               if (static_cast<const std::function<void (const CopyData &)>& >(copier))
                 copier (copy_data);
             }
+        scratch_data_pool.release (scratch_data);
       }
 #ifdef DEAL_II_WITH_THREADS
     else // have TBB and use more than one thread
@@ -1160,7 +1397,7 @@ namespace WorkStream
 
               WorkerAndCopier worker_and_copier (worker,
                                                  copier,
-                                                 sample_scratch_data,
+                                                 scratch_data_pool,
                                                  sample_copy_data);
 
               tbb::parallel_for (tbb::blocked_range<RangeType>
@@ -1179,6 +1416,154 @@ namespace WorkStream
 
 
 
+  /**
+   * A function object that returns the degrees of freedom of a cell, for
+   * use as the conflict function of run_with_conflicts() when the copier
+   * writes into the entries of a global matrix or vector that belong to the
+   * degrees of freedom of the cell.
+   */
+  struct DoFIndexConflicts
+  {
+    template <typename CellIterator>
+    void operator() (const CellIterator                   &cell,
+                     std::vector<types::global_dof_index> &dof_indices) const
+    {
+      dof_indices.resize (cell->get_fe().dofs_per_cell);
+      cell->get_dof_indices (dof_indices);
+    }
+  };
+
+
+
+  /**
+   * A variant of the main functions of the WorkStream concept in which
+   * the copiers of different items are allowed to run at the same time,
+   * as long as they write into different parts of the global object. This
+   * avoids both the serialization of all copiers of the run() function on
+   * an iterator range, which limits the parallel scalability for many
+   * threads, and the graph coloring needed by the run() function on colored
+   * iterators.
+   *
+   * The function @p get_conflict_indices returns, for an item, the indices
+   * of the global object the copier writes into, typically the degrees of
+   * freedom of a cell, for which DoFIndexConflicts can be used. It is
+   * called after the worker of the item. The items are distributed among
+   * the threads in chunks of @p chunk_size elements with the work stealing
+   * of tbb::parallel_for. Each thread runs the copier of an item right
+   * after the worker if no copier with an overlapping set of indices is
+   * currently running on another thread; otherwise, the copy data is kept
+   * and the copier is tried again after the worker of the next item. There
+   * is neither a precomputed conflict graph nor any blocking: conflicts are
+   * detected by a table of locks indexed by a hash of the indices, which
+   * may report spurious conflicts between indices that share a lock but
+   * never misses a real conflict.
+   *
+   * @note In contrast to the run() function on an iterator range, the
+   * copiers do not run in the order of the items, so sums accumulated in
+   * the global object may differ by round-off between two runs.
+   *
+   * @note The copy data objects kept for later copiers are additional
+   * copies of @p sample_copy_data, and at most a few per thread are alive
+   * at a time.
+   */
+  template <typename Worker,
+            typename Copier,
+            typename ConflictFunction,
+            typename Iterator,
+            typename ScratchData,
+            typename CopyData>
+  void
+  run_with_conflicts (const Iterator                          &begin,
+                      const typename identity<Iterator>::type &end,
+                      Worker                                   worker,
+                      Copier                                   copier,
+                      ConflictFunction                         get_conflict_indices,
+                      const ScratchData                       &sample_scratch_data,
+                      const CopyData                          &sample_copy_data,
+                      const unsigned int                       chunk_size = 8)
+  {
+    ScratchDataPool<ScratchData>
+    scratch_data_pool (std::shared_ptr<const ScratchData>(std::shared_ptr<const ScratchData>(),
+                                                          &sample_scratch_data));
+    run_with_conflicts (begin, end, worker, copier, get_conflict_indices,
+                        scratch_data_pool, sample_copy_data, chunk_size);
+  }
+
+
+
+  /**
+   * Same as the function above, but take the scratch data objects from the
+   * given @p scratch_data_pool, which keeps them for later calls. See
+   * ScratchDataPool for more information.
+   */
+  template <typename Worker,
+            typename Copier,
+            typename ConflictFunction,
+            typename Iterator,
+            typename ScratchData,
+            typename CopyData>
+  void
+  run_with_conflicts (const Iterator                          &begin,
+                      const typename identity<Iterator>::type &end,
+                      Worker                                   worker,
+                      Copier                                   copier,
+                      ConflictFunction                         get_conflict_indices,
+                      ScratchDataPool<ScratchData>            &scratch_data_pool,
+                      const CopyData                          &sample_copy_data,
+                      const unsigned int                       chunk_size = 8)
+  {
+    Assert (chunk_size > 0,
+            ExcMessage ("The chunk_size must be at least one."));
+    (void)chunk_size; // removes -Wunused-parameter warning in optimized mode
+    (void)get_conflict_indices;
+
+    if (!(begin != end))
+      return;
+
+#ifdef DEAL_II_WITH_THREADS
+    if (MultithreadInfo::n_threads()==1 ||
+        !static_cast<const std::function<void (const CopyData &)>& >(copier))
+#endif
+      {
+        // without threads, or without a copier function where there are
+        // no conflicts, run() does the job
+        run (begin, end, worker, copier, scratch_data_pool, sample_copy_data,
+             2*MultithreadInfo::n_threads(), chunk_size);
+      }
+#ifdef DEAL_II_WITH_THREADS
+    else
+      {
+        // as in run() for an empty copier, copy the iterators into an
+        // array to be able to split the range
+        std::vector<Iterator> all_iterators;
+        for (Iterator p=begin; p!=end; ++p)
+          all_iterators.push_back (p);
+
+        typedef
+        internal::Implementation4::WorkerAndConflictingCopier<Iterator,ScratchData,CopyData>
+        WorkerAndCopier;
+
+        WorkerAndCopier worker_and_copier (worker,
+                                           copier,
+                                           get_conflict_indices,
+                                           scratch_data_pool,
+                                           sample_copy_data);
+
+        tbb::parallel_for (tbb::blocked_range<typename std::vector<Iterator>::const_iterator>
+                           (all_iterators.begin(),
+                            all_iterators.end(),
+                            /*grain_size=*/chunk_size),
+                           std::bind (&WorkerAndCopier::operator(),
+                                      std::ref(worker_and_copier),
+                                      std::placeholders::_1),
+                           tbb::auto_partitioner());
+      }
+#endif
+  }
+
+
+
+
 
   /**
    * This is a variant of one of the two main functions of the WorkStream
@@ -1240,6 +1625,44 @@ namespace WorkStream
          chunk_size);
   }
 
+
+
+  /**
+   * Same as the function above, but take the scratch data objects from the
+   * given @p scratch_data_pool, which keeps them for later calls. See
+   * ScratchDataPool for more information.
+   */
+  template <typename MainClass,
+            typename Iterator,
+            typename ScratchData,
+            typename CopyData>
+  void
+  run (const Iterator                          &begin,
+       const typename identity<Iterator>::type &end,
+       MainClass                               &main_object,
+       void (MainClass::*worker) (const Iterator &,
+                                  ScratchData &,
+                                  CopyData &),
+       void (MainClass::*copier) (const CopyData &),
+       ScratchDataPool<ScratchData>            &scratch_data_pool,
+       const CopyData                          &sample_copy_data,
+       const unsigned int queue_length =        2*MultithreadInfo::n_threads(),
+       const unsigned int chunk_size =          8)
+  {
+    // forward to the other function
+    run (begin, end,
+         std::bind (worker,
+                    std::ref (main_object),
+                    std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+         std::bind (copier,
+                    std::ref (main_object),
+                    std::placeholders::_1),
+         scratch_data_pool,
+         sample_copy_data,
+         queue_length,
+         chunk_size);
+  }
+
 }
 
 
@@ -0,0 +1,825 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_differentiation_ad_ad_helpers_h
+#define dealii_differentiation_ad_ad_helpers_h
+
+#include <deal.II/base/config.h>
+
+#if defined(DEAL_II_WITH_TRILINOS) || defined(DEAL_II_WITH_ADOLC)
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/types.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#ifdef DEAL_II_WITH_TRILINOS
+#  include <deal.II/differentiation/ad/sacado_product_types.h>
+DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
+#  include <Sacado.hpp>
+DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
+#endif
+
+#ifdef DEAL_II_WITH_ADOLC
+DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
+#  include <adolc/adouble.h>
+#  include <adolc/drivers/drivers.h>
+#  include <adolc/taping.h>
+DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
+#endif
+
+#include <set>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * Helpers for the computation of the local contributions of a cell to the
+ * residual and the tangent matrix by automatic differentiation.
+ */
+namespace Differentiation
+{
+  namespace AD
+  {
+#ifdef DEAL_II_WITH_TRILINOS
+
+    /**
+     * A type trait selecting the forward-mode Sacado number type for
+     * first derivatives with respect to @p n_independent_variables
+     * variables: Sacado::Fad::SFad with a statically sized derivative array
+     * if the number of variables is known at compile time, and
+     * Sacado::Fad::DFad otherwise, indicated by the value zero.
+     */
+    template <int n_independent_variables, typename Number>
+    struct SacadoFad
+    {
+      typedef Sacado::Fad::SFad<Number,n_independent_variables> type;
+    };
+
+    template <typename Number>
+    struct SacadoFad<0,Number>
+    {
+      typedef Sacado::Fad::DFad<Number> type;
+    };
+
+
+
+    /**
+     * Compute the local residual and the local tangent matrix of a cell as
+     * the first and second derivatives of an energy functional with respect
+     * to the values of the degrees of freedom on the cell, using nested
+     * forward-mode Sacado numbers.
+     *
+     * The typical use in the loop over the cells reads
+     * @code
+     *   typedef Differentiation::AD::EnergyFunctional<dofs_per_cell> ADHelper;
+     *   typedef ADHelper::ad_type ADNumber;
+     *   ADHelper ad_helper;
+     *   for (const auto &cell : dof_handler.active_cell_iterators())
+     *     {
+     *       fe_values.reinit(cell);
+     *       cell->get_dof_indices(local_dof_indices);
+     *       ad_helper.register_dof_values(solution, local_dof_indices);
+     *
+     *       const std::vector<ADNumber> &dof_values_ad
+     *         = ad_helper.get_sensitive_dof_values();
+     *       ADNumber energy = 0.;
+     *       for (unsigned int q=0; q<n_q_points; ++q)
+     *         {
+     *           Tensor<1,dim,ADNumber> grad_u;
+     *           for (unsigned int i=0; i<dofs_per_cell; ++i)
+     *             grad_u += dof_values_ad[i] * fe_values.shape_grad(i,q);
+     *           energy += psi(grad_u) * fe_values.JxW(q);
+     *         }
+     *       ad_helper.register_energy_functional(energy);
+     *
+     *       ad_helper.compute_residual(cell_rhs);
+     *       cell_rhs *= -1.;
+     *       ad_helper.compute_linearization(cell_matrix);
+     *       ...
+     *     }
+     * @endcode
+     *
+     * If the number of degrees of freedom per cell is given as template
+     * argument @p n_independent_variables, statically sized derivative
+     * arrays (Sacado::Fad::SFad) are used and the evaluation of the energy
+     * does not allocate any memory. Otherwise, i.e., for the default value
+     * zero, the number of degrees of freedom is set at run time by the
+     * constructor and the dynamically sized Sacado::Fad::DFad is used. In
+     * that case, the independent variables are kept from one cell to the
+     * next such that their derivative arrays are only allocated once, but
+     * each intermediate result in the evaluation of the energy still
+     * allocates memory.
+     */
+    template <int n_independent_variables = 0, typename Number = double>
+    class EnergyFunctional
+    {
+    public:
+      /**
+       * The number type with first derivatives.
+       */
+      typedef typename SacadoFad<n_independent_variables,Number>::type ad_type_first_derivatives;
+
+      /**
+       * The number type with first and second derivatives in which the
+       * energy functional is to be evaluated.
+       */
+      typedef typename SacadoFad<n_independent_variables,ad_type_first_derivatives>::type ad_type;
+
+      /**
+       * Constructor. The number of degrees of freedom per cell must match
+       * the template argument if the latter is nonzero.
+       */
+      EnergyFunctional (const unsigned int n_dofs = n_independent_variables);
+
+      /**
+       * Return the number of independent variables.
+       */
+      unsigned int n_independent_dofs () const;
+
+      /**
+       * Set the values of the degrees of freedom on the current cell and
+       * mark them as the independent variables.
+       */
+      void register_dof_values (const Vector<Number> &local_dof_values);
+
+      /**
+       * Set the values of the degrees of freedom on the current cell from
+       * the global vector @p values at the indices @p local_dof_indices and
+       * mark them as the independent variables.
+       */
+      template <typename VectorType>
+      void register_dof_values (const VectorType                           &values,
+                                const std::vector<types::global_dof_index> &local_dof_indices);
+
+      /**
+       * Return the independent variables set by the last call to
+       * register_dof_values(), in terms of which the energy functional is
+       * to be evaluated.
+       */
+      const std::vector<ad_type> &get_sensitive_dof_values () const;
+
+      /**
+       * Register the value of the energy functional on the current cell,
+       * evaluated in terms of get_sensitive_dof_values().
+       */
+      void register_energy_functional (const ad_type &energy);
+
+      /**
+       * Return the value of the energy functional.
+       */
+      Number compute_energy () const;
+
+      /**
+       * Compute the gradient of the energy functional with respect to the
+       * degrees of freedom on the cell, i.e., the residual.
+       */
+      void compute_residual (Vector<Number> &residual) const;
+
+      /**
+       * Compute the Hessian of the energy functional with respect to the
+       * degrees of freedom on the cell, i.e., the linearization of the
+       * residual.
+       */
+      void compute_linearization (FullMatrix<Number> &linearization) const;
+
+    private:
+      /**
+       * The independent variables.
+       */
+      std::vector<ad_type> dof_values;
+
+      /**
+       * The energy functional with its derivatives.
+       */
+      ad_type energy;
+    };
+
+
+
+    /**
+     * Compute the local tangent matrix of a cell as the linearization of
+     * the local residual vector with respect to the values of the degrees
+     * of freedom on the cell, using forward-mode Sacado numbers. This is the
+     * counterpart of EnergyFunctional for problems that are not derived
+     * from a potential: the user evaluates the residual vector in terms of
+     * get_sensitive_dof_values() and registers it with
+     * register_residual_vector().
+     *
+     * As for EnergyFunctional, a nonzero template argument @p
+     * n_independent_variables selects statically sized derivative arrays.
+     */
+    template <int n_independent_variables = 0, typename Number = double>
+    class ResidualLinearization
+    {
+    public:
+      /**
+       * The number type with first derivatives in which the residual is to
+       * be evaluated.
+       */
+      typedef typename SacadoFad<n_independent_variables,Number>::type ad_type;
+
+      /**
+       * Constructor. The number of degrees of freedom per cell must match
+       * the template argument if the latter is nonzero.
+       */
+      ResidualLinearization (const unsigned int n_dofs = n_independent_variables);
+
+      /**
+       * Return the number of independent variables.
+       */
+      unsigned int n_independent_dofs () const;
+
+      /**
+       * Set the values of the degrees of freedom on the current cell and
+       * mark them as the independent variables.
+       */
+      void register_dof_values (const Vector<Number> &local_dof_values);
+
+      /**
+       * Set the values of the degrees of freedom on the current cell from
+       * the global vector @p values at the indices @p local_dof_indices and
+       * mark them as the independent variables.
+       */
+      template <typename VectorType>
+      void register_dof_values (const VectorType                           &values,
+                                const std::vector<types::global_dof_index> &local_dof_indices);
+
+      /**
+       * Return the independent variables set by the last call to
+       * register_dof_values(), in terms of which the residual is to be
+       * evaluated.
+       */
+      const std::vector<ad_type> &get_sensitive_dof_values () const;
+
+      /**
+       * Register the residual vector on the current cell, evaluated in
+       * terms of get_sensitive_dof_values(). Its size needs to equal the
+       * number of degrees of freedom.
+       */
+      void register_residual_vector (const std::vector<ad_type> &residual);
+
+      /**
+       * Return the values of the residual vector.
+       */
+      void compute_residual (Vector<Number> &residual) const;
+
+      /**
+       * Compute the derivatives of the residual vector with respect to the
+       * degrees of freedom on the cell.
+       */
+      void compute_linearization (FullMatrix<Number> &linearization) const;
+
+    private:
+      /**
+       * The independent variables.
+       */
+      std::vector<ad_type> dof_values;
+
+      /**
+       * The residual vector with its derivatives.
+       */
+      std::vector<ad_type> residual;
+    };
+
+#endif // DEAL_II_WITH_TRILINOS
+
+
+
+#ifdef DEAL_II_WITH_ADOLC
+
+    /**
+     * Compute the local residual and the local tangent matrix of a cell as
+     * the derivatives of an energy functional, recorded on an ADOL-C tape.
+     * Since the operations evaluating the energy are the same on all cells
+     * of the same type (i.e., with the same finite element, quadrature
+     * formula, and material model), a tape is recorded only once for each
+     * of them and then evaluated with the ADOL-C drivers at the values of
+     * the degrees of freedom of the other cells. Only the values entering
+     * the tapes as independent variables change from cell to cell.
+     * Therefore, the evaluation of the energy may not depend on the
+     * geometry of the cell unless the geometric quantities are part of the
+     * independent variables, and it may not branch on the values of the
+     * degrees of freedom unless ADOL-C was configured with advanced
+     * branching. The tape index given to start_recording() identifies the
+     * type of cell.
+     *
+     * @code
+     *   Differentiation::AD::TapedEnergyFunctional ad_helper (dofs_per_cell);
+     *   for (const auto &cell : dof_handler.active_cell_iterators())
+     *     {
+     *       cell->get_dof_values(solution, local_dof_values);
+     *       if (ad_helper.start_recording(cell->active_fe_index(), local_dof_values))
+     *         {
+     *           const std::vector<adouble> &dof_values_ad
+     *             = ad_helper.get_sensitive_dof_values();
+     *           adouble energy = ...;
+     *           ad_helper.register_energy_functional(energy);
+     *           ad_helper.stop_recording();
+     *         }
+     *       ad_helper.compute_residual(cell_rhs);
+     *       ad_helper.compute_linearization(cell_matrix);
+     *       ...
+     *     }
+     * @endcode
+     */
+    class TapedEnergyFunctional
+    {
+    public:
+      /**
+       * Constructor.
+       */
+      TapedEnergyFunctional (const unsigned int n_dofs);
+
+      /**
+       * Return the number of independent variables.
+       */
+      unsigned int n_independent_dofs () const;
+
+      /**
+       * Activate the tape with index @p tape_index and set the point at
+       * which the derivatives are evaluated. Return whether the tape has
+       * not been recorded before, in which case the energy functional needs
+       * to be evaluated in terms of get_sensitive_dof_values() and passed to
+       * register_energy_functional(), followed by a call to
+       * stop_recording(). Otherwise, the recorded tape is evaluated at the
+       * new values.
+       */
+      bool start_recording (const unsigned int    tape_index,
+                            const Vector<double> &local_dof_values);
+
+      /**
+       * Return the independent variables of the tape being recorded.
+       */
+      const std::vector<adouble> &get_sensitive_dof_values () const;
+
+      /**
+       * Mark the energy functional as the dependent variable of the tape
+       * being recorded.
+       */
+      void register_energy_functional (const adouble &energy);
+
+      /**
+       * Finish the recording of the tape.
+       */
+      void stop_recording ();
+
+      /**
+       * Evaluate the active tape for the value of the energy functional.
+       */
+      double compute_energy () const;
+
+      /**
+       * Evaluate the active tape for the gradient of the energy functional,
+       * i.e., the residual.
+       */
+      void compute_residual (Vector<double> &residual) const;
+
+      /**
+       * Evaluate the active tape for the Hessian of the energy functional,
+       * i.e., the linearization of the residual.
+       */
+      void compute_linearization (FullMatrix<double> &linearization) const;
+
+    private:
+      /**
+       * The tapes that have been recorded.
+       */
+      std::set<unsigned int> recorded_tapes;
+
+      /**
+       * The active tape, and whether it is being recorded.
+       */
+      unsigned int active_tape;
+      bool         is_recording;
+
+      /**
+       * The point of evaluation.
+       */
+      std::vector<double> dof_values;
+
+      /**
+       * The independent variables used during the recording.
+       */
+      std::vector<adouble> dof_values_ad;
+    };
+
+#endif // DEAL_II_WITH_ADOLC
+  }
+}
+
+
+
+/* ---------------------- inline and template functions ------------------ */
+
+#ifndef DOXYGEN
+
+namespace Differentiation
+{
+  namespace AD
+  {
+#ifdef DEAL_II_WITH_TRILINOS
+
+    template <int n_independent_variables, typename Number>
+    inline
+    EnergyFunctional<n_independent_variables,Number>::EnergyFunctional
+    (const unsigned int n_dofs)
+      :
+      dof_values (n_dofs)
+    {
+      Assert (n_independent_variables == 0 ||
+              n_dofs == static_cast<unsigned int>(n_independent_variables),
+              ExcDimensionMismatch(n_dofs, n_independent_variables));
+      AssertThrow (n_dofs > 0,
+                   ExcMessage("The number of independent variables must be "
+                              "given if it is not known at compile time."));
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    unsigned int
+    EnergyFunctional<n_independent_variables,Number>::n_independent_dofs () const
+    {
+      return dof_values.size();
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    void
+    EnergyFunctional<n_independent_variables,Number>::register_dof_values
+    (const Vector<Number> &local_dof_values)
+    {
+      const unsigned int n_dofs = dof_values.size();
+      AssertDimension (local_dof_values.size(), n_dofs);
+      for (unsigned int i=0; i<n_dofs; ++i)
+        {
+          ad_type_first_derivatives value = local_dof_values(i);
+          value.diff(i, n_dofs);
+          dof_values[i] = value;
+          dof_values[i].diff(i, n_dofs);
+        }
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    template <typename VectorType>
+    inline
+    void
+    EnergyFunctional<n_independent_variables,Number>::register_dof_values
+    (const VectorType                           &values,
+     const std::vector<types::global_dof_index> &local_dof_indices)
+    {
+      const unsigned int n_dofs = dof_values.size();
+      AssertDimension (local_dof_indices.size(), n_dofs);
+      for (unsigned int i=0; i<n_dofs; ++i)
+        {
+          ad_type_first_derivatives value = values(local_dof_indices[i]);
+          value.diff(i, n_dofs);
+          dof_values[i] = value;
+          dof_values[i].diff(i, n_dofs);
+        }
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    const std::vector<typename EnergyFunctional<n_independent_variables,Number>::ad_type> &
+    EnergyFunctional<n_independent_variables,Number>::get_sensitive_dof_values () const
+    {
+      return dof_values;
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    void
+    EnergyFunctional<n_independent_variables,Number>::register_energy_functional
+    (const ad_type &energy)
+    {
+      this->energy = energy;
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    Number
+    EnergyFunctional<n_independent_variables,Number>::compute_energy () const
+    {
+      return energy.val().val();
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    void
+    EnergyFunctional<n_independent_variables,Number>::compute_residual
+    (Vector<Number> &residual) const
+    {
+      const unsigned int n_dofs = dof_values.size();
+      AssertDimension (residual.size(), n_dofs);
+      for (unsigned int i=0; i<n_dofs; ++i)
+        residual(i) = energy.dx(i).val();
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    void
+    EnergyFunctional<n_independent_variables,Number>::compute_linearization
+    (FullMatrix<Number> &linearization) const
+    {
+      const unsigned int n_dofs = dof_values.size();
+      AssertDimension (linearization.m(), n_dofs);
+      AssertDimension (linearization.n(), n_dofs);
+      for (unsigned int i=0; i<n_dofs; ++i)
+        for (unsigned int j=0; j<n_dofs; ++j)
+          linearization(i,j) = energy.dx(i).dx(j);
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    ResidualLinearization<n_independent_variables,Number>::ResidualLinearization
+    (const unsigned int n_dofs)
+      :
+      dof_values (n_dofs)
+    {
+      Assert (n_independent_variables == 0 ||
+              n_dofs == static_cast<unsigned int>(n_independent_variables),
+              ExcDimensionMismatch(n_dofs, n_independent_variables));
+      AssertThrow (n_dofs > 0,
+                   ExcMessage("The number of independent variables must be "
+                              "given if it is not known at compile time."));
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    unsigned int
+    ResidualLinearization<n_independent_variables,Number>::n_independent_dofs () const
+    {
+      return dof_values.size();
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    void
+    ResidualLinearization<n_independent_variables,Number>::register_dof_values
+    (const Vector<Number> &local_dof_values)
+    {
+      const unsigned int n_dofs = dof_values.size();
+      AssertDimension (local_dof_values.size(), n_dofs);
+      for (unsigned int i=0; i<n_dofs; ++i)
+        {
+          dof_values[i] = local_dof_values(i);
+          dof_values[i].diff(i, n_dofs);
+        }
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    template <typename VectorType>
+    inline
+    void
+    ResidualLinearization<n_independent_variables,Number>::register_dof_values
+    (const VectorType                           &values,
+     const std::vector<types::global_dof_index> &local_dof_indices)
+    {
+      const unsigned int n_dofs = dof_values.size();
+      AssertDimension (local_dof_indices.size(), n_dofs);
+      for (unsigned int i=0; i<n_dofs; ++i)
+        {
+          dof_values[i] = values(local_dof_indices[i]);
+          dof_values[i].diff(i, n_dofs);
+        }
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    const std::vector<typename ResidualLinearization<n_independent_variables,Number>::ad_type> &
+    ResidualLinearization<n_independent_variables,Number>::get_sensitive_dof_values () const
+    {
+      return dof_values;
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    void
+    ResidualLinearization<n_independent_variables,Number>::register_residual_vector
+    (const std::vector<ad_type> &residual)
+    {
+      AssertDimension (residual.size(), dof_values.size());
+      this->residual = residual;
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    void
+    ResidualLinearization<n_independent_variables,Number>::compute_residual
+    (Vector<Number> &residual) const
+    {
+      AssertDimension (residual.size(), this->residual.size());
+      for (unsigned int i=0; i<this->residual.size(); ++i)
+        residual(i) = this->residual[i].val();
+    }
+
+
+
+    template <int n_independent_variables, typename Number>
+    inline
+    void
+    ResidualLinearization<n_independent_variables,Number>::compute_linearization
+    (FullMatrix<Number> &linearization) const
+    {
+      const unsigned int n_dofs = dof_values.size();
+      AssertDimension (linearization.m(), residual.size());
+      AssertDimension (linearization.n(), n_dofs);
+      for (unsigned int i=0; i<residual.size(); ++i)
+        for (unsigned int j=0; j<n_dofs; ++j)
+          linearization(i,j) = residual[i].dx(j);
+    }
+
+#endif // DEAL_II_WITH_TRILINOS
+
+
+
+#ifdef DEAL_II_WITH_ADOLC
+
+    inline
+    TapedEnergyFunctional::TapedEnergyFunctional (const unsigned int n_dofs)
+      :
+      active_tape (numbers::invalid_unsigned_int),
+      is_recording (false),
+      dof_values (n_dofs),
+      dof_values_ad (n_dofs)
+    {}
+
+
+
+    inline
+    unsigned int
+    TapedEnergyFunctional::n_independent_dofs () const
+    {
+      return dof_values.size();
+    }
+
+
+
+    inline
+    bool
+    TapedEnergyFunctional::start_recording (const unsigned int    tape_index,
+                                            const Vector<double> &local_dof_values)
+    {
+      Assert (is_recording == false,
+              ExcMessage("The previous tape has not been finished by "
+                         "stop_recording()."));
+      AssertDimension (local_dof_values.size(), dof_values.size());
+      for (unsigned int i=0; i<dof_values.size(); ++i)
+        dof_values[i] = local_dof_values(i);
+
+      active_tape = tape_index;
+      if (recorded_tapes.find(tape_index) != recorded_tapes.end())
+        return false;
+
+      // keep the values of the forward sweep on the tape since the
+      // derivatives are usually requested at the point of recording
+      trace_on (static_cast<short>(tape_index), 1);
+      for (unsigned int i=0; i<dof_values.size(); ++i)
+        dof_values_ad[i] <<= dof_values[i];
+      is_recording = true;
+      return true;
+    }
+
+
+
+    inline
+    const std::vector<adouble> &
+    TapedEnergyFunctional::get_sensitive_dof_values () const
+    {
+      Assert (is_recording == true,
+              ExcMessage("The independent variables are only available "
+                         "while a tape is recorded."));
+      return dof_values_ad;
+    }
+
+
+
+    inline
+    void
+    TapedEnergyFunctional::register_energy_functional (const adouble &energy)
+    {
+      Assert (is_recording == true,
+              ExcMessage("No tape is being recorded."));
+      double energy_value;
+      energy >>= energy_value;
+      (void)energy_value;
+    }
+
+
+
+    inline
+    void
+    TapedEnergyFunctional::stop_recording ()
+    {
+      Assert (is_recording == true,
+              ExcMessage("No tape is being recorded."));
+      trace_off ();
+      recorded_tapes.insert (active_tape);
+      is_recording = false;
+    }
+
+
+
+    inline
+    double
+    TapedEnergyFunctional::compute_energy () const
+    {
+      Assert (is_recording == false && active_tape != numbers::invalid_unsigned_int,
+              ExcMessage("No tape is available for evaluation."));
+      double energy = 0.;
+      ::function (static_cast<short>(active_tape), 1, dof_values.size(),
+                  const_cast<double *>(dof_values.data()), &energy);
+      return energy;
+    }
+
+
+
+    inline
+    void
+    TapedEnergyFunctional::compute_residual (Vector<double> &residual) const
+    {
+      Assert (is_recording == false && active_tape != numbers::invalid_unsigned_int,
+              ExcMessage("No tape is available for evaluation."));
+      AssertDimension (residual.size(), dof_values.size());
+      ::gradient (static_cast<short>(active_tape), dof_values.size(),
+                  const_cast<double *>(dof_values.data()), residual.begin());
+    }
+
+
+
+    inline
+    void
+    TapedEnergyFunctional::compute_linearization (FullMatrix<double> &linearization) const
+    {
+      Assert (is_recording == false && active_tape != numbers::invalid_unsigned_int,
+              ExcMessage("No tape is available for evaluation."));
+      const unsigned int n_dofs = dof_values.size();
+      AssertDimension (linearization.m(), n_dofs);
+      AssertDimension (linearization.n(), n_dofs);
+
+      // ADOL-C only fills the lower triangle of the Hessian, which is
+      // stored by rows in the memory of the matrix
+      std::vector<double *> rows (n_dofs);
+      for (unsigned int i=0; i<n_dofs; ++i)
+        rows[i] = &linearization(i,0);
+      ::hessian (static_cast<short>(active_tape), n_dofs,
+                 const_cast<double *>(dof_values.data()), rows.data());
+      for (unsigned int i=0; i<n_dofs; ++i)
+        for (unsigned int j=i+1; j<n_dofs; ++j)
+          linearization(i,j) = linearization(j,i);
+    }
+
+#endif // DEAL_II_WITH_ADOLC
+  }
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // defined(DEAL_II_WITH_TRILINOS) || defined(DEAL_II_WITH_ADOLC)
+
+#endif
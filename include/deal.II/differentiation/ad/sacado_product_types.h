@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2015 by the deal.II authors
+// Copyright (C) 2015 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -74,6 +74,49 @@ namespace internal
     typedef Sacado::Fad::DFad<typename ProductType<T,U>::type > type;
   };
 
+
+  template <typename T, int N>
+  struct ProductTypeImpl<Sacado::Fad::SFad<T,N>, float>
+  {
+    typedef Sacado::Fad::SFad<T,N> type;
+  };
+
+  template <typename T, int N>
+  struct ProductTypeImpl<float, Sacado::Fad::SFad<T,N> >
+  {
+    typedef Sacado::Fad::SFad<T,N> type;
+  };
+
+  template <typename T, int N>
+  struct ProductTypeImpl<Sacado::Fad::SFad<T,N>, double>
+  {
+    typedef Sacado::Fad::SFad<T,N> type;
+  };
+
+  template <typename T, int N>
+  struct ProductTypeImpl<double, Sacado::Fad::SFad<T,N> >
+  {
+    typedef Sacado::Fad::SFad<T,N> type;
+  };
+
+  template <typename T, int N>
+  struct ProductTypeImpl<Sacado::Fad::SFad<T,N>, int>
+  {
+    typedef Sacado::Fad::SFad<T,N> type;
+  };
+
+  template <typename T, int N>
+  struct ProductTypeImpl<int, Sacado::Fad::SFad<T,N> >
+  {
+    typedef Sacado::Fad::SFad<T,N> type;
+  };
+
+  template <typename T, typename U, int N>
+  struct ProductTypeImpl<Sacado::Fad::SFad<T,N>, Sacado::Fad::SFad<U,N> >
+  {
+    typedef Sacado::Fad::SFad<typename ProductType<T,U>::type,N> type;
+  };
+
 }
 
 template <typename T>
@@ -83,6 +126,13 @@ struct EnableIfScalar<Sacado::Fad::DFad<T> >
 };
 
 
+template <typename T, int N>
+struct EnableIfScalar<Sacado::Fad::SFad<T,N> >
+{
+  typedef Sacado::Fad::SFad<T,N> type;
+};
+
+
 
 /**
  * Compute the scalar product $a:b=\sum_{i,j} a_{ij}b_{ij}$ between two
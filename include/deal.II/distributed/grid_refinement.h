@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2009 - 2016 by the deal.II authors
+// Copyright (C) 2009 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -42,6 +42,15 @@ namespace parallel
      * the functions in the current namespace are intended for distributed
      * meshes, i.e., objects of type parallel::distributed::Triangulation.
      *
+     * The thresholds for refinement and coarsening are determined from
+     * global histograms of the indicators on logarithmically spaced bins,
+     * which are refined around the target until the number of cells (or the
+     * error) above the threshold matches the target up to a relative
+     * tolerance of about $10^{-5}$, or up to a single cell. The thresholds
+     * for refinement and coarsening are searched for at the same time, so
+     * this typically takes three collective operations in total, independent
+     * of the number of processors.
+     *
      * @ingroup grid
      * @author Wolfgang Bangerth, 2009
      */
@@ -0,0 +1,175 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_distributed_load_balancer_h
+#define dealii_distributed_load_balancer_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/distributed/tria.h>
+
+#include <boost/signals2/connection.hpp>
+
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace parallel
+{
+  namespace distributed
+  {
+    /**
+     * A class that collects the measured computational cost of the locally
+     * owned cells of a parallel::distributed::Triangulation and uses it to
+     * decide whether repartitioning the mesh pays off.
+     *
+     * The cost of the cells is recorded with add_cell_cost() while the
+     * simulation runs, for example the time spent in the assembly on a cell,
+     * the number of particles in a cell times the cost of a particle update,
+     * or the number of unknowns of a cell for hp methods. Calling
+     * repartition_if_beneficial() then compares the predicted gain, i.e.,
+     * the time the most loaded process spends in excess of the average over
+     * the expected number of future intervals, with the estimated cost of
+     * migrating the cells that need to be shipped to balance the load. If
+     * the gain exceeds the migration cost, the costs are handed to the
+     * Triangulation::Signals::cell_weight signal and
+     * Triangulation::repartition() is called.
+     *
+     * @code
+     *   LoadBalancer<dim> balancer (triangulation, migration_cost_per_cell);
+     *   for (unsigned int step=0; step<n_steps; ++step)
+     *     {
+     *       for (cell = ...)
+     *         balancer.add_cell_cost (cell, particle_handler.n_particles_in_cell(cell) *
+     *                                       cost_per_particle);
+     *       if (step % check_interval == 0)
+     *         {
+     *           // register data transfer, e.g. with the particle handler
+     *           if (balancer.repartition_if_beneficial (check_interval))
+     *             // unpack the transferred data
+     *         }
+     *     }
+     * @endcode
+     *
+     * The costs are accumulated until they are cleared with clear_costs(),
+     * by a successful repartition_if_beneficial(), or by any change of the
+     * triangulation, at which point the cell numbering the costs refer to
+     * becomes invalid. The units of the costs are arbitrary as long as the
+     * migration cost is given in the same units.
+     *
+     * Since repartition_if_beneficial() calls Triangulation::repartition()
+     * only in some cases, the data transfer needed during repartitioning
+     * (SolutionTransfer, register_data_attach()) must either be registered
+     * unconditionally and then unpacked only if the function returned @p
+     * true, or be set up after a call to should_repartition() that returns
+     * the decision without acting on it.
+     *
+     * @ingroup distributed
+     */
+    template <int dim, int spacedim = dim>
+    class LoadBalancer
+    {
+    public:
+      /**
+       * Constructor. The argument @p migration_cost_per_cell is the
+       * estimated cost of moving one cell with its data to another process,
+       * in the same units as the costs recorded with add_cell_cost().
+       */
+      LoadBalancer (Triangulation<dim,spacedim> &triangulation,
+                    const double                 migration_cost_per_cell);
+
+      /**
+       * Destructor. Disconnects from the signals of the triangulation.
+       */
+      ~LoadBalancer ();
+
+      /**
+       * Add @p cost to the accumulated cost of the locally owned active cell
+       * @p cell.
+       */
+      void add_cell_cost (const typename dealii::Triangulation<dim,spacedim>::active_cell_iterator &cell,
+                          const double cost);
+
+      /**
+       * Reset the accumulated costs of all cells to zero.
+       */
+      void clear_costs ();
+
+      /**
+       * Return the ratio between the maximal accumulated cost on any process
+       * and the average over all processes. A value of one means perfect
+       * balance. This is a collective operation.
+       */
+      double imbalance () const;
+
+      /**
+       * Return whether repartitioning is expected to pay off, given that the
+       * current partition would be kept for @p n_future_intervals more
+       * intervals of the length over which the current costs were measured.
+       * This is a collective operation.
+       */
+      bool should_repartition (const double n_future_intervals = 1.) const;
+
+      /**
+       * If should_repartition() returns @p true, repartition the
+       * triangulation with cell weights proportional to the accumulated cell
+       * costs and clear the costs. Returns whether the triangulation was
+       * repartitioned. This is a collective operation.
+       */
+      bool repartition_if_beneficial (const double n_future_intervals = 1.);
+
+    private:
+      /**
+       * The weight passed to the cell_weight signal during repartitioning.
+       */
+      unsigned int
+      cell_weight (const typename dealii::Triangulation<dim,spacedim>::cell_iterator &cell,
+                   const typename dealii::Triangulation<dim,spacedim>::CellStatus status) const;
+
+      /**
+       * The triangulation whose cells are balanced.
+       */
+      SmartPointer<Triangulation<dim,spacedim>,LoadBalancer<dim,spacedim> > triangulation;
+
+      /**
+       * The estimated cost of migrating one cell.
+       */
+      const double migration_cost_per_cell;
+
+      /**
+       * The accumulated costs, indexed by the active cell index.
+       */
+      std::vector<double> cell_costs;
+
+      /**
+       * The cost of the cheapest cell with a non-zero cost over all
+       * processes, used to scale the weights during repartitioning.
+       */
+      double reference_cost;
+
+      /**
+       * The connection to the any_change signal of the triangulation that
+       * invalidates the recorded costs.
+       */
+      boost::signals2::connection tria_listener;
+    };
+  }
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
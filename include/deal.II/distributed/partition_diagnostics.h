@@ -0,0 +1,177 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_distributed_partition_diagnostics_h
+#define dealii_distributed_partition_diagnostics_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/vector.h>
+
+#include <array>
+#include <iosfwd>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace parallel
+{
+  /**
+   * A class that collects indicators of the quality of the parallel
+   * partition of a mesh and of the degrees of freedom on it: the number of
+   * locally owned and ghost cells, the number of neighboring processors, the
+   * number of locally owned and ghost degrees of freedom, and the sizes of
+   * the messages exchanged when updating the ghost values of a vector with
+   * the layout of Utilities::MPI::Partitioner. The local value of each of
+   * these quantities is accumulated over all processors into the minimum,
+   * maximum, and average, which helps to identify load imbalance or
+   * excessive communication without using a profiler.
+   *
+   * @code
+   *   parallel::PartitionDiagnostics<dim> diagnostics (dof_handler);
+   *   diagnostics.print (pcout);
+   *
+   *   data_out.add_data_vector (diagnostics.cell_field
+   *                             (parallel::PartitionDiagnostics<dim>::ghost_dof_ratio),
+   *                             "ghost_dof_ratio");
+   * @endcode
+   *
+   * The quantities are computed in the constructor, which is a collective
+   * operation on the communicator of the triangulation. For triangulations
+   * that are not derived from parallel::Triangulation, the diagnostics
+   * describe the single partition of the current process.
+   *
+   * @ingroup distributed
+   */
+  template <int dim, int spacedim = dim>
+  class PartitionDiagnostics
+  {
+  public:
+    /**
+     * The quantities collected by this class.
+     */
+    enum Quantity
+    {
+      /**
+       * The number of locally owned active cells.
+       */
+      owned_cells,
+      /**
+       * The number of active ghost cells.
+       */
+      ghost_cells,
+      /**
+       * The number of processors that own ghost cells of this processor.
+       */
+      neighbor_processors,
+      /**
+       * The number of locally owned degrees of freedom.
+       */
+      owned_dofs,
+      /**
+       * The number of locally relevant degrees of freedom that are not
+       * locally owned, i.e., the size of the ghost range of a vector.
+       */
+      ghost_dofs,
+      /**
+       * The ratio between the numbers of ghost and of locally owned degrees
+       * of freedom.
+       */
+      ghost_dof_ratio,
+      /**
+       * The number of processors this processor exchanges messages with when
+       * updating the ghost values of a vector.
+       */
+      communication_partners,
+      /**
+       * The number of vector entries this processor sends to other
+       * processors when updating ghost values, i.e.,
+       * Utilities::MPI::Partitioner::n_import_indices().
+       */
+      exported_entries,
+      /**
+       * The number of vector entries this processor receives from other
+       * processors when updating ghost values, which equals @p ghost_dofs.
+       */
+      imported_entries,
+      /**
+       * The number of quantities.
+       */
+      n_quantities
+    };
+
+    /**
+     * Constructor. Computes all quantities for the partition described by
+     * @p dof_handler and its triangulation.
+     */
+    PartitionDiagnostics (const DoFHandler<dim,spacedim> &dof_handler);
+
+    /**
+     * Return the value of the quantity @p quantity on the current processor.
+     */
+    double local_value (const Quantity quantity) const;
+
+    /**
+     * Return the minimum, maximum, and average of the quantity @p quantity
+     * over all processors.
+     */
+    const Utilities::MPI::MinMaxAvg &statistics (const Quantity quantity) const;
+
+    /**
+     * Return a name for the given quantity, used in print().
+     */
+    static const char *name (const Quantity quantity);
+
+    /**
+     * Print a table with the minimum, average, and maximum of all quantities
+     * over the processors together with the ranks holding the extreme values
+     * to the given stream.
+     */
+    template <class StreamType>
+    void print (StreamType &out) const;
+
+    /**
+     * Return a vector with one entry per active cell of the triangulation
+     * that holds the local value of @p quantity on the locally owned cells
+     * and zero on all other cells. The vector can be passed to
+     * DataOut::add_data_vector() to visualize the distribution of the
+     * quantity over the processors.
+     */
+    Vector<float> cell_field (const Quantity quantity) const;
+
+  private:
+    /**
+     * The triangulation the diagnostics were computed on.
+     */
+    SmartPointer<const dealii::Triangulation<dim,spacedim>,PartitionDiagnostics<dim,spacedim> > triangulation;
+
+    /**
+     * The values on the current processor.
+     */
+    std::array<double,n_quantities> local_values;
+
+    /**
+     * The statistics over all processors.
+     */
+    std::array<Utilities::MPI::MinMaxAvg,n_quantities> global_values;
+  };
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -93,6 +93,22 @@ namespace parallel
      * by processors. Both the DoFHandler and hp::DoFHandler classes know how
      * to enumerate degrees of freedom in ways appropriate for the partitioned mesh.
      *
+     * <h3>Memory consumption</h3>
+     *
+     * Since every processor stores the complete mesh, the memory used by this
+     * class and by the DoFHandler objects built on it does not decrease as
+     * more processors are used, which limits this class to meshes with a few
+     * million cells. Setting @p allow_artificial_cells only affects which
+     * cells are considered ghost cells, it does not release the storage of
+     * the artificial cells: the enumeration of degrees of freedom for shared
+     * triangulations and the partitioning functions in GridTools need all
+     * cells. Use memory_consumption() to monitor the per-process storage.
+     * For larger meshes, parallel::distributed::Triangulation only stores
+     * the coarse mesh together with the locally owned and ghost cells; with
+     * the flag
+     * parallel::distributed::Triangulation::graph_partitioned_coarse_cell_ordering
+     * its partitions follow a METIS partitioning of the coarse mesh.
+     *
      * @author Denis Davydov, 2015
      * @ingroup distributed
      *
@@ -278,6 +294,13 @@ namespace parallel
        */
       bool with_artificial_cells() const;
 
+      /**
+       * Return the local memory consumption in bytes, including the
+       * replicated mesh and the arrays storing the true subdomain ids of all
+       * cells.
+       */
+      virtual std::size_t memory_consumption () const;
+
     private:
 
       /**
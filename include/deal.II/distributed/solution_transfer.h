@@ -222,6 +222,14 @@ namespace parallel
        */
       unsigned int offset;
 
+      /**
+       * Temporary arrays for the values on a cell and on its children, kept
+       * to avoid allocating memory for every cell and every vector in the
+       * callbacks.
+       */
+      ::dealii::Vector<typename VectorType::value_type> cell_values;
+      ::dealii::Vector<typename VectorType::value_type> child_values;
+
       /**
        * A callback function used to pack the data on the current mesh into
        * objects that can later be retrieved after refinement, coarsening and
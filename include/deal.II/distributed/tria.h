@@ -316,7 +316,30 @@ namespace parallel
          * after a refinement cycle. It can be executed manually by calling
          * repartition().
          */
-        no_automatic_repartitioning = 0x4
+        no_automatic_repartitioning = 0x4,
+        /**
+         * p4est partitions the mesh along a Morton (z-order) curve within
+         * each coarse cell and traverses the coarse cells in the order of
+         * the trees of its forest. By default, the trees are numbered by
+         * SparsityTools::reorder_hierarchical() on the connectivity graph of
+         * the coarse cells. If this flag is set, the trees are instead
+         * ordered along a Hilbert curve through the centers of the coarse
+         * cells, which keeps consecutive trees adjacent and gives partitions
+         * with a smaller surface for meshes consisting of many coarse cells,
+         * such as elongated or anisotropic domains.
+         */
+        hilbert_coarse_cell_ordering = 0x8,
+        /**
+         * If set, the coarse cells are partitioned with METIS into as many
+         * groups as there are MPI processes, minimizing the number of cut
+         * edges in the connectivity graph, and the trees of p4est are
+         * numbered group by group. The partitioning done by p4est along the
+         * curve then follows the graph partitioning as long as the cells are
+         * evenly refined. This flag requires deal.II to be configured with
+         * METIS when running on more than one process and cannot be combined
+         * with hilbert_coarse_cell_ordering.
+         */
+        graph_partitioned_coarse_cell_ordering = 0x10
       };
 
 
@@ -389,6 +412,19 @@ namespace parallel
        * necessary once the mesh is being refined, though we will always keep
        * the entire coarse mesh that is generated by this function on all
        * processors.
+       *
+       * @note Both the deal.II coarse mesh and the p4est connectivity built
+       * from it are replicated on every processor, because p4est identifies
+       * the trees of its forest by their global index and needs the complete
+       * tree-to-tree connectivity for balancing and partitioning. Thus, the
+       * memory consumption and the time spent in this function grow with the
+       * global number of coarse cells, independent of the number of
+       * processors. As a rule of thumb, each coarse cell takes a few hundred
+       * bytes in 3d, including its faces, edges and vertices, see
+       * memory_consumption(). For coarse meshes with many millions of cells,
+       * it is usually better to start from a coarser description of the
+       * geometry and create the fine mesh by refinement, possibly attaching
+       * a TransfiniteInterpolationManifold to keep the geometry.
        */
       virtual void create_triangulation (const std::vector<Point<spacedim> >    &vertices,
                                          const std::vector<CellData<dim> > &cells,
@@ -561,6 +597,12 @@ namespace parallel
        */
       virtual std::size_t memory_consumption_p4est () const;
 
+      /**
+       * Return a breakdown of the local memory consumption, including the
+       * p4est data structures.
+       */
+      virtual MemoryReport memory_report () const;
+
       /**
        * A collective operation that produces a sequence of output files with
        * the given file base name that contain the mesh in VTK format.
@@ -640,6 +682,16 @@ namespace parallel
        * @note The two functions can also be used for serialization of data
        * using save() and load() in the same way. Then the status will always
        * be CELL_PERSIST.
+       *
+       * @note The data is stored inside the quadrants of the p4est forest,
+       * which p4est moves along with the quadrants during repartitioning and
+       * writes in save(). Therefore, @p size bytes are reserved for every
+       * active cell, and data whose size varies between the cells must be
+       * padded to the largest size. The sizes of all registered callbacks add
+       * up, so the combined size is what is sent for each cell. Keep @p size
+       * as small as possible, e.g. by storing data in single precision or
+       * by compressing it into the given buffer, since it is multiplied by
+       * the number of cells in all transfers.
        */
       unsigned int
       register_data_attach (const std::size_t size,
@@ -98,6 +98,15 @@ namespace parallel
      */
     unsigned int n_locally_owned_active_cells () const;
 
+    /**
+     * Return the number of active ghost cells on the current processor,
+     * i.e., the size of the layer of cells owned by other processors that
+     * surrounds the locally owned cells. Comparing this number before and
+     * after repartitioning gives a measure for the communication volume
+     * induced by the partition.
+     */
+    unsigned int n_ghost_active_cells () const;
+
     /**
      * Return the sum over all processors of the number of active cells owned
      * by each processor. This equals the overall number of active cells in
@@ -193,6 +202,10 @@ namespace parallel
        * n_locally_owned_active_cells).
        */
       types::global_dof_index       n_global_active_cells;
+      /**
+       * The number of active ghost cells on this processor.
+       */
+      unsigned int                  n_ghost_active_cells;
       /**
        * The global number of levels computed as the maximum number of levels
        * taken over all MPI ranks, so <tt>n_levels()<=n_global_levels =
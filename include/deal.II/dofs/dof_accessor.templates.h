@@ -2656,17 +2656,14 @@ namespace internal
       void
       update_cell_dof_indices_cache (const DoFCellAccessor<DoFHandler<1,spacedim>, level_dof_access> &accessor)
       {
-        // check as in documentation that
-        // cell is either active, or dofs
-        // are only in vertices. otherwise
-        // simply don't update the cache at
-        // all. the get_dof_indices
-        // function will then make sure we
-        // don't access the invalid data
-        if (accessor.has_children()
-            &&
-            (accessor.get_fe().dofs_per_cell !=
-             accessor.get_fe().dofs_per_vertex * GeometryInfo<1>::vertices_per_cell))
+        // caches are only for cells with
+        // DoFs, i.e., for active
+        // ones. otherwise simply don't
+        // update the cache at all. the
+        // get_dof_indices function will
+        // then make sure we don't access
+        // the invalid data
+        if (accessor.has_children())
           return;
 
         const unsigned int dofs_per_vertex = accessor.get_fe().dofs_per_vertex,
@@ -2677,15 +2674,28 @@ namespace internal
         // as big as we need it when
         // writing to the last element of
         // this cell
-        Assert (accessor.present_index * dofs_per_cell + dofs_per_cell
+        Assert (static_cast<unsigned int>(accessor.present_index)
+                <
+                accessor.dof_handler->levels[accessor.present_level]
+                ->cell_cache_offsets.size(),
+                ExcInternalError());
+        Assert (accessor.dof_handler->levels[accessor.present_level]
+                ->cell_cache_offsets[accessor.present_index]
+                !=
+                numbers::invalid_unsigned_int,
+                ExcMessage ("The DoF index cache has no entries for "
+                            "artificial cells."));
+        Assert (accessor.dof_handler->levels[accessor.present_level]
+                ->cell_cache_offsets[accessor.present_index] + dofs_per_cell
                 <=
                 accessor.dof_handler->levels[accessor.present_level]
                 ->cell_dof_indices_cache.size(),
                 ExcInternalError());
 
-        std::vector<types::global_dof_index>::iterator next
-          = (accessor.dof_handler->levels[accessor.present_level]
-             ->cell_dof_indices_cache.begin() + accessor.present_index * dofs_per_cell);
+        types::global_dof_index *next
+          = &accessor.dof_handler->levels[accessor.present_level]
+            ->cell_dof_indices_cache[accessor.dof_handler->levels[accessor.present_level]
+                                     ->cell_cache_offsets[accessor.present_index]];
 
         for (unsigned int vertex=0; vertex<2; ++vertex)
           for (unsigned int d=0; d<dofs_per_vertex; ++d)
@@ -2701,17 +2711,14 @@ namespace internal
       void
       update_cell_dof_indices_cache (const DoFCellAccessor<DoFHandler<2,spacedim>, level_dof_access> &accessor)
       {
-        // check as in documentation that
-        // cell is either active, or dofs
-        // are only in vertices. otherwise
-        // simply don't update the cache at
-        // all. the get_dof_indices
-        // function will then make sure we
-        // don't access the invalid data
-        if (accessor.has_children()
-            &&
-            (accessor.get_fe().dofs_per_cell !=
-             accessor.get_fe().dofs_per_vertex * GeometryInfo<2>::vertices_per_cell))
+        // caches are only for cells with
+        // DoFs, i.e., for active
+        // ones. otherwise simply don't
+        // update the cache at all. the
+        // get_dof_indices function will
+        // then make sure we don't access
+        // the invalid data
+        if (accessor.has_children())
           return;
 
         const unsigned int dofs_per_vertex = accessor.get_fe().dofs_per_vertex,
@@ -2723,15 +2730,28 @@ namespace internal
         // as big as we need it when
         // writing to the last element of
         // this cell
-        Assert (accessor.present_index * dofs_per_cell + dofs_per_cell
+        Assert (static_cast<unsigned int>(accessor.present_index)
+                <
+                accessor.dof_handler->levels[accessor.present_level]
+                ->cell_cache_offsets.size(),
+                ExcInternalError());
+        Assert (accessor.dof_handler->levels[accessor.present_level]
+                ->cell_cache_offsets[accessor.present_index]
+                !=
+                numbers::invalid_unsigned_int,
+                ExcMessage ("The DoF index cache has no entries for "
+                            "artificial cells."));
+        Assert (accessor.dof_handler->levels[accessor.present_level]
+                ->cell_cache_offsets[accessor.present_index] + dofs_per_cell
                 <=
                 accessor.dof_handler->levels[accessor.present_level]
                 ->cell_dof_indices_cache.size(),
                 ExcInternalError());
 
-        std::vector<types::global_dof_index>::iterator next
-          = (accessor.dof_handler->levels[accessor.present_level]
-             ->cell_dof_indices_cache.begin() + accessor.present_index * dofs_per_cell);
+        types::global_dof_index *next
+          = &accessor.dof_handler->levels[accessor.present_level]
+            ->cell_dof_indices_cache[accessor.dof_handler->levels[accessor.present_level]
+                                     ->cell_cache_offsets[accessor.present_index]];
 
         for (unsigned int vertex=0; vertex<4; ++vertex)
           for (unsigned int d=0; d<dofs_per_vertex; ++d)
@@ -2749,17 +2769,14 @@ namespace internal
       void
       update_cell_dof_indices_cache (const DoFCellAccessor<DoFHandler<3,spacedim>, level_dof_access> &accessor)
       {
-        // check as in documentation that
-        // cell is either active, or dofs
-        // are only in vertices. otherwise
-        // simply don't update the cache at
-        // all. the get_dof_indices
-        // function will then make sure we
-        // don't access the invalid data
-        if (accessor.has_children()
-            &&
-            (accessor.get_fe().dofs_per_cell !=
-             accessor.get_fe().dofs_per_vertex * GeometryInfo<3>::vertices_per_cell))
+        // caches are only for cells with
+        // DoFs, i.e., for active
+        // ones. otherwise simply don't
+        // update the cache at all. the
+        // get_dof_indices function will
+        // then make sure we don't access
+        // the invalid data
+        if (accessor.has_children())
           return;
 
         const unsigned int dofs_per_vertex = accessor.get_fe().dofs_per_vertex,
@@ -2772,15 +2789,28 @@ namespace internal
         // as big as we need it when
         // writing to the last element of
         // this cell
-        Assert (accessor.present_index * dofs_per_cell + dofs_per_cell
+        Assert (static_cast<unsigned int>(accessor.present_index)
+                <
+                accessor.dof_handler->levels[accessor.present_level]
+                ->cell_cache_offsets.size(),
+                ExcInternalError());
+        Assert (accessor.dof_handler->levels[accessor.present_level]
+                ->cell_cache_offsets[accessor.present_index]
+                !=
+                numbers::invalid_unsigned_int,
+                ExcMessage ("The DoF index cache has no entries for "
+                            "artificial cells."));
+        Assert (accessor.dof_handler->levels[accessor.present_level]
+                ->cell_cache_offsets[accessor.present_index] + dofs_per_cell
                 <=
                 accessor.dof_handler->levels[accessor.present_level]
                 ->cell_dof_indices_cache.size(),
                 ExcInternalError());
 
-        std::vector<types::global_dof_index>::iterator next
-          = (accessor.dof_handler->levels[accessor.present_level]
-             ->cell_dof_indices_cache.begin() + accessor.present_index * dofs_per_cell);
+        types::global_dof_index *next
+          = &accessor.dof_handler->levels[accessor.present_level]
+            ->cell_dof_indices_cache[accessor.dof_handler->levels[accessor.present_level]
+                                     ->cell_cache_offsets[accessor.present_index]];
 
         for (unsigned int vertex=0; vertex<8; ++vertex)
           for (unsigned int d=0; d<dofs_per_vertex; ++d)
@@ -3045,8 +3075,8 @@ namespace internal
 
         const unsigned int n_dofs = local_source_end - local_source_begin;
 
-        types::global_dof_index *dofs = &accessor.dof_handler->levels[accessor.level()]
-                                        ->cell_dof_indices_cache[accessor.present_index * n_dofs];
+        const types::global_dof_index *dofs = accessor.dof_handler->levels[accessor.level()]
+                                        ->get_cell_cache_start (accessor.present_index, n_dofs);
 
         // distribute cell vector
         global_destination.add(n_dofs, dofs, local_source_begin);
@@ -3104,8 +3134,8 @@ namespace internal
 
         const unsigned int n_dofs = local_source_end - local_source_begin;
 
-        types::global_dof_index *dofs = &accessor.dof_handler->levels[accessor.level()]
-                                        ->cell_dof_indices_cache[accessor.present_index * n_dofs];
+        const types::global_dof_index *dofs = accessor.dof_handler->levels[accessor.level()]
+                                        ->get_cell_cache_start (accessor.present_index, n_dofs);
 
         // distribute cell vector
         constraints.distribute_local_to_global (local_source_begin, local_source_end,
@@ -3168,8 +3198,8 @@ namespace internal
 
         const unsigned int n_dofs = local_source.m();
 
-        types::global_dof_index *dofs = &accessor.dof_handler->levels[accessor.level()]
-                                        ->cell_dof_indices_cache[accessor.present_index * n_dofs];
+        const types::global_dof_index *dofs = accessor.dof_handler->levels[accessor.level()]
+                                        ->get_cell_cache_start (accessor.present_index, n_dofs);
 
         // distribute cell matrix
         for (unsigned int i=0; i<n_dofs; ++i)
@@ -3240,8 +3270,8 @@ namespace internal
                 ExcMessage ("Cell must be active."));
 
         const unsigned int n_dofs = accessor.get_fe().dofs_per_cell;
-        types::global_dof_index *dofs = &accessor.dof_handler->levels[accessor.level()]
-                                        ->cell_dof_indices_cache[accessor.present_index *n_dofs];
+        const types::global_dof_index *dofs = accessor.dof_handler->levels[accessor.level()]
+                                        ->get_cell_cache_start (accessor.present_index, n_dofs);
 
         // distribute cell matrices
         for (unsigned int i=0; i<n_dofs; ++i)
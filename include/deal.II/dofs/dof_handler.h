@@ -23,6 +23,7 @@
 #include <deal.II/base/smartpointer.h>
 #include <deal.II/base/index_set.h>
 #include <deal.II/base/iterator_range.h>
+#include <deal.II/base/memory_report.h>
 #include <deal.II/dofs/block_info.h>
 #include <deal.II/dofs/dof_iterator_selector.h>
 #include <deal.II/dofs/number_cache.h>
@@ -889,6 +890,15 @@ public:
    */
   virtual std::size_t memory_consumption () const;
 
+  /**
+   * Return a breakdown of the memory consumption returned by
+   * memory_consumption() into the degree of freedom indices stored on the
+   * cells of each level, on faces and on vertices, the multigrid
+   * indices, and the finite elements. The memory of the triangulation is
+   * not included; use Triangulation::memory_report() for it.
+   */
+  virtual MemoryReport memory_report () const;
+
   /**
    * Write the data of this object to a stream for the purpose of
    * serialization.
@@ -71,8 +71,18 @@ namespace internal
     {
     public:
       /**
-       * Cache for the DoF indices on cells. The size of this array equals the
-       * number of cells on a given level times selected_fe.dofs_per_cell.
+       * The offsets for each cell into the cache that holds all DoF indices,
+       * or numbers::invalid_unsigned_int for cells that have no entries in
+       * the cache.
+       */
+      std::vector<unsigned int> cell_cache_offsets;
+
+      /**
+       * Cache for the DoF indices on cells. Only the active cells that are
+       * not artificial have entries in this array, since the cache is never
+       * read for other cells, so its size equals the number of these cells
+       * on a given level times selected_fe.dofs_per_cell. The position of
+       * the entries of each cell is given by #cell_cache_offsets.
        */
       std::vector<types::global_dof_index> cell_dof_indices_cache;
 
@@ -117,12 +127,18 @@ namespace internal
     DoFLevel<dim>::get_cell_cache_start (const unsigned int obj_index,
                                          const unsigned int dofs_per_cell) const
     {
-      Assert (obj_index*dofs_per_cell+dofs_per_cell
-              <=
-              cell_dof_indices_cache.size(),
-              ExcInternalError());
-
-      return &cell_dof_indices_cache[obj_index*dofs_per_cell];
+      Assert ((obj_index < cell_cache_offsets.size())
+              &&
+              (cell_cache_offsets[obj_index] != numbers::invalid_unsigned_int)
+              &&
+              (cell_cache_offsets[obj_index]+dofs_per_cell
+               <=
+               cell_dof_indices_cache.size()),
+              ExcMessage ("Trying to access the DoF index cache of a cell "
+                          "that has no entries in it."));
+      (void)dofs_per_cell;
+
+      return &cell_dof_indices_cache[cell_cache_offsets[obj_index]];
     }
 
 
@@ -132,7 +148,8 @@ namespace internal
     std::size_t
     DoFLevel<dim>::memory_consumption () const
     {
-      return (MemoryConsumption::memory_consumption (cell_dof_indices_cache) +
+      return (MemoryConsumption::memory_consumption (cell_cache_offsets) +
+              MemoryConsumption::memory_consumption (cell_dof_indices_cache) +
               MemoryConsumption::memory_consumption (dof_object));
     }
 
@@ -144,6 +161,7 @@ namespace internal
     DoFLevel<dim>::serialize (Archive &ar,
                               const unsigned int)
     {
+      ar &cell_cache_offsets;
       ar &cell_dof_indices_cache;
       ar &dof_object;
     }
@@ -540,6 +540,40 @@ namespace DoFTools
                          const bool                 keep_constrained_dofs = true,
                          const types::subdomain_id  subdomain_id          = numbers::invalid_subdomain_id);
 
+  /**
+   * Same as the first make_sparsity_pattern() function above, but build the
+   * pattern directly into a SparsityPattern without going through a
+   * DynamicSparsityPattern. On exit, @p sparsity_pattern is sized to the
+   * number of degrees of freedom and compressed, i.e., it can immediately be
+   * used to initialize a SparseMatrix. Any previous content of @p
+   * sparsity_pattern is discarded.
+   *
+   * The pattern is built in two passes over the cells: The first pass counts
+   * the entries going into each row, which gives an upper bound for the row
+   * lengths since entries that several cells add into the same row are
+   * counted multiple times. The second pass allocates the storage for all
+   * rows in one piece and fills in the entries, and the final call to
+   * SparsityPattern::compress() removes the unused slots. Both passes work on
+   * the cells in parallel, with the rows guarded by a Threads::SpinLockTable.
+   * This avoids the many small allocations of the rows of a
+   * DynamicSparsityPattern and the copy out of it, at the price of some
+   * additional memory for the overestimated rows during the construction.
+   *
+   * See the first make_sparsity_pattern() function for a description of the
+   * other arguments. Since the result is compressed, the constraints must be
+   * passed to this function rather than eliminated by a later call to
+   * ConstraintMatrix::condense().
+   *
+   * @ingroup constraints
+   */
+  template <typename DoFHandlerType>
+  void
+  make_compressed_sparsity_pattern (const DoFHandlerType      &dof_handler,
+                                    SparsityPattern           &sparsity_pattern,
+                                    const ConstraintMatrix    &constraints           = ConstraintMatrix(),
+                                    const bool                 keep_constrained_dofs = true,
+                                    const types::subdomain_id  subdomain_id          = numbers::invalid_subdomain_id);
+
   /**
    * Compute which entries of a matrix built on the given @p dof_handler may
    * possibly be nonzero, and create a sparsity pattern object that represents
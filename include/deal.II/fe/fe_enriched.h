@@ -192,6 +192,17 @@ DEAL_II_NAMESPACE_OPEN
  * The ordering of the shape function, @p interface_constrains, the @p prolongation (embedding)
  * and the @p restriction matrices are taken from the FESystem class.
  *
+ * The enrichment functions are evaluated at all quadrature points of a
+ * cell at once through Function::value_list(), Function::gradient_list()
+ * and Function::hessian_list(). The results are kept in the internal data
+ * of each FEValues object and reused if the next call to FEValues::reinit()
+ * asks for the same enrichment function object at the same time (see
+ * Function::get_time()) and at the same quadrature points. Repeated
+ * reinitialization on the same cell, e.g., within a Newton iteration,
+ * then does not evaluate the enrichment functions again. For this reason,
+ * an enrichment function must not change its values other than through
+ * FunctionTime::set_time() while it is in use by FE_Enriched.
+ *
  * @ingroup fe
  *
  * @author Denis Davydov, 2016.
@@ -455,9 +466,27 @@ protected:
      */
     struct EnrichmentValues
     {
+      /**
+       * Constructor.
+       */
+      EnrichmentValues ();
+
       std::vector<double> values;
       std::vector<Tensor<1,spacedim> > gradients;
       std::vector<SymmetricTensor<2, spacedim> > hessians;
+
+      /**
+       * The enrichment function the values, gradients and hessians above
+       * were computed for, or @p nullptr if they have not been computed
+       * yet.
+       */
+      const Function<spacedim> *function;
+
+      /**
+       * The time of @p function at which the values, gradients and hessians
+       * above were computed.
+       */
+      double time;
     };
 
     /**
@@ -506,6 +535,13 @@ protected:
      * and (ii) that these objects could not be used in a multithreaded context.
      */
     mutable std::vector<std::vector<EnrichmentValues> > enrichment;
+
+    /**
+     * The quadrature points on the real cell at which the data in
+     * @p enrichment was computed. If the next cell has the same points and
+     * the same enrichment functions, the stored values are reused.
+     */
+    mutable std::vector<Point<spacedim> > enrichment_points;
   };
 
   /**
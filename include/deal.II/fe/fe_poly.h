@@ -437,6 +437,28 @@ protected:
                              const unsigned int                                                n_q_points,
                              const unsigned int                                                dof) const;
 
+  /**
+   * Transform the gradients of all shape functions on the reference cell,
+   * stored in @p fe_data for the quadrature points starting at @p offset, to
+   * the real cell. This is the covariant transformation $\nabla \phi_i =
+   * J^{-T} \hat \nabla \hat \phi_i$, which is applied directly with the
+   * inverse Jacobians computed by the mapping (we request
+   * #update_inverse_jacobians together with the gradients for this purpose).
+   * Compared to calling Mapping::transform() for one shape function at a
+   * time, this avoids a virtual function call per shape function and keeps
+   * the inverse Jacobian of a quadrature point in registers for the whole
+   * loop over all shape functions. If the mapping did not provide the
+   * inverse Jacobians, Mapping::transform() is used instead.
+   */
+  void
+  transform_gradients (const InternalData                                               &fe_data,
+                       const unsigned int                                                offset,
+                       const unsigned int                                                n_q_points,
+                       const Mapping<dim,spacedim>                                      &mapping,
+                       const typename Mapping<dim,spacedim>::InternalDataBase           &mapping_internal,
+                       const internal::FEValues::MappingRelatedData<dim,spacedim>       &mapping_data,
+                       internal::FEValues::FiniteElementRelatedData<dim,spacedim>       &output_data) const;
+
   /**
    * The polynomial space. Its type is given by the template parameter
    * PolynomialType.
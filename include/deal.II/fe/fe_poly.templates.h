@@ -193,7 +193,8 @@ FE_Poly<PolynomialType,dim,spacedim>::requires_update_flags (const UpdateFlags f
   if (flags & update_values)
     out |= update_values;
   if (flags & update_gradients)
-    out |= update_gradients | update_covariant_transformation;
+    out |= update_gradients | update_covariant_transformation
+           | update_inverse_jacobians;
   if (flags & update_hessians)
     out |= update_hessians | update_covariant_transformation
            | update_gradients | update_jacobian_pushed_forward_grads;
@@ -240,11 +241,8 @@ fill_fe_values (const typename Triangulation<dim,spacedim>::cell_iterator &,
   // for values since we already emplaced them into output_data when
   // we were in get_data()
   if (flags & update_gradients && cell_similarity != CellSimilarity::translation)
-    for (unsigned int k=0; k<this->dofs_per_cell; ++k)
-      mapping.transform (make_array_view(fe_data.shape_gradients, k),
-                         mapping_covariant,
-                         mapping_internal,
-                         make_array_view(output_data.shape_gradients, k));
+    transform_gradients (fe_data, 0, quadrature.size(), mapping,
+                         mapping_internal, mapping_data, output_data);
 
   if (flags & update_hessians && cell_similarity != CellSimilarity::translation)
     {
@@ -318,11 +316,8 @@ fill_fe_face_values (const typename Triangulation<dim,spacedim>::cell_iterator
         output_data.shape_values(k,i) = fe_data.shape_values[k][i+offset];
 
   if (flags & update_gradients)
-    for (unsigned int k=0; k<this->dofs_per_cell; ++k)
-      mapping.transform (make_array_view(fe_data.shape_gradients, k, offset, quadrature.size()),
-                         mapping_covariant,
-                         mapping_internal,
-                         make_array_view(output_data.shape_gradients, k));
+    transform_gradients (fe_data, offset, quadrature.size(), mapping,
+                         mapping_internal, mapping_data, output_data);
 
   if (flags & update_hessians)
     {
@@ -398,11 +393,8 @@ fill_fe_subface_values (const typename Triangulation<dim,spacedim>::cell_iterato
         output_data.shape_values(k,i) = fe_data.shape_values[k][i+offset];
 
   if (flags & update_gradients)
-    for (unsigned int k=0; k<this->dofs_per_cell; ++k)
-      mapping.transform (make_array_view(fe_data.shape_gradients, k, offset, quadrature.size()),
-                         mapping_covariant,
-                         mapping_internal,
-                         make_array_view(output_data.shape_gradients, k));
+    transform_gradients (fe_data, offset, quadrature.size(), mapping,
+                         mapping_internal, mapping_data, output_data);
 
   if (flags & update_hessians)
     {
@@ -435,6 +427,49 @@ fill_fe_subface_values (const typename Triangulation<dim,spacedim>::cell_iterato
 
 
 
+template <class PolynomialType, int dim, int spacedim>
+inline void
+FE_Poly<PolynomialType,dim,spacedim>::
+transform_gradients (const InternalData                                               &fe_data,
+                     const unsigned int                                                offset,
+                     const unsigned int                                                n_q_points,
+                     const Mapping<dim,spacedim>                                      &mapping,
+                     const typename Mapping<dim,spacedim>::InternalDataBase           &mapping_internal,
+                     const internal::FEValues::MappingRelatedData<dim,spacedim>       &mapping_data,
+                     internal::FEValues::FiniteElementRelatedData<dim,spacedim>       &output_data) const
+{
+  if (mapping_data.inverse_jacobians.size() != n_q_points)
+    {
+      for (unsigned int k=0; k<this->dofs_per_cell; ++k)
+        mapping.transform (make_array_view(fe_data.shape_gradients, k, offset, n_q_points),
+                           mapping_covariant,
+                           mapping_internal,
+                           make_array_view(output_data.shape_gradients, k));
+      return;
+    }
+
+  // the inverse Jacobian holds the derivatives of the reference
+  // coordinates with respect to the real coordinates, so the real
+  // gradient is the sum of its rows weighted by the reference gradient
+  for (unsigned int k=0; k<this->dofs_per_cell; ++k)
+    {
+      const Tensor<1,dim> *reference_gradients = &fe_data.shape_gradients[k][offset];
+      Tensor<1,spacedim> *real_gradients = &output_data.shape_gradients[k][0];
+      for (unsigned int q=0; q<n_q_points; ++q)
+        {
+          const DerivativeForm<1,spacedim,dim> &inverse_jacobian =
+            mapping_data.inverse_jacobians[q];
+          Tensor<1,spacedim> gradient;
+          for (unsigned int e=0; e<dim; ++e)
+            for (unsigned int d=0; d<spacedim; ++d)
+              gradient[d] += reference_gradients[q][e] * inverse_jacobian[e][d];
+          real_gradients[q] = gradient;
+        }
+    }
+}
+
+
+
 template <class PolynomialType, int dim, int spacedim>
 inline void
 FE_Poly<PolynomialType,dim,spacedim>::
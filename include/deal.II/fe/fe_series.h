@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2016 by the deal.II authors
+// Copyright (C) 2016 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -24,12 +24,16 @@
 #include <deal.II/base/table.h>
 #include <deal.II/base/table_indices.h>
 #include <deal.II/base/tensor.h>
+#include <deal.II/base/work_stream.h>
+#include <deal.II/hp/dof_handler.h>
 #include <deal.II/hp/fe_collection.h>
 #include <deal.II/hp/q_collection.h>
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/numerics/vector_tools.h>
 
+#include <complex>
+#include <functional>
 #include <vector>
 #include <string>
 #include <memory>
@@ -107,6 +111,41 @@ namespace FESeries
                    const unsigned int                cell_active_fe_index,
                    Table<dim,std::complex<double> > &fourier_coefficients);
 
+    /**
+     * Same as above, but without calculating missing transformation
+     * matrices on the fly. This requires a previous call to
+     * precalculate_all_transformation_matrices(). As this function does not
+     * modify the object, it can be called from several threads at once.
+     */
+    void calculate(const dealii::Vector<double>     &local_dof_values,
+                   const unsigned int                cell_active_fe_index,
+                   Table<dim,std::complex<double> > &fourier_coefficients) const;
+
+    /**
+     * Calculate the Fourier coefficients of the field described by
+     * @p solution on all locally owned active cells of @p dof_handler in one
+     * call, and pass them on to @p cell_operation together with the cell
+     * they belong to. The cells are worked on in parallel with WorkStream,
+     * so @p cell_operation must be safe to be called from several threads
+     * at once, which is e.g. the case if it only writes into the entry
+     * of an output vector indexed by the cell's active_cell_index().
+     *
+     * The transformation matrices are calculated for all elements of the
+     * hp::FECollection before the cells are visited.
+     */
+    template <typename VectorType>
+    void calculate(const hp::DoFHandler<dim> &dof_handler,
+                   const VectorType          &solution,
+                   const std::function<void (const typename hp::DoFHandler<dim>::active_cell_iterator &,
+                                             const Table<dim,std::complex<double> > &)> &cell_operation);
+
+    /**
+     * Calculate the transformation matrices for all elements of the
+     * hp::FECollection, with one task per element. The matrices are only
+     * computed for those elements for which this has not happened before.
+     */
+    void precalculate_all_transformation_matrices();
+
   private:
     /**
      * hp::FECollection for which transformation matrices will be calculated.
@@ -134,11 +173,6 @@ namespace FESeries
      */
     std::vector<FullMatrix<std::complex<double> > > fourier_transform_matrices;
 
-    /**
-     * Auxiliary vector to store unrolled coefficients.
-     */
-    std::vector<std::complex<double> > unrolled_coefficients;
-
   };
 
   /**
@@ -208,6 +242,40 @@ namespace FESeries
                    const unsigned int            cell_active_fe_index,
                    Table<dim,double>            &legendre_coefficients);
 
+    /**
+     * Same as above, but without calculating missing transformation
+     * matrices on the fly. This requires a previous call to
+     * precalculate_all_transformation_matrices(). As this function does not
+     * modify the object, it can be called from several threads at once.
+     */
+    void calculate(const dealii::Vector<double> &local_dof_values,
+                   const unsigned int            cell_active_fe_index,
+                   Table<dim,double>            &legendre_coefficients) const;
+
+    /**
+     * Calculate the Legendre coefficients of the field described by
+     * @p solution on all locally owned active cells of @p dof_handler in one
+     * call, and pass them on to @p cell_operation together with the cell
+     * they belong to. The cells are worked on in parallel with WorkStream,
+     * so @p cell_operation must be safe to be called from several threads
+     * at once.
+     *
+     * The transformation matrices are calculated for all elements of the
+     * hp::FECollection before the cells are visited.
+     */
+    template <typename VectorType>
+    void calculate(const hp::DoFHandler<dim> &dof_handler,
+                   const VectorType          &solution,
+                   const std::function<void (const typename hp::DoFHandler<dim>::active_cell_iterator &,
+                                             const Table<dim,double> &)> &cell_operation);
+
+    /**
+     * Calculate the transformation matrices for all elements of the
+     * hp::FECollection, with one task per element. The matrices are only
+     * computed for those elements for which this has not happened before.
+     */
+    void precalculate_all_transformation_matrices();
+
   private:
     /**
      * Number of coefficients in each direction
@@ -235,11 +303,6 @@ namespace FESeries
      */
     std::vector<FullMatrix<double> > legendre_transform_matrices;
 
-    /**
-     * Auxiliary vector to store unrolled coefficients.
-     */
-    std::vector<double> unrolled_coefficients;
-
   };
 
 
@@ -273,6 +336,48 @@ namespace FESeries
   std::pair<double,double> linear_regression(const std::vector<double> &x,
                                              const std::vector<double> &y);
 
+
+
+  /**
+   * Estimate the smoothness of the finite element field @p solution on each
+   * active cell of @p dof_handler from the decay of its Fourier coefficients,
+   * in the way described in step-27: On each cell, the largest absolute
+   * value of the coefficients $c_{\bf k}$ with equal $|{\bf k}|$ is fitted
+   * against $(2\pi|{\bf k}|)^{-\mu-d/2}$ by linear regression in a
+   * logarithmic scale, omitting ${\bf k}=0$. The exponent $\mu$ is
+   * written into @p smoothness_indicators, indexed by the active cell index.
+   * Entries of cells that are not locally owned are set to zero.
+   *
+   * The cells are processed in parallel by Fourier::calculate(), using
+   * transformation matrices that are set up once for all elements of the
+   * hp::FECollection.
+   */
+  template <int dim, typename VectorType>
+  void estimate_smoothness(Fourier<dim>              &fourier,
+                           const hp::DoFHandler<dim> &dof_handler,
+                           const VectorType          &solution,
+                           Vector<float>             &smoothness_indicators);
+
+  /**
+   * Estimate the smoothness of the finite element field @p solution on each
+   * active cell of @p dof_handler from the decay of its Legendre
+   * coefficients: On each cell, the largest absolute value of the
+   * coefficients $c_{\bf k}$ with equal $\max_d k_d$ is fitted against
+   * $C \exp(-\sigma \max_d k_d)$ by linear regression in a logarithmic
+   * scale. The decay rate $\sigma$ is written into @p smoothness_indicators,
+   * indexed by the active cell index, where larger values indicate a smoother
+   * solution. Entries of cells that are not locally owned are set to zero.
+   *
+   * The cells are processed in parallel by Legendre::calculate(), using
+   * transformation matrices that are set up once for all elements of the
+   * hp::FECollection.
+   */
+  template <int dim, typename VectorType>
+  void estimate_smoothness(Legendre<dim>             &legendre,
+                           const hp::DoFHandler<dim> &dof_handler,
+                           const VectorType          &solution,
+                           Vector<float>             &smoothness_indicators);
+
 }
 
 /*@}*/
@@ -415,6 +520,183 @@ FESeries::process_coefficients(const Table<dim,T> &coefficients,
 }
 
 
+
+namespace internal
+{
+  namespace FESeriesImplementation
+  {
+    template <int dim, typename CoefficientType>
+    struct ScratchData
+    {
+      ScratchData (const TableIndices<dim> &n_coefficients)
+      {
+        coefficients.reinit (n_coefficients);
+      }
+
+      dealii::Vector<double>              local_dof_values;
+      dealii::Table<dim,CoefficientType>  coefficients;
+    };
+
+
+
+    template <int dim, typename SeriesType, typename CoefficientType, typename VectorType>
+    void
+    calculate_on_all_cells (const SeriesType          &series,
+                            const unsigned int         size_in_each_direction,
+                            const dealii::hp::DoFHandler<dim> &dof_handler,
+                            const VectorType          &solution,
+                            const std::function<void (const typename dealii::hp::DoFHandler<dim>::active_cell_iterator &,
+                                                      const dealii::Table<dim,CoefficientType> &)> &cell_operation)
+    {
+      typedef typename dealii::hp::DoFHandler<dim>::active_cell_iterator Iterator;
+
+      TableIndices<dim> n_coefficients;
+      for (unsigned int d=0; d<dim; ++d)
+        n_coefficients[d] = size_in_each_direction;
+
+      // each cell writes its result through cell_operation, so we need
+      // neither copy data nor a copier stage
+      auto worker = [&](const Iterator &cell,
+                        ScratchData<dim,CoefficientType> &scratch,
+                        int &)
+      {
+        if (cell->is_locally_owned() == false)
+          return;
+
+        scratch.local_dof_values.reinit (cell->get_fe().dofs_per_cell, true);
+        cell->get_dof_values (solution, scratch.local_dof_values);
+        series.calculate (scratch.local_dof_values, cell->active_fe_index(),
+                          scratch.coefficients);
+        cell_operation (cell, scratch.coefficients);
+      };
+
+      WorkStream::run (dof_handler.begin_active(),
+                       static_cast<Iterator>(dof_handler.end()),
+                       worker,
+                       std::function<void (const int &)>(),
+                       ScratchData<dim,CoefficientType>(n_coefficients),
+                       /* dummy CopyData object = */ 0,
+                       2*MultithreadInfo::n_threads(),
+                       /* chunk_size = */ 32);
+    }
+  }
+}
+
+
+
+template <int dim>
+template <typename VectorType>
+void
+FESeries::Fourier<dim>::calculate
+(const hp::DoFHandler<dim> &dof_handler,
+ const VectorType          &solution,
+ const std::function<void (const typename hp::DoFHandler<dim>::active_cell_iterator &,
+                           const Table<dim,std::complex<double> > &)> &cell_operation)
+{
+  precalculate_all_transformation_matrices();
+  const Fourier<dim> &series = *this;
+  internal::FESeriesImplementation::calculate_on_all_cells<dim,Fourier<dim>,std::complex<double> >
+  (series, k_vectors.size(0), dof_handler, solution, cell_operation);
+}
+
+
+
+template <int dim>
+template <typename VectorType>
+void
+FESeries::Legendre<dim>::calculate
+(const hp::DoFHandler<dim> &dof_handler,
+ const VectorType          &solution,
+ const std::function<void (const typename hp::DoFHandler<dim>::active_cell_iterator &,
+                           const Table<dim,double> &)> &cell_operation)
+{
+  precalculate_all_transformation_matrices();
+  const Legendre<dim> &series = *this;
+  internal::FESeriesImplementation::calculate_on_all_cells<dim,Legendre<dim>,double>
+  (series, N, dof_handler, solution, cell_operation);
+}
+
+
+
+template <int dim, typename VectorType>
+void
+FESeries::estimate_smoothness (Fourier<dim>              &fourier,
+                               const hp::DoFHandler<dim> &dof_handler,
+                               const VectorType          &solution,
+                               Vector<float>             &smoothness_indicators)
+{
+  smoothness_indicators.reinit (dof_handler.get_triangulation().n_active_cells());
+
+  // group the coefficients by |k|^2 and skip the constant mode
+  const std::function<std::pair<bool,unsigned int>(const TableIndices<dim> &)> predicate
+    = [](const TableIndices<dim> &indices)
+  {
+    unsigned int sum_of_squares = 0;
+    for (unsigned int d=0; d<dim; ++d)
+      sum_of_squares += indices[d]*indices[d];
+    return std::make_pair (sum_of_squares != 0, sum_of_squares);
+  };
+
+  fourier.calculate (dof_handler, solution,
+                     [&](const typename hp::DoFHandler<dim>::active_cell_iterator &cell,
+                         const Table<dim,std::complex<double> > &coefficients)
+  {
+    const std::pair<std::vector<unsigned int>,std::vector<double> > res
+      = process_coefficients<dim> (coefficients, predicate, VectorTools::Linfty_norm);
+
+    std::vector<double> ln_k (res.first.size()), ln_U_k (res.first.size());
+    for (unsigned int f=0; f<res.first.size(); ++f)
+      {
+        ln_k[f] = std::log (2.0*numbers::PI*std::sqrt(1.*res.first[f]));
+        ln_U_k[f] = std::log (res.second[f]);
+      }
+
+    const std::pair<double,double> fit = linear_regression (ln_k, ln_U_k);
+    smoothness_indicators(cell->active_cell_index()) = -fit.first - 1.*dim/2;
+  });
+}
+
+
+
+template <int dim, typename VectorType>
+void
+FESeries::estimate_smoothness (Legendre<dim>             &legendre,
+                               const hp::DoFHandler<dim> &dof_handler,
+                               const VectorType          &solution,
+                               Vector<float>             &smoothness_indicators)
+{
+  smoothness_indicators.reinit (dof_handler.get_triangulation().n_active_cells());
+
+  // group the coefficients by the largest index
+  const std::function<std::pair<bool,unsigned int>(const TableIndices<dim> &)> predicate
+    = [](const TableIndices<dim> &indices)
+  {
+    unsigned int max_index = 0;
+    for (unsigned int d=0; d<dim; ++d)
+      max_index = std::max (max_index, indices[d]);
+    return std::make_pair (true, max_index);
+  };
+
+  legendre.calculate (dof_handler, solution,
+                      [&](const typename hp::DoFHandler<dim>::active_cell_iterator &cell,
+                          const Table<dim,double> &coefficients)
+  {
+    const std::pair<std::vector<unsigned int>,std::vector<double> > res
+      = process_coefficients<dim> (coefficients, predicate, VectorTools::Linfty_norm);
+
+    std::vector<double> k (res.first.size()), ln_U_k (res.first.size());
+    for (unsigned int f=0; f<res.first.size(); ++f)
+      {
+        k[f] = res.first[f];
+        ln_U_k[f] = std::log (res.second[f]);
+      }
+
+    const std::pair<double,double> fit = linear_regression (k, ln_U_k);
+    smoothness_indicators(cell->active_cell_index()) = -fit.first;
+  });
+}
+
+
 #endif // DOXYGEN
 
 DEAL_II_NAMESPACE_CLOSE
@@ -1061,6 +1061,40 @@ private:
    */
   std::vector<std::vector<std::size_t>> generalized_support_points_index_table;
 
+  /**
+   * A block of consecutive rows of the shape function tables (values,
+   * gradients, etc.) of a base element that is copied into a block of
+   * consecutive rows of the tables of this element in compute_fill(). The
+   * rows correspond to the nonzero components of the shape functions, i.e.,
+   * non-primitive shape functions occupy several rows.
+   */
+  struct ShapeFunctionCopyRange
+  {
+    /**
+     * The first row in the tables of this element.
+     */
+    unsigned int system_row;
+
+    /**
+     * The first row in the tables of the base element.
+     */
+    unsigned int base_row;
+
+    /**
+     * The number of rows to be copied.
+     */
+    unsigned int n_rows;
+  };
+
+  /**
+   * For each base element, the blocks of rows of its shape function tables
+   * that make up the tables of this element, with adjacent blocks merged.
+   * This table is filled by initialize() and lets compute_fill() copy the
+   * output of the base elements without searching through all shape
+   * functions of the composed element.
+   */
+  std::vector<std::vector<ShapeFunctionCopyRange> > base_to_system_copy_ranges;
+
   /**
    * This function is simply singled out of the constructors since there are
    * several of them. It sets up the index table for the system as well as @p
@@ -1284,6 +1284,65 @@ namespace FETools
   void add_fe_name (const std::string &name,
                     const FEFactoryBase<dim,spacedim> *factory);
 
+  /**
+   * A process-wide cache for matrices of finite elements that are expensive
+   * to compute, such as the prolongation and restriction matrices of
+   * FE_Q and FE_DGQ. These elements compute their matrices only once per
+   * program run for each name as returned by FiniteElement::get_name()
+   * (which identifies the element type, the space dimensions, the degree
+   * and the support points), and copy them from the cache whenever another
+   * object of the same element, e.g. within an hp::FECollection or an
+   * FESystem, requests them.
+   *
+   * Optionally, the matrices can also be stored on disk by calling
+   * set_directory(). Matrices that are not yet in memory are then read from
+   * the files in that directory, and newly computed matrices are written to
+   * it. This allows to compute the matrices once for all processes of a
+   * parallel computation and all subsequent runs rather than on every
+   * process of every run. The files are written in binary format and
+   * include only the name of the matrices, so the directory should only be
+   * shared between runs on machines with the same binary representation of
+   * <tt>double</tt>.
+   *
+   * Keys containing the string <tt>QUnknownNodes</tt>, which is what
+   * elements with support points that can not be described by their name
+   * put into their name, are never cached.
+   *
+   * All functions in this namespace are thread-safe.
+   */
+  namespace MatrixCache
+  {
+    /**
+     * Set a directory in which matrices are stored and from which they are
+     * read. The directory must exist. An empty string, which is the
+     * default, disables the on-disk cache.
+     */
+    void set_directory (const std::string &directory);
+
+    /**
+     * Look up the matrices stored under @p key, first in memory and then,
+     * if a directory has been set, on disk. If found, copy them into
+     * @p matrices and return <tt>true</tt>; otherwise, return
+     * <tt>false</tt> and leave @p matrices untouched.
+     */
+    bool get (const std::string               &key,
+              std::vector<FullMatrix<double> > &matrices);
+
+    /**
+     * Store the given matrices under @p key, unless another thread has
+     * already done so, and write them to the directory set by
+     * set_directory() in case there is no such file yet.
+     */
+    void store (const std::string                     &key,
+                const std::vector<FullMatrix<double> > &matrices);
+
+    /**
+     * Remove all matrices from the in-memory cache. Files on disk are not
+     * touched.
+     */
+    void clear ();
+  }
+
   /**
    * The string used for get_fe_by_name() cannot be translated to a finite
    * element.
@@ -34,6 +34,7 @@
 #include <deal.II/lac/trilinos_vector.h>
 #include <deal.II/lac/trilinos_parallel_block_vector.h>
 
+#include <map>
 #include <queue>
 
 DEAL_II_NAMESPACE_OPEN
@@ -140,11 +141,13 @@ namespace FETools
                   sizeof(typename dealii::internal::p4est::types<dim>::quadrant));    // quadrant
         }
 
+        // append the data of this cell to the given buffer
         void pack_data (std::vector<char> &buffer) const
         {
-          buffer.resize(bytes_for_buffer());
+          const std::size_t offset = buffer.size();
+          buffer.resize(offset + bytes_for_buffer());
 
-          char *ptr = buffer.data();
+          char *ptr = buffer.data() + offset;
 
           unsigned int n_dofs = dof_values.size ();
           std::memcpy(ptr, &n_dofs, sizeof(unsigned int));
@@ -163,9 +166,10 @@ namespace FETools
                   ExcInternalError());
         }
 
-        void unpack_data (const std::vector<char> &buffer)
+        // read the data of one cell from the given position of a buffer
+        // and advance the position to the data of the next cell
+        void unpack_data (const char *&ptr)
         {
-          const char *ptr = buffer.data();
           unsigned int n_dofs;
           memcpy(&n_dofs, ptr, sizeof(unsigned int));
           ptr += sizeof(unsigned int);
@@ -179,9 +183,6 @@ namespace FETools
 
           std::memcpy(&quadrant,ptr,sizeof(typename dealii::internal::p4est::types<dim>::quadrant));
           ptr += sizeof(typename dealii::internal::p4est::types<dim>::quadrant);
-
-          Assert (ptr == buffer.data()+buffer.size(),
-                  ExcInternalError());
         }
       };
 
@@ -1059,31 +1060,33 @@ namespace FETools
     send_cells (const std::vector<CellData>  &cells_to_send,
                 std::vector<CellData>        &received_cells) const
     {
-      std::vector<std::vector<char> > sendbuffers (cells_to_send.size());
-      std::vector<std::vector<char> >::iterator buffer = sendbuffers.begin();
-      std::vector<MPI_Request> requests (cells_to_send.size());
-      std::vector<unsigned int> destinations;
+      // collect all cells for the same receiver in one buffer, such that
+      // only a single message is sent to each process
+      std::map<unsigned int, std::vector<char> > sendbuffers;
+      for (typename std::vector<CellData>::const_iterator it=cells_to_send.begin();
+           it!=cells_to_send.end();
+           ++it)
+        it->pack_data (sendbuffers[it->receiver]);
 
       // send data
+      std::vector<MPI_Request> requests (sendbuffers.size());
+      std::vector<unsigned int> destinations;
+      destinations.reserve (sendbuffers.size());
       unsigned int idx=0;
-      for (typename std::vector<CellData>::const_iterator it=cells_to_send.begin();
-           it!=cells_to_send.end();
-           ++it, ++idx)
+      for (std::map<unsigned int, std::vector<char> >::iterator
+           buffer = sendbuffers.begin(); buffer != sendbuffers.end(); ++buffer, ++idx)
         {
-          destinations.push_back (it->receiver);
+          destinations.push_back (buffer->first);
 
-          it->pack_data (*buffer);
-          const int ierr = MPI_Isend (&(*buffer)[0], buffer->size(),
+          const int ierr = MPI_Isend (buffer->second.data(), buffer->second.size(),
                                       MPI_BYTE,
-                                      it->receiver,
+                                      buffer->first,
                                       round,
                                       communicator,
                                       &requests[idx]);
           AssertThrowMPI(ierr);
         }
 
-      Assert(destinations.size()==cells_to_send.size(), ExcInternalError());
-
       std::vector<unsigned int> senders
         = Utilities::MPI::compute_point_to_point_communication_pattern(communicator, destinations);
 
@@ -1104,14 +1107,19 @@ namespace FETools
           ierr = MPI_Recv (buf, len, MPI_BYTE, status.MPI_SOURCE, status.MPI_TAG, communicator, &status);
           AssertThrowMPI(ierr);
 
-          cell_data.unpack_data (receive);
+          const char *ptr = receive.data();
+          while (ptr != receive.data() + receive.size())
+            {
+              Assert (ptr < receive.data() + receive.size(), ExcInternalError());
+              cell_data.unpack_data (ptr);
 
-          // this process has to send this
-          // cell back to the sender
-          // the receiver is the old sender
-          cell_data.receiver = status.MPI_SOURCE;
+              // this process has to send this
+              // cell back to the sender
+              // the receiver is the old sender
+              cell_data.receiver = status.MPI_SOURCE;
 
-          received_cells.push_back (cell_data);
+              received_cells.push_back (cell_data);
+            }
         }
 
       if (requests.size () > 0)
@@ -1235,35 +1243,39 @@ namespace FETools
           // if there are no cells to compute and no new needs, stop
           ready = Utilities::MPI::sum (new_needs.size () + cells_to_compute.size (), communicator);
 
+          // store computed cells...
           for (typename std::vector<CellData>::const_iterator comp=computed_cells.begin ();
                comp != computed_cells.end ();
                ++comp)
-            {
-              // store computed cells...
-              cell_data_insert (*comp, available_cells);
+            cell_data_insert (*comp, available_cells);
 
-              // ...and generate a vector of computed cells with correct
-              // receivers, then delete this received need from the list
-              typename std::vector<CellData>::iterator recv=received_needs.begin();
-              while (recv != received_needs.end())
-                {
-                  if (dealii::internal::p4est::quadrant_is_equal<dim>(recv->quadrant, comp->quadrant))
-                    {
-                      recv->dof_values = comp->dof_values;
-                      cells_to_send.push_back (*recv);
-                      received_needs.erase (recv);
-                      recv = received_needs.begin();
-                    }
-                  else
-                    ++recv;
-                }
-            }
+          // ...and generate a vector of computed cells with correct
+          // receivers, then delete the answered needs from the list. the
+          // list of computed cells is sorted, so we can look up each need
+          // rather than going through all needs for each computed cell
+          {
+            typename std::vector<CellData>::iterator unanswered = received_needs.begin();
+            for (typename std::vector<CellData>::iterator recv=received_needs.begin();
+                 recv != received_needs.end(); ++recv)
+              {
+                const int pos = cell_data_search (*recv, computed_cells);
+                if (pos >= 0)
+                  {
+                    recv->dof_values = computed_cells[pos].dof_values;
+                    cells_to_send.push_back (*recv);
+                  }
+                else
+                  *unanswered++ = *recv;
+              }
+            received_needs.erase (unanswered, received_needs.end());
+          }
 
           // increase the round counter, such that we are sure to only send
           // and receive data from the correct call
           ++round;
 
           send_cells (cells_to_send, received_cells);
+          cells_to_send.clear ();
 
           // store received cell_data
           for (typename std::vector<CellData>::const_iterator recv=received_cells.begin ();
@@ -1272,6 +1284,7 @@ namespace FETools
             {
               cell_data_insert (*recv, available_cells);
             }
+          received_cells.clear ();
 
           // increase the round counter, such that we are sure to only send
           // and receive data from the correct call
@@ -21,6 +21,7 @@
 #include <deal.II/base/qprojector.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/work_stream.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/la_vector.h>
 #include <deal.II/lac/block_vector.h>
@@ -53,6 +54,72 @@ DEAL_II_NAMESPACE_OPEN
 
 namespace FETools
 {
+  namespace internal
+  {
+    /**
+     * Whether reading elements from a vector of the given type from
+     * several threads at the same time is allowed.
+     */
+    template <typename VectorType>
+    struct ThreadSafeReadAccess
+    {
+      static const bool value = false;
+    };
+
+    template <typename Number>
+    struct ThreadSafeReadAccess<dealii::Vector<Number> >
+    {
+      static const bool value = true;
+    };
+
+    template <typename Number>
+    struct ThreadSafeReadAccess<dealii::BlockVector<Number> >
+    {
+      static const bool value = true;
+    };
+
+    template <typename Number>
+    struct ThreadSafeReadAccess<LinearAlgebra::distributed::Vector<Number> >
+    {
+      static const bool value = true;
+    };
+
+    template <typename Number>
+    struct ThreadSafeReadAccess<LinearAlgebra::distributed::BlockVector<Number> >
+    {
+      static const bool value = true;
+    };
+
+
+
+    /**
+     * Compute the interpolation matrix from @p fe1 to @p fe2, taking it
+     * from FETools::MatrixCache if it has been computed before.
+     */
+    template <int dim, int spacedim>
+    void
+    get_cached_interpolation_matrix (const FiniteElement<dim,spacedim> &fe1,
+                                     const FiniteElement<dim,spacedim> &fe2,
+                                     FullMatrix<double>                &interpolation_matrix)
+    {
+      const std::string cache_key = "interpolation:" + fe1.get_name() + ":" + fe2.get_name();
+      std::vector<FullMatrix<double> > cached_matrix;
+      if (MatrixCache::get (cache_key, cached_matrix))
+        {
+          AssertDimension (cached_matrix.size(), 1);
+          interpolation_matrix.swap (cached_matrix[0]);
+          return;
+        }
+
+      interpolation_matrix.reinit (fe2.dofs_per_cell, fe1.dofs_per_cell);
+      get_interpolation_matrix (fe1, fe2, interpolation_matrix);
+      MatrixCache::store (cache_key,
+                          std::vector<FullMatrix<double> >(1, interpolation_matrix));
+    }
+  }
+
+
+
   template <int dim, int spacedim,
             template <int, int> class DoFHandlerType1,
             template <int, int> class DoFHandlerType2,
@@ -102,35 +169,6 @@ namespace FETools
                       " index sets."));
 #endif
 
-    // allocate vectors at maximal
-    // size. will be reinited in inner
-    // cell, but Vector makes sure that
-    // this does not lead to
-    // reallocation of memory
-    Vector<typename OutVector::value_type> u1_local(DoFTools::max_dofs_per_cell(dof1));
-    Vector<typename OutVector::value_type> u2_local(DoFTools::max_dofs_per_cell(dof2));
-
-    // have a map for interpolation
-    // matrices. shared_ptr make sure
-    // that memory is released again
-    std::map<const FiniteElement<dim,spacedim> *,
-        std::map<const FiniteElement<dim,spacedim> *,
-        std::shared_ptr<FullMatrix<double> > > >
-        interpolation_matrices;
-
-    typename DoFHandlerType1<dim,spacedim>::active_cell_iterator cell1 = dof1.begin_active(),
-                                                                 endc1 = dof1.end();
-    typename DoFHandlerType2<dim,spacedim>::active_cell_iterator cell2 = dof2.begin_active(),
-                                                                 endc2 = dof2.end();
-    (void)endc2;
-
-    std::vector<types::global_dof_index> dofs;
-    dofs.reserve (DoFTools::max_dofs_per_cell (dof2));
-
-    u2 = 0;
-    OutVector touch_count(u2);
-    touch_count = 0;
-
     // for distributed triangulations,
     // we can only interpolate u1 on
     // a cell, which this processor owns,
@@ -138,78 +176,132 @@ namespace FETools
     const types::subdomain_id subdomain_id =
       dof1.get_triangulation().locally_owned_subdomain();
 
-    for (; cell1!=endc1; ++cell1, ++cell2)
-      if ((cell1->subdomain_id() == subdomain_id)
-          ||
-          (subdomain_id == numbers::invalid_subdomain_id))
-        {
-          Assert(cell1->get_fe().n_components() == cell2->get_fe().n_components(),
-                 ExcDimensionMismatch (cell1->get_fe().n_components(),
-                                       cell2->get_fe().n_components()));
-
-          // for continuous elements on
-          // grids with hanging nodes we
-          // need hanging node
-          // constraints. Consequently,
-          // if there are no constraints
-          // then hanging nodes are not
-          // allowed.
-          const bool hanging_nodes_not_allowed
-            = ((cell2->get_fe().dofs_per_vertex != 0) &&
-               (constraints.n_constraints() == 0));
-
-          if (hanging_nodes_not_allowed)
-            for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
-              Assert (cell1->at_boundary(face) ||
-                      cell1->neighbor(face)->level() == cell1->level(),
-                      ExcHangingNodesNotAllowed(0));
+    typedef typename DoFHandlerType1<dim,spacedim>::active_cell_iterator CellIterator1;
+    typedef typename DoFHandlerType2<dim,spacedim>::active_cell_iterator CellIterator2;
 
+    // set up the interpolation matrices for all pairs of elements that
+    // appear on our cells before the actual loop, such that the loop can
+    // run in parallel. the matrices only depend on the elements, so they
+    // are taken from the process-wide cache if possible
+    std::map<std::pair<const FiniteElement<dim,spacedim> *,
+        const FiniteElement<dim,spacedim> *>,
+        FullMatrix<double> > interpolation_matrices;
+    {
+      CellIterator2 cell2 = dof2.begin_active();
+      for (CellIterator1 cell1 = dof1.begin_active(); cell1!=dof1.end(); ++cell1, ++cell2)
+        if ((cell1->subdomain_id() == subdomain_id)
+            ||
+            (subdomain_id == numbers::invalid_subdomain_id))
+          {
+            const std::pair<const FiniteElement<dim,spacedim> *,
+                  const FiniteElement<dim,spacedim> *>
+                  fe_pair (&cell1->get_fe(), &cell2->get_fe());
+            if (interpolation_matrices.find(fe_pair) == interpolation_matrices.end())
+              internal::get_cached_interpolation_matrix (cell1->get_fe(), cell2->get_fe(),
+                                                         interpolation_matrices[fe_pair]);
+          }
+      // cell1 is at the end, so should
+      // be cell2
+      Assert (cell2 == dof2.end(), ExcInternalError());
+    }
 
-          const unsigned int dofs_per_cell1 = cell1->get_fe().dofs_per_cell;
-          const unsigned int dofs_per_cell2 = cell2->get_fe().dofs_per_cell;
-          u1_local.reinit (dofs_per_cell1);
-          u2_local.reinit (dofs_per_cell2);
-
-          // check if interpolation
-          // matrix for this particular
-          // pair of elements is already
-          // there
-          if (interpolation_matrices[&cell1->get_fe()][&cell2->get_fe()].get() == nullptr)
-            {
-              std::shared_ptr<FullMatrix<double> >
-              interpolation_matrix (new FullMatrix<double> (dofs_per_cell2,
-                                                            dofs_per_cell1));
-              interpolation_matrices[&cell1->get_fe()][&cell2->get_fe()]
-                = interpolation_matrix;
-
-              get_interpolation_matrix(cell1->get_fe(),
-                                       cell2->get_fe(),
-                                       *interpolation_matrix);
-            }
-
-          cell1->get_dof_values(u1, u1_local);
-          interpolation_matrices[&cell1->get_fe()][&cell2->get_fe()]
-          ->vmult(u2_local, u1_local);
+    u2 = 0;
+    OutVector touch_count(u2);
+    touch_count = 0;
 
-          dofs.resize (dofs_per_cell2);
-          cell2->get_dof_indices(dofs);
+    // the values of each cell are computed by the worker and added into
+    // u2 by the copier
+    struct CopyData
+    {
+      Vector<typename OutVector::value_type> u2_local;
+      std::vector<types::global_dof_index> dofs;
+    };
+    struct ScratchData
+    {
+      Vector<typename OutVector::value_type> u1_local;
+    };
 
-          for (unsigned int i=0; i<dofs_per_cell2; ++i)
+    auto worker = [&] (const CellIterator1 &cell1,
+                       ScratchData         &scratch,
+                       CopyData            &copy_data)
+    {
+      copy_data.dofs.clear();
+      if ((cell1->subdomain_id() != subdomain_id)
+          &&
+          (subdomain_id != numbers::invalid_subdomain_id))
+        return;
+
+      const CellIterator2 cell2 (&dof2.get_triangulation(), cell1->level(),
+                                 cell1->index(), &dof2);
+
+      Assert(cell1->get_fe().n_components() == cell2->get_fe().n_components(),
+             ExcDimensionMismatch (cell1->get_fe().n_components(),
+                                   cell2->get_fe().n_components()));
+
+      // for continuous elements on
+      // grids with hanging nodes we
+      // need hanging node
+      // constraints. Consequently,
+      // if there are no constraints
+      // then hanging nodes are not
+      // allowed.
+      const bool hanging_nodes_not_allowed
+        = ((cell2->get_fe().dofs_per_vertex != 0) &&
+           (constraints.n_constraints() == 0));
+
+      if (hanging_nodes_not_allowed)
+        for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
+          Assert (cell1->at_boundary(face) ||
+                  cell1->neighbor(face)->level() == cell1->level(),
+                  ExcHangingNodesNotAllowed(0));
+      (void)hanging_nodes_not_allowed;
+
+      const unsigned int dofs_per_cell1 = cell1->get_fe().dofs_per_cell;
+      const unsigned int dofs_per_cell2 = cell2->get_fe().dofs_per_cell;
+      scratch.u1_local.reinit (dofs_per_cell1);
+      copy_data.u2_local.reinit (dofs_per_cell2);
+
+      cell1->get_dof_values(u1, scratch.u1_local);
+      interpolation_matrices.find(std::make_pair(&cell1->get_fe(), &cell2->get_fe()))
+      ->second.vmult(copy_data.u2_local, scratch.u1_local);
+
+      copy_data.dofs.resize (dofs_per_cell2);
+      cell2->get_dof_indices(copy_data.dofs);
+    };
+
+    auto copier = [&] (const CopyData &copy_data)
+    {
+      for (unsigned int i=0; i<copy_data.dofs.size(); ++i)
+        {
+          // if dof is locally_owned
+          const types::global_dof_index gdi = copy_data.dofs[i];
+          if (u2_elements.is_element(gdi))
             {
-              // if dof is locally_owned
-              const types::global_dof_index gdi = dofs[i];
-              if (u2_elements.is_element(gdi))
-                {
-                  ::dealii::internal::ElementAccess<OutVector>::add(u2_local(i),
-                                                                    dofs[i], u2);
-                  ::dealii::internal::ElementAccess<OutVector>::add(1,
-                                                                    dofs[i], touch_count);
-                }
+              ::dealii::internal::ElementAccess<OutVector>::add(copy_data.u2_local(i),
+                                                                gdi, u2);
+              ::dealii::internal::ElementAccess<OutVector>::add(1,
+                                                                gdi, touch_count);
             }
         }
-    // cell1 is at the end, so should
-    // be cell2
-    Assert (cell2 == endc2, ExcInternalError());
+    };
+
+    ScratchData sample_scratch;
+    sample_scratch.u1_local.reinit (DoFTools::max_dofs_per_cell(dof1));
+    CopyData sample_copy;
+    sample_copy.u2_local.reinit (DoFTools::max_dofs_per_cell(dof2));
+    sample_copy.dofs.reserve (DoFTools::max_dofs_per_cell(dof2));
+
+    // reading from the vectors of PETSc and Trilinos is not thread-safe,
+    // so only run in parallel for the vectors of deal.II
+    if (internal::ThreadSafeReadAccess<InVector>::value)
+      WorkStream::run (dof1.begin_active(), dof1.end(), worker, copier,
+                       sample_scratch, sample_copy);
+    else
+      for (CellIterator1 cell1 = dof1.begin_active(); cell1!=dof1.end(); ++cell1)
+        {
+          worker (cell1, sample_scratch, sample_copy);
+          copier (sample_copy);
+        }
 
     u2.compress(VectorOperation::add);
     touch_count.compress(VectorOperation::add);
@@ -225,22 +317,23 @@ namespace FETools
     // for parallel vectors check,
     // if this component is owned by
     // this processor.
-    for (types::global_dof_index i=0; i<dof2.n_dofs(); ++i)
-      if (locally_owned_dofs.is_element(i))
-        {
-          Assert(static_cast<typename OutVector::value_type>(
-                   ::dealii::internal::ElementAccess<OutVector>::get(
-                     touch_count, i)) != typename OutVector::value_type(0),
-                 ExcInternalError());
-
-
-          const typename OutVector::value_type val
-            = ::dealii::internal::ElementAccess<OutVector>::get(
-                u2, i);
-          ::dealii::internal::ElementAccess<OutVector>::set(
-            val /
-            ::dealii::internal::ElementAccess<OutVector>::get(touch_count,i), i, u2);
-        }
+    for (IndexSet::ElementIterator index = locally_owned_dofs.begin();
+         index != locally_owned_dofs.end(); ++index)
+      {
+        const types::global_dof_index i = *index;
+        Assert(static_cast<typename OutVector::value_type>(
+                 ::dealii::internal::ElementAccess<OutVector>::get(
+                   touch_count, i)) != typename OutVector::value_type(0),
+               ExcInternalError());
+
+
+        const typename OutVector::value_type val
+          = ::dealii::internal::ElementAccess<OutVector>::get(
+              u2, i);
+        ::dealii::internal::ElementAccess<OutVector>::set(
+          val /
+          ::dealii::internal::ElementAccess<OutVector>::get(touch_count,i), i, u2);
+      }
 
     // finish the work on parallel vectors
     u2.compress(VectorOperation::insert);
@@ -37,6 +37,7 @@
 #include <deal.II/fe/mapping.h>
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <type_traits>
 
@@ -1749,6 +1750,37 @@ namespace internal
  * </ul>
  *
  *
+ * <h3>Computing quantities on demand</h3>
+ *
+ * All quantities requested by the update flags are computed in reinit()
+ * for all quadrature points and shape functions. If some of them are only
+ * needed on a few cells, for example second derivatives for a stabilization
+ * term that is only active on some cells, they can be excluded from this
+ * eager computation by set_lazy_update_flags(). They are then computed, for
+ * the present cell, on the first access to one of them, e.g. through
+ * shape_hessian() or get_function_hessians():
+ * @code
+ * FEValues<dim> fe_values (fe, quadrature,
+ *                          update_values | update_gradients |
+ *                          update_hessians | update_JxW_values);
+ * fe_values.set_lazy_update_flags (update_hessians);
+ * for (cell = dof_handler.begin_active(); ...)
+ *   {
+ *     fe_values.reinit (cell);   // values, gradients, JxW values
+ *     ...
+ *     if (cell_needs_stabilization)
+ *       ... fe_values.shape_hessian(i,q) ...   // hessians computed now
+ *   }
+ * @endcode
+ * On the first access, the mapping and the finite element compute all flags
+ * passed to the constructor for the present cell, i.e., the eager quantities
+ * are recomputed along with the lazy ones. This is cheaper than computing
+ * the lazy quantities on all cells as long as they are only needed on a
+ * minority of cells, and it replaces a second FEValues object with the
+ * additional flags. The lazy computation modifies the object from within
+ * the const access functions, so an FEValues object must not be accessed
+ * from several threads at the same time, which is the usual setup anyway.
+ *
  * <h3>Internals about the implementation</h3>
  *
  * The mechanisms by which this class work are discussed on the page on
@@ -1805,7 +1837,7 @@ public:
   /**
    * Destructor.
    */
-  ~FEValuesBase ();
+  virtual ~FEValuesBase ();
 
 
   /// @name ShapeAccess Access to shape function values. These fields are filled by the finite element.
@@ -2820,6 +2852,22 @@ public:
    */
   UpdateFlags get_update_flags () const;
 
+  /**
+   * Select those of the update flags passed to the constructor that are not
+   * computed by reinit() but only on the first access to one of the
+   * respective quantities on the present cell, see the section on computing
+   * quantities on demand in the documentation of this class. The flags
+   * required for computing the remaining flags are still computed in
+   * reinit(). Passing update_default restores the computation of all flags
+   * in reinit(). The setting applies from the next call to reinit().
+   */
+  void set_lazy_update_flags (const UpdateFlags lazy_flags);
+
+  /**
+   * Return the flags set by set_lazy_update_flags().
+   */
+  UpdateFlags get_lazy_update_flags () const;
+
   /**
    * Return a triangulation iterator to the current cell.
    */
@@ -3018,6 +3066,76 @@ protected:
    */
   UpdateFlags          update_flags;
 
+  /**
+   * The update flags handed to the initialize() function of the derived
+   * class, before adding the flags needed to compute them.
+   */
+  UpdateFlags          requested_update_flags;
+
+  /**
+   * The flags set by set_lazy_update_flags().
+   */
+  UpdateFlags          lazy_update_flags;
+
+  /**
+   * The flags of #update_flags that are not computed in reinit() because of
+   * set_lazy_update_flags().
+   */
+  UpdateFlags          deferred_update_flags;
+
+  /**
+   * The deferred flags that have not yet been computed on the present
+   * cell. Set to #deferred_update_flags in reinit() and cleared when the
+   * quantities are computed.
+   */
+  mutable UpdateFlags  pending_update_flags;
+
+  /**
+   * The internal data of the mapping and the finite element for all of
+   * #update_flags, used to compute the deferred flags on the present cell.
+   * Only set when #deferred_update_flags is not empty, in which case
+   * #mapping_data and #fe_data only compute the flags not deferred.
+   */
+  std::unique_ptr<typename Mapping<dim,spacedim>::InternalDataBase> lazy_mapping_data;
+
+  /**
+   * The internal data of the finite element for all of #update_flags, see
+   * #lazy_mapping_data.
+   */
+  std::unique_ptr<typename FiniteElement<dim,spacedim>::InternalDataBase> lazy_fe_data;
+
+  /**
+   * Make sure the quantities given by @p flags are available on the present
+   * cell, computing them if they are among the deferred flags not yet
+   * computed. Called by all functions accessing the computed quantities
+   * before checking their update flag.
+   */
+  void compute_on_demand (const UpdateFlags flags) const;
+
+  /**
+   * Compute all pending deferred flags on the present cell.
+   */
+  void compute_pending_update_flags () const;
+
+  /**
+   * Create the internal data of the mapping and the finite element that
+   * compute the given update flags, in the way the initialize() function of
+   * the derived class does. Used by set_lazy_update_flags().
+   */
+  virtual void
+  get_internal_data (const UpdateFlags                                                      flags,
+                     std::unique_ptr<typename Mapping<dim,spacedim>::InternalDataBase>       &mapping_data,
+                     std::unique_ptr<typename FiniteElement<dim,spacedim>::InternalDataBase> &fe_data) = 0;
+
+  /**
+   * Compute the quantities of the present cell (or face or subface) with the
+   * given internal data of the mapping and the finite element, ignoring the
+   * similarity to the previous cell. Used by compute_pending_update_flags().
+   */
+  virtual void
+  fill_present_cell (const typename Mapping<dim,spacedim>::InternalDataBase      &mapping_data,
+                     const typename FiniteElement<dim,spacedim>::InternalDataBase &fe_data) = 0;
+
   /**
    * Initialize some update flags. Called from the @p initialize functions of
    * derived classes, which are in turn called from their constructors.
@@ -3141,6 +3259,34 @@ public:
    */
   const Quadrature<dim> &get_quadrature () const;
 
+  /**
+   * Enable a cache for the data computed by the mapping and the finite
+   * element on up to @p max_n_cell_shapes different cell shapes. When
+   * reinit() is called for a cell that is a translation of a cell stored in
+   * the cache (in the sense of TriaAccessor::is_translation_of()), the
+   * Jacobians, JxW values, shape function gradients, etc. are copied from
+   * the cache instead of being recomputed, and only the quadrature points
+   * are shifted. This generalizes the detection of CellSimilarity, which
+   * only compares with the cell visited last, to meshes where cells of the
+   * same shape are not visited consecutively, e.g., mostly Cartesian
+   * meshes. Once the cache is full, the oldest entry is replaced. Passing
+   * zero disables the cache, which is the default.
+   *
+   * Cells are only stored in the cache if the mapping does not mark the
+   * computed data as specific to the current cell (as MappingQEulerian or
+   * MappingFEField do, for example), and if the finite element does not
+   * need the location of the quadrature points to compute its shape
+   * functions (as FE_DGPNonparametric does, for example). As for
+   * CellSimilarity, two cells with translated vertices are assumed to have
+   * the same shape also in the interior, which is not the case if a
+   * higher order mapping follows a curved manifold. The cache is only
+   * used if <tt>dim==spacedim</tt>.
+   *
+   * @note Results obtained from the cache can differ in the last digits
+   * from the ones computed on the cell itself.
+   */
+  void enable_geometry_cache (const unsigned int max_n_cell_shapes);
+
   /**
    * Determine an estimate for the memory consumption (in bytes) of this
    * object.
@@ -3181,6 +3327,64 @@ private:
    * independent of the actual type of the cell iterator.
    */
   void do_reinit ();
+
+  /**
+   * Create the internal data of the mapping and the finite element for the
+   * given flags.
+   */
+  virtual void
+  get_internal_data (const UpdateFlags                                                      flags,
+                     std::unique_ptr<typename Mapping<dim,spacedim>::InternalDataBase>       &mapping_data,
+                     std::unique_ptr<typename FiniteElement<dim,spacedim>::InternalDataBase> &fe_data);
+
+  /**
+   * Compute the quantities on the present cell with the given internal data.
+   */
+  virtual void
+  fill_present_cell (const typename Mapping<dim,spacedim>::InternalDataBase      &mapping_data,
+                     const typename FiniteElement<dim,spacedim>::InternalDataBase &fe_data);
+
+  /**
+   * The data of one cell shape stored by the cache set up with
+   * enable_geometry_cache(): the position of the vertices of the cell the
+   * data was computed on, and the output of the mapping and the finite
+   * element on that cell.
+   */
+  struct GeometryCacheEntry
+  {
+    std::array<Point<spacedim>,GeometryInfo<dim>::vertices_per_cell> vertices;
+    dealii::internal::FEValues::MappingRelatedData<dim, spacedim>       mapping_output;
+    dealii::internal::FEValues::FiniteElementRelatedData<dim, spacedim> finite_element_output;
+  };
+
+  /**
+   * If the present cell is a translation of a cell in the geometry cache,
+   * copy the cached data into the output fields of this object and return
+   * true. Otherwise, return false.
+   */
+  bool reinit_from_geometry_cache ();
+
+  /**
+   * Store the data just computed on the present cell in the geometry cache.
+   */
+  void store_in_geometry_cache ();
+
+  /**
+   * The maximal number of entries in #geometry_cache, as set by
+   * enable_geometry_cache().
+   */
+  unsigned int max_geometry_cache_size;
+
+  /**
+   * The entry of #geometry_cache to be replaced next once the cache is
+   * full.
+   */
+  unsigned int next_geometry_cache_entry;
+
+  /**
+   * The cells shapes stored by the geometry cache.
+   */
+  std::vector<GeometryCacheEntry> geometry_cache;
 };
 
 
@@ -3376,6 +3580,28 @@ private:
    * independent of the actual type of the cell iterator.
    */
   void do_reinit (const unsigned int face_no);
+
+  /**
+   * Create the internal data of the mapping and the finite element for the
+   * given flags.
+   */
+  virtual void
+  get_internal_data (const UpdateFlags                                                      flags,
+                     std::unique_ptr<typename Mapping<dim,spacedim>::InternalDataBase>       &mapping_data,
+                     std::unique_ptr<typename FiniteElement<dim,spacedim>::InternalDataBase> &fe_data);
+
+  /**
+   * Compute the quantities on the present face with the given internal data.
+   */
+  virtual void
+  fill_present_cell (const typename Mapping<dim,spacedim>::InternalDataBase      &mapping_data,
+                     const typename FiniteElement<dim,spacedim>::InternalDataBase &fe_data);
+
+  /**
+   * The number of the face within the present cell, as passed to the last
+   * call to reinit().
+   */
+  unsigned int present_face_no;
 };
 
 
@@ -3507,6 +3733,29 @@ private:
    */
   void do_reinit (const unsigned int face_no,
                   const unsigned int subface_no);
+
+  /**
+   * Create the internal data of the mapping and the finite element for the
+   * given flags.
+   */
+  virtual void
+  get_internal_data (const UpdateFlags                                                      flags,
+                     std::unique_ptr<typename Mapping<dim,spacedim>::InternalDataBase>       &mapping_data,
+                     std::unique_ptr<typename FiniteElement<dim,spacedim>::InternalDataBase> &fe_data);
+
+  /**
+   * Compute the quantities on the present subface with the given internal data.
+   */
+  virtual void
+  fill_present_cell (const typename Mapping<dim,spacedim>::InternalDataBase      &mapping_data,
+                     const typename FiniteElement<dim,spacedim>::InternalDataBase &fe_data);
+
+  /**
+   * The numbers of the face within the present cell and of the subface, as
+   * passed to the last call to reinit().
+   */
+  unsigned int present_face_no;
+  unsigned int present_subface_no;
 };
 
 
@@ -3525,6 +3774,7 @@ namespace FEValuesViews
   {
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_values);
     Assert (fe_values->update_flags & update_values,
             ((typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_values"))));
 
@@ -3550,6 +3800,7 @@ namespace FEValuesViews
   {
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
 
@@ -3576,6 +3827,7 @@ namespace FEValuesViews
   {
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_hessians);
     Assert (fe_values->update_flags & update_hessians,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_hessians")));
 
@@ -3601,6 +3853,7 @@ namespace FEValuesViews
   {
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_3rd_derivatives);
     Assert (fe_values->update_flags & update_3rd_derivatives,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_3rd_derivatives")));
 
@@ -3626,6 +3879,7 @@ namespace FEValuesViews
   {
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_values);
     Assert (fe_values->update_flags & update_values,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_values")));
 
@@ -3663,6 +3917,7 @@ namespace FEValuesViews
   {
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
 
@@ -3702,6 +3957,7 @@ namespace FEValuesViews
     // the case above
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
 
@@ -3736,6 +3992,7 @@ namespace FEValuesViews
 
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     // same as for the scalar case except that we have one more index
@@ -3873,6 +4130,7 @@ namespace FEValuesViews
     // the case above
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_hessians);
     Assert (fe_values->update_flags & update_hessians,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_hessians")));
 
@@ -3910,6 +4168,7 @@ namespace FEValuesViews
     // the case above
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_3rd_derivatives);
     Assert (fe_values->update_flags & update_3rd_derivatives,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_3rd_derivatives")));
 
@@ -4023,6 +4282,7 @@ namespace FEValuesViews
   {
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
 
@@ -4056,6 +4316,7 @@ namespace FEValuesViews
   {
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_values);
     Assert (fe_values->update_flags & update_values,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_values")));
 
@@ -4102,6 +4363,7 @@ namespace FEValuesViews
   {
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
 
@@ -4191,6 +4453,7 @@ namespace FEValuesViews
   {
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_values);
     Assert (fe_values->update_flags & update_values,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_values")));
 
@@ -4240,6 +4503,7 @@ namespace FEValuesViews
   {
     Assert (shape_function < fe_values->fe->dofs_per_cell,
             ExcIndexRange (shape_function, 0, fe_values->fe->dofs_per_cell));
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
 
@@ -4366,6 +4630,7 @@ FEValuesBase<dim,spacedim>::shape_value (const unsigned int i,
 {
   Assert (i < fe->dofs_per_cell,
           ExcIndexRange (i, 0, fe->dofs_per_cell));
+  this->compute_on_demand (update_values);
   Assert (this->update_flags & update_values,
           ExcAccessToUninitializedField("update_values"));
   Assert (fe->is_primitive (i),
@@ -4402,6 +4667,7 @@ FEValuesBase<dim,spacedim>::shape_value_component (const unsigned int i,
 {
   Assert (i < fe->dofs_per_cell,
           ExcIndexRange (i, 0, fe->dofs_per_cell));
+  this->compute_on_demand (update_values);
   Assert (this->update_flags & update_values,
           ExcAccessToUninitializedField("update_values"));
   Assert (component < fe->n_components(),
@@ -4431,6 +4697,7 @@ FEValuesBase<dim,spacedim>::shape_grad (const unsigned int i,
 {
   Assert (i < fe->dofs_per_cell,
           ExcIndexRange (i, 0, fe->dofs_per_cell));
+  this->compute_on_demand (update_gradients);
   Assert (this->update_flags & update_gradients,
           ExcAccessToUninitializedField("update_gradients"));
   Assert (fe->is_primitive (i),
@@ -4467,6 +4734,7 @@ FEValuesBase<dim,spacedim>::shape_grad_component (const unsigned int i,
 {
   Assert (i < fe->dofs_per_cell,
           ExcIndexRange (i, 0, fe->dofs_per_cell));
+  this->compute_on_demand (update_gradients);
   Assert (this->update_flags & update_gradients,
           ExcAccessToUninitializedField("update_gradients"));
   Assert (component < fe->n_components(),
@@ -4496,6 +4764,7 @@ FEValuesBase<dim,spacedim>::shape_hessian (const unsigned int i,
 {
   Assert (i < fe->dofs_per_cell,
           ExcIndexRange (i, 0, fe->dofs_per_cell));
+  this->compute_on_demand (update_hessians);
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
   Assert (fe->is_primitive (i),
@@ -4532,6 +4801,7 @@ FEValuesBase<dim,spacedim>::shape_hessian_component (const unsigned int i,
 {
   Assert (i < fe->dofs_per_cell,
           ExcIndexRange (i, 0, fe->dofs_per_cell));
+  this->compute_on_demand (update_hessians);
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
   Assert (component < fe->n_components(),
@@ -4561,6 +4831,7 @@ FEValuesBase<dim,spacedim>::shape_3rd_derivative (const unsigned int i,
 {
   Assert (i < fe->dofs_per_cell,
           ExcIndexRange (i, 0, fe->dofs_per_cell));
+  this->compute_on_demand (update_hessians);
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_3rd_derivatives"));
   Assert (fe->is_primitive (i),
@@ -4597,6 +4868,7 @@ FEValuesBase<dim,spacedim>::shape_3rd_derivative_component (const unsigned int i
 {
   Assert (i < fe->dofs_per_cell,
           ExcIndexRange (i, 0, fe->dofs_per_cell));
+  this->compute_on_demand (update_hessians);
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_3rd_derivatives"));
   Assert (component < fe->n_components(),
@@ -4647,11 +4919,33 @@ FEValuesBase<dim,spacedim>::get_update_flags () const
 
 
 
+template <int dim, int spacedim>
+inline
+UpdateFlags
+FEValuesBase<dim,spacedim>::get_lazy_update_flags () const
+{
+  return lazy_update_flags;
+}
+
+
+
+template <int dim, int spacedim>
+inline
+void
+FEValuesBase<dim,spacedim>::compute_on_demand (const UpdateFlags flags) const
+{
+  if (pending_update_flags & flags)
+    compute_pending_update_flags ();
+}
+
+
+
 template <int dim, int spacedim>
 inline
 const std::vector<Point<spacedim> > &
 FEValuesBase<dim,spacedim>::get_quadrature_points () const
 {
+  this->compute_on_demand (update_quadrature_points);
   Assert (this->update_flags & update_quadrature_points,
           ExcAccessToUninitializedField("update_quadrature_points"));
   return this->mapping_output.quadrature_points;
@@ -4664,6 +4958,7 @@ inline
 const std::vector<double> &
 FEValuesBase<dim,spacedim>::get_JxW_values () const
 {
+  this->compute_on_demand (update_JxW_values);
   Assert (this->update_flags & update_JxW_values,
           ExcAccessToUninitializedField("update_JxW_values"));
   return this->mapping_output.JxW_values;
@@ -4676,6 +4971,7 @@ inline
 const std::vector<DerivativeForm<1,dim,spacedim> > &
 FEValuesBase<dim,spacedim>::get_jacobians () const
 {
+  this->compute_on_demand (update_jacobians);
   Assert (this->update_flags & update_jacobians,
           ExcAccessToUninitializedField("update_jacobians"));
   return this->mapping_output.jacobians;
@@ -4688,6 +4984,7 @@ inline
 const std::vector<DerivativeForm<2,dim,spacedim> > &
 FEValuesBase<dim,spacedim>::get_jacobian_grads () const
 {
+  this->compute_on_demand (update_jacobian_grads);
   Assert (this->update_flags & update_jacobian_grads,
           ExcAccessToUninitializedField("update_jacobians_grads"));
   return this->mapping_output.jacobian_grads;
@@ -4700,6 +4997,7 @@ inline
 const Tensor<3,spacedim> &
 FEValuesBase<dim,spacedim>::jacobian_pushed_forward_grad (const unsigned int i) const
 {
+  this->compute_on_demand (update_jacobian_pushed_forward_grads);
   Assert (this->update_flags & update_jacobian_pushed_forward_grads,
           ExcAccessToUninitializedField("update_jacobian_pushed_forward_grads"));
   return this->mapping_output.jacobian_pushed_forward_grads[i];
@@ -4712,6 +5010,7 @@ inline
 const std::vector<Tensor<3,spacedim> > &
 FEValuesBase<dim,spacedim>::get_jacobian_pushed_forward_grads () const
 {
+  this->compute_on_demand (update_jacobian_pushed_forward_grads);
   Assert (this->update_flags & update_jacobian_pushed_forward_grads,
           ExcAccessToUninitializedField("update_jacobian_pushed_forward_grads"));
   return this->mapping_output.jacobian_pushed_forward_grads;
@@ -4724,6 +5023,7 @@ inline
 const DerivativeForm<3,dim,spacedim> &
 FEValuesBase<dim,spacedim>::jacobian_2nd_derivative (const unsigned int i) const
 {
+  this->compute_on_demand (update_jacobian_2nd_derivatives);
   Assert (this->update_flags & update_jacobian_2nd_derivatives,
           ExcAccessToUninitializedField("update_jacobian_2nd_derivatives"));
   return this->mapping_output.jacobian_2nd_derivatives[i];
@@ -4736,6 +5036,7 @@ inline
 const std::vector<DerivativeForm<3,dim,spacedim> > &
 FEValuesBase<dim,spacedim>::get_jacobian_2nd_derivatives () const
 {
+  this->compute_on_demand (update_jacobian_2nd_derivatives);
   Assert (this->update_flags & update_jacobian_2nd_derivatives,
           ExcAccessToUninitializedField("update_jacobian_2nd_derivatives"));
   return this->mapping_output.jacobian_2nd_derivatives;
@@ -4748,6 +5049,7 @@ inline
 const Tensor<4,spacedim> &
 FEValuesBase<dim,spacedim>::jacobian_pushed_forward_2nd_derivative (const unsigned int i) const
 {
+  this->compute_on_demand (update_jacobian_pushed_forward_2nd_derivatives);
   Assert (this->update_flags & update_jacobian_pushed_forward_2nd_derivatives,
           ExcAccessToUninitializedField("update_jacobian_pushed_forward_2nd_derivatives"));
   return this->mapping_output.jacobian_pushed_forward_2nd_derivatives[i];
@@ -4760,6 +5062,7 @@ inline
 const std::vector<Tensor<4,spacedim> > &
 FEValuesBase<dim,spacedim>::get_jacobian_pushed_forward_2nd_derivatives () const
 {
+  this->compute_on_demand (update_jacobian_pushed_forward_2nd_derivatives);
   Assert (this->update_flags & update_jacobian_pushed_forward_2nd_derivatives,
           ExcAccessToUninitializedField("update_jacobian_pushed_forward_2nd_derivatives"));
   return this->mapping_output.jacobian_pushed_forward_2nd_derivatives;
@@ -4772,6 +5075,7 @@ inline
 const DerivativeForm<4,dim,spacedim> &
 FEValuesBase<dim,spacedim>::jacobian_3rd_derivative (const unsigned int i) const
 {
+  this->compute_on_demand (update_jacobian_3rd_derivatives);
   Assert (this->update_flags & update_jacobian_3rd_derivatives,
           ExcAccessToUninitializedField("update_jacobian_3rd_derivatives"));
   return this->mapping_output.jacobian_3rd_derivatives[i];
@@ -4784,6 +5088,7 @@ inline
 const std::vector<DerivativeForm<4,dim,spacedim> > &
 FEValuesBase<dim,spacedim>::get_jacobian_3rd_derivatives () const
 {
+  this->compute_on_demand (update_jacobian_3rd_derivatives);
   Assert (this->update_flags & update_jacobian_3rd_derivatives,
           ExcAccessToUninitializedField("update_jacobian_3rd_derivatives"));
   return this->mapping_output.jacobian_3rd_derivatives;
@@ -4796,6 +5101,7 @@ inline
 const Tensor<5,spacedim> &
 FEValuesBase<dim,spacedim>::jacobian_pushed_forward_3rd_derivative (const unsigned int i) const
 {
+  this->compute_on_demand (update_jacobian_pushed_forward_3rd_derivatives);
   Assert (this->update_flags & update_jacobian_pushed_forward_3rd_derivatives,
           ExcAccessToUninitializedField("update_jacobian_pushed_forward_3rd_derivatives"));
   return this->mapping_output.jacobian_pushed_forward_3rd_derivatives[i];
@@ -4808,6 +5114,7 @@ inline
 const std::vector<Tensor<5,spacedim> > &
 FEValuesBase<dim,spacedim>::get_jacobian_pushed_forward_3rd_derivatives () const
 {
+  this->compute_on_demand (update_jacobian_pushed_forward_3rd_derivatives);
   Assert (this->update_flags & update_jacobian_pushed_forward_3rd_derivatives,
           ExcAccessToUninitializedField("update_jacobian_pushed_forward_3rd_derivatives"));
   return this->mapping_output.jacobian_pushed_forward_3rd_derivatives;
@@ -4819,6 +5126,7 @@ inline
 const std::vector<DerivativeForm<1,spacedim,dim> > &
 FEValuesBase<dim,spacedim>::get_inverse_jacobians () const
 {
+  this->compute_on_demand (update_inverse_jacobians);
   Assert (this->update_flags & update_inverse_jacobians,
           ExcAccessToUninitializedField("update_inverse_jacobians"));
   return this->mapping_output.inverse_jacobians;
@@ -4831,6 +5139,7 @@ inline
 const Point<spacedim> &
 FEValuesBase<dim,spacedim>::quadrature_point (const unsigned int i) const
 {
+  this->compute_on_demand (update_quadrature_points);
   Assert (this->update_flags & update_quadrature_points,
           ExcAccessToUninitializedField("update_quadrature_points"));
   Assert (i<this->mapping_output.quadrature_points.size(),
@@ -4847,6 +5156,7 @@ inline
 double
 FEValuesBase<dim,spacedim>::JxW (const unsigned int i) const
 {
+  this->compute_on_demand (update_JxW_values);
   Assert (this->update_flags & update_JxW_values,
           ExcAccessToUninitializedField("update_JxW_values"));
   Assert (i<this->mapping_output.JxW_values.size(),
@@ -4862,6 +5172,7 @@ inline
 const DerivativeForm<1,dim,spacedim> &
 FEValuesBase<dim,spacedim>::jacobian (const unsigned int i) const
 {
+  this->compute_on_demand (update_jacobians);
   Assert (this->update_flags & update_jacobians,
           ExcAccessToUninitializedField("update_jacobians"));
   Assert (i<this->mapping_output.jacobians.size(),
@@ -4877,6 +5188,7 @@ inline
 const DerivativeForm<2,dim,spacedim> &
 FEValuesBase<dim,spacedim>::jacobian_grad (const unsigned int i) const
 {
+  this->compute_on_demand (update_jacobian_grads);
   Assert (this->update_flags & update_jacobian_grads,
           ExcAccessToUninitializedField("update_jacobians_grads"));
   Assert (i<this->mapping_output.jacobian_grads.size(),
@@ -4892,6 +5204,7 @@ inline
 const DerivativeForm<1,spacedim,dim> &
 FEValuesBase<dim,spacedim>::inverse_jacobian (const unsigned int i) const
 {
+  this->compute_on_demand (update_inverse_jacobians);
   Assert (this->update_flags & update_inverse_jacobians,
           ExcAccessToUninitializedField("update_inverse_jacobians"));
   Assert (i<this->mapping_output.inverse_jacobians.size(),
@@ -4906,6 +5219,7 @@ inline
 const Tensor<1,spacedim> &
 FEValuesBase<dim,spacedim>::normal_vector (const unsigned int i) const
 {
+  this->compute_on_demand (update_normal_vectors);
   Assert (this->update_flags & update_normal_vectors,
           (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_normal_vectors")));
   Assert (i<this->mapping_output.normal_vectors.size(),
@@ -4989,6 +5303,7 @@ FEFaceValuesBase<dim,spacedim>::boundary_form (const unsigned int i) const
 {
   Assert (i<this->mapping_output.boundary_forms.size(),
           ExcIndexRange(i, 0, this->mapping_output.boundary_forms.size()));
+  this->compute_on_demand (update_boundary_forms);
   Assert (this->update_flags & update_boundary_forms,
           (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_boundary_forms")));
 
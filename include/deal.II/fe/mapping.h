@@ -391,6 +391,27 @@ public:
   transform_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
                                const Point<spacedim>                                     &p) const = 0;
 
+  /**
+   * Map the points @p real_points on the real @p cell to the corresponding
+   * points on the unit cell and store them in @p unit_points, which must
+   * have the same size as @p real_points.
+   *
+   * In contrast to transform_real_to_unit_cell(), this function does not
+   * throw an exception if the inverse mapping of a point cannot be computed.
+   * Instead, all coordinates of the respective entry of @p unit_points are
+   * set to infinity, such that GeometryInfo::is_inside_unit_cell() returns
+   * false for it.
+   *
+   * The default implementation calls transform_real_to_unit_cell() for each
+   * point. Derived classes can provide more efficient implementations that
+   * process several points at once, like MappingQGeneric.
+   */
+  virtual
+  void
+  transform_points_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                      const ArrayView<const Point<spacedim> >                   &real_points,
+                                      const ArrayView<Point<dim> >                              &unit_points) const;
+
   /**
    * Transforms the point @p p on the real @p cell to the corresponding point
    * on the unit cell, and then projects it to a dim-1  point on the face with
@@ -184,6 +184,30 @@ public:
   transform_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
                                const Point<spacedim>                            &p) const;
 
+  /**
+   * Map the points @p real_points on the real @p cell to the unit cell, see
+   * Mapping::transform_points_real_to_unit_cell().
+   *
+   * For <tt>dim==spacedim</tt>, the Newton iteration of the inverse mapping
+   * is run on batches of VectorizedArray<double>::n_array_elements points
+   * at once. The mapping support points of the cell are computed only once
+   * for all points, and the position and Jacobian of the mapping at the
+   * current iterates are evaluated with sum factorization over the tensor
+   * product of the one-dimensional Lagrange polynomials on the support
+   * points, rather than through the full set of shape functions as in
+   * transform_real_to_unit_cell(). The iteration starts from the affine
+   * approximation of the mapping at the cell center. Points for which the
+   * batched iteration does not converge, which can happen for points far
+   * outside the cell, are handed to transform_real_to_unit_cell() with its
+   * line search. For <tt>dim<spacedim</tt>, the implementation of the base
+   * class is used.
+   */
+  virtual
+  void
+  transform_points_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                      const ArrayView<const Point<spacedim> >                   &real_points,
+                                      const ArrayView<Point<dim> >                              &unit_points) const;
+
   /**
    * @}
    */
@@ -450,6 +474,16 @@ public:
      */
     QGaussLobatto<1> line_support_points;
 
+    /**
+     * The location of the mapping support points on the reference cell, in
+     * the (hierarchical) order used by compute_mapping_support_points(). They
+     * are used to detect cells whose support points are an affine image of
+     * the reference cell, in which case fill_fe_values() evaluates the
+     * constant Jacobian once instead of summing over all support points in
+     * each quadrature point.
+     */
+    std::vector<Point<dim> > unit_support_points;
+
     /**
       * In case the quadrature rule given represents a tensor product
       * we need to store the evaluations of the 1d polynomials at the
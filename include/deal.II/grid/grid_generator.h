@@ -262,6 +262,74 @@ namespace GridGenerator
                               const Table<dim,types::material_id>      &material_id,
                               const bool                                colorize=false);
 
+  /**
+   * Create only a part of the mesh of subdivided_hyper_rectangle(), namely
+   * the cells of one block of a regular partition of the cells into blocks,
+   * together with @p n_ghost_layers layers of cells around the block. The
+   * partition splits the cells in coordinate direction <code>d</code> into
+   * <code>n_blocks[d]</code> contiguous chunks of (almost) equal size, and
+   * the blocks are numbered lexicographically with the x direction running
+   * fastest. When called with the rank of each MPI process as @p block, the
+   * union of the blocks is the full mesh, but each process only creates
+   * and stores the cells it needs:
+   * @code
+   *   const unsigned int rank = Utilities::MPI::this_mpi_process(comm);
+   *   GridGenerator::subdivided_hyper_rectangle_block
+   *     (tria, {1000, 100, 100}, {8, 2, 2}, rank, p1, p2, true);
+   * @endcode
+   *
+   * The cells and vertices of the block are computed arithmetically from the
+   * block index, so the cost of this function only depends on the size of
+   * the block, not on the size of the global mesh. The vertices have exactly
+   * the same coordinates as the corresponding vertices of
+   * subdivided_hyper_rectangle(), and the subdomain id of each cell is set
+   * to the block the cell belongs to, which identifies the ghost cells.
+   *
+   * If @p colorize is set, boundary ids and material ids are assigned as in
+   * subdivided_hyper_rectangle(), where boundary ids are only set on the
+   * faces at the boundary of the global rectangle. The faces at the
+   * artificial boundary between the created part and the rest of the mesh
+   * get the boundary id zero; they are the faces at the boundary of the
+   * ghost cells (or, without ghost layers, of the cells next to other
+   * blocks).
+   *
+   * @note This function creates a regular Triangulation that only knows the
+   * local part of the mesh. parallel::distributed::Triangulation and
+   * parallel::shared::Triangulation require the complete coarse mesh on
+   * every process and can not be created from the output of this function.
+   *
+   * @param tria The Triangulation to create. It needs to be empty upon
+   * calling this function.
+   *
+   * @param repetitions The number of cells of the global mesh in each
+   * coordinate direction.
+   *
+   * @param n_blocks The number of blocks in each coordinate direction, which
+   * must not exceed the number of cells in that direction.
+   *
+   * @param block The index of the block to create, smaller than the product
+   * of the entries of @p n_blocks.
+   *
+   * @param p1 First corner point of the global rectangle.
+   *
+   * @param p2 Second corner of the global rectangle opposite to @p p1.
+   *
+   * @param colorize Assign different boundary ids if set to true.
+   *
+   * @param n_ghost_layers The number of layers of cells of the neighboring
+   * blocks to create around the block.
+   */
+  template <int dim, int spacedim>
+  void
+  subdivided_hyper_rectangle_block (Triangulation<dim,spacedim>     &tria,
+                                    const std::vector<unsigned int> &repetitions,
+                                    const std::vector<unsigned int> &n_blocks,
+                                    const unsigned int               block,
+                                    const Point<dim>                &p1,
+                                    const Point<dim>                &p2,
+                                    const bool                       colorize = false,
+                                    const unsigned int               n_ghost_layers = 1);
+
   /**
    * \brief Rectangular domain with rectangular pattern of holes
    *
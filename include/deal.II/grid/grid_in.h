@@ -341,6 +341,19 @@ public:
    */
   void attach_triangulation (Triangulation<dim,spacedim> &tria);
 
+  /**
+   * Select whether the cells read from a file are passed through
+   * GridReordering::reorder_cells() before the triangulation is created,
+   * which is the default. Reordering makes the orientation of the cells
+   * consistent as needed by the Triangulation class, but takes a
+   * considerable part of the time and memory for reading large meshes. If
+   * the input is known to be consistently oriented already, e.g. because it
+   * was written by GridOut from a deal.II triangulation, it can be skipped by
+   * calling this function with @p reorder set to false. Creating the
+   * triangulation fails if the input is not actually consistently oriented.
+   */
+  void set_reorder_cells (const bool reorder);
+
   /**
    * Read from the given stream. If no format is given,
    * GridIn::Format::Default is used.
@@ -438,6 +451,11 @@ public:
    * file format. The GMSH formats are documented at
    * http://www.geuz.org/gmsh/.
    *
+   * Version 2 files can be given both in ascii and in binary form. The
+   * binary form is much faster to read for large meshes, but needs to have
+   * been written with the byte order of the present machine. Note that the
+   * stream should then be opened in binary mode.
+   *
    * @note The input function of deal.II does not distinguish between newline
    * and other whitespace. Therefore, deal.II will be able to read files in a
    * slightly more general format than Gmsh.
@@ -669,6 +687,12 @@ private:
    * Input format used by read() if no format is given.
    */
   Format default_format;
+
+  /**
+   * Whether to reorder the cells before creating the triangulation, see
+   * set_reorder_cells().
+   */
+  bool reorder_cells;
 };
 
 /* -------------- declaration of explicit specializations ------------- */
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2016 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -131,11 +131,24 @@ namespace GridOutFlags
      */
     bool write_lines;
 
+    /**
+     * Write the nodes and elements in binary form, using version 2.2 of the
+     * gmsh file format, rather than as text in the original gmsh format.
+     * Binary files are much smaller and are written and read (by
+     * GridIn::read_msh()) much faster than text files, since no number has
+     * to be formatted. They can only be read on machines with the same byte
+     * order.
+     *
+     * Default: @p false.
+     */
+    bool binary;
+
     /**
      * Constructor.
      */
     Msh (const bool write_faces    = false,
-         const bool write_lines    = false);
+         const bool write_lines    = false,
+         const bool binary         = false);
     /**
      * Declare parameters in ParameterHandler.
      */
@@ -935,7 +948,9 @@ public:
    * boundary indicators explicitly, which is done by this flag.
    *
    * Names and values of further flags controlling the output can be found in
-   * the documentation of the GridOutFlags::Msh() class.
+   * the documentation of the GridOutFlags::Msh() class. In particular,
+   * GridOutFlags::Msh::binary selects the binary format, which is the
+   * preferred choice for large meshes.
    *
    * Works also in the codimension one case.
    */
@@ -20,6 +20,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/bounding_box.h>
 #include <deal.II/base/geometry_info.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/fe/mapping.h>
 #include <deal.II/fe/mapping_q1.h>
@@ -32,6 +33,7 @@
 #include <bitset>
 #include <list>
 #include <set>
+#include <tuple>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -392,6 +394,11 @@ namespace GridTools
    * value of this parameter is <code>false</code>.
    *
    * @note This function is not currently implemented for the 1d case.
+   *
+   * @note This function sets up the Laplace problem from scratch on every
+   * call and only works on serial triangulations. For moving a mesh
+   * repeatedly, or for parallel::distributed::Triangulation objects, use the
+   * LaplaceTransform class, which keeps the operator between calls.
    */
   template <int dim>
   void laplace_transform (const std::map<unsigned int,Point<dim> > &new_points,
@@ -933,6 +940,15 @@ namespace GridTools
    * A version of the previous function that exploits an already existing
    * GridTools::Cache<dim,spacedim> object.
    *
+   * If the point lies in @p cell_hint, that cell is returned right away.
+   * Otherwise, the cells whose bounding box contains the point are
+   * obtained from the R-tree of the cache, see
+   * Cache::get_cell_bounding_boxes_rtree(), which takes logarithmic time in
+   * the number of cells. Only if none of these cells contains the point
+   * (which can happen for curved cells extending beyond the bounding box of
+   * their vertices) or if @p marked_vertices is given, the search around the
+   * closest vertex of the previous function is used.
+   *
    * @author Luca Heltai, 2017
    */
   template <int dim, int spacedim>
@@ -942,6 +958,100 @@ namespace GridTools
                                  const typename Triangulation<dim, spacedim>::active_cell_iterator &cell_hint=typename Triangulation<dim, spacedim>::active_cell_iterator(),
                                  const std::vector<bool>                                           &marked_vertices = std::vector<bool>());
 
+  /**
+   * Find the active cells around all points in @p points, using the
+   * hint-free search of find_active_cell_around_point() with the R-tree of
+   * cell bounding boxes stored in @p cache. The points are processed in
+   * parallel with the task-based parallelism of deal.II, so this function is
+   * much faster than locating the points one by one for large numbers of
+   * points. The data structures of @p cache used by the search are computed
+   * before the parallel loop starts.
+   *
+   * The function returns a tuple containing the following data:
+   * - a vector of the cells that contain at least one of the points,
+   * - for each of these cells, the reference (unit cell) coordinates of the
+   *   points that lie in it, and
+   * - for each of these cells, the positions of these points in @p points.
+   *
+   * Points that lie in no cell of the triangulation do not appear in the
+   * output. For points on the boundary between cells, only one of the cells
+   * is returned. The cells are sorted by their active cell index.
+   *
+   * The mapping stored in @p cache must support concurrent calls to
+   * Mapping::transform_real_to_unit_cell(), which is the case for the
+   * mappings of deal.II.
+   */
+  template <int dim, int spacedim>
+  std::tuple<std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator>,
+      std::vector<std::vector<Point<dim> > >,
+      std::vector<std::vector<unsigned int> > >
+      compute_point_locations (const Cache<dim,spacedim>        &cache,
+                               const std::vector<Point<spacedim> > &points);
+
+  /**
+   * Return a description of the locally owned part of the triangulation
+   * stored in @p cache by bounding boxes: for each coarse cell that has
+   * locally owned active descendants, the bounding box of the (mapped)
+   * vertices of these descendants is computed. For a serial triangulation,
+   * all cells are locally owned.
+   *
+   * The result is meant to be exchanged among all processes with
+   * exchange_local_bounding_boxes(), e.g. for distributed_compute_point_locations().
+   */
+  template <int dim, int spacedim>
+  std::vector<BoundingBox<spacedim> >
+  compute_locally_owned_bounding_boxes (const Cache<dim,spacedim> &cache);
+
+  /**
+   * Collect the bounding boxes @p local_bboxes of all processes in the
+   * communicator @p mpi_communicator, such that entry $i$ of the returned
+   * vector contains the boxes of process $i$. This function is collective
+   * over all processes of the communicator. If deal.II is not configured
+   * with MPI, the returned vector only contains @p local_bboxes.
+   */
+  template <int spacedim>
+  std::vector<std::vector<BoundingBox<spacedim> > >
+  exchange_local_bounding_boxes (const std::vector<BoundingBox<spacedim> > &local_bboxes,
+                                 const MPI_Comm                          &mpi_communicator);
+
+  /**
+   * A version of compute_point_locations() for triangulations distributed
+   * among several MPI processes, where each process provides a set of
+   * points @p local_points that may lie in the part of the mesh owned by any
+   * process.
+   *
+   * The argument @p global_bboxes describes the locally owned parts of the
+   * mesh on all processes, as returned by exchange_local_bounding_boxes()
+   * for the boxes of compute_locally_owned_bounding_boxes() (or any other
+   * set of boxes that covers the locally owned cells). Each point is sent to
+   * all processes that have a bounding box containing it, with one message
+   * per pair of processes. The receiving processes locate the points in
+   * their locally owned cells in parallel as in compute_point_locations().
+   * For a serial triangulation, all points are located locally.
+   *
+   * The function returns, on each process, the points found in the locally
+   * owned cells in a tuple containing
+   * - a vector of the locally owned cells that contain at least one point,
+   * - for each of these cells, the reference coordinates of the points,
+   * - for each of these cells, the positions of the points in the vector
+   *   @p local_points of the process that sent them, and
+   * - for each of these cells, the ranks of the processes that sent the
+   *   points.
+   *
+   * Points on the interface between the locally owned parts of two processes
+   * may be reported by both processes, and points outside the domain are not
+   * reported by any process. This function is collective over all processes
+   * of the communicator of the triangulation.
+   */
+  template <int dim, int spacedim>
+  std::tuple<std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator>,
+      std::vector<std::vector<Point<dim> > >,
+      std::vector<std::vector<unsigned int> >,
+      std::vector<std::vector<unsigned int> > >
+      distributed_compute_point_locations (const Cache<dim,spacedim>                               &cache,
+                                           const std::vector<Point<spacedim> >                     &local_points,
+                                           const std::vector<std::vector<BoundingBox<spacedim> > > &global_bboxes);
+
   /**
    * Return a list of all descendants of the given cell that are active. For
    * example, if the current cell is once refined but none of its children are
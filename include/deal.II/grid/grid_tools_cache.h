@@ -21,6 +21,7 @@
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/point.h>
+#include <deal.II/base/bounding_box_tree.h>
 
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_iterator.h>
@@ -50,8 +51,25 @@ namespace GridTools
    * for faster access whenever the triangulation has not changed.
    *
    * Notice that this class only notices if the underlying Triangulation has
-   * changed due to a Triangulation::Signals::any_change() signal being
-   * triggered.
+   * changed due to one of the signals collected by
+   * Triangulation::Signals::any_change() being triggered.
+   *
+   * Small changes of the mesh do not require to compute everything from
+   * scratch: the class records the cells refined and coarsened in
+   * Triangulation::execute_coarsening_and_refinement() through the
+   * Triangulation::Signals::post_refinement_on_cell() and
+   * Triangulation::Signals::pre_coarsening_on_cell() signals, and once the
+   * Triangulation::Signals::post_refinement() signal is triggered, it updates
+   * the vertex to cell map, the vertex to cell center directions, the map of
+   * used vertices, and the R-tree of the cell bounding boxes only for the
+   * vertices and cells around the changed cells, provided they are up to
+   * date at that point. The cost of this is proportional to the number of
+   * changed cells rather than the size of the mesh. If more than an eighth
+   * of the active cells changed, or if the R-tree has accumulated too many
+   * entries that are not sorted into the tree, the structures are marked
+   * for update instead. The signal Triangulation::Signals::mesh_movement()
+   * does not change the topology of the mesh, so it only marks the
+   * structures depending on the vertex locations for update.
    *
    * If the triangulation changes for other reasons, for example because you
    * use it in conjunction with a MappingQEulerian object that sees the
@@ -116,6 +134,20 @@ namespace GridTools
     const std::map<unsigned int, Point<spacedim> >
     &get_used_vertices() const;
 
+    /**
+     * Return the cached R-tree of the bounding boxes of all active cells of
+     * the triangulation. The boxes are computed from the vertices of the
+     * cells as seen through the stored mapping, see
+     * Mapping::get_vertices(). For mappings that curve the cells, the box of
+     * the vertices need not contain the whole cell, so a query should be
+     * complemented by another search if no cell is found.
+     *
+     * After refinement, the tree may contain removed entries and entries
+     * that are not sorted into the tree, see BoundingBoxTree::insert().
+     */
+    const BoundingBoxTree<spacedim, typename Triangulation<dim,spacedim>::active_cell_iterator>
+    &get_cell_bounding_boxes_rtree() const;
+
     /**
      * Return a reference to the stored triangulation.
      */
@@ -135,6 +167,51 @@ namespace GridTools
 #endif
 
   private:
+    /**
+     * Record the parent of a set of cells that is going to be coarsened,
+     * together with the vertices around the children, which are not
+     * accessible anymore once the children have been removed. Also remove
+     * the children from the R-tree.
+     */
+    void pre_coarsening_on_cell (const typename Triangulation<dim,spacedim>::cell_iterator &parent);
+
+    /**
+     * Record the parent of a set of cells that has just been created by
+     * refinement.
+     */
+    void post_refinement_on_cell (const typename Triangulation<dim,spacedim>::cell_iterator &parent);
+
+    /**
+     * Update the data structures that are up to date for the cells recorded
+     * by the two functions above and clear the records.
+     */
+    void post_refinement ();
+
+    /**
+     * Add the indices of the vertices of @p cell, of the children of its
+     * faces, and in 3d of the midpoints of its refined lines to
+     * changed_vertices. These are all the vertices whose entries in the
+     * vertex to cell map can change when @p cell is created or removed.
+     */
+    void add_changed_vertices (const typename Triangulation<dim,spacedim>::cell_iterator &cell);
+
+    /**
+     * Recompute the entries of the vertex to cell map, and of the other data
+     * structures depending on it that are up to date, for the vertices in
+     * changed_vertices. @p new_cells are the active cells created by the
+     * last refinement, either as children of a refined cell or as the
+     * parent of coarsened cells.
+     */
+    void update_vertex_information
+    (const std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> &new_cells);
+
+    /**
+     * Return the bounding box of the vertices of @p cell as seen through the
+     * mapping, enlarged slightly to not miss points on the cell boundary.
+     */
+    BoundingBox<spacedim>
+    compute_cell_bounding_box (const typename Triangulation<dim,spacedim>::active_cell_iterator &cell) const;
+
     /**
      * Keep track of what needs to be updated next.
      */
@@ -180,9 +257,40 @@ namespace GridTools
     mutable std::map<unsigned int, Point<spacedim>> used_vertices;
 
     /**
-     * Storage for the status of the triangulation signal.
+     * An R-tree of the bounding boxes of the active cells.
+     */
+    mutable BoundingBoxTree<spacedim, typename Triangulation<dim,spacedim>::active_cell_iterator>
+    cell_bounding_boxes_rtree;
+
+    /**
+     * The position of each active cell in cell_bounding_boxes_rtree, indexed
+     * by the level and the index of the cell, or numbers::invalid_unsigned_int
+     * for cells not in the tree.
+     */
+    mutable std::vector<std::vector<unsigned int> > rtree_positions;
+
+    /**
+     * The positions of the R-tree freed by coarsening since the last
+     * post_refinement signal, which are reused for the parents.
+     */
+    std::vector<unsigned int> free_rtree_positions;
+
+    /**
+     * The parents of the cells refined or coarsened since the last
+     * post_refinement signal.
+     */
+    std::vector<typename Triangulation<dim,spacedim>::cell_iterator> changed_parents;
+
+    /**
+     * The vertices whose entries in the vertex to cell map can have changed
+     * since the last post_refinement signal.
+     */
+    std::vector<unsigned int> changed_vertices;
+
+    /**
+     * Storage for the status of the triangulation signals.
      */
-    boost::signals2::connection tria_signal;
+    std::vector<boost::signals2::connection> tria_signals;
   };
 
 
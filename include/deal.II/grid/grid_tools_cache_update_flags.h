@@ -61,6 +61,12 @@ namespace GridTools
      */
     update_used_vertices = 0x08,
 
+    /**
+     * Update an R-tree of the bounding boxes of all active cells, used for
+     * locating points in the mesh.
+     */
+    update_cell_bounding_boxes_rtree = 0x10,
+
     /**
      * Update all objects.
      */
@@ -84,6 +90,8 @@ namespace GridTools
 #ifdef DEAL_II_WITH_NANOFLANN
     if (u & update_vertex_kdtree)                      s << "|vertex_kdtree";
 #endif
+    if (u & update_used_vertices)                      s << "|used_vertices";
+    if (u & update_cell_bounding_boxes_rtree)          s << "|cell_bounding_boxes_rtree";
     return s;
   }
 
@@ -0,0 +1,237 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_grid_grid_tools_laplace_transform_h
+#define dealii_grid_grid_tools_laplace_transform_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/function.h>
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/point.h>
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/operators.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace GridTools
+{
+
+  /**
+   * A class that moves the vertices of a triangulation by the solution of a
+   * Laplace problem, like the function GridTools::laplace_transform(), but
+   * that keeps the Laplace operator between calls and that also works on
+   * parallel::distributed::Triangulation objects.
+   *
+   * The Laplace operator is set up by reinit() on the mesh as it is at that
+   * point, using linear finite elements, a matrix-free implementation of the
+   * operator (MatrixFreeOperators::LaplaceOperator), and vectors of type
+   * LinearAlgebra::distributed::Vector that are distributed in the same way
+   * as the locally owned cells of the triangulation. Each call to
+   * transform() then only needs to solve the @p dim Laplace problems with the
+   * prescribed vertex positions as Dirichlet data, which makes the class
+   * suitable for moving a mesh in every time step of an ALE computation, as
+   * long as the topology of the mesh does not change. After refinement or
+   * coarsening, reinit() needs to be called again.
+   *
+   * The linear systems are solved by the conjugate gradient method,
+   * preconditioned by a Chebyshev iteration around the point-Jacobi method
+   * (or only by the point-Jacobi method if the degree of the Chebyshev
+   * polynomial is set to zero), which only requires the action of the
+   * operator and its diagonal. Hanging node constraints are respected.
+   *
+   * In parallel, every process can prescribe the new location of those
+   * vertices it knows about, i.e., the vertices of its locally owned and
+   * ghost cells. If a vertex gets a location from more than one process, the
+   * average of the given locations is used. At the end of transform(), the
+   * vertices of all locally owned and ghost cells have been moved, with
+   * consistent locations across processes. Vertices of artificial cells are
+   * not moved.
+   *
+   * By default, the operator is kept as computed on the mesh at the time of
+   * reinit(), i.e., the Laplace problem of every call to transform() is
+   * posed on the original rather than the deformed configuration. This
+   * approximation avoids recomputing the geometry of all cells in each call.
+   * Setting AdditionalData::update_mapping makes every call to transform()
+   * recompute the geometry and the coefficient on the current mesh first.
+   */
+  template <int dim>
+  class LaplaceTransform : public Subscriptor
+  {
+  public:
+    /**
+     * The type of vectors used for solving the Laplace problems.
+     */
+    typedef LinearAlgebra::distributed::Vector<double> VectorType;
+
+    /**
+     * Collection of parameters for the solution of the Laplace problems.
+     */
+    struct AdditionalData
+    {
+      /**
+       * Constructor.
+       */
+      AdditionalData (const double       tolerance = 1e-10,
+                      const unsigned int chebyshev_degree = 3,
+                      const bool         update_mapping = false);
+
+      /**
+       * Tolerance for the conjugate gradient solver, relative to the norm of
+       * the right hand side.
+       */
+      double tolerance;
+
+      /**
+       * Degree of the Chebyshev polynomial used as preconditioner. For zero,
+       * the point-Jacobi method is used.
+       */
+      unsigned int chebyshev_degree;
+
+      /**
+       * If true, the geometry of the cells (and the coefficient, if given)
+       * is recomputed on the current mesh at the beginning of every call to
+       * transform().
+       */
+      bool update_mapping;
+    };
+
+    /**
+     * Constructor. Does not set up anything, reinit() needs to be called
+     * before the object can be used.
+     */
+    LaplaceTransform ();
+
+    /**
+     * Destructor.
+     */
+    ~LaplaceTransform ();
+
+    /**
+     * Set up the Laplace operator for the given triangulation. The meaning of
+     * @p coefficient is the same as for GridTools::laplace_transform(). The
+     * coefficient is evaluated at the time of this call on the mesh as it is
+     * then, unless AdditionalData::update_mapping is set. The triangulation
+     * and the coefficient need to live at least as long as this object or
+     * until the next call to reinit() or clear().
+     */
+    void reinit (Triangulation<dim>   &triangulation,
+                 const Function<dim>  *coefficient = nullptr,
+                 const AdditionalData &additional_data = AdditionalData());
+
+    /**
+     * Move the vertices of the triangulation given to reinit(). The
+     * arguments have the same meaning as for GridTools::laplace_transform().
+     * In parallel, vertex indices in @p new_points that do not belong to a
+     * locally owned or ghost cell are ignored.
+     */
+    void transform (const std::map<unsigned int,Point<dim> > &new_points,
+                    const bool solve_for_absolute_positions = false);
+
+    /**
+     * Return the number of conjugate gradient iterations spent in the last
+     * call to transform(), summed over all coordinate directions.
+     */
+    unsigned int n_iterations () const;
+
+    /**
+     * Release all memory and reset the object to the state after the
+     * default constructor.
+     */
+    void clear ();
+
+  private:
+    /**
+     * Evaluate the coefficient at the quadrature points of the matrix-free
+     * framework and pass it on to the Laplace operator.
+     */
+    void compute_coefficient ();
+
+    /**
+     * The triangulation whose vertices are moved.
+     */
+    SmartPointer<Triangulation<dim>,LaplaceTransform<dim> > triangulation;
+
+    /**
+     * The coefficient of the Laplace problem, or @p nullptr for the unit
+     * coefficient.
+     */
+    SmartPointer<const Function<dim>,LaplaceTransform<dim> > coefficient;
+
+    /**
+     * The parameters passed to reinit().
+     */
+    AdditionalData additional_data;
+
+    /**
+     * The linear element whose degrees of freedom sit at the vertices.
+     */
+    const FE_Q<dim> fe;
+
+    /**
+     * The DoFHandler for the linear element on the triangulation.
+     */
+    DoFHandler<dim> dof_handler;
+
+    /**
+     * The degrees of freedom of all locally owned and ghost cells.
+     */
+    IndexSet locally_relevant_dofs;
+
+    /**
+     * Hanging node constraints.
+     */
+    ConstraintMatrix constraints;
+
+    /**
+     * The matrix-free data the Laplace operator works on.
+     */
+    std::shared_ptr<MatrixFree<dim,double> > matrix_free;
+
+    /**
+     * The Laplace operator.
+     */
+    MatrixFreeOperators::LaplaceOperator<dim,1,2,1,VectorType> laplace_operator;
+
+    /**
+     * The degree of freedom sitting at each vertex of the triangulation, or
+     * numbers::invalid_dof_index for vertices not belonging to a locally
+     * owned or ghost cell.
+     */
+    std::vector<types::global_dof_index> vertex_dof_indices;
+
+    /**
+     * The number of iterations spent in the last call to transform().
+     */
+    unsigned int last_n_iterations;
+  };
+
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
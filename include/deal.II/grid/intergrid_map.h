@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2016 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -105,6 +105,10 @@ DEAL_II_NAMESPACE_OPEN
  * <tt>InterGridMap<DoFHandler<2> ></tt>, which here is DoFHandler (and could
  * equally well be Triangulation, PersistentTriangulation, or hp::DoFHandler).
  *
+ * For grids that are not derived from the same coarse grid, or that are
+ * distributed among several processors, the overlapping cells of two grids
+ * can be computed with the NonMatching::MeshCoupling class.
+ *
  * @ingroup grid
  * @author Wolfgang Bangerth, 1999
  */
@@ -21,9 +21,12 @@
 #include <deal.II/grid/manifold.h>
 #include <deal.II/base/function.h>
 #include <deal.II/base/function_parser.h>
+#include <deal.II/base/thread_local_storage.h>
 
 #include <boost/container/small_vector.hpp>
 
+#include <tuple>
+
 DEAL_II_NAMESPACE_OPEN
 
 /**
@@ -758,6 +761,14 @@ private:
   pull_back(const typename Triangulation<dim,spacedim>::cell_iterator &cell,
             const Point<spacedim> &p) const;
 
+  /**
+   * Same as pull_back(), but first look up the point in the cache of recent
+   * pull-backs of the current thread, and store the result there otherwise.
+   */
+  Point<dim>
+  cached_pull_back(const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                   const Point<spacedim> &p) const;
+
   /**
    * Push forward operation.
    *
@@ -803,6 +814,41 @@ private:
    * use a FlatManifold description.
    */
   FlatManifold<dim> chart_manifold;
+
+  /**
+   * A ring buffer of the most recent pull-backs, stored as the index of the
+   * coarse cell, the point in real space and its chart point.
+   */
+  struct PullBackCache
+  {
+    /**
+     * Constructor.
+     */
+    PullBackCache();
+
+    /**
+     * The cached pull-backs.
+     */
+    std::vector<std::tuple<unsigned int,Point<spacedim>,Point<dim> > > entries;
+
+    /**
+     * The position in @p entries to be overwritten next once the cache is
+     * full.
+     */
+    unsigned int next_entry;
+  };
+
+  /**
+   * When computing the new points with the same chart, e.g. all support
+   * points of a cell in MappingQGeneric or the new points of neighboring
+   * cells during refinement, the same surrounding points are pulled back
+   * over and over again. Since the pull-back is a Newton iteration that
+   * evaluates the surrounding manifolds in each step, we keep the most
+   * recent results. As the pull-back only depends on the coarse cell and the
+   * point, the results are the same as without the cache. The cache is kept
+   * separately for each thread such that no locking is necessary.
+   */
+  mutable Threads::ThreadLocalStorage<PullBackCache> pull_back_cache;
 };
 
 DEAL_II_NAMESPACE_CLOSE
@@ -23,6 +23,7 @@
 #include <deal.II/base/smartpointer.h>
 #include <deal.II/base/geometry_info.h>
 #include <deal.II/base/iterator_range.h>
+#include <deal.II/base/memory_report.h>
 #include <deal.II/grid/tria_iterator_selector.h>
 
 // Ignore deprecation warnings for auto_ptr.
@@ -1986,6 +1987,13 @@ public:
    * be propagated through this function if that happens, and you may not get
    * the actual number of refinement steps in that case.
    *
+   * Since all cells are flagged for isotropic refinement, the mesh smoothing
+   * of prepare_coarsening_and_refinement() can not modify the flags unless
+   * the mesh contains anisotropically refined cells or one of the
+   * <tt>eliminate_refined_*_islands</tt> smoothing flags is set. In all other
+   * cases, execute_coarsening_and_refinement() skips that step, which makes
+   * uniform refinement of large meshes considerably cheaper.
+   *
    * @note This function triggers the pre- and post-refinement signals before
    * and after doing each individual refinement cycle (i.e. more than once if
    * times > 1) . See the section on signals in the general documentation of
@@ -3145,6 +3153,14 @@ public:
    */
   virtual std::size_t memory_consumption () const;
 
+  /**
+   * Return a breakdown of the memory consumption returned by
+   * memory_consumption() into the cells and faces of each level, the
+   * vertices, and the remaining data. See the MemoryReport class for how
+   * to combine and print such reports.
+   */
+  virtual MemoryReport memory_report () const;
+
   /**
    * Write the data of this object to a stream for the purpose of
    * serialization.
@@ -1788,7 +1788,9 @@ template <int structdim, int dim, int spacedim>
 void *TriaAccessor<structdim,dim,spacedim>::user_pointer () const
 {
   Assert (this->used(), TriaAccessorExceptions::ExcCellNotUsed());
-  return this->objects().user_pointer(this->present_index);
+  // go through the const overload, which does not allocate the user data
+  const auto &objects = this->objects();
+  return const_cast<void *>(objects.user_pointer(this->present_index));
 }
 
 
@@ -1841,7 +1843,8 @@ template <int structdim, int dim, int spacedim>
 unsigned int TriaAccessor<structdim,dim,spacedim>::user_index () const
 {
   Assert (this->used(), TriaAccessorExceptions::ExcCellNotUsed());
-  return this->objects().user_index(this->present_index);
+  const auto &objects = this->objects();
+  return objects.user_index(this->present_index);
 }
 
 
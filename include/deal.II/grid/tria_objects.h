@@ -399,6 +399,12 @@ namespace internal
       /**
        * Pointer which is not used by the library but may be accessed and set
        * by the user to handle data local to a line/quad/etc.
+       *
+       * Since most programs never use this field, the vector is only
+       * allocated (with the size of the @p cells vector) by the first write
+       * access through user_pointer() or user_index(). As long as it is
+       * empty, read access returns a null pointer or zero. This saves the
+       * space of one pointer per object for large meshes.
        */
       std::vector<UserData> user_data;
 
@@ -622,6 +628,8 @@ namespace internal
              ExcPointerIndexClash());
       user_data_type = data_pointer;
 
+      if (user_data.empty())
+        user_data.resize(cells.size());
       Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
       return user_data[i].p;
     }
@@ -636,6 +644,11 @@ namespace internal
              ExcPointerIndexClash());
       user_data_type = data_pointer;
 
+      if (user_data.empty())
+        {
+          Assert(i<cells.size(), ExcIndexRange(i,0,cells.size()));
+          return nullptr;
+        }
       Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
       return user_data[i].p;
     }
@@ -650,6 +663,8 @@ namespace internal
              ExcPointerIndexClash());
       user_data_type = data_index;
 
+      if (user_data.empty())
+        user_data.resize(cells.size());
       Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
       return user_data[i].i;
     }
@@ -660,6 +675,11 @@ namespace internal
     void
     TriaObjects<G>::clear_user_data (const unsigned int i)
     {
+      if (user_data.empty())
+        {
+          Assert(i<cells.size(), ExcIndexRange(i,0,cells.size()));
+          return;
+        }
       Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
       user_data[i].i = 0;
     }
@@ -684,6 +704,11 @@ namespace internal
              ExcPointerIndexClash());
       user_data_type = data_index;
 
+      if (user_data.empty())
+        {
+          Assert(i<cells.size(), ExcIndexRange(i,0,cells.size()));
+          return 0;
+        }
       Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
       return user_data[i].i;
     }
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2006 - 2015 by the deal.II authors
+// Copyright (C) 2006 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -20,6 +20,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/hp/fe_collection.h>
 
+#include <limits>
 #include <vector>
 
 DEAL_II_NAMESPACE_OPEN
@@ -58,9 +59,8 @@ namespace internal
      * any more if different lines may have different numbers of degrees of
      * freedom associated with them. Consequently, rather than using this
      * simple multiplication, the dofs array has an associated array
-     * dof_offsets. The data corresponding to a line then starts at index
-     * <code>line_dof_offsets[line_index]</code> within the
-     * <code>line_dofs</code> array.
+     * dof_offsets that holds the start index of every set of DoF indices
+     * stored within the @p dofs array, see below.
      *
      *
      * <h4>Multiple data sets per object</h4>
@@ -76,22 +76,29 @@ namespace internal
      * indices associated. Since real sets are typically very inefficient to
      * store, and since most of the time we expect the number of individual
      * keys to be small (frequently, adjacent cells will have the same finite
-     * element, and only a single entry will exist in the map), what we do is
-     * instead to store a linked list. In this format, the first entry
-     * starting at position
-     * <code>lines.dofs[lines.dof_offsets[line_index]]</code> will denote the
-     * finite element index of the set of DoF indices following; after this
-     * set, we will store the finite element index of the second set followed
-     * by the corresponding DoF indices; and so on. Finally, when all finite
-     * element indices adjacent to this object have been covered, we write a
-     * -1 to indicate the end of the list.
+     * element, and only a single entry will exist in the map), we store the
+     * data in a compressed row format: the sets of the object with index
+     * <code>obj_index</code> are those with numbers between
+     * <code>object_offsets[obj_index]</code> and
+     * <code>object_offsets[obj_index+1]</code>. For every set @p s, the
+     * finite element index is <code>fe_indices[s]</code> and the DoF indices
+     * are stored contiguously in @p dofs starting at position
+     * <code>dof_offsets[s]</code>. Objects without any degrees of freedom,
+     * i.e., those that are not part of an active cell, have an empty range
+     * of sets.
+     *
+     * Looking up a DoF index thus only needs to compare the requested finite
+     * element index with the few entries of the compact @p fe_indices array
+     * belonging to an object, without any access to the finite elements, and
+     * the @p dofs array contains nothing but DoF indices, which allows to
+     * renumber them in a single sweep over the array.
      *
      * Access to this kind of data, as well as the distinction between cells
      * and objects of lower dimensionality are encoded in the accessor
      * functions, DoFObjects::set_dof_index() and DoFLevel::get_dof_index().
-     * They are able to traverse this list and pick out or set a DoF index
-     * given the finite element index and its location within the set of DoFs
-     * corresponding to this finite element.
+     * They are able to pick out or set a DoF index given the finite element
+     * index and its location within the set of DoFs corresponding to this
+     * finite element.
      *
      *
      * @ingroup hp
@@ -102,8 +109,28 @@ namespace internal
     {
     public:
       /**
-       * Store the start index for the degrees of freedom of each object in
-       * the @p dofs array.
+       * The type in which we store the finite element index of each set of
+       * DoF indices, the same as used for the active_fe_index on cells in
+       * DoFLevel.
+       */
+      typedef unsigned short int active_fe_index_type;
+
+      /**
+       * Store for each object the index of its first set of DoF indices in
+       * the @p fe_indices and @p dof_offsets arrays. The array has one more
+       * entry than there are objects, such that the sets of an object end
+       * where the sets of the next object start.
+       */
+      std::vector<unsigned int> object_offsets;
+
+      /**
+       * The finite element index of each set of DoF indices.
+       */
+      std::vector<active_fe_index_type> fe_indices;
+
+      /**
+       * Store the start index of each set of DoF indices in the @p dofs
+       * array. The array has one more entry than there are sets.
        *
        * The type we store is then obviously the type the @p dofs array uses
        * for indexing.
@@ -116,6 +143,16 @@ namespace internal
        */
       std::vector<types::global_dof_index> dofs;
 
+      /**
+       * Fill the @p dof_offsets array from the finite element indices of the
+       * sets that have been placed in @p object_offsets and @p fe_indices,
+       * and allocate the @p dofs array with all entries set to
+       * numbers::invalid_dof_index.
+       */
+      template <int dim, int spacedim>
+      void
+      reserve_dof_indices (const dealii::hp::FECollection<dim,spacedim> &fe_collection);
+
       /**
        * Set the global index of the @p local_index-th degree of freedom
        * located on the object with number @p obj_index to the value given by
@@ -357,6 +394,34 @@ namespace internal
       ar &lines &quads;
     }
 
+    template <int structdim>
+    template <int dim, int spacedim>
+    void
+    DoFIndicesOnFacesOrEdges<structdim>::
+    reserve_dof_indices (const dealii::hp::FECollection<dim,spacedim> &fe_collection)
+    {
+      Assert (object_offsets.size() > 0 &&
+              object_offsets.back() == fe_indices.size(),
+              ExcInternalError());
+      Assert (fe_collection.size() <= std::numeric_limits<active_fe_index_type>::max(),
+              ExcMessage ("The number of finite elements exceeds the range of "
+                          "the type used to store the finite element indices"));
+
+      dof_offsets.resize (fe_indices.size()+1);
+      dof_offsets[0] = 0;
+      for (unsigned int s=0; s<fe_indices.size(); ++s)
+        {
+          AssertIndexRange (fe_indices[s], fe_collection.size());
+          dof_offsets[s+1] = dof_offsets[s] +
+                             fe_collection[fe_indices[s]].template n_dofs_per_object<structdim>();
+        }
+
+      dofs.clear ();
+      dofs.resize (dof_offsets.back(), numbers::invalid_dof_index);
+    }
+
+
+
     template <int structdim>
     template <int dim, int spacedim>
     inline
@@ -378,37 +443,30 @@ namespace internal
               ExcIndexRange(local_index, 0,
                             dof_handler.get_fe(fe_index)
                             .template n_dofs_per_object<structdim>()));
-      Assert (obj_index < dof_offsets.size(),
-              ExcIndexRange (obj_index, 0, dof_offsets.size()));
+      Assert (obj_index+1 < object_offsets.size(),
+              ExcIndexRange (obj_index, 0, object_offsets.size()-1));
 
       // make sure we are on an
       // object for which DoFs have
       // been allocated at all
-      Assert (dof_offsets[obj_index] != numbers::invalid_unsigned_int,
+      Assert (object_offsets[obj_index] != object_offsets[obj_index+1],
               ExcMessage ("You are trying to access degree of freedom "
                           "information for an object on which no such "
                           "information is available"));
 
       Assert (structdim<dim, ExcMessage ("This object can not be used for cells."));
+      (void)dof_handler;
 
       // there may be multiple finite elements associated with
-      // this object. hop along the list of index sets until we
-      // find the one with the correct fe_index, and then poke
-      // into that part. trigger an exception if we can't find a
-      // set for this particular fe_index
-      const types::global_dof_index starting_offset = dof_offsets[obj_index];
-      const types::global_dof_index *pointer        = &dofs[starting_offset];
-      while (true)
-        {
-          Assert (*pointer != numbers::invalid_dof_index,
-                  ExcInternalError());
-          if (*pointer == fe_index)
-            return *(pointer + 1 + local_index);
-          else
-            pointer += static_cast<types::global_dof_index>(
-                         dof_handler.get_fe(*pointer)
-                         .template n_dofs_per_object<structdim>() + 1);
-        }
+      // this object. look for the set with the correct fe_index
+      // and then poke into that part. trigger an exception if we
+      // can't find a set for this particular fe_index
+      for (unsigned int s=object_offsets[obj_index]; s<object_offsets[obj_index+1]; ++s)
+        if (fe_indices[s] == fe_index)
+          return dofs[dof_offsets[s] + local_index];
+
+      Assert (false, ExcInternalError());
+      return numbers::invalid_dof_index;
     }
 
 
@@ -435,39 +493,32 @@ namespace internal
               ExcIndexRange(local_index, 0,
                             dof_handler.get_fe(fe_index)
                             .template n_dofs_per_object<structdim>()));
-      Assert (obj_index < dof_offsets.size(),
-              ExcIndexRange (obj_index, 0, dof_offsets.size()));
+      Assert (obj_index+1 < object_offsets.size(),
+              ExcIndexRange (obj_index, 0, object_offsets.size()-1));
 
       // make sure we are on an
       // object for which DoFs have
       // been allocated at all
-      Assert (dof_offsets[obj_index] != numbers::invalid_unsigned_int,
+      Assert (object_offsets[obj_index] != object_offsets[obj_index+1],
               ExcMessage ("You are trying to access degree of freedom "
                           "information for an object on which no such "
                           "information is available"));
 
       Assert (structdim<dim, ExcMessage ("This object can not be used for cells."));
+      (void)dof_handler;
 
       // there may be multiple finite elements associated with
-      // this object.  hop along the list of index sets until we
-      // find the one with the correct fe_index, and then poke
-      // into that part. trigger an exception if we can't find a
-      // set for this particular fe_index
-      const types::global_dof_index starting_offset = dof_offsets[obj_index];
-      types::global_dof_index      *pointer         = &dofs[starting_offset];
-      while (true)
-        {
-          Assert (*pointer != numbers::invalid_dof_index,
-                  ExcInternalError());
-          if (*pointer == fe_index)
-            {
-              *(pointer + 1 + local_index) = global_index;
-              return;
-            }
-          else
-            pointer += dof_handler.get_fe(*pointer)
-                       .template n_dofs_per_object<structdim>() + 1;
-        }
+      // this object. look for the set with the correct fe_index
+      // and then poke into that part. trigger an exception if we
+      // can't find a set for this particular fe_index
+      for (unsigned int s=object_offsets[obj_index]; s<object_offsets[obj_index+1]; ++s)
+        if (fe_indices[s] == fe_index)
+          {
+            dofs[dof_offsets[s] + local_index] = global_index;
+            return;
+          }
+
+      Assert (false, ExcInternalError());
     }
 
 
@@ -477,40 +528,17 @@ namespace internal
     inline
     unsigned int
     DoFIndicesOnFacesOrEdges<structdim>::
-    n_active_fe_indices (const dealii::hp::DoFHandler<dim,spacedim> &dof_handler,
+    n_active_fe_indices (const dealii::hp::DoFHandler<dim,spacedim> &/*dof_handler*/,
                          const unsigned int                obj_index) const
     {
-      Assert (obj_index < dof_offsets.size(),
-              ExcIndexRange (obj_index, 0, dof_offsets.size()));
-
-      // make sure we are on an
-      // object for which DoFs have
-      // been allocated at all
-      if (dof_offsets[obj_index] == numbers::invalid_unsigned_int)
-        return 0;
+      Assert (obj_index+1 < object_offsets.size(),
+              ExcIndexRange (obj_index, 0, object_offsets.size()-1));
 
       Assert (structdim<dim, ExcMessage ("This object can not be used for cells."));
 
-      // there may be multiple finite elements associated with this
-      // object. hop along the list of index sets until we find the
-      // one with the correct fe_index, and then poke into that
-      // part. trigger an exception if we can't find a set for this
-      // particular fe_index
-      const unsigned int starting_offset = dof_offsets[obj_index];
-      const types::global_dof_index *pointer        = &dofs[starting_offset];
-      unsigned int counter = 0;
-      while (true)
-        {
-          if (*pointer == numbers::invalid_dof_index)
-            // end of list reached
-            return counter;
-          else
-            {
-              ++counter;
-              pointer += dof_handler.get_fe(*pointer)
-                         .template n_dofs_per_object<structdim>() + 1;
-            }
-        }
+      // objects for which no DoFs have been allocated have an
+      // empty range of sets
+      return object_offsets[obj_index+1] - object_offsets[obj_index];
     }
 
 
@@ -525,13 +553,13 @@ namespace internal
                          const unsigned int                obj_index,
                          const unsigned int                n) const
     {
-      Assert (obj_index < dof_offsets.size(),
-              ExcIndexRange (obj_index, 0, dof_offsets.size()));
+      Assert (obj_index+1 < object_offsets.size(),
+              ExcIndexRange (obj_index, 0, object_offsets.size()-1));
 
       // make sure we are on an
       // object for which DoFs have
       // been allocated at all
-      Assert (dof_offsets[obj_index] != numbers::invalid_unsigned_int,
+      Assert (object_offsets[obj_index] != object_offsets[obj_index+1],
               ExcMessage ("You are trying to access degree of freedom "
                           "information for an object on which no such "
                           "information is available"));
@@ -541,32 +569,9 @@ namespace internal
       Assert (n < n_active_fe_indices(dof_handler, obj_index),
               ExcIndexRange (n, 0,
                              n_active_fe_indices(dof_handler, obj_index)));
+      (void)dof_handler;
 
-      // there may be multiple finite elements associated with
-      // this object. hop along the list of index sets until we
-      // find the one with the correct fe_index, and then poke
-      // into that part. trigger an exception if we can't find a
-      // set for this particular fe_index
-      const unsigned int starting_offset = dof_offsets[obj_index];
-      const types::global_dof_index *pointer = &dofs[starting_offset];
-      unsigned int counter = 0;
-      while (true)
-        {
-          Assert (*pointer != numbers::invalid_dof_index,
-                  ExcInternalError());
-
-          const unsigned int fe_index = *pointer;
-
-          Assert (fe_index < dof_handler.get_fe_collection().size(),
-                  ExcInternalError());
-
-          if (counter == n)
-            return fe_index;
-
-          ++counter;
-          pointer += dof_handler.get_fe(fe_index)
-                     .template n_dofs_per_object<structdim>() + 1;
-        }
+      return fe_indices[object_offsets[obj_index] + n];
     }
 
 
@@ -581,8 +586,8 @@ namespace internal
                         const unsigned int                fe_index,
                         const unsigned int                /*obj_level*/) const
     {
-      Assert (obj_index < dof_offsets.size(),
-              ExcIndexRange (obj_index, 0, static_cast<unsigned int>(dof_offsets.size())));
+      Assert (obj_index+1 < object_offsets.size(),
+              ExcIndexRange (obj_index, 0, static_cast<unsigned int>(object_offsets.size()-1)));
       Assert ((fe_index != dealii::hp::DoFHandler<dim,spacedim>::default_fe_index),
               ExcMessage ("You need to specify a FE index when working "
                           "with hp DoFHandlers"));
@@ -592,32 +597,18 @@ namespace internal
       // make sure we are on an
       // object for which DoFs have
       // been allocated at all
-      Assert (dof_offsets[obj_index] != numbers::invalid_unsigned_int,
+      Assert (object_offsets[obj_index] != object_offsets[obj_index+1],
               ExcMessage ("You are trying to access degree of freedom "
                           "information for an object on which no such "
                           "information is available"));
 
       Assert (structdim<dim, ExcMessage ("This object can not be used for cells."));
+      (void)dof_handler;
 
-      // there may be multiple finite elements associated with
-      // this object. hop along the list of index sets until we
-      // find the one with the correct fe_index, and then poke
-      // into that part. trigger an exception if we can't find a
-      // set for this particular fe_index
-      const types::global_dof_index starting_offset = dof_offsets[obj_index];
-      const types::global_dof_index *pointer = &dofs[starting_offset];
-      while (true)
-        {
-          if (*pointer == numbers::invalid_dof_index)
-            // end of list reached
-            return false;
-          else if (*pointer == fe_index)
-            return true;
-          else
-            pointer += static_cast<types::global_dof_index>(
-                         dof_handler.get_fe(*pointer)
-                         .template n_dofs_per_object<structdim>()+1);
-        }
+      for (unsigned int s=object_offsets[obj_index]; s<object_offsets[obj_index+1]; ++s)
+        if (fe_indices[s] == fe_index)
+          return true;
+      return false;
     }
 
     template <int structdim>
@@ -625,8 +616,10 @@ namespace internal
     void DoFIndicesOnFacesOrEdges<structdim>::serialize(Archive &ar,
                                                         const unsigned int)
     {
-      ar &dofs;
+      ar &object_offsets;
+      ar &fe_indices;
       ar &dof_offsets;
+      ar &dofs;
     }
 
 
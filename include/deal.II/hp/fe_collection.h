@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2003 - 2016 by the deal.II authors
+// Copyright (C) 2003 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -17,11 +17,15 @@
 #define dealii_fe_collection_h
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/thread_management.h>
 #include <deal.II/fe/fe.h>
 #include <deal.II/fe/fe_values_extractors.h>
 #include <deal.II/fe/component_mask.h>
 
+#include <map>
 #include <memory>
+#include <set>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -237,10 +241,44 @@ namespace hp
      * is to return FiniteElementDomination::no_requirements when comparing
      * for face domination. This, therefore, can't be considered as a
      * dominating element in the sense described above .
+     *
+     * The result for each set @p fes is computed only once and then stored
+     * in this object, such that repeated calls with the same argument, as
+     * they happen on every face with the same combination of elements when
+     * building hanging node constraints, only look up the stored value.
      */
     unsigned int
     find_least_face_dominating_fe (const std::set<unsigned int> &fes) const;
 
+    /**
+     * Return the matrix that interpolates from the face degrees of freedom
+     * of the element with index @p source_fe_index to those of the element
+     * with index @p fe_index, as computed by
+     * FiniteElement::get_face_interpolation_matrix() of the latter. The
+     * matrix has as many rows as the source element has degrees of freedom
+     * per face and as many columns as the element @p fe_index.
+     *
+     * The matrix is computed the first time it is requested and then stored
+     * in this object until another element is added to the collection, so
+     * functions that need the matrix on many faces, such as
+     * DoFTools::make_hanging_node_constraints(), do not need to recompute it
+     * every time they are called. This function can be called concurrently
+     * from several threads.
+     */
+    const FullMatrix<double> &
+    get_face_interpolation_matrix (const unsigned int fe_index,
+                                   const unsigned int source_fe_index) const;
+
+    /**
+     * Same as get_face_interpolation_matrix(), but for the interpolation to
+     * the child face @p subface of the face, as computed by
+     * FiniteElement::get_subface_interpolation_matrix().
+     */
+    const FullMatrix<double> &
+    get_subface_interpolation_matrix (const unsigned int fe_index,
+                                      const unsigned int source_fe_index,
+                                      const unsigned int subface) const;
+
     /**
      * Return a component mask with as many elements as this object has vector
      * components and of which exactly the one component is true that
@@ -444,6 +482,28 @@ namespace hp
      * Array of pointers to the finite elements stored by this collection.
      */
     std::vector<std::shared_ptr<const FiniteElement<dim,spacedim> > > finite_elements;
+
+    /**
+     * The face interpolation matrices computed so far, indexed by the two
+     * element indices. Empty entries have not been requested yet.
+     */
+    mutable Table<2,std::shared_ptr<const FullMatrix<double> > > face_interpolation_matrices;
+
+    /**
+     * The subface interpolation matrices computed so far, indexed by the two
+     * element indices and the number of the subface.
+     */
+    mutable Table<3,std::shared_ptr<const FullMatrix<double> > > subface_interpolation_matrices;
+
+    /**
+     * The results of find_least_face_dominating_fe() computed so far.
+     */
+    mutable std::map<std::set<unsigned int>,unsigned int> least_face_dominating_fes;
+
+    /**
+     * A lock that guards the creation of entries in the three caches above.
+     */
+    mutable Threads::Mutex cache_mutex;
   };
 
 
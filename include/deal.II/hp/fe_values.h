@@ -25,6 +25,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -109,6 +110,33 @@ namespace internal
        */
       const FEValuesType &get_present_fe_values () const;
 
+      /**
+       * Create the FE*Values objects for all finite elements of the
+       * collection, combined with the mapping and quadrature that the
+       * reinit() functions select by default for the corresponding
+       * active_fe_index, i.e., the mapping and quadrature object of the same
+       * index or the single element of a collection of size one.
+       *
+       * Calling this function after construction moves the initialization
+       * of the underlying objects, which includes the evaluation of the shape
+       * functions at the quadrature points and the allocation of all their
+       * memory, out of the first loop over the cells. This is mostly useful
+       * for the face variants, which would otherwise create their objects on
+       * the first face of a given kind that is visited deep inside the
+       * assembly loop.
+       */
+      void precalculate_fe_values ();
+
+      /**
+       * Create the FE*Values object for the given combination of finite
+       * element, mapping, and quadrature indices unless it already exists.
+       * Use this function if the reinit() functions are called with indices
+       * different from the default ones.
+       */
+      void precalculate_fe_values (const unsigned int fe_index,
+                                   const unsigned int mapping_index,
+                                   const unsigned int q_index);
+
     protected:
 
       /**
@@ -151,7 +179,8 @@ namespace internal
        * within the q_collection.
        *
        * Initially, all entries have zero pointers, and we will allocate them
-       * lazily as needed in select_fe_values().
+       * lazily as needed in select_fe_values() or up front in
+       * precalculate_fe_values().
        */
       dealii::Table<3,std::shared_ptr<FEValuesType> > fe_values_table;
 
@@ -215,7 +244,18 @@ namespace hp
    * Note that ::FEValues objects are created on the fly, i.e. only as they
    * are needed. This ensures that we do not create objects for every
    * combination of finite element, quadrature formula and mapping, but only
-   * those that will actually be needed.
+   * those that will actually be needed. If the setup cost should not be
+   * incurred inside the loop over the cells, the objects for the default
+   * combinations can be created up front by precalculate_fe_values().
+   *
+   * Every ::FEValues object in the collection detects on its own whether the
+   * present cell is a translation of the cell it was last initialized with
+   * and then skips the recomputation of the mapping data (see
+   * CellSimilarity). On meshes where cells with different active_fe_index
+   * alternate, this information as well as the data of the ::FEValues
+   * objects in the caches is lost on most calls to reinit(). Visiting the
+   * cells in the order returned by hp::cells_sorted_by_active_fe_index()
+   * keeps working on the same ::FEValues object as long as possible.
    *
    * This class has not yet been implemented for the use in the codimension
    * one case (<tt>spacedim != dim </tt>).
@@ -583,6 +623,39 @@ namespace hp
             const unsigned int fe_index      = numbers::invalid_unsigned_int);
   };
 
+
+  /**
+   * Return the active cells of @p dof_handler sorted by their
+   * active_fe_index. Within each group of cells with the same
+   * active_fe_index, the cells appear in the order of the usual traversal
+   * with DoFHandler::begin_active(), which preserves the locality of that
+   * order. If @p only_locally_owned is set, only the locally owned cells are
+   * returned, otherwise all cells that are not artificial.
+   *
+   * Running the loop over the cells of an hp assembly on the returned vector
+   * instead of the cell iterators means that hp::FEValues, hp::FEFaceValues,
+   * and hp::FESubfaceValues switch between their underlying objects only
+   * once per finite element of the collection, which retains the reuse of
+   * the mapping data on similar cells and the cache contents of the object
+   * in use:
+   * @code
+   *   const std::vector<typename hp::DoFHandler<dim>::active_cell_iterator>
+   *   cells = hp::cells_sorted_by_active_fe_index (dof_handler);
+   *   for (unsigned int i=0; i<cells.size(); ++i)
+   *     {
+   *       hp_fe_values.reinit (cells[i]);
+   *       ...
+   *     }
+   * @endcode
+   *
+   * The function can also be used for other DoFHandler types, for which all
+   * cells have active_fe_index zero.
+   */
+  template <typename DoFHandlerType>
+  std::vector<typename DoFHandlerType::active_cell_iterator>
+  cells_sorted_by_active_fe_index (const DoFHandlerType &dof_handler,
+                                   const bool            only_locally_owned = true);
+
 }
 
 
@@ -643,6 +716,38 @@ namespace internal
 
 }
 
+
+
+namespace hp
+{
+  template <typename DoFHandlerType>
+  std::vector<typename DoFHandlerType::active_cell_iterator>
+  cells_sorted_by_active_fe_index (const DoFHandlerType &dof_handler,
+                                   const bool            only_locally_owned)
+  {
+    // a counting sort that keeps the traversal order within each index
+    std::vector<unsigned int> n_cells_per_index (dof_handler.get_fe_collection().size()+1, 0);
+    for (typename DoFHandlerType::active_cell_iterator cell = dof_handler.begin_active();
+         cell != dof_handler.end(); ++cell)
+      if (only_locally_owned ? cell->is_locally_owned() : !cell->is_artificial())
+        {
+          AssertIndexRange (cell->active_fe_index(), n_cells_per_index.size()-1);
+          ++n_cells_per_index[cell->active_fe_index()+1];
+        }
+    for (unsigned int i=1; i<n_cells_per_index.size(); ++i)
+      n_cells_per_index[i] += n_cells_per_index[i-1];
+
+    std::vector<typename DoFHandlerType::active_cell_iterator>
+    sorted_cells (n_cells_per_index.back());
+    for (typename DoFHandlerType::active_cell_iterator cell = dof_handler.begin_active();
+         cell != dof_handler.end(); ++cell)
+      if (only_locally_owned ? cell->is_locally_owned() : !cell->is_artificial())
+        sorted_cells[n_cells_per_index[cell->active_fe_index()]++] = cell;
+
+    return sorted_cells;
+  }
+}
+
 DEAL_II_NAMESPACE_CLOSE
 
 #endif
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2010 - 2016 by the deal.II authors
+// Copyright (C) 2010 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -21,6 +21,7 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/quadrature.h>
 #include <deal.II/lac/full_matrix.h>
+#include <deal.II/integrators/matrix_kernels.h>
 #include <deal.II/fe/mapping.h>
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/meshworker/dof_info.h>
@@ -63,20 +64,21 @@ namespace LocalIntegrators
       AssertDimension(M.m(), t_dofs);
       AssertDimension(M.n(), n_dofs);
 
+      // gather the weighted test functions and the divergences of the trial
+      // functions into contiguous tables and multiply them in one go
+      internal::LocalIntegrators::ShapeTable
+      test_values (t_dofs, fe.n_quadrature_points),
+                  divergences (n_dofs, fe.n_quadrature_points);
       for (unsigned int k=0; k<fe.n_quadrature_points; ++k)
         {
           const double dx = fe.JxW(k) * factor;
           for (unsigned int i=0; i<t_dofs; ++i)
-            {
-              const double vv = fetest.shape_value(i,k);
-              for (unsigned int d=0; d<dim; ++d)
-                for (unsigned int j=0; j<n_dofs; ++j)
-                  {
-                    const double du = fe.shape_grad_component(j,k,d)[d];
-                    M(i,j) += dx * du * vv;
-                  }
-            }
+            test_values(k,i) = dx * fetest.shape_value(i,k);
+          for (unsigned int j=0; j<n_dofs; ++j)
+            for (unsigned int d=0; d<dim; ++d)
+              divergences(k,j) += fe.shape_grad_component(j,k,d)[d];
         }
+      internal::LocalIntegrators::add_matrix_products(M, test_values, divergences, false);
     }
 
     /**
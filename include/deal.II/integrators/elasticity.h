@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2010 - 2016 by the deal.II authors
+// Copyright (C) 2010 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -21,6 +21,7 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/quadrature.h>
 #include <deal.II/lac/full_matrix.h>
+#include <deal.II/integrators/matrix_kernels.h>
 #include <deal.II/fe/mapping.h>
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/meshworker/dof_info.h>
@@ -56,17 +57,30 @@ namespace LocalIntegrators
       AssertDimension(M.m(), n_dofs);
       AssertDimension(M.n(), n_dofs);
 
+      // gather the entries of the symmetric gradients, with and without the
+      // quadrature weight, into contiguous tables and multiply them in one go
+      const unsigned int n_entries = dim*dim;
+      internal::LocalIntegrators::ShapeTable
+      strains (n_dofs, fe.n_quadrature_points*n_entries),
+               weighted_strains (n_dofs, fe.n_quadrature_points*n_entries);
       for (unsigned int k=0; k<fe.n_quadrature_points; ++k)
         {
           const double dx = factor * fe.JxW(k);
           for (unsigned int i=0; i<n_dofs; ++i)
-            for (unsigned int j=0; j<n_dofs; ++j)
+            {
+              Tensor<2,dim> grad;
+              for (unsigned int d=0; d<dim; ++d)
+                grad[d] = fe.shape_grad_component(i,k,d);
               for (unsigned int d1=0; d1<dim; ++d1)
                 for (unsigned int d2=0; d2<dim; ++d2)
-                  M(i,j) += dx * .25 *
-                            (fe.shape_grad_component(j,k,d1)[d2] + fe.shape_grad_component(j,k,d2)[d1]) *
-                            (fe.shape_grad_component(i,k,d1)[d2] + fe.shape_grad_component(i,k,d2)[d1]);
+                  {
+                    const double strain = .5 * (grad[d1][d2] + grad[d2][d1]);
+                    strains(k*n_entries+d1*dim+d2,i) = strain;
+                    weighted_strains(k*n_entries+d1*dim+d2,i) = dx * strain;
+                  }
+            }
         }
+      internal::LocalIntegrators::add_matrix_products(M, weighted_strains, strains, true);
     }
 
 
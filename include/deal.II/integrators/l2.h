@@ -21,6 +21,7 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/quadrature.h>
 #include <deal.II/lac/full_matrix.h>
+#include <deal.II/integrators/matrix_kernels.h>
 #include <deal.II/fe/mapping.h>
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/meshworker/dof_info.h>
@@ -57,33 +58,26 @@ namespace LocalIntegrators
     {
       const unsigned int n_dofs = fe.dofs_per_cell;
       const unsigned int n_components = fe.get_fe().n_components();
+      AssertDimension(M.m(), n_dofs);
+      AssertDimension(M.n(), n_dofs);
 
+      // gather the shape values, with and without the quadrature weight,
+      // into contiguous tables and multiply them in one go
+      internal::LocalIntegrators::ShapeTable
+      values (n_dofs, fe.n_quadrature_points*n_components),
+              weighted_values (n_dofs, fe.n_quadrature_points*n_components);
       for (unsigned int k=0; k<fe.n_quadrature_points; ++k)
         {
           const double dx = fe.JxW(k) * factor;
-          for (unsigned int i=0; i<n_dofs; ++i)
-            {
-              double Mii = 0.0;
-              for (unsigned int d=0; d<n_components; ++d)
-                Mii += dx
-                       * fe.shape_value_component(i,k,d)
-                       * fe.shape_value_component(i,k,d);
-
-              M(i,i) += Mii;
-
-              for (unsigned int j=i+1; j<n_dofs; ++j)
-                {
-                  double Mij = 0.0;
-                  for (unsigned int d=0; d<n_components; ++d)
-                    Mij += dx
-                           * fe.shape_value_component(j,k,d)
-                           * fe.shape_value_component(i,k,d);
-
-                  M(i,j) += Mij;
-                  M(j,i) += Mij;
-                }
-            }
+          for (unsigned int d=0; d<n_components; ++d)
+            for (unsigned int i=0; i<n_dofs; ++i)
+              {
+                const double phi = fe.shape_value_component(i,k,d);
+                values(k*n_components+d,i) = phi;
+                weighted_values(k*n_components+d,i) = dx * phi;
+              }
         }
+      internal::LocalIntegrators::add_matrix_products(M, weighted_values, values, true);
     }
 
     /**
@@ -113,32 +107,21 @@ namespace LocalIntegrators
       AssertDimension(M.n(), n_dofs);
       AssertDimension(weights.size(), fe.n_quadrature_points);
 
+      internal::LocalIntegrators::ShapeTable
+      values (n_dofs, fe.n_quadrature_points*n_components),
+              weighted_values (n_dofs, fe.n_quadrature_points*n_components);
       for (unsigned int k=0; k<fe.n_quadrature_points; ++k)
         {
           const double dx = fe.JxW(k) * weights[k];
-          for (unsigned int i=0; i<n_dofs; ++i)
-            {
-              double Mii = 0.0;
-              for (unsigned int d=0; d<n_components; ++d)
-                Mii += dx
-                       * fe.shape_value_component(i,k,d)
-                       * fe.shape_value_component(i,k,d);
-
-              M(i,i) += Mii;
-
-              for (unsigned int j=i+1; j<n_dofs; ++j)
-                {
-                  double Mij = 0.0;
-                  for (unsigned int d=0; d<n_components; ++d)
-                    Mij += dx
-                           * fe.shape_value_component(j,k,d)
-                           * fe.shape_value_component(i,k,d);
-
-                  M(i,j) += Mij;
-                  M(j,i) += Mij;
-                }
-            }
+          for (unsigned int d=0; d<n_components; ++d)
+            for (unsigned int i=0; i<n_dofs; ++i)
+              {
+                const double phi = fe.shape_value_component(i,k,d);
+                values(k*n_components+d,i) = phi;
+                weighted_values(k*n_components+d,i) = dx * phi;
+              }
         }
+      internal::LocalIntegrators::add_matrix_products(M, weighted_values, values, true);
     }
 
     /**
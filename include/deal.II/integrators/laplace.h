@@ -21,6 +21,7 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/quadrature.h>
 #include <deal.II/lac/full_matrix.h>
+#include <deal.II/integrators/matrix_kernels.h>
 #include <deal.II/fe/mapping.h>
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/meshworker/dof_info.h>
@@ -56,32 +57,30 @@ namespace LocalIntegrators
     {
       const unsigned int n_dofs = fe.dofs_per_cell;
       const unsigned int n_components = fe.get_fe().n_components();
-
+      AssertDimension(M.m(), n_dofs);
+      AssertDimension(M.n(), n_dofs);
+
+      // gather the components of the shape gradients, with and without the
+      // quadrature weight, into contiguous tables and multiply them in one go
+      const unsigned int n_entries = n_components*dim;
+      internal::LocalIntegrators::ShapeTable
+      gradients (n_dofs, fe.n_quadrature_points*n_entries),
+                 weighted_gradients (n_dofs, fe.n_quadrature_points*n_entries);
       for (unsigned int k=0; k<fe.n_quadrature_points; ++k)
         {
           const double dx = fe.JxW(k) * factor;
-          for (unsigned int i=0; i<n_dofs; ++i)
-            {
-              double Mii = 0.0;
-              for (unsigned int d=0; d<n_components; ++d)
-                Mii += dx *
-                       (fe.shape_grad_component(i,k,d) * fe.shape_grad_component(i,k,d));
-
-              M(i,i) += Mii;
-
-              for (unsigned int j=i+1; j<n_dofs; ++j)
-                {
-                  double Mij = 0.0;
-                  for (unsigned int d=0; d<n_components; ++d)
-                    Mij += dx *
-                           (fe.shape_grad_component(j,k,d) * fe.shape_grad_component(i,k,d));
-
-                  M(i,j) += Mij;
-                  M(j,i) += Mij;
-                }
-            }
+          for (unsigned int c=0; c<n_components; ++c)
+            for (unsigned int i=0; i<n_dofs; ++i)
+              {
+                const Tensor<1,dim> grad = fe.shape_grad_component(i,k,c);
+                for (unsigned int d=0; d<dim; ++d)
+                  {
+                    gradients(k*n_entries+c*dim+d,i) = grad[d];
+                    weighted_gradients(k*n_entries+c*dim+d,i) = dx * grad[d];
+                  }
+              }
         }
-
+      internal::LocalIntegrators::add_matrix_products(M, weighted_gradients, gradients, true);
     }
 
     /**
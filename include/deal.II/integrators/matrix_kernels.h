@@ -0,0 +1,173 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_integrators_matrix_kernels_h
+#define dealii_integrators_matrix_kernels_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/lac/full_matrix.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace internal
+{
+  namespace LocalIntegrators
+  {
+    /**
+     * A table of the values of some quantity of all shape functions of a
+     * cell, e.g., the components of the gradients at all quadrature points,
+     * multiplied by the quadrature weights if desired. The table is stored
+     * with the shape function as the fastest running index and padded to a
+     * multiple of the length of VectorizedArray<double>, so that
+     * add_matrix_products() can load the entries of several shape functions
+     * at once.
+     */
+    class ShapeTable
+    {
+    public:
+      typedef VectorizedArray<double> vector_type;
+
+      /**
+       * Constructor. Sets up a table for @p n_dofs shape functions and @p
+       * n_entries entries per shape function, with all entries set to zero.
+       */
+      ShapeTable (const unsigned int n_dofs,
+                  const unsigned int n_entries)
+        :
+        n_dofs (n_dofs),
+        stride ((n_dofs + vector_type::n_array_elements - 1) /
+                vector_type::n_array_elements * vector_type::n_array_elements),
+        n_entries (n_entries)
+      {
+        data.resize_fast(stride * n_entries);
+        for (unsigned int i=0; i<data.size(); ++i)
+          data[i] = 0.;
+      }
+
+      /**
+       * Read-write access to entry @p entry of shape function @p dof.
+       */
+      double &operator() (const unsigned int entry,
+                          const unsigned int dof)
+      {
+        AssertIndexRange(entry, n_entries);
+        AssertIndexRange(dof, n_dofs);
+        return data[entry*stride+dof];
+      }
+
+      /**
+       * Read access to entry @p entry of shape function @p dof.
+       */
+      double operator() (const unsigned int entry,
+                         const unsigned int dof) const
+      {
+        AssertIndexRange(entry, n_entries);
+        AssertIndexRange(dof, n_dofs);
+        return data[entry*stride+dof];
+      }
+
+      /**
+       * Pointer to the entries @p entry of all shape functions.
+       */
+      const double *begin (const unsigned int entry) const
+      {
+        AssertIndexRange(entry, n_entries);
+        return data.begin()+entry*stride;
+      }
+
+      const unsigned int n_dofs;
+      const unsigned int stride;
+      const unsigned int n_entries;
+
+    private:
+      AlignedVector<double> data;
+    };
+
+
+
+    /**
+     * Add the products of the tables of the test and the trial functions
+     * to the matrix, i.e., $M_{ij} \mathrel{+}= \sum_e \text{test}(e,i)
+     * \, \text{trial}(e,j)$. The sum over the entries is the innermost loop
+     * and runs over several trial functions $j$ at once with
+     * VectorizedArray. If @p symmetric is set, the tables of the test and
+     * trial functions are assumed to describe the same bilinear form with
+     * the weights on either side, and only the upper triangle is computed
+     * and then mirrored to the lower one.
+     */
+    inline
+    void
+    add_matrix_products (FullMatrix<double> &M,
+                         const ShapeTable   &test,
+                         const ShapeTable   &trial,
+                         const bool          symmetric)
+    {
+      typedef ShapeTable::vector_type vector_type;
+      const unsigned int n_lanes = vector_type::n_array_elements;
+      AssertDimension(M.m(), test.n_dofs);
+      AssertDimension(M.n(), trial.n_dofs);
+      AssertDimension(test.n_entries, trial.n_entries);
+      Assert(symmetric == false || test.n_dofs == trial.n_dofs,
+             ExcMessage("Only square matrices can be symmetric"));
+
+      const unsigned int n_entries = test.n_entries;
+      const unsigned int n_blocks = trial.stride / n_lanes;
+      AlignedVector<vector_type> row (n_blocks);
+      for (unsigned int i=0; i<test.n_dofs; ++i)
+        {
+          // in the symmetric case, start with the block that contains the
+          // diagonal entry
+          const unsigned int first_block = symmetric ? i / n_lanes : 0;
+          for (unsigned int jb=first_block; jb<n_blocks; ++jb)
+            row[jb] = vector_type();
+          for (unsigned int e=0; e<n_entries; ++e)
+            {
+              const double test_value = test.begin(e)[i];
+              if (test_value == 0.)
+                continue;
+              vector_type test_vector;
+              test_vector = test_value;
+              const double *trial_values = trial.begin(e);
+              for (unsigned int jb=first_block; jb<n_blocks; ++jb)
+                {
+                  vector_type trial_vector;
+                  trial_vector.load(trial_values+jb*n_lanes);
+                  row[jb] += test_vector * trial_vector;
+                }
+            }
+
+          double *M_row = &M(i,0);
+          if (symmetric)
+            {
+              for (unsigned int j=i; j<trial.n_dofs; ++j)
+                M_row[j] += row[j/n_lanes][j%n_lanes];
+              for (unsigned int j=i+1; j<trial.n_dofs; ++j)
+                M(j,i) += row[j/n_lanes][j%n_lanes];
+            }
+          else
+            for (unsigned int j=0; j<trial.n_dofs; ++j)
+              M_row[j] += row[j/n_lanes][j%n_lanes];
+        }
+    }
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -21,6 +21,7 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/quadrature.h>
 #include <deal.II/lac/full_matrix.h>
+#include <deal.II/integrators/matrix_kernels.h>
 #include <deal.II/fe/mapping.h>
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/meshworker/dof_info.h>
@@ -187,22 +188,27 @@ namespace LocalIntegrators
       // all dimensions
       const unsigned int d_max = (dim==2) ? 1 : dim;
 
+      // gather the components of the curls, with and without the
+      // quadrature weight, into contiguous tables and multiply them in one
+      // go
+      internal::LocalIntegrators::ShapeTable
+      curls (n_dofs, fe.n_quadrature_points*d_max),
+             weighted_curls (n_dofs, fe.n_quadrature_points*d_max);
       for (unsigned int k=0; k<fe.n_quadrature_points; ++k)
         {
           const double dx = factor * fe.JxW(k);
           for (unsigned int i=0; i<n_dofs; ++i)
-            for (unsigned int j=0; j<n_dofs; ++j)
-              for (unsigned int d=0; d<d_max; ++d)
-                {
-                  const unsigned int d1 = (d+1)%dim;
-                  const unsigned int d2 = (d+2)%dim;
-
-                  const double cv = fe.shape_grad_component(i,k,d2)[d1] - fe.shape_grad_component(i,k,d1)[d2];
-                  const double cu = fe.shape_grad_component(j,k,d2)[d1] - fe.shape_grad_component(j,k,d1)[d2];
-
-                  M(i,j) += dx * cu * cv;
-                }
+            for (unsigned int d=0; d<d_max; ++d)
+              {
+                const unsigned int d1 = (d+1)%dim;
+                const unsigned int d2 = (d+2)%dim;
+
+                const double curl = fe.shape_grad_component(i,k,d2)[d1] - fe.shape_grad_component(i,k,d1)[d2];
+                curls(k*d_max+d,i) = curl;
+                weighted_curls(k*d_max+d,i) = dx * curl;
+              }
         }
+      internal::LocalIntegrators::add_matrix_products(M, weighted_curls, curls, true);
     }
 
     /**
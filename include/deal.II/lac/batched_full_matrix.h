@@ -0,0 +1,715 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_batched_full_matrix_h
+#define dealii_batched_full_matrix_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/lapack_support.h>
+
+#include <cmath>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*! @addtogroup Matrix1
+ *@{
+ */
+
+
+/**
+ * A collection of many small dense square matrices of the same size, stored
+ * in an interleaved layout such that the operations of this class work on
+ * VectorizedArray<Number>::n_array_elements matrices at once. This is meant
+ * for algorithms that need to factorize or invert lots of local matrices,
+ * such as the static condensation of hybridizable discontinuous Galerkin
+ * methods (see step-51) or block-Jacobi smoothers for discontinuous
+ * elements, where calling FullMatrix::gauss_jordan() or
+ * LAPACKFullMatrix::invert() on each matrix separately is dominated by
+ * the overhead of the individual calls and does not use the vector units
+ * of the processor.
+ *
+ * <h3>Data layout</h3>
+ *
+ * The matrices are grouped into <i>batches</i> of
+ * VectorizedArray<Number>::n_array_elements matrices. An entry $(i,j)$ of a
+ * batch is a VectorizedArray whose lane $l$ holds the entry $(i,j)$ of the
+ * matrix with index <code>batch * n_array_elements + l</code>. If the
+ * number of matrices is not a multiple of the vectorization width, the
+ * unused lanes of the last batch are filled with identity matrices, so that
+ * all operations of this class are well-defined on them.
+ *
+ * Vectors that are multiplied by the matrices or that are passed to solve()
+ * use the same layout: an AlignedVector<VectorizedArray<Number>> of length
+ * n_batches()*n(), where the entry <code>batch*n()+i</code> contains
+ * component $i$ of the vectors of all matrices in the batch.
+ *
+ * <h3>Factorizations</h3>
+ *
+ * Like LAPACKFullMatrix, this class keeps track of what it currently stores
+ * in terms of a LAPACKSupport::State. After filling the matrices, one of
+ * compute_lu_factorization(), compute_cholesky_factorization(), or invert()
+ * can be called, followed by any number of calls to solve(). The LU
+ * factorization uses partial pivoting as in LAPACK's <code>getrf</code>:
+ * the pivot search and the row swaps are done separately for each lane,
+ * whereas the elimination itself, the part of the algorithm with cubic
+ * complexity, runs on full VectorizedArray entries. The Cholesky
+ * factorization does not need pivoting and is completely vectorized. The
+ * batches are distributed over the available threads.
+ *
+ * @ingroup Matrix1
+ */
+template <typename Number>
+class BatchedFullMatrix : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef unsigned int size_type;
+
+  /**
+   * Constructor. Initialize an empty object.
+   */
+  BatchedFullMatrix ();
+
+  /**
+   * Constructor. Set the number of matrices and their size, and initialize
+   * all entries to zero.
+   */
+  BatchedFullMatrix (const size_type n_matrices,
+                     const size_type size);
+
+  /**
+   * Set the number of matrices and their size, and initialize all entries
+   * to zero. The unused lanes of the last batch are set to identity
+   * matrices.
+   */
+  void reinit (const size_type n_matrices,
+               const size_type size);
+
+  /**
+   * Return the number of matrices stored in this object.
+   */
+  size_type n_matrices () const;
+
+  /**
+   * Return the number of batches, i.e., the number of matrices divided by
+   * the vectorization width and rounded up.
+   */
+  size_type n_batches () const;
+
+  /**
+   * Return the number of rows (and columns) of each matrix.
+   */
+  size_type n () const;
+
+  /**
+   * Read-write access to the entry $(i,j)$ of all matrices in the given
+   * batch.
+   */
+  VectorizedArray<Number> &operator() (const size_type batch,
+                                       const size_type i,
+                                       const size_type j);
+
+  /**
+   * Read access to the entry $(i,j)$ of all matrices in the given batch.
+   */
+  const VectorizedArray<Number> &operator() (const size_type batch,
+                                             const size_type i,
+                                             const size_type j) const;
+
+  /**
+   * Copy the given matrix into the slot with index @p index. The matrix
+   * must be of size n() times n(). This resets the state of the object to
+   * LAPACKSupport::matrix, so all matrices should be set before calling one
+   * of the factorization functions.
+   */
+  template <typename Number2>
+  void set_matrix (const size_type           index,
+                   const FullMatrix<Number2> &matrix);
+
+  /**
+   * Copy the content of slot @p index, i.e., the matrix, its factorization,
+   * or its inverse depending on the current state, into the given matrix,
+   * which is resized if necessary.
+   */
+  template <typename Number2>
+  void get_matrix (const size_type      index,
+                   FullMatrix<Number2> &matrix) const;
+
+  /**
+   * Compute the LU factorization with partial pivoting of all matrices. If
+   * one of the matrices is singular, an exception of type
+   * LACExceptions::ExcSingular is thrown.
+   */
+  void compute_lu_factorization ();
+
+  /**
+   * Compute the Cholesky factorization $A=LL^T$ of all matrices, which must
+   * be symmetric and positive definite. Only the lower triangle of the
+   * matrices is accessed. If one of the matrices is not positive definite,
+   * an exception of type LACExceptions::ExcSingular is thrown.
+   */
+  void compute_cholesky_factorization ();
+
+  /**
+   * Replace all matrices by their inverses. If the object holds matrices,
+   * the LU factorization is computed first. If it already holds an LU or
+   * Cholesky factorization, the inverse is computed from the factors.
+   */
+  void invert ();
+
+  /**
+   * Solve the linear systems with the matrices of this object for the right
+   * hand sides given in @p rhs_and_solution, which is overwritten by the
+   * solution. The vector must be laid out as described in the class
+   * documentation. The object must contain an LU or Cholesky factorization
+   * or the inverse matrices.
+   */
+  void solve (AlignedVector<VectorizedArray<Number> > &rhs_and_solution) const;
+
+  /**
+   * Matrix-vector multiplication with all matrices, $dst = A \, src$, with
+   * vectors laid out as described in the class documentation. The object
+   * must contain the matrices or their inverses.
+   */
+  void vmult (AlignedVector<VectorizedArray<Number> >       &dst,
+              const AlignedVector<VectorizedArray<Number> > &src) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * Compute the LU factorization of the matrices in the given batch.
+   */
+  void lu_factorize_batch (const size_type batch);
+
+  /**
+   * Compute the Cholesky factorization of the matrices in the given batch.
+   */
+  void cholesky_factorize_batch (const size_type batch);
+
+  /**
+   * Solve with the factorization of the given batch in place for the vector
+   * starting at @p vector. The function reads the factors from @p factors,
+   * which is either the data field of this class or a copy of the factors of
+   * the batch.
+   */
+  void solve_batch (const size_type                batch,
+                    const VectorizedArray<Number> *factors,
+                    VectorizedArray<Number>       *vector) const;
+
+  /**
+   * The number of matrices.
+   */
+  size_type n_mat;
+
+  /**
+   * The size of the matrices.
+   */
+  size_type n_rows;
+
+  /**
+   * The entries of all matrices. The entry $(i,j)$ of batch <code>b</code>
+   * is stored at position <code>(b*n_rows+i)*n_rows+j</code>.
+   */
+  AlignedVector<VectorizedArray<Number> > data;
+
+  /**
+   * The pivot rows chosen by the LU factorization. Entry
+   * <code>(b*n_rows+k)*n_array_elements+l</code> holds the row that was
+   * swapped with row $k$ in lane $l$ of batch $b$.
+   */
+  std::vector<size_type> pivots;
+
+  /**
+   * What the object currently stores.
+   */
+  LAPACKSupport::State state;
+};
+
+/*@}*/
+
+
+#ifndef DOXYGEN
+/*----------------------- Inline functions ----------------------------------*/
+
+
+template <typename Number>
+inline
+BatchedFullMatrix<Number>::BatchedFullMatrix ()
+  :
+  n_mat (0),
+  n_rows (0),
+  state (LAPACKSupport::matrix)
+{}
+
+
+
+template <typename Number>
+inline
+BatchedFullMatrix<Number>::BatchedFullMatrix (const size_type n_matrices,
+                                              const size_type size)
+  :
+  n_mat (0),
+  n_rows (0),
+  state (LAPACKSupport::matrix)
+{
+  reinit (n_matrices, size);
+}
+
+
+
+template <typename Number>
+inline
+void
+BatchedFullMatrix<Number>::reinit (const size_type n_matrices,
+                                   const size_type size)
+{
+  n_mat = n_matrices;
+  n_rows = size;
+  data.resize_fast (n_batches()*n_rows*n_rows);
+  data.fill (make_vectorized_array (Number()));
+  pivots.clear ();
+  state = LAPACKSupport::matrix;
+
+  // put identity matrices into the unused lanes of the last batch to keep
+  // the factorizations well-defined
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  if (n_mat % n_lanes != 0)
+    for (size_type i=0; i<n_rows; ++i)
+      for (unsigned int l=n_mat%n_lanes; l<n_lanes; ++l)
+        (*this)(n_batches()-1, i, i)[l] = 1.;
+}
+
+
+
+template <typename Number>
+inline
+typename BatchedFullMatrix<Number>::size_type
+BatchedFullMatrix<Number>::n_matrices () const
+{
+  return n_mat;
+}
+
+
+
+template <typename Number>
+inline
+typename BatchedFullMatrix<Number>::size_type
+BatchedFullMatrix<Number>::n_batches () const
+{
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  return (n_mat + n_lanes - 1) / n_lanes;
+}
+
+
+
+template <typename Number>
+inline
+typename BatchedFullMatrix<Number>::size_type
+BatchedFullMatrix<Number>::n () const
+{
+  return n_rows;
+}
+
+
+
+template <typename Number>
+inline
+VectorizedArray<Number> &
+BatchedFullMatrix<Number>::operator() (const size_type batch,
+                                       const size_type i,
+                                       const size_type j)
+{
+  AssertIndexRange (batch, n_batches());
+  AssertIndexRange (i, n_rows);
+  AssertIndexRange (j, n_rows);
+  return data[(batch*n_rows+i)*n_rows+j];
+}
+
+
+
+template <typename Number>
+inline
+const VectorizedArray<Number> &
+BatchedFullMatrix<Number>::operator() (const size_type batch,
+                                       const size_type i,
+                                       const size_type j) const
+{
+  AssertIndexRange (batch, n_batches());
+  AssertIndexRange (i, n_rows);
+  AssertIndexRange (j, n_rows);
+  return data[(batch*n_rows+i)*n_rows+j];
+}
+
+
+
+template <typename Number>
+template <typename Number2>
+inline
+void
+BatchedFullMatrix<Number>::set_matrix (const size_type            index,
+                                       const FullMatrix<Number2> &matrix)
+{
+  AssertIndexRange (index, n_mat);
+  AssertDimension (matrix.m(), n_rows);
+  AssertDimension (matrix.n(), n_rows);
+
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  const size_type batch = index / n_lanes;
+  const unsigned int lane = index % n_lanes;
+  for (size_type i=0; i<n_rows; ++i)
+    for (size_type j=0; j<n_rows; ++j)
+      (*this)(batch, i, j)[lane] = matrix(i,j);
+  state = LAPACKSupport::matrix;
+}
+
+
+
+template <typename Number>
+template <typename Number2>
+inline
+void
+BatchedFullMatrix<Number>::get_matrix (const size_type      index,
+                                       FullMatrix<Number2> &matrix) const
+{
+  AssertIndexRange (index, n_mat);
+
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  const size_type batch = index / n_lanes;
+  const unsigned int lane = index % n_lanes;
+  matrix.reinit (n_rows, n_rows);
+  for (size_type i=0; i<n_rows; ++i)
+    for (size_type j=0; j<n_rows; ++j)
+      matrix(i,j) = (*this)(batch, i, j)[lane];
+}
+
+
+
+template <typename Number>
+inline
+void
+BatchedFullMatrix<Number>::lu_factorize_batch (const size_type batch)
+{
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  VectorizedArray<Number> *a = &data[batch*n_rows*n_rows];
+  size_type *pivot = &pivots[batch*n_rows*n_lanes];
+
+  for (size_type k=0; k<n_rows; ++k)
+    {
+      // the pivot search and the row interchanges differ between the lanes,
+      // so do them lane by lane. this is only quadratic work
+      for (unsigned int l=0; l<n_lanes; ++l)
+        {
+          size_type p = k;
+          Number max_value = std::abs(a[k*n_rows+k][l]);
+          for (size_type i=k+1; i<n_rows; ++i)
+            if (std::abs(a[i*n_rows+k][l]) > max_value)
+              {
+                max_value = std::abs(a[i*n_rows+k][l]);
+                p = i;
+              }
+          AssertThrow (max_value != Number(), LACExceptions::ExcSingular());
+
+          pivot[k*n_lanes+l] = p;
+          if (p != k)
+            for (size_type j=0; j<n_rows; ++j)
+              std::swap (a[k*n_rows+j][l], a[p*n_rows+j][l]);
+        }
+
+      // the elimination is the same for all lanes
+      const VectorizedArray<Number> inv_pivot = Number(1.) / a[k*n_rows+k];
+      for (size_type i=k+1; i<n_rows; ++i)
+        {
+          a[i*n_rows+k] *= inv_pivot;
+          const VectorizedArray<Number> factor = a[i*n_rows+k];
+          for (size_type j=k+1; j<n_rows; ++j)
+            a[i*n_rows+j] -= factor * a[k*n_rows+j];
+        }
+    }
+}
+
+
+
+template <typename Number>
+inline
+void
+BatchedFullMatrix<Number>::cholesky_factorize_batch (const size_type batch)
+{
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  VectorizedArray<Number> *a = &data[batch*n_rows*n_rows];
+
+  for (size_type j=0; j<n_rows; ++j)
+    {
+      VectorizedArray<Number> diagonal = a[j*n_rows+j];
+      for (size_type k=0; k<j; ++k)
+        diagonal -= a[j*n_rows+k] * a[j*n_rows+k];
+      for (unsigned int l=0; l<n_lanes; ++l)
+        AssertThrow (diagonal[l] > Number(), LACExceptions::ExcSingular());
+      a[j*n_rows+j] = std::sqrt(diagonal);
+
+      const VectorizedArray<Number> inv_diagonal = Number(1.) / a[j*n_rows+j];
+      for (size_type i=j+1; i<n_rows; ++i)
+        {
+          VectorizedArray<Number> sum = a[i*n_rows+j];
+          for (size_type k=0; k<j; ++k)
+            sum -= a[i*n_rows+k] * a[j*n_rows+k];
+          a[i*n_rows+j] = sum * inv_diagonal;
+        }
+    }
+}
+
+
+
+template <typename Number>
+inline
+void
+BatchedFullMatrix<Number>::compute_lu_factorization ()
+{
+  Assert (state == LAPACKSupport::matrix, LAPACKSupport::ExcState(state));
+
+  pivots.resize (n_batches()*n_rows*VectorizedArray<Number>::n_array_elements);
+  parallel::apply_to_subranges (0U, n_batches(),
+                                [this] (const size_type begin,
+                                        const size_type end)
+  {
+    for (size_type batch=begin; batch<end; ++batch)
+      lu_factorize_batch (batch);
+  },
+  1);
+  state = LAPACKSupport::lu;
+}
+
+
+
+template <typename Number>
+inline
+void
+BatchedFullMatrix<Number>::compute_cholesky_factorization ()
+{
+  Assert (state == LAPACKSupport::matrix, LAPACKSupport::ExcState(state));
+
+  parallel::apply_to_subranges (0U, n_batches(),
+                                [this] (const size_type begin,
+                                        const size_type end)
+  {
+    for (size_type batch=begin; batch<end; ++batch)
+      cholesky_factorize_batch (batch);
+  },
+  1);
+  state = LAPACKSupport::cholesky;
+}
+
+
+
+template <typename Number>
+inline
+void
+BatchedFullMatrix<Number>::solve_batch (const size_type                batch,
+                                        const VectorizedArray<Number> *a,
+                                        VectorizedArray<Number>       *x) const
+{
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  if (state == LAPACKSupport::lu)
+    {
+      // apply the row interchanges in the order of the factorization
+      const size_type *pivot = &pivots[batch*n_rows*n_lanes];
+      for (size_type k=0; k<n_rows; ++k)
+        for (unsigned int l=0; l<n_lanes; ++l)
+          if (pivot[k*n_lanes+l] != k)
+            std::swap (x[k][l], x[pivot[k*n_lanes+l]][l]);
+
+      // forward substitution with the unit lower triangular factor
+      for (size_type i=1; i<n_rows; ++i)
+        {
+          VectorizedArray<Number> sum = x[i];
+          for (size_type j=0; j<i; ++j)
+            sum -= a[i*n_rows+j] * x[j];
+          x[i] = sum;
+        }
+
+      // backward substitution with the upper triangular factor
+      for (size_type i=n_rows; i>0; --i)
+        {
+          VectorizedArray<Number> sum = x[i-1];
+          for (size_type j=i; j<n_rows; ++j)
+            sum -= a[(i-1)*n_rows+j] * x[j];
+          x[i-1] = sum / a[(i-1)*n_rows+i-1];
+        }
+    }
+  else
+    {
+      Assert (state == LAPACKSupport::cholesky,
+              LAPACKSupport::ExcState(state));
+
+      // forward substitution with L
+      for (size_type i=0; i<n_rows; ++i)
+        {
+          VectorizedArray<Number> sum = x[i];
+          for (size_type j=0; j<i; ++j)
+            sum -= a[i*n_rows+j] * x[j];
+          x[i] = sum / a[i*n_rows+i];
+        }
+
+      // backward substitution with L^T
+      for (size_type i=n_rows; i>0; --i)
+        {
+          VectorizedArray<Number> sum = x[i-1];
+          for (size_type j=i; j<n_rows; ++j)
+            sum -= a[j*n_rows+i-1] * x[j];
+          x[i-1] = sum / a[(i-1)*n_rows+i-1];
+        }
+    }
+}
+
+
+
+template <typename Number>
+inline
+void
+BatchedFullMatrix<Number>::invert ()
+{
+  if (state == LAPACKSupport::matrix)
+    compute_lu_factorization ();
+
+  Assert (state == LAPACKSupport::lu || state == LAPACKSupport::cholesky,
+          LAPACKSupport::ExcState(state));
+
+  parallel::apply_to_subranges (0U, n_batches(),
+                                [this] (const size_type begin,
+                                        const size_type end)
+  {
+    AlignedVector<VectorizedArray<Number> > factors (n_rows*n_rows);
+    AlignedVector<VectorizedArray<Number> > column (n_rows);
+    for (size_type batch=begin; batch<end; ++batch)
+      {
+        VectorizedArray<Number> *a = &data[batch*n_rows*n_rows];
+        for (size_type i=0; i<n_rows*n_rows; ++i)
+          factors[i] = a[i];
+
+        // solve with the unit vectors to get the columns of the inverse
+        for (size_type j=0; j<n_rows; ++j)
+          {
+            column.fill (make_vectorized_array (Number()));
+            column[j] = Number(1.);
+            solve_batch (batch, factors.begin(), column.begin());
+            for (size_type i=0; i<n_rows; ++i)
+              a[i*n_rows+j] = column[i];
+          }
+      }
+  },
+  1);
+  state = LAPACKSupport::inverse_matrix;
+}
+
+
+
+template <typename Number>
+inline
+void
+BatchedFullMatrix<Number>::solve
+(AlignedVector<VectorizedArray<Number> > &rhs_and_solution) const
+{
+  AssertDimension (rhs_and_solution.size(), n_batches()*n_rows);
+
+  if (state == LAPACKSupport::inverse_matrix)
+    {
+      AlignedVector<VectorizedArray<Number> > rhs (rhs_and_solution);
+      vmult (rhs_and_solution, rhs);
+      return;
+    }
+
+  Assert (state == LAPACKSupport::lu || state == LAPACKSupport::cholesky,
+          LAPACKSupport::ExcState(state));
+  parallel::apply_to_subranges (0U, n_batches(),
+                                [&] (const size_type begin,
+                                     const size_type end)
+  {
+    for (size_type batch=begin; batch<end; ++batch)
+      solve_batch (batch, &data[batch*n_rows*n_rows],
+                   &rhs_and_solution[batch*n_rows]);
+  },
+  16);
+}
+
+
+
+template <typename Number>
+inline
+void
+BatchedFullMatrix<Number>::vmult
+(AlignedVector<VectorizedArray<Number> >       &dst,
+ const AlignedVector<VectorizedArray<Number> > &src) const
+{
+  Assert (state == LAPACKSupport::matrix ||
+          state == LAPACKSupport::inverse_matrix,
+          LAPACKSupport::ExcState(state));
+  AssertDimension (src.size(), n_batches()*n_rows);
+  Assert (&dst != &src, ExcMessage("Source and destination must not be the "
+                                   "same vector"));
+
+  dst.resize_fast (n_batches()*n_rows);
+  parallel::apply_to_subranges (0U, n_batches(),
+                                [&] (const size_type begin,
+                                     const size_type end)
+  {
+    for (size_type batch=begin; batch<end; ++batch)
+      {
+        const VectorizedArray<Number> *a = &data[batch*n_rows*n_rows];
+        const VectorizedArray<Number> *x = &src[batch*n_rows];
+        for (size_type i=0; i<n_rows; ++i)
+          {
+            VectorizedArray<Number> sum = make_vectorized_array (Number());
+            for (size_type j=0; j<n_rows; ++j)
+              sum += a[i*n_rows+j] * x[j];
+            dst[batch*n_rows+i] = sum;
+          }
+      }
+  },
+  16);
+}
+
+
+
+template <typename Number>
+inline
+std::size_t
+BatchedFullMatrix<Number>::memory_consumption () const
+{
+  return (sizeof(*this) + data.memory_consumption() +
+          MemoryConsumption::memory_consumption(pivots));
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
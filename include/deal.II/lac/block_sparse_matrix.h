@@ -19,6 +19,8 @@
 
 #include <deal.II/base/config.h>
 #include <deal.II/base/table.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/thread_management.h>
 #include <deal.II/lac/block_matrix_base.h>
 #include <deal.II/lac/block_vector.h>
 #include <deal.II/lac/sparse_matrix.h>
@@ -209,6 +211,13 @@ public:
   /**
    * Matrix-vector multiplication: let $dst = M*src$ with $M$ being this
    * matrix.
+   *
+   * When running with several threads, the block rows are worked on as
+   * separate tasks. The products of the individual blocks are themselves
+   * parallel, so the tasks of small blocks can fill the threads left idle by
+   * the larger blocks rather than waiting for each block product to finish
+   * before starting the next. Blocks without any nonzero entries are
+   * skipped.
    */
   template <typename block_number>
   void vmult (BlockVector<block_number>       &dst,
@@ -243,7 +252,7 @@ public:
   /**
    * Matrix-vector multiplication: let $dst = M^T*src$ with $M$ being this
    * matrix. This function does the same as vmult() but takes the transposed
-   * matrix.
+   * matrix. With threads, the block columns are run as separate tasks.
    */
   template <typename block_number>
   void Tvmult (BlockVector<block_number>       &dst,
@@ -384,7 +393,38 @@ void
 BlockSparseMatrix<number>::vmult (BlockVector<block_number>       &dst,
                                   const BlockVector<block_number> &src) const
 {
-  BaseClass::vmult_block_block (dst, src);
+  if (MultithreadInfo::n_threads() == 1 || this->n_block_rows() == 1)
+    {
+      BaseClass::vmult_block_block (dst, src);
+      return;
+    }
+
+  Assert (dst.n_blocks() == this->n_block_rows(),
+          ExcDimensionMismatch(dst.n_blocks(), this->n_block_rows()));
+  Assert (src.n_blocks() == this->n_block_cols(),
+          ExcDimensionMismatch(src.n_blocks(), this->n_block_cols()));
+
+  // each block row writes into its own block of the destination vector, so
+  // all block rows can run concurrently. The products within a row
+  // accumulate into the same vector and are done one after the other
+  Threads::TaskGroup<> tasks;
+  for (size_type row=0; row<this->n_block_rows(); ++row)
+    tasks += Threads::new_task ([this, row, &dst, &src]()
+    {
+      bool is_first = true;
+      for (size_type col=0; col<this->n_block_cols(); ++col)
+        if (this->block(row,col).n_nonzero_elements() > 0)
+          {
+            if (is_first)
+              this->block(row,col).vmult (dst.block(row), src.block(col));
+            else
+              this->block(row,col).vmult_add (dst.block(row), src.block(col));
+            is_first = false;
+          }
+      if (is_first)
+        dst.block(row) = 0;
+    });
+  tasks.join_all ();
 }
 
 
@@ -434,7 +474,36 @@ void
 BlockSparseMatrix<number>::Tvmult (BlockVector<block_number>       &dst,
                                    const BlockVector<block_number> &src) const
 {
-  BaseClass::Tvmult_block_block (dst, src);
+  if (MultithreadInfo::n_threads() == 1 || this->n_block_cols() == 1)
+    {
+      BaseClass::Tvmult_block_block (dst, src);
+      return;
+    }
+
+  Assert (dst.n_blocks() == this->n_block_cols(),
+          ExcDimensionMismatch(dst.n_blocks(), this->n_block_cols()));
+  Assert (src.n_blocks() == this->n_block_rows(),
+          ExcDimensionMismatch(src.n_blocks(), this->n_block_rows()));
+
+  // same as in vmult(), but now each block column is one task
+  Threads::TaskGroup<> tasks;
+  for (size_type col=0; col<this->n_block_cols(); ++col)
+    tasks += Threads::new_task ([this, col, &dst, &src]()
+    {
+      bool is_first = true;
+      for (size_type row=0; row<this->n_block_rows(); ++row)
+        if (this->block(row,col).n_nonzero_elements() > 0)
+          {
+            if (is_first)
+              this->block(row,col).Tvmult (dst.block(col), src.block(row));
+            else
+              this->block(row,col).Tvmult_add (dst.block(col), src.block(row));
+            is_first = false;
+          }
+      if (is_first)
+        dst.block(col) = 0;
+    });
+  tasks.join_all ();
 }
 
 
@@ -25,6 +25,7 @@
 #include <deal.II/lac/vector_type_traits.h>
 
 #include <cstdio>
+#include <memory>
 #include <vector>
 
 DEAL_II_NAMESPACE_OPEN
@@ -309,6 +310,152 @@ public:
    */
   void swap (BlockVector<Number> &v);
 
+  /**
+   * @name Contiguous storage
+   */
+  //@{
+
+  /**
+   * Set the number of blocks from the size of @p block_sizes and the size of
+   * each block to the given value, like reinit(), but place the elements of
+   * all blocks in one contiguous array. The blocks are then views into this
+   * array, with block <tt>i</tt> starting behind the last element of block
+   * <tt>i-1</tt>.
+   *
+   * With this storage, the global operations of this class that combine
+   * two or three block vectors with contiguous storage, such as add(),
+   * sadd(), the scalar product or the norms, run as a single loop (with a
+   * single reduction) over all elements instead of one loop per block.
+   * Furthermore, get_contiguous_vector() gives access to all elements as a
+   * single Vector without copying.
+   *
+   * Once this function has been called, the other reinit() functions
+   * keep the contiguous storage, and so does reinit() from a vector with
+   * contiguous storage, which is the way temporary vectors are set up in
+   * the iterative solvers. Calling reinit() on an individual block with a
+   * larger size gives that block its own memory again, in which case
+   * has_contiguous_storage() returns false and the operations fall back to
+   * the loops over the blocks.
+   *
+   * @note The blocks do not own their memory, so they must not be swapped
+   * with or moved into vectors that live longer than this object.
+   */
+  void reinit_contiguous (const std::vector<size_type> &block_sizes,
+                          const bool                    omit_zeroing_entries = false);
+
+  /**
+   * Return whether the elements of all blocks are stored in one
+   * contiguous array, see reinit_contiguous().
+   */
+  bool has_contiguous_storage () const;
+
+  /**
+   * Return a vector holding the elements of all blocks, one block after the
+   * other, which uses the same memory as the blocks.
+   *
+   * @pre has_contiguous_storage() must return true.
+   */
+  Vector<Number> &get_contiguous_vector ();
+
+  /**
+   * Read-only version of the above function.
+   */
+  const Vector<Number> &get_contiguous_vector () const;
+
+  /**
+   * Return the scalar product of two vectors, using a single loop if both
+   * vectors have contiguous storage.
+   */
+  value_type operator* (const BlockVector<Number> &V) const;
+
+  /**
+   * Return the square of the $l_2$-norm.
+   */
+  real_type norm_sqr () const;
+
+  /**
+   * Return the mean value of the elements of this vector.
+   */
+  value_type mean_value () const;
+
+  /**
+   * Return the $l_1$-norm of the vector, i.e. the sum of the absolute values.
+   */
+  real_type l1_norm () const;
+
+  /**
+   * Return the $l_2$-norm of the vector, i.e. the square root of the sum of
+   * the squares of the elements.
+   */
+  real_type l2_norm () const;
+
+  /**
+   * Return the maximum absolute value of the elements of this vector.
+   */
+  real_type linfty_norm () const;
+
+  /**
+   * Perform a combined operation of a vector addition and a subsequent inner
+   * product, see BlockVectorBase::add_and_dot().
+   */
+  value_type add_and_dot (const value_type           a,
+                          const BlockVector<Number> &V,
+                          const BlockVector<Number> &W);
+
+  /**
+   * Add the given vector to the present one.
+   */
+  BlockVector &operator += (const BlockVector<Number> &V);
+
+  /**
+   * Subtract the given vector from the present one.
+   */
+  BlockVector &operator -= (const BlockVector<Number> &V);
+
+  /**
+   * Scale each element of the vector by a constant value.
+   */
+  BlockVector &operator *= (const value_type factor);
+
+  /**
+   * Scale each element of the vector by the inverse of the given value.
+   */
+  BlockVector &operator /= (const value_type factor);
+
+  using BaseClass::add;
+
+  /**
+   * Simple addition of a multiple of a vector, i.e. <tt>*this += a*V</tt>.
+   */
+  void add (const value_type a, const BlockVector<Number> &V);
+
+  /**
+   * Multiple addition of scaled vectors, i.e. <tt>*this += a*V+b*W</tt>.
+   */
+  void add (const value_type a, const BlockVector<Number> &V,
+            const value_type b, const BlockVector<Number> &W);
+
+  using BaseClass::sadd;
+
+  /**
+   * Scaling and simple vector addition, i.e. <tt>*this = s*(*this)+V</tt>.
+   */
+  void sadd (const value_type s, const BlockVector<Number> &V);
+
+  /**
+   * Scaling and simple addition, i.e. <tt>*this = s*(*this)+a*V</tt>.
+   */
+  void sadd (const value_type s, const value_type a,
+             const BlockVector<Number> &V);
+
+  using BaseClass::equ;
+
+  /**
+   * Assignment <tt>*this = a*V</tt>.
+   */
+  void equ (const value_type a, const BlockVector<Number> &V);
+  //@}
+
   /**
    * Output of vector in user-defined format.
    *
@@ -354,6 +501,31 @@ public:
    */
   DeclException0 (ExcIteratorRangeDoesNotMatchVectorSize);
   //@}
+
+private:
+  /**
+   * Let @p vector use the @p size elements starting at @p data, without
+   * taking over the ownership of the memory.
+   */
+  static void make_view (Vector<Number>  &vector,
+                         Number          *data,
+                         const size_type  size);
+
+  /**
+   * The memory of all blocks if reinit_contiguous() has been called, and
+   * a null pointer otherwise.
+   */
+  std::unique_ptr<Number[], decltype(&free)> contiguous_values {nullptr, &free};
+
+  /**
+   * A vector using the memory of all blocks in case of contiguous storage.
+   */
+  Vector<Number> contiguous_vector;
+
+  /**
+   * Make the other block vector types friends.
+   */
+  template <typename Number2> friend class BlockVector;
 };
 
 /*@}*/
@@ -452,6 +624,292 @@ void BlockVector<Number>::scale (const BlockVector2 &v)
   BaseClass::scale (v);
 }
 
+
+
+template <typename Number>
+inline
+bool
+BlockVector<Number>::has_contiguous_storage () const
+{
+  // check that none of the blocks has been reinitialized with its own
+  // memory since the contiguous storage was set up
+  if (contiguous_values == nullptr ||
+      contiguous_vector.size() != this->size() ||
+      contiguous_vector.begin() != contiguous_values.get())
+    return false;
+  for (unsigned int b=0; b<this->n_blocks(); ++b)
+    if (this->components[b].size() > 0 &&
+        this->components[b].begin() != contiguous_values.get() +
+        this->block_indices.block_start(b))
+      return false;
+  return true;
+}
+
+
+
+template <typename Number>
+inline
+Vector<Number> &
+BlockVector<Number>::get_contiguous_vector ()
+{
+  Assert (has_contiguous_storage(),
+          ExcMessage("The block vector does not use contiguous storage"));
+  return contiguous_vector;
+}
+
+
+
+template <typename Number>
+inline
+const Vector<Number> &
+BlockVector<Number>::get_contiguous_vector () const
+{
+  Assert (has_contiguous_storage(),
+          ExcMessage("The block vector does not use contiguous storage"));
+  return contiguous_vector;
+}
+
+
+
+template <typename Number>
+inline
+typename BlockVector<Number>::value_type
+BlockVector<Number>::operator* (const BlockVector<Number> &v) const
+{
+  if (has_contiguous_storage() && v.has_contiguous_storage())
+    {
+      AssertDimension (this->n_blocks(), v.n_blocks());
+      return contiguous_vector * v.contiguous_vector;
+    }
+  return BaseClass::operator* (v);
+}
+
+
+
+template <typename Number>
+inline
+typename BlockVector<Number>::real_type
+BlockVector<Number>::norm_sqr () const
+{
+  if (has_contiguous_storage())
+    return contiguous_vector.norm_sqr();
+  return BaseClass::norm_sqr();
+}
+
+
+
+template <typename Number>
+inline
+typename BlockVector<Number>::value_type
+BlockVector<Number>::mean_value () const
+{
+  if (has_contiguous_storage())
+    return contiguous_vector.mean_value();
+  return BaseClass::mean_value();
+}
+
+
+
+template <typename Number>
+inline
+typename BlockVector<Number>::real_type
+BlockVector<Number>::l1_norm () const
+{
+  if (has_contiguous_storage())
+    return contiguous_vector.l1_norm();
+  return BaseClass::l1_norm();
+}
+
+
+
+template <typename Number>
+inline
+typename BlockVector<Number>::real_type
+BlockVector<Number>::l2_norm () const
+{
+  if (has_contiguous_storage())
+    return contiguous_vector.l2_norm();
+  return BaseClass::l2_norm();
+}
+
+
+
+template <typename Number>
+inline
+typename BlockVector<Number>::real_type
+BlockVector<Number>::linfty_norm () const
+{
+  if (has_contiguous_storage())
+    return contiguous_vector.linfty_norm();
+  return BaseClass::linfty_norm();
+}
+
+
+
+template <typename Number>
+inline
+typename BlockVector<Number>::value_type
+BlockVector<Number>::add_and_dot (const value_type           a,
+                                  const BlockVector<Number> &V,
+                                  const BlockVector<Number> &W)
+{
+  if (has_contiguous_storage() && V.has_contiguous_storage() &&
+      W.has_contiguous_storage())
+    {
+      AssertDimension (this->n_blocks(), V.n_blocks());
+      AssertDimension (this->n_blocks(), W.n_blocks());
+      return contiguous_vector.add_and_dot (a, V.contiguous_vector,
+                                            W.contiguous_vector);
+    }
+  return BaseClass::add_and_dot (a, V, W);
+}
+
+
+
+template <typename Number>
+inline
+BlockVector<Number> &
+BlockVector<Number>::operator += (const BlockVector<Number> &v)
+{
+  if (has_contiguous_storage() && v.has_contiguous_storage())
+    {
+      AssertDimension (this->n_blocks(), v.n_blocks());
+      contiguous_vector += v.contiguous_vector;
+    }
+  else
+    BaseClass::operator += (v);
+  return *this;
+}
+
+
+
+template <typename Number>
+inline
+BlockVector<Number> &
+BlockVector<Number>::operator -= (const BlockVector<Number> &v)
+{
+  if (has_contiguous_storage() && v.has_contiguous_storage())
+    {
+      AssertDimension (this->n_blocks(), v.n_blocks());
+      contiguous_vector -= v.contiguous_vector;
+    }
+  else
+    BaseClass::operator -= (v);
+  return *this;
+}
+
+
+
+template <typename Number>
+inline
+BlockVector<Number> &
+BlockVector<Number>::operator *= (const value_type factor)
+{
+  if (has_contiguous_storage())
+    contiguous_vector *= factor;
+  else
+    BaseClass::operator *= (factor);
+  return *this;
+}
+
+
+
+template <typename Number>
+inline
+BlockVector<Number> &
+BlockVector<Number>::operator /= (const value_type factor)
+{
+  if (has_contiguous_storage())
+    contiguous_vector /= factor;
+  else
+    BaseClass::operator /= (factor);
+  return *this;
+}
+
+
+
+template <typename Number>
+inline
+void
+BlockVector<Number>::add (const value_type a, const BlockVector<Number> &v)
+{
+  if (has_contiguous_storage() && v.has_contiguous_storage())
+    {
+      AssertDimension (this->n_blocks(), v.n_blocks());
+      contiguous_vector.add (a, v.contiguous_vector);
+    }
+  else
+    BaseClass::add (a, v);
+}
+
+
+
+template <typename Number>
+inline
+void
+BlockVector<Number>::add (const value_type a, const BlockVector<Number> &v,
+                          const value_type b, const BlockVector<Number> &w)
+{
+  if (has_contiguous_storage() && v.has_contiguous_storage() &&
+      w.has_contiguous_storage())
+    {
+      AssertDimension (this->n_blocks(), v.n_blocks());
+      AssertDimension (this->n_blocks(), w.n_blocks());
+      contiguous_vector.add (a, v.contiguous_vector, b, w.contiguous_vector);
+    }
+  else
+    BaseClass::add (a, v, b, w);
+}
+
+
+
+template <typename Number>
+inline
+void
+BlockVector<Number>::sadd (const value_type s, const BlockVector<Number> &v)
+{
+  if (has_contiguous_storage() && v.has_contiguous_storage())
+    {
+      AssertDimension (this->n_blocks(), v.n_blocks());
+      contiguous_vector.sadd (s, v.contiguous_vector);
+    }
+  else
+    BaseClass::sadd (s, v);
+}
+
+
+
+template <typename Number>
+inline
+void
+BlockVector<Number>::sadd (const value_type s, const value_type a,
+                           const BlockVector<Number> &v)
+{
+  if (has_contiguous_storage() && v.has_contiguous_storage())
+    {
+      AssertDimension (this->n_blocks(), v.n_blocks());
+      contiguous_vector.sadd (s, a, v.contiguous_vector);
+    }
+  else
+    BaseClass::sadd (s, a, v);
+}
+
+
+
+template <typename Number>
+inline
+void
+BlockVector<Number>::equ (const value_type a, const BlockVector<Number> &v)
+{
+  if (has_contiguous_storage() && v.has_contiguous_storage())
+    {
+      AssertDimension (this->n_blocks(), v.n_blocks());
+      contiguous_vector.equ (a, v.contiguous_vector);
+    }
+  else
+    BaseClass::equ (a, v);
+}
+
 #endif // DOXYGEN
 
 
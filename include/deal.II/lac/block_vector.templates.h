@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2016 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -18,6 +18,8 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/utilities.h>
 #include <deal.II/lac/block_vector.h>
 #include <deal.II/lac/trilinos_parallel_block_vector.h>
 #include <cmath>
@@ -53,6 +55,16 @@ BlockVector<Number>::BlockVector (const BlockVector<Number> &v)
   :
   BlockVectorBase<Vector<Number> > ()
 {
+  if (v.has_contiguous_storage())
+    {
+      std::vector<size_type> block_sizes (v.n_blocks());
+      for (unsigned int b=0; b<v.n_blocks(); ++b)
+        block_sizes[b] = v.block_indices.block_size(b);
+      reinit_contiguous (block_sizes, true);
+      contiguous_vector = v.contiguous_vector;
+      return;
+    }
+
   this->components.resize (v.n_blocks());
   this->block_indices = v.block_indices;
 
@@ -103,6 +115,12 @@ template <typename Number>
 void BlockVector<Number>::reinit (const std::vector<size_type> &block_sizes,
                                   const bool                    omit_zeroing_entries)
 {
+  if (contiguous_values != nullptr)
+    {
+      reinit_contiguous (block_sizes, omit_zeroing_entries);
+      return;
+    }
+
   this->block_indices.reinit (block_sizes);
   if (this->components.size() != this->n_blocks())
     this->components.resize(this->n_blocks());
@@ -117,6 +135,15 @@ void BlockVector<Number>::reinit (
   const BlockIndices &n,
   const bool omit_zeroing_entries)
 {
+  if (contiguous_values != nullptr)
+    {
+      std::vector<size_type> block_sizes (n.size());
+      for (unsigned int b=0; b<n.size(); ++b)
+        block_sizes[b] = n.block_size(b);
+      reinit_contiguous (block_sizes, omit_zeroing_entries);
+      return;
+    }
+
   this->block_indices = n;
   if (this->components.size() != this->n_blocks())
     this->components.resize(this->n_blocks());
@@ -131,6 +158,17 @@ template <typename Number2>
 void BlockVector<Number>::reinit (const BlockVector<Number2> &v,
                                   const bool omit_zeroing_entries)
 {
+  // take over the contiguous storage from v, which is how the temporary
+  // vectors of the iterative solvers are set up
+  if (contiguous_values != nullptr || v.has_contiguous_storage())
+    {
+      std::vector<size_type> block_sizes (v.n_blocks());
+      for (unsigned int b=0; b<v.n_blocks(); ++b)
+        block_sizes[b] = v.get_block_indices().block_size(b);
+      reinit_contiguous (block_sizes, omit_zeroing_entries);
+      return;
+    }
+
   this->block_indices = v.get_block_indices();
   if (this->components.size() != this->n_blocks())
     this->components.resize(this->n_blocks());
@@ -159,6 +197,73 @@ void BlockVector<Number>::swap (BlockVector<Number> &v)
   std::swap(this->components, v.components);
 
   dealii::swap (this->block_indices, v.block_indices);
+
+  contiguous_values.swap (v.contiguous_values);
+  contiguous_vector.swap (v.contiguous_vector);
+}
+
+
+
+namespace internal
+{
+  namespace BlockVectorImplementation
+  {
+    // the deleter of the blocks with contiguous storage, which do not own
+    // their memory
+    inline
+    void do_not_free (void *)
+    {}
+  }
+}
+
+
+
+template <typename Number>
+void BlockVector<Number>::make_view (Vector<Number>  &vector,
+                                     Number          *data,
+                                     const size_type  size)
+{
+  // replacing the pointer releases the memory previously owned by the
+  // vector. A later reinit() to a larger size gives the vector its own
+  // memory again
+  vector.values = std::unique_ptr<Number[], decltype(&free)>
+                  (size > 0 ? data : nullptr,
+                   &internal::BlockVectorImplementation::do_not_free);
+  vector.vec_size = size;
+  vector.max_vec_size = size;
+  vector.thread_loop_partitioner.reset(new parallel::internal::TBBPartitioner());
+}
+
+
+
+template <typename Number>
+void BlockVector<Number>::reinit_contiguous (const std::vector<size_type> &block_sizes,
+                                             const bool                    omit_zeroing_entries)
+{
+  this->block_indices.reinit (block_sizes);
+  if (this->components.size() != this->n_blocks())
+    this->components.resize(this->n_blocks());
+
+  const size_type total_size = this->block_indices.total_size();
+  if (contiguous_values == nullptr || total_size != contiguous_vector.size())
+    {
+      // allocate memory with the proper alignment requirements of 64 bytes
+      // as in the Vector class. Make sure that there is a valid pointer
+      // also for empty vectors to mark the contiguous storage
+      Number *new_values;
+      Utilities::System::posix_memalign ((void **)&new_values, 64,
+                                         sizeof(Number)*std::max<size_type>(total_size, 1));
+      contiguous_values.reset (new_values);
+    }
+
+  make_view (contiguous_vector, contiguous_values.get(), total_size);
+  for (unsigned int b=0; b<this->n_blocks(); ++b)
+    make_view (this->components[b],
+               contiguous_values.get() + this->block_indices.block_start(b),
+               block_sizes[b]);
+
+  if (omit_zeroing_entries == false)
+    contiguous_vector = Number();
 }
 
 
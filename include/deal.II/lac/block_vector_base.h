@@ -1693,9 +1693,9 @@ BlockVectorBase<VectorType>::mean_value () const
   value_type sum = 0.;
   // need to do static_cast as otherwise it won't work with value_type=complex<T>
   for (size_type i=0; i<n_blocks(); ++i)
-    sum += components[i].mean_value() * static_cast<double>(components[i].size());
+    sum += components[i].mean_value() * static_cast<real_type>(components[i].size());
 
-  return sum/static_cast<double>(size());
+  return sum/static_cast<real_type>(size());
 }
 
 
@@ -1729,7 +1729,7 @@ BlockVectorBase<VectorType>::linfty_norm () const
   real_type sum = 0.;
   for (size_type i=0; i<n_blocks(); ++i)
     {
-      value_type newval = components[i].linfty_norm();
+      const real_type newval = components[i].linfty_norm();
       if (sum<newval)
         sum = newval;
     }
@@ -2152,7 +2152,7 @@ BlockVectorBase<VectorType>::operator /= (const value_type factor)
 {
 
   AssertIsFinite(factor);
-  Assert (factor != 0., ExcDivideByZero() );
+  Assert (factor != value_type(), ExcDivideByZero() );
 
   for (size_type i=0; i<n_blocks(); ++i)
     components[i] /= factor;
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2008 - 2016 by the deal.II authors
+// Copyright (C) 2008 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -393,6 +393,27 @@ namespace ChunkSparseMatrixIterators
  * know this, and more importantly one can associate more than one matrix with
  * the same sparsity pattern.
  *
+ * The entries are stored in dense chunks of size <tt>chunk_size</tt> times
+ * <tt>chunk_size</tt> with one column index per chunk, i.e., in a block
+ * compressed row storage format. This is beneficial for vector-valued
+ * problems such as linear elasticity discretized by FESystem(FE_Q(p),dim):
+ * DoFHandler::distribute_dofs() numbers the degrees of freedom on each
+ * vertex, line, face, and cell consecutively, so that with
+ * <tt>chunk_size=dim</tt> the components of each node form a chunk and the
+ * couplings between nodes are stored as dense blocks that only need one
+ * column index. Renumberings that separate the components of a node, like
+ * DoFRenumbering::component_wise(), make the chunks sparse again. The
+ * sparsity pattern is built with DoFTools::make_sparsity_pattern() into a
+ * DynamicSparsityPattern that is copied into a ChunkSparsityPattern with the
+ * desired chunk size, and the matrix can be assembled with
+ * ConstraintMatrix::distribute_local_to_global(). The matrix-vector products
+ * are specialized for chunk sizes up to four, such that the loops within a
+ * chunk are unrolled and can be vectorized by the compiler. Besides the point
+ * relaxation methods of this class, PreconditionBlockJacobi,
+ * PreconditionBlockSOR, and PreconditionBlockSSOR are provided for this
+ * class; with the block size set to the chunk size, they relax the
+ * components of each node together.
+ *
  * The use of this class is demonstrated in step-51.
  *
  * @note Instantiations for this template are provided for <tt>@<float@> and
@@ -983,12 +1004,16 @@ public:
                             const number              omega = 1.) const;
 
   /**
-   * Apply SSOR preconditioning to <tt>src</tt>.
+   * Apply SSOR preconditioning to <tt>src</tt>. The last argument is
+   * ignored. It is only present for compatibility with
+   * SparseMatrix::precondition_SSOR(), such that this class can be used
+   * with PreconditionSSOR.
    */
   template <typename somenumber>
-  void precondition_SSOR (Vector<somenumber>       &dst,
-                          const Vector<somenumber> &src,
-                          const number              om = 1.) const;
+  void precondition_SSOR (Vector<somenumber>             &dst,
+                          const Vector<somenumber>       &src,
+                          const number                    om = 1.,
+                          const std::vector<std::size_t> &pos_right_of_diagonal=std::vector<std::size_t>()) const;
 
   /**
    * Apply SOR preconditioning matrix to <tt>src</tt>.
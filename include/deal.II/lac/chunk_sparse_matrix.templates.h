@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2008 - 2016 by the deal.II authors
+// Copyright (C) 2008 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -177,6 +177,114 @@ namespace internal
 
 
 
+    /**
+     * Return the product of the entries of row <tt>row</tt> of a matrix with
+     * <tt>n_cols</tt> columns in the columns from <tt>begin_col</tt> up to
+     * but excluding <tt>end_col</tt> with the respective entries of the
+     * vector <tt>v</tt>. This is the building block of the relaxation
+     * methods, which need the products with the entries left or right of
+     * the diagonal. Only the chunks of the row are visited, and the padding
+     * elements are skipped.
+     */
+    template <typename number, typename somenumber>
+    inline
+    somenumber
+    partial_row_product (const size_type                   chunk_size,
+                         const size_type                   n_cols,
+                         const size_type                   row,
+                         const size_type                   begin_col,
+                         const size_type                   end_col,
+                         const number                     *values,
+                         const std::size_t                *rowstart,
+                         const size_type                  *colnums,
+                         const dealii::Vector<somenumber> &v)
+    {
+      const size_type chunk_row = row / chunk_size;
+      const size_type last_col = std::min(end_col, n_cols);
+      const number *const row_values = values + (row % chunk_size) * chunk_size;
+
+      somenumber sum = 0;
+      for (std::size_t k=rowstart[chunk_row]; k<rowstart[chunk_row+1]; ++k)
+        {
+          const size_type first_col = colnums[k] * chunk_size;
+          if (first_col >= last_col || first_col + chunk_size <= begin_col)
+            continue;
+
+          const size_type c_begin = begin_col > first_col ? begin_col - first_col : 0;
+          const size_type c_end = std::min(chunk_size, last_col - first_col);
+          const number *const val_ptr = row_values + k * chunk_size * chunk_size;
+          for (size_type c=c_begin; c<c_end; ++c)
+            sum += somenumber(val_ptr[c]) * v(first_col + c);
+        }
+      return sum;
+    }
+
+
+
+    /**
+     * Perform the vmult_add on the chunk rows in the range from
+     * <tt>begin_row</tt> to <tt>end_row</tt>, which must not contain the
+     * last chunk row if the rows are padded. The pointers into the values,
+     * the column numbers and the destination vector are advanced to the end
+     * of the range.
+     *
+     * If the template argument <tt>fixed_chunk_size</tt> is positive, it
+     * must be equal to the chunk size. Then, the loops within each chunk
+     * have a length known at compile time and can be unrolled and vectorized
+     * by the compiler, which is the case for the small chunk sizes used for
+     * the components of the nodes in vector-valued problems.
+     */
+    template <int fixed_chunk_size,
+              typename number,
+              typename InVector,
+              typename DstIterator>
+    inline
+    void vmult_add_regular_rows (const size_type     runtime_chunk_size,
+                                 const size_type     begin_row,
+                                 const size_type     end_row,
+                                 const size_type     n_filled_last_cols,
+                                 const size_type     irregular_col,
+                                 const number       *values,
+                                 const std::size_t  *rowstart,
+                                 const number      *&val_ptr,
+                                 const size_type   *&colnum_ptr,
+                                 const InVector     &src,
+                                 DstIterator        &dst_ptr)
+    {
+      Assert (fixed_chunk_size < 0 ||
+              runtime_chunk_size == static_cast<size_type>(fixed_chunk_size),
+              ExcInternalError());
+      const size_type chunk_size = fixed_chunk_size > 0 ?
+                                   fixed_chunk_size : runtime_chunk_size;
+
+      for (size_type chunk_row=begin_row; chunk_row<end_row; ++chunk_row)
+        {
+          const number *const val_end_of_row = &values[rowstart[chunk_row+1] *
+                                                       chunk_size * chunk_size];
+          while (val_ptr != val_end_of_row)
+            {
+              if (*colnum_ptr != irregular_col)
+                chunk_vmult_add (chunk_size,
+                                 val_ptr,
+                                 src.begin() + *colnum_ptr * chunk_size,
+                                 dst_ptr);
+              else
+                // we're at a chunk column that has padding
+                for (size_type r=0; r<chunk_size; ++r)
+                  for (size_type c=0; c<n_filled_last_cols; ++c)
+                    dst_ptr[r] += (val_ptr[r*chunk_size + c] *
+                                   src(*colnum_ptr * chunk_size + c));
+
+              ++colnum_ptr;
+              val_ptr += chunk_size * chunk_size;
+            }
+
+          dst_ptr += chunk_size;
+        }
+    }
+
+
+
     /**
      * Perform a vmult_add using the ChunkSparseMatrix data structures, but
      * only using a subinterval of the matrix rows.
@@ -215,30 +323,40 @@ namespace internal
       typename OutVector::iterator dst_ptr = dst.begin()+chunk_size*begin_row;
       const number    *val_ptr    = &values[rowstart[begin_row]*chunk_size*chunk_size];
       const size_type *colnum_ptr = &colnums[rowstart[begin_row]];
-      for (unsigned int chunk_row=begin_row; chunk_row<last_regular_row;
-           ++chunk_row)
-        {
-          const number *const val_end_of_row = &values[rowstart[chunk_row+1] *
-                                                       chunk_size * chunk_size];
-          while (val_ptr != val_end_of_row)
-            {
-              if (*colnum_ptr != irregular_col)
-                chunk_vmult_add (chunk_size,
-                                 val_ptr,
-                                 src.begin() + *colnum_ptr * chunk_size,
-                                 dst_ptr);
-              else
-                // we're at a chunk column that has padding
-                for (size_type r=0; r<chunk_size; ++r)
-                  for (size_type c=0; c<n_filled_last_cols; ++c)
-                    dst_ptr[r] += (val_ptr[r*chunk_size + c] *
-                                   src(*colnum_ptr * chunk_size + c));
-
-              ++colnum_ptr;
-              val_ptr += chunk_size * chunk_size;
-            }
 
-          dst_ptr += chunk_size;
+      // dispatch the chunk sizes of vector-valued problems to code with the
+      // chunk size known at compile time
+      switch (chunk_size)
+        {
+        case 1:
+          vmult_add_regular_rows<1> (chunk_size, begin_row, last_regular_row,
+                                     n_filled_last_cols, irregular_col,
+                                     values, rowstart, val_ptr, colnum_ptr,
+                                     src, dst_ptr);
+          break;
+        case 2:
+          vmult_add_regular_rows<2> (chunk_size, begin_row, last_regular_row,
+                                     n_filled_last_cols, irregular_col,
+                                     values, rowstart, val_ptr, colnum_ptr,
+                                     src, dst_ptr);
+          break;
+        case 3:
+          vmult_add_regular_rows<3> (chunk_size, begin_row, last_regular_row,
+                                     n_filled_last_cols, irregular_col,
+                                     values, rowstart, val_ptr, colnum_ptr,
+                                     src, dst_ptr);
+          break;
+        case 4:
+          vmult_add_regular_rows<4> (chunk_size, begin_row, last_regular_row,
+                                     n_filled_last_cols, irregular_col,
+                                     values, rowstart, val_ptr, colnum_ptr,
+                                     src, dst_ptr);
+          break;
+        default:
+          vmult_add_regular_rows<-1> (chunk_size, begin_row, last_regular_row,
+                                      n_filled_last_cols, irregular_col,
+                                      values, rowstart, val_ptr, colnum_ptr,
+                                      src, dst_ptr);
         }
 
       // now deal with last chunk row if necessary
@@ -930,7 +1048,7 @@ template <typename number>
 template <typename somenumber>
 somenumber
 ChunkSparseMatrix<number>::matrix_scalar_product (const Vector<somenumber> &u,
-                                                  const Vector<somenumber> &v) const
+                                                  const dealii::Vector<somenumber> &v) const
 {
   Assert (cols != nullptr, ExcNotInitialized());
   Assert (val != nullptr, ExcNotInitialized());
@@ -1237,10 +1355,8 @@ template <typename somenumber>
 void
 ChunkSparseMatrix<number>::precondition_Jacobi (Vector<somenumber>       &dst,
                                                 const Vector<somenumber> &src,
-                                                const number              /*om*/) const
+                                                const number              om) const
 {
-  (void)dst;
-  (void)src;
   Assert (cols != nullptr, ExcNotInitialized());
   Assert (val != nullptr, ExcNotInitialized());
   Assert (m() == n(), ExcMessage("This operation is only valid on square matrices."));
@@ -1248,7 +1364,12 @@ ChunkSparseMatrix<number>::precondition_Jacobi (Vector<somenumber>       &dst,
   Assert (dst.size() == n(), ExcDimensionMismatch (dst.size(), n()));
   Assert (src.size() == n(), ExcDimensionMismatch (src.size(), n()));
 
-  Assert (false, ExcNotImplemented());
+  const size_type n = src.size();
+  for (size_type i=0; i<n; ++i)
+    {
+      Assert (diag_element(i) != number(), ExcDivideByZero());
+      dst(i) = somenumber(om) * src(i) / somenumber(diag_element(i));
+    }
 }
 
 
@@ -1256,14 +1377,11 @@ ChunkSparseMatrix<number>::precondition_Jacobi (Vector<somenumber>       &dst,
 template <typename number>
 template <typename somenumber>
 void
-ChunkSparseMatrix<number>::precondition_SSOR (Vector<somenumber>       &dst,
-                                              const Vector<somenumber> &src,
-                                              const number              /*om*/) const
+ChunkSparseMatrix<number>::precondition_SSOR (Vector<somenumber>             &dst,
+                                              const Vector<somenumber>       &src,
+                                              const number                    om,
+                                              const std::vector<std::size_t> &) const
 {
-  // to understand how this function works you may want to take a look at the
-  // CVS archives to see the original version which is much clearer...
-  (void)dst;
-  (void)src;
   Assert (cols != nullptr, ExcNotInitialized());
   Assert (val != nullptr, ExcNotInitialized());
   Assert (m() == n(), ExcMessage("This operation is only valid on square matrices."));
@@ -1271,7 +1389,33 @@ ChunkSparseMatrix<number>::precondition_SSOR (Vector<somenumber>       &dst,
   Assert (dst.size() == n(), ExcDimensionMismatch (dst.size(), n()));
   Assert (src.size() == n(), ExcDimensionMismatch (src.size(), n()));
 
-  Assert (false, ExcNotImplemented());
+  // the forward sweep only reads the entry of src in the current row before
+  // writing to dst, so this function also works in-place
+  const size_type n = src.size();
+  const size_type chunk_size = cols->get_chunk_size();
+  for (size_type row=0; row<n; ++row)
+    {
+      Assert (diag_element(row) != number(), ExcDivideByZero());
+      const somenumber s = internal::ChunkSparseMatrix::partial_row_product
+                           (chunk_size, n, row, 0, row, val.get(),
+                            cols->sparsity_pattern.rowstart.get(),
+                            cols->sparsity_pattern.colnums.get(), dst);
+      dst(row) = (src(row) - s * somenumber(om)) / somenumber(diag_element(row));
+    }
+
+  for (size_type row=0; row<n; ++row)
+    dst(row) *= somenumber(om*(number(2.)-om)) * somenumber(diag_element(row));
+
+  // backward sweep
+  for (size_type row=n; row>0; )
+    {
+      --row;
+      const somenumber s = internal::ChunkSparseMatrix::partial_row_product
+                           (chunk_size, n, row, row+1, n, val.get(),
+                            cols->sparsity_pattern.rowstart.get(),
+                            cols->sparsity_pattern.colnums.get(), dst);
+      dst(row) = (dst(row) - s * somenumber(om)) / somenumber(diag_element(row));
+    }
 }
 
 
@@ -1313,15 +1457,23 @@ template <typename number>
 template <typename somenumber>
 void
 ChunkSparseMatrix<number>::SOR (Vector<somenumber> &dst,
-                                const number /*om*/) const
+                                const number om) const
 {
-  (void)dst;
   Assert (cols != nullptr, ExcNotInitialized());
   Assert (val != nullptr, ExcNotInitialized());
   Assert (m() == n(), ExcMessage("This operation is only valid on square matrices."));
   Assert (m() == dst.size(), ExcDimensionMismatch(m(),dst.size()));
 
-  Assert (false, ExcNotImplemented());
+  const size_type chunk_size = cols->get_chunk_size();
+  for (size_type row=0; row<m(); ++row)
+    {
+      Assert (diag_element(row) != number(), ExcDivideByZero());
+      const somenumber s = internal::ChunkSparseMatrix::partial_row_product
+                           (chunk_size, n(), row, 0, row, val.get(),
+                            cols->sparsity_pattern.rowstart.get(),
+                            cols->sparsity_pattern.colnums.get(), dst);
+      dst(row) = (dst(row) - s) * somenumber(om) / somenumber(diag_element(row));
+    }
 }
 
 
@@ -1329,15 +1481,24 @@ template <typename number>
 template <typename somenumber>
 void
 ChunkSparseMatrix<number>::TSOR (Vector<somenumber> &dst,
-                                 const number /*om*/) const
+                                 const number om) const
 {
-  (void)dst;
   Assert (cols != nullptr, ExcNotInitialized());
   Assert (val != nullptr, ExcNotInitialized());
   Assert (m() == n(), ExcMessage("This operation is only valid on square matrices."));
   Assert (m() == dst.size(), ExcDimensionMismatch(m(),dst.size()));
 
-  Assert (false, ExcNotImplemented());
+  const size_type chunk_size = cols->get_chunk_size();
+  for (size_type row=m(); row>0; )
+    {
+      --row;
+      Assert (diag_element(row) != number(), ExcDivideByZero());
+      const somenumber s = internal::ChunkSparseMatrix::partial_row_product
+                           (chunk_size, n(), row, row+1, n(), val.get(),
+                            cols->sparsity_pattern.rowstart.get(),
+                            cols->sparsity_pattern.colnums.get(), dst);
+      dst(row) = (dst(row) - s) * somenumber(om) / somenumber(diag_element(row));
+    }
 }
 
 
@@ -1397,10 +1558,8 @@ template <typename somenumber>
 void
 ChunkSparseMatrix<number>::SOR_step (Vector<somenumber> &v,
                                      const Vector<somenumber> &b,
-                                     const number        /*om*/) const
+                                     const number        om) const
 {
-  (void)v;
-  (void)b;
   Assert (cols != nullptr, ExcNotInitialized());
   Assert (val != nullptr, ExcNotInitialized());
   Assert (m() == n(), ExcMessage("This operation is only valid on square matrices."));
@@ -1408,7 +1567,16 @@ ChunkSparseMatrix<number>::SOR_step (Vector<somenumber> &v,
   Assert (m() == v.size(), ExcDimensionMismatch(m(),v.size()));
   Assert (m() == b.size(), ExcDimensionMismatch(m(),b.size()));
 
-  Assert (false, ExcNotImplemented());
+  const size_type chunk_size = cols->get_chunk_size();
+  for (size_type row=0; row<m(); ++row)
+    {
+      Assert (diag_element(row) != number(), ExcDivideByZero());
+      const somenumber s = internal::ChunkSparseMatrix::partial_row_product
+                           (chunk_size, n(), row, 0, n(), val.get(),
+                            cols->sparsity_pattern.rowstart.get(),
+                            cols->sparsity_pattern.colnums.get(), v);
+      v(row) += (b(row) - s) * somenumber(om) / somenumber(diag_element(row));
+    }
 }
 
 
@@ -1418,10 +1586,8 @@ template <typename somenumber>
 void
 ChunkSparseMatrix<number>::TSOR_step (Vector<somenumber> &v,
                                       const Vector<somenumber> &b,
-                                      const number        /*om*/) const
+                                      const number        om) const
 {
-  (void)v;
-  (void)b;
   Assert (cols != nullptr, ExcNotInitialized());
   Assert (val != nullptr, ExcNotInitialized());
   Assert (m() == n(), ExcMessage("This operation is only valid on square matrices."));
@@ -1429,7 +1595,17 @@ ChunkSparseMatrix<number>::TSOR_step (Vector<somenumber> &v,
   Assert (m() == v.size(), ExcDimensionMismatch(m(),v.size()));
   Assert (m() == b.size(), ExcDimensionMismatch(m(),b.size()));
 
-  Assert (false, ExcNotImplemented());
+  const size_type chunk_size = cols->get_chunk_size();
+  for (size_type row=m(); row>0; )
+    {
+      --row;
+      Assert (diag_element(row) != number(), ExcDivideByZero());
+      const somenumber s = internal::ChunkSparseMatrix::partial_row_product
+                           (chunk_size, n(), row, 0, n(), val.get(),
+                            cols->sparsity_pattern.rowstart.get(),
+                            cols->sparsity_pattern.colnums.get(), v);
+      v(row) += (b(row) - s) * somenumber(om) / somenumber(diag_element(row));
+    }
 }
 
 
@@ -1451,16 +1627,15 @@ template <typename number>
 template <typename somenumber>
 void
 ChunkSparseMatrix<number>::SSOR (Vector<somenumber> &dst,
-                                 const number /*om*/) const
+                                 const number om) const
 {
-  (void)dst;
   Assert (cols != nullptr, ExcNotInitialized());
   Assert (val != nullptr, ExcNotInitialized());
   Assert (m() == n(), ExcMessage("This operation is only valid on square matrices."));
 
   Assert (m() == dst.size(), ExcDimensionMismatch(m(),dst.size()));
 
-  Assert (false, ExcNotImplemented());
+  precondition_SSOR (dst, dst, om);
 }
 
 
@@ -18,8 +18,10 @@
 #define dealii_constraint_matrix_h
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/array_view.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/index_set.h>
+#include <deal.II/base/memory_report.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/template_constraints.h>
 
@@ -37,6 +39,7 @@ DEAL_II_NAMESPACE_OPEN
 
 template <int dim, class T> class Table;
 template <typename> class FullMatrix;
+template <int, int, typename> class SmallFullMatrix;
 class SparsityPattern;
 class DynamicSparsityPattern;
 class BlockSparsityPattern;
@@ -44,9 +47,158 @@ class BlockDynamicSparsityPattern;
 template <typename number> class SparseMatrix;
 template <typename number> class BlockSparseMatrix;
 
+namespace Threads
+{
+  class SpinLockTable;
+}
+
 namespace internals
 {
   class GlobalRowsFromLocal;
+
+  /**
+   * A read-only view of a local matrix whose entries are stored row by row
+   * in contiguous memory. ConstraintMatrix::distribute_local_to_global()
+   * works on this view internally, so that FullMatrix and SmallFullMatrix
+   * objects can be handed to the same implementation without copying.
+   */
+  template <typename number>
+  class LocalMatrixView
+  {
+  public:
+    typedef types::global_dof_index size_type;
+
+    /**
+     * Constructor. Create a view of the entries of the given matrix.
+     */
+    explicit LocalMatrixView (const FullMatrix<number> &matrix);
+
+    /**
+     * Constructor. Create a view of @p n_rows times @p n_cols entries
+     * starting at @p data.
+     */
+    LocalMatrixView (const number   *data,
+                     const size_type n_rows,
+                     const size_type n_cols);
+
+    /**
+     * Return the number of rows.
+     */
+    size_type m () const;
+
+    /**
+     * Return the number of columns.
+     */
+    size_type n () const;
+
+    /**
+     * Access the entry in row @p i and column @p j.
+     */
+    const number &operator() (const size_type i,
+                              const size_type j) const;
+
+  private:
+    const number   *data;
+    const size_type n_rows;
+    const size_type n_cols;
+  };
+
+  /**
+   * A compact map from the index of a constrained degree of freedom to the
+   * position of its ConstraintLine, used as the lookup structure of
+   * ConstraintMatrix.
+   *
+   * A plain std::vector indexed by the degree of freedom would need one entry
+   * for every index up to the largest constrained one, which for large
+   * adaptive computations is a huge array that is mostly empty. This class
+   * instead splits the index range into blocks of 2<sup>block_shift</sup>
+   * consecutive indices and allocates storage only for blocks that contain
+   * at least one constrained index. A lookup is a shift, one read of the
+   * block table, and one read of the block, i.e., it remains O(1), while the
+   * memory scales with the number of constraints (plus one integer per
+   * block). Since constraints typically cluster at refinement interfaces and
+   * boundaries, most allocated blocks are densely populated.
+   *
+   * The interface is modeled after the subset of the std::vector interface
+   * used by ConstraintMatrix: entries not set are reported as
+   * numbers::invalid_size_type.
+   */
+  class ConstraintLinesCache
+  {
+  public:
+    typedef types::global_dof_index size_type;
+
+    /**
+     * The logarithm of the number of indices per block.
+     */
+    static const unsigned int block_shift = 6;
+
+    /**
+     * Constructor. Create an empty object.
+     */
+    ConstraintLinesCache ();
+
+    /**
+     * Return one past the largest index that can be represented without
+     * reallocating the block table.
+     */
+    size_type size () const;
+
+    /**
+     * Change the logical size. Entries beyond the new size are removed.
+     */
+    void resize (const size_type new_size);
+
+    /**
+     * Return the value stored for @p index, or numbers::invalid_size_type if
+     * none is stored (also for indices beyond size()).
+     */
+    size_type operator [] (const size_type index) const;
+
+    /**
+     * Store @p value for @p index, which must be less than size().
+     */
+    void set (const size_type index,
+              const size_type value);
+
+    /**
+     * Remove all entries, but keep the logical size.
+     */
+    void reset ();
+
+    /**
+     * Remove all entries and set the logical size to zero.
+     */
+    void clear ();
+
+    /**
+     * Swap the content with another object.
+     */
+    void swap (ConstraintLinesCache &other);
+
+    /**
+     * Return the memory consumption of this object in bytes.
+     */
+    std::size_t memory_consumption () const;
+
+  private:
+    /**
+     * The logical size.
+     */
+    size_type n_indices;
+
+    /**
+     * For each block, the position of its first entry in #values, or
+     * numbers::invalid_unsigned_int if the block holds no entries.
+     */
+    std::vector<unsigned int> block_starts;
+
+    /**
+     * The values of the allocated blocks, 2<sup>block_shift</sup> entries
+     * per block.
+     */
+    std::vector<size_type> values;
+  };
 }
 
 
@@ -555,6 +707,13 @@ public:
    */
   std::size_t memory_consumption () const;
 
+  /**
+   * Return a breakdown of the memory consumption returned by
+   * memory_consumption() into the constraint lines with their entries, the
+   * cache for looking up lines, and the index set of local lines.
+   */
+  MemoryReport memory_report () const;
+
   /**
    * Add the constraint indices associated to the indices in the given vector.
    * After a call to this function, the indices vector contains the initial
@@ -996,6 +1155,81 @@ public:
                               VectorType                    &global_vector,
                               bool                          use_inhomogeneities_for_rhs = false) const;
 
+  /**
+   * Same as the function above, but guard each row of @p global_matrix and
+   * the respective entry of @p global_vector by the lock with the same index
+   * in @p row_locks while writing into it. For block matrices, the lock is
+   * selected by the global row index. This makes it safe to call this
+   * function concurrently from several threads that write into the same
+   * rows, e.g. from the copier of WorkStream::run() running in parallel,
+   * without a coloring of the cells. The size of @p row_locks must equal the
+   * number of rows of @p global_matrix, and the same table must be used by
+   * all threads writing into the same matrix.
+   *
+   * Since every row of a local matrix is written in one piece, one lock is
+   * taken per row of the cell matrix rather than per matrix entry, and
+   * threads only wait for each other when they add into the very same row at
+   * the same time.
+   *
+   * @note The locks only serialize the access to the individual rows. The
+   * function is therefore only thread-safe if the global matrix and vector
+   * support simultaneous writes into different rows, which is the case for
+   * the deal.II matrix and vector classes like SparseMatrix and Vector, but
+   * not necessarily for the wrappers of external libraries.
+   */
+  template <typename MatrixType, typename VectorType>
+  void
+  distribute_local_to_global (const FullMatrix<typename MatrixType::value_type> &local_matrix,
+                              const Vector<typename VectorType::value_type>     &local_vector,
+                              const std::vector<size_type>  &local_dof_indices,
+                              MatrixType                    &global_matrix,
+                              VectorType                    &global_vector,
+                              const bool                    use_inhomogeneities_for_rhs,
+                              Threads::SpinLockTable        &row_locks) const;
+
+  /**
+   * Same as the function above for writing into a matrix only, i.e., like
+   * distribute_local_to_global(local_matrix,local_dof_indices,global_matrix)
+   * but with each row guarded by the lock with the same index in @p
+   * row_locks.
+   */
+  template <typename MatrixType>
+  void
+  distribute_local_to_global (const FullMatrix<typename MatrixType::value_type> &local_matrix,
+                              const std::vector<size_type> &local_dof_indices,
+                              MatrixType                   &global_matrix,
+                              Threads::SpinLockTable       &row_locks) const;
+
+  /**
+   * Same as the function
+   * distribute_local_to_global(local_matrix,local_dof_indices,global_matrix)
+   * for a local matrix whose size is fixed at compile time. This avoids the
+   * memory allocation of a FullMatrix object in assembly loops for elements
+   * with a number of degrees of freedom known at compile time.
+   */
+  template <typename MatrixType, int n_dofs>
+  void
+  distribute_local_to_global (const SmallFullMatrix<n_dofs,n_dofs,typename MatrixType::value_type> &local_matrix,
+                              const std::vector<size_type> &local_dof_indices,
+                              MatrixType                   &global_matrix) const;
+
+  /**
+   * Same as the function above that writes into a matrix and a vector
+   * simultaneously, for a local matrix whose size is fixed at compile time.
+   * The local vector can be any container that stores its entries
+   * contiguously and provides <code>size()</code> and
+   * <code>operator[]</code>, like <code>std::array</code>, std::vector, or
+   * Vector.
+   */
+  template <typename MatrixType, typename VectorType, int n_dofs, typename LocalVectorType>
+  void
+  distribute_local_to_global (const SmallFullMatrix<n_dofs,n_dofs,typename MatrixType::value_type> &local_matrix,
+                              const LocalVectorType         &local_vector,
+                              const std::vector<size_type>  &local_dof_indices,
+                              MatrixType                    &global_matrix,
+                              VectorType                    &global_vector,
+                              bool                          use_inhomogeneities_for_rhs = false) const;
+
   /**
    * Do a similar operation as the distribute_local_to_global() function that
    * distributes writing entries into a matrix for constrained degrees of
@@ -1355,12 +1589,13 @@ private:
    * constraints on the fly while add cell contributions into vectors and
    * matrices.
    */
-  std::vector<size_type> lines_cache;
+  internals::ConstraintLinesCache lines_cache;
 
   /**
    * This IndexSet is used to limit the lines to save in the ConstraintMatrix
-   * to a subset. This is necessary, because the lines_cache vector would
-   * become too big in a distributed calculation.
+   * to a subset. With local_lines, the indices into lines_cache are
+   * positions within this set rather than global indices, which keeps the
+   * block table of lines_cache small in a distributed calculation.
    */
   IndexSet local_lines;
 
@@ -1393,12 +1628,13 @@ private:
    */
   template <typename MatrixType, typename VectorType>
   void
-  distribute_local_to_global (const FullMatrix<typename MatrixType::value_type>  &local_matrix,
-                              const Vector<typename VectorType::value_type>      &local_vector,
+  distribute_local_to_global (const internals::LocalMatrixView<typename MatrixType::value_type> &local_matrix,
+                              const ArrayView<const typename VectorType::value_type>          &local_vector,
                               const std::vector<size_type> &local_dof_indices,
                               MatrixType                   &global_matrix,
                               VectorType                   &global_vector,
                               bool                          use_inhomogeneities_for_rhs,
+                              Threads::SpinLockTable       *row_locks,
                               std::integral_constant<bool, false>) const;
 
   /**
@@ -1407,12 +1643,13 @@ private:
    */
   template <typename MatrixType, typename VectorType>
   void
-  distribute_local_to_global (const FullMatrix<typename MatrixType::value_type>  &local_matrix,
-                              const Vector<typename VectorType::value_type>      &local_vector,
+  distribute_local_to_global (const internals::LocalMatrixView<typename MatrixType::value_type> &local_matrix,
+                              const ArrayView<const typename VectorType::value_type>          &local_vector,
                               const std::vector<size_type> &local_dof_indices,
                               MatrixType                   &global_matrix,
                               VectorType                   &global_vector,
                               bool                          use_inhomogeneities_for_rhs,
+                              Threads::SpinLockTable       *row_locks,
                               std::integral_constant<bool, true>) const;
 
   /**
@@ -1466,17 +1703,127 @@ private:
    */
   template <typename LocalType>
   LocalType
-  resolve_vector_entry (const size_type                       i,
-                        const internals::GlobalRowsFromLocal &global_rows,
-                        const Vector<LocalType>              &local_vector,
-                        const std::vector<size_type>         &local_dof_indices,
-                        const FullMatrix<LocalType>          &local_matrix) const;
+  resolve_vector_entry (const size_type                            i,
+                        const internals::GlobalRowsFromLocal      &global_rows,
+                        const ArrayView<const LocalType>          &local_vector,
+                        const std::vector<size_type>              &local_dof_indices,
+                        const internals::LocalMatrixView<LocalType> &local_matrix) const;
 };
 
 
 
 /* ---------------- template and inline functions ----------------- */
 
+namespace internals
+{
+  template <typename number>
+  inline
+  LocalMatrixView<number>::LocalMatrixView (const FullMatrix<number> &matrix)
+    :
+    data (matrix.m() * matrix.n() != 0 ? &matrix(0,0) : nullptr),
+    n_rows (matrix.m()),
+    n_cols (matrix.n())
+  {}
+
+
+
+  template <typename number>
+  inline
+  LocalMatrixView<number>::LocalMatrixView (const number   *data,
+                                            const size_type n_rows,
+                                            const size_type n_cols)
+    :
+    data (data),
+    n_rows (n_rows),
+    n_cols (n_cols)
+  {}
+
+
+
+  template <typename number>
+  inline
+  typename LocalMatrixView<number>::size_type
+  LocalMatrixView<number>::m () const
+  {
+    return n_rows;
+  }
+
+
+
+  template <typename number>
+  inline
+  typename LocalMatrixView<number>::size_type
+  LocalMatrixView<number>::n () const
+  {
+    return n_cols;
+  }
+
+
+
+  template <typename number>
+  inline
+  const number &
+  LocalMatrixView<number>::operator() (const size_type i,
+                                       const size_type j) const
+  {
+    AssertIndexRange (i, n_rows);
+    AssertIndexRange (j, n_cols);
+    return data[i*n_cols+j];
+  }
+
+
+
+  inline
+  ConstraintLinesCache::ConstraintLinesCache ()
+    :
+    n_indices (0)
+  {}
+
+
+
+  inline
+  ConstraintLinesCache::size_type
+  ConstraintLinesCache::size () const
+  {
+    return n_indices;
+  }
+
+
+
+  inline
+  ConstraintLinesCache::size_type
+  ConstraintLinesCache::operator [] (const size_type index) const
+  {
+    if (index >= n_indices)
+      return numbers::invalid_size_type;
+    const unsigned int start = block_starts[index >> block_shift];
+    if (start == numbers::invalid_unsigned_int)
+      return numbers::invalid_size_type;
+    return values[start + (index & ((size_type(1)<<block_shift)-1))];
+  }
+
+
+
+  inline
+  void
+  ConstraintLinesCache::set (const size_type index,
+                             const size_type value)
+  {
+    AssertIndexRange (index, n_indices);
+    const size_type block = index >> block_shift;
+    if (block_starts[block] == numbers::invalid_unsigned_int)
+      {
+        Assert (values.size() < numbers::invalid_unsigned_int,
+                ExcInternalError());
+        block_starts[block] = values.size();
+        values.resize (values.size() + (size_type(1)<<block_shift),
+                       numbers::invalid_size_type);
+      }
+    values[block_starts[block] + (index & ((size_type(1)<<block_shift)-1))] = value;
+  }
+}
+
+
 inline
 ConstraintMatrix::ConstraintMatrix (const IndexSet &local_constraints)
   :
@@ -1524,14 +1871,13 @@ ConstraintMatrix::add_line (const size_type line)
   // if necessary enlarge vector of existing entries for cache
   if (line_index >= lines_cache.size())
     lines_cache.resize (std::max(2*static_cast<size_type>(lines_cache.size()),
-                                 line_index+1),
-                        numbers::invalid_size_type);
+                                 line_index+1));
 
   // push a new line to the end of the list
   lines.emplace_back ();
   lines.back().index = line;
   lines.back().inhomogeneity = 0.;
-  lines_cache[line_index] = lines.size()-1;
+  lines_cache.set (line_index, lines.size()-1);
 }
 
 
@@ -1885,9 +2231,49 @@ distribute_local_to_global (const FullMatrix<typename MatrixType::value_type>
 {
   // create a dummy and hand on to the function actually implementing this
   // feature in the cm.templates.h file.
-  Vector<typename MatrixType::value_type> dummy(0);
-  distribute_local_to_global (local_matrix, dummy, local_dof_indices,
-                              global_matrix, dummy, false,
+  typedef typename MatrixType::value_type number;
+  Vector<number> dummy(0);
+  distribute_local_to_global (internals::LocalMatrixView<number>(local_matrix),
+                              ArrayView<const number>(), local_dof_indices,
+                              global_matrix, dummy, false, nullptr,
+                              std::integral_constant<bool, IsBlockMatrix<MatrixType>::value>());
+}
+
+
+
+template <typename MatrixType>
+inline
+void
+ConstraintMatrix::
+distribute_local_to_global (const FullMatrix<typename MatrixType::value_type>     &local_matrix,
+                            const std::vector<size_type> &local_dof_indices,
+                            MatrixType                   &global_matrix,
+                            Threads::SpinLockTable       &row_locks) const
+{
+  typedef typename MatrixType::value_type number;
+  Vector<number> dummy(0);
+  distribute_local_to_global (internals::LocalMatrixView<number>(local_matrix),
+                              ArrayView<const number>(), local_dof_indices,
+                              global_matrix, dummy, false, &row_locks,
+                              std::integral_constant<bool, IsBlockMatrix<MatrixType>::value>());
+}
+
+
+
+template <typename MatrixType, int n_dofs>
+inline
+void
+ConstraintMatrix::
+distribute_local_to_global (const SmallFullMatrix<n_dofs,n_dofs,typename MatrixType::value_type> &local_matrix,
+                            const std::vector<size_type> &local_dof_indices,
+                            MatrixType                   &global_matrix) const
+{
+  typedef typename MatrixType::value_type number;
+  Vector<number> dummy(0);
+  distribute_local_to_global (internals::LocalMatrixView<number>(local_matrix.data(),
+                                                                  n_dofs, n_dofs),
+                              ArrayView<const number>(), local_dof_indices,
+                              global_matrix, dummy, false, nullptr,
                               std::integral_constant<bool, IsBlockMatrix<MatrixType>::value>());
 }
 
@@ -1907,8 +2293,62 @@ distribute_local_to_global (const FullMatrix<typename MatrixType::value_type>
 {
   // enter the internal function with the respective block information set,
   // the actual implementation follows in the cm.templates.h file.
-  distribute_local_to_global (local_matrix, local_vector, local_dof_indices,
+  typedef typename VectorType::value_type vector_number;
+  distribute_local_to_global (internals::LocalMatrixView<typename MatrixType::value_type>(local_matrix),
+                              ArrayView<const vector_number>(local_vector.begin(),
+                                                             local_vector.size()),
+                              local_dof_indices,
+                              global_matrix, global_vector, use_inhomogeneities_for_rhs,
+                              nullptr,
+                              std::integral_constant<bool, IsBlockMatrix<MatrixType>::value>());
+}
+
+
+
+template <typename MatrixType, typename VectorType>
+inline
+void
+ConstraintMatrix::
+distribute_local_to_global (const FullMatrix<typename MatrixType::value_type>     &local_matrix,
+                            const Vector<typename VectorType::value_type>         &local_vector,
+                            const std::vector<size_type> &local_dof_indices,
+                            MatrixType                   &global_matrix,
+                            VectorType                   &global_vector,
+                            const bool                    use_inhomogeneities_for_rhs,
+                            Threads::SpinLockTable       &row_locks) const
+{
+  typedef typename VectorType::value_type vector_number;
+  distribute_local_to_global (internals::LocalMatrixView<typename MatrixType::value_type>(local_matrix),
+                              ArrayView<const vector_number>(local_vector.begin(),
+                                                             local_vector.size()),
+                              local_dof_indices,
+                              global_matrix, global_vector, use_inhomogeneities_for_rhs,
+                              &row_locks,
+                              std::integral_constant<bool, IsBlockMatrix<MatrixType>::value>());
+}
+
+
+
+template <typename MatrixType, typename VectorType, int n_dofs, typename LocalVectorType>
+inline
+void
+ConstraintMatrix::
+distribute_local_to_global (const SmallFullMatrix<n_dofs,n_dofs,typename MatrixType::value_type> &local_matrix,
+                            const LocalVectorType        &local_vector,
+                            const std::vector<size_type> &local_dof_indices,
+                            MatrixType                   &global_matrix,
+                            VectorType                   &global_vector,
+                            bool                          use_inhomogeneities_for_rhs) const
+{
+  typedef typename VectorType::value_type vector_number;
+  distribute_local_to_global (internals::LocalMatrixView<typename MatrixType::value_type>
+                              (local_matrix.data(), n_dofs, n_dofs),
+                              ArrayView<const vector_number>(local_vector.size() > 0 ?
+                                                             &local_vector[0] : nullptr,
+                                                             local_vector.size()),
+                              local_dof_indices,
                               global_matrix, global_vector, use_inhomogeneities_for_rhs,
+                              nullptr,
                               std::integral_constant<bool, IsBlockMatrix<MatrixType>::value>());
 }
 
@@ -20,6 +20,7 @@
 
 #include <deal.II/lac/constraint_matrix.h>
 
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/thread_local_storage.h>
 #include <deal.II/lac/full_matrix.h>
@@ -539,20 +540,27 @@ namespace internal
       template <typename Number>
       void set_zero_parallel(const std::vector<size_type> &cm, LinearAlgebra::distributed::Vector<Number> &vec, size_type shift = 0)
       {
-        for (typename std::vector<size_type>::const_iterator it = cm.begin();
-             it != cm.end(); ++it)
-          {
-            // If shift>0 then we are working on a part of a BlockVector
-            // so vec(i) is actually the global entry i+shift.
-            // We first make sure the line falls into the range of vec,
-            // then check if is part of the local part of the vector, before
-            // finally setting it to 0.
-            if ((*it)<shift)
-              continue;
-            size_type idx = *it - shift;
-            if (vec.in_local_range(idx))
-              vec(idx) = 0.;
-          }
+        // the entries are independent of each other, so we can work on them
+        // in parallel
+        parallel::apply_to_subranges
+        (size_type(0), static_cast<size_type>(cm.size()),
+         [&cm,&vec,shift] (const size_type begin, const size_type end)
+        {
+          for (size_type i=begin; i<end; ++i)
+            {
+              // If shift>0 then we are working on a part of a BlockVector
+              // so vec(i) is actually the global entry i+shift.
+              // We first make sure the line falls into the range of vec,
+              // then check if is part of the local part of the vector, before
+              // finally setting it to 0.
+              if (cm[i]<shift)
+                continue;
+              size_type idx = cm[i] - shift;
+              if (vec.in_local_range(idx))
+                vec(idx) = 0.;
+            }
+        },
+        internal::SparseMatrix::minimum_parallel_grain_size);
         vec.zero_out_ghosts();
       }
 
@@ -582,9 +590,16 @@ namespace internal
       void set_zero_serial(const std::vector<size_type> &cm,
                            VectorType                   &vec)
       {
-        for (typename std::vector<size_type>::const_iterator it = cm.begin();
-             it != cm.end(); ++it)
-          vec(*it) = 0.;
+        // the vector is stored in plain memory and the entries are
+        // independent of each other, so we can work on them in parallel
+        parallel::apply_to_subranges
+        (size_type(0), static_cast<size_type>(cm.size()),
+         [&cm,&vec] (const size_type begin, const size_type end)
+        {
+          for (size_type i=begin; i<end; ++i)
+            vec(cm[i]) = 0.;
+        },
+        internal::SparseMatrix::minimum_parallel_grain_size);
       }
 
       template <class VectorType>
@@ -847,6 +862,36 @@ namespace internal
 }
 
 
+namespace internal
+{
+  namespace ConstraintMatrixImplementation
+  {
+    /**
+     * A flag whether the elements of a vector can be written concurrently
+     * from several threads through internal::ElementAccess, as long as each
+     * element is written by only one thread. This holds for all vectors
+     * stored in plain memory, but not for the wrapper classes of external
+     * libraries.
+     */
+    template <typename VectorType>
+    struct SupportsConcurrentElementAccess
+      : std::integral_constant<bool, dealii::is_serial_vector<VectorType>::value>
+    {};
+
+    template <typename Number>
+    struct SupportsConcurrentElementAccess<LinearAlgebra::distributed::Vector<Number> >
+      : std::true_type
+    {};
+
+    template <typename Number>
+    struct SupportsConcurrentElementAccess<LinearAlgebra::distributed::BlockVector<Number> >
+      : std::true_type
+    {};
+  }
+}
+
+
+
 template <class VectorType>
 void
 ConstraintMatrix::distribute (VectorType &vec) const
@@ -880,6 +925,9 @@ ConstraintMatrix::distribute (VectorType &vec) const
       // need to get a vector that has all the *sources* or constraints we
       // own locally, possibly as ghost vector elements, then read from them,
       // and finally throw away the ghosted vector. Implement this in the following.
+      // compress the index set so that the queries below are read-only and
+      // can be done from several threads
+      vec_owned_elements.compress();
       IndexSet needed_elements = vec_owned_elements;
 
       typedef std::vector<ConstraintLine>::const_iterator constraint_iterator;
@@ -896,20 +944,37 @@ ConstraintMatrix::distribute (VectorType &vec) const
                                                    ghosted_vector,
                                                    std::integral_constant<bool, IsBlockVector<VectorType>::value>());
 
-      for (constraint_iterator it = lines.begin();
-           it != lines.end(); ++it)
-        if (vec_owned_elements.is_element(it->index))
+      // after close(), the constraint lines only refer to unconstrained
+      // degrees of freedom, so every line can be resolved independently of
+      // the others. for vectors that allow it, do this in parallel
+      const auto distribute_lines =
+        [&] (const size_type begin, const size_type end)
+      {
+        for (size_type l=begin; l<end; ++l)
           {
-            typename VectorType::value_type
-            new_value = it->inhomogeneity;
-            for (unsigned int i=0; i<it->entries.size(); ++i)
-              new_value += (static_cast<typename VectorType::value_type>
-                            (internal::ElementAccess<VectorType>::get(
-                               ghosted_vector, it->entries[i].first)) *
-                            it->entries[i].second);
-            AssertIsFinite(new_value);
-            internal::ElementAccess<VectorType>::set(new_value, it->index, vec);
+            const ConstraintLine &line = lines[l];
+            if (vec_owned_elements.is_element(line.index))
+              {
+                typename VectorType::value_type
+                new_value = line.inhomogeneity;
+                for (unsigned int i=0; i<line.entries.size(); ++i)
+                  new_value += (static_cast<typename VectorType::value_type>
+                                (internal::ElementAccess<VectorType>::get(
+                                   ghosted_vector, line.entries[i].first)) *
+                                line.entries[i].second);
+                AssertIsFinite(new_value);
+                internal::ElementAccess<VectorType>::set(new_value, line.index, vec);
+              }
           }
+      };
+      if (internal::ConstraintMatrixImplementation::
+          SupportsConcurrentElementAccess<VectorType>::value)
+        parallel::apply_to_subranges (size_type(0),
+                                      static_cast<size_type>(lines.size()),
+                                      distribute_lines,
+                                      internal::SparseMatrix::minimum_parallel_grain_size);
+      else
+        distribute_lines (0, lines.size());
 
       // now compress to communicate the entries that we added to
       // and that weren't to local processors to the owner
@@ -923,23 +988,37 @@ ConstraintMatrix::distribute (VectorType &vec) const
     // support anything else or because it's completely stored
     // locally)
     {
-      std::vector<ConstraintLine>::const_iterator next_constraint = lines.begin();
-      for (; next_constraint != lines.end(); ++next_constraint)
-        {
-          // fill entry in line
-          // next_constraint.index by adding the
-          // different contributions
-          typename VectorType::value_type
-          new_value = next_constraint->inhomogeneity;
-          for (unsigned int i=0; i<next_constraint->entries.size(); ++i)
-            new_value += (static_cast<typename VectorType::value_type>
-                          (internal::ElementAccess<VectorType>::get(
-                             vec, next_constraint->entries[i].first))*
-                          next_constraint->entries[i].second);
-          AssertIsFinite(new_value);
-          internal::ElementAccess<VectorType>::set(new_value, next_constraint->index,
-                                                   vec);
-        }
+      // the constraint lines only read from unconstrained entries and each
+      // line writes a different entry, so they can be processed in parallel
+      const auto distribute_lines =
+        [&] (const size_type begin, const size_type end)
+      {
+        for (size_type l=begin; l<end; ++l)
+          {
+            const ConstraintLine &next_constraint = lines[l];
+            // fill entry in line
+            // next_constraint.index by adding the
+            // different contributions
+            typename VectorType::value_type
+            new_value = next_constraint.inhomogeneity;
+            for (unsigned int i=0; i<next_constraint.entries.size(); ++i)
+              new_value += (static_cast<typename VectorType::value_type>
+                            (internal::ElementAccess<VectorType>::get(
+                               vec, next_constraint.entries[i].first))*
+                            next_constraint.entries[i].second);
+            AssertIsFinite(new_value);
+            internal::ElementAccess<VectorType>::set(new_value, next_constraint.index,
+                                                     vec);
+          }
+      };
+      if (internal::ConstraintMatrixImplementation::
+          SupportsConcurrentElementAccess<VectorType>::value)
+        parallel::apply_to_subranges (size_type(0),
+                                      static_cast<size_type>(lines.size()),
+                                      distribute_lines,
+                                      internal::SparseMatrix::minimum_parallel_grain_size);
+      else
+        distribute_lines (0, lines.size());
     }
 }
 
@@ -1607,7 +1686,7 @@ namespace internals
                                   const size_type              i,
                                   const size_type              j,
                                   const size_type              loc_row,
-                                  const FullMatrix<LocalType> &local_matrix)
+                                  const LocalMatrixView<LocalType> &local_matrix)
   {
     const size_type loc_col = global_cols.local_row(j);
     LocalType col_val;
@@ -1659,7 +1738,7 @@ namespace internals
                       const size_type               i,
                       const size_type               column_start,
                       const size_type               column_end,
-                      const FullMatrix<LocalType>  &local_matrix,
+                      const LocalMatrixView<LocalType> &local_matrix,
                       size_type                   *&col_ptr,
                       number                      *&val_ptr)
   {
@@ -1747,7 +1826,7 @@ namespace internals
                       const size_type              i,
                       const size_type              column_start,
                       const size_type              column_end,
-                      const FullMatrix<LocalType> &local_matrix,
+                      const LocalMatrixView<LocalType> &local_matrix,
                       SparseMatrix<number>        *sparse_matrix)
   {
     if (column_end == column_start)
@@ -1966,6 +2045,37 @@ add_this_index:
 
 
 
+  // lock for a row of the global matrix (and the respective vector entry)
+  // in distribute_local_to_global that is held during the lifetime of the
+  // object. does nothing if no table of locks is given, i.e., in the usual
+  // case where the caller makes sure that no two threads write into the same
+  // row
+  class RowLock
+  {
+  public:
+    RowLock (Threads::SpinLockTable *row_locks,
+             const size_type         row)
+      :
+      row_locks (row_locks),
+      row (row)
+    {
+      if (row_locks != nullptr)
+        row_locks->acquire (row);
+    }
+
+    ~RowLock ()
+    {
+      if (row_locks != nullptr)
+        row_locks->release (row);
+    }
+
+  private:
+    Threads::SpinLockTable *row_locks;
+    const size_type         row;
+  };
+
+
+
   // to make sure that the global matrix remains invertible, we need to do
   // something with the diagonal elements. add the absolute value of the local
   // matrix, so the resulting entry will always be positive and furthermore be
@@ -1983,11 +2093,12 @@ add_this_index:
   inline void
   set_matrix_diagonals (const internals::GlobalRowsFromLocal              &global_rows,
                         const std::vector<size_type>                      &local_dof_indices,
-                        const FullMatrix<typename MatrixType::value_type> &local_matrix,
+                        const LocalMatrixView<typename MatrixType::value_type> &local_matrix,
                         const ConstraintMatrix                            &constraints,
                         MatrixType                                        &global_matrix,
                         VectorType                                        &global_vector,
-                        bool                                               use_inhomogeneities_for_rhs)
+                        bool                                               use_inhomogeneities_for_rhs,
+                        Threads::SpinLockTable                            *row_locks)
   {
     if (global_rows.n_constraints() > 0)
       {
@@ -2003,6 +2114,7 @@ add_this_index:
             const typename MatrixType::value_type new_diagonal
               = (std::abs(local_matrix(local_row,local_row)) != 0 ?
                  std::abs(local_matrix(local_row,local_row)) : average_diagonal);
+            const RowLock row_lock (row_locks, global_row);
             global_matrix.add(global_row, global_row, new_diagonal);
 
             // if the use_inhomogeneities_for_rhs flag is set to true, the
@@ -2068,6 +2180,7 @@ add_this_index:
 // and then go through the
 // lines and collect all the local rows that
 // are related to it.
+inline
 void
 ConstraintMatrix::
 make_sorted_row_list (const std::vector<size_type>   &local_dof_indices,
@@ -2191,11 +2304,11 @@ template < typename LocalType>
 inline
 LocalType
 ConstraintMatrix::
-resolve_vector_entry (const size_type                       i,
-                      const internals::GlobalRowsFromLocal &global_rows,
-                      const Vector<LocalType>              &local_vector,
-                      const std::vector<size_type>         &local_dof_indices,
-                      const FullMatrix<LocalType>          &local_matrix) const
+resolve_vector_entry (const size_type                            i,
+                      const internals::GlobalRowsFromLocal      &global_rows,
+                      const ArrayView<const LocalType>          &local_vector,
+                      const std::vector<size_type>              &local_dof_indices,
+                      const internals::LocalMatrixView<LocalType> &local_matrix) const
 {
   const size_type loc_row = global_rows.local_row(i);
   const size_type n_inhomogeneous_rows = global_rows.n_inhomogeneities();
@@ -2205,7 +2318,7 @@ resolve_vector_entry (const size_type                       i,
   // row.
   if (loc_row != numbers::invalid_size_type)
     {
-      val = local_vector(loc_row);
+      val = local_vector[loc_row];
       for (size_type i=0; i<n_inhomogeneous_rows; ++i)
         val -= (local_matrix(loc_row, global_rows.constraint_origin(i)) *
                 lines[lines_cache[calculate_line_index(local_dof_indices
@@ -2217,7 +2330,7 @@ resolve_vector_entry (const size_type                       i,
   for (size_type q=0; q<global_rows.size(i); ++q)
     {
       const size_type loc_row_q = global_rows.local_row(i,q);
-      LocalType add_this = local_vector (loc_row_q);
+      LocalType add_this = local_vector[loc_row_q];
       for (size_type k=0; k<n_inhomogeneous_rows; ++k)
         add_this -= (local_matrix(loc_row_q,global_rows.constraint_origin(k)) *
                      lines[lines_cache[calculate_line_index
@@ -2235,12 +2348,13 @@ resolve_vector_entry (const size_type                       i,
 template <typename MatrixType, typename VectorType>
 void
 ConstraintMatrix::distribute_local_to_global (
-  const FullMatrix<typename MatrixType::value_type> &local_matrix,
-  const Vector<typename VectorType::value_type>     &local_vector,
+  const internals::LocalMatrixView<typename MatrixType::value_type> &local_matrix,
+  const ArrayView<const typename VectorType::value_type>          &local_vector,
   const std::vector<size_type>                      &local_dof_indices,
   MatrixType                                        &global_matrix,
   VectorType                                        &global_vector,
   bool                                               use_inhomogeneities_for_rhs,
+  Threads::SpinLockTable                            *row_locks,
   std::integral_constant<bool, false>) const
 {
   // check whether we work on real vectors or we just used a dummy when
@@ -2260,6 +2374,8 @@ ConstraintMatrix::distribute_local_to_global (
       AssertDimension (global_matrix.m(), global_vector.size());
     }
   Assert (lines.empty() || sorted == true, ExcMatrixNotClosed());
+  Assert (row_locks == nullptr || row_locks->size() == global_matrix.m(),
+          ExcDimensionMismatch(row_locks->size(), global_matrix.m()));
 
   const size_type n_local_dofs = local_dof_indices.size();
 
@@ -2301,6 +2417,7 @@ ConstraintMatrix::distribute_local_to_global (
   for (size_type i=0; i<n_actual_dofs; ++i)
     {
       const size_type row = global_rows.global_row(i);
+      const internals::RowLock row_lock (row_locks, row);
 
       // calculate all the data that will be written into the matrix row.
       if (use_dealii_matrix == false)
@@ -2334,7 +2451,11 @@ ConstraintMatrix::distribute_local_to_global (
                                                    local_matrix);
           AssertIsFinite(val);
 
-          if (val != number ())
+          // with locks, the entry must be written while we hold the lock of
+          // this row, so we cannot defer it to the bulk update below
+          if (val != number () && row_locks != nullptr)
+            global_vector(row) += static_cast<typename VectorType::value_type>(val);
+          else if (val != number ())
             {
               vector_indices[local_row_n] = row;
               vector_values[local_row_n] = val;
@@ -2369,7 +2490,8 @@ ConstraintMatrix::distribute_local_to_global (
 
   internals::set_matrix_diagonals (global_rows, local_dof_indices,
                                    local_matrix, *this,
-                                   global_matrix, global_vector, use_inhomogeneities_for_rhs);
+                                   global_matrix, global_vector, use_inhomogeneities_for_rhs,
+                                   row_locks);
 }
 
 
@@ -2380,12 +2502,13 @@ template <typename MatrixType, typename VectorType>
 void
 ConstraintMatrix::
 distribute_local_to_global (
-  const FullMatrix<typename MatrixType::value_type> &local_matrix,
-  const Vector<typename VectorType::value_type>     &local_vector,
+  const internals::LocalMatrixView<typename MatrixType::value_type> &local_matrix,
+  const ArrayView<const typename VectorType::value_type>          &local_vector,
   const std::vector<size_type>                      &local_dof_indices,
   MatrixType                                        &global_matrix,
   VectorType                                        &global_vector,
   bool                                               use_inhomogeneities_for_rhs,
+  Threads::SpinLockTable                            *row_locks,
   std::integral_constant<bool, true>) const
 {
   const bool use_vectors = (local_vector.size() == 0 &&
@@ -2405,6 +2528,8 @@ distribute_local_to_global (
       AssertDimension (global_matrix.m(), global_vector.size());
     }
   Assert (sorted == true, ExcMatrixNotClosed());
+  Assert (row_locks == nullptr || row_locks->size() == global_matrix.m(),
+          ExcDimensionMismatch(row_locks->size(), global_matrix.m()));
 
   typename internals::ConstraintMatrixData<number>::ScratchDataAccessor
   scratch_data;
@@ -2416,8 +2541,10 @@ distribute_local_to_global (
   make_sorted_row_list (local_dof_indices, global_rows);
   const size_type n_actual_dofs = global_rows.size();
 
+  // the row indices are translated to the index within the block below, so
+  // keep the global indices for the vector and the locks
   std::vector<size_type> &global_indices = scratch_data->vector_indices;
-  if (use_vectors == true)
+  if (use_vectors == true || row_locks != nullptr)
     {
       global_indices.resize(n_actual_dofs);
       for (size_type i=0; i<n_actual_dofs; ++i)
@@ -2447,6 +2574,9 @@ distribute_local_to_global (
       for (size_type i=block_starts[block]; i<next_block; ++i)
         {
           const size_type row = global_rows.global_row(i);
+          const internals::RowLock row_lock (row_locks,
+                                             row_locks != nullptr ?
+                                             global_indices[i] : row);
 
           for (size_type block_col=0; block_col<num_blocks; ++block_col)
             {
@@ -2492,7 +2622,8 @@ distribute_local_to_global (
 
   internals::set_matrix_diagonals (global_rows, local_dof_indices,
                                    local_matrix, *this,
-                                   global_matrix, global_vector, use_inhomogeneities_for_rhs);
+                                   global_matrix, global_vector, use_inhomogeneities_for_rhs,
+                                   row_locks);
 }
 
 
@@ -2547,6 +2678,8 @@ ConstraintMatrix::distribute_local_to_global (
   cols.resize(n_actual_col_dofs);
   vals.resize(n_actual_col_dofs);
 
+  const internals::LocalMatrixView<number> local_matrix_view (local_matrix);
+
   // now do the actual job.
   for (size_type i=0; i<n_actual_row_dofs; ++i)
     {
@@ -2557,7 +2690,7 @@ ConstraintMatrix::distribute_local_to_global (
       number    *val_ptr = &vals[0];
       internals::resolve_matrix_row (global_rows, global_cols, i, 0,
                                      n_actual_col_dofs,
-                                     local_matrix, col_ptr, val_ptr);
+                                     local_matrix_view, col_ptr, val_ptr);
       const size_type n_values = col_ptr - &cols[0];
       if (n_values > 0)
         global_matrix.add(row, n_values, &cols[0], &vals[0], false, true);
@@ -0,0 +1,290 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_cuda_sparse_matrix_h
+#define dealii_cuda_sparse_matrix_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/types.h>
+
+#ifdef DEAL_II_WITH_CUDA
+
+#include <deal.II/lac/cuda_vector.h>
+#include <cusparse.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+template <typename number> class SparseMatrix;
+
+namespace CUDAWrappers
+{
+  /**
+   * A sparse matrix stored in compressed row storage (CSR) format in the
+   * memory of the GPU. The matrix is created from a dealii::SparseMatrix on
+   * the host, whose sparsity pattern and entries are copied to the device,
+   * and the matrix-vector products are performed by the cuSPARSE library on
+   * vectors of type LinearAlgebra::CUDAWrappers::Vector. Together with
+   * matrix-free operators based on CUDAWrappers::MatrixFree, this allows to
+   * keep operators that are based on matrices, e.g. on the coarse levels of
+   * a multigrid method or for elements without tensor product structure, on
+   * the device.
+   *
+   * The class also stores the inverse of the diagonal of the matrix, which
+   * is used by precondition_Jacobi() and Jacobi_step() to run
+   * PreconditionJacobi on the device, and by PreconditionChebyshev to set
+   * up its diagonal preconditioner. The matrix entries can not be changed
+   * after the matrix has been created other than by calling reinit() with
+   * a new matrix.
+   *
+   * The indices are stored as 32 bit integers as required by cuSPARSE, so
+   * the number of rows, columns and nonzero entries must be representable
+   * by an <tt>int</tt>.
+   *
+   * @ingroup CUDAWrappers
+   * @ingroup Matrix1
+   */
+  template <typename Number>
+  class SparseMatrix : public virtual Subscriptor
+  {
+  public:
+    /**
+     * Declare type for container size.
+     */
+    typedef types::global_dof_index size_type;
+
+    /**
+     * Type of the matrix entries.
+     */
+    typedef Number value_type;
+
+    /**
+     * Constructor. Create an empty matrix.
+     */
+    SparseMatrix ();
+
+    /**
+     * Constructor. Copy the given matrix to the device, see reinit().
+     */
+    explicit SparseMatrix (const ::dealii::SparseMatrix<Number> &matrix);
+
+    /**
+     * Destructor. Free the memory on the device.
+     */
+    ~SparseMatrix ();
+
+    /**
+     * Copying is not allowed, as the matrix holds memory on the device and
+     * a cuSPARSE handle.
+     */
+    SparseMatrix (const SparseMatrix<Number> &) = delete;
+
+    /**
+     * Copying is not allowed.
+     */
+    SparseMatrix<Number> &operator= (const SparseMatrix<Number> &) = delete;
+
+    /**
+     * Copy the sparsity pattern and the entries of the given matrix to the
+     * device, replacing the previous content. The entries of each row are
+     * stored sorted by their column, i.e., the diagonal entry that
+     * dealii::SparseMatrix stores first in each row of a square matrix is
+     * moved to its position.
+     */
+    void reinit (const ::dealii::SparseMatrix<Number> &matrix);
+
+    /**
+     * Return the number of rows of the matrix.
+     */
+    size_type m () const;
+
+    /**
+     * Return the number of columns of the matrix.
+     */
+    size_type n () const;
+
+    /**
+     * Return the number of nonzero entries of the matrix.
+     */
+    std::size_t n_nonzero_elements () const;
+
+    /**
+     * Matrix-vector multiplication: let $dst = M*src$ with $M$ being this
+     * matrix.
+     */
+    void vmult (LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const;
+
+    /**
+     * Matrix-vector multiplication: let $dst = M^T*src$ with $M$ being this
+     * matrix.
+     */
+    void Tvmult (LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                 const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const;
+
+    /**
+     * Adding matrix-vector multiplication: add $M*src$ to $dst$ with $M$
+     * being this matrix.
+     */
+    void vmult_add (LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                    const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const;
+
+    /**
+     * Adding matrix-vector multiplication: add $M^T*src$ to $dst$ with $M$
+     * being this matrix.
+     */
+    void Tvmult_add (LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                     const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const;
+
+    /**
+     * Apply the Jacobi preconditioner, which multiplies every element of the
+     * @p src vector by the inverse of the respective diagonal element and
+     * multiplies the result with the relaxation factor @p omega.
+     */
+    void precondition_Jacobi (LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                              const LinearAlgebra::CUDAWrappers::Vector<Number> &src,
+                              const Number                                       omega = 1.) const;
+
+    /**
+     * Do one Jacobi step on @p v with right hand side @p b, i.e., set $v =
+     * v + \omega D^{-1}(b-Mv)$. This function needs an auxiliary vector,
+     * which is acquired from GrowingVectorMemory.
+     */
+    void Jacobi_step (LinearAlgebra::CUDAWrappers::Vector<Number>       &v,
+                      const LinearAlgebra::CUDAWrappers::Vector<Number> &b,
+                      const Number                                       omega = 1.) const;
+
+    /**
+     * Return the inverse of the diagonal of the matrix, as computed by
+     * reinit().
+     */
+    const LinearAlgebra::CUDAWrappers::Vector<Number> &get_diagonal_inverse () const;
+
+    /**
+     * Return the memory consumption of the matrix on the device in bytes.
+     */
+    std::size_t memory_consumption () const;
+
+  private:
+    /**
+     * Run the matrix-vector product with cuSPARSE, computing $dst =
+     * op(M) src + \beta dst$.
+     */
+    void apply (const cusparseOperation_t                           operation,
+                const Number                                        beta,
+                LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const;
+
+    /**
+     * Free the memory on the device.
+     */
+    void clear ();
+
+    /**
+     * The handle of the cuSPARSE library.
+     */
+    cusparseHandle_t cusparse_handle;
+
+    /**
+     * The description of the matrix for cuSPARSE, a general matrix with
+     * zero-based indices.
+     */
+    cusparseMatDescr_t descriptor;
+
+    /**
+     * The number of rows of the matrix.
+     */
+    int n_rows;
+
+    /**
+     * The number of columns of the matrix.
+     */
+    int n_cols;
+
+    /**
+     * The number of nonzero entries of the matrix.
+     */
+    int n_nonzero;
+
+    /**
+     * The entries of the matrix on the device.
+     */
+    Number *values_dev;
+
+    /**
+     * The column indices of the entries on the device.
+     */
+    int *column_index_dev;
+
+    /**
+     * The start of each row within #values_dev and #column_index_dev on the
+     * device, with one more entry than the number of rows.
+     */
+    int *row_ptr_dev;
+
+    /**
+     * The inverse of the diagonal of the matrix.
+     */
+    LinearAlgebra::CUDAWrappers::Vector<Number> diagonal_inverse;
+  };
+
+
+
+  // ------------------------------ Inline functions -----------------------------
+
+  template <typename Number>
+  inline
+  typename SparseMatrix<Number>::size_type
+  SparseMatrix<Number>::m () const
+  {
+    return n_rows;
+  }
+
+
+
+  template <typename Number>
+  inline
+  typename SparseMatrix<Number>::size_type
+  SparseMatrix<Number>::n () const
+  {
+    return n_cols;
+  }
+
+
+
+  template <typename Number>
+  inline
+  std::size_t
+  SparseMatrix<Number>::n_nonzero_elements () const
+  {
+    return n_nonzero;
+  }
+
+
+
+  template <typename Number>
+  inline
+  const LinearAlgebra::CUDAWrappers::Vector<Number> &
+  SparseMatrix<Number>::get_diagonal_inverse () const
+  {
+    return diagonal_inverse;
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
+
+#endif
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2016 by the deal.II authors
+// Copyright (C) 2016 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -77,6 +77,12 @@ namespace LinearAlgebra
        */
       ~Vector();
 
+      /**
+       * Copy assignment operator. Copy the elements of @p V on the device,
+       * resizing this vector if necessary.
+       */
+      Vector<Number> &operator= (const Vector<Number> &V);
+
       /**
        * Reinit functionality. The flag <tt>omit_zeroing_entries</tt>
        * determines wheter the vector should be filled with zero (false) or
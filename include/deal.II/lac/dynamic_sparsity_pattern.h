@@ -26,12 +26,164 @@
 #include <vector>
 #include <algorithm>
 #include <iostream>
+#include <memory>
 
 DEAL_II_NAMESPACE_OPEN
 
 class DynamicSparsityPattern;
 
 
+namespace internal
+{
+  namespace DynamicSparsityPatternImplementation
+  {
+    /**
+     * A memory pool for the column indices of the rows of a
+     * DynamicSparsityPattern. Memory is taken from large chunks in blocks
+     * whose sizes are powers of two. Blocks that are returned go into a free
+     * list for their size and are handed out again on the next request of
+     * the same size, which is the typical pattern of rows that grow by
+     * doubling their capacity. The chunks themselves are only returned to the
+     * operating system all at once, in release() or the destructor.
+     *
+     * This replaces the many small heap allocations of a pattern with many
+     * rows by a few large ones, and avoids the fragmentation and the
+     * per-allocation overhead of the system allocator.
+     */
+    class RowPool
+    {
+    public:
+      /**
+       * Constructor.
+       */
+      RowPool ();
+
+      /**
+       * Return a block of at least @p n_bytes bytes.
+       */
+      void *allocate (const std::size_t n_bytes);
+
+      /**
+       * Return a block obtained from allocate() with the same @p n_bytes to
+       * the pool.
+       */
+      void deallocate (void              *ptr,
+                       const std::size_t  n_bytes);
+
+      /**
+       * Release all memory of the pool at once. Any block handed out before
+       * becomes invalid.
+       */
+      void release ();
+
+      /**
+       * Return the memory allocated by the pool, in bytes.
+       */
+      std::size_t memory_consumption () const;
+
+    private:
+      /**
+       * Return the index of the size class for a request of @p n_bytes,
+       * i.e., the exponent of the smallest power of two that holds @p
+       * n_bytes bytes and at least one pointer.
+       */
+      static unsigned int size_class (const std::size_t n_bytes);
+
+      /**
+       * The chunks of memory allocated so far.
+       */
+      std::vector<std::unique_ptr<char[]> > chunks;
+
+      /**
+       * The memory allocated so far, in bytes.
+       */
+      std::size_t allocated_bytes;
+
+      /**
+       * The next unused position in the current chunk and the number of
+       * bytes left there.
+       */
+      char        *chunk_position;
+      std::size_t  chunk_remaining;
+
+      /**
+       * The heads of the lists of returned blocks for each size class. The
+       * blocks are linked through a pointer stored at their beginning.
+       */
+      std::vector<void *> free_lists;
+    };
+
+
+
+    /**
+     * An allocator for the row storage of DynamicSparsityPattern that takes
+     * its memory from a RowPool, or from the global operator new if no pool
+     * is given.
+     */
+    template <typename T>
+    class RowAllocator
+    {
+    public:
+      typedef T value_type;
+
+      typedef std::true_type propagate_on_container_copy_assignment;
+      typedef std::true_type propagate_on_container_move_assignment;
+      typedef std::true_type propagate_on_container_swap;
+
+      template <typename U>
+      struct rebind
+      {
+        typedef RowAllocator<U> other;
+      };
+
+      RowAllocator (RowPool *pool = nullptr)
+        :
+        pool (pool)
+      {}
+
+      template <typename U>
+      RowAllocator (const RowAllocator<U> &other)
+        :
+        pool (other.pool)
+      {}
+
+      T *allocate (const std::size_t n)
+      {
+        if (pool != nullptr)
+          return static_cast<T *>(pool->allocate(n*sizeof(T)));
+        else
+          return static_cast<T *>(::operator new(n*sizeof(T)));
+      }
+
+      void deallocate (T *ptr, const std::size_t n)
+      {
+        if (pool != nullptr)
+          pool->deallocate(ptr, n*sizeof(T));
+        else
+          ::operator delete(ptr);
+      }
+
+      template <typename U>
+      bool operator == (const RowAllocator<U> &other) const
+      {
+        return pool == other.pool;
+      }
+
+      template <typename U>
+      bool operator != (const RowAllocator<U> &other) const
+      {
+        return pool != other.pool;
+      }
+
+      /**
+       * The pool to take memory from, or nullptr.
+       */
+      RowPool *pool;
+    };
+  }
+}
+
+
 /*! @addtogroup Sparsity
  *@{
  */
@@ -50,6 +202,12 @@ namespace DynamicSparsityPatternIterators
    */
   typedef types::global_dof_index size_type;
 
+  /**
+   * The type used for storing the column indices of a row.
+   */
+  typedef std::vector<size_type, internal::DynamicSparsityPatternImplementation::RowAllocator<size_type> >
+  RowEntries;
+
   /**
    * Accessor class for iterators into objects of type DynamicSparsityPattern.
    *
@@ -120,7 +278,7 @@ namespace DynamicSparsityPatternIterators
      * A pointer to the element within the current row that we currently point
      * to.
      */
-    std::vector<size_type>::const_iterator current_entry;
+    RowEntries::const_iterator current_entry;
 
     /**
      * A pointer to the end of the current row. We store this to make
@@ -128,7 +286,7 @@ namespace DynamicSparsityPatternIterators
      * needs to do the IndexSet translation from row index to the index within
      * the 'lines' array of DynamicSparsityPattern.
      */
-    std::vector<size_type>::const_iterator end_of_row;
+    RowEntries::const_iterator end_of_row;
 
     /**
      * Move the accessor to the next nonzero entry in the matrix.
@@ -370,6 +528,23 @@ public:
                const size_type n,
                const IndexSet &rowset = IndexSet());
 
+  /**
+   * Select whether the column indices of the rows are stored in a memory
+   * pool owned by this object rather than in a separate heap allocation per
+   * row. For patterns with many rows, the pool replaces the many small
+   * allocations by a few large ones, which is faster, reduces fragmentation,
+   * and avoids the overhead the system allocator adds to each allocation.
+   * The memory of the rows is then only returned to the system when the
+   * object is destroyed or reinit() is called. The pool is disabled by
+   * default.
+   *
+   * This function can be called at any time, but discards the current
+   * entries of the pattern, i.e., it should be called right after the
+   * constructor or reinit(). All other functions of this class work the same
+   * with and without the pool.
+   */
+  void set_pooled_row_storage (const bool use_pool);
+
   /**
    * Since this object is kept compressed at all times anyway, this function
    * does nothing, but is declared to make the interface of this class as much
@@ -592,11 +767,17 @@ private:
   struct Line
   {
   public:
+    /**
+     * Constructor. Take the memory for the entries from the given allocator.
+     */
+    Line (const DynamicSparsityPatternIterators::RowEntries::allocator_type &allocator
+          = DynamicSparsityPatternIterators::RowEntries::allocator_type());
+
     /**
      * Storage for the column indices of this row. This array is always kept
      * sorted.
      */
-    std::vector<size_type> entries;
+    DynamicSparsityPatternIterators::RowEntries entries;
 
     /**
      * Add the given column number to this line.
@@ -618,6 +799,13 @@ private:
   };
 
 
+  /**
+   * The memory pool for the entries of the rows if set_pooled_row_storage()
+   * was called, or nullptr. Declared before the lines that return their
+   * memory to the pool upon destruction.
+   */
+  std::unique_ptr<internal::DynamicSparsityPatternImplementation::RowPool> row_pool;
+
   /**
    * Actual data: store for each row the set of nonzero entries.
    */
@@ -892,6 +1080,15 @@ namespace DynamicSparsityPatternIterators
 }
 
 
+inline
+DynamicSparsityPattern::Line::Line
+(const DynamicSparsityPatternIterators::RowEntries::allocator_type &allocator)
+  :
+  entries (allocator)
+{}
+
+
+
 inline
 void
 DynamicSparsityPattern::Line::add (const size_type j)
@@ -904,7 +1101,7 @@ DynamicSparsityPattern::Line::add (const size_type j)
     }
 
   // do a binary search to find the place where to insert:
-  std::vector<size_type>::iterator
+  DynamicSparsityPatternIterators::RowEntries::iterator
   it = Utilities::lower_bound(entries.begin(),
                               entries.end(),
                               j);
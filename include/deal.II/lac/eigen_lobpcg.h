@@ -0,0 +1,451 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_eigen_lobpcg_h
+#define dealii_eigen_lobpcg_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/identity_matrix.h>
+#include <deal.II/lac/la_parallel_multi_vector.h>
+#include <deal.II/lac/lapack_full_matrix.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * Locally optimal block preconditioned conjugate gradient method (LOBPCG)
+ * of Knyazev for computing the smallest eigenvalues and the associated
+ * eigenvectors of the symmetric generalized eigenvalue problem $Ax=\lambda
+ * Bx$ with $B$ symmetric positive definite.
+ *
+ * The method iterates on a block $X$ of approximate eigenvectors, stored as
+ * the columns of a LinearAlgebra::distributed::MultiVector. In each step,
+ * the residuals $R = AX - BX\Lambda$ are preconditioned, $W = T R$, and the
+ * new approximations are found by a Rayleigh-Ritz procedure on the subspace
+ * spanned by the columns of $X$, of $W$, and of the previous search
+ * directions $P$. Compared to SolverCG-based inverse iterations or to
+ * EigenInverse, all columns are treated at once: the operators are applied
+ * to all columns in one call, and the Gram matrices of the Rayleigh-Ritz
+ * step are computed with MultiVector::inner_product_matrix(), i.e., with
+ * one global reduction per pair of blocks, independent of the number of
+ * eigenvectors. The small dense eigenvalue problem of size three times the
+ * number of columns is solved with LAPACK on every processor.
+ *
+ * The number of eigenpairs computed is given by the number of columns of
+ * the start vector. Upon return, the columns of the vector hold the
+ * $B$-orthonormal eigenvectors in the order of increasing eigenvalues. The
+ * iteration is stopped according to the SolverControl object once the
+ * largest residual norm $\|Ax_c-\lambda_c Bx_c\|$ among all columns
+ * satisfies the criterion. Since columns that converged earlier are not
+ * locked, it is usually a good idea to ask for a few more eigenpairs than
+ * needed, which also speeds up the convergence of the ones of interest.
+ *
+ * If the basis $[X,W,P]$ becomes numerically linearly dependent, which
+ * happens when the iteration is close to convergence, the search directions
+ * $P$ are dropped for one step. The threshold for this restart is set by
+ * AdditionalData::min_reciprocal_condition.
+ *
+ * The operators $A$ and $B$ and the preconditioner must provide a function
+ * <code>vmult(MultiVector&, const MultiVector&)</code>, such as the one of
+ * SparseMatrix, PreconditionIdentity, or a user-defined operator based on
+ * MatrixFree::cell_loop. For the preconditioner, a good choice is an
+ * approximation of the inverse of $A$ (or of $A-\sigma B$ with a shift
+ * $\sigma$ below the wanted eigenvalues), such as a multigrid V-cycle.
+ *
+ * @note This class requires deal.II to be configured with LAPACK.
+ */
+template <typename Number = double>
+class EigenLOBPCG : private Solver<LinearAlgebra::distributed::MultiVector<Number> >
+{
+public:
+  /**
+   * The vector type this solver works on.
+   */
+  typedef LinearAlgebra::distributed::MultiVector<Number> VectorType;
+
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData (const double min_reciprocal_condition = 1e-12)
+      :
+      min_reciprocal_condition (min_reciprocal_condition)
+    {}
+
+    /**
+     * The smallest reciprocal condition number of the $B$-Gram matrix of
+     * the basis $[X,W,P]$ accepted in the Rayleigh-Ritz step. Below this
+     * value, the search directions $P$ are dropped for one step.
+     */
+    double min_reciprocal_condition;
+  };
+
+  /**
+   * Constructor.
+   */
+  EigenLOBPCG (SolverControl            &cn,
+               VectorMemory<VectorType> &mem,
+               const AdditionalData     &data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  EigenLOBPCG (SolverControl        &cn,
+               const AdditionalData &data=AdditionalData());
+
+  /**
+   * Compute the smallest eigenvalues of the generalized eigenvalue problem
+   * $Ax=\lambda Bx$. The number of eigenpairs is the number of columns of
+   * @p x, which holds the start vectors on entry and the eigenvectors on
+   * exit. The start vectors must be linearly independent, random vectors
+   * are a common choice. The vector @p eigenvalues is resized to the number
+   * of columns.
+   */
+  template <typename MatrixType1, typename MatrixType2,
+            typename PreconditionerType>
+  void
+  solve (const MatrixType1         &A,
+         const MatrixType2         &B,
+         const PreconditionerType  &preconditioner,
+         std::vector<Number>       &eigenvalues,
+         VectorType                &x);
+
+  /**
+   * Same as above for the standard eigenvalue problem $Ax=\lambda x$, i.e.,
+   * with $B$ the identity.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve (const MatrixType          &A,
+         const PreconditionerType  &preconditioner,
+         std::vector<Number>       &eigenvalues,
+         VectorType                &x);
+
+protected:
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+
+private:
+  /**
+   * Solve the Rayleigh-Ritz problem for the @p n_wanted smallest eigenpairs
+   * given the Gram matrices of the basis with respect to $A$ and $B$, and
+   * return the eigenvalues and the coefficients of the Ritz vectors in the
+   * columns of @p coefficients. Return false without computing anything if
+   * the $B$-Gram matrix is not positive definite or worse conditioned than
+   * allowed by AdditionalData::min_reciprocal_condition.
+   */
+  bool
+  rayleigh_ritz (const FullMatrix<Number> &gram_A,
+                 const FullMatrix<Number> &gram_B,
+                 const unsigned int        n_wanted,
+                 std::vector<Number>      &eigenvalues,
+                 FullMatrix<Number>       &coefficients) const;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename Number>
+EigenLOBPCG<Number>::EigenLOBPCG (SolverControl            &cn,
+                                  VectorMemory<VectorType> &mem,
+                                  const AdditionalData     &data)
+  :
+  Solver<VectorType>(cn,mem),
+  additional_data(data)
+{}
+
+
+
+template <typename Number>
+EigenLOBPCG<Number>::EigenLOBPCG (SolverControl        &cn,
+                                  const AdditionalData &data)
+  :
+  Solver<VectorType>(cn),
+  additional_data(data)
+{}
+
+
+
+template <typename Number>
+bool
+EigenLOBPCG<Number>::rayleigh_ritz (const FullMatrix<Number> &gram_A,
+                                    const FullMatrix<Number> &gram_B,
+                                    const unsigned int        n_wanted,
+                                    std::vector<Number>      &eigenvalues,
+                                    FullMatrix<Number>       &coefficients) const
+{
+  const unsigned int n = gram_A.m();
+  AssertDimension (gram_B.m(), n);
+  Assert (n_wanted <= n, ExcIndexRange(n_wanted, 0, n+1));
+
+  // symmetrize the matrices, the inner products are only symmetric up to
+  // roundoff
+  LAPACKFullMatrix<Number> matrix_A(n), matrix_B(n);
+  for (unsigned int i=0; i<n; ++i)
+    for (unsigned int j=0; j<n; ++j)
+      {
+        matrix_A(i,j) = Number(0.5) * (gram_A(i,j) + gram_A(j,i));
+        matrix_B(i,j) = Number(0.5) * (gram_B(i,j) + gram_B(j,i));
+      }
+
+  LAPACKFullMatrix<Number> factorization (matrix_B);
+  factorization.set_property (LAPACKSupport::symmetric);
+  const Number norm = factorization.l1_norm();
+  try
+    {
+      factorization.compute_cholesky_factorization();
+    }
+  catch (const LACExceptions::ExcSingular &)
+    {
+      return false;
+    }
+  if (factorization.reciprocal_condition_number(norm) <
+      additional_data.min_reciprocal_condition)
+    return false;
+
+  std::vector<Vector<Number> > eigenvectors (n_wanted);
+  matrix_A.compute_generalized_eigenvalues_symmetric (matrix_B, eigenvectors);
+
+  eigenvalues.resize (n_wanted);
+  coefficients.reinit (n, n_wanted);
+  for (unsigned int c=0; c<n_wanted; ++c)
+    {
+      eigenvalues[c] = matrix_A.eigenvalue(c).real();
+      for (unsigned int i=0; i<n; ++i)
+        coefficients(i,c) = eigenvectors[c](i);
+    }
+  return true;
+}
+
+
+
+template <typename Number>
+template <typename MatrixType1, typename MatrixType2,
+          typename PreconditionerType>
+void
+EigenLOBPCG<Number>::solve (const MatrixType1         &A,
+                            const MatrixType2         &B,
+                            const PreconditionerType  &preconditioner,
+                            std::vector<Number>       &eigenvalues,
+                            VectorType                &x)
+{
+  const unsigned int m = x.n_vectors();
+  Assert (m > 0, ExcMessage ("The start vector must have at least one column."));
+
+  SolverControl::State conv=SolverControl::iterate;
+
+  LogStream::Prefix prefix("lobpcg");
+
+  typename VectorMemory<VectorType>::Pointer ax_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer bx_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer w_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer aw_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer bw_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer p_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer ap_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer bp_pointer(this->memory);
+
+  // keep the products with A and B of all three blocks of the basis, so
+  // that the operators are applied only once per iteration to the
+  // preconditioned residual
+  VectorType &ax = *ax_pointer;
+  VectorType &bx = *bx_pointer;
+  VectorType &w  = *w_pointer;
+  VectorType &aw = *aw_pointer;
+  VectorType &bw = *bw_pointer;
+  VectorType &p  = *p_pointer;
+  VectorType &ap = *ap_pointer;
+  VectorType &bp = *bp_pointer;
+
+  ax.reinit(x, true);
+  bx.reinit(x, true);
+  w.reinit(x, true);
+  aw.reinit(x, true);
+  bw.reinit(x, true);
+  p.reinit(x, true);
+  ap.reinit(x, true);
+  bp.reinit(x, true);
+
+  std::vector<typename VectorType::real_type> norms(m);
+  std::vector<Number> factors(m);
+  const std::vector<Number> ones(m, Number(1.));
+  FullMatrix<Number> gram_A, gram_B, coefficients, block;
+
+  // Rayleigh-Ritz on the start vectors
+  A.vmult(ax, x);
+  B.vmult(bx, x);
+  x.inner_product_matrix(ax, gram_A);
+  x.inner_product_matrix(bx, gram_B);
+  AssertThrow (rayleigh_ritz(gram_A, gram_B, m, eigenvalues, coefficients),
+               ExcMessage ("The start vectors of EigenLOBPCG must be linearly "
+                           "independent."));
+  x.transform(coefficients);
+  ax.transform(coefficients);
+  bx.transform(coefficients);
+
+  bool have_p = false;
+  double res = 0;
+  int it=0;
+  while (true)
+    {
+      // compute the residual R = AX - BX Lambda, stored in aw until A is
+      // applied to the preconditioned residual
+      aw = ax;
+      for (unsigned int c=0; c<m; ++c)
+        factors[c] = -eigenvalues[c];
+      aw.add(factors, bx);
+
+      aw.l2_norms(norms);
+      res = *std::max_element(norms.begin(), norms.end());
+      conv = this->iteration_status(it, res, x);
+      if (conv != SolverControl::iterate)
+        break;
+      it++;
+
+      // precondition the residual and normalize the columns to balance the
+      // Gram matrices
+      preconditioner.vmult(w, aw);
+      w.l2_norms(norms);
+      for (unsigned int c=0; c<m; ++c)
+        factors[c] = (norms[c] > 0) ? Number(1./norms[c]) : Number(1.);
+      w.scale(factors);
+      A.vmult(aw, w);
+      B.vmult(bw, w);
+
+      if (have_p)
+        {
+          p.inner_products(bp, factors);
+          for (unsigned int c=0; c<m; ++c)
+            factors[c] = (factors[c] > Number()) ?
+                         Number(1./std::sqrt(factors[c])) : Number(1.);
+          p.scale(factors);
+          ap.scale(factors);
+          bp.scale(factors);
+        }
+
+      // assemble the Gram matrices of the basis [X, W, P], dropping P if
+      // the basis is close to linear dependence
+      bool success = false;
+      for (unsigned int n_blocks = have_p ? 3 : 2;
+           n_blocks >= 2 && success == false; --n_blocks)
+        {
+          const VectorType *basis[3] = { &x, &w, &p };
+          const VectorType *basis_A[3] = { &ax, &aw, &ap };
+          const VectorType *basis_B[3] = { &bx, &bw, &bp };
+          gram_A.reinit(n_blocks*m, n_blocks*m);
+          gram_B.reinit(n_blocks*m, n_blocks*m);
+          for (unsigned int i=0; i<n_blocks; ++i)
+            for (unsigned int j=i; j<n_blocks; ++j)
+              {
+                basis[i]->inner_product_matrix(*basis_A[j], block);
+                gram_A.fill(block, i*m, j*m);
+                if (j > i)
+                  gram_A.Tadd(block, 1., j*m, i*m);
+                basis[i]->inner_product_matrix(*basis_B[j], block);
+                gram_B.fill(block, i*m, j*m);
+                if (j > i)
+                  gram_B.Tadd(block, 1., j*m, i*m);
+              }
+          success = rayleigh_ritz(gram_A, gram_B, m, eigenvalues, coefficients);
+          if (success == false && n_blocks == 3)
+            deallog << "Restart without search directions in step "
+                    << it << std::endl;
+          if (success == true && n_blocks == 2)
+            have_p = false;
+        }
+      AssertThrow (success,
+                   ExcMessage ("The basis of the Rayleigh-Ritz step in "
+                               "EigenLOBPCG is linearly dependent."));
+
+      // the new search directions are P = W Cw + P Cp, the new approximate
+      // eigenvectors X = X Cx + P
+      FullMatrix<Number> cx(m, m), cw(m, m);
+      cx.fill(coefficients, 0, 0, 0, 0);
+      cw.fill(coefficients, 0, 0, m, 0);
+      if (have_p)
+        {
+          FullMatrix<Number> cp(m, m);
+          cp.fill(coefficients, 0, 0, 2*m, 0);
+          p.transform(cp);
+          ap.transform(cp);
+          bp.transform(cp);
+        }
+      else
+        {
+          p = Number();
+          ap = Number();
+          bp = Number();
+        }
+      p.add_product(w, cw);
+      ap.add_product(aw, cw);
+      bp.add_product(bw, cw);
+
+      x.transform(cx);
+      ax.transform(cx);
+      bx.transform(cx);
+      x.add(ones, p);
+      ax.add(ones, ap);
+      bx.add(ones, bp);
+      have_p = true;
+    }
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence (it, res));
+  // otherwise exit as normal
+}
+
+
+
+template <typename Number>
+template <typename MatrixType, typename PreconditionerType>
+void
+EigenLOBPCG<Number>::solve (const MatrixType          &A,
+                            const PreconditionerType  &preconditioner,
+                            std::vector<Number>       &eigenvalues,
+                            VectorType                &x)
+{
+  solve (A, IdentityMatrix(x.size()), preconditioner, eigenvalues, x);
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,839 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_la_parallel_multi_vector_h
+#define dealii_la_parallel_multi_vector_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/vector_operation.h>
+
+#include <memory>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+
+    /*! @addtogroup Vectors
+     *@{
+     */
+
+    /**
+     * A collection of @p n_vectors distributed vectors that all share the
+     * same parallel partitioning, e.g. a block of right hand sides that are
+     * to be solved for with the same matrix at once.
+     *
+     * As opposed to a std::vector of LinearAlgebra::distributed::Vector
+     * objects, the entries are stored in row-major order: all @p n_vectors
+     * values belonging to one row (i.e., one degree of freedom) are
+     * contiguous in memory, with row @p i of column @p c found at position
+     * <code>i*n_vectors()+c</code>. This has two advantages:
+     * <ul>
+     * <li> Operations that read an entry of a matrix (such as a sparse
+     * matrix-vector product, or the evaluation of a cell integral) can apply
+     * that entry to all columns at once, i.e., the matrix is loaded from
+     * memory only once per block rather than once per column. Since these
+     * operations are typically limited by memory bandwidth, this increases the
+     * arithmetic intensity by up to a factor of @p n_vectors.
+     * <li> The ghost exchange and the compress() operation are done once for
+     * all columns, sending one message of size @p n_vectors times the single
+     * vector message size to each neighbor. The latency of the data exchange
+     * thus is paid only once.
+     * </ul>
+     *
+     * Internally, the data is held by a LinearAlgebra::distributed::Vector
+     * defined on an expanded partitioner in which every index @p i of the
+     * original partitioner is replaced by the range <code>[i*n_vectors,
+     * (i+1)*n_vectors)</code>. All communication is delegated to that
+     * vector. The original partitioner, describing the layout of a single
+     * column, is kept and returned by get_partitioner().
+     *
+     * The column operations (add(), sadd(), inner_products()) take one scalar
+     * per column, so that Krylov methods that run independent recurrences for
+     * each column (such as SolverMultiVectorCG) can be expressed with a single
+     * sweep through memory and, for the reductions, a single global
+     * communication per operation.
+     */
+    template <typename Number>
+    class MultiVector : public Subscriptor
+    {
+    public:
+      /**
+       * Declare standard types used in all containers.
+       */
+      typedef Number                                            value_type;
+      typedef types::global_dof_index                           size_type;
+      typedef typename numbers::NumberTraits<Number>::real_type real_type;
+
+      /**
+       * Constructor. Create an empty object with zero columns.
+       */
+      MultiVector ();
+
+      /**
+       * Constructor. Create @p n_vectors columns with the layout described by
+       * @p partitioner, all set to zero.
+       */
+      MultiVector (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+                   const unsigned int n_vectors);
+
+      /**
+       * Set up @p n_vectors columns with the layout described by @p
+       * partitioner and set all entries (including ghosts) to zero.
+       */
+      void reinit (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+                   const unsigned int n_vectors);
+
+      /**
+       * Set up the same layout as @p other. Unless @p omit_zeroing_entries is
+       * true, all entries are set to zero.
+       */
+      void reinit (const MultiVector<Number> &other,
+                   const bool                 omit_zeroing_entries = false);
+
+      /**
+       * Set all locally owned entries to the scalar @p s. Only zero is
+       * allowed as in the underlying vector class, in which case the ghost
+       * entries are zeroed as well.
+       */
+      MultiVector<Number> &operator = (const Number s);
+
+      /**
+       * Return the number of columns.
+       */
+      unsigned int n_vectors () const;
+
+      /**
+       * Return the global number of rows, i.e., the size of a single column.
+       */
+      size_type size () const;
+
+      /**
+       * Return the number of locally owned rows.
+       */
+      unsigned int local_size () const;
+
+      /**
+       * Return the partitioner describing the layout of a single column.
+       */
+      const std::shared_ptr<const Utilities::MPI::Partitioner> &
+      get_partitioner () const;
+
+      /**
+       * Read access to the entry in row @p local_row (a local index, i.e., a
+       * number between zero and local_size() plus the number of ghosts) of
+       * column @p column.
+       */
+      Number local_element (const size_type    local_row,
+                            const unsigned int column) const;
+
+      /**
+       * Read and write access to the entry in row @p local_row of column @p
+       * column.
+       */
+      Number &local_element (const size_type    local_row,
+                             const unsigned int column);
+
+      /**
+       * Read access to the entry in global row @p global_row of column @p
+       * column. The row must be locally owned or a ghost.
+       */
+      Number operator () (const size_type    global_row,
+                          const unsigned int column) const;
+
+      /**
+       * Read and write access to the entry in global row @p global_row of
+       * column @p column.
+       */
+      Number &operator () (const size_type    global_row,
+                           const unsigned int column);
+
+      /**
+       * Return a pointer to the start of the row-major storage of the locally
+       * owned rows, followed by the ghost rows.
+       */
+      Number *begin ();
+
+      /**
+       * Constant version of begin().
+       */
+      const Number *begin () const;
+
+      /**
+       * Copy column @p column into the vector @p dst, which must have the
+       * layout of get_partitioner(). Only locally owned entries are copied.
+       */
+      void extract_column (const unsigned int column,
+                           Vector<Number>    &dst) const;
+
+      /**
+       * Copy the locally owned entries of @p src into column @p column.
+       */
+      void insert_column (const unsigned int    column,
+                          const Vector<Number> &src);
+
+      /**
+       * Column-wise scaled addition <i>this<sub>c</sub> += a<sub>c</sub>
+       * V<sub>c</sub></i> for each column @p c.
+       */
+      void add (const std::vector<Number> &a,
+                const MultiVector<Number> &V);
+
+      /**
+       * Column-wise scaling and addition <i>this<sub>c</sub> = s<sub>c</sub>
+       * this<sub>c</sub> + V<sub>c</sub></i> for each column @p c.
+       */
+      void sadd (const std::vector<Number> &s,
+                 const MultiVector<Number> &V);
+
+      /**
+       * Compute the inner product of each column of this object with the
+       * same column of @p V, i.e., <i>result<sub>c</sub> = this<sub>c</sub>
+       * &middot; V<sub>c</sub></i>. The results of all columns are combined in
+       * a single global reduction.
+       */
+      void inner_products (const MultiVector<Number> &V,
+                           std::vector<Number>       &result) const;
+
+      /**
+       * Compute the $l_2$ norm of each column, combined in a single global
+       * reduction.
+       */
+      void l2_norms (std::vector<real_type> &result) const;
+
+      /**
+       * Column-wise scaling <i>this<sub>c</sub> *= s<sub>c</sub></i>.
+       */
+      void scale (const std::vector<Number> &s);
+
+      /**
+       * Compute the inner products between all columns of this object and
+       * all columns of @p V, i.e., the matrix <i>result = this<sup>T</sup>
+       * V</i> of size n_vectors() times <code>V.n_vectors()</code>, combined
+       * in a single global reduction. This is the Gram matrix needed by
+       * block methods such as EigenLOBPCG.
+       */
+      void inner_product_matrix (const MultiVector<Number> &V,
+                                 FullMatrix<Number>        &result) const;
+
+      /**
+       * Add the linear combinations of the columns of @p V given by the
+       * columns of @p C, i.e., <i>this += V C</i>, where @p C has
+       * <code>V.n_vectors()</code> rows and n_vectors() columns.
+       */
+      void add_product (const MultiVector<Number> &V,
+                        const FullMatrix<Number>  &C);
+
+      /**
+       * Replace the columns by their linear combinations given by the columns
+       * of the square matrix @p C, i.e., <i>this = this C</i>. Since the
+       * entries of a row are contiguous, this is done in place without
+       * temporary vectors.
+       */
+      void transform (const FullMatrix<Number> &C);
+
+      /**
+       * Fill the ghost entries of all columns with a single data exchange.
+       */
+      void update_ghost_values () const;
+
+      /**
+       * Initiate the ghost exchange. See
+       * LinearAlgebra::distributed::Vector::update_ghost_values_start().
+       */
+      void update_ghost_values_start (const unsigned int communication_channel = 0) const;
+
+      /**
+       * Finish the ghost exchange started by update_ghost_values_start().
+       */
+      void update_ghost_values_finish () const;
+
+      /**
+       * Send the contributions in ghost entries of all columns to their
+       * owners with a single data exchange.
+       */
+      void compress (::dealii::VectorOperation::values operation);
+
+      /**
+       * Initiate the compress operation. See
+       * LinearAlgebra::distributed::Vector::compress_start().
+       */
+      void compress_start (const unsigned int                communication_channel = 0,
+                           ::dealii::VectorOperation::values operation = VectorOperation::add);
+
+      /**
+       * Finish the compress operation started by compress_start().
+       */
+      void compress_finish (::dealii::VectorOperation::values operation);
+
+      /**
+       * Set the ghost entries of all columns to zero.
+       */
+      void zero_out_ghosts ();
+
+      /**
+       * Return whether the ghost entries are currently valid.
+       */
+      bool has_ghost_elements () const;
+
+      /**
+       * Return the underlying vector on the expanded partitioner.
+       */
+      const Vector<Number> &get_data () const;
+
+      /**
+       * Return the memory consumption of this object in bytes.
+       */
+      std::size_t memory_consumption () const;
+
+    private:
+      /**
+       * The layout of a single column.
+       */
+      std::shared_ptr<const Utilities::MPI::Partitioner> partitioner;
+
+      /**
+       * The number of columns.
+       */
+      unsigned int n_columns;
+
+      /**
+       * The row-major data on the expanded partitioner.
+       */
+      Vector<Number> data;
+    };
+
+    /*@}*/
+
+
+    /*----------------------- Inline functions ----------------------------------*/
+
+#ifndef DOXYGEN
+
+    template <typename Number>
+    inline
+    MultiVector<Number>::MultiVector ()
+      :
+      n_columns (0)
+    {}
+
+
+
+    template <typename Number>
+    inline
+    MultiVector<Number>::MultiVector
+    (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+     const unsigned int                                         n_vectors)
+      :
+      n_columns (0)
+    {
+      reinit (partitioner, n_vectors);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::reinit
+    (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner_in,
+     const unsigned int                                         n_vectors)
+    {
+      Assert (partitioner_in.get() != nullptr, ExcNotInitialized());
+      Assert (n_vectors > 0, ExcMessage("Need at least one column"));
+
+      partitioner = partitioner_in;
+      n_columns = n_vectors;
+
+      // replace each index i of the partitioner by the range
+      // [i*n_vectors, (i+1)*n_vectors)
+      const size_type n = n_vectors;
+      IndexSet owned (partitioner->size()*n);
+      const std::pair<size_type,size_type> range = partitioner->local_range();
+      owned.add_range (range.first*n, range.second*n);
+
+      IndexSet ghosts (partitioner->size()*n);
+      const IndexSet &ghost_rows = partitioner->ghost_indices();
+      for (IndexSet::IntervalIterator it = ghost_rows.begin_intervals();
+           it != ghost_rows.end_intervals(); ++it)
+        ghosts.add_range (*it->begin()*n, (it->last()+1)*n);
+
+      std::shared_ptr<const Utilities::MPI::Partitioner> expanded
+      (new Utilities::MPI::Partitioner(owned, ghosts,
+                                       partitioner->get_mpi_communicator()));
+      data.reinit (expanded);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::reinit (const MultiVector<Number> &other,
+                                 const bool                 omit_zeroing_entries)
+    {
+      partitioner = other.partitioner;
+      n_columns = other.n_columns;
+      data.reinit (other.data, omit_zeroing_entries);
+    }
+
+
+
+    template <typename Number>
+    inline
+    MultiVector<Number> &
+    MultiVector<Number>::operator = (const Number s)
+    {
+      data = s;
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    inline
+    unsigned int
+    MultiVector<Number>::n_vectors () const
+    {
+      return n_columns;
+    }
+
+
+
+    template <typename Number>
+    inline
+    typename MultiVector<Number>::size_type
+    MultiVector<Number>::size () const
+    {
+      return partitioner.get() != nullptr ? partitioner->size() : 0;
+    }
+
+
+
+    template <typename Number>
+    inline
+    unsigned int
+    MultiVector<Number>::local_size () const
+    {
+      return partitioner.get() != nullptr ? partitioner->local_size() : 0;
+    }
+
+
+
+    template <typename Number>
+    inline
+    const std::shared_ptr<const Utilities::MPI::Partitioner> &
+    MultiVector<Number>::get_partitioner () const
+    {
+      return partitioner;
+    }
+
+
+
+    template <typename Number>
+    inline
+    Number
+    MultiVector<Number>::local_element (const size_type    local_row,
+                                        const unsigned int column) const
+    {
+      AssertIndexRange (column, n_columns);
+      return data.local_element (local_row*n_columns+column);
+    }
+
+
+
+    template <typename Number>
+    inline
+    Number &
+    MultiVector<Number>::local_element (const size_type    local_row,
+                                        const unsigned int column)
+    {
+      AssertIndexRange (column, n_columns);
+      return data.local_element (local_row*n_columns+column);
+    }
+
+
+
+    template <typename Number>
+    inline
+    Number
+    MultiVector<Number>::operator () (const size_type    global_row,
+                                      const unsigned int column) const
+    {
+      AssertIndexRange (column, n_columns);
+      return data (global_row*n_columns+column);
+    }
+
+
+
+    template <typename Number>
+    inline
+    Number &
+    MultiVector<Number>::operator () (const size_type    global_row,
+                                      const unsigned int column)
+    {
+      AssertIndexRange (column, n_columns);
+      return data (global_row*n_columns+column);
+    }
+
+
+
+    template <typename Number>
+    inline
+    Number *
+    MultiVector<Number>::begin ()
+    {
+      return data.begin();
+    }
+
+
+
+    template <typename Number>
+    inline
+    const Number *
+    MultiVector<Number>::begin () const
+    {
+      return data.begin();
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::extract_column (const unsigned int column,
+                                         Vector<Number>    &dst) const
+    {
+      AssertIndexRange (column, n_columns);
+      AssertDimension (dst.local_size(), local_size());
+      const Number *src = data.begin();
+      for (unsigned int i=0; i<dst.local_size(); ++i)
+        dst.local_element(i) = src[i*n_columns+column];
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::insert_column (const unsigned int    column,
+                                        const Vector<Number> &src)
+    {
+      AssertIndexRange (column, n_columns);
+      AssertDimension (src.local_size(), local_size());
+      Number *dst = data.begin();
+      for (unsigned int i=0; i<src.local_size(); ++i)
+        dst[i*n_columns+column] = src.local_element(i);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::add (const std::vector<Number> &a,
+                              const MultiVector<Number> &V)
+    {
+      AssertDimension (a.size(), n_columns);
+      AssertDimension (V.n_columns, n_columns);
+      AssertDimension (V.local_size(), local_size());
+      Number *dst = data.begin();
+      const Number *src = V.data.begin();
+      const unsigned int n_rows = local_size();
+      for (unsigned int i=0; i<n_rows; ++i, dst+=n_columns, src+=n_columns)
+        for (unsigned int c=0; c<n_columns; ++c)
+          dst[c] += a[c] * src[c];
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::sadd (const std::vector<Number> &s,
+                               const MultiVector<Number> &V)
+    {
+      AssertDimension (s.size(), n_columns);
+      AssertDimension (V.n_columns, n_columns);
+      AssertDimension (V.local_size(), local_size());
+      Number *dst = data.begin();
+      const Number *src = V.data.begin();
+      const unsigned int n_rows = local_size();
+      for (unsigned int i=0; i<n_rows; ++i, dst+=n_columns, src+=n_columns)
+        for (unsigned int c=0; c<n_columns; ++c)
+          dst[c] = s[c] * dst[c] + src[c];
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::inner_products (const MultiVector<Number> &V,
+                                         std::vector<Number>       &result) const
+    {
+      AssertDimension (V.n_columns, n_columns);
+      AssertDimension (V.local_size(), local_size());
+      std::vector<Number> local_sums (n_columns, Number());
+      const Number *x = data.begin();
+      const Number *y = V.data.begin();
+      const unsigned int n_rows = local_size();
+      for (unsigned int i=0; i<n_rows; ++i, x+=n_columns, y+=n_columns)
+        for (unsigned int c=0; c<n_columns; ++c)
+          local_sums[c] += x[c] * numbers::NumberTraits<Number>::conjugate(y[c]);
+
+      result.resize (n_columns);
+      Utilities::MPI::sum (local_sums, partitioner->get_mpi_communicator(),
+                           result);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::l2_norms (std::vector<real_type> &result) const
+    {
+      std::vector<real_type> local_sums (n_columns, real_type());
+      const Number *x = data.begin();
+      const unsigned int n_rows = local_size();
+      for (unsigned int i=0; i<n_rows; ++i, x+=n_columns)
+        for (unsigned int c=0; c<n_columns; ++c)
+          local_sums[c] += numbers::NumberTraits<Number>::abs_square(x[c]);
+
+      result.resize (n_columns);
+      Utilities::MPI::sum (local_sums, partitioner->get_mpi_communicator(),
+                           result);
+      for (unsigned int c=0; c<n_columns; ++c)
+        result[c] = std::sqrt(result[c]);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::scale (const std::vector<Number> &s)
+    {
+      AssertDimension (s.size(), n_columns);
+      Number *dst = data.begin();
+      const unsigned int n_rows = local_size();
+      for (unsigned int i=0; i<n_rows; ++i, dst+=n_columns)
+        for (unsigned int c=0; c<n_columns; ++c)
+          dst[c] *= s[c];
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::inner_product_matrix (const MultiVector<Number> &V,
+                                               FullMatrix<Number>        &result) const
+    {
+      AssertDimension (V.local_size(), local_size());
+      const unsigned int n_columns_V = V.n_columns;
+      std::vector<Number> local_sums (n_columns*n_columns_V, Number());
+      const Number *x = data.begin();
+      const Number *y = V.data.begin();
+      const unsigned int n_rows = local_size();
+      for (unsigned int i=0; i<n_rows; ++i, x+=n_columns, y+=n_columns_V)
+        for (unsigned int c=0; c<n_columns; ++c)
+          {
+            Number *sums = &local_sums[c*n_columns_V];
+            for (unsigned int d=0; d<n_columns_V; ++d)
+              sums[d] += x[c] * numbers::NumberTraits<Number>::conjugate(y[d]);
+          }
+
+      std::vector<Number> global_sums (local_sums.size());
+      Utilities::MPI::sum (local_sums, partitioner->get_mpi_communicator(),
+                           global_sums);
+      result.reinit (n_columns, n_columns_V);
+      for (unsigned int c=0; c<n_columns; ++c)
+        for (unsigned int d=0; d<n_columns_V; ++d)
+          result(c,d) = global_sums[c*n_columns_V+d];
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::add_product (const MultiVector<Number> &V,
+                                      const FullMatrix<Number>  &C)
+    {
+      AssertDimension (V.local_size(), local_size());
+      AssertDimension (C.m(), V.n_columns);
+      AssertDimension (C.n(), n_columns);
+      const unsigned int n_columns_V = V.n_columns;
+      Number *dst = data.begin();
+      const Number *src = V.data.begin();
+      const unsigned int n_rows = local_size();
+      for (unsigned int i=0; i<n_rows; ++i, dst+=n_columns, src+=n_columns_V)
+        for (unsigned int d=0; d<n_columns_V; ++d)
+          for (unsigned int c=0; c<n_columns; ++c)
+            dst[c] += src[d] * C(d,c);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::transform (const FullMatrix<Number> &C)
+    {
+      AssertDimension (C.m(), n_columns);
+      AssertDimension (C.n(), n_columns);
+      std::vector<Number> row (n_columns);
+      Number *dst = data.begin();
+      const unsigned int n_rows = local_size();
+      for (unsigned int i=0; i<n_rows; ++i, dst+=n_columns)
+        {
+          std::copy (dst, dst+n_columns, row.begin());
+          for (unsigned int c=0; c<n_columns; ++c)
+            {
+              Number sum = Number();
+              for (unsigned int d=0; d<n_columns; ++d)
+                sum += row[d] * C(d,c);
+              dst[c] = sum;
+            }
+        }
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::update_ghost_values () const
+    {
+      data.update_ghost_values();
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::update_ghost_values_start
+    (const unsigned int communication_channel) const
+    {
+      data.update_ghost_values_start (communication_channel);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::update_ghost_values_finish () const
+    {
+      data.update_ghost_values_finish();
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::compress (::dealii::VectorOperation::values operation)
+    {
+      data.compress (operation);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::compress_start
+    (const unsigned int                communication_channel,
+     ::dealii::VectorOperation::values operation)
+    {
+      data.compress_start (communication_channel, operation);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::compress_finish (::dealii::VectorOperation::values operation)
+    {
+      data.compress_finish (operation);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    MultiVector<Number>::zero_out_ghosts ()
+    {
+      data.zero_out_ghosts();
+    }
+
+
+
+    template <typename Number>
+    inline
+    bool
+    MultiVector<Number>::has_ghost_elements () const
+    {
+      return data.has_ghost_elements();
+    }
+
+
+
+    template <typename Number>
+    inline
+    const Vector<Number> &
+    MultiVector<Number>::get_data () const
+    {
+      return data;
+    }
+
+
+
+    template <typename Number>
+    inline
+    std::size_t
+    MultiVector<Number>::memory_consumption () const
+    {
+      return sizeof(*this) + data.memory_consumption();
+    }
+
+#endif // DOXYGEN
+
+  } // end of namespace distributed
+
+} // end of namespace LinearAlgebra
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
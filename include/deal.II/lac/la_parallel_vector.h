@@ -17,6 +17,7 @@
 #define dealii_la_parallel_vector_h
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/memory_report.h>
 #include <deal.II/base/mpi.h>
 #include <deal.II/base/numbers.h>
 #include <deal.II/base/partitioner.h>
@@ -26,6 +27,7 @@
 #include <deal.II/lac/vector_type_traits.h>
 
 #include <iomanip>
+#include <type_traits>
 #include <memory>
 
 DEAL_II_NAMESPACE_OPEN
@@ -302,6 +304,34 @@ namespace LinearAlgebra
        */
       void reinit (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner);
 
+#ifdef DEAL_II_WITH_MPI
+      /**
+       * Same as above, but allocate the memory of the vector in a shared
+       * memory window of the processes given by @p communicator_sm, which
+       * must be processes that share the memory of a compute node, typically
+       * obtained by <code>MPI_Comm_split_type</code> with
+       * <code>MPI_COMM_TYPE_SHARED</code> from the communicator of the
+       * partitioner. With many processes per node, most ghost entries are
+       * typically owned by processes of the same node. In
+       * update_ghost_values() and compress(), these entries are then read
+       * directly from the memory of the other process instead of being sent
+       * as MPI messages, and only the ghost entries of processes on other
+       * nodes are exchanged with messages, see
+       * Utilities::MPI::SharedMemoryExchange. The arrays of the other
+       * processes can be accessed by shared_vector_data().
+       *
+       * This function is collective on the communicator of the partitioner.
+       * For vectors using shared memory, also the reinit() functions and
+       * the destructor are collective on @p communicator_sm, because the
+       * shared memory window is allocated and released by all processes on
+       * the node together. The same applies to the initialization from a
+       * vector using shared memory by reinit(const Vector<Number2> &, const
+       * bool) or the copy constructor, which creates a new window.
+       */
+      void reinit (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+                   const MPI_Comm                                            communicator_sm);
+#endif
+
       /**
        * Swap the contents of this vector and the other vector @p v. One could
        * do this operation with a temporary variable and copying over the data
@@ -514,6 +544,39 @@ namespace LinearAlgebra
        */
       bool has_ghost_elements() const;
 
+      /**
+       * Select whether update_ghost_values() and compress() exchange the
+       * ghost entries with other processes in reduced precision. For vectors
+       * with <tt>Number=double</tt>, the values are then rounded to @p float
+       * when they are packed for the MPI messages and converted back to @p
+       * double when they are unpacked, which halves the volume of the
+       * communication. This is sufficient for operations that only need an
+       * approximate result, like the application of a smoother or the
+       * coarse levels in a multigrid method, but gives ghost entries and
+       * sums over processes with an accuracy of only about $10^{-7}$
+       * relative to the values. The locally owned entries and all operations
+       * on them are not affected. For other types of @p Number, this setting
+       * has no effect.
+       *
+       * The setting is kept by the reinit() functions and copied to vectors
+       * initialized by reinit(const Vector<Number2> &, const bool) from this
+       * vector, so that temporary vectors created with the layout of this
+       * vector, e.g. within a solver or smoother, use the same
+       * precision. Ghost entries that are filled from the memory of other
+       * processes on the same node in case the vector uses shared memory are
+       * always read in full precision. Do not change the setting while a
+       * communication of this vector is in progress.
+       *
+       * By default, the ghost entries are exchanged in full precision.
+       */
+      void set_reduced_precision_ghost_exchange (const bool reduced_precision = true);
+
+      /**
+       * Return whether the ghost entries are exchanged in reduced precision
+       * as specified by set_reduced_precision_ghost_exchange().
+       */
+      bool uses_reduced_precision_ghost_exchange () const;
+
       /**
        * This method copies the data in the locally owned range from another
        * distributed vector @p src into the calling vector. As opposed to
@@ -663,6 +726,41 @@ namespace LinearAlgebra
                                  const VectorSpaceVector<Number> &V,
                                  const VectorSpaceVector<Number> &W) override;
 
+      /**
+       * Perform a combined operation of two vector additions and a subsequent
+       * computation of the squared norm of the calling vector. In other
+       * words, the result of this function is the same as if the user called
+       * @code
+       * X.add(a, W);
+       * this->add(a, V);
+       * return_value = this->norm_sqr();
+       * @endcode
+       *
+       * This is the update of the solution and the residual vector in the
+       * conjugate gradient method, see SolverCG. The combined operation loads
+       * the four vectors @p this, @p V, @p X, @p W once and writes @p this and
+       * @p X, whereas the separate operations load @p this twice, reducing
+       * the memory transfer by one sixth. The vector @p X must be different
+       * from @p this and @p V.
+       */
+      real_type add_and_norm_sqr (const Number          a,
+                                  const Vector<Number> &V,
+                                  Vector<Number>       &X,
+                                  const Vector<Number> &W);
+
+      /**
+       * Compute the inner products of this vector with all the vectors in @p
+       * V, i.e., <code>results[i] = *this * (*V[i])</code>, and return them
+       * in @p results, which is resized to the length of @p V. The local
+       * contributions of all inner products are combined in a single global
+       * reduction, as opposed to one reduction per inner product when
+       * calling operator* repeatedly. This is the core operation of the
+       * classical Gram-Schmidt orthogonalization in SolverGMRES. The list @p
+       * V may contain @p this, which gives the squared norm of the vector.
+       */
+      void inner_products (const std::vector<const Vector<Number> *> &V,
+                           std::vector<Number>                       &results) const;
+
       /**
        * Return the global size of the vector, equal to the sum of the number of
        * locally owned indices among all processors.
@@ -694,6 +792,15 @@ namespace LinearAlgebra
        * Return the memory consumption of this class in bytes.
        */
       virtual std::size_t memory_consumption() const override;
+
+      /**
+       * Return a breakdown of the memory consumption returned by
+       * memory_consumption() into the locally owned values, the ghost
+       * values, the buffer for the import data, and the partitioner. As in
+       * memory_consumption(), only a fraction of the memory of a
+       * partitioner shared between several vectors is accounted for.
+       */
+      MemoryReport memory_report() const;
       //@}
 
       /**
@@ -982,6 +1089,20 @@ namespace LinearAlgebra
       const std::shared_ptr<const Utilities::MPI::Partitioner> &
       get_partitioner () const;
 
+#ifdef DEAL_II_WITH_MPI
+      /**
+       * For a vector allocated in shared memory by reinit() with a shared
+       * memory communicator, return the arrays of locally owned and ghost
+       * entries of all processes on the node, in the order of the ranks in the
+       * shared memory communicator. The entries of the other processes may be
+       * read in place, e.g. by a matrix-vector product, as long as the
+       * processes are suitably synchronized. For other vectors, an empty
+       * vector is returned.
+       */
+      const std::vector<ArrayView<const Number> > &
+      shared_vector_data () const;
+#endif
+
       /**
        * Check whether the given partitioner is compatible with the
        * partitioner used for this vector. Two partitioners are compatible if
@@ -1087,6 +1208,14 @@ namespace LinearAlgebra
                                 const Vector<Number> &V,
                                 const Vector<Number> &W);
 
+      /**
+       * Local part of add_and_norm_sqr().
+       */
+      real_type add_and_norm_sqr_local (const Number          a,
+                                        const Vector<Number> &V,
+                                        Vector<Number>       &X,
+                                        const Vector<Number> &W);
+
       /**
        * Shared pointer to store the parallel partitioning information. This
        * information can be shared between several vectors that have the same
@@ -1121,6 +1250,21 @@ namespace LinearAlgebra
        */
       mutable std::unique_ptr<Number[]> import_data;
 
+      /**
+       * The type in which the ghost entries are sent in case the exchange in
+       * reduced precision is selected, i.e., @p float for @p double vectors
+       * and @p Number otherwise.
+       */
+      typedef typename std::conditional<std::is_same<Number,double>::value,
+              float, Number>::type reduced_precision_type;
+
+      /**
+       * Temporary storage for the exchange in reduced precision, holding the
+       * packed data sent to or from this processor followed by the ghost
+       * entries.
+       */
+      mutable std::unique_ptr<reduced_precision_type[]> reduced_precision_data;
+
       /**
        * Stores whether the vector currently allows for reading ghost elements
        * or not. Note that this is to ensure consistent ghost data and does
@@ -1130,22 +1274,61 @@ namespace LinearAlgebra
        */
       mutable bool vector_is_ghosted;
 
+      /**
+       * Stores whether the ghost entries are exchanged in reduced precision,
+       * see set_reduced_precision_ghost_exchange().
+       */
+      bool reduced_precision_ghost_exchange;
+
 #ifdef DEAL_II_WITH_MPI
       /**
-       * A vector that collects all requests from @p compress() operations.
-       * This class uses persistent MPI communicators, i.e., the communication
-       * channels are stored during successive calls to a given function. This
-       * reduces the overhead involved with setting up the MPI machinery, but
-       * it does not remove the need for a receive operation to be posted
-       * before the data can actually be sent.
+       * A vector that collects all requests from @p compress() operations
+       * while they are ongoing. This class uses persistent MPI
+       * communicators, i.e., the communication channels are stored during
+       * successive calls to a given function in
+       * compress_persistent_requests. This reduces the overhead involved with
+       * setting up the MPI machinery, but it does not remove the need for a
+       * receive operation to be posted before the data can actually be sent.
        */
       std::vector<MPI_Request>   compress_requests;
 
+      /**
+       * The persistent MPI requests of @p compress(), bound to the data
+       * arrays of this vector and set up again whenever these change.
+       */
+      Utilities::MPI::PersistentRequests compress_persistent_requests;
+
       /**
        * A vector that collects all requests from @p update_ghost_values()
-       * operations. This class uses persistent MPI communicators.
+       * operations while they are ongoing. This class uses persistent MPI
+       * communicators.
        */
       mutable std::vector<MPI_Request>   update_ghost_values_requests;
+
+      /**
+       * The persistent MPI requests of @p update_ghost_values(), bound to the
+       * data arrays of this vector and set up again whenever these change.
+       */
+      mutable Utilities::MPI::PersistentRequests update_ghost_values_persistent_requests;
+
+      /**
+       * For vectors allocated in shared memory, the object describing the
+       * split of the data exchange into the part within the node and the
+       * part with other nodes, and a null pointer otherwise.
+       */
+      std::shared_ptr<const Utilities::MPI::SharedMemoryExchange> shared_memory_exchange;
+
+      /**
+       * The shared memory window holding the entries of this vector, which
+       * is released when the last copy of the pointer goes away.
+       */
+      std::shared_ptr<MPI_Win> shared_memory_window;
+
+      /**
+       * The arrays of all processes on the node in the shared memory
+       * window.
+       */
+      std::vector<ArrayView<const Number> > shared_values;
 #endif
 
       /**
@@ -1166,6 +1349,29 @@ namespace LinearAlgebra
        */
       void resize_val (const size_type new_allocated_size);
 
+#ifdef DEAL_II_WITH_MPI
+      /**
+       * A helper function that allocates the val array in a shared memory
+       * window described by @p exchange.
+       */
+      void allocate_shared_memory
+      (const std::shared_ptr<const Utilities::MPI::SharedMemoryExchange> &exchange);
+
+      /**
+       * A helper function that makes the changes to the shared memory
+       * window of all processes on the node visible to each other.
+       */
+      void synchronize_shared_memory () const;
+
+      /**
+       * A helper function that allocates the buffer for the exchange of the
+       * ghost entries in reduced precision with @p exchange_partitioner in
+       * case it is not set up yet.
+       */
+      void allocate_reduced_precision_data
+      (const Utilities::MPI::Partitioner &exchange_partitioner) const;
+#endif
+
       /*
        * Make all other vector types friends.
        */
@@ -1194,6 +1400,27 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number>
+    inline
+    void
+    Vector<Number>::set_reduced_precision_ghost_exchange (const bool reduced_precision)
+    {
+      reduced_precision_ghost_exchange = reduced_precision;
+    }
+
+
+
+    template <typename Number>
+    inline
+    bool
+    Vector<Number>::uses_reduced_precision_ghost_exchange () const
+    {
+      return reduced_precision_ghost_exchange &&
+             !std::is_same<reduced_precision_type,Number>::value;
+    }
+
+
+
     template <typename Number>
     inline
     typename Vector<Number>::size_type
@@ -1494,6 +1721,18 @@ namespace LinearAlgebra
       return partitioner;
     }
 
+
+
+#ifdef DEAL_II_WITH_MPI
+    template <typename Number>
+    inline
+    const std::vector<ArrayView<const Number> > &
+    Vector<Number>::shared_vector_data () const
+    {
+      return shared_values;
+    }
+#endif
+
 #endif
 
   }
@@ -1528,6 +1767,16 @@ struct is_serial_vector< LinearAlgebra::distributed::Vector< Number > > : std::f
 };
 
 
+/**
+ * Declare that dealii::LinearAlgebra::distributed::Vector< Number > provides
+ * the fused vector operation add_and_norm_sqr() used by SolverCG.
+ */
+template <typename Number>
+struct has_fused_cg_update< LinearAlgebra::distributed::Vector< Number > > : std::true_type
+{
+};
+
+
 namespace internal
 {
   namespace LinearOperator
@@ -18,6 +18,7 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/mpi_progress.h>
 #include <deal.II/lac/exceptions.h>
 #include <deal.II/lac/la_parallel_vector.h>
 #include <deal.II/lac/vector_operations_internal.h>
@@ -39,18 +40,15 @@ namespace LinearAlgebra
     Vector<Number>::clear_mpi_requests ()
     {
 #ifdef DEAL_II_WITH_MPI
-      for (size_type j=0; j<compress_requests.size(); j++)
-        {
-          const int ierr = MPI_Request_free(&compress_requests[j]);
-          AssertThrowMPI(ierr);
-        }
+      Utilities::MPI::ProgressEngine::remove_requests (compress_requests);
+      Utilities::MPI::ProgressEngine::remove_requests (update_ghost_values_requests);
+
+      // the active requests are copies of the persistent ones, which are
+      // freed (and completed by MPI if still ongoing) together
       compress_requests.clear();
-      for (size_type j=0; j<update_ghost_values_requests.size(); j++)
-        {
-          const int ierr = MPI_Request_free(&update_ghost_values_requests[j]);
-          AssertThrowMPI(ierr);
-        }
+      compress_persistent_requests.clear();
       update_ghost_values_requests.clear();
+      update_ghost_values_persistent_requests.clear();
 #endif
     }
 
@@ -60,6 +58,18 @@ namespace LinearAlgebra
     void
     Vector<Number>::resize_val (const size_type new_alloc_size)
     {
+#ifdef DEAL_II_WITH_MPI
+      // release the shared memory window of a previous initialization
+      if (shared_memory_window != nullptr)
+        {
+          values = std::unique_ptr<Number[], decltype(&free)>(nullptr, &free);
+          allocated_size = 0;
+          shared_values.clear();
+          shared_memory_window.reset();
+          shared_memory_exchange.reset();
+        }
+#endif
+
       if (new_alloc_size > allocated_size)
         {
           Assert (((allocated_size > 0 && values != nullptr) ||
@@ -81,6 +91,90 @@ namespace LinearAlgebra
 
 
 
+#ifdef DEAL_II_WITH_MPI
+    template <typename Number>
+    void
+    Vector<Number>::allocate_shared_memory
+    (const std::shared_ptr<const Utilities::MPI::SharedMemoryExchange> &exchange)
+    {
+      resize_val (0);
+
+      const MPI_Comm &communicator_sm = exchange->get_shared_memory_communicator();
+      const size_type new_allocated_size = partitioner->local_size() +
+                                           partitioner->n_ghost_indices();
+      Number *new_values = nullptr;
+      MPI_Win window;
+      int ierr = MPI_Win_allocate_shared (new_allocated_size*sizeof(Number),
+                                          sizeof(Number), MPI_INFO_NULL,
+                                          communicator_sm, &new_values, &window);
+      AssertThrowMPI(ierr);
+
+      // keep the window in a passive target epoch for its whole lifetime,
+      // so that we only need MPI_Win_sync and a barrier to synchronize
+      ierr = MPI_Win_lock_all (MPI_MODE_NOCHECK, window);
+      AssertThrowMPI(ierr);
+      shared_memory_window.reset (new MPI_Win(window), [](MPI_Win *window)
+      {
+        int ierr = MPI_Win_unlock_all (*window);
+        AssertNothrow (ierr == MPI_SUCCESS, ExcInternalError());
+        ierr = MPI_Win_free (window);
+        AssertNothrow (ierr == MPI_SUCCESS, ExcInternalError());
+        (void)ierr;
+        delete window;
+      });
+
+      // the memory belongs to the window, so the deleter must not free it
+      values = std::unique_ptr<Number[], decltype(&free)>(new_values, [](void *) noexcept {});
+      allocated_size = new_allocated_size;
+
+      const unsigned int n_procs_sm = Utilities::MPI::n_mpi_processes(communicator_sm);
+      shared_values.clear ();
+      shared_values.reserve (n_procs_sm);
+      for (unsigned int p=0; p<n_procs_sm; ++p)
+        {
+          MPI_Aint size;
+          int disp_unit;
+          Number *data;
+          ierr = MPI_Win_shared_query (window, p, &size, &disp_unit, &data);
+          AssertThrowMPI(ierr);
+          shared_values.emplace_back (data, size/sizeof(Number));
+        }
+
+      shared_memory_exchange = exchange;
+    }
+
+
+
+    template <typename Number>
+    void
+    Vector<Number>::synchronize_shared_memory () const
+    {
+      int ierr = MPI_Win_sync (*shared_memory_window);
+      AssertThrowMPI(ierr);
+      ierr = MPI_Barrier (shared_memory_exchange->get_shared_memory_communicator());
+      AssertThrowMPI(ierr);
+      ierr = MPI_Win_sync (*shared_memory_window);
+      AssertThrowMPI(ierr);
+    }
+
+
+
+    template <typename Number>
+    void
+    Vector<Number>::allocate_reduced_precision_data
+    (const Utilities::MPI::Partitioner &exchange_partitioner) const
+    {
+      // zero the ghost part, as not all of its entries are necessarily
+      // received in case some ghosts are read from shared memory
+      if (reduced_precision_data == nullptr)
+        reduced_precision_data.reset
+        (new reduced_precision_type[exchange_partitioner.n_import_indices()+
+                                    partitioner->n_ghost_indices()]());
+    }
+#endif
+
+
+
     template <typename Number>
     void
     Vector<Number>::reinit (const size_type size,
@@ -93,6 +187,7 @@ namespace LinearAlgebra
 
       // delete previous content in import data
       import_data.reset ();
+      reduced_precision_data.reset ();
 
       // set partitioner to serial version
       partitioner.reset (new Utilities::MPI::Partitioner (size));
@@ -119,7 +214,21 @@ namespace LinearAlgebra
       // different (check only if the are allocated
       // differently, not if the actual data is
       // different)
+#ifdef DEAL_II_WITH_MPI
+      if (v.shared_memory_exchange != nullptr)
+        {
+          // a vector with shared memory needs its own window
+          if (shared_memory_exchange != v.shared_memory_exchange)
+            {
+              partitioner = v.partitioner;
+              allocate_shared_memory (v.shared_memory_exchange);
+            }
+        }
+      else if (partitioner.get() != v.partitioner.get() ||
+               shared_memory_exchange != nullptr)
+#else
       if (partitioner.get() != v.partitioner.get())
+#endif
         {
           partitioner = v.partitioner;
           const size_type new_allocated_size = partitioner->local_size() +
@@ -137,6 +246,9 @@ namespace LinearAlgebra
       // update_ghost_values, and we might have vectors where we never
       // call these methods and hence do not need to have the storage.
       import_data.reset ();
+      reduced_precision_data.reset ();
+
+      reduced_precision_ghost_exchange = v.reduced_precision_ghost_exchange;
 
       thread_loop_partitioner = v.thread_loop_partitioner;
     }
@@ -193,9 +305,35 @@ namespace LinearAlgebra
       // update_ghost_values, and we might have vectors where we never
       // call these methods and hence do not need to have the storage.
       import_data.reset ();
+      reduced_precision_data.reset ();
+
+      vector_is_ghosted = false;
+    }
+
+
+
+#ifdef DEAL_II_WITH_MPI
+    template <typename Number>
+    void
+    Vector<Number>::reinit (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner_in,
+                            const MPI_Comm                                            communicator_sm)
+    {
+      clear_mpi_requests();
+      partitioner = partitioner_in;
+
+      allocate_shared_memory
+      (std::make_shared<const Utilities::MPI::SharedMemoryExchange>(partitioner,
+           communicator_sm));
+
+      // initialize to zero
+      this->operator= (Number());
+
+      import_data.reset ();
+      reduced_precision_data.reset ();
 
       vector_is_ghosted = false;
     }
+#endif
 
 
 
@@ -204,7 +342,8 @@ namespace LinearAlgebra
       :
       partitioner (new Utilities::MPI::Partitioner()),
       allocated_size (0),
-      values (nullptr, &free)
+      values (nullptr, &free),
+      reduced_precision_ghost_exchange (false)
     {
       reinit(0);
     }
@@ -217,7 +356,8 @@ namespace LinearAlgebra
       Subscriptor(),
       allocated_size (0),
       values (nullptr, &free),
-      vector_is_ghosted (false)
+      vector_is_ghosted (false),
+      reduced_precision_ghost_exchange (false)
     {
       reinit (v, true);
 
@@ -241,7 +381,8 @@ namespace LinearAlgebra
       :
       allocated_size (0),
       values (nullptr, &free),
-      vector_is_ghosted (false)
+      vector_is_ghosted (false),
+      reduced_precision_ghost_exchange (false)
     {
       reinit (local_range, ghost_indices, communicator);
     }
@@ -254,7 +395,8 @@ namespace LinearAlgebra
       :
       allocated_size (0),
       values (nullptr, &free),
-      vector_is_ghosted (false)
+      vector_is_ghosted (false),
+      reduced_precision_ghost_exchange (false)
     {
       reinit (local_range, communicator);
     }
@@ -266,7 +408,8 @@ namespace LinearAlgebra
       :
       allocated_size (0),
       values (nullptr, &free),
-      vector_is_ghosted (false)
+      vector_is_ghosted (false),
+      reduced_precision_ghost_exchange (false)
     {
       reinit (size, false);
     }
@@ -279,7 +422,8 @@ namespace LinearAlgebra
       :
       allocated_size (0),
       values (nullptr, &free),
-      vector_is_ghosted (false)
+      vector_is_ghosted (false),
+      reduced_precision_ghost_exchange (false)
     {
       reinit (partitioner);
     }
@@ -533,15 +677,55 @@ namespace LinearAlgebra
       // make this function thread safe
       Threads::Mutex::ScopedLock lock (mutex);
 
+      // for vectors in shared memory, add the ghost entries of the other
+      // processes on the node directly from their memory. the barrier
+      // before makes sure that they have finished writing into their ghost
+      // entries and the one after that they do not change them (e.g. when
+      // exchanging the data with other nodes) before we have read them
+      const Utilities::MPI::Partitioner &exchange_partitioner =
+        shared_memory_exchange != nullptr ?
+        shared_memory_exchange->get_remote_partitioner() : *partitioner;
+      if (shared_memory_exchange != nullptr &&
+          operation != ::dealii::VectorOperation::insert)
+        {
+          synchronize_shared_memory();
+          shared_memory_exchange->import_from_ghosted_array_shared
+          (shared_values, ArrayView<Number>(values.get(), partitioner->local_size()));
+          synchronize_shared_memory();
+        }
+
+      // in reduced precision, round the ghost entries into the second part
+      // of the buffer and clear them right away, as the partitioner only
+      // clears the buffer
+      if (uses_reduced_precision_ghost_exchange())
+        {
+          allocate_reduced_precision_data (exchange_partitioner);
+          reduced_precision_type *ghost_buffer = reduced_precision_data.get() +
+                                                 exchange_partitioner.n_import_indices();
+          std::copy (values.get() + partitioner->local_size(),
+                     values.get() + partitioner->local_size() + partitioner->n_ghost_indices(),
+                     ghost_buffer);
+          std::fill_n (values.get() + partitioner->local_size(),
+                       partitioner->n_ghost_indices(), Number());
+
+          exchange_partitioner.import_from_ghosted_array_start
+          (operation, counter,
+           ArrayView<reduced_precision_type>(ghost_buffer, partitioner->n_ghost_indices()),
+           ArrayView<reduced_precision_type>(reduced_precision_data.get(),
+                                             exchange_partitioner.n_import_indices()),
+           compress_requests);
+          return;
+        }
+
       // allocate import_data in case it is not set up yet
-      if (import_data == nullptr && partitioner->n_import_indices() > 0)
-        import_data.reset (new Number[partitioner->n_import_indices()]);
+      if (import_data == nullptr && exchange_partitioner.n_import_indices() > 0)
+        import_data.reset (new Number[exchange_partitioner.n_import_indices()]);
 
-      partitioner->import_from_ghosted_array_start
+      exchange_partitioner.import_from_ghosted_array_start
       (operation, counter,
        ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
-       ArrayView<Number>(import_data.get(), partitioner->n_import_indices()),
-       compress_requests);
+       ArrayView<Number>(import_data.get(), exchange_partitioner.n_import_indices()),
+       compress_requests, compress_persistent_requests);
 #endif
     }
 
@@ -554,21 +738,45 @@ namespace LinearAlgebra
 #ifdef DEAL_II_WITH_MPI
       vector_is_ghosted = false;
 
-      if (compress_requests.size() == 0)
-        return;
+      if (compress_requests.size() > 0)
+        {
+          // make this function thread safe
+          Threads::Mutex::ScopedLock lock (mutex);
 
-      // make this function thread safe
-      Threads::Mutex::ScopedLock lock (mutex);
+          const Utilities::MPI::Partitioner &exchange_partitioner =
+            shared_memory_exchange != nullptr ?
+            shared_memory_exchange->get_remote_partitioner() : *partitioner;
+          if (uses_reduced_precision_ghost_exchange())
+            {
+              Assert(reduced_precision_data != nullptr, ExcNotInitialized());
+              exchange_partitioner.import_from_ghosted_array_finish
+              (operation,
+               ArrayView<const reduced_precision_type>(reduced_precision_data.get(),
+                                                       exchange_partitioner.n_import_indices()),
+               ArrayView<Number>(values.get(), partitioner->local_size()),
+               ArrayView<reduced_precision_type>(reduced_precision_data.get() +
+                                                 exchange_partitioner.n_import_indices(),
+                                                 partitioner->n_ghost_indices()),
+               compress_requests);
+            }
+          else
+            {
+              Assert(exchange_partitioner.n_import_indices() == 0 ||
+                     import_data != nullptr,
+                     ExcNotInitialized());
+              exchange_partitioner.import_from_ghosted_array_finish
+              (operation,
+               ArrayView<const Number>(import_data.get(), exchange_partitioner.n_import_indices()),
+               ArrayView<Number>(values.get(), partitioner->local_size()),
+               ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
+               compress_requests);
+            }
+        }
 
-      Assert(partitioner->n_import_indices() == 0 ||
-             import_data != nullptr,
-             ExcNotInitialized());
-      partitioner->import_from_ghosted_array_finish
-      (operation,
-       ArrayView<const Number>(import_data.get(), partitioner->n_import_indices()),
-       ArrayView<Number>(values.get(), partitioner->local_size()),
-       ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
-       compress_requests);
+      // the remote partitioner only clears the ghost entries it has sent, so
+      // clear the ones read by the other processes on the node, too
+      if (shared_memory_exchange != nullptr)
+        zero_out_ghosts();
 #else
       (void)operation;
 #endif
@@ -581,23 +789,54 @@ namespace LinearAlgebra
     Vector<Number>::update_ghost_values_start (const unsigned int counter) const
     {
 #ifdef DEAL_II_WITH_MPI
-      // nothing to do when we neither have import nor ghost indices.
-      if (partitioner->n_ghost_indices()==0 && partitioner->n_import_indices()==0)
+      // nothing to do when we neither have import nor ghost indices. vectors
+      // in shared memory must always take part in the synchronization of the
+      // node, though
+      if (partitioner->n_ghost_indices()==0 && partitioner->n_import_indices()==0 &&
+          shared_memory_exchange == nullptr)
         return;
 
       // make this function thread safe
       Threads::Mutex::ScopedLock lock (mutex);
 
+      // for vectors in shared memory, the ghost entries owned by other
+      // processes on the node are read from their memory in
+      // update_ghost_values_finish(). make sure that the other processes
+      // have finished writing into their locally owned entries
+      const Utilities::MPI::Partitioner &exchange_partitioner =
+        shared_memory_exchange != nullptr ?
+        shared_memory_exchange->get_remote_partitioner() : *partitioner;
+      if (shared_memory_exchange != nullptr)
+        synchronize_shared_memory();
+
+      // in reduced precision, receive the ghost entries into the second
+      // part of the buffer, from where they are converted in
+      // update_ghost_values_finish()
+      if (uses_reduced_precision_ghost_exchange())
+        {
+          allocate_reduced_precision_data (exchange_partitioner);
+          exchange_partitioner.export_to_ghosted_array_start
+          (counter,
+           ArrayView<const Number>(values.get(), partitioner->local_size()),
+           ArrayView<reduced_precision_type>(reduced_precision_data.get(),
+                                             exchange_partitioner.n_import_indices()),
+           ArrayView<reduced_precision_type>(reduced_precision_data.get() +
+                                             exchange_partitioner.n_import_indices(),
+                                             partitioner->n_ghost_indices()),
+           update_ghost_values_requests);
+          return;
+        }
+
       // allocate import_data in case it is not set up yet
-      if (import_data == nullptr && partitioner->n_import_indices() > 0)
-        import_data.reset (new Number[partitioner->n_import_indices()]);
+      if (import_data == nullptr && exchange_partitioner.n_import_indices() > 0)
+        import_data.reset (new Number[exchange_partitioner.n_import_indices()]);
 
-      partitioner->export_to_ghosted_array_start
+      exchange_partitioner.export_to_ghosted_array_start
       (counter,
        ArrayView<const Number>(values.get(), partitioner->local_size()),
-       ArrayView<Number>(import_data.get(), partitioner->n_import_indices()),
+       ArrayView<Number>(import_data.get(), exchange_partitioner.n_import_indices()),
        ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
-       update_ghost_values_requests);
+       update_ghost_values_requests, update_ghost_values_persistent_requests);
 
 #else
       (void)counter;
@@ -613,17 +852,46 @@ namespace LinearAlgebra
 #ifdef DEAL_II_WITH_MPI
       // wait for both sends and receives to complete, even though only
       // receives are really necessary. this gives (much) better performance
-      AssertDimension (partitioner->ghost_targets().size() +
-                       partitioner->import_targets().size(),
+      const Utilities::MPI::Partitioner &exchange_partitioner =
+        shared_memory_exchange != nullptr ?
+        shared_memory_exchange->get_remote_partitioner() : *partitioner;
+      AssertDimension (exchange_partitioner.ghost_targets().size() +
+                       exchange_partitioner.import_targets().size(),
                        update_ghost_values_requests.size());
       if (update_ghost_values_requests.size() > 0)
         {
           // make this function thread safe
           Threads::Mutex::ScopedLock lock (mutex);
 
-          partitioner->export_to_ghosted_array_finish
-          (ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
-           update_ghost_values_requests);
+          if (uses_reduced_precision_ghost_exchange())
+            {
+              reduced_precision_type *ghost_buffer = reduced_precision_data.get() +
+                                                     exchange_partitioner.n_import_indices();
+              exchange_partitioner.export_to_ghosted_array_finish
+              (ArrayView<reduced_precision_type>(ghost_buffer, partitioner->n_ghost_indices()),
+               update_ghost_values_requests);
+              std::copy (ghost_buffer, ghost_buffer + partitioner->n_ghost_indices(),
+                         values.get() + partitioner->local_size());
+            }
+          else
+            exchange_partitioner.export_to_ghosted_array_finish
+            (ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()),
+             update_ghost_values_requests);
+        }
+
+      // read the ghost entries owned by other processes on the node. this
+      // must come after the exchange with other nodes, which may use some
+      // ghost entries as temporary storage. the barrier makes sure that no
+      // process changes its locally owned entries before all others have
+      // read them
+      if (shared_memory_exchange != nullptr)
+        {
+          Threads::Mutex::ScopedLock lock (mutex);
+
+          shared_memory_exchange->export_to_ghosted_array_shared
+          (shared_values,
+           ArrayView<Number>(values.get() + partitioner->local_size(),partitioner->n_ghost_indices()));
+          synchronize_shared_memory();
         }
 #endif
       vector_is_ghosted = true;
@@ -720,6 +988,11 @@ namespace LinearAlgebra
 
       std::swap (compress_requests, v.compress_requests);
       std::swap (update_ghost_values_requests, v.update_ghost_values_requests);
+      compress_persistent_requests.swap (v.compress_persistent_requests);
+      update_ghost_values_persistent_requests.swap (v.update_ghost_values_persistent_requests);
+      std::swap (shared_memory_exchange, v.shared_memory_exchange);
+      std::swap (shared_memory_window, v.shared_memory_window);
+      std::swap (shared_values, v.shared_values);
 #endif
 
       std::swap (partitioner,       v.partitioner);
@@ -727,7 +1000,9 @@ namespace LinearAlgebra
       std::swap (allocated_size,    v.allocated_size);
       std::swap (values,               v.values);
       std::swap (import_data,       v.import_data);
+      std::swap (reduced_precision_data, v.reduced_precision_data);
       std::swap (vector_is_ghosted, v.vector_is_ghosted);
+      std::swap (reduced_precision_ghost_exchange, v.reduced_precision_ghost_exchange);
     }
 
 
@@ -1331,6 +1606,67 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number>
+    typename Vector<Number>::real_type
+    Vector<Number>::add_and_norm_sqr_local(const Number          a,
+                                           const Vector<Number> &v,
+                                           Vector<Number>       &x,
+                                           const Vector<Number> &w)
+    {
+      const size_type vec_size = partitioner->local_size();
+      AssertDimension (vec_size, v.local_size());
+      AssertDimension (vec_size, x.local_size());
+      AssertDimension (vec_size, w.local_size());
+      Assert (&x != this && &x != &v,
+              ExcMessage("The vector X must be different from the calling "
+                         "vector and V."));
+
+      real_type sum;
+      internal::VectorOperations::AddAndAddAndNorm2<Number,real_type>
+      adder(this->values.get(), v.values.get(), x.values.get(), w.values.get(), a);
+      internal::VectorOperations::parallel_reduce (adder, 0, vec_size, sum, thread_loop_partitioner);
+      AssertIsFinite(sum);
+      return sum;
+    }
+
+
+
+    template <typename Number>
+    typename Vector<Number>::real_type
+    Vector<Number>::add_and_norm_sqr (const Number          a,
+                                      const Vector<Number> &v,
+                                      Vector<Number>       &x,
+                                      const Vector<Number> &w)
+    {
+      real_type local_result = add_and_norm_sqr_local(a, v, x, w);
+      if (partitioner->n_mpi_processes() > 1)
+        return Utilities::MPI::sum (local_result,
+                                    partitioner->get_mpi_communicator());
+      else
+        return local_result;
+    }
+
+
+
+    template <typename Number>
+    void
+    Vector<Number>::inner_products (const std::vector<const Vector<Number> *> &v,
+                                    std::vector<Number>                       &results) const
+    {
+      results.resize(v.size());
+      for (unsigned int i=0; i<v.size(); ++i)
+        {
+          Assert (v[i] != nullptr, ExcNotInitialized());
+          results[i] = inner_product_local(*v[i]);
+        }
+
+      if (partitioner->n_mpi_processes() > 1)
+        Utilities::MPI::sum (results, partitioner->get_mpi_communicator(),
+                             results);
+    }
+
+
+
     template <typename Number>
     inline
     bool
@@ -1368,11 +1704,59 @@ namespace LinearAlgebra
       if (import_data != nullptr)
         memory += (static_cast<std::size_t>(partitioner->n_import_indices())*
                    sizeof(Number));
+      if (reduced_precision_data != nullptr)
+        memory += (static_cast<std::size_t>(partitioner->n_import_indices()+
+                                            partitioner->n_ghost_indices())*
+                   sizeof(reduced_precision_type));
+#ifdef DEAL_II_WITH_MPI
+      if (shared_memory_exchange.use_count() > 0)
+        memory += shared_memory_exchange->memory_consumption()/shared_memory_exchange.use_count()+1;
+#endif
       return memory;
     }
 
 
 
+    template <typename Number>
+    MemoryReport
+    Vector<Number>::memory_report () const
+    {
+      MemoryReport report ("LinearAlgebra::distributed::Vector", sizeof(*this));
+      const std::size_t n_local = partitioner.use_count() > 0 ?
+                                  partitioner->local_size() : 0;
+      report.add ("locally owned values", sizeof (Number) * n_local);
+      report.add ("ghost values", sizeof (Number) *
+                  (static_cast<std::size_t>(allocated_size) - n_local));
+      if (import_data != nullptr)
+        report.add ("import data buffer",
+                    static_cast<std::size_t>(partitioner->n_import_indices())*
+                    sizeof(Number));
+      if (reduced_precision_data != nullptr)
+        report.add ("reduced precision exchange buffer",
+                    static_cast<std::size_t>(partitioner->n_import_indices()+
+                                             partitioner->n_ghost_indices())*
+                    sizeof(reduced_precision_type));
+      if (partitioner.use_count() > 0)
+        {
+          // in case the partitioner is shared, only count its share as in
+          // memory_consumption()
+          if (partitioner.use_count() == 1)
+            report.add (partitioner->memory_report());
+          else
+            report.add ("Partitioner (shared by " +
+                        Utilities::int_to_string(partitioner.use_count()) + " objects)",
+                        partitioner->memory_consumption()/partitioner.use_count()+1);
+        }
+#ifdef DEAL_II_WITH_MPI
+      if (shared_memory_exchange.use_count() > 0)
+        report.add ("shared memory exchange",
+                    shared_memory_exchange->memory_consumption()/shared_memory_exchange.use_count()+1);
+#endif
+      return report;
+    }
+
+
+
     template <typename Number>
     void
     Vector<Number>::print (std::ostream      &out,
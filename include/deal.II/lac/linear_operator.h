@@ -21,8 +21,11 @@
 #include <deal.II/lac/vector_memory.h>
 
 #include <array>
+#include <cmath>
 #include <functional>
+#include <memory>
 #include <type_traits>
+#include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -110,6 +113,14 @@ null_operator(const LinearOperator<Range, Domain, Payload> &);
  * const auto op = (op_a + k * op_b) * op_c;
  * @endcode
  *
+ * Sums and scalar multiples of linear operators are stored as a single
+ * linear combination of the operators involved, no matter how they are
+ * nested. In the example, <code>op.vmult(dst, src)</code> applies
+ * <code>op_c</code> to a temporary vector and then <code>op_a.vmult()</code>
+ * and <code>op_b.vmult_add()</code> to the result one after the other,
+ * without any further temporary vectors. The factor $k$ is applied by
+ * rescaling the result vector before and after <code>op_b.vmult_add()</code>.
+ *
  * @note This class makes heavy use of <code>std::function</code> objects and
  * lambda functions. This flexibility comes with a run-time penalty. Only use
  * this object to encapsulate matrix object of medium to large size (as a rule
@@ -340,6 +351,167 @@ public:
 };
 
 
+namespace internal
+{
+  namespace LinearOperator
+  {
+    /**
+     * The terms $s_k A_k$ of a linear combination $\sum_k s_k A_k$ of
+     * linear operators.
+     */
+    template <typename Range, typename Domain, typename Payload>
+    using LinearCombinationTerms
+      = std::vector<std::pair<typename Range::value_type,
+      dealii::LinearOperator<Range, Domain, Payload> > >;
+
+    /**
+     * A function object evaluating a linear combination of linear operators,
+     * created by the addition and scalar multiplication of LinearOperator
+     * objects. Rather than nesting one function object per operation and
+     * rescaling the result vector twice for every scaled summand, the terms
+     * are applied one after the other to the same result vector. The result
+     * vector holds the partial sum divided by the factor of the last term,
+     * so that it only needs to be rescaled when the factor changes between
+     * consecutive terms, and once at the end.
+     *
+     * The template argument @p transpose selects the application of the
+     * transpose operators, and @p add whether the result is added to the
+     * destination vector.
+     */
+    template <typename Range, typename Domain, typename Payload,
+              bool transpose, bool add>
+    struct LinearCombination
+    {
+      typedef typename std::conditional<transpose, Domain, Range>::type Destination;
+      typedef typename std::conditional<transpose, Range, Domain>::type Source;
+
+      void operator() (Destination &v, const Source &u) const
+      {
+        typedef typename Destination::value_type value_type;
+        value_type scaling = 1.;
+        bool overwrite = !add;
+        for (const auto &term : *terms)
+          {
+            if (overwrite)
+              {
+                apply(term.second, v, u, false);
+                overwrite = false;
+              }
+            else
+              {
+                if (term.first != scaling)
+                  v *= static_cast<value_type>(scaling / term.first);
+                apply(term.second, v, u, true);
+              }
+            scaling = term.first;
+          }
+        if (scaling != value_type(1.))
+          v *= scaling;
+      }
+
+      static void apply (const dealii::LinearOperator<Range, Domain, Payload> &op,
+                         Destination  &v,
+                         const Source &u,
+                         const bool    add_result)
+      {
+        apply_operator (op, v, u, add_result,
+                        std::integral_constant<bool,transpose>());
+      }
+
+      static void apply_operator (const dealii::LinearOperator<Range, Domain, Payload> &op,
+                                  Range  &v,
+                                  const Domain &u,
+                                  const bool    add_result,
+                                  std::false_type)
+      {
+        if (add_result)
+          op.vmult_add(v, u);
+        else
+          op.vmult(v, u);
+      }
+
+      static void apply_operator (const dealii::LinearOperator<Range, Domain, Payload> &op,
+                                  Domain &v,
+                                  const Range  &u,
+                                  const bool    add_result,
+                                  std::true_type)
+      {
+        if (add_result)
+          op.Tvmult_add(v, u);
+        else
+          op.Tvmult(v, u);
+      }
+
+      std::shared_ptr<const LinearCombinationTerms<Range, Domain, Payload> > terms;
+    };
+
+
+
+    /**
+     * Return the terms of the linear combination @p op if it has been
+     * created by the addition or scalar multiplication of other operators
+     * and none of its function objects has been replaced since, and the
+     * single term $1\cdot$ @p op otherwise.
+     */
+    template <typename Range, typename Domain, typename Payload>
+    LinearCombinationTerms<Range, Domain, Payload>
+    get_linear_combination_terms (const dealii::LinearOperator<Range, Domain, Payload> &op)
+    {
+      const auto vmult
+        = op.vmult.template target<LinearCombination<Range, Domain, Payload, false, false> >();
+      const auto vmult_add
+        = op.vmult_add.template target<LinearCombination<Range, Domain, Payload, false, true> >();
+      const auto Tvmult
+        = op.Tvmult.template target<LinearCombination<Range, Domain, Payload, true, false> >();
+      const auto Tvmult_add
+        = op.Tvmult_add.template target<LinearCombination<Range, Domain, Payload, true, true> >();
+
+      if (vmult != nullptr && vmult_add != nullptr &&
+          Tvmult != nullptr && Tvmult_add != nullptr &&
+          vmult->terms == vmult_add->terms &&
+          vmult->terms == Tvmult->terms &&
+          vmult->terms == Tvmult_add->terms)
+        return *vmult->terms;
+      else
+        return LinearCombinationTerms<Range, Domain, Payload>
+               (1, std::make_pair(typename Range::value_type(1.), op));
+    }
+
+
+
+    /**
+     * Let the function objects of @p op evaluate the linear combination
+     * with the given @p terms.
+     */
+    template <typename Range, typename Domain, typename Payload>
+    void
+    set_linear_combination (dealii::LinearOperator<Range, Domain, Payload> &op,
+                            const LinearCombinationTerms<Range, Domain, Payload> &terms)
+    {
+      const std::shared_ptr<const LinearCombinationTerms<Range, Domain, Payload> >
+      shared_terms (new LinearCombinationTerms<Range, Domain, Payload>(terms));
+
+      LinearCombination<Range, Domain, Payload, false, false> vmult;
+      vmult.terms = shared_terms;
+      op.vmult = vmult;
+
+      LinearCombination<Range, Domain, Payload, false, true> vmult_add;
+      vmult_add.terms = shared_terms;
+      op.vmult_add = vmult_add;
+
+      LinearCombination<Range, Domain, Payload, true, false> Tvmult;
+      Tvmult.terms = shared_terms;
+      op.Tvmult = Tvmult;
+
+      LinearCombination<Range, Domain, Payload, true, true> Tvmult_add;
+      Tvmult_add.terms = shared_terms;
+      op.Tvmult_add = Tvmult_add;
+    }
+  } /* namespace LinearOperator */
+} /* namespace internal */
+
+
+
 /**
  * @name Vector space operations
  */
@@ -376,32 +548,14 @@ operator+(const LinearOperator<Range, Domain, Payload> &first_op,
       return_op.reinit_range_vector = first_op.reinit_range_vector;
       return_op.reinit_domain_vector = first_op.reinit_domain_vector;
 
-      // ensure to have valid computation objects by catching first_op and
-      // second_op by value
-
-      return_op.vmult = [first_op, second_op](Range &v, const Domain &u)
-      {
-        first_op.vmult(v, u);
-        second_op.vmult_add(v, u);
-      };
-
-      return_op.vmult_add = [first_op, second_op](Range &v, const Domain &u)
-      {
-        first_op.vmult_add(v, u);
-        second_op.vmult_add(v, u);
-      };
-
-      return_op.Tvmult = [first_op, second_op](Domain &v, const Range &u)
-      {
-        second_op.Tvmult(v, u);
-        first_op.Tvmult_add(v, u);
-      };
-
-      return_op.Tvmult_add = [first_op, second_op](Domain &v, const Range &u)
-      {
-        second_op.Tvmult_add(v, u);
-        first_op.Tvmult_add(v, u);
-      };
+      // flatten nested sums and scalings into a single linear combination
+      // that is evaluated without temporary vectors
+      internal::LinearOperator::LinearCombinationTerms<Range, Domain, Payload> terms
+        = internal::LinearOperator::get_linear_combination_terms(first_op);
+      const internal::LinearOperator::LinearCombinationTerms<Range, Domain, Payload> second_terms
+        = internal::LinearOperator::get_linear_combination_terms(second_op);
+      terms.insert(terms.end(), second_terms.begin(), second_terms.end());
+      internal::LinearOperator::set_linear_combination(return_op, terms);
 
       return return_op;
     }
@@ -476,34 +630,13 @@ operator*(typename Range::value_type  number,
     {
       LinearOperator<Range, Domain, Payload> return_op = op;
 
-      // ensure to have valid computation objects by catching number and op by
-      // value
-
-      return_op.vmult = [number, op](Range &v, const Domain &u)
-      {
-        op.vmult(v,u);
-        v *= number;
-      };
-
-      return_op.vmult_add = [number, op](Range &v, const Domain &u)
-      {
-        v /= number;
-        op.vmult_add(v,u);
-        v *= number;
-      };
-
-      return_op.Tvmult = [number, op](Domain &v, const Range &u)
-      {
-        op.Tvmult(v,u);
-        v *= number;
-      };
-
-      return_op.Tvmult_add = [number, op](Domain &v, const Range &u)
-      {
-        v /= number;
-        op.Tvmult_add(v,u);
-        v *= number;
-      };
+      // fold the factor into the terms of a linear combination, such that
+      // the vector is only rescaled once in a sum of scaled operators
+      internal::LinearOperator::LinearCombinationTerms<Range, Domain, Payload> terms
+        = internal::LinearOperator::get_linear_combination_terms(op);
+      for (auto &term : terms)
+        term.first *= number;
+      internal::LinearOperator::set_linear_combination(return_op, terms);
 
       return return_op;
     }
@@ -723,6 +856,196 @@ inverse_operator(const LinearOperator<Range, Domain, Payload> &op,
   return return_op;
 }
 
+
+namespace internal
+{
+  namespace LinearOperator
+  {
+    /**
+     * A helper class for inverse_operator_with_recycling() that stores up
+     * to a given number of previous solutions of the inner solve, together
+     * with the product of the operator with these vectors, and computes an
+     * initial guess for the next solve from them.
+     *
+     * The stored vectors $w_i$ are kept orthonormal in the scalar product
+     * induced by the (symmetric positive definite) operator $A$, i.e.,
+     * $w_i^T A w_j = \delta_{ij}$. The initial guess for a right hand side
+     * $b$ is then the $A$-orthogonal projection of the solution onto the
+     * span of the stored vectors, $x_0 = \sum_i (w_i^T b) w_i$, which costs
+     * one inner product and one vector update per stored vector, but no
+     * application of the operator. Since the solution $x$ of a converged
+     * solve satisfies $Ax\approx b$, the product $Aw$ of a new vector is
+     * obtained from the right hand side instead of an additional operator
+     * evaluation.
+     */
+    template <typename VectorType>
+    class RecycledSolutions
+    {
+    public:
+      /**
+       * Constructor. Keep at most @p max_n_vectors previous solutions.
+       */
+      RecycledSolutions (const unsigned int max_n_vectors)
+        :
+        max_n_vectors (max_n_vectors)
+      {}
+
+      /**
+       * Set @p x to the projection of the solution for the right hand side
+       * @p b onto the space of stored vectors. The vector @p x must already
+       * have the correct size and be zero on entry.
+       */
+      void initial_guess (VectorType       &x,
+                          const VectorType &b) const
+      {
+        for (unsigned int i=0; i<vectors.size(); ++i)
+          x.add(*vectors[i] * b, *vectors[i]);
+      }
+
+      /**
+       * Add the solution @p x of the system with right hand side @p b to
+       * the stored vectors, dropping the oldest vector if the maximal
+       * number of vectors has been reached. Vectors that are (numerically)
+       * contained in the span of the stored vectors are not added.
+       */
+      void add (const VectorType &x,
+                const VectorType &b)
+      {
+        if (max_n_vectors == 0)
+          return;
+
+        std::unique_ptr<VectorType> w (new VectorType(x));
+        std::unique_ptr<VectorType> a_w (new VectorType(b));
+        for (unsigned int i=0; i<vectors.size(); ++i)
+          {
+            const typename VectorType::value_type alpha = *a_vectors[i] * x;
+            w->add(-alpha, *vectors[i]);
+            a_w->add(-alpha, *a_vectors[i]);
+          }
+
+        const typename VectorType::value_type norm_square = *w * *a_w;
+        const typename VectorType::value_type reference = x * b;
+        if (!(std::abs(norm_square) > 1e-12 * std::abs(reference)))
+          return;
+
+        const typename VectorType::value_type scaling = 1./std::sqrt(std::abs(norm_square));
+        *w *= scaling;
+        *a_w *= scaling;
+
+        if (vectors.size() == max_n_vectors)
+          {
+            vectors.erase(vectors.begin());
+            a_vectors.erase(a_vectors.begin());
+          }
+        vectors.push_back(std::move(w));
+        a_vectors.push_back(std::move(a_w));
+      }
+
+    private:
+      /**
+       * The maximal number of stored vectors.
+       */
+      const unsigned int max_n_vectors;
+
+      /**
+       * The $A$-orthonormal previous solutions.
+       */
+      std::vector<std::unique_ptr<VectorType> > vectors;
+
+      /**
+       * The product of the operator with the entries of @p vectors.
+       */
+      std::vector<std::unique_ptr<VectorType> > a_vectors;
+    };
+  }
+}
+
+
+
+/**
+ * @relates LinearOperator
+ *
+ * Return an object representing the inverse of the LinearOperator @p op
+ * like inverse_operator(), but where each inner solve is started from an
+ * initial guess built from the solutions of previous invocations of
+ * <code>vmult</code>.
+ *
+ * This is useful when the inverse is applied repeatedly to similar
+ * vectors, as for the inner solves with the velocity block or the Schur
+ * complement in a block preconditioner (see schur_complement()), where the
+ * right hand sides of two subsequent outer iterations often differ only
+ * slightly. The object keeps up to @p n_recycled_vectors previous
+ * solutions, orthonormalized in the energy scalar product of @p op, and
+ * uses the projection of the new solution onto their span as initial
+ * guess. With <code>n_recycled_vectors=1</code>, this is the previous
+ * solution scaled by the optimal factor (a warm start), and larger values
+ * deflate the components of the error that the outer iteration keeps
+ * reintroducing. The projection minimizes the error in the energy norm
+ * over the stored space, so the initial guess is never worse than a zero
+ * guess in that norm. The additional cost per application is two inner
+ * products and three vector updates per stored vector; the operator
+ * itself is not applied.
+ *
+ * The projection relies on @p op being symmetric and positive definite,
+ * which is the case for the usual inner solves with CG. The
+ * <code>Tvmult</code> variants solve with the transpose operator and do
+ * not use the stored vectors. Copies of the returned LinearOperator share
+ * the stored vectors.
+ *
+ * The stopping criterion of @p solver should be set relative to the norm
+ * of the right hand side (e.g. with ReductionControl or a tolerance scaled
+ * by the norm of the right hand side), as the initial residual is smaller
+ * than with a zero initial guess.
+ *
+ * The same requirements on the lifetime of @p solver and @p preconditioner
+ * as for inverse_operator() apply.
+ *
+ *
+ * @ingroup LAOperators
+ */
+template <typename Payload,
+          typename Solver, typename Preconditioner,
+          typename Range = typename Solver::vector_type, typename Domain = Range>
+LinearOperator<Domain, Range, Payload>
+inverse_operator_with_recycling(const LinearOperator<Range, Domain, Payload> &op,
+                                Solver &solver,
+                                const Preconditioner &preconditioner,
+                                const unsigned int n_recycled_vectors = 1)
+{
+  static_assert(std::is_same<Range, Domain>::value,
+                "The recycling of solutions requires the same vector type for "
+                "the range and the domain of the operator.");
+
+  LinearOperator<Domain, Range, Payload> return_op
+    = inverse_operator(op, solver, preconditioner);
+
+  std::shared_ptr<internal::LinearOperator::RecycledSolutions<Range> > history
+  (new internal::LinearOperator::RecycledSolutions<Range>(n_recycled_vectors));
+
+  return_op.vmult = [op, &solver, &preconditioner, history](Range &v, const Domain &u)
+  {
+    op.reinit_range_vector(v, /*bool omit_zeroing_entries =*/ false);
+    history->initial_guess(v, u);
+    solver.solve(op, v, u, preconditioner);
+    history->add(v, u);
+  };
+
+  return_op.vmult_add =
+    [op, &solver, &preconditioner, history](Range &v, const Domain &u)
+  {
+    GrowingVectorMemory<Range> vector_memory;
+
+    typename VectorMemory<Range>::Pointer v2 (vector_memory);
+    op.reinit_range_vector(*v2, /*bool omit_zeroing_entries =*/ false);
+    history->initial_guess(*v2, u);
+    solver.solve(op, *v2, u, preconditioner);
+    history->add(*v2, u);
+    v += *v2;
+  };
+
+  return return_op;
+}
+
 //@}
 
 
@@ -0,0 +1,200 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mapped_vector_memory_h
+#define dealii_mapped_vector_memory_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/vector_memory.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/**
+ * A memory pool for vectors whose elements are not kept in main memory, but
+ * in memory-mapped files. It is meant as a replacement of SwappableVector for
+ * applications that keep many more vectors than fit into main memory, such
+ * as the time history of adjoint or time-parallel methods: Rather than
+ * writing and reading whole vectors explicitly, the elements of the vectors
+ * handed out by alloc() live in temporary files that are mapped into the
+ * address space of the program. The operating system loads the pages of a
+ * vector when it is accessed and writes them back to the file when memory
+ * gets scarce, so the vectors can be used like any other Vector object, and
+ * the pool can be given to the iterative solvers like GrowingVectorMemory:
+ * @code
+ *   MappedVectorMemory<double> memory (dof_handler.n_dofs(), "/scratch");
+ *   std::vector<Vector<double> *> history;
+ *   for (unsigned int step=0; step<n_steps; ++step)
+ *     {
+ *       history.push_back (memory.alloc());
+ *       ... compute *history.back() ...
+ *       memory.evict (*history.back());
+ *     }
+ *   for (unsigned int step=n_steps; step>0; --step)
+ *     {
+ *       if (step > 1)
+ *         memory.prefetch (*history[step-2]);
+ *       ... use *history[step-1] ...
+ *       memory.free (history[step-1]);
+ *     }
+ * @endcode
+ *
+ * The functions prefetch() and evict() give hints to the operating system
+ * (via <tt>madvise</tt>): prefetch() starts to read the pages of a vector in
+ * the background, similar to SwappableVector::alert(), and evict() lets the
+ * operating system write the pages of a vector back to the file and release
+ * the memory. Neither function changes the elements of the vector.
+ *
+ * All vectors of the pool have the size given to the constructor. The files
+ * are deleted from the file system as soon as they are created, so they do
+ * not persist if the program terminates without cleaning up. Vectors
+ * returned through free() keep their file and are reused by later calls to
+ * alloc(); the files are closed in the destructor.
+ *
+ * The vectors handed out by this class must not be swapped with other
+ * vectors, and they lose their connection to the file if they are
+ * reinitialized to a larger size than the one given to the constructor, in
+ * which case they are placed in regular memory until they are returned to
+ * the pool.
+ *
+ * This class is only available on POSIX systems.
+ */
+template <typename Number>
+class MappedVectorMemory : public VectorMemory<Vector<Number> >
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Constructor. The vectors handed out by alloc() have @p vector_size
+   * elements, and their files are created in @p directory, which should be
+   * located on a disk with enough free space.
+   */
+  MappedVectorMemory (const size_type    vector_size,
+                      const std::string &directory = "/tmp");
+
+  /**
+   * Destructor. Unmaps and closes the files of all vectors. All vectors must
+   * have been returned to the pool at this point.
+   */
+  virtual ~MappedVectorMemory ();
+
+  /**
+   * Return a pointer to a vector of the size given to the constructor whose
+   * elements are stored in a memory-mapped file. The contents of the vector
+   * are unspecified.
+   */
+  virtual Vector<Number> *alloc ();
+
+  /**
+   * Return a vector to the pool for reuse by a later call to alloc().
+   */
+  virtual void free (const Vector<Number> *const vector);
+
+  /**
+   * Ask the operating system to read the elements of @p vector from the file
+   * in the background, so that they are available when the vector is used
+   * later.
+   */
+  void prefetch (const Vector<Number> &vector) const;
+
+  /**
+   * Tell the operating system that the elements of @p vector are not needed
+   * in the near future, so that their memory can be released after they
+   * have been written to the file. The elements are read again when the
+   * vector is accessed the next time.
+   */
+  void evict (const Vector<Number> &vector) const;
+
+  /**
+   * Return the number of vectors held by the pool, i.e., the number of files
+   * created.
+   */
+  unsigned int n_vectors () const;
+
+  /**
+   * Memory consumed by this class, not counting the memory-mapped elements
+   * of the vectors.
+   */
+  virtual std::size_t memory_consumption () const;
+
+private:
+  /**
+   * A vector of the pool together with its memory mapping.
+   */
+  struct Entry
+  {
+    /**
+     * The vector itself.
+     */
+    std::unique_ptr<Vector<Number> > vector;
+
+    /**
+     * The start of the memory mapping of the file.
+     */
+    Number *data;
+
+    /**
+     * Whether the vector is currently handed out by alloc().
+     */
+    bool in_use;
+  };
+
+  /**
+   * Return the entry of @p vector, or a null pointer if the vector was not
+   * allocated by this pool.
+   */
+  const Entry *find_entry (const Vector<Number> &vector) const;
+
+  /**
+   * Point the vector of @p entry to the mapped memory.
+   */
+  void make_view (Entry &entry) const;
+
+  /**
+   * The size of the vectors.
+   */
+  const size_type vector_size;
+
+  /**
+   * The file name prefix of the files.
+   */
+  const std::string file_template;
+
+  /**
+   * All vectors created so far.
+   */
+  std::vector<Entry> entries;
+
+  /**
+   * Mutex protecting the list of vectors.
+   */
+  mutable Threads::Mutex mutex;
+};
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
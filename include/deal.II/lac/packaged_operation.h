@@ -21,6 +21,8 @@
 #include <deal.II/lac/vector_memory.h>
 
 #include <functional>
+#include <memory>
+#include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -269,6 +271,140 @@ public:
 };
 
 
+namespace internal
+{
+  namespace PackagedOperationImplementation
+  {
+    /**
+     * The terms $s_k c_k$ of a linear combination $\sum_k s_k c_k$ of
+     * PackagedOperation objects.
+     */
+    template <typename Range>
+    using LinearCombinationTerms
+      = std::vector<std::pair<typename Range::value_type, PackagedOperation<Range> > >;
+
+    /**
+     * A function object evaluating a linear combination of PackagedOperation
+     * objects, created by their addition, subtraction, and scalar
+     * multiplication. The terms are applied one after the other to the same
+     * vector, which holds the partial sum divided by the factor of the last
+     * term. Thus, the vector is only rescaled when the factor changes
+     * between consecutive terms, and once at the end. The template argument
+     * @p add selects whether the result is added to the vector.
+     */
+    template <typename Range, bool add>
+    struct LinearCombination
+    {
+      void operator() (Range &v) const
+      {
+        typedef typename Range::value_type value_type;
+        value_type scaling = 1.;
+        bool overwrite = !add;
+        for (const auto &term : *terms)
+          {
+            if (overwrite)
+              {
+                term.second.apply(v);
+                overwrite = false;
+              }
+            else
+              {
+                if (term.first != scaling)
+                  v *= static_cast<value_type>(scaling / term.first);
+                term.second.apply_add(v);
+              }
+            scaling = term.first;
+          }
+        if (scaling != value_type(1.))
+          v *= scaling;
+      }
+
+      std::shared_ptr<const LinearCombinationTerms<Range> > terms;
+    };
+
+
+
+    /**
+     * Return the terms of the linear combination @p comp if it has been
+     * created by the addition or scalar multiplication of other
+     * PackagedOperation objects and none of its function objects has been
+     * replaced since, and the single term $1\cdot$ @p comp otherwise.
+     */
+    template <typename Range>
+    LinearCombinationTerms<Range>
+    get_linear_combination_terms (const PackagedOperation<Range> &comp)
+    {
+      const auto apply
+        = comp.apply.template target<LinearCombination<Range, false> >();
+      const auto apply_add
+        = comp.apply_add.template target<LinearCombination<Range, true> >();
+
+      if (apply != nullptr && apply_add != nullptr &&
+          apply->terms == apply_add->terms)
+        return *apply->terms;
+      else
+        return LinearCombinationTerms<Range>
+               (1, std::make_pair(typename Range::value_type(1.), comp));
+    }
+
+
+
+    /**
+     * Let the function objects of @p comp evaluate the linear combination
+     * with the given @p terms.
+     */
+    template <typename Range>
+    void
+    set_linear_combination (PackagedOperation<Range>            &comp,
+                            const LinearCombinationTerms<Range> &terms)
+    {
+      const std::shared_ptr<const LinearCombinationTerms<Range> >
+      shared_terms (new LinearCombinationTerms<Range>(terms));
+
+      LinearCombination<Range, false> apply;
+      apply.terms = shared_terms;
+      comp.apply = apply;
+
+      LinearCombination<Range, true> apply_add;
+      apply_add.terms = shared_terms;
+      comp.apply_add = apply_add;
+    }
+
+
+
+    /**
+     * Return the linear combination @p first_factor * @p first_comp +
+     * @p second_factor * @p second_comp, flattening the terms of nested
+     * linear combinations.
+     */
+    template <typename Range>
+    PackagedOperation<Range>
+    linear_combination (const typename Range::value_type first_factor,
+                        const PackagedOperation<Range>  &first_comp,
+                        const typename Range::value_type second_factor,
+                        const PackagedOperation<Range>  &second_comp)
+    {
+      PackagedOperation<Range> return_comp;
+      return_comp.reinit_vector = first_comp.reinit_vector;
+
+      LinearCombinationTerms<Range> terms
+        = get_linear_combination_terms(first_comp);
+      for (auto &term : terms)
+        term.first *= first_factor;
+      LinearCombinationTerms<Range> second_terms
+        = get_linear_combination_terms(second_comp);
+      for (auto &term : second_terms)
+        term.first *= second_factor;
+      terms.insert(terms.end(), second_terms.begin(), second_terms.end());
+
+      set_linear_combination(return_comp, terms);
+      return return_comp;
+    }
+  } /* namespace PackagedOperationImplementation */
+} /* namespace internal */
+
+
+
 /**
  * @name Vector space operations
  */
@@ -287,26 +423,10 @@ PackagedOperation<Range>
 operator+(const PackagedOperation<Range> &first_comp,
           const PackagedOperation<Range> &second_comp)
 {
-  PackagedOperation<Range> return_comp;
-
-  return_comp.reinit_vector = first_comp.reinit_vector;
-
-  // ensure to have valid PackagedOperation objects by catching first_comp and
-  // second_comp by value
-
-  return_comp.apply = [first_comp, second_comp](Range &v)
-  {
-    first_comp.apply(v);
-    second_comp.apply_add(v);
-  };
-
-  return_comp.apply_add = [first_comp, second_comp](Range &v)
-  {
-    first_comp.apply_add(v);
-    second_comp.apply_add(v);
-  };
-
-  return return_comp;
+  // evaluate nested sums and scalings as a single linear combination
+  return internal::PackagedOperationImplementation::linear_combination
+         (typename Range::value_type(1.), first_comp,
+          typename Range::value_type(1.), second_comp);
 }
 
 /**
@@ -322,29 +442,10 @@ PackagedOperation<Range>
 operator-(const PackagedOperation<Range> &first_comp,
           const PackagedOperation<Range> &second_comp)
 {
-  PackagedOperation<Range> return_comp;
-
-  return_comp.reinit_vector = first_comp.reinit_vector;
-
-  // ensure to have valid PackagedOperation objects by catching first_comp and
-  // second_comp by value
-
-  return_comp.apply = [first_comp, second_comp](Range &v)
-  {
-    second_comp.apply(v);
-    v *= -1.;
-    first_comp.apply_add(v);
-  };
-
-  return_comp.apply_add = [first_comp, second_comp](Range &v)
-  {
-    first_comp.apply_add(v);
-    v *= -1.;
-    second_comp.apply_add(v);
-    v *= -1.;
-  };
-
-  return return_comp;
+  // evaluate nested sums and scalings as a single linear combination
+  return internal::PackagedOperationImplementation::linear_combination
+         (typename Range::value_type(1.), first_comp,
+          typename Range::value_type(-1.), second_comp);
 }
 
 /**
@@ -378,18 +479,12 @@ operator*(const PackagedOperation<Range> &comp,
     }
   else
     {
-      return_comp.apply = [comp, number](Range &v)
-      {
-        comp.apply(v);
-        v *= number;
-      };
-
-      return_comp.apply_add = [comp, number](Range &v)
-      {
-        v /= number;
-        comp.apply_add(v);
-        v *= number;
-      };
+      // fold the factor into the terms of a linear combination
+      internal::PackagedOperationImplementation::LinearCombinationTerms<Range> terms
+        = internal::PackagedOperationImplementation::get_linear_combination_terms(comp);
+      for (auto &term : terms)
+        term.first *= number;
+      internal::PackagedOperationImplementation::set_linear_combination(return_comp, terms);
     }
 
   return return_comp;
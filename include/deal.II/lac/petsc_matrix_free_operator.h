@@ -0,0 +1,323 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_petsc_matrix_free_operator_h
+#define dealii_petsc_matrix_free_operator_h
+
+
+#include <deal.II/base/config.h>
+
+#ifdef DEAL_II_WITH_PETSC
+#  include <deal.II/base/smartpointer.h>
+#  include <deal.II/lac/exceptions.h>
+#  include <deal.II/lac/la_parallel_vector.h>
+#  include <deal.II/lac/petsc_matrix_free.h>
+
+#  include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+
+namespace PETScWrappers
+{
+  /**
+   * Create a PETSc vector that uses the memory of the locally owned
+   * elements of @p vector, rather than copying them (via
+   * <tt>VecCreateMPIWithArray</tt>). Changes made through either of the two
+   * objects are immediately visible in the other one. The ghost elements of
+   * @p vector are placed behind the locally owned ones and are not seen by
+   * PETSc.
+   *
+   * Vectors created from the returned one by <tt>VecDuplicate</tt>, as done
+   * by the PETSc Krylov solvers for their auxiliary vectors, are again
+   * views of LinearAlgebra::distributed::Vector objects with the same
+   * partitioner, which are owned by the PETSc vector and deleted together
+   * with it. This allows MatrixFreeOperatorWrapper to apply deal.II
+   * operators to all vectors inside a PETSc solver without copying.
+   *
+   * The caller is responsible for destroying the returned vector with
+   * <tt>VecDestroy</tt>, which must happen before @p vector goes out of
+   * scope or gets reinitialized.
+   */
+  Vec create_vector_view (LinearAlgebra::distributed::Vector<PetscScalar> &vector);
+
+  /**
+   * Return the deal.II vector whose memory is used by the PETSc vector
+   * @p vector if it was created by create_vector_view() or duplicated from
+   * such a vector, and a null pointer otherwise.
+   */
+  LinearAlgebra::distributed::Vector<PetscScalar> *
+  get_vector_view (const Vec &vector);
+
+
+
+  /**
+   * A PETSc shell matrix that applies a deal.II operator, such as the
+   * classes in the namespace MatrixFreeOperators, working on vectors of
+   * type LinearAlgebra::distributed::Vector<PetscScalar>. This allows to use
+   * the PETSc solvers (and the solvers in the PETScWrappers namespace) with
+   * matrix-free operators.
+   *
+   * If the PETSc vectors given to the matrix-vector product have been
+   * created by create_vector_view() or were duplicated from such a vector,
+   * the operator works directly on the memory of the underlying deal.II
+   * vectors. For all other PETSc vectors, the data is copied into and out of
+   * temporary vectors of the operator.
+   * @code
+   *   LinearAlgebra::distributed::Vector<PetscScalar> solution, rhs;
+   *   laplace_operator.initialize_dof_vector (solution);
+   *   laplace_operator.initialize_dof_vector (rhs);
+   *   ...
+   *   PETScWrappers::MatrixFreeOperatorWrapper<LaplaceOperator>
+   *   system_matrix (laplace_operator);
+   *   Vec x = PETScWrappers::create_vector_view (solution);
+   *   Vec b = PETScWrappers::create_vector_view (rhs);
+   *   {
+   *     PETScWrappers::VectorBase x_petsc (x), b_petsc (b);
+   *     PETScWrappers::SolverCG solver (solver_control, communicator);
+   *     PETScWrappers::PreconditionNone preconditioner (system_matrix);
+   *     solver.solve (system_matrix, x_petsc, b_petsc, preconditioner);
+   *   }
+   *   VecDestroy (&x);
+   *   VecDestroy (&b);
+   * @endcode
+   *
+   * The template argument @p OperatorType must provide the functions
+   * <tt>vmult</tt>, <tt>Tvmult</tt>, <tt>vmult_add</tt>, <tt>Tvmult_add</tt>
+   * and <tt>initialize_dof_vector</tt> for vectors of type
+   * LinearAlgebra::distributed::Vector<PetscScalar>.
+   */
+  template <typename OperatorType>
+  class MatrixFreeOperatorWrapper : public MatrixFree
+  {
+  public:
+    /**
+     * Constructor. Sets up a shell matrix with the sizes and the parallel
+     * layout of the vectors of @p op. The operator must outlive this
+     * object.
+     */
+    MatrixFreeOperatorWrapper (const OperatorType &op);
+
+    /**
+     * Matrix-vector multiplication through the operator.
+     */
+    virtual
+    void vmult (VectorBase       &dst,
+                const VectorBase &src) const;
+
+    /**
+     * Transposed matrix-vector multiplication through the operator.
+     */
+    virtual
+    void Tvmult (VectorBase       &dst,
+                 const VectorBase &src) const;
+
+    /**
+     * Adding matrix-vector multiplication through the operator.
+     */
+    virtual
+    void vmult_add (VectorBase       &dst,
+                    const VectorBase &src) const;
+
+    /**
+     * Adding transposed matrix-vector multiplication through the operator.
+     */
+    virtual
+    void Tvmult_add (VectorBase       &dst,
+                     const VectorBase &src) const;
+
+    /**
+     * The matrix-vector multiplication called by the PETSc solvers.
+     */
+    virtual
+    void vmult (Vec  &dst, const Vec  &src) const;
+
+  private:
+    /**
+     * Apply the operator, the transpose if @p transpose is set, to @p src
+     * and write or, if @p add is set, add the result to @p dst.
+     */
+    void apply (const Vec &dst, const Vec &src,
+                const bool transpose, const bool add) const;
+
+    /**
+     * The operator.
+     */
+    SmartPointer<const OperatorType> op;
+
+    /**
+     * Temporary vectors for PETSc vectors that do not use the memory of a
+     * deal.II vector.
+     */
+    mutable LinearAlgebra::distributed::Vector<PetscScalar> tmp_src;
+    mutable LinearAlgebra::distributed::Vector<PetscScalar> tmp_dst;
+  };
+
+
+
+// -------- template and inline functions ----------
+
+  template <typename OperatorType>
+  MatrixFreeOperatorWrapper<OperatorType>
+  ::MatrixFreeOperatorWrapper (const OperatorType &op_in)
+    :
+    op (&op_in)
+  {
+    op_in.initialize_dof_vector (tmp_src);
+    op_in.initialize_dof_vector (tmp_dst);
+    reinit (tmp_src.get_mpi_communicator(), tmp_src.size(), tmp_src.size(),
+            tmp_src.local_size(), tmp_src.local_size());
+  }
+
+
+
+  template <typename OperatorType>
+  void
+  MatrixFreeOperatorWrapper<OperatorType>::vmult (VectorBase       &dst,
+                                                  const VectorBase &src) const
+  {
+    apply (static_cast<const Vec &>(dst), static_cast<const Vec &>(src),
+           false, false);
+  }
+
+
+
+  template <typename OperatorType>
+  void
+  MatrixFreeOperatorWrapper<OperatorType>::Tvmult (VectorBase       &dst,
+                                                   const VectorBase &src) const
+  {
+    apply (static_cast<const Vec &>(dst), static_cast<const Vec &>(src),
+           true, false);
+  }
+
+
+
+  template <typename OperatorType>
+  void
+  MatrixFreeOperatorWrapper<OperatorType>::vmult_add (VectorBase       &dst,
+                                                      const VectorBase &src) const
+  {
+    apply (static_cast<const Vec &>(dst), static_cast<const Vec &>(src),
+           false, true);
+  }
+
+
+
+  template <typename OperatorType>
+  void
+  MatrixFreeOperatorWrapper<OperatorType>::Tvmult_add (VectorBase       &dst,
+                                                       const VectorBase &src) const
+  {
+    apply (static_cast<const Vec &>(dst), static_cast<const Vec &>(src),
+           true, true);
+  }
+
+
+
+  template <typename OperatorType>
+  void
+  MatrixFreeOperatorWrapper<OperatorType>::vmult (Vec &dst, const Vec &src) const
+  {
+    apply (dst, src, false, false);
+  }
+
+
+
+  template <typename OperatorType>
+  void
+  MatrixFreeOperatorWrapper<OperatorType>::apply (const Vec &dst,
+                                                  const Vec &src,
+                                                  const bool transpose,
+                                                  const bool add) const
+  {
+    LinearAlgebra::distributed::Vector<PetscScalar> *src_view = get_vector_view (src);
+    LinearAlgebra::distributed::Vector<PetscScalar> *dst_view = get_vector_view (dst);
+    const unsigned int local_size = tmp_src.local_size();
+    PetscErrorCode ierr;
+
+    // copy the data of PETSc vectors that do not share their memory with a
+    // deal.II vector
+    if (src_view == nullptr)
+      {
+        const PetscScalar *src_values;
+        ierr = VecGetArrayRead (src, &src_values);
+        AssertThrow (ierr == 0, ExcPETScError(ierr));
+        std::copy (src_values, src_values+local_size, tmp_src.begin());
+        ierr = VecRestoreArrayRead (src, &src_values);
+        AssertThrow (ierr == 0, ExcPETScError(ierr));
+        src_view = &tmp_src;
+      }
+    else
+      // PETSc might have changed the locally owned values behind the back of
+      // the deal.II vector, so the ghost values must be imported again
+      src_view->zero_out_ghosts();
+    AssertDimension (src_view->local_size(), local_size);
+
+    if (dst_view == nullptr)
+      {
+        dst_view = &tmp_dst;
+        if (add)
+          {
+            const PetscScalar *dst_values;
+            ierr = VecGetArrayRead (dst, &dst_values);
+            AssertThrow (ierr == 0, ExcPETScError(ierr));
+            std::copy (dst_values, dst_values+local_size, tmp_dst.begin());
+            ierr = VecRestoreArrayRead (dst, &dst_values);
+            AssertThrow (ierr == 0, ExcPETScError(ierr));
+          }
+      }
+    AssertDimension (dst_view->local_size(), local_size);
+
+    if (transpose)
+      {
+        if (add)
+          op->Tvmult_add (*dst_view, *src_view);
+        else
+          op->Tvmult (*dst_view, *src_view);
+      }
+    else
+      {
+        if (add)
+          op->vmult_add (*dst_view, *src_view);
+        else
+          op->vmult (*dst_view, *src_view);
+      }
+
+    if (dst_view == &tmp_dst)
+      {
+        PetscScalar *dst_values;
+        ierr = VecGetArray (dst, &dst_values);
+        AssertThrow (ierr == 0, ExcPETScError(ierr));
+        std::copy (tmp_dst.begin(), tmp_dst.begin()+local_size, dst_values);
+        ierr = VecRestoreArray (dst, &dst_values);
+        AssertThrow (ierr == 0, ExcPETScError(ierr));
+      }
+    else
+      {
+        // the values were written to the memory of the PETSc vector
+        // directly, so invalidate the cached data of PETSc such as norms
+        ierr = PetscObjectStateIncrease (reinterpret_cast<PetscObject>(dst));
+        AssertThrow (ierr == 0, ExcPETScError(ierr));
+      }
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // DEAL_II_WITH_PETSC
+
+#endif
@@ -22,11 +22,17 @@
 #include <deal.II/base/smartpointer.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/parallel.h>
+#include <deal.II/base/performance_counters.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/lac/diagonal_matrix.h>
 #include <deal.II/lac/solver_cg.h>
 #include <deal.II/lac/vector_memory.h>
+#ifdef DEAL_II_WITH_CUDA
+#  include <deal.II/lac/read_write_vector.h>
+#endif
+
+#include <functional>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -37,10 +43,19 @@ template <typename number> class SparseMatrix;
 namespace LinearAlgebra
 {
   namespace distributed
+  {
+    template <typename number> class Vector;
+    template <typename number> class BlockVector;
+  }
+  namespace CUDAWrappers
   {
     template <typename number> class Vector;
   }
 }
+namespace CUDAWrappers
+{
+  template <typename number> class SparseMatrix;
+}
 
 
 
@@ -855,6 +870,28 @@ private:
  * direct solver. For an error estimation of the Chebyshev iteration that can
  * be used to determine the number of iteration, see Varga (2009).
  *
+ * When the preconditioner is re-initialized for a sequence of similar
+ * operators, e.g. in every step of a Newton iteration or a time stepping
+ * scheme, the eigenvalue estimate of the previous operator can be kept by
+ * setting PreconditionChebyshev::AdditionalData::reuse_eigenvalue_estimate.
+ * Optionally, the first vmult() after initialize() then runs a single
+ * matrix-vector product with a fixed probe vector and only repeats the full
+ * eigenvalue estimation if the resulting estimate of the largest eigenvalue
+ * has drifted by more than
+ * PreconditionChebyshev::AdditionalData::eigenvalue_drift_tolerance relative
+ * to the one recorded at the time of the last full estimation.
+ *
+ * If the matrix provides a function <tt>vmult(VectorType &, const VectorType
+ * &, const std::function<void(const unsigned int, const unsigned int)> &,
+ * const std::function<void(const unsigned int, const unsigned int)> &)</tt>
+ * that runs operations on ranges of vector entries before and after the
+ * matrix-vector product, like MatrixFreeOperators::Base, and the
+ * preconditioner is a DiagonalMatrix around
+ * LinearAlgebra::distributed::Vector, the vector updates of each Chebyshev
+ * step are run on the entries of the matrix-vector product as soon as they
+ * are final. For matrix-free operators, this merges the updates into the
+ * cell loop and saves several sweeps through the vectors per step.
+ *
  * In order to use Chebyshev as a solver, set the degree to
  * numbers::invalid_unsigned_int to force the automatic computation of the
  * number of iterations needed to reach a given target tolerance. In this
@@ -919,12 +956,14 @@ public:
     /**
      * Constructor.
      */
-    AdditionalData (const unsigned int degree              = 0,
-                    const double       smoothing_range     = 0.,
-                    const bool         nonzero_starting    = false,
-                    const unsigned int eig_cg_n_iterations = 8,
-                    const double       eig_cg_residual     = 1e-2,
-                    const double       max_eigenvalue      = 1);
+    AdditionalData (const unsigned int degree                     = 0,
+                    const double       smoothing_range            = 0.,
+                    const bool         nonzero_starting           = false,
+                    const unsigned int eig_cg_n_iterations        = 8,
+                    const double       eig_cg_residual            = 1e-2,
+                    const double       max_eigenvalue             = 1,
+                    const bool         reuse_eigenvalue_estimate  = false,
+                    const double       eigenvalue_drift_tolerance = 0.);
 
     /**
      * This determines the degree of the Chebyshev polynomial. The degree of
@@ -986,6 +1025,25 @@ public:
      */
     double max_eigenvalue;
 
+    /**
+     * If set to <tt>true</tt> and the preconditioner has already computed an
+     * eigenvalue estimate for a matrix of the same size, a subsequent call to
+     * initialize() keeps that estimate instead of running the CG iteration
+     * again during the next vmult(). Only in effect if @p
+     * eig_cg_n_iterations is positive.
+     */
+    bool reuse_eigenvalue_estimate;
+
+    /**
+     * Relative tolerance for the drift of the largest eigenvalue when
+     * reusing an eigenvalue estimate. If positive, the first vmult() after
+     * initialize() compares the estimate $\|P^{-1}Av\|/\|v\|$ for a fixed
+     * vector $v$ against the value recorded at the last full eigenvalue
+     * estimation and runs a new estimation if the relative difference exceeds
+     * this tolerance. If zero, the reused estimate is never checked.
+     */
+    double eigenvalue_drift_tolerance;
+
     /**
      * Stores the inverse of the diagonal of the underlying matrix.
      *
@@ -1105,6 +1163,29 @@ private:
    */
   bool eigenvalues_are_initialized;
 
+  /**
+   * The estimates of the largest and smallest eigenvalue from the last
+   * eigenvalue computation, kept for reuse in subsequent calls to
+   * initialize().
+   */
+  double max_eigenvalue_estimate;
+  double min_eigenvalue_estimate;
+
+  /**
+   * The value of $\|P^{-1}Av\|/\|v\|$ for the probe vector $v$ at the time
+   * of the last full eigenvalue estimation, used for detecting the drift of
+   * the eigenvalues when reusing the estimate.
+   */
+  double probe_eigenvalue;
+
+  /**
+   * Stores whether the eigenvalue estimate has been carried over from a
+   * previous matrix in initialize(), in which case the next vmult()
+   * re-creates the temporary vectors and checks for the drift of the
+   * eigenvalues.
+   */
+  bool eigenvalues_are_reused;
+
   /**
    * A mutex to avoid that multiple vmult() invocations by different threads
    * overwrite the temporary vectors.
@@ -1134,6 +1215,27 @@ private:
    * by the user is used.
    */
   void estimate_eigenvalues(const VectorType &src) const;
+
+  /**
+   * Computes the factors theta and delta (and the degree, if it is
+   * determined automatically) from the given eigenvalue range.
+   */
+  void compute_chebyshev_parameters(const double max_eigenvalue,
+                                    const double min_eigenvalue) const;
+
+  /**
+   * Returns the estimate $\|P^{-1}Av\|/\|v\|$ of the largest eigenvalue
+   * for a fixed probe vector $v$, using the vectors update1 and update2 as
+   * scratch space.
+   */
+  double compute_probe_eigenvalue() const;
+
+  /**
+   * Sets up the temporary vectors for a reused eigenvalue estimate, checks
+   * the estimate against the drift tolerance and recomputes the eigenvalues
+   * if necessary.
+   */
+  void check_eigenvalue_drift(const VectorType &src) const;
 };
 
 
@@ -1857,6 +1959,103 @@ namespace internal
       VectorUpdatesRange<Number>(upd, src.local_size());
     }
 
+    // selection for diagonal matrix around parallel deal.II block vector,
+    // running the fused updates block by block
+    template <typename Number>
+    inline
+    void
+    vector_updates (const LinearAlgebra::distributed::BlockVector<Number> &src,
+                    const DiagonalMatrix<LinearAlgebra::distributed::BlockVector<Number> > &jacobi,
+                    const bool    start_zero,
+                    const double  factor1,
+                    const double  factor2,
+                    LinearAlgebra::distributed::BlockVector<Number> &update1,
+                    LinearAlgebra::distributed::BlockVector<Number> &update2,
+                    LinearAlgebra::distributed::BlockVector<Number> &,
+                    LinearAlgebra::distributed::BlockVector<Number> &dst)
+    {
+      for (unsigned int b=0; b<src.n_blocks(); ++b)
+        {
+          VectorUpdater<Number> upd(src.block(b).begin(),
+                                    jacobi.get_vector().block(b).begin(),
+                                    start_zero, factor1, factor2,
+                                    update1.block(b).begin(),
+                                    update2.block(b).begin(),
+                                    dst.block(b).begin());
+          VectorUpdatesRange<Number>(upd, src.block(b).local_size());
+        }
+    }
+
+    // A trait class that determines whether the matrix type provides a
+    // vmult function that runs additional operations on ranges of vector
+    // entries before and after the matrix-vector product, like
+    // MatrixFreeOperators::Base
+    template <typename MatrixType, typename VectorType>
+    class has_vmult_with_std_functions
+    {
+      template <typename C>
+      static std::false_type test(...);
+
+      template <typename C>
+      static auto test(VectorType *v)
+      -> decltype(std::declval<const C>().vmult(*v, *v,
+                                                std::function<void(const unsigned int, const unsigned int)>(),
+                                                std::function<void(const unsigned int, const unsigned int)>()),
+                  std::true_type());
+
+    public:
+      static const bool value = decltype(test<MatrixType>(nullptr))::value;
+    };
+
+    // one step of the Chebyshev iteration for general matrices: a
+    // matrix-vector product followed by the vector updates
+    template <typename MatrixType, typename VectorType, typename PreconditionerType>
+    inline
+    void
+    vmult_and_vector_updates (const MatrixType         &matrix,
+                              const VectorType         &src,
+                              const PreconditionerType &preconditioner,
+                              const double              factor1,
+                              const double              factor2,
+                              VectorType               &update1,
+                              VectorType               &update2,
+                              VectorType               &update3,
+                              VectorType               &dst)
+    {
+      matrix.vmult (update2, dst);
+      vector_updates (src, preconditioner, false, factor1, factor2,
+                      update1, update2, update3, dst);
+    }
+
+    // for matrices that can run operations inside the matrix-vector product
+    // and a diagonal preconditioner, run the vector updates on each range of
+    // entries as soon as the matrix-vector product has computed them, while
+    // the data is still in cache
+    template <typename MatrixType, typename Number>
+    inline
+    typename std::enable_if<has_vmult_with_std_functions<MatrixType,
+             LinearAlgebra::distributed::Vector<Number> >::value>::type
+             vmult_and_vector_updates (const MatrixType                                                  &matrix,
+                                       const LinearAlgebra::distributed::Vector<Number>                  &src,
+                                       const DiagonalMatrix<LinearAlgebra::distributed::Vector<Number> > &jacobi,
+                                       const double                                                       factor1,
+                                       const double                                                       factor2,
+                                       LinearAlgebra::distributed::Vector<Number>                        &update1,
+                                       LinearAlgebra::distributed::Vector<Number>                        &update2,
+                                       LinearAlgebra::distributed::Vector<Number>                        &,
+                                       LinearAlgebra::distributed::Vector<Number>                        &dst)
+    {
+      const VectorUpdater<Number> upd(src.begin(), jacobi.get_vector().begin(),
+                                      false, factor1, factor2,
+                                      update1.begin(), update2.begin(), dst.begin());
+      matrix.vmult (update2, dst,
+                    std::function<void(const unsigned int, const unsigned int)>(),
+                    [&](const unsigned int begin, const unsigned int end)
+      {
+        upd.apply_to_subrange(begin, end);
+      });
+    }
+
     template <typename MatrixType, typename VectorType, typename PreconditionerType>
     inline
     void
@@ -1903,6 +2102,60 @@ namespace internal
         }
     }
 
+#ifdef DEAL_II_WITH_CUDA
+    // the entries of vectors on the device can not be set one by one, so
+    // the inverse of the diagonal must be given by the user for general
+    // matrices, whereas it is available from CUDAWrappers::SparseMatrix
+    template <typename MatrixType, typename Number>
+    inline
+    void
+    set_diagonal_inverse(const MatrixType &,
+                         LinearAlgebra::CUDAWrappers::Vector<Number> &)
+    {
+      AssertThrow(false,
+                  ExcMessage("For vectors on the device, the inverse of the "
+                             "matrix diagonal must be set in "
+                             "AdditionalData::preconditioner unless the "
+                             "matrix is a CUDAWrappers::SparseMatrix."));
+    }
+
+    template <typename Number>
+    inline
+    void
+    set_diagonal_inverse(const CUDAWrappers::SparseMatrix<Number>    &matrix,
+                         LinearAlgebra::CUDAWrappers::Vector<Number> &diagonal_inverse)
+    {
+      diagonal_inverse = matrix.get_diagonal_inverse();
+    }
+
+    template <typename MatrixType, typename Number>
+    inline
+    void
+    initialize_preconditioner(const MatrixType                                                             &matrix,
+                              std::shared_ptr<DiagonalMatrix<LinearAlgebra::CUDAWrappers::Vector<Number> > > &preconditioner,
+                              LinearAlgebra::CUDAWrappers::Vector<Number>                                  &diagonal_inverse)
+    {
+      if (preconditioner.get() == nullptr ||
+          preconditioner->m() != matrix.m())
+        {
+          if (preconditioner.get() == nullptr)
+            preconditioner.reset(new DiagonalMatrix<LinearAlgebra::CUDAWrappers::Vector<Number> >());
+
+          Assert(preconditioner->m() == 0,
+                 ExcMessage("Preconditioner appears to be initialized but not sized correctly"));
+
+          preconditioner->reinit(diagonal_inverse);
+          {
+            LinearAlgebra::CUDAWrappers::Vector<Number> empty_vector;
+            diagonal_inverse.reinit(empty_vector);
+          }
+
+          if (preconditioner->m() != matrix.m())
+            set_diagonal_inverse(matrix, preconditioner->get_vector());
+        }
+    }
+#endif
+
     template <typename VectorType>
     void set_initial_guess(VectorType &vector)
     {
@@ -1944,6 +2197,44 @@ namespace internal
       vector.add(-mean_value);
     }
 
+    template <typename Number>
+    void set_initial_guess(::dealii::LinearAlgebra::distributed::BlockVector<Number> &vector)
+    {
+      // Same as for the distributed vector, enumerating the entries by
+      // their global index within the whole block vector
+      types::global_dof_index block_offset = 0;
+      for (unsigned int b=0; b<vector.n_blocks(); ++b)
+        {
+          LinearAlgebra::distributed::Vector<Number> &block = vector.block(b);
+          types::global_dof_index first_local_range = block_offset;
+          if (!block.locally_owned_elements().is_empty())
+            first_local_range += block.locally_owned_elements().nth_index_in_set(0);
+          for (unsigned int i=0; i<block.local_size(); ++i)
+            block.local_element(i) = (i+first_local_range)%11;
+          block_offset += block.size();
+        }
+
+      const Number mean_value = vector.mean_value();
+      for (unsigned int b=0; b<vector.n_blocks(); ++b)
+        vector.block(b).add(-mean_value);
+    }
+
+#ifdef DEAL_II_WITH_CUDA
+    template <typename Number>
+    void set_initial_guess(::dealii::LinearAlgebra::CUDAWrappers::Vector<Number> &vector)
+    {
+      // Same initial guess as for the deal.II vectors, set up on the host and
+      // copied to the device
+      LinearAlgebra::ReadWriteVector<Number> host_vector(vector.size());
+      for (unsigned int i=0; i<vector.size(); ++i)
+        host_vector[i] = i%11;
+      vector.import(host_vector, VectorOperation::insert);
+
+      const Number mean_value = vector.mean_value();
+      vector.add(-mean_value);
+    }
+#endif
+
     struct EigenvalueTracker
     {
     public:
@@ -1970,14 +2261,18 @@ AdditionalData (const unsigned int degree,
                 const bool         nonzero_starting,
                 const unsigned int eig_cg_n_iterations,
                 const double       eig_cg_residual,
-                const double       max_eigenvalue)
+                const double       max_eigenvalue,
+                const bool         reuse_eigenvalue_estimate,
+                const double       eigenvalue_drift_tolerance)
   :
   degree  (degree),
   smoothing_range (smoothing_range),
   nonzero_starting (nonzero_starting),
   eig_cg_n_iterations (eig_cg_n_iterations),
   eig_cg_residual (eig_cg_residual),
-  max_eigenvalue (max_eigenvalue)
+  max_eigenvalue (max_eigenvalue),
+  reuse_eigenvalue_estimate (reuse_eigenvalue_estimate),
+  eigenvalue_drift_tolerance (eigenvalue_drift_tolerance)
 {}
 
 DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
@@ -1987,9 +2282,13 @@ template <typename MatrixType, typename VectorType, typename PreconditionerType>
 inline
 PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::PreconditionChebyshev ()
   :
-  theta                       (1.),
-  delta                       (1.),
-  eigenvalues_are_initialized (false)
+  theta                          (1.),
+  delta                          (1.),
+  eigenvalues_are_initialized    (false),
+  max_eigenvalue_estimate        (0.),
+  min_eigenvalue_estimate        (0.),
+  probe_eigenvalue               (0.),
+  eigenvalues_are_reused         (false)
 {
   static_assert(
     std::is_same<size_type, typename VectorType::size_type>::value,
@@ -2007,12 +2306,33 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::initialize
 (const MatrixType     &matrix,
  const AdditionalData &additional_data)
 {
+  // keep the eigenvalue estimate of the previous matrix if requested and
+  // possible, i.e., if an estimate from the modified CG iteration exists and
+  // the new matrix has the same size
+  const bool reuse_eigenvalues = additional_data.reuse_eigenvalue_estimate &&
+                                 additional_data.eig_cg_n_iterations > 0 &&
+                                 data.eig_cg_n_iterations > 0 &&
+                                 max_eigenvalue_estimate > 0. &&
+                                 matrix_ptr != nullptr &&
+                                 matrix_ptr->m() == matrix.m();
+
   matrix_ptr = &matrix;
   data = additional_data;
   internal::PreconditionChebyshev::initialize_preconditioner(matrix,
                                                              data.preconditioner,
                                                              data.matrix_diagonal_inverse);
-  eigenvalues_are_initialized = false;
+  if (reuse_eigenvalues)
+    {
+      compute_chebyshev_parameters(max_eigenvalue_estimate,
+                                   min_eigenvalue_estimate);
+      eigenvalues_are_reused = true;
+    }
+  else
+    {
+      eigenvalues_are_initialized = false;
+      eigenvalues_are_reused = false;
+      max_eigenvalue_estimate = min_eigenvalue_estimate = probe_eigenvalue = 0.;
+    }
 }
 
 
@@ -2023,7 +2343,9 @@ void
 PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::clear ()
 {
   eigenvalues_are_initialized = false;
+  eigenvalues_are_reused = false;
   theta = delta = 1.0;
+  max_eigenvalue_estimate = min_eigenvalue_estimate = probe_eigenvalue = 0.;
   matrix_ptr = nullptr;
   {
     VectorType empty_vector;
@@ -2094,6 +2416,15 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::estimate_eigenv
           // be converged
           max_eigenvalue = 1.2*eigenvalue_tracker.values.back();
         }
+
+      // record the estimate for later reuse, together with the reference
+      // value for the drift check
+      PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> &self =
+        const_cast<PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> &>(*this);
+      self.max_eigenvalue_estimate = max_eigenvalue;
+      self.min_eigenvalue_estimate = min_eigenvalue;
+      if (data.reuse_eigenvalue_estimate && data.eigenvalue_drift_tolerance > 0.)
+        self.probe_eigenvalue = compute_probe_eigenvalue();
     }
   else
     {
@@ -2101,6 +2432,34 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::estimate_eigenv
       min_eigenvalue = data.max_eigenvalue/data.smoothing_range;
     }
 
+  compute_chebyshev_parameters(max_eigenvalue, min_eigenvalue);
+
+  // We do not need the third auxiliary vector in case we have a
+  // DiagonalMatrix as preconditioner and use deal.II's own vectors
+  if (std::is_same<PreconditionerType,DiagonalMatrix<VectorType> >::value == false ||
+      (std::is_same<VectorType,dealii::Vector<typename VectorType::value_type> >::value == false
+       &&
+       std::is_same<VectorType,LinearAlgebra::distributed::Vector<typename VectorType::value_type> >::value == false
+       &&
+       std::is_same<VectorType,LinearAlgebra::distributed::BlockVector<typename VectorType::value_type> >::value == false
+      ))
+    update3.reinit (src, true);
+
+  const_cast<PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> *>(this)->eigenvalues_are_initialized = true;
+}
+
+
+
+template <typename MatrixType, typename VectorType, typename PreconditionerType>
+inline
+void
+PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::compute_chebyshev_parameters
+(const double max_eigenvalue,
+ const double min_eigenvalue) const
+{
+  PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> &self =
+    const_cast<PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> &>(*this);
+
   const double alpha = (data.smoothing_range > 1. ?
                         max_eigenvalue / data.smoothing_range :
                         std::min(0.9*max_eigenvalue, min_eigenvalue));
@@ -2115,23 +2474,59 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::estimate_eigenv
       const double actual_range = max_eigenvalue / alpha;
       const double sigma = (1.-std::sqrt(1./actual_range))/(1.+std::sqrt(1./actual_range));
       const double eps = data.smoothing_range;
-      const_cast<PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> *>(this)->data.degree
-        = 1+std::log(1./eps+std::sqrt(1./eps/eps-1))/std::log(1./sigma);
+      self.data.degree = 1+std::log(1./eps+std::sqrt(1./eps/eps-1))/std::log(1./sigma);
     }
 
-  const_cast<PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> *>(this)->delta = (max_eigenvalue-alpha)*0.5;
-  const_cast<PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> *>(this)->theta = (max_eigenvalue+alpha)*0.5;
+  self.delta = (max_eigenvalue-alpha)*0.5;
+  self.theta = (max_eigenvalue+alpha)*0.5;
+}
 
-  // We do not need the third auxiliary vector in case we have a
-  // DiagonalMatrix as preconditioner and use deal.II's own vectors
-  if (std::is_same<PreconditionerType,DiagonalMatrix<VectorType> >::value == false ||
-      (std::is_same<VectorType,dealii::Vector<typename VectorType::value_type> >::value == false
-       &&
-       std::is_same<VectorType,LinearAlgebra::distributed::Vector<typename VectorType::value_type> >::value == false
-      ))
-    update3.reinit (src, true);
 
-  const_cast<PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> *>(this)->eigenvalues_are_initialized = true;
+
+template <typename MatrixType, typename VectorType, typename PreconditionerType>
+inline
+double
+PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::compute_probe_eigenvalue () const
+{
+  // use the same vector as for the initial guess of the eigenvalue
+  // estimation, which contains high frequencies, and run one step of the
+  // power iteration
+  internal::PreconditionChebyshev::set_initial_guess(update2);
+  const double probe_norm = update2.l2_norm();
+  matrix_ptr->vmult(update1, update2);
+  data.preconditioner->vmult(update2, update1);
+  return probe_norm > 0. ? update2.l2_norm() / probe_norm : 0.;
+}
+
+
+
+template <typename MatrixType, typename VectorType, typename PreconditionerType>
+inline
+void
+PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>::check_eigenvalue_drift
+(const VectorType &src) const
+{
+  Assert(eigenvalues_are_initialized == true, ExcInternalError());
+  PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> &self =
+    const_cast<PreconditionChebyshev<MatrixType,VectorType,PreconditionerType> &>(*this);
+  self.eigenvalues_are_reused = false;
+
+  // the vectors might have a different layout if the matrix has changed
+  update1.reinit(src, true);
+  update2.reinit(src, true);
+  if (update3.size() > 0)
+    update3.reinit(src, true);
+
+  if (data.eigenvalue_drift_tolerance > 0.)
+    {
+      const double new_probe_eigenvalue = compute_probe_eigenvalue();
+      if (std::abs(new_probe_eigenvalue - probe_eigenvalue) >
+          data.eigenvalue_drift_tolerance * probe_eigenvalue)
+        {
+          self.eigenvalues_are_initialized = false;
+          estimate_eigenvalues(src);
+        }
+    }
 }
 
 
@@ -2151,12 +2546,12 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>
   double rhok  = delta / theta,  sigma = theta / delta;
   for (unsigned int k=0; k<data.degree; ++k)
     {
-      matrix_ptr->vmult (update2, dst);
       const double rhokp = 1./(2.*sigma-rhok);
       const double factor1 = rhokp * rhok, factor2 = 2.*rhokp/delta;
       rhok = rhokp;
-      internal::PreconditionChebyshev::vector_updates
-      (src, *data.preconditioner, false, factor1, factor2, update1, update2, update3, dst);
+      internal::PreconditionChebyshev::vmult_and_vector_updates
+      (*matrix_ptr, src, *data.preconditioner, factor1, factor2, update1, update2,
+       update3, dst);
     }
 }
 
@@ -2193,7 +2588,10 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>
   Threads::Mutex::ScopedLock lock(mutex);
   if (eigenvalues_are_initialized == false)
     estimate_eigenvalues(src);
+  else if (eigenvalues_are_reused)
+    check_eigenvalue_drift(src);
 
+  const PerformanceCounters::Region counter_region("PreconditionChebyshev::vmult");
   internal::PreconditionChebyshev::vector_updates
   (src, *data.preconditioner, true, 0., 1./theta, update1, update2, update3, dst);
 
@@ -2212,6 +2610,8 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>
   Threads::Mutex::ScopedLock lock(mutex);
   if (eigenvalues_are_initialized == false)
     estimate_eigenvalues(src);
+  else if (eigenvalues_are_reused)
+    check_eigenvalue_drift(src);
 
   internal::PreconditionChebyshev::vector_updates
   (src, *data.preconditioner, true, 0., 1./theta, update1, update2, update3, dst);
@@ -2231,10 +2631,12 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>
   Threads::Mutex::ScopedLock lock(mutex);
   if (eigenvalues_are_initialized == false)
     estimate_eigenvalues(src);
+  else if (eigenvalues_are_reused)
+    check_eigenvalue_drift(src);
 
-  matrix_ptr->vmult (update2, dst);
-  internal::PreconditionChebyshev::vector_updates
-  (src, *data.preconditioner, false, 0., 1./theta, update1, update2, update3, dst);
+  internal::PreconditionChebyshev::vmult_and_vector_updates
+  (*matrix_ptr, src, *data.preconditioner, 0., 1./theta, update1, update2,
+   update3, dst);
 
   do_chebyshev_loop(dst, src);
 }
@@ -2251,6 +2653,8 @@ PreconditionChebyshev<MatrixType,VectorType,PreconditionerType>
   Threads::Mutex::ScopedLock lock(mutex);
   if (eigenvalues_are_initialized == false)
     estimate_eigenvalues(src);
+  else if (eigenvalues_are_reused)
+    check_eigenvalue_drift(src);
 
   matrix_ptr->Tvmult (update2, dst);
   internal::PreconditionChebyshev::vector_updates
@@ -0,0 +1,427 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_precondition_amg_h
+#define dealii_precondition_amg_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#ifdef DEAL_II_WITH_LAPACK
+#  include <deal.II/lac/lapack_full_matrix.h>
+#endif
+
+#include <memory>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*! @addtogroup Preconditioners
+ *@{
+ */
+
+/**
+ * An algebraic multigrid (AMG) preconditioner based on smoothed aggregation
+ * for a dealii::SparseMatrix, which does not need any external library. The
+ * interface follows TrilinosWrappers::PreconditionAMG, so that programs can
+ * switch between the two implementations.
+ *
+ * <h3>Setup</h3>
+ *
+ * The hierarchy of levels is built from the matrix alone in initialize(). On
+ * each level, the degrees of freedom are grouped into aggregates of strongly
+ * coupled unknowns, where the entry $a_{ij}$ couples strongly if $|a_{ij}|
+ * \geq \theta \sqrt{|a_{ii} a_{jj}|}$ with the threshold $\theta$ given by
+ * AdditionalData::aggregation_threshold. Rows without strong off-diagonal
+ * entries, like the rows of constrained degrees of freedom, are not
+ * aggregated and only treated by the smoother. The vectors of the near null
+ * space are restricted to each aggregate and orthonormalized, which gives
+ * the tentative prolongator from the coarse unknowns of the aggregate, and
+ * the restriction of the near null space to the next level. The tentative
+ * prolongator is then smoothed by one step of a damped Jacobi method,
+ * $P=(I-\frac{4}{3\lambda}D^{-1}A)P_0$ with an upper bound $\lambda$ of the
+ * spectrum of $D^{-1}A$, and the matrix of the next level is computed by
+ * the Galerkin product $P^TAP$. The coarsening stops when the size of a
+ * level falls below AdditionalData::coarse_size, when the number of levels
+ * reaches AdditionalData::max_levels, or when the coarsening stagnates.
+ *
+ * The near null space consists of the constant function for scalar
+ * equations. For systems, it is given by AdditionalData::constant_modes,
+ * one constant mode for each component as returned by
+ * DoFTools::extract_constant_modes(), and possibly additional vectors in
+ * AdditionalData::near_null_space. For linear elasticity, these are the
+ * rigid body rotations, which can be computed from the support points of
+ * the degrees of freedom as returned by
+ * DoFTools::map_dofs_to_support_points(). If an aggregate contains too few
+ * unknowns to represent all vectors of the near null space, it gets as many
+ * coarse unknowns as there are linearly independent vectors restricted to
+ * it.
+ *
+ * The computation of the strong couplings, the aggregation, the tentative
+ * and smoothed prolongators and the Galerkin product are distributed among
+ * the available threads, see MultithreadInfo. For the aggregation, the rows
+ * are split into a fixed number of consecutive chunks that are aggregated
+ * independently, which makes the hierarchy independent of the number of
+ * threads.
+ *
+ * <h3>Cycle</h3>
+ *
+ * The preconditioner applies AdditionalData::n_cycles V-cycles. On each
+ * level, PreconditionChebyshev around the diagonal of the level matrix is
+ * used for the pre- and post-smoothing, with AdditionalData::smoother_sweeps
+ * as the degree of the polynomial. The coarsest level is solved with a
+ * direct method if it is not larger than AdditionalData::coarse_size, using
+ * the pseudo-inverse computed by LAPACK if deal.II is configured with LAPACK
+ * in order to allow for singular matrices, e.g. for pure Neumann problems.
+ * Otherwise, it is only smoothed. Since the pre- and post-smoothing are the
+ * same and the restriction is the transpose of the prolongation, the
+ * preconditioner is symmetric for symmetric matrices and can be used with
+ * SolverCG. The matrix-vector products and the vector operations of the
+ * cycle are run in parallel by the threads, too.
+ *
+ * The class is intended for symmetric positive definite matrices, as
+ * arising from elliptic problems. For nonsymmetric matrices, the Chebyshev
+ * smoother is not guaranteed to work.
+ */
+class PreconditionAMG : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * A data structure that is used to control details of how the algebraic
+   * multigrid is set up.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor. By default, we pretend to work on a scalar elliptic
+     * problem.
+     */
+    AdditionalData (const unsigned int                     n_cycles = 1,
+                    const double                           aggregation_threshold = 1e-4,
+                    const std::vector<std::vector<bool> > &constant_modes = std::vector<std::vector<bool> > (0),
+                    const std::vector<Vector<double> >    &near_null_space = std::vector<Vector<double> > (0),
+                    const unsigned int                     smoother_sweeps = 2,
+                    const double                           smoothing_range = 20.,
+                    const unsigned int                     coarse_size = 500,
+                    const unsigned int                     max_levels = 20);
+
+    /**
+     * Defines how many V-cycles should be performed by the preconditioner.
+     */
+    unsigned int n_cycles;
+
+    /**
+     * This threshold tells the AMG setup how the coarsening should be
+     * performed. All points that strongly couple with a point are grouped
+     * into one aggregate, where the entry $a_{ij}$ couples strongly if its
+     * magnitude is not smaller than <tt>aggregation_threshold</tt> times
+     * $\sqrt{|a_{ii} a_{jj}|}$.
+     */
+    double aggregation_threshold;
+
+    /**
+     * Specifies the constant modes of the matrix, in the format returned by
+     * DoFTools::extract_constant_modes(): For each component, a vector of
+     * the size of the matrix that is <tt>true</tt> for the degrees of
+     * freedom of this component. Each component contributes the vector
+     * that is one on these degrees of freedom to the near null space. If
+     * both this field and #near_null_space are empty, the near null space
+     * consists of the vector of all ones, which is suitable for scalar
+     * equations.
+     */
+    std::vector<std::vector<bool> > constant_modes;
+
+    /**
+     * Additional vectors of the near null space of the matrix, like the
+     * rigid body rotations in linear elasticity, which are appended to the
+     * vectors given by #constant_modes. The vectors need to be of the size
+     * of the matrix.
+     */
+    std::vector<Vector<double> > near_null_space;
+
+    /**
+     * The degree of the Chebyshev polynomial used for pre- and
+     * post-smoothing on each level, i.e., the number of matrix-vector
+     * products per smoothing step.
+     */
+    unsigned int smoother_sweeps;
+
+    /**
+     * The range of the eigenvalues of the diagonally preconditioned level
+     * matrices that is treated by the Chebyshev smoother, see
+     * PreconditionChebyshev::AdditionalData::smoothing_range.
+     */
+    double smoothing_range;
+
+    /**
+     * The coarsening stops once a level has at most this number of
+     * unknowns, and a level of at most this size is solved with a direct
+     * method.
+     */
+    unsigned int coarse_size;
+
+    /**
+     * The maximal number of levels of the hierarchy, including the level of
+     * the given matrix.
+     */
+    unsigned int max_levels;
+  };
+
+  /**
+   * Constructor. Does not do anything.
+   */
+  PreconditionAMG ();
+
+  /**
+   * Destructor.
+   */
+  ~PreconditionAMG ();
+
+  /**
+   * Compute the multilevel hierarchy for the given matrix. The matrix must
+   * be square and is used for the smoothing on the finest level, so it must
+   * persist as long as this object is used.
+   */
+  void initialize (const SparseMatrix<double> &matrix,
+                   const AdditionalData       &additional_data = AdditionalData());
+
+  /**
+   * Destroy the hierarchy, leaving an object like just after having called
+   * the constructor.
+   */
+  void clear ();
+
+  /**
+   * Apply the preconditioner, i.e., AdditionalData::n_cycles V-cycles with
+   * zero starting value for the right hand side @p src.
+   */
+  void vmult (Vector<double>       &dst,
+              const Vector<double> &src) const;
+
+  /**
+   * Apply the transpose preconditioner. As the preconditioner is symmetric
+   * for symmetric matrices, this is the same as vmult().
+   */
+  void Tvmult (Vector<double>       &dst,
+               const Vector<double> &src) const;
+
+  /**
+   * Return the dimension of the codomain (or range) space. Note that the
+   * matrix is of dimension $m \times n$.
+   */
+  size_type m () const;
+
+  /**
+   * Return the dimension of the domain space. Note that the matrix is of
+   * dimension $m \times n$.
+   */
+  size_type n () const;
+
+  /**
+   * Return the number of levels of the hierarchy, including the level of
+   * the given matrix.
+   */
+  unsigned int n_levels () const;
+
+  /**
+   * Return the matrix on the given level, with level zero being the matrix
+   * passed to initialize().
+   */
+  const SparseMatrix<double> &get_level_matrix (const unsigned int level) const;
+
+  /**
+   * Return an estimate of the memory consumption of the hierarchy in bytes,
+   * not including the matrix passed to initialize().
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The data of one level of the hierarchy.
+   */
+  struct Level
+  {
+    /**
+     * The sparsity pattern of #matrix.
+     */
+    SparsityPattern sparsity;
+
+    /**
+     * The Galerkin matrix of this level. Empty on level zero, where the
+     * matrix passed to initialize() is used.
+     */
+    SparseMatrix<double> matrix;
+
+    /**
+     * The matrix of this level, pointing either to #matrix or to the matrix
+     * passed to initialize().
+     */
+    SmartPointer<const SparseMatrix<double>,PreconditionAMG> level_matrix;
+
+    /**
+     * The sparsity pattern of #prolongation.
+     */
+    SparsityPattern prolongation_sparsity;
+
+    /**
+     * The prolongation from the next coarser level to this level, with as
+     * many rows as this level has unknowns. Empty on the coarsest level.
+     */
+    SparseMatrix<double> prolongation;
+
+    /**
+     * The sparsity pattern of #restriction.
+     */
+    SparsityPattern restriction_sparsity;
+
+    /**
+     * The transpose of #prolongation, stored explicitly in order to run the
+     * restriction in parallel.
+     */
+    SparseMatrix<double> restriction;
+
+    /**
+     * The smoother of this level.
+     */
+    PreconditionChebyshev<SparseMatrix<double>,Vector<double> > smoother;
+
+    /**
+     * The right hand side of the cycle on this level, restricted from the
+     * next finer level. Unused on level zero.
+     */
+    mutable Vector<double> rhs;
+
+    /**
+     * The solution of the cycle on this level. Unused on level zero.
+     */
+    mutable Vector<double> solution;
+
+    /**
+     * The residual on this level that is restricted to the next coarser
+     * level.
+     */
+    mutable Vector<double> residual;
+  };
+
+  /**
+   * Run one V-cycle on the given level with zero starting value.
+   */
+  void v_cycle (const unsigned int    level,
+                Vector<double>       &dst,
+                const Vector<double> &src) const;
+
+  /**
+   * The levels of the hierarchy, from fine to coarse.
+   */
+  std::vector<std::unique_ptr<Level> > levels;
+
+  /**
+   * Whether the coarsest level is solved with a direct method.
+   */
+  bool coarse_solve_is_direct;
+
+#ifdef DEAL_II_WITH_LAPACK
+  /**
+   * The pseudo-inverse of the matrix on the coarsest level.
+   */
+  LAPACKFullMatrix<double> coarse_inverse;
+#else
+  /**
+   * The inverse of the matrix on the coarsest level.
+   */
+  FullMatrix<double> coarse_inverse;
+#endif
+
+  /**
+   * The number of V-cycles applied in vmult().
+   */
+  unsigned int n_cycles;
+
+  /**
+   * Temporary vectors for vmult() with more than one cycle.
+   */
+  mutable Vector<double> residual;
+  mutable Vector<double> correction;
+
+  /**
+   * A mutex to avoid that multiple vmult() invocations by different threads
+   * overwrite the temporary vectors.
+   */
+  mutable Threads::Mutex mutex;
+};
+
+/*@}*/
+
+
+/* ---------------------------------- Inline functions ------------------- */
+
+#ifndef DOXYGEN
+
+inline
+PreconditionAMG::size_type
+PreconditionAMG::m () const
+{
+  Assert (levels.size() > 0, ExcNotInitialized());
+  return levels[0]->level_matrix->m();
+}
+
+
+
+inline
+PreconditionAMG::size_type
+PreconditionAMG::n () const
+{
+  Assert (levels.size() > 0, ExcNotInitialized());
+  return levels[0]->level_matrix->n();
+}
+
+
+
+inline
+unsigned int
+PreconditionAMG::n_levels () const
+{
+  return levels.size();
+}
+
+
+
+inline
+const SparseMatrix<double> &
+PreconditionAMG::get_level_matrix (const unsigned int level) const
+{
+  AssertIndexRange (level, levels.size());
+  return *levels[level]->level_matrix;
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2016 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -63,6 +63,11 @@ DEAL_II_NAMESPACE_OPEN
  * has blocks each of the same block size. Varying block sizes within the
  * matrix must still be implemented if needed.
  *
+ * Instantiations are provided for SparseMatrix and ChunkSparseMatrix. For
+ * the latter, choosing the chunk size as block size relaxes the chunks on
+ * the diagonal, e.g. the components of each node of a vector-valued
+ * problem, together.
+ *
  * The first template parameter denotes the type of number representation in
  * the sparse matrix, the second denotes the type of number representation in
  * which the inverted diagonal block matrices are stored within this class by
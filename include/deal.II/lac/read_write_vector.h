@@ -32,6 +32,8 @@
 #ifdef DEAL_II_WITH_TRILINOS
 #  include <deal.II/lac/trilinos_epetra_communication_pattern.h>
 #  include <deal.II/lac/trilinos_epetra_vector.h>
+#  include <deal.II/lac/trilinos_tpetra_communication_pattern.h>
+#  include <deal.II/lac/trilinos_tpetra_vector.h>
 
 DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 #  include <Epetra_MultiVector.h>
@@ -280,6 +282,13 @@ namespace LinearAlgebra
      * current vector or replace the current elements. The last parameter can
      * be used if the same communication pattern is used multiple times. This
      * can be used to improve performance.
+     *
+     * If no communication pattern is given, the Utilities::MPI::Partitioner
+     * describing the exchange is stored and reused by subsequent imports
+     * from vectors with the same locally owned elements, until the stored
+     * elements of this vector are changed by reinit(). The locally owned
+     * entries of @p vec are read directly from its memory, and only the
+     * entries owned by other processors are communicated.
      */
     void import(const distributed::Vector<Number> &vec,
                 VectorOperation::values operation,
@@ -330,6 +339,22 @@ namespace LinearAlgebra
                 VectorOperation::values operation,
                 std::shared_ptr<const CommunicationPatternBase> communication_pattern =
                   std::shared_ptr<const CommunicationPatternBase> ());
+
+#ifdef DEAL_II_TRILINOS_WITH_TPETRA
+    /**
+     * Imports all the elements present in the vector's IndexSet from the input
+     * vector @p tpetra_vec. VectorOperation::values @p operation is used to
+     * decide if the elements in @p V should be added to the current vector or
+     * replace the current elements. The last parameter can be used if the same
+     * communication pattern is used multiple times, in which case it must be
+     * of type TpetraWrappers::CommunicationPattern. This can be used to
+     * improve performance.
+     */
+    void import(const TpetraWrappers::Vector<double> &tpetra_vec,
+                VectorOperation::values operation,
+                std::shared_ptr<const CommunicationPatternBase> communication_pattern =
+                  std::shared_ptr<const CommunicationPatternBase> ());
+#endif
 #endif
 #endif
 
@@ -588,11 +613,21 @@ namespace LinearAlgebra
      * Return a EpetraWrappers::Communication pattern and store it for future
      * use.
      */
-    EpetraWrappers::CommunicationPattern
+    std::shared_ptr<const EpetraWrappers::CommunicationPattern>
     create_epetra_comm_pattern(const IndexSet &source_index_set,
                                const MPI_Comm &mpi_comm);
 #endif
 
+#if defined(DEAL_II_TRILINOS_WITH_TPETRA) && defined(DEAL_II_WITH_MPI)
+    /**
+     * Return a TpetraWrappers::CommunicationPattern and store it for future
+     * use.
+     */
+    std::shared_ptr<const TpetraWrappers::CommunicationPattern>
+    create_tpetra_comm_pattern(const IndexSet &source_index_set,
+                               const MPI_Comm &mpi_comm);
+#endif
+
     /**
      * Indices of the elements stored.
      */
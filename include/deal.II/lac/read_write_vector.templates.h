@@ -18,6 +18,7 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/array_view.h>
 #include <deal.II/base/partitioner.h>
 
 #include <deal.II/lac/exceptions.h>
@@ -27,6 +28,8 @@
 
 #include <boost/io/ios_state.hpp>
 
+#include <type_traits>
+
 #ifdef DEAL_II_WITH_PETSC
 #  include <deal.II/lac/petsc_parallel_vector.h>
 #endif
@@ -35,8 +38,11 @@
 #  include <deal.II/lac/trilinos_vector.h>
 #  include <deal.II/lac/trilinos_epetra_vector.h>
 #  include <deal.II/lac/trilinos_epetra_communication_pattern.h>
+#  include <deal.II/lac/trilinos_tpetra_vector.h>
+#  include <deal.II/lac/trilinos_tpetra_communication_pattern.h>
 DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 #  include <Epetra_Import.h>
+#  include <Epetra_Vector.h>
 DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 #endif
 
@@ -238,35 +244,76 @@ namespace LinearAlgebra
                                   VectorOperation::values operation,
                                   const std::shared_ptr<const CommunicationPatternBase> &communication_pattern)
   {
-    // If no communication pattern is given, create one. Otherwise, use the
-    // given one.
-    std::shared_ptr<const Utilities::MPI::Partitioner> comm_pattern;
+    // If no communication pattern is given, reuse the one from the last
+    // import if the source vector has the same layout, or create a new one
+    // and store it for future use. Since the pattern is reset whenever the
+    // stored elements of this vector change, matching source elements
+    // identify the pattern. Otherwise, use the given one.
+    std::shared_ptr<const Utilities::MPI::Partitioner> partitioner;
     if (communication_pattern.get() == nullptr)
       {
-        comm_pattern.reset(new Utilities::MPI::Partitioner(vec.locally_owned_elements(),
-                                                           get_stored_elements(),
-                                                           vec.get_mpi_communicator()));
+        const IndexSet source_elements = vec.locally_owned_elements();
+        if ((source_elements.size() == source_stored_elements.size()) &&
+            (source_elements == source_stored_elements))
+          partitioner =
+            std::dynamic_pointer_cast<const Utilities::MPI::Partitioner> (comm_pattern);
+        if (partitioner == nullptr)
+          {
+            std::shared_ptr<Utilities::MPI::Partitioner> new_partitioner
+              = std::make_shared<Utilities::MPI::Partitioner>(source_elements,
+                                                              get_stored_elements(),
+                                                              vec.get_mpi_communicator());
+            source_stored_elements = source_elements;
+            comm_pattern = new_partitioner;
+            partitioner = new_partitioner;
+          }
       }
     else
       {
-        comm_pattern =
+        partitioner =
           std::dynamic_pointer_cast<const Utilities::MPI::Partitioner> (communication_pattern);
-        AssertThrow(comm_pattern != nullptr,
+        AssertThrow(partitioner != nullptr,
                     ExcMessage("The communication pattern is not of type "
                                "Utilities::MPI::Partitioner."));
       }
-    distributed::Vector<Number> tmp_vector(comm_pattern);
-
-    std::copy(vec.begin(), vec.end(), tmp_vector.begin());
-    tmp_vector.update_ghost_values();
+    AssertDimension (partitioner->local_size(), vec.local_size());
+
+    // Only the entries that are stored here but owned by other processors
+    // need to be communicated. The locally owned entries are read directly
+    // from the source vector, without a temporary copy. If the calling
+    // processor neither sends nor receives data, the communication can be
+    // skipped altogether because no other processor expects messages from
+    // it.
+    std::vector<Number> ghost_values (partitioner->n_ghost_indices());
+#ifdef DEAL_II_WITH_MPI
+    if (partitioner->n_ghost_indices() > 0 || partitioner->n_import_indices() > 0)
+      {
+        std::vector<Number> temporary_storage (partitioner->n_import_indices());
+        std::vector<MPI_Request> requests;
+        partitioner->export_to_ghosted_array_start
+        (0, ArrayView<const Number>(vec.begin(), partitioner->local_size()),
+         make_array_view(temporary_storage), make_array_view(ghost_values),
+         requests);
+        partitioner->export_to_ghosted_array_finish (make_array_view(ghost_values),
+                                                     requests);
+      }
+#endif
 
-    const IndexSet &stored = get_stored_elements();
-    if (operation == VectorOperation::add)
-      for (size_type i=0; i<stored.n_elements(); ++i)
-        local_element(i) += tmp_vector(stored.nth_index_in_set(i));
-    else
-      for (size_type i=0; i<stored.n_elements(); ++i)
-        local_element(i) = tmp_vector(stored.nth_index_in_set(i));
+    const size_type first_owned = partitioner->local_range().first;
+    const size_type end_owned = partitioner->local_range().second;
+    const unsigned int local_size = partitioner->local_size();
+    size_type i = 0;
+    for (const auto index : stored_elements)
+      {
+        const Number value = (index >= first_owned && index < end_owned) ?
+                             vec.local_element(index-first_owned) :
+                             ghost_values[partitioner->global_to_local(index)-local_size];
+        if (operation == VectorOperation::add)
+          val[i] += value;
+        else
+          val[i] = value;
+        ++i;
+      }
   }
 
 
@@ -351,12 +398,10 @@ namespace LinearAlgebra
             epetra_comm_pattern =
               std::dynamic_pointer_cast<const EpetraWrappers::CommunicationPattern> (comm_pattern);
             if (epetra_comm_pattern == nullptr)
-              epetra_comm_pattern = std::make_shared<const EpetraWrappers::CommunicationPattern>(
-                                      create_epetra_comm_pattern(source_elements, mpi_comm));
+              epetra_comm_pattern = create_epetra_comm_pattern(source_elements, mpi_comm);
           }
         else
-          epetra_comm_pattern = std::make_shared<const EpetraWrappers::CommunicationPattern>(
-                                  create_epetra_comm_pattern(source_elements, mpi_comm));
+          epetra_comm_pattern = create_epetra_comm_pattern(source_elements, mpi_comm);
       }
     else
       {
@@ -367,7 +412,19 @@ namespace LinearAlgebra
                                "LinearAlgebra::EpetraWrappers::CommunicationPattern."));
       }
 
-    Epetra_Import import(epetra_comm_pattern->get_epetra_import());
+    const Epetra_Import &import = epetra_comm_pattern->get_epetra_import();
+
+    // In case we overwrite the entries and store the same number type as
+    // Epetra, let Epetra write into our memory directly.
+    if (operation==VectorOperation::insert && std::is_same<Number,double>::value)
+      {
+        Epetra_Vector target_view(View, import.TargetMap(),
+                                  reinterpret_cast<double *>(val));
+        const int err = target_view.Import(multivector, import, Insert);
+        AssertThrow(err == 0, ExcMessage("Epetra Import() failed with error code: "
+                                         + Utilities::to_string(err)));
+        return;
+      }
 
     Epetra_FEVector target_vector(import.TargetMap());
 
@@ -428,6 +485,73 @@ namespace LinearAlgebra
     import(trilinos_vec.trilinos_vector(), trilinos_vec.locally_owned_elements(),
            operation, trilinos_vec.get_mpi_communicator(), communication_pattern);
   }
+
+
+
+#ifdef DEAL_II_TRILINOS_WITH_TPETRA
+  template <typename Number>
+  void
+  ReadWriteVector<Number>::import(const LinearAlgebra::TpetraWrappers::Vector<double> &tpetra_vec,
+                                  VectorOperation::values                              operation,
+                                  std::shared_ptr<const CommunicationPatternBase>      communication_pattern)
+  {
+    std::shared_ptr<const TpetraWrappers::CommunicationPattern> tpetra_comm_pattern;
+
+    // If no communication pattern is given, create one. Otherwise, use the one
+    // given.
+    if (communication_pattern == nullptr)
+      {
+        // The first time import is called, we create a communication pattern.
+        // Check if the communication pattern already exists and if it can be
+        // reused.
+        const IndexSet source_elements = tpetra_vec.locally_owned_elements();
+        if ((source_elements.size() == source_stored_elements.size()) &&
+            (source_elements == source_stored_elements))
+          {
+            tpetra_comm_pattern =
+              std::dynamic_pointer_cast<const TpetraWrappers::CommunicationPattern> (comm_pattern);
+            if (tpetra_comm_pattern == nullptr)
+              tpetra_comm_pattern = create_tpetra_comm_pattern(source_elements,
+                                                               tpetra_vec.get_mpi_communicator());
+          }
+        else
+          tpetra_comm_pattern = create_tpetra_comm_pattern(source_elements,
+                                                           tpetra_vec.get_mpi_communicator());
+      }
+    else
+      {
+        tpetra_comm_pattern = std::dynamic_pointer_cast<const TpetraWrappers::CommunicationPattern> (
+                                communication_pattern);
+        AssertThrow(tpetra_comm_pattern != nullptr,
+                    ExcMessage(std::string("The communication pattern is not of type ") +
+                               "LinearAlgebra::TpetraWrappers::CommunicationPattern."));
+      }
+
+    const TpetraWrappers::ImportType &import = tpetra_comm_pattern->get_tpetra_import();
+
+    typename TpetraWrappers::Vector<double>::VectorType target_vector(import.getTargetMap());
+    target_vector.doImport(tpetra_vec.trilinos_vector(), import, Tpetra::REPLACE);
+
+    // copy the data from the memory space Tpetra works on to the host
+    target_vector.template sync<Kokkos::HostSpace>();
+    auto values_2d = target_vector.template getLocalView<Kokkos::HostSpace>();
+    auto values = Kokkos::subview(values_2d, Kokkos::ALL(), 0);
+    const size_t size = target_vector.getLocalLength();
+
+    if (operation==VectorOperation::insert)
+      {
+        for (size_t i=0; i<size; ++i)
+          val[i] = values(i);
+      }
+    else if (operation==VectorOperation::add)
+      {
+        for (size_t i=0; i<size; ++i)
+          val[i] += values(i);
+      }
+    else
+      AssertThrow(false, ExcNotImplemented());
+  }
+#endif
 #endif
 
 
@@ -519,19 +643,39 @@ namespace LinearAlgebra
 
 #if defined(DEAL_II_WITH_TRILINOS) && defined(DEAL_II_WITH_MPI)
   template <typename Number>
-  EpetraWrappers::CommunicationPattern
+  std::shared_ptr<const EpetraWrappers::CommunicationPattern>
   ReadWriteVector<Number>::create_epetra_comm_pattern(const IndexSet &source_index_set,
                                                       const MPI_Comm &mpi_comm)
   {
     source_stored_elements = source_index_set;
-    EpetraWrappers::CommunicationPattern epetra_comm_pattern(
-      source_stored_elements, stored_elements, mpi_comm);
-    comm_pattern.reset(new EpetraWrappers::CommunicationPattern(
-                         source_stored_elements, stored_elements, mpi_comm));
+    std::shared_ptr<EpetraWrappers::CommunicationPattern> epetra_comm_pattern
+      = std::make_shared<EpetraWrappers::CommunicationPattern>(source_stored_elements,
+                                                               stored_elements,
+                                                               mpi_comm);
+    comm_pattern = epetra_comm_pattern;
 
     return epetra_comm_pattern;
   }
 #endif
+
+
+
+#if defined(DEAL_II_TRILINOS_WITH_TPETRA) && defined(DEAL_II_WITH_MPI)
+  template <typename Number>
+  std::shared_ptr<const TpetraWrappers::CommunicationPattern>
+  ReadWriteVector<Number>::create_tpetra_comm_pattern(const IndexSet &source_index_set,
+                                                      const MPI_Comm &mpi_comm)
+  {
+    source_stored_elements = source_index_set;
+    std::shared_ptr<TpetraWrappers::CommunicationPattern> tpetra_comm_pattern
+      = std::make_shared<TpetraWrappers::CommunicationPattern>(source_stored_elements,
+                                                               stored_elements,
+                                                               mpi_comm);
+    comm_pattern = tpetra_comm_pattern;
+
+    return tpetra_comm_pattern;
+  }
+#endif
 } // end of namespace LinearAlgebra
 
 
@@ -0,0 +1,321 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_small_full_matrix_h
+#define dealii_small_full_matrix_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/lac/full_matrix.h>
+
+#include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*! @addtogroup Matrix1
+ *@{
+ */
+
+
+/**
+ * A dense matrix whose size is fixed at compile time and whose entries are
+ * stored inside the object, i.e., without any memory allocation. This class
+ * is intended for local assembly in cases where the number of degrees of
+ * freedom per cell is known when compiling the program, e.g. for a fixed
+ * polynomial degree: A <code>SmallFullMatrix<dofs_per_cell></code> can be
+ * created on the stack for every cell, and the compiler knows the loop
+ * bounds of all operations on it. Apart from the size, the access to the
+ * entries works as for FullMatrix, so an assembly loop only needs to change
+ * the declaration of the cell matrix:
+ * @code
+ *   const unsigned int dofs_per_cell = 9;
+ *   SmallFullMatrix<dofs_per_cell> cell_matrix;
+ *   std::array<double, dofs_per_cell> cell_rhs;
+ *
+ *   for (cell = ...)
+ *     {
+ *       fe_values.reinit (cell);
+ *       cell_matrix = 0;
+ *       ...
+ *             cell_matrix(i,j) += (fe_values.shape_grad(i,q) *
+ *                                  fe_values.shape_grad(j,q) *
+ *                                  fe_values.JxW(q));
+ *       ...
+ *       cell->get_dof_indices (local_dof_indices);
+ *       constraints.distribute_local_to_global (cell_matrix, cell_rhs,
+ *                                               local_dof_indices,
+ *                                               system_matrix, system_rhs);
+ *     }
+ * @endcode
+ * ConstraintMatrix::distribute_local_to_global() accepts objects of this
+ * class as well as FullMatrix objects and treats both in the same way. For
+ * the local vector, any contiguous container like <code>std::array</code>
+ * can be used.
+ *
+ * The entries are stored row by row in a plain array. Since objects of this
+ * class are usually placed on the stack, this class is only useful for
+ * matrices with up to a few thousand entries; larger matrices should use
+ * FullMatrix.
+ *
+ * @tparam n_rows The number of rows of the matrix.
+ * @tparam n_columns The number of columns of the matrix.
+ * @tparam Number The type of the matrix entries.
+ *
+ * @ingroup Matrix1
+ */
+template <int n_rows, int n_columns = n_rows, typename Number = double>
+class SmallFullMatrix
+{
+public:
+  static_assert (n_rows > 0 && n_columns > 0,
+                 "The matrix must have at least one row and one column");
+
+  /**
+   * Type of matrix entries.
+   */
+  typedef Number value_type;
+
+  /**
+   * Declare type for container size.
+   */
+  typedef unsigned int size_type;
+
+  /**
+   * Constructor. Initialize all entries to zero.
+   */
+  SmallFullMatrix ();
+
+  /**
+   * Assignment from a scalar. Like for FullMatrix, only the value zero is
+   * allowed, which sets all entries to zero.
+   */
+  SmallFullMatrix &operator = (const Number d);
+
+  /**
+   * Copy the entries of a FullMatrix of the same size into this object.
+   */
+  template <typename Number2>
+  SmallFullMatrix &operator = (const FullMatrix<Number2> &matrix);
+
+  /**
+   * Return the number of rows.
+   */
+  size_type m () const;
+
+  /**
+   * Return the number of columns.
+   */
+  size_type n () const;
+
+  /**
+   * Read-write access to the entry in row @p i and column @p j.
+   */
+  Number &operator() (const size_type i,
+                      const size_type j);
+
+  /**
+   * Read access to the entry in row @p i and column @p j.
+   */
+  const Number &operator() (const size_type i,
+                            const size_type j) const;
+
+  /**
+   * Return a pointer to the first entry. The entries are stored row by row.
+   */
+  Number *data ();
+
+  /**
+   * Return a pointer to the first entry for read access.
+   */
+  const Number *data () const;
+
+  /**
+   * Add another matrix of the same size.
+   */
+  SmallFullMatrix &operator += (const SmallFullMatrix &matrix);
+
+  /**
+   * Scale all entries by the given factor.
+   */
+  SmallFullMatrix &operator *= (const Number factor);
+
+  /**
+   * Copy the entries into the given FullMatrix, which is resized if
+   * necessary.
+   */
+  template <typename Number2>
+  void copy_to (FullMatrix<Number2> &matrix) const;
+
+private:
+  /**
+   * The entries of the matrix, stored row by row.
+   */
+  Number values[n_rows*n_columns];
+};
+
+/*@}*/
+
+
+#ifndef DOXYGEN
+/*----------------------- Inline functions ----------------------------------*/
+
+
+template <int n_rows, int n_columns, typename Number>
+inline
+SmallFullMatrix<n_rows,n_columns,Number>::SmallFullMatrix ()
+{
+  std::fill (values, values+n_rows*n_columns, Number());
+}
+
+
+
+template <int n_rows, int n_columns, typename Number>
+inline
+SmallFullMatrix<n_rows,n_columns,Number> &
+SmallFullMatrix<n_rows,n_columns,Number>::operator = (const Number d)
+{
+  Assert (d == Number(), ExcScalarAssignmentOnlyForZeroValue());
+  (void)d;
+  std::fill (values, values+n_rows*n_columns, Number());
+  return *this;
+}
+
+
+
+template <int n_rows, int n_columns, typename Number>
+template <typename Number2>
+inline
+SmallFullMatrix<n_rows,n_columns,Number> &
+SmallFullMatrix<n_rows,n_columns,Number>::operator = (const FullMatrix<Number2> &matrix)
+{
+  AssertDimension (matrix.m(), n_rows);
+  AssertDimension (matrix.n(), n_columns);
+  for (size_type i=0; i<n_rows; ++i)
+    for (size_type j=0; j<n_columns; ++j)
+      values[i*n_columns+j] = matrix(i,j);
+  return *this;
+}
+
+
+
+template <int n_rows, int n_columns, typename Number>
+inline
+typename SmallFullMatrix<n_rows,n_columns,Number>::size_type
+SmallFullMatrix<n_rows,n_columns,Number>::m () const
+{
+  return n_rows;
+}
+
+
+
+template <int n_rows, int n_columns, typename Number>
+inline
+typename SmallFullMatrix<n_rows,n_columns,Number>::size_type
+SmallFullMatrix<n_rows,n_columns,Number>::n () const
+{
+  return n_columns;
+}
+
+
+
+template <int n_rows, int n_columns, typename Number>
+inline
+Number &
+SmallFullMatrix<n_rows,n_columns,Number>::operator() (const size_type i,
+                                                      const size_type j)
+{
+  AssertIndexRange (i, n_rows);
+  AssertIndexRange (j, n_columns);
+  return values[i*n_columns+j];
+}
+
+
+
+template <int n_rows, int n_columns, typename Number>
+inline
+const Number &
+SmallFullMatrix<n_rows,n_columns,Number>::operator() (const size_type i,
+                                                      const size_type j) const
+{
+  AssertIndexRange (i, n_rows);
+  AssertIndexRange (j, n_columns);
+  return values[i*n_columns+j];
+}
+
+
+
+template <int n_rows, int n_columns, typename Number>
+inline
+Number *
+SmallFullMatrix<n_rows,n_columns,Number>::data ()
+{
+  return values;
+}
+
+
+
+template <int n_rows, int n_columns, typename Number>
+inline
+const Number *
+SmallFullMatrix<n_rows,n_columns,Number>::data () const
+{
+  return values;
+}
+
+
+
+template <int n_rows, int n_columns, typename Number>
+inline
+SmallFullMatrix<n_rows,n_columns,Number> &
+SmallFullMatrix<n_rows,n_columns,Number>::operator += (const SmallFullMatrix &matrix)
+{
+  for (size_type i=0; i<n_rows*n_columns; ++i)
+    values[i] += matrix.values[i];
+  return *this;
+}
+
+
+
+template <int n_rows, int n_columns, typename Number>
+inline
+SmallFullMatrix<n_rows,n_columns,Number> &
+SmallFullMatrix<n_rows,n_columns,Number>::operator *= (const Number factor)
+{
+  for (size_type i=0; i<n_rows*n_columns; ++i)
+    values[i] *= factor;
+  return *this;
+}
+
+
+
+template <int n_rows, int n_columns, typename Number>
+template <typename Number2>
+inline
+void
+SmallFullMatrix<n_rows,n_columns,Number>::copy_to (FullMatrix<Number2> &matrix) const
+{
+  matrix.reinit (n_rows, n_columns, true);
+  for (size_type i=0; i<n_rows; ++i)
+    for (size_type j=0; j<n_columns; ++j)
+      matrix(i,j) = values[i*n_columns+j];
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
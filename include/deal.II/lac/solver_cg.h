@@ -21,6 +21,7 @@
 #include <deal.II/lac/tridiagonal_matrix.h>
 #include <deal.II/lac/solver.h>
 #include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector_type_traits.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/subscriptor.h>
@@ -227,6 +228,51 @@ protected:
 
 #ifndef DOXYGEN
 
+namespace internal
+{
+  namespace SolverCGImplementation
+  {
+    /**
+     * Update the solution vector @p x by @p alpha times the search
+     * direction @p d and the residual @p g by @p alpha times @p h = A d,
+     * and return the squared norm of the updated residual. This is the
+     * variant for vector types without fused operations.
+     */
+    template <typename VectorType>
+    double
+    update_solution_and_residual (const double      alpha,
+                                  const VectorType &d,
+                                  const VectorType &h,
+                                  VectorType       &x,
+                                  VectorType       &g,
+                                  std::false_type)
+    {
+      x.add(alpha,d);
+      return g.add_and_dot(alpha, h, g);
+    }
+
+
+
+    /**
+     * Same as above but for vector types providing the fused operation
+     * add_and_norm_sqr(), see has_fused_cg_update.
+     */
+    template <typename VectorType>
+    double
+    update_solution_and_residual (const double      alpha,
+                                  const VectorType &d,
+                                  const VectorType &h,
+                                  VectorType       &x,
+                                  VectorType       &g,
+                                  std::true_type)
+    {
+      return g.add_and_norm_sqr(alpha, h, x, d);
+    }
+  }
+}
+
+
+
 template <typename VectorType>
 SolverCG<VectorType>::SolverCG (SolverControl        &cn,
                                 VectorMemory<VectorType> &mem,
@@ -386,8 +432,9 @@ SolverCG<VectorType>::solve (const MatrixType         &A,
       Assert(alpha != 0., ExcDivideByZero());
       alpha = gh/alpha;
 
-      x.add(alpha,d);
-      res = std::sqrt(g.add_and_dot(alpha, h, g));
+      res = std::sqrt(internal::SolverCGImplementation::update_solution_and_residual
+                      (alpha, d, h, x, g,
+                       std::integral_constant<bool,has_fused_cg_update<VectorType>::value>()));
 
       print_vectors(it, x, g, d);
 
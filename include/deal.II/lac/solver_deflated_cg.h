@@ -0,0 +1,560 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_deflated_cg_h
+#define dealii_solver_deflated_cg_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/lapack_full_matrix.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * Deflated preconditioned conjugate gradient method for symmetric positive
+ * definite matrices according to Y. Saad, M. Yeung, J. Erhel, F.
+ * Guyomarc'h, "A deflated version of the conjugate gradient algorithm",
+ * SIAM J. Sci. Comput. 21(5), pp. 1909-1926, 2000.
+ *
+ * The solver is given a set of deflation vectors $W=[w_1,\ldots,w_k]$
+ * through set_deflation_vectors(). The initial guess is corrected such
+ * that the initial residual is orthogonal to $W$, and all search directions
+ * are kept $A$-orthogonal to $W$ by a projection with the small matrix
+ * $W^TAW$. If $W$ spans (approximations of) the eigenvectors belonging to
+ * the smallest eigenvalues of the preconditioned matrix, these eigenvalues
+ * are effectively removed from the spectrum seen by the iteration, and the
+ * convergence is governed by the remaining part of the spectrum. Each solve
+ * needs $k$ additional matrix-vector products to compute $AW$, and every
+ * iteration needs $k$ additional inner products and vector updates.
+ *
+ * <h3>Recycling of Krylov information</h3>
+ *
+ * For sequences of linear systems with a slowly varying matrix, as
+ * they appear in time stepping, the deflation space can be harvested from
+ * the previous solves. If AdditionalData::n_recycled_vectors is larger
+ * than zero, the solver collects the search directions $P$ of the
+ * iteration in a buffer of AdditionalData::n_harvested_directions vectors.
+ * Whenever the buffer is full, and at the end of the solve, a Rayleigh-Ritz
+ * procedure on the space spanned by the current approximate eigenvectors
+ * $U$ (initially the deflation vectors $W$) and $P$ selects the
+ * AdditionalData::n_recycled_vectors vectors with the smallest Ritz values
+ * and the buffer is emptied, similarly to the eigCG method of A.
+ * Stathopoulos and K. Orginos, SIAM J. Sci. Comput. 32(1), pp. 439-462,
+ * 2010. The final approximate eigenvectors replace the deflation vectors
+ * for the next call to solve(). Since the search directions are
+ * $A$-conjugate to each other and to all earlier directions, the projected
+ * matrix $[U,P]^TA[U,P]$ is block diagonal and available from the step
+ * lengths of the iteration. Only the Gram matrix $[U,P]^T[U,P]$ needs to be
+ * computed by inner products, and its block $U^TU$ is known from the
+ * previous Rayleigh-Ritz step. The small generalized eigenvalue problems
+ * are solved with LAPACKFullMatrix, so recycling requires deal.II to be
+ * configured with LAPACK. The algorithm is in the spirit of the
+ * Lanczos-based eigenvalue estimates of SolverCG, but keeps the
+ * eigenvectors instead of only the eigenvalues. The extraction costs about
+ * $(k+m/2)$ inner products and $k(k+m)/m$ vector updates per iteration for
+ * $k$ recycled vectors and a buffer of $m$ directions, in addition to the
+ * memory for these vectors.
+ *
+ * After a few solves (the warm-up phase), the deflation space contains good
+ * approximations to the eigenvectors of the lowest part of the spectrum,
+ * which typically reduces the iteration count considerably for problems
+ * like the pressure Poisson equation, where a few small eigenvalues
+ * dominate the condition number. Deflation vectors given by the user are
+ * combined with the harvested directions in the same way, i.e., they are
+ * replaced by the Ritz vectors after the first solve.
+ *
+ * Without deflation vectors and with recycling disabled, the iterates are
+ * the same as the ones of SolverCG.
+ *
+ * <h3>Observing the progress of linear solver iterations</h3>
+ *
+ * The solve() function of this class uses the mechanism described in the
+ * Solver base class to determine convergence, i.e., it can be combined with
+ * SolverControl, ReductionControl, or IterationNumberControl in the same way
+ * as SolverCG.
+ */
+template <typename VectorType = Vector<double> >
+class SolverDeflatedCG : public Solver<VectorType>
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor. By default, no vectors are recycled between solves and
+     * only the vectors given to set_deflation_vectors() are used. If @p
+     * n_harvested_directions is zero, twice the number of recycled vectors
+     * is used.
+     */
+    explicit
+    AdditionalData (const unsigned int n_recycled_vectors = 0,
+                    const unsigned int n_harvested_directions = 0)
+      :
+      n_recycled_vectors (n_recycled_vectors),
+      n_harvested_directions (n_harvested_directions == 0 ?
+                              2*n_recycled_vectors :
+                              n_harvested_directions)
+    {}
+
+    /**
+     * The number of approximate eigenvectors that are extracted after each
+     * solve and used as deflation vectors in the next one.
+     */
+    unsigned int n_recycled_vectors;
+
+    /**
+     * The number of search directions that are collected before the
+     * approximate eigenvectors are updated by a Rayleigh-Ritz step. A larger
+     * number gives better approximations at the cost of memory for the same
+     * number of vectors and of the inner products in the Rayleigh-Ritz
+     * procedure.
+     */
+    unsigned int n_harvested_directions;
+  };
+
+  /**
+   * Constructor.
+   */
+  SolverDeflatedCG (SolverControl            &cn,
+                    VectorMemory<VectorType> &mem,
+                    const AdditionalData     &data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverDeflatedCG (SolverControl        &cn,
+                    const AdditionalData &data=AdditionalData());
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~SolverDeflatedCG () = default;
+
+  /**
+   * Set the deflation vectors used in the next call to solve(). The vectors
+   * must be linearly independent.
+   */
+  void set_deflation_vectors (const std::vector<VectorType> &vectors);
+
+  /**
+   * Return the current deflation vectors, i.e., the vectors given to
+   * set_deflation_vectors() or the approximate eigenvectors harvested in
+   * the last solve.
+   */
+  const std::vector<VectorType> &get_deflation_vectors () const;
+
+  /**
+   * Remove all deflation vectors, e.g. when the matrix has changed
+   * considerably.
+   */
+  void clear_deflation_vectors ();
+
+  /**
+   * Solve the linear system $Ax=b$ for x.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve (const MatrixType         &A,
+         VectorType               &x,
+         const VectorType         &b,
+         const PreconditionerType &preconditioner);
+
+protected:
+  /**
+   * Interface for derived class. This function gets the current iteration
+   * vector, the residual and the update vector in each step. It can be used
+   * for graphical output of the convergence history.
+   */
+  virtual void print_vectors(const unsigned int step,
+                             const VectorType   &x,
+                             const VectorType   &r,
+                             const VectorType   &p) const;
+
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+
+private:
+  /**
+   * Compute the coefficients $c=(W^TAW)^{-1}(V^Tv)$ for the given set of
+   * vectors $V$, which is either $W$ or $AW$.
+   */
+  void compute_coefficients (const std::vector<VectorType> &vectors,
+                             const VectorType              &v,
+                             Vector<double>                &coefficients) const;
+
+  /**
+   * Replace the approximate eigenvectors by the ones with the smallest Ritz
+   * values in the space spanned by the current approximate eigenvectors and
+   * the harvested search directions, and empty the buffer of search
+   * directions.
+   */
+  void update_ritz_vectors ();
+
+  /**
+   * The deflation vectors $W$.
+   */
+  std::vector<VectorType> deflation_vectors;
+
+  /**
+   * The product of the matrix with the deflation vectors, $AW$, for the
+   * matrix of the current solve.
+   */
+  std::vector<VectorType> a_deflation_vectors;
+
+  /**
+   * The inverse of the matrix $W^TAW$.
+   */
+  FullMatrix<double> inverse_coarse_matrix;
+
+  /**
+   * The current approximate eigenvectors $U$ of the solve.
+   */
+  std::vector<VectorType> ritz_vectors;
+
+  /**
+   * The matrices $U^TAU$ and $U^TU$ of the approximate eigenvectors.
+   */
+  FullMatrix<double> ritz_projected_matrix;
+  FullMatrix<double> ritz_gram_matrix;
+
+  /**
+   * The search directions collected since the last Rayleigh-Ritz step,
+   * normalized to $p^TAp=1$.
+   */
+  std::vector<VectorType> harvested_directions;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename VectorType>
+SolverDeflatedCG<VectorType>::SolverDeflatedCG (SolverControl            &cn,
+                                                VectorMemory<VectorType> &mem,
+                                                const AdditionalData     &data)
+  :
+  Solver<VectorType>(cn,mem),
+  additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+SolverDeflatedCG<VectorType>::SolverDeflatedCG (SolverControl        &cn,
+                                                const AdditionalData &data)
+  :
+  Solver<VectorType>(cn),
+  additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+void
+SolverDeflatedCG<VectorType>::set_deflation_vectors
+(const std::vector<VectorType> &vectors)
+{
+  deflation_vectors = vectors;
+}
+
+
+
+template <typename VectorType>
+const std::vector<VectorType> &
+SolverDeflatedCG<VectorType>::get_deflation_vectors () const
+{
+  return deflation_vectors;
+}
+
+
+
+template <typename VectorType>
+void
+SolverDeflatedCG<VectorType>::clear_deflation_vectors ()
+{
+  deflation_vectors.clear();
+  a_deflation_vectors.clear();
+  ritz_vectors.clear();
+  harvested_directions.clear();
+}
+
+
+
+template <typename VectorType>
+void
+SolverDeflatedCG<VectorType>::print_vectors(const unsigned int,
+                                            const VectorType &,
+                                            const VectorType &,
+                                            const VectorType &) const
+{}
+
+
+
+template <typename VectorType>
+void
+SolverDeflatedCG<VectorType>::compute_coefficients
+(const std::vector<VectorType> &vectors,
+ const VectorType              &v,
+ Vector<double>                &coefficients) const
+{
+  Vector<double> inner_products(vectors.size());
+  for (unsigned int i=0; i<vectors.size(); ++i)
+    inner_products(i) = vectors[i] * v;
+  inverse_coarse_matrix.vmult(coefficients, inner_products);
+}
+
+
+
+template <typename VectorType>
+void
+SolverDeflatedCG<VectorType>::update_ritz_vectors ()
+{
+  const unsigned int n_old = ritz_vectors.size();
+  const unsigned int n_directions = harvested_directions.size();
+  const unsigned int n_basis = n_old + n_directions;
+  const unsigned int n_new = std::min(additional_data.n_recycled_vectors,
+                                      n_basis);
+  if (n_directions == 0 || n_new == 0)
+    return;
+
+  auto basis_vector = [&](const unsigned int i) -> const VectorType &
+  {
+    return i < n_old ? ritz_vectors[i] : harvested_directions[i-n_old];
+  };
+
+  // the search directions are A-orthogonal to each other and to the old
+  // approximate eigenvectors, so the projected matrix is block diagonal
+  // with U^T A U and an identity block for the normalized directions
+  LAPACKFullMatrix<double> projected_matrix(n_basis, n_basis);
+  for (unsigned int i=0; i<n_old; ++i)
+    for (unsigned int j=0; j<n_old; ++j)
+      projected_matrix(i,j) = ritz_projected_matrix(i,j);
+  for (unsigned int j=n_old; j<n_basis; ++j)
+    projected_matrix(j,j) = 1.;
+
+  // compute the negative Gram matrix of the basis. Solving the problem
+  // -Z^T Z y = mu Z^T A Z y, the first eigenvectors belong to the largest
+  // values of -mu, i.e., the smallest Ritz values, and are normalized in
+  // the A-inner product
+  LAPACKFullMatrix<double> gram_matrix(n_basis, n_basis);
+  for (unsigned int i=0; i<n_basis; ++i)
+    for (unsigned int j=0; j<=i; ++j)
+      {
+        const double product = (i<n_old) ? ritz_gram_matrix(i,j) :
+                               basis_vector(i) * basis_vector(j);
+        gram_matrix(i,j) = -product;
+        gram_matrix(j,i) = -product;
+      }
+
+  std::vector<Vector<double> > eigenvectors(n_new);
+  gram_matrix.compute_generalized_eigenvalues_symmetric(projected_matrix,
+                                                        eigenvectors);
+
+  std::vector<VectorType> new_vectors(n_new);
+  for (unsigned int k=0; k<n_new; ++k)
+    {
+      new_vectors[k].reinit(basis_vector(0));
+      for (unsigned int i=0; i<n_basis; ++i)
+        new_vectors[k].add(eigenvectors[k](i), basis_vector(i));
+    }
+  ritz_vectors.swap(new_vectors);
+  harvested_directions.clear();
+
+  // the eigenvectors are orthonormal with respect to Z^T A Z and
+  // orthogonal with respect to Z^T Z with the eigenvalues as diagonal
+  ritz_projected_matrix.reinit(n_new, n_new);
+  ritz_gram_matrix.reinit(n_new, n_new);
+  for (unsigned int k=0; k<n_new; ++k)
+    {
+      ritz_projected_matrix(k,k) = 1.;
+      ritz_gram_matrix(k,k) = -gram_matrix.eigenvalue(k).real();
+    }
+}
+
+
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverDeflatedCG<VectorType>::solve (const MatrixType         &A,
+                                     VectorType               &x,
+                                     const VectorType         &b,
+                                     const PreconditionerType &preconditioner)
+{
+  SolverControl::State conv=SolverControl::iterate;
+
+  LogStream::Prefix prefix("dcg");
+
+  typename VectorMemory<VectorType>::Pointer r_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer z_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer p_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer h_pointer(this->memory);
+
+  // r is the residual, z the preconditioned residual, p the search
+  // direction, and h holds A*p
+  VectorType &r = *r_pointer;
+  VectorType &z = *z_pointer;
+  VectorType &p = *p_pointer;
+  VectorType &h = *h_pointer;
+
+  r.reinit(x, true);
+  z.reinit(x, true);
+  p.reinit(x, true);
+  h.reinit(x, true);
+
+  // set up the coarse problem W^T A W for the matrix of this solve
+  const unsigned int n_deflation = deflation_vectors.size();
+  a_deflation_vectors.resize(n_deflation);
+  inverse_coarse_matrix.reinit(n_deflation, n_deflation);
+  for (unsigned int i=0; i<n_deflation; ++i)
+    {
+      a_deflation_vectors[i].reinit(x, true);
+      A.vmult(a_deflation_vectors[i], deflation_vectors[i]);
+      for (unsigned int j=0; j<=i; ++j)
+        {
+          const double product = deflation_vectors[j] * a_deflation_vectors[i];
+          inverse_coarse_matrix(i,j) = product;
+          inverse_coarse_matrix(j,i) = product;
+        }
+    }
+
+  // the approximate eigenvectors start from the deflation vectors
+  const bool recycle = additional_data.n_recycled_vectors > 0;
+  harvested_directions.clear();
+  if (recycle)
+    {
+      ritz_vectors = deflation_vectors;
+      ritz_projected_matrix = inverse_coarse_matrix;
+      ritz_gram_matrix.reinit(n_deflation, n_deflation);
+      for (unsigned int i=0; i<n_deflation; ++i)
+        for (unsigned int j=0; j<=i; ++j)
+          {
+            const double product = deflation_vectors[i] * deflation_vectors[j];
+            ritz_gram_matrix(i,j) = product;
+            ritz_gram_matrix(j,i) = product;
+          }
+    }
+
+  if (n_deflation > 0)
+    inverse_coarse_matrix.gauss_jordan();
+  Vector<double> coefficients(n_deflation);
+
+  // compute the residual r = b - A x and correct the initial guess such
+  // that the residual is orthogonal to the deflation vectors
+  A.vmult(r, x);
+  r.sadd(-1., 1., b);
+  if (n_deflation > 0)
+    {
+      compute_coefficients(deflation_vectors, r, coefficients);
+      for (unsigned int i=0; i<n_deflation; ++i)
+        {
+          x.add(coefficients(i), deflation_vectors[i]);
+          r.add(-coefficients(i), a_deflation_vectors[i]);
+        }
+    }
+
+  double res = r.l2_norm();
+  int it = 0;
+  conv = this->iteration_status(0, res, x);
+
+  double gamma = 0.;
+  while (conv == SolverControl::iterate)
+    {
+      preconditioner.vmult(z, r);
+      const double gamma_new = r * z;
+
+      // the new search direction is the preconditioned residual made
+      // A-orthogonal to the deflation vectors
+      if (it == 0)
+        p = z;
+      else
+        {
+          Assert(gamma != 0., ExcDivideByZero());
+          p.sadd(gamma_new/gamma, 1., z);
+        }
+      gamma = gamma_new;
+      if (n_deflation > 0)
+        {
+          compute_coefficients(a_deflation_vectors, z, coefficients);
+          for (unsigned int i=0; i<n_deflation; ++i)
+            p.add(-coefficients(i), deflation_vectors[i]);
+        }
+
+      A.vmult(h, p);
+      const double ph = p * h;
+      Assert(ph != 0., ExcDivideByZero());
+      const double alpha = gamma/ph;
+
+      if (recycle && ph > 0.)
+        {
+          harvested_directions.push_back(p);
+          harvested_directions.back() *= 1./std::sqrt(ph);
+          if (harvested_directions.size() >= additional_data.n_harvested_directions)
+            update_ritz_vectors();
+        }
+
+      x.add(alpha, p);
+      r.add(-alpha, h);
+      res = r.l2_norm();
+
+      ++it;
+      print_vectors(it, x, r, p);
+      conv = this->iteration_status(it, res, x);
+    }
+
+  if (recycle)
+    {
+      update_ritz_vectors();
+      deflation_vectors.swap(ritz_vectors);
+      ritz_vectors.clear();
+    }
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence (it, res));
+  // otherwise exit as normal
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -36,6 +36,14 @@
 
 DEAL_II_NAMESPACE_OPEN
 
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    template <typename> class Vector;
+  }
+}
+
 /*!@addtogroup Solvers */
 /*@{*/
 
@@ -103,6 +111,37 @@ namespace internal
        */
       std::vector<typename VectorMemory<VectorType>::Pointer> data;
     };
+
+
+
+    /**
+     * Compute the inner products of @p vv with the first @p dim vectors in
+     * @p orthogonal_vectors, and, if @p include_norm is set, append the
+     * squared norm of @p vv, placing the results in @p results. The generic
+     * implementation computes the inner products one at a time.
+     */
+    template <typename VectorType>
+    void
+    inner_products (const TmpVectors<VectorType> &orthogonal_vectors,
+                    const unsigned int            dim,
+                    const VectorType             &vv,
+                    const bool                    include_norm,
+                    dealii::Vector<double>       &results);
+
+
+
+    /**
+     * Specialization of the inner products for
+     * LinearAlgebra::distributed::Vector that combines all inner products in
+     * a single global reduction.
+     */
+    template <typename Number>
+    void
+    inner_products (const TmpVectors<LinearAlgebra::distributed::Vector<Number> > &orthogonal_vectors,
+                    const unsigned int                                             dim,
+                    const LinearAlgebra::distributed::Vector<Number>               &vv,
+                    const bool                                                     include_norm,
+                    dealii::Vector<double>                                         &results);
   }
 }
 
@@ -182,17 +221,49 @@ public:
    */
   struct AdditionalData
   {
+    /**
+     * The algorithms available for the orthogonalization of the new Krylov
+     * vector against the previous basis vectors.
+     */
+    enum OrthogonalizationStrategy
+    {
+      /**
+       * Modified Gram-Schmidt, which computes the projection onto one basis
+       * vector after the other. This requires one global reduction per
+       * basis vector. Loss of orthogonality is checked every fifth step and
+       * re-orthogonalization is switched on if necessary, see
+       * #force_re_orthogonalization.
+       */
+      modified_gram_schmidt,
+      /**
+       * Classical Gram-Schmidt with re-orthogonalization, which computes the
+       * projections onto all basis vectors at once and repeats the
+       * orthogonalization a second time to compensate for the loss of
+       * orthogonality of the classical algorithm. This requires two global
+       * reductions per iteration, independently of the size of the basis,
+       * and is thus considerably faster than modified Gram-Schmidt for
+       * large bases on many MPI processes. For
+       * LinearAlgebra::distributed::Vector, the inner products are computed
+       * with Vector::inner_products() which combines them in a single
+       * reduction; for other vector types the inner products are computed
+       * one at a time.
+       */
+      classical_gram_schmidt
+    };
+
     /**
      * Constructor. By default, set the number of temporary vectors to 30,
      * i.e. do a restart every 28 iterations. Also set preconditioning from
      * left, the residual of the stopping criterion to the default residual,
-     * and re-orthogonalization only if necessary.
+     * re-orthogonalization only if necessary, and the modified Gram-Schmidt
+     * algorithm.
      */
     explicit
     AdditionalData (const unsigned int max_n_tmp_vectors = 30,
                     const bool right_preconditioning = false,
                     const bool use_default_residual = true,
-                    const bool force_re_orthogonalization = false);
+                    const bool force_re_orthogonalization = false,
+                    const OrthogonalizationStrategy orthogonalization_strategy = modified_gram_schmidt);
 
     /**
      * Maximum number of temporary vectors. This parameter controls the size
@@ -222,6 +293,11 @@ public:
      * if necessary.
      */
     bool force_re_orthogonalization;
+
+    /**
+     * The algorithm used for the orthogonalization of the Krylov basis.
+     */
+    OrthogonalizationStrategy orthogonalization_strategy;
   };
 
   /**
@@ -394,6 +470,19 @@ protected:
    bool                                                &re_orthogonalize,
    const boost::signals2::signal<void(int)>            &re_orthogonalize_signal = boost::signals2::signal<void(int)>());
 
+  /**
+   * Orthogonalize the vector @p vv against the @p dim (orthogonal) vectors
+   * given by the first argument using the classical Gram-Schmidt algorithm
+   * applied twice. The factors used for orthogonalization are stored in @p
+   * h. The return value is the norm of @p vv after orthogonalization.
+   */
+  static double
+  classical_gram_schmidt
+  (const internal::SolverGMRES::TmpVectors<VectorType> &orthogonal_vectors,
+   const unsigned int                                  dim,
+   VectorType                                          &vv,
+   Vector<double>                                      &h);
+
   /**
    * Estimates the eigenvalues from the Hessenberg matrix, H_orig, generated
    * during the inner iterations. Uses these estimate to compute the condition
@@ -574,6 +663,45 @@ namespace internal
 
 
 
+
+    template <typename VectorType>
+    void
+    inner_products (const TmpVectors<VectorType> &orthogonal_vectors,
+                    const unsigned int            dim,
+                    const VectorType             &vv,
+                    const bool                    include_norm,
+                    dealii::Vector<double>       &results)
+    {
+      for (unsigned int i=0; i<dim; ++i)
+        results(i) = vv * orthogonal_vectors[i];
+      if (include_norm)
+        results(dim) = vv.norm_sqr();
+    }
+
+
+
+    template <typename Number>
+    void
+    inner_products (const TmpVectors<LinearAlgebra::distributed::Vector<Number> > &orthogonal_vectors,
+                    const unsigned int                                             dim,
+                    const LinearAlgebra::distributed::Vector<Number>               &vv,
+                    const bool                                                     include_norm,
+                    dealii::Vector<double>                                         &results)
+    {
+      std::vector<const LinearAlgebra::distributed::Vector<Number> *>
+      vectors(dim + (include_norm ? 1 : 0));
+      for (unsigned int i=0; i<dim; ++i)
+        vectors[i] = &orthogonal_vectors[i];
+      if (include_norm)
+        vectors[dim] = &vv;
+      std::vector<Number> products;
+      vv.inner_products(vectors, products);
+      for (unsigned int i=0; i<products.size(); ++i)
+        results(i) = products[i];
+    }
+
+
+
     // A comparator for better printing eigenvalues
     inline
     bool complex_less_pred(const std::complex<double> &x,
@@ -592,12 +720,14 @@ SolverGMRES<VectorType>::AdditionalData::
 AdditionalData (const unsigned int max_n_tmp_vectors,
                 const bool         right_preconditioning,
                 const bool         use_default_residual,
-                const bool         force_re_orthogonalization)
+                const bool         force_re_orthogonalization,
+                const OrthogonalizationStrategy orthogonalization_strategy)
   :
   max_n_tmp_vectors(max_n_tmp_vectors),
   right_preconditioning(right_preconditioning),
   use_default_residual(use_default_residual),
-  force_re_orthogonalization(force_re_orthogonalization)
+  force_re_orthogonalization(force_re_orthogonalization),
+  orthogonalization_strategy(orthogonalization_strategy)
 {}
 
 
@@ -716,6 +846,50 @@ SolverGMRES<VectorType>::modified_gram_schmidt
 
 
 
+template <class VectorType>
+inline
+double
+SolverGMRES<VectorType>::classical_gram_schmidt
+(const internal::SolverGMRES::TmpVectors<VectorType> &orthogonal_vectors,
+ const unsigned int                                  dim,
+ VectorType                                          &vv,
+ Vector<double>                                      &h)
+{
+  Assert(dim > 0, ExcInternalError());
+
+  // first pass: compute all projections with one reduction and subtract
+  // them
+  Vector<double> projections(dim+1);
+  internal::SolverGMRES::inner_products(orthogonal_vectors, dim, vv, false,
+                                        projections);
+  for (unsigned int i=0; i<dim; ++i)
+    {
+      h(i) = projections(i);
+      vv.add(-projections(i), orthogonal_vectors[i]);
+    }
+
+  // second pass for re-orthogonalization, where we also compute the norm of
+  // vv in the same reduction. The norm after the second subtraction follows
+  // from Pythagoras as the corrections are orthogonal to the new vector
+  internal::SolverGMRES::inner_products(orthogonal_vectors, dim, vv, true,
+                                        projections);
+  double norm_sqr = projections(dim);
+  for (unsigned int i=0; i<dim; ++i)
+    {
+      h(i) += projections(i);
+      vv.add(-projections(i), orthogonal_vectors[i]);
+      norm_sqr -= projections(i) * projections(i);
+    }
+
+  // in case of cancellation, compute the norm explicitly
+  if (norm_sqr > 0.5 * projections(dim))
+    return std::sqrt(norm_sqr);
+  else
+    return vv.l2_norm();
+}
+
+
+
 template <class VectorType>
 inline void
 SolverGMRES<VectorType>::compute_eigs_and_cond
@@ -931,10 +1105,14 @@ SolverGMRES<VectorType>::solve (const MatrixType         &A,
 
           dim = inner_iteration+1;
 
-          const double s = modified_gram_schmidt(tmp_vectors, dim,
-                                                 accumulated_iterations,
-                                                 vv, h, re_orthogonalize,
-                                                 re_orthogonalize_signal);
+          const double s =
+            additional_data.orthogonalization_strategy ==
+            AdditionalData::classical_gram_schmidt ?
+            classical_gram_schmidt(tmp_vectors, dim, vv, h) :
+            modified_gram_schmidt(tmp_vectors, dim,
+                                  accumulated_iterations,
+                                  vv, h, re_orthogonalize,
+                                  re_orthogonalize_signal);
           h(inner_iteration+1) = s;
 
           //s=0 is a lucky breakdown, the solver will reach convergence,
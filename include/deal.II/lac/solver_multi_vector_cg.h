@@ -0,0 +1,240 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_multi_vector_cg_h
+#define dealii_solver_multi_vector_cg_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/la_parallel_multi_vector.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * Preconditioned conjugate gradient method for solving a linear system with
+ * several right hand sides at once, stored as the columns of a
+ * LinearAlgebra::distributed::MultiVector.
+ *
+ * The solver runs the usual CG recurrences of SolverCG independently for
+ * each column, i.e., every column gets its own step lengths $\alpha$ and
+ * $\beta$ and the iterates of each column are exactly the ones SolverCG
+ * would compute for that right hand side alone. The benefit over solving the
+ * systems one after the other lies in the data access: the matrix-vector
+ * product and the preconditioner are applied to all columns in one call, so
+ * that the matrix (or, for matrix-free operators, the geometry data) is read
+ * from memory once for all columns, see for example
+ * SparseMatrix::vmult(LinearAlgebra::distributed::MultiVector<somenumber>&,const LinearAlgebra::distributed::MultiVector<somenumber>&) const.
+ * Likewise, the inner products of all columns are combined into a single
+ * global reduction and the ghost exchange of the operator is done once for
+ * all columns. Note that this is not a block Krylov method in the sense of
+ * O'Leary that builds a common search space from all columns; the
+ * convergence of each column is the one of plain CG.
+ *
+ * The iteration is stopped according to the SolverControl object once the
+ * largest residual norm among all columns satisfies the criterion, i.e., the
+ * values passed to the SolverControl are the maximum over all columns.
+ * Columns that converged earlier continue to be updated, which in exact
+ * arithmetic only improves their accuracy.
+ *
+ * The matrix and the preconditioner must provide a function
+ * <code>vmult(MultiVector&, const MultiVector&)</code>, such as the one of
+ * SparseMatrix, PreconditionIdentity, or a user-defined operator based on
+ * MatrixFree::cell_loop.
+ */
+template <typename Number = double>
+class SolverMultiVectorCG : public Solver<LinearAlgebra::distributed::MultiVector<Number> >
+{
+public:
+  /**
+   * The vector type this solver works on.
+   */
+  typedef LinearAlgebra::distributed::MultiVector<Number> VectorType;
+
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   * Here, it doesn't store anything but just exists for consistency
+   * with the other solver classes.
+   */
+  struct AdditionalData {};
+
+  /**
+   * Constructor.
+   */
+  SolverMultiVectorCG (SolverControl            &cn,
+                       VectorMemory<VectorType> &mem,
+                       const AdditionalData     &data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverMultiVectorCG (SolverControl        &cn,
+                       const AdditionalData &data=AdditionalData());
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~SolverMultiVectorCG () = default;
+
+  /**
+   * Solve the linear systems $Ax_c=b_c$ for all columns $c$ of @p x and @p
+   * b.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve (const MatrixType         &A,
+         VectorType               &x,
+         const VectorType         &b,
+         const PreconditionerType &preconditioner);
+
+protected:
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename Number>
+SolverMultiVectorCG<Number>::SolverMultiVectorCG (SolverControl            &cn,
+                                                  VectorMemory<VectorType> &mem,
+                                                  const AdditionalData     &data)
+  :
+  Solver<VectorType>(cn,mem),
+  additional_data(data)
+{}
+
+
+
+template <typename Number>
+SolverMultiVectorCG<Number>::SolverMultiVectorCG (SolverControl        &cn,
+                                                  const AdditionalData &data)
+  :
+  Solver<VectorType>(cn),
+  additional_data(data)
+{}
+
+
+
+template <typename Number>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverMultiVectorCG<Number>::solve (const MatrixType         &A,
+                                    VectorType               &x,
+                                    const VectorType         &b,
+                                    const PreconditionerType &preconditioner)
+{
+  AssertDimension (x.n_vectors(), b.n_vectors());
+
+  SolverControl::State conv=SolverControl::iterate;
+
+  LogStream::Prefix prefix("mvcg");
+
+  typename VectorMemory<VectorType>::Pointer g_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer d_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer h_pointer(this->memory);
+
+  // g is the residual, d the search direction, and h holds A*d and the
+  // preconditioned residual
+  VectorType &g = *g_pointer;
+  VectorType &d = *d_pointer;
+  VectorType &h = *h_pointer;
+
+  g.reinit(x, true);
+  d.reinit(x, true);
+  h.reinit(x, true);
+
+  const unsigned int n_vectors = x.n_vectors();
+  std::vector<Number> alpha(n_vectors), beta(n_vectors), gamma(n_vectors),
+      gamma_new(n_vectors), dh(n_vectors);
+  std::vector<typename VectorType::real_type> norms(n_vectors);
+
+  // compute the residual g = b - A x
+  A.vmult(g, x);
+  g.sadd(std::vector<Number>(n_vectors, Number(-1.)), b);
+
+  g.l2_norms(norms);
+  double res = *std::max_element(norms.begin(), norms.end());
+  conv = this->iteration_status(0, res, x);
+  if (conv != SolverControl::iterate)
+    return;
+
+  preconditioner.vmult(h, g);
+  d = h;
+  g.inner_products(h, gamma);
+
+  int it=0;
+  while (conv == SolverControl::iterate)
+    {
+      it++;
+      A.vmult(h, d);
+      h.inner_products(d, dh);
+
+      for (unsigned int c=0; c<n_vectors; ++c)
+        {
+          // a column with zero residual (e.g. a zero right hand side) does
+          // not change anymore
+          alpha[c] = (dh[c] != Number()) ? gamma[c] / dh[c] : Number();
+          Assert(dh[c] != Number() || gamma[c] == Number(), ExcDivideByZero());
+        }
+      x.add(alpha, d);
+      for (unsigned int c=0; c<n_vectors; ++c)
+        alpha[c] = -alpha[c];
+      g.add(alpha, h);
+
+      g.l2_norms(norms);
+      res = *std::max_element(norms.begin(), norms.end());
+      conv = this->iteration_status(it, res, x);
+      if (conv != SolverControl::iterate)
+        break;
+
+      preconditioner.vmult(h, g);
+      g.inner_products(h, gamma_new);
+      for (unsigned int c=0; c<n_vectors; ++c)
+        {
+          beta[c] = (gamma[c] != Number()) ? gamma_new[c] / gamma[c] : Number();
+          gamma[c] = gamma_new[c];
+        }
+      d.sadd(beta, h);
+    }
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence (it, res));
+  // otherwise exit as normal
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
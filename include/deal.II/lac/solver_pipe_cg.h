@@ -0,0 +1,426 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_pipe_cg_h
+#define dealii_solver_pipe_cg_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * Pipelined preconditioned conjugate gradient method for symmetric positive
+ * definite matrices according to P. Ghysels and W. Vanroose, "Hiding global
+ * synchronization latency in the preconditioned Conjugate Gradient
+ * algorithm", Parallel Computing 40(7), pp. 224-238, 2014.
+ *
+ * The classical formulation in SolverCG needs two global reductions per
+ * iteration, namely the inner product for the step length and the inner
+ * product with the preconditioned residual (which also gives the residual
+ * norm). Each of them is a synchronization point between all MPI processes,
+ * which limits the parallel scalability when the work per iteration and
+ * process is small. The pipelined variant rearranges the recurrences with
+ * some auxiliary vectors such that only a single reduction of the three
+ * inner products $(r,u)$, $(w,u)$ and $(r,r)$ is needed per iteration, where
+ * $u$ is the preconditioned residual and $w=Au$. The reduction is started
+ * as a non-blocking <code>MPI_Iallreduce</code> before the application of
+ * the preconditioner and the matrix-vector product of the iteration, and only
+ * completed afterwards, so the latency of the reduction is hidden behind the
+ * work of these two operations.
+ *
+ * The overlap of communication is implemented for
+ * LinearAlgebra::distributed::Vector and requires an MPI implementation that
+ * supports the MPI-3 standard. For other vector types, or if the MPI
+ * library is older, the three inner products are computed by the usual
+ * blocking operations of the vector class, which still saves one of the
+ * reductions of SolverCG.
+ *
+ * The price for the reduced synchronization is that the algorithm needs
+ * nine vectors instead of the three vectors of SolverCG and performs more
+ * vector updates per iteration. Furthermore, the residual used for the
+ * convergence check is computed by a recurrence rather than as the true
+ * residual $b-Ax$. In finite precision, the recurrence can drift away from
+ * the true residual, which limits the attainable accuracy for very strict
+ * tolerances. The algorithm needs one more matrix-vector product than SolverCG
+ * for the same number of iterations.
+ *
+ * <h3>Observing the progress of linear solver iterations</h3>
+ *
+ * The solve() function of this class uses the mechanism described in the
+ * Solver base class to determine convergence, i.e., it can be combined with
+ * SolverControl, ReductionControl, or IterationNumberControl in the same way
+ * as SolverCG.
+ */
+template <typename VectorType = Vector<double> >
+class SolverPipeCG : public Solver<VectorType>
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   * Here, it doesn't store anything but just exists for consistency
+   * with the other solver classes.
+   */
+  struct AdditionalData {};
+
+  /**
+   * Constructor.
+   */
+  SolverPipeCG (SolverControl            &cn,
+                VectorMemory<VectorType> &mem,
+                const AdditionalData     &data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverPipeCG (SolverControl        &cn,
+                const AdditionalData &data=AdditionalData());
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~SolverPipeCG () = default;
+
+  /**
+   * Solve the linear system $Ax=b$ for x.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve (const MatrixType         &A,
+         VectorType               &x,
+         const VectorType         &b,
+         const PreconditionerType &preconditioner);
+
+protected:
+  /**
+   * Interface for derived class. This function gets the current iteration
+   * vector, the residual and the update vector in each step. It can be used
+   * for graphical output of the convergence history.
+   */
+  virtual void print_vectors(const unsigned int step,
+                             const VectorType   &x,
+                             const VectorType   &r,
+                             const VectorType   &p) const;
+
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+namespace internal
+{
+  namespace SolverPipeCGImplementation
+  {
+    /**
+     * A class that computes the three inner products $(r,u)$, $(w,u)$ and
+     * $(r,r)$ of the pipelined CG method. The generic implementation
+     * evaluates them with the blocking inner products of the vector class
+     * in start() and simply returns the values in finish().
+     */
+    template <typename VectorType>
+    class InnerProducts
+    {
+    public:
+      void start (const VectorType &r,
+                  const VectorType &u,
+                  const VectorType &w)
+      {
+        results[0] = r * u;
+        results[1] = w * u;
+        results[2] = r * r;
+      }
+
+      const std::array<double,3> &finish ()
+      {
+        return results;
+      }
+
+    private:
+      std::array<double,3> results;
+    };
+
+
+
+    /**
+     * Specialization for LinearAlgebra::distributed::Vector, which computes
+     * the local parts of the three inner products in a single sweep through
+     * the vectors and starts a non-blocking reduction that is completed in
+     * finish().
+     */
+    template <typename Number>
+    class InnerProducts<LinearAlgebra::distributed::Vector<Number> >
+    {
+    public:
+      InnerProducts ()
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+        :
+        request (MPI_REQUEST_NULL)
+#endif
+      {}
+
+      ~InnerProducts ()
+      {
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+        // do not leave a pending reduction behind, e.g. when an exception
+        // was thrown between start() and finish()
+        if (request != MPI_REQUEST_NULL)
+          MPI_Wait(&request, MPI_STATUS_IGNORE);
+#endif
+      }
+
+      void start (const LinearAlgebra::distributed::Vector<Number> &r,
+                  const LinearAlgebra::distributed::Vector<Number> &u,
+                  const LinearAlgebra::distributed::Vector<Number> &w)
+      {
+        AssertDimension (r.local_size(), u.local_size());
+        AssertDimension (r.local_size(), w.local_size());
+        std::array<double,3> local_sums = {{0., 0., 0.}};
+        const Number *r_ptr = r.begin();
+        const Number *u_ptr = u.begin();
+        const Number *w_ptr = w.begin();
+        const unsigned int local_size = r.local_size();
+        for (unsigned int i=0; i<local_size; ++i)
+          {
+            local_sums[0] += r_ptr[i] * u_ptr[i];
+            local_sums[1] += w_ptr[i] * u_ptr[i];
+            local_sums[2] += r_ptr[i] * r_ptr[i];
+          }
+
+#ifdef DEAL_II_WITH_MPI
+        if (Utilities::MPI::n_mpi_processes(r.get_mpi_communicator()) > 1)
+          {
+#  if MPI_VERSION >= 3
+            send_buffer = local_sums;
+            const int ierr = MPI_Iallreduce(send_buffer.data(), results.data(),
+                                            3, MPI_DOUBLE, MPI_SUM,
+                                            r.get_mpi_communicator(),
+                                            &request);
+            AssertThrowMPI(ierr);
+#  else
+            const int ierr = MPI_Allreduce(local_sums.data(), results.data(),
+                                           3, MPI_DOUBLE, MPI_SUM,
+                                           r.get_mpi_communicator());
+            AssertThrowMPI(ierr);
+#  endif
+            return;
+          }
+#endif
+        results = local_sums;
+      }
+
+      const std::array<double,3> &finish ()
+      {
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+        if (request != MPI_REQUEST_NULL)
+          {
+            const int ierr = MPI_Wait(&request, MPI_STATUS_IGNORE);
+            AssertThrowMPI(ierr);
+          }
+#endif
+        return results;
+      }
+
+    private:
+      std::array<double,3> results;
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+      std::array<double,3> send_buffer;
+      MPI_Request request;
+#endif
+    };
+  }
+}
+
+
+
+template <typename VectorType>
+SolverPipeCG<VectorType>::SolverPipeCG (SolverControl            &cn,
+                                        VectorMemory<VectorType> &mem,
+                                        const AdditionalData     &data)
+  :
+  Solver<VectorType>(cn,mem),
+  additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+SolverPipeCG<VectorType>::SolverPipeCG (SolverControl        &cn,
+                                        const AdditionalData &data)
+  :
+  Solver<VectorType>(cn),
+  additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+void
+SolverPipeCG<VectorType>::print_vectors(const unsigned int,
+                                        const VectorType &,
+                                        const VectorType &,
+                                        const VectorType &) const
+{}
+
+
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverPipeCG<VectorType>::solve (const MatrixType         &A,
+                                 VectorType               &x,
+                                 const VectorType         &b,
+                                 const PreconditionerType &preconditioner)
+{
+  SolverControl::State conv=SolverControl::iterate;
+
+  LogStream::Prefix prefix("pipecg");
+
+  // Memory allocation. The names of the vectors follow the notation in the
+  // paper by Ghysels and Vanroose: r is the residual, u=M^{-1}r the
+  // preconditioned residual, w=Au, m=M^{-1}w, n=Am, and p, s=Ap, q=M^{-1}s,
+  // z=Aq are the search direction and its images
+  typename VectorMemory<VectorType>::Pointer r_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer u_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer w_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer m_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer n_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer p_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer s_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer q_pointer(this->memory);
+  typename VectorMemory<VectorType>::Pointer z_pointer(this->memory);
+
+  VectorType &r = *r_pointer;
+  VectorType &u = *u_pointer;
+  VectorType &w = *w_pointer;
+  VectorType &m = *m_pointer;
+  VectorType &n = *n_pointer;
+  VectorType &p = *p_pointer;
+  VectorType &s = *s_pointer;
+  VectorType &q = *q_pointer;
+  VectorType &z = *z_pointer;
+
+  r.reinit(x, true);
+  u.reinit(x, true);
+  w.reinit(x, true);
+  m.reinit(x, true);
+  n.reinit(x, true);
+  p.reinit(x, true);
+  s.reinit(x, true);
+  q.reinit(x, true);
+  z.reinit(x, true);
+
+  // compute residual. if vector is zero, then short-circuit the full
+  // computation
+  if (!x.all_zero())
+    {
+      A.vmult(r,x);
+      r.sadd(-1.,1.,b);
+    }
+  else
+    r = b;
+
+  preconditioner.vmult(u,r);
+  A.vmult(w,u);
+
+  internal::SolverPipeCGImplementation::InnerProducts<VectorType> inner_products;
+
+  int it = 0;
+  double res = -std::numeric_limits<double>::max();
+  double gamma_old = 0, alpha = 0;
+  while (true)
+    {
+      // start the reduction and hide it behind the preconditioner and the
+      // matrix-vector product
+      inner_products.start(r, u, w);
+      preconditioner.vmult(m,w);
+      A.vmult(n,m);
+      const std::array<double,3> &products = inner_products.finish();
+      const double gamma = products[0];
+      const double delta = products[1];
+      res = std::sqrt(products[2]);
+
+      conv = this->iteration_status(it, res, x);
+      if (conv != SolverControl::iterate)
+        break;
+
+      if (it > 0)
+        {
+          Assert(gamma_old != 0., ExcDivideByZero());
+          const double beta = gamma/gamma_old;
+          Assert(delta - beta*gamma/alpha != 0., ExcDivideByZero());
+          alpha = gamma/(delta - beta*gamma/alpha);
+          z.sadd(beta, 1., n);
+          q.sadd(beta, 1., m);
+          s.sadd(beta, 1., w);
+          p.sadd(beta, 1., u);
+        }
+      else
+        {
+          Assert(delta != 0., ExcDivideByZero());
+          alpha = gamma/delta;
+          z = n;
+          q = m;
+          s = w;
+          p = u;
+        }
+      gamma_old = gamma;
+
+      x.add(alpha, p);
+      r.add(-alpha, s);
+      u.add(-alpha, q);
+      w.add(-alpha, z);
+
+      ++it;
+      print_vectors(it, x, r, p);
+    }
+
+  // in case of failure: throw exception
+  if (conv != SolverControl::success)
+    AssertThrow(false, SolverControl::NoConvergence (it, res));
+  // otherwise exit as normal
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2002 - 2016 by the deal.II authors
+// Copyright (C) 2002 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -17,6 +17,8 @@
 #define dealii_sparse_decomposition_h
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/lac/sparse_matrix.h>
 
 #include <cmath>
@@ -93,6 +95,22 @@ DEAL_II_NAMESPACE_OPEN
  * restrictions on the sparsity see section `Fill-in' above).
  *
  *
+ * <h3>Parallel application</h3>
+ * The forward and backward substitutions in the vmult() functions of
+ * SparseILU and SparseMIC can use several threads: When the decomposition
+ * is computed, the rows are grouped into levels such that the rows of one
+ * level only depend on rows of earlier levels (level scheduling). The
+ * substitutions then process the levels one after the other and the rows
+ * within one level in parallel. Since the levels only depend on the
+ * sparsity pattern, the schedule is reused when the decomposition is
+ * recomputed with <code>use_previous_sparsity=true</code> as well as by all
+ * applications of the preconditioner. The result is the same as for the
+ * sequential substitutions. How many rows can be processed in parallel
+ * depends on the numbering of the unknowns: A Cuthill-McKee numbering gives
+ * wide levels, whereas a numbering along a line of cells results in long
+ * chains of dependent rows, in which case the rows are processed
+ * sequentially. The transpose operation Tvmult() is always sequential.
+ *
  * <h3>Particular implementations</h3>
  *
  * It is enough to override the initialize() and vmult() methods to implement
@@ -313,11 +331,56 @@ protected:
   std::vector<const size_type *> prebuilt_lower_bound;
 
   /**
-   * Fills the #prebuilt_lower_bound array.
+   * Fills the #prebuilt_lower_bound array and the level schedules of the
+   * forward and backward substitutions.
    */
   void prebuild_lower_bound ();
 
+  /**
+   * The level schedule of the forward substitution with the lower
+   * triangular factor: Level zero contains the rows without entries left of
+   * the diagonal, and each further level the rows that only depend on rows
+   * of earlier levels. Thus, the rows of one level can be processed in
+   * parallel. The rows of level <tt>l</tt> are stored in
+   * <tt>forward_level_rows[forward_level_start[l]]</tt> to
+   * <tt>forward_level_rows[forward_level_start[l+1]-1]</tt>. Becomes
+   * available after invocation of prebuild_lower_bound().
+   */
+  std::vector<size_type> forward_level_rows;
+  std::vector<size_type> forward_level_start;
+
+  /**
+   * The level schedule of the backward substitution with the upper
+   * triangular factor, in the same format as #forward_level_rows.
+   */
+  std::vector<size_type> backward_level_rows;
+  std::vector<size_type> backward_level_start;
+
+  /**
+   * Call @p worker for all rows given by the level schedule @p level_rows
+   * and @p level_start one level after the other, such that all rows a row
+   * depends on have been processed before. The rows within a level are
+   * processed in parallel if multiple threads are available and the levels
+   * contain enough rows on average. Otherwise, the rows are processed one at
+   * a time in ascending order if @p ascending is true or in descending order
+   * otherwise, which is the natural order of the forward and backward
+   * substitution, respectively. Since a row only reads results of the rows
+   * it depends on, the result does not depend on the order.
+   */
+  template <typename Worker>
+  void apply_level_schedule (const std::vector<size_type> &level_rows,
+                             const std::vector<size_type> &level_start,
+                             const bool                    ascending,
+                             const Worker                 &worker) const;
+
 private:
+  /**
+   * Sort the rows by the given @p level into the level schedule given by
+   * @p level_rows and @p level_start.
+   */
+  static void sort_rows_by_level (const std::vector<size_type> &level,
+                                  std::vector<size_type>       &level_rows,
+                                  std::vector<size_type>       &level_start);
 
   /**
    * In general this pointer is zero except for the case that no
@@ -370,6 +433,49 @@ SparseLUDecomposition<number>::n () const
   return SparseMatrix<number>::n();
 }
 
+template <typename number>
+template <typename Worker>
+inline void
+SparseLUDecomposition<number>::apply_level_schedule
+(const std::vector<size_type> &level_rows,
+ const std::vector<size_type> &level_start,
+ const bool                    ascending,
+ const Worker                 &worker) const
+{
+  const size_type N = level_rows.size();
+  const size_type n_levels = level_start.empty() ? 0 : level_start.size()-1;
+  const unsigned int grain_size = internal::SparseMatrix::minimum_parallel_grain_size;
+
+  if (MultithreadInfo::n_threads() == 1 || n_levels * grain_size > N)
+    {
+      if (ascending)
+        for (size_type row=0; row<N; ++row)
+          worker (row);
+      else
+        for (size_type row=N; row>0; --row)
+          worker (row-1);
+      return;
+    }
+
+  for (size_type level=0; level<n_levels; ++level)
+    {
+      if (level_start[level+1]-level_start[level] < grain_size)
+        for (size_type i=level_start[level]; i<level_start[level+1]; ++i)
+          worker (level_rows[i]);
+      else
+        parallel::apply_to_subranges (level_start[level], level_start[level+1],
+                                      [&level_rows,&worker] (const size_type begin,
+                                                             const size_type end)
+        {
+          for (size_type i=begin; i<end; ++i)
+            worker (level_rows[i]);
+        },
+        grain_size);
+    }
+}
+
+
+
 // Note: This function is required for full compatibility with
 // the LinearOperator class. ::MatrixInterfaceWithVmultAdd
 // picks up the vmult_add function in the protected SparseMatrix
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2002 - 2016 by the deal.II authors
+// Copyright (C) 2002 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -49,6 +49,10 @@ void SparseLUDecomposition<number>::clear()
 {
   std::vector<const size_type *> tmp;
   tmp.swap (prebuilt_lower_bound);
+  forward_level_rows.clear();
+  forward_level_start.clear();
+  backward_level_rows.clear();
+  backward_level_start.clear();
 
   SparseMatrix<number>::clear();
 
@@ -149,6 +153,55 @@ SparseLUDecomposition<number>::prebuild_lower_bound()
                                   &column_numbers[rowstart_indices[row+1]],
                                   row);
     }
+
+  // compute the levels of the forward substitution: a row can be
+  // processed once all rows left of the diagonal have been processed
+  std::vector<size_type> level (N);
+  for (size_type row=0; row<N; ++row)
+    {
+      size_type row_level = 0;
+      for (const size_type *col=&column_numbers[rowstart_indices[row]+1];
+           col!=prebuilt_lower_bound[row]; ++col)
+        row_level = std::max(row_level, level[*col]+1);
+      level[row] = row_level;
+    }
+  sort_rows_by_level (level, forward_level_rows, forward_level_start);
+
+  // same for the backward substitution with the rows right of the diagonal
+  for (size_type row=N; row>0; --row)
+    {
+      size_type row_level = 0;
+      for (const size_type *col=prebuilt_lower_bound[row-1];
+           col!=&column_numbers[rowstart_indices[row]]; ++col)
+        row_level = std::max(row_level, level[*col]+1);
+      level[row-1] = row_level;
+    }
+  sort_rows_by_level (level, backward_level_rows, backward_level_start);
+}
+
+
+
+template <typename number>
+void
+SparseLUDecomposition<number>::sort_rows_by_level
+(const std::vector<size_type> &level,
+ std::vector<size_type>       &level_rows,
+ std::vector<size_type>       &level_start)
+{
+  const size_type n_levels = level.empty() ? 0 :
+                             *std::max_element(level.begin(), level.end())+1;
+  level_start.clear();
+  level_start.resize (n_levels+1, 0);
+  for (size_type row=0; row<level.size(); ++row)
+    ++level_start[level[row]+1];
+  for (size_type l=0; l<n_levels; ++l)
+    level_start[l+1] += level_start[l];
+
+  // sort the rows of each level in ascending order by a counting sort
+  level_rows.resize (level.size());
+  std::vector<size_type> position (level_start.begin(), level_start.end()-1);
+  for (size_type row=0; row<level.size(); ++row)
+    level_rows[position[level[row]]++] = row;
 }
 
 template <typename number>
@@ -228,7 +281,11 @@ std::size_t
 SparseLUDecomposition<number>::memory_consumption () const
 {
   return (SparseMatrix<number>::memory_consumption () +
-          MemoryConsumption::memory_consumption(prebuilt_lower_bound));
+          MemoryConsumption::memory_consumption(prebuilt_lower_bound) +
+          MemoryConsumption::memory_consumption(forward_level_rows) +
+          MemoryConsumption::memory_consumption(forward_level_start) +
+          MemoryConsumption::memory_consumption(backward_level_rows) +
+          MemoryConsumption::memory_consumption(backward_level_start));
 }
 
 
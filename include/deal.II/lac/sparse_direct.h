@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2001 - 2016 by the deal.II authors
+// Copyright (C) 2001 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -35,6 +35,8 @@
 
 DEAL_II_NAMESPACE_OPEN
 
+template <typename number> class FullMatrix;
+
 /**
  * This class provides an interface to the sparse direct solver UMFPACK, which
  * is part of the SuiteSparse library (see <a
@@ -57,6 +59,19 @@ DEAL_II_NAMESPACE_OPEN
  * class provides an older interface, consisting of the functions factorize()
  * and solve(). Both interfaces are interchangeable.
  *
+ * <h4>Reusing the factorization</h4>
+ *
+ * The factorization consists of a symbolic phase that only depends on the
+ * positions of the nonzero entries (column ordering and analysis of the
+ * elimination tree) and a numeric phase that computes the actual LU factors.
+ * When a sequence of matrices with the same sparsity pattern is factorized,
+ * e.g. in the iterations of a Newton method or in the time steps of an
+ * implicit time integrator, the function refactorize() reuses the symbolic
+ * decomposition of the previous factorization and only recomputes the
+ * numeric part. Furthermore, the function solve(FullMatrix<double>&,bool)
+ * solves for all columns of a matrix of right hand sides with a single
+ * factorization, working on several columns concurrently.
+ *
  * @note This class exists if the <a
  * href="http://faculty.cse.tamu.edu/davis/suitesparse.html">UMFPACK</a>
  * interface was not explicitly disabled during configuration.
@@ -126,7 +141,9 @@ public:
    * time if you want to invert several matrices with the same sparsity
    * pattern. However, note that the bulk of the computing time is actually
    * spent in the factorization, so this functionality may not always be of
-   * large benefit.
+   * large benefit. See refactorize() for a way to at least skip the symbolic
+   * part of the factorization for matrices with an unchanged sparsity
+   * pattern.
    *
    * In contrast to the other direct solver classes, the initialization method
    * does nothing. Therefore initialize is not automatically called by this
@@ -139,6 +156,23 @@ public:
   template <class Matrix>
   void factorize (const Matrix &matrix);
 
+  /**
+   * Factorize the matrix, reusing the symbolic decomposition computed by the
+   * previous call to factorize() or refactorize() if the matrix has the same
+   * sparsity pattern, i.e., the same entries in the same positions, as the
+   * matrix factorized before. In that case, only UMFPACK's numeric
+   * factorization is run, which saves the time for the fill-reducing ordering
+   * and the symbolic analysis. If the sparsity pattern has changed or no
+   * factorization has been computed yet, this function does the same as
+   * factorize().
+   *
+   * Since the symbolic decomposition determines the pivot order, reusing it
+   * for a matrix whose entries differ a lot from the original one may lead
+   * to a less stable factorization.
+   */
+  template <class Matrix>
+  void refactorize (const Matrix &matrix);
+
   /**
    * Initialize memory and call SparseDirectUMFPACK::factorize.
    */
@@ -235,6 +269,17 @@ public:
   void solve (BlockVector<double> &rhs_and_solution,
               const bool           transpose = false) const;
 
+  /**
+   * Same as before, but for several right hand sides at once: each column of
+   * @p rhs_and_solution is a right hand side vector and is replaced by the
+   * corresponding solution. The number of rows of the matrix must equal the
+   * size of the factorized matrix. Since UMFPACK's solve phase only reads
+   * from the factorization, the columns are processed in parallel on the
+   * available threads.
+   */
+  void solve (FullMatrix<double> &rhs_and_solution,
+              const bool          transpose = false) const;
+
   /**
    * Call the two functions factorize() and solve() in that order, i.e.
    * perform the whole solution process for the given right hand side vector.
@@ -321,6 +366,21 @@ private:
    */
   void clear ();
 
+  /**
+   * Copy the entries of the given matrix into the arrays Ap, Ai, and Ax in
+   * the sorted format UMFPACK wants.
+   */
+  template <class Matrix>
+  void copy_matrix_to_arrays (const Matrix &matrix);
+
+  /**
+   * Run the symbolic and numeric phases of UMFPACK's factorization on the
+   * arrays Ap, Ai, and Ax, respectively, freeing previously computed
+   * decompositions first.
+   */
+  void compute_symbolic_decomposition ();
+  void compute_numeric_decomposition ();
+
   /**
    * Make sure that the arrays Ai and Ap are sorted in each row. UMFPACK wants
    * it this way. We need to have three versions of this function, one for the
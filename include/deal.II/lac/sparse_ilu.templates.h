@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2015 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -140,11 +140,11 @@ void SparseILU<number>::vmult (Vector<somenumber>       &dst,
   Assert (dst.size() == src.size(), ExcDimensionMismatch(dst.size(), src.size()));
   Assert (dst.size() == this->m(), ExcDimensionMismatch(dst.size(), this->m()));
 
-  const size_type N=dst.size();
   const std::size_t *const rowstart_indices
     = this->get_sparsity_pattern().rowstart.get();
   const size_type *const column_numbers
     = this->get_sparsity_pattern().colnums.get();
+  const number *const luval_start = this->SparseMatrix<number>::val.get();
 
   // solve LUx=b in two steps:
   // first Ly = b, then
@@ -157,24 +157,29 @@ void SparseILU<number>::vmult (Vector<somenumber>       &dst,
   //       - sum_{j=0}^{i-1} L_{ij}y_j
   // we split the y_i = b_i off and
   // perform it at the outset of the
-  // loop
+  // loop. the rows are processed in
+  // the order given by the level
+  // schedule, which allows to work
+  // on the rows of one level in
+  // parallel
   dst = src;
-  for (size_type row=0; row<N; ++row)
-    {
-      // get start of this row. skip the
-      // diagonal element
-      const size_type *const rowstart = &column_numbers[rowstart_indices[row]+1];
-      // find the position where the part
-      // right of the diagonal starts
-      const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
-
-      somenumber dst_row = dst(row);
-      const number *luval = this->SparseMatrix<number>::val.get() +
-                            (rowstart - column_numbers);
-      for (const size_type *col=rowstart; col!=first_after_diagonal; ++col, ++luval)
-        dst_row -= *luval * dst(*col);
-      dst(row) = dst_row;
-    }
+  this->apply_level_schedule
+  (this->forward_level_rows, this->forward_level_start, true,
+   [&] (const size_type row)
+  {
+    // get start of this row. skip the
+    // diagonal element
+    const size_type *const rowstart = &column_numbers[rowstart_indices[row]+1];
+    // find the position where the part
+    // right of the diagonal starts
+    const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
+
+    somenumber dst_row = dst(row);
+    const number *luval = luval_start + (rowstart - column_numbers);
+    for (const size_type *col=rowstart; col!=first_after_diagonal; ++col, ++luval)
+      dst_row -= *luval * dst(*col);
+    dst(row) = dst_row;
+  });
 
   // now the backward solve. same
   // procedure, but we need not set
@@ -184,25 +189,26 @@ void SparseILU<number>::vmult (Vector<somenumber>       &dst,
   // note that we need to scale now,
   // since the diagonal is not equal to
   // one now
-  for (int row=N-1; row>=0; --row)
-    {
-      // get end of this row
-      const size_type *const rowend = &column_numbers[rowstart_indices[row+1]];
-      // find the position where the part
-      // right of the diagonal starts
-      const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
-
-      somenumber dst_row = dst(row);
-      const number *luval = this->SparseMatrix<number>::val.get() +
-                            (first_after_diagonal - column_numbers);
-      for (const size_type *col=first_after_diagonal; col!=rowend; ++col, ++luval)
-        dst_row -= *luval * dst(*col);
-
-      // scale by the diagonal element.
-      // note that the diagonal element
-      // was stored inverted
-      dst(row) = dst_row * this->diag_element(row);
-    }
+  this->apply_level_schedule
+  (this->backward_level_rows, this->backward_level_start, false,
+   [&] (const size_type row)
+  {
+    // get end of this row
+    const size_type *const rowend = &column_numbers[rowstart_indices[row+1]];
+    // find the position where the part
+    // right of the diagonal starts
+    const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
+
+    somenumber dst_row = dst(row);
+    const number *luval = luval_start + (first_after_diagonal - column_numbers);
+    for (const size_type *col=first_after_diagonal; col!=rowend; ++col, ++luval)
+      dst_row -= *luval * dst(*col);
+
+    // scale by the diagonal element.
+    // note that the diagonal element
+    // was stored inverted
+    dst(row) = dst_row * this->diag_element(row);
+  });
 }
 
 
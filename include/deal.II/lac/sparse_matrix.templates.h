@@ -21,6 +21,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/parallel.h>
+#include <deal.II/base/performance_counters.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/lac/sparse_matrix.h>
@@ -186,26 +187,27 @@ SparseMatrix<number>::operator = (const double d)
   Assert (cols != nullptr, ExcNotInitialized());
   Assert (cols->compressed || cols->empty(), SparsityPattern::ExcNotCompressed());
 
-  // do initial zeroing of elements in parallel. Try to achieve a similar
-  // layout as when doing matrix-vector products, as on some NUMA systems, a
-  // memory block is assigned to memory banks where the first access is
-  // generated. For sparse matrices, the first operations is usually the
-  // operator=. The grain size is chosen to reflect the number of rows in
-  // minimum_parallel_grain_size, weighted by the number of nonzero entries
-  // per row on average.
+  // do initial zeroing of elements in parallel. For sparse matrices, the
+  // first operation is usually the operator=, which therefore decides on the
+  // memory bank a memory page is assigned to on NUMA systems. Hence, split
+  // the work by rows with the same partitioning and the same (affinity
+  // preserving) thread partitioner of the sparsity pattern that is also used
+  // in the matrix-vector products.
   const std::size_t matrix_size = cols->n_nonzero_elements();
-  const size_type grain_size =
-    internal::SparseMatrix::minimum_parallel_grain_size *
-    (cols->n_nonzero_elements()+m()) / m();
-  if (matrix_size>grain_size)
-    parallel::apply_to_subranges (0U, matrix_size,
-                                  std::bind(&internal::SparseMatrix::template
-                                            zero_subrange<number>,
-                                            std::placeholders::_1, std::placeholders::_2,
-                                            val.get()),
-                                  grain_size);
-  else if (matrix_size > 0)
-    std::memset (val.get(), 0, matrix_size*sizeof(number));
+  if (matrix_size > 0)
+    {
+      number *values = val.get();
+      const std::size_t *rowstart = cols->rowstart.get();
+      parallel::apply_to_subranges
+      (0, m(),
+       [values,rowstart] (const std::size_t begin, const std::size_t end)
+      {
+        internal::SparseMatrix::zero_subrange (rowstart[begin], rowstart[end],
+                                               values);
+      },
+      internal::SparseMatrix::minimum_parallel_grain_size,
+      *cols->thread_loop_partitioner);
+    }
 
   return *this;
 }
@@ -752,6 +754,7 @@ SparseMatrix<number>::vmult (OutVector &dst,
 
   Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
 
+  const PerformanceCounters::Region counter_region("SparseMatrix::vmult");
   parallel::apply_to_subranges (0U, m(),
                                 std::bind (&internal::SparseMatrix::vmult_on_subrange
                                            <number,InVector,OutVector>,
@@ -762,7 +765,8 @@ SparseMatrix<number>::vmult (OutVector &dst,
                                            std::cref(src),
                                            std::ref(dst),
                                            false),
-                                internal::SparseMatrix::minimum_parallel_grain_size);
+                                internal::SparseMatrix::minimum_parallel_grain_size,
+                                *cols->thread_loop_partitioner);
 }
 
 
@@ -817,7 +821,8 @@ SparseMatrix<number>::vmult_add (OutVector &dst,
                                            std::cref(src),
                                            std::ref(dst),
                                            true),
-                                internal::SparseMatrix::minimum_parallel_grain_size);
+                                internal::SparseMatrix::minimum_parallel_grain_size,
+                                *cols->thread_loop_partitioner);
 }
 
 
@@ -0,0 +1,1026 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_matrix_compressed_index_h
+#define dealii_sparse_matrix_compressed_index_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*! @addtogroup Matrix1
+ *@{
+ */
+
+/**
+ * A sparse matrix in compressed row storage whose column indices are stored
+ * with fewer bits than SparsityPattern uses. For each row, the smallest
+ * column index is stored as the base of the row, and the entries only store
+ * the distance of their column to this base, as 16 bit integers if the
+ * distance between the smallest and largest column of every row fits into
+ * this range, and as 32 bit integers otherwise. The column indices are
+ * decoded on the fly when the matrix is applied.
+ *
+ * The matrix-vector product of a sparse matrix is limited by the memory
+ * bandwidth, to which the column indices contribute as much as the values
+ * for matrices of type <tt>float</tt>, or half as much for matrices of type
+ * <tt>double</tt> if deal.II is configured with 64 bit indices, see
+ * @ref GlobalDoFIndex, where a SparsityPattern stores each column index in
+ * 64 bits. Storing the indices in 16 bits thus reduces the data transferred
+ * for <tt>double</tt> matrices by up to 40 percent with 64 bit indices, and
+ * by up to 25 percent with 32 bit indices. Finite element matrices have a
+ * small range of columns per row once the degrees of freedom have been
+ * renumbered to reduce the bandwidth, e.g. by DoFRenumbering::Cuthill_McKee();
+ * bits_per_index() tells which storage was selected.
+ *
+ * Objects of this class are created from a SparseMatrix by reinit(), which
+ * both sets up the index storage and copies the values; the order of
+ * entries within each row is the one of the SparsityPattern, i.e., the
+ * diagonal entry of square matrices is stored first. If only the values
+ * change, copy_from() transfers the new values without recomputing the
+ * indices. Besides the matrix-vector products, the class provides what is
+ * needed for PreconditionJacobi and read access to the entries by iterators
+ * that are decoded in the same way.
+ */
+template <typename number>
+class SparseMatrixCompressedIndex : public virtual Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Type of the matrix entries.
+   */
+  typedef number value_type;
+
+  /**
+   * Accessor to the entries of the matrix, giving the row, the decoded
+   * column, and the value of an entry.
+   */
+  class Accessor
+  {
+  public:
+    /**
+     * Row number of the entry.
+     */
+    size_type row () const;
+
+    /**
+     * Column number of the entry.
+     */
+    size_type column () const;
+
+    /**
+     * Value of the entry.
+     */
+    number value () const;
+
+  private:
+    /**
+     * Constructor, setting the row such that the accessor does not point to
+     * the end of an empty row.
+     */
+    Accessor (const SparseMatrixCompressedIndex<number> *matrix,
+              const size_type                            row,
+              const std::size_t                          index);
+
+    /**
+     * Move to the next entry of the matrix.
+     */
+    void advance ();
+
+    /**
+     * The matrix accessed.
+     */
+    const SparseMatrixCompressedIndex<number> *matrix;
+
+    /**
+     * The current row.
+     */
+    size_type current_row;
+
+    /**
+     * The position of the current entry in the arrays of the matrix.
+     */
+    std::size_t index;
+
+    template <typename> friend class SparseMatrixCompressedIndex;
+  };
+
+  /**
+   * Iterator over the entries of the matrix, row by row.
+   */
+  class const_iterator
+  {
+  public:
+    /**
+     * Constructor for the iterator pointing to the given position.
+     */
+    const_iterator (const SparseMatrixCompressedIndex<number> *matrix,
+                    const size_type                            row,
+                    const std::size_t                          index);
+
+    /**
+     * Prefix increment.
+     */
+    const_iterator &operator++ ();
+
+    /**
+     * Dereferencing operator.
+     */
+    const Accessor &operator* () const;
+
+    /**
+     * Dereferencing operator.
+     */
+    const Accessor *operator-> () const;
+
+    /**
+     * Comparison. True if both iterators point to the same matrix entry.
+     */
+    bool operator == (const const_iterator &other) const;
+
+    /**
+     * Inverse of <tt>==</tt>.
+     */
+    bool operator != (const const_iterator &other) const;
+
+    /**
+     * Comparison operator. True if this iterator points to an entry before
+     * the entry of @p other.
+     */
+    bool operator < (const const_iterator &other) const;
+
+  private:
+    /**
+     * The accessor holding the position.
+     */
+    Accessor accessor;
+  };
+
+  /**
+   * Constructor. Create an empty matrix.
+   */
+  SparseMatrixCompressedIndex ();
+
+  /**
+   * Set up the index storage from the sparsity pattern of @p matrix and copy
+   * its values.
+   */
+  template <typename number2>
+  void reinit (const SparseMatrix<number2> &matrix);
+
+  /**
+   * Set up the index storage from @p sparsity with all values set to zero.
+   */
+  void reinit (const SparsityPattern &sparsity);
+
+  /**
+   * Copy the values of @p matrix into this object, which must have been set
+   * up with the sparsity pattern of @p matrix.
+   */
+  template <typename number2>
+  void copy_from (const SparseMatrix<number2> &matrix);
+
+  /**
+   * Release all memory and return to a state just like after having called
+   * the default constructor.
+   */
+  void clear ();
+
+  /**
+   * Return the number of rows of the matrix.
+   */
+  size_type m () const;
+
+  /**
+   * Return the number of columns of the matrix.
+   */
+  size_type n () const;
+
+  /**
+   * Return the number of entries of the matrix.
+   */
+  std::size_t n_nonzero_elements () const;
+
+  /**
+   * Return the number of bits used to store the offset of each column
+   * index, 16 or 32, or zero if the matrix is empty.
+   */
+  unsigned int bits_per_index () const;
+
+  /**
+   * Return the value of the entry (<i>i,j</i>), or zero if the entry is not
+   * in the sparsity pattern.
+   */
+  number el (const size_type i,
+             const size_type j) const;
+
+  /**
+   * Return the main diagonal element in the <i>i</i>th row. The matrix
+   * must be square.
+   */
+  number diag_element (const size_type i) const;
+
+  /**
+   * Matrix-vector multiplication: let <i>dst = M*src</i>. The vectors must
+   * provide contiguous storage accessible through <code>begin()</code>
+   * holding numbers of type @p number, as e.g. Vector or
+   * LinearAlgebra::distributed::Vector in serial.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <class VectorType>
+  void vmult (VectorType       &dst,
+              const VectorType &src) const;
+
+  /**
+   * Adding matrix-vector multiplication: add <i>M*src</i> to <i>dst</i>.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <class VectorType>
+  void vmult_add (VectorType       &dst,
+                  const VectorType &src) const;
+
+  /**
+   * Transpose matrix-vector multiplication: let <i>dst =
+   * M<sup>T</sup>*src</i>. This operation is not parallelized.
+   */
+  template <class VectorType>
+  void Tvmult (VectorType       &dst,
+               const VectorType &src) const;
+
+  /**
+   * Adding transpose matrix-vector multiplication: add
+   * <i>M<sup>T</sup>*src</i> to <i>dst</i>.
+   */
+  template <class VectorType>
+  void Tvmult_add (VectorType       &dst,
+                   const VectorType &src) const;
+
+  /**
+   * Apply the Jacobi preconditioner, which multiplies every element of the
+   * @p src vector by the inverse of the respective diagonal element and
+   * multiplies the result with the relaxation factor @p omega.
+   */
+  template <class VectorType>
+  void precondition_Jacobi (VectorType       &dst,
+                            const VectorType &src,
+                            const number      omega = 1.) const;
+
+  /**
+   * Do one Jacobi step on @p v, i.e., set <i>v = v + omega
+   * D<sup>-1</sup>(b-Av)</i>.
+   */
+  template <class VectorType>
+  void Jacobi_step (VectorType       &v,
+                    const VectorType &b,
+                    const number      omega = 1.) const;
+
+  /**
+   * Iterator to the first entry of row @p r, or to the first entry of the
+   * next nonempty row if row @p r is empty.
+   */
+  const_iterator begin (const size_type r = 0) const;
+
+  /**
+   * Iterator to the position past the last entry of row @p r, or to the
+   * end of the matrix if no row with entries follows.
+   */
+  const_iterator end (const size_type r) const;
+
+  /**
+   * Iterator to the end of the matrix.
+   */
+  const_iterator end () const;
+
+  /**
+   * Return the memory consumption of this object in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg (ExcSourceEqualsDestination,
+                    "You are attempting an operation on two matrices that "
+                    "are the same object, but the operation requires that the "
+                    "two objects are in fact different.");
+
+private:
+  /**
+   * Perform the matrix-vector product on the rows in [begin, end), with the
+   * column offsets stored in @p offsets.
+   */
+  template <typename OffsetType>
+  void vmult_on_rows (const size_type   begin,
+                      const size_type   end,
+                      const OffsetType *offsets,
+                      const number     *src,
+                      number           *dst,
+                      const bool        add) const;
+
+  /**
+   * Run the matrix-vector product in parallel with the offsets of the
+   * selected width.
+   */
+  void vmult_impl (const number *src,
+                   number       *dst,
+                   const bool    add) const;
+
+  /**
+   * Return the column of the entry at position @p index within the arrays
+   * of the matrix, which is in row @p row.
+   */
+  size_type decode_column (const size_type   row,
+                           const std::size_t index) const;
+
+  /**
+   * Number of rows.
+   */
+  size_type n_rows;
+
+  /**
+   * Number of columns.
+   */
+  size_type n_cols;
+
+  /**
+   * The position of the first entry of each row in the arrays of offsets
+   * and values. Has one more element than there are rows.
+   */
+  std::vector<std::size_t> row_start;
+
+  /**
+   * The smallest column index in each row.
+   */
+  std::vector<size_type> row_base;
+
+  /**
+   * The column offsets with respect to the row base if 16 bits suffice for
+   * all rows, empty otherwise.
+   */
+  std::vector<std::uint16_t> offsets_16;
+
+  /**
+   * The column offsets with respect to the row base if 16 bits do not
+   * suffice for all rows, empty otherwise.
+   */
+  std::vector<std::uint32_t> offsets_32;
+
+  /**
+   * The matrix entries.
+   */
+  std::vector<number> values;
+};
+
+/*@}*/
+
+
+/*---------------------- Inline functions -----------------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename number>
+inline
+SparseMatrixCompressedIndex<number>::Accessor::Accessor
+(const SparseMatrixCompressedIndex<number> *matrix,
+ const size_type                            row,
+ const std::size_t                          index)
+  :
+  matrix (matrix),
+  current_row (row),
+  index (index)
+{
+  while (current_row < matrix->n_rows &&
+         index == matrix->row_start[current_row+1])
+    ++current_row;
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixCompressedIndex<number>::size_type
+SparseMatrixCompressedIndex<number>::Accessor::row () const
+{
+  Assert (current_row < matrix->n_rows, ExcIteratorPastEnd());
+  return current_row;
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixCompressedIndex<number>::size_type
+SparseMatrixCompressedIndex<number>::Accessor::column () const
+{
+  Assert (current_row < matrix->n_rows, ExcIteratorPastEnd());
+  return matrix->decode_column(current_row, index);
+}
+
+
+
+template <typename number>
+inline
+number
+SparseMatrixCompressedIndex<number>::Accessor::value () const
+{
+  Assert (current_row < matrix->n_rows, ExcIteratorPastEnd());
+  return matrix->values[index];
+}
+
+
+
+template <typename number>
+inline
+void
+SparseMatrixCompressedIndex<number>::Accessor::advance ()
+{
+  Assert (current_row < matrix->n_rows, ExcIteratorPastEnd());
+  ++index;
+  while (current_row < matrix->n_rows &&
+         index == matrix->row_start[current_row+1])
+    ++current_row;
+}
+
+
+
+template <typename number>
+inline
+SparseMatrixCompressedIndex<number>::const_iterator::const_iterator
+(const SparseMatrixCompressedIndex<number> *matrix,
+ const size_type                            row,
+ const std::size_t                          index)
+  :
+  accessor (matrix, row, index)
+{}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixCompressedIndex<number>::const_iterator &
+SparseMatrixCompressedIndex<number>::const_iterator::operator++ ()
+{
+  accessor.advance();
+  return *this;
+}
+
+
+
+template <typename number>
+inline
+const typename SparseMatrixCompressedIndex<number>::Accessor &
+SparseMatrixCompressedIndex<number>::const_iterator::operator* () const
+{
+  return accessor;
+}
+
+
+
+template <typename number>
+inline
+const typename SparseMatrixCompressedIndex<number>::Accessor *
+SparseMatrixCompressedIndex<number>::const_iterator::operator-> () const
+{
+  return &accessor;
+}
+
+
+
+template <typename number>
+inline
+bool
+SparseMatrixCompressedIndex<number>::const_iterator::operator ==
+(const const_iterator &other) const
+{
+  return (accessor.matrix == other.accessor.matrix &&
+          accessor.index == other.accessor.index);
+}
+
+
+
+template <typename number>
+inline
+bool
+SparseMatrixCompressedIndex<number>::const_iterator::operator !=
+(const const_iterator &other) const
+{
+  return !(*this == other);
+}
+
+
+
+template <typename number>
+inline
+bool
+SparseMatrixCompressedIndex<number>::const_iterator::operator <
+(const const_iterator &other) const
+{
+  Assert (accessor.matrix == other.accessor.matrix, ExcInternalError());
+  return accessor.index < other.accessor.index;
+}
+
+
+
+template <typename number>
+inline
+SparseMatrixCompressedIndex<number>::SparseMatrixCompressedIndex ()
+  :
+  n_rows (0),
+  n_cols (0)
+{}
+
+
+
+template <typename number>
+inline
+void
+SparseMatrixCompressedIndex<number>::clear ()
+{
+  n_rows = 0;
+  n_cols = 0;
+  row_start.clear();
+  row_base.clear();
+  offsets_16.clear();
+  offsets_32.clear();
+  values.clear();
+}
+
+
+
+template <typename number>
+inline
+void
+SparseMatrixCompressedIndex<number>::reinit (const SparsityPattern &sparsity)
+{
+  Assert (sparsity.is_compressed(), SparsityPattern::ExcNotCompressed());
+
+  clear();
+  n_rows = sparsity.n_rows();
+  n_cols = sparsity.n_cols();
+
+  // find the base of each row and the largest distance of a column to it,
+  // which determines the width of the offsets
+  row_start.resize(n_rows+1);
+  row_base.resize(n_rows);
+  row_start[0] = 0;
+  size_type max_offset = 0;
+  for (size_type row=0; row<n_rows; ++row)
+    {
+      row_start[row+1] = row_start[row] + sparsity.row_length(row);
+      size_type min_col = numbers::invalid_size_type, max_col = 0;
+      for (SparsityPattern::iterator it=sparsity.begin(row);
+           it != sparsity.end(row); ++it)
+        {
+          min_col = std::min<size_type>(min_col, it->column());
+          max_col = std::max<size_type>(max_col, it->column());
+        }
+      row_base[row] = row_start[row+1] > row_start[row] ? min_col : 0;
+      if (row_start[row+1] > row_start[row])
+        max_offset = std::max(max_offset, max_col - min_col);
+    }
+  AssertThrow (max_offset <= std::numeric_limits<std::uint32_t>::max(),
+               ExcMessage("The columns within a row of this sparsity pattern "
+                          "span more than 2^32 indices, which cannot be "
+                          "represented by SparseMatrixCompressedIndex."));
+
+  const bool use_16_bit = max_offset <= std::numeric_limits<std::uint16_t>::max();
+  if (use_16_bit)
+    offsets_16.resize(row_start[n_rows]);
+  else
+    offsets_32.resize(row_start[n_rows]);
+  for (size_type row=0; row<n_rows; ++row)
+    {
+      std::size_t index = row_start[row];
+      for (SparsityPattern::iterator it=sparsity.begin(row);
+           it != sparsity.end(row); ++it, ++index)
+        if (use_16_bit)
+          offsets_16[index] = static_cast<std::uint16_t>(it->column() - row_base[row]);
+        else
+          offsets_32[index] = static_cast<std::uint32_t>(it->column() - row_base[row]);
+    }
+
+  values.resize(row_start[n_rows], number());
+}
+
+
+
+template <typename number>
+template <typename number2>
+inline
+void
+SparseMatrixCompressedIndex<number>::reinit (const SparseMatrix<number2> &matrix)
+{
+  reinit (matrix.get_sparsity_pattern());
+  copy_from (matrix);
+}
+
+
+
+template <typename number>
+template <typename number2>
+inline
+void
+SparseMatrixCompressedIndex<number>::copy_from (const SparseMatrix<number2> &matrix)
+{
+  AssertDimension (matrix.m(), m());
+  AssertDimension (matrix.n(), n());
+  AssertDimension (matrix.n_nonzero_elements(), n_nonzero_elements());
+
+  for (size_type row=0; row<n_rows; ++row)
+    {
+      std::size_t index = row_start[row];
+      for (typename SparseMatrix<number2>::const_iterator it=matrix.begin(row);
+           it != matrix.end(row); ++it, ++index)
+        {
+          Assert (index < row_start[row+1] &&
+                  decode_column(row, index) == it->column(),
+                  ExcMessage("The sparsity pattern of the given matrix does "
+                             "not match the one this object was set up with"));
+          values[index] = it->value();
+        }
+    }
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixCompressedIndex<number>::size_type
+SparseMatrixCompressedIndex<number>::m () const
+{
+  return n_rows;
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixCompressedIndex<number>::size_type
+SparseMatrixCompressedIndex<number>::n () const
+{
+  return n_cols;
+}
+
+
+
+template <typename number>
+inline
+std::size_t
+SparseMatrixCompressedIndex<number>::n_nonzero_elements () const
+{
+  return values.size();
+}
+
+
+
+template <typename number>
+inline
+unsigned int
+SparseMatrixCompressedIndex<number>::bits_per_index () const
+{
+  if (offsets_16.size() > 0)
+    return 16;
+  else if (offsets_32.size() > 0)
+    return 32;
+  else
+    return 0;
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixCompressedIndex<number>::size_type
+SparseMatrixCompressedIndex<number>::decode_column (const size_type   row,
+                                                    const std::size_t index) const
+{
+  AssertIndexRange (index, values.size());
+  return row_base[row] + (offsets_16.size() > 0 ?
+                          static_cast<size_type>(offsets_16[index]) :
+                          static_cast<size_type>(offsets_32[index]));
+}
+
+
+
+template <typename number>
+inline
+number
+SparseMatrixCompressedIndex<number>::el (const size_type i,
+                                         const size_type j) const
+{
+  AssertIndexRange (i, m());
+  AssertIndexRange (j, n());
+  for (std::size_t index=row_start[i]; index<row_start[i+1]; ++index)
+    if (decode_column(i, index) == j)
+      return values[index];
+  return number();
+}
+
+
+
+template <typename number>
+inline
+number
+SparseMatrixCompressedIndex<number>::diag_element (const size_type i) const
+{
+  Assert (m() == n(), ExcNotQuadratic());
+  AssertIndexRange (i, m());
+  Assert (row_start[i+1] > row_start[i] && decode_column(i, row_start[i]) == i,
+          ExcInternalError());
+
+  // the diagonal is stored first in each row of a square matrix
+  return values[row_start[i]];
+}
+
+
+
+template <typename number>
+template <typename OffsetType>
+inline
+void
+SparseMatrixCompressedIndex<number>::vmult_on_rows (const size_type   begin,
+                                                    const size_type   end,
+                                                    const OffsetType *offsets,
+                                                    const number     *src,
+                                                    number           *dst,
+                                                    const bool        add) const
+{
+  const number *val_ptr = values.data() + row_start[begin];
+  const OffsetType *offset_ptr = offsets + row_start[begin];
+  for (size_type row=begin; row<end; ++row)
+    {
+      // shift the source pointer by the base of the row, such that only the
+      // short offsets need to be read in the inner loop
+      const number *src_row = src + row_base[row];
+      const number *const val_end_of_row = values.data() + row_start[row+1];
+      number sum = number();
+      while (val_ptr != val_end_of_row)
+        sum += *val_ptr++ * src_row[*offset_ptr++];
+      if (add)
+        dst[row] += sum;
+      else
+        dst[row] = sum;
+    }
+}
+
+
+
+template <typename number>
+inline
+void
+SparseMatrixCompressedIndex<number>::vmult_impl (const number *src,
+                                                 number       *dst,
+                                                 const bool    add) const
+{
+  if (offsets_16.size() > 0)
+    {
+      const std::uint16_t *offsets = offsets_16.data();
+      parallel::apply_to_subranges
+      (size_type(0), n_rows,
+       [this,offsets,src,dst,add] (const size_type begin, const size_type end)
+      {
+        this->vmult_on_rows(begin, end, offsets, src, dst, add);
+      },
+      internal::SparseMatrix::minimum_parallel_grain_size);
+    }
+  else
+    {
+      const std::uint32_t *offsets = offsets_32.data();
+      parallel::apply_to_subranges
+      (size_type(0), n_rows,
+       [this,offsets,src,dst,add] (const size_type begin, const size_type end)
+      {
+        this->vmult_on_rows(begin, end, offsets, src, dst, add);
+      },
+      internal::SparseMatrix::minimum_parallel_grain_size);
+    }
+}
+
+
+
+template <typename number>
+template <class VectorType>
+inline
+void
+SparseMatrixCompressedIndex<number>::vmult (VectorType       &dst,
+                                            const VectorType &src) const
+{
+  static_assert(std::is_same<typename VectorType::value_type, number>::value,
+                "The vector entries must be of the same type as the matrix entries");
+  AssertDimension (dst.size(), m());
+  AssertDimension (src.size(), n());
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  vmult_impl (src.begin(), dst.begin(), false);
+}
+
+
+
+template <typename number>
+template <class VectorType>
+inline
+void
+SparseMatrixCompressedIndex<number>::vmult_add (VectorType       &dst,
+                                                const VectorType &src) const
+{
+  static_assert(std::is_same<typename VectorType::value_type, number>::value,
+                "The vector entries must be of the same type as the matrix entries");
+  AssertDimension (dst.size(), m());
+  AssertDimension (src.size(), n());
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  vmult_impl (src.begin(), dst.begin(), true);
+}
+
+
+
+template <typename number>
+template <class VectorType>
+inline
+void
+SparseMatrixCompressedIndex<number>::Tvmult (VectorType       &dst,
+                                             const VectorType &src) const
+{
+  static_assert(std::is_same<typename VectorType::value_type, number>::value,
+                "The vector entries must be of the same type as the matrix entries");
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), m());
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  dst = number();
+  Tvmult_add (dst, src);
+}
+
+
+
+template <typename number>
+template <class VectorType>
+inline
+void
+SparseMatrixCompressedIndex<number>::Tvmult_add (VectorType       &dst,
+                                                 const VectorType &src) const
+{
+  static_assert(std::is_same<typename VectorType::value_type, number>::value,
+                "The vector entries must be of the same type as the matrix entries");
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), m());
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  const number *src_ptr = src.begin();
+  number *dst_ptr = dst.begin();
+  for (size_type row=0; row<n_rows; ++row)
+    {
+      number *dst_row = dst_ptr + row_base[row];
+      const number src_value = src_ptr[row];
+      if (offsets_16.size() > 0)
+        for (std::size_t index=row_start[row]; index<row_start[row+1]; ++index)
+          dst_row[offsets_16[index]] += values[index] * src_value;
+      else
+        for (std::size_t index=row_start[row]; index<row_start[row+1]; ++index)
+          dst_row[offsets_32[index]] += values[index] * src_value;
+    }
+}
+
+
+
+template <typename number>
+template <class VectorType>
+inline
+void
+SparseMatrixCompressedIndex<number>::precondition_Jacobi (VectorType       &dst,
+                                                          const VectorType &src,
+                                                          const number      omega) const
+{
+  static_assert(std::is_same<typename VectorType::value_type, number>::value,
+                "The vector entries must be of the same type as the matrix entries");
+  Assert (m() == n(), ExcNotQuadratic());
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), n());
+
+  const number *src_ptr = src.begin();
+  number *dst_ptr = dst.begin();
+  for (size_type i=0; i<n_rows; ++i)
+    {
+      Assert (diag_element(i) != number(), ExcDivideByZero());
+      dst_ptr[i] = omega * src_ptr[i] / values[row_start[i]];
+    }
+}
+
+
+
+template <typename number>
+template <class VectorType>
+inline
+void
+SparseMatrixCompressedIndex<number>::Jacobi_step (VectorType       &v,
+                                                  const VectorType &b,
+                                                  const number      omega) const
+{
+  static_assert(std::is_same<typename VectorType::value_type, number>::value,
+                "The vector entries must be of the same type as the matrix entries");
+  Assert (m() == n(), ExcNotQuadratic());
+  AssertDimension (v.size(), n());
+  AssertDimension (b.size(), n());
+
+  VectorType residual;
+  residual.reinit(v, true);
+  vmult (residual, v);
+
+  const number *b_ptr = b.begin();
+  const number *residual_ptr = residual.begin();
+  number *v_ptr = v.begin();
+  for (size_type i=0; i<n_rows; ++i)
+    {
+      Assert (diag_element(i) != number(), ExcDivideByZero());
+      v_ptr[i] += omega * (b_ptr[i] - residual_ptr[i]) / values[row_start[i]];
+    }
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixCompressedIndex<number>::const_iterator
+SparseMatrixCompressedIndex<number>::begin (const size_type r) const
+{
+  AssertIndexRange (r, m()+1);
+  if (r == n_rows)
+    return end();
+  return const_iterator(this, r, row_start[r]);
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixCompressedIndex<number>::const_iterator
+SparseMatrixCompressedIndex<number>::end (const size_type r) const
+{
+  AssertIndexRange (r, m());
+  return const_iterator(this, r, row_start[r+1]);
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixCompressedIndex<number>::const_iterator
+SparseMatrixCompressedIndex<number>::end () const
+{
+  return const_iterator(this, n_rows, values.size());
+}
+
+
+
+template <typename number>
+inline
+std::size_t
+SparseMatrixCompressedIndex<number>::memory_consumption () const
+{
+  return sizeof(*this) +
+         MemoryConsumption::memory_consumption(row_start) +
+         MemoryConsumption::memory_consumption(row_base) +
+         MemoryConsumption::memory_consumption(offsets_16) +
+         MemoryConsumption::memory_consumption(offsets_32) +
+         MemoryConsumption::memory_consumption(values);
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,603 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_matrix_sell_h
+#define dealii_sparse_matrix_sell_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*! @addtogroup Matrix1
+ *@{
+ */
+
+/**
+ * A sparse matrix in the SELL-C-$\sigma$ format of M. Kreutzer, G. Hager, G.
+ * Wellein, H. Fehske, A. R. Bishop, "A unified sparse matrix data format for
+ * efficient general sparse matrix-vector multiplication on modern
+ * processors with wide SIMD units", SIAM J. Sci. Comput. 36(5), 2014.
+ *
+ * The rows of the matrix are grouped into chunks of $C$ consecutive rows,
+ * where $C$ is the number of lanes of VectorizedArray<number>. Within a
+ * chunk, the entries are stored column-major, i.e., the $j$-th entry of all
+ * $C$ rows is contiguous in memory and is processed by a single SIMD
+ * instruction, with the entries of the source vector loaded by
+ * VectorizedArray::gather(). Rows shorter than the longest row of their chunk
+ * are padded with zeros. To keep this padding small, the rows are sorted by
+ * their length within windows of $\sigma$ rows before being grouped into
+ * chunks. For finite element matrices, whose rows have similar lengths, the
+ * padding is typically a few percent, as opposed to ChunkSparseMatrix, which
+ * pads each chunk to a dense block.
+ *
+ * The sorting is an internal detail of this class: the vectors passed to
+ * vmult() and Tvmult() use the original numbering of the rows.
+ *
+ * Objects of this class are created from a SparseMatrix by reinit(), which
+ * both sets up the layout and copies the values. If only the values change,
+ * e.g. in a time-dependent problem, copy_from() transfers new values without
+ * recomputing the layout.
+ *
+ * The column indices are stored as <code>unsigned int</code> to match the
+ * interface of VectorizedArray::gather(), which limits the number of columns
+ * to $2^{32}-1$.
+ */
+template <typename number>
+class SparseMatrixSELL : public virtual Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Type of the matrix entries.
+   */
+  typedef number value_type;
+
+  /**
+   * The number of rows per chunk, given by the width of the SIMD unit.
+   */
+  static const unsigned int chunk_size = VectorizedArray<number>::n_array_elements;
+
+  /**
+   * Constructor. Create an empty matrix.
+   */
+  SparseMatrixSELL ();
+
+  /**
+   * Set up the layout from the sparsity pattern of @p matrix and copy its
+   * values. The rows are sorted by length within windows of @p sigma rows;
+   * @p sigma is rounded up to a multiple of chunk_size. A value of
+   * numbers::invalid_unsigned_int sorts all rows at once.
+   */
+  template <typename number2>
+  void reinit (const SparseMatrix<number2> &matrix,
+               const unsigned int           sigma = 128);
+
+  /**
+   * Set up the layout from @p sparsity with all values set to zero. See the
+   * other reinit() function for the meaning of @p sigma.
+   */
+  void reinit (const SparsityPattern &sparsity,
+               const unsigned int     sigma = 128);
+
+  /**
+   * Copy the values of @p matrix into this object, which must have been set
+   * up with the sparsity pattern of @p matrix.
+   */
+  template <typename number2>
+  void copy_from (const SparseMatrix<number2> &matrix);
+
+  /**
+   * Release all memory and return to a state just like after having called
+   * the default constructor.
+   */
+  void clear ();
+
+  /**
+   * Return the number of rows of the matrix.
+   */
+  size_type m () const;
+
+  /**
+   * Return the number of columns of the matrix.
+   */
+  size_type n () const;
+
+  /**
+   * Return the number of entries stored, including the zeros used for
+   * padding the chunks.
+   */
+  std::size_t n_stored_elements () const;
+
+  /**
+   * Matrix-vector multiplication: let <i>dst = M*src</i>. The vectors must
+   * provide contiguous storage accessible through <code>begin()</code>
+   * holding numbers of type @p number, as e.g. Vector or
+   * LinearAlgebra::distributed::Vector in serial.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <class VectorType>
+  void vmult (VectorType       &dst,
+              const VectorType &src) const;
+
+  /**
+   * Adding matrix-vector multiplication: add <i>M*src</i> to <i>dst</i>.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <class VectorType>
+  void vmult_add (VectorType       &dst,
+                  const VectorType &src) const;
+
+  /**
+   * Transpose matrix-vector multiplication: let <i>dst =
+   * M<sup>T</sup>*src</i>. The rows of @p src are loaded in SIMD fashion,
+   * but the result is accumulated entry by entry since several rows of a
+   * chunk may write into the same entry of @p dst. This operation is not
+   * parallelized.
+   */
+  template <class VectorType>
+  void Tvmult (VectorType       &dst,
+               const VectorType &src) const;
+
+  /**
+   * Adding transpose matrix-vector multiplication: add
+   * <i>M<sup>T</sup>*src</i> to <i>dst</i>.
+   */
+  template <class VectorType>
+  void Tvmult_add (VectorType       &dst,
+                   const VectorType &src) const;
+
+  /**
+   * Return the memory consumption of this object in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg (ExcSourceEqualsDestination,
+                    "You are attempting an operation on two matrices that "
+                    "are the same object, but the operation requires that the "
+                    "two objects are in fact different.");
+
+private:
+  /**
+   * Perform the matrix-vector product on the chunks in [begin, end).
+   */
+  void vmult_on_chunks (const unsigned int begin,
+                        const unsigned int end,
+                        const number      *src,
+                        number            *dst,
+                        const bool         add) const;
+
+  /**
+   * Perform the transpose matrix-vector product, adding into @p dst.
+   */
+  void Tvmult_add_impl (const number *src,
+                        number       *dst) const;
+
+  /**
+   * Number of rows.
+   */
+  size_type n_rows;
+
+  /**
+   * Number of columns.
+   */
+  size_type n_cols;
+
+  /**
+   * The original row number of the row at a given position in the sorted
+   * order. The array is padded to a multiple of chunk_size with the
+   * index of the last row.
+   */
+  std::vector<unsigned int> row_permutation;
+
+  /**
+   * The start of each chunk in values and column_indices, in units of
+   * VectorizedArray entries. Has one more element than there are chunks.
+   */
+  std::vector<unsigned int> chunk_start;
+
+  /**
+   * The matrix entries, one VectorizedArray for the $j$-th entry of the
+   * chunk_size rows of a chunk.
+   */
+  AlignedVector<VectorizedArray<number> > values;
+
+  /**
+   * The column indices of the entries, with chunk_size consecutive entries
+   * per VectorizedArray in values. Padding entries point to column zero.
+   */
+  AlignedVector<unsigned int> column_indices;
+};
+
+/*@}*/
+
+
+/*---------------------- Inline functions -----------------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename number>
+const unsigned int SparseMatrixSELL<number>::chunk_size;
+
+
+
+template <typename number>
+inline
+SparseMatrixSELL<number>::SparseMatrixSELL ()
+  :
+  n_rows (0),
+  n_cols (0)
+{}
+
+
+
+template <typename number>
+inline
+void
+SparseMatrixSELL<number>::clear ()
+{
+  n_rows = 0;
+  n_cols = 0;
+  row_permutation.clear();
+  chunk_start.clear();
+  values.clear();
+  column_indices.clear();
+}
+
+
+
+template <typename number>
+inline
+void
+SparseMatrixSELL<number>::reinit (const SparsityPattern &sparsity,
+                                  const unsigned int     sigma_in)
+{
+  Assert (sparsity.is_compressed(), SparsityPattern::ExcNotCompressed());
+  AssertThrow (sparsity.n_cols() < std::numeric_limits<unsigned int>::max() &&
+               sparsity.n_rows() < std::numeric_limits<unsigned int>::max(),
+               ExcMessage("SparseMatrixSELL uses 32-bit indices and cannot "
+                          "represent matrices of this size"));
+
+  clear();
+  n_rows = sparsity.n_rows();
+  n_cols = sparsity.n_cols();
+
+  const unsigned int n_chunks = (n_rows + chunk_size - 1) / chunk_size;
+  const unsigned int sigma = sigma_in == numbers::invalid_unsigned_int ?
+                             n_chunks * chunk_size :
+                             ((std::max(sigma_in, 1U) + chunk_size - 1) / chunk_size) * chunk_size;
+
+  // sort the rows by decreasing length within each window of sigma rows;
+  // the stable sort keeps rows of equal length in their original order
+  row_permutation.resize(n_chunks * chunk_size);
+  std::iota(row_permutation.begin(), row_permutation.begin() + n_rows, 0U);
+  for (unsigned int start=0; start<n_rows; start+=sigma)
+    {
+      const unsigned int end = std::min<unsigned int>(start+sigma, n_rows);
+      std::stable_sort(row_permutation.begin()+start, row_permutation.begin()+end,
+                       [&sparsity] (const unsigned int a, const unsigned int b)
+      {
+        return sparsity.row_length(a) > sparsity.row_length(b);
+      });
+    }
+  for (unsigned int i=n_rows; i<row_permutation.size(); ++i)
+    row_permutation[i] = n_rows > 0 ? row_permutation[n_rows-1] : 0;
+
+  // the length of a chunk is given by its longest row
+  chunk_start.resize(n_chunks+1);
+  chunk_start[0] = 0;
+  for (unsigned int c=0; c<n_chunks; ++c)
+    {
+      unsigned int length = 0;
+      for (unsigned int v=0; v<chunk_size && c*chunk_size+v<n_rows; ++v)
+        length = std::max(length, sparsity.row_length(row_permutation[c*chunk_size+v]));
+      chunk_start[c+1] = chunk_start[c] + length;
+    }
+
+  values.resize_fast(chunk_start.back());
+  column_indices.resize_fast(std::size_t(chunk_start.back()) * chunk_size);
+  for (unsigned int i=0; i<values.size(); ++i)
+    values[i] = number();
+  for (unsigned int i=0; i<column_indices.size(); ++i)
+    column_indices[i] = 0;
+
+  for (unsigned int c=0; c<n_chunks; ++c)
+    for (unsigned int v=0; v<chunk_size && c*chunk_size+v<n_rows; ++v)
+      {
+        const unsigned int row = row_permutation[c*chunk_size+v];
+        unsigned int j = 0;
+        for (SparsityPattern::iterator it=sparsity.begin(row);
+             it != sparsity.end(row); ++it, ++j)
+          column_indices[(std::size_t(chunk_start[c])+j)*chunk_size+v] = it->column();
+      }
+}
+
+
+
+template <typename number>
+template <typename number2>
+inline
+void
+SparseMatrixSELL<number>::reinit (const SparseMatrix<number2> &matrix,
+                                  const unsigned int           sigma)
+{
+  reinit (matrix.get_sparsity_pattern(), sigma);
+  copy_from (matrix);
+}
+
+
+
+template <typename number>
+template <typename number2>
+inline
+void
+SparseMatrixSELL<number>::copy_from (const SparseMatrix<number2> &matrix)
+{
+  AssertDimension (matrix.m(), m());
+  AssertDimension (matrix.n(), n());
+
+  const unsigned int n_chunks = chunk_start.size() - 1;
+  for (unsigned int c=0; c<n_chunks; ++c)
+    for (unsigned int v=0; v<chunk_size && c*chunk_size+v<n_rows; ++v)
+      {
+        const unsigned int row = row_permutation[c*chunk_size+v];
+        unsigned int j = 0;
+        for (typename SparseMatrix<number2>::const_iterator it=matrix.begin(row);
+             it != matrix.end(row); ++it, ++j)
+          {
+            Assert (chunk_start[c]+j < chunk_start[c+1] &&
+                    column_indices[(std::size_t(chunk_start[c])+j)*chunk_size+v]
+                    == it->column(),
+                    ExcMessage("The sparsity pattern of the given matrix does "
+                               "not match the one this object was set up with"));
+            values[chunk_start[c]+j][v] = it->value();
+          }
+      }
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixSELL<number>::size_type
+SparseMatrixSELL<number>::m () const
+{
+  return n_rows;
+}
+
+
+
+template <typename number>
+inline
+typename SparseMatrixSELL<number>::size_type
+SparseMatrixSELL<number>::n () const
+{
+  return n_cols;
+}
+
+
+
+template <typename number>
+inline
+std::size_t
+SparseMatrixSELL<number>::n_stored_elements () const
+{
+  return values.size() * chunk_size;
+}
+
+
+
+template <typename number>
+inline
+void
+SparseMatrixSELL<number>::vmult_on_chunks (const unsigned int begin,
+                                           const unsigned int end,
+                                           const number      *src,
+                                           number            *dst,
+                                           const bool         add) const
+{
+  for (unsigned int c=begin; c<end; ++c)
+    {
+      VectorizedArray<number> sum = VectorizedArray<number>();
+      const VectorizedArray<number> *val_ptr = values.begin() + chunk_start[c];
+      const unsigned int *col_ptr = column_indices.begin() +
+                                    std::size_t(chunk_start[c]) * chunk_size;
+      for (unsigned int j=chunk_start[c]; j<chunk_start[c+1];
+           ++j, ++val_ptr, col_ptr += chunk_size)
+        {
+          VectorizedArray<number> src_values;
+          src_values.gather(src, col_ptr);
+          sum += *val_ptr * src_values;
+        }
+
+      const unsigned int *rows = &row_permutation[c*chunk_size];
+      const unsigned int n_filled = std::min<size_type>(chunk_size,
+                                                        n_rows - c*chunk_size);
+      if (add)
+        for (unsigned int v=0; v<n_filled; ++v)
+          dst[rows[v]] += sum[v];
+      else if (n_filled == chunk_size)
+        sum.scatter(rows, dst);
+      else
+        for (unsigned int v=0; v<n_filled; ++v)
+          dst[rows[v]] = sum[v];
+    }
+}
+
+
+
+template <typename number>
+template <class VectorType>
+inline
+void
+SparseMatrixSELL<number>::vmult (VectorType       &dst,
+                                 const VectorType &src) const
+{
+  static_assert(std::is_same<typename VectorType::value_type, number>::value,
+                "The vector entries must be of the same type as the matrix entries");
+  AssertDimension (dst.size(), m());
+  AssertDimension (src.size(), n());
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  const number *src_ptr = src.begin();
+  number *dst_ptr = dst.begin();
+  parallel::apply_to_subranges
+  (0U, static_cast<unsigned int>(chunk_start.size()-1),
+   [this,src_ptr,dst_ptr] (const unsigned int begin, const unsigned int end)
+  {
+    this->vmult_on_chunks(begin, end, src_ptr, dst_ptr, false);
+  },
+  internal::SparseMatrix::minimum_parallel_grain_size/chunk_size+1);
+}
+
+
+
+template <typename number>
+template <class VectorType>
+inline
+void
+SparseMatrixSELL<number>::vmult_add (VectorType       &dst,
+                                     const VectorType &src) const
+{
+  static_assert(std::is_same<typename VectorType::value_type, number>::value,
+                "The vector entries must be of the same type as the matrix entries");
+  AssertDimension (dst.size(), m());
+  AssertDimension (src.size(), n());
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  const number *src_ptr = src.begin();
+  number *dst_ptr = dst.begin();
+  parallel::apply_to_subranges
+  (0U, static_cast<unsigned int>(chunk_start.size()-1),
+   [this,src_ptr,dst_ptr] (const unsigned int begin, const unsigned int end)
+  {
+    this->vmult_on_chunks(begin, end, src_ptr, dst_ptr, true);
+  },
+  internal::SparseMatrix::minimum_parallel_grain_size/chunk_size+1);
+}
+
+
+
+template <typename number>
+inline
+void
+SparseMatrixSELL<number>::Tvmult_add_impl (const number *src,
+                                           number       *dst) const
+{
+  const unsigned int n_chunks = chunk_start.size() - 1;
+  for (unsigned int c=0; c<n_chunks; ++c)
+    {
+      // padded lanes of the last chunk duplicate the last row, so zero their
+      // source values rather than relying on the padding of the matrix
+      VectorizedArray<number> src_values;
+      src_values.gather(src, &row_permutation[c*chunk_size]);
+      const unsigned int n_filled = std::min<size_type>(chunk_size,
+                                                        n_rows - c*chunk_size);
+      for (unsigned int v=n_filled; v<chunk_size; ++v)
+        src_values[v] = number();
+
+      const VectorizedArray<number> *val_ptr = values.begin() + chunk_start[c];
+      const unsigned int *col_ptr = column_indices.begin() +
+                                    std::size_t(chunk_start[c]) * chunk_size;
+      for (unsigned int j=chunk_start[c]; j<chunk_start[c+1];
+           ++j, ++val_ptr, col_ptr += chunk_size)
+        {
+          const VectorizedArray<number> products = *val_ptr * src_values;
+          for (unsigned int v=0; v<chunk_size; ++v)
+            dst[col_ptr[v]] += products[v];
+        }
+    }
+}
+
+
+
+template <typename number>
+template <class VectorType>
+inline
+void
+SparseMatrixSELL<number>::Tvmult (VectorType       &dst,
+                                  const VectorType &src) const
+{
+  static_assert(std::is_same<typename VectorType::value_type, number>::value,
+                "The vector entries must be of the same type as the matrix entries");
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), m());
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  dst = number();
+  Tvmult_add_impl (src.begin(), dst.begin());
+}
+
+
+
+template <typename number>
+template <class VectorType>
+inline
+void
+SparseMatrixSELL<number>::Tvmult_add (VectorType       &dst,
+                                      const VectorType &src) const
+{
+  static_assert(std::is_same<typename VectorType::value_type, number>::value,
+                "The vector entries must be of the same type as the matrix entries");
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), m());
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  Tvmult_add_impl (src.begin(), dst.begin());
+}
+
+
+
+template <typename number>
+inline
+std::size_t
+SparseMatrixSELL<number>::memory_consumption () const
+{
+  return sizeof(*this) +
+         MemoryConsumption::memory_consumption(row_permutation) +
+         MemoryConsumption::memory_consumption(chunk_start) +
+         values.memory_consumption() +
+         column_indices.memory_consumption();
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
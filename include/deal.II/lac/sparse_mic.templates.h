@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2002 - 2015 by the deal.II authors
+// Copyright (C) 2002 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -150,40 +150,46 @@ SparseMIC<number>::vmult (Vector<somenumber>       &dst,
   // We assume the underlying matrix A is: A = X - L - U, where -L and -U are
   // strictly lower- and upper- diagonal parts of the system.
   //
-  // Solve (X-L)X{-1}(X-U) x = b in 3 steps:
+  // Solve (X-L)X{-1}(X-U) x = b in 3 steps. The rows of the triangular
+  // solves are processed in the order given by the level schedule, which
+  // allows to work on the rows of one level in parallel.
   dst = src;
-  for (size_type row=0; row<N; ++row)
-    {
-      // Now: (X-L)u = b
+  this->apply_level_schedule
+  (this->forward_level_rows, this->forward_level_start, true,
+   [&] (const size_type row)
+  {
+    // Now: (X-L)u = b
 
-      // get start of this row. skip
-      // the diagonal element
-      for (typename SparseMatrix<number>::const_iterator
-           p = this->begin(row)+1;
-           (p != this->end(row)) && (p->column() < row);
-           ++p)
-        dst(row) -= p->value() * dst(p->column());
+    // get start of this row. skip
+    // the diagonal element
+    for (typename SparseMatrix<number>::const_iterator
+         p = this->begin(row)+1;
+         (p != this->end(row)) && (p->column() < row);
+         ++p)
+      dst(row) -= p->value() * dst(p->column());
 
-      dst(row) *= inv_diag[row];
-    }
+    dst(row) *= inv_diag[row];
+  });
 
   // Now: v = Xu
   for (size_type row=0; row<N; row++)
     dst(row) *= diag[row];
 
   // x = (X-U)v
-  for (int row=N-1; row>=0; --row)
-    {
-      // get end of this row
-      for (typename SparseMatrix<number>::const_iterator
-           p = this->begin(row)+1;
-           p != this->end(row);
-           ++p)
-        if (p->column() > static_cast<size_type>(row))
-          dst(row) -= p->value() * dst(p->column());
+  this->apply_level_schedule
+  (this->backward_level_rows, this->backward_level_start, false,
+   [&] (const size_type row)
+  {
+    // get end of this row
+    for (typename SparseMatrix<number>::const_iterator
+         p = this->begin(row)+1;
+         p != this->end(row);
+         ++p)
+      if (p->column() > row)
+        dst(row) -= p->value() * dst(p->column());
 
-      dst(row) *= inv_diag[row];
-    }
+    dst(row) *= inv_diag[row];
+  });
 }
 
 
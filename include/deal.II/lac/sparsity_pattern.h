@@ -52,6 +52,14 @@ namespace ChunkSparsityPatternIterators
   class Accessor;
 }
 
+namespace parallel
+{
+  namespace internal
+  {
+    class TBBPartitioner;
+  }
+}
+
 
 /*! @addtogroup Sparsity
  *@{
@@ -1101,6 +1109,17 @@ private:
    */
   bool store_diagonal_first_in_row;
 
+  /**
+   * The affinity partitioner used for the thread-parallel loops over the
+   * rows of this pattern and of the SparseMatrix objects built on it. Using
+   * the same object for the first touch of the data in reinit() and
+   * compress() as well as for the matrix-vector products of SparseMatrix
+   * assigns the same rows to the same threads wherever possible, so that the
+   * data stays in the memory bank of the socket working on it on NUMA
+   * systems.
+   */
+  mutable std::shared_ptr<parallel::internal::TBBPartitioner> thread_loop_partitioner;
+
   /**
    * Make all sparse matrices friends of this class.
    */
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2008 - 2016 by the deal.II authors
+// Copyright (C) 2008 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -209,6 +209,46 @@ namespace SparsityTools
    const MPI_Comm              &mpi_comm,
    const IndexSet              &myrange);
 
+  /**
+   * Communicate rows in a dynamic sparsity pattern over MPI, like the
+   * functions above, but given only the set of rows owned by the current
+   * process rather than the ownership of all processes.
+   *
+   * The owners of the rows to be sent are determined through a distributed
+   * directory, where each process records the owners of a contiguous chunk
+   * of the rows, and the rows are sent as ranges of consecutive column
+   * indices. Neither the memory nor the communication of this function grow
+   * with the number of processes, which makes it the preferred variant for
+   * large numbers of processes.
+   *
+   * @param[in,out] dsp The locally built sparsity pattern to be modified.
+   *
+   * @param locally_owned_rows The rows owned by the current process,
+   * typically the value given by DoFHandler::locally_owned_dofs. The sets
+   * of all processes must be disjoint and cover all rows of @p dsp.
+   *
+   * @param mpi_comm The MPI communicator to use.
+   *
+   * @param locally_relevant_rows The rows stored in @p dsp, typically the
+   * locally relevant DoFs. Only these rows are checked for transfer.
+   */
+  void distribute_sparsity_pattern
+  (DynamicSparsityPattern &dsp,
+   const IndexSet         &locally_owned_rows,
+   const MPI_Comm         &mpi_comm,
+   const IndexSet         &locally_relevant_rows);
+
+  /**
+   * Similar to the function above, but for BlockDynamicSparsityPattern
+   * instead. The row indices refer to the global numbering of the rows of
+   * all blocks.
+   */
+  void distribute_sparsity_pattern
+  (BlockDynamicSparsityPattern &dsp,
+   const IndexSet              &locally_owned_rows,
+   const MPI_Comm              &mpi_comm,
+   const IndexSet              &locally_relevant_rows);
+
 #endif
 
 
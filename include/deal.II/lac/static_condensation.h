@@ -0,0 +1,426 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_static_condensation_h
+#define dealii_static_condensation_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/types.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*! @addtogroup Matrix2
+ *@{
+ */
+
+/**
+ * Static condensation of the degrees of freedom in the interior of cells.
+ * For a cell matrix and right hand side split into the interior degrees of
+ * freedom $I$, which are only coupled to the other degrees of freedom of the
+ * same cell, and the remaining skeleton degrees of freedom $S$ on the faces,
+ * edges and vertices,
+ * @f[
+ *   \left(\begin{array}{cc} A_{II} & A_{IS} \\ A_{SI} & A_{SS}
+ *   \end{array}\right)
+ *   \left(\begin{array}{c} u_I \\ u_S \end{array}\right)
+ *   =
+ *   \left(\begin{array}{c} f_I \\ f_S \end{array}\right),
+ * @f]
+ * the interior unknowns are eliminated by the Schur complement, which gives
+ * the condensed cell matrix $A_{SS} - A_{SI} A_{II}^{-1} A_{IS}$ and right
+ * hand side $f_S - A_{SI} A_{II}^{-1} f_I$ that are assembled into the
+ * global system for the skeleton unknowns. After that system has been
+ * solved, the interior unknowns are recovered cell by cell as $u_I =
+ * A_{II}^{-1} (f_I - A_{IS} u_S)$. This is the procedure used for the
+ * hybridizable discontinuous Galerkin method in step-51, where the interior
+ * unknowns are the ones of an FE_DGQ element and the skeleton unknowns the
+ * ones of FE_FaceQ, and it applies equally to high order continuous
+ * elements like FE_Q, where the degrees of freedom of the cell interior,
+ * i.e., the last FiniteElement::dofs_per_quad (2D) or
+ * FiniteElement::dofs_per_hex (3D) degrees of freedom of each cell, are
+ * eliminated. The global system then only couples the skeleton unknowns,
+ * which for high polynomial degrees are considerably fewer than all
+ * unknowns and have a smaller number of nonzero entries per row.
+ *
+ * <h3>Usage</h3>
+ *
+ * The object is set up with the number of cells by reinit(), typically with
+ * Triangulation::n_active_cells(). During assembly, condense_cell() is called
+ * on each cell with the cell matrix and right hand side, where the interior
+ * degrees of freedom are numbered first and the skeleton degrees of freedom
+ * last, together with the global indices of both sets. The function returns
+ * the condensed matrix and right hand side to be distributed into the global
+ * skeleton system, e.g. by ConstraintMatrix::distribute_local_to_global()
+ * with the skeleton indices, and it stores the matrices needed for the
+ * reconstruction. Calls for different cells do not interfere, so that
+ * condense_cell() can be called from the worker functions of WorkStream::run()
+ * while the distribution into the global system happens in the copier. The
+ * index of the cell passed to condense_cell() is arbitrary as long as it is
+ * unique, e.g. CellAccessor::active_cell_index(). After the skeleton system
+ * has been solved, reconstruct() computes the interior unknowns of all cells
+ * in parallel.
+ *
+ * Instead of assembling the global skeleton matrix, the condensed cell
+ * matrices can be kept in the object by setting
+ * AdditionalData::store_condensed_matrices, in which case vmult() applies
+ * the skeleton operator cell by cell. This allows to use the object as the
+ * matrix in iterative solvers, with a preconditioner like
+ * PreconditionIdentity or PreconditionChebyshev based on the diagonal
+ * computed by compute_diagonal(). Constraints on the skeleton unknowns are
+ * then left to the caller, who may e.g. skip the constrained indices by
+ * passing numbers::invalid_dof_index for them to condense_cell(), which
+ * removes the respective rows and columns from the operator.
+ *
+ * The inverse of $A_{II}$ is computed by FullMatrix::gauss_jordan() and the
+ * matrix products by FullMatrix::mmult(), which uses the BLAS if deal.II is
+ * configured with LAPACK.
+ */
+template <typename Number>
+class StaticCondensation : public Subscriptor
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the object.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData (const bool store_condensed_matrices = false);
+
+    /**
+     * Keep the condensed cell matrices in the object in order to apply the
+     * skeleton operator by vmult(). If false, only the matrices needed for
+     * the reconstruction are stored.
+     */
+    bool store_condensed_matrices;
+  };
+
+  /**
+   * Constructor. Does nothing apart from setting up an empty object.
+   */
+  StaticCondensation ();
+
+  /**
+   * Prepare the object for condensing @p n_cells cells, which deletes the
+   * data of a previous condensation.
+   */
+  void reinit (const unsigned int    n_cells,
+               const AdditionalData &additional_data = AdditionalData());
+
+  /**
+   * Release all memory.
+   */
+  void clear ();
+
+  /**
+   * Return the number of cells the object was set up for.
+   */
+  unsigned int n_cells () const;
+
+  /**
+   * Eliminate the interior degrees of freedom of the cell with index
+   * @p cell_index. The rows and columns of @p cell_matrix and the entries
+   * of @p cell_rhs are ordered such that the degrees of freedom with the
+   * global indices @p interior_dof_indices come first, followed by the ones
+   * with the global indices @p skeleton_dof_indices. On exit,
+   * @p condensed_matrix and @p condensed_rhs contain the Schur complement
+   * system of the skeleton degrees of freedom, and the inverse of the
+   * interior block applied to the coupling matrix and to the right hand
+   * side are stored for reconstruct().
+   *
+   * The interior indices refer to the vector passed to reconstruct() and
+   * must not be shared with other cells. This function may be called
+   * concurrently for different cells.
+   */
+  void condense_cell (const unsigned int                          cell_index,
+                      const FullMatrix<Number>                   &cell_matrix,
+                      const Vector<Number>                       &cell_rhs,
+                      const std::vector<types::global_dof_index> &interior_dof_indices,
+                      const std::vector<types::global_dof_index> &skeleton_dof_indices,
+                      FullMatrix<Number>                         &condensed_matrix,
+                      Vector<Number>                             &condensed_rhs);
+
+  /**
+   * Compute the interior unknowns of all cells from the solution of the
+   * skeleton system @p skeleton_solution and write them into
+   * @p interior_solution at the interior indices given to condense_cell().
+   * The two vectors may be the same object if the interior and skeleton
+   * unknowns share one numbering, as for continuous elements. Entries of
+   * @p skeleton_solution are accessed through <code>operator()</code> with
+   * the global index, so a parallel vector must have its ghost entries
+   * imported. Skeleton indices given as numbers::invalid_dof_index are
+   * taken as zero. The cells are worked on in parallel.
+   */
+  template <typename VectorType>
+  void reconstruct (const VectorType &skeleton_solution,
+                    VectorType       &interior_solution) const;
+
+  /**
+   * Apply the condensed skeleton operator, i.e., add up the products of
+   * the condensed cell matrices with the entries of @p src at the skeleton
+   * indices of each cell. Only available if the object was set up with
+   * AdditionalData::store_condensed_matrices. The products on the cells are
+   * computed in parallel, the summation into @p dst is done serially.
+   */
+  template <typename VectorType>
+  void vmult (VectorType       &dst,
+              const VectorType &src) const;
+
+  /**
+   * Apply the transpose of the condensed skeleton operator.
+   */
+  template <typename VectorType>
+  void Tvmult (VectorType       &dst,
+               const VectorType &src) const;
+
+  /**
+   * Add the diagonal entries of the condensed cell matrices into
+   * @p diagonal, which has to be set to zero and has to have the size of
+   * the skeleton system when calling this function. Only available if the
+   * object was set up with AdditionalData::store_condensed_matrices.
+   */
+  template <typename VectorType>
+  void compute_diagonal (VectorType &diagonal) const;
+
+  /**
+   * Return the memory consumption of this object in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The data stored for each cell.
+   */
+  struct CellData
+  {
+    /**
+     * The global indices of the interior degrees of freedom.
+     */
+    std::vector<types::global_dof_index> interior_dof_indices;
+
+    /**
+     * The global indices of the skeleton degrees of freedom.
+     */
+    std::vector<types::global_dof_index> skeleton_dof_indices;
+
+    /**
+     * The matrix $-A_{II}^{-1} A_{IS}$ that maps the skeleton unknowns to
+     * the interior ones.
+     */
+    FullMatrix<Number> reconstruction_matrix;
+
+    /**
+     * The vector $A_{II}^{-1} f_I$, the interior unknowns for zero skeleton
+     * unknowns.
+     */
+    Vector<Number> reconstruction_rhs;
+
+    /**
+     * The condensed cell matrix, only filled if
+     * AdditionalData::store_condensed_matrices is set.
+     */
+    FullMatrix<Number> condensed_matrix;
+  };
+
+  /**
+   * Apply the condensed cell matrices or their transposes to @p src and
+   * add the result into @p dst.
+   */
+  template <typename VectorType>
+  void apply_add (VectorType       &dst,
+                  const VectorType &src,
+                  const bool        transpose) const;
+
+  /**
+   * The data of all cells.
+   */
+  std::vector<CellData> cell_data;
+
+  /**
+   * The settings of the object.
+   */
+  AdditionalData additional_data;
+};
+
+/*@}*/
+
+
+/*---------------------- Inline functions -----------------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename Number>
+inline
+unsigned int
+StaticCondensation<Number>::n_cells () const
+{
+  return cell_data.size();
+}
+
+
+
+template <typename Number>
+template <typename VectorType>
+inline
+void
+StaticCondensation<Number>::reconstruct (const VectorType &skeleton_solution,
+                                         VectorType       &interior_solution) const
+{
+  parallel::apply_to_subranges
+  (0U, n_cells(),
+   [&] (const unsigned int begin, const unsigned int end)
+  {
+    Vector<Number> skeleton_values, interior_values;
+    for (unsigned int cell=begin; cell<end; ++cell)
+      {
+        const CellData &data = cell_data[cell];
+        skeleton_values.reinit(data.skeleton_dof_indices.size(), true);
+        for (unsigned int i=0; i<data.skeleton_dof_indices.size(); ++i)
+          skeleton_values(i) =
+            data.skeleton_dof_indices[i] == numbers::invalid_dof_index ?
+            Number() : Number(skeleton_solution(data.skeleton_dof_indices[i]));
+        interior_values = data.reconstruction_rhs;
+        if (data.reconstruction_matrix.m() > 0 && data.reconstruction_matrix.n() > 0)
+          data.reconstruction_matrix.vmult(interior_values, skeleton_values, true);
+        for (unsigned int i=0; i<data.interior_dof_indices.size(); ++i)
+          interior_solution(data.interior_dof_indices[i]) = interior_values(i);
+      }
+  },
+  16);
+}
+
+
+
+template <typename Number>
+template <typename VectorType>
+inline
+void
+StaticCondensation<Number>::apply_add (VectorType       &dst,
+                                       const VectorType &src,
+                                       const bool        transpose) const
+{
+  Assert (additional_data.store_condensed_matrices,
+          ExcMessage("The operator can only be applied if the condensed cell "
+                     "matrices have been stored, see "
+                     "AdditionalData::store_condensed_matrices"));
+
+  // compute the cell contributions in parallel into one buffer, and add
+  // them into the destination vector afterwards to avoid races on the
+  // shared skeleton unknowns
+  std::vector<std::size_t> offsets(n_cells()+1, 0);
+  for (unsigned int cell=0; cell<n_cells(); ++cell)
+    offsets[cell+1] = offsets[cell] + cell_data[cell].skeleton_dof_indices.size();
+  std::vector<Number> cell_results(offsets.back());
+
+  parallel::apply_to_subranges
+  (0U, n_cells(),
+   [&] (const unsigned int begin, const unsigned int end)
+  {
+    Vector<Number> src_values, dst_values;
+    for (unsigned int cell=begin; cell<end; ++cell)
+      {
+        const std::vector<types::global_dof_index> &indices =
+          cell_data[cell].skeleton_dof_indices;
+        src_values.reinit(indices.size(), true);
+        dst_values.reinit(indices.size(), true);
+        for (unsigned int i=0; i<indices.size(); ++i)
+          src_values(i) = indices[i] == numbers::invalid_dof_index ?
+                          Number() : Number(src(indices[i]));
+        if (indices.size() == 0)
+          continue;
+        else if (transpose)
+          cell_data[cell].condensed_matrix.Tvmult(dst_values, src_values);
+        else
+          cell_data[cell].condensed_matrix.vmult(dst_values, src_values);
+        std::copy(dst_values.begin(), dst_values.end(),
+                  cell_results.begin() + offsets[cell]);
+      }
+  },
+  16);
+
+  for (unsigned int cell=0; cell<n_cells(); ++cell)
+    {
+      const std::vector<types::global_dof_index> &indices =
+        cell_data[cell].skeleton_dof_indices;
+      for (unsigned int i=0; i<indices.size(); ++i)
+        if (indices[i] != numbers::invalid_dof_index)
+          dst(indices[i]) += cell_results[offsets[cell]+i];
+    }
+}
+
+
+
+template <typename Number>
+template <typename VectorType>
+inline
+void
+StaticCondensation<Number>::vmult (VectorType       &dst,
+                                   const VectorType &src) const
+{
+  Assert (&dst != &src, ExcMessage("Source and destination must not be the same vector"));
+  dst = 0;
+  apply_add (dst, src, false);
+}
+
+
+
+template <typename Number>
+template <typename VectorType>
+inline
+void
+StaticCondensation<Number>::Tvmult (VectorType       &dst,
+                                    const VectorType &src) const
+{
+  Assert (&dst != &src, ExcMessage("Source and destination must not be the same vector"));
+  dst = 0;
+  apply_add (dst, src, true);
+}
+
+
+
+template <typename Number>
+template <typename VectorType>
+inline
+void
+StaticCondensation<Number>::compute_diagonal (VectorType &diagonal) const
+{
+  Assert (additional_data.store_condensed_matrices,
+          ExcMessage("The diagonal can only be computed if the condensed cell "
+                     "matrices have been stored, see "
+                     "AdditionalData::store_condensed_matrices"));
+  for (unsigned int cell=0; cell<n_cells(); ++cell)
+    {
+      const CellData &data = cell_data[cell];
+      for (unsigned int i=0; i<data.skeleton_dof_indices.size(); ++i)
+        if (data.skeleton_dof_indices[i] != numbers::invalid_dof_index)
+          diagonal(data.skeleton_dof_indices[i]) += data.condensed_matrix(i,i);
+    }
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
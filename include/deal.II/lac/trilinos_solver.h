@@ -645,6 +645,16 @@ namespace TrilinosWrappers
      */
     void solve (MPI::Vector &x, const MPI::Vector &b);
 
+    /**
+     * Solve the linear system <tt>Ax=b</tt> for deal.II's own parallel
+     * vectors based on the factorization computed in initialize(). The
+     * vectors need to have the same locally owned range as the rows of the
+     * matrix given to initialize(). Note the matrix is not refactorized
+     * during this call.
+     */
+    void solve (dealii::LinearAlgebra::distributed::Vector<double>       &x,
+                const dealii::LinearAlgebra::distributed::Vector<double> &b);
+
     /**
      * Solve the linear system <tt>Ax=b</tt>. Creates a factorization of the
      * matrix with the package chosen from the additional data structure and
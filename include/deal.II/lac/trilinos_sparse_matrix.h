@@ -23,6 +23,7 @@
 
 #  include <deal.II/base/subscriptor.h>
 #  include <deal.II/base/index_set.h>
+#  include <deal.II/base/thread_local_storage.h>
 #  include <deal.II/lac/full_matrix.h>
 #  include <deal.II/lac/exceptions.h>
 #  include <deal.II/lac/trilinos_vector.h>
@@ -484,9 +485,23 @@ namespace TrilinosWrappers
    *
    * Note that all other reinit methods and constructors of
    * TrilinosWrappers::SparsityPattern will result in a matrix that needs to
-   * allocate off-processor entries on demand, which breaks thread-safety. Of
-   * course, using the respective reinit method for the block Trilinos
-   * sparsity pattern and block matrix also results in thread-safety.
+   * allocate off-processor entries on demand. For additions via add(), this
+   * class collects such off-processor contributions in a separate array for
+   * each thread and hands them to Trilinos in compress(), so concurrent
+   * additions into different rows are safe in that case as well, provided
+   * that the matrix is in a compressed state when the threads start writing
+   * (i.e., compress() has been called after the last set() operation).
+   * Calls to set() as well as all other operations that change the state of
+   * the whole matrix must not run concurrently with other writes. Of course,
+   * using the respective reinit method for the block Trilinos sparsity
+   * pattern and block matrix also results in thread-safety.
+   *
+   * When several threads need to write into the same matrix row, e.g. for
+   * degrees of freedom on faces shared between cells assembled on different
+   * threads, the writes must be protected by the user, e.g. by the variant
+   * of ConstraintMatrix::distribute_local_to_global() that takes a
+   * Threads::SpinLockTable for locking rows, or by coloring the cells with
+   * GraphColoring and WorkStream.
    *
    * @ingroup TrilinosWrappers
    * @ingroup Matrix1
@@ -1322,6 +1337,13 @@ namespace TrilinosWrappers
      * specify whether zero values should be added anyway or these should be
      * filtered away and only non-zero data is added. The default value is
      * <tt>true</tt>, i.e., zero values won't be added into the matrix.
+     *
+     * Contributions to rows owned by another processor are collected in a
+     * buffer of this class, unless the matrix was initialized with a
+     * sparsity pattern that specifies the writable nonlocal rows. The buffer
+     * is sorted and handed to Trilinos row by row in compress(), which means
+     * that entries outside the sparsity pattern of the owning processor are
+     * only detected at that point.
      */
     void add (const size_type       row,
               const size_type       n_cols,
@@ -2012,6 +2034,44 @@ namespace TrilinosWrappers
      */
     std::shared_ptr<Epetra_Export>    nonlocal_matrix_exporter;
 
+    /**
+     * A contribution to an entry in a row owned by another processor.
+     */
+    struct NonlocalEntry
+    {
+      NonlocalEntry (const TrilinosWrappers::types::int_type row,
+                     const TrilinosWrappers::types::int_type column,
+                     const TrilinosScalar                    value)
+        :
+        row (row),
+        column (column),
+        value (value)
+      {}
+
+      TrilinosWrappers::types::int_type row;
+      TrilinosWrappers::types::int_type column;
+      TrilinosScalar value;
+    };
+
+    /**
+     * Contributions to rows owned by other processors that were added while
+     * no separate #nonlocal_matrix is available. Rather than inserting them
+     * one call at a time into the nonlocal storage of Epetra_FECrsMatrix, they
+     * are collected in this array and sorted, merged, and submitted in one
+     * call per row by add_staged_nonlocal_entries() when the matrix is
+     * compressed. The communication then happens in a single exchange in
+     * compress(). Every thread collects its entries in a separate array, such
+     * that add() can be called from several threads at the same time.
+     */
+    Threads::ThreadLocalStorage<std::vector<NonlocalEntry> > nonlocal_entries;
+
+    /**
+     * Sort the entries collected in #nonlocal_entries by all threads, sum up
+     * entries with the same row and column, and add them to the matrix row by
+     * row. Must not be called concurrently with add().
+     */
+    void add_staged_nonlocal_entries ();
+
     /**
      * Trilinos doesn't allow to mix additions to matrix entries and
      * overwriting them (to make synchronization of %parallel computations
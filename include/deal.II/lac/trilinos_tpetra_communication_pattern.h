@@ -0,0 +1,112 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_trilinos_tpetra_communication_pattern_h
+#define dealii_trilinos_tpetra_communication_pattern_h
+
+
+#include <deal.II/base/config.h>
+
+#if defined(DEAL_II_TRILINOS_WITH_TPETRA) && defined(DEAL_II_WITH_MPI)
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/lac/communication_pattern_base.h>
+
+DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
+#  include <Teuchos_RCP.hpp>
+#  include <Tpetra_Import.hpp>
+#  include <Tpetra_Map.hpp>
+DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
+
+#include <memory>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace LinearAlgebra
+{
+  namespace TpetraWrappers
+  {
+    /**
+     * The type of the parallel partitioning of Tpetra objects, identifying
+     * the locally owned global indices.
+     */
+    typedef Tpetra::Map<TrilinosWrappers::types::tpetra_local_ordinal,
+                        TrilinosWrappers::types::tpetra_global_ordinal> MapType;
+
+    /**
+     * The type of the Tpetra object describing the data exchange between two
+     * parallel partitionings.
+     */
+    typedef Tpetra::Import<TrilinosWrappers::types::tpetra_local_ordinal,
+                           TrilinosWrappers::types::tpetra_global_ordinal> ImportType;
+
+    /**
+     * This class implements a wrapper to Tpetra::Import. It is the Tpetra
+     * equivalent of EpetraWrappers::CommunicationPattern and describes the
+     * data exchange between a distributed TpetraWrappers::Vector and a
+     * ReadWriteVector with locally relevant entries.
+     */
+    class CommunicationPattern : public CommunicationPatternBase
+    {
+    public:
+      /**
+       * Reinitialize the communication pattern. The first argument @p
+       * vector_space_vector_index_set is the index set associated to a
+       * VectorSpaceVector object. The second argument @p
+       * read_write_vector_index_set is the index set associated to a
+       * ReadWriteVector object.
+       */
+      CommunicationPattern(const IndexSet &vector_space_vector_index_set,
+                           const IndexSet &read_write_vector_index_set,
+                           const MPI_Comm &communicator);
+
+      /**
+       * Reinitialize the object.
+       */
+      virtual void reinit(const IndexSet &vector_space_vector_index_set,
+                          const IndexSet &read_write_vector_index_set,
+                          const MPI_Comm &communicator) override;
+
+      /**
+       * Return the underlying MPI communicator.
+       */
+      virtual const MPI_Comm &get_mpi_communicator() const override;
+
+      /**
+       * Return the underlying Tpetra::Import object. The source map of the
+       * importer is the map of the VectorSpaceVector, the target map the one
+       * of the ReadWriteVector.
+       */
+      const ImportType &get_tpetra_import() const;
+
+    private:
+      /**
+       * Shared pointer to the MPI communicator used.
+       */
+      std::shared_ptr<const MPI_Comm> comm;
+
+      /**
+       * Pointer to the Tpetra::Import object used.
+       */
+      Teuchos::RCP<ImportType> import;
+    };
+  } // end of namespace TpetraWrappers
+} // end of namespace LinearAlgebra
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
+
+#endif
@@ -0,0 +1,390 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_trilinos_tpetra_sparse_matrix_h
+#define dealii_trilinos_tpetra_sparse_matrix_h
+
+
+#include <deal.II/base/config.h>
+
+#if defined(DEAL_II_TRILINOS_WITH_TPETRA) && defined(DEAL_II_WITH_MPI)
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/trilinos_tpetra_vector.h>
+#include <deal.II/lac/vector_operation.h>
+
+DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
+#  include <mpi.h>
+#  include <Teuchos_RCP.hpp>
+#  include <Tpetra_CrsGraph.hpp>
+#  include <Tpetra_CrsMatrix.hpp>
+DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
+
+DEAL_II_NAMESPACE_OPEN
+
+// forward declarations
+class DynamicSparsityPattern;
+
+namespace LinearAlgebra
+{
+  namespace TpetraWrappers
+  {
+    /**
+     * This class implements a wrapper to the Trilinos distributed sparse
+     * matrix class Tpetra::CrsMatrix, to be used together with
+     * TpetraWrappers::Vector. As opposed to TrilinosWrappers::SparseMatrix
+     * which is based on Epetra, the global indices are 64-bit integers, and
+     * the matrix-vector products are performed by the Kokkos kernels of
+     * Tpetra, i.e., they are threaded or run on an accelerator depending on
+     * the configuration of Trilinos.
+     *
+     * The matrix is set up with a sparsity pattern, the locally owned rows
+     * and the locally owned columns (i.e., the partitioning of the domain
+     * vectors), which builds a fixed Tpetra::CrsGraph. After reinit() the
+     * matrix is open for assembly via add() and set(), both for locally owned
+     * rows and for rows owned by other processors. The contributions to other
+     * processors are exchanged in compress(), which also finishes the
+     * assembly such that the matrix can be applied to vectors. In order to
+     * assemble a matrix again after compress(), set it to zero by
+     * <tt>matrix = 0;</tt>, which is a collective operation.
+     *
+     * The underlying Tpetra::CrsMatrix can be accessed through
+     * trilinos_rcp() in order to use it with the preconditioners of Ifpack2
+     * and MueLu or with the solvers of Belos.
+     *
+     * @note Tpetra is only compiled for a few number types. This class is
+     * instantiated for <tt>Number = double</tt>.
+     *
+     * @ingroup TrilinosWrappers
+     * @ingroup Matrix1
+     */
+    template <typename Number>
+    class SparseMatrix : public Subscriptor
+    {
+    public:
+      /**
+       * Declare the type for container size.
+       */
+      typedef dealii::types::global_dof_index size_type;
+
+      /**
+       * Type of matrix entries.
+       */
+      typedef Number value_type;
+
+      /**
+       * The type of the underlying Tpetra matrix.
+       */
+      typedef Tpetra::CrsMatrix<Number,
+                                TrilinosWrappers::types::tpetra_local_ordinal,
+                                TrilinosWrappers::types::tpetra_global_ordinal> MatrixType;
+
+      /**
+       * The type of the sparsity pattern of the underlying Tpetra matrix.
+       */
+      typedef Tpetra::CrsGraph<TrilinosWrappers::types::tpetra_local_ordinal,
+                               TrilinosWrappers::types::tpetra_global_ordinal> GraphType;
+
+      /**
+       * Default constructor. Generates an empty (zero-size) matrix.
+       */
+      SparseMatrix ();
+
+      /**
+       * Constructor. Equivalent to calling reinit() with the given
+       * arguments.
+       */
+      SparseMatrix (const IndexSet               &row_parallel_partitioning,
+                    const IndexSet               &col_parallel_partitioning,
+                    const DynamicSparsityPattern &sparsity_pattern,
+                    const MPI_Comm               &communicator);
+
+      /**
+       * Copy constructor is deleted.
+       */
+      SparseMatrix (const SparseMatrix &) = delete;
+
+      /**
+       * Copy operator is deleted.
+       */
+      SparseMatrix &operator= (const SparseMatrix &) = delete;
+
+      /**
+       * Initialize the matrix with the sparsity pattern of the locally owned
+       * rows given by @p sparsity_pattern. The rows of the matrix are
+       * distributed according to @p row_parallel_partitioning, and the
+       * columns according to @p col_parallel_partitioning, which is the
+       * partitioning of the vectors the matrix is multiplied with.
+       *
+       * The sparsity pattern must contain all entries of the locally owned
+       * rows, including the ones that other processors add into. If it has
+       * been built from locally relevant cells, the entries need to be
+       * exchanged by SparsityTools::distribute_sparsity_pattern() first.
+       * Entries of the sparsity pattern outside of the locally owned rows are
+       * ignored.
+       *
+       * This is a collective operation that needs to be called on all
+       * processors in order to avoid a dead lock. After this call, all
+       * entries are zero and the matrix is open for assembly.
+       */
+      void reinit (const IndexSet               &row_parallel_partitioning,
+                   const IndexSet               &col_parallel_partitioning,
+                   const DynamicSparsityPattern &sparsity_pattern,
+                   const MPI_Comm               &communicator);
+
+      /**
+       * Set all entries of the matrix to @p d, which must be zero, and open
+       * the matrix for another assembly if compress() has been called before.
+       * This is a collective operation.
+       */
+      SparseMatrix &operator= (const Number d);
+
+      /**
+       * Set the elements given in @p values in row @p row at the columns
+       * given by @p col_indices to the respective values. All entries must be
+       * part of the sparsity pattern.
+       */
+      void set (const size_type  row,
+                const size_type  n_cols,
+                const size_type *col_indices,
+                const Number    *values);
+
+      /**
+       * Set the element (<i>i,j</i>) to @p value.
+       */
+      void set (const size_type i,
+                const size_type j,
+                const Number    value);
+
+      /**
+       * Add the elements given in @p values to the row @p row at the columns
+       * given by @p col_indices. All entries must be part of the sparsity
+       * pattern. If the row is owned by another processor, the entries are
+       * sent to the owner in compress().
+       *
+       * If @p elide_zero_values is true, zero entries in @p values are
+       * skipped.
+       */
+      void add (const size_type  row,
+                const size_type  n_cols,
+                const size_type *col_indices,
+                const Number    *values,
+                const bool       elide_zero_values = true);
+
+      /**
+       * Add @p value to the element (<i>i,j</i>).
+       */
+      void add (const size_type i,
+                const size_type j,
+                const Number    value);
+
+      /**
+       * Exchange the contributions to rows owned by other processors and
+       * finish the assembly of the matrix, such that it can be used in
+       * matrix-vector products. This is a collective operation. The argument
+       * is only present for compatibility with the other matrix classes;
+       * Tpetra decides on the combination of the entries according to the
+       * last set() or add() operation.
+       */
+      void compress (const VectorOperation::values operation);
+
+      /**
+       * Return whether compress() has been called after the last set() or
+       * add() operation.
+       */
+      bool is_compressed () const;
+
+      /**
+       * Return the number of rows of the matrix.
+       */
+      size_type m () const;
+
+      /**
+       * Return the number of columns of the matrix.
+       */
+      size_type n () const;
+
+      /**
+       * Return the number of rows stored on the current processor.
+       */
+      unsigned int local_size () const;
+
+      /**
+       * Return the total number of nonzero elements of the matrix summed over
+       * all processors.
+       */
+      size_type n_nonzero_elements () const;
+
+      /**
+       * Return the Frobenius norm of the matrix.
+       */
+      typename numbers::NumberTraits<Number>::real_type frobenius_norm () const;
+
+      /**
+       * Matrix-vector multiplication: let <i>dst = M*src</i> with <i>M</i>
+       * being this matrix. The vector @p src must have the layout of the
+       * columns of the matrix and @p dst the one of the rows.
+       */
+      void vmult (Vector<Number>       &dst,
+                  const Vector<Number> &src) const;
+
+      /**
+       * Matrix-vector multiplication with the transpose of the matrix: let
+       * <i>dst = M<sup>T</sup>*src</i>.
+       */
+      void Tvmult (Vector<Number>       &dst,
+                   const Vector<Number> &src) const;
+
+      /**
+       * Adding matrix-vector multiplication, i.e., <i>dst += M*src</i>.
+       */
+      void vmult_add (Vector<Number>       &dst,
+                      const Vector<Number> &src) const;
+
+      /**
+       * Adding matrix-vector multiplication with the transpose of the
+       * matrix, i.e., <i>dst += M<sup>T</sup>*src</i>.
+       */
+      void Tvmult_add (Vector<Number>       &dst,
+                       const Vector<Number> &src) const;
+
+      /**
+       * Return the partitioning of the domain space of this matrix, i.e.,
+       * the partitioning of the vectors this matrix has to be multiplied
+       * with.
+       */
+      IndexSet locally_owned_domain_indices () const;
+
+      /**
+       * Return the partitioning of the range space of this matrix, i.e., the
+       * partitioning of the vectors that result from matrix-vector products.
+       */
+      IndexSet locally_owned_range_indices () const;
+
+      /**
+       * Return the MPI communicator object in use with this matrix.
+       */
+      MPI_Comm get_mpi_communicator () const;
+
+      /**
+       * Return a const reference to the underlying Tpetra::CrsMatrix.
+       */
+      const MatrixType &trilinos_matrix () const;
+
+      /**
+       * Return a reference-counted pointer to the underlying
+       * Tpetra::CrsMatrix, as expected by the interfaces of Ifpack2, Belos,
+       * and MueLu.
+       */
+      Teuchos::RCP<MatrixType> trilinos_rcp ();
+
+      /**
+       * Same as above, for constant access.
+       */
+      Teuchos::RCP<const MatrixType> trilinos_rcp () const;
+
+      /**
+       * Return the memory consumption of this class in bytes.
+       */
+      std::size_t memory_consumption () const;
+
+      /**
+       * Exception
+       */
+      DeclExceptionMsg (ExcNotCompressed,
+                        "The matrix must be compressed before this operation "
+                        "can be performed. Call compress() first.");
+
+      /**
+       * Exception
+       */
+      DeclExceptionMsg (ExcNotOpenForAssembly,
+                        "The matrix is not open for assembly since compress() "
+                        "has been called. Set the matrix to zero before "
+                        "assembling it again.");
+
+      /**
+       * Exception
+       */
+      DeclException2 (ExcAccessToNonPresentElement,
+                      size_type, size_type,
+                      << "You tried to access element (" << arg1
+                      << "/" << arg2 << ")"
+                      << " of a sparse matrix, but it appears to not"
+                      << " exist in the Tpetra sparsity pattern.");
+
+    private:
+      /**
+       * Pointer to the Tpetra sparsity pattern, which is fixed after
+       * reinit().
+       */
+      Teuchos::RCP<const GraphType> graph;
+
+      /**
+       * Pointer to the Tpetra matrix object.
+       */
+      Teuchos::RCP<MatrixType> matrix;
+
+      /**
+       * Whether compress() has been called after the last modification.
+       */
+      bool compressed;
+    };
+
+
+
+    // ------------------------- inline functions ----------------------
+
+    template <typename Number>
+    inline
+    void
+    SparseMatrix<Number>::set (const size_type i,
+                               const size_type j,
+                               const Number    value)
+    {
+      set (i, 1, &j, &value);
+    }
+
+
+
+    template <typename Number>
+    inline
+    void
+    SparseMatrix<Number>::add (const size_type i,
+                               const size_type j,
+                               const Number    value)
+    {
+      add (i, 1, &j, &value, false);
+    }
+
+
+
+    template <typename Number>
+    inline
+    bool
+    SparseMatrix<Number>::is_compressed () const
+    {
+      return compressed;
+    }
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
+
+#endif
@@ -24,6 +24,7 @@
 #  include <deal.II/base/index_set.h>
 #  include <deal.II/base/utilities.h>
 #  include <deal.II/base/mpi.h>
+#  include <deal.II/base/thread_management.h>
 #  include <deal.II/lac/exceptions.h>
 #  include <deal.II/lac/vector.h>
 #  include <deal.II/lac/vector_operation.h>
@@ -391,6 +392,15 @@ namespace TrilinosWrappers
      * been constructed with an additional index set for ghost entries in
      * write mode.
      *
+     * For additions via add() into entries owned by other processors of a
+     * vector without the additional index set, the off-processor
+     * contributions are handed to Trilinos under a lock, so several threads
+     * can add into the vector at the same time in that case as well. This
+     * requires that the vector is in a compressed state when the threads
+     * start writing, i.e., compress() has been called after the last
+     * operator() or set() assignment. Operations that overwrite entries must
+     * not run concurrently with additions.
+     *
      * @ingroup TrilinosWrappers
      * @ingroup Vectors
      * @author Martin Kronbichler, Wolfgang Bangerth, Daniel Arndt,
@@ -1254,6 +1264,13 @@ namespace TrilinosWrappers
        */
       std::shared_ptr<Epetra_MultiVector> nonlocal_vector;
 
+      /**
+       * A lock that protects the off-processor entries of #vector against
+       * concurrent additions from several threads in case no
+       * #nonlocal_vector is available.
+       */
+      Threads::Mutex nonlocal_mutex;
+
       /**
        * An IndexSet storing the indices this vector owns exclusively.
        */
@@ -1645,6 +1662,8 @@ namespace TrilinosWrappers
             (*vector)[0][local_row] += values[i];
           else if (nonlocal_vector.get() == nullptr)
             {
+              // the nonlocal storage of Epetra_FEVector is not thread-safe
+              Threads::Mutex::ScopedLock lock (nonlocal_mutex);
               const int ierr = vector->SumIntoGlobalValues (1,
                                                             (const TrilinosWrappers::types::int_type *)(&row),
                                                             &values[i]);
@@ -66,6 +66,8 @@ template <typename> class BlockVector;
 
 template <typename> class VectorView;
 
+template <typename> class MappedVectorMemory;
+
 namespace parallel
 {
   namespace internal
@@ -919,6 +921,16 @@ protected:
    */
   friend class VectorView<Number>;
 
+  /**
+   * BlockVector places the elements of its blocks in one array if requested.
+   */
+  friend class BlockVector<Number>;
+
+  /**
+   * MappedVectorMemory places the elements in memory-mapped files.
+   */
+  friend class MappedVectorMemory<Number>;
+
 private:
 
   /**
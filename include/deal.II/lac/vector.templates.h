@@ -993,7 +993,9 @@ Vector<Number>::allocate()
   // allocate memory with the proper alignment requirements of 64 bytes
   Number *new_values;
   Utilities::System::posix_memalign ((void **)&new_values, 64, sizeof(Number)*max_vec_size);
-  values.reset (new_values);
+  // set the deleter along with the pointer, as the vector might have used
+  // memory it does not own before, see BlockVector::reinit_contiguous()
+  values = std::unique_ptr<Number[], decltype(&free)>(new_values, &free);
 }
 
 
@@ -21,8 +21,10 @@
 #include <deal.II/base/smartpointer.h>
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/thread_local_storage.h>
 #include <deal.II/lac/vector.h>
 
+#include <atomic>
 #include <vector>
 #include <iostream>
 #include <memory>
@@ -299,6 +301,33 @@ public:
  * of creating a new memory pool every time. A drawback of this policy is that
  * vectors once allocated are only released at the end of the program run.
  *
+ * <h3>Thread safety and performance</h3>
+ *
+ * The functions of this class can be called concurrently from several
+ * threads. In order not to serialize threaded solver calls (e.g., nested
+ * LinearOperator objects evaluated within WorkStream), each thread keeps a
+ * small list of the vectors it has returned most recently and serves
+ * subsequent calls to alloc() from this list, in last-in first-out order.
+ * Since solvers typically request and return the same set of temporary
+ * vectors in each iteration, this means that a thread usually gets back a
+ * vector that was already used with the same size, and the call to
+ * <code>reinit</code> that follows does not need to allocate memory. The
+ * global list of vectors, and the lock protecting it, is only used when the
+ * list of the calling thread is empty or full, when a new vector needs to be
+ * created, or when a vector is returned by a different thread than the one
+ * that requested it.
+ *
+ * If the place requesting the vector knows the layout it wants, it can use
+ * the alloc(const VectorType &, const bool) function instead. It prefers
+ * vectors that had the same size as the given model vector when they were
+ * returned, so that vectors of different sizes, such as those of an outer
+ * solver and of an inner solver working on one block, are not mixed up.
+ *
+ * The pool records how many vectors were requested, how many of these
+ * requests were served by reusing a vector, the largest number of vectors
+ * in use at the same time, and the memory held by the vectors of the pool.
+ * These numbers can be queried at any time through get_statistics().
+ *
  * @author Guido Kanschat, 1999, 2007; Wolfgang Bangerth, 2017.
  */
 template <typename VectorType = dealii::Vector<double> >
@@ -345,12 +374,25 @@ public:
    */
   virtual VectorType *alloc ();
 
+  /**
+   * Return a pointer to a vector that has been reinitialized to the layout
+   * of the vector @p model, calling <code>reinit(model,
+   * omit_zeroing_entries)</code> on it. Among the unused vectors of the
+   * pool, this function prefers one that had the same size as @p model when
+   * it was returned, in order to make the call to <code>reinit</code>
+   * independent of memory allocation. The vector needs to be returned
+   * through free() like any other vector obtained from alloc().
+   */
+  VectorType *alloc (const VectorType &model,
+                     const bool        omit_zeroing_entries = false);
+
   /**
    * Return a vector and indicate that it is not going to be used any further
    * by the instance that called alloc() to get a pointer to it.
    *
    * For the present class, this means retaining the vector for later reuse by
-   * the alloc() method.
+   * the alloc() method. The vector is kept in the list of the calling thread
+   * unless this list is full.
    *
    * @warning Just like using <code>new</code> and <code>delete</code>
    *   explicitly in code invites bugs where memory is leaked (either
@@ -365,7 +407,9 @@ public:
   virtual void free (const VectorType *const);
 
   /**
-   * Release all vectors that are not currently in use.
+   * Release all vectors that are not currently in use. This function must
+   * not be called while other threads request or return vectors of the same
+   * type.
    */
   static void release_unused_memory ();
 
@@ -374,14 +418,126 @@ public:
    */
   virtual std::size_t memory_consumption() const;
 
+  /**
+   * A structure collecting the usage statistics of the memory pool shared
+   * by all GrowingVectorMemory objects of the same vector type.
+   */
+  struct Statistics
+  {
+    /**
+     * The number of calls to alloc().
+     */
+    std::size_t n_allocations;
+
+    /**
+     * The number of calls to alloc() that could be served with a vector
+     * that had been returned to the pool before.
+     */
+    std::size_t n_reused;
+
+    /**
+     * The number of calls to alloc() that had to create a new vector.
+     */
+    std::size_t n_created;
+
+    /**
+     * The number of calls to alloc(const VectorType &, const bool) that
+     * found an unused vector of the same size as the model vector.
+     */
+    std::size_t n_size_matches;
+
+    /**
+     * The number of vectors currently in use.
+     */
+    std::size_t n_in_use;
+
+    /**
+     * The largest number of vectors that were in use at the same time.
+     */
+    std::size_t max_in_use;
+
+    /**
+     * The memory held by the vectors of the pool, in bytes. Since vectors
+     * are resized by their users, the memory of a vector is recorded at the
+     * time it is returned to the pool.
+     */
+    std::size_t memory;
+
+    /**
+     * The largest value that #memory has taken so far.
+     */
+    std::size_t max_memory;
+  };
+
+  /**
+   * Return the usage statistics of the memory pool for the current vector
+   * type. This function can be called at any time; the values are collected
+   * without the need of synchronization with the threads using the pool, so
+   * they might be slightly out of date when alloc() or free() run
+   * concurrently.
+   */
+  static Statistics get_statistics ();
+
 private:
   /**
-   * A type that describes this entries of an array that represents
-   * the vectors stored by this object. The first component of the pair
-   * is be a flag telling whether the vector is used, the second
-   * a pointer to the vector itself.
+   * An entry of the memory pool, representing one vector.
    */
-  typedef std::pair<bool, std::unique_ptr<VectorType> > entry_type;
+  struct Entry
+  {
+    /**
+     * Constructor. Creates an empty vector.
+     */
+    Entry ();
+
+    /**
+     * The vector itself.
+     */
+    std::unique_ptr<VectorType> vector;
+
+    /**
+     * The size of the vector at the time it was last returned to the pool.
+     * Used to find a vector of a suitable size in alloc(const VectorType &,
+     * const bool).
+     */
+    size_type size;
+
+    /**
+     * The memory consumption of the vector at the time it was last returned
+     * to the pool.
+     */
+    std::size_t memory;
+  };
+
+  /**
+   * The list of vectors handed out to, and returned by, one thread.
+   */
+  struct ThreadCache
+  {
+    /**
+     * The maximal number of unused vectors kept in the list of one thread.
+     * Further vectors returned by the thread go to the global list.
+     */
+    static const unsigned int max_free_entries = 16;
+
+    /**
+     * Mutex protecting the two lists below. In the common case it is only
+     * acquired by the thread owning the lists and therefore uncontended; the
+     * lists of other threads are only searched when a vector is returned by
+     * a different thread than the one that requested it.
+     */
+    mutable Threads::Mutex mutex;
+
+    /**
+     * Vectors returned by this thread and available for reuse, with the
+     * most recently returned one at the end.
+     */
+    std::vector<Entry *> free_entries;
+
+    /**
+     * Vectors handed out to this thread and not yet returned.
+     */
+    std::vector<Entry *> used_entries;
+  };
 
   /**
    * The class providing the actual storage for the memory pool.
@@ -410,11 +566,55 @@ private:
     void initialize(const size_type size);
 
     /**
-     * Pointer to the storage object
+     * Return the list of the calling thread, creating it upon first use.
+     */
+    ThreadCache &get_thread_cache ();
+
+    /**
+     * Pointer to the storage object owning all vectors of the pool.
+     * Protected by GrowingVectorMemory::mutex.
      */
-    std::vector<entry_type> *data;
+    std::vector<std::unique_ptr<Entry> > *data;
+
+    /**
+     * Vectors available for reuse that are not held in the list of a
+     * particular thread. Protected by GrowingVectorMemory::mutex.
+     */
+    std::vector<Entry *> free_entries;
+
+    /**
+     * The lists of all threads that have used the pool so far, in order to
+     * find vectors returned by another thread and to release the memory
+     * held in the lists. Protected by GrowingVectorMemory::mutex.
+     */
+    std::vector<std::shared_ptr<ThreadCache> > thread_caches;
+
+    /**
+     * The list of the current thread.
+     */
+    Threads::ThreadLocalStorage<std::shared_ptr<ThreadCache> > thread_cache;
+
+    /**
+     * Counters behind get_statistics(). See the Statistics structure for
+     * their meaning.
+     */
+    std::atomic<std::size_t> n_allocations;
+    std::atomic<std::size_t> n_reused;
+    std::atomic<std::size_t> n_size_matches;
+    std::atomic<std::size_t> n_in_use;
+    std::atomic<std::size_t> max_in_use;
+    std::atomic<std::size_t> memory;
+    std::atomic<std::size_t> max_memory;
   };
 
+  /**
+   * Take an unused vector from the pool, preferring one whose size was
+   * @p size when it was returned if @p match_size is set, or create a new
+   * one. The returned entry is recorded as used by the calling thread.
+   */
+  static Entry *get_entry (const bool      match_size,
+                           const size_type size);
+
   /**
    * Array of allocated vectors.
    */
@@ -424,13 +624,13 @@ private:
    * Overall number of allocations. Only used for bookkeeping and to generate
    * output at the end of an object's lifetime.
    */
-  size_type total_alloc;
+  std::atomic<size_type> total_alloc;
 
   /**
    * Number of vectors currently allocated in this object; used for detecting
    * memory leaks.
    */
-  size_type current_alloc;
+  std::atomic<size_type> current_alloc;
 
   /**
    * A flag controlling the logging of statistics by the destructor.
@@ -438,7 +638,7 @@ private:
   bool log_statistics;
 
   /**
-   * Mutex to synchronize access to internal data of this object from multiple
+   * Mutex to synchronize access to the global data of the pool from multiple
    * threads.
    */
   static Threads::Mutex mutex;
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2007 - 2015 by the deal.II authors
+// Copyright (C) 2007 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -20,20 +20,68 @@
 #include <deal.II/lac/vector_memory.h>
 #include <deal.II/base/std_cxx14/memory.h>
 
+#include <algorithm>
+#include <iterator>
+
 DEAL_II_NAMESPACE_OPEN
 
 
+namespace internal
+{
+  namespace GrowingVectorMemory
+  {
+    /**
+     * Set @p maximum to @p value if the latter is larger.
+     */
+    inline
+    void
+    atomic_max (std::atomic<std::size_t> &maximum,
+                const std::size_t         value)
+    {
+      std::size_t old_value = maximum.load();
+      while (old_value < value &&
+             !maximum.compare_exchange_weak(old_value, value))
+        ;
+    }
+  }
+}
+
+
+
 template <typename VectorType>
 typename GrowingVectorMemory<VectorType>::Pool GrowingVectorMemory<VectorType>::pool;
 
 template <typename VectorType>
 Threads::Mutex GrowingVectorMemory<VectorType>::mutex;
 
+template <typename VectorType>
+const unsigned int GrowingVectorMemory<VectorType>::ThreadCache::max_free_entries;
+
+
+
+template <typename VectorType>
+inline
+GrowingVectorMemory<VectorType>::Entry::Entry()
+  :
+  vector(std_cxx14::make_unique<VectorType>()),
+  size(0),
+  memory(0)
+{}
+
+
+
 template <typename VectorType>
 inline
 GrowingVectorMemory<VectorType>::Pool::Pool()
   :
-  data(nullptr)
+  data(nullptr),
+  n_allocations(0),
+  n_reused(0),
+  n_size_matches(0),
+  n_in_use(0),
+  max_in_use(0),
+  memory(0),
+  max_memory(0)
 {}
 
 
@@ -48,6 +96,8 @@ GrowingVectorMemory<VectorType>::Pool::~Pool()
 
   // delete the 'data' object. this also releases all vectors
   // that are pointed to by the std::unique_ptrs
+  free_entries.clear();
+  thread_caches.clear();
   data->clear();
   delete data;
 }
@@ -60,19 +110,35 @@ GrowingVectorMemory<VectorType>::Pool::initialize(const size_type size)
 {
   if (data == nullptr)
     {
-      data = new std::vector<entry_type>(size);
-
-      for (typename std::vector<entry_type>::iterator i= data->begin();
-           i != data->end();
-           ++i)
+      data = new std::vector<std::unique_ptr<Entry> >();
+      data->reserve(size);
+      for (size_type i=0; i<size; ++i)
         {
-          i->first = false;
-          i->second = std_cxx14::make_unique<VectorType>();
+          data->emplace_back(std_cxx14::make_unique<Entry>());
+          free_entries.push_back(data->back().get());
         }
     }
 }
 
 
+
+template <typename VectorType>
+inline
+typename GrowingVectorMemory<VectorType>::ThreadCache &
+GrowingVectorMemory<VectorType>::Pool::get_thread_cache()
+{
+  std::shared_ptr<ThreadCache> &cache = thread_cache.get();
+  if (cache.get() == nullptr)
+    {
+      cache = std::make_shared<ThreadCache>();
+      Threads::Mutex::ScopedLock lock(mutex);
+      thread_caches.push_back(cache);
+    }
+  return *cache;
+}
+
+
+
 template <typename VectorType>
 inline
 GrowingVectorMemory<VectorType>::GrowingVectorMemory (const size_type initial_size,
@@ -93,11 +159,12 @@ inline
 GrowingVectorMemory<VectorType>::~GrowingVectorMemory()
 {
   AssertNothrow(current_alloc == 0,
-                StandardExceptions::ExcMemoryLeak(current_alloc));
+                StandardExceptions::ExcMemoryLeak(current_alloc.load()));
   if (log_statistics)
     {
+      Threads::Mutex::ScopedLock lock(mutex);
       deallog << "GrowingVectorMemory:Overall allocated vectors: "
-              << total_alloc << std::endl;
+              << total_alloc.load() << std::endl;
       deallog << "GrowingVectorMemory:Maximum allocated vectors: "
               << pool.data->size() << std::endl;
     }
@@ -107,29 +174,102 @@ GrowingVectorMemory<VectorType>::~GrowingVectorMemory()
 
 template <typename VectorType>
 inline
-VectorType *
-GrowingVectorMemory<VectorType>::alloc ()
+typename GrowingVectorMemory<VectorType>::Entry *
+GrowingVectorMemory<VectorType>::get_entry (const bool      match_size,
+                                            const size_type size)
 {
-  Threads::Mutex::ScopedLock lock(mutex);
-
-  ++total_alloc;
-  ++current_alloc;
-  // see if there is a free vector
-  // available in our list
-  for (typename std::vector<entry_type>::iterator i=pool.data->begin();
-       i != pool.data->end(); ++i)
+  ThreadCache &cache = pool.get_thread_cache();
+  Entry *entry = nullptr;
+
+  // look into the list of the calling thread first. the lock is only
+  // contended if another thread returns a vector obtained by this thread at
+  // the same time
+  {
+    Threads::Mutex::ScopedLock lock(cache.mutex);
+    typename std::vector<Entry *>::reverse_iterator it = cache.free_entries.rbegin();
+    if (match_size)
+      {
+        for (; it != cache.free_entries.rend(); ++it)
+          if ((*it)->size == size)
+            break;
+        if (it == cache.free_entries.rend())
+          it = cache.free_entries.rbegin();
+        else
+          ++pool.n_size_matches;
+      }
+    if (it != cache.free_entries.rend())
+      {
+        entry = *it;
+        cache.free_entries.erase(std::next(it).base());
+        ++pool.n_reused;
+      }
+  }
+
+  // then into the global list, or create a new vector. note that we must
+  // not hold the lock of the thread's list while acquiring the global lock
+  if (entry == nullptr)
     {
-      if (i->first == false)
+      Threads::Mutex::ScopedLock lock(mutex);
+      typename std::vector<Entry *>::reverse_iterator it = pool.free_entries.rbegin();
+      if (match_size)
         {
-          i->first = true;
-          return i->second.get();
+          for (; it != pool.free_entries.rend(); ++it)
+            if ((*it)->size == size)
+              break;
+          if (it == pool.free_entries.rend())
+            it = pool.free_entries.rbegin();
+          else
+            ++pool.n_size_matches;
+        }
+      if (it != pool.free_entries.rend())
+        {
+          entry = *it;
+          pool.free_entries.erase(std::next(it).base());
+          ++pool.n_reused;
+        }
+      else
+        {
+          pool.data->emplace_back(std_cxx14::make_unique<Entry>());
+          entry = pool.data->back().get();
         }
     }
 
-  // no free vector found, so let's just allocate a new one
-  pool.data->emplace_back(entry_type (true, std_cxx14::make_unique<VectorType>()));
+  {
+    Threads::Mutex::ScopedLock lock(cache.mutex);
+    cache.used_entries.push_back(entry);
+  }
+
+  ++pool.n_allocations;
+  internal::GrowingVectorMemory::atomic_max(pool.max_in_use, ++pool.n_in_use);
 
-  return pool.data->back().second.get();
+  return entry;
+}
+
+
+
+template <typename VectorType>
+inline
+VectorType *
+GrowingVectorMemory<VectorType>::alloc ()
+{
+  ++total_alloc;
+  ++current_alloc;
+  return get_entry(false, 0)->vector.get();
+}
+
+
+
+template <typename VectorType>
+inline
+VectorType *
+GrowingVectorMemory<VectorType>::alloc (const VectorType &model,
+                                        const bool        omit_zeroing_entries)
+{
+  ++total_alloc;
+  ++current_alloc;
+  VectorType *v = get_entry(true, model.size())->vector.get();
+  v->reinit(model, omit_zeroing_entries);
+  return v;
 }
 
 
@@ -139,19 +279,74 @@ inline
 void
 GrowingVectorMemory<VectorType>::free(const VectorType *const v)
 {
-  Threads::Mutex::ScopedLock lock(mutex);
+  ThreadCache &cache = pool.get_thread_cache();
+  Entry *entry = nullptr;
+  bool keep_in_cache = false;
+
+  // vectors are usually returned by the thread that requested them, in
+  // reverse order, so search the list of the calling thread from the back
+  {
+    Threads::Mutex::ScopedLock lock(cache.mutex);
+    for (typename std::vector<Entry *>::reverse_iterator
+         it = cache.used_entries.rbegin(); it != cache.used_entries.rend(); ++it)
+      if ((*it)->vector.get() == v)
+        {
+          entry = *it;
+          cache.used_entries.erase(std::next(it).base());
+          break;
+        }
+  }
 
-  for (typename std::vector<entry_type>::iterator i=pool.data->begin();
-       i != pool.data->end(); ++i)
+  // otherwise, the vector was requested by another thread
+  if (entry == nullptr)
     {
-      if (v == i->second.get())
+      Threads::Mutex::ScopedLock lock(mutex);
+      for (unsigned int c=0; c<pool.thread_caches.size() && entry == nullptr; ++c)
         {
-          i->first = false;
-          --current_alloc;
-          return;
+          ThreadCache &other = *pool.thread_caches[c];
+          if (&other == &cache)
+            continue;
+          Threads::Mutex::ScopedLock other_lock(other.mutex);
+          for (typename std::vector<Entry *>::iterator
+               it = other.used_entries.begin(); it != other.used_entries.end(); ++it)
+            if ((*it)->vector.get() == v)
+              {
+                entry = *it;
+                other.used_entries.erase(it);
+                break;
+              }
         }
     }
-  Assert(false, typename VectorMemory<VectorType>::ExcNotAllocatedHere());
+
+  Assert(entry != nullptr, typename VectorMemory<VectorType>::ExcNotAllocatedHere());
+  if (entry == nullptr)
+    return;
+
+  --current_alloc;
+  --pool.n_in_use;
+
+  // record the layout and memory of the vector before it becomes visible to
+  // other threads through the lists of free vectors
+  entry->size = v->size();
+  const std::size_t memory = v->memory_consumption();
+  pool.memory -= entry->memory;
+  internal::GrowingVectorMemory::atomic_max(pool.max_memory, pool.memory += memory);
+  entry->memory = memory;
+
+  {
+    Threads::Mutex::ScopedLock lock(cache.mutex);
+    if (cache.free_entries.size() < ThreadCache::max_free_entries)
+      {
+        cache.free_entries.push_back(entry);
+        keep_in_cache = true;
+      }
+  }
+
+  if (keep_in_cache == false)
+    {
+      Threads::Mutex::ScopedLock lock(mutex);
+      pool.free_entries.push_back(entry);
+    }
 }
 
 
@@ -163,8 +358,32 @@ GrowingVectorMemory<VectorType>::release_unused_memory ()
 {
   Threads::Mutex::ScopedLock lock(mutex);
 
-  if (pool.data != nullptr)
-    pool.data->clear();
+  if (pool.data == nullptr)
+    return;
+
+  std::vector<const Entry *> unused (pool.free_entries.begin(),
+                                     pool.free_entries.end());
+  pool.free_entries.clear();
+  for (unsigned int c=0; c<pool.thread_caches.size(); ++c)
+    {
+      ThreadCache &cache = *pool.thread_caches[c];
+      Threads::Mutex::ScopedLock cache_lock(cache.mutex);
+      unused.insert(unused.end(), cache.free_entries.begin(),
+                    cache.free_entries.end());
+      cache.free_entries.clear();
+    }
+  std::sort(unused.begin(), unused.end());
+
+  for (typename std::vector<const Entry *>::const_iterator it = unused.begin();
+       it != unused.end(); ++it)
+    pool.memory -= (*it)->memory;
+
+  pool.data->erase(std::remove_if(pool.data->begin(), pool.data->end(),
+                                  [&unused](const std::unique_ptr<Entry> &entry)
+  {
+    return std::binary_search(unused.begin(), unused.end(), entry.get());
+  }),
+  pool.data->end());
 }
 
 
@@ -177,16 +396,36 @@ GrowingVectorMemory<VectorType>::memory_consumption () const
   Threads::Mutex::ScopedLock lock(mutex);
 
   std::size_t result = sizeof (*this);
-  const typename std::vector<entry_type>::const_iterator
+  const typename std::vector<std::unique_ptr<Entry> >::const_iterator
   end = pool.data->end();
-  for (typename std::vector<entry_type>::const_iterator
+  for (typename std::vector<std::unique_ptr<Entry> >::const_iterator
        i = pool.data->begin(); i != end ; ++i)
-    result += sizeof (*i) + i->second->memory_consumption();
+    result += sizeof (Entry) + (*i)->vector->memory_consumption();
 
   return result;
 }
 
 
+
+template <typename VectorType>
+inline
+typename GrowingVectorMemory<VectorType>::Statistics
+GrowingVectorMemory<VectorType>::get_statistics ()
+{
+  Statistics statistics;
+  statistics.n_allocations = pool.n_allocations;
+  statistics.n_reused = pool.n_reused;
+  statistics.n_created = statistics.n_allocations - std::min(statistics.n_reused,
+                                                             statistics.n_allocations);
+  statistics.n_size_matches = pool.n_size_matches;
+  statistics.n_in_use = pool.n_in_use;
+  statistics.max_in_use = pool.max_in_use;
+  statistics.memory = pool.memory;
+  statistics.max_memory = pool.max_memory;
+  return statistics;
+}
+
+
 DEAL_II_NAMESPACE_CLOSE
 
 #endif
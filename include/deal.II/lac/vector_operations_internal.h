@@ -875,6 +875,51 @@ namespace internal
       Number a;
     };
 
+    template <typename Number, typename RealType>
+    struct AddAndAddAndNorm2
+    {
+      static const bool vectorizes = VectorizedArray<Number>::n_array_elements > 1;
+
+      AddAndAddAndNorm2(Number *X, const Number *V, Number *Y, const Number *W,
+                        Number a)
+        :
+        X(X),
+        V(V),
+        Y(Y),
+        W(W),
+        a(a)
+      {}
+
+      RealType
+      operator() (const size_type i) const
+      {
+        Y[i] += a * W[i];
+        X[i] += a * V[i];
+        return numbers::NumberTraits<Number>::abs_square(X[i]);
+      }
+
+      VectorizedArray<Number>
+      do_vectorized(const size_type i) const
+      {
+        VectorizedArray<Number> x, v, y, w;
+        y.load(Y+i);
+        w.load(W+i);
+        y += a * w;
+        y.store(Y+i);
+        x.load(X+i);
+        v.load(V+i);
+        x += a * v;
+        x.store(X+i);
+        return x * x;
+      }
+
+      Number *X;
+      const Number *V;
+      Number *Y;
+      const Number *W;
+      Number a;
+    };
+
 
 
     // this is the main working loop for all vector sums using the templated
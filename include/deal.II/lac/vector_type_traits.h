@@ -47,6 +47,34 @@ template <typename T>
 struct is_serial_vector;
 
 
+
+/**
+ * Type trait that indicates whether a vector class provides the fused
+ * operation
+ * @code
+ *   real_type VectorType::add_and_norm_sqr (const Number a, const VectorType &V,
+ *                                           VectorType &X, const VectorType &W);
+ * @endcode
+ * that performs the two updates <code>X += a*W</code> and <code>*this +=
+ * a*V</code> and returns the squared norm of the updated calling vector in a
+ * single sweep through the data. SolverCG uses this function for the update
+ * of the solution and residual vectors if the trait is true, and separate
+ * vector operations otherwise.
+ *
+ * The default is @p false. Vector classes providing the function declare the
+ * specialization
+ * @code
+ *   template <>
+ *   struct has_fused_cg_update< VectorType > : std::true_type {};
+ * @endcode
+ * in the header file of the vector declaration.
+ */
+template <typename T>
+struct has_fused_cg_update : std::false_type
+{
+};
+
+
 DEAL_II_NAMESPACE_CLOSE
 
 #endif
@@ -19,6 +19,7 @@
 #include <deal.II/base/tensor.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/lac/cuda_vector.h>
+#include <deal.II/matrix_free/cuda_hanging_nodes_internal.h>
 #include <deal.II/matrix_free/cuda_matrix_free.h>
 #include <deal.II/matrix_free/cuda_matrix_free.templates.cuh>
 #include <deal.II/matrix_free/cuda_tensor_product_kernels.cuh>
@@ -29,11 +30,101 @@ namespace CUDAWrappers
 {
   namespace internal
   {
+    /**
+     * Interpolate the values on the hanging faces and edges of a cell along
+     * the coordinate direction @p direction. The degrees of freedom taking
+     * part are those on hanging faces not orthogonal to @p direction and
+     * those on hanging edges parallel to @p direction. For these, each
+     * thread computes the interpolation from the coarse values stored at the
+     * same line in @p direction, using the 1D interpolation matrices in @p
+     * constraint_weights. The transpose interpolation is used for @p
+     * transpose equal to true.
+     */
+    template <int dim, int fe_degree, int direction, bool transpose, typename Number>
+    __device__ inline void interpolate_hanging_nodes_shmem(Number            *values,
+                                                           const unsigned int constr)
+    {
+      const unsigned int n_dofs_1d = fe_degree + 1;
+      const unsigned int position[3] = {threadIdx.x % n_dofs_1d,
+                                        dim>1 ? threadIdx.y : 0,
+                                        dim>2 ? threadIdx.z : 0
+                                       };
+      const unsigned int stride[3] = {1, n_dofs_1d, n_dofs_1d*n_dofs_1d};
+
+      bool constrained = false;
+      for (unsigned int d=0; d<dim; ++d)
+        if (d != direction && (constr & (constr_face_x << d)) &&
+            position[d] == ((constr & (constr_type_x << d)) ? fe_degree : 0))
+          constrained = true;
+      if (dim == 3 && (constr & (constr_edge_x << direction)))
+        {
+          bool on_edge = true;
+          for (unsigned int d=0; d<dim; ++d)
+            if (d != direction &&
+                position[d] != ((constr & (constr_type_x << d)) ? fe_degree : 0))
+              on_edge = false;
+          if (on_edge)
+            constrained = true;
+        }
+
+      Number t = 0;
+      const unsigned int idx = position[0] + position[1]*stride[1] + position[2]*stride[2];
+      if (constrained)
+        {
+          const Number *weights = reinterpret_cast<const Number *>(constraint_weights) +
+                                  ((constr & (constr_type_x << direction)) ?
+                                   n_dofs_1d*n_dofs_1d : 0);
+          const unsigned int i = position[direction];
+          const unsigned int line_start = idx - i*stride[direction];
+          for (unsigned int k=0; k<n_dofs_1d; ++k)
+            t += (transpose ? weights[k*n_dofs_1d+i] : weights[i*n_dofs_1d+k]) *
+                 values[line_start + k*stride[direction]];
+        }
+
+      // all threads must have read the old values before they are overwritten
+      __syncthreads();
+      if (constrained)
+        values[idx] = t;
+      __syncthreads();
+    }
+
+
+
+    /**
+     * Resolve the hanging node constraints of the current cell in shared
+     * memory. Before the call, @p values holds the values of the degrees of
+     * freedom of the coarse neighbors on the hanging faces and edges; after
+     * the call, these are replaced by the interpolated values on the hanging
+     * nodes. The transpose operation applied by distribute_local_to_global()
+     * adds the contributions of the hanging nodes to the coarse degrees of
+     * freedom. The interpolation is done one direction after the other,
+     * which is exact because the constraints have tensor product structure.
+     *
+     * This function contains barriers and must be called by all threads of a
+     * block, including the ones of unconstrained cells.
+     */
     template <int dim, int fe_degree, bool transpose, typename Number>
     __device__ void resolve_hanging_nodes_shmem(Number *values, const unsigned
                                                 int constr)
     {
-      //TODO
+      // the values might have been written by other threads of the cell
+      __syncthreads();
+      if (transpose)
+        {
+          if (dim > 2)
+            interpolate_hanging_nodes_shmem<dim,fe_degree,2,transpose>(values, constr);
+          if (dim > 1)
+            interpolate_hanging_nodes_shmem<dim,fe_degree,1,transpose>(values, constr);
+          interpolate_hanging_nodes_shmem<dim,fe_degree,0,transpose>(values, constr);
+        }
+      else
+        {
+          interpolate_hanging_nodes_shmem<dim,fe_degree,0,transpose>(values, constr);
+          if (dim > 1)
+            interpolate_hanging_nodes_shmem<dim,fe_degree,1,transpose>(values, constr);
+          if (dim > 2)
+            interpolate_hanging_nodes_shmem<dim,fe_degree,2,transpose>(values, constr);
+        }
     }
   }
 
@@ -216,9 +307,10 @@ namespace CUDAWrappers
     // Use the read-only data cache.
     values[idx] = __ldg(&src[src_idx]);
 
-    if (constraint_mask)
-      internal::resolve_hanging_nodes_shmem<dim,fe_degree,false>(values,
-                                                                 constraint_mask);
+    // the barriers in the resolution of the hanging nodes must be reached by
+    // all threads of the block, so the mask is only tested inside
+    internal::resolve_hanging_nodes_shmem<dim,fe_degree,false>(values,
+                                                               constraint_mask);
 
     __syncthreads();
   }
@@ -233,10 +325,8 @@ namespace CUDAWrappers
   {
     static_assert(n_components_ == 1, "This function only supports FE with one \
                   components");
-    if (constraint_mask)
-      internal::resolve_hanging_nodes_shmem<dim,fe_degree,true>(values,
-                                                                constraint_mask);
-
+    internal::resolve_hanging_nodes_shmem<dim,fe_degree,true>(values,
+                                                              constraint_mask);
 
     const unsigned int idx = (threadIdx.x%n_q_points_1d)
                              + (dim>1 ? threadIdx.y : 0) * n_q_points_1d
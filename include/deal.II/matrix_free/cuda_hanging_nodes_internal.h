@@ -0,0 +1,353 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2018 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_cuda_hanging_nodes_internal_h
+#define dealii_cuda_hanging_nodes_internal_h
+
+#include <deal.II/base/config.h>
+
+#ifdef DEAL_II_WITH_CUDA
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/grid/tria.h>
+
+#include <utility>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace CUDAWrappers
+{
+  namespace internal
+  {
+    /**
+     * The bits of the constraint mask that is stored for every cell. The
+     * first @p dim bits store the position of the cell within its parent,
+     * i.e., bit <tt>d</tt> is set if the cell occupies the upper half of the
+     * parent in direction <tt>d</tt>. The next bits indicate which faces and
+     * (in 3D) which edges of the cell are hanging. Only the faces and edges
+     * on the boundary of the parent can be hanging, so their position
+     * follows from the child position: for a cell in the lower half of its
+     * parent in direction <tt>d</tt>, the hanging face with normal
+     * <tt>d</tt> is the face at the lower end, and vice versa. The edge bit
+     * <tt>constr_edge_d</tt> refers to the edge that is parallel to the
+     * coordinate direction <tt>d</tt>.
+     *
+     * @ingroup CUDAWrappers
+     */
+    enum ConstraintTypes
+    {
+      unconstrained = 0,
+      constr_type_x = 1 << 0,
+      constr_type_y = 1 << 1,
+      constr_type_z = 1 << 2,
+      constr_face_x = 1 << 3,
+      constr_face_y = 1 << 4,
+      constr_face_z = 1 << 5,
+      constr_edge_x = 1 << 6,
+      constr_edge_y = 1 << 7,
+      constr_edge_z = 1 << 8
+    };
+
+
+
+    /**
+     * This class sets up the data needed to resolve the hanging node
+     * constraints of continuous elements on the device. Instead of the
+     * indices of the constrained degrees of freedom, the indices of the
+     * degrees of freedom on the coarser side of a hanging face or edge are
+     * stored for a cell, placed at the positions in lexicographic order that
+     * they take with respect to the tensor product on the parent. The device
+     * code then interpolates from these coarse values to the hanging degrees
+     * of freedom, using the information in the constraint mask. This is the
+     * same idea as used by ConstraintValues for the CPU code, but it
+     * exploits the tensor product structure of the constraints instead of
+     * storing the weights for each constrained degree of freedom.
+     *
+     * Only isotropic refinement and faces in standard orientation are
+     * supported.
+     *
+     * @ingroup CUDAWrappers
+     */
+    template <int dim>
+    class HangingNodes
+    {
+    public:
+      /**
+       * Constructor. The argument @p lexicographic_mapping translates from
+       * the lexicographic numbering of the degrees of freedom to the
+       * numbering of the finite element.
+       */
+      HangingNodes(const unsigned int                fe_degree,
+                   const DoFHandler<dim>            &dof_handler,
+                   const std::vector<unsigned int>  &lexicographic_mapping);
+
+      /**
+       * Compute the constraint mask of @p cell and replace the entries of @p
+       * dof_indices, which hold the indices of the cell in lexicographic
+       * order, on the hanging faces and edges by the indices on the coarser
+       * neighbors.
+       */
+      template <typename CellIterator>
+      void setup_constraints(std::vector<types::global_dof_index> &dof_indices,
+                             const CellIterator                   &cell,
+                             unsigned int                         &mask) const;
+
+    private:
+      /**
+       * Return the direction of the line @p line of a hexahedron, and write
+       * the position (zero or fe_degree) of the line along the other
+       * coordinate directions into @p position.
+       */
+      unsigned int line_position(const unsigned int line,
+                                 unsigned int       position[3]) const;
+
+      /**
+       * Return the lexicographic index of the point at @p position.
+       */
+      unsigned int lexicographic_index(const unsigned int position[3]) const;
+
+      const unsigned int fe_degree;
+
+      const DoFHandler<dim> &dof_handler;
+
+      const std::vector<unsigned int> &lexicographic_mapping;
+
+      /**
+       * For every line of a 3D mesh, the active cells that contain the line
+       * together with the number of the line within the cell. This is used
+       * to find coarser neighbors across edges, which are not recorded by
+       * the neighbor information of the triangulation.
+       */
+      std::vector<std::vector<std::pair<typename DoFHandler<dim>::cell_iterator,
+          unsigned int> > > line_to_cells;
+    };
+
+
+
+    template <int dim>
+    HangingNodes<dim>::HangingNodes(const unsigned int                fe_degree,
+                                    const DoFHandler<dim>            &dof_handler,
+                                    const std::vector<unsigned int>  &lexicographic_mapping)
+      :
+      fe_degree(fe_degree),
+      dof_handler(dof_handler),
+      lexicographic_mapping(lexicographic_mapping)
+    {
+      if (dim == 3)
+        {
+          line_to_cells.resize(dof_handler.get_triangulation().n_raw_lines());
+          for (typename DoFHandler<dim>::active_cell_iterator
+               cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+            if (cell->is_artificial() == false)
+              for (unsigned int line=0; line<GeometryInfo<dim>::lines_per_cell; ++line)
+                line_to_cells[cell->line(line)->index()].
+                push_back(std::make_pair(cell, line));
+        }
+    }
+
+
+
+    template <int dim>
+    unsigned int
+    HangingNodes<dim>::line_position(const unsigned int line,
+                                     unsigned int       position[3]) const
+    {
+      Assert(dim == 3, ExcInternalError());
+      // lines 0-3 lie on the bottom face and lines 4-7 on the top face,
+      // alternating between the y and x directions; lines 8-11 point into z
+      // direction
+      if (line < 8)
+        {
+          position[2] = (line / 4) * fe_degree;
+          if (line % 4 < 2)
+            {
+              position[0] = (line % 2) * fe_degree;
+              return 1;
+            }
+          else
+            {
+              position[1] = (line % 2) * fe_degree;
+              return 0;
+            }
+        }
+      else
+        {
+          position[0] = (line % 2) * fe_degree;
+          position[1] = ((line-8) / 2) * fe_degree;
+          return 2;
+        }
+    }
+
+
+
+    template <int dim>
+    unsigned int
+    HangingNodes<dim>::lexicographic_index(const unsigned int position[3]) const
+    {
+      const unsigned int n_dofs_1d = fe_degree + 1;
+      unsigned int index = 0;
+      for (int d=dim-1; d>=0; --d)
+        index = index * n_dofs_1d + position[d];
+      return index;
+    }
+
+
+
+    template <int dim>
+    template <typename CellIterator>
+    void
+    HangingNodes<dim>::setup_constraints(std::vector<types::global_dof_index> &dof_indices,
+                                         const CellIterator                   &cell,
+                                         unsigned int                         &mask) const
+    {
+      mask = unconstrained;
+
+      // there are no hanging nodes in 1D and on the coarsest level
+      if (dim == 1 || cell->level() == 0)
+        return;
+
+      const typename DoFHandler<dim>::cell_iterator parent = cell->parent();
+      AssertThrow(parent->refinement_case() == RefinementCase<dim>::isotropic_refinement,
+                  ExcMessage("Hanging nodes in CUDAWrappers::MatrixFree are only "
+                             "implemented for isotropic refinement."));
+      unsigned int child = 0;
+      for ( ; child<parent->n_children(); ++child)
+        if (parent->child(child) == cell)
+          break;
+      Assert(child < parent->n_children(), ExcInternalError());
+
+      // the children of an isotropically refined cell are numbered
+      // lexicographically, so the bits of the child number give the position
+      // within the parent
+      const unsigned int n_dofs_1d = fe_degree + 1;
+      unsigned int side[3] = {0, 0, 0};
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          side[d] = (child >> d) & 1;
+          if (side[d])
+            mask |= constr_type_x << d;
+        }
+
+      std::vector<types::global_dof_index> neighbor_dofs(dof_indices.size());
+      bool face_is_hanging[3] = {false, false, false};
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          const unsigned int face = 2*d + side[d];
+          if (cell->at_boundary(face))
+            {
+              AssertThrow(cell->has_periodic_neighbor(face) == false ||
+                          cell->periodic_neighbor_is_coarser(face) == false,
+                          ExcMessage("Hanging nodes over periodic boundaries are "
+                                     "not implemented in CUDAWrappers::MatrixFree."));
+              continue;
+            }
+          if (cell->neighbor_is_coarser(face) == false)
+            continue;
+
+          const typename DoFHandler<dim>::cell_iterator neighbor = cell->neighbor(face);
+          const unsigned int neighbor_face = cell->neighbor_of_coarser_neighbor(face).first;
+          AssertThrow(neighbor_face == (face^1) &&
+                      (dim < 3 || (parent->face_orientation(face) == true &&
+                                   parent->face_flip(face) == false &&
+                                   parent->face_rotation(face) == false &&
+                                   neighbor->face_orientation(neighbor_face) == true &&
+                                   neighbor->face_flip(neighbor_face) == false &&
+                                   neighbor->face_rotation(neighbor_face) == false)),
+                      ExcMessage("Hanging nodes in CUDAWrappers::MatrixFree are only "
+                                 "implemented for neighbors in standard orientation."));
+
+          mask |= constr_face_x << d;
+          face_is_hanging[d] = true;
+
+          // the degrees of freedom on the face take the same tangential
+          // position on the neighbor, which sits on the opposite side of the
+          // face
+          neighbor->get_dof_indices(neighbor_dofs);
+          for (unsigned int i=0; i<dof_indices.size(); ++i)
+            {
+              unsigned int position[3] = {0, 0, 0};
+              for (unsigned int e=0, j=i; e<dim; ++e, j/=n_dofs_1d)
+                position[e] = j % n_dofs_1d;
+              if (position[d] != side[d]*fe_degree)
+                continue;
+              position[d] = (1-side[d]) * fe_degree;
+              dof_indices[i] = neighbor_dofs[lexicographic_mapping[lexicographic_index(position)]];
+            }
+        }
+
+      // in 3D, an edge can be hanging without any of the adjacent faces
+      // being hanging, which we detect by looking for active cells that share
+      // the edge of the parent
+      if (dim == 3)
+        for (unsigned int line=0; line<GeometryInfo<dim>::lines_per_cell; ++line)
+          {
+            unsigned int position[3] = {0, 0, 0};
+            const unsigned int direction = line_position(line, position);
+            bool on_parent_boundary = true;
+            bool in_hanging_face = false;
+            for (unsigned int d=0; d<dim; ++d)
+              if (d != direction)
+                {
+                  if (position[d] != side[d]*fe_degree)
+                    on_parent_boundary = false;
+                  if (face_is_hanging[d])
+                    in_hanging_face = true;
+                }
+            if (on_parent_boundary == false || in_hanging_face == true)
+              continue;
+
+            const std::vector<std::pair<typename DoFHandler<dim>::cell_iterator,
+                  unsigned int> > &cells = line_to_cells[parent->line(line)->index()];
+            if (cells.empty())
+              continue;
+
+            const typename DoFHandler<dim>::cell_iterator coarse = cells[0].first;
+            const unsigned int coarse_line = cells[0].second;
+            mask |= constr_edge_x << direction;
+
+            // the line might be oriented differently in the coarse cell, so
+            // compare the vertices to find the direction
+            const bool same_direction =
+              coarse->vertex_index(GeometryInfo<dim>::line_to_cell_vertices(coarse_line,0))
+              == parent->vertex_index(GeometryInfo<dim>::line_to_cell_vertices(line,0));
+            Assert(same_direction ||
+                   coarse->vertex_index(GeometryInfo<dim>::line_to_cell_vertices(coarse_line,1))
+                   == parent->vertex_index(GeometryInfo<dim>::line_to_cell_vertices(line,0)),
+                   ExcInternalError());
+
+            unsigned int coarse_position[3] = {0, 0, 0};
+            const unsigned int coarse_direction = line_position(coarse_line, coarse_position);
+            coarse->get_dof_indices(neighbor_dofs);
+            for (unsigned int k=0; k<n_dofs_1d; ++k)
+              {
+                position[direction] = k;
+                coarse_position[coarse_direction] = same_direction ? k : fe_degree-k;
+                dof_indices[lexicographic_index(position)] =
+                  neighbor_dofs[lexicographic_mapping[lexicographic_index(coarse_position)]];
+              }
+          }
+    }
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
+
+#endif
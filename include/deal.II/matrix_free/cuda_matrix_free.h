@@ -21,6 +21,7 @@
 
 #ifdef DEAL_II_WITH_CUDA
 
+#include <deal.II/base/partitioner.h>
 #include <deal.II/base/quadrature.h>
 #include <deal.II/base/tensor.h>
 #include <deal.II/dofs/dof_handler.h>
@@ -29,8 +30,11 @@
 #include <deal.II/fe/fe_update_flags.h>
 #include <deal.II/lac/constraint_matrix.h>
 #include <deal.II/lac/cuda_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
 #include <cuda_runtime_api.h>
 
+#include <memory>
+
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -65,6 +69,29 @@ namespace CUDAWrappers
    * This class traverse the cells in a different order than the usual
    * Triangulation class in deal.II.
    *
+   * On triangulations of type parallel::Triangulation, only the locally owned
+   * cells are stored, and the indices of the degrees of freedom refer to the
+   * local numbering of the vector partitioner returned by
+   * get_vector_partitioner(), i.e., the locally owned range followed by the
+   * ghost entries. In that case, the cell_loop() taking
+   * LinearAlgebra::distributed::Vector arguments must be used, which performs
+   * the exchange of ghost entries through MPI. Each MPI process uses the
+   * device that is active when reinit() is called, so the devices of a node
+   * should be assigned to the processes beforehand, e.g., by calling
+   * <code>cudaSetDevice(rank % n_devices)</code>.
+   *
+   * The hanging node constraints of adaptively refined meshes are not taken
+   * from the ConstraintMatrix passed to reinit(), but they are resolved on
+   * the device by FEEvaluation::read_dof_values() and
+   * FEEvaluation::distribute_local_to_global(). To this end, the cells store
+   * the indices of the degrees of freedom on the coarser side of hanging
+   * faces and edges together with a bit mask describing the constraints, and
+   * the interpolation to the hanging nodes is done in shared memory. The
+   * hanging degrees of freedom themselves are never accessed by the cell
+   * loop, so they should be treated by copy_constrained_values() and
+   * set_constrained_values() like the other constrained entries. Only
+   * isotropic refinement and faces in standard orientation are supported.
+   *
    * @ingroup CUDAWrappers
    */
   template <int dim, typename Number=double>
@@ -140,6 +167,27 @@ namespace CUDAWrappers
 
     unsigned int get_padding_length() const;
 
+    /**
+     * Return the partitioner that describes the parallel layout of the
+     * vectors used in the cell loop. For serial triangulations, the
+     * partitioner contains all degrees of freedom as locally owned entries.
+     */
+    const std::shared_ptr<const Utilities::MPI::Partitioner> &
+    get_vector_partitioner() const;
+
+    /**
+     * Initialize a vector on the device to the size of the degrees of freedom
+     * of the DoFHandler. This is only possible for serial computations.
+     */
+    void initialize_dof_vector(CUDAVector<Number> &vec) const;
+
+    /**
+     * Initialize a distributed vector with the locally owned and ghost
+     * entries of the partitioner returned by get_vector_partitioner(), to be
+     * used with the cell_loop() for distributed triangulations.
+     */
+    void initialize_dof_vector(LinearAlgebra::distributed::Vector<Number> &vec) const;
+
     /**
      * Extracts the information needed to perform loops over cells. The
      * DoFHandler and ConstraintMatrix describe the layout of degrees of
@@ -175,11 +223,39 @@ namespace CUDAWrappers
                    const CUDAVector<Number> &src,
                    CUDAVector<Number> &dst) const;
 
+    /**
+     * Same as above for vectors distributed among several MPI processes. The
+     * ghost entries of @p src are imported on the host, then the locally
+     * owned and ghost entries of both vectors are transferred to buffers on
+     * the device, the cell kernels are run on the device, and the
+     * contributions to the ghost entries of @p dst are sent to their owners
+     * by LinearAlgebra::distributed::Vector::compress(). As in the serial
+     * case, the result of the local operations is added into @p dst.
+     */
+    template <typename functor>
+    void cell_loop(const functor &func,
+                   const LinearAlgebra::distributed::Vector<Number> &src,
+                   LinearAlgebra::distributed::Vector<Number> &dst) const;
+
     void copy_constrained_values(const CUDAVector<Number> &src,
                                  CUDAVector<Number> &dst) const;
 
+    /**
+     * Same as above for distributed vectors, where the locally owned
+     * constrained entries are copied on the host.
+     */
+    void copy_constrained_values(const LinearAlgebra::distributed::Vector<Number> &src,
+                                 LinearAlgebra::distributed::Vector<Number> &dst) const;
+
     void set_constrained_values(const Number val, CUDAVector<Number> &dst) const;
 
+    /**
+     * Same as above for distributed vectors, where the locally owned
+     * constrained entries are set on the host.
+     */
+    void set_constrained_values(const Number val,
+                                LinearAlgebra::distributed::Vector<Number> &dst) const;
+
     /**
      * Free all the memory allocated.
      */
@@ -243,6 +319,12 @@ namespace CUDAWrappers
 
     // Constraints
     unsigned int *constrained_dofs;
+    /**
+     * The locally owned constrained degrees of freedom in the local numbering
+     * of the partitioner, stored on the host for the operations on
+     * distributed vectors.
+     */
+    std::vector<unsigned int> constrained_dofs_host;
     std::vector<unsigned int *> constraint_mask;
     /**
      * Grid dimensions associated to the different colors. The grid dimensions
@@ -263,6 +345,19 @@ namespace CUDAWrappers
     unsigned int padding_length;
     std::vector<unsigned int> row_start;
 
+    /**
+     * Parallel layout of the vectors, used to translate the global indices
+     * of the degrees of freedom into the local numbering of the vectors.
+     */
+    std::shared_ptr<const Utilities::MPI::Partitioner> partitioner;
+
+    /**
+     * Buffers on the device that hold the locally owned and ghost entries of
+     * distributed vectors during the cell loop.
+     */
+    mutable CUDAVector<Number> src_buffer;
+    mutable CUDAVector<Number> dst_buffer;
+
     friend class internal::ReinitHelper<dim,Number>;
   };
 
@@ -22,8 +22,11 @@
 #ifdef DEAL_II_WITH_CUDA
 
 #include <deal.II/base/graph_coloring.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/dofs/dof_tools.h>
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/grid/filtered_iterator.h>
+#include <deal.II/matrix_free/cuda_hanging_nodes_internal.h>
 #include <deal.II/matrix_free/shape_info.h>
 #include <cuda_runtime_api.h>
 #include <functional>
@@ -41,6 +44,9 @@ namespace CUDAWrappers
 #define MAX_ELEM_DEGREE 10
     __constant__ double global_shape_values[(MAX_ELEM_DEGREE+1) * (MAX_ELEM_DEGREE+1)];
     __constant__ double global_shape_gradients[(MAX_ELEM_DEGREE+1) * (MAX_ELEM_DEGREE+1)];
+    // The 1D interpolation matrices from a coarse cell to the lower and the
+    // upper half, used to resolve the hanging node constraints
+    __constant__ double constraint_weights[2 * (MAX_ELEM_DEGREE+1) * (MAX_ELEM_DEGREE+1)];
 
     template <typename Number>
     using CUDAVector = ::dealii::LinearAlgebra::CUDAWrappers::Vector<Number>;
@@ -98,13 +104,13 @@ namespace CUDAWrappers
     /**
      * Helper class to (re)initialize MatrixFree object.
      */
-    //TODO for now does not support hanging_nodes
     template <int dim, typename Number>
     class ReinitHelper
     {
     public:
       ReinitHelper(MatrixFree<dim,Number>        *data,
                    const Mapping<dim>            &mapping,
+                   const DoFHandler<dim>         &dof_handler,
                    const FiniteElement<dim, dim> &fe,
                    const Quadrature<1>           &quad,
                    const ::dealii::internal::MatrixFreeFunctions::ShapeInfo<Number> &shape_info,
@@ -132,12 +138,15 @@ namespace CUDAWrappers
       FEValues<dim> fe_values;
       // Convert the default dof numbering to a lexicographic one
       const std::vector<unsigned int> &lexicographic_inv;
+      std::vector<types::global_dof_index> lexicographic_global_dof_indices;
       std::vector<unsigned int> lexicographic_dof_indices;
       const unsigned int fe_degree;
       const unsigned int dofs_per_cell;
       const unsigned int q_points_per_cell;
       const UpdateFlags &update_flags;
       const unsigned int padding_length;
+      // Setup of the hanging node constraints
+      HangingNodes<dim> hanging_nodes;
     };
 
 
@@ -145,6 +154,7 @@ namespace CUDAWrappers
     template <int dim, typename Number>
     ReinitHelper<dim,Number>::ReinitHelper(MatrixFree<dim,Number>   *data,
                                            const Mapping<dim>       &mapping,
+                                           const DoFHandler<dim>    &dof_handler,
                                            const FiniteElement<dim> &fe,
                                            const Quadrature<1>      &quad,
                                            const ::dealii::internal::MatrixFreeFunctions::ShapeInfo<Number> &shape_info,
@@ -159,9 +169,11 @@ namespace CUDAWrappers
                 update_values | update_gradients | update_JxW_values),
       lexicographic_inv(shape_info.lexicographic_numbering),
       update_flags(update_flags),
-      padding_length(data->get_padding_length())
+      padding_length(data->get_padding_length()),
+      hanging_nodes(fe_degree, dof_handler, lexicographic_inv)
     {
       local_dof_indices.resize(data->dofs_per_cell);
+      lexicographic_global_dof_indices.resize(dofs_per_cell);
       lexicographic_dof_indices.resize(dofs_per_cell);
     }
 
@@ -243,8 +255,18 @@ namespace CUDAWrappers
     {
       cell->get_dof_indices(local_dof_indices);
 
+      // go to the lexicographic numbering and replace the indices on hanging
+      // faces and edges by the ones of the coarser neighbors
       for (unsigned int i=0; i<dofs_per_cell; ++i)
-        lexicographic_dof_indices[i] = local_dof_indices[lexicographic_inv[i]];
+        lexicographic_global_dof_indices[i] = local_dof_indices[lexicographic_inv[i]];
+      hanging_nodes.setup_constraints(lexicographic_global_dof_indices, cell,
+                                      constraint_mask_host[cell_id]);
+
+      // translate into the local numbering of the vectors, which is the
+      // identity for serial computations
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        lexicographic_dof_indices[i] =
+          data->partitioner->global_to_local(lexicographic_global_dof_indices[i]);
 
       memcpy(&local_to_global_host[cell_id*padding_length], lexicographic_dof_indices.data(),
              dofs_per_cell*sizeof(unsigned int));
@@ -477,10 +499,59 @@ namespace CUDAWrappers
         AssertCuda(cuda_error);
       }
 
+    // Setup the interpolation matrices for the hanging nodes. For a point
+    // of the child in the lower (upper) half of the parent, the coarse basis
+    // functions are evaluated at the position of the point in the parent.
+    // Since the shape functions are tensor products, it suffices to evaluate
+    // them along the first coordinate direction.
+    if (dim > 1)
+      {
+        Assert(fe.has_support_points(), ExcNotImplemented());
+        const std::vector<Point<dim>> &unit_points = fe.get_unit_support_points();
+        std::vector<Number> constraint_weights(2*n_dofs_1d*n_dofs_1d);
+        for (unsigned int c=0; c<2; ++c)
+          for (unsigned int i=0; i<n_dofs_1d; ++i)
+            {
+              Point<dim> p;
+              p[0] = 0.5 * (c + unit_points[shape_info.lexicographic_numbering[i]][0]);
+              for (unsigned int j=0; j<n_dofs_1d; ++j)
+                constraint_weights[(c*n_dofs_1d+i)*n_dofs_1d+j] =
+                  fe.shape_value(shape_info.lexicographic_numbering[j], p);
+            }
+
+        cuda_error = cudaMemcpyToSymbol(internal::constraint_weights,
+                                        constraint_weights.data(),
+                                        constraint_weights.size()*sizeof(Number),
+                                        0,
+                                        cudaMemcpyHostToDevice);
+        AssertCuda(cuda_error);
+      }
+
     // Setup the number of cells per CUDA thread block
     cells_per_block = cells_per_block_shmem(dim, fe_degree);
+    AssertThrow(parallelization_scheme != parallel_in_elem ||
+                cells_per_block*Utilities::fixed_power<dim>(n_dofs_1d) <= 1024,
+                ExcMessage("The number of CUDA threads needed per block for degree " +
+                           Utilities::to_string(fe_degree) + " exceeds the "
+                           "maximum of 1024."));
+
+    // Setup the parallel layout of the vectors. On distributed
+    // triangulations, the cells access the locally owned and the ghost
+    // entries of the locally relevant degrees of freedom
+    const parallel::Triangulation<dim> *dist_tria =
+      dynamic_cast<const parallel::Triangulation<dim>*>(&dof_handler.get_triangulation());
+    if (dist_tria != nullptr)
+      {
+        IndexSet locally_relevant_dofs;
+        DoFTools::extract_locally_relevant_dofs(dof_handler, locally_relevant_dofs);
+        partitioner.reset(new Utilities::MPI::Partitioner(dof_handler.locally_owned_dofs(),
+                                                          locally_relevant_dofs,
+                                                          dist_tria->get_communicator()));
+      }
+    else
+      partitioner.reset(new Utilities::MPI::Partitioner(dof_handler.n_dofs()));
 
-    internal::ReinitHelper<dim, Number> helper(this, mapping, fe, quad,
+    internal::ReinitHelper<dim, Number> helper(this, mapping, dof_handler, fe, quad,
                                                shape_info,  update_flags);
 
     // Create a graph coloring
@@ -516,8 +587,14 @@ namespace CUDAWrappers
     for (unsigned int i=0; i<n_colors-1; ++i)
       row_start[i+1] = row_start[i] + n_cells[i] * get_padding_length();
 
-    // Constrained indices
-    n_constrained_dofs = constraints.n_constraints();
+    // Constrained indices. Only the locally owned ones are needed because
+    // the ghost entries of the destination vector are overwritten by their
+    // owners
+    constrained_dofs_host.clear();
+    for (unsigned int i=0; i<partitioner->local_size(); ++i)
+      if (constraints.is_constrained(partitioner->local_to_global(i)))
+        constrained_dofs_host.push_back(i);
+    n_constrained_dofs = constrained_dofs_host.size();
 
     if (n_constrained_dofs != 0)
       {
@@ -531,24 +608,15 @@ namespace CUDAWrappers
         constraint_grid_dim = dim3(constraint_x_n_blocks, constraint_y_n_blocks);
         constraint_block_dim = dim3(BLOCK_SIZE);
 
-        std::vector<dealii::types::global_dof_index> constrained_dofs_host(n_constrained_dofs);
-
-        unsigned int i_constraint = 0;
-        const unsigned int n_dofs = dof_handler.n_dofs();
-        for (unsigned int i=0; i<n_dofs; ++i)
-          {
-            if (constraints.is_constrained(i))
-              {
-                constrained_dofs_host[i_constraint] = i;
-                ++i_constraint;
-              }
-          }
+        std::vector<dealii::types::global_dof_index>
+        constrained_dofs_device_layout(constrained_dofs_host.begin(),
+                                       constrained_dofs_host.end());
 
         cuda_error = cudaMalloc(&constrained_dofs, n_constrained_dofs *
                                 sizeof(dealii::types::global_dof_index));
         AssertCuda(cuda_error);
 
-        cuda_error = cudaMemcpy(constrained_dofs, constrained_dofs_host.data(),
+        cuda_error = cudaMemcpy(constrained_dofs, constrained_dofs_device_layout.data(),
                                 n_constrained_dofs * sizeof(dealii::types::global_dof_index),
                                 cudaMemcpyHostToDevice);
         AssertCuda(cuda_error);
@@ -666,6 +734,38 @@ namespace CUDAWrappers
 
 
 
+  template <int dim, typename Number>
+  void MatrixFree<dim,Number>::copy_constrained_values
+  (const LinearAlgebra::distributed::Vector<Number> &src,
+   LinearAlgebra::distributed::Vector<Number>       &dst) const
+  {
+    Assert(partitioner->is_compatible(*src.get_partitioner()),
+           ExcMessage("The source vector is not compatible with the partitioner "
+                      "of MatrixFree, use initialize_dof_vector()."));
+    Assert(partitioner->is_compatible(*dst.get_partitioner()),
+           ExcMessage("The destination vector is not compatible with the "
+                      "partitioner of MatrixFree, use initialize_dof_vector()."));
+    for (unsigned int i=0; i<constrained_dofs_host.size(); ++i)
+      dst.local_element(constrained_dofs_host[i]) =
+        src.local_element(constrained_dofs_host[i]);
+  }
+
+
+
+  template <int dim, typename Number>
+  void MatrixFree<dim,Number>::set_constrained_values
+  (const Number                                val,
+   LinearAlgebra::distributed::Vector<Number> &dst) const
+  {
+    Assert(partitioner->is_compatible(*dst.get_partitioner()),
+           ExcMessage("The destination vector is not compatible with the "
+                      "partitioner of MatrixFree, use initialize_dof_vector()."));
+    for (unsigned int i=0; i<constrained_dofs_host.size(); ++i)
+      dst.local_element(constrained_dofs_host[i]) = val;
+  }
+
+
+
   template <int dim, typename Number>
   unsigned int MatrixFree<dim,Number>::get_padding_length() const
   {
@@ -674,6 +774,38 @@ namespace CUDAWrappers
 
 
 
+  template <int dim, typename Number>
+  const std::shared_ptr<const Utilities::MPI::Partitioner> &
+  MatrixFree<dim,Number>::get_vector_partitioner() const
+  {
+    return partitioner;
+  }
+
+
+
+  template <int dim, typename Number>
+  void MatrixFree<dim,Number>::initialize_dof_vector(CUDAVector<Number> &vec) const
+  {
+    Assert(partitioner.get() != nullptr, ExcNotInitialized());
+    AssertThrow(partitioner->n_mpi_processes() == 1,
+                ExcMessage("Vectors on the device can only be used for serial "
+                           "computations. Use LinearAlgebra::distributed::Vector "
+                           "on distributed triangulations."));
+    vec.reinit(partitioner->size());
+  }
+
+
+
+  template <int dim, typename Number>
+  void MatrixFree<dim,Number>::initialize_dof_vector
+  (LinearAlgebra::distributed::Vector<Number> &vec) const
+  {
+    Assert(partitioner.get() != nullptr, ExcNotInitialized());
+    vec.reinit(partitioner);
+  }
+
+
+
   template <int dim, typename Number>
   template <typename functor>
   void MatrixFree<dim,Number>::cell_loop(const functor &func,
@@ -687,6 +819,60 @@ namespace CUDAWrappers
 
 
 
+  template <int dim, typename Number>
+  template <typename functor>
+  void MatrixFree<dim,Number>::cell_loop
+  (const functor                                    &func,
+   const LinearAlgebra::distributed::Vector<Number> &src,
+   LinearAlgebra::distributed::Vector<Number>       &dst) const
+  {
+    Assert(partitioner->is_compatible(*src.get_partitioner()),
+           ExcMessage("The source vector is not compatible with the partitioner "
+                      "of MatrixFree, use initialize_dof_vector()."));
+    Assert(partitioner->is_compatible(*dst.get_partitioner()),
+           ExcMessage("The destination vector is not compatible with the "
+                      "partitioner of MatrixFree, use initialize_dof_vector()."));
+
+    const unsigned int n_local_entries = partitioner->local_size() +
+                                         partitioner->n_ghost_indices();
+    if (src_buffer.size() != n_local_entries)
+      {
+        src_buffer.reinit(n_local_entries, true);
+        dst_buffer.reinit(n_local_entries, true);
+      }
+
+    // import the ghost entries of the source vector (unless the user has
+    // already done so) and transfer the locally relevant entries to the
+    // device
+    const bool ghosts_were_set = src.has_ghost_elements();
+    if (ghosts_were_set == false)
+      src.update_ghost_values();
+    cudaError_t cuda_error = cudaMemcpy(src_buffer.get_values(), src.begin(),
+                                        n_local_entries * sizeof(Number),
+                                        cudaMemcpyHostToDevice);
+    AssertCuda(cuda_error);
+    if (ghosts_were_set == false)
+      const_cast<LinearAlgebra::distributed::Vector<Number>&>(src).zero_out_ghosts();
+
+    // the contributions to the ghost entries of the destination are
+    // accumulated starting from zero and then sent to the owners
+    dst.zero_out_ghosts();
+    cuda_error = cudaMemcpy(dst_buffer.get_values(), dst.begin(),
+                            n_local_entries * sizeof(Number),
+                            cudaMemcpyHostToDevice);
+    AssertCuda(cuda_error);
+
+    cell_loop(func, src_buffer, dst_buffer);
+
+    cuda_error = cudaMemcpy(dst.begin(), dst_buffer.get_values(),
+                            n_local_entries * sizeof(Number),
+                            cudaMemcpyDeviceToHost);
+    AssertCuda(cuda_error);
+    dst.compress(VectorOperation::add);
+  }
+
+
+
   template <int dim, typename Number>
   std::size_t MatrixFree<dim, Number>::memory_consumption() const
   {
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2011 - 2016 by the deal.II authors
+// Copyright (C) 2011 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -58,6 +58,39 @@ namespace internal
      */
     struct DoFInfo
     {
+      /**
+       * Describes how the indices of the cells in a macro cell are laid out in
+       * the vector, which determines the kind of vector access in
+       * FEEvaluation, see @p index_storage_variants.
+       */
+      enum class IndexStorageVariants : unsigned char
+      {
+        /**
+         * The general case: The indices are read one by one from @p
+         * dof_indices, resolving constraints on the fly.
+         */
+        full,
+        /**
+         * All cells of the macro cell are free of constraints and the indices
+         * of each cell form a contiguous range in the vector, starting at the
+         * positions stored in @p dof_indices_contiguous. The ranges of
+         * different cells do not overlap. The vector entries can be accessed
+         * by vectorized_load_and_transpose() and
+         * vectorized_transpose_and_store().
+         */
+        contiguous,
+        /**
+         * All cells of the macro cell are free of constraints and the indices
+         * are interleaved, i.e., the <code>i</code>-th degree of freedom of
+         * the cell in lane <code>v</code> sits at position
+         * <code>start + i*vectorization_length + v</code> of the vector, with
+         * <code>start</code> given by the first entry in @p
+         * dof_indices_contiguous of the macro cell. The vector entries can
+         * be accessed by plain vector loads and stores.
+         */
+        interleaved
+      };
+
       /**
        * Default empty constructor.
        */
@@ -155,6 +188,21 @@ namespace internal
                              ConstraintValues<double> &constraint_values,
                              bool                            &cell_at_boundary);
 
+      /**
+       * Append the indices that another DoFInfo object has collected with @p
+       * read_dof_indices for a contiguous range of cells, starting at cell
+       * number @p first_cell of this object. This way, the indices of
+       * different ranges of cells can be read concurrently into separate
+       * objects and then be combined. The temporary numbers of the ghost
+       * indices are shifted by the ghosts already present in this object,
+       * and the positions of the constraints in the pool of @p chunk are
+       * translated by @p constraint_renumbering. The result is the same as
+       * if all cells had been read into this object in sequence.
+       */
+      void append_dof_indices (const DoFInfo                     &chunk,
+                               const unsigned int                 first_cell,
+                               const std::vector<unsigned short> &constraint_renumbering);
+
       /**
        * This method assigns the correct indices to ghost indices from the
        * temporary numbering employed by the @p read_dof_indices function. The
@@ -197,7 +245,9 @@ namespace internal
        * This method reorders the way cells are gone through based on a given
        * renumbering of the cells. It also takes @p vectorization_length cells
        * together and interprets them as one cell only, as is needed for
-       * vectorization.
+       * vectorization. The indices of the macro cells are copied in parallel
+       * on ranges of macro cells, after their positions in the new arrays
+       * have been determined from the sizes of the rows.
        */
       void reorder_cells (const SizeInfo                  &size_info,
                           const std::vector<unsigned int> &renumbering,
@@ -205,6 +255,30 @@ namespace internal
                           const std::vector<unsigned int> &irregular_cells,
                           const unsigned int               vectorization_length);
 
+      /**
+       * Groups the cells of the serial cell loop into chunks and determines,
+       * for each locally owned degree of freedom, the chunk that accesses it
+       * first and the chunk that accesses it last. The result is stored in
+       * @p cell_loop_chunks, @p cell_loop_pre_list and @p
+       * cell_loop_post_list, which allows MatrixFree::cell_loop() to run
+       * user operations on vector entries right before the first cell
+       * touches them and right after their values are final. Degrees of
+       * freedom that are ghosts on other processors or that are not accessed
+       * by any cell are scheduled before the start and after the end of the
+       * loop, respectively.
+       */
+      void compute_cell_loop_pre_post_lists (const SizeInfo     &size_info,
+                                             const unsigned int  vectorization_length);
+
+      /**
+       * Classifies the indices of each macro cell according to
+       * IndexStorageVariants and fills the fields @p index_storage_variants
+       * and @p dof_indices_contiguous. Must be called after the cells have
+       * been reordered by reorder_cells().
+       */
+      void compute_index_storage_variants (const SizeInfo     &size_info,
+                                           const unsigned int  vectorization_length);
+
       /**
        * This helper function determines a block size if the user decided not
        * to force a block size through MatrixFree::AdditionalData. This is
@@ -279,6 +353,13 @@ namespace internal
        */
       std::size_t memory_consumption() const;
 
+      /**
+       * Return a breakdown of the memory consumption returned by
+       * memory_consumption() into the index arrays, the constraint
+       * indicators, the plain indices, and the vector partitioner.
+       */
+      MemoryReport memory_report(const std::string &name) const;
+
       /**
        * Prints a detailed summary of memory consumption in the different
        * structures of this class to the given output stream.
@@ -366,6 +447,35 @@ namespace internal
        */
       std::vector<unsigned int> plain_dof_indices;
 
+      /**
+       * Stores the rowstart indices of the compressed row storage in the @p
+       * dof_indices_per_cell and @p constraint_indicator_per_cell fields,
+       * similarly to @p row_starts. As opposed to @p row_starts, this field
+       * is indexed by the cells in the MatrixFree numbering, i.e.,
+       * <code>macro_cell * vectorization_length + lane</code>, such that the
+       * indices of cells in arbitrary combinations can be accessed. This is
+       * needed for face integrals, where the cells adjacent to the faces in
+       * a batch are in general not part of the same macro cell. Only filled
+       * if @p store_indices_per_cell is set.
+       */
+      std::vector<std::array<unsigned int, 2> > row_starts_per_cell;
+
+      /**
+       * Stores the indices of the degrees of freedom for each cell in the
+       * same format as @p dof_indices, including the indirect contributions
+       * from constraints, but without the interleaving of the cells in a
+       * macro cell. Only filled if @p store_indices_per_cell is set.
+       */
+      std::vector<unsigned int> dof_indices_per_cell;
+
+      /**
+       * Stores the constraint indicators in the format of @p
+       * constraint_indicator, but referring to the non-interleaved indices in
+       * @p dof_indices_per_cell. Only filled if @p store_indices_per_cell is
+       * set.
+       */
+      std::vector<std::pair<unsigned short,unsigned short> > constraint_indicator_per_cell;
+
       /**
        * Stores the dimension of the underlying DoFHandler. Since the indices
        * are not templated, this is the variable that makes the dimension
@@ -394,6 +504,13 @@ namespace internal
        */
       bool store_plain_indices;
 
+      /**
+       * Informs on whether the indices of the individual cells are stored in
+       * a non-interleaved format in addition to the indices of the macro
+       * cells, see @p dof_indices_per_cell.
+       */
+      bool store_indices_per_cell;
+
       /**
        * Stores the index of the active finite element in the hp case.
        */
@@ -412,6 +529,59 @@ namespace internal
        */
       std::vector<std::pair<unsigned int,unsigned int> > fe_index_conversion;
 
+      /**
+       * Stores the boundaries of the chunks of macro cells the serial cell
+       * loop is split into when running operations before and after the
+       * cell operation, see compute_cell_loop_pre_post_lists(). The chunks
+       * do not straddle the boundaries between the inner cells and the cells
+       * with ghosts. Empty if the lists have not been computed.
+       */
+      std::vector<unsigned int> cell_loop_chunks;
+
+      /**
+       * Stores the row start of the ranges in @p cell_loop_pre_list for the
+       * operations to be run before the cell loop (index 0) and before the
+       * chunk <code>c</code> (index <code>c+1</code>).
+       */
+      std::vector<unsigned int> cell_loop_pre_list_index;
+
+      /**
+       * Ranges of locally owned vector entries (in MPI-local index space)
+       * that are accessed for the first time in the chunk given by @p
+       * cell_loop_pre_list_index.
+       */
+      std::vector<std::pair<unsigned int,unsigned int> > cell_loop_pre_list;
+
+      /**
+       * Stores the row start of the ranges in @p cell_loop_post_list for the
+       * operations to be run after the chunk <code>c</code> (index
+       * <code>c</code>) and after the cell loop including the data exchange
+       * (index <code>n_chunks</code>).
+       */
+      std::vector<unsigned int> cell_loop_post_list_index;
+
+      /**
+       * Ranges of locally owned vector entries (in MPI-local index space)
+       * that are accessed for the last time in the chunk given by @p
+       * cell_loop_post_list_index.
+       */
+      std::vector<std::pair<unsigned int,unsigned int> > cell_loop_post_list;
+
+      /**
+       * Stores the layout of the indices of each macro cell, as determined by
+       * compute_index_storage_variants().
+       */
+      std::vector<IndexStorageVariants> index_storage_variants;
+
+      /**
+       * For the macro cells in the IndexStorageVariants::contiguous and
+       * IndexStorageVariants::interleaved categories, stores the position in
+       * the vector of the first degree of freedom of each cell in the macro
+       * cell, i.e., <code>vectorization_length</code> entries per macro cell.
+       * The entries of the other macro cells are unused.
+       */
+      std::vector<unsigned int> dof_indices_contiguous;
+
       /**
        * Temporarily stores the numbers of ghosts during setup. Cleared when
        * calling @p assign_ghosts. Then, all information is collected by the
@@ -19,6 +19,7 @@
 
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/matrix_free/dof_info.h>
@@ -59,6 +60,16 @@ namespace internal
       unsigned short
       insert_entries (const std::vector<std::pair<types::global_dof_index,double> > &entries);
 
+      /**
+       * This function inserts all constraints collected by another object
+       * into this collection, in the order in which they were first inserted
+       * into @p other. It returns the storage positions in this object for
+       * the storage positions of @p other, which allows to combine the
+       * constraints found on different ranges of cells.
+       */
+      std::vector<unsigned short>
+      insert_constraints (const ConstraintValues<Number> &other);
+
       std::vector<std::pair<types::global_dof_index, double> > constraint_entries;
       std::vector<types::global_dof_index> constraint_indices;
 
@@ -122,6 +133,40 @@ namespace internal
 
 
 
+    template <typename Number>
+    std::vector<unsigned short>
+    ConstraintValues<Number>::
+    insert_constraints (const ConstraintValues<Number> &other)
+    {
+      // sort the constraints of the other object by their position in order
+      // to insert them in the same order as a sequential call to
+      // insert_entries would have done
+      std::vector<const std::vector<Number>*> other_constraints (other.constraints.size());
+      for (typename std::map<std::vector<Number>, types::global_dof_index,
+           FPArrayComparator<double> >::const_iterator
+           it = other.constraints.begin(); it != other.constraints.end(); ++it)
+        {
+          AssertIndexRange(it->second, other_constraints.size());
+          other_constraints[it->second] = &it->first;
+        }
+
+      std::vector<unsigned short> renumbering (other_constraints.size());
+      for (unsigned int i=0; i<other_constraints.size(); ++i)
+        {
+          Assert(other_constraints[i] != nullptr, ExcInternalError());
+          const types::global_dof_index next_position = constraints.size();
+          const types::global_dof_index insert_position =
+            constraints.insert(std::make_pair(*other_constraints[i],
+                                              next_position)).first->second;
+          Assert(insert_position < (1<<(8*sizeof(unsigned short))),
+                 ExcInternalError());
+          renumbering[i] = static_cast<unsigned short>(insert_position);
+        }
+      return renumbering;
+    }
+
+
+
     // ----------------- actual DoFInfo functions -----------------------------
 
     DoFInfo::DoFInfo ()
@@ -146,9 +191,20 @@ namespace internal
       row_starts_plain_indices.clear();
       plain_dof_indices.clear();
       store_plain_indices = false;
+      row_starts_per_cell.clear();
+      dof_indices_per_cell.clear();
+      constraint_indicator_per_cell.clear();
+      store_indices_per_cell = false;
       cell_active_fe_index.clear();
       max_fe_index = 0;
       fe_index_conversion.clear();
+      cell_loop_chunks.clear();
+      cell_loop_pre_list_index.clear();
+      cell_loop_pre_list.clear();
+      cell_loop_post_list_index.clear();
+      cell_loop_post_list.clear();
+      index_storage_variants.clear();
+      dof_indices_contiguous.clear();
     }
 
 
@@ -308,6 +364,70 @@ no_constraint:
 
 
 
+    void
+    DoFInfo::append_dof_indices (const DoFInfo                     &chunk,
+                                 const unsigned int                 first_cell,
+                                 const std::vector<unsigned short> &constraint_renumbering)
+    {
+      Assert (vector_partitioner.get() != nullptr, ExcInternalError());
+      const unsigned int n_chunk_cells = chunk.row_starts.size()-1;
+      AssertIndexRange (first_cell+n_chunk_cells, row_starts.size());
+      AssertDimension (row_starts[first_cell][0], dof_indices.size());
+      AssertDimension (row_starts[first_cell][1], constraint_indicator.size());
+
+      // the ghosts of the chunk got temporary numbers starting at the end of
+      // the locally owned range, so shift them by the ghosts collected so far
+      const unsigned int n_owned = (vector_partitioner->local_range().second-
+                                    vector_partitioner->local_range().first);
+      const unsigned int ghost_shift = ghost_dofs.size();
+      ghost_dofs.insert (ghost_dofs.end(), chunk.ghost_dofs.begin(),
+                         chunk.ghost_dofs.end());
+
+      const unsigned int index_shift = dof_indices.size();
+      dof_indices.reserve (index_shift + chunk.dof_indices.size());
+      for (std::size_t i=0; i<chunk.dof_indices.size(); ++i)
+        dof_indices.push_back (chunk.dof_indices[i] >= n_owned ?
+                               chunk.dof_indices[i] + ghost_shift :
+                               chunk.dof_indices[i]);
+
+      const unsigned int indicator_shift = constraint_indicator.size();
+      constraint_indicator.reserve (indicator_shift + chunk.constraint_indicator.size());
+      for (std::size_t i=0; i<chunk.constraint_indicator.size(); ++i)
+        {
+          AssertIndexRange (chunk.constraint_indicator[i].second,
+                            constraint_renumbering.size());
+          constraint_indicator.emplace_back
+          (chunk.constraint_indicator[i].first,
+           constraint_renumbering[chunk.constraint_indicator[i].second]);
+        }
+
+      for (unsigned int cell=0; cell<n_chunk_cells; ++cell)
+        {
+          row_starts[first_cell+cell+1][0] = chunk.row_starts[cell+1][0] + index_shift;
+          row_starts[first_cell+cell+1][1] = chunk.row_starts[cell+1][1] + indicator_shift;
+          row_starts[first_cell+cell+1][2] = 0;
+        }
+
+      if (store_plain_indices == true && n_chunk_cells > 0)
+        {
+          AssertDimension (chunk.row_starts_plain_indices.size(),
+                           chunk.row_starts.size());
+          if (row_starts_plain_indices.size() != row_starts.size())
+            row_starts_plain_indices.resize (row_starts.size());
+          const unsigned int plain_shift = plain_dof_indices.size();
+          for (unsigned int cell=0; cell<n_chunk_cells; ++cell)
+            row_starts_plain_indices[first_cell+cell] =
+              chunk.row_starts_plain_indices[cell] + plain_shift;
+          plain_dof_indices.reserve (plain_shift + chunk.plain_dof_indices.size());
+          for (std::size_t i=0; i<chunk.plain_dof_indices.size(); ++i)
+            plain_dof_indices.push_back (chunk.plain_dof_indices[i] >= n_owned ?
+                                         chunk.plain_dof_indices[i] + ghost_shift :
+                                         chunk.plain_dof_indices[i]);
+        }
+    }
+
+
+
     void
     DoFInfo::assign_ghosts (const std::vector<unsigned int> &boundary_cells)
     {
@@ -590,122 +710,197 @@ no_constraint:
           std::swap (new_active_fe_index, cell_active_fe_index);
         }
 
-      std::vector<std::array<unsigned int, 3> > new_row_starts;
-      std::vector<unsigned int> new_dof_indices;
-      std::vector<std::pair<unsigned short,unsigned short> >
-      new_constraint_indicator;
-      std::vector<unsigned int> new_plain_indices, new_rowstart_plain;
-      unsigned int position_cell = 0;
-      new_row_starts.resize (size_info.n_macro_cells + 1);
-      new_dof_indices.reserve (dof_indices.size());
-      new_constraint_indicator.reserve (constraint_indicator.size());
-      if (store_plain_indices == true)
+      // for face integrals, also store the indices of the individual cells
+      // in the new cell order, without interleaving them. The padded lanes
+      // of the last macro cells get empty rows
+      if (store_indices_per_cell == true)
         {
-          new_rowstart_plain.resize (size_info.n_macro_cells + 1,
-                                     numbers::invalid_unsigned_int);
-          new_plain_indices.reserve (plain_dof_indices.size());
+          row_starts_per_cell.clear();
+          dof_indices_per_cell.clear();
+          constraint_indicator_per_cell.clear();
+          row_starts_per_cell.reserve(size_info.n_macro_cells*vectorization_length+1);
+          dof_indices_per_cell.reserve(dof_indices.size());
+          constraint_indicator_per_cell.reserve(constraint_indicator.size());
+          std::array<unsigned int,2> row_start;
+          unsigned int position_cell = 0;
+          for (unsigned int i=0; i<size_info.n_macro_cells; ++i)
+            {
+              const unsigned int n_comp = (irregular_cells[i]>0 ?
+                                           irregular_cells[i] : vectorization_length);
+              for (unsigned int j=0; j<vectorization_length; ++j)
+                {
+                  row_start[0] = dof_indices_per_cell.size();
+                  row_start[1] = constraint_indicator_per_cell.size();
+                  row_starts_per_cell.push_back(row_start);
+                  if (j < n_comp)
+                    {
+                      const unsigned int row = renumbering[position_cell+j];
+                      dof_indices_per_cell.insert(dof_indices_per_cell.end(),
+                                                  begin_indices(row),
+                                                  end_indices(row));
+                      constraint_indicator_per_cell.insert(constraint_indicator_per_cell.end(),
+                                                           begin_indicators(row),
+                                                           end_indicators(row));
+                    }
+                }
+              position_cell += n_comp;
+            }
+          row_start[0] = dof_indices_per_cell.size();
+          row_start[1] = constraint_indicator_per_cell.size();
+          row_starts_per_cell.push_back(row_start);
         }
 
+      // determine the position of each macro cell in the new data fields
+      // from the length of the rows of its cells. Then, the indices of
+      // different macro cells can be filled in independently of each other
+      std::vector<std::array<unsigned int, 3> > new_row_starts (size_info.n_macro_cells + 1);
+      std::vector<unsigned int> new_rowstart_plain;
+      if (store_plain_indices == true)
+        new_rowstart_plain.resize (size_info.n_macro_cells + 1,
+                                   numbers::invalid_unsigned_int);
+      std::vector<unsigned int> macro_cell_starts (size_info.n_macro_cells + 1);
+      std::size_t n_new_plain_indices = 0;
+      {
+        unsigned int position_cell = 0;
+        for (unsigned int i=0; i<size_info.n_macro_cells; ++i)
+          {
+            const unsigned int n_comp = (irregular_cells[i]>0 ?
+                                         irregular_cells[i] : vectorization_length);
+            unsigned int row_length = 0, row_length_indicator = 0;
+            for (unsigned int j=0; j<n_comp; ++j)
+              {
+                row_length += row_length_indices (renumbering[position_cell+j]);
+                row_length_indicator +=
+                  row_length_indicators (renumbering[position_cell+j]);
+              }
+            new_row_starts[i+1][0] = new_row_starts[i][0] + row_length;
+            new_row_starts[i+1][1] = new_row_starts[i][1] + row_length_indicator;
+            new_row_starts[i][2] = irregular_cells[i];
+
+            // the plain indices are only stored for macro cells with
+            // constraints
+            if (store_plain_indices == true && row_length_indicator > 0)
+              {
+                new_rowstart_plain[i] = n_new_plain_indices;
+                n_new_plain_indices += n_comp *
+                                       dofs_per_cell[cell_active_fe_index.size() == 0 ? 0 :
+                                                     cell_active_fe_index[i]];
+              }
+            macro_cell_starts[i] = position_cell;
+            position_cell += n_comp;
+          }
+        AssertDimension (position_cell+1, row_starts.size());
+        macro_cell_starts[size_info.n_macro_cells] = position_cell;
+        new_row_starts[size_info.n_macro_cells][2] = 0;
+      }
+
+      std::vector<unsigned int> new_dof_indices (new_row_starts.back()[0]);
+      std::vector<std::pair<unsigned short,unsigned short> >
+      new_constraint_indicator (new_row_starts.back()[1]);
+      std::vector<unsigned int> new_plain_indices (n_new_plain_indices);
+
       // copy the indices and the constraint indicators to the new data field:
       // Store the indices in a way so that adjacent data fields in local
       // vectors are adjacent, i.e., first dof index 0 for all vectors, then
       // dof index 1 for all vectors, and so on. This involves some extra
       // resorting.
-      std::vector<const unsigned int *> glob_indices (vectorization_length);
-      std::vector<const unsigned int *> plain_glob_indices (vectorization_length);
-      std::vector<const std::pair<unsigned short,unsigned short>*>
-      constr_ind(vectorization_length), constr_end(vectorization_length);
-      std::vector<unsigned int> index(vectorization_length);
-      for (unsigned int i=0; i<size_info.n_macro_cells; ++i)
-        {
-          const unsigned int dofs_mcell =
-            dofs_per_cell[cell_active_fe_index.size() == 0 ? 0 :
-                          cell_active_fe_index[i]] * vectorization_length;
-          new_row_starts[i][0] = new_dof_indices.size();
-          new_row_starts[i][1] = new_constraint_indicator.size();
-          new_row_starts[i][2] = irregular_cells[i];
-
-          const unsigned int n_comp = (irregular_cells[i]>0 ?
-                                       irregular_cells[i] : vectorization_length);
+      auto reorder_range = [&] (const unsigned int begin,
+                                const unsigned int end)
+      {
+        std::vector<const unsigned int *> glob_indices (vectorization_length);
+        std::vector<const unsigned int *> plain_glob_indices (vectorization_length);
+        std::vector<const std::pair<unsigned short,unsigned short>*>
+        constr_ind(vectorization_length), constr_end(vectorization_length);
+        std::vector<unsigned int> index(vectorization_length);
+        for (unsigned int i=begin; i<end; ++i)
+          {
+            const unsigned int dofs_mcell =
+              dofs_per_cell[cell_active_fe_index.size() == 0 ? 0 :
+                            cell_active_fe_index[i]] * vectorization_length;
+            const unsigned int position_cell = macro_cell_starts[i];
+            const unsigned int n_comp = (irregular_cells[i]>0 ?
+                                         irregular_cells[i] : vectorization_length);
+
+            for (unsigned int j=0; j<n_comp; ++j)
+              {
+                glob_indices[j] = begin_indices(renumbering[position_cell+j]);
+                constr_ind[j] = begin_indicators(renumbering[position_cell+j]);
+                constr_end[j] = end_indicators(renumbering[position_cell+j]);
+                index[j] = 0;
+              }
 
-          for (unsigned int j=0; j<n_comp; ++j)
-            {
-              glob_indices[j] = begin_indices(renumbering[position_cell+j]);
-              constr_ind[j] = begin_indicators(renumbering[position_cell+j]);
-              constr_end[j] = end_indicators(renumbering[position_cell+j]);
-              index[j] = 0;
-            }
+            unsigned int *new_indices = new_dof_indices.data() + new_row_starts[i][0];
+            std::pair<unsigned short,unsigned short> *new_indicators =
+              new_constraint_indicator.data() + new_row_starts[i][1];
+            unsigned int *new_plain = nullptr;
 
-          bool has_constraints = false;
-          if (store_plain_indices == true)
-            {
-              for (unsigned int j=0; j<n_comp; ++j)
-                if (begin_indicators(renumbering[position_cell+j]) <
-                    end_indicators(renumbering[position_cell+j]))
-                  {
+            const bool has_constraints = new_row_starts[i+1][1] > new_row_starts[i][1];
+            if (store_plain_indices == true && has_constraints == true)
+              {
+                for (unsigned int j=0; j<n_comp; ++j)
+                  if (begin_indicators(renumbering[position_cell+j]) <
+                      end_indicators(renumbering[position_cell+j]))
                     plain_glob_indices[j] =
                       begin_indices_plain (renumbering[position_cell+j]);
-                    has_constraints = true;
-                  }
-                else
-                  plain_glob_indices[j] =
-                    begin_indices (renumbering[position_cell+j]);
-              if (has_constraints == true)
-                new_rowstart_plain[i] = new_plain_indices.size();
-            }
+                  else
+                    plain_glob_indices[j] =
+                      begin_indices (renumbering[position_cell+j]);
+                new_plain = new_plain_indices.data() + new_rowstart_plain[i];
+              }
 
-          unsigned int m_ind_local = 0, m_index = 0;
-          while (m_ind_local < dofs_mcell)
-            for (unsigned int j=0; j<vectorization_length; ++j)
-              {
-                // last cell: nothing to do
-                if (j >= n_comp)
-                  {
-                    ++m_ind_local;
-                    continue;
-                  }
+            unsigned int m_ind_local = 0, m_index = 0;
+            while (m_ind_local < dofs_mcell)
+              for (unsigned int j=0; j<vectorization_length; ++j)
+                {
+                  // last cell: nothing to do
+                  if (j >= n_comp)
+                    {
+                      ++m_ind_local;
+                      continue;
+                    }
 
-                // otherwise, check if we are a constrained dof. The dof is
-                // not constrained if we are at the end of the row for the
-                // constraints (indi[j] == n_indi[j]) or if the local index[j]
-                // is smaller than the next position for a constraint. Then,
-                // just copy it. otherwise, copy all the entries that come
-                // with this dof
-                if (constr_ind[j] == constr_end[j] ||
-                    index[j] < constr_ind[j]->first)
-                  {
-                    new_dof_indices.push_back (*glob_indices[j]);
-                    ++m_index;
-                    ++index[j];
-                    ++glob_indices[j];
-                  }
-                else
-                  {
-                    const unsigned short constraint_loc = constr_ind[j]->second;
-                    new_constraint_indicator.emplace_back (m_index, constraint_loc);
-                    for (unsigned int k=constraint_pool_row_index[constraint_loc];
-                         k<constraint_pool_row_index[constraint_loc+1];
-                         ++k, ++glob_indices[j])
-                      new_dof_indices.push_back (*glob_indices[j]);
-                    ++constr_ind[j];
-                    m_index = 0;
-                    index[j] = 0;
-                  }
-                if (store_plain_indices==true && has_constraints==true)
-                  new_plain_indices.push_back (*plain_glob_indices[j]++);
-                ++m_ind_local;
-              }
+                  // otherwise, check if we are a constrained dof. The dof is
+                  // not constrained if we are at the end of the row for the
+                  // constraints (indi[j] == n_indi[j]) or if the local
+                  // index[j] is smaller than the next position for a
+                  // constraint. Then, just copy it. otherwise, copy all the
+                  // entries that come with this dof
+                  if (constr_ind[j] == constr_end[j] ||
+                      index[j] < constr_ind[j]->first)
+                    {
+                      *new_indices++ = *glob_indices[j];
+                      ++m_index;
+                      ++index[j];
+                      ++glob_indices[j];
+                    }
+                  else
+                    {
+                      const unsigned short constraint_loc = constr_ind[j]->second;
+                      *new_indicators++ = std::make_pair(static_cast<unsigned short>(m_index),
+                                                         constraint_loc);
+                      for (unsigned int k=constraint_pool_row_index[constraint_loc];
+                           k<constraint_pool_row_index[constraint_loc+1];
+                           ++k, ++glob_indices[j])
+                        *new_indices++ = *glob_indices[j];
+                      ++constr_ind[j];
+                      m_index = 0;
+                      index[j] = 0;
+                    }
+                  if (new_plain != nullptr)
+                    *new_plain++ = *plain_glob_indices[j]++;
+                  ++m_ind_local;
+                }
 
-          for (unsigned int j=0; j<n_comp; ++j)
-            Assert (glob_indices[j]==end_indices(renumbering[position_cell+j]),
+            for (unsigned int j=0; j<n_comp; ++j)
+              Assert (glob_indices[j]==end_indices(renumbering[position_cell+j]),
+                      ExcInternalError());
+            Assert (new_indices == new_dof_indices.data() + new_row_starts[i+1][0],
                     ExcInternalError());
-          position_cell += n_comp;
-        }
-      AssertDimension (position_cell+1, row_starts.size());
-
-      new_row_starts[size_info.n_macro_cells][0] = new_dof_indices.size();
-      new_row_starts[size_info.n_macro_cells][1] = new_constraint_indicator.size();
-      new_row_starts[size_info.n_macro_cells][2] = 0;
+            Assert (new_indicators == new_constraint_indicator.data() +
+                    new_row_starts[i+1][1], ExcInternalError());
+          }
+      };
+      parallel::apply_to_subranges (0U, size_info.n_macro_cells, reorder_range, 32);
 
       AssertDimension(dof_indices.size(), new_dof_indices.size());
       AssertDimension(constraint_indicator.size(),
@@ -767,6 +962,171 @@ no_constraint:
 
 
 
+    namespace
+    {
+      // convert the slot index assigned to each locally owned degree of
+      // freedom into lists of contiguous index ranges per slot in compressed
+      // row storage
+      void
+      fill_range_lists (const std::vector<unsigned int>                    &slot,
+                        const unsigned int                                  n_slots,
+                        std::vector<unsigned int>                          &row_index,
+                        std::vector<std::pair<unsigned int,unsigned int> > &ranges)
+      {
+        std::vector<std::vector<std::pair<unsigned int,unsigned int> > >
+        ranges_per_slot(n_slots);
+        for (unsigned int i=0; i<slot.size(); )
+          {
+            const unsigned int begin = i;
+            for (++i; i<slot.size() && slot[i] == slot[begin]; ++i)
+              ;
+            ranges_per_slot[slot[begin]].push_back(std::make_pair(begin, i));
+          }
+
+        row_index.resize(n_slots+1);
+        row_index[0] = 0;
+        ranges.clear();
+        for (unsigned int s=0; s<n_slots; ++s)
+          {
+            ranges.insert(ranges.end(), ranges_per_slot[s].begin(),
+                          ranges_per_slot[s].end());
+            row_index[s+1] = ranges.size();
+          }
+      }
+    }
+
+
+
+    void
+    DoFInfo::compute_cell_loop_pre_post_lists (const SizeInfo     &size_info,
+                                               const unsigned int  vectorization_length)
+    {
+      // choose the chunk size such that the vector entries of a chunk fit
+      // into the caches for the typical number of vectors involved in fused
+      // operations
+      const unsigned int entries_per_macro_cell =
+        std::max(1U, (dofs_per_cell.empty() ? 1U : dofs_per_cell[0]) *
+                 vectorization_length);
+      const unsigned int chunk_size =
+        std::max(1U, 8192U / entries_per_macro_cell);
+
+      cell_loop_chunks.clear();
+      cell_loop_chunks.push_back(0);
+      const unsigned int phase_ends [3] = {size_info.boundary_cells_start,
+                                           size_info.boundary_cells_end,
+                                           size_info.n_macro_cells
+                                          };
+      for (unsigned int phase=0; phase<3; ++phase)
+        for (unsigned int cell=cell_loop_chunks.back(); cell<phase_ends[phase];
+             cell += chunk_size)
+          cell_loop_chunks.push_back(std::min(cell+chunk_size,
+                                              phase_ends[phase]));
+      const unsigned int n_chunks = cell_loop_chunks.size()-1;
+
+      // slot of the pre operation: 0 for before the loop, c+1 for before
+      // chunk c; slot of the post operation: c for after chunk c, n_chunks
+      // for after the loop
+      const unsigned int n_owned = vector_partitioner->local_size();
+      std::vector<unsigned int> pre_slot(n_owned, 0), post_slot(n_owned, n_chunks);
+      std::vector<bool> touched(n_owned, false);
+      for (unsigned int chunk=0; chunk<n_chunks; ++chunk)
+        for (unsigned int cell=cell_loop_chunks[chunk];
+             cell<cell_loop_chunks[chunk+1]; ++cell)
+          for (const unsigned int *it=begin_indices(cell); it!=end_indices(cell); ++it)
+            if (*it < n_owned)
+              {
+                if (touched[*it] == false)
+                  {
+                    pre_slot[*it] = chunk+1;
+                    touched[*it] = true;
+                  }
+                post_slot[*it] = chunk;
+              }
+
+      // entries that are ghosts on other processors are read by remote cells
+      // and receive contributions during compress(), so they must be handled
+      // before the ghost exchange starts and after compress() has finished
+      for (unsigned int i=0; i<vector_partitioner->import_indices().size(); ++i)
+        for (unsigned int j=vector_partitioner->import_indices()[i].first;
+             j<vector_partitioner->import_indices()[i].second; ++j)
+          {
+            pre_slot[j] = 0;
+            post_slot[j] = n_chunks;
+          }
+
+      fill_range_lists(pre_slot, n_chunks+1, cell_loop_pre_list_index,
+                       cell_loop_pre_list);
+      fill_range_lists(post_slot, n_chunks+1, cell_loop_post_list_index,
+                       cell_loop_post_list);
+    }
+
+
+
+    void
+    DoFInfo::compute_index_storage_variants (const SizeInfo     &size_info,
+                                             const unsigned int  vectorization_length)
+    {
+      index_storage_variants.clear();
+      index_storage_variants.resize(size_info.n_macro_cells,
+                                    IndexStorageVariants::full);
+      dof_indices_contiguous.clear();
+      dof_indices_contiguous.resize(size_info.n_macro_cells*vectorization_length,
+                                    numbers::invalid_unsigned_int);
+
+      std::vector<unsigned int> sorted_starts(vectorization_length);
+      for (unsigned int cell=0; cell<size_info.n_macro_cells; ++cell)
+        {
+          // only cells without constraints and with all lanes filled use the
+          // compressed access
+          if (row_starts[cell][2] > 0 ||
+              row_starts[cell][1] != row_starts[cell+1][1])
+            continue;
+
+          const unsigned int *indices = begin_indices(cell);
+          const unsigned int n_entries = row_length_indices(cell);
+          if (n_entries == 0 || n_entries % vectorization_length != 0)
+            continue;
+          const unsigned int n_dofs = n_entries / vectorization_length;
+
+          bool is_interleaved = true;
+          for (unsigned int i=0; i<n_entries && is_interleaved; ++i)
+            if (indices[i] != indices[0]+i)
+              is_interleaved = false;
+
+          bool is_contiguous = !is_interleaved;
+          for (unsigned int i=1; i<n_dofs && is_contiguous; ++i)
+            for (unsigned int v=0; v<vectorization_length; ++v)
+              if (indices[i*vectorization_length+v] != indices[v]+i)
+                {
+                  is_contiguous = false;
+                  break;
+                }
+
+          // the vectorized stores of the contiguous case require that the
+          // ranges of the lanes do not overlap
+          if (is_contiguous)
+            {
+              std::copy(indices, indices+vectorization_length,
+                        sorted_starts.begin());
+              std::sort(sorted_starts.begin(), sorted_starts.end());
+              for (unsigned int v=1; v<vectorization_length; ++v)
+                if (sorted_starts[v] < sorted_starts[v-1]+n_dofs)
+                  is_contiguous = false;
+            }
+
+          if (is_interleaved || is_contiguous)
+            {
+              index_storage_variants[cell] = is_interleaved ?
+                                             IndexStorageVariants::interleaved :
+                                             IndexStorageVariants::contiguous;
+              std::copy(indices, indices+vectorization_length,
+                        dof_indices_contiguous.begin()+cell*vectorization_length);
+            }
+        }
+    }
+
+
+
     void DoFInfo::guess_block_size (const SizeInfo &size_info,
                                     TaskInfo       &task_info)
     {
@@ -1117,6 +1477,48 @@ no_constraint:
                                     (task_info.odds+task_info.evens+1)%2;
       task_info.n_workers = task_info.partition_color_blocks_data.size()-1-
                             task_info.n_blocked_workers;
+
+      // for the scheduling by a dependency graph, collect for each block the
+      // blocks that come later in the partition-color order and share
+      // degrees of freedom with it. These must not start before the block is
+      // finished, whereas all other blocks might run concurrently
+      if (task_info.use_dependency_graph == true)
+        {
+          std::vector<unsigned int> new_block_index(task_info.n_blocks);
+          for (unsigned int block=0; block<task_info.n_blocks; ++block)
+            new_block_index[partition_color_list[block]] = block;
+
+          task_info.block_successors_row_index.resize(task_info.n_blocks+1);
+          task_info.block_successors_row_index[0] = 0;
+          task_info.block_successors.clear();
+          task_info.block_n_predecessors.clear();
+          task_info.block_n_predecessors.resize(task_info.n_blocks, 0);
+          for (unsigned int block=0; block<task_info.n_blocks; ++block)
+            {
+              const unsigned int old_block = partition_color_list[block];
+              DynamicSparsityPattern::iterator
+              neighbor = connectivity.begin(old_block),
+              end      = connectivity.end(old_block);
+              for (; neighbor!=end ; ++neighbor)
+                {
+                  const unsigned int neighbor_block =
+                    new_block_index[neighbor->column()];
+                  if (neighbor_block > block)
+                    {
+                      task_info.block_successors.push_back(neighbor_block);
+                      ++task_info.block_n_predecessors[neighbor_block];
+                    }
+                }
+              task_info.block_successors_row_index[block+1] =
+                task_info.block_successors.size();
+            }
+
+          // the blocks of the first partition contain the cells with ghost
+          // degrees of freedom
+          task_info.n_boundary_blocks =
+            task_info.partition_color_blocks_data
+            [task_info.partition_color_blocks_row_index[1]];
+        }
     }
 
 
@@ -1877,6 +2279,12 @@ not_connect:
         if (renumbering[i] == numbers::invalid_dof_index)
           renumbering[i] = counter++;
 
+      // the indices of the individual cells contain the same entries as
+      // dof_indices, so they have all been assigned a new number above
+      for (std::size_t i=0; i<dof_indices_per_cell.size(); ++i)
+        if (dof_indices_per_cell[i] < local_size)
+          dof_indices_per_cell[i] = renumbering[dof_indices_per_cell[i]];
+
       // adjust the constrained DoFs
       std::vector<unsigned int> new_constrained_dofs (constrained_dofs.size());
       for (std::size_t i=0; i<constrained_dofs.size(); ++i)
@@ -1908,12 +2316,51 @@ not_connect:
       memory += MemoryConsumption::memory_consumption (row_starts_plain_indices);
       memory += MemoryConsumption::memory_consumption (plain_dof_indices);
       memory += MemoryConsumption::memory_consumption (constraint_indicator);
+      memory += (row_starts_per_cell.capacity()*sizeof(std::array<unsigned int,2>));
+      memory += MemoryConsumption::memory_consumption (dof_indices_per_cell);
+      memory += MemoryConsumption::memory_consumption (constraint_indicator_per_cell);
       memory += MemoryConsumption::memory_consumption (*vector_partitioner);
+      memory += MemoryConsumption::memory_consumption (cell_loop_chunks);
+      memory += MemoryConsumption::memory_consumption (cell_loop_pre_list_index);
+      memory += cell_loop_pre_list.capacity()*sizeof(std::pair<unsigned int,unsigned int>);
+      memory += MemoryConsumption::memory_consumption (cell_loop_post_list_index);
+      memory += cell_loop_post_list.capacity()*sizeof(std::pair<unsigned int,unsigned int>);
+      memory += index_storage_variants.capacity()*sizeof(IndexStorageVariants);
+      memory += MemoryConsumption::memory_consumption (dof_indices_contiguous);
       return memory;
     }
 
 
 
+    MemoryReport
+    DoFInfo::memory_report (const std::string &name) const
+    {
+      MemoryReport report (name, sizeof(*this));
+      report.add ("dof indices",
+                  row_starts.capacity()*sizeof(std::array<unsigned int,3>) +
+                  MemoryConsumption::memory_consumption (dof_indices) +
+                  index_storage_variants.capacity()*sizeof(IndexStorageVariants) +
+                  MemoryConsumption::memory_consumption (dof_indices_contiguous) +
+                  row_starts_per_cell.capacity()*sizeof(std::array<unsigned int,2>) +
+                  MemoryConsumption::memory_consumption (dof_indices_per_cell));
+      report.add ("constraint indicators",
+                  MemoryConsumption::memory_consumption (constraint_indicator) +
+                  MemoryConsumption::memory_consumption (constraint_indicator_per_cell));
+      report.add ("plain indices",
+                  MemoryConsumption::memory_consumption (row_starts_plain_indices) +
+                  MemoryConsumption::memory_consumption (plain_dof_indices));
+      report.add (vector_partitioner->memory_report());
+      report.add ("cell loop lists",
+                  MemoryConsumption::memory_consumption (cell_loop_chunks) +
+                  MemoryConsumption::memory_consumption (cell_loop_pre_list_index) +
+                  cell_loop_pre_list.capacity()*sizeof(std::pair<unsigned int,unsigned int>) +
+                  MemoryConsumption::memory_consumption (cell_loop_post_list_index) +
+                  cell_loop_post_list.capacity()*sizeof(std::pair<unsigned int,unsigned int>));
+      return report;
+    }
+
+
+
     template <typename StreamType>
     void
     DoFInfo::print_memory_consumption (StreamType     &out,
@@ -20,6 +20,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/vectorization.h>
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/geometry_info.h>
 #include <deal.II/matrix_free/tensor_product_kernels.h>
 #include <deal.II/matrix_free/shape_info.h>
 
@@ -528,15 +529,19 @@ namespace internal
    * This struct performs the evaluation of function values, gradients and
    * Hessians for tensor-product finite elements. This a specialization for
    * symmetric basis functions about the mid point 0.5 of the unit interval
-   * with the same number of quadrature points as degrees of freedom. In that
-   * case, we can first transform the basis to one that has the nodal points
-   * in the quadrature points (i.e., the collocation space) and then perform
-   * the evaluation of the first and second derivatives in this transformed
-   * space, using the identity operation for the shape values.
+   * with at least as many quadrature points as degrees of freedom in 1D. In
+   * that case, we can first transform the basis to one that has the nodal
+   * points in the quadrature points (i.e., the collocation space) and then
+   * perform the evaluation of the first and second derivatives in this
+   * transformed space, using the identity operation for the shape values. If
+   * there are more quadrature points than degrees of freedom, the
+   * transformation interpolates the polynomial into the collocation space of
+   * degree n_q_points_1d-1, which is exact. Both the transformation and the
+   * derivatives in the collocation space use the even-odd decomposition.
    *
    * @author Katharina Kormann, Martin Kronbichler, 2017
    */
-  template <int dim, int fe_degree, int n_components, typename Number>
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components, typename Number>
   struct FEEvaluationImplTransformToCollocation
   {
     static
@@ -560,10 +565,10 @@ namespace internal
                     const bool               integrate_gradients);
   };
 
-  template <int dim, int fe_degree, int n_components, typename Number>
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components, typename Number>
   inline
   void
-  FEEvaluationImplTransformToCollocation<dim, fe_degree, n_components, Number>
+  FEEvaluationImplTransformToCollocation<dim, fe_degree, n_q_points_1d, n_components, Number>
   ::evaluate (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
               VectorizedArray<Number> *values_dofs[],
               VectorizedArray<Number> *values_quad[],
@@ -574,18 +579,24 @@ namespace internal
               const bool               evaluate_gradients,
               const bool               evaluate_hessians)
   {
-    typedef EvaluatorTensorProduct<evaluate_evenodd, dim, fe_degree, fe_degree+1,
-            VectorizedArray<Number> > Eval;
-    Eval eval_val (shape_info.shape_values_eo,
-                   AlignedVector<VectorizedArray<Number> >(),
-                   AlignedVector<VectorizedArray<Number> >(),
-                   shape_info.fe_degree,
-                   shape_info.n_q_points_1d);
-    Eval eval(AlignedVector<VectorizedArray<Number> >(),
-              shape_info.shape_gradients_collocation_eo,
-              shape_info.shape_hessians_collocation_eo,
-              shape_info.fe_degree,
-              shape_info.n_q_points_1d);
+    static_assert (n_q_points_1d >= fe_degree+1,
+                   "The transformation to the collocation space needs at least "
+                   "as many quadrature points as degrees of freedom in 1D");
+    AssertDimension(shape_info.n_q_points_1d, n_q_points_1d);
+    EvaluatorTensorProduct<evaluate_evenodd, dim, fe_degree, n_q_points_1d,
+                           VectorizedArray<Number> >
+                           eval_val (shape_info.shape_values_eo,
+                                     AlignedVector<VectorizedArray<Number> >(),
+                                     AlignedVector<VectorizedArray<Number> >(),
+                                     shape_info.fe_degree,
+                                     shape_info.n_q_points_1d);
+    EvaluatorTensorProduct<evaluate_evenodd, dim, n_q_points_1d-1, n_q_points_1d,
+                           VectorizedArray<Number> >
+                           eval (AlignedVector<VectorizedArray<Number> >(),
+                                 shape_info.shape_gradients_collocation_eo,
+                                 shape_info.shape_hessians_collocation_eo,
+                                 shape_info.n_q_points_1d-1,
+                                 shape_info.n_q_points_1d);
 
     // These avoid compiler warnings; they are only used in sensible context but
     // compilers typically cannot detect when we access something like
@@ -644,10 +655,10 @@ namespace internal
       }
   }
 
-  template <int dim, int fe_degree, int n_components, typename Number>
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components, typename Number>
   inline
   void
-  FEEvaluationImplTransformToCollocation<dim, fe_degree, n_components, Number>
+  FEEvaluationImplTransformToCollocation<dim, fe_degree, n_q_points_1d, n_components, Number>
   ::integrate (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
                VectorizedArray<Number> *values_dofs[],
                VectorizedArray<Number> *values_quad[],
@@ -656,18 +667,24 @@ namespace internal
                const bool               integrate_values,
                const bool               integrate_gradients)
   {
-    typedef EvaluatorTensorProduct<evaluate_evenodd, dim, fe_degree, fe_degree+1,
-            VectorizedArray<Number> > Eval;
-    Eval eval_val (shape_info.shape_values_eo,
-                   AlignedVector<VectorizedArray<Number> >(),
-                   AlignedVector<VectorizedArray<Number> >(),
-                   shape_info.fe_degree,
-                   shape_info.n_q_points_1d);
-    Eval eval(AlignedVector<VectorizedArray<Number> >(),
-              shape_info.shape_gradients_collocation_eo,
-              shape_info.shape_hessians_collocation_eo,
-              shape_info.fe_degree,
-              shape_info.n_q_points_1d);
+    static_assert (n_q_points_1d >= fe_degree+1,
+                   "The transformation to the collocation space needs at least "
+                   "as many quadrature points as degrees of freedom in 1D");
+    AssertDimension(shape_info.n_q_points_1d, n_q_points_1d);
+    EvaluatorTensorProduct<evaluate_evenodd, dim, fe_degree, n_q_points_1d,
+                           VectorizedArray<Number> >
+                           eval_val (shape_info.shape_values_eo,
+                                     AlignedVector<VectorizedArray<Number> >(),
+                                     AlignedVector<VectorizedArray<Number> >(),
+                                     shape_info.fe_degree,
+                                     shape_info.n_q_points_1d);
+    EvaluatorTensorProduct<evaluate_evenodd, dim, n_q_points_1d-1, n_q_points_1d,
+                           VectorizedArray<Number> >
+                           eval (AlignedVector<VectorizedArray<Number> >(),
+                                 shape_info.shape_gradients_collocation_eo,
+                                 shape_info.shape_hessians_collocation_eo,
+                                 shape_info.n_q_points_1d-1,
+                                 shape_info.n_q_points_1d);
 
     // These avoid compiler warnings; they are only used in sensible context but
     // compilers typically cannot detect when we access something like
@@ -856,6 +873,552 @@ namespace internal
       }
   }
 
+
+
+  /**
+   * This struct performs the evaluation of function values and gradients
+   * for the Raviart-Thomas element FE_RaviartThomasNodal, whose vector
+   * components are anisotropic tensor products of 1D polynomials: In the
+   * direction of the component, the polynomials of
+   * ShapeInfo::shape_values_normal with one degree more than the
+   * polynomials of ShapeInfo::shape_values in the other directions are
+   * used. Since the 1D sizes differ between the directions and the
+   * components, the sizes are not known at compile time and the sum
+   * factorization uses loops with variable bounds.
+   *
+   * The values and gradients are computed on the unit cell. The
+   * contravariant Piola transformation is applied by
+   * FEEvaluationAccess::get_value_contravariant_piola() and related
+   * functions at the quadrature points.
+   */
+  template <int dim, int n_components, typename Number>
+  struct FEEvaluationImplRaviartThomas
+  {
+    static
+    void evaluate (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
+                   VectorizedArray<Number> *values_dofs[],
+                   VectorizedArray<Number> *values_quad[],
+                   VectorizedArray<Number> *gradients_quad[][dim],
+                   VectorizedArray<Number> *scratch_data,
+                   const bool               evaluate_values,
+                   const bool               evaluate_gradients,
+                   const bool               evaluate_hessians);
+
+    static
+    void integrate (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
+                    VectorizedArray<Number> *values_dofs[],
+                    VectorizedArray<Number> *values_quad[],
+                    VectorizedArray<Number> *gradients_quad[][dim],
+                    VectorizedArray<Number> *scratch_data,
+                    const bool               integrate_values,
+                    const bool               integrate_gradients);
+
+  private:
+    /**
+     * Apply the 1D shape functions of the vector component @p component in
+     * all directions, using the derivatives in direction @p
+     * derivative_direction (no derivatives if it is equal to dim). Goes from
+     * the degrees of freedom to the quadrature points if @p dof_to_quad is
+     * true and in the opposite direction otherwise, in which case the
+     * result is added to @p out if @p add is true.
+     */
+    static
+    void apply (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
+                const unsigned int             component,
+                const unsigned int             derivative_direction,
+                const bool                     dof_to_quad,
+                const bool                     add,
+                const VectorizedArray<Number> *in,
+                VectorizedArray<Number>       *out,
+                VectorizedArray<Number>       *scratch_data);
+  };
+
+
+
+  template <int dim, int n_components, typename Number>
+  inline
+  void
+  FEEvaluationImplRaviartThomas<dim,n_components,Number>
+  ::apply (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
+           const unsigned int             component,
+           const unsigned int             derivative_direction,
+           const bool                     dof_to_quad,
+           const bool                     add,
+           const VectorizedArray<Number> *in,
+           VectorizedArray<Number>       *out,
+           VectorizedArray<Number>       *scratch_data)
+  {
+    const unsigned int n_q_points_1d = shape_info.n_q_points_1d;
+
+    // the sizes of the tensor in the current stage of the sum factorization
+    unsigned int sizes[dim];
+    unsigned int max_size = 1;
+    for (unsigned int d=0; d<dim; ++d)
+      {
+        const unsigned int n_dofs_1d = shape_info.fe_degree + (d==component ? 2 : 1);
+        sizes[d] = dof_to_quad ? n_dofs_1d : n_q_points_1d;
+        max_size *= std::max(n_dofs_1d, n_q_points_1d);
+      }
+
+    const VectorizedArray<Number> *src = in;
+    VectorizedArray<Number> *tmp[2] = {scratch_data, scratch_data + max_size};
+    for (unsigned int d=0; d<dim; ++d)
+      {
+        const AlignedVector<VectorizedArray<Number> > &shape =
+          d == component ?
+          (d == derivative_direction ? shape_info.shape_gradients_normal :
+           shape_info.shape_values_normal) :
+          (d == derivative_direction ? shape_info.shape_gradients :
+           shape_info.shape_values);
+        const unsigned int n_dofs_1d = shape_info.fe_degree + (d==component ? 2 : 1);
+        const unsigned int n_in = dof_to_quad ? n_dofs_1d : n_q_points_1d;
+        const unsigned int n_out = dof_to_quad ? n_q_points_1d : n_dofs_1d;
+        unsigned int n_before = 1, n_after = 1;
+        for (unsigned int e=0; e<d; ++e)
+          n_before *= sizes[e];
+        for (unsigned int e=d+1; e<dim; ++e)
+          n_after *= sizes[e];
+        VectorizedArray<Number> *dst = (d == dim-1) ? out : tmp[d%2];
+        const bool add_here = (d == dim-1) && add;
+
+        // the shape data is stored with the quadrature points running
+        // fastest, i.e., shape[i*n_q_points_1d+q] for dof i and point q
+        for (unsigned int b=0; b<n_after; ++b)
+          for (unsigned int o=0; o<n_out; ++o)
+            for (unsigned int a=0; a<n_before; ++a)
+              {
+                VectorizedArray<Number> sum = VectorizedArray<Number>();
+                for (unsigned int i=0; i<n_in; ++i)
+                  sum += (dof_to_quad ? shape[i*n_q_points_1d+o] :
+                          shape[o*n_q_points_1d+i]) *
+                         src[a + n_before*(i + n_in*b)];
+                if (add_here)
+                  dst[a + n_before*(o + n_out*b)] += sum;
+                else
+                  dst[a + n_before*(o + n_out*b)] = sum;
+              }
+        sizes[d] = n_out;
+        src = dst;
+      }
+  }
+
+
+
+  template <int dim, int n_components, typename Number>
+  inline
+  void
+  FEEvaluationImplRaviartThomas<dim,n_components,Number>
+  ::evaluate (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
+              VectorizedArray<Number> *values_dofs[],
+              VectorizedArray<Number> *values_quad[],
+              VectorizedArray<Number> *gradients_quad[][dim],
+              VectorizedArray<Number> *scratch_data,
+              const bool               evaluate_values,
+              const bool               evaluate_gradients,
+              const bool               evaluate_hessians)
+  {
+    AssertThrow (n_components == dim,
+                 ExcMessage("The Raviart-Thomas element must be evaluated with "
+                            "dim components in FEEvaluation."));
+    AssertThrow (evaluate_hessians == false, ExcNotImplemented());
+    (void)evaluate_hessians;
+
+    for (unsigned int c=0; c<n_components; ++c)
+      {
+        if (evaluate_values)
+          apply (shape_info, c, dim, true, false, values_dofs[c],
+                 values_quad[c], scratch_data);
+        if (evaluate_gradients)
+          for (unsigned int d=0; d<dim; ++d)
+            apply (shape_info, c, d, true, false, values_dofs[c],
+                   gradients_quad[c][d], scratch_data);
+      }
+  }
+
+
+
+  template <int dim, int n_components, typename Number>
+  inline
+  void
+  FEEvaluationImplRaviartThomas<dim,n_components,Number>
+  ::integrate (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
+               VectorizedArray<Number> *values_dofs[],
+               VectorizedArray<Number> *values_quad[],
+               VectorizedArray<Number> *gradients_quad[][dim],
+               VectorizedArray<Number> *scratch_data,
+               const bool               integrate_values,
+               const bool               integrate_gradients)
+  {
+    AssertThrow (n_components == dim,
+                 ExcMessage("The Raviart-Thomas element must be evaluated with "
+                            "dim components in FEEvaluation."));
+
+    for (unsigned int c=0; c<n_components; ++c)
+      {
+        if (integrate_values)
+          apply (shape_info, c, dim, false, false, values_quad[c],
+                 values_dofs[c], scratch_data);
+        if (integrate_gradients)
+          for (unsigned int d=0; d<dim; ++d)
+            apply (shape_info, c, d, false, integrate_values || d>0,
+                   gradients_quad[c][d], values_dofs[c], scratch_data);
+        if (integrate_values == false && integrate_gradients == false)
+          for (unsigned int i=0; i<shape_info.dofs_per_cell; ++i)
+            values_dofs[c][i] = VectorizedArray<Number>();
+      }
+  }
+
+
+
+  /**
+   * This struct performs the evaluation of function values and gradients on
+   * the faces of tensor-product finite elements. The evaluation is split
+   * into two steps: First, the cell degrees of freedom are interpolated to
+   * the face, giving the values and the normal derivatives at the nodes of
+   * the face in the face-local lexicographic numbering. Second, a
+   * tensor-product evaluation in dim-1 dimensions computes the values and
+   * the derivatives at the face quadrature points. For subfaces of coarser
+   * cells (hanging nodes), the second step uses the shape functions
+   * evaluated within the two halves of the 1D unit interval.
+   *
+   * The integration performs the transpose operations in reverse order.
+   *
+   * The face-local coordinate system follows the one of GeometryInfo: the
+   * k-th coordinate on a face in direction @p face_direction (given by
+   * <code>face_no/2</code>) corresponds to the coordinate
+   * <code>(face_direction+1+k)%dim</code> on the cell.
+   */
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number>
+  struct FEFaceEvaluationImpl
+  {
+    static const unsigned int dofs_per_face =
+      Utilities::fixed_int_power<fe_degree+1,(dim>1?dim-1:0)>::value;
+    static const unsigned int n_q_points =
+      Utilities::fixed_int_power<n_q_points_1d,(dim>1?dim-1:0)>::value;
+
+    static
+    void evaluate (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
+                   VectorizedArray<Number> *values_dofs[],
+                   VectorizedArray<Number> *values_quad[],
+                   VectorizedArray<Number> *gradients_quad[][dim],
+                   VectorizedArray<Number> *scratch_data,
+                   const bool               evaluate_values,
+                   const bool               evaluate_gradients,
+                   const unsigned int       face_no,
+                   const unsigned int       subface_index);
+
+    static
+    void integrate (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
+                    VectorizedArray<Number> *values_dofs[],
+                    VectorizedArray<Number> *values_quad[],
+                    VectorizedArray<Number> *gradients_quad[][dim],
+                    VectorizedArray<Number> *scratch_data,
+                    const bool               integrate_values,
+                    const bool               integrate_gradients,
+                    const unsigned int       face_no,
+                    const unsigned int       subface_index);
+
+  private:
+    /**
+     * Select the 1D shape values and gradients used along the two face-local
+     * directions, taking into account a possible subface.
+     */
+    static
+    void select_shape_data (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
+                            const unsigned int              subface_index,
+                            const VectorizedArray<Number> *shape_values[2],
+                            const VectorizedArray<Number> *shape_gradients[2]);
+  };
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number>
+  inline
+  void
+  FEFaceEvaluationImpl<dim,fe_degree,n_q_points_1d,n_components,Number>
+  ::select_shape_data (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
+                       const unsigned int              subface_index,
+                       const VectorizedArray<Number> *shape_values[2],
+                       const VectorizedArray<Number> *shape_gradients[2])
+  {
+    // subfaces of isotropically refined faces are numbered
+    // lexicographically in the face-local coordinates
+    if (subface_index >= GeometryInfo<dim>::max_children_per_cell)
+      for (unsigned int d=0; d<2; ++d)
+        {
+          shape_values[d] = shape_info.shape_values.begin();
+          shape_gradients[d] = shape_info.shape_gradients.begin();
+        }
+    else
+      {
+        shape_values[0] = shape_info.values_within_subface[subface_index%2].begin();
+        shape_gradients[0] = shape_info.gradients_within_subface[subface_index%2].begin();
+        shape_values[1] = shape_info.values_within_subface[(subface_index/2)%2].begin();
+        shape_gradients[1] = shape_info.gradients_within_subface[(subface_index/2)%2].begin();
+      }
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number>
+  inline
+  void
+  FEFaceEvaluationImpl<dim,fe_degree,n_q_points_1d,n_components,Number>
+  ::evaluate (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
+              VectorizedArray<Number> *values_dofs[],
+              VectorizedArray<Number> *values_quad[],
+              VectorizedArray<Number> *gradients_quad[][dim],
+              VectorizedArray<Number> *scratch_data,
+              const bool               evaluate_values,
+              const bool               evaluate_gradients,
+              const unsigned int       face_no,
+              const unsigned int       subface_index)
+  {
+    if (evaluate_values == false && evaluate_gradients == false)
+      return;
+
+    Assert (shape_info.element_type <= MatrixFreeFunctions::tensor_general,
+            ExcNotImplemented());
+    AssertIndexRange (face_no, GeometryInfo<dim>::faces_per_cell);
+
+    typedef EvaluatorTensorProduct<evaluate_general, (dim>1?dim-1:1), fe_degree,
+            n_q_points_1d, VectorizedArray<Number> > Eval;
+
+    const unsigned int face_direction = face_no / 2;
+    const VectorizedArray<Number> *shape_face =
+      shape_info.shape_data_on_face[face_no%2].begin();
+
+    // the first part of the scratch data holds the values and normal
+    // derivatives on the nodes of the face, the second part the temporary
+    // data of the tensor product evaluation within the face
+    VectorizedArray<Number> *temp = scratch_data + 2*n_components*dofs_per_face;
+
+    // step 1: interpolate from the cell to the face
+    for (unsigned int c=0; c<n_components; ++c)
+      {
+        VectorizedArray<Number> *face_values = scratch_data + 2*c*dofs_per_face;
+        VectorizedArray<Number> *face_normal_derivatives = face_values + dofs_per_face;
+        switch (face_direction)
+          {
+          case 0:
+            apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,0,true,false>
+            (shape_face, values_dofs[c], face_values);
+            if (evaluate_gradients == true)
+              apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,0,true,false>
+              (shape_face+fe_degree+1, values_dofs[c], face_normal_derivatives);
+            break;
+          case 1:
+            apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,(dim>1?1:0),true,false>
+            (shape_face, values_dofs[c], face_values);
+            if (evaluate_gradients == true)
+              apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,(dim>1?1:0),true,false>
+              (shape_face+fe_degree+1, values_dofs[c], face_normal_derivatives);
+            break;
+          case 2:
+            apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,(dim>2?2:0),true,false>
+            (shape_face, values_dofs[c], face_values);
+            if (evaluate_gradients == true)
+              apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,(dim>2?2:0),true,false>
+              (shape_face+fe_degree+1, values_dofs[c], face_normal_derivatives);
+            break;
+          default:
+            Assert (false, ExcNotImplemented());
+          }
+      }
+
+    // step 2: evaluate within the face
+    const VectorizedArray<Number> *shape_values[2], *shape_gradients[2];
+    select_shape_data (shape_info, subface_index, shape_values, shape_gradients);
+    const unsigned int tangent_0 = (face_direction+1)%dim;
+    const unsigned int tangent_1 = (face_direction+2)%dim;
+
+    for (unsigned int c=0; c<n_components; ++c)
+      {
+        const VectorizedArray<Number> *face_values = scratch_data + 2*c*dofs_per_face;
+        const VectorizedArray<Number> *face_normal_derivatives = face_values + dofs_per_face;
+        if (dim == 1)
+          {
+            if (evaluate_values == true)
+              values_quad[c][0] = face_values[0];
+            if (evaluate_gradients == true)
+              gradients_quad[c][0][0] = face_normal_derivatives[0];
+          }
+        else if (dim == 2)
+          {
+            if (evaluate_values == true)
+              Eval::template apply<0,true,false>(shape_values[0], face_values,
+                                                 values_quad[c]);
+            if (evaluate_gradients == true)
+              {
+                Eval::template apply<0,true,false>(shape_gradients[0], face_values,
+                                                   gradients_quad[c][tangent_0]);
+                Eval::template apply<0,true,false>(shape_values[0], face_normal_derivatives,
+                                                   gradients_quad[c][face_direction]);
+              }
+          }
+        else if (dim == 3)
+          {
+            Eval::template apply<0,true,false>(shape_values[0], face_values, temp);
+            if (evaluate_values == true)
+              Eval::template apply<1,true,false>(shape_values[1], temp, values_quad[c]);
+            if (evaluate_gradients == true)
+              {
+                Eval::template apply<1,true,false>(shape_gradients[1], temp,
+                                                   gradients_quad[c][tangent_1]);
+                Eval::template apply<0,true,false>(shape_gradients[0], face_values, temp);
+                Eval::template apply<1,true,false>(shape_values[1], temp,
+                                                   gradients_quad[c][tangent_0]);
+                Eval::template apply<0,true,false>(shape_values[0],
+                                                   face_normal_derivatives, temp);
+                Eval::template apply<1,true,false>(shape_values[1], temp,
+                                                   gradients_quad[c][face_direction]);
+              }
+          }
+        else
+          Assert (false, ExcNotImplemented());
+      }
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number>
+  inline
+  void
+  FEFaceEvaluationImpl<dim,fe_degree,n_q_points_1d,n_components,Number>
+  ::integrate (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &shape_info,
+               VectorizedArray<Number> *values_dofs[],
+               VectorizedArray<Number> *values_quad[],
+               VectorizedArray<Number> *gradients_quad[][dim],
+               VectorizedArray<Number> *scratch_data,
+               const bool               integrate_values,
+               const bool               integrate_gradients,
+               const unsigned int       face_no,
+               const unsigned int       subface_index)
+  {
+    Assert (shape_info.element_type <= MatrixFreeFunctions::tensor_general,
+            ExcNotImplemented());
+    AssertIndexRange (face_no, GeometryInfo<dim>::faces_per_cell);
+
+    typedef EvaluatorTensorProduct<evaluate_general, (dim>1?dim-1:1), fe_degree,
+            n_q_points_1d, VectorizedArray<Number> > Eval;
+
+    const unsigned int face_direction = face_no / 2;
+    const VectorizedArray<Number> *shape_face =
+      shape_info.shape_data_on_face[face_no%2].begin();
+    VectorizedArray<Number> *temp = scratch_data + 2*n_components*dofs_per_face;
+
+    if (integrate_values == false && integrate_gradients == false)
+      {
+        for (unsigned int c=0; c<n_components; ++c)
+          for (unsigned int i=0; i<shape_info.dofs_per_cell; ++i)
+            values_dofs[c][i] = VectorizedArray<Number>();
+        return;
+      }
+
+    // step 1: integrate within the face, the transpose of step 2 in
+    // evaluate()
+    const VectorizedArray<Number> *shape_values[2], *shape_gradients[2];
+    select_shape_data (shape_info, subface_index, shape_values, shape_gradients);
+    const unsigned int tangent_0 = (face_direction+1)%dim;
+    const unsigned int tangent_1 = (face_direction+2)%dim;
+
+    for (unsigned int c=0; c<n_components; ++c)
+      {
+        VectorizedArray<Number> *face_values = scratch_data + 2*c*dofs_per_face;
+        VectorizedArray<Number> *face_normal_derivatives = face_values + dofs_per_face;
+        if (dim == 1)
+          {
+            face_values[0] = integrate_values ? values_quad[c][0] :
+                             VectorizedArray<Number>();
+            if (integrate_gradients == true)
+              face_normal_derivatives[0] = gradients_quad[c][0][0];
+          }
+        else if (dim == 2)
+          {
+            if (integrate_values == true)
+              Eval::template apply<0,false,false>(shape_values[0], values_quad[c],
+                                                  face_values);
+            if (integrate_gradients == true)
+              {
+                if (integrate_values == true)
+                  Eval::template apply<0,false,true>(shape_gradients[0],
+                                                     gradients_quad[c][tangent_0],
+                                                     face_values);
+                else
+                  Eval::template apply<0,false,false>(shape_gradients[0],
+                                                      gradients_quad[c][tangent_0],
+                                                      face_values);
+                Eval::template apply<0,false,false>(shape_values[0],
+                                                    gradients_quad[c][face_direction],
+                                                    face_normal_derivatives);
+              }
+          }
+        else if (dim == 3)
+          {
+            if (integrate_values == true)
+              {
+                Eval::template apply<0,false,false>(shape_values[0], values_quad[c], temp);
+                Eval::template apply<1,false,false>(shape_values[1], temp, face_values);
+              }
+            if (integrate_gradients == true)
+              {
+                Eval::template apply<0,false,false>(shape_values[0],
+                                                    gradients_quad[c][tangent_1], temp);
+                if (integrate_values == true)
+                  Eval::template apply<1,false,true>(shape_gradients[1], temp, face_values);
+                else
+                  Eval::template apply<1,false,false>(shape_gradients[1], temp, face_values);
+                Eval::template apply<0,false,false>(shape_gradients[0],
+                                                    gradients_quad[c][tangent_0], temp);
+                Eval::template apply<1,false,true>(shape_values[1], temp, face_values);
+                Eval::template apply<0,false,false>(shape_values[0],
+                                                    gradients_quad[c][face_direction], temp);
+                Eval::template apply<1,false,false>(shape_values[1], temp,
+                                                    face_normal_derivatives);
+              }
+          }
+        else
+          Assert (false, ExcNotImplemented());
+      }
+
+    // step 2: expand from the face to the cell
+    for (unsigned int c=0; c<n_components; ++c)
+      {
+        const VectorizedArray<Number> *face_values = scratch_data + 2*c*dofs_per_face;
+        const VectorizedArray<Number> *face_normal_derivatives = face_values + dofs_per_face;
+        switch (face_direction)
+          {
+          case 0:
+            apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,0,false,false>
+            (shape_face, face_values, values_dofs[c]);
+            if (integrate_gradients == true)
+              apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,0,false,true>
+              (shape_face+fe_degree+1, face_normal_derivatives, values_dofs[c]);
+            break;
+          case 1:
+            apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,(dim>1?1:0),false,false>
+            (shape_face, face_values, values_dofs[c]);
+            if (integrate_gradients == true)
+              apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,(dim>1?1:0),false,true>
+              (shape_face+fe_degree+1, face_normal_derivatives, values_dofs[c]);
+            break;
+          case 2:
+            apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,(dim>2?2:0),false,false>
+            (shape_face, face_values, values_dofs[c]);
+            if (integrate_gradients == true)
+              apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,(dim>2?2:0),false,true>
+              (shape_face+fe_degree+1, face_normal_derivatives, values_dofs[c]);
+            break;
+          default:
+            Assert (false, ExcNotImplemented());
+          }
+      }
+  }
+
 } // end of namespace internal
 
 
@@ -31,7 +31,7 @@ namespace
 // 1. Start with fe_degree=0, n_q_points_1d=0 and DEPTH=0.
 // 2. If the current assumption on fe_degree doesn't match the runtime
 //    parameter, increase fe_degree  by one and try again.
-//    If fe_degree==10 use the class Default which serves as a fallback.
+//    If fe_degree==11 use the class Default which serves as a fallback.
 // 3. After fixing the fe_degree, DEPTH is increased (DEPTH=1) and we start with
 //    n_q_points=fe_degree+1.
 // 4. If the current assumption on n_q_points_1d doesn't match the runtime
@@ -91,7 +91,7 @@ namespace
    * which we want to determine the correct template parameters based at runtime.
    */
   template<int n_q_points_1d, int dim, int n_components, typename Number>
-  struct Factory<dim, n_components, Number, 0, 10, n_q_points_1d> : Default<dim, n_components, Number> {};
+  struct Factory<dim, n_components, Number, 0, 11, n_q_points_1d> : Default<dim, n_components, Number> {};
 
   /**
    * This specialization sets the maximal number of n_q_points_1d for
@@ -171,21 +171,16 @@ namespace
     const int runtime_n_q_points_1d = shape_info.n_q_points_1d;
     if (runtime_n_q_points_1d == n_q_points_1d)
       {
-        if (n_q_points_1d == degree+1)
-          {
-            if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
-              internal::FEEvaluationImplCollocation<dim, degree, n_components, Number>
-              ::evaluate(shape_info, values_dofs_actual, values_quad,
-                         gradients_quad, hessians_quad, scratch_data,
-                         evaluate_values, evaluate_gradients, evaluate_hessians);
-            else
-              internal::FEEvaluationImplTransformToCollocation<dim, degree, n_components, Number>
-              ::evaluate(shape_info, values_dofs_actual, values_quad,
-                         gradients_quad, hessians_quad, scratch_data,
-                         evaluate_values, evaluate_gradients, evaluate_hessians);
-          }
+        // n_q_points_1d starts at degree+1, so the transformation to the
+        // collocation space is always possible here
+        if (n_q_points_1d == degree+1 &&
+            shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
+          internal::FEEvaluationImplCollocation<dim, degree, n_components, Number>
+          ::evaluate(shape_info, values_dofs_actual, values_quad,
+                     gradients_quad, hessians_quad, scratch_data,
+                     evaluate_values, evaluate_gradients, evaluate_hessians);
         else
-          internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric, dim, degree, n_q_points_1d, n_components, Number>
+          internal::FEEvaluationImplTransformToCollocation<dim, degree, n_q_points_1d, n_components, Number>
           ::evaluate(shape_info, values_dofs_actual, values_quad,
                      gradients_quad, hessians_quad, scratch_data,
                      evaluate_values, evaluate_gradients, evaluate_hessians);
@@ -207,23 +202,17 @@ namespace
     const int runtime_n_q_points_1d = shape_info.n_q_points_1d;
     if (runtime_n_q_points_1d == n_q_points_1d)
       {
-        if (n_q_points_1d == degree+1)
-          {
-            if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
-              internal::FEEvaluationImplCollocation<dim, degree, n_components, Number>
-              ::integrate(shape_info, values_dofs_actual, values_quad,
-                          gradients_quad, scratch_data,
-                          integrate_values, integrate_gradients);
-            else
-              internal::FEEvaluationImplTransformToCollocation<dim, degree, n_components, Number>
-              ::integrate(shape_info, values_dofs_actual, values_quad,
-                          gradients_quad, scratch_data,
-                          integrate_values, integrate_gradients);
-          }
+        if (n_q_points_1d == degree+1 &&
+            shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
+          internal::FEEvaluationImplCollocation<dim, degree, n_components, Number>
+          ::integrate(shape_info, values_dofs_actual, values_quad,
+                      gradients_quad, scratch_data,
+                      integrate_values, integrate_gradients);
         else
-          internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric, dim, degree, n_q_points_1d, n_components, Number>
-          ::integrate(shape_info, values_dofs_actual, values_quad, gradients_quad,
-                      scratch_data, integrate_values, integrate_gradients);
+          internal::FEEvaluationImplTransformToCollocation<dim, degree, n_q_points_1d, n_components, Number>
+          ::integrate(shape_info, values_dofs_actual, values_quad,
+                      gradients_quad, scratch_data,
+                      integrate_values, integrate_gradients);
       }
     else
       Factory<dim, n_components, Number, 1, degree, n_q_points_1d+1>
@@ -250,6 +239,7 @@ namespace
                                     const bool               evaluate_hessians)
   {
     Assert(shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric||
+           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_hermite||
            shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation,
            ExcInternalError());
     Factory<dim, n_components, Number>::evaluate
@@ -273,6 +263,7 @@ namespace
                                      const bool               integrate_gradients)
   {
     Assert(shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric||
+           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_hermite||
            shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation,
            ExcInternalError());
     Factory<dim, n_components, Number>::integrate
@@ -291,7 +282,7 @@ namespace
  * pass these values to the respective template specializations.
  * Otherwise, we perform a runtime matching of the runtime parameters to find
  * the correct specialization. This matching currently supports
- * $0\leq fe\_degree \leq 9$ and $degree+1\leq n\_q\_points\_1d\leq fe\_degree+2$.
+ * $0\leq fe\_degree \leq 10$ and $degree+1\leq n\_q\_points\_1d\leq fe\_degree+2$.
  */
 template <int dim, int fe_degree, int n_q_points_1d, int n_components, typename Number>
 struct SelectEvaluator
@@ -335,7 +326,7 @@ struct SelectEvaluator
  * the selection is done based on the shape_info variable which contains
  * the relevant runtime parameters.
  * In case these parameters do not satisfy
- * $0\leq fe\_degree \leq 9$ and
+ * $0\leq fe\_degree \leq 10$ and
  * $degree+1\leq n\_q\_points\_1d\leq fe\_degree+2$, a non-optimized fallback
  * is used.
  */
@@ -396,23 +387,37 @@ SelectEvaluator<dim, fe_degree, n_q_points_1d, n_components, Number>::evaluate
 {
   Assert(fe_degree>=0  && n_q_points_1d>0, ExcInternalError());
 
-  if (fe_degree+1 == n_q_points_1d &&
-      shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
+  if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_raviart_thomas)
     {
-      internal::FEEvaluationImplCollocation<dim, fe_degree, n_components, Number>
+      internal::FEEvaluationImplRaviartThomas<dim, n_components, Number>
       ::evaluate(shape_info, values_dofs_actual, values_quad,
-                 gradients_quad, hessians_quad, scratch_data,
+                 gradients_quad, scratch_data,
                  evaluate_values, evaluate_gradients, evaluate_hessians);
     }
   else if (fe_degree+1 == n_q_points_1d &&
-           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric)
+           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
     {
-      internal::FEEvaluationImplTransformToCollocation<dim, fe_degree, n_components, Number>
+      internal::FEEvaluationImplCollocation<dim, fe_degree, n_components, Number>
       ::evaluate(shape_info, values_dofs_actual, values_quad,
                  gradients_quad, hessians_quad, scratch_data,
                  evaluate_values, evaluate_gradients, evaluate_hessians);
     }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric)
+  // all symmetric element types (i.e., the ones up to tensor_symmetric in
+  // the ElementType enum) can be transformed to the collocation space if
+  // there are at least as many quadrature points as degrees of freedom. The
+  // template argument for the number of quadrature points is only used when
+  // this condition is fulfilled, so select a valid dummy argument otherwise
+  else if (fe_degree+1 <= n_q_points_1d &&
+           shape_info.element_type <= internal::MatrixFreeFunctions::tensor_symmetric)
+    {
+      internal::FEEvaluationImplTransformToCollocation<dim, fe_degree,
+               (fe_degree+1 <= n_q_points_1d ? n_q_points_1d : fe_degree+1),
+               n_components, Number>
+               ::evaluate(shape_info, values_dofs_actual, values_quad,
+                          gradients_quad, hessians_quad, scratch_data,
+                          evaluate_values, evaluate_gradients, evaluate_hessians);
+    }
+  else if (shape_info.element_type <= internal::MatrixFreeFunctions::tensor_symmetric)
     {
       internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric,
                dim, fe_degree, n_q_points_1d, n_components, Number>
@@ -464,23 +469,37 @@ SelectEvaluator<dim, fe_degree, n_q_points_1d, n_components, Number>::integrate
 {
   Assert(fe_degree>=0  && n_q_points_1d>0, ExcInternalError());
 
-  if (fe_degree+1 == n_q_points_1d &&
-      shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
+  if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_raviart_thomas)
     {
-      internal::FEEvaluationImplCollocation<dim, fe_degree, n_components, Number>
+      internal::FEEvaluationImplRaviartThomas<dim, n_components, Number>
       ::integrate(shape_info, values_dofs_actual, values_quad,
                   gradients_quad, scratch_data,
                   integrate_values, integrate_gradients);
     }
   else if (fe_degree+1 == n_q_points_1d &&
-           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric)
+           shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_collocation)
     {
-      internal::FEEvaluationImplTransformToCollocation<dim, fe_degree, n_components, Number>
+      internal::FEEvaluationImplCollocation<dim, fe_degree, n_components, Number>
       ::integrate(shape_info, values_dofs_actual, values_quad,
                   gradients_quad, scratch_data,
                   integrate_values, integrate_gradients);
     }
-  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric)
+  // all symmetric element types (i.e., the ones up to tensor_symmetric in
+  // the ElementType enum) can be transformed to the collocation space if
+  // there are at least as many quadrature points as degrees of freedom. The
+  // template argument for the number of quadrature points is only used when
+  // this condition is fulfilled, so select a valid dummy argument otherwise
+  else if (fe_degree+1 <= n_q_points_1d &&
+           shape_info.element_type <= internal::MatrixFreeFunctions::tensor_symmetric)
+    {
+      internal::FEEvaluationImplTransformToCollocation<dim, fe_degree,
+               (fe_degree+1 <= n_q_points_1d ? n_q_points_1d : fe_degree+1),
+               n_components, Number>
+               ::integrate(shape_info, values_dofs_actual, values_quad,
+                           gradients_quad, scratch_data,
+                           integrate_values, integrate_gradients);
+    }
+  else if (shape_info.element_type <= internal::MatrixFreeFunctions::tensor_symmetric)
     {
       internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric,
                dim, fe_degree, n_q_points_1d, n_components, Number>
@@ -532,7 +551,14 @@ SelectEvaluator<dim, -1, dummy, n_components, Number>::evaluate
  const bool               evaluate_gradients,
  const bool               evaluate_hessians)
 {
-  if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0)
+  if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_raviart_thomas)
+    {
+      internal::FEEvaluationImplRaviartThomas<dim, n_components, Number>
+      ::evaluate(shape_info, values_dofs_actual, values_quad,
+                 gradients_quad, scratch_data,
+                 evaluate_values, evaluate_gradients, evaluate_hessians);
+    }
+  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0)
     {
       internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0,
                dim, -1, 0, n_components, Number>
@@ -575,7 +601,14 @@ SelectEvaluator<dim, -1, dummy, n_components, Number>::integrate
  const bool               integrate_values,
  const bool               integrate_gradients)
 {
-  if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0)
+  if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_raviart_thomas)
+    {
+      internal::FEEvaluationImplRaviartThomas<dim, n_components, Number>
+      ::integrate(shape_info, values_dofs_actual, values_quad,
+                  gradients_quad, scratch_data,
+                  integrate_values, integrate_gradients);
+    }
+  else if (shape_info.element_type == internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0)
     {
       internal::FEEvaluationImpl<internal::MatrixFreeFunctions::tensor_symmetric_plus_dg0,
                dim, -1, 0, n_components, Number>
@@ -0,0 +1,188 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_matrix_free_face_info_h
+#define dealii_matrix_free_face_info_h
+
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/types.h>
+#include <deal.II/base/utilities.h>
+
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+
+namespace internal
+{
+  namespace MatrixFreeFunctions
+  {
+    /**
+     * Data type for information about the batches build for vectorization of
+     * the face integrals. The setup of the batches for the faces is
+     * independent of the cells, and thus, we must store the relation to the
+     * cell indexing for accessing the degrees of freedom.
+     *
+     * Interior faces are stored by the two adjacent cells, which we label as
+     * "interior" and "exterior" side of the face. Normal vectors stored in
+     * MappingInfo are only stored once and are the outer normals to the
+     * cells on the "interior" side, whereas the sign is the opposite for the
+     * "exterior" side.
+     *
+     * On faces with hanging nodes, the finer of the two cells is always
+     * placed on the "interior" side and evaluated on its full face, whereas
+     * the coarser cell is placed on the "exterior" side and evaluated on the
+     * subface given by @p subface_index.
+     *
+     * This data field is stored as a vector for all faces involved in the
+     * computation. In order to avoid gaps in the memory representation, the
+     * four 'char' variables are put next to each other which occupies the
+     * same size as the unsigned integers on most architectures.
+     */
+    template <int vectorization_width>
+    struct FaceToCellTopology
+    {
+      /**
+       * The value of @p subface_index that identifies a full face of the
+       * exterior cell.
+       */
+      static const unsigned char invalid_subface_index = static_cast<unsigned char>(-1);
+
+      /**
+       * Indices of the faces in the current face batch as compared to the
+       * numbers of the cells on the logical "interior" side of the face
+       * which is aligned to the direction of FEEvaluation::get_normal_vector().
+       * The index is the number in the MatrixFree cell numbering, i.e.,
+       * <code>macro_cell * vectorization_width + lane</code>. Lanes that are
+       * not filled by a face are set to numbers::invalid_unsigned_int.
+       */
+      unsigned int cells_interior[vectorization_width];
+
+      /**
+       * Indices of the faces in the current face batch as compared to the
+       * numbers of the cells on the logical "exterior" side of the face
+       * which is aligned to the opposite direction of
+       * FEEvaluation::get_normal_vector(). Note that the distinction into
+       * interior and exterior faces is purely logical and refers to the
+       * direction of the normal only. The entries are set to
+       * numbers::invalid_unsigned_int on boundary faces and in unused lanes.
+       */
+      unsigned int cells_exterior[vectorization_width];
+
+      /**
+       * Index of the face between 0 and GeometryInfo::faces_per_cell within
+       * the cells on the "interior" side of the faces.
+       */
+      unsigned char interior_face_no;
+
+      /**
+       * Index of the face between 0 and GeometryInfo::faces_per_cell within
+       * the cells on the "exterior" side of the faces. For a boundary face,
+       * this data field stores the boundary id.
+       */
+      unsigned char exterior_face_no;
+
+      /**
+       * For adaptively refined meshes, the cell on the exterior side of the
+       * face might be less refined than the interior side. This index
+       * indicates the possible subface index on the exterior side. Set to
+       * @p invalid_subface_index (i.e., 255) if the face is a full face of
+       * the exterior cell.
+       */
+      unsigned char subface_index;
+
+      /**
+       * Stores the number of filled lanes in the present face batch.
+       */
+      unsigned char n_filled_lanes;
+
+      /**
+       * Return the memory consumption of the present data structure.
+       */
+      std::size_t memory_consumption() const
+      {
+        return sizeof(*this);
+      }
+    };
+
+
+
+    /**
+     * A data structure that holds the connectivity between the faces and the
+     * cells. The faces are subdivided into two ranges: The inner faces
+     * between two locally owned cells come first, then the boundary faces.
+     */
+    template <int vectorization_width>
+    struct FaceInfo
+    {
+      /**
+       * Constructor.
+       */
+      FaceInfo ()
+        :
+        n_inner_face_batches (0),
+        n_boundary_face_batches (0)
+      {}
+
+      /**
+       * Clear all data fields to be in a state similar to after having
+       * called the default constructor.
+       */
+      void clear()
+      {
+        faces.clear();
+        n_inner_face_batches = 0;
+        n_boundary_face_batches = 0;
+      }
+
+      /**
+       * Return the memory consumption of the present data structure.
+       */
+      std::size_t memory_consumption() const
+      {
+        return sizeof(*this) + MemoryConsumption::memory_consumption(faces);
+      }
+
+      /**
+       * This data structure holds the face batches for the inner faces
+       * first, followed by the boundary faces. Within the boundary faces,
+       * batches are sorted by the boundary id.
+       */
+      std::vector<FaceToCellTopology<vectorization_width> > faces;
+
+      /**
+       * The number of batches of inner faces stored at the beginning of @p
+       * faces.
+       */
+      unsigned int n_inner_face_batches;
+
+      /**
+       * The number of batches of boundary faces stored after the inner faces
+       * in @p faces.
+       */
+      unsigned int n_boundary_face_batches;
+    };
+
+  } // end of namespace MatrixFreeFunctions
+} // end of namespace internal
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
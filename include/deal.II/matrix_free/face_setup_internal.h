@@ -0,0 +1,217 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_matrix_free_face_setup_internal_h
+#define dealii_matrix_free_face_setup_internal_h
+
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/matrix_free/face_info.h>
+
+#include <array>
+#include <map>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+
+namespace internal
+{
+  namespace MatrixFreeFunctions
+  {
+    /**
+     * Collect all faces of the cells given in @p cell_level_index (which is
+     * the cell numbering of MatrixFree, including the repeated entries that
+     * pad the last macro cells) and group them into batches of @p
+     * vectorization_width faces that share the same face number on the
+     * interior side, the same face number on the exterior side, and the same
+     * subface index. Boundary faces are grouped by their boundary id and
+     * face number. The result is written into @p face_info.
+     *
+     * The setup is currently restricted to faces where the cells on both
+     * sides are handled by the current MatrixFree object (i.e., no ghost
+     * neighbors across MPI processes), where the faces have the standard
+     * orientation, where hanging nodes come from isotropic refinement, and
+     * where there are no periodic neighbors. An exception is thrown
+     * otherwise.
+     */
+    template <int dim, int vectorization_width>
+    void
+    collect_faces (const dealii::Triangulation<dim>                         &tria,
+                   const std::vector<std::pair<unsigned int,unsigned int> > &cell_level_index,
+                   FaceInfo<vectorization_width>                            &face_info)
+    {
+      face_info.clear();
+
+      // map from the cell level and index to the number in MatrixFree. The
+      // padded lanes repeat the last valid cell in a macro cell, so only the
+      // first occurrence of a cell is inserted.
+      std::map<std::pair<unsigned int,unsigned int>, unsigned int> cell_map;
+      for (unsigned int i=0; i<cell_level_index.size(); ++i)
+        cell_map.insert(std::make_pair(cell_level_index[i], i));
+
+      // the faces are grouped by the face numbers on the two sides and the
+      // subface index, which must be the same within a vectorized batch
+      std::map<std::array<unsigned int,3>,
+          std::vector<std::pair<unsigned int,unsigned int> > > inner_faces;
+      std::map<std::pair<types::boundary_id,unsigned int>,
+          std::vector<unsigned int> > boundary_faces;
+
+      for (unsigned int i=0; i<cell_level_index.size(); ++i)
+        {
+          if (cell_map[cell_level_index[i]] != i)
+            continue;
+
+          typename dealii::Triangulation<dim>::cell_iterator
+          cell (&tria, cell_level_index[i].first, cell_level_index[i].second);
+          for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+            {
+              AssertThrow (dim < 3 ||
+                           (cell->face_orientation(f) == true &&
+                            cell->face_flip(f) == false &&
+                            cell->face_rotation(f) == false),
+                           ExcMessage("Face integrals in MatrixFree are only "
+                                      "implemented for faces in standard "
+                                      "orientation."));
+              if (cell->at_boundary(f))
+                {
+                  AssertThrow (cell->has_periodic_neighbor(f) == false,
+                               ExcMessage("Face integrals in MatrixFree are "
+                                          "not implemented for periodic "
+                                          "boundary conditions."));
+                  boundary_faces[std::make_pair(cell->face(f)->boundary_id(),f)].
+                  push_back(i);
+                  continue;
+                }
+
+              // faces to finer neighbors are collected from the fine side
+              if (cell->neighbor(f)->has_children())
+                continue;
+
+              const typename std::map<std::pair<unsigned int,unsigned int>,
+                    unsigned int>::const_iterator neighbor =
+                      cell_map.find(std::make_pair(cell->neighbor_level(f),
+                                                   cell->neighbor_index(f)));
+              AssertThrow (neighbor != cell_map.end(),
+                           ExcMessage("Face integrals in MatrixFree are only "
+                                      "implemented for faces between cells "
+                                      "that are both handled by the "
+                                      "MatrixFree object, but found a "
+                                      "neighbor that is not. Ghost cells of "
+                                      "distributed triangulations are not "
+                                      "supported."));
+
+              std::array<unsigned int,3> key;
+              key[0] = f;
+              if (dim == 1 && cell->neighbor_is_coarser(f))
+                {
+                  // faces in 1D are points, so there are no subfaces
+                  key[1] = 1-f;
+                  key[2] = FaceToCellTopology<vectorization_width>::invalid_subface_index;
+                }
+              else if (cell->neighbor_is_coarser(f))
+                {
+                  const std::pair<unsigned int,unsigned int> neighbor_face =
+                    cell->neighbor_of_coarser_neighbor(f);
+                  AssertThrow (dim == 2 ||
+                               cell->neighbor(f)->face(neighbor_face.first)->refinement_case()
+                               == RefinementCase<dim-1>::isotropic_refinement,
+                               ExcMessage("Face integrals in MatrixFree are "
+                                          "only implemented for isotropic "
+                                          "refinement."));
+                  key[1] = neighbor_face.first;
+                  key[2] = neighbor_face.second;
+                }
+              else
+                {
+                  // same level: only collect the face once from the side
+                  // with the lower index
+                  if (neighbor->second < i)
+                    continue;
+                  key[1] = cell->neighbor_of_neighbor(f);
+                  key[2] = FaceToCellTopology<vectorization_width>::invalid_subface_index;
+                }
+              inner_faces[key].push_back(std::make_pair(i, neighbor->second));
+            }
+        }
+
+      // now build the batches, first the inner faces and then the boundary
+      // faces
+      FaceToCellTopology<vectorization_width> face_batch;
+      for (typename std::map<std::array<unsigned int,3>,
+           std::vector<std::pair<unsigned int,unsigned int> > >::const_iterator
+           it = inner_faces.begin(); it != inner_faces.end(); ++it)
+        for (unsigned int start=0; start<it->second.size();
+             start += vectorization_width)
+          {
+            const unsigned int n_filled =
+              std::min<unsigned int>(vectorization_width,
+                                     it->second.size()-start);
+            for (unsigned int v=0; v<vectorization_width; ++v)
+              {
+                face_batch.cells_interior[v] = v < n_filled ?
+                                               it->second[start+v].first :
+                                               numbers::invalid_unsigned_int;
+                face_batch.cells_exterior[v] = v < n_filled ?
+                                               it->second[start+v].second :
+                                               numbers::invalid_unsigned_int;
+              }
+            face_batch.interior_face_no = it->first[0];
+            face_batch.exterior_face_no = it->first[1];
+            face_batch.subface_index = it->first[2];
+            face_batch.n_filled_lanes = n_filled;
+            face_info.faces.push_back(face_batch);
+          }
+      face_info.n_inner_face_batches = face_info.faces.size();
+
+      for (typename std::map<std::pair<types::boundary_id,unsigned int>,
+           std::vector<unsigned int> >::const_iterator
+           it = boundary_faces.begin(); it != boundary_faces.end(); ++it)
+        for (unsigned int start=0; start<it->second.size();
+             start += vectorization_width)
+          {
+            const unsigned int n_filled =
+              std::min<unsigned int>(vectorization_width,
+                                     it->second.size()-start);
+            for (unsigned int v=0; v<vectorization_width; ++v)
+              {
+                face_batch.cells_interior[v] = v < n_filled ?
+                                               it->second[start+v] :
+                                               numbers::invalid_unsigned_int;
+                face_batch.cells_exterior[v] = numbers::invalid_unsigned_int;
+              }
+            face_batch.interior_face_no = it->first.second;
+            face_batch.exterior_face_no = it->first.first;
+            face_batch.subface_index = FaceToCellTopology<vectorization_width>::invalid_subface_index;
+            face_batch.n_filled_lanes = n_filled;
+            face_info.faces.push_back(face_batch);
+          }
+      face_info.n_boundary_face_batches =
+        face_info.faces.size() - face_info.n_inner_face_batches;
+    }
+
+  } // end of namespace MatrixFreeFunctions
+} // end of namespace internal
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
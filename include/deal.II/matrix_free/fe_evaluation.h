@@ -941,6 +941,20 @@ protected:
    */
   mutable std::vector<types::global_dof_index> local_dof_indices;
 
+  /**
+   * The inverse Jacobians on the present cell if MappingInfo only stores the
+   * support points of the mapping for general cells. In that case, the
+   * Jacobians are computed in reinit() and the pointer @p jacobian points
+   * into this field.
+   */
+  AlignedVector<Tensor<2,dim,VectorizedArray<Number> > > jacobians_on_the_fly;
+
+  /**
+   * The JxW values on the present cell if computed on the fly, followed by
+   * temporary storage for the evaluation of the mapping.
+   */
+  AlignedVector<VectorizedArray<Number> > JxW_on_the_fly;
+
 private:
   /**
    * Sets the pointers for values, gradients, hessians to the central
@@ -948,6 +962,13 @@ private:
    */
   void set_data_pointers();
 
+  /**
+   * Compute the inverse Jacobians and JxW values of a general cell from the
+   * support points of the mapping stored in MappingInfo, using sum
+   * factorization with the 1D polynomials of the mapping.
+   */
+  void compute_jacobians_on_the_fly();
+
   /**
    * Make other FEEvaluationBase as well as FEEvaluation objects friends.
    */
@@ -1216,6 +1237,45 @@ public:
   void submit_curl (const Tensor<1,dim==2?1:dim,VectorizedArray<Number> > curl_in,
                     const unsigned int q_point);
 
+  /**
+   * Return the value of an H(div) conforming element, i.e.,
+   * FE_RaviartThomasNodal, at quadrature point number @p q_point after a
+   * call to @p evaluate(true,...). The values in reference coordinates
+   * $\hat{u}$ are mapped to real space by the contravariant Piola
+   * transformation, $u = \frac{1}{\det J} J \hat{u}$, which preserves the
+   * normal components on the faces. Use FEEvaluation with the template
+   * argument @p fe_degree set to the polynomial degree of the element in the
+   * tangential directions, i.e., the degree of FE_RaviartThomasNodal.
+   */
+  value_type get_value_contravariant_piola (const unsigned int q_point) const;
+
+  /**
+   * Return the divergence of an H(div) conforming element at quadrature
+   * point number @p q_point after a call to @p evaluate(...,true,...),
+   * $\nabla \cdot u = \frac{1}{\det J} \hat{\nabla} \cdot \hat{u}$.
+   */
+  VectorizedArray<Number>
+  get_divergence_contravariant_piola (const unsigned int q_point) const;
+
+  /**
+   * Write a contribution that is tested by the values of an H(div)
+   * conforming element transformed by the contravariant Piola
+   * transformation. This is the counterpart of
+   * get_value_contravariant_piola() for @p integrate(true,...).
+   */
+  void submit_value_contravariant_piola (const value_type   val_in,
+                                         const unsigned int q_point);
+
+  /**
+   * Write a contribution that is tested by the divergence of an H(div)
+   * conforming element. This is the counterpart of
+   * get_divergence_contravariant_piola() for @p integrate(...,true). Since
+   * the Jacobian determinant of the transformation cancels against the one
+   * of the integration, only the quadrature weight is applied.
+   */
+  void submit_divergence_contravariant_piola (const VectorizedArray<Number> div_in,
+                                              const unsigned int q_point);
+
 protected:
   /**
    * Constructor. Made protected to avoid initialization in user code. Takes
@@ -2048,6 +2108,233 @@ private:
 
 
 
+
+/**
+ * The class that provides all functions necessary to evaluate functions at
+ * quadrature points and face integrations for one batch of faces as given by
+ * MatrixFree::loop(). The design is similar to FEEvaluation: The operations
+ * are vectorized over several faces that are combined in a batch (with the
+ * same layout as VectorizedArray), and the degrees of freedom of the cells
+ * on the "interior" or "exterior" side of the faces are read and written
+ * through the cell numbering of MatrixFree.
+ *
+ * This class is constructed for one side of the faces only, as selected by
+ * the argument @p is_interior_face of the constructor. The normal vector
+ * returned by get_normal_vector() points from the "interior" side to the
+ * "exterior" side. For an object that evaluates the exterior side, the sign
+ * of the normal is flipped, i.e., get_normal_vector() returns the outer
+ * normal of the cells on the respective side. Boundary faces only have an
+ * interior side.
+ *
+ * The face data must be set up by specifying
+ * MatrixFree::AdditionalData::mapping_update_flags_inner_faces and/or
+ * MatrixFree::AdditionalData::mapping_update_flags_boundary_faces. Note that
+ * the face integrals are currently limited to meshes without periodic
+ * boundaries and without faces across MPI processes, and to tensor-product
+ * elements with a compile-time degree. In 3D, all faces must furthermore be
+ * in standard orientation, i.e., without rotated or flipped faces as they
+ * can appear in unstructured hexahedral meshes, and faces with hanging
+ * nodes must stem from isotropic refinement. Otherwise, MatrixFree::reinit()
+ * throws an exception when setting up the face data.
+ *
+ * @tparam dim Dimension in which this class is to be used
+ *
+ * @tparam fe_degree Degree of the tensor product finite element with
+ * fe_degree+1 degrees of freedom per coordinate direction
+ *
+ * @tparam n_q_points_1d Number of points in the quadrature formula in 1D,
+ * defaults to fe_degree+1
+ *
+ * @tparam n_components Number of vector components when solving a system of
+ * PDEs. Defaults to 1.
+ *
+ * @tparam Number Number format, usually @p double or @p float. Defaults to @p
+ * double
+ */
+template <int dim, int fe_degree, int n_q_points_1d = fe_degree+1,
+          int n_components_ = 1, typename Number = double >
+class FEFaceEvaluation : public FEEvaluationAccess<dim,n_components_,Number>
+{
+public:
+  typedef FEEvaluationAccess<dim,n_components_,Number> BaseClass;
+  typedef Number                            number_type;
+  typedef typename BaseClass::value_type    value_type;
+  typedef typename BaseClass::gradient_type gradient_type;
+  static const unsigned int dimension     = dim;
+  static const unsigned int n_components  = n_components_;
+  static const unsigned int static_n_q_points = Utilities::fixed_int_power<n_q_points_1d,dim-1>::value;
+  static const unsigned int static_n_q_points_cell = Utilities::fixed_int_power<n_q_points_1d,dim>::value;
+  static const unsigned int tensor_dofs_per_cell = Utilities::fixed_int_power<fe_degree+1,dim>::value;
+
+  /**
+   * Constructor. Takes all data stored in MatrixFree. The argument @p
+   * is_interior_face selects which of the two cells adjacent to the faces
+   * the object works on. If applied to problems with more than one finite
+   * element or more than one quadrature formula selected during construction
+   * of @p matrix_free, @p fe_no and @p quad_no allow to select the
+   * appropriate components.
+   */
+  FEFaceEvaluation (const MatrixFree<dim,Number> &matrix_free,
+                    const bool                    is_interior_face = true,
+                    const unsigned int            fe_no   = 0,
+                    const unsigned int            quad_no = 0);
+
+  /**
+   * Initialize the operation pointer to the current face batch with index
+   * @p face_batch_number in the range from zero to
+   * MatrixFree::n_inner_face_batches() + MatrixFree::n_boundary_face_batches().
+   * The exterior side can only be selected for inner faces.
+   */
+  void reinit (const unsigned int face_batch_number);
+
+  /**
+   * For the vector @p src, read out the values on the degrees of freedom of
+   * the cells on the selected side of the current face batch, and store them
+   * internally. See FEEvaluationBase::read_dof_values() for the treatment of
+   * block vectors and constraints.
+   */
+  template <typename VectorType>
+  void read_dof_values (const VectorType  &src,
+                        const unsigned int first_index = 0);
+
+  /**
+   * Takes the values stored internally on the degrees of freedom of the
+   * cells on the selected side of the current face batch and sums them into
+   * the vector @p dst, applying the constraints. See
+   * FEEvaluationBase::distribute_local_to_global().
+   */
+  template <typename VectorType>
+  void distribute_local_to_global (VectorType        &dst,
+                                   const unsigned int first_index = 0) const;
+
+  /**
+   * Takes the values stored internally on the degrees of freedom of the
+   * cells on the selected side of the current face batch and writes them
+   * into the vector @p dst, skipping the constrained degrees of freedom. See
+   * FEEvaluationBase::set_dof_values().
+   */
+  template <typename VectorType>
+  void set_dof_values (VectorType        &dst,
+                       const unsigned int first_index = 0) const;
+
+  /**
+   * Evaluates the function values and the gradients of the FE function
+   * given at the DoF values of the cells in the input vector at the
+   * quadrature points on the face. The function arguments specify which
+   * parts shall actually be computed. Needs to be called before the
+   * functions get_value(), get_gradient() or get_normal_derivative() give
+   * useful information.
+   */
+  void evaluate (const bool evaluate_values,
+                 const bool evaluate_gradients);
+
+  /**
+   * This function takes the values and/or gradients that are stored on
+   * quadrature points of the face, tests them by all the basis
+   * functions/gradients of the cells and performs the face integration. The
+   * result is stored in the DoF values of the cells and can be written into
+   * a vector with distribute_local_to_global().
+   */
+  void integrate (const bool integrate_values,
+                  const bool integrate_gradients);
+
+  /**
+   * Return the q-th quadrature point on the face. Only available if the
+   * flag update_quadrature_points was set for the face data.
+   */
+  Point<dim,VectorizedArray<Number> >
+  quadrature_point (const unsigned int q_point) const;
+
+  /**
+   * Return the outer normal vector of the cells on the selected side of the
+   * face at the given quadrature point.
+   */
+  Tensor<1,dim,VectorizedArray<Number> >
+  get_normal_vector (const unsigned int q_point) const;
+
+  /**
+   * Return the derivative in direction of get_normal_vector() at the given
+   * quadrature point. The same can be obtained by taking the scalar product
+   * of get_gradient() and get_normal_vector() but this function is more
+   * efficient.
+   */
+  value_type
+  get_normal_derivative (const unsigned int q_point) const;
+
+  /**
+   * Write a contribution that is tested by the derivative in direction of
+   * get_normal_vector() to the field containing the values on quadrature
+   * points with component @p q_point.
+   */
+  void
+  submit_normal_derivative (const value_type   grad_in,
+                            const unsigned int q_point);
+
+  /**
+   * Return whether the present object works on the interior side of the
+   * faces.
+   */
+  bool is_interior_face () const;
+
+  /**
+   * Return the face number within the cells on the selected side of the
+   * current face batch.
+   */
+  unsigned int get_face_no () const;
+
+  /**
+   * The number of scalar degrees of freedom on the cell.
+   */
+  const unsigned int dofs_per_cell;
+
+  /**
+   * The number of quadrature points on the face.
+   */
+  const unsigned int n_q_points;
+
+private:
+  /**
+   * A unified function to read from and write into vectors for the cells
+   * adjacent to the current face batch, processing the cells lane by lane
+   * through the indices stored per cell in DoFInfo.
+   */
+  template <typename VectorType, typename VectorOperation>
+  void read_write_operation_face (const VectorOperation &operation,
+                                  VectorType            *vectors[]) const;
+
+  /**
+   * Stores whether the present object works on the interior or the
+   * exterior side of the faces.
+   */
+  const bool is_interior;
+
+  /**
+   * The number of the cells (in the MatrixFree numbering) on the selected
+   * side of the faces in the current batch, set to
+   * numbers::invalid_unsigned_int for unused lanes.
+   */
+  unsigned int cell_ids[VectorizedArray<Number>::n_array_elements];
+
+  /**
+   * The face number within the cells on the selected side.
+   */
+  unsigned int face_no;
+
+  /**
+   * The subface index within the cells on the selected side, which is
+   * different from a full face only for the coarser cell on the exterior
+   * side of faces with hanging nodes.
+   */
+  unsigned int subface_index;
+
+  /**
+   * A pointer to the normal vectors of the current face batch.
+   */
+  const Tensor<1,dim,VectorizedArray<Number> > *normal_vectors;
+};
+
+
+
 namespace internal
 {
   namespace MatrixFreeFunctions
@@ -2451,6 +2738,12 @@ FEEvaluationBase<dim,n_components_,Number>::reinit (const unsigned int cell_in)
       jacobian  = &mapping_info->affine_data[cell_data_number].first;
       J_value   = &mapping_info->affine_data[cell_data_number].second;
     }
+  else if (mapping_info->mapping_degree != numbers::invalid_unsigned_int)
+    {
+      compute_jacobians_on_the_fly();
+      jacobian = jacobians_on_the_fly.begin();
+      J_value  = JxW_on_the_fly.begin();
+    }
   else
     {
       const unsigned int rowstart = mapping_info->
@@ -2489,6 +2782,86 @@ FEEvaluationBase<dim,n_components_,Number>::reinit (const unsigned int cell_in)
 
 
 
+template <int dim, int n_components_, typename Number>
+inline
+void
+FEEvaluationBase<dim,n_components_,Number>::compute_jacobians_on_the_fly ()
+{
+  const unsigned int n_points_1d = mapping_info->mapping_degree + 1;
+  const unsigned int n_mapping_points = Utilities::fixed_power<dim>(n_points_1d);
+  const unsigned int n_q_points_1d = data->n_q_points_1d;
+  const unsigned int n_q_points = data->n_q_points;
+  AssertIndexRange ((cell_data_number+1)*dim*n_mapping_points,
+                    mapping_info->mapping_support_points.size()+1);
+  const VectorizedArray<Number> *support_points =
+    &mapping_info->mapping_support_points[cell_data_number*dim*n_mapping_points];
+
+  const unsigned int tmp_size =
+    Utilities::fixed_power<dim>(std::max(n_points_1d, n_q_points_1d));
+  jacobians_on_the_fly.resize_fast(n_q_points);
+  JxW_on_the_fly.resize_fast(n_q_points + 2*tmp_size);
+  VectorizedArray<Number> *tmp0 = JxW_on_the_fly.begin() + n_q_points;
+  VectorizedArray<Number> *tmp1 = tmp0 + tmp_size;
+
+  const typename internal::MatrixFreeFunctions::MappingInfo<dim,Number>::
+  MappingInfoDependent &quad_data = mapping_info->mapping_data_gen[quad_no];
+  internal::EvaluatorTensorProduct<internal::evaluate_general,dim,-1,0,VectorizedArray<Number> >
+  eval (quad_data.mapping_shape_values[active_quad_index],
+        quad_data.mapping_shape_gradients[active_quad_index],
+        quad_data.mapping_shape_gradients[active_quad_index],
+        mapping_info->mapping_degree,
+        n_q_points_1d);
+
+  // derivative of the component d of the mapping in direction e, evaluated
+  // by sum factorization with the derivative applied in direction e only
+  for (unsigned int d=0; d<dim; ++d)
+    for (unsigned int e=0; e<dim; ++e)
+      {
+        const VectorizedArray<Number> *in = support_points + d*n_mapping_points;
+        if (dim == 1)
+          eval.template gradients<0,true,false>(in, tmp1);
+        else if (dim == 2)
+          {
+            if (e == 0)
+              eval.template gradients<0,true,false>(in, tmp0);
+            else
+              eval.template values<0,true,false>(in, tmp0);
+            if (e == 1)
+              eval.template gradients<1,true,false>(tmp0, tmp1);
+            else
+              eval.template values<1,true,false>(tmp0, tmp1);
+          }
+        else
+          {
+            if (e == 0)
+              eval.template gradients<0,true,false>(in, tmp1);
+            else
+              eval.template values<0,true,false>(in, tmp1);
+            if (e == 1)
+              eval.template gradients<1,true,false>(tmp1, tmp0);
+            else
+              eval.template values<1,true,false>(tmp1, tmp0);
+            if (e == 2)
+              eval.template gradients<2,true,false>(tmp0, tmp1);
+            else
+              eval.template values<2,true,false>(tmp0, tmp1);
+          }
+        for (unsigned int q=0; q<n_q_points; ++q)
+          jacobians_on_the_fly[q][d][e] = tmp1[q];
+      }
+
+  // same format as the data in MappingInfo: transposed inverse of the
+  // Jacobian and determinant times quadrature weight
+  for (unsigned int q=0; q<n_q_points; ++q)
+    {
+      const Tensor<2,dim,VectorizedArray<Number> > jac = jacobians_on_the_fly[q];
+      JxW_on_the_fly[q] = determinant(jac) * quadrature_weights[q];
+      jacobians_on_the_fly[q] = transpose(invert(jac));
+    }
+}
+
+
+
 template <int dim, int n_components_, typename Number>
 template <typename DoFHandlerType, bool level_dof_access>
 inline
@@ -2722,6 +3095,58 @@ namespace internal
         res[v] = vector_access(const_cast<const VectorType &>(vec), indices[v]);
     }
 
+    // read the dofs of cells whose indices are contiguous, starting at the
+    // given offsets for the lanes, see
+    // DoFInfo::IndexStorageVariants::contiguous
+    template <typename VectorType>
+    void process_dofs_contiguous (const unsigned int       n_dofs,
+                                  const unsigned int      *offsets,
+                                  VectorType              &vec,
+                                  VectorizedArray<Number> *res,
+                                  std::integral_constant<bool, true>) const
+    {
+      vectorized_load_and_transpose(n_dofs, vec.begin(), offsets, res);
+    }
+
+    template <typename VectorType>
+    void process_dofs_contiguous (const unsigned int       n_dofs,
+                                  const unsigned int      *offsets,
+                                  VectorType              &vec,
+                                  VectorizedArray<Number> *res,
+                                  std::integral_constant<bool, false>) const
+    {
+      for (unsigned int i=0; i<n_dofs; ++i)
+        for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+          res[i][v] = vector_access(const_cast<const VectorType &>(vec), offsets[v]+i);
+    }
+
+    // read the dofs of cells whose indices are interleaved, starting at the
+    // given offset, see DoFInfo::IndexStorageVariants::interleaved
+    template <typename VectorType>
+    void process_dofs_interleaved (const unsigned int       n_dofs,
+                                   const unsigned int       offset,
+                                   VectorType              &vec,
+                                   VectorizedArray<Number> *res,
+                                   std::integral_constant<bool, true>) const
+    {
+      const Number *vec_ptr = vec.begin() + offset;
+      for (unsigned int i=0; i<n_dofs; ++i, vec_ptr += VectorizedArray<Number>::n_array_elements)
+        res[i].load(vec_ptr);
+    }
+
+    template <typename VectorType>
+    void process_dofs_interleaved (const unsigned int       n_dofs,
+                                   const unsigned int       offset,
+                                   VectorType              &vec,
+                                   VectorizedArray<Number> *res,
+                                   std::integral_constant<bool, false>) const
+    {
+      for (unsigned int i=0; i<n_dofs; ++i)
+        for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+          res[i][v] = vector_access(const_cast<const VectorType &>(vec),
+                                    offset+i*VectorizedArray<Number>::n_array_elements+v);
+    }
+
     template <typename VectorType>
     void process_dof_global (const types::global_dof_index index,
                              VectorType         &vec,
@@ -2803,6 +3228,57 @@ namespace internal
         vector_access(vec, indices[v]) += res[v];
     }
 
+    template <typename VectorType>
+    void process_dofs_contiguous (const unsigned int       n_dofs,
+                                  const unsigned int      *offsets,
+                                  VectorType              &vec,
+                                  VectorizedArray<Number> *res,
+                                  std::integral_constant<bool, true>) const
+    {
+      vectorized_transpose_and_store(true, n_dofs, res, offsets, vec.begin());
+    }
+
+    template <typename VectorType>
+    void process_dofs_contiguous (const unsigned int       n_dofs,
+                                  const unsigned int      *offsets,
+                                  VectorType              &vec,
+                                  VectorizedArray<Number> *res,
+                                  std::integral_constant<bool, false>) const
+    {
+      for (unsigned int i=0; i<n_dofs; ++i)
+        for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+          vector_access(vec, offsets[v]+i) += res[i][v];
+    }
+
+    template <typename VectorType>
+    void process_dofs_interleaved (const unsigned int       n_dofs,
+                                   const unsigned int       offset,
+                                   VectorType              &vec,
+                                   VectorizedArray<Number> *res,
+                                   std::integral_constant<bool, true>) const
+    {
+      Number *vec_ptr = vec.begin() + offset;
+      for (unsigned int i=0; i<n_dofs; ++i, vec_ptr += VectorizedArray<Number>::n_array_elements)
+        {
+          VectorizedArray<Number> tmp;
+          tmp.load(vec_ptr);
+          tmp += res[i];
+          tmp.store(vec_ptr);
+        }
+    }
+
+    template <typename VectorType>
+    void process_dofs_interleaved (const unsigned int       n_dofs,
+                                   const unsigned int       offset,
+                                   VectorType              &vec,
+                                   VectorizedArray<Number> *res,
+                                   std::integral_constant<bool, false>) const
+    {
+      for (unsigned int i=0; i<n_dofs; ++i)
+        for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+          vector_access(vec, offset+i*VectorizedArray<Number>::n_array_elements+v) += res[i][v];
+    }
+
     template <typename VectorType>
     void process_dof_global (const types::global_dof_index index,
                              VectorType         &vec,
@@ -2868,6 +3344,52 @@ namespace internal
         vector_access(vec, indices[v]) = res[v];
     }
 
+    template <typename VectorType>
+    void process_dofs_contiguous (const unsigned int       n_dofs,
+                                  const unsigned int      *offsets,
+                                  VectorType              &vec,
+                                  VectorizedArray<Number> *res,
+                                  std::integral_constant<bool, true>) const
+    {
+      vectorized_transpose_and_store(false, n_dofs, res, offsets, vec.begin());
+    }
+
+    template <typename VectorType>
+    void process_dofs_contiguous (const unsigned int       n_dofs,
+                                  const unsigned int      *offsets,
+                                  VectorType              &vec,
+                                  VectorizedArray<Number> *res,
+                                  std::integral_constant<bool, false>) const
+    {
+      for (unsigned int i=0; i<n_dofs; ++i)
+        for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+          vector_access(vec, offsets[v]+i) = res[i][v];
+    }
+
+    template <typename VectorType>
+    void process_dofs_interleaved (const unsigned int       n_dofs,
+                                   const unsigned int       offset,
+                                   VectorType              &vec,
+                                   VectorizedArray<Number> *res,
+                                   std::integral_constant<bool, true>) const
+    {
+      Number *vec_ptr = vec.begin() + offset;
+      for (unsigned int i=0; i<n_dofs; ++i, vec_ptr += VectorizedArray<Number>::n_array_elements)
+        res[i].store(vec_ptr);
+    }
+
+    template <typename VectorType>
+    void process_dofs_interleaved (const unsigned int       n_dofs,
+                                   const unsigned int       offset,
+                                   VectorType              &vec,
+                                   VectorizedArray<Number> *res,
+                                   std::integral_constant<bool, false>) const
+    {
+      for (unsigned int i=0; i<n_dofs; ++i)
+        for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+          vector_access(vec, offset+i*VectorizedArray<Number>::n_array_elements+v) = res[i][v];
+    }
+
     template <typename VectorType>
     void process_dof_global (const types::global_dof_index index,
                              VectorType         &vec,
@@ -3026,6 +3548,18 @@ FEEvaluationBase<dim,n_components_,Number>
   const unsigned int n_irreg_components_filled = dof_info->row_starts[cell][2];
   const bool at_irregular_cell = n_irreg_components_filled > 0;
 
+  // macro cells whose indices are contiguous or interleaved in the vector
+  // are accessed with vectorized loads and stores in the branches without
+  // constraints below
+  typedef internal::MatrixFreeFunctions::DoFInfo::IndexStorageVariants IndexStorageVariants;
+  const IndexStorageVariants index_storage =
+    (cell < dof_info->index_storage_variants.size() ?
+     dof_info->index_storage_variants[cell] : IndexStorageVariants::full);
+  const unsigned int *contiguous_offsets =
+    (index_storage != IndexStorageVariants::full ?
+     &dof_info->dof_indices_contiguous[cell*VectorizedArray<Number>::n_array_elements] :
+     nullptr);
+
   // scalar case (or case when all components have the same degrees of freedom
   // and sit on a different vector each)
   if (n_fe_components == 1)
@@ -3098,6 +3632,20 @@ FEEvaluationBase<dim,n_components_,Number>
                                            local_data[comp][ind_local]);
                 }
             }
+          else if (index_storage == IndexStorageVariants::contiguous)
+            {
+              for (unsigned int comp=0; comp<n_components; ++comp)
+                operation.process_dofs_contiguous(dofs_per_cell, contiguous_offsets,
+                                                  *src[comp], values_dofs[comp],
+                                                  std::integral_constant<bool, std::is_same<typename VectorType::value_type,Number>::value>());
+            }
+          else if (index_storage == IndexStorageVariants::interleaved)
+            {
+              for (unsigned int comp=0; comp<n_components; ++comp)
+                operation.process_dofs_interleaved(dofs_per_cell, contiguous_offsets[0],
+                                                   *src[comp], values_dofs[comp],
+                                                   std::integral_constant<bool, std::is_same<typename VectorType::value_type,Number>::value>());
+            }
           else
             {
               // no constraint at all: compiler can unroll at least the
@@ -3241,6 +3789,16 @@ FEEvaluationBase<dim,n_components_,Number>
               Assert (dof_indices == dof_info->end_indices(cell),
                       ExcInternalError());
             }
+          else if (index_storage == IndexStorageVariants::contiguous)
+            operation.process_dofs_contiguous(dofs_per_cell*n_components,
+                                              contiguous_offsets,
+                                              *src[0], values_dofs[0],
+                                              std::integral_constant<bool, std::is_same<typename VectorType::value_type,Number>::value>());
+          else if (index_storage == IndexStorageVariants::interleaved)
+            operation.process_dofs_interleaved(dofs_per_cell*n_components,
+                                               contiguous_offsets[0],
+                                               *src[0], values_dofs[0],
+                                               std::integral_constant<bool, std::is_same<typename VectorType::value_type,Number>::value>());
           else
             {
               // no constraint at all: compiler can unroll at least the
@@ -4832,29 +5390,153 @@ FEEvaluationAccess<dim,dim,Number>
 }
 
 
-/*-------------------- FEEvaluationAccess scalar for 1d ----------------------------*/
-
 
-template <typename Number>
+template <int dim, typename Number>
 inline
-FEEvaluationAccess<1,1,Number>
-::FEEvaluationAccess (const MatrixFree<1,Number> &data_in,
-                      const unsigned int fe_no,
-                      const unsigned int quad_no_in,
-                      const unsigned int fe_degree,
-                      const unsigned int n_q_points)
-  :
-  FEEvaluationBase <1,1,Number>
-  (data_in, fe_no, quad_no_in, fe_degree, n_q_points)
-{}
+Tensor<1,dim,VectorizedArray<Number> >
+FEEvaluationAccess<dim,dim,Number>
+::get_value_contravariant_piola (const unsigned int q_point) const
+{
+  Assert (this->values_quad_initialized==true,
+          internal::ExcAccessToUninitializedField());
+  AssertIndexRange (q_point, this->data->n_q_points);
+
+  Tensor<1,dim,VectorizedArray<Number> > value;
+  if (this->cell_type == internal::MatrixFreeFunctions::cartesian)
+    {
+      // the Jacobian is the inverse of the diagonal in cartesian_data
+      VectorizedArray<Number> inv_det = this->cartesian_data[0][0];
+      for (unsigned int d=1; d<dim; ++d)
+        inv_det *= this->cartesian_data[0][d];
+      for (unsigned int d=0; d<dim; ++d)
+        value[d] = this->values_quad[d][q_point] * inv_det /
+                   this->cartesian_data[0][d];
+    }
+  else
+    {
+      // the stored Jacobian is the inverse transpose
+      const Tensor<2,dim,VectorizedArray<Number> > &jac =
+        this->cell_type == internal::MatrixFreeFunctions::general ?
+        this->jacobian[q_point] : this->jacobian[0];
+      const Tensor<2,dim,VectorizedArray<Number> > inv_jac = invert(jac);
+      const VectorizedArray<Number> inv_det = determinant(jac);
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          VectorizedArray<Number> sum = inv_jac[0][d] * this->values_quad[0][q_point];
+          for (unsigned int e=1; e<dim; ++e)
+            sum += inv_jac[e][d] * this->values_quad[e][q_point];
+          value[d] = sum * inv_det;
+        }
+    }
+  return value;
+}
 
 
 
-template <typename Number>
-template <int n_components_other>
+template <int dim, typename Number>
 inline
-FEEvaluationAccess<1,1,Number>
-::FEEvaluationAccess (const Mapping<1>       &mapping,
+VectorizedArray<Number>
+FEEvaluationAccess<dim,dim,Number>
+::get_divergence_contravariant_piola (const unsigned int q_point) const
+{
+  Assert (this->gradients_quad_initialized==true,
+          internal::ExcAccessToUninitializedField());
+  AssertIndexRange (q_point, this->data->n_q_points);
+
+  VectorizedArray<Number> divergence = this->gradients_quad[0][0][q_point];
+  for (unsigned int d=1; d<dim; ++d)
+    divergence += this->gradients_quad[d][d][q_point];
+
+  if (this->cell_type == internal::MatrixFreeFunctions::cartesian)
+    for (unsigned int d=0; d<dim; ++d)
+      divergence *= this->cartesian_data[0][d];
+  else
+    divergence *= determinant(this->cell_type == internal::MatrixFreeFunctions::general ?
+                              this->jacobian[q_point] : this->jacobian[0]);
+  return divergence;
+}
+
+
+
+template <int dim, typename Number>
+inline
+void
+FEEvaluationAccess<dim,dim,Number>
+::submit_value_contravariant_piola (const Tensor<1,dim,VectorizedArray<Number> > val_in,
+                                    const unsigned int q_point)
+{
+#ifdef DEBUG
+  Assert (this->cell != numbers::invalid_unsigned_int, ExcNotInitialized());
+  AssertIndexRange (q_point, this->data->n_q_points);
+  this->values_quad_submitted = true;
+#endif
+
+  // the determinant of the Piola transformation cancels against the one of
+  // the integration, leaving the transpose of the Jacobian times the weight
+  const VectorizedArray<Number> weight = this->quadrature_weights[q_point];
+  if (this->cell_type == internal::MatrixFreeFunctions::cartesian)
+    for (unsigned int d=0; d<dim; ++d)
+      this->values_quad[d][q_point] = val_in[d] * weight / this->cartesian_data[0][d];
+  else
+    {
+      const Tensor<2,dim,VectorizedArray<Number> > inv_jac =
+        invert(this->cell_type == internal::MatrixFreeFunctions::general ?
+               this->jacobian[q_point] : this->jacobian[0]);
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          VectorizedArray<Number> sum = inv_jac[d][0] * val_in[0];
+          for (unsigned int e=1; e<dim; ++e)
+            sum += inv_jac[d][e] * val_in[e];
+          this->values_quad[d][q_point] = sum * weight;
+        }
+    }
+}
+
+
+
+template <int dim, typename Number>
+inline
+void
+FEEvaluationAccess<dim,dim,Number>
+::submit_divergence_contravariant_piola (const VectorizedArray<Number> div_in,
+                                         const unsigned int q_point)
+{
+#ifdef DEBUG
+  Assert (this->cell != numbers::invalid_unsigned_int, ExcNotInitialized());
+  AssertIndexRange (q_point, this->data->n_q_points);
+  this->gradients_quad_submitted = true;
+#endif
+
+  const VectorizedArray<Number> fac = this->quadrature_weights[q_point] * div_in;
+  for (unsigned int d=0; d<dim; ++d)
+    for (unsigned int e=0; e<dim; ++e)
+      this->gradients_quad[d][e][q_point] = (d == e) ? fac : VectorizedArray<Number>();
+}
+
+
+/*-------------------- FEEvaluationAccess scalar for 1d ----------------------------*/
+
+
+template <typename Number>
+inline
+FEEvaluationAccess<1,1,Number>
+::FEEvaluationAccess (const MatrixFree<1,Number> &data_in,
+                      const unsigned int fe_no,
+                      const unsigned int quad_no_in,
+                      const unsigned int fe_degree,
+                      const unsigned int n_q_points)
+  :
+  FEEvaluationBase <1,1,Number>
+  (data_in, fe_no, quad_no_in, fe_degree, n_q_points)
+{}
+
+
+
+template <typename Number>
+template <int n_components_other>
+inline
+FEEvaluationAccess<1,1,Number>
+::FEEvaluationAccess (const Mapping<1>       &mapping,
                       const FiniteElement<1> &fe,
                       const Quadrature<1>    &quadrature,
                       const UpdateFlags       update_flags,
@@ -5419,6 +6101,499 @@ FEEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
 
 
 
+/*-------------------------- FEFaceEvaluation ---------------------------*/
+
+namespace internal
+{
+  // access to the components of value_type in FEFaceEvaluation, which is
+  // a plain VectorizedArray for scalar problems and a tensor otherwise
+  template <typename Number>
+  inline
+  Number &
+  value_component (Number &value,
+                   const unsigned int)
+  {
+    return value;
+  }
+
+
+
+  template <int n_components, typename Number>
+  inline
+  Number &
+  value_component (Tensor<1,n_components,Number> &value,
+                   const unsigned int             component)
+  {
+    return value[component];
+  }
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::FEFaceEvaluation (const MatrixFree<dim,Number> &matrix_free,
+                    const bool                    is_interior_face,
+                    const unsigned int            fe_no,
+                    const unsigned int            quad_no)
+  :
+  BaseClass (matrix_free, fe_no, quad_no, fe_degree, static_n_q_points_cell),
+  dofs_per_cell (this->data->dofs_per_cell),
+  n_q_points (this->data->n_q_points_face),
+  is_interior (is_interior_face),
+  face_no (numbers::invalid_unsigned_int),
+  subface_index (numbers::invalid_unsigned_int),
+  normal_vectors (nullptr)
+{
+  static_assert (fe_degree >= 0,
+                 "FEFaceEvaluation needs the polynomial degree as a "
+                 "template argument");
+  Assert (this->data->fe_degree == static_cast<unsigned int>(fe_degree) &&
+          this->data->n_q_points_1d == static_cast<unsigned int>(n_q_points_1d),
+          ExcMessage("The template arguments of FEFaceEvaluation do not match "
+                     "the degree of the finite element and the number of "
+                     "quadrature points given to MatrixFree."));
+  AssertDimension (n_q_points, static_n_q_points);
+  for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+    cell_ids[v] = numbers::invalid_unsigned_int;
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::reinit (const unsigned int face)
+{
+  Assert (this->mapping_info->face_data.size() > this->quad_no,
+          ExcMessage("The face data has not been set up in MatrixFree. Set "
+                     "the flags AdditionalData::mapping_update_flags_inner_faces "
+                     "or AdditionalData::mapping_update_flags_boundary_faces "
+                     "when initializing MatrixFree."));
+  AssertIndexRange (face, this->matrix_info->n_inner_face_batches() +
+                    this->matrix_info->n_boundary_face_batches());
+  Assert (is_interior == true || face < this->matrix_info->n_inner_face_batches(),
+          ExcMessage("The exterior side of a face can only be selected on "
+                     "inner faces."));
+
+  const internal::MatrixFreeFunctions::FaceToCellTopology<VectorizedArray<Number>::n_array_elements>
+  &face_topology = this->matrix_info->get_face_info(face);
+  const typename internal::MatrixFreeFunctions::MappingInfo<dim,Number>::FaceMappingInfoDependent
+  &face_data = this->mapping_info->face_data[this->quad_no];
+  AssertDimension (face_data.n_q_points, n_q_points);
+
+  this->cell = face;
+  this->cell_type = internal::MatrixFreeFunctions::general;
+  const unsigned int offset = face * n_q_points;
+  this->jacobian = face_data.jacobians[is_interior ? 0 : 1].begin() + offset;
+  this->J_value = face_data.JxW_values.begin() + offset;
+  normal_vectors = face_data.normal_vectors.begin() + offset;
+  this->quadrature_points = face_data.quadrature_points.size() > 0 ?
+                            face_data.quadrature_points.begin() + offset :
+                            nullptr;
+
+  if (is_interior)
+    {
+      face_no = face_topology.interior_face_no;
+      subface_index = GeometryInfo<dim>::max_children_per_cell;
+      for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+        cell_ids[v] = face_topology.cells_interior[v];
+    }
+  else
+    {
+      face_no = face_topology.exterior_face_no;
+      subface_index = face_topology.subface_index;
+      for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+        cell_ids[v] = face_topology.cells_exterior[v];
+    }
+
+#ifdef DEBUG
+  this->dof_values_initialized      = false;
+  this->values_quad_initialized     = false;
+  this->gradients_quad_initialized  = false;
+  this->hessians_quad_initialized   = false;
+  this->values_quad_submitted       = false;
+  this->gradients_quad_submitted    = false;
+#endif
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+template <typename VectorType, typename VectorOperation>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::read_write_operation_face (const VectorOperation &operation,
+                             VectorType            *src[]) const
+{
+  // This function works similarly to FEEvaluationBase::read_write_operation,
+  // but the cells adjacent to a face batch are in general not part of the
+  // same macro cell, so we process them lane by lane with the indices
+  // stored for the individual cells
+  Assert (this->dof_info != nullptr, ExcNotInitialized());
+  Assert (this->dof_info->store_indices_per_cell == true,
+          ExcMessage("The indices of the individual cells have not been "
+                     "stored in MatrixFree, which is necessary for face "
+                     "integrals."));
+  Assert (this->cell != numbers::invalid_unsigned_int, ExcNotInitialized());
+
+  const internal::MatrixFreeFunctions::DoFInfo &dof_info = *this->dof_info;
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+
+  // scalar case with one vector per component (or several components in
+  // one single vector, with all entries of the first component first)
+  const unsigned int n_vectors = this->n_fe_components == 1 ? n_components : 1;
+  const unsigned int n_local_dofs = this->n_fe_components == 1 ?
+                                    dofs_per_cell : n_components * dofs_per_cell;
+  if (this->n_fe_components == 1)
+    for (unsigned int comp=0; comp<n_components; ++comp)
+      {
+        Assert(src[comp] != nullptr,
+               ExcMessage("The finite element underlying this FEFaceEvaluation "
+                          "object is scalar, but you requested " +
+                          std::to_string(n_components) +
+                          " components via the template argument in "
+                          "FEFaceEvaluation. In that case, you must pass an "
+                          "std::vector<VectorType> or a BlockVector to " +
+                          "read_dof_values and distribute_local_to_global."));
+        internal::check_vector_compatibility (*src[comp], dof_info);
+      }
+  else
+    {
+      Assert (this->n_fe_components == n_components_, ExcNotImplemented());
+      internal::check_vector_compatibility (*src[0], dof_info);
+    }
+
+  Number *local_data = const_cast<Number *>(&this->values_dofs[0][0][0]);
+  for (unsigned int v=0; v<n_lanes; ++v)
+    {
+      if (cell_ids[v] == numbers::invalid_unsigned_int)
+        {
+          for (unsigned int i=0; i<n_components*dofs_per_cell; ++i)
+            operation.process_empty (local_data[i*n_lanes+v]);
+          continue;
+        }
+
+      AssertIndexRange (cell_ids[v]+1, dof_info.row_starts_per_cell.size());
+      const std::array<unsigned int,2> &row_start =
+        dof_info.row_starts_per_cell[cell_ids[v]];
+      const std::array<unsigned int,2> &row_end =
+        dof_info.row_starts_per_cell[cell_ids[v]+1];
+      const unsigned int *dof_indices =
+        dof_info.dof_indices_per_cell.data() + row_start[0];
+      const std::pair<unsigned short,unsigned short> *indicators =
+        dof_info.constraint_indicator_per_cell.data() + row_start[1];
+      const std::pair<unsigned short,unsigned short> *indicators_end =
+        dof_info.constraint_indicator_per_cell.data() + row_end[1];
+
+      unsigned int ind_local = 0;
+      for ( ; indicators != indicators_end; ++indicators)
+        {
+          // run through values up to next constraint
+          for (unsigned int j=0; j<indicators->first; ++j)
+            for (unsigned int comp=0; comp<n_vectors; ++comp)
+              operation.process_dof (dof_indices[j], *src[comp],
+                                     local_data[(comp*dofs_per_cell+ind_local+j)*n_lanes+v]);
+          ind_local += indicators->first;
+          dof_indices += indicators->first;
+
+          // constrained case: build the local value as a linear combination
+          // of the global value according to constraints
+          Number value [n_components];
+          for (unsigned int comp=0; comp<n_vectors; ++comp)
+            operation.pre_constraints (local_data[(comp*dofs_per_cell+ind_local)*n_lanes+v],
+                                       value[comp]);
+
+          const Number *data_val =
+            this->matrix_info->constraint_pool_begin(indicators->second);
+          const Number *end_pool =
+            this->matrix_info->constraint_pool_end(indicators->second);
+          for ( ; data_val != end_pool; ++data_val, ++dof_indices)
+            for (unsigned int comp=0; comp<n_vectors; ++comp)
+              operation.process_constraint (*dof_indices, *data_val,
+                                            *src[comp], value[comp]);
+
+          for (unsigned int comp=0; comp<n_vectors; ++comp)
+            operation.post_constraints (value[comp],
+                                        local_data[(comp*dofs_per_cell+ind_local)*n_lanes+v]);
+          ind_local++;
+        }
+
+      // get the dof values past the last constraint
+      for (; ind_local<n_local_dofs; ++dof_indices, ++ind_local)
+        for (unsigned int comp=0; comp<n_vectors; ++comp)
+          operation.process_dof (*dof_indices, *src[comp],
+                                 local_data[(comp*dofs_per_cell+ind_local)*n_lanes+v]);
+      Assert (dof_indices == dof_info.dof_indices_per_cell.data() + row_end[0],
+              ExcInternalError());
+    }
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+template <typename VectorType>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::read_dof_values (const VectorType  &src,
+                   const unsigned int first_index)
+{
+  typename internal::BlockVectorSelector<VectorType,
+           IsBlockVector<VectorType>::value>::BaseVectorType *src_data[n_components];
+  for (unsigned int d=0; d<n_components; ++d)
+    src_data[d] = internal::BlockVectorSelector<VectorType, IsBlockVector<VectorType>::value>::get_vector_component(const_cast<VectorType &>(src), d+first_index);
+
+  internal::VectorReader<Number> reader;
+  read_write_operation_face (reader, src_data);
+
+#ifdef DEBUG
+  this->dof_values_initialized = true;
+#endif
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+template <typename VectorType>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::distribute_local_to_global (VectorType        &dst,
+                              const unsigned int first_index) const
+{
+  Assert (this->dof_values_initialized==true,
+          internal::ExcAccessToUninitializedField());
+
+  typename internal::BlockVectorSelector<VectorType,
+           IsBlockVector<VectorType>::value>::BaseVectorType *dst_data[n_components];
+  for (unsigned int d=0; d<n_components; ++d)
+    dst_data[d] = internal::BlockVectorSelector<VectorType, IsBlockVector<VectorType>::value>::get_vector_component(dst, d+first_index);
+
+  internal::VectorDistributorLocalToGlobal<Number> distributor;
+  read_write_operation_face (distributor, dst_data);
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+template <typename VectorType>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::set_dof_values (VectorType        &dst,
+                  const unsigned int first_index) const
+{
+  Assert (this->dof_values_initialized==true,
+          internal::ExcAccessToUninitializedField());
+
+  typename internal::BlockVectorSelector<VectorType,
+           IsBlockVector<VectorType>::value>::BaseVectorType *dst_data[n_components];
+  for (unsigned int d=0; d<n_components; ++d)
+    dst_data[d] = internal::BlockVectorSelector<VectorType, IsBlockVector<VectorType>::value>::get_vector_component(dst, d+first_index);
+
+  internal::VectorSetter<Number> setter;
+  read_write_operation_face (setter, dst_data);
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::evaluate (const bool evaluate_values,
+            const bool evaluate_gradients)
+{
+  Assert (this->dof_values_initialized == true,
+          internal::ExcAccessToUninitializedField());
+  Assert (face_no != numbers::invalid_unsigned_int, ExcNotInitialized());
+
+  internal::FEFaceEvaluationImpl<dim, fe_degree, n_q_points_1d, n_components, Number>
+  ::evaluate (*this->data, &this->values_dofs[0], this->values_quad,
+              this->gradients_quad, this->scratch_data,
+              evaluate_values, evaluate_gradients, face_no, subface_index);
+
+#ifdef DEBUG
+  if (evaluate_values == true)
+    this->values_quad_initialized = true;
+  if (evaluate_gradients == true)
+    this->gradients_quad_initialized = true;
+#endif
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::integrate (const bool integrate_values,
+             const bool integrate_gradients)
+{
+  if (integrate_values == true)
+    Assert (this->values_quad_submitted == true,
+            internal::ExcAccessToUninitializedField());
+  if (integrate_gradients == true)
+    Assert (this->gradients_quad_submitted == true,
+            internal::ExcAccessToUninitializedField());
+  Assert (face_no != numbers::invalid_unsigned_int, ExcNotInitialized());
+
+  internal::FEFaceEvaluationImpl<dim, fe_degree, n_q_points_1d, n_components, Number>
+  ::integrate (*this->data, &this->values_dofs[0], this->values_quad,
+               this->gradients_quad, this->scratch_data,
+               integrate_values, integrate_gradients, face_no, subface_index);
+
+#ifdef DEBUG
+  this->dof_values_initialized = true;
+#endif
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+Point<dim,VectorizedArray<Number> >
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::quadrature_point (const unsigned int q) const
+{
+  Assert (this->quadrature_points != nullptr,
+          ExcMessage("The quadrature points on faces have not been set up. "
+                     "Set the flag update_quadrature_points in the face "
+                     "flags of MatrixFree::AdditionalData."));
+  AssertIndexRange (q, n_q_points);
+  return this->quadrature_points[q];
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+Tensor<1,dim,VectorizedArray<Number> >
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_normal_vector (const unsigned int q) const
+{
+  Assert (normal_vectors != nullptr, ExcNotInitialized());
+  AssertIndexRange (q, n_q_points);
+  if (is_interior)
+    return normal_vectors[q];
+  else
+    return -normal_vectors[q];
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+typename FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::value_type
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_normal_derivative (const unsigned int q) const
+{
+  Assert (this->gradients_quad_initialized==true,
+          internal::ExcAccessToUninitializedField());
+  AssertIndexRange (q, n_q_points);
+
+  // compute the normal derivative as normal^T J^{-T} grad_unit(u), where the
+  // first product can be shared among the components
+  const Tensor<1,dim,VectorizedArray<Number> > normal = get_normal_vector(q);
+  const Tensor<2,dim,VectorizedArray<Number> > &jac = this->jacobian[q];
+  VectorizedArray<Number> normal_times_jac[dim];
+  for (unsigned int e=0; e<dim; ++e)
+    {
+      normal_times_jac[e] = normal[0] * jac[0][e];
+      for (unsigned int d=1; d<dim; ++d)
+        normal_times_jac[e] += normal[d] * jac[d][e];
+    }
+
+  value_type result;
+  for (unsigned int comp=0; comp<n_components; ++comp)
+    {
+      VectorizedArray<Number> value = normal_times_jac[0] *
+                                      this->gradients_quad[comp][0][q];
+      for (unsigned int e=1; e<dim; ++e)
+        value += normal_times_jac[e] * this->gradients_quad[comp][e][q];
+      internal::value_component(result, comp) = value;
+    }
+  return result;
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::submit_normal_derivative (const value_type   grad_in,
+                            const unsigned int q)
+{
+#ifdef DEBUG
+  Assert (this->cell != numbers::invalid_unsigned_int, ExcNotInitialized());
+  AssertIndexRange (q, n_q_points);
+  this->gradients_quad_submitted = true;
+#endif
+
+  const Tensor<1,dim,VectorizedArray<Number> > normal = get_normal_vector(q);
+  const Tensor<2,dim,VectorizedArray<Number> > &jac = this->jacobian[q];
+  VectorizedArray<Number> normal_times_jac[dim];
+  for (unsigned int e=0; e<dim; ++e)
+    {
+      normal_times_jac[e] = normal[0] * jac[0][e];
+      for (unsigned int d=1; d<dim; ++d)
+        normal_times_jac[e] += normal[d] * jac[d][e];
+    }
+
+  value_type value = grad_in;
+  for (unsigned int comp=0; comp<n_components; ++comp)
+    {
+      const VectorizedArray<Number> factor =
+        internal::value_component(value, comp) * this->J_value[q];
+      for (unsigned int e=0; e<dim; ++e)
+        this->gradients_quad[comp][e][q] = normal_times_jac[e] * factor;
+    }
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+bool
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::is_interior_face () const
+{
+  return is_interior;
+}
+
+
+
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+unsigned int
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_face_no () const
+{
+  return face_no;
+}
+
+
+
 #endif  // ifndef DOXYGEN
 
 
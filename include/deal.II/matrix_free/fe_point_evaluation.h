@@ -0,0 +1,268 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_fe_point_evaluation_h
+#define dealii_fe_point_evaluation_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/polynomial.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/grid/tria.h>
+
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/**
+ * This class evaluates a finite element field at an arbitrary set of points
+ * inside a cell, given by their coordinates on the reference cell, and
+ * performs the transposed operation of testing values and gradients given
+ * at these points by all shape functions of the cell. A typical application
+ * are particle methods, where the velocity field is evaluated at the
+ * location of the particles of a cell, or the particle properties are
+ * deposited onto the mesh.
+ *
+ * As opposed to FEValues with a Quadrature object made of the points, this
+ * class does not need to be set up anew for every cell, and it evaluates
+ * the shape functions in a tensor-product fashion: for each point, the
+ * $k+1$ one-dimensional shape functions of degree $k$ are evaluated along
+ * every coordinate direction, and the coefficients of the field are then
+ * contracted one direction after the other in the sum-factorization style
+ * of FEEvaluation. This costs $\mathcal O(k^d)$ operations per point and
+ * component for values and gradients together, instead of $\mathcal
+ * O(k^{d+1})$ for the evaluation of all $(k+1)^d$ shape functions.
+ *
+ * The class works for elements whose shape functions are tensor products of
+ * one-dimensional Lagrange polynomials, i.e., FE_Q, FE_DGQ, and
+ * FE_DGQArbitraryNodes, as well as FESystem objects built from a single one
+ * of these elements. The coefficients passed to evaluate() and returned by
+ * integrate() use the numbering of the degrees of freedom of the finite
+ * element, i.e., the ordering returned by
+ * DoFCellAccessor::get_dof_values().
+ *
+ * The gradients are transformed to real space with the Jacobian of the
+ * bi-/trilinear map defined by the vertices of the cell, i.e., the
+ * geometry described by MappingQ1.
+ */
+template <int dim>
+class FEPointEvaluation
+{
+public:
+  /**
+   * Constructor. Extracts the one-dimensional polynomials and the
+   * lexicographic numbering of the shape functions from the given element.
+   */
+  FEPointEvaluation (const FiniteElement<dim> &fe);
+
+  /**
+   * Set up the evaluation for the points with reference coordinates @p
+   * unit_points in the cell @p cell. This evaluates the one-dimensional
+   * shape functions at the points and computes the inverse Jacobians used
+   * to transform gradients.
+   */
+  void reinit (const typename Triangulation<dim>::cell_iterator &cell,
+               const ArrayView<const Point<dim> >             &unit_points);
+
+  /**
+   * Evaluate the finite element field with the coefficients @p dof_values
+   * at the points given to reinit(). The values and the gradients (in real
+   * space) can then be queried by value() and gradient().
+   */
+  void evaluate (const ArrayView<const double> &dof_values,
+                 const bool                     evaluate_values,
+                 const bool                     evaluate_gradients);
+
+  /**
+   * Test the values and gradients set by submit_value() and
+   * submit_gradient() by all shape functions of the element and write the
+   * result into @p dof_values, i.e., compute $\sum_q \varphi_i(x_q) v_q +
+   * \nabla \varphi_i(x_q) \cdot g_q$ for all shape functions $\varphi_i$.
+   * The previous content of @p dof_values is overwritten.
+   */
+  void integrate (const ArrayView<double> &dof_values,
+                  const bool               integrate_values,
+                  const bool               integrate_gradients);
+
+  /**
+   * Return the value of the given component at the point with index @p
+   * point after a call to evaluate().
+   */
+  double value (const unsigned int point,
+                const unsigned int component = 0) const;
+
+  /**
+   * Return the gradient in real space of the given component at the point
+   * with index @p point after a call to evaluate().
+   */
+  const Tensor<1,dim> &gradient (const unsigned int point,
+                                 const unsigned int component = 0) const;
+
+  /**
+   * Set the value of the given component at the point with index @p point
+   * that is tested by integrate().
+   */
+  void submit_value (const double       value,
+                     const unsigned int point,
+                     const unsigned int component = 0);
+
+  /**
+   * Set the gradient in real space of the given component at the point with
+   * index @p point that is tested by integrate().
+   */
+  void submit_gradient (const Tensor<1,dim> &gradient,
+                        const unsigned int   point,
+                        const unsigned int   component = 0);
+
+  /**
+   * Return the number of points given to the last call of reinit().
+   */
+  unsigned int n_points () const;
+
+private:
+  /**
+   * The number of vector components of the element.
+   */
+  const unsigned int n_components;
+
+  /**
+   * The number of one-dimensional shape functions, i.e., the polynomial
+   * degree plus one.
+   */
+  const unsigned int n_shapes_1d;
+
+  /**
+   * The number of degrees of freedom of the element.
+   */
+  const unsigned int dofs_per_cell;
+
+  /**
+   * The one-dimensional Lagrange polynomials the shape functions are
+   * tensor products of, in lexicographic order.
+   */
+  std::vector<Polynomials::Polynomial<double> > polynomials_1d;
+
+  /**
+   * For each component and each shape function in lexicographic order, the
+   * index of the shape function in the numbering of the element.
+   */
+  std::vector<unsigned int> lexicographic_numbering;
+
+  /**
+   * The values and first derivatives of the one-dimensional shape
+   * functions at the coordinates of the points. The entry with index
+   * <tt>((point*dim + d)*n_shapes_1d + i)*2 + derivative</tt> refers to
+   * the derivative of order @p derivative of polynomial @p i evaluated at
+   * the coordinate @p d of the point.
+   */
+  std::vector<double> shapes;
+
+  /**
+   * The transpose of the inverse Jacobian of the geometry at each point.
+   */
+  std::vector<Tensor<2,dim> > inverse_jacobians_transposed;
+
+  /**
+   * The values at the points, with the component running fastest.
+   */
+  std::vector<double> values;
+
+  /**
+   * The gradients at the points, with the component running fastest.
+   */
+  std::vector<Tensor<1,dim> > gradients;
+
+  /**
+   * Temporary storage for the coefficients in lexicographic order.
+   */
+  std::vector<double> lexicographic_values;
+};
+
+
+/*----------------------- Inline functions ----------------------------------*/
+
+#ifndef DOXYGEN
+
+template <int dim>
+inline
+double
+FEPointEvaluation<dim>::value (const unsigned int point,
+                               const unsigned int component) const
+{
+  AssertIndexRange (point*n_components+component, values.size());
+  return values[point*n_components+component];
+}
+
+
+
+template <int dim>
+inline
+const Tensor<1,dim> &
+FEPointEvaluation<dim>::gradient (const unsigned int point,
+                                  const unsigned int component) const
+{
+  AssertIndexRange (point*n_components+component, gradients.size());
+  return gradients[point*n_components+component];
+}
+
+
+
+template <int dim>
+inline
+void
+FEPointEvaluation<dim>::submit_value (const double       value,
+                                      const unsigned int point,
+                                      const unsigned int component)
+{
+  AssertIndexRange (point*n_components+component, values.size());
+  values[point*n_components+component] = value;
+}
+
+
+
+template <int dim>
+inline
+void
+FEPointEvaluation<dim>::submit_gradient (const Tensor<1,dim> &gradient,
+                                         const unsigned int   point,
+                                         const unsigned int   component)
+{
+  AssertIndexRange (point*n_components+component, gradients.size());
+  gradients[point*n_components+component] = gradient;
+}
+
+
+
+template <int dim>
+inline
+unsigned int
+FEPointEvaluation<dim>::n_points () const
+{
+  return inverse_jacobians_transposed.size();
+}
+
+#endif // ifndef DOXYGEN
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
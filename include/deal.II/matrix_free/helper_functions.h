@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2011 - 2016 by the deal.II authors
+// Copyright (C) 2011 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -62,6 +62,7 @@ namespace internal
       bool use_multithreading;
       bool use_partition_partition;
       bool use_coloring_only;
+      bool use_dependency_graph;
 
       std::vector<unsigned int> partition_color_blocks_row_index;
       std::vector<unsigned int> partition_color_blocks_data;
@@ -74,6 +75,24 @@ namespace internal
       std::vector<unsigned int> partition_odds;
       std::vector<unsigned int> partition_n_blocked_workers;
       std::vector<unsigned int> partition_n_workers;
+
+      /**
+       * For the scheduling by a dependency graph: the blocks with a larger
+       * index that share degrees of freedom with a block, stored in a
+       * compressed row format with the row starts in
+       * block_successors_row_index, and the number of blocks with a smaller
+       * index each block must wait for.
+       */
+      std::vector<unsigned int> block_successors_row_index;
+      std::vector<unsigned int> block_successors;
+      std::vector<unsigned int> block_n_predecessors;
+
+      /**
+       * The number of blocks at the beginning of the block list that contain
+       * cells with ghost degrees of freedom and thus must wait for the ghost
+       * exchange of the source vector.
+       */
+      unsigned int n_boundary_blocks;
     };
 
 
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2011 - 2016 by the deal.II authors
+// Copyright (C) 2011 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -25,6 +25,7 @@
 #include <deal.II/fe/fe.h>
 #include <deal.II/fe/mapping.h>
 #include <deal.II/matrix_free/helper_functions.h>
+#include <deal.II/matrix_free/face_info.h>
 
 #include <memory>
 
@@ -75,13 +76,48 @@ namespace internal
        * for different kinds of iterators, e.g. standard DoFHandler,
        * multigrid, etc.)  on a fixed Triangulation. In addition, a mapping
        * and several quadrature formulas are given.
+       *
+       * If @p store_mapping_support_points is set, the general cells do not
+       * store the inverse Jacobians and JxW values on the quadrature points,
+       * but only the support points of the mapping, from which
+       * FEEvaluation computes the Jacobians on the fly. This needs a mapping
+       * of type MappingQGeneric or MappingQ and is not available together
+       * with second derivatives.
        */
       void initialize (const dealii::Triangulation<dim>                &tria,
                        const std::vector<std::pair<unsigned int,unsigned int> > &cells,
                        const std::vector<unsigned int>         &active_fe_index,
                        const Mapping<dim>                      &mapping,
                        const std::vector<dealii::hp::QCollection<1> >  &quad,
-                       const UpdateFlags                        update_flags);
+                       const UpdateFlags                        update_flags,
+                       const bool                               store_mapping_support_points = false);
+
+      /**
+       * Compute the information on the faces collected in @p face_info, using
+       * the cells given in @p cells (in the MatrixFree numbering used for the
+       * entries in @p face_info). As for the cells, the data is computed for
+       * all quadrature formulas in @p quad, where only the first formula of
+       * each hp::QCollection is used. Needs to be called after initialize().
+       */
+      void initialize_faces (const dealii::Triangulation<dim>                &tria,
+                             const std::vector<std::pair<unsigned int,unsigned int> > &cells,
+                             const FaceInfo<VectorizedArray<Number>::n_array_elements> &face_info,
+                             const Mapping<dim>                      &mapping,
+                             const std::vector<dealii::hp::QCollection<1> >  &quad,
+                             const UpdateFlags                        update_flags_faces);
+
+      /**
+       * Recompute the information on the cells and faces with a new
+       * mapping, e.g. after the mesh has moved in an ALE setting, keeping
+       * the quadrature formulas and update flags of the last calls to
+       * initialize() and initialize_faces(). The cells and the faces must be
+       * the same as in these calls.
+       */
+      void update_mapping (const dealii::Triangulation<dim>                          &tria,
+                           const std::vector<std::pair<unsigned int,unsigned int> >  &cells,
+                           const std::vector<unsigned int>                           &active_fe_index,
+                           const FaceInfo<VectorizedArray<Number>::n_array_elements> &face_info,
+                           const Mapping<dim>                                        &mapping);
 
       /**
        * Helper function to determine which update flags must be set in the
@@ -92,6 +128,27 @@ namespace internal
                             const std::vector<dealii::hp::QCollection<1> >  &quad =
                               std::vector<dealii::hp::QCollection<1> >());
 
+      /**
+       * Return the polynomial degree of @p mapping if it is described by the
+       * position of support points in a tensor product, i.e., for
+       * MappingQGeneric and MappingQ, and numbers::invalid_unsigned_int
+       * otherwise.
+       */
+      static unsigned int
+      get_mapping_degree (const Mapping<dim> &mapping);
+
+      /**
+       * Heuristic to decide whether it pays off to store the support points
+       * of the mapping instead of the Jacobians for general cells: This is
+       * the case if the mapping supports it, no second derivatives are
+       * requested, and the support points take at most half of the memory of
+       * the inverse Jacobians and JxW values for all quadrature formulas.
+       */
+      static bool
+      use_mapping_support_points (const Mapping<dim>                             &mapping,
+                                  const std::vector<dealii::hp::QCollection<1> > &quad,
+                                  const UpdateFlags                               update_flags);
+
       /**
        * Return the type of a given cell as detected during initialization.
        */
@@ -160,6 +217,24 @@ namespace internal
       AlignedVector<std::pair<Tensor<2,dim,VectorizedArray<Number> >,
                     VectorizedArray<Number> > > affine_data;
 
+      /**
+       * The polynomial degree of the mapping if the support points of the
+       * mapping are stored for general cells instead of the Jacobians, and
+       * numbers::invalid_unsigned_int otherwise.
+       */
+      unsigned int mapping_degree;
+
+      /**
+       * The support points of the mapping on general cells if @p
+       * mapping_degree is set, in the lexicographic numbering of the
+       * tensor product of (mapping_degree+1) Gauss-Lobatto points. The data
+       * of the general cell with data index @p i starts at position
+       * <code>i*dim*(mapping_degree+1)^dim</code>, with all points of the
+       * first coordinate coming first, then the second coordinate, and so
+       * on.
+       */
+      AlignedVector<VectorizedArray<Number> > mapping_support_points;
+
       /**
        * Definition of a structure that stores data that depends on the
        * quadrature formula (if we have more than one quadrature formula on a
@@ -208,6 +283,21 @@ namespace internal
         AlignedVector<Tensor<1,(dim>1?dim*(dim-1)/2:1),
                       Tensor<1,dim,VectorizedArray<Number> > > > jacobians_grad_upper;
 
+        /**
+         * The values of the 1D Lagrange polynomials on the support points of
+         * the mapping evaluated at the 1D quadrature points, for all
+         * quadrature formulas in the hp case. The data is laid out as in
+         * ShapeInfo::shape_values and only set if the support points of the
+         * mapping are stored.
+         */
+        std::vector<AlignedVector<VectorizedArray<Number> > > mapping_shape_values;
+
+        /**
+         * The derivatives of the 1D Lagrange polynomials on the support points
+         * of the mapping, in the same format as @p mapping_shape_values.
+         */
+        std::vector<AlignedVector<VectorizedArray<Number> > > mapping_shape_gradients;
+
         /**
          * Stores the row start for quadrature points in real coordinates for
          * both types of cells. Note that Cartesian cells will have shorter
@@ -289,6 +379,82 @@ namespace internal
        */
       std::vector<MappingInfoDependent> mapping_data_gen;
 
+      /**
+       * Definition of a structure that stores the data on the faces for a
+       * given quadrature formula. As opposed to the cells, no compression of
+       * Cartesian or affine geometries is done and all data is stored for
+       * each quadrature point of each face batch, with the face batch @p f
+       * starting at position <code>f*n_q_points</code>.
+       */
+      struct FaceMappingInfoDependent
+      {
+        /**
+         * The number of quadrature points on a face.
+         */
+        unsigned int n_q_points;
+
+        /**
+         * The Jacobian determinant on the face (ratio between the surface
+         * elements on the real and the unit face) times the quadrature
+         * weight.
+         */
+        AlignedVector<VectorizedArray<Number> > JxW_values;
+
+        /**
+         * The outer unit normal vectors of the cells on the interior side of
+         * the face.
+         */
+        AlignedVector<Tensor<1,dim,VectorizedArray<Number> > > normal_vectors;
+
+        /**
+         * The inverse Jacobians of the cells on the interior side (index 0)
+         * and the exterior side (index 1) of the faces, in the same format as
+         * MappingInfoDependent::jacobians. The data for the exterior side is
+         * only stored for inner faces, which are placed before the boundary
+         * faces.
+         */
+        AlignedVector<Tensor<2,dim,VectorizedArray<Number> > > jacobians[2];
+
+        /**
+         * The quadrature points in real coordinates. Only filled if the
+         * update flags for the faces contain @p update_quadrature_points.
+         */
+        AlignedVector<Point<dim,VectorizedArray<Number> > > quadrature_points;
+
+        /**
+         * Return the memory consumption in bytes.
+         */
+        std::size_t memory_consumption () const;
+      };
+
+      /**
+       * Contains the data on faces for all quadrature formulas.
+       */
+      std::vector<FaceMappingInfoDependent> face_data;
+
+      /**
+       * The quadrature formulas passed to the last call to initialize(), as
+       * needed by update_mapping().
+       */
+      std::vector<dealii::hp::QCollection<1> > quadrature_1d;
+
+      /**
+       * The update flags passed to the last call to initialize().
+       */
+      UpdateFlags update_flags_cells;
+
+      /**
+       * The update flags passed to the last call to initialize_faces(), or
+       * update_default if the faces have not been initialized.
+       */
+      UpdateFlags update_flags_faces;
+
+      /**
+       * Stores whether the last call to initialize() stored the support
+       * points of the mapping rather than the Jacobians on general cells.
+       */
+      bool store_mapping_support_points;
+
       /**
        * Stores whether JxW values have been initialized
        */
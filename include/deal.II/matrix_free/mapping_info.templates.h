@@ -18,8 +18,11 @@
 
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/polynomial.h>
+#include <deal.II/base/quadrature_lib.h>
 #include <deal.II/fe/fe_nothing.h>
 #include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q.h>
 #include <deal.II/fe/mapping_q1.h>
 
 #include <deal.II/matrix_free/mapping_info.h>
@@ -37,6 +40,10 @@ namespace internal
     template <int dim, typename Number>
     MappingInfo<dim,Number>::MappingInfo()
       :
+      mapping_degree (numbers::invalid_unsigned_int),
+      update_flags_cells (update_default),
+      update_flags_faces (update_default),
+      store_mapping_support_points (false),
       JxW_values_initialized (false),
       second_derivatives_initialized (false),
       quadrature_points_initialized (false)
@@ -52,9 +59,56 @@ namespace internal
       quadrature_points_initialized = false;
       second_derivatives_initialized = false;
       mapping_data_gen.clear();
+      face_data.clear();
       cell_type.clear();
       cartesian_data.clear();
       affine_data.clear();
+      mapping_degree = numbers::invalid_unsigned_int;
+      mapping_support_points.clear();
+      quadrature_1d.clear();
+      update_flags_cells = update_default;
+      update_flags_faces = update_default;
+      store_mapping_support_points = false;
+    }
+
+
+
+    template <int dim, typename Number>
+    unsigned int
+    MappingInfo<dim,Number>::get_mapping_degree (const Mapping<dim> &mapping)
+    {
+      if (const MappingQGeneric<dim> *mapping_q_generic =
+            dynamic_cast<const MappingQGeneric<dim> *>(&mapping))
+        return mapping_q_generic->get_degree();
+      else if (const MappingQ<dim> *mapping_q =
+                 dynamic_cast<const MappingQ<dim> *>(&mapping))
+        return mapping_q->get_degree();
+      else
+        return numbers::invalid_unsigned_int;
+    }
+
+
+
+    template <int dim, typename Number>
+    bool
+    MappingInfo<dim,Number>::use_mapping_support_points
+    (const Mapping<dim>                             &mapping,
+     const std::vector<dealii::hp::QCollection<1> > &quad,
+     const UpdateFlags                               update_flags)
+    {
+      const unsigned int degree = get_mapping_degree(mapping);
+      if (degree == numbers::invalid_unsigned_int ||
+          (compute_update_flags(update_flags, quad) & update_jacobian_grads))
+        return false;
+
+      // compare the storage of the support points with the one of the
+      // inverse Jacobians plus JxW values
+      const unsigned int size_points = dim * Utilities::fixed_power<dim>(degree+1);
+      for (unsigned int my_q=0; my_q<quad.size(); ++my_q)
+        for (unsigned int q=0; q<quad[my_q].size(); ++q)
+          if (2*size_points > (dim*dim+1)*Utilities::fixed_power<dim>(quad[my_q][q].size()))
+            return false;
+      return true;
     }
 
 
@@ -133,9 +187,13 @@ namespace internal
      const std::vector<unsigned int>                          &active_fe_index,
      const Mapping<dim>                                       &mapping,
      const std::vector<dealii::hp::QCollection<1> >           &quad,
-     const UpdateFlags                                         update_flags_input)
+     const UpdateFlags                                         update_flags_input,
+     const bool                                                store_support_points)
     {
       clear();
+      quadrature_1d = quad;
+      update_flags_cells = update_flags_input;
+      store_mapping_support_points = store_support_points;
       const unsigned int n_quads = quad.size();
       const unsigned int n_cells = cells.size();
       const unsigned int vectorization_length =
@@ -158,6 +216,33 @@ namespace internal
       if (update_flags & update_quadrature_points)
         quadrature_points_initialized = true;
 
+      // set up the evaluation of the support points of the mapping on a
+      // tensor product of Gauss-Lobatto points, which represents the
+      // polynomial mapping exactly
+      std::shared_ptr<dealii::FEValues<dim> > fe_values_support_points;
+      std::vector<Polynomials::Polynomial<double> > mapping_polynomials;
+      if (store_mapping_support_points)
+        {
+          mapping_degree = get_mapping_degree(mapping);
+          AssertThrow(mapping_degree != numbers::invalid_unsigned_int,
+                      ExcMessage("Storing the support points of the mapping in "
+                                 "MatrixFree requires a mapping of type "
+                                 "MappingQGeneric or MappingQ."));
+          AssertThrow((update_flags & update_jacobian_grads) == 0,
+                      ExcMessage("Storing the support points of the mapping in "
+                                 "MatrixFree is not possible together with "
+                                 "second derivatives."));
+          const QGaussLobatto<1> support_points_1d(mapping_degree+1);
+          fe_values_support_points.reset
+          (new dealii::FEValues<dim> (mapping, dummy_fe,
+                                      Quadrature<dim>(support_points_1d),
+                                      update_quadrature_points));
+          mapping_polynomials =
+            Polynomials::generate_complete_Lagrange_basis(support_points_1d.get_points());
+        }
+      const unsigned int n_mapping_points = store_mapping_support_points ?
+                                            Utilities::fixed_power<dim>(mapping_degree+1) : 0;
+
       // when we make comparisons about the size of Jacobians we need to know
       // the approximate size of typical entries in Jacobians. We need to fix
       // the Jacobian size once and for all. We choose the diameter of the
@@ -208,6 +293,29 @@ namespace internal
               if (n_hp_quads > 1)
                 current_data.quad_index_conversion[q] = n_q_points;
 
+              // values and derivatives of the polynomials of the mapping at
+              // the 1D quadrature points
+              if (store_mapping_support_points)
+                {
+                  current_data.mapping_shape_values.resize(n_hp_quads);
+                  current_data.mapping_shape_gradients.resize(n_hp_quads);
+                  AlignedVector<VectorizedArray<Number> > &values =
+                    current_data.mapping_shape_values[q];
+                  AlignedVector<VectorizedArray<Number> > &gradients =
+                    current_data.mapping_shape_gradients[q];
+                  values.resize((mapping_degree+1)*n_q_points_1d[q]);
+                  gradients.resize((mapping_degree+1)*n_q_points_1d[q]);
+                  std::vector<double> value_and_derivative(2);
+                  for (unsigned int i=0; i<=mapping_degree; ++i)
+                    for (unsigned int k=0; k<n_q_points_1d[q]; ++k)
+                      {
+                        mapping_polynomials[i].value(quad[my_q][q].point(k)[0],
+                                                     value_and_derivative);
+                        values[i*n_q_points_1d[q]+k] = value_and_derivative[0];
+                        gradients[i*n_q_points_1d[q]+k] = value_and_derivative[1];
+                      }
+                }
+
               // To walk on the diagonal for lexicographic ordering, we have
               // to jump one index ahead in each direction. For direction 0,
               // this is just the next point, for direction 1, it means adding
@@ -381,7 +489,29 @@ namespace internal
                     {
                       Assert (most_general_type == general, ExcInternalError());
                       insert_position = current_data.rowstart_jacobians.size();
-                      if (current_data.rowstart_jacobians.size() == 0)
+
+                      // only the support points of the mapping are stored,
+                      // in the vectorized layout
+                      if (store_mapping_support_points)
+                        {
+                          Assert(mapping_support_points.size() ==
+                                 insert_position*dim*n_mapping_points,
+                                 ExcInternalError());
+                          const unsigned int old_size = mapping_support_points.size();
+                          mapping_support_points.resize(old_size + dim*n_mapping_points);
+                          for (unsigned int j=0; j<vectorization_length; ++j)
+                            {
+                              typename dealii::Triangulation<dim>::cell_iterator
+                              cell_it (&tria, cells[cell*vectorization_length+j].first,
+                                       cells[cell*vectorization_length+j].second);
+                              fe_values_support_points->reinit(cell_it);
+                              for (unsigned int d=0; d<dim; ++d)
+                                for (unsigned int i=0; i<n_mapping_points; ++i)
+                                  mapping_support_points[old_size+d*n_mapping_points+i][j] =
+                                    fe_values_support_points->quadrature_point(i)[d];
+                            }
+                        }
+                      else if (current_data.rowstart_jacobians.size() == 0)
                         {
                           unsigned int reserve_size = (n_macro_cells-cell+1)/2;
                           current_data.rowstart_jacobians.reserve
@@ -405,8 +535,12 @@ namespace internal
 
               // general cell case: now go through all quadrature points and
               // collect the data. done for all different quadrature formulas,
-              // so do it outside the above loop.
-              if (get_cell_type(cell) == general)
+              // so do it outside the above loop. If the support points of the
+              // mapping are stored, we only need to keep track of the index
+              // of the general cell.
+              if (get_cell_type(cell) == general && store_mapping_support_points)
+                current_data.rowstart_jacobians.push_back (0);
+              else if (get_cell_type(cell) == general)
                 {
                   const unsigned int previous_size =
                     current_data.jacobians.size();
@@ -603,6 +737,167 @@ namespace internal
 
 
 
+    template <int dim, typename Number>
+    void
+    MappingInfo<dim,Number>::initialize_faces
+    (const dealii::Triangulation<dim>                                &tria,
+     const std::vector<std::pair<unsigned int,unsigned int> >        &cells,
+     const FaceInfo<VectorizedArray<Number>::n_array_elements>       &face_info,
+     const Mapping<dim>                                              &mapping,
+     const std::vector<dealii::hp::QCollection<1> >                  &quad,
+     const UpdateFlags                                                update_flags_faces)
+    {
+      const unsigned int vectorization_length =
+        VectorizedArray<Number>::n_array_elements;
+      const unsigned int n_faces = face_info.faces.size();
+      const unsigned int n_inner_faces = face_info.n_inner_face_batches;
+      face_data.clear();
+      face_data.resize(quad.size());
+      this->update_flags_faces = update_flags_faces;
+
+      // as for the cells, use a dummy FE to only evaluate the mapping. The
+      // quadrature points are always computed in order to check that the
+      // points on the two sides of inner faces match
+      FE_Nothing<dim> dummy_fe;
+      const UpdateFlags update_flags = update_jacobians | update_JxW_values |
+                                       update_normal_vectors |
+                                       update_quadrature_points;
+      const bool store_quadrature_points = update_flags_faces & update_quadrature_points;
+      const double tolerance = 1e-10 * internal::get_jacobian_size(tria);
+
+      for (unsigned int my_q=0; my_q<quad.size(); ++my_q)
+        {
+          FaceMappingInfoDependent &current_data = face_data[my_q];
+          const Quadrature<dim-1> quadrature (quad[my_q][0]);
+          const unsigned int n_q_points = quadrature.size();
+          current_data.n_q_points = n_q_points;
+          current_data.JxW_values.resize(n_faces*n_q_points);
+          current_data.normal_vectors.resize(n_faces*n_q_points);
+          current_data.jacobians[0].resize(n_faces*n_q_points);
+          current_data.jacobians[1].resize(n_inner_faces*n_q_points);
+          if (store_quadrature_points)
+            current_data.quadrature_points.resize(n_faces*n_q_points);
+
+          FEFaceValues<dim> fe_face_values (mapping, dummy_fe, quadrature,
+                                            update_flags);
+          FEFaceValues<dim> fe_face_values_exterior (mapping, dummy_fe, quadrature,
+                                                     update_jacobians |
+                                                     update_quadrature_points);
+          FESubfaceValues<dim> fe_subface_values_exterior (mapping, dummy_fe, quadrature,
+                                                           update_jacobians |
+                                                           update_quadrature_points);
+
+          for (unsigned int face=0; face<n_faces; ++face)
+            {
+              const FaceToCellTopology<vectorization_length> &face_topology =
+                face_info.faces[face];
+              for (unsigned int v=0; v<vectorization_length; ++v)
+                {
+                  // fill the unused lanes with the data of the first face in
+                  // order to avoid invalid numbers in the computations
+                  const unsigned int lane = v < face_topology.n_filled_lanes ? v : 0;
+                  const unsigned int cell_index = face_topology.cells_interior[lane];
+                  typename dealii::Triangulation<dim>::cell_iterator
+                  cell (&tria, cells[cell_index].first, cells[cell_index].second);
+                  fe_face_values.reinit(cell, face_topology.interior_face_no);
+
+                  for (unsigned int q=0; q<n_q_points; ++q)
+                    {
+                      const unsigned int index = face*n_q_points+q;
+                      current_data.JxW_values[index][v] = fe_face_values.JxW(q);
+                      Tensor<2,dim> jac;
+                      for (unsigned int d=0; d<dim; ++d)
+                        {
+                          current_data.normal_vectors[index][d][v] =
+                            fe_face_values.normal_vector(q)[d];
+                          for (unsigned int e=0; e<dim; ++e)
+                            jac[d][e] = fe_face_values.jacobian(q)[d][e];
+                        }
+                      const Tensor<2,dim> inv_jac = transpose(invert(jac));
+                      for (unsigned int d=0; d<dim; ++d)
+                        for (unsigned int e=0; e<dim; ++e)
+                          current_data.jacobians[0][index][d][e][v] = inv_jac[d][e];
+                      if (store_quadrature_points)
+                        for (unsigned int d=0; d<dim; ++d)
+                          current_data.quadrature_points[index][d][v] =
+                            fe_face_values.quadrature_point(q)[d];
+                    }
+
+                  if (face >= n_inner_faces)
+                    continue;
+
+                  const unsigned int cell_index_ext = face_topology.cells_exterior[lane];
+                  typename dealii::Triangulation<dim>::cell_iterator
+                  cell_ext (&tria, cells[cell_index_ext].first, cells[cell_index_ext].second);
+                  const FEValuesBase<dim> *fe_values_exterior = nullptr;
+                  if (face_topology.subface_index ==
+                      FaceToCellTopology<vectorization_length>::invalid_subface_index)
+                    {
+                      fe_face_values_exterior.reinit(cell_ext,
+                                                     face_topology.exterior_face_no);
+                      fe_values_exterior = &fe_face_values_exterior;
+                    }
+                  else
+                    {
+                      fe_subface_values_exterior.reinit(cell_ext,
+                                                        face_topology.exterior_face_no,
+                                                        face_topology.subface_index);
+                      fe_values_exterior = &fe_subface_values_exterior;
+                    }
+
+                  for (unsigned int q=0; q<n_q_points; ++q)
+                    {
+                      // the face evaluation relies on the quadrature points
+                      // being in the same order on both sides of the face
+                      AssertThrow (fe_values_exterior->quadrature_point(q).
+                                   distance(fe_face_values.quadrature_point(q))
+                                   < tolerance,
+                                   ExcMessage("The quadrature points on the two "
+                                              "sides of a face do not match. "
+                                              "This can happen for faces that "
+                                              "are not in standard orientation, "
+                                              "which is not supported by the "
+                                              "face integrals in MatrixFree."));
+                      Tensor<2,dim> jac;
+                      for (unsigned int d=0; d<dim; ++d)
+                        for (unsigned int e=0; e<dim; ++e)
+                          jac[d][e] = fe_values_exterior->jacobian(q)[d][e];
+                      const Tensor<2,dim> inv_jac = transpose(invert(jac));
+                      const unsigned int index = face*n_q_points+q;
+                      for (unsigned int d=0; d<dim; ++d)
+                        for (unsigned int e=0; e<dim; ++e)
+                          current_data.jacobians[1][index][d][e][v] = inv_jac[d][e];
+                    }
+                }
+            }
+        }
+    }
+
+
+
+    template <int dim, typename Number>
+    void
+    MappingInfo<dim,Number>::update_mapping
+    (const dealii::Triangulation<dim>                          &tria,
+     const std::vector<std::pair<unsigned int,unsigned int> >  &cells,
+     const std::vector<unsigned int>                           &active_fe_index,
+     const FaceInfo<VectorizedArray<Number>::n_array_elements> &face_info,
+     const Mapping<dim>                                        &mapping)
+    {
+      Assert (mapping_data_gen.size() > 0,
+              ExcMessage ("The mapping information has not been initialized."));
+
+      // initialize() clears the stored settings, so take a copy of them
+      const std::vector<dealii::hp::QCollection<1> > quad = quadrature_1d;
+      const UpdateFlags flags_faces = update_flags_faces;
+      initialize (tria, cells, active_fe_index, mapping, quad,
+                  update_flags_cells, store_mapping_support_points);
+      if (face_info.faces.size() > 0)
+        initialize_faces (tria, cells, face_info, mapping, quad, flags_faces);
+    }
+
+
+
     template <int dim, typename Number>
     void
     MappingInfo<dim,Number>::evaluate_on_cell (const dealii::Triangulation<dim> &tria,
@@ -836,6 +1131,8 @@ namespace internal
       memory += MemoryConsumption::memory_consumption (quadrature);
       memory += MemoryConsumption::memory_consumption (face_quadrature);
       memory += MemoryConsumption::memory_consumption (quadrature_weights);
+      memory += MemoryConsumption::memory_consumption (mapping_shape_values);
+      memory += MemoryConsumption::memory_consumption (mapping_shape_gradients);
       memory += MemoryConsumption::memory_consumption (n_q_points);
       memory += MemoryConsumption::memory_consumption (n_q_points_face);
       memory += MemoryConsumption::memory_consumption (quad_index_conversion);
@@ -844,13 +1141,29 @@ namespace internal
 
 
 
+    template <int dim, typename Number>
+    std::size_t MappingInfo<dim,Number>::FaceMappingInfoDependent::memory_consumption() const
+    {
+      std::size_t
+      memory = MemoryConsumption::memory_consumption (JxW_values);
+      memory += MemoryConsumption::memory_consumption (normal_vectors);
+      memory += MemoryConsumption::memory_consumption (jacobians[0]);
+      memory += MemoryConsumption::memory_consumption (jacobians[1]);
+      memory += MemoryConsumption::memory_consumption (quadrature_points);
+      return memory;
+    }
+
+
+
     template <int dim, typename Number>
     std::size_t MappingInfo<dim,Number>::memory_consumption() const
     {
       std::size_t
       memory= MemoryConsumption::memory_consumption (mapping_data_gen);
+      memory += MemoryConsumption::memory_consumption (face_data);
       memory += MemoryConsumption::memory_consumption (affine_data);
       memory += MemoryConsumption::memory_consumption (cartesian_data);
+      memory += MemoryConsumption::memory_consumption (mapping_support_points);
       memory += MemoryConsumption::memory_consumption (cell_type);
       memory += sizeof (*this);
       return memory;
@@ -917,6 +1230,12 @@ namespace internal
       size_info.print_memory_statistics
       (out, MemoryConsumption::memory_consumption (affine_data) +
        MemoryConsumption::memory_consumption (cartesian_data));
+      if (mapping_degree != numbers::invalid_unsigned_int)
+        {
+          out << "    Memory mapping support points:   ";
+          size_info.print_memory_statistics
+          (out, MemoryConsumption::memory_consumption (mapping_support_points));
+        }
       for (unsigned int j=0; j<mapping_data_gen.size(); ++j)
         {
           out << "    Data component " << j << std::endl;
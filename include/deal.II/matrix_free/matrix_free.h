@@ -19,8 +19,11 @@
 
 #include <deal.II/base/aligned_vector.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi_progress.h>
 #include <deal.II/base/parallel.h>
+#include <deal.II/base/performance_counters.h>
 #include <deal.II/base/quadrature.h>
+#include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/vectorization.h>
 #include <deal.II/base/thread_local_storage.h>
 #include <deal.II/base/template_constraints.h>
@@ -29,6 +32,7 @@
 #include <deal.II/fe/mapping_q1.h>
 #include <deal.II/lac/vector_operation.h>
 #include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/la_parallel_multi_vector.h>
 #include <deal.II/lac/block_vector_base.h>
 #include <deal.II/lac/constraint_matrix.h>
 #include <deal.II/dofs/dof_handler.h>
@@ -38,6 +42,7 @@
 #include <deal.II/matrix_free/shape_info.h>
 #include <deal.II/matrix_free/dof_info.h>
 #include <deal.II/matrix_free/mapping_info.h>
+#include <deal.II/matrix_free/face_info.h>
 
 #ifdef DEAL_II_WITH_THREADS
 #include <tbb/task.h>
@@ -47,14 +52,18 @@
 #endif
 
 #include <stdlib.h>
+#include <atomic>
 #include <memory>
 #include <limits>
 #include <list>
+#include <type_traits>
 
 
 DEAL_II_NAMESPACE_OPEN
 
 
+class TimerOutput;
+
 
 /**
  * This class collects all the data that is stored for the matrix free
@@ -163,7 +172,37 @@ public:
        * Use the traditional coloring algorithm: this is like
        * TasksParallelScheme::partition_color, but only uses one partition.
        */
-      color
+      color,
+      /**
+       * Partition and color the cells as in
+       * TasksParallelScheme::partition_color, but schedule the chunks of
+       * cells by a dependency graph instead of synchronizing after each
+       * partition and color.
+       */
+      dependency_graph
+    };
+
+    /**
+     * Collects the options for storing the geometry data of cells with a
+     * general (non-affine) mapping. See the documentation of the member
+     * variable MatrixFree::AdditionalData::mapping_storage for a description.
+     */
+    enum MappingStorage
+    {
+      /**
+       * Store the inverse Jacobians and JxW values on all quadrature points.
+       */
+      mapping_jacobians,
+      /**
+       * Store only the support points of the mapping and compute the
+       * Jacobians on the fly in FEEvaluation::reinit().
+       */
+      mapping_support_points,
+      /**
+       * Select one of the two options above by a heuristic based on the
+       * memory consumption.
+       */
+      mapping_automatic
     };
 
     /**
@@ -175,15 +214,21 @@ public:
                     const unsigned int level_mg_handler = numbers::invalid_unsigned_int,
                     const bool                store_plain_indices = true,
                     const bool                initialize_indices = true,
-                    const bool                initialize_mapping = true)
+                    const bool                initialize_mapping = true,
+                    const UpdateFlags         mapping_update_flags_boundary_faces = update_default,
+                    const UpdateFlags         mapping_update_flags_inner_faces = update_default)
       :
       tasks_parallel_scheme (tasks_parallel_scheme),
       tasks_block_size      (tasks_block_size),
       mapping_update_flags  (mapping_update_flags),
+      mapping_update_flags_boundary_faces (mapping_update_flags_boundary_faces),
+      mapping_update_flags_inner_faces (mapping_update_flags_inner_faces),
       level_mg_handler      (level_mg_handler),
       store_plain_indices   (store_plain_indices),
       initialize_indices    (initialize_indices),
-      initialize_mapping    (initialize_mapping)
+      initialize_mapping    (initialize_mapping),
+      mapping_storage       (mapping_jacobians),
+      setup_timer           (nullptr)
     {};
 
 
@@ -214,6 +259,17 @@ public:
      * hanging nodes, there are quite many colors (50 or more in 3D), which
      * might degrade parallel performance (bad cache behavior, many
      * synchronization points).
+     *
+     * The fourth option @p dependency_graph uses the chunks of cells of the
+     * second option, but does not synchronize the threads after each color
+     * and partition. Instead, a chunk is started as soon as all chunks that
+     * are earlier in the order of partitions and colors and share degrees of
+     * freedom with it are finished. Likewise, only the chunks with ghost
+     * degrees of freedom wait for the ghost exchange of the source vector,
+     * and the exchange of the destination vector starts as soon as these
+     * chunks are done, overlapping the communication with the work on the
+     * other chunks. This option avoids the idle times at the synchronization
+     * points on machines with many cores.
      */
     TasksParallelScheme tasks_parallel_scheme;
 
@@ -241,6 +297,29 @@ public:
      */
     UpdateFlags         mapping_update_flags;
 
+    /**
+     * This flag determines the mapping data on boundary faces to be
+     * cached. Note that MatrixFree uses a separate loop layout for face
+     * integrals in order to effectively vectorize also in the case of hanging
+     * nodes (which require different subface settings on the two sides) or
+     * some cells in the batch of a VectorizedArray of cells that are adjacent
+     * to the boundary and others that are not.
+     *
+     * If set to a value different from update_default, the face information
+     * is explicitly built during the initialization of MatrixFree and can be
+     * accessed in the face loops of MatrixFree::loop() and through
+     * FEFaceEvaluation. The default value is update_default, i.e., no face
+     * data is set up.
+     */
+    UpdateFlags         mapping_update_flags_boundary_faces;
+
+    /**
+     * This flag determines the mapping data on interior faces to be
+     * cached. See the description of @p mapping_update_flags_boundary_faces
+     * for the setup of the face data.
+     */
+    UpdateFlags         mapping_update_flags_inner_faces;
+
     /**
      * This option can be used to define whether we work on a certain level of
      * the mesh, and not the active cells. If set to invalid_unsigned_int
@@ -276,6 +355,53 @@ public:
      * independent cells should be computed).
      */
     bool                initialize_mapping;
+
+    /**
+     * Select how the geometry data of cells with a general mapping is
+     * stored. Cells detected as Cartesian or affine within a batch of cells
+     * are always stored in compressed form with only one Jacobian per batch
+     * (shared among batches with the same Jacobians), independent of this
+     * setting.
+     *
+     * The default @p mapping_jacobians stores the inverse Jacobians and the
+     * JxW values on each quadrature point. On curved meshes, this data is
+     * often larger than the vectors the operator is applied to, so the
+     * operator evaluation becomes limited by the memory transfer of the
+     * geometry. The option @p mapping_support_points only stores the
+     * positions of the support points of a polynomial mapping of degree $p$,
+     * i.e., $d(p+1)^d$ numbers per cell, and recomputes the Jacobians in
+     * FEEvaluation::reinit() through sum factorization. This trades memory
+     * transfer for arithmetic operations, which typically pays off for
+     * higher polynomial degrees on curved 3D meshes. The option requires a
+     * mapping of type MappingQGeneric or MappingQ, and it is not
+     * available when second derivatives are requested in @p
+     * mapping_update_flags. With @p mapping_automatic, the support points are
+     * stored whenever possible and they take at most half of the memory of
+     * the Jacobian data for all quadrature formulas.
+     */
+    MappingStorage      mapping_storage;
+
+    /**
+     * A timer to report the cost of the setup in reinit(). If set to a
+     * TimerOutput object, which must live until reinit() returns, the phases
+     * of the setup are timed as separate sections of that object, namely
+     * "MatrixFree::reinit: shape info" for the evaluation of the shape
+     * functions, "MatrixFree::reinit: dof indices" for the extraction of
+     * the indices and constraints from the DoFHandler, "MatrixFree::reinit:
+     * cell reordering" for the partitioning of the cells into batches for
+     * vectorization and threads, "MatrixFree::reinit: index compression"
+     * for the constraint pool and the vectorized layout of the indices,
+     * "MatrixFree::reinit: faces" for the setup of the face batches and
+     * "MatrixFree::reinit: mapping" for the computation of the geometry
+     * data. The sections are nested into the section that is active when
+     * reinit() is called. The default null pointer does not time anything.
+     *
+     * The extraction of the indices is done in parallel on ranges of cells
+     * if multithreading is enabled through @p tasks_parallel_scheme, and the
+     * indices are copied into the vectorized layout in parallel on ranges of
+     * cell batches with the threads given by MultithreadInfo::n_threads().
+     */
+    TimerOutput        *setup_timer;
   };
 
   /**
@@ -416,6 +542,25 @@ public:
                const QuadratureType                        &quad,
                const AdditionalData                        additional_data = AdditionalData());
 
+  /**
+   * Recompute the geometry information, i.e., the Jacobians, JxW values,
+   * quadrature points and normal vectors on the cells and faces, with the
+   * given mapping, while keeping the cell batches, the degree of freedom
+   * information, the constraints and the partitioning for threads and MPI
+   * of the last call to reinit(). This is meant for meshes that move while
+   * their topology does not change, e.g. with MappingQEulerian or
+   * MappingFEField in ALE or fluid-structure interaction computations,
+   * where a full reinit() in each time step recomputes many data
+   * structures that only depend on the mesh topology and the degrees of
+   * freedom.
+   *
+   * The quadrature formulas, update flags and the storage of the mapping
+   * set in the AdditionalData of the last reinit() call are used again. If
+   * the mapping support points were stored, the new mapping must again be
+   * of type MappingQGeneric or MappingQ.
+   */
+  void update_mapping (const Mapping<dim> &mapping);
+
   /**
    * Copy function. Creates a deep copy of all data structures. It is usually
    * enough to keep the data for different operations once, so this function
@@ -489,6 +634,159 @@ public:
                   OutVector      &dst,
                   const InVector &src) const;
 
+  /**
+   * Same as the first cell_loop() function, but additionally runs the two
+   * operations @p operation_before_loop and @p operation_after_loop on
+   * ranges <code>[begin, end)</code> of locally owned vector entries in the
+   * MPI-local index space of the DoFHandler with index @p
+   * dof_handler_index_pre_post. The first operation is called on an entry
+   * before the first cell that reads from or writes into it is processed,
+   * and the second one once all cells have made their contributions to the
+   * entry, including the contributions from other processors collected by
+   * the data exchange at the end of the loop. Every locally owned entry is
+   * passed exactly once to each operation.
+   *
+   * This allows to merge vector operations into the cell loop while the
+   * data of a chunk of cells is still in the caches. A typical use case is a
+   * matrix-vector product that sets @p dst to zero in @p operation_before_loop
+   * and then runs the vector updates of a smoother such as
+   * PreconditionChebyshev on the final result in @p operation_after_loop,
+   * rather than going through the vectors in separate sweeps.
+   *
+   * Entries that are ghosts on other processors are passed to @p
+   * operation_before_loop before the ghost exchange of @p src starts and to
+   * @p operation_after_loop after the exchange of @p dst has finished. Hence,
+   * both operations may also modify the locally owned entries of @p src.
+   * When the loop runs with threads, the two operations are called once on
+   * the whole locally owned range at the beginning and at the end of the
+   * loop, respectively.
+   */
+  template <typename OutVector, typename InVector>
+  void cell_loop (const std::function<void (const MatrixFree<dim,Number> &,
+                                            OutVector &,
+                                            const InVector &,
+                                            const std::pair<unsigned int,
+                                            unsigned int> &)> &cell_operation,
+                  OutVector      &dst,
+                  const InVector &src,
+                  const std::function<void (const unsigned int,
+                                            const unsigned int)> &operation_before_loop,
+                  const std::function<void (const unsigned int,
+                                            const unsigned int)> &operation_after_loop,
+                  const unsigned int dof_handler_index_pre_post = 0) const;
+
+  /**
+   * Same as above, but for a class member function with the signature
+   * described for the second cell_loop() function.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void cell_loop (void (CLASS::*function_pointer)(const MatrixFree &,
+                                                  OutVector &,
+                                                  const InVector &,
+                                                  const std::pair<unsigned int,
+                                                  unsigned int> &)const,
+                  const CLASS    *owning_class,
+                  OutVector      &dst,
+                  const InVector &src,
+                  const std::function<void (const unsigned int,
+                                            const unsigned int)> &operation_before_loop,
+                  const std::function<void (const unsigned int,
+                                            const unsigned int)> &operation_after_loop,
+                  const unsigned int dof_handler_index_pre_post = 0) const;
+
+  /**
+   * This method runs a loop over all cells, the inner faces and the boundary
+   * faces and performs the MPI data exchange on the source vector and
+   * destination vector. The first three arguments are function objects with
+   * the same signature as in cell_loop(), i.e., <code>operation (const
+   * MatrixFree<dim,Number> &, OutVector &, InVector &, std::pair<unsigned
+   * int,unsigned int> &)</code>. The first one is called on ranges of the
+   * cell batches, the second one on ranges of the inner face batches in the
+   * numbering range from zero to n_inner_face_batches(), and the third one
+   * on ranges of the boundary face batches in the numbering range from
+   * n_inner_face_batches() to n_inner_face_batches() +
+   * n_boundary_face_batches(). The face data must have been set up by
+   * setting the flags AdditionalData::mapping_update_flags_inner_faces and
+   * AdditionalData::mapping_update_flags_boundary_faces during
+   * initialization.
+   *
+   * As in cell_loop(), the data exchange is overlapped with the work on
+   * cells: The cells that do not touch ghost entries are processed while
+   * the import of ghost values of @p src is in flight, and the remaining
+   * inner cells are processed while the ghost contributions of @p dst are
+   * sent to their owners. Since cells and faces write into the same vector
+   * entries, the three operations are currently run one after another
+   * without threads.
+   */
+  template <typename OutVector, typename InVector>
+  void loop (const std::function<void (const MatrixFree<dim,Number> &,
+                                       OutVector &,
+                                       const InVector &,
+                                       const std::pair<unsigned int,
+                                       unsigned int> &)> &cell_operation,
+             const std::function<void (const MatrixFree<dim,Number> &,
+                                       OutVector &,
+                                       const InVector &,
+                                       const std::pair<unsigned int,
+                                       unsigned int> &)> &face_operation,
+             const std::function<void (const MatrixFree<dim,Number> &,
+                                       OutVector &,
+                                       const InVector &,
+                                       const std::pair<unsigned int,
+                                       unsigned int> &)> &boundary_operation,
+             OutVector      &dst,
+             const InVector &src) const;
+
+  /**
+   * This is the second variant to run the loop over all cells, inner faces,
+   * and boundary faces, now providing three function pointers to member
+   * functions of class @p CLASS with the signature <code>operation (const
+   * MatrixFree<dim,Number> &, OutVector &, InVector &, std::pair<unsigned
+   * int,unsigned int>&)const</code>.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void loop (void (CLASS::*cell_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &)const,
+             void (CLASS::*face_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &)const,
+             void (CLASS::*boundary_operation)(const MatrixFree &,
+                                               OutVector &,
+                                               const InVector &,
+                                               const std::pair<unsigned int,
+                                               unsigned int> &)const,
+             const CLASS    *owning_class,
+             OutVector      &dst,
+             const InVector &src) const;
+
+  /**
+   * Same as above, but for class member functions which are non-const.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void loop (void (CLASS::*cell_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &),
+             void (CLASS::*face_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &),
+             void (CLASS::*boundary_operation)(const MatrixFree &,
+                                               OutVector &,
+                                               const InVector &,
+                                               const std::pair<unsigned int,
+                                               unsigned int> &),
+             CLASS          *owning_class,
+             OutVector      &dst,
+             const InVector &src) const;
+
   /**
    * In the hp adaptive case, a subrange of cells as computed during the cell
    * loop might contain elements of different degrees. Use this function to
@@ -512,6 +810,47 @@ public:
                                     const unsigned int fe_index,
                                     const unsigned int vector_component = 0) const;
 
+  /**
+   * In the hp adaptive case, split the cell range @p range as handed to the
+   * cell operation of cell_loop() or loop() into the subranges of constant
+   * active FE index (the cells are grouped into macro cells of the same
+   * FE index during the setup, so each macro cell belongs to exactly one
+   * subrange) and call @p operation for each nonempty subrange with the
+   * polynomial degree as a compile-time constant. This allows to select the
+   * appropriate instantiation of FEEvaluation for each subrange without
+   * writing the switch over the degrees in user code. The operation must be
+   * callable as
+   * @code
+   * operation (std::integral_constant<int,degree>(),
+   *            const std::pair<unsigned int,unsigned int> &subrange);
+   * @endcode
+   * for all degrees between @p min_degree and @p max_degree, which can be
+   * realized by a class with a templated <code>operator()</code>, e.g.
+   * @code
+   * struct LocalOperation
+   * {
+   *   template <int degree>
+   *   void operator() (std::integral_constant<int,degree>,
+   *                    const std::pair<unsigned int,unsigned int> &range) const
+   *   {
+   *     FEEvaluation<dim,degree> phi(data);
+   *     for (unsigned int cell=range.first; cell<range.second; ++cell)
+   *       ...
+   *   }
+   * };
+   * @endcode
+   * The polynomial degree is the one stored in the ShapeInfo object of the
+   * respective FE index, i.e., the degree that FEEvaluation checks its
+   * template argument against. If a degree of the FECollection is outside
+   * the range [@p min_degree, @p max_degree], an exception is thrown. For
+   * a standard DoFHandler, the operation is called once with the full range.
+   */
+  template <int min_degree, int max_degree, typename Operation>
+  void
+  dispatch_by_fe_degree (const std::pair<unsigned int,unsigned int> &range,
+                         const Operation                            &operation,
+                         const unsigned int vector_component = 0) const;
+
   //@}
 
   /**
@@ -650,6 +989,37 @@ public:
    */
   unsigned int n_macro_cells () const;
 
+  /**
+   * Return the number of batches of interior faces with the same
+   * vectorization layout as the cells in n_macro_cells(). The face batches
+   * are only set up if AdditionalData::mapping_update_flags_inner_faces or
+   * AdditionalData::mapping_update_flags_boundary_faces was set during
+   * initialization.
+   */
+  unsigned int n_inner_face_batches () const;
+
+  /**
+   * Return the number of batches of boundary faces. They are numbered
+   * after the inner faces, i.e., in the range from n_inner_face_batches() to
+   * n_inner_face_batches() + n_boundary_face_batches().
+   */
+  unsigned int n_boundary_face_batches () const;
+
+  /**
+   * Return the boundary id of the batch of boundary faces with the given
+   * index in the range from n_inner_face_batches() to
+   * n_inner_face_batches() + n_boundary_face_batches(). All faces within a
+   * batch share the same boundary id.
+   */
+  types::boundary_id get_boundary_id (const unsigned int face_batch) const;
+
+  /**
+   * Return the connectivity between the given face batch and the cells on
+   * its two sides. For internal use in FEFaceEvaluation.
+   */
+  const internal::MatrixFreeFunctions::FaceToCellTopology<VectorizedArray<Number>::n_array_elements> &
+  get_face_info (const unsigned int face_batch) const;
+
   /**
    * In case this structure was built based on a DoFHandler, this returns the
    * DoFHandler.
@@ -672,6 +1042,17 @@ public:
                      const unsigned int vector_number,
                      const unsigned int fe_component = 0) const;
 
+  /**
+   * Return the level of the multigrid hierarchy this object was set up for,
+   * as given by AdditionalData::level_mg_handler. For objects working on the
+   * active cells, numbers::invalid_unsigned_int is returned. The degrees of
+   * freedom of the cells returned by get_cell_iterator() must be queried by
+   * get_mg_dof_indices() in the former case and by get_dof_indices() in the
+   * latter case.
+   */
+  unsigned int
+  get_mg_level () const;
+
   /**
    * This returns the cell iterator in deal.II speak to a given cell in the
    * renumbering of this structure. This function returns an exception in case
@@ -775,6 +1156,16 @@ public:
    */
   std::size_t memory_consumption() const;
 
+  /**
+   * Return a breakdown of the memory consumption returned by
+   * memory_consumption() into the data of each DoFInfo component, the
+   * mapping data, the shape functions, the cell indices, and the task and
+   * face information. In contrast to print_memory_consumption(), the
+   * result can be combined with the reports of other objects and printed
+   * with statistics over all processes, see MemoryReport.
+   */
+  MemoryReport memory_report() const;
+
   /**
    * Prints a detailed summary of memory consumption in the different
    * structures of this class to the given output stream.
@@ -900,7 +1291,8 @@ private:
    */
   void
   initialize_indices (const std::vector<const ConstraintMatrix *> &constraint,
-                      const std::vector<IndexSet> &locally_owned_set);
+                      const std::vector<IndexSet> &locally_owned_set,
+                      TimerOutput                 *setup_timer);
 
   /**
    * Initializes the DoFHandlers based on a DoFHandler<dim> argument.
@@ -976,6 +1368,12 @@ private:
    */
   internal::MatrixFreeFunctions::MappingInfo<dim,Number> mapping_info;
 
+  /**
+   * Stores how the faces are grouped into batches for vectorization and
+   * the relation to the cells on both sides of the faces.
+   */
+  internal::MatrixFreeFunctions::FaceInfo<VectorizedArray<Number>::n_array_elements> face_info;
+
   /**
    * Contains shape value information on the unit cell.
    */
@@ -1022,6 +1420,58 @@ private:
 
 
 
+namespace DoFRenumbering
+{
+  /**
+   * Compute a renumbering of the locally owned degrees of freedom in the
+   * order in which the cell loop of the given MatrixFree object first
+   * touches them, i.e., going through the cell batches of @p matrix_free in
+   * order and through the cells filled into each batch. This makes the
+   * access to the vector entries in FEEvaluationBase::read_dof_values() and
+   * FEEvaluationBase::distribute_local_to_global() as contiguous as
+   * possible.
+   *
+   * If @p matrix_free has been set up on a level of a multigrid hierarchy
+   * (see MatrixFree::AdditionalData::level_mg_handler), the degrees of
+   * freedom of that level are considered. The vector @p new_dof_indices is
+   * resized to the number of locally owned degrees of freedom (on the
+   * level) and can be passed to DoFHandler::renumber_dofs().
+   *
+   * @note The MatrixFree object needs to be set up again after the
+   * renumbering has been applied to the DoFHandler.
+   */
+  template <int dim, typename Number>
+  void
+  compute_matrix_free_data_locality
+  (std::vector<types::global_dof_index> &new_dof_indices,
+   const DoFHandler<dim>                &dof_handler,
+   const MatrixFree<dim,Number>         &matrix_free);
+
+  /**
+   * Renumber the degrees of freedom of @p dof_handler in the order in which
+   * the cell loop of a MatrixFree object set up with the given
+   * @p constraints and @p matrix_free_data accesses them, see
+   * compute_matrix_free_data_locality(). The MatrixFree object needed for
+   * computing the order is set up internally without mapping data. If
+   * MatrixFree::AdditionalData::level_mg_handler is set, the degrees of
+   * freedom on that multigrid level are renumbered, so the function can be
+   * called for each level of a multigrid hierarchy in turn.
+   *
+   * Since the number type can not be deduced from @p matrix_free_data, it
+   * must be given explicitly, e.g.
+   * <code>DoFRenumbering::matrix_free_data_locality<dim,double>(dof_handler,
+   * constraints, additional_data)</code>.
+   */
+  template <int dim, typename Number>
+  void
+  matrix_free_data_locality
+  (DoFHandler<dim>                                       &dof_handler,
+   const ConstraintMatrix                                &constraints,
+   const typename MatrixFree<dim,Number>::AdditionalData &matrix_free_data);
+}
+
+
+
 /*----------------------- Inline functions ----------------------------------*/
 
 #ifndef DOXYGEN
@@ -1116,6 +1566,51 @@ MatrixFree<dim,Number>::n_macro_cells () const
 
 
 
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::n_inner_face_batches () const
+{
+  return face_info.n_inner_face_batches;
+}
+
+
+
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::n_boundary_face_batches () const
+{
+  return face_info.n_boundary_face_batches;
+}
+
+
+
+template <int dim, typename Number>
+inline
+types::boundary_id
+MatrixFree<dim,Number>::get_boundary_id (const unsigned int face_batch) const
+{
+  Assert (face_batch >= face_info.n_inner_face_batches &&
+          face_batch < face_info.n_inner_face_batches+face_info.n_boundary_face_batches,
+          ExcIndexRange(face_batch, face_info.n_inner_face_batches,
+                        face_info.n_inner_face_batches+face_info.n_boundary_face_batches));
+  return types::boundary_id(face_info.faces[face_batch].exterior_face_no);
+}
+
+
+
+template <int dim, typename Number>
+inline
+const internal::MatrixFreeFunctions::FaceToCellTopology<VectorizedArray<Number>::n_array_elements> &
+MatrixFree<dim,Number>::get_face_info (const unsigned int face_batch) const
+{
+  AssertIndexRange (face_batch, face_info.faces.size());
+  return face_info.faces[face_batch];
+}
+
+
+
 template <int dim, typename Number>
 inline
 unsigned int
@@ -1250,6 +1745,94 @@ MatrixFree<dim,Number>::create_cell_subrange_hp_by_index
 
 
 
+namespace internal
+{
+  /**
+   * Translate the runtime polynomial degree @p fe_degree into a compile-time
+   * constant in the range [@p degree, @p max_degree] and call the given
+   * operation with it. Returns false if the degree is not within the range.
+   */
+  template <int degree, int max_degree>
+  struct FEDegreeDispatcher
+  {
+    template <typename Operation>
+    static bool run (const unsigned int                          fe_degree,
+                     const Operation                            &operation,
+                     const std::pair<unsigned int,unsigned int> &range)
+    {
+      if (fe_degree == degree)
+        {
+          operation (std::integral_constant<int,degree>(), range);
+          return true;
+        }
+      else
+        return FEDegreeDispatcher<degree+1,max_degree>::run (fe_degree,
+                                                            operation,
+                                                            range);
+    }
+  };
+
+  template <int max_degree>
+  struct FEDegreeDispatcher<max_degree,max_degree>
+  {
+    template <typename Operation>
+    static bool run (const unsigned int                          fe_degree,
+                     const Operation                            &operation,
+                     const std::pair<unsigned int,unsigned int> &range)
+    {
+      if (fe_degree == max_degree)
+        {
+          operation (std::integral_constant<int,max_degree>(), range);
+          return true;
+        }
+      else
+        return false;
+    }
+  };
+}
+
+
+
+template <int dim, typename Number>
+template <int min_degree, int max_degree, typename Operation>
+inline
+void
+MatrixFree<dim,Number>::dispatch_by_fe_degree
+(const std::pair<unsigned int,unsigned int> &range,
+ const Operation                            &operation,
+ const unsigned int                          vector_component) const
+{
+  static_assert (min_degree >= 0 && min_degree <= max_degree,
+                 "The range of degrees must be non-empty");
+  AssertIndexRange (vector_component, dof_info.size());
+  for (unsigned int fe_index=0; fe_index<dof_info[vector_component].max_fe_index;
+       ++fe_index)
+    {
+      const std::pair<unsigned int,unsigned int> subrange =
+        create_cell_subrange_hp_by_index (range, fe_index, vector_component);
+      if (subrange.second > subrange.first)
+        {
+          const unsigned int fe_degree =
+            shape_info(vector_component, 0, fe_index, 0).fe_degree;
+          const bool found =
+            internal::FEDegreeDispatcher<min_degree,max_degree>::run (fe_degree,
+                                                                      operation,
+                                                                      subrange);
+          AssertThrow (found,
+                       ExcMessage("The polynomial degree "
+                                  + Utilities::to_string(fe_degree)
+                                  + " of FE index "
+                                  + Utilities::to_string(fe_index)
+                                  + " is not within the range ["
+                                  + Utilities::to_string(min_degree) + ","
+                                  + Utilities::to_string(max_degree)
+                                  + "] of dispatch_by_fe_degree()."));
+        }
+    }
+}
+
+
+
 template <int dim, typename Number>
 inline
 void
@@ -1323,6 +1906,16 @@ MatrixFree<dim,Number>::get_cell_iterator(const unsigned int macro_cell_number,
 
 
 
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::get_mg_level () const
+{
+  return dof_handlers.level;
+}
+
+
+
 template <int dim, typename Number>
 inline
 typename hp::DoFHandler<dim>::active_cell_iterator
@@ -1833,6 +2426,18 @@ namespace internal
 
 
 
+  template <typename Number>
+  inline
+  bool update_ghost_values_start (const LinearAlgebra::distributed::MultiVector<Number> &vec,
+                                  const unsigned int                                       channel = 0)
+  {
+    bool return_value = !vec.has_ghost_elements();
+    vec.update_ghost_values_start(channel);
+    return return_value;
+  }
+
+
+
   template <typename VectorStruct>
   inline
   bool update_ghost_values_start (const std::vector<VectorStruct> &vec)
@@ -1896,6 +2501,17 @@ namespace internal
 
 
 
+  template <typename Number>
+  inline
+  void reset_ghost_values (const LinearAlgebra::distributed::MultiVector<Number> &vec,
+                           const bool zero_out_ghosts)
+  {
+    if (zero_out_ghosts)
+      const_cast<LinearAlgebra::distributed::MultiVector<Number>&>(vec).zero_out_ghosts();
+  }
+
+
+
   template <typename VectorStruct>
   inline
   void reset_ghost_values (const std::vector<VectorStruct> &vec,
@@ -1949,6 +2565,15 @@ namespace internal
 
 
 
+  template <typename Number>
+  inline
+  void update_ghost_values_finish (const LinearAlgebra::distributed::MultiVector<Number> &vec)
+  {
+    vec.update_ghost_values_finish();
+  }
+
+
+
   template <typename VectorStruct>
   inline
   void update_ghost_values_finish (const std::vector<VectorStruct> &vec)
@@ -2001,6 +2626,16 @@ namespace internal
 
 
 
+  template <typename Number>
+  inline
+  void compress_start (LinearAlgebra::distributed::MultiVector<Number> &vec,
+                       const unsigned int                                 channel = 0)
+  {
+    vec.compress_start(channel);
+  }
+
+
+
   template <typename VectorStruct>
   inline
   void compress_start (std::vector<VectorStruct> &vec)
@@ -2052,6 +2687,15 @@ namespace internal
 
 
 
+  template <typename Number>
+  inline
+  void compress_finish (LinearAlgebra::distributed::MultiVector<Number> &vec)
+  {
+    vec.compress_finish(::dealii::VectorOperation::add);
+  }
+
+
+
   template <typename VectorStruct>
   inline
   void compress_finish (std::vector<VectorStruct> &vec)
@@ -2083,6 +2727,40 @@ namespace internal
 
 
 
+  // run the cell operation on the given range. if the MPI progress engine is
+  // enabled, split the range into pieces of the size given by the engine and
+  // let it test the outstanding messages after each piece
+  template <typename Operation, typename MatrixFreeType,
+            typename OutVector, typename InVector>
+  inline
+  void run_with_progress (const Operation                              &cell_operation,
+                          const MatrixFreeType                         &matrix_free,
+                          OutVector                                    &dst,
+                          const InVector                               &src,
+                          const std::pair<unsigned int,unsigned int>   &cell_range)
+  {
+    const unsigned int interval =
+      Utilities::MPI::ProgressEngine::get_poll_interval();
+    if (interval == 0)
+      {
+        cell_operation (matrix_free, dst, src, cell_range);
+        return;
+      }
+
+    unsigned int begin = cell_range.first;
+    do
+      {
+        const std::pair<unsigned int,unsigned int>
+        range (begin, std::min(begin+interval, cell_range.second));
+        cell_operation (matrix_free, dst, src, range);
+        Utilities::MPI::ProgressEngine::poll();
+        begin = range.second;
+      }
+    while (begin < cell_range.second);
+  }
+
+
+
 #ifdef DEAL_II_WITH_THREADS
 
   // This defines the TBB data structures that are needed to schedule the
@@ -2111,6 +2789,7 @@ namespace internal
         (task_info.partition_color_blocks_data[partition],
          task_info.partition_color_blocks_data[partition+1]);
         worker(cell_range);
+        Utilities::MPI::ProgressEngine::poll();
         if (is_blocked==true)
           dummy->spawn (*dummy);
         return (nullptr);
@@ -2247,6 +2926,7 @@ namespace internal
                                      (task_info.block_size_last):(task_info.block_size));
               }
             worker (cell_range);
+            Utilities::MPI::ProgressEngine::poll();
           }
       }
     private:
@@ -2293,6 +2973,111 @@ namespace internal
   } // end of namespace color
 
 
+
+  // This defines the TBB task that schedules the chunks of cells according
+  // to the dependency graph stored in TaskInfo. Besides the chunks with
+  // indices 0 to n_blocks-1, the graph contains a node with index n_blocks
+  // for the end of the ghost exchange of the source vector, which all chunks
+  // with cells at the MPI boundary depend upon, and a node with index
+  // n_blocks+1 for the start of the exchange of the destination vector,
+  // which depends on these chunks.
+
+  namespace dependency_graph
+  {
+    template <typename Worker, typename OutVector, typename InVector>
+    class BlockWork : public tbb::task
+    {
+    public:
+      BlockWork (const Worker                                  &worker_in,
+                 const unsigned int                             block_in,
+                 const internal::MatrixFreeFunctions::TaskInfo &task_info_in,
+                 std::vector<std::atomic<unsigned int> >       &n_missing_predecessors_in,
+                 tbb::task                                     &root_in,
+                 OutVector                                     &dst_in,
+                 const InVector                                &src_in)
+        :
+        worker (worker_in),
+        block (block_in),
+        task_info (task_info_in),
+        n_missing_predecessors (n_missing_predecessors_in),
+        root (root_in),
+        dst (dst_in),
+        src (src_in)
+      {};
+
+      tbb::task *execute ()
+      {
+        const unsigned int n_blocks = task_info.n_blocks;
+        tbb::task *next = nullptr;
+        if (block == n_blocks)
+          {
+            internal::update_ghost_values_finish(src);
+            for (unsigned int b=0; b<task_info.n_boundary_blocks; ++b)
+              release (b, next);
+          }
+        else if (block == n_blocks+1)
+          internal::compress_start(dst);
+        else
+          {
+            std::pair<unsigned int,unsigned int> cell_range;
+            if (task_info.position_short_block<block)
+              {
+                cell_range.first = (block-1)*task_info.block_size+
+                                   task_info.block_size_last;
+                cell_range.second = cell_range.first + task_info.block_size;
+              }
+            else
+              {
+                cell_range.first = block*task_info.block_size;
+                cell_range.second = cell_range.first +
+                                    ((block == task_info.position_short_block)?
+                                     (task_info.block_size_last):(task_info.block_size));
+              }
+            worker (cell_range);
+            Utilities::MPI::ProgressEngine::poll();
+
+            for (unsigned int i=task_info.block_successors_row_index[block];
+                 i<task_info.block_successors_row_index[block+1]; ++i)
+              release (task_info.block_successors[i], next);
+            if (block < task_info.n_boundary_blocks)
+              release (n_blocks+1, next);
+          }
+
+        // continue directly with one of the released chunks, which likely
+        // shares data with the present one
+        return next;
+      }
+
+    private:
+      // mark this node as finished for the given successor and start the
+      // successor if it has no other unfinished predecessors
+      void release (const unsigned int successor,
+                    tbb::task        *&next)
+      {
+        if (--n_missing_predecessors[successor] == 0)
+          {
+            BlockWork *task = new (tbb::task::allocate_additional_child_of(root))
+            BlockWork (worker, successor, task_info, n_missing_predecessors,
+                       root, dst, src);
+            if (next == nullptr)
+              next = task;
+            else
+              tbb::task::spawn (*task);
+          }
+      }
+
+      const Worker                                  &worker;
+      const unsigned int                             block;
+      const internal::MatrixFreeFunctions::TaskInfo &task_info;
+      std::vector<std::atomic<unsigned int> >       &n_missing_predecessors;
+      tbb::task                                     &root;
+      OutVector                                     &dst;
+      const InVector                                &src;
+    };
+
+  } // end of namespace dependency_graph
+
+
   template <typename VectorStruct>
   class MPIComDistribute : public tbb::task
   {
@@ -2352,6 +3137,8 @@ MatrixFree<dim, Number>::cell_loop
  OutVector       &dst,
  const InVector  &src) const
 {
+  const PerformanceCounters::Region counter_region("MatrixFree::cell_loop");
+
   // in any case, need to start the ghost import at the beginning
   bool ghosts_were_not_set = internal::update_ghost_values_start (src);
 
@@ -2373,7 +3160,38 @@ MatrixFree<dim, Number>::cell_loop
                                      std::cref(src),
                                      std::placeholders::_1);
 
-      if (task_info.use_partition_partition == true)
+      if (task_info.use_dependency_graph == true)
+        {
+          typedef internal::dependency_graph::BlockWork<Worker,OutVector,InVector>
+          BlockWork;
+          const unsigned int n_blocks = task_info.n_blocks;
+          std::vector<std::atomic<unsigned int> > n_missing_predecessors(n_blocks+2);
+          for (unsigned int block=0; block<n_blocks; ++block)
+            n_missing_predecessors[block] = task_info.block_n_predecessors[block] +
+                                            (block < task_info.n_boundary_blocks ? 1 : 0);
+          n_missing_predecessors[n_blocks] = 0;
+          n_missing_predecessors[n_blocks+1] = task_info.n_boundary_blocks;
+
+          // start the ghost exchange node and all chunks without
+          // predecessors, the other chunks get spawned as soon as their
+          // predecessors are done. All initial tasks must be collected
+          // before spawning any of them because the running tasks modify
+          // the counters
+          tbb::empty_task *root = new ( tbb::task::allocate_root() )
+          tbb::empty_task;
+          root->set_ref_count(1);
+          tbb::task_list initial_tasks;
+          for (unsigned int block=0; block<n_blocks+2; ++block)
+            if (n_missing_predecessors[block] == 0)
+              initial_tasks.push_back
+              (*new (tbb::task::allocate_additional_child_of(*root))
+               BlockWork (func, block, task_info, n_missing_predecessors,
+                          *root, dst, src));
+          tbb::task::spawn (initial_tasks);
+          root->wait_for_all();
+          root->destroy(*root);
+        }
+      else if (task_info.use_partition_partition == true)
         {
           tbb::empty_task *root = new ( tbb::task::allocate_root() )
           tbb::empty_task;
@@ -2588,11 +3406,13 @@ MatrixFree<dim, Number>::cell_loop
     {
       std::pair<unsigned int,unsigned int> cell_range;
 
-      // First operate on cells where no ghost data is needed (inner cells)
+      // First operate on cells where no ghost data is needed (inner cells).
+      // if the MPI progress engine is enabled, let it test the messages of
+      // the ghost exchange after every few cell batches
       {
         cell_range.first = 0;
         cell_range.second = size_info.boundary_cells_start;
-        cell_operation (*this, dst, src, cell_range);
+        internal::run_with_progress (cell_operation, *this, dst, src, cell_range);
       }
 
       // before starting operations on cells that contain ghost nodes (outer
@@ -2614,7 +3434,7 @@ MatrixFree<dim, Number>::cell_loop
         {
           cell_range.first = size_info.boundary_cells_end;
           cell_range.second = size_info.n_macro_cells;
-          cell_operation (*this, dst, src, cell_range);
+          internal::run_with_progress (cell_operation, *this, dst, src, cell_range);
         }
     }
 
@@ -2688,6 +3508,393 @@ MatrixFree<dim,Number>::cell_loop
 }
 
 
+
+template <int dim, typename Number>
+template <typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim, Number>::cell_loop
+(const std::function<void (const MatrixFree<dim,Number> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int,
+                           unsigned int> &)> &cell_operation,
+ OutVector       &dst,
+ const InVector  &src,
+ const std::function<void (const unsigned int,
+                           const unsigned int)> &operation_before_loop,
+ const std::function<void (const unsigned int,
+                           const unsigned int)> &operation_after_loop,
+ const unsigned int dof_handler_index_pre_post) const
+{
+  AssertIndexRange(dof_handler_index_pre_post, dof_info.size());
+  const internal::MatrixFreeFunctions::DoFInfo &info =
+    dof_info[dof_handler_index_pre_post];
+
+  // without the access lists (bare structures) or when running with
+  // threads, the cells do not run in a fixed order, so we run the operations
+  // on the whole range around the plain cell loop
+  bool run_with_threads = false;
+#ifdef DEAL_II_WITH_THREADS
+  run_with_threads = (task_info.use_multithreading == true &&
+                      task_info.n_blocks > 3);
+#endif
+  if (info.cell_loop_chunks.empty() || run_with_threads)
+    {
+      const unsigned int local_size =
+        info.vector_partitioner.get() != nullptr ?
+        info.vector_partitioner->local_size() : 0;
+      if (operation_before_loop)
+        operation_before_loop(0, local_size);
+      cell_loop (cell_operation, dst, src);
+      if (operation_after_loop)
+        operation_after_loop(0, local_size);
+      return;
+    }
+
+  const unsigned int n_chunks = info.cell_loop_chunks.size()-1;
+  if (operation_before_loop)
+    for (unsigned int i=info.cell_loop_pre_list_index[0];
+         i<info.cell_loop_pre_list_index[1]; ++i)
+      operation_before_loop(info.cell_loop_pre_list[i].first,
+                            info.cell_loop_pre_list[i].second);
+
+  bool ghosts_were_not_set = internal::update_ghost_values_start (src);
+
+  // same as the serial loop in the other cell_loop() function: inner cells,
+  // cells with ghosts, remaining inner cells, but now split into the chunks
+  // of the access lists
+  const unsigned int phase_ends [3] = {size_info.boundary_cells_start,
+                                       size_info.boundary_cells_end,
+                                       size_info.n_macro_cells
+                                      };
+  unsigned int chunk = 0;
+  for (unsigned int phase=0; phase<3; ++phase)
+    {
+      if (phase == 1)
+        internal::update_ghost_values_finish(src);
+      else if (phase == 2)
+        internal::compress_start(dst);
+
+      for ( ; chunk<n_chunks && info.cell_loop_chunks[chunk+1] <= phase_ends[phase];
+            ++chunk)
+        {
+          if (operation_before_loop)
+            for (unsigned int i=info.cell_loop_pre_list_index[chunk+1];
+                 i<info.cell_loop_pre_list_index[chunk+2]; ++i)
+              operation_before_loop(info.cell_loop_pre_list[i].first,
+                                    info.cell_loop_pre_list[i].second);
+
+          const std::pair<unsigned int,unsigned int>
+          cell_range (info.cell_loop_chunks[chunk], info.cell_loop_chunks[chunk+1]);
+          cell_operation (*this, dst, src, cell_range);
+          Utilities::MPI::ProgressEngine::poll();
+
+          if (operation_after_loop)
+            for (unsigned int i=info.cell_loop_post_list_index[chunk];
+                 i<info.cell_loop_post_list_index[chunk+1]; ++i)
+              operation_after_loop(info.cell_loop_post_list[i].first,
+                                   info.cell_loop_post_list[i].second);
+        }
+    }
+  Assert(chunk == n_chunks, ExcInternalError());
+
+  internal::compress_finish(dst);
+  if (operation_after_loop)
+    for (unsigned int i=info.cell_loop_post_list_index[n_chunks];
+         i<info.cell_loop_post_list_index[n_chunks+1]; ++i)
+      operation_after_loop(info.cell_loop_post_list[i].first,
+                           info.cell_loop_post_list[i].second);
+  internal::reset_ghost_values(src, ghosts_were_not_set);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CLASS, typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::cell_loop
+(void (CLASS::*function_pointer)(const MatrixFree<dim,Number> &,
+                                 OutVector &,
+                                 const InVector &,
+                                 const std::pair<unsigned int,
+                                 unsigned int> &)const,
+ const CLASS    *owning_class,
+ OutVector      &dst,
+ const InVector &src,
+ const std::function<void (const unsigned int,
+                           const unsigned int)> &operation_before_loop,
+ const std::function<void (const unsigned int,
+                           const unsigned int)> &operation_after_loop,
+ const unsigned int dof_handler_index_pre_post) const
+{
+  std::function<void (const MatrixFree<dim,Number> &,
+                      OutVector &,
+                      const InVector &,
+                      const std::pair<unsigned int,
+                      unsigned int> &)>
+  function = std::bind<void>(function_pointer,
+                             owning_class,
+                             std::placeholders::_1,
+                             std::placeholders::_2,
+                             std::placeholders::_3,
+                             std::placeholders::_4);
+  cell_loop (function, dst, src, operation_before_loop, operation_after_loop,
+             dof_handler_index_pre_post);
+}
+
+
+
+template <int dim, typename Number>
+template <typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim, Number>::loop
+(const std::function<void (const MatrixFree<dim,Number> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int,
+                           unsigned int> &)> &cell_operation,
+ const std::function<void (const MatrixFree<dim,Number> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int,
+                           unsigned int> &)> &face_operation,
+ const std::function<void (const MatrixFree<dim,Number> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int,
+                           unsigned int> &)> &boundary_operation,
+ OutVector       &dst,
+ const InVector  &src) const
+{
+  const PerformanceCounters::Region counter_region("MatrixFree::loop");
+
+  // in any case, need to start the ghost import at the beginning
+  bool ghosts_were_not_set = internal::update_ghost_values_start (src);
+
+  // First operate on cells where no ghost data is needed (inner cells)
+  std::pair<unsigned int,unsigned int> range (0, size_info.boundary_cells_start);
+  if (range.second > range.first)
+    cell_operation (*this, dst, src, range);
+
+  // before starting operations on cells that contain ghost nodes (outer
+  // cells) and on the faces, which might be adjacent to the outer cells,
+  // wait for the MPI commands to finish
+  internal::update_ghost_values_finish(src);
+
+  range = std::make_pair(size_info.boundary_cells_start,
+                         size_info.boundary_cells_end);
+  if (range.second > range.first)
+    cell_operation (*this, dst, src, range);
+
+  range = std::make_pair(0U, face_info.n_inner_face_batches);
+  if (range.second > range.first)
+    face_operation (*this, dst, src, range);
+
+  range = std::make_pair(face_info.n_inner_face_batches,
+                         face_info.n_inner_face_batches +
+                         face_info.n_boundary_face_batches);
+  if (range.second > range.first)
+    boundary_operation (*this, dst, src, range);
+
+  // all contributions to the ghost entries of dst have been computed now, so
+  // start the data exchange and finally operate on the remaining inner cells
+  internal::compress_start(dst);
+
+  range = std::make_pair(size_info.boundary_cells_end,
+                         size_info.n_macro_cells);
+  if (range.second > range.first)
+    cell_operation (*this, dst, src, range);
+
+  internal::compress_finish(dst);
+  internal::reset_ghost_values(src, ghosts_were_not_set);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CLASS, typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::loop
+(void (CLASS::*cell_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &)const,
+ void (CLASS::*face_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &)const,
+ void (CLASS::*boundary_operation)(const MatrixFree<dim,Number> &,
+                                   OutVector &,
+                                   const InVector &,
+                                   const std::pair<unsigned int,
+                                   unsigned int> &)const,
+ const CLASS    *owning_class,
+ OutVector      &dst,
+ const InVector &src) const
+{
+  // here, use std::bind to hand function handlers with the appropriate
+  // arguments to the other loop function
+  typedef std::function<void (const MatrixFree<dim,Number> &,
+                              OutVector &,
+                              const InVector &,
+                              const std::pair<unsigned int,
+                              unsigned int> &)> Function;
+  const Function cell_function =
+    std::bind<void>(cell_operation, owning_class,
+                    std::placeholders::_1, std::placeholders::_2,
+                    std::placeholders::_3, std::placeholders::_4);
+  const Function face_function =
+    std::bind<void>(face_operation, owning_class,
+                    std::placeholders::_1, std::placeholders::_2,
+                    std::placeholders::_3, std::placeholders::_4);
+  const Function boundary_function =
+    std::bind<void>(boundary_operation, owning_class,
+                    std::placeholders::_1, std::placeholders::_2,
+                    std::placeholders::_3, std::placeholders::_4);
+  loop (cell_function, face_function, boundary_function, dst, src);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CLASS, typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::loop
+(void (CLASS::*cell_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &),
+ void (CLASS::*face_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &),
+ void (CLASS::*boundary_operation)(const MatrixFree<dim,Number> &,
+                                   OutVector &,
+                                   const InVector &,
+                                   const std::pair<unsigned int,
+                                   unsigned int> &),
+ CLASS          *owning_class,
+ OutVector      &dst,
+ const InVector &src) const
+{
+  // here, use std::bind to hand function handlers with the appropriate
+  // arguments to the other loop function
+  typedef std::function<void (const MatrixFree<dim,Number> &,
+                              OutVector &,
+                              const InVector &,
+                              const std::pair<unsigned int,
+                              unsigned int> &)> Function;
+  const Function cell_function =
+    std::bind<void>(cell_operation, owning_class,
+                    std::placeholders::_1, std::placeholders::_2,
+                    std::placeholders::_3, std::placeholders::_4);
+  const Function face_function =
+    std::bind<void>(face_operation, owning_class,
+                    std::placeholders::_1, std::placeholders::_2,
+                    std::placeholders::_3, std::placeholders::_4);
+  const Function boundary_function =
+    std::bind<void>(boundary_operation, owning_class,
+                    std::placeholders::_1, std::placeholders::_2,
+                    std::placeholders::_3, std::placeholders::_4);
+  loop (cell_function, face_function, boundary_function, dst, src);
+}
+
+
+
+namespace DoFRenumbering
+{
+  template <int dim, typename Number>
+  void
+  compute_matrix_free_data_locality
+  (std::vector<types::global_dof_index> &new_dof_indices,
+   const DoFHandler<dim>                &dof_handler,
+   const MatrixFree<dim,Number>         &matrix_free)
+  {
+    const unsigned int level = matrix_free.get_mg_level();
+    const IndexSet &locally_owned =
+      (level == numbers::invalid_unsigned_int ?
+       dof_handler.locally_owned_dofs() :
+       dof_handler.locally_owned_mg_dofs(level));
+
+    new_dof_indices.resize (0);
+    new_dof_indices.resize (locally_owned.n_elements(),
+                            numbers::invalid_dof_index);
+
+    types::global_dof_index next_free = 0;
+    std::vector<types::global_dof_index> local_dof_indices;
+    for (unsigned int macro=0; macro<matrix_free.n_macro_cells(); ++macro)
+      for (unsigned int v=0; v<matrix_free.n_components_filled(macro); ++v)
+        {
+          const typename DoFHandler<dim>::cell_iterator
+          cell = matrix_free.get_cell_iterator(macro, v);
+          const typename DoFHandler<dim>::cell_iterator
+          dcell (&dof_handler.get_triangulation(), cell->level(),
+                 cell->index(), &dof_handler);
+          local_dof_indices.resize (dcell->get_fe().dofs_per_cell);
+          if (level == numbers::invalid_unsigned_int)
+            dcell->get_dof_indices (local_dof_indices);
+          else
+            dcell->get_mg_dof_indices (local_dof_indices);
+
+          for (unsigned int i=0; i<local_dof_indices.size(); ++i)
+            if (locally_owned.is_element (local_dof_indices[i]))
+              {
+                const types::global_dof_index idx
+                  = locally_owned.index_within_set (local_dof_indices[i]);
+                if (new_dof_indices[idx] == numbers::invalid_dof_index)
+                  new_dof_indices[idx] = locally_owned.nth_index_in_set (next_free++);
+              }
+        }
+
+    // locally owned degrees of freedom not seen by the cell loop (which
+    // should not happen for the usual setups) are appended at the end
+    for (std::size_t i=0; i<new_dof_indices.size(); ++i)
+      if (new_dof_indices[i] == numbers::invalid_dof_index)
+        new_dof_indices[i] = locally_owned.nth_index_in_set (next_free++);
+
+    AssertDimension (next_free, locally_owned.n_elements());
+  }
+
+
+
+  template <int dim, typename Number>
+  void
+  matrix_free_data_locality
+  (DoFHandler<dim>                                       &dof_handler,
+   const ConstraintMatrix                                &constraints,
+   const typename MatrixFree<dim,Number>::AdditionalData &matrix_free_data)
+  {
+    typename MatrixFree<dim,Number>::AdditionalData additional_data = matrix_free_data;
+    additional_data.initialize_indices = true;
+    additional_data.initialize_mapping = false;
+
+    MatrixFree<dim,Number> matrix_free;
+    matrix_free.reinit (dof_handler, constraints,
+                        QGauss<1>(dof_handler.get_fe().degree+1),
+                        additional_data);
+
+    std::vector<types::global_dof_index> new_dof_indices;
+    compute_matrix_free_data_locality (new_dof_indices, dof_handler,
+                                       matrix_free);
+
+    if (additional_data.level_mg_handler == numbers::invalid_unsigned_int)
+      dof_handler.renumber_dofs (new_dof_indices);
+    else
+      dof_handler.renumber_dofs (additional_data.level_mg_handler,
+                                 new_dof_indices);
+  }
+}
+
+
 #endif  // ifndef DOXYGEN
 
 
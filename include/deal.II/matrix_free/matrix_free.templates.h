@@ -22,8 +22,10 @@
 #include <deal.II/base/tensor_product_polynomials.h>
 #include <deal.II/base/polynomials_piecewise.h>
 #include <deal.II/base/mpi.h>
+#include <deal.II/base/timer.h>
 #include <deal.II/dofs/dof_accessor.h>
 #include <deal.II/fe/fe_poly.h>
+#include <deal.II/fe/fe_raviart_thomas.h>
 #include <deal.II/hp/q_collection.h>
 #include <deal.II/distributed/tria.h>
 
@@ -31,11 +33,62 @@
 #include <deal.II/matrix_free/shape_info.templates.h>
 #include <deal.II/matrix_free/mapping_info.templates.h>
 #include <deal.II/matrix_free/dof_info.templates.h>
+#include <deal.II/matrix_free/face_setup_internal.h>
 
 
 DEAL_II_NAMESPACE_OPEN
 
 
+namespace internal
+{
+  namespace MatrixFreeFunctions
+  {
+    /**
+     * Enter a section of the timer given by
+     * MatrixFree::AdditionalData::setup_timer for the lifetime of this
+     * object, or do nothing if the timer is a null pointer.
+     */
+    class SetupTimerSection
+    {
+    public:
+      SetupTimerSection (TimerOutput       *timer,
+                         const std::string &section_name)
+        :
+        timer (timer),
+        section_name (section_name)
+      {
+        if (timer != nullptr)
+          timer->enter_subsection (section_name);
+      }
+
+      ~SetupTimerSection ()
+      {
+        if (timer != nullptr)
+          timer->leave_subsection (section_name);
+      }
+
+      /**
+       * Leave the current section and enter the section @p new_section_name.
+       */
+      void switch_to (const std::string &new_section_name)
+      {
+        if (timer != nullptr)
+          {
+            timer->leave_subsection (section_name);
+            timer->enter_subsection (new_section_name);
+          }
+        section_name = new_section_name;
+      }
+
+    private:
+      TimerOutput *timer;
+      std::string  section_name;
+    };
+  }
+}
+
+
+
 // --------------------- MatrixFree -----------------------------------
 
 template <int dim, typename Number>
@@ -68,6 +121,7 @@ copy_from (const MatrixFree<dim,Number> &v)
   constraint_pool_data = v.constraint_pool_data;
   constraint_pool_row_index = v.constraint_pool_row_index;
   mapping_info = v.mapping_info;
+  face_info = v.face_info;
   shape_info = v.shape_info;
   cell_level_index = v.cell_level_index;
   task_info = v.task_info;
@@ -87,10 +141,20 @@ internal_reinit(const Mapping<dim>                          &mapping,
                 const std::vector<hp::QCollection<1> >      &quad,
                 const typename MatrixFree<dim,Number>::AdditionalData additional_data)
 {
+  AssertThrow (Utilities::System::get_cpu_vectorization_level() >=
+               DEAL_II_COMPILER_VECTORIZATION_LEVEL,
+               ExcMessage("deal.II was compiled with vectorization level " +
+                          Utilities::to_string(DEAL_II_COMPILER_VECTORIZATION_LEVEL) +
+                          ", but the processor of this machine only supports level " +
+                          Utilities::to_string(Utilities::System::get_cpu_vectorization_level()) +
+                          ". Use an installation of deal.II configured for this processor."));
+
 
   // Reads out the FE information and stores the shape function values,
   // gradients and Hessians for quadrature points.
   {
+    const internal::MatrixFreeFunctions::SetupTimerSection
+    timer_section (additional_data.setup_timer, "MatrixFree::reinit: shape info");
     const unsigned int n_fe   = dof_handler.size();
     const unsigned int n_quad = quad.size();
     shape_info.reinit (TableIndices<4>(n_fe, n_quad, 1, 1));
@@ -134,6 +198,23 @@ internal_reinit(const Mapping<dim>                          &mapping,
       for (unsigned int no=0; no<dof_handler.size(); ++no)
         dof_info[no].store_plain_indices = additional_data.store_plain_indices;
 
+      // face integrals access the degrees of freedom of individual cells
+      // rather than the vectorized layout of the cell batches, so keep the
+      // indices per cell in that case
+      const bool setup_faces =
+        (additional_data.mapping_update_flags_inner_faces |
+         additional_data.mapping_update_flags_boundary_faces) != update_default;
+      if (setup_faces)
+        {
+          AssertThrow (additional_data.level_mg_handler ==
+                       numbers::invalid_unsigned_int,
+                       ExcMessage("Face integrals are currently not "
+                                  "implemented for level operators in "
+                                  "MatrixFree."));
+          for (unsigned int no=0; no<dof_handler.size(); ++no)
+            dof_info[no].store_indices_per_cell = true;
+        }
+
       // initialize the basic multithreading information that needs to be
       // passed to the DoFInfo structure
 #ifdef DEAL_II_WITH_THREADS
@@ -148,6 +229,9 @@ internal_reinit(const Mapping<dim>                          &mapping,
           task_info.use_coloring_only =
             (additional_data.tasks_parallel_scheme ==
              AdditionalData::color ? true : false);
+          task_info.use_dependency_graph =
+            (additional_data.tasks_parallel_scheme ==
+             AdditionalData::dependency_graph ? true : false);
         }
       else
 #endif
@@ -157,7 +241,17 @@ internal_reinit(const Mapping<dim>                          &mapping,
       // constraint_pool_data. It also reorders the way cells are gone through
       // (to separate cells with overlap to other processors from others
       // without).
-      initialize_indices (constraint, locally_owned_set);
+      initialize_indices (constraint, locally_owned_set,
+                          additional_data.setup_timer);
+
+      // group the faces into batches for vectorization
+      if (setup_faces)
+        {
+          const internal::MatrixFreeFunctions::SetupTimerSection
+          timer_section (additional_data.setup_timer, "MatrixFree::reinit: faces");
+          internal::MatrixFreeFunctions::collect_faces
+          (dof_handler[0]->get_triangulation(), cell_level_index, face_info);
+        }
     }
 
   // initialize bare structures
@@ -171,7 +265,7 @@ internal_reinit(const Mapping<dim>                          &mapping,
       for (unsigned int i=0; i<dof_info.size(); ++i)
         {
           dof_info[i].dimension    = dim;
-          dof_info[i].n_components = dof_handler[i]->get_fe().element_multiplicity(0);
+          dof_info[i].n_components = dof_handler[i]->get_fe().n_components();
           dof_info[i].dofs_per_cell.push_back(dof_handler[i]->get_fe().dofs_per_cell);
           dof_info[i].row_starts.resize(size_info.n_macro_cells+1);
           dof_info[i].row_starts.back()[2] =
@@ -194,9 +288,24 @@ internal_reinit(const Mapping<dim>                          &mapping,
   // general case?
   if (additional_data.initialize_mapping == true)
     {
+      const internal::MatrixFreeFunctions::SetupTimerSection
+      timer_section (additional_data.setup_timer, "MatrixFree::reinit: mapping");
       mapping_info.initialize (dof_handler[0]->get_triangulation(), cell_level_index,
                                dof_info[0].cell_active_fe_index, mapping, quad,
-                               additional_data.mapping_update_flags);
+                               additional_data.mapping_update_flags,
+                               additional_data.mapping_storage ==
+                               AdditionalData::mapping_support_points ||
+                               (additional_data.mapping_storage ==
+                                AdditionalData::mapping_automatic &&
+                                internal::MatrixFreeFunctions::MappingInfo<dim,Number>::
+                                use_mapping_support_points(mapping, quad,
+                                                           additional_data.mapping_update_flags)));
+      if (face_info.faces.size() > 0)
+        mapping_info.initialize_faces (dof_handler[0]->get_triangulation(),
+                                       cell_level_index, face_info, mapping,
+                                       quad,
+                                       additional_data.mapping_update_flags_inner_faces |
+                                       additional_data.mapping_update_flags_boundary_faces);
 
       mapping_is_initialized = true;
     }
@@ -213,9 +322,19 @@ internal_reinit(const Mapping<dim>                            &mapping,
                 const std::vector<hp::QCollection<1> >        &quad,
                 const typename MatrixFree<dim,Number>::AdditionalData additional_data)
 {
+  AssertThrow (Utilities::System::get_cpu_vectorization_level() >=
+               DEAL_II_COMPILER_VECTORIZATION_LEVEL,
+               ExcMessage("deal.II was compiled with vectorization level " +
+                          Utilities::to_string(DEAL_II_COMPILER_VECTORIZATION_LEVEL) +
+                          ", but the processor of this machine only supports level " +
+                          Utilities::to_string(Utilities::System::get_cpu_vectorization_level()) +
+                          ". Use an installation of deal.II configured for this processor."));
+
   // Reads out the FE information and stores the shape function values,
   // gradients and Hessians for quadrature points.
   {
+    const internal::MatrixFreeFunctions::SetupTimerSection
+    timer_section (additional_data.setup_timer, "MatrixFree::reinit: shape info");
     const unsigned int n_components = dof_handler.size();
     const unsigned int n_quad       = quad.size();
     unsigned int n_fe_in_collection = 0;
@@ -264,6 +383,12 @@ internal_reinit(const Mapping<dim>                            &mapping,
           size_info.n_procs = 1;
         }
 
+      AssertThrow ((additional_data.mapping_update_flags_inner_faces |
+                    additional_data.mapping_update_flags_boundary_faces) ==
+                   update_default,
+                   ExcMessage("Face integrals are currently not implemented "
+                              "for hp::DoFHandler in MatrixFree."));
+
       initialize_dof_handlers (dof_handler, additional_data.level_mg_handler);
       for (unsigned int no=0; no<dof_handler.size(); ++no)
         dof_info[no].store_plain_indices = additional_data.store_plain_indices;
@@ -282,6 +407,9 @@ internal_reinit(const Mapping<dim>                            &mapping,
           task_info.use_coloring_only =
             (additional_data.tasks_parallel_scheme ==
              AdditionalData::color ? true : false);
+          task_info.use_dependency_graph =
+            (additional_data.tasks_parallel_scheme ==
+             AdditionalData::dependency_graph ? true : false);
         }
       else
 #endif
@@ -291,7 +419,8 @@ internal_reinit(const Mapping<dim>                            &mapping,
       // constraint_pool_data. It also reorders the way cells are gone through
       // (to separate cells with overlap to other processors from others
       // without).
-      initialize_indices (constraint, locally_owned_set);
+      initialize_indices (constraint, locally_owned_set,
+                          additional_data.setup_timer);
     }
 
   // initialize bare structures
@@ -306,7 +435,7 @@ internal_reinit(const Mapping<dim>                            &mapping,
         {
           Assert(dof_handler[i]->get_fe_collection().size() == 1, ExcNotImplemented());
           dof_info[i].dimension    = dim;
-          dof_info[i].n_components = dof_handler[i]->get_fe(0).element_multiplicity(0);
+          dof_info[i].n_components = dof_handler[i]->get_fe(0).n_components();
           dof_info[i].dofs_per_cell.push_back(dof_handler[i]->get_fe(0).dofs_per_cell);
           dof_info[i].row_starts.resize(size_info.n_macro_cells+1);
           dof_info[i].row_starts.back()[2] =
@@ -326,15 +455,43 @@ internal_reinit(const Mapping<dim>                            &mapping,
   // determined in @p extract_local_to_global_indices.
   if (additional_data.initialize_mapping == true)
     {
+      const internal::MatrixFreeFunctions::SetupTimerSection
+      timer_section (additional_data.setup_timer, "MatrixFree::reinit: mapping");
       mapping_info.initialize (dof_handler[0]->get_triangulation(), cell_level_index,
                                dof_info[0].cell_active_fe_index, mapping, quad,
-                               additional_data.mapping_update_flags);
+                               additional_data.mapping_update_flags,
+                               additional_data.mapping_storage ==
+                               AdditionalData::mapping_support_points ||
+                               (additional_data.mapping_storage ==
+                                AdditionalData::mapping_automatic &&
+                                internal::MatrixFreeFunctions::MappingInfo<dim,Number>::
+                                use_mapping_support_points(mapping, quad,
+                                                           additional_data.mapping_update_flags)));
 
       mapping_is_initialized = true;
     }
 }
 
 
+template <int dim, typename Number>
+void MatrixFree<dim,Number>::update_mapping (const Mapping<dim> &mapping)
+{
+  Assert (mapping_is_initialized == true,
+          ExcMessage ("The mapping can only be updated after it has been "
+                      "initialized by a call to reinit()."));
+  Assert (dof_handlers.n_dof_handlers > 0, ExcNotInitialized());
+
+  const Triangulation<dim> &tria =
+    (dof_handlers.active_dof_handler == DoFHandlers::usual ?
+     dof_handlers.dof_handler[0]->get_triangulation() :
+     dof_handlers.hp_dof_handler[0]->get_triangulation());
+  mapping_info.update_mapping (tria, cell_level_index,
+                               dof_info[0].cell_active_fe_index,
+                               face_info, mapping);
+}
+
+
+
 template <int dim, typename Number>
 template <int spacedim>
 bool
@@ -348,6 +505,8 @@ MatrixFree<dim, Number>::is_supported(const FiniteElement<dim, spacedim> &fe)
     return false;
 
   const FiniteElement<dim, spacedim> *fe_ptr = &(fe.base_element(0));
+  if (dynamic_cast<const FE_RaviartThomasNodal<dim>*>(fe_ptr)!=nullptr)
+    return dim > 1;
   if (fe_ptr->n_components() != 1)
     return false;
 
@@ -495,8 +654,12 @@ initialize_dof_handlers (const std::vector<const hp::DoFHandler<dim>*> &dof_hand
 template <int dim, typename Number>
 void MatrixFree<dim,Number>::initialize_indices
 (const std::vector<const ConstraintMatrix *> &constraint,
- const std::vector<IndexSet>                 &locally_owned_set)
+ const std::vector<IndexSet>                 &locally_owned_set,
+ TimerOutput                                 *setup_timer)
 {
+  internal::MatrixFreeFunctions::SetupTimerSection
+  timer_section (setup_timer, "MatrixFree::reinit: dof indices");
+
   const unsigned int n_fe = dof_handlers.n_dof_handlers;
   const unsigned int n_active_cells = cell_level_index.size();
 
@@ -544,7 +707,10 @@ void MatrixFree<dim,Number>::initialize_indices
           const FiniteElement<dim> &fe = *fes[fe_index];
           Assert (fe.n_base_elements() == 1,
                   ExcMessage ("MatrixFree currently only works for DoFHandler with one base element"));
-          const unsigned int n_fe_components = fe.element_multiplicity (0);
+          // the base element is scalar except for FE_RaviartThomasNodal, so
+          // the number of components of the system is the number of
+          // components the FEEvaluation objects work on
+          const unsigned int n_fe_components = fe.n_components ();
 
           // cache number of finite elements and dofs_per_cell
           dof_info[no].dofs_per_cell.push_back (fe.dofs_per_cell);
@@ -582,82 +748,159 @@ void MatrixFree<dim,Number>::initialize_indices
     }
 
   // extract all the global indices associated with the computation, and form
-  // the ghost indices
+  // the ghost indices. The indices of cell number counter are put into the
+  // row counter-first_cell of the given DoFInfo objects.
+  auto read_cell_indices = [&]
+                           (const unsigned int                                   counter,
+                            const unsigned int                                   first_cell,
+                            std::vector<internal::MatrixFreeFunctions::DoFInfo> &dof_info_target,
+                            internal::MatrixFreeFunctions::ConstraintValues<double> &constraint_values_target,
+                            std::vector<types::global_dof_index>                &local_dof_indices)
+  {
+    bool cell_at_boundary = false;
+    for (unsigned int no=0; no<n_fe; ++no)
+      {
+        // OK, read indices from standard DoFHandler in the usual way
+        if (dof_handlers.active_dof_handler == DoFHandlers::usual &&
+            dof_handlers.level == numbers::invalid_unsigned_int)
+          {
+            const DoFHandler<dim> *dofh = &*dof_handlers.dof_handler[no];
+            typename DoFHandler<dim>::active_cell_iterator
+            cell_it (&dofh->get_triangulation(),
+                     cell_level_index[counter].first,
+                     cell_level_index[counter].second,
+                     dofh);
+            local_dof_indices.resize (dof_info[no].dofs_per_cell[0]);
+            cell_it->get_dof_indices(local_dof_indices);
+            dof_info_target[no].read_dof_indices (local_dof_indices,
+                                                  shape_info(no,0,0,0).lexicographic_numbering,
+                                                  *constraint[no], counter-first_cell,
+                                                  constraint_values_target,
+                                                  cell_at_boundary);
+          }
+        // ok, now we are requested to use a level in a MG DoFHandler
+        else if (dof_handlers.active_dof_handler == DoFHandlers::usual &&
+                 dof_handlers.level != numbers::invalid_unsigned_int)
+          {
+            const DoFHandler<dim> *dofh = dof_handlers.dof_handler[no];
+            AssertIndexRange (dof_handlers.level, dofh->get_triangulation().n_levels());
+            typename DoFHandler<dim>::cell_iterator
+            cell_it (&dofh->get_triangulation(),
+                     cell_level_index[counter].first,
+                     cell_level_index[counter].second,
+                     dofh);
+            local_dof_indices.resize (dof_info[no].dofs_per_cell[0]);
+            cell_it->get_mg_dof_indices(local_dof_indices);
+            dof_info_target[no].read_dof_indices (local_dof_indices,
+                                                  shape_info(no,0,0,0).lexicographic_numbering,
+                                                  *constraint[no], counter-first_cell,
+                                                  constraint_values_target,
+                                                  cell_at_boundary);
+          }
+        else if (dof_handlers.active_dof_handler == DoFHandlers::hp)
+          {
+            const hp::DoFHandler<dim> *dofh =
+              dof_handlers.hp_dof_handler[no];
+            typename hp::DoFHandler<dim>::active_cell_iterator
+            cell_it (&dofh->get_triangulation(),
+                     cell_level_index[counter].first,
+                     cell_level_index[counter].second,
+                     dofh);
+            if (dofh->get_fe_collection().size() > 1)
+              dof_info_target[no].cell_active_fe_index[counter-first_cell] =
+                cell_it->active_fe_index();
+            local_dof_indices.resize (cell_it->get_fe().dofs_per_cell);
+            cell_it->get_dof_indices(local_dof_indices);
+            dof_info_target[no].read_dof_indices (local_dof_indices,
+                                                  shape_info(no,0,cell_it->active_fe_index(),0).lexicographic_numbering,
+                                                  *constraint[no], counter-first_cell,
+                                                  constraint_values_target,
+                                                  cell_at_boundary);
+          }
+        else
+          {
+            Assert (false, ExcNotImplemented());
+          }
+      }
+    return cell_at_boundary;
+  };
+
+  // if we found dofs on some FE component that belong to other processors,
+  // the cell is added to the boundary cells.
   std::vector<unsigned int> boundary_cells;
-  for (unsigned int counter = 0 ; counter < n_active_cells ; ++counter)
+
+  // On large meshes, read the indices of ranges of cells concurrently into
+  // separate DoFInfo objects, each with its own collection of constraints,
+  // and append them in the order of the cells. This gives the same result as
+  // the serial loop below. The hp case, where the cell_active_fe_index field
+  // is filled in the same loop, is always done in serial.
+  const unsigned int n_cells_per_chunk = 256;
+  if (task_info.use_multithreading == true &&
+      dof_handlers.active_dof_handler == DoFHandlers::usual &&
+      n_active_cells >= 4*n_cells_per_chunk)
     {
-      bool cell_at_boundary = false;
-      for (unsigned int no=0; no<n_fe; ++no)
+      const unsigned int n_chunks =
+        (n_active_cells + n_cells_per_chunk - 1) / n_cells_per_chunk;
+      std::vector<std::vector<internal::MatrixFreeFunctions::DoFInfo> >
+      chunk_dof_info (n_chunks, std::vector<internal::MatrixFreeFunctions::DoFInfo>(n_fe));
+      std::vector<internal::MatrixFreeFunctions::ConstraintValues<double> >
+      chunk_constraint_values (n_chunks);
+      std::vector<std::vector<unsigned int> > chunk_boundary_cells (n_chunks);
+
+      parallel::apply_to_subranges
+      (0U, n_chunks,
+       [&] (const unsigned int chunk_begin,
+            const unsigned int chunk_end)
+      {
+        std::vector<types::global_dof_index> local_dof_indices;
+        for (unsigned int chunk=chunk_begin; chunk<chunk_end; ++chunk)
+          {
+            const unsigned int first_cell = chunk * n_cells_per_chunk;
+            const unsigned int last_cell = std::min(first_cell + n_cells_per_chunk,
+                                                    n_active_cells);
+            for (unsigned int no=0; no<n_fe; ++no)
+              {
+                internal::MatrixFreeFunctions::DoFInfo &info = chunk_dof_info[chunk][no];
+                info.vector_partitioner  = dof_info[no].vector_partitioner;
+                info.dofs_per_cell       = dof_info[no].dofs_per_cell;
+                info.store_plain_indices = dof_info[no].store_plain_indices;
+                info.row_starts.resize (last_cell-first_cell+1);
+                info.row_starts[0][0] = 0;
+                info.row_starts[0][1] = 0;
+                info.row_starts[0][2] = 0;
+              }
+            for (unsigned int counter=first_cell; counter<last_cell; ++counter)
+              if (read_cell_indices (counter, first_cell, chunk_dof_info[chunk],
+                                     chunk_constraint_values[chunk],
+                                     local_dof_indices))
+                chunk_boundary_cells[chunk].push_back (counter);
+          }
+      },
+      1);
+
+      for (unsigned int chunk=0; chunk<n_chunks; ++chunk)
         {
-          // OK, read indices from standard DoFHandler in the usual way
-          if (dof_handlers.active_dof_handler == DoFHandlers::usual &&
-              dof_handlers.level == numbers::invalid_unsigned_int)
-            {
-              const DoFHandler<dim> *dofh = &*dof_handlers.dof_handler[no];
-              typename DoFHandler<dim>::active_cell_iterator
-              cell_it (&dofh->get_triangulation(),
-                       cell_level_index[counter].first,
-                       cell_level_index[counter].second,
-                       dofh);
-              local_dof_indices.resize (dof_info[no].dofs_per_cell[0]);
-              cell_it->get_dof_indices(local_dof_indices);
-              dof_info[no].read_dof_indices (local_dof_indices,
-                                             shape_info(no,0,0,0).lexicographic_numbering,
-                                             *constraint[no], counter,
-                                             constraint_values,
-                                             cell_at_boundary);
-            }
-          // ok, now we are requested to use a level in a MG DoFHandler
-          else if (dof_handlers.active_dof_handler == DoFHandlers::usual &&
-                   dof_handlers.level != numbers::invalid_unsigned_int)
-            {
-              const DoFHandler<dim> *dofh = dof_handlers.dof_handler[no];
-              AssertIndexRange (dof_handlers.level, dofh->get_triangulation().n_levels());
-              typename DoFHandler<dim>::cell_iterator
-              cell_it (&dofh->get_triangulation(),
-                       cell_level_index[counter].first,
-                       cell_level_index[counter].second,
-                       dofh);
-              local_dof_indices.resize (dof_info[no].dofs_per_cell[0]);
-              cell_it->get_mg_dof_indices(local_dof_indices);
-              dof_info[no].read_dof_indices (local_dof_indices,
-                                             shape_info(no,0,0,0).lexicographic_numbering,
-                                             *constraint[no], counter,
-                                             constraint_values,
-                                             cell_at_boundary);
-            }
-          else if (dof_handlers.active_dof_handler == DoFHandlers::hp)
-            {
-              const hp::DoFHandler<dim> *dofh =
-                dof_handlers.hp_dof_handler[no];
-              typename hp::DoFHandler<dim>::active_cell_iterator
-              cell_it (&dofh->get_triangulation(),
-                       cell_level_index[counter].first,
-                       cell_level_index[counter].second,
-                       dofh);
-              if (dofh->get_fe_collection().size() > 1)
-                dof_info[no].cell_active_fe_index[counter] =
-                  cell_it->active_fe_index();
-              local_dof_indices.resize (cell_it->get_fe().dofs_per_cell);
-              cell_it->get_dof_indices(local_dof_indices);
-              dof_info[no].read_dof_indices (local_dof_indices,
-                                             shape_info(no,0,cell_it->active_fe_index(),0).lexicographic_numbering,
-                                             *constraint[no], counter,
-                                             constraint_values,
-                                             cell_at_boundary);
-            }
-          else
+          const std::vector<unsigned short> constraint_renumbering =
+            constraint_values.insert_constraints (chunk_constraint_values[chunk]);
+          for (unsigned int no=0; no<n_fe; ++no)
             {
-              Assert (false, ExcNotImplemented());
+              dof_info[no].append_dof_indices (chunk_dof_info[chunk][no],
+                                               chunk * n_cells_per_chunk,
+                                               constraint_renumbering);
+              chunk_dof_info[chunk][no].clear();
             }
+          boundary_cells.insert (boundary_cells.end(),
+                                 chunk_boundary_cells[chunk].begin(),
+                                 chunk_boundary_cells[chunk].end());
         }
-
-      // if we found dofs on some FE component that belong to other
-      // processors, the cell is added to the boundary cells.
-      if (cell_at_boundary == true)
-        boundary_cells.push_back(counter);
     }
+  else
+    for (unsigned int counter = 0 ; counter < n_active_cells ; ++counter)
+      if (read_cell_indices (counter, 0, dof_info, constraint_values,
+                             local_dof_indices))
+        boundary_cells.push_back(counter);
 
+  timer_section.switch_to ("MatrixFree::reinit: cell reordering");
   const unsigned int vectorization_length =
     VectorizedArray<Number>::n_array_elements;
   std::vector<unsigned int> irregular_cells;
@@ -733,6 +976,8 @@ void MatrixFree<dim,Number>::initialize_indices
     AssertDimension (cell_level_index.size(),size_info.n_macro_cells*vectorization_length);
   }
 
+  timer_section.switch_to ("MatrixFree::reinit: index compression");
+
   // set constraint pool from the std::map and reorder the indices
   typename std::map<std::vector<double>, types::global_dof_index,
            internal::MatrixFreeFunctions::FPArrayComparator<double> >::iterator
@@ -765,6 +1010,16 @@ void MatrixFree<dim,Number>::initialize_indices
                                constraint_pool_row_index,
                                irregular_cells, vectorization_length);
 
+  // determine when the cell loop accesses each vector entry for the first
+  // and for the last time, needed by cell_loop() with pre and post operations
+  for (unsigned int no=0; no<n_fe; ++no)
+    dof_info[no].compute_cell_loop_pre_post_lists(size_info, vectorization_length);
+
+  // find the macro cells where the vector entries can be accessed with
+  // vectorized loads and stores
+  for (unsigned int no=0; no<n_fe; ++no)
+    dof_info[no].compute_index_storage_variants(size_info, vectorization_length);
+
   indices_are_initialized = true;
 }
 
@@ -775,6 +1030,7 @@ void MatrixFree<dim,Number>::clear()
 {
   dof_info.clear();
   mapping_info.clear();
+  face_info.clear();
   cell_level_index.clear();
   size_info.clear();
   task_info.clear();
@@ -797,10 +1053,31 @@ std::size_t MatrixFree<dim,Number>::memory_consumption () const
   memory += MemoryConsumption::memory_consumption (task_info);
   memory += sizeof(*this);
   memory += mapping_info.memory_consumption();
+  memory += face_info.memory_consumption();
   return memory;
 }
 
 
+
+template <int dim, typename Number>
+MemoryReport MatrixFree<dim,Number>::memory_report () const
+{
+  MemoryReport report ("MatrixFree", sizeof(*this));
+  for (unsigned int j=0; j<dof_info.size(); ++ j)
+    report.add (dof_info[j].memory_report("DoFInfo component " +
+                                          Utilities::int_to_string(j)));
+  report.add ("mapping info", mapping_info.memory_consumption());
+  report.add ("shape info", MemoryConsumption::memory_consumption (shape_info));
+  report.add ("constraint pool",
+              MemoryConsumption::memory_consumption (constraint_pool_data) +
+              MemoryConsumption::memory_consumption (constraint_pool_row_index));
+  report.add ("cell index", MemoryConsumption::memory_consumption (cell_level_index));
+  report.add ("task info", MemoryConsumption::memory_consumption (task_info));
+  report.add ("face info", face_info.memory_consumption());
+  return report;
+}
+
+
 template <int dim, typename Number>
 template <typename StreamType>
 void MatrixFree<dim,Number>::print_memory_consumption (StreamType &out) const
@@ -869,6 +1146,7 @@ namespace internal
       use_multithreading = false;
       use_partition_partition = false;
       use_coloring_only = false;
+      use_dependency_graph = false;
       partition_color_blocks_row_index.clear();
       partition_color_blocks_data.clear();
       evens = 0;
@@ -879,6 +1157,10 @@ namespace internal
       partition_odds.clear();
       partition_n_blocked_workers.clear();
       partition_n_workers.clear();
+      block_successors_row_index.clear();
+      block_successors.clear();
+      block_n_predecessors.clear();
+      n_boundary_blocks = 0;
     }
 
 
@@ -892,7 +1174,10 @@ namespace internal
               MemoryConsumption::memory_consumption (partition_evens) +
               MemoryConsumption::memory_consumption (partition_odds) +
               MemoryConsumption::memory_consumption (partition_n_blocked_workers) +
-              MemoryConsumption::memory_consumption (partition_n_workers));
+              MemoryConsumption::memory_consumption (partition_n_workers) +
+              MemoryConsumption::memory_consumption (block_successors_row_index) +
+              MemoryConsumption::memory_consumption (block_successors) +
+              MemoryConsumption::memory_consumption (block_n_predecessors));
     }
 
 
@@ -18,12 +18,15 @@
 #define dealii_matrix_free_operators_h
 
 
+#include <deal.II/base/array_view.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/vectorization.h>
 #include <deal.II/base/subscriptor.h>
 
 #include <deal.II/lac/diagonal_matrix.h>
 #include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/tensor_product_matrix.h>
 #include <deal.II/multigrid/mg_constrained_dofs.h>
 #include <deal.II/matrix_free/matrix_free.h>
 #include <deal.II/matrix_free/fe_evaluation.h>
@@ -276,6 +279,32 @@ namespace MatrixFreeOperators
     void vmult (VectorType &dst,
                 const VectorType &src) const;
 
+    /**
+     * Matrix-vector multiplication that additionally runs the operation @p
+     * operation_before_matrix_vector_product on ranges
+     * <code>[begin,end)</code> of locally owned vector entries before they
+     * are accessed by the matrix-vector product, and the operation @p
+     * operation_after_matrix_vector_product on ranges of the entries of @p
+     * dst once their values are final. The ranges are in the local index
+     * space of the vectors, i.e., they can be used with
+     * <code>local_element()</code> or the pointer returned by
+     * <code>begin()</code>. Empty function objects are skipped.
+     *
+     * For operators whose apply_add_with_operations() runs the operations
+     * inside MatrixFree::cell_loop(), this allows to fuse vector updates
+     * with the matrix-vector product, e.g. for the Chebyshev iteration in
+     * PreconditionChebyshev, and to go through the vectors once instead of
+     * several times. Otherwise, the operations are simply called before and
+     * after the product on the whole locally owned range.
+     *
+     * This function is only available for a single (non-block) vector
+     * component.
+     */
+    void vmult (VectorType &dst,
+                const VectorType &src,
+                const std::function<void(const unsigned int, const unsigned int)> &operation_before_matrix_vector_product,
+                const std::function<void(const unsigned int, const unsigned int)> &operation_after_matrix_vector_product) const;
+
     /**
      * Transpose matrix-vector multiplication.
      */
@@ -381,6 +410,25 @@ namespace MatrixFreeOperators
     virtual void Tapply_add(VectorType &dst,
                             const VectorType &src) const;
 
+    /**
+     * Apply operator to @p src and add result in @p dst, running the given
+     * operations on ranges of locally owned vector entries before they are
+     * first accessed and after their values are final, respectively, see
+     * the vmult() function with the same arguments.
+     *
+     * The default implementation calls @p operation_before_loop on the whole
+     * locally owned range, then apply_add(), and finally @p
+     * operation_after_loop. Derived classes that implement apply_add()
+     * through MatrixFree::cell_loop() should override this function and
+     * pass the two operations to the cell loop, as done by MassOperator and
+     * LaplaceOperator.
+     */
+    virtual void apply_add_with_operations
+    (VectorType       &dst,
+     const VectorType &src,
+     const std::function<void(const unsigned int, const unsigned int)> &operation_before_loop,
+     const std::function<void(const unsigned int, const unsigned int)> &operation_after_loop) const;
+
     /**
      * MatrixFree object to be used with this operator.
      */
@@ -650,6 +698,16 @@ namespace MatrixFreeOperators
     virtual void apply_add (VectorType       &dst,
                             const VectorType &src) const;
 
+    /**
+     * Same as apply_add(), but running the given operations inside the cell
+     * loop.
+     */
+    virtual void apply_add_with_operations
+    (VectorType       &dst,
+     const VectorType &src,
+     const std::function<void(const unsigned int, const unsigned int)> &operation_before_loop,
+     const std::function<void(const unsigned int, const unsigned int)> &operation_after_loop) const;
+
     /**
      * For this operator, there is just a cell contribution.
      */
@@ -723,13 +781,13 @@ namespace MatrixFreeOperators
      *     {
      *       fe_eval.reinit(cell);
      *       for (unsigned int q=0; q<n_q_points; ++q)
-     *         (*coefficient)(cell,q) = function.value(fe_eval.quadrature_point(q));
+     *         (*coefficient)(cell,q) =
+     *           function.vectorized_value(fe_eval.quadrature_point(q));
      *     }
      * }
      * @endcode
      * where <code>mf_data</code> is a MatrixFree object and <code>function</code>
-     * is a function which provides the following method
-     * <code>VectorizedArray<double> value(const Point<dim, VectorizedArray<double> > &p_vec)</code>.
+     * is a Function<dim>, see Function::vectorized_value().
      *
      * If this function is not called, the coefficient is assumed to be unity.
      *
@@ -763,6 +821,16 @@ namespace MatrixFreeOperators
     virtual void apply_add (VectorType       &dst,
                             const VectorType &src) const;
 
+    /**
+     * Same as apply_add(), but running the given operations inside the cell
+     * loop.
+     */
+    virtual void apply_add_with_operations
+    (VectorType       &dst,
+     const VectorType &src,
+     const std::function<void(const unsigned int, const unsigned int)> &operation_before_loop,
+     const std::function<void(const unsigned int, const unsigned int)> &operation_after_loop) const;
+
     /**
      * Applies the Laplace operator on a cell.
      */
@@ -793,6 +861,192 @@ namespace MatrixFreeOperators
 
 
 
+  /**
+   * This class implements a block-Jacobi preconditioner for discontinuous
+   * Galerkin discretizations of the operator $-\nabla \cdot (\alpha \nabla
+   * u) + \beta u$ with the symmetric interior penalty method, where each
+   * block is given by the degrees of freedom of a cell. The cell matrices are
+   * approximated by separable operators that are inverted by the fast
+   * diagonalization method. On each cell, the matrix is given as the sum of
+   * Kronecker products
+   * @f{align*}{
+   * A = \sum_{d=1}^{dim} M_{dim}\otimes \cdots \otimes (\alpha L_d + \frac{\beta}{dim} M_d)
+   *     \otimes \cdots \otimes M_1,
+   * @f}
+   * where $M_d$ are the 1D mass matrices and $L_d$ the 1D Laplace matrices
+   * including the cell-local part of the interior penalty face terms in the
+   * respective direction. The inverse is applied through the 1D eigenvectors
+   * and eigenvalues stored in TensorProductMatrixSymmetricSum, which costs
+   * about as much as a matrix-vector product on the cell. All operations are
+   * done on the batches of cells of the MatrixFree framework within a
+   * MatrixFree::cell_loop(), i.e., the eigendecompositions and their
+   * application are vectorized over several cells.
+   *
+   * The 1D matrices are computed from the extent of the cells in the
+   * respective coordinate direction and are exact for axis-parallel cells
+   * with constant coefficients. On deformed cells, the separable operator is
+   * an approximation of the cell matrix, which is usually still an efficient
+   * preconditioner or smoother. All boundary faces are assumed to carry
+   * Dirichlet boundary conditions imposed weakly by the interior penalty
+   * method. The penalty parameter on the faces of a cell of extent $h$ in the
+   * normal direction is taken as <code>penalty_factor * (fe_degree+1)^2 /
+   * h</code>, which should be matched by the penalty parameter of the
+   * operator.
+   *
+   * The class provides the interface of the relaxation classes in
+   * precondition.h, and can in particular be used as a smoother in multigrid
+   * through MGSmootherPrecondition, where the
+   * AdditionalData::relaxation parameter controls the damping:
+   * @code
+   * typedef PreconditionFastDiagonalization<dim,fe_degree> SmootherType;
+   * MGSmootherPrecondition<LevelMatrixType,SmootherType,VectorType> mg_smoother;
+   * mg_smoother.initialize(mg_matrices, SmootherType::AdditionalData(0., 1., penalty_factor));
+   * @endcode
+   * The level matrices must be derived from MatrixFreeOperators::Base or
+   * provide another function <code>get_matrix_free()</code> returning a
+   * shared pointer to the MatrixFree object to work on.
+   *
+   * This class requires LAPACK support for computing the generalized
+   * eigenvalues and eigenvectors of the 1D matrices. Only scalar elements of
+   * type FE_DGQ and its variants with $(fe_degree+1)^{dim}$ degrees of
+   * freedom on each cell are supported.
+   */
+  template <int dim, int fe_degree, int n_q_points_1d = fe_degree+1, typename VectorType = LinearAlgebra::distributed::Vector<double> >
+  class PreconditionFastDiagonalization : public Subscriptor
+  {
+  public:
+    /**
+     * Number typedef.
+     */
+    typedef typename VectorType::value_type value_type;
+
+    /**
+     * size_type needed for preconditioner classes.
+     */
+    typedef typename VectorType::size_type size_type;
+
+    /**
+     * Parameters for the operator whose cell matrices are inverted.
+     */
+    struct AdditionalData
+    {
+      /**
+       * Constructor.
+       */
+      AdditionalData (const double       mass_coefficient = 0.,
+                      const double       laplace_coefficient = 1.,
+                      const double       penalty_factor = 1.,
+                      const double       relaxation = 1.,
+                      const unsigned int dof_index = 0,
+                      const unsigned int quad_index = 0);
+
+      /**
+       * The coefficient $\beta$ of the mass term.
+       */
+      double mass_coefficient;
+
+      /**
+       * The coefficient $\alpha$ of the Laplace term.
+       */
+      double laplace_coefficient;
+
+      /**
+       * The factor in the penalty parameter of the interior penalty method.
+       */
+      double penalty_factor;
+
+      /**
+       * The damping factor the inverse cell matrices are multiplied with.
+       */
+      double relaxation;
+
+      /**
+       * The index of the DoFHandler in the MatrixFree object.
+       */
+      unsigned int dof_index;
+
+      /**
+       * The index of the quadrature formula in the MatrixFree object that is
+       * used for constructing the FEEvaluation object. The 1D matrices are
+       * always integrated exactly, independent of this choice.
+       */
+      unsigned int quad_index;
+    };
+
+    /**
+     * Constructor.
+     */
+    PreconditionFastDiagonalization ();
+
+    /**
+     * Initialize the preconditioner with the MatrixFree object of the given
+     * operator, which must provide a function <code>get_matrix_free()</code>.
+     */
+    template <typename MatrixType>
+    void initialize (const MatrixType     &matrix,
+                     const AdditionalData &additional_data = AdditionalData());
+
+    /**
+     * Compute the 1D matrices and their eigendecompositions on all cells of
+     * the given MatrixFree object.
+     */
+    void initialize (const std::shared_ptr<const MatrixFree<dim,value_type> > &matrix_free,
+                     const AdditionalData                                    &additional_data = AdditionalData());
+
+    /**
+     * Release all memory and return to a state just like after having called
+     * the default constructor.
+     */
+    void clear ();
+
+    /**
+     * Apply the (damped) inverse of the cell matrices to @p src and write
+     * the result into @p dst.
+     */
+    void vmult (VectorType       &dst,
+                const VectorType &src) const;
+
+    /**
+     * Apply the transpose of the preconditioner, which is the same as
+     * vmult() since the cell matrices are symmetric.
+     */
+    void Tvmult (VectorType       &dst,
+                 const VectorType &src) const;
+
+    /**
+     * Determine an estimate for the memory consumption (in bytes) of this
+     * object.
+     */
+    std::size_t memory_consumption () const;
+
+  private:
+    /**
+     * Apply the inverse of the cell matrices on a range of cell batches.
+     */
+    void local_apply_inverse (const MatrixFree<dim,value_type>            &data,
+                              VectorType                                  &dst,
+                              const VectorType                            &src,
+                              const std::pair<unsigned int,unsigned int>  &cell_range) const;
+
+    /**
+     * The MatrixFree object the preconditioner is applied on.
+     */
+    std::shared_ptr<const MatrixFree<dim,value_type> > data;
+
+    /**
+     * The parameters given to initialize().
+     */
+    AdditionalData additional_data;
+
+    /**
+     * The separable cell matrices and their eigendecompositions for each
+     * batch of cells.
+     */
+    std::vector<TensorProductMatrixSymmetricSum<dim,VectorizedArray<value_type>,fe_degree+1> > cell_matrices;
+  };
+
+
+
   // ------------------------------------ inline functions ---------------------
 
   template <int dim, int fe_degree, int n_components, typename Number>
@@ -1153,6 +1407,70 @@ namespace MatrixFreeOperators
 
 
 
+  template <int dim, typename VectorType>
+  void
+  Base<dim,VectorType>::
+  vmult (VectorType       &dst,
+         const VectorType &src,
+         const std::function<void(const unsigned int, const unsigned int)> &operation_before_matrix_vector_product,
+         const std::function<void(const unsigned int, const unsigned int)> &operation_after_matrix_vector_product) const
+  {
+    typedef typename Base<dim,VectorType>::value_type Number;
+    AssertDimension(dst.size(), src.size());
+    AssertDimension(n_blocks(dst), n_blocks(src));
+    AssertDimension(n_blocks(dst), selected_rows.size());
+    AssertThrow(n_blocks(dst) == 1,
+                ExcMessage("The vmult() function with operations before and "
+                           "after the matrix-vector product is only "
+                           "implemented for a single vector component."));
+    preprocess_constraints (dst,src);
+
+    // the entries of dst are set to zero by the operation before the loop,
+    // so make sure the ghost range that collects the contributions to other
+    // processors starts from zero as well
+    subblock(dst,0).zero_out_ghosts();
+
+    const std::vector<unsigned int> &constrained_dofs =
+      data->get_constrained_dofs(selected_rows[0]);
+    const std::vector<unsigned int> &edge_indices = edge_constrained_indices[0];
+
+    apply_add_with_operations
+    (dst, src,
+     [&](const unsigned int begin, const unsigned int end)
+    {
+      Number *dst_ptr = subblock(dst,0).begin();
+      for (unsigned int i=begin; i<end; ++i)
+        dst_ptr[i] = Number();
+      if (operation_before_matrix_vector_product)
+        operation_before_matrix_vector_product(begin, end);
+    },
+    [&](const unsigned int begin, const unsigned int end)
+    {
+      // the part of postprocess_constraints() on the current range, with
+      // the zero initial value of dst: unit rows on constrained dofs and on
+      // the refinement edge, where the input values get restored
+      for (std::vector<unsigned int>::const_iterator
+           it = std::lower_bound(constrained_dofs.begin(),
+                                 constrained_dofs.end(), begin);
+           it != constrained_dofs.end() && *it < end; ++it)
+        subblock(dst,0).local_element(*it) = subblock(src,0).local_element(*it);
+      for (unsigned int i = std::lower_bound(edge_indices.begin(),
+                                             edge_indices.end(), begin) -
+                            edge_indices.begin();
+           i < edge_indices.size() && edge_indices[i] < end; ++i)
+        {
+          subblock(const_cast<VectorType &>(src),0).local_element(edge_indices[i])
+            = edge_constrained_values[0][i].first;
+          subblock(dst,0).local_element(edge_indices[i])
+            = edge_constrained_values[0][i].first;
+        }
+      if (operation_after_matrix_vector_product)
+        operation_after_matrix_vector_product(begin, end);
+    });
+  }
+
+
+
   template <int dim, typename VectorType>
   void
   Base<dim,VectorType>::vmult_add (VectorType &dst,
@@ -1436,6 +1754,25 @@ namespace MatrixFreeOperators
 
 
 
+  template <int dim, typename VectorType>
+  void
+  Base<dim,VectorType>::
+  apply_add_with_operations
+  (VectorType       &dst,
+   const VectorType &src,
+   const std::function<void(const unsigned int, const unsigned int)> &operation_before_loop,
+   const std::function<void(const unsigned int, const unsigned int)> &operation_after_loop) const
+  {
+    const unsigned int local_size = subblock(dst,0).local_size();
+    if (operation_before_loop)
+      operation_before_loop(0, local_size);
+    apply_add(dst,src);
+    if (operation_after_loop)
+      operation_after_loop(0, local_size);
+  }
+
+
+
   template <int dim, typename VectorType>
   void
   Base<dim,VectorType>::precondition_Jacobi(VectorType &dst,
@@ -1589,6 +1926,24 @@ namespace MatrixFreeOperators
 
 
 
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components, typename VectorType>
+  void
+  MassOperator<dim, fe_degree, n_q_points_1d, n_components, VectorType>::
+  apply_add_with_operations
+  (VectorType       &dst,
+   const VectorType &src,
+   const std::function<void(const unsigned int, const unsigned int)> &operation_before_loop,
+   const std::function<void(const unsigned int, const unsigned int)> &operation_after_loop) const
+  {
+    Base<dim, VectorType>::data->cell_loop (&MassOperator::local_apply_cell,
+                                            this, dst, src,
+                                            operation_before_loop,
+                                            operation_after_loop,
+                                            this->selected_rows[0]);
+  }
+
+
+
   template <int dim, int fe_degree, int n_q_points_1d, int n_components, typename VectorType>
   void
   MassOperator<dim, fe_degree, n_q_points_1d, n_components, VectorType>::
@@ -1703,6 +2058,24 @@ namespace MatrixFreeOperators
                                             this, dst, src);
   }
 
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components, typename VectorType>
+  void
+  LaplaceOperator<dim, fe_degree, n_q_points_1d, n_components, VectorType>::
+  apply_add_with_operations
+  (VectorType       &dst,
+   const VectorType &src,
+   const std::function<void(const unsigned int, const unsigned int)> &operation_before_loop,
+   const std::function<void(const unsigned int, const unsigned int)> &operation_after_loop) const
+  {
+    Base<dim, VectorType>::data->cell_loop (&LaplaceOperator::local_apply_cell,
+                                            this, dst, src,
+                                            operation_before_loop,
+                                            operation_after_loop,
+                                            this->selected_rows[0]);
+  }
+
   namespace
   {
     template <typename Number>
@@ -1797,6 +2170,227 @@ namespace MatrixFreeOperators
   }
 
 
+  //------------------------- PreconditionFastDiagonalization ----------------
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename VectorType>
+  PreconditionFastDiagonalization<dim, fe_degree, n_q_points_1d, VectorType>::
+  AdditionalData::AdditionalData (const double       mass_coefficient,
+                                  const double       laplace_coefficient,
+                                  const double       penalty_factor,
+                                  const double       relaxation,
+                                  const unsigned int dof_index,
+                                  const unsigned int quad_index)
+    :
+    mass_coefficient (mass_coefficient),
+    laplace_coefficient (laplace_coefficient),
+    penalty_factor (penalty_factor),
+    relaxation (relaxation),
+    dof_index (dof_index),
+    quad_index (quad_index)
+  {}
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename VectorType>
+  PreconditionFastDiagonalization<dim, fe_degree, n_q_points_1d, VectorType>::
+  PreconditionFastDiagonalization ()
+  {}
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename VectorType>
+  template <typename MatrixType>
+  void
+  PreconditionFastDiagonalization<dim, fe_degree, n_q_points_1d, VectorType>::
+  initialize (const MatrixType     &matrix,
+              const AdditionalData &additional_data)
+  {
+    initialize (matrix.get_matrix_free(), additional_data);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename VectorType>
+  void
+  PreconditionFastDiagonalization<dim, fe_degree, n_q_points_1d, VectorType>::
+  initialize (const std::shared_ptr<const MatrixFree<dim,value_type> > &matrix_free,
+              const AdditionalData                                    &additional_data_in)
+  {
+    Assert (matrix_free.get() != nullptr, ExcNotInitialized());
+    data = matrix_free;
+    additional_data = additional_data_in;
+
+    const FiniteElement<dim> &fe =
+      data->get_dof_handler(additional_data.dof_index).get_fe();
+    AssertThrow (fe.n_components() == 1 && fe.dofs_per_face == 0 &&
+                 fe.dofs_per_cell == Utilities::fixed_power<dim>(static_cast<unsigned int>(fe_degree+1)),
+                 ExcMessage("PreconditionFastDiagonalization is only "
+                            "implemented for scalar discontinuous elements "
+                            "with (fe_degree+1)^dim degrees of freedom per "
+                            "cell."));
+    AssertDimension (fe.degree, static_cast<unsigned int>(fe_degree));
+
+    // compute the 1D mass and Laplace matrices on the unit interval with a
+    // quadrature formula that integrates them exactly. As the numbering of
+    // the 1D shape functions is the same as in FEEvaluation, the resulting
+    // tensor product matrices act on the lexicographic cell vectors.
+    typedef VectorizedArray<value_type> VectorizedArrayType;
+    const unsigned int n_dofs_1d = fe_degree+1;
+    const QGauss<1> quadrature (fe_degree+1);
+    const internal::MatrixFreeFunctions::ShapeInfo<VectorizedArrayType>
+    shape_info (quadrature, fe, 0);
+    const unsigned int n_q_points = quadrature.size();
+    FullMatrix<double> mass_1d (n_dofs_1d, n_dofs_1d),
+               laplace_1d (n_dofs_1d, n_dofs_1d);
+    for (unsigned int i=0; i<n_dofs_1d; ++i)
+      for (unsigned int j=0; j<n_dofs_1d; ++j)
+        for (unsigned int q=0; q<n_q_points; ++q)
+          {
+            mass_1d(i,j) += quadrature.weight(q) *
+                            shape_info.shape_values[i*n_q_points+q][0] *
+                            shape_info.shape_values[j*n_q_points+q][0];
+            laplace_1d(i,j) += quadrature.weight(q) *
+                               shape_info.shape_gradients[i*n_q_points+q][0] *
+                               shape_info.shape_gradients[j*n_q_points+q][0];
+          }
+
+    const unsigned int n_lanes = VectorizedArrayType::n_array_elements;
+    const double penalty_scaling = additional_data.penalty_factor *
+                                   (fe_degree+1) * (fe_degree+1);
+    cell_matrices.resize (data->n_macro_cells());
+    std::array<Table<2,VectorizedArrayType>,dim> mass_matrices, laplace_matrices;
+    for (unsigned int d=0; d<dim; ++d)
+      {
+        mass_matrices[d].reinit (n_dofs_1d, n_dofs_1d);
+        laplace_matrices[d].reinit (n_dofs_1d, n_dofs_1d);
+      }
+    for (unsigned int cell=0; cell<data->n_macro_cells(); ++cell)
+      {
+        const unsigned int n_filled = data->n_components_filled(cell);
+        for (unsigned int v=0; v<n_lanes; ++v)
+          {
+            // fill the unused lanes with the data of the first cell to get
+            // invertible matrices
+            const typename DoFHandler<dim>::cell_iterator dcell =
+              data->get_cell_iterator(cell, v < n_filled ? v : 0,
+                                      additional_data.dof_index);
+            for (unsigned int d=0; d<dim; ++d)
+              {
+                const double h = (dcell->vertex(1<<d) - dcell->vertex(0)).norm();
+                const double penalty = penalty_scaling / h;
+                for (unsigned int i=0; i<n_dofs_1d; ++i)
+                  for (unsigned int j=0; j<n_dofs_1d; ++j)
+                    {
+                      double laplace = laplace_1d(i,j) / h;
+
+                      // cell-local part of the interior penalty terms on
+                      // the left (normal -1) and right (normal +1) face. On
+                      // interior faces, the average of the normal derivative
+                      // only contains half the contribution of the cell
+                      for (unsigned int side=0; side<2; ++side)
+                        {
+                          const double factor = dcell->at_boundary(2*d+side) ? 1. : 0.5;
+                          const double normal = side == 0 ? -1. : 1.;
+                          const VectorizedArrayType *face_data =
+                            shape_info.shape_data_on_face[side].begin();
+                          const double value_i = face_data[i][0];
+                          const double value_j = face_data[j][0];
+                          const double grad_i = face_data[n_dofs_1d+i][0] / h;
+                          const double grad_j = face_data[n_dofs_1d+j][0] / h;
+                          laplace += - factor * normal * (grad_i * value_j +
+                                                          value_i * grad_j)
+                                     + penalty * value_i * value_j;
+                        }
+                      mass_matrices[d](i,j)[v] = h * mass_1d(i,j);
+                      laplace_matrices[d](i,j)[v] =
+                        additional_data.laplace_coefficient * laplace +
+                        additional_data.mass_coefficient / dim * h * mass_1d(i,j);
+                    }
+              }
+          }
+        cell_matrices[cell].reinit (mass_matrices, laplace_matrices);
+      }
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename VectorType>
+  void
+  PreconditionFastDiagonalization<dim, fe_degree, n_q_points_1d, VectorType>::
+  clear ()
+  {
+    data.reset();
+    cell_matrices.clear();
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename VectorType>
+  void
+  PreconditionFastDiagonalization<dim, fe_degree, n_q_points_1d, VectorType>::
+  vmult (VectorType       &dst,
+         const VectorType &src) const
+  {
+    Assert (data.get() != nullptr, ExcNotInitialized());
+    dst = 0;
+    data->cell_loop (&PreconditionFastDiagonalization::local_apply_inverse,
+                     this, dst, src);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename VectorType>
+  void
+  PreconditionFastDiagonalization<dim, fe_degree, n_q_points_1d, VectorType>::
+  Tvmult (VectorType       &dst,
+          const VectorType &src) const
+  {
+    vmult (dst, src);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename VectorType>
+  std::size_t
+  PreconditionFastDiagonalization<dim, fe_degree, n_q_points_1d, VectorType>::
+  memory_consumption () const
+  {
+    // the tensor product matrices store 4*dim 1D matrices per batch of cells
+    return sizeof(*this) + cell_matrices.size() *
+           (sizeof(cell_matrices[0]) + 4 * dim * (fe_degree+1) * (fe_degree+1) *
+            sizeof(VectorizedArray<value_type>));
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, typename VectorType>
+  void
+  PreconditionFastDiagonalization<dim, fe_degree, n_q_points_1d, VectorType>::
+  local_apply_inverse (const MatrixFree<dim,value_type>            &data,
+                       VectorType                                  &dst,
+                       const VectorType                            &src,
+                       const std::pair<unsigned int,unsigned int>  &cell_range) const
+  {
+    FEEvaluation<dim,fe_degree,n_q_points_1d,1,value_type>
+    phi (data, additional_data.dof_index, additional_data.quad_index);
+    const unsigned int dofs_per_cell = phi.dofs_per_cell;
+    AlignedVector<VectorizedArray<value_type> > local_src (dofs_per_cell);
+    const VectorizedArray<value_type> relaxation =
+      make_vectorized_array<value_type>(additional_data.relaxation);
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+      {
+        phi.reinit (cell);
+        phi.read_dof_values (src);
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          local_src[i] = relaxation * phi.begin_dof_values()[i];
+        cell_matrices[cell].apply_inverse
+        (ArrayView<VectorizedArray<value_type> >(phi.begin_dof_values(), dofs_per_cell),
+         ArrayView<const VectorizedArray<value_type> >(local_src.begin(), dofs_per_cell));
+        phi.distribute_local_to_global (dst);
+      }
+  }
+
+
 } // end of namespace MatrixFreeOperators
 
 
@@ -72,7 +72,19 @@ namespace internal
        * of the unit interval 0.5 that additionally add a constant shape
        * function according to FE_Q_DG0.
        */
-      tensor_symmetric_plus_dg0 = 5
+      tensor_symmetric_plus_dg0 = 5,
+      /**
+       * The vector-valued shape functions of FE_RaviartThomasNodal. Each
+       * vector component is an anisotropic tensor product of 1D Lagrange
+       * polynomials, with degree <code>fe_degree+1</code> in the direction
+       * of the component (stored in the fields @p shape_values_normal and @p
+       * shape_gradients_normal) and degree <code>fe_degree</code> in the
+       * other directions (stored in @p shape_values and @p shape_gradients).
+       * FEEvaluation evaluates the values and gradients on the unit cell, to
+       * be transformed with the contravariant Piola transformation. Hessians
+       * and face integrals are not supported for this element type.
+       */
+      tensor_raviart_thomas = 6
     };
 
     /**
@@ -133,6 +145,23 @@ namespace internal
        */
       AlignedVector<Number> shape_values;
 
+      /**
+       * For the element type tensor_raviart_thomas, stores the shape values
+       * of the 1D polynomials in the direction of the vector component,
+       * which have one degree more than the ones stored in @p shape_values.
+       * The length of this array is <tt>(n_dofs_1d+1) * n_q_points_1d</tt>
+       * and quadrature points are the index running fastest. Empty for all
+       * other element types.
+       */
+      AlignedVector<Number> shape_values_normal;
+
+      /**
+       * For the element type tensor_raviart_thomas, stores the gradients of
+       * the 1D polynomials in the direction of the vector component, in the
+       * same layout as @p shape_values_normal.
+       */
+      AlignedVector<Number> shape_gradients_normal;
+
       /**
        * Stores the shape gradients of the 1D finite element evaluated on all
        * 1D quadrature points in vectorized format, i.e., as an array of
@@ -347,6 +376,17 @@ namespace internal
        * that save some operations in the evaluation.
        */
       bool check_1d_shapes_collocation();
+
+      /**
+       * Initialize the data fields for the element type
+       * tensor_raviart_thomas. The 1D polynomials are the Lagrange
+       * polynomials in the points of the node functionals of
+       * FE_RaviartThomasNodal, and the numbering of the degrees of freedom is
+       * found by evaluating the shape functions in these points.
+       */
+      template <int dim>
+      void reinit_raviart_thomas (const Quadrature<1>      &quad,
+                                  const FiniteElement<dim> &fe);
     };
 
 
@@ -22,10 +22,12 @@
 #include <deal.II/base/polynomial.h>
 #include <deal.II/base/tensor_product_polynomials.h>
 #include <deal.II/base/polynomials_piecewise.h>
+#include <deal.II/base/quadrature_lib.h>
 #include <deal.II/fe/fe_poly.h>
 #include <deal.II/fe/fe_dgp.h>
 #include <deal.II/fe/fe_dgq.h>
 #include <deal.II/fe/fe_q_dg0.h>
+#include <deal.II/fe/fe_raviart_thomas.h>
 
 #include <deal.II/matrix_free/shape_info.h>
 
@@ -79,6 +81,13 @@ namespace internal
     {
       const FiniteElement<dim> *fe = &fe_in.base_element(base_element_number);
 
+      if (dynamic_cast<const FE_RaviartThomasNodal<dim>*>(fe) != nullptr)
+        {
+          Assert (fe_in.n_base_elements() == 1, ExcNotImplemented());
+          reinit_raviart_thomas (quad, *fe);
+          return;
+        }
+
       Assert (fe->n_components() == 1,
               ExcMessage("FEEvaluation only works for scalar finite elements."));
 
@@ -370,6 +379,114 @@ namespace internal
 
 
 
+    template <typename Number>
+    template <int dim>
+    void
+    ShapeInfo<Number>::reinit_raviart_thomas (const Quadrature<1>      &quad,
+                                              const FiniteElement<dim> &fe)
+    {
+      element_type = tensor_raviart_thomas;
+
+      // the degree of FE_RaviartThomasNodal is the degree in the direction
+      // of the vector component, so store the degree in the other directions
+      Assert (fe.degree > 0, ExcInternalError());
+      fe_degree = fe.degree - 1;
+      n_q_points_1d = quad.size();
+      const unsigned int n_dofs_1d = fe_degree + 1;
+
+      n_q_points      = Utilities::fixed_power<dim>(n_q_points_1d);
+      dofs_per_cell   = fe.dofs_per_cell / dim;
+      n_q_points_face = dim>1?Utilities::fixed_power<dim-1>(n_q_points_1d):1;
+      dofs_per_face   = fe.dofs_per_face;
+      nodal_at_cell_boundaries = false;
+      AssertDimension (dofs_per_cell * dim, fe.dofs_per_cell);
+      AssertDimension (dofs_per_cell, (n_dofs_1d+1) * (dim>1 ?
+                                                       Utilities::fixed_power<dim-1>(n_dofs_1d) :
+                                                       1));
+
+      // the node functionals of FE_RaviartThomasNodal are point values of the
+      // vector components: In the direction of the component, the points are
+      // the two end points and the Gauss points of the interior and in the
+      // other directions the Gauss points with one point more. Hence, the
+      // shape functions are tensor products of the Lagrange polynomials in
+      // these points
+      std::vector<Point<1> > tangential_points = QGauss<1>(n_dofs_1d).get_points();
+      std::vector<Point<1> > normal_points (1, Point<1>(0.));
+      if (fe_degree > 0)
+        {
+          const std::vector<Point<1> > inner_points = QGauss<1>(fe_degree).get_points();
+          normal_points.insert (normal_points.end(), inner_points.begin(),
+                                inner_points.end());
+        }
+      normal_points.push_back (Point<1>(1.));
+
+      const std::vector<Polynomials::Polynomial<double> >
+      tangential_polynomials =
+        Polynomials::generate_complete_Lagrange_basis(tangential_points),
+        normal_polynomials =
+          Polynomials::generate_complete_Lagrange_basis(normal_points);
+
+      shape_values.resize_fast (n_dofs_1d*n_q_points_1d);
+      shape_gradients.resize_fast (n_dofs_1d*n_q_points_1d);
+      shape_values_normal.resize_fast ((n_dofs_1d+1)*n_q_points_1d);
+      shape_gradients_normal.resize_fast ((n_dofs_1d+1)*n_q_points_1d);
+      std::vector<double> value_and_derivative (2);
+      for (unsigned int q=0; q<n_q_points_1d; ++q)
+        {
+          for (unsigned int i=0; i<n_dofs_1d; ++i)
+            {
+              tangential_polynomials[i].value (quad.point(q)[0], value_and_derivative);
+              shape_values[i*n_q_points_1d+q] = value_and_derivative[0];
+              shape_gradients[i*n_q_points_1d+q] = value_and_derivative[1];
+            }
+          for (unsigned int i=0; i<n_dofs_1d+1; ++i)
+            {
+              normal_polynomials[i].value (quad.point(q)[0], value_and_derivative);
+              shape_values_normal[i*n_q_points_1d+q] = value_and_derivative[0];
+              shape_gradients_normal[i*n_q_points_1d+q] = value_and_derivative[1];
+            }
+        }
+
+      // find the shape function that is one in the point of each node
+      // functional, ordering the components one after another and the
+      // degrees of freedom within the components lexicographically
+      lexicographic_numbering.resize (fe.dofs_per_cell);
+      std::vector<bool> dof_is_assigned (fe.dofs_per_cell, false);
+      for (unsigned int c=0; c<dim; ++c)
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          {
+            Point<dim> point;
+            for (unsigned int d=0, index=i; d<dim; ++d)
+              {
+                const unsigned int n = (d == c) ? n_dofs_1d+1 : n_dofs_1d;
+                point[d] = (d == c) ? normal_points[index%n][0] :
+                           tangential_points[index%n][0];
+                index /= n;
+              }
+
+            unsigned int dof = 0;
+            double max_value = 0;
+            for (unsigned int j=0; j<fe.dofs_per_cell; ++j)
+              {
+                const double value = fe.shape_value_component (j, point, c);
+                if (std::abs(value) > std::abs(max_value))
+                  {
+                    max_value = value;
+                    dof = j;
+                  }
+              }
+            AssertThrow (std::abs(max_value-1.) < 1e-10 &&
+                         dof_is_assigned[dof] == false,
+                         ExcMessage("Could not identify the tensor product "
+                                    "shape functions of the element " +
+                                    fe.get_name()));
+            dof_is_assigned[dof] = true;
+            lexicographic_numbering[c*dofs_per_cell+i] = dof;
+          }
+    }
+
+
+
     template <typename Number>
     bool
     ShapeInfo<Number>::check_1d_shapes_symmetric(const unsigned int n_q_points_1d)
@@ -507,6 +624,8 @@ namespace internal
       std::size_t memory = sizeof(*this);
       memory += MemoryConsumption::memory_consumption(shape_values);
       memory += MemoryConsumption::memory_consumption(shape_gradients);
+      memory += MemoryConsumption::memory_consumption(shape_values_normal);
+      memory += MemoryConsumption::memory_consumption(shape_gradients_normal);
       memory += MemoryConsumption::memory_consumption(shape_hessians);
       memory += MemoryConsumption::memory_consumption(shape_values_eo);
       memory += MemoryConsumption::memory_consumption(shape_gradients_eo);
@@ -0,0 +1,414 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_matrix_free_tools_h
+#define dealii_matrix_free_tools_h
+
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <functional>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/**
+ * A namespace with utility functions that extract the matrix underlying a
+ * matrix-free operator, e.g. to assemble the sparse matrix for an algebraic
+ * coarse grid solver or the diagonal for a Jacobi or Chebyshev smoother.
+ *
+ * The operator is given by a cell kernel @p local_operator that acts on an
+ * FEEvaluation object that has been initialized on a batch of cells. The
+ * kernel takes the values stored in FEEvaluation::begin_dof_values(), applies
+ * the operator (usually by calling FEEvaluation::evaluate(), operating on the
+ * quadrature points, and calling FEEvaluation::integrate()), and leaves the
+ * result in FEEvaluation::begin_dof_values(). This is the cell operation of a
+ * typical MatrixFree::cell_loop() without the calls to
+ * FEEvaluation::read_dof_values() and
+ * FEEvaluation::distribute_local_to_global(). For the Laplacian, the kernel
+ * reads
+ * @code
+ * [](FEEvaluation<dim,fe_degree,n_q_points_1d,1,double> &phi)
+ * {
+ *   phi.evaluate(false, true);
+ *   for (unsigned int q=0; q<phi.n_q_points; ++q)
+ *     phi.submit_gradient(phi.get_gradient(q), q);
+ *   phi.integrate(false, true);
+ * }
+ * @endcode
+ *
+ * The cell matrices are computed by applying the kernel to all unit vectors
+ * of the local degrees of freedom. Since FEEvaluation works on all lanes of a
+ * VectorizedArray at once, each application computes a column of the cell
+ * matrices of VectorizedArray::n_array_elements cells. The cost is thus
+ * approximately the cost of <code>dofs_per_cell</code> operator evaluations
+ * on each cell, which is usually considerably less than the cost of a
+ * traditional assembly with FEValues for higher polynomial degrees. The cell
+ * matrices are then transferred into the global matrix with
+ * ConstraintMatrix::distribute_local_to_global().
+ *
+ * Since the functions take the template arguments of FEEvaluation through a
+ * std::function, they cannot be deduced from a lambda and must be specified
+ * explicitly:
+ * @code
+ * MatrixFreeTools::compute_matrix<dim,fe_degree,n_q_points_1d,1,double>
+ *   (matrix_free, constraints, sparse_matrix, local_operator);
+ * @endcode
+ *
+ * The functions work on the DoFHandler (or the multigrid level, depending on
+ * MatrixFree::AdditionalData::level_mg_handler) selected by @p dof_no and the
+ * quadrature formula selected by @p quad_no. Only the cells of the current
+ * MPI process are visited, so a parallel matrix or vector must be able to
+ * receive entries of rows owned by other processes, which are sent to their
+ * owners by the final call to <code>compress(VectorOperation::add)</code>.
+ */
+namespace MatrixFreeTools
+{
+  /**
+   * Compute the matrix representation of the cell operator @p local_operator
+   * on all cells of @p matrix_free and add it into @p matrix, which must be
+   * initialized with a suitable sparsity pattern. The constraints in @p
+   * constraints are eliminated from the matrix in the same way as
+   * ConstraintMatrix::distribute_local_to_global() would do when assembling
+   * with FEValues. This variant can be used with a dealii::SparseMatrix as
+   * well as with the matrix classes in TrilinosWrappers and PETScWrappers.
+   */
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number, typename MatrixType>
+  void
+  compute_matrix
+  (const MatrixFree<dim,Number>                                                          &matrix_free,
+   const ConstraintMatrix                                                                &constraints,
+   MatrixType                                                                            &matrix,
+   const std::function<void(FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number> &)> &local_operator,
+   const unsigned int                                                                     dof_no = 0,
+   const unsigned int                                                                     quad_no = 0);
+
+  /**
+   * Compute the diagonal of the matrix that compute_matrix() would assemble
+   * for the same arguments and add it into @p diagonal_global, without
+   * building the matrix. The vector must be initialized by
+   * MatrixFree::initialize_dof_vector() in order to access the ghost entries
+   * the cells contribute to.
+   *
+   * The diagonal entries of rows fully constrained by @p constraints
+   * (e.g. Dirichlet boundary conditions) are left at zero, as opposed to the
+   * matrix case where ConstraintMatrix::distribute_local_to_global() fills
+   * them with a non-zero value. As in
+   * MatrixFreeOperators::Base::set_constrained_entries_to_one(), the user needs
+   * to fill these entries with a value that is suitable for the solver in
+   * use.
+   */
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number, typename VectorType>
+  void
+  compute_diagonal
+  (const MatrixFree<dim,Number>                                                          &matrix_free,
+   const ConstraintMatrix                                                                &constraints,
+   VectorType                                                                            &diagonal_global,
+   const std::function<void(FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number> &)> &local_operator,
+   const unsigned int                                                                     dof_no = 0,
+   const unsigned int                                                                     quad_no = 0);
+
+  /**
+   * Compute the cell matrices of the cell operator @p local_operator on the
+   * batch of cells with index @p cell of @p matrix_free. On return, @p
+   * cell_matrices contains one matrix for each of the
+   * MatrixFree::n_components_filled() lanes of the batch, and @p dof_indices
+   * the global indices of the degrees of freedom of the respective cell in
+   * the order of the rows and columns of the matrix. The two arguments are
+   * resized if necessary, so they can be reused over all batches of cells
+   * without allocating memory.
+   *
+   * This is the building block of compute_matrix() and can be used to
+   * assemble matrices whose entries depend on additional data on the cell,
+   * such as the Jacobian of a nonlinear operator in a Newton method. The
+   * linearization point is evaluated once on the batch with a separate
+   * FEEvaluation object, and the kernel then accesses the values at the
+   * quadrature points stored in that way:
+   * @code
+   * FEEvaluation<dim,fe_degree> phi(matrix_free), phi_lin(matrix_free);
+   * std::vector<FullMatrix<double> > cell_matrices;
+   * std::vector<std::vector<types::global_dof_index> > dof_indices;
+   * for (unsigned int cell=0; cell<matrix_free.n_macro_cells(); ++cell)
+   *   {
+   *     phi_lin.reinit(cell);
+   *     phi_lin.read_dof_values_plain(linearization_point);
+   *     phi_lin.evaluate(true, false);
+   *     MatrixFreeTools::compute_cell_matrices<dim,fe_degree,fe_degree+1,1,double>
+   *       (matrix_free, cell, phi,
+   *        [&](FEEvaluation<dim,fe_degree> &eval)
+   *        {
+   *          eval.evaluate(true, true);
+   *          for (unsigned int q=0; q<eval.n_q_points; ++q)
+   *            {
+   *              eval.submit_value(nonlinearity_derivative(phi_lin.get_value(q)) *
+   *                                eval.get_value(q), q);
+   *              eval.submit_gradient(eval.get_gradient(q), q);
+   *            }
+   *          eval.integrate(true, true);
+   *        },
+   *        cell_matrices, dof_indices);
+   *     for (unsigned int v=0; v<matrix_free.n_components_filled(cell); ++v)
+   *       constraints.distribute_local_to_global(cell_matrices[v],
+   *                                              dof_indices[v], jacobian);
+   *   }
+   * jacobian.compress(VectorOperation::add);
+   * @endcode
+   * All work at quadrature points, including the evaluation of the
+   * nonlinearity, is done on VectorizedArray::n_array_elements cells at once.
+   */
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number, typename MatrixNumber>
+  void
+  compute_cell_matrices
+  (const MatrixFree<dim,Number>                                                          &matrix_free,
+   const unsigned int                                                                     cell,
+   FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number>                         &phi,
+   const std::function<void(FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number> &)> &local_operator,
+   std::vector<FullMatrix<MatrixNumber> >                                                &cell_matrices,
+   std::vector<std::vector<types::global_dof_index> >                                    &dof_indices,
+   const unsigned int                                                                     dof_no = 0);
+
+
+
+  // ------------------------- inline and template functions ------------------
+
+#ifndef DOXYGEN
+
+  namespace internal
+  {
+    /**
+     * Apply the cell operator to all unit vectors on the given batch of
+     * cells and store the resulting cell matrices in @p cell_matrices, one
+     * for each filled lane. The global indices of the degrees of freedom,
+     * arranged in the order used by FEEvaluation, are placed in @p
+     * dof_indices.
+     */
+    template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+              typename Number, typename MatrixNumber>
+    void
+    compute_cell_matrices
+    (const MatrixFree<dim,Number>                                                          &matrix_free,
+     const unsigned int                                                                     cell,
+     FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number>                         &phi,
+     const std::function<void(FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number> &)> &local_operator,
+     const unsigned int                                                                     dof_no,
+     std::vector<types::global_dof_index>                                                  &dof_indices_cell,
+     std::vector<std::vector<types::global_dof_index> >                                    &dof_indices,
+     std::vector<FullMatrix<MatrixNumber> >                                                &cell_matrices)
+    {
+      const unsigned int dofs_per_cell = phi.dofs_per_cell * n_components;
+      const unsigned int n_filled = matrix_free.n_components_filled(cell);
+      const std::vector<unsigned int> &lexicographic_numbering =
+        phi.get_internal_dof_numbering();
+      AssertDimension(lexicographic_numbering.size(), dofs_per_cell);
+
+      phi.reinit(cell);
+      for (unsigned int j=0; j<dofs_per_cell; ++j)
+        {
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            phi.begin_dof_values()[i] = Number();
+          phi.begin_dof_values()[j] = Number(1.);
+
+          local_operator(phi);
+
+          for (unsigned int v=0; v<n_filled; ++v)
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              cell_matrices[v](i,j) = phi.begin_dof_values()[i][v];
+        }
+
+      dof_indices_cell.resize(dofs_per_cell);
+      for (unsigned int v=0; v<n_filled; ++v)
+        {
+          const typename DoFHandler<dim>::cell_iterator dof_cell =
+            matrix_free.get_cell_iterator(cell, v, dof_no);
+          if (matrix_free.get_mg_level() == numbers::invalid_unsigned_int)
+            dof_cell->get_dof_indices(dof_indices_cell);
+          else
+            dof_cell->get_mg_dof_indices(dof_indices_cell);
+          dof_indices[v].resize(dofs_per_cell);
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            dof_indices[v][i] = dof_indices_cell[lexicographic_numbering[i]];
+        }
+    }
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number, typename MatrixNumber>
+  void
+  compute_cell_matrices
+  (const MatrixFree<dim,Number>                                                          &matrix_free,
+   const unsigned int                                                                     cell,
+   FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number>                         &phi,
+   const std::function<void(FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number> &)> &local_operator,
+   std::vector<FullMatrix<MatrixNumber> >                                                &cell_matrices,
+   std::vector<std::vector<types::global_dof_index> >                                    &dof_indices,
+   const unsigned int                                                                     dof_no)
+  {
+    AssertIndexRange(cell, matrix_free.n_macro_cells());
+    const unsigned int dofs_per_cell = phi.dofs_per_cell * n_components;
+    const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+
+    cell_matrices.resize(n_lanes);
+    for (unsigned int v=0; v<n_lanes; ++v)
+      if (cell_matrices[v].m() != dofs_per_cell ||
+          cell_matrices[v].n() != dofs_per_cell)
+        cell_matrices[v].reinit(dofs_per_cell, dofs_per_cell);
+    dof_indices.resize(n_lanes);
+
+    std::vector<types::global_dof_index> dof_indices_cell;
+    internal::compute_cell_matrices(matrix_free, cell, phi, local_operator,
+                                    dof_no, dof_indices_cell, dof_indices,
+                                    cell_matrices);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number, typename MatrixType>
+  void
+  compute_matrix
+  (const MatrixFree<dim,Number>                                                          &matrix_free,
+   const ConstraintMatrix                                                                &constraints,
+   MatrixType                                                                            &matrix,
+   const std::function<void(FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number> &)> &local_operator,
+   const unsigned int                                                                     dof_no,
+   const unsigned int                                                                     quad_no)
+  {
+    typedef typename MatrixType::value_type MatrixNumber;
+    FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number>
+    phi(matrix_free, dof_no, quad_no);
+    const unsigned int dofs_per_cell = phi.dofs_per_cell * n_components;
+    const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+
+    std::vector<FullMatrix<MatrixNumber> >
+    cell_matrices(n_lanes, FullMatrix<MatrixNumber>(dofs_per_cell, dofs_per_cell));
+    std::vector<std::vector<types::global_dof_index> > dof_indices(n_lanes);
+    std::vector<types::global_dof_index> dof_indices_cell;
+
+    for (unsigned int cell=0; cell<matrix_free.n_macro_cells(); ++cell)
+      {
+        internal::compute_cell_matrices(matrix_free, cell, phi, local_operator,
+                                        dof_no, dof_indices_cell, dof_indices,
+                                        cell_matrices);
+        for (unsigned int v=0; v<matrix_free.n_components_filled(cell); ++v)
+          constraints.distribute_local_to_global(cell_matrices[v],
+                                                 dof_indices[v], matrix);
+      }
+
+    matrix.compress(VectorOperation::add);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number, typename VectorType>
+  void
+  compute_diagonal
+  (const MatrixFree<dim,Number>                                                          &matrix_free,
+   const ConstraintMatrix                                                                &constraints,
+   VectorType                                                                            &diagonal_global,
+   const std::function<void(FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number> &)> &local_operator,
+   const unsigned int                                                                     dof_no,
+   const unsigned int                                                                     quad_no)
+  {
+    typedef typename VectorType::value_type VectorNumber;
+    FEEvaluation<dim,fe_degree,n_q_points_1d,n_components,Number>
+    phi(matrix_free, dof_no, quad_no);
+    const unsigned int dofs_per_cell = phi.dofs_per_cell * n_components;
+    const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+
+    std::vector<FullMatrix<VectorNumber> >
+    cell_matrices(n_lanes, FullMatrix<VectorNumber>(dofs_per_cell, dofs_per_cell));
+    std::vector<std::vector<types::global_dof_index> > dof_indices(n_lanes);
+    std::vector<types::global_dof_index> dof_indices_cell;
+
+    // for each local degree of freedom, the list of global degrees of
+    // freedom it is resolved into by the constraints together with the
+    // respective weights
+    std::vector<std::vector<std::pair<types::global_dof_index,VectorNumber> > >
+    resolved_entries(dofs_per_cell);
+
+    for (unsigned int cell=0; cell<matrix_free.n_macro_cells(); ++cell)
+      {
+        internal::compute_cell_matrices(matrix_free, cell, phi, local_operator,
+                                        dof_no, dof_indices_cell, dof_indices,
+                                        cell_matrices);
+        for (unsigned int v=0; v<matrix_free.n_components_filled(cell); ++v)
+          {
+            bool has_constraints = false;
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              {
+                resolved_entries[i].clear();
+                const std::vector<std::pair<types::global_dof_index,double> >
+                *entries = constraints.get_constraint_entries(dof_indices[v][i]);
+                if (entries != nullptr)
+                  {
+                    has_constraints = true;
+                    for (unsigned int e=0; e<entries->size(); ++e)
+                      resolved_entries[i].push_back
+                      (std::make_pair((*entries)[e].first,
+                                      VectorNumber((*entries)[e].second)));
+                  }
+                else
+                  resolved_entries[i].push_back
+                  (std::make_pair(dof_indices[v][i], VectorNumber(1.)));
+              }
+
+            // without constraints, only the diagonal of the cell matrix
+            // contributes. Otherwise, the diagonal entry of the condensed
+            // matrix C^T A C for a global index collects the weighted cell
+            // matrix entries of all pairs of local degrees of freedom that
+            // are resolved into that index.
+            if (has_constraints == false)
+              for (unsigned int i=0; i<dofs_per_cell; ++i)
+                diagonal_global(dof_indices[v][i]) += cell_matrices[v](i,i);
+            else
+              for (unsigned int i=0; i<dofs_per_cell; ++i)
+                for (unsigned int k=0; k<dofs_per_cell; ++k)
+                  if (cell_matrices[v](i,k) != VectorNumber())
+                    for (unsigned int a=0; a<resolved_entries[i].size(); ++a)
+                      for (unsigned int b=0; b<resolved_entries[k].size(); ++b)
+                        if (resolved_entries[i][a].first ==
+                            resolved_entries[k][b].first)
+                          diagonal_global(resolved_entries[i][a].first) +=
+                            resolved_entries[i][a].second *
+                            resolved_entries[k][b].second *
+                            cell_matrices[v](i,k);
+          }
+      }
+
+    diagonal_global.compress(VectorOperation::add);
+  }
+
+#endif // ifndef DOXYGEN
+
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
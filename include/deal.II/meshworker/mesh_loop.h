@@ -19,6 +19,7 @@
 
 #include <deal.II/base/config.h>
 #include <deal.II/base/work_stream.h>
+#include <deal.II/base/graph_coloring.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/filtered_iterator.h>
@@ -28,137 +29,57 @@
 #include <deal.II/meshworker/integration_info.h>
 #include <deal.II/meshworker/assemble_flags.h>
 
+#include <algorithm>
 #include <functional>
+#include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
 template <typename> class TriaActiveIterator;
 
-namespace MeshWorker
+namespace internal
 {
   /**
-   * This function extends the WorkStream concept to work on meshes
-   * (cells and/or faces) and handles the complicated logic for
-   * work on adaptively refined faces
-   * and parallel computation (work on faces to ghost neighbors for example).
-   * The @p mesh_loop can be used to simplify operations on cells (for example
-   * assembly), on boundaries (Neumann type boundary conditions), or on
-   * interior faces (for example in discontinuous Galerkin methods).
-   *
-   * For uniformly refined meshes, it would be relatively easy to use
-   * WorkStream::run() with a @p cell_worker that also loops over faces, and
-   * takes care of assembling face terms depending on the current and neighbor
-   * cell. All user codes that do these loops would then need to insert
-   * manually the logic that identifies, for every face of the current cell,
-   * the neighboring cell, and the face index on the neighboring cell that
-   * corresponds to the current face.
-   *
-   * This is more complicated if local refinement is enabled and the current or
-   * neighbor cells have hanging nodes. In this case it is also necessary to
-   * identify the corresponding subface on either the current or the neighbor
-   * faces.
-   *
-   * This method externalises that logic (which is independent from user codes)
-   * and separates the assembly of face terms (internal faces, boundary faces,
-   * or faces between different subdomain ids on parallel computations) from
-   * the assembling on cells, allowing the user to specify two additional
-   * workers (a @p cell_worker, a @p boundary_worker, and a @p face_worker) that
-   * are called automatically in each @p cell, according to the specific
-   * AssembleFlags @p flags that are passed. The @p cell_worker is passed the
-   * cell identifier, a ScratchData object, and a CopyData object, following
-   * the same principles of WorkStream::run. Internally the function passes to
-   * @p boundary_worker, in addition to the above, also a @p face_no parameter
-   * that identifies the face on which the integration should be performed. The
-   * @p face_worker instead needs to identify the current face unambiguously both on
-   * the cell and on the neighboring cell, and it is therefore called with six
-   * arguments (three for each cell: the actual cell, the face index, and
-   * the subface_index. If no subface integration is needed, then the
-   * subface_index is numbers::invalid_unsigned_int) in addition to the usual
-   * ScratchData and CopyData objects.
-   *
-   * If the flag AssembleFlags::assemble_own_cells is passed, then the default
-   * behavior is to first loop over faces and do the work there, and then
-   * compute the actual work on the cell. It is possible to perform the
-   * integration on the cells after working on faces, by adding the flag
-   * AssembleFlags::cells_after_faces.
-   *
-   * If the flag AssembleFlags::assemble_own_interior_faces_once is specified,
-   * then each interior face is visited only once, and the @p face_worker is
-   * assumed to integrate all face terms at once (and add contributions to both
-   * sides of the face in a discontinuous Galerkin setting).
-   *
-   * This method is equivalent to the WorkStream::run() method when
-   * AssembleFlags contains only @p assemble_own_cells, and can be used as a
-   * drop-in replacement for that method.
-   *
-   * The two data types ScratchData and CopyData need to have a working copy
-   * constructor. ScratchData is only used in the worker function, while CopyData is
-   * the object passed from the worker to the copier.
-   *
-   * The queue_length argument indicates the number of items that can be live at any
-   * given time. Each item consists of chunk_size elements of the input stream that
-   * will be worked on by the worker and copier functions one after the other on the
-   * same thread.
-   *
-   * If your data objects are large, or their constructors are expensive, it is
-   * helpful to keep in mind that queue_length copies of the ScratchData object
-   * and queue_length*chunk_size copies of the CopyData object are generated.
-   *
-   * @note More information about requirements on template types and meaning
-   * of @p queue_length and @p chunk_size can be found in the documentation of the
-   * WorkStream namespace and its members.
-   *
-   * @ingroup MeshWorker
-   * @author Luca Heltai and Timo Heister, 2017
+   * Return the function that mesh_loop() runs on each cell: reset the copy
+   * data to @p sample_copy_data and call the cell, boundary, and face
+   * workers according to @p flags. The workers are copied into the
+   * returned object, whereas @p sample_copy_data is referenced and must
+   * outlive it.
    */
-  template <class CellIteratorType,
-            class ScratchData, class CopyData>
-  void mesh_loop(const CellIteratorType &begin,
-                 const typename identity<CellIteratorType>::type &end,
-
-                 const typename identity<std::function<void (const CellIteratorType &, ScratchData &, CopyData &)>>::type &cell_worker,
-                 const typename identity<std::function<void (const CopyData &)>>::type &copier,
-
-                 const ScratchData &sample_scratch_data,
-                 const CopyData &sample_copy_data,
-
-                 const AssembleFlags flags = assemble_own_cells,
-
-                 const typename identity<std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)>>::type &boundary_worker=
-                   std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)>(),
-
-                 const typename identity<std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
-                                                             const CellIteratorType &, const unsigned int &, const unsigned int &,
-                                                             ScratchData &, CopyData &)>>::type &face_worker=
-                   std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
-                                       const CellIteratorType &, const unsigned int &, const unsigned int &,
-                                       ScratchData &, CopyData &)>(),
-
-                 const unsigned int   queue_length = 2*MultithreadInfo::n_threads(),
-                 const unsigned int   chunk_size = 8)
+  template <class CellIteratorType, class ScratchData, class CopyData>
+  std::function<void (const CellIteratorType &, ScratchData &, CopyData &)>
+  make_mesh_loop_cell_action
+  (const std::function<void (const CellIteratorType &, ScratchData &, CopyData &)> &cell_worker,
+   const CopyData &sample_copy_data,
+   const MeshWorker::AssembleFlags flags,
+   const std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)> &boundary_worker,
+   const std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
+                             const CellIteratorType &, const unsigned int &, const unsigned int &,
+                             ScratchData &, CopyData &)> &face_worker)
   {
-    Assert((!cell_worker) == !(flags & work_on_cells),
+    Assert((!cell_worker) == !(flags & MeshWorker::work_on_cells),
            ExcMessage("If you specify a cell_worker, you need to set assemble_own_cells or assemble_ghost_cells."));
 
-    Assert((flags & (assemble_own_interior_faces_once|assemble_own_interior_faces_both))
-           != (assemble_own_interior_faces_once|assemble_own_interior_faces_both),
+    Assert((flags & (MeshWorker::assemble_own_interior_faces_once|MeshWorker::assemble_own_interior_faces_both))
+           != (MeshWorker::assemble_own_interior_faces_once|MeshWorker::assemble_own_interior_faces_both),
            ExcMessage("You can only specify assemble_own_interior_faces_once OR assemble_own_interior_faces_both."));
 
-    Assert((flags & (assemble_ghost_faces_once|assemble_ghost_faces_both))
-           != (assemble_ghost_faces_once|assemble_ghost_faces_both),
+    Assert((flags & (MeshWorker::assemble_ghost_faces_once|MeshWorker::assemble_ghost_faces_both))
+           != (MeshWorker::assemble_ghost_faces_once|MeshWorker::assemble_ghost_faces_both),
            ExcMessage("You can only specify assemble_ghost_faces_once OR assemble_ghost_faces_both."));
 
-    Assert(!(flags & cells_after_faces) ||
-           (flags & (assemble_own_cells | assemble_ghost_cells)),
+    Assert(!(flags & MeshWorker::cells_after_faces) ||
+           (flags & (MeshWorker::assemble_own_cells | MeshWorker::assemble_ghost_cells)),
            ExcMessage("The option cells_after_faces only makes sense if you assemble on cells."));
 
-    Assert((!face_worker) == !(flags & work_on_faces),
+    Assert((!face_worker) == !(flags & MeshWorker::work_on_faces),
            ExcMessage("If you specify a face_worker, assemble_face_* needs to be set."));
 
-    Assert((!boundary_worker) == !(flags & assemble_boundary_faces),
+    Assert((!boundary_worker) == !(flags & MeshWorker::assemble_boundary_faces),
            ExcMessage("If you specify a boundary_worker, assemble_boundary_faces needs to be set."));
 
-    auto cell_action = [&] (const CellIteratorType &cell, ScratchData &scratch, CopyData &copy)
+    return [cell_worker, &sample_copy_data, flags, boundary_worker, face_worker]
+           (const CellIteratorType &cell, ScratchData &scratch, CopyData &copy)
     {
       // First reset the CopyData class to the empty copy_data given by the user.
       copy = sample_copy_data;
@@ -175,19 +96,19 @@ namespace MeshWorker
       if ((!ignore_subdomain) && (current_subdomain_id == numbers::artificial_subdomain_id))
         return;
 
-      if ( !(flags & (cells_after_faces)) &&
-           ( ((flags & (assemble_own_cells)) && own_cell)
-             || ( (flags & assemble_ghost_cells) && !own_cell) ) )
+      if ( !(flags & (MeshWorker::cells_after_faces)) &&
+           ( ((flags & (MeshWorker::assemble_own_cells)) && own_cell)
+             || ( (flags & MeshWorker::assemble_ghost_cells) && !own_cell) ) )
         cell_worker(cell, scratch, copy);
 
-      if (flags & (work_on_faces | work_on_boundary))
+      if (flags & (MeshWorker::work_on_faces | MeshWorker::work_on_boundary))
         for (unsigned int face_no=0; face_no < GeometryInfo<CellIteratorType::AccessorType::Container::dimension>::faces_per_cell; ++face_no)
           {
             typename CellIteratorType::AccessorType::Container::face_iterator face = cell->face(face_no);
             if (cell->at_boundary(face_no) && !cell->has_periodic_neighbor(face_no))
               {
                 // only integrate boundary faces of own cells
-                if ( (flags & assemble_boundary_faces) && own_cell)
+                if ( (flags & MeshWorker::assemble_boundary_faces) && own_cell)
                   boundary_worker(cell, face_no, scratch, copy);
               }
             else
@@ -210,11 +131,11 @@ namespace MeshWorker
                   continue;
 
                 // skip if the user doesn't want faces between own cells
-                if (own_cell && own_neighbor && !(flags & (assemble_own_interior_faces_both | assemble_own_interior_faces_once)))
+                if (own_cell && own_neighbor && !(flags & (MeshWorker::assemble_own_interior_faces_both | MeshWorker::assemble_own_interior_faces_once)))
                   continue;
 
                 // skip face to ghost
-                if (own_cell != own_neighbor && !(flags & (assemble_ghost_faces_both | assemble_ghost_faces_once)))
+                if (own_cell != own_neighbor && !(flags & (MeshWorker::assemble_ghost_faces_both | MeshWorker::assemble_ghost_faces_once)))
                   continue;
 
                 // Deal with refinement edges from the refined side. Assuming one-irregular
@@ -229,7 +150,7 @@ namespace MeshWorker
 
                     // skip if only one processor needs to assemble the face
                     // to a ghost cell and the fine cell is not ours.
-                    if (!own_cell && (flags & assemble_ghost_faces_once))
+                    if (!own_cell && (flags & MeshWorker::assemble_ghost_faces_once))
                       continue;
 
                     const std::pair<unsigned int, unsigned int> neighbor_face_no
@@ -241,7 +162,7 @@ namespace MeshWorker
                                 neighbor, neighbor_face_no.first, neighbor_face_no.second,
                                 scratch, copy);
 
-                    if (flags & assemble_own_interior_faces_both)
+                    if (flags & MeshWorker::assemble_own_interior_faces_both)
                       {
                         // If own faces are to be assembled from both sides, call the
                         // faceworker again with swapped arguments. This is because
@@ -266,7 +187,7 @@ namespace MeshWorker
                     // AssembleFlags says otherwise). Here, we rely on cell comparison
                     // that will look at cell->index().
                     if (own_cell && own_neighbor
-                        && (flags & assemble_own_interior_faces_once)
+                        && (flags & MeshWorker::assemble_own_interior_faces_once)
                         && (neighbor < cell))
                       continue;
 
@@ -279,7 +200,7 @@ namespace MeshWorker
                     // processor with the smaller (level-)subdomain id assemble the
                     // face.
                     if (own_cell && !own_neighbor
-                        && (flags & assemble_ghost_faces_once)
+                        && (flags & MeshWorker::assemble_ghost_faces_once)
                         && (neighbor_subdomain_id < current_subdomain_id))
                       continue;
 
@@ -296,10 +217,120 @@ namespace MeshWorker
           } // faces
 
       // Execute the cell_worker if faces are handled before cells
-      if ((flags & cells_after_faces) &&
-          ( ((flags & assemble_own_cells) && own_cell) || ((flags & assemble_ghost_cells) && !own_cell)))
+      if ((flags & MeshWorker::cells_after_faces) &&
+          ( ((flags & MeshWorker::assemble_own_cells) && own_cell) || ((flags & MeshWorker::assemble_ghost_cells) && !own_cell)))
         cell_worker(cell, scratch, copy);
     };
+  }
+}
+
+
+namespace MeshWorker
+{
+  /**
+   * This function extends the WorkStream concept to work on meshes
+   * (cells and/or faces) and handles the complicated logic for
+   * work on adaptively refined faces
+   * and parallel computation (work on faces to ghost neighbors for example).
+   * The @p mesh_loop can be used to simplify operations on cells (for example
+   * assembly), on boundaries (Neumann type boundary conditions), or on
+   * interior faces (for example in discontinuous Galerkin methods).
+   *
+   * For uniformly refined meshes, it would be relatively easy to use
+   * WorkStream::run() with a @p cell_worker that also loops over faces, and
+   * takes care of assembling face terms depending on the current and neighbor
+   * cell. All user codes that do these loops would then need to insert
+   * manually the logic that identifies, for every face of the current cell,
+   * the neighboring cell, and the face index on the neighboring cell that
+   * corresponds to the current face.
+   *
+   * This is more complicated if local refinement is enabled and the current or
+   * neighbor cells have hanging nodes. In this case it is also necessary to
+   * identify the corresponding subface on either the current or the neighbor
+   * faces.
+   *
+   * This method externalises that logic (which is independent from user codes)
+   * and separates the assembly of face terms (internal faces, boundary faces,
+   * or faces between different subdomain ids on parallel computations) from
+   * the assembling on cells, allowing the user to specify two additional
+   * workers (a @p cell_worker, a @p boundary_worker, and a @p face_worker) that
+   * are called automatically in each @p cell, according to the specific
+   * AssembleFlags @p flags that are passed. The @p cell_worker is passed the
+   * cell identifier, a ScratchData object, and a CopyData object, following
+   * the same principles of WorkStream::run. Internally the function passes to
+   * @p boundary_worker, in addition to the above, also a @p face_no parameter
+   * that identifies the face on which the integration should be performed. The
+   * @p face_worker instead needs to identify the current face unambiguously both on
+   * the cell and on the neighboring cell, and it is therefore called with six
+   * arguments (three for each cell: the actual cell, the face index, and
+   * the subface_index. If no subface integration is needed, then the
+   * subface_index is numbers::invalid_unsigned_int) in addition to the usual
+   * ScratchData and CopyData objects.
+   *
+   * If the flag AssembleFlags::assemble_own_cells is passed, then the default
+   * behavior is to first loop over faces and do the work there, and then
+   * compute the actual work on the cell. It is possible to perform the
+   * integration on the cells after working on faces, by adding the flag
+   * AssembleFlags::cells_after_faces.
+   *
+   * If the flag AssembleFlags::assemble_own_interior_faces_once is specified,
+   * then each interior face is visited only once, and the @p face_worker is
+   * assumed to integrate all face terms at once (and add contributions to both
+   * sides of the face in a discontinuous Galerkin setting).
+   *
+   * This method is equivalent to the WorkStream::run() method when
+   * AssembleFlags contains only @p assemble_own_cells, and can be used as a
+   * drop-in replacement for that method.
+   *
+   * The two data types ScratchData and CopyData need to have a working copy
+   * constructor. ScratchData is only used in the worker function, while CopyData is
+   * the object passed from the worker to the copier.
+   *
+   * The queue_length argument indicates the number of items that can be live at any
+   * given time. Each item consists of chunk_size elements of the input stream that
+   * will be worked on by the worker and copier functions one after the other on the
+   * same thread.
+   *
+   * If your data objects are large, or their constructors are expensive, it is
+   * helpful to keep in mind that queue_length copies of the ScratchData object
+   * and queue_length*chunk_size copies of the CopyData object are generated.
+   *
+   * @note More information about requirements on template types and meaning
+   * of @p queue_length and @p chunk_size can be found in the documentation of the
+   * WorkStream namespace and its members.
+   *
+   * @ingroup MeshWorker
+   * @author Luca Heltai and Timo Heister, 2017
+   */
+  template <class CellIteratorType,
+            class ScratchData, class CopyData>
+  void mesh_loop(const CellIteratorType &begin,
+                 const typename identity<CellIteratorType>::type &end,
+
+                 const typename identity<std::function<void (const CellIteratorType &, ScratchData &, CopyData &)>>::type &cell_worker,
+                 const typename identity<std::function<void (const CopyData &)>>::type &copier,
+
+                 const ScratchData &sample_scratch_data,
+                 const CopyData &sample_copy_data,
+
+                 const AssembleFlags flags = assemble_own_cells,
+
+                 const typename identity<std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)>>::type &boundary_worker=
+                   std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)>(),
+
+                 const typename identity<std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                                             const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                                             ScratchData &, CopyData &)>>::type &face_worker=
+                   std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                       const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                       ScratchData &, CopyData &)>(),
+
+                 const unsigned int   queue_length = 2*MultithreadInfo::n_threads(),
+                 const unsigned int   chunk_size = 8)
+  {
+    const std::function<void (const CellIteratorType &, ScratchData &, CopyData &)>
+    cell_action = internal::make_mesh_loop_cell_action<CellIteratorType,ScratchData,CopyData>
+                  (cell_worker, sample_copy_data, flags, boundary_worker, face_worker);
 
     // Submit to workstream
     WorkStream::run(begin, end,
@@ -307,6 +338,241 @@ namespace MeshWorker
                     sample_scratch_data, sample_copy_data,
                     queue_length, chunk_size);
   }
+
+
+  /**
+   * Same as the function above, but take the scratch data objects from the
+   * given @p scratch_data_pool rather than copying them from a sample. The
+   * pool keeps the objects, e.g., the FEValues and FEFaceValues objects
+   * used by the workers, for later calls, so that a code that runs
+   * mesh_loop() in every time step or nonlinear iteration avoids their
+   * repeated construction. See WorkStream::ScratchDataPool for more
+   * information.
+   *
+   * @ingroup MeshWorker
+   */
+  template <class CellIteratorType,
+            class ScratchData, class CopyData>
+  void mesh_loop(const CellIteratorType &begin,
+                 const typename identity<CellIteratorType>::type &end,
+
+                 const typename identity<std::function<void (const CellIteratorType &, ScratchData &, CopyData &)>>::type &cell_worker,
+                 const typename identity<std::function<void (const CopyData &)>>::type &copier,
+
+                 WorkStream::ScratchDataPool<ScratchData> &scratch_data_pool,
+                 const CopyData &sample_copy_data,
+
+                 const AssembleFlags flags = assemble_own_cells,
+
+                 const typename identity<std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)>>::type &boundary_worker=
+                   std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)>(),
+
+                 const typename identity<std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                                             const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                                             ScratchData &, CopyData &)>>::type &face_worker=
+                   std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                       const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                       ScratchData &, CopyData &)>(),
+
+                 const unsigned int   queue_length = 2*MultithreadInfo::n_threads(),
+                 const unsigned int   chunk_size = 8)
+  {
+    const std::function<void (const CellIteratorType &, ScratchData &, CopyData &)>
+    cell_action = internal::make_mesh_loop_cell_action<CellIteratorType,ScratchData,CopyData>
+                  (cell_worker, sample_copy_data, flags, boundary_worker, face_worker);
+
+    WorkStream::run(begin, end,
+                    cell_action, copier,
+                    scratch_data_pool, sample_copy_data,
+                    queue_length, chunk_size);
+  }
+
+
+
+  /**
+   * Same as the first function above, but run the cells in the order given
+   * by @p colored_iterators, a set of colors for which the copier calls of
+   * cells of the same color do not write into the same global data.
+   * WorkStream then runs the copiers within a color in parallel rather than
+   * sequentially (see the respective WorkStream::run() function), which
+   * removes the serial copier as a bottleneck of assembly on many threads.
+   * A coloring that fits the flags passed to this function can be computed
+   * with make_colored_cell_ranges(). In particular, with
+   * assemble_own_interior_faces_once, which lets one cell of each interior
+   * face write into the rows of both cells, the coloring needs to separate
+   * cells that share a face neighbor.
+   *
+   * @ingroup MeshWorker
+   */
+  template <class CellIteratorType,
+            class ScratchData, class CopyData>
+  void mesh_loop(const std::vector<std::vector<CellIteratorType> > &colored_iterators,
+
+                 const typename identity<std::function<void (const CellIteratorType &, ScratchData &, CopyData &)>>::type &cell_worker,
+                 const typename identity<std::function<void (const CopyData &)>>::type &copier,
+
+                 const ScratchData &sample_scratch_data,
+                 const CopyData &sample_copy_data,
+
+                 const AssembleFlags flags = assemble_own_cells,
+
+                 const typename identity<std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)>>::type &boundary_worker=
+                   std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)>(),
+
+                 const typename identity<std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                                             const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                                             ScratchData &, CopyData &)>>::type &face_worker=
+                   std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                       const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                       ScratchData &, CopyData &)>(),
+
+                 const unsigned int   queue_length = 2*MultithreadInfo::n_threads(),
+                 const unsigned int   chunk_size = 8)
+  {
+    const std::function<void (const CellIteratorType &, ScratchData &, CopyData &)>
+    cell_action = internal::make_mesh_loop_cell_action<CellIteratorType,ScratchData,CopyData>
+                  (cell_worker, sample_copy_data, flags, boundary_worker, face_worker);
+
+    WorkStream::run(colored_iterators,
+                    cell_action, copier,
+                    sample_scratch_data, sample_copy_data,
+                    queue_length, chunk_size);
+  }
+
+
+
+  /**
+   * Same as the function above, but take the scratch data objects from the
+   * given @p scratch_data_pool. See WorkStream::ScratchDataPool for more
+   * information.
+   *
+   * @ingroup MeshWorker
+   */
+  template <class CellIteratorType,
+            class ScratchData, class CopyData>
+  void mesh_loop(const std::vector<std::vector<CellIteratorType> > &colored_iterators,
+
+                 const typename identity<std::function<void (const CellIteratorType &, ScratchData &, CopyData &)>>::type &cell_worker,
+                 const typename identity<std::function<void (const CopyData &)>>::type &copier,
+
+                 WorkStream::ScratchDataPool<ScratchData> &scratch_data_pool,
+                 const CopyData &sample_copy_data,
+
+                 const AssembleFlags flags = assemble_own_cells,
+
+                 const typename identity<std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)>>::type &boundary_worker=
+                   std::function<void (const CellIteratorType &, const unsigned int &, ScratchData &, CopyData &)>(),
+
+                 const typename identity<std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                                             const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                                             ScratchData &, CopyData &)>>::type &face_worker=
+                   std::function<void (const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                       const CellIteratorType &, const unsigned int &, const unsigned int &,
+                                       ScratchData &, CopyData &)>(),
+
+                 const unsigned int   queue_length = 2*MultithreadInfo::n_threads(),
+                 const unsigned int   chunk_size = 8)
+  {
+    const std::function<void (const CellIteratorType &, ScratchData &, CopyData &)>
+    cell_action = internal::make_mesh_loop_cell_action<CellIteratorType,ScratchData,CopyData>
+                  (cell_worker, sample_copy_data, flags, boundary_worker, face_worker);
+
+    WorkStream::run(colored_iterators,
+                    cell_action, copier,
+                    scratch_data_pool, sample_copy_data,
+                    queue_length, chunk_size);
+  }
+
+
+
+  /**
+   * Compute a coloring of the cells in the range from @p begin to @p end
+   * for the colored variants of mesh_loop(), using
+   * GraphColoring::make_parallel_graph_coloring(). Two cells get different colors if
+   * the copier calls of mesh_loop() with the given @p flags may write into
+   * the same degrees of freedom, i.e., if they share degrees of freedom
+   * themselves or, when faces are assembled, if one of them or one of their
+   * face neighbors shares degrees of freedom with the other one or one of
+   * its face neighbors. Cells that are skipped by mesh_loop(), i.e.,
+   * artificial cells on parallel meshes, are not part of the coloring.
+   *
+   * The iterator type needs to point into a DoFHandler, whose (active or
+   * level) degrees of freedom describe the global data written by the
+   * copier. The coloring only changes with the mesh and the degrees of
+   * freedom and can be reused for all loops in between.
+   *
+   * @ingroup MeshWorker
+   */
+  template <class CellIteratorType>
+  std::vector<std::vector<CellIteratorType> >
+  make_colored_cell_ranges(const CellIteratorType &begin,
+                           const typename identity<CellIteratorType>::type &end,
+                           const AssembleFlags flags = assemble_own_cells)
+  {
+    std::vector<CellIteratorType> cells;
+    for (CellIteratorType cell=begin; cell!=end; ++cell)
+      {
+        const types::subdomain_id subdomain_id = (cell->is_level_cell()
+                                                  ? cell->level_subdomain_id()
+                                                  : cell->subdomain_id());
+        if (cell->get_triangulation().locally_owned_subdomain() == numbers::invalid_subdomain_id
+            || subdomain_id != numbers::artificial_subdomain_id)
+          cells.push_back(cell);
+      }
+    if (cells.empty())
+      return std::vector<std::vector<CellIteratorType> >();
+
+    const std::function<std::vector<types::global_dof_index> (const CellIteratorType &)>
+    get_conflict_indices = [flags] (const CellIteratorType &cell)
+    {
+      std::vector<types::global_dof_index> conflict_indices, neighbor_indices;
+      conflict_indices.resize(cell->get_fe().dofs_per_cell);
+      cell->get_active_or_mg_dof_indices(conflict_indices);
+
+      // with work on faces, the copier may write into the rows of all
+      // unrefined face neighbors
+      if (flags & (work_on_faces | work_on_boundary))
+        for (unsigned int face_no=0; face_no < GeometryInfo<CellIteratorType::AccessorType::Container::dimension>::faces_per_cell; ++face_no)
+          if (!cell->at_boundary(face_no) || cell->has_periodic_neighbor(face_no))
+            {
+              const TriaIterator<typename CellIteratorType::AccessorType> neighbor
+                = cell->neighbor_or_periodic_neighbor(face_no);
+              if (internal::is_active_iterator(cell) && neighbor->has_children())
+                continue;
+              const types::subdomain_id neighbor_subdomain_id = (neighbor->is_level_cell()
+                                                                 ? neighbor->level_subdomain_id()
+                                                                 : neighbor->subdomain_id());
+              if (neighbor_subdomain_id == numbers::artificial_subdomain_id)
+                continue;
+              neighbor_indices.resize(neighbor->get_fe().dofs_per_cell);
+              neighbor->get_active_or_mg_dof_indices(neighbor_indices);
+              conflict_indices.insert(conflict_indices.end(),
+                                      neighbor_indices.begin(), neighbor_indices.end());
+            }
+      std::sort(conflict_indices.begin(), conflict_indices.end());
+      conflict_indices.erase(std::unique(conflict_indices.begin(), conflict_indices.end()),
+                             conflict_indices.end());
+      return conflict_indices;
+    };
+
+    const std::vector<std::vector<typename std::vector<CellIteratorType>::iterator> >
+    coloring = GraphColoring::make_parallel_graph_coloring
+               (cells.begin(), cells.end(),
+                std::function<std::vector<types::global_dof_index> (const typename std::vector<CellIteratorType>::iterator &)>
+                ([&get_conflict_indices] (const typename std::vector<CellIteratorType>::iterator &it)
+    {
+      return get_conflict_indices(*it);
+    }));
+
+    std::vector<std::vector<CellIteratorType> > colored_iterators (coloring.size());
+    for (unsigned int color=0; color<coloring.size(); ++color)
+      {
+        colored_iterators[color].reserve(coloring[color].size());
+        for (unsigned int i=0; i<coloring[color].size(); ++i)
+          colored_iterators[color].push_back(*coloring[color][i]);
+      }
+    return colored_iterators;
+  }
 }
 
 DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,253 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_cuda_mg_transfer_matrix_free_h
+#define dealii_cuda_mg_transfer_matrix_free_h
+
+#include <deal.II/base/config.h>
+
+#ifdef DEAL_II_WITH_CUDA
+
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/cuda_vector.h>
+#include <deal.II/multigrid/mg_base.h>
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace CUDAWrappers
+{
+  /*!@addtogroup mg */
+  /*@{*/
+
+  /**
+   * Implementation of the MGTransferBase interface for vectors of type
+   * LinearAlgebra::CUDAWrappers::Vector, where the transfer operations run
+   * in the memory of the GPU. Like dealii::MGTransferMatrixFree, whose setup
+   * this class shares, the prolongation is applied cell by cell as the
+   * tensor product of the one-dimensional embedding matrices of the finite
+   * element from each parent cell to the patch of its children, and the
+   * restriction is the transpose operation. Each parent cell is worked on by
+   * a block of threads, with one thread for each degree of freedom of the
+   * child patch, and the contributions of neighboring parents to shared
+   * degrees of freedom are summed with atomic operations.
+   *
+   * The functions copy_to_mg(), copy_from_mg() and copy_from_mg_add() move
+   * the data between a global vector and the level vectors on the device as
+   * well, so that a PreconditionMG object built on this transfer, on level
+   * matrices such as CUDAWrappers::SparseMatrix or operators based on
+   * CUDAWrappers::MatrixFree, on smoothers such as mg::SmootherRelaxation or
+   * MGSmootherPrecondition with PreconditionChebyshev, and on a coarse grid
+   * solver such as MGCoarseGridIterativeSolver runs the whole multigrid cycle
+   * without transferring vector data between host and device.
+   *
+   * As the CUDA vectors are not distributed, this class works with serial
+   * triangulations only. The restrictions on the finite element are the same
+   * as for dealii::MGTransferMatrixFree, i.e., the element needs to be FE_Q
+   * or FE_DGQ or a system of several components of one of these elements.
+   * The number of degrees of freedom on the children of a cell in one
+   * component must not exceed the maximal number of threads in a block, 1024.
+   *
+   * @ingroup CUDAWrappers
+   */
+  template <int dim, typename Number>
+  class MGTransferMatrixFree : public MGTransferBase<LinearAlgebra::CUDAWrappers::Vector<Number> >
+  {
+  public:
+    /**
+     * Constructor without constraint matrices. Use this constructor only
+     * with discontinuous finite elements or with no local refinement.
+     */
+    MGTransferMatrixFree ();
+
+    /**
+     * Constructor with constraints. Equivalent to the default constructor
+     * followed by initialize_constraints().
+     */
+    MGTransferMatrixFree (const MGConstrainedDoFs &mg_constrained_dofs);
+
+    /**
+     * Destructor. Free the memory on the device.
+     */
+    virtual ~MGTransferMatrixFree ();
+
+    /**
+     * Initialize the constraints to be used in build().
+     */
+    void initialize_constraints (const MGConstrainedDoFs &mg_constrained_dofs);
+
+    /**
+     * Reset the object to the state it had right after the default
+     * constructor, except for the constraints.
+     */
+    void clear ();
+
+    /**
+     * Build the information for the transfer between the levels on the host
+     * and copy it to the device.
+     */
+    void build (const DoFHandler<dim> &mg_dof);
+
+    /**
+     * Prolongate a vector from level <tt>to_level-1</tt> to level
+     * <tt>to_level</tt> using the embedding matrices of the underlying finite
+     * element. The previous content of <tt>dst</tt> is overwritten.
+     */
+    virtual void prolongate (const unsigned int                                  to_level,
+                             LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                             const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const;
+
+    /**
+     * Restrict a vector from level <tt>from_level</tt> to level
+     * <tt>from_level-1</tt> using the transpose operation of the
+     * prolongate() method and add the result to <tt>dst</tt>.
+     */
+    virtual void restrict_and_add (const unsigned int                                  from_level,
+                                   LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                                   const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const;
+
+    /**
+     * Transfer from a vector on the global grid to vectors defined on each
+     * of the levels separately for the active degrees of freedom, see
+     * MGLevelGlobalTransfer::copy_to_mg(). The level vectors are resized as
+     * necessary.
+     */
+    void
+    copy_to_mg (const DoFHandler<dim>                                        &mg_dof,
+                MGLevelObject<LinearAlgebra::CUDAWrappers::Vector<Number> > &dst,
+                const LinearAlgebra::CUDAWrappers::Vector<Number>           &src) const;
+
+    /**
+     * Transfer from the level vectors to a vector on the global grid, see
+     * MGLevelGlobalTransfer::copy_from_mg().
+     */
+    void
+    copy_from_mg (const DoFHandler<dim>                                              &mg_dof,
+                  LinearAlgebra::CUDAWrappers::Vector<Number>                       &dst,
+                  const MGLevelObject<LinearAlgebra::CUDAWrappers::Vector<Number> > &src) const;
+
+    /**
+     * Add the level vectors to a vector on the global grid, see
+     * MGLevelGlobalTransfer::copy_from_mg_add().
+     */
+    void
+    copy_from_mg_add (const DoFHandler<dim>                                              &mg_dof,
+                      LinearAlgebra::CUDAWrappers::Vector<Number>                       &dst,
+                      const MGLevelObject<LinearAlgebra::CUDAWrappers::Vector<Number> > &src) const;
+
+    /**
+     * Memory used by this object on the device.
+     */
+    std::size_t memory_consumption () const;
+
+  private:
+    /**
+     * Free the memory on the device.
+     */
+    void free ();
+
+    /**
+     * The constraints of the multigrid levels.
+     */
+    SmartPointer<const MGConstrainedDoFs, MGTransferMatrixFree<dim,Number> > mg_constrained_dofs;
+
+    /**
+     * The polynomial degree of the finite element.
+     */
+    unsigned int fe_degree;
+
+    /**
+     * Whether the element is continuous, i.e., the children of a cell share
+     * degrees of freedom.
+     */
+    bool element_is_continuous;
+
+    /**
+     * The number of components of the finite element.
+     */
+    unsigned int n_components;
+
+    /**
+     * The number of degrees of freedom on the children of a cell.
+     */
+    unsigned int n_child_cell_dofs;
+
+    /**
+     * The number of parent cells of each level, i.e., the number of cells
+     * on level <tt>l</tt> that have children on level <tt>l+1</tt>, stored
+     * at position <tt>l</tt>.
+     */
+    std::vector<unsigned int> n_parent_cells;
+
+    /**
+     * The one-dimensional embedding matrix from the mother element to both
+     * children on the device.
+     */
+    Number *prolongation_matrix_1d_dev;
+
+    /**
+     * The indices of the degrees of freedom on the children of each parent
+     * cell on the device, in lexicographic order of the child patch. The
+     * entry <tt>l</tt> refers to the parent cells on level <tt>l</tt> and
+     * the indices on level <tt>l+1</tt>.
+     */
+    std::vector<unsigned int *> child_indices_dev;
+
+    /**
+     * The indices of the degrees of freedom of each parent cell on the
+     * device, in lexicographic order. Indices that are constrained by
+     * Dirichlet boundary conditions are set to numbers::invalid_unsigned_int.
+     */
+    std::vector<unsigned int *> parent_indices_dev;
+
+    /**
+     * The weights of the degrees of freedom on the children of each parent
+     * cell on the device, which correct for the contributions of several
+     * parents to shared degrees of freedom of continuous elements. There are
+     * <tt>3<sup>dim</sup></tt> weights per parent cell, one for each vertex,
+     * line, face and interior of the child patch.
+     */
+    std::vector<Number *> weights_dev;
+
+    /**
+     * The number of pairs of global and level indices in #copy_indices_dev
+     * on each level.
+     */
+    std::vector<unsigned int> n_copy_indices;
+
+    /**
+     * The global indices of the degrees of freedom active on each level,
+     * followed by the respective level indices, on the device.
+     */
+    std::vector<unsigned int *> copy_indices_dev;
+
+    /**
+     * The number of degrees of freedom on each level.
+     */
+    std::vector<types::global_dof_index> n_level_dofs;
+  };
+
+  /*@}*/
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
+
+#endif
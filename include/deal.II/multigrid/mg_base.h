@@ -205,6 +205,16 @@ public:
   virtual void restrict_and_add (const unsigned int from_level,
                                  VectorType         &dst,
                                  const VectorType   &src) const = 0;
+
+  /**
+   * Return whether the current processor takes part in the computations on
+   * the given level. Transfer classes that agglomerate the coarser levels
+   * onto a subset of the processors return false on the processors that do
+   * not hold any data on that level, which makes Multigrid skip the
+   * smoothing and the coarse grid solve there. The default implementation
+   * returns true.
+   */
+  virtual bool is_active_on_level (const unsigned int level) const;
 };
 
 
@@ -21,8 +21,14 @@
 #include <deal.II/lac/householder.h>
 #include <deal.II/lac/linear_operator.h>
 #include <deal.II/lac/matrix_lib.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/trilinos_precondition.h>
+#include <deal.II/lac/trilinos_solver.h>
+#include <deal.II/lac/trilinos_vector.h>
 #include <deal.II/multigrid/mg_base.h>
 
+#include <memory>
+
 DEAL_II_NAMESPACE_OPEN
 
 /*!@addtogroup mg */
@@ -234,6 +240,132 @@ private:
 
 
 
+/**
+ * Coarse grid solver that applies an (approximate) inverse of the coarse
+ * grid matrix which is set up once and then reused in all subsequent
+ * multigrid cycles. Typical choices for @p PreconditionerType are
+ * TrilinosWrappers::PreconditionAMG, SparseDirectUMFPACK, or
+ * TrilinosWrappers::SolverDirect. In contrast to MGCoarseGridIterativeSolver,
+ * no Krylov iteration is run, so the AMG hierarchy or the factorization of
+ * the matrix computed in initialize() is the only setup cost, which is
+ * typically paid once per mesh rather than in every cycle.
+ *
+ * When the entries of the coarse grid matrix change but the mesh stays the
+ * same, e.g. for changing coefficients in a time-dependent or nonlinear
+ * problem, the function update() selects how much of the setup is redone
+ * according to a SetupReuse policy. For TrilinosWrappers::PreconditionAMG,
+ * SetupReuse::reuse_structure keeps the aggregation computed in the initial
+ * setup and only recomputes the multilevel operators via
+ * TrilinosWrappers::PreconditionAMG::reinit(). The other types do not offer
+ * a cheaper partial setup and are set up from scratch in that case.
+ *
+ * The preconditioner object is set up via a function
+ * <code>initialize(matrix, additional_data)</code> (or
+ * <code>initialize(matrix)</code> for TrilinosWrappers::SolverDirect, which
+ * takes its parameters in the constructor) and applied via
+ * <code>vmult(dst, src)</code> (or <code>solve(dst, src)</code> for
+ * TrilinosWrappers::SolverDirect). For level vectors of type
+ * LinearAlgebra::distributed::Vector<float>, as used by matrix-free
+ * multigrid in single precision, the vectors are converted to double
+ * precision before calling the preconditioner.
+ */
+template <class VectorType,
+          class MatrixType,
+          class PreconditionerType>
+class MGCoarseGridApplyPreconditioner : public MGCoarseGridBase<VectorType>
+{
+public:
+  /**
+   * Policy for the recomputation of the setup in update().
+   */
+  enum SetupReuse
+  {
+    /**
+     * Set up the preconditioner from scratch for the new matrix.
+     */
+    full_setup,
+    /**
+     * Keep the structural part of the setup (such as the AMG aggregates)
+     * and only recompute the numerical values from the new matrix entries.
+     */
+    reuse_structure,
+    /**
+     * Keep the complete setup from the previous matrix. This is useful if
+     * the coarse grid operator changes only slightly and an approximate
+     * coarse grid solve suffices.
+     */
+    reuse_setup
+  };
+
+  /**
+   * Default constructor. The preconditioner object is default-constructed
+   * in the first call to initialize().
+   */
+  MGCoarseGridApplyPreconditioner ();
+
+  /**
+   * Constructor taking a preconditioner object that has been created
+   * outside this class, e.g. a TrilinosWrappers::SolverDirect that needs a
+   * SolverControl upon construction. The object is set up in initialize().
+   */
+  MGCoarseGridApplyPreconditioner (const std::shared_ptr<PreconditionerType> &preconditioner);
+
+  /**
+   * Set up the preconditioner for the given matrix with the given
+   * parameters.
+   */
+  void initialize (const MatrixType &matrix,
+                   const typename PreconditionerType::AdditionalData &additional_data
+                   = typename PreconditionerType::AdditionalData());
+
+  /**
+   * Update the setup for a matrix with changed entries on the same mesh
+   * according to the given policy, reusing the parameters given to
+   * initialize(). For SetupReuse::reuse_structure with
+   * TrilinosWrappers::PreconditionAMG, @p matrix must be the same object as
+   * the one given to initialize().
+   */
+  void update (const MatrixType &matrix,
+               const SetupReuse  policy);
+
+  /**
+   * Release the preconditioner.
+   */
+  void clear ();
+
+  /**
+   * Return the number of times the preconditioner has been set up,
+   * counting both complete and partial setups.
+   */
+  unsigned int n_setups () const;
+
+  /**
+   * Implementation of the abstract function. Applies the preconditioner to
+   * the vector @p src.
+   */
+  virtual void operator() (const unsigned int level,
+                           VectorType         &dst,
+                           const VectorType   &src) const;
+
+private:
+  /**
+   * The preconditioner object.
+   */
+  std::shared_ptr<PreconditionerType> preconditioner;
+
+  /**
+   * The parameters given to initialize().
+   */
+  typename PreconditionerType::AdditionalData additional_data;
+
+  /**
+   * The number of setups performed so far.
+   */
+  unsigned int setup_counter;
+};
+
+
+
 /**
  * Coarse grid solver by QR factorization implemented in the class
  * Householder.
@@ -531,6 +663,198 @@ MGCoarseGridIterativeSolver<VectorType, SolverType, MatrixType, PreconditionerTy
 
 
 
+/* ------------------ Functions for MGCoarseGridApplyPreconditioner ------------ */
+
+namespace internal
+{
+  namespace MGCoarseGridApplyPreconditioner
+  {
+    // generic setup and application of the preconditioner
+    template <typename PreconditionerType, typename MatrixType>
+    void setup (PreconditionerType                                 &preconditioner,
+                const MatrixType                                   &matrix,
+                const typename PreconditionerType::AdditionalData &additional_data,
+                const bool                                         reuse_structure)
+    {
+      (void)reuse_structure;
+      preconditioner.initialize(matrix, additional_data);
+    }
+
+    template <typename PreconditionerType>
+    void create (std::shared_ptr<PreconditionerType> &preconditioner)
+    {
+      preconditioner.reset(new PreconditionerType());
+    }
+
+    template <typename PreconditionerType, typename VectorType>
+    void apply (PreconditionerType &preconditioner,
+                VectorType         &dst,
+                const VectorType   &src)
+    {
+      preconditioner.vmult(dst, src);
+    }
+
+#ifdef DEAL_II_WITH_TRILINOS
+    // AMG can reuse the aggregation of a previous setup
+    template <typename MatrixType>
+    void setup (TrilinosWrappers::PreconditionAMG                        &preconditioner,
+                const MatrixType                                         &matrix,
+                const TrilinosWrappers::PreconditionAMG::AdditionalData &additional_data,
+                const bool                                               reuse_structure)
+    {
+      if (reuse_structure)
+        preconditioner.reinit();
+      else
+        preconditioner.initialize(matrix, additional_data);
+    }
+
+    // the direct solver takes its parameters in the constructor and applies
+    // the factorization in solve()
+    inline
+    void create (std::shared_ptr<TrilinosWrappers::SolverDirect> &)
+    {
+      AssertThrow(false,
+                  ExcMessage("TrilinosWrappers::SolverDirect needs a SolverControl "
+                             "object upon construction, so it must be created "
+                             "outside and passed to the constructor of "
+                             "MGCoarseGridApplyPreconditioner."));
+    }
+
+    template <typename MatrixType>
+    void setup (TrilinosWrappers::SolverDirect                        &solver,
+                const MatrixType                                      &matrix,
+                const TrilinosWrappers::SolverDirect::AdditionalData &,
+                const bool)
+    {
+      solver.initialize(matrix);
+    }
+
+    inline
+    void apply (TrilinosWrappers::SolverDirect                           &solver,
+                LinearAlgebra::distributed::Vector<double>       &dst,
+                const LinearAlgebra::distributed::Vector<double> &src)
+    {
+      solver.solve(dst, src);
+    }
+
+    inline
+    void apply (TrilinosWrappers::SolverDirect     &solver,
+                TrilinosWrappers::MPI::Vector       &dst,
+                const TrilinosWrappers::MPI::Vector &src)
+    {
+      solver.solve(dst, src);
+    }
+#endif
+
+    // the preconditioners for the coarse grid work in double precision, so
+    // convert single-precision vectors
+    template <typename PreconditionerType>
+    void apply (PreconditionerType                                &preconditioner,
+                LinearAlgebra::distributed::Vector<float>       &dst,
+                const LinearAlgebra::distributed::Vector<float> &src)
+    {
+      LinearAlgebra::distributed::Vector<double> src_double, dst_double;
+      src_double.reinit(src, true);
+      dst_double.reinit(dst, true);
+      src_double.copy_locally_owned_data_from(src);
+      apply(preconditioner, dst_double, src_double);
+      dst.copy_locally_owned_data_from(dst_double);
+    }
+  }
+}
+
+
+
+template <class VectorType, class MatrixType, class PreconditionerType>
+MGCoarseGridApplyPreconditioner<VectorType, MatrixType, PreconditionerType>
+::MGCoarseGridApplyPreconditioner ()
+  :
+  setup_counter (0)
+{}
+
+
+
+template <class VectorType, class MatrixType, class PreconditionerType>
+MGCoarseGridApplyPreconditioner<VectorType, MatrixType, PreconditionerType>
+::MGCoarseGridApplyPreconditioner (const std::shared_ptr<PreconditionerType> &preconditioner)
+  :
+  preconditioner (preconditioner),
+  setup_counter (0)
+{}
+
+
+
+template <class VectorType, class MatrixType, class PreconditionerType>
+void
+MGCoarseGridApplyPreconditioner<VectorType, MatrixType, PreconditionerType>
+::initialize (const MatrixType                                   &matrix,
+              const typename PreconditionerType::AdditionalData &data)
+{
+  if (preconditioner.get() == nullptr)
+    internal::MGCoarseGridApplyPreconditioner::create(preconditioner);
+  additional_data = data;
+  internal::MGCoarseGridApplyPreconditioner::setup(*preconditioner, matrix,
+                                                   additional_data, false);
+  ++setup_counter;
+}
+
+
+
+template <class VectorType, class MatrixType, class PreconditionerType>
+void
+MGCoarseGridApplyPreconditioner<VectorType, MatrixType, PreconditionerType>
+::update (const MatrixType &matrix,
+          const SetupReuse  policy)
+{
+  Assert(preconditioner.get() != nullptr && setup_counter > 0,
+         ExcMessage("The preconditioner must be set up by initialize() "
+                    "before it can be updated."));
+  if (policy == reuse_setup)
+    return;
+
+  internal::MGCoarseGridApplyPreconditioner::setup(*preconditioner, matrix,
+                                                   additional_data,
+                                                   policy == reuse_structure);
+  ++setup_counter;
+}
+
+
+
+template <class VectorType, class MatrixType, class PreconditionerType>
+void
+MGCoarseGridApplyPreconditioner<VectorType, MatrixType, PreconditionerType>
+::clear ()
+{
+  preconditioner.reset();
+  setup_counter = 0;
+}
+
+
+
+template <class VectorType, class MatrixType, class PreconditionerType>
+unsigned int
+MGCoarseGridApplyPreconditioner<VectorType, MatrixType, PreconditionerType>
+::n_setups () const
+{
+  return setup_counter;
+}
+
+
+
+template <class VectorType, class MatrixType, class PreconditionerType>
+void
+MGCoarseGridApplyPreconditioner<VectorType, MatrixType, PreconditionerType>
+::operator() (const unsigned int /*level*/,
+              VectorType         &dst,
+              const VectorType   &src) const
+{
+  Assert(preconditioner.get() != nullptr && setup_counter > 0,
+         ExcNotInitialized());
+  internal::MGCoarseGridApplyPreconditioner::apply(*preconditioner, dst, src);
+}
+
+
+
 /* ------------------ Functions for MGCoarseGridHouseholder ------------ */
 
 template <typename number, class VectorType>
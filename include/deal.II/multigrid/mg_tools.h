@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2005 - 2016 by the deal.II authors
+// Copyright (C) 2005 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -73,6 +73,9 @@ namespace MGTools
    *
    * There is no need to consider hanging nodes here, since only one level is
    * considered.
+   *
+   * The indices of the cells are extracted in parallel, while the entries
+   * are added to @p sparsity row by row on one thread at a time.
    */
   template <typename DoFHandlerType, typename SparsityPatternType>
   void
@@ -209,6 +212,8 @@ namespace MGTools
    * as input.
    *
    * Previous content in @p boundary_indices is not overwritten, but added to.
+   * The cells of all levels are worked on in parallel, and the indices are
+   * added to the IndexSet of each level at once.
    */
   template <int dim, int spacedim>
   void
@@ -220,7 +225,8 @@ namespace MGTools
   /**
    * For each level in a multigrid hierarchy, produce an IndexSet that
    * indicates which of the degrees of freedom are along interfaces of this
-   * level to cells that only exist on coarser levels.
+   * level to cells that only exist on coarser levels. The cells of all
+   * levels are worked on in parallel.
    */
   template <int dim, int spacedim>
   void
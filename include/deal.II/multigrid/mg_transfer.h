@@ -297,11 +297,61 @@ class MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> > : publi
 {
 public:
 
+  /**
+   * Constructor.
+   */
+  MGLevelGlobalTransfer ();
+
   /**
    * Reset the object to the state it had right after the default constructor.
    */
   void clear ();
 
+  /**
+   * Agglomerate the coarse levels onto a subset of the processors. On each
+   * level except the finest one, the level is distributed among
+   * $\max(1,N_\text{cells}/$@p min_cells_per_process$)$ processors, where
+   * $N_\text{cells}$ is the number of cells on that level, if this is less
+   * than the number of processors of the triangulation's communicator. The
+   * number of participating processors never increases towards coarser
+   * levels. The level vectors on an agglomerated level are distributed by
+   * contiguous blocks of the level degrees of freedom among the first
+   * processors via the partitioner returned by
+   * get_agglomerated_partitioner(), and the remaining processors hold no
+   * entries on that level and skip the level smoothing and the coarse grid
+   * solve inside Multigrid, see is_active_on_level(). The data movement
+   * between the natural layout of the level degrees of freedom (given by the
+   * level subdomain ids of the cells) and the agglomerated layout is done
+   * inside the transfer, so the level matrices, smoothers and the coarse
+   * grid solver on agglomerated levels must use vectors with the
+   * agglomerated layout, e.g., a matrix that has been set up with the
+   * agglomerated partitioner and its sub-communicator.
+   *
+   * Agglomeration is set up during the build() function of the derived
+   * classes, so this function must be called before build(). A value of
+   * zero, the default, disables agglomeration. Agglomeration is only done
+   * for parallel triangulations and is currently implemented by
+   * MGTransferMatrixFree.
+   */
+  void set_coarse_level_agglomeration (const unsigned int min_cells_per_process);
+
+  /**
+   * Return the partitioner describing the layout of the level vectors on an
+   * agglomerated level, or a null pointer if the given level is distributed
+   * in the natural way. On the processors that do not participate on the
+   * level, the partitioner has no locally owned entries and is based on
+   * MPI_COMM_SELF.
+   */
+  std::shared_ptr<const Utilities::MPI::Partitioner>
+  get_agglomerated_partitioner (const unsigned int level) const;
+
+  /**
+   * Return whether the current processor holds entries of the level vectors
+   * on the given level, i.e., false for the processors that are not part of
+   * the sub-communicator of an agglomerated level.
+   */
+  virtual bool is_active_on_level (const unsigned int level) const;
+
   /**
    * Transfer from a vector on the global grid to vectors defined on each of
    * the levels separately for the active degrees of freedom. In particular, for
@@ -385,6 +435,42 @@ protected:
   template <int dim, int spacedim>
   void fill_and_communicate_copy_indices(const DoFHandler<dim,spacedim> &mg_dof);
 
+  /**
+   * Internal function to set up the agglomerated layouts of the coarse
+   * levels as requested by set_coarse_level_agglomeration(). Called by
+   * derived classes in their build() function.
+   */
+  template <int dim, int spacedim>
+  void setup_agglomeration(const DoFHandler<dim,spacedim> &mg_dof);
+
+  /**
+   * Return whether the level vectors on the given level use the agglomerated
+   * layout.
+   */
+  bool level_is_agglomerated (const unsigned int level) const;
+
+  /**
+   * Move the locally owned entries of the vector @p src in the natural level
+   * layout to the vector @p dst in the agglomerated layout of the given
+   * level. If @p add is true, the entries are added to @p dst, otherwise
+   * they overwrite its content. This is a collective operation on the
+   * communicator of the triangulation.
+   */
+  void copy_to_agglomerated (const unsigned int                                level,
+                             LinearAlgebra::distributed::Vector<Number>       &dst,
+                             const LinearAlgebra::distributed::Vector<Number> &src,
+                             const bool                                        add) const;
+
+  /**
+   * Move the entries of the vector @p src in the agglomerated layout of the
+   * given level to the locally owned entries of the vector @p dst in the
+   * natural level layout. This is a collective operation on the
+   * communicator of the triangulation.
+   */
+  void copy_from_agglomerated (const unsigned int                                level,
+                               LinearAlgebra::distributed::Vector<Number>       &dst,
+                               const LinearAlgebra::distributed::Vector<Number> &src) const;
+
   /**
    * Sizes of the multi-level vectors.
    */
@@ -489,6 +575,40 @@ protected:
    */
   mutable MGLevelObject<LinearAlgebra::distributed::Vector<Number> > solution_ghosted_level_vector;
 
+  /**
+   * The minimal number of cells per processor on the coarse levels as set
+   * by set_coarse_level_agglomeration(), or zero if no agglomeration is
+   * requested.
+   */
+  unsigned int agglomeration_min_cells;
+
+  /**
+   * The layout of the level vectors on the agglomerated levels, or null
+   * pointers on the levels that are distributed in the natural way.
+   */
+  std::vector<std::shared_ptr<const Utilities::MPI::Partitioner> > agglomerated_partitioners;
+
+  /**
+   * The sub-communicators of the agglomerated levels. Levels with the same
+   * number of participating processors share the communicator, which is
+   * freed once the last level using it is cleared. The processors not
+   * participating on a level hold a null pointer.
+   */
+  std::vector<std::shared_ptr<MPI_Comm> > agglomeration_communicators;
+
+  /**
+   * Vectors used for moving data between the natural and the agglomerated
+   * layout of a level. They live on the communicator of the triangulation,
+   * own the entries of the agglomerated layout, and have the locally owned
+   * level degrees of freedom of the natural layout as ghosts.
+   */
+  mutable std::vector<LinearAlgebra::distributed::Vector<Number> > agglomeration_exchange_vectors;
+
+  /**
+   * For each locally owned level degree of freedom in the natural layout,
+   * the local index within the respective agglomeration exchange vector.
+   */
+  std::vector<std::vector<unsigned int> > agglomeration_natural_indices;
 };
 
 
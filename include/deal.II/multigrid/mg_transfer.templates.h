@@ -104,13 +104,17 @@ namespace
   /**
    * Adjust vectors on all levels to correct size.  Here, we just count the
    * numbers of degrees of freedom on each level and @p reinit each level
-   * vector to this length.
+   * vector to this length. Levels for which @p level_partitioners holds a
+   * non-null pointer are initialized with that partitioner instead of the
+   * locally owned level degrees of freedom.
    */
   template <int dim, typename number, int spacedim>
   void
   reinit_vector (const dealii::DoFHandler<dim,spacedim> &mg_dof,
                  const std::vector<unsigned int> &,
-                 MGLevelObject<LinearAlgebra::distributed::Vector<number> > &v)
+                 MGLevelObject<LinearAlgebra::distributed::Vector<number> > &v,
+                 const std::vector<std::shared_ptr<const Utilities::MPI::Partitioner> > &level_partitioners
+                 = std::vector<std::shared_ptr<const Utilities::MPI::Partitioner> >())
   {
     const parallel::Triangulation<dim,spacedim> *tria =
       (dynamic_cast<const parallel::Triangulation<dim,spacedim>*>
@@ -118,7 +122,15 @@ namespace
 
     for (unsigned int level=v.min_level(); level<=v.max_level(); ++level)
       {
-        if (v[level].size() != mg_dof.locally_owned_mg_dofs(level).size() ||
+        if (level < level_partitioners.size() &&
+            level_partitioners[level].get() != nullptr)
+          {
+            if (v[level].get_partitioner().get() != level_partitioners[level].get())
+              v[level].reinit(level_partitioners[level]);
+            else
+              v[level] = 0.;
+          }
+        else if (v[level].size() != mg_dof.locally_owned_mg_dofs(level).size() ||
             v[level].local_size() != mg_dof.locally_owned_mg_dofs(level).n_elements())
           v[level].reinit(mg_dof.locally_owned_mg_dofs(level), tria != nullptr ?
                           tria->get_communicator() : MPI_COMM_SELF);
@@ -390,7 +402,8 @@ MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::copy_to_mg
 
   AssertIndexRange(dst.max_level(), mg_dof_handler.get_triangulation().n_global_levels());
   AssertIndexRange(dst.min_level(), dst.max_level()+1);
-  reinit_vector(mg_dof_handler, component_to_block_map, dst);
+  reinit_vector(mg_dof_handler, component_to_block_map, dst,
+                agglomerated_partitioners);
 
   if (perform_plain_copy)
     {
@@ -413,8 +426,11 @@ MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::copy_to_mg
   AssertDimension(ghosted_global_vector.local_size(), src.local_size());
 
   // copy the source vector to the temporary vector that we hold for the
-  // purpose of data exchange
-  this_ghosted_global_vector = src;
+  // purpose of data exchange. Only the locally owned range is copied (and
+  // converted in case the level vectors have a different precision than
+  // @p src), which avoids the global check for compatible parallel layouts
+  // in the assignment operator
+  this_ghosted_global_vector.copy_locally_owned_data_from(src);
   this_ghosted_global_vector.update_ghost_values();
 
   for (unsigned int level=dst.max_level()+1; level != dst.min_level();)
@@ -422,7 +438,14 @@ MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::copy_to_mg
       --level;
 
       typedef std::vector<std::pair<unsigned int, unsigned int> >::const_iterator dof_pair_iterator;
-      LinearAlgebra::distributed::Vector<Number> &dst_level = dst[level];
+
+      // on agglomerated levels, fill the vector in the natural layout first
+      // and move the data afterwards
+      const bool is_agglomerated = level_is_agglomerated(level);
+      if (is_agglomerated)
+        ghosted_level_vector[level] = 0.;
+      LinearAlgebra::distributed::Vector<Number> &dst_level =
+        is_agglomerated ? ghosted_level_vector[level] : dst[level];
 
       // first copy local unknowns
       for (dof_pair_iterator i = this_copy_indices[level].begin();
@@ -436,6 +459,8 @@ MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::copy_to_mg
         dst_level.local_element(i->second) = this_ghosted_global_vector.local_element(i->first);
 
       dst_level.compress(VectorOperation::insert);
+      if (is_agglomerated)
+        copy_to_agglomerated(level, dst[level], dst_level, false);
     }
 }
 
@@ -481,16 +506,21 @@ MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::copy_from_mg
     {
       typedef std::vector<std::pair<unsigned int, unsigned int> >::const_iterator dof_pair_iterator;
 
-      // the ghosted vector should already have the correct local size (but
-      // different parallel layout)
-      AssertDimension(ghosted_level_vector[level].local_size(),
-                      src[level].local_size());
-
       // the first time around, we copy the source vector to the temporary
-      // vector that we hold for the purpose of data exchange
+      // vector that we hold for the purpose of data exchange, moving the data
+      // back to the natural layout on agglomerated levels
       LinearAlgebra::distributed::Vector<Number> &ghosted_vector =
         ghosted_level_vector[level];
-      ghosted_vector = src[level];
+      if (level_is_agglomerated(level))
+        copy_from_agglomerated(level, ghosted_vector, src[level]);
+      else
+        {
+          // the ghosted vector should already have the correct local size
+          // (but different parallel layout)
+          AssertDimension(ghosted_vector.local_size(),
+                          src[level].local_size());
+          ghosted_vector.copy_locally_owned_data_from(src[level]);
+        }
       ghosted_vector.update_ghost_values();
 
       // first copy local unknowns
@@ -526,16 +556,21 @@ MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::copy_from_mg
     {
       typedef std::vector<std::pair<unsigned int, unsigned int> >::const_iterator dof_pair_iterator;
 
-      // the ghosted vector should already have the correct local size (but
-      // different parallel layout)
-      AssertDimension(ghosted_level_vector[level].local_size(),
-                      src[level].local_size());
-
       // the first time around, we copy the source vector to the temporary
-      // vector that we hold for the purpose of data exchange
+      // vector that we hold for the purpose of data exchange, moving the data
+      // back to the natural layout on agglomerated levels
       LinearAlgebra::distributed::Vector<Number> &ghosted_vector =
         ghosted_level_vector[level];
-      ghosted_vector = src[level];
+      if (level_is_agglomerated(level))
+        copy_from_agglomerated(level, ghosted_vector, src[level]);
+      else
+        {
+          // the ghosted vector should already have the correct local size
+          // (but different parallel layout)
+          AssertDimension(ghosted_vector.local_size(),
+                          src[level].local_size());
+          ghosted_vector.copy_locally_owned_data_from(src[level]);
+        }
       ghosted_vector.update_ghost_values();
 
       // first add local unknowns
@@ -0,0 +1,365 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mg_transfer_global_coarsening_h
+#define dealii_mg_transfer_global_coarsening_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/multigrid/mg_base.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup mg */
+/*@{*/
+
+/**
+ * Implementation of the MGTransferBase interface for global coarsening,
+ * i.e., a multigrid hierarchy where each level is an independent
+ * triangulation that covers the whole domain. As opposed to the local
+ * smoothing approach of MGTransferMatrixFree based on the level degrees of
+ * freedom of DoFHandler::distribute_mg_dofs(), each level here is the active
+ * mesh of its own triangulation with its own parallel partitioning, e.g. a
+ * parallel::distributed::Triangulation that has been repartitioned after
+ * each coarsening step. On adaptively refined meshes, this keeps all
+ * processors busy on the coarser levels, whereas the level partitions of
+ * local smoothing often end up on a few processors only.
+ *
+ * The levels are described by one DoFHandler per triangulation, passed to
+ * build() in the order from the coarsest to the finest mesh, and the index
+ * in that list is the multigrid level. All triangulations must be created
+ * from the same coarse mesh, and two consecutive triangulations must be
+ * nested in the sense that each active cell of the finer one is either an
+ * active cell of the coarser one or a child of an active cell of the
+ * coarser one. Such a sequence is obtained e.g. by applying all but the
+ * last refinement steps of the fine mesh to a copy of the coarse mesh, or
+ * by globally coarsening all cells that are flagged for coarsening. The
+ * element must be the same on all levels.
+ *
+ * The transfer is computed on the locally owned cells of the finer
+ * triangulation. For each such cell, the degrees of freedom of the
+ * associated coarse cell are looked up on the coarser triangulation, which
+ * might be owned by a different processor. The required coarse values are
+ * imported as ghost entries of a vector with its own
+ * Utilities::MPI::Partitioner, so the communication per application is a
+ * single ghost exchange (respectively compress) per transfer. The lookup of
+ * coarse cells that are neither locally owned nor ghosted on the coarse
+ * triangulation is done once in build() by sending the cell paths to all
+ * processors.
+ *
+ * The element-wise prolongation uses the 1D embedding matrices of the
+ * element, applied by sum factorization with internal::EvaluatorTensorProduct
+ * as in MGTransferMatrixFree. For continuous elements, the contributions of
+ * the cells sharing a degree of freedom are averaged, and the restriction
+ * is the exact transpose of the prolongation. Homogeneous constraints (e.g.
+ * hanging nodes and Dirichlet boundary conditions) of each level are
+ * respected in the same way as in MGTransferPolynomialMatrixFree.
+ *
+ * This class currently only works for tensor-product finite elements based
+ * on FE_Q and FE_DGQ elements, including systems involving multiple copies
+ * of one of these elements.
+ */
+template <int dim, typename Number>
+class MGTransferGlobalCoarsening : public MGTransferBase<LinearAlgebra::distributed::Vector<Number> >
+{
+public:
+  /**
+   * Constructor. The object is not usable before build() has been called.
+   */
+  MGTransferGlobalCoarsening ();
+
+  /**
+   * Destructor.
+   */
+  virtual ~MGTransferGlobalCoarsening () = default;
+
+  /**
+   * Reset the object to the state it had right after the default constructor.
+   */
+  void clear ();
+
+  /**
+   * Build the transfer operators between all pairs of consecutive levels.
+   * The DoFHandler objects in @p dof_handlers describe the levels from the
+   * coarsest to the finest mesh, each based on its own triangulation. The
+   * optional vector @p constraints holds the (homogeneous) constraints of
+   * each level. If it is empty, no constraints are applied. Otherwise, it
+   * must have the same length as @p dof_handlers, where null pointers are
+   * allowed for levels without constraints.
+   *
+   * The objects pointed to must remain alive as long as this object is used.
+   * This function is collective over the communicator of the triangulations.
+   */
+  void build (const std::vector<const DoFHandler<dim> *>   &dof_handlers,
+              const std::vector<const ConstraintMatrix *> &constraints
+              = std::vector<const ConstraintMatrix *>());
+
+  /**
+   * Prolongate a vector from level <tt>to_level-1</tt> to level
+   * <tt>to_level</tt> using the embedding matrices of the underlying finite
+   * element. The previous content of <tt>dst</tt> is overwritten.
+   *
+   * @param to_level The index of the level to prolongate to, which is the
+   * level of @p dst.
+   *
+   * @param src is a vector with as many elements as there are degrees of
+   * freedom on the coarser level involved.
+   *
+   * @param dst has as many elements as there are degrees of freedom on the
+   * finer level.
+   */
+  virtual void prolongate (const unsigned int                                to_level,
+                           LinearAlgebra::distributed::Vector<Number>       &dst,
+                           const LinearAlgebra::distributed::Vector<Number> &src) const;
+
+  /**
+   * Restrict a vector from level <tt>from_level</tt> to level
+   * <tt>from_level-1</tt> using the transpose operation of the prolongate()
+   * method and add the result to @p dst.
+   *
+   * @param from_level The index of the level to restrict from, which is the
+   * level of @p src.
+   *
+   * @param src is a vector with as many elements as there are degrees of
+   * freedom on the finer level involved.
+   *
+   * @param dst has as many elements as there are degrees of freedom on the
+   * coarser level.
+   */
+  virtual void restrict_and_add (const unsigned int                                from_level,
+                                 LinearAlgebra::distributed::Vector<Number>       &dst,
+                                 const LinearAlgebra::distributed::Vector<Number> &src) const;
+
+  /**
+   * Initialize the vectors on all levels of @p dst to the layout of the
+   * respective DoFHandler and copy the global vector @p src into the
+   * finest level. The argument @p dof_handler is only used for consistency
+   * checks and must be the DoFHandler of the finest level.
+   */
+  template <typename Number2>
+  void
+  copy_to_mg (const DoFHandler<dim>                                     &dof_handler,
+              MGLevelObject<LinearAlgebra::distributed::Vector<Number> > &dst,
+              const LinearAlgebra::distributed::Vector<Number2>          &src) const;
+
+  /**
+   * Copy the content of the finest level of @p src into the global vector
+   * @p dst.
+   */
+  template <typename Number2>
+  void
+  copy_from_mg (const DoFHandler<dim>                                           &dof_handler,
+                LinearAlgebra::distributed::Vector<Number2>                      &dst,
+                const MGLevelObject<LinearAlgebra::distributed::Vector<Number> > &src) const;
+
+  /**
+   * Add the content of the finest level of @p src to the global vector @p
+   * dst.
+   */
+  template <typename Number2>
+  void
+  copy_from_mg_add (const DoFHandler<dim>                                           &dof_handler,
+                    LinearAlgebra::distributed::Vector<Number2>                      &dst,
+                    const MGLevelObject<LinearAlgebra::distributed::Vector<Number> > &src) const;
+
+  /**
+   * Return the number of levels, i.e., the number of DoFHandler objects
+   * passed to build().
+   */
+  unsigned int n_levels () const;
+
+  /**
+   * Memory used by this object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The DoFHandler objects of all levels.
+   */
+  std::vector<SmartPointer<const DoFHandler<dim>,MGTransferGlobalCoarsening<dim,Number> > > dof_handlers;
+
+  /**
+   * The constraints of all levels. Null pointers denote levels without
+   * constraints.
+   */
+  std::vector<SmartPointer<const ConstraintMatrix,MGTransferGlobalCoarsening<dim,Number> > > level_constraints;
+
+  /**
+   * The polynomial degree of the element.
+   */
+  unsigned int fe_degree;
+
+  /**
+   * Stores the number of components in the finite element.
+   */
+  unsigned int n_components;
+
+  /**
+   * The 1D prolongation matrices to the left and right child in
+   * lexicographic order, stored in the format expected by
+   * internal::EvaluatorTensorProduct.
+   */
+  AlignedVector<Number> prolongation_matrix_1d[2];
+
+  /**
+   * For the transfer into level @p l, holds the indices of the degrees of
+   * freedom on the locally owned cells of level @p l in lexicographic
+   * order, expressed as local indices of <tt>ghosted_level_vector[l]</tt>.
+   */
+  std::vector<std::vector<unsigned int> > fine_dof_indices;
+
+  /**
+   * For the transfer into level @p l, holds the indices of the degrees of
+   * freedom on the coarse cell associated with each locally owned cell of
+   * level @p l in lexicographic order, expressed as local indices of
+   * <tt>ghosted_coarse_vector[l]</tt>.
+   */
+  std::vector<std::vector<unsigned int> > coarse_dof_indices;
+
+  /**
+   * For the transfer into level @p l, holds for each locally owned cell of
+   * level @p l the child index within the coarse cell, or
+   * numbers::invalid_unsigned_int if the cell is the same on both levels.
+   */
+  std::vector<std::vector<unsigned int> > child_indices;
+
+  /**
+   * The weights applied to the fine degrees of freedom on each cell, given
+   * by the inverse of the number of cells a degree of freedom belongs to.
+   * The weights are indexed by the local index in the ghosted level vector.
+   */
+  std::vector<AlignedVector<Number> > weights;
+
+  /**
+   * A ghosted vector for each level with the locally relevant degrees of
+   * freedom of the respective DoFHandler as ghosts.
+   */
+  mutable MGLevelObject<LinearAlgebra::distributed::Vector<Number> > ghosted_level_vector;
+
+  /**
+   * For the transfer into level @p l, a vector in the layout of level
+   * <tt>l-1</tt> whose ghost entries are all coarse degrees of freedom
+   * touched by the locally owned cells of level @p l.
+   */
+  mutable MGLevelObject<LinearAlgebra::distributed::Vector<Number> > ghosted_coarse_vector;
+};
+
+
+/*@}*/
+
+
+//------------------------ templated functions -------------------------
+#ifndef DOXYGEN
+
+
+template <int dim, typename Number>
+template <typename Number2>
+void
+MGTransferGlobalCoarsening<dim,Number>::
+copy_to_mg (const DoFHandler<dim>                                     &dof_handler,
+            MGLevelObject<LinearAlgebra::distributed::Vector<Number> > &dst,
+            const LinearAlgebra::distributed::Vector<Number2>          &src) const
+{
+  (void)dof_handler;
+  AssertIndexRange(dst.max_level(), n_levels());
+  AssertIndexRange(dst.min_level(), dst.max_level()+1);
+  AssertDimension(dof_handler.n_dofs(), dof_handlers[dst.max_level()]->n_dofs());
+
+  for (unsigned int level=dst.min_level(); level<=dst.max_level(); ++level)
+    {
+      const LinearAlgebra::distributed::Vector<Number> &ghosted =
+        ghosted_level_vector[level];
+      if (dst[level].size() != ghosted.size() ||
+          dst[level].local_size() != ghosted.local_size())
+        dst[level].reinit(ghosted.get_partitioner()->locally_owned_range(),
+                          ghosted.get_partitioner()->get_mpi_communicator());
+      else
+        dst[level] = 0.;
+    }
+
+  AssertDimension(dst[dst.max_level()].local_size(), src.local_size());
+  dst[dst.max_level()].copy_locally_owned_data_from(src);
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2>
+void
+MGTransferGlobalCoarsening<dim,Number>::
+copy_from_mg (const DoFHandler<dim>                                           &dof_handler,
+              LinearAlgebra::distributed::Vector<Number2>                      &dst,
+              const MGLevelObject<LinearAlgebra::distributed::Vector<Number> > &src) const
+{
+  (void)dof_handler;
+  AssertIndexRange(src.max_level(), n_levels());
+  AssertDimension(dof_handler.n_dofs(), dof_handlers[src.max_level()]->n_dofs());
+
+  // avoid stray data in the ghost entries of the destination
+  dst.zero_out_ghosts();
+  AssertDimension(src[src.max_level()].local_size(), dst.local_size());
+  dst.copy_locally_owned_data_from(src[src.max_level()]);
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2>
+void
+MGTransferGlobalCoarsening<dim,Number>::
+copy_from_mg_add (const DoFHandler<dim>                                           &dof_handler,
+                  LinearAlgebra::distributed::Vector<Number2>                      &dst,
+                  const MGLevelObject<LinearAlgebra::distributed::Vector<Number> > &src) const
+{
+  (void)dof_handler;
+  AssertIndexRange(src.max_level(), n_levels());
+  AssertDimension(dof_handler.n_dofs(), dof_handlers[src.max_level()]->n_dofs());
+
+  dst.zero_out_ghosts();
+  const LinearAlgebra::distributed::Vector<Number> &src_level = src[src.max_level()];
+  AssertDimension(src_level.local_size(), dst.local_size());
+  for (unsigned int i=0; i<dst.local_size(); ++i)
+    dst.local_element(i) += src_level.local_element(i);
+}
+
+
+
+template <int dim, typename Number>
+inline
+unsigned int
+MGTransferGlobalCoarsening<dim,Number>::n_levels () const
+{
+  return dof_handlers.size();
+}
+
+
+#endif // DOXYGEN
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
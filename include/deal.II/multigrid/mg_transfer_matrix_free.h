@@ -48,6 +48,16 @@ DEAL_II_NAMESPACE_OPEN
  * of one of these elements. Systems with different elements or other elements
  * are currently not implemented.
  *
+ * When running with several threads, the parent cells of each level are
+ * grouped into chunks that are colored such that chunks of the same color do
+ * not write into the same vector entries, and the chunks of a color are
+ * distributed among the threads. Constrained degrees of freedom on the
+ * parent cells are handled inside the kernel. If the vectors passed to
+ * prolongate() and restrict_and_add() already use the same partitioner
+ * (i.e., the same ghost layout) as the internal level vectors of the
+ * transfer, the transfer works on them directly and skips the copies into
+ * the internal vectors.
+ *
  * @author Martin Kronbichler
  * @date 2016
  */
@@ -231,6 +241,16 @@ private:
    */
   std::vector<std::vector<std::vector<unsigned short> > > dirichlet_indices;
 
+  /**
+   * Stores a coloring of the parent cells for running the transfer with
+   * threads for all levels (outer index). For each color (second index),
+   * the ranges of parent cells listed in the inner vector do not write into
+   * the same vector entries, neither in prolongate() nor in
+   * restrict_and_add(), and can be worked on concurrently. Empty if the
+   * transfer runs serially.
+   */
+  std::vector<std::vector<std::vector<std::pair<unsigned int,unsigned int> > > > parent_cell_colors;
+
   /**
    * Performs templated prolongation operation
    */
@@ -0,0 +1,356 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mg_transfer_polynomial_h
+#define dealii_mg_transfer_polynomial_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/multigrid/mg_base.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup mg */
+/*@{*/
+
+/**
+ * Implementation of the MGTransferBase interface for a polynomial (p-)
+ * multigrid hierarchy, i.e., the levels of the multigrid algorithm are not
+ * given by different meshes but by finite element spaces of different
+ * polynomial degree on the same (active) mesh. A typical sequence of degrees
+ * for a high order discretization is $k, k/2, k/4, \ldots, 1$.
+ *
+ * The levels are described by one DoFHandler per degree, all of them
+ * distributed on the same triangulation, passed to build() in the order from
+ * the coarsest to the finest degree. The index of a DoFHandler in that list
+ * is the multigrid level the respective space is associated with, i.e., level
+ * zero is the lowest polynomial degree and the last DoFHandler is the one of
+ * the original problem. The vectors on level @p l are laid out as the global
+ * vectors of the DoFHandler with index @p l, so the level operators can be
+ * set up as usual (e.g. with a MatrixFree object for each DoFHandler).
+ *
+ * The prolongation from degree $k_c$ to degree $k_f$ interpolates the coarse
+ * polynomial into the fine space. Since the coarse space is contained in the
+ * fine space, this embedding is identical to the local $L_2$ projection
+ * computed by FETools::get_projection_matrix(). This class computes the
+ * projection matrix for the one-dimensional versions of the two elements and
+ * applies it to each cell by sum factorization with the kernels of
+ * internal::EvaluatorTensorProduct, i.e., the cost per cell is proportional
+ * to $(k_f+1)^{d+1}$ rather than $(k_f+1)^{2d}$. For continuous elements,
+ * the contributions of the cells sharing a degree of freedom are averaged.
+ * The restriction is the exact transpose of the prolongation.
+ *
+ * Constraints such as hanging nodes and homogeneous Dirichlet boundary
+ * conditions can be passed for each level. On prolongation, the coarse
+ * vector is first completed by the values of the constrained degrees of
+ * freedom (ConstraintMatrix::distribute()) and the constrained entries of
+ * the fine vector are set to zero in the end. Restriction applies the
+ * transpose of these two steps. Since the level vectors in multigrid are
+ * corrections, the constraints must be homogeneous.
+ *
+ * Like MGTransferMatrixFree, this class only works for tensor-product finite
+ * elements based on FE_Q or FE_DGQ elements, including systems of several
+ * copies of one of these elements. The elements on all levels must be of the
+ * same type and have the same number of components.
+ *
+ * The class can be passed to Multigrid and PreconditionMG in place of the
+ * mesh-based transfer classes. The functions copy_to_mg() and copy_from_mg()
+ * connect the finest level with the global vector of the last DoFHandler. In
+ * order to combine p-multigrid with h-multigrid or with an algebraic
+ * multigrid method, the coarse grid solver of this multigrid object (acting
+ * on the lowest degree) can be an MGCoarseGridIterativeSolver whose
+ * preconditioner is a PreconditionMG object based on MGTransferMatrixFree
+ * or an algebraic multigrid preconditioner.
+ */
+template <int dim, typename Number>
+class MGTransferPolynomialMatrixFree : public MGTransferBase<LinearAlgebra::distributed::Vector<Number> >
+{
+public:
+  /**
+   * Constructor. The object is not usable before build() has been called.
+   */
+  MGTransferPolynomialMatrixFree ();
+
+  /**
+   * Destructor.
+   */
+  virtual ~MGTransferPolynomialMatrixFree () = default;
+
+  /**
+   * Reset the object to the state it had right after the default constructor.
+   */
+  void clear ();
+
+  /**
+   * Build the transfer operators between all pairs of consecutive levels.
+   * The DoFHandler objects in @p dof_handlers describe the levels from the
+   * coarsest to the finest polynomial degree and must all be based on the
+   * same triangulation. The optional vector @p constraints holds the
+   * (homogeneous) constraints of each level. If it is empty, no constraints
+   * are applied. Otherwise, it must have the same length as @p dof_handlers,
+   * where null pointers are allowed for levels without constraints.
+   *
+   * The objects pointed to must remain alive as long as this object is used.
+   */
+  void build (const std::vector<const DoFHandler<dim> *>   &dof_handlers,
+              const std::vector<const ConstraintMatrix *> &constraints
+              = std::vector<const ConstraintMatrix *>());
+
+  /**
+   * Prolongate a vector from level <tt>to_level-1</tt> to level
+   * <tt>to_level</tt> by embedding the lower degree polynomials into the
+   * higher degree space. The previous content of <tt>dst</tt> is
+   * overwritten.
+   *
+   * @param to_level The index of the level to prolongate to, which is the
+   * level of @p dst.
+   *
+   * @param src is a vector with as many elements as there are degrees of
+   * freedom on the coarser level involved.
+   *
+   * @param dst has as many elements as there are degrees of freedom on the
+   * finer level.
+   */
+  virtual void prolongate (const unsigned int                                to_level,
+                           LinearAlgebra::distributed::Vector<Number>       &dst,
+                           const LinearAlgebra::distributed::Vector<Number> &src) const;
+
+  /**
+   * Restrict a vector from level <tt>from_level</tt> to level
+   * <tt>from_level-1</tt> using the transpose operation of the prolongate()
+   * method and add the result to @p dst.
+   *
+   * @param from_level The index of the level to restrict from, which is the
+   * level of @p src.
+   *
+   * @param src is a vector with as many elements as there are degrees of
+   * freedom on the finer level involved.
+   *
+   * @param dst has as many elements as there are degrees of freedom on the
+   * coarser level.
+   */
+  virtual void restrict_and_add (const unsigned int                                from_level,
+                                 LinearAlgebra::distributed::Vector<Number>       &dst,
+                                 const LinearAlgebra::distributed::Vector<Number> &src) const;
+
+  /**
+   * Initialize the vectors on all levels of @p dst to the layout of the
+   * respective DoFHandler and copy the global vector @p src into the
+   * finest level. The argument @p dof_handler is only used for consistency
+   * checks and must be the DoFHandler of the finest level.
+   */
+  template <typename Number2>
+  void
+  copy_to_mg (const DoFHandler<dim>                                     &dof_handler,
+              MGLevelObject<LinearAlgebra::distributed::Vector<Number> > &dst,
+              const LinearAlgebra::distributed::Vector<Number2>          &src) const;
+
+  /**
+   * Copy the content of the finest level of @p src into the global vector
+   * @p dst.
+   */
+  template <typename Number2>
+  void
+  copy_from_mg (const DoFHandler<dim>                                           &dof_handler,
+                LinearAlgebra::distributed::Vector<Number2>                      &dst,
+                const MGLevelObject<LinearAlgebra::distributed::Vector<Number> > &src) const;
+
+  /**
+   * Add the content of the finest level of @p src to the global vector @p
+   * dst.
+   */
+  template <typename Number2>
+  void
+  copy_from_mg_add (const DoFHandler<dim>                                           &dof_handler,
+                    LinearAlgebra::distributed::Vector<Number2>                      &dst,
+                    const MGLevelObject<LinearAlgebra::distributed::Vector<Number> > &src) const;
+
+  /**
+   * Return the number of levels, i.e., the number of DoFHandler objects
+   * passed to build().
+   */
+  unsigned int n_levels () const;
+
+  /**
+   * Memory used by this object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * The DoFHandler objects of all levels.
+   */
+  std::vector<SmartPointer<const DoFHandler<dim>,MGTransferPolynomialMatrixFree<dim,Number> > > dof_handlers;
+
+  /**
+   * The constraints of all levels. Null pointers denote levels without
+   * constraints.
+   */
+  std::vector<SmartPointer<const ConstraintMatrix,MGTransferPolynomialMatrixFree<dim,Number> > > level_constraints;
+
+  /**
+   * The polynomial degree of the element on each level.
+   */
+  std::vector<unsigned int> fe_degrees;
+
+  /**
+   * Stores the number of components in the finite element, which is the
+   * same on all levels.
+   */
+  unsigned int n_components;
+
+  /**
+   * The 1D embedding matrices from level <tt>l</tt> to level <tt>l+1</tt>
+   * in lexicographic order of both bases, stored in the format expected by
+   * internal::EvaluatorTensorProduct, i.e., the entry for the coarse basis
+   * function @p i and the fine basis function @p j is at position
+   * <tt>i*(fe_degrees[l+1]+1)+j</tt>.
+   */
+  std::vector<AlignedVector<Number> > prolongation_matrices_1d;
+
+  /**
+   * Holds the indices of the degrees of freedom on the locally owned cells
+   * for each level in lexicographic order, expressed as local indices of
+   * the ghosted level vectors. The cells are enumerated in the order of the
+   * active cell iterators, which is the same for all levels.
+   */
+  std::vector<std::vector<unsigned int> > level_dof_indices;
+
+  /**
+   * The same as level_dof_indices but with global indices, needed for the
+   * resolution of constraints in restrict_and_add().
+   */
+  std::vector<std::vector<types::global_dof_index> > global_level_dof_indices;
+
+  /**
+   * The weights applied to the fine degrees of freedom on each cell, given
+   * by the inverse of the number of cells a degree of freedom belongs to.
+   * The weights are indexed by the local index in the ghosted level vector.
+   */
+  std::vector<AlignedVector<Number> > weights;
+
+  /**
+   * A ghosted vector for each level used for the data exchange between the
+   * processors.
+   */
+  mutable MGLevelObject<LinearAlgebra::distributed::Vector<Number> > ghosted_level_vector;
+};
+
+
+/*@}*/
+
+
+//------------------------ templated functions -------------------------
+#ifndef DOXYGEN
+
+
+template <int dim, typename Number>
+template <typename Number2>
+void
+MGTransferPolynomialMatrixFree<dim,Number>::
+copy_to_mg (const DoFHandler<dim>                                     &dof_handler,
+            MGLevelObject<LinearAlgebra::distributed::Vector<Number> > &dst,
+            const LinearAlgebra::distributed::Vector<Number2>          &src) const
+{
+  (void)dof_handler;
+  AssertIndexRange(dst.max_level(), n_levels());
+  AssertIndexRange(dst.min_level(), dst.max_level()+1);
+  AssertDimension(dof_handler.n_dofs(), dof_handlers[dst.max_level()]->n_dofs());
+
+  for (unsigned int level=dst.min_level(); level<=dst.max_level(); ++level)
+    {
+      const LinearAlgebra::distributed::Vector<Number> &ghosted =
+        ghosted_level_vector[level];
+      if (dst[level].size() != ghosted.size() ||
+          dst[level].local_size() != ghosted.local_size())
+        dst[level].reinit(ghosted.get_partitioner()->locally_owned_range(),
+                          ghosted.get_partitioner()->get_mpi_communicator());
+      else
+        dst[level] = 0.;
+    }
+
+  AssertDimension(dst[dst.max_level()].local_size(), src.local_size());
+  dst[dst.max_level()].copy_locally_owned_data_from(src);
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2>
+void
+MGTransferPolynomialMatrixFree<dim,Number>::
+copy_from_mg (const DoFHandler<dim>                                           &dof_handler,
+              LinearAlgebra::distributed::Vector<Number2>                      &dst,
+              const MGLevelObject<LinearAlgebra::distributed::Vector<Number> > &src) const
+{
+  (void)dof_handler;
+  AssertIndexRange(src.max_level(), n_levels());
+  AssertDimension(dof_handler.n_dofs(), dof_handlers[src.max_level()]->n_dofs());
+
+  // avoid stray data in the ghost entries of the destination
+  dst.zero_out_ghosts();
+  AssertDimension(src[src.max_level()].local_size(), dst.local_size());
+  dst.copy_locally_owned_data_from(src[src.max_level()]);
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2>
+void
+MGTransferPolynomialMatrixFree<dim,Number>::
+copy_from_mg_add (const DoFHandler<dim>                                           &dof_handler,
+                  LinearAlgebra::distributed::Vector<Number2>                      &dst,
+                  const MGLevelObject<LinearAlgebra::distributed::Vector<Number> > &src) const
+{
+  (void)dof_handler;
+  AssertIndexRange(src.max_level(), n_levels());
+  AssertDimension(dof_handler.n_dofs(), dof_handlers[src.max_level()]->n_dofs());
+
+  dst.zero_out_ghosts();
+  const LinearAlgebra::distributed::Vector<Number> &src_level = src[src.max_level()];
+  AssertDimension(src_level.local_size(), dst.local_size());
+  for (unsigned int i=0; i<dst.local_size(); ++i)
+    dst.local_element(i) += src_level.local_element(i);
+}
+
+
+
+template <int dim, typename Number>
+inline
+unsigned int
+MGTransferPolynomialMatrixFree<dim,Number>::n_levels () const
+{
+  return dof_handlers.size();
+}
+
+
+#endif // DOXYGEN
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -356,6 +356,33 @@ private:
  * use of a separate DoFHandler for each block, this class also allows
  * to be initialized with a separate DoFHandler for each block.
  *
+ * The vector type used by the iterative solver calling vmult() does not need
+ * to coincide with @p VectorType of the multigrid levels, as long as the
+ * transfer object can convert between the two. In particular, the transfer
+ * classes for LinearAlgebra::distributed::Vector (e.g. MGTransferMatrixFree)
+ * convert between different number types within copy_to_mg() and
+ * copy_from_mg(), i.e., while copying the defect into the level vectors and
+ * the level solution into the global vector. Thus, a multigrid V-cycle with
+ * level operators and smoothers in single precision can be used as a
+ * preconditioner for a solver in double precision without additional vector
+ * copies:
+ * @code
+ * typedef LinearAlgebra::distributed::Vector<float> LevelVectorType;
+ * MGTransferMatrixFree<dim,float> mg_transfer(mg_constrained_dofs);
+ * ...
+ * Multigrid<LevelVectorType> mg(mg_matrix, mg_coarse, mg_transfer,
+ *                               mg_smoother, mg_smoother);
+ * PreconditionMG<dim, LevelVectorType, MGTransferMatrixFree<dim,float> >
+ * preconditioner(dof_handler, mg, mg_transfer);
+ *
+ * SolverCG<LinearAlgebra::distributed::Vector<double> > cg(solver_control);
+ * cg.solve(system_matrix, solution, system_rhs, preconditioner);
+ * @endcode
+ * Since the residual is significantly reduced by the outer solver in double
+ * precision, the accuracy of the final solution is not affected by the lower
+ * precision of the V-cycle, whereas the level operations can use twice as
+ * many lanes in VectorizedArray and half the memory transfer.
+ *
  * @author Guido Kanschat, Daniel Arndt, 1999, 2000, 2001, 2002, 2017
  */
 template <int dim, typename VectorType, class TRANSFER>
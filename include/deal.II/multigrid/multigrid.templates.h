@@ -108,6 +108,21 @@ template <typename VectorType>
 void
 Multigrid<VectorType>::level_v_step (const unsigned int level)
 {
+  // processors that do not hold data on this level because the transfer
+  // has agglomerated it onto a subset of the processors skip the smoothing
+  // and the coarse solve, but still take part in the (collective) transfer
+  // to and from the next coarser level
+  if (!transfer->is_active_on_level(level))
+    {
+      if (level > minlevel)
+        {
+          transfer->restrict_and_add(level, defect[level-1], t[level]);
+          level_v_step(level-1);
+          transfer->prolongate(level, t[level], solution[level-1]);
+        }
+      return;
+    }
+
   if (debug>0)
     deallog << "V-cycle entering level " << level << std::endl;
   if (debug>2)
@@ -201,6 +216,28 @@ void
 Multigrid<VectorType>::level_step(const unsigned int level,
                                   Cycle cycle)
 {
+  // processors that do not hold data on this level because the transfer
+  // has agglomerated it onto a subset of the processors only take part in
+  // the transfer, repeating the recursion pattern of the active processors
+  if (!transfer->is_active_on_level(level))
+    {
+      if (level > minlevel)
+        {
+          defect2[level-1] = 0;
+          transfer->restrict_and_add (level, defect2[level-1], t[level]);
+          level_step(level-1, cycle);
+          if (level>minlevel+1)
+            {
+              if (cycle == w_cycle)
+                level_step(level-1, cycle);
+              else if (cycle == f_cycle)
+                level_step(level-1, v_cycle);
+            }
+          transfer->prolongate(level, t[level], solution[level-1]);
+        }
+      return;
+    }
+
   char cychar = '?';
   switch (cycle)
     {
@@ -0,0 +1,169 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_non_matching_fe_values_h
+#define dealii_non_matching_fe_values_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping.h>
+#include <deal.II/non_matching/quadrature_generator.h>
+
+#include <memory>
+
+DEAL_II_NAMESPACE_OPEN
+namespace NonMatching
+{
+
+  /**
+   * A wrapper around dealii::FEValues for the integration over the parts of
+   * the cells inside and outside of a level set, and over the zero contour
+   * of the level set, using the quadratures stored by a
+   * DiscreteQuadratureGenerator object.
+   *
+   * Most cells of a mesh are usually not intersected by the zero contour.
+   * They use the same regular tensor product quadrature, so the shape
+   * function values of a single dealii::FEValues object are computed once in
+   * the constructor and reused for all these cells, exactly as for a
+   * standard loop over the cells. Only for the intersected cells, new
+   * dealii::FEValues objects are created with the quadratures of the cell:
+   * @code
+   *   NonMatching::FEValues<dim> fe_values (mapping, fe, update_flags,
+   *                                         quadrature_generator);
+   *   for (cell = ...)
+   *     {
+   *       fe_values.reinit (cell);
+   *       if (const dealii::FEValues<dim> *inside = fe_values.get_inside_fe_values())
+   *         for (unsigned int q=0; q<inside->n_quadrature_points; ++q)
+   *           ... inside->JxW(q) ...
+   *       if (const dealii::FEValues<dim> *surface = fe_values.get_surface_fe_values())
+   *         for (unsigned int q=0; q<surface->n_quadrature_points; ++q)
+   *           ... fe_values.surface_JxW(q) ... fe_values.surface_normal(q) ...
+   *     }
+   * @endcode
+   *
+   * For the surface, the JxW values of dealii::FEValues refer to the volume
+   * and can not be used. Instead, surface_JxW() and surface_normal() return
+   * the surface element and the unit normal in real space, computed from
+   * the normals of the ImmersedSurfaceQuadrature.
+   */
+  template <int dim>
+  class FEValues
+  {
+  public:
+    /**
+     * Constructor. The quadratures are taken from @p quadrature_generator,
+     * which must be initialized with reinit() before the cells are visited
+     * and must live as long as this object.
+     */
+    FEValues (const Mapping<dim>                     &mapping,
+              const FiniteElement<dim>               &fe,
+              const UpdateFlags                       update_flags,
+              const DiscreteQuadratureGenerator<dim> &quadrature_generator);
+
+    /**
+     * Constructor, using a MappingQ1 object as the mapping.
+     */
+    FEValues (const FiniteElement<dim>               &fe,
+              const UpdateFlags                       update_flags,
+              const DiscreteQuadratureGenerator<dim> &quadrature_generator);
+
+    /**
+     * Reinitialize the objects for the given cell.
+     */
+    void reinit (const typename DoFHandler<dim>::active_cell_iterator &cell);
+
+    /**
+     * Return the location of the current cell relative to the level set.
+     */
+    LocationToLevelSet get_location () const;
+
+    /**
+     * Return the FEValues object for the part of the current cell where the
+     * level set function is negative, or a null pointer if this part is
+     * empty.
+     */
+    const dealii::FEValues<dim> *get_inside_fe_values () const;
+
+    /**
+     * Return the FEValues object for the part of the current cell where the
+     * level set function is positive, or a null pointer if this part is
+     * empty.
+     */
+    const dealii::FEValues<dim> *get_outside_fe_values () const;
+
+    /**
+     * Return the FEValues object for the points on the zero contour of the
+     * level set function, or a null pointer if the current cell is not
+     * intersected.
+     */
+    const dealii::FEValues<dim> *get_surface_fe_values () const;
+
+    /**
+     * Return the surface element times the quadrature weight in real space
+     * at the given point of the surface quadrature, i.e., $\det(J_q)
+     * |J_q^{-T} \hat{n}_q| w_q$.
+     */
+    double surface_JxW (const unsigned int quadrature_point) const;
+
+    /**
+     * Return the unit normal in real space at the given point of the
+     * surface quadrature, pointing out of the inside region.
+     */
+    Tensor<1,dim> surface_normal (const unsigned int quadrature_point) const;
+
+  private:
+    /**
+     * Create a new FEValues object for the given quadrature, or reset the
+     * pointer if the quadrature is empty.
+     */
+    void
+    reinit_cut_cell_fe_values (const typename DoFHandler<dim>::active_cell_iterator &cell,
+                               const Quadrature<dim>                               &quadrature,
+                               const UpdateFlags                                    flags,
+                               std::unique_ptr<dealii::FEValues<dim> >             &fe_values);
+
+    const SmartPointer<const Mapping<dim> >                     mapping;
+    const SmartPointer<const FiniteElement<dim> >               fe;
+    const UpdateFlags                                           update_flags;
+    const SmartPointer<const DiscreteQuadratureGenerator<dim> > quadrature_generator;
+
+    /**
+     * The FEValues object for the cells that are not intersected, which
+     * keeps the shape data of the regular quadrature.
+     */
+    dealii::FEValues<dim> regular_fe_values;
+
+    /**
+     * The FEValues objects of the current cell if it is intersected.
+     */
+    std::unique_ptr<dealii::FEValues<dim> > inside_fe_values;
+    std::unique_ptr<dealii::FEValues<dim> > outside_fe_values;
+    std::unique_ptr<dealii::FEValues<dim> > surface_fe_values;
+
+    /**
+     * The surface quadrature of the current cell.
+     */
+    const ImmersedSurfaceQuadrature<dim> *surface_quadrature;
+
+    LocationToLevelSet current_location;
+  };
+
+}
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -68,6 +68,10 @@ namespace NonMatching
    *
    * @image html immersed_surface_quadrature.svg
    *
+   * Quadratures of this type for the zero contour of a level set function
+   * are created by the QuadratureGenerator and DiscreteQuadratureGenerator
+   * classes.
+   *
    * @author Simon Sticko, 2017
    */
   template <int dim>
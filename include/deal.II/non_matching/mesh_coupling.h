@@ -0,0 +1,283 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_non_matching_mesh_coupling_h
+#define dealii_non_matching_mesh_coupling_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/grid/cell_id.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_tools_cache.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <boost/signals2.hpp>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+namespace NonMatching
+{
+
+  /**
+   * A class that computes the coupling between two independent meshes that
+   * overlap in space, as needed for assembling Nitsche or mortar terms
+   * between non-matching meshes. Unlike InterGridMap and
+   * GridTools::get_finest_common_cells(), the two meshes need not be derived
+   * from the same coarse mesh, and both may be distributed among several MPI
+   * processes, e.g., as parallel::distributed::Triangulation objects.
+   *
+   * The first mesh, of type Triangulation<dim,spacedim>, is the one the
+   * coupling terms are integrated on. It can either be a mesh of the same
+   * dimension as the second one (for overlapping domains) or a mesh of
+   * lower dimension embedded in the space of the second mesh (for an
+   * interface or an immersed boundary). The second mesh, of type
+   * Triangulation<spacedim>, is the one the first mesh is located in.
+   *
+   * The coupling is described by a list of CellPair objects. Each pair
+   * consists of a locally owned cell of the first mesh and a cell of the
+   * second mesh that overlaps with it, together with a quadrature rule for
+   * the intersection of the two cells: the quadrature points in the
+   * reference coordinates of both cells, and the weights multiplied by the
+   * Jacobian determinant of the first cell. The intersection quadrature is
+   * obtained by mapping the quadrature formula passed to the constructor to
+   * every locally owned cell of the first mesh and locating each of the
+   * points in the second mesh. The points of a cell of the first mesh are
+   * grouped by the cell of the second mesh they lie in. Points that lie in
+   * no cell of the second mesh are dropped, and points on the boundary
+   * between cells of the second mesh are assigned to exactly one of them.
+   *
+   * The rules obtained this way are exact where the cells of the first mesh
+   * lie entirely within a cell of the second mesh. For cells cut by the
+   * boundaries of cells of the second mesh, the rules only approximate the
+   * integral over the intersection since the quadrature points are not
+   * adapted to the intersection, with an accuracy that is improved by using
+   * a composite formula like QIterated for the first mesh, typically with
+   * a number of subdivisions given by the ratio of the mesh sizes of the
+   * two meshes.
+   *
+   * In parallel, the points are located with
+   * GridTools::distributed_compute_point_locations(): the bounding boxes of
+   * the locally owned parts of the second mesh are exchanged among all
+   * processes, each point is sent to the processes whose boxes contain it,
+   * and those processes search their locally owned cells with the R-tree of
+   * cell bounding boxes of a GridTools::Cache. The result is then sent back
+   * to the process owning the cell of the first mesh, such that the cell
+   * pairs are always stored on the owner of the cell of the first mesh. The
+   * cell of the second mesh is identified by its CellId and the rank of its
+   * owner. It is also available as iterator if it is a locally owned or a
+   * ghost cell on the current process.
+   *
+   * The setup is expensive compared to the assembly of the coupling terms,
+   * so it is kept as long as neither of the two meshes changes. The class
+   * connects to the signals of both triangulations and recomputes the
+   * coupling in the next call to update() once one of the meshes has been
+   * refined, coarsened, recreated, or moved by a deal.II function, see
+   * Triangulation::Signals::mesh_movement. The data structures of the
+   * GridTools::Cache of the second mesh are updated incrementally in that
+   * case.
+   *
+   * If the second mesh is distributed, the first mesh must be distributed
+   * among the same processes with the same communicator. If only the first
+   * mesh is distributed, each process locates its points in its own copy of
+   * the second mesh.
+   */
+  template <int dim, int spacedim = dim>
+  class MeshCoupling : public Subscriptor
+  {
+  public:
+    /**
+     * A pair of overlapping cells together with the quadrature rule for
+     * their intersection.
+     */
+    struct CellPair
+    {
+      /**
+       * The locally owned cell of the first mesh.
+       */
+      typename Triangulation<dim,spacedim>::active_cell_iterator first_cell;
+
+      /**
+       * The cell of the second mesh. The iterator is only valid if the cell
+       * is a locally owned or a ghost cell on the current process, see
+       * second_cell_owner.
+       */
+      typename Triangulation<spacedim>::active_cell_iterator second_cell;
+
+      /**
+       * The identifier of the cell of the second mesh, which is valid on all
+       * processes.
+       */
+      CellId second_cell_id;
+
+      /**
+       * The rank of the process owning the cell of the second mesh in the
+       * communicator of the second triangulation, or zero if the second
+       * triangulation is not distributed.
+       */
+      unsigned int second_cell_owner;
+
+      /**
+       * The quadrature points of the intersection in the reference
+       * coordinates of the first cell.
+       */
+      std::vector<Point<dim> > first_unit_points;
+
+      /**
+       * The quadrature points of the intersection in the reference
+       * coordinates of the second cell.
+       */
+      std::vector<Point<spacedim> > second_unit_points;
+
+      /**
+       * The quadrature weights multiplied by the Jacobian determinant of the
+       * first cell at the quadrature points, i.e., the values FEValues::JxW()
+       * would return for these points on the first cell.
+       */
+      std::vector<double> JxW;
+    };
+
+    /**
+     * Constructor. The triangulations, the mappings, and the quadrature
+     * formula are stored and the coupling is computed in the first call to
+     * update(). The triangulations and the mappings need to live longer than
+     * this object.
+     */
+    MeshCoupling (const Triangulation<dim,spacedim> &first_triangulation,
+                  const Triangulation<spacedim>     &second_triangulation,
+                  const Quadrature<dim>             &quadrature,
+                  const Mapping<dim,spacedim>       &first_mapping = StaticMappingQ1<dim,spacedim>::mapping,
+                  const Mapping<spacedim>           &second_mapping = StaticMappingQ1<spacedim>::mapping);
+
+    /**
+     * Destructor. Disconnects from the signals of the triangulations.
+     */
+    ~MeshCoupling ();
+
+    /**
+     * Compute the cell pairs if one of the meshes has changed since the last
+     * call, or if this function has not been called before. Otherwise,
+     * return immediately. Since it is not known on all processes whether a
+     * mesh has changed elsewhere, this function must be called on all
+     * processes at the same time, which is the case for the collective
+     * operations that change a distributed triangulation.
+     */
+    void update ();
+
+    /**
+     * Return whether the cell pairs are up to date with the current state
+     * of both meshes.
+     */
+    bool is_up_to_date () const;
+
+    /**
+     * Return the cell pairs computed by the last call to update(). The
+     * pairs are sorted by the active cell index of the first cell and then
+     * by the owner and the identifier of the second cell.
+     */
+    const std::vector<CellPair> &get_cell_pairs () const;
+
+    /**
+     * Return the total number of quadrature points of all cell pairs.
+     */
+    unsigned int n_quadrature_points () const;
+
+    /**
+     * Return the cache of the second mesh the points are located with,
+     * which can also be used for locating other points in this mesh.
+     */
+    const GridTools::Cache<spacedim> &get_second_cache () const;
+
+  private:
+    /**
+     * The triangulation the coupling terms are integrated on.
+     */
+    SmartPointer<const Triangulation<dim,spacedim>,MeshCoupling<dim,spacedim> > first_triangulation;
+
+    /**
+     * The mapping of the first triangulation.
+     */
+    SmartPointer<const Mapping<dim,spacedim>,MeshCoupling<dim,spacedim> > first_mapping;
+
+    /**
+     * The quadrature formula on the cells of the first triangulation.
+     */
+    const Quadrature<dim> quadrature;
+
+    /**
+     * The cache of the second triangulation, which holds the R-tree of its
+     * cell bounding boxes.
+     */
+    GridTools::Cache<spacedim> second_cache;
+
+    /**
+     * Whether the cell pairs are up to date.
+     */
+    bool up_to_date;
+
+    /**
+     * The cell pairs computed by update().
+     */
+    std::vector<CellPair> cell_pairs;
+
+    /**
+     * The connections to the signals of both triangulations.
+     */
+    std::vector<boost::signals2::connection> tria_signals;
+  };
+
+
+
+  /* ---------------------- inline functions ---------------------- */
+
+
+
+  template <int dim, int spacedim>
+  inline
+  bool
+  MeshCoupling<dim,spacedim>::is_up_to_date () const
+  {
+    return up_to_date;
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline
+  const std::vector<typename MeshCoupling<dim,spacedim>::CellPair> &
+  MeshCoupling<dim,spacedim>::get_cell_pairs () const
+  {
+    Assert (up_to_date,
+            ExcMessage("The cell pairs are outdated, call update() first."));
+    return cell_pairs;
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline
+  const GridTools::Cache<spacedim> &
+  MeshCoupling<dim,spacedim>::get_second_cache () const
+  {
+    return second_cache;
+  }
+
+}
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,575 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_non_matching_quadrature_generator_h
+#define dealii_non_matching_quadrature_generator_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/bounding_box.h>
+#include <deal.II/base/function.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/non_matching/immersed_surface_quadrature.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+namespace NonMatching
+{
+
+  /**
+   * The position of a cell or a box relative to the zero contour of a level
+   * set function $\psi$. The region $\{x : \psi(x) < 0\}$ is called inside
+   * and $\{x : \psi(x) > 0\}$ is called outside.
+   */
+  enum class LocationToLevelSet
+  {
+    /**
+     * The level set function is negative in the whole cell.
+     */
+    inside,
+    /**
+     * The level set function is positive in the whole cell.
+     */
+    outside,
+    /**
+     * The zero contour of the level set function intersects the cell.
+     */
+    intersected,
+    /**
+     * No information is available for the cell, for example because it is
+     * not locally owned.
+     */
+    unassigned
+  };
+
+
+
+  /**
+   * Parameters that control the quadrature generation of the
+   * QuadratureGenerator and DiscreteQuadratureGenerator classes.
+   */
+  struct AdditionalQGeneratorData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalQGeneratorData (const unsigned int max_box_splits = 4,
+                              const double       lower_bound_implicit_function = 1e-11,
+                              const double       min_relative_derivative = 0.2,
+                              const double       min_distance_between_roots = 1e-12,
+                              const double       limit_to_be_definite = 1e-11,
+                              const double       root_finder_tolerance = 1e-12,
+                              const unsigned int max_root_finder_iterations = 50);
+
+    /**
+     * The number of times a box is allowed to be split in half in each
+     * coordinate direction when no direction is found in which the level set
+     * function is monotone. When this number is reached, the direction with
+     * the largest derivative is used anyway, which reduces the accuracy of
+     * the quadrature close to points where the surface is tangential to that
+     * direction.
+     */
+    unsigned int max_box_splits;
+
+    /**
+     * The smallest value a bound of the partial derivative of the level set
+     * function may take for the derivative to be considered bounded away from
+     * zero.
+     */
+    double lower_bound_implicit_function;
+
+    /**
+     * A box is also split, as long as @p max_box_splits is not reached, if
+     * the derivative in the height direction is smaller than this fraction
+     * of the largest component of the gradient. Such a zero contour is steep
+     * as a function over the face, which reduces the accuracy of the
+     * quadrature on the face.
+     */
+    double min_relative_derivative;
+
+    /**
+     * Two roots that are closer than this distance are merged into one, and
+     * intervals shorter than this distance get no quadrature points.
+     */
+    double min_distance_between_roots;
+
+    /**
+     * The level set function is considered to have a definite sign on a box
+     * if its estimated bounds are further away from zero than this value.
+     */
+    double limit_to_be_definite;
+
+    /**
+     * The tolerance of the root finder along the lines in the height
+     * direction.
+     */
+    double root_finder_tolerance;
+
+    /**
+     * The maximal number of iterations of the root finder.
+     */
+    unsigned int max_root_finder_iterations;
+  };
+
+
+
+  namespace internal
+  {
+    namespace QuadratureGeneratorImplementation
+    {
+      /**
+       * A list of points and weights that is filled point by point during
+       * the quadrature generation.
+       */
+      template <int dim>
+      struct PointsAndWeights
+      {
+        void push_back (const Point<dim> &point,
+                        const double      weight);
+
+        void clear ();
+
+        std::vector<Point<dim> > points;
+        std::vector<double>      weights;
+      };
+
+
+
+      /**
+       * The quadrature points generated on a box, sorted by the sign of a
+       * set of level set functions: @p negative holds the points where all
+       * functions are negative, @p positive the points where all functions
+       * are positive, and @p indefinite the points where the functions have
+       * different signs. The surface points are only generated for the zero
+       * contour of a single level set function.
+       */
+      template <int dim>
+      struct QPartitioning
+      {
+        void clear ();
+
+        PointsAndWeights<dim> negative;
+        PointsAndWeights<dim> positive;
+        PointsAndWeights<dim> indefinite;
+
+        PointsAndWeights<dim>        surface;
+        std::vector<Tensor<1,dim> > surface_normals;
+      };
+
+
+
+      /**
+       * The parts of the quadrature generation that do not depend on how the
+       * algorithm continues to lower dimensions.
+       */
+      template <int dim>
+      class QGeneratorBase
+      {
+      public:
+        QGeneratorBase (const Quadrature<1>             &quadrature_1D,
+                        const AdditionalQGeneratorData &additional_data);
+
+        /**
+         * Remove all points generated so far.
+         */
+        void clear ();
+
+        /**
+         * The generated points.
+         */
+        QPartitioning<dim> q_partitioning;
+
+      protected:
+        /**
+         * Estimate the bounds of all level set functions and their gradients
+         * on the box and collect the functions whose sign changes in @p
+         * indefinite_level_sets. If all functions have a definite sign,
+         * add a tensor product quadrature on the box to the matching region
+         * and return true.
+         */
+        bool
+        sort_by_sign (const std::vector<const Function<dim> *>      &level_sets,
+                      const BoundingBox<dim>                        &box,
+                      std::vector<const Function<dim> *>            &indefinite_level_sets,
+                      std::vector<std::array<std::pair<double,double>,dim> > &gradient_bounds);
+
+        /**
+         * Find the roots of the indefinite level set functions on the line
+         * through @p point in direction @p direction between @p lower and @p
+         * upper, and add quadrature points on the intervals between the roots
+         * with the given @p weight. If @p create_surface is true, also add
+         * surface points at the roots of the first level set function.
+         */
+        void
+        add_line_quadrature (const std::vector<const Function<dim> *> &level_sets,
+                             const std::vector<const Function<dim> *> &indefinite_level_sets,
+                             Point<dim>                                point,
+                             const unsigned int                        direction,
+                             const double                              lower,
+                             const double                              upper,
+                             const double                              weight,
+                             const bool                                monotone,
+                             const bool                                create_surface);
+
+        const Quadrature<1>            quadrature_1D;
+        const Quadrature<dim>          tensor_quadrature;
+        const AdditionalQGeneratorData additional_data;
+
+        /**
+         * Scratch data for the roots along a line.
+         */
+        std::vector<double> roots;
+      };
+
+
+
+      /**
+       * The recursive part of the algorithm by Saye: If all level set
+       * functions are monotone in one coordinate direction on the box, a
+       * quadrature is generated on the face perpendicular to that direction
+       * for the restrictions of the functions to the two opposite faces, and
+       * is extended upwards by one-dimensional quadratures on the intervals
+       * between the roots along each line in the height direction. Otherwise,
+       * the box is split into $2^\text{dim}$ children.
+       */
+      template <int dim>
+      class QGenerator : public QGeneratorBase<dim>
+      {
+      public:
+        QGenerator (const Quadrature<1>             &quadrature_1D,
+                    const AdditionalQGeneratorData &additional_data);
+
+        void generate (const std::vector<const Function<dim> *> &level_sets,
+                       const BoundingBox<dim>                   &box,
+                       const unsigned int                        n_box_splits,
+                       const bool                                create_surface);
+
+      private:
+        void
+        create_up_through_dimension (const std::vector<const Function<dim> *> &level_sets,
+                                     const std::vector<const Function<dim> *> &indefinite_level_sets,
+                                     const BoundingBox<dim>                   &box,
+                                     const unsigned int                        height_direction,
+                                     const bool                                monotone,
+                                     const bool                                create_surface);
+
+        /**
+         * The generator for the faces of the box, which is reused for all
+         * boxes of this dimension.
+         */
+        QGenerator<dim-1> low_dim_generator;
+      };
+
+
+
+      /**
+       * Specialization for the one-dimensional case that ends the
+       * recursion.
+       */
+      template <>
+      class QGenerator<1> : public QGeneratorBase<1>
+      {
+      public:
+        QGenerator (const Quadrature<1>             &quadrature_1D,
+                    const AdditionalQGeneratorData &additional_data);
+
+        void generate (const std::vector<const Function<1> *> &level_sets,
+                       const BoundingBox<1>                   &box,
+                       const unsigned int                      n_box_splits,
+                       const bool                              create_surface);
+      };
+    }
+  }
+
+
+
+  /**
+   * Create high-order quadrature formulas for the regions $\{x : \psi(x) <
+   * 0\}$ (inside) and $\{x : \psi(x) > 0\}$ (outside) of a box and for the
+   * surface $\{x : \psi(x) = 0\}$, where $\psi$ is a level set function. The
+   * quadratures are constructed with the algorithm of
+   *
+   * R. I. Saye, High-order quadrature methods for implicitly defined surfaces
+   * and volumes in hyperrectangles, SIAM J. Sci. Comput. 37(2), 2015.
+   *
+   * If $\psi$ is monotone in some coordinate direction $x_k$ on the box, its
+   * zero contour is the graph of a height function over the face
+   * perpendicular to $x_k$. Then, a quadrature is created on that face for
+   * the restrictions of $\psi$ to the two faces perpendicular to $x_k$,
+   * recursively by the same algorithm in one dimension less. For each of
+   * these points, the root of $\psi$ along the line in direction $x_k$ is
+   * computed, and a one-dimensional quadrature is placed on the intervals
+   * below and above the root. The surface points are located at the roots,
+   * with weights scaled by $|\nabla\psi|/|\partial_k\psi|$. If no such
+   * direction exists, the box is split and the algorithm is applied to the
+   * children.
+   *
+   * Since the points are placed on intervals where $\psi$ has a definite
+   * sign, the quadratures converge with the order of the one-dimensional
+   * quadrature that is passed to the constructor, as long as $\psi$ is
+   * smooth.
+   *
+   * The bounds of $\psi$ and its gradient on a box are estimated from a
+   * second order Taylor expansion around the center of the box, which
+   * requires the @p value, @p gradient and @p hessian functions of the level
+   * set function to be implemented.
+   *
+   * A typical use is
+   * @code
+   *   QuadratureGenerator<dim> generator (QGauss<1>(3));
+   *   generator.generate (level_set, box);
+   *   const Quadrature<dim> &inside_quadrature = generator.get_inside_quadrature ();
+   * @endcode
+   * For level set functions described by a finite element field, the
+   * DiscreteQuadratureGenerator class runs this algorithm for all cells of a
+   * mesh.
+   */
+  template <int dim>
+  class QuadratureGenerator
+  {
+  public:
+    /**
+     * Constructor. The quadrature @p quadrature_1D is used on all intervals
+     * and must be defined on the unit interval, e.g. QGauss<1>.
+     */
+    QuadratureGenerator (const Quadrature<1>             &quadrature_1D,
+                         const AdditionalQGeneratorData &additional_data = AdditionalQGeneratorData());
+
+    /**
+     * Construct the quadratures for the given level set function on the
+     * given box. The points and weights refer to the coordinates in which
+     * both the level set function and the box are given, e.g. the unit cell.
+     */
+    void generate (const Function<dim>    &level_set,
+                   const BoundingBox<dim> &box);
+
+    /**
+     * Return the quadrature for the region where the level set function is
+     * negative.
+     */
+    const Quadrature<dim> &get_inside_quadrature () const;
+
+    /**
+     * Return the quadrature for the region where the level set function is
+     * positive.
+     */
+    const Quadrature<dim> &get_outside_quadrature () const;
+
+    /**
+     * Return the quadrature for the zero contour of the level set function.
+     * The normals point in the direction of the gradient of the level set
+     * function, i.e., out of the inside region.
+     */
+    const ImmersedSurfaceQuadrature<dim> &get_surface_quadrature () const;
+
+    /**
+     * Return the location of the box of the last call to generate() relative
+     * to the level set.
+     */
+    LocationToLevelSet get_location () const;
+
+  private:
+    internal::QuadratureGeneratorImplementation::QGenerator<dim> q_generator;
+
+    Quadrature<dim>                inside_quadrature;
+    Quadrature<dim>                outside_quadrature;
+    ImmersedSurfaceQuadrature<dim> surface_quadrature;
+    LocationToLevelSet             location;
+  };
+
+
+
+  /**
+   * Create and store the quadratures of QuadratureGenerator for all locally
+   * owned active cells of a mesh, for a level set function given by a
+   * scalar finite element field such as FE_Q. The level set function is
+   * evaluated in the reference coordinates of each cell, so the quadratures
+   * refer to the unit cell and can be directly passed to FEValues, which is
+   * done by NonMatching::FEValues.
+   *
+   * For cells that are not intersected by the zero contour, only the
+   * location is stored, and the regular tensor product quadrature based on
+   * the one-dimensional quadrature is returned for the region that covers
+   * the cell. The quadratures of the intersected cells are computed in
+   * parallel on several threads.
+   */
+  template <int dim>
+  class DiscreteQuadratureGenerator : public Subscriptor
+  {
+  public:
+    /**
+     * Constructor.
+     */
+    DiscreteQuadratureGenerator (const Quadrature<1>             &quadrature_1D,
+                                 const AdditionalQGeneratorData &additional_data = AdditionalQGeneratorData());
+
+    /**
+     * Compute the quadratures for all locally owned active cells of @p
+     * dof_handler for the level set function given by the finite element
+     * field @p level_set. The finite element must be scalar. For parallel
+     * vectors, @p level_set needs to contain the ghost values of the
+     * locally owned cells.
+     */
+    template <typename VectorType>
+    void reinit (const DoFHandler<dim> &dof_handler,
+                 const VectorType      &level_set);
+
+    /**
+     * Return the location of the given cell relative to the level set.
+     */
+    template <typename CellIteratorType>
+    LocationToLevelSet location (const CellIteratorType &cell) const;
+
+    /**
+     * Return the quadrature for the part of the cell where the level set
+     * function is negative. This is the regular quadrature for cells inside
+     * and an empty quadrature for cells outside.
+     */
+    template <typename CellIteratorType>
+    const Quadrature<dim> &get_inside_quadrature (const CellIteratorType &cell) const;
+
+    /**
+     * Return the quadrature for the part of the cell where the level set
+     * function is positive. This is the regular quadrature for cells
+     * outside and an empty quadrature for cells inside.
+     */
+    template <typename CellIteratorType>
+    const Quadrature<dim> &get_outside_quadrature (const CellIteratorType &cell) const;
+
+    /**
+     * Return the quadrature for the zero contour of the level set function
+     * in the given cell, which is empty for cells that are not intersected.
+     */
+    template <typename CellIteratorType>
+    const ImmersedSurfaceQuadrature<dim> &get_surface_quadrature (const CellIteratorType &cell) const;
+
+    /**
+     * Return the tensor product quadrature used for the cells that are not
+     * intersected.
+     */
+    const Quadrature<dim> &get_regular_quadrature () const;
+
+    /**
+     * Return the number of intersected cells.
+     */
+    unsigned int n_intersected_cells () const;
+
+  private:
+    /**
+     * The quadratures of an intersected cell.
+     */
+    struct CutCellQuadratures
+    {
+      Quadrature<dim>                inside;
+      Quadrature<dim>                outside;
+      ImmersedSurfaceQuadrature<dim> surface;
+    };
+
+    const Quadrature<1>            quadrature_1D;
+    const AdditionalQGeneratorData additional_data;
+    const Quadrature<dim>          regular_quadrature;
+    const Quadrature<dim>          empty_quadrature;
+    const ImmersedSurfaceQuadrature<dim> empty_surface_quadrature;
+
+    /**
+     * The location of each active cell, indexed by the active cell index.
+     */
+    std::vector<LocationToLevelSet> cell_locations;
+
+    /**
+     * The quadratures of the intersected cells, indexed by the active cell
+     * index. The entries of the other cells are empty.
+     */
+    std::vector<std::unique_ptr<CutCellQuadratures> > cut_cell_quadratures;
+  };
+
+
+
+  /* ------------------------- inline functions --------------------------- */
+
+#ifndef DOXYGEN
+
+  template <int dim>
+  template <typename CellIteratorType>
+  inline
+  LocationToLevelSet
+  DiscreteQuadratureGenerator<dim>::location (const CellIteratorType &cell) const
+  {
+    AssertIndexRange (cell->active_cell_index(), cell_locations.size());
+    return cell_locations[cell->active_cell_index()];
+  }
+
+
+
+  template <int dim>
+  template <typename CellIteratorType>
+  inline
+  const Quadrature<dim> &
+  DiscreteQuadratureGenerator<dim>::get_inside_quadrature (const CellIteratorType &cell) const
+  {
+    switch (location(cell))
+      {
+      case LocationToLevelSet::inside:
+        return regular_quadrature;
+      case LocationToLevelSet::intersected:
+        return cut_cell_quadratures[cell->active_cell_index()]->inside;
+      default:
+        return empty_quadrature;
+      }
+  }
+
+
+
+  template <int dim>
+  template <typename CellIteratorType>
+  inline
+  const Quadrature<dim> &
+  DiscreteQuadratureGenerator<dim>::get_outside_quadrature (const CellIteratorType &cell) const
+  {
+    switch (location(cell))
+      {
+      case LocationToLevelSet::outside:
+        return regular_quadrature;
+      case LocationToLevelSet::intersected:
+        return cut_cell_quadratures[cell->active_cell_index()]->outside;
+      default:
+        return empty_quadrature;
+      }
+  }
+
+
+
+  template <int dim>
+  template <typename CellIteratorType>
+  inline
+  const ImmersedSurfaceQuadrature<dim> &
+  DiscreteQuadratureGenerator<dim>::get_surface_quadrature (const CellIteratorType &cell) const
+  {
+    if (location(cell) == LocationToLevelSet::intersected)
+      return cut_cell_quadratures[cell->active_cell_index()]->surface;
+    else
+      return empty_surface_quadrature;
+  }
+
+#endif
+
+}
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
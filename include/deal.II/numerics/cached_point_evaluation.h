@@ -0,0 +1,220 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_cached_point_evaluation_h
+#define dealii_cached_point_evaluation_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/mapping.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/vector_element_access.h>
+
+#include <map>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/**
+ * A class that evaluates finite element fields at a fixed set of points,
+ * for example the monitoring probes of a time dependent simulation, many
+ * times on the same mesh.
+ *
+ * Classes like PointValueHistory or Functions::FEFieldFunction search the
+ * cell around each point, compute its reference coordinates, and evaluate
+ * the shape functions there every time a field is evaluated. This class does
+ * all of this work once in the constructor and stores, for each point, the
+ * degrees of freedom of the surrounding cell and the values of all shape
+ * functions at the point. An evaluation with evaluate() then merely reads
+ * the degrees of freedom and forms a small dot product per point and vector
+ * component.
+ *
+ * The points are located with GridTools::distributed_compute_point_locations(),
+ * so each process may ask for an arbitrary set of points, not only points in
+ * its locally owned part of the mesh. The process owning the cell around a
+ * point evaluates the field and sends the result back to the process that
+ * requested the point. Points on the interface between the locally owned
+ * parts of several processes are evaluated by the process of lowest rank
+ * among them. In serial, all points are simply evaluated locally.
+ *
+ * The stored data become invalid as soon as the mesh or the degrees of
+ * freedom change, in which case a new object needs to be created.
+ */
+template <int dim, int spacedim=dim>
+class CachedPointEvaluation
+{
+public:
+  /**
+   * Constructor. Locate the @p points in the mesh of @p dof_handler with
+   * the given @p mapping and compute the values of the shape functions at
+   * them. This is a collective operation for meshes distributed among
+   * several processes, and an exception is thrown if one of the points lies
+   * outside of the mesh.
+   */
+  CachedPointEvaluation (const Mapping<dim,spacedim>        &mapping,
+                         const DoFHandler<dim,spacedim>     &dof_handler,
+                         const std::vector<Point<spacedim> > &points);
+
+  /**
+   * Evaluate the finite element field given by @p vector at the points
+   * passed to the constructor, with one entry in @p values per point, of
+   * the size of the number of vector components of the finite element.
+   *
+   * For distributed vectors, the vector must contain the ghost entries of
+   * the locally relevant degrees of freedom, as the degrees of freedom of
+   * all locally owned cells are read. This is a collective operation for
+   * meshes distributed among several processes.
+   */
+  template <typename VectorType>
+  void evaluate (const VectorType              &vector,
+                 std::vector<Vector<double> > &values) const;
+
+  /**
+   * Return the number of points passed to the constructor.
+   */
+  unsigned int n_points () const;
+
+  /**
+   * Return an estimate of the memory consumption of this object in bytes.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * Distribute the values computed on this process for the points of the
+   * locally owned cells, @p evaluated_values, to the processes that asked
+   * for them and write them into @p values.
+   */
+  void communicate_values (const std::vector<double>    &evaluated_values,
+                           std::vector<Vector<double> > &values) const;
+
+  /**
+   * A pointer to the DoFHandler, used to check that it is not destroyed
+   * while this object exists.
+   */
+  SmartPointer<const DoFHandler<dim,spacedim>,CachedPointEvaluation<dim,spacedim> > dof_handler;
+
+  /**
+   * The communicator of the triangulation, or MPI_COMM_SELF for serial
+   * triangulations.
+   */
+  MPI_Comm mpi_communicator;
+
+  /**
+   * The number of points requested on this process.
+   */
+  unsigned int n_requested_points;
+
+  /**
+   * The number of degrees of freedom per cell and of vector components of
+   * the finite element.
+   */
+  unsigned int dofs_per_cell;
+  unsigned int n_components;
+
+  /**
+   * The degrees of freedom of the locally owned cells that contain at least
+   * one point, with @p dofs_per_cell entries per cell.
+   */
+  std::vector<types::global_dof_index> dof_indices;
+
+  /**
+   * For each of these cells, the range of points inside the cell as an
+   * index into the points evaluated on this process, i.e., the points of
+   * cell $c$ are the ones from <tt>cell_point_ranges[c]</tt> to
+   * <tt>cell_point_ranges[c+1]</tt>.
+   */
+  std::vector<unsigned int> cell_point_ranges;
+
+  /**
+   * The values of the shape functions at the points evaluated on this
+   * process, with <tt>dofs_per_cell * n_components</tt> entries per point
+   * where the component runs fastest.
+   */
+  std::vector<double> shape_values;
+
+  /**
+   * For each process that asked for points evaluated by this process
+   * (including the present one), the positions of the points in the list
+   * of evaluated points, in the order in which their values are sent.
+   */
+  std::map<unsigned int, std::vector<unsigned int> > send_indices;
+
+  /**
+   * For each process evaluating points requested by this process (including
+   * the present one), the positions of the points in the list of requested
+   * points, in the order in which their values are received. Points also
+   * evaluated by a process of lower rank are marked by
+   * numbers::invalid_unsigned_int and ignored.
+   */
+  std::map<unsigned int, std::vector<unsigned int> > receive_indices;
+};
+
+
+/*----------------------- template functions --------------------------------*/
+
+#ifndef DOXYGEN
+
+template <int dim, int spacedim>
+template <typename VectorType>
+void
+CachedPointEvaluation<dim,spacedim>::evaluate (const VectorType              &vector,
+                                               std::vector<Vector<double> > &values) const
+{
+  AssertDimension (vector.size(), dof_handler->n_dofs());
+
+  std::vector<double> evaluated_values(n_components*(cell_point_ranges.size() > 0 ?
+                                                     cell_point_ranges.back() : 0));
+  std::vector<double> local_values(dofs_per_cell);
+  for (unsigned int c=0; c+1<cell_point_ranges.size(); ++c)
+    {
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        local_values[i] =
+          internal::ElementAccess<VectorType>::get(vector, dof_indices[c*dofs_per_cell+i]);
+
+      for (unsigned int q=cell_point_ranges[c]; q<cell_point_ranges[c+1]; ++q)
+        {
+          const double *shape = &shape_values[q*dofs_per_cell*n_components];
+          double *result = &evaluated_values[q*n_components];
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            for (unsigned int d=0; d<n_components; ++d)
+              result[d] += local_values[i] * shape[i*n_components+d];
+        }
+    }
+
+  communicate_values(evaluated_values, values);
+}
+
+
+
+template <int dim, int spacedim>
+inline
+unsigned int
+CachedPointEvaluation<dim,spacedim>::n_points () const
+{
+  return n_requested_points;
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -27,6 +27,11 @@ DEAL_II_NAMESPACE_OPEN
 
 namespace internal
 {
+  namespace MatrixFreeFunctions
+  {
+    template <typename Number> struct ShapeInfo;
+  }
+
   namespace DataOut
   {
     /**
@@ -48,6 +53,25 @@ namespace internal
       std::vector<Point<spacedim> > patch_evaluation_points;
 
       const std::vector<std::vector<unsigned int> > *cell_to_patch_index_map;
+
+      /**
+       * For each data vector, the one-dimensional shape information that
+       * allows to evaluate the vector on the patch points by sum
+       * factorization. This is only set up for data vectors without a
+       * postprocessor that are based on a tensor product element (FE_Q or
+       * FE_DGQ, possibly within an FESystem of a single base element), and
+       * is a null pointer for all other data vectors that are evaluated with
+       * FEValues.
+       */
+      std::vector<std::shared_ptr<const MatrixFreeFunctions::ShapeInfo<double> > > tensor_product_shape_info;
+
+      /**
+       * Scratch arrays for the sum factorization evaluation.
+       */
+      std::vector<types::global_dof_index> dof_indices;
+      std::vector<double> dof_values;
+      std::vector<double> lexicographic_dof_values;
+      std::vector<double> tensor_product_values[2];
     };
   }
 }
@@ -0,0 +1,285 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_data_out_async_writer_h
+#define dealii_data_out_async_writer_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/data_out_base.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/numerics/data_out_dof_data.h>
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace DataOutAsyncWriter
+  {
+    /**
+     * A class that owns a set of patches together with the names of the
+     * data sets, the vector data ranges, and the output flags of the object
+     * they were taken from. It can be written with all the functions of
+     * DataOutInterface independently of the original object.
+     */
+    template <int dim, int spacedim>
+    class StoredPatches : public DataOutInterface<dim,spacedim>
+    {
+    public:
+      /**
+       * Constructor. The output flags are copied from @p flags_source, and
+       * the patches are moved into the new object.
+       */
+      StoredPatches (const DataOutInterface<dim,spacedim>                             &flags_source,
+                     std::vector<DataOutBase::Patch<dim,spacedim> >                  &&patches,
+                     const std::vector<std::string>                                   &dataset_names,
+                     const std::vector<std::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges)
+        :
+        DataOutInterface<dim,spacedim> (flags_source),
+        patches (std::move(patches)),
+        dataset_names (dataset_names),
+        vector_data_ranges (vector_data_ranges)
+      {}
+
+    protected:
+      virtual
+      const std::vector<DataOutBase::Patch<dim,spacedim> > &
+      get_patches () const
+      {
+        return patches;
+      }
+
+      virtual
+      std::vector<std::string>
+      get_dataset_names () const
+      {
+        return dataset_names;
+      }
+
+      virtual
+      std::vector<std::tuple<unsigned int, unsigned int, std::string> >
+      get_vector_data_ranges () const
+      {
+        return vector_data_ranges;
+      }
+
+    private:
+      const std::vector<DataOutBase::Patch<dim,spacedim> > patches;
+      const std::vector<std::string> dataset_names;
+      const std::vector<std::tuple<unsigned int, unsigned int, std::string> > vector_data_ranges;
+    };
+  }
+}
+
+
+
+/**
+ * A class that writes graphical output in the background while the program
+ * continues with its computations.
+ *
+ * Building the patches with DataOut::build_patches() is usually cheap
+ * compared to writing them to a file, in particular in compressed formats or
+ * through a parallel file system. The write() function of this class moves
+ * the patches out of a DataOut object (or any other class derived from
+ * DataOut_DoFData), together with the names of the data sets and the output
+ * flags, and hands them to a user-provided function running on a separate
+ * thread. The DataOut object can then be reused for the next output right
+ * away:
+ * @code
+ * DataOutAsyncWriter<dim> writer (2);
+ * for (unsigned int step=0; step<n_steps; ++step)
+ *   {
+ *     ... // solve the time step
+ *
+ *     DataOut<dim> data_out;
+ *     data_out.attach_dof_handler (dof_handler);
+ *     data_out.add_data_vector (solution, "solution");
+ *     data_out.build_patches ();
+ *
+ *     const std::string filename = "solution-" +
+ *                                  Utilities::int_to_string(step, 4) + ".vtu";
+ *     writer.write (data_out,
+ *                   [filename](const DataOutInterface<dim> &output)
+ *                   {
+ *                     std::ofstream file (filename.c_str());
+ *                     output.write_vtu (file);
+ *                   });
+ *   }
+ * writer.wait ();
+ * @endcode
+ * Since the function works on a DataOutInterface object, all output formats
+ * are available. This includes write_vtu_in_parallel() and the HDF5 output
+ * through DataOutInterface::write_filtered_data() and
+ * DataOutBase::write_hdf5_parallel().
+ *
+ * The outputs are written one after the other in the order in which they
+ * were submitted. At most <code>max_n_pending_outputs</code> of them are kept
+ * in memory. If write() is called while that many outputs are still waiting
+ * or being written, it first waits for the oldest one to finish. This
+ * bounds the memory used by the stored patches.
+ *
+ * @note The data vectors attached to the DataOut object are only accessed
+ * in build_patches(). They can therefore be changed as soon as write()
+ * returns. The writer function, on the other hand, must not refer to
+ * objects that may go away before it runs. It is best to capture all its
+ * arguments, such as the file name, by value.
+ *
+ * @note Collective output functions like write_vtu_in_parallel() call MPI
+ * from the background thread. This requires an MPI library initialized with
+ * <code>MPI_THREAD_MULTIPLE</code>. The communicator used for the output
+ * must also not be used by the main thread at the same time, so a
+ * duplicate of the communicator of the computation should be passed to the
+ * writer function. Since the outputs are written in order, all processes
+ * issue the collective calls in the same sequence.
+ *
+ * @ingroup output
+ */
+template <int dim, int spacedim=dim>
+class DataOutAsyncWriter
+{
+public:
+  /**
+   * Constructor. The argument sets the maximal number of outputs that may be
+   * pending, i.e., waiting to be written or being written, at any time.
+   */
+  explicit
+  DataOutAsyncWriter (const unsigned int max_n_pending_outputs = 1);
+
+  /**
+   * Destructor. Waits for all pending outputs to be written.
+   */
+  ~DataOutAsyncWriter ();
+
+  /**
+   * Move the patches built in @p data_out into a new pending output and run
+   * @p writer on them on a background thread, once all previously submitted
+   * outputs have been written. After this call, @p data_out does not hold
+   * any patches any more. Its data vectors, however, stay attached, so
+   * build_patches() can be called again.
+   */
+  template <typename DoFHandlerType>
+  void
+  write (DataOut_DoFData<DoFHandlerType,dim,spacedim>                    &data_out,
+         const std::function<void (const DataOutInterface<dim,spacedim> &)> &writer);
+
+  /**
+   * Wait until all pending outputs have been written.
+   */
+  void wait ();
+
+private:
+  /**
+   * The maximal number of pending outputs.
+   */
+  const unsigned int max_n_pending_outputs;
+
+  /**
+   * The threads writing the pending outputs, in the order of submission.
+   */
+  std::list<Threads::Thread<void> > pending_outputs;
+};
+
+
+
+// ------------------------- inline and template functions ------------------
+
+#ifndef DOXYGEN
+
+template <int dim, int spacedim>
+inline
+DataOutAsyncWriter<dim,spacedim>::
+DataOutAsyncWriter (const unsigned int max_n_pending_outputs)
+  :
+  max_n_pending_outputs (max_n_pending_outputs)
+{
+  Assert (max_n_pending_outputs > 0,
+          ExcMessage ("At least one output must be allowed to be pending."));
+}
+
+
+
+template <int dim, int spacedim>
+inline
+DataOutAsyncWriter<dim,spacedim>::~DataOutAsyncWriter ()
+{
+  wait ();
+}
+
+
+
+template <int dim, int spacedim>
+template <typename DoFHandlerType>
+inline
+void
+DataOutAsyncWriter<dim,spacedim>::
+write (DataOut_DoFData<DoFHandlerType,dim,spacedim>                    &data_out,
+       const std::function<void (const DataOutInterface<dim,spacedim> &)> &writer)
+{
+  // wait for the oldest outputs to finish if too many are pending
+  while (pending_outputs.size() >= max_n_pending_outputs)
+    {
+      pending_outputs.front().join ();
+      pending_outputs.pop_front ();
+    }
+
+  std::shared_ptr<const internal::DataOutAsyncWriter::StoredPatches<dim,spacedim> >
+  stored_patches
+  (new internal::DataOutAsyncWriter::StoredPatches<dim,spacedim>
+   (data_out, std::move(data_out.patches), data_out.get_dataset_names(),
+    data_out.get_vector_data_ranges()));
+  data_out.patches.clear ();
+
+  // keep the outputs in order by letting each thread wait for the one
+  // started before it
+  const Threads::Thread<void> previous_output = (pending_outputs.empty() ?
+                                                 Threads::Thread<void>() :
+                                                 pending_outputs.back());
+  const std::function<void ()> write_output =
+    [stored_patches, writer, previous_output]()
+  {
+    previous_output.join ();
+    writer (*stored_patches);
+  };
+  pending_outputs.push_back (Threads::new_thread (write_output));
+}
+
+
+
+template <int dim, int spacedim>
+inline
+void
+DataOutAsyncWriter<dim,spacedim>::wait ()
+{
+  for (typename std::list<Threads::Thread<void> >::iterator
+       output = pending_outputs.begin(); output != pending_outputs.end(); ++output)
+    output->join ();
+  pending_outputs.clear ();
+}
+
+#endif // ifndef DOXYGEN
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
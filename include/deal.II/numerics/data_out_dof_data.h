@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2016 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -141,6 +141,9 @@ namespace Exceptions
 }
 
 
+template <int dim, int spacedim> class DataOutAsyncWriter;
+
+
 namespace internal
 {
   namespace DataOut
@@ -192,6 +195,18 @@ namespace internal
       double
       get_cell_data_value (const unsigned int cell_number) const = 0;
 
+      /**
+       * Extract the values of the degrees of freedom located on the given
+       * cell from the vector we actually store, in the order of the cell's
+       * local numbering. The vector @p dof_indices is used as scratch space
+       * for the degree of freedom indices of the cell.
+       */
+      virtual
+      void
+      get_dof_values (const typename DoFHandlerType::active_cell_iterator &cell,
+                      std::vector<types::global_dof_index>               &dof_indices,
+                      std::vector<double>                                &dof_values) const = 0;
+
       /**
        * Given a FEValuesBase object, extract the values on the present cell
        * from the vector we actually store.
@@ -339,12 +354,27 @@ namespace internal
 
       void resize_system_vectors(const unsigned int n_components);
 
+      /**
+       * Copy the data previously extracted into patch_values_scalar (if
+       * @p n_components is one) or patch_values_system into the contiguous
+       * tables of patch_values_block and call
+       * DataPostprocessor::evaluate_field_block() on it. The result is
+       * placed in postprocessed_block.
+       */
+      template <typename DoFHandlerType>
+      void evaluate_postprocessor_block (const DataPostprocessor<spacedim> &postprocessor,
+                                         const typename DoFHandlerType::active_cell_iterator &cell,
+                                         const unsigned int n_components,
+                                         const unsigned int n_output_variables);
+
       const unsigned int n_datasets;
       const unsigned int n_subdivisions;
 
       DataPostprocessorInputs::Scalar<spacedim>          patch_values_scalar;
       DataPostprocessorInputs::Vector<spacedim>          patch_values_system;
       std::vector<std::vector<dealii::Vector<double> > > postprocessed_values;
+      DataPostprocessorInputs::Block<spacedim>           patch_values_block;
+      dealii::Table<2,double>                            postprocessed_block;
 
       const dealii::hp::MappingCollection<dim,spacedim> mapping_collection;
       const std::vector<std::shared_ptr<dealii::hp::FECollection<dim,spacedim> > > finite_elements;
@@ -872,6 +902,13 @@ protected:
    */
   template <class, int, int>
   friend class DataOut_DoFData;
+
+  /**
+   * Make the asynchronous writer a friend so that it can move the patches
+   * out of this object.
+   */
+  template <int, int>
+  friend class DataOutAsyncWriter;
 private:
   /**
    * Common function called by the four public add_data_vector methods.
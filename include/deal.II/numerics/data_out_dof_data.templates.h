@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2016 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -153,6 +153,8 @@ namespace internal
       patch_values_scalar (data.patch_values_scalar),
       patch_values_system (data.patch_values_system),
       postprocessed_values (data.postprocessed_values),
+      patch_values_block (data.patch_values_block),
+      postprocessed_block (data.postprocessed_block),
       mapping_collection (data.mapping_collection),
       finite_elements (data.finite_elements),
       update_flags (data.update_flags)
@@ -291,6 +293,67 @@ namespace internal
 
 
 
+    template <int dim, int spacedim>
+    template <typename DoFHandlerType>
+    void
+    ParallelDataBase<dim,spacedim>::
+    evaluate_postprocessor_block (const DataPostprocessor<spacedim> &postprocessor,
+                                  const typename DoFHandlerType::active_cell_iterator &cell,
+                                  const unsigned int n_components,
+                                  const unsigned int n_output_variables)
+    {
+      const UpdateFlags update_flags = postprocessor.get_needed_update_flags();
+      const DataPostprocessorInputs::CommonInputs<spacedim> &common_inputs =
+        (n_components == 1 ?
+         static_cast<const DataPostprocessorInputs::CommonInputs<spacedim> &>(patch_values_scalar) :
+         static_cast<const DataPostprocessorInputs::CommonInputs<spacedim> &>(patch_values_system));
+      const unsigned int n_q_points = patch_values_scalar.solution_values.size();
+
+      // the tables keep their memory when called with the same sizes as
+      // before, so no allocation takes place once the first patch has been
+      // processed
+      if (update_flags & update_values)
+        {
+          patch_values_block.solution_values.reinit (n_q_points, n_components, true);
+          for (unsigned int q=0; q<n_q_points; ++q)
+            if (n_components == 1)
+              patch_values_block.solution_values(q,0) = patch_values_scalar.solution_values[q];
+            else
+              for (unsigned int c=0; c<n_components; ++c)
+                patch_values_block.solution_values(q,c) = patch_values_system.solution_values[q](c);
+        }
+      if (update_flags & update_gradients)
+        {
+          patch_values_block.solution_gradients.reinit (n_q_points, n_components, true);
+          for (unsigned int q=0; q<n_q_points; ++q)
+            if (n_components == 1)
+              patch_values_block.solution_gradients(q,0) = patch_values_scalar.solution_gradients[q];
+            else
+              for (unsigned int c=0; c<n_components; ++c)
+                patch_values_block.solution_gradients(q,c) = patch_values_system.solution_gradients[q][c];
+        }
+      if (update_flags & update_hessians)
+        {
+          patch_values_block.solution_hessians.reinit (n_q_points, n_components, true);
+          for (unsigned int q=0; q<n_q_points; ++q)
+            if (n_components == 1)
+              patch_values_block.solution_hessians(q,0) = patch_values_scalar.solution_hessians[q];
+            else
+              for (unsigned int c=0; c<n_components; ++c)
+                patch_values_block.solution_hessians(q,c) = patch_values_system.solution_hessians[q][c];
+        }
+      if (update_flags & update_quadrature_points)
+        patch_values_block.evaluation_points = common_inputs.evaluation_points;
+      if (update_flags & update_normal_vectors)
+        patch_values_block.normals = common_inputs.normals;
+      patch_values_block.template set_cell<DoFHandlerType> (cell);
+
+      postprocessed_block.reinit (n_q_points, n_output_variables, true);
+      postprocessor.evaluate_field_block (patch_values_block, postprocessed_block);
+    }
+
+
+
 
     /**
      * In a WorkStream context, use this function to append the patch computed
@@ -408,6 +471,16 @@ namespace internal
       double
       get_cell_data_value (const unsigned int cell_number) const;
 
+      /**
+       * Extract the values of the degrees of freedom located on the given
+       * cell from the vector we actually store.
+       */
+      virtual
+      void
+      get_dof_values (const typename DoFHandlerType::active_cell_iterator &cell,
+                      std::vector<types::global_dof_index>               &dof_indices,
+                      std::vector<double>                                &dof_values) const;
+
       /**
        * Given a FEValuesBase object, extract the values on the present cell
        * from the vector we actually store.
@@ -520,18 +593,18 @@ namespace internal
     {
       template <typename VectorType>
       double
-      get_vector_element (const VectorType   &vector,
-                          const unsigned int  cell_number)
+      get_vector_element (const VectorType                   &vector,
+                          const types::global_dof_index  index)
       {
-        return internal::ElementAccess<VectorType>::get(vector,cell_number);
+        return internal::ElementAccess<VectorType>::get(vector,index);
       }
 
 
       inline double
-      get_vector_element (const IndexSet &is,
-                          const unsigned int cell_number)
+      get_vector_element (const IndexSet                &is,
+                          const types::global_dof_index  index)
       {
-        return (is.is_element(cell_number) ? 1 : 0);
+        return (is.is_element(index) ? 1 : 0);
       }
     }
 
@@ -547,6 +620,22 @@ namespace internal
 
 
 
+    template <typename DoFHandlerType, typename VectorType>
+    void
+    DataEntry<DoFHandlerType,VectorType>::
+    get_dof_values (const typename DoFHandlerType::active_cell_iterator &cell,
+                    std::vector<types::global_dof_index>               &dof_indices,
+                    std::vector<double>                                &dof_values) const
+    {
+      dof_indices.resize (cell->get_fe().dofs_per_cell);
+      cell->get_dof_indices (dof_indices);
+      dof_values.resize (dof_indices.size());
+      for (unsigned int i=0; i<dof_indices.size(); ++i)
+        dof_values[i] = get_vector_element(*vector, dof_indices[i]);
+    }
+
+
+
     template <typename DoFHandlerType, typename VectorType>
     void
     DataEntry<DoFHandlerType,VectorType>::get_function_values
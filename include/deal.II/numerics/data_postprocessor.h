@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2007 - 2016 by the deal.II authors
+// Copyright (C) 2007 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -21,6 +21,7 @@
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/tensor.h>
 #include <deal.II/base/point.h>
+#include <deal.II/base/table.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/fe/fe_update_flags.h>
 #include <deal.II/numerics/data_component_interpretation.h>
@@ -331,6 +332,51 @@ namespace DataPostprocessorInputs
     std::vector<std::vector<Tensor<2, spacedim> > > solution_hessians;
   };
 
+  /**
+   * A structure that is used to pass information to
+   * DataPostprocessor::evaluate_field_block(). It contains the same data as
+   * the Scalar and Vector structures, i.e., the values and (if requested)
+   * derivatives of the solution variable at the evaluation points on a
+   * cell or face, but stores them in contiguous tables rather than in
+   * nested vectors. The first index of each table runs over the evaluation
+   * points and the second over the components of the finite element
+   * field, i.e., <code>solution_values(q,c)</code> is the value of
+   * component @p c at point @p q. Scalar fields are represented by tables
+   * with a single column.
+   *
+   * Objects of this type are kept alive by DataOut and similar classes
+   * over all cells they work on, so that the tables are only resized when
+   * the number of evaluation points or components changes, rather than
+   * being allocated anew for every patch.
+   */
+  template <int spacedim>
+  struct Block : public CommonInputs<spacedim>
+  {
+    /**
+     * A table of values of the solution at the evaluation points, with
+     * one row per point and one column per component.
+     */
+    Table<2,double>              solution_values;
+
+    /**
+     * A table of gradients of the solution at the evaluation points, with
+     * one row per point and one column per component.
+     *
+     * This table is only filled if DataPostprocessor::get_needed_update_flags()
+     * returns (possibly among other flags) UpdateFlags::update_gradients.
+     */
+    Table<2,Tensor<1,spacedim> > solution_gradients;
+
+    /**
+     * A table of second derivatives of the solution at the evaluation
+     * points, with one row per point and one column per component.
+     *
+     * This table is only filled if DataPostprocessor::get_needed_update_flags()
+     * returns (possibly among other flags) UpdateFlags::update_hessians.
+     */
+    Table<2,Tensor<2,spacedim> > solution_hessians;
+  };
+
 }
 
 
@@ -465,6 +511,36 @@ public:
   evaluate_vector_field (const DataPostprocessorInputs::Vector<dim> &input_data,
                          std::vector<Vector<double> >               &computed_quantities) const;
 
+  /**
+   * Return whether DataOut and similar classes should call
+   * evaluate_field_block() instead of evaluate_scalar_field() and
+   * evaluate_vector_field(). The default implementation returns @p false.
+   * Derived classes that overload evaluate_field_block() need to overload
+   * this function as well and return @p true.
+   */
+  virtual
+  bool
+  uses_block_evaluation () const;
+
+  /**
+   * Same as evaluate_scalar_field() and evaluate_vector_field(), but the
+   * data at all evaluation points of a patch is passed in contiguous
+   * tables, both for scalar and vector-valued finite element fields. The
+   * second argument has already been sized to the number of evaluation
+   * points times the number of names returned by get_names(), and is to
+   * be filled with the derived quantity @p i at point @p q in
+   * <code>computed_quantities(q,i)</code>. As both arguments are reused
+   * from one patch to the next, implementations of this function can
+   * compute derived quantities without any memory allocation and with
+   * unit-stride access to the solution data.
+   *
+   * This function is only called if uses_block_evaluation() returns @p true.
+   */
+  virtual
+  void
+  evaluate_field_block (const DataPostprocessorInputs::Block<dim> &input_data,
+                        Table<2,double>                           &computed_quantities) const;
+
   /**
    * Return the vector of strings describing the names of the computed
    * quantities.
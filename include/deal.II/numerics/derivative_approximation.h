@@ -142,6 +142,13 @@ DEAL_II_NAMESPACE_OPEN
  * such as finding all active neighbors, or setting up the matrix $Y$ is done
  * in the main function @p approximate.
  *
+ * The finite element field is evaluated only once at the center of each
+ * cell, in a first loop over all cells, and the results are then combined
+ * with the ones of the neighbors in a second loop. Both loops run in
+ * parallel on several threads using WorkStream. In a parallel computation,
+ * the first loop includes the ghost cells, so that the locally owned cells
+ * find the values of all their neighbors.
+ *
  * Due to this way of operation, the class may be easily extended for higher
  * oder derivatives than are presently implemented. Basically, only an
  * additional class along the lines of the derivative descriptor classes @p
@@ -224,6 +231,51 @@ namespace DerivativeApproximation
                                  Vector<float>                      &derivative_norm,
                                  const unsigned int                  component = 0);
 
+  /**
+   * Estimate the error of the gradient of a finite element field by
+   * superconvergent patch recovery in the spirit of Zienkiewicz and Zhu. The
+   * gradients of the solution at the centers of a cell and of all its active
+   * neighbors are fitted by a linear function in the least squares sense,
+   * and the value returned for each cell is the $L_2$ norm of the difference
+   * between this recovered gradient and the gradient of the finite element
+   * field on the cell, $\eta_K = \|G(u_h)-\nabla u_h\|_{L_2(K)}$. Unlike the
+   * quantities computed by approximate_gradient(), this is an estimate of
+   * the error itself and does not need to be scaled by a power of the mesh
+   * size.
+   *
+   * The gradients at the cell centers are computed only once per cell and
+   * shared by all patches the cell belongs to, just as for the other
+   * functions of this namespace, and the cells are worked on in parallel
+   * with WorkStream. The same restriction on the number of neighbors as for
+   * approximate_gradient() applies, i.e., the centers of the cells of each
+   * patch must span the whole space, and ExcInsufficientDirections is thrown
+   * otherwise.
+   *
+   * The last parameter denotes the solution component, for which the error
+   * is to be estimated. It defaults to the first component.
+   *
+   * In a parallel computation the @p solution vector needs to contain the
+   * locally relevant unknowns. The estimate is computed on the locally owned
+   * cells and set to zero on all other cells.
+   */
+  template <int dim, template <int, int> class DoFHandlerType, class InputVector, int spacedim>
+  void
+  estimate_recovered_gradient_error (const Mapping<dim,spacedim>        &mapping,
+                                     const DoFHandlerType<dim,spacedim> &dof,
+                                     const InputVector                  &solution,
+                                     Vector<float>                      &error_per_cell,
+                                     const unsigned int                  component = 0);
+
+  /**
+   * Call the function above with <tt>mapping=MappingQGeneric@<dim@>(1)</tt>.
+   */
+  template <int dim, template <int, int> class DoFHandlerType, class InputVector, int spacedim>
+  void
+  estimate_recovered_gradient_error (const DoFHandlerType<dim,spacedim> &dof,
+                                     const InputVector                  &solution,
+                                     Vector<float>                      &error_per_cell,
+                                     const unsigned int                  component = 0);
+
   /**
    * This function calculates the <tt>order</tt>-th order approximate
    * derivative and returns the full tensor for a single cell.
@@ -22,7 +22,10 @@
 
 #include <deal.II/base/point.h>
 
+#include <array>
 #include <memory>
+#include <utility>
+#include <vector>
 
 DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 #include <nanoflann.hpp>
@@ -156,12 +159,48 @@ public:
 
 
   /**
-   * A typedef for the actual KDTree object.
+   * The actual KDTree object. This is the tree provided by nanoflann,
+   * extended by a function that adjusts the splitting planes of the tree to
+   * points that have moved, without changing the structure of the tree.
    */
-  typedef
-  typename nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<double, PointCloudAdaptor> ,
-           PointCloudAdaptor, dim, unsigned int>
-           NanoFlannKDTree;
+  class NanoFlannKDTree
+    : public nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<double, PointCloudAdaptor>,
+      PointCloudAdaptor, dim, unsigned int>
+  {
+  public:
+    /**
+     * Constructor. The arguments are passed to the constructor of the
+     * nanoflann tree.
+     */
+    NanoFlannKDTree (const int                                      dimension,
+                     const PointCloudAdaptor                       &adaptor,
+                     const nanoflann::KDTreeSingleIndexAdaptorParams &params);
+
+    /**
+     * Recompute the bounding box of the tree and the low and high bounds of
+     * the splitting planes of all nodes from the current position of the
+     * points, keeping the assignment of the points to the leaves. Returns
+     * false if a point has crossed the splitting plane of one of its
+     * ancestors, in which case the tree does not describe the points
+     * anymore and must be rebuilt.
+     */
+    bool refit (const std::vector<Point<dim> > &points);
+
+  private:
+    /**
+     * The type of the nanoflann tree.
+     */
+    typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<double, PointCloudAdaptor>,
+            PointCloudAdaptor, dim, unsigned int> BaseType;
+
+    /**
+     * Recursively refit the given node, filling @p box with the bounding box
+     * of the points below it.
+     */
+    bool refit_node (typename BaseType::Node                    *node,
+                     const std::vector<Point<dim> >             &points,
+                     std::array<std::pair<double,double>,dim>   &box);
+  };
 
 
   /**
@@ -185,6 +224,30 @@ public:
   void set_points (const std::vector<Point<dim> > &pts);
 
 
+  /**
+   * Update the tree after the points passed to set_points() have moved. In
+   * contrast to set_points(), which splits the space anew at a cost of
+   * order $n\log(n)$, this function keeps the structure of the tree and
+   * only recomputes the bounds of the splitting planes from the new
+   * positions of the points, which costs one pass over the points. This is
+   * possible as long as no point has moved across the splitting plane of
+   * one of the nodes above its leaf, i.e., for small displacements compared
+   * to the distance between the points, for example in the time steps of
+   * particle simulations. Otherwise, or if @p pts is not the same vector
+   * (with the same number of points) the tree was built from, the tree is
+   * rebuilt by set_points(). In either case, the tree describes the points
+   * correctly after this call.
+   *
+   * Since the tree is not split anew, a tree that is refit over many steps
+   * may become less balanced than a new one. Queries stay correct, but
+   * calling set_points() once in a while can make them faster.
+   *
+   * @param[in] pts The collection of points, usually the same vector as
+   * passed to set_points() with updated entries
+   */
+  void update_points (const std::vector<Point<dim> > &pts);
+
+
   /**
    * A const accessor to the @p i'th one among the underlying points.
    */
@@ -226,6 +289,37 @@ public:
   get_closest_points (const Point<dim>  &target,
                       const unsigned int n_points) const;
 
+  /**
+   * Perform get_points_within_ball() for each of the given @p targets. The
+   * queries are independent of each other and are distributed among the
+   * available threads, see MultithreadInfo.
+   *
+   * @param[in] targets The target points
+   * @param[in] radius The radius of the balls
+   * @param[in] sorted If @p true, sort the results of each target in ascending order with respect to distance
+   *
+   * @return A vector with an entry for each target, containing the indices
+   * and distances to the respective target of the matching points
+   */
+  std::vector<std::vector<std::pair<unsigned int, double> > >
+  get_points_within_ball (const std::vector<Point<dim> > &targets,
+                          const double                   &radius,
+                          const bool                      sorted=false) const;
+
+  /**
+   * Perform get_closest_points() for each of the given @p targets, using
+   * all available threads like the function above.
+   *
+   * @param[in] targets The target points
+   * @param[in] n_points The number of requested points for each target
+   *
+   * @return A vector with an entry for each target, containing the pairs
+   * of indices and distances of the matching points
+   */
+  std::vector<std::vector<std::pair<unsigned int, double> > >
+  get_closest_points (const std::vector<Point<dim> > &targets,
+                      const unsigned int              n_points) const;
+
 private:
   /**
    * Max number of points per leaf as set in the constructor.
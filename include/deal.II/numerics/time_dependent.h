@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2016 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -24,7 +24,11 @@
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/smartpointer.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/thread_management.h>
 
+#include <algorithm>
+#include <functional>
 #include <vector>
 #include <utility>
 
@@ -542,6 +546,64 @@ public:
                 const TimeSteppingData &timestepping_data,
                 const Direction         direction);
 
+  /**
+   * Like do_loop(), but call the @p loop_function of several time steps
+   * concurrently. This is meant for sweeps in which the work on one time
+   * step does not depend on the results of the work on the other time steps
+   * of the same sweep, such as postprocessing or the evaluation of error
+   * estimates once the primal and dual solutions are known. It can not be
+   * used for the solution of the primal or dual problems themselves, since
+   * there each time step needs the solution of the previous one.
+   *
+   * The time steps are processed in blocks of @p n_concurrent_timesteps
+   * consecutive time steps. For each block, the @p wake_up functions are
+   * called as do_loop() would call them before working on any of the time
+   * steps of the block, then the @p loop_function of all time steps of the
+   * block is run as separate tasks, and after all of them have finished, the
+   * @p sleep functions are called as do_loop() would call them after the
+   * last time step of the block. Consequently, the @p loop_function
+   * of a time step sees the same time steps awake as in do_loop(), and in
+   * addition the other time steps of the block, i.e. the number of time
+   * steps that are awake at a time grows by <tt>n_concurrent_timesteps-1</tt>.
+   *
+   * Waking up the time steps beyond the window of the present block, i.e.
+   * those more than <tt>timestepping_data.look_ahead</tt> time steps ahead of
+   * the last time step of the block, is not needed for the present block.
+   * These time steps are woken up by a separate task while the present block
+   * is being worked on, so that reading back data from disk or rebuilding
+   * grids overlaps with the computations. The sequence of calls to @p wake_up
+   * and @p sleep for each single time step object is the same as in
+   * do_loop(); only calls on different objects may be reordered or run
+   * concurrently.
+   *
+   * The @p init_function is called for all time steps up front as in
+   * do_loop(). If @p n_concurrent_timesteps is zero, the number of threads
+   * set in MultithreadInfo is used. This function does the same as do_loop()
+   * if deal.II is configured without threads, apart from the different order
+   * of the calls to @p wake_up and @p sleep on different objects.
+   *
+   * @note Since the @p loop_function, @p wake_up and @p sleep functions of
+   * different time step objects run concurrently, they must not modify data
+   * shared between time steps without synchronization. Reading data of the
+   * other time steps that are awake (e.g. the grid or solution of the
+   * previous time step) is safe, as long as it is not changed in this sweep.
+   * The postprocessing of a time step could for example look like this:
+   * @code
+   *   do_parallel_loop (std::bind(&TimeStepBase::init_for_postprocessing,
+   *                               std::placeholders::_1),
+   *                     std::bind(&TimeStepBase::postprocess_timestep,
+   *                               std::placeholders::_1),
+   *                     timestepping_data_postprocess,
+   *                     forward);
+   * @endcode
+   */
+  template <typename InitFunctionObject, typename LoopFunctionObject>
+  void do_parallel_loop (InitFunctionObject      init_function,
+                         LoopFunctionObject      loop_function,
+                         const TimeSteppingData &timestepping_data,
+                         const Direction         direction,
+                         const unsigned int      n_concurrent_timesteps = 0);
+
 
   /**
    * Initialize the objects for the next sweep. This function specifically
@@ -1520,8 +1582,8 @@ void TimeDependent::do_loop (InitFunctionObject      init_function,
             timesteps[step+look_ahead]->wake_up(look_ahead);
           break;
         case backward:
-          if (n_timesteps-(step+look_ahead) < n_timesteps)
-            timesteps[n_timesteps-(step+look_ahead)]->wake_up(look_ahead);
+          if (step+look_ahead >= 0)
+            timesteps[n_timesteps-(step+look_ahead)-1]->wake_up(look_ahead);
           break;
         };
 
@@ -1594,6 +1656,103 @@ void TimeDependent::do_loop (InitFunctionObject      init_function,
         };
 }
 
+
+
+template <typename InitFunctionObject, typename LoopFunctionObject>
+void TimeDependent::do_parallel_loop (InitFunctionObject      init_function,
+                                      LoopFunctionObject      loop_function,
+                                      const TimeSteppingData &timestepping_data,
+                                      const Direction         direction,
+                                      const unsigned int      n_concurrent_timesteps)
+{
+  const int n_timesteps = timesteps.size();
+  const int look_ahead  = timestepping_data.look_ahead;
+  const int look_back   = timestepping_data.look_back;
+  const int block_size  = std::max (1U, (n_concurrent_timesteps == 0 ?
+                                         MultithreadInfo::n_threads() :
+                                         n_concurrent_timesteps));
+
+  // the time step object with the given number in the order of the loop,
+  // i.e., counted from the end for backward loops
+  const auto timestep = [&](const int step) -> TimeStepBase *
+  {
+    return &*timesteps[direction == forward ? step : n_timesteps-step-1];
+  };
+
+  // call the wake_up functions do_loop() calls for the steps
+  // [begin, end), restricted to the time steps [first, last)
+  const auto wake_up = [&](const int begin, const int end,
+                           const int first, const int last)
+  {
+    for (int step=begin; step<end; ++step)
+      for (int ahead=0; ahead<=look_ahead; ++ahead)
+        if ((step+ahead >= std::max (first, 0))
+            &&
+            (step+ahead < std::min (last, n_timesteps)))
+          timestep(step+ahead)->wake_up(ahead);
+  };
+
+  // same for the sleep functions
+  const auto sleep = [&](const int begin, const int end)
+  {
+    for (int step=begin; step<end; ++step)
+      for (int back=0; back<=look_back; ++back)
+        if ((step-back >= 0) && (step-back < n_timesteps))
+          timestep(step-back)->sleep(back);
+  };
+
+  for (int step=0; step<n_timesteps; ++step)
+    init_function (timestep(step));
+
+  // wake up the first few time levels, including the ones needed for the
+  // first block
+  wake_up (-look_ahead, std::min (block_size, n_timesteps),
+           0, n_timesteps);
+
+  Threads::Task<> prefetch;
+  for (int block_begin=0; block_begin<n_timesteps; block_begin+=block_size)
+    {
+      const int block_end = std::min (block_begin+block_size, n_timesteps);
+
+      // the wake-ups of this block that were not done by the prefetch task
+      // started while working on the previous block
+      if (prefetch.joinable())
+        {
+          prefetch.join ();
+          wake_up (block_begin, block_end,
+                   0, block_begin+look_ahead);
+        }
+
+      // start waking up the time steps of the next block that are not
+      // accessed by the present block, i.e., those beyond the look-ahead of
+      // the last time step of the present block
+      prefetch = Threads::Task<>();
+      if (block_end < n_timesteps)
+        {
+          const int next_end = std::min (block_end+block_size, n_timesteps);
+          prefetch = Threads::new_task
+                     (std::function<void ()>
+                      (std::bind (wake_up, block_end, next_end,
+                                  block_end+look_ahead, n_timesteps)));
+        }
+
+      // actually do the work
+      Threads::TaskGroup<> tasks;
+      for (int step=block_begin; step<block_end; ++step)
+        tasks += Threads::new_task
+                 (std::function<void ()>
+                  (std::bind (std::ref(loop_function), timestep(step))));
+      tasks.join_all ();
+
+      // let the time steps behind sleep. none of them is touched by the
+      // prefetch task
+      sleep (block_begin, block_end);
+    }
+
+  // make the last few timesteps sleep
+  sleep (n_timesteps, n_timesteps+look_back);
+}
+
 DEAL_II_NAMESPACE_CLOSE
 
 /*----------------------------   time-dependent.h     ---------------------------*/
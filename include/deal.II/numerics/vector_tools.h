@@ -1199,6 +1199,116 @@ namespace VectorTools
    const ComponentMask &component_mask = ComponentMask());
 
 
+  /**
+   * A class that caches the information needed by
+   * interpolate_boundary_values() for a given DoFHandler and a set of
+   * boundary indicators: the location of the support points of the degrees
+   * of freedom on these parts of the boundary in real space, the indices of
+   * the degrees of freedom, and the vector components they belong to. Since
+   * computing this information involves the evaluation of the mapping on all
+   * boundary faces, an object of this class can be used to speed up repeated
+   * interpolation of boundary values on the same mesh, e.g. for
+   * time-dependent boundary functions in each time step:
+   * @code
+   * VectorTools::BoundaryInterpolationPlan<dim> plan (mapping, dof_handler,
+   *                                                   {0, 1});
+   * for ( ; time < end_time; time += time_step)
+   *   {
+   *     boundary_function.set_time (time);
+   *     std::map<types::global_dof_index,double> boundary_values;
+   *     plan.interpolate (function_map, boundary_values);
+   *     ...
+   *   }
+   * @endcode
+   * The interpolation then only evaluates the boundary functions on all
+   * support points of a boundary indicator at once and scatters the values
+   * into the result. The object must be set up again whenever the mesh or
+   * the degrees of freedom change.
+   *
+   * The same restrictions as for interpolate_boundary_values() apply, in
+   * particular only primitive shape functions can be interpolated. Degrees
+   * of freedom that are shared by faces with different boundary indicators
+   * are assigned to one of them. Unlike interpolate_boundary_values(), this
+   * class does not support hp::DoFHandler objects.
+   *
+   * @ingroup constraints
+   */
+  template <int dim, int spacedim=dim>
+  class BoundaryInterpolationPlan
+  {
+  public:
+    /**
+     * Constructor. Collect the support points of the degrees of freedom on
+     * the faces with the given boundary indicators, using the given mapping
+     * to compute their location in real space. Only the components selected
+     * by @p component_mask are considered.
+     */
+    BoundaryInterpolationPlan (const Mapping<dim,spacedim>       &mapping,
+                               const DoFHandler<dim,spacedim>    &dof,
+                               const std::set<types::boundary_id> &boundary_ids,
+                               const ComponentMask               &component_mask = ComponentMask());
+
+    /**
+     * Evaluate the functions given in @p function_map on the cached support
+     * points and enter the values into @p boundary_values, in the same way
+     * as interpolate_boundary_values() does. All boundary indicators in
+     * @p function_map must have been passed to the constructor.
+     */
+    template <typename number>
+    void
+    interpolate (const std::map<types::boundary_id, const Function<spacedim,number>*> &function_map,
+                 std::map<types::global_dof_index,number>                             &boundary_values) const;
+
+    /**
+     * Same as above, but enter the boundary values as inhomogeneous
+     * constraints into @p constraints, in the same way as the respective
+     * interpolate_boundary_values() function does.
+     */
+    template <typename number>
+    void
+    interpolate (const std::map<types::boundary_id, const Function<spacedim,number>*> &function_map,
+                 ConstraintMatrix                                                     &constraints) const;
+
+  private:
+    /**
+     * The cached data for one boundary indicator.
+     */
+    struct BoundaryData
+    {
+      /**
+       * The real-space location of the support points. Components of
+       * vector-valued elements located at the same point share the entry.
+       */
+      std::vector<Point<spacedim> > points;
+
+      /**
+       * The indices of the degrees of freedom to be interpolated.
+       */
+      std::vector<types::global_dof_index> dof_indices;
+
+      /**
+       * For each degree of freedom, the index into #points.
+       */
+      std::vector<unsigned int> point_indices;
+
+      /**
+       * For each degree of freedom, the vector component it belongs to.
+       */
+      std::vector<unsigned int> components;
+    };
+
+    /**
+     * The number of vector components of the finite element.
+     */
+    unsigned int n_components;
+
+    /**
+     * The cached data for each boundary indicator.
+     */
+    std::map<types::boundary_id, BoundaryData> boundary_data;
+  };
+
+
   /**
    * Project a function or a set of functions to the boundary of the domain.
    * In other words, compute the solution of the following problem: Find $u_h
@@ -1070,10 +1070,22 @@ namespace VectorTools
       // steps may not be sufficient, since roundoff errors may accumulate for
       // badly conditioned matrices. This behavior can be observed, e.g. for
       // FE_Q_Hierarchical for degree higher than three.
+      //
+      // As a preconditioner, use a Chebyshev iteration around the point
+      // Jacobi method. The Jacobi-preconditioned mass matrix has a small
+      // condition number, so a few Chebyshev steps that only involve matrix-
+      // vector products considerably reduce the number of CG iterations and
+      // thus the global reductions in the inner products.
       ReductionControl     control(5.*rhs.size(), 0., 1e-12, false, false);
       SolverCG<LinearAlgebra::distributed::Vector<Number> > cg(control);
-      PreconditionJacobi<MatrixType> preconditioner;
-      preconditioner.initialize(mass_matrix, 1.);
+      typedef PreconditionChebyshev<MatrixType, LinearAlgebra::distributed::Vector<Number> > PreconditionerType;
+      typename PreconditionerType::AdditionalData preconditioner_data;
+      preconditioner_data.degree = 3;
+      preconditioner_data.smoothing_range = 30.;
+      preconditioner_data.eig_cg_n_iterations = 15;
+      preconditioner_data.preconditioner = mass_matrix.get_matrix_diagonal_inverse();
+      PreconditionerType preconditioner;
+      preconditioner.initialize(mass_matrix, preconditioner_data);
       cg.solve (mass_matrix, work_result, rhs, preconditioner);
       work_result+=inhomogeneities;
 
@@ -1082,6 +1094,88 @@ namespace VectorTools
 
 
 
+    /*
+     * MatrixFree implementation of project() for discontinuous tensor
+     * product elements without constraints. In that case, the mass matrix is
+     * block-diagonal and we apply its inverse cell by cell through
+     * CellwiseInverseMassMatrix, using a Gauss quadrature with as many points
+     * as there are degrees of freedom, rather than solving a linear system.
+     */
+    template <int components, int fe_degree, int dim, typename Number, int spacedim>
+    void project_matrix_free_dg
+    (const Mapping<dim, spacedim>               &mapping,
+     const DoFHandler<dim, spacedim>            &dof,
+     const Quadrature<dim>                      &quadrature,
+     const Function<spacedim, typename LinearAlgebra::distributed::Vector<Number>::value_type> &function,
+     LinearAlgebra::distributed::Vector<Number> &work_result)
+    {
+      Assert (dof.get_fe().degree == static_cast<unsigned int>(fe_degree),
+              ExcDimensionMismatch(fe_degree, dof.get_fe().degree));
+      Assert (dof.get_fe(0).n_components() == components,
+              ExcDimensionMismatch(components, dof.get_fe(0).n_components()));
+
+      typename MatrixFree<dim,Number>::AdditionalData additional_data;
+      additional_data.tasks_parallel_scheme =
+        MatrixFree<dim,Number>::AdditionalData::partition_color;
+      additional_data.mapping_update_flags = (update_values | update_JxW_values);
+      const ConstraintMatrix no_constraints;
+      MatrixFree<dim, Number> matrix_free;
+      matrix_free.reinit (mapping, dof, no_constraints,
+                          QGauss<1>(fe_degree+1), additional_data);
+
+      LinearAlgebra::distributed::Vector<Number> rhs;
+      matrix_free.initialize_dof_vector(work_result);
+      matrix_free.initialize_dof_vector(rhs);
+      create_right_hand_side (mapping, dof, quadrature, function, rhs);
+
+      typedef LinearAlgebra::distributed::Vector<Number> VectorType;
+      matrix_free.cell_loop
+      (std::function<void (const MatrixFree<dim,Number> &, VectorType &,
+                           const VectorType &, const std::pair<unsigned int,unsigned int> &)>
+       ([](const MatrixFree<dim,Number>                &data,
+           VectorType                                  &dst,
+           const VectorType                            &src,
+           const std::pair<unsigned int,unsigned int>  &cell_range)
+      {
+        FEEvaluation<dim,fe_degree,fe_degree+1,components,Number> phi(data);
+        MatrixFreeOperators::CellwiseInverseMassMatrix<dim,fe_degree,components,Number>
+        inverse_mass(phi);
+        AlignedVector<VectorizedArray<Number> > inverse_JxW(phi.n_q_points);
+        for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+          {
+            phi.reinit(cell);
+            phi.read_dof_values(src);
+            inverse_mass.fill_inverse_JxW_values(inverse_JxW);
+            inverse_mass.apply(inverse_JxW, components, phi.begin_dof_values(),
+                               phi.begin_dof_values());
+            phi.set_dof_values(dst);
+          }
+      }),
+       work_result, rhs);
+    }
+
+
+
+    /**
+     * Return whether project() can use the cellwise inverse of the mass
+     * matrix in project_matrix_free_dg(), i.e., whether the element is a
+     * (possibly vector-valued) FE_DGQ element without constraints.
+     */
+    template <int dim, int spacedim>
+    bool
+    project_can_use_cellwise_inverse (const DoFHandler<dim, spacedim> &dof,
+                                      const ConstraintMatrix          &constraints)
+    {
+      const FiniteElement<dim,spacedim> &fe = dof.get_fe();
+      return (dim > 1 &&
+              constraints.n_constraints() == 0 &&
+              fe.n_base_elements() == 1 &&
+              fe.dofs_per_face == 0 &&
+              dynamic_cast<const FE_DGQ<dim,spacedim> *>(&fe.base_element(0)) != nullptr);
+    }
+
+
+
     /**
      * Helper interface. After figuring out the number of components in
      * project_matrix_free_component, we determine the degree of the
@@ -1103,21 +1197,33 @@ namespace VectorTools
       switch (dof.get_fe().degree)
         {
         case 1:
-          project_matrix_free<components, 1>
-          (mapping, dof, constraints, quadrature, function, work_result,
-           enforce_zero_boundary, q_boundary, project_to_boundary_first);
+          if (project_can_use_cellwise_inverse(dof, constraints))
+            project_matrix_free_dg<components, 1>
+            (mapping, dof, quadrature, function, work_result);
+          else
+            project_matrix_free<components, 1>
+            (mapping, dof, constraints, quadrature, function, work_result,
+             enforce_zero_boundary, q_boundary, project_to_boundary_first);
           break;
 
         case 2:
-          project_matrix_free<components, 2>
-          (mapping, dof, constraints, quadrature, function, work_result,
-           enforce_zero_boundary, q_boundary, project_to_boundary_first);
+          if (project_can_use_cellwise_inverse(dof, constraints))
+            project_matrix_free_dg<components, 2>
+            (mapping, dof, quadrature, function, work_result);
+          else
+            project_matrix_free<components, 2>
+            (mapping, dof, constraints, quadrature, function, work_result,
+             enforce_zero_boundary, q_boundary, project_to_boundary_first);
           break;
 
         case 3:
-          project_matrix_free<components, 3>
-          (mapping, dof, constraints, quadrature, function, work_result,
-           enforce_zero_boundary, q_boundary, project_to_boundary_first);
+          if (project_can_use_cellwise_inverse(dof, constraints))
+            project_matrix_free_dg<components, 3>
+            (mapping, dof, quadrature, function, work_result);
+          else
+            project_matrix_free<components, 3>
+            (mapping, dof, constraints, quadrature, function, work_result,
+             enforce_zero_boundary, q_boundary, project_to_boundary_first);
           break;
 
         default:
@@ -2816,6 +2922,204 @@ namespace VectorTools
 
 
 
+  template <int dim, int spacedim>
+  BoundaryInterpolationPlan<dim,spacedim>::
+  BoundaryInterpolationPlan (const Mapping<dim,spacedim>        &mapping,
+                             const DoFHandler<dim,spacedim>     &dof,
+                             const std::set<types::boundary_id> &boundary_ids,
+                             const ComponentMask                &component_mask)
+    :
+    n_components (dof.get_fe().n_components())
+  {
+    Assert (component_mask.represents_n_components(n_components),
+            ExcMessage ("The number of components in the mask has to be either "
+                        "zero or equal to the number of components in the finite "
+                        "element."));
+    Assert (boundary_ids.find(numbers::internal_face_boundary_id) == boundary_ids.end(),
+            ExcMessage("You cannot specify the special boundary indicator "
+                       "for interior faces in the set of boundary indicators."));
+
+    for (std::set<types::boundary_id>::const_iterator id=boundary_ids.begin();
+         id!=boundary_ids.end(); ++id)
+      boundary_data[*id] = BoundaryData();
+
+    const FiniteElement<dim,spacedim> &fe = dof.get_fe();
+    if (fe.dofs_per_face == 0)
+      return;
+
+    // find the component each degree of freedom on a face belongs to, or
+    // numbers::invalid_unsigned_int if it is not to be interpolated. as in
+    // interpolate_boundary_values(), we can only deal with primitive shape
+    // functions in the components we are interested in
+    std::vector<unsigned int> face_dof_components (fe.dofs_per_face,
+                                                   numbers::invalid_unsigned_int);
+    for (unsigned int i=0; i<fe.dofs_per_face; ++i)
+      {
+        const unsigned int cell_i = fe.face_to_cell_index(i, 0);
+        if (fe.is_primitive(cell_i))
+          {
+            const unsigned int component = fe.system_to_component_index(cell_i).first;
+            if (component_mask[component] == true)
+              face_dof_components[i] = component;
+          }
+        else
+          for (unsigned int c=0; c<n_components; ++c)
+            Assert (!(fe.get_nonzero_components(cell_i)[c] && component_mask[c]),
+                    ExcMessage ("This function can only deal with requested boundary "
+                                "values that correspond to primitive (scalar) base "
+                                "elements"));
+      }
+
+    // in more than one dimension, compute the location of the support points
+    // on the faces with an FEFaceValues object. in 1d, the only support point
+    // on a face is the vertex
+    std::unique_ptr<FEFaceValues<dim,spacedim> > fe_face_values;
+    if (dim > 1)
+      {
+        std::vector<Point<dim-1> > unit_support_points (fe.dofs_per_face);
+        if (fe.has_face_support_points())
+          unit_support_points = fe.get_unit_face_support_points();
+        else
+          for (unsigned int i=0; i<fe.dofs_per_face; ++i)
+            if (face_dof_components[i] != numbers::invalid_unsigned_int)
+              unit_support_points[i] = fe.unit_face_support_point(i);
+
+        fe_face_values.reset (new FEFaceValues<dim,spacedim> (mapping, fe,
+                                                              Quadrature<dim-1>(unit_support_points),
+                                                              update_quadrature_points));
+      }
+
+    std::vector<bool> dof_is_entered (dof.n_dofs(), false);
+    std::vector<types::global_dof_index> face_dofs (fe.dofs_per_face);
+    std::vector<unsigned int> face_point_indices (fe.dofs_per_face);
+
+    for (typename DoFHandler<dim,spacedim>::active_cell_iterator cell = dof.begin_active();
+         cell != dof.end(); ++cell)
+      if (!cell->is_artificial())
+        for (unsigned int face_no=0; face_no<GeometryInfo<dim>::faces_per_cell; ++face_no)
+          {
+            if (cell->at_boundary(face_no) == false)
+              continue;
+
+            const typename std::map<types::boundary_id, BoundaryData>::iterator
+            data = boundary_data.find (cell->face(face_no)->boundary_id());
+            if (data == boundary_data.end())
+              continue;
+
+            if (dim == 1)
+              for (unsigned int i=0; i<fe.dofs_per_face; ++i)
+                face_dofs[i] = cell->vertex_dof_index(face_no, i);
+            else
+              {
+                fe_face_values->reinit (cell, face_no);
+                cell->face(face_no)->get_dof_indices (face_dofs);
+              }
+
+            // enter the degrees of freedom not seen before, letting
+            // components at the same support point share the point entry
+            for (unsigned int i=0; i<fe.dofs_per_face; ++i)
+              {
+                face_point_indices[i] = numbers::invalid_unsigned_int;
+                if (face_dof_components[i] == numbers::invalid_unsigned_int ||
+                    dof_is_entered[face_dofs[i]] == true)
+                  continue;
+                dof_is_entered[face_dofs[i]] = true;
+
+                const Point<spacedim> point = (dim == 1 ?
+                                               cell->vertex(face_no) :
+                                               fe_face_values->quadrature_point(i));
+                for (unsigned int j=0; j<i; ++j)
+                  if (face_point_indices[j] != numbers::invalid_unsigned_int &&
+                      data->second.points[face_point_indices[j]] == point)
+                    {
+                      face_point_indices[i] = face_point_indices[j];
+                      break;
+                    }
+                if (face_point_indices[i] == numbers::invalid_unsigned_int)
+                  {
+                    face_point_indices[i] = data->second.points.size();
+                    data->second.points.push_back (point);
+                  }
+
+                data->second.dof_indices.push_back (face_dofs[i]);
+                data->second.point_indices.push_back (face_point_indices[i]);
+                data->second.components.push_back (face_dof_components[i]);
+              }
+          }
+  }
+
+
+
+  template <int dim, int spacedim>
+  template <typename number>
+  void
+  BoundaryInterpolationPlan<dim,spacedim>::
+  interpolate (const std::map<types::boundary_id, const Function<spacedim,number>*> &function_map,
+               std::map<types::global_dof_index,number>                             &boundary_values) const
+  {
+    for (typename std::map<types::boundary_id, const Function<spacedim,number>*>::const_iterator
+         function=function_map.begin(); function!=function_map.end(); ++function)
+      {
+        const typename std::map<types::boundary_id, BoundaryData>::const_iterator
+        data_it = boundary_data.find(function->first);
+        Assert (data_it != boundary_data.end(),
+                ExcMessage ("The boundary indicator " +
+                            Utilities::int_to_string(function->first) +
+                            " was not passed to the constructor of this object."));
+        Assert (n_components == function->second->n_components,
+                ExcDimensionMismatch(n_components, function->second->n_components));
+
+        const BoundaryData &data = data_it->second;
+        if (data.points.empty())
+          continue;
+
+        if (n_components == 1)
+          {
+            std::vector<number> values (data.points.size());
+            function->second->value_list (data.points, values, 0);
+            for (unsigned int i=0; i<data.dof_indices.size(); ++i)
+              boundary_values[data.dof_indices[i]] = values[data.point_indices[i]];
+          }
+        else
+          {
+            std::vector<Vector<number> > values (data.points.size(),
+                                                 Vector<number>(n_components));
+            function->second->vector_value_list (data.points, values);
+            for (unsigned int i=0; i<data.dof_indices.size(); ++i)
+              boundary_values[data.dof_indices[i]]
+                = values[data.point_indices[i]](data.components[i]);
+          }
+      }
+  }
+
+
+
+  template <int dim, int spacedim>
+  template <typename number>
+  void
+  BoundaryInterpolationPlan<dim,spacedim>::
+  interpolate (const std::map<types::boundary_id, const Function<spacedim,number>*> &function_map,
+               ConstraintMatrix                                                     &constraints) const
+  {
+    std::map<types::global_dof_index,number> boundary_values;
+    interpolate (function_map, boundary_values);
+    typename std::map<types::global_dof_index,number>::const_iterator boundary_value =
+      boundary_values.begin();
+    for ( ; boundary_value !=boundary_values.end(); ++boundary_value)
+      {
+        if (constraints.can_store_line (boundary_value->first)
+            &&
+            !constraints.is_constrained(boundary_value->first))
+          {
+            constraints.add_line (boundary_value->first);
+            constraints.set_inhomogeneity (boundary_value->first,
+                                           boundary_value->second);
+          }
+      }
+  }
+
+
+
 
 // -------- implementation for project_boundary_values with std::map --------
 
@@ -22,6 +22,7 @@
 #ifdef DEAL_II_WITH_OPENCASCADE
 
 #include <deal.II/opencascade/utilities.h>
+#include <deal.II/base/table.h>
 #include <deal.II/grid/tria_boundary.h>
 #include <deal.II/grid/manifold.h>
 
@@ -93,6 +94,17 @@ namespace OpenCASCADE
     project_to_manifold (const ArrayView<const Point<spacedim>> &surrounding_points,
                          const Point<spacedim>                  &candidate) const;
 
+    /**
+     * Compute the weighted averages of the @p surrounding_points for all
+     * rows of @p weights and project them with project_to_manifold(). The
+     * projections of the different points are independent of each other
+     * and are done in parallel.
+     */
+    virtual void
+    get_new_points (const ArrayView<const Point<spacedim>> &surrounding_points,
+                    const Table<2,double>                  &weights,
+                    ArrayView<Point<spacedim>>              new_points) const;
+
 
   private:
     /**
@@ -107,6 +119,12 @@ namespace OpenCASCADE
      * Relative tolerance used by this class to compute distances.
      */
     const double tolerance;
+
+    /**
+     * The bounding box tree of the faces of the shape, used to speed up the
+     * projections.
+     */
+    const ShapeSearchTree search_tree;
   } DEAL_II_DEPRECATED;
 
   /**
@@ -158,6 +176,17 @@ namespace OpenCASCADE
     project_to_manifold (const ArrayView<const Point<spacedim>> &surrounding_points,
                          const Point<spacedim>                  &candidate) const;
 
+    /**
+     * Compute the weighted averages of the @p surrounding_points for all
+     * rows of @p weights and project them with project_to_manifold(). The
+     * projections of the different points are independent of each other
+     * and are done in parallel.
+     */
+    virtual void
+    get_new_points (const ArrayView<const Point<spacedim>> &surrounding_points,
+                    const Table<2,double>                  &weights,
+                    ArrayView<Point<spacedim>>              new_points) const;
+
   private:
     /**
      * The topological shape which is used internally to project points. You
@@ -176,6 +205,12 @@ namespace OpenCASCADE
      * Relative tolerance used by this class to compute distances.
      */
     const double tolerance;
+
+    /**
+     * The bounding box tree of the faces of the shape, used to speed up the
+     * projections.
+     */
+    const ShapeSearchTree search_tree;
   } DEAL_II_DEPRECATED;
 
 
@@ -248,6 +283,17 @@ namespace OpenCASCADE
     project_to_manifold (const ArrayView<const Point<spacedim>> &surrounding_points,
                          const Point<spacedim>                  &candidate) const;
 
+    /**
+     * Compute the weighted averages of the @p surrounding_points for all
+     * rows of @p weights and project them with project_to_manifold(). The
+     * projections of the different points are independent of each other
+     * and are done in parallel.
+     */
+    virtual void
+    get_new_points (const ArrayView<const Point<spacedim>> &surrounding_points,
+                    const Table<2,double>                  &weights,
+                    ArrayView<Point<spacedim>>              new_points) const;
+
   private:
     /**
      * The topological shape which is used internally to project points. You
@@ -261,6 +307,12 @@ namespace OpenCASCADE
      * Relative tolerance used by this class to compute distances.
      */
     const double tolerance;
+
+    /**
+     * The bounding box tree of the faces of the shape, used to speed up the
+     * projections.
+     */
+    const ShapeSearchTree search_tree;
   } DEAL_II_DEPRECATED;
 
   /**
@@ -23,8 +23,11 @@
 
 #include <deal.II/grid/tria.h>
 #include <deal.II/base/point.h>
+#include <deal.II/base/thread_local_storage.h>
 
 #include <string>
+#include <tuple>
+#include <vector>
 
 // opencascade needs "HAVE_CONFIG_H" to be exported...
 DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
@@ -311,6 +314,133 @@ namespace OpenCASCADE
                              const double tolerance=1e-7);
 
 
+  /**
+   * A search structure for the repeated projection of points onto the same
+   * TopoDS_Shape. The free functions project_point_and_pull_back(),
+   * closest_point(), closest_point_and_differential_forms() and
+   * line_intersection() visit all the faces of the shape for every point,
+   * which dominates the cost of refining a mesh attached to a CAD model with
+   * many faces. This class collects the faces of the shape (or its edges, if
+   * the shape does not contain faces) once in the constructor, together
+   * with their bounding boxes, and arranges the boxes in a binary tree. A
+   * query then only projects onto the faces whose bounding box is closer to
+   * the point than the best projection found so far. Since consecutive
+   * queries during refinement usually end up on the same face, the face of
+   * the last successful query of the calling thread is tested first, which
+   * typically prunes all other faces right away.
+   *
+   * The results agree with the ones of the free functions, except in the
+   * rare case where the projection onto the untrimmed surface underlying a
+   * face is closer to the point than its bounding box, i.e., where the free
+   * functions return a point outside the face itself.
+   *
+   * All query functions are const and may be called from several threads at
+   * the same time.
+   */
+  class ShapeSearchTree
+  {
+  public:
+    /**
+     * Constructor. Collect the faces of @p shape, or its edges if it does
+     * not contain faces, and build the tree of their bounding boxes. The @p
+     * tolerance is used for the projections and to enlarge the boxes.
+     */
+    ShapeSearchTree (const TopoDS_Shape &shape,
+                     const double        tolerance = 1e-7);
+
+    /**
+     * Same as the free function project_point_and_pull_back().
+     */
+    std::tuple<Point<3>, TopoDS_Shape, double, double>
+    project_point_and_pull_back (const Point<3> &origin) const;
+
+    /**
+     * Same as the free function closest_point().
+     */
+    Point<3> closest_point (const Point<3> &origin) const;
+
+    /**
+     * Same as the free function closest_point_and_differential_forms().
+     */
+    std::tuple<Point<3>, Tensor<1,3>, double, double>
+    closest_point_and_differential_forms (const Point<3> &origin) const;
+
+    /**
+     * Same as the free function line_intersection(): Return the
+     * intersection of the line through @p origin along @p direction with
+     * the shape that is closest to @p origin. Only the faces whose bounding
+     * box is hit by the line are intersected.
+     */
+    Point<3> line_intersection (const Point<3>    &origin,
+                                const Tensor<1,3> &direction) const;
+
+  private:
+    /**
+     * A node of the tree, covering the entities with indices in
+     * [begin,end) of the array @p entities. Leaves have no children.
+     */
+    struct Node
+    {
+      Point<3>     lower_corner;
+      Point<3>     upper_corner;
+      unsigned int begin;
+      unsigned int end;
+      unsigned int children[2];
+    };
+
+    /**
+     * Split the entities in [begin,end) of @p indices at the median of the
+     * box centers along the direction of largest extent, and return the
+     * index of the new node.
+     */
+    unsigned int build_tree (std::vector<unsigned int> &indices,
+                             const unsigned int         begin,
+                             const unsigned int         end);
+
+    /**
+     * Project @p origin onto the entity with the given index and return
+     * the distance, together with the projected point and its parameters.
+     * A negative distance is returned if the projection failed.
+     */
+    double project_to_entity (const unsigned int index,
+                              const Point<3>    &origin,
+                              Point<3>          &projection,
+                              double            &u,
+                              double            &v) const;
+
+    /**
+     * The shape the tree was built for.
+     */
+    const TopoDS_Shape shape;
+
+    /**
+     * Tolerance for the projections.
+     */
+    const double tolerance;
+
+    /**
+     * The faces of the shape, or its edges if it has no faces, sorted by
+     * the tree.
+     */
+    std::vector<TopoDS_Shape> entities;
+
+    /**
+     * The bounding boxes of the entities.
+     */
+    std::vector<std::pair<Point<3>,Point<3> > > entity_boxes;
+
+    /**
+     * The nodes of the tree. The first node is the root.
+     */
+    std::vector<Node> nodes;
+
+    /**
+     * The entity on which the last query of each thread ended up.
+     */
+    mutable Threads::ThreadLocalStorage<unsigned int> last_entity;
+  };
+
+
   /**
    * Convert OpenCASCADE point into a Point<3>.
    */
@@ -0,0 +1,254 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_particles_cell_linked_list_h
+#define dealii_particles_cell_linked_list_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/point.h>
+#include <deal.II/grid/tria.h>
+
+#include <utility>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Particles
+{
+  template <int, int> class ParticleHandler;
+
+  /**
+   * A neighbor search structure for a collection of points based on the
+   * active cells of a triangulation, i.e., a cell-linked list whose bins
+   * are the cells of the mesh. The points are sorted by the cells they are
+   * located in, and each cell knows the active cells sharing a vertex with
+   * it (including the cells adjacent over hanging vertices). A query for the
+   * points within a ball around a target point starts from the cell the
+   * target lies in and visits the neighbors of the visited cells whose
+   * bounding boxes intersect the ball. Only the points in these cells are
+   * compared to the target.
+   *
+   * In contrast to KDTree, building the structure only sorts the points into
+   * their cells, which is a single pass over the points if the cells are
+   * known, as for the particles of a ParticleHandler. For points that are
+   * distributed with roughly uniform density over cells of similar size and
+   * for radii of the order of the cell size, as in particle methods like DEM
+   * or SPH with a mesh adapted to the interaction radius, a query only
+   * visits a few cells with a few points each, which is faster than the
+   * traversal of a tree. For very non-uniform densities or radii much
+   * larger than the cells, KDTree is the better choice.
+   *
+   * The search proceeds through the mesh, so points are only found if the
+   * straight line from the target to them does not leave the mesh, which is
+   * always the case for convex domains. The bounding boxes of the cells are
+   * computed from their vertices, enlarged to contain the points sorted into
+   * the cell, which makes the search exact also on curved cells as long as
+   * the points of the segment are inside the bounding boxes of the cells
+   * containing them.
+   *
+   * After the points have moved, update_points() sorts them into their new
+   * cells without recomputing the neighbor lists of the cells, which only
+   * change when the triangulation changes and then require a call to
+   * reinit().
+   */
+  template <int dim, int spacedim=dim>
+  class CellLinkedList
+  {
+  public:
+    /**
+     * Constructor. The object needs to be initialized with reinit() before
+     * it can be used.
+     */
+    CellLinkedList ();
+
+    /**
+     * Set up the neighbor lists of the active cells of @p triangulation and
+     * sort the given @p points into the cells given by @p cells, which must
+     * contain the active cell each point lies in. The points are copied, and
+     * the indices of the points returned by the queries refer to their
+     * position in @p points.
+     */
+    void
+    reinit (const Triangulation<dim,spacedim>                                             &triangulation,
+            const std::vector<Point<spacedim> >                                           &points,
+            const std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> &cells);
+
+    /**
+     * Like the function above, but with the locations and surrounding cells
+     * of the locally owned particles of @p particle_handler. The indices of
+     * the points returned by the queries are the positions of the particles
+     * in the iteration from ParticleHandler::begin() to
+     * ParticleHandler::end(), which is sorted by cells.
+     */
+    void
+    reinit (const Triangulation<dim,spacedim>   &triangulation,
+            const ParticleHandler<dim,spacedim> &particle_handler);
+
+    /**
+     * Sort the points anew into the cells after the points have moved, for
+     * the same triangulation as in the last call to reinit(). This only
+     * costs a pass over the points, as the neighbor lists of the cells are
+     * kept.
+     */
+    void
+    update_points (const std::vector<Point<spacedim> >                                           &points,
+                   const std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> &cells);
+
+    /**
+     * Return the number of points stored in this object.
+     */
+    unsigned int
+    size () const;
+
+    /**
+     * Return the number of points located in the given cell.
+     */
+    unsigned int
+    n_points_in_cell (const typename Triangulation<dim,spacedim>::active_cell_iterator &cell) const;
+
+    /**
+     * Fill and return a vector with the indices and distances of the points
+     * that are at distance less than or equal to the given radius from the
+     * target point, which must be located in @p cell.
+     *
+     * @param[in] target The target point
+     * @param[in] cell The active cell containing the target point
+     * @param[in] radius The radius of the ball
+     * @param[in] sorted If @p true, sort the output results in ascending order with respect to distance
+     *
+     * @return A vector of indices and distances to @p target of the matching points
+     */
+    std::vector<std::pair<unsigned int, double> >
+    get_points_within_ball (const Point<spacedim>                                           &target,
+                            const typename Triangulation<dim,spacedim>::active_cell_iterator &cell,
+                            const double                                                     radius,
+                            const bool                                                       sorted = false) const;
+
+    /**
+     * Return the points within the given radius of each of the stored
+     * points, i.e., the neighbor lists of all points as needed for the
+     * interactions in particle methods. Each entry contains the point
+     * itself at distance zero. The queries are distributed among the
+     * available threads, see MultithreadInfo.
+     *
+     * @param[in] radius The radius of the balls
+     * @param[in] sorted If @p true, sort the results of each point in ascending order with respect to distance
+     *
+     * @return A vector with an entry for each stored point, containing the
+     * indices and distances of the matching points
+     */
+    std::vector<std::vector<std::pair<unsigned int, double> > >
+    get_points_within_ball (const double radius,
+                            const bool   sorted = false) const;
+
+  private:
+    /**
+     * Add the points within the ball around @p target, found by starting
+     * from the cell with active cell index @p cell_index, to @p matches.
+     * The vector @p visited_cells is used as scratch space.
+     */
+    void
+    search_ball (const Point<spacedim>                          &target,
+                 const unsigned int                              cell_index,
+                 const double                                    radius,
+                 std::vector<unsigned int>                      &visited_cells,
+                 std::vector<std::pair<unsigned int, double> >  &matches) const;
+
+    /**
+     * The number of active cells of the triangulation passed to reinit().
+     */
+    unsigned int n_active_cells;
+
+    /**
+     * The active cell indices of the cells sharing a vertex with a cell,
+     * stored for all cells one after the other, with the range of cell
+     * <tt>c</tt> given by <tt>neighbor_start[c]</tt> and
+     * <tt>neighbor_start[c+1]</tt>.
+     */
+    std::vector<unsigned int> neighbors;
+
+    /**
+     * The start of the neighbor list of each cell in #neighbors, with one
+     * more entry than the number of cells.
+     */
+    std::vector<unsigned int> neighbor_start;
+
+    /**
+     * The bounding boxes of the vertices of each cell, given by the lower
+     * left and the upper right corner.
+     */
+    std::vector<std::pair<Point<spacedim>,Point<spacedim> > > vertex_boxes;
+
+    /**
+     * The bounding boxes of the vertices of each cell, enlarged to contain
+     * all points sorted into the cell, as used by the search.
+     */
+    std::vector<std::pair<Point<spacedim>,Point<spacedim> > > cell_boxes;
+
+    /**
+     * The points sorted by the cells they lie in, with the points of cell
+     * <tt>c</tt> in the range given by <tt>point_start[c]</tt> and
+     * <tt>point_start[c+1]</tt>.
+     */
+    std::vector<Point<spacedim> > sorted_points;
+
+    /**
+     * The index of the entries of #sorted_points in the vector passed to
+     * reinit() or update_points().
+     */
+    std::vector<unsigned int> point_indices;
+
+    /**
+     * The start of the points of each cell in #sorted_points, with one more
+     * entry than the number of cells.
+     */
+    std::vector<unsigned int> point_start;
+
+    /**
+     * The active cell index of each point, in the order of the vector
+     * passed to reinit() or update_points().
+     */
+    std::vector<unsigned int> point_cells;
+  };
+
+
+
+  /* ----------------------- inline functions ----------------------- */
+
+  template <int dim, int spacedim>
+  inline
+  unsigned int
+  CellLinkedList<dim,spacedim>::size () const
+  {
+    return sorted_points.size();
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline
+  unsigned int
+  CellLinkedList<dim,spacedim>::n_points_in_cell
+  (const typename Triangulation<dim,spacedim>::active_cell_iterator &cell) const
+  {
+    AssertIndexRange (cell->active_cell_index(), n_active_cells);
+    return point_start[cell->active_cell_index()+1] -
+           point_start[cell->active_cell_index()];
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,160 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_particles_field_evaluation_h
+#define dealii_particles_field_evaluation_h
+
+#include <deal.II/particles/particle_handler.h>
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/matrix_free/fe_point_evaluation.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Particles
+{
+  /**
+   * Interpolate the finite element field @p field described by @p
+   * dof_handler to the locations of all particles in @p particle_handler
+   * and store the result in the properties of the particles. The values of
+   * the n_components() components of the field are written to the
+   * properties starting at index @p first_property. If @p
+   * include_gradients is set, the gradients follow the values, with the
+   * dim derivatives of each component stored contiguously.
+   *
+   * The evaluation runs cell by cell with FEPointEvaluation, i.e., it uses
+   * the reference locations of the particles stored in the particle handler
+   * and is restricted to the elements supported by that class. Ghosted
+   * vectors need to have their ghost values updated as the field is only
+   * read on locally owned cells.
+   */
+  template <int dim, typename VectorType>
+  void
+  interpolate_field_on_particles (const DoFHandler<dim> &dof_handler,
+                                  const VectorType      &field,
+                                  ParticleHandler<dim>  &particle_handler,
+                                  const unsigned int     first_property,
+                                  const bool             include_gradients = false)
+  {
+    const FiniteElement<dim> &fe = dof_handler.get_fe();
+    const unsigned int n_components = fe.n_components();
+    FEPointEvaluation<dim> evaluator (fe);
+    Vector<double> dof_values (fe.dofs_per_cell);
+    std::vector<Point<dim> > unit_points;
+
+    for (typename DoFHandler<dim>::active_cell_iterator
+         cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+      if (cell->is_locally_owned())
+        {
+          const typename ParticleHandler<dim>::particle_iterator_range
+          particles = particle_handler.particles_in_cell(cell);
+          if (particles.begin() == particles.end())
+            continue;
+
+          unit_points.clear();
+          for (typename ParticleHandler<dim>::particle_iterator
+               particle = particles.begin(); particle != particles.end(); ++particle)
+            unit_points.push_back(particle->get_reference_location());
+
+          cell->get_dof_values(field, dof_values);
+          evaluator.reinit(cell, make_array_view(unit_points));
+          evaluator.evaluate(make_array_view(dof_values.begin(), dof_values.end()),
+                             true, include_gradients);
+
+          unsigned int q = 0;
+          for (typename ParticleHandler<dim>::particle_iterator
+               particle = particles.begin(); particle != particles.end(); ++particle, ++q)
+            {
+              const ArrayView<double> properties = particle->get_properties();
+              AssertIndexRange (first_property + n_components*(include_gradients ? dim+1 : 1),
+                                properties.size()+1);
+              for (unsigned int c=0; c<n_components; ++c)
+                properties[first_property+c] = evaluator.value(q, c);
+              if (include_gradients)
+                for (unsigned int c=0; c<n_components; ++c)
+                  for (unsigned int d=0; d<dim; ++d)
+                    properties[first_property+n_components+c*dim+d] =
+                      evaluator.gradient(q, c)[d];
+            }
+        }
+  }
+
+
+
+  /**
+   * The transpose of interpolate_field_on_particles(): deposit the
+   * properties of the particles onto the mesh by testing them with the
+   * shape functions, i.e., add $\sum_p \varphi_i(x_p) a_p$ to the entry $i$
+   * of @p rhs, where $a_p$ are the n_components() properties of particle
+   * $p$ starting at index @p first_property. This is the right hand side of
+   * a projection of the particle data onto the finite element space.
+   *
+   * The contributions are added with DoFCellAccessor::distribute_local_to_global()
+   * without applying constraints; for parallel vectors, compress() needs to
+   * be called on @p rhs afterwards.
+   */
+  template <int dim, typename VectorType>
+  void
+  deposit_particle_properties (const DoFHandler<dim> &dof_handler,
+                               ParticleHandler<dim>  &particle_handler,
+                               const unsigned int     first_property,
+                               VectorType            &rhs)
+  {
+    const FiniteElement<dim> &fe = dof_handler.get_fe();
+    const unsigned int n_components = fe.n_components();
+    FEPointEvaluation<dim> evaluator (fe);
+    Vector<double> dof_values (fe.dofs_per_cell);
+    std::vector<Point<dim> > unit_points;
+
+    for (typename DoFHandler<dim>::active_cell_iterator
+         cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+      if (cell->is_locally_owned())
+        {
+          const typename ParticleHandler<dim>::particle_iterator_range
+          particles = particle_handler.particles_in_cell(cell);
+          if (particles.begin() == particles.end())
+            continue;
+
+          unit_points.clear();
+          for (typename ParticleHandler<dim>::particle_iterator
+               particle = particles.begin(); particle != particles.end(); ++particle)
+            unit_points.push_back(particle->get_reference_location());
+          evaluator.reinit(cell, make_array_view(unit_points));
+
+          unsigned int q = 0;
+          for (typename ParticleHandler<dim>::particle_iterator
+               particle = particles.begin(); particle != particles.end(); ++particle, ++q)
+            {
+              const ArrayView<double> properties = particle->get_properties();
+              AssertIndexRange (first_property + n_components, properties.size()+1);
+              for (unsigned int c=0; c<n_components; ++c)
+                evaluator.submit_value(properties[first_property+c], q, c);
+            }
+
+          evaluator.integrate(make_array_view(dof_values.begin(), dof_values.end()),
+                              true, false);
+          cell->distribute_local_to_global(dof_values, rhs);
+        }
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
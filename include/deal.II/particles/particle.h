@@ -242,6 +242,24 @@ namespace Particles
     bool
     has_properties () const;
 
+    /**
+     * Return the handle of the slot in the property pool that stores the
+     * properties of this particle. This is meant to be used together with
+     * set_handle() and PropertyPool::sort_memory_slots() to rearrange the
+     * storage of the particle properties.
+     */
+    PropertyPool::Handle
+    get_handle () const;
+
+    /**
+     * Set the handle of the slot in the property pool that stores the
+     * properties of this particle. The particle takes over the slot, i.e.,
+     * it will release it on destruction, and it does not release the slot it
+     * held before.
+     */
+    void
+    set_handle (const PropertyPool::Handle new_handle);
+
     /**
      * Set the properties of this particle.
      *
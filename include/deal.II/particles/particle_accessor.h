@@ -201,6 +201,12 @@ namespace Particles
      * Make ParticleIterator a friend to allow it constructing ParticleAccessors.
      */
     template <int, int> friend class ParticleIterator;
+
+    /**
+     * Make ParticleHandler a friend to allow it to access the underlying
+     * container iterator.
+     */
+    template <int, int> friend class ParticleHandler;
   };
 }
 
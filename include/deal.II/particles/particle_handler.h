@@ -0,0 +1,501 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_particles_particle_handler_h
+#define dealii_particles_particle_handler_h
+
+#include <deal.II/particles/particle.h>
+#include <deal.II/particles/particle_iterator.h>
+#include <deal.II/particles/property_pool.h>
+
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/fe/mapping.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_tools_cache.h>
+
+#include <boost/range/iterator_range.hpp>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Particles
+{
+  /**
+   * This class manages the storage and handling of particles. It provides
+   * the data structures necessary to store particles efficiently, accessor
+   * functions to iterate over particles and find particles, and algorithms
+   * to distribute particles in parallel domains.
+   *
+   * The particles are stored in a container that is sorted by the active
+   * cell they are located in, so that the particles of a cell are adjacent
+   * and can be obtained by particles_in_cell(). After the particles have
+   * been moved, e.g. by setting a new location through a
+   * ParticleAccessor, the function sort_particles_into_subdomains_and_cells()
+   * finds the new cells of the particles and sends the particles that left
+   * the locally owned part of the mesh to the processes owning their new
+   * cells.
+   *
+   * If the triangulation is derived from parallel::Triangulation, e.g. a
+   * parallel::distributed::Triangulation, the particles are distributed
+   * among the processes of its communicator, and each process only stores
+   * the particles located in its locally owned cells. For other
+   * triangulations, all particles are stored on the current process.
+   */
+  template <int dim, int spacedim=dim>
+  class ParticleHandler : public Subscriptor
+  {
+  public:
+    /**
+     * A type that can be used to iterate over all particles in the domain.
+     */
+    typedef ParticleIterator<dim,spacedim> particle_iterator;
+
+    /**
+     * A type for the return value of the function particles_in_cell().
+     */
+    typedef boost::iterator_range<particle_iterator> particle_iterator_range;
+
+    /**
+     * Default constructor. The object needs to be initialized with
+     * initialize() before it can be used.
+     */
+    ParticleHandler ();
+
+    /**
+     * Constructor that initializes the particle handler with a given
+     * triangulation and mapping. Since particles are stored in respect to
+     * their surrounding cells this information is necessary to correctly
+     * organize the particle collection. The constructor is identical to
+     * calling initialize() on a default-constructed object.
+     */
+    ParticleHandler (const Triangulation<dim,spacedim> &tria,
+                     const Mapping<dim,spacedim>       &mapping,
+                     const unsigned int                 n_properties = 0);
+
+    /**
+     * Destructor.
+     */
+    ~ParticleHandler ();
+
+    /**
+     * Initialize the particle handler. This function clears the internal
+     * data structures and sets the triangulation and the mapping, and the
+     * number of properties stored per particle.
+     */
+    void
+    initialize (const Triangulation<dim,spacedim> &tria,
+                const Mapping<dim,spacedim>       &mapping,
+                const unsigned int                 n_properties = 0);
+
+    /**
+     * Clear all particle related data and the pointers to the
+     * triangulation and the mapping.
+     */
+    void
+    clear ();
+
+    /**
+     * Only clear the particle data, but keep the information about the
+     * triangulation and the mapping.
+     */
+    void
+    clear_particles ();
+
+    /**
+     * Update all internally cached numbers, namely the global number of
+     * particles, the largest number of particles in a cell, and the next free
+     * particle index. This is a collective operation over all processes of
+     * the triangulation. It is called at the end of all functions of this
+     * class that change the number of particles globally, and needs to be
+     * called by the user after particles have been inserted or removed with
+     * insert_particle() or remove_particle().
+     */
+    void
+    update_cached_numbers ();
+
+    /**
+     * Return an iterator to the first particle.
+     */
+    particle_iterator
+    begin () const;
+
+    /**
+     * Return an iterator to the first particle.
+     */
+    particle_iterator
+    begin ();
+
+    /**
+     * Return an iterator past the end of the particles.
+     */
+    particle_iterator
+    end () const;
+
+    /**
+     * Return an iterator past the end of the particles.
+     */
+    particle_iterator
+    end ();
+
+    /**
+     * Return a pair of particle iterators that mark the begin and end of the
+     * particles in a particular cell. The last iterator is the first
+     * particle that is no longer in the cell.
+     */
+    particle_iterator_range
+    particles_in_cell (const typename Triangulation<dim,spacedim>::active_cell_iterator &cell);
+
+    /**
+     * Return the number of particles that live in the given cell.
+     */
+    unsigned int
+    n_particles_in_cell (const typename Triangulation<dim,spacedim>::active_cell_iterator &cell) const;
+
+    /**
+     * Remove a particle pointed to by the iterator. All other iterators
+     * remain valid.
+     */
+    void
+    remove_particle (const particle_iterator &particle);
+
+    /**
+     * Insert a particle into the collection of particles. Return an iterator
+     * to the new position of the particle. This function involves a copy of
+     * the particle and its properties. Note that this function is of $O(\log
+     * N)$ complexity for $N$ particles.
+     */
+    particle_iterator
+    insert_particle (const Particle<dim,spacedim>                                    &particle,
+                     const typename Triangulation<dim,spacedim>::active_cell_iterator &cell);
+
+    /**
+     * Insert a number of particles into the collection of particles. This
+     * function involves a copy of the particles and their properties, and
+     * calls update_cached_numbers() at the end, so it is a collective
+     * operation over all processes of the triangulation.
+     */
+    void
+    insert_particles (const std::multimap<typename Triangulation<dim,spacedim>::active_cell_iterator,
+                      Particle<dim,spacedim> > &particles);
+
+    /**
+     * Create and insert a number of particles at the given positions. The
+     * cells and the reference locations of the particles are located with
+     * GridTools::compute_point_locations(). Positions that are not inside a
+     * locally owned cell are ignored. The particle created from
+     * <tt>positions[i]</tt> gets the index get_next_free_particle_index()
+     * plus @p i plus the number of positions passed on the processes of
+     * lower rank, so that the indices are unique among all processes. The
+     * properties of the new particles are set to zero. This is a collective
+     * operation over all processes of the triangulation.
+     */
+    void
+    insert_particles (const std::vector<Point<spacedim> > &positions);
+
+    /**
+     * Return the total number of particles that were managed by this class
+     * the last time the update_cached_numbers() function was called. The
+     * actual number of particles may have changed since then if particles
+     * have been added or removed.
+     */
+    types::particle_index
+    n_global_particles () const;
+
+    /**
+     * Return the maximum number of particles in a single cell over all
+     * processes at the time of the last call to update_cached_numbers().
+     */
+    types::particle_index
+    n_global_max_particles_per_cell () const;
+
+    /**
+     * Return the number of particles in the local part of the
+     * triangulation.
+     */
+    types::particle_index
+    n_locally_owned_particles () const;
+
+    /**
+     * Return the next free particle index in the global set of particles
+     * the last time update_cached_numbers() was called.
+     */
+    types::particle_index
+    get_next_free_particle_index () const;
+
+    /**
+     * Return the number of properties each particle has.
+     */
+    unsigned int
+    n_properties_per_particle () const;
+
+    /**
+     * Return a reference to the property pool that owns all particle
+     * properties, and organizes them physically.
+     */
+    PropertyPool &
+    get_property_pool () const;
+
+    /**
+     * Find the cells of all particles after their locations have changed.
+     * For a particle that is still inside its cell, only the reference
+     * location is updated. For the other particles, the cells around the
+     * vertex of the old cell that is closest to the particle are searched
+     * first, in the order of how well the directions from this vertex to
+     * the cell centers align with the direction to the particle, using the
+     * vertex-to-cell map of the GridTools::Cache object of this class. If
+     * none of them contains the particle, the search of
+     * GridTools::find_active_cell_around_point() is used.
+     *
+     * Particles that end up in a locally owned cell are moved to their new
+     * cell. Particles whose new cell is a ghost cell are packed into one
+     * message per receiving process and sent to the owner of that cell with
+     * Utilities::MPI::sparse_data_exchange(). Particles that are not found
+     * in the locally owned or ghost cells have left the domain (or moved
+     * further than a layer of ghost cells within one step) and are deleted.
+     *
+     * This is a collective operation over all processes of the
+     * triangulation.
+     */
+    void
+    sort_particles_into_subdomains_and_cells ();
+
+    /**
+     * Rearrange the properties of all particles in the property pool in the
+     * order of the particles in the container, i.e., sorted by cells, see
+     * PropertyPool::sort_memory_slots(). Afterwards, loops over the
+     * particles of a cell access contiguous memory. Since this copies the
+     * properties of all particles, it is typically called only every few
+     * time steps, after sort_particles_into_subdomains_and_cells() has
+     * moved the particles to new cells.
+     */
+    void
+    sort_property_pool_by_cells ();
+
+    /**
+     * Return the size in bytes that the particles of this process occupy if
+     * all their data is serialized.
+     */
+    std::size_t
+    serialized_size_in_bytes () const;
+
+    /**
+     * Register the function that packs the particles of each cell into the
+     * data that a parallel::distributed::Triangulation attaches to its
+     * cells, see parallel::distributed::Triangulation::register_data_attach().
+     * The particles then move along with their cells when the triangulation
+     * is refined, coarsened or repartitioned, or are written into the file
+     * by parallel::distributed::Triangulation::save().
+     *
+     * This function needs to be called right before
+     * parallel::distributed::Triangulation::execute_coarsening_and_refinement()
+     * or parallel::distributed::Triangulation::repartition() with
+     * @p serialization set to false, e.g. by connecting it to the
+     * Triangulation::Signals::pre_distributed_refinement signal, or right
+     * before parallel::distributed::Triangulation::save() with
+     * @p serialization set to true. The particles need to be restored by
+     * register_load_callback_function() after the triangulation has been
+     * changed or loaded.
+     *
+     * The triangulation reserves the same number of bytes for every cell. It
+     * is computed from the largest number of particles in a cell, times the
+     * number of children of a cell if the mesh is changed, because
+     * coarsening collects the particles of all children in their parent.
+     * This is a collective operation over all processes of the
+     * triangulation.
+     */
+    void
+    register_store_callback_function (const bool serialization);
+
+    /**
+     * Unpack the particles stored by register_store_callback_function()
+     * from the data attached to the cells of the triangulation, and replace
+     * the particles of this class by them. The particles of a refined cell
+     * are distributed among its children. The argument needs to be the same
+     * as in the corresponding call to register_store_callback_function().
+     * When loading a checkpoint, the state of this object needs to be
+     * restored by serialize() before the triangulation is loaded.
+     */
+    void
+    register_load_callback_function (const bool serialization);
+
+    /**
+     * Connect a function to the Triangulation::Signals::cell_weight signal
+     * of the triangulation that adds @p weight_per_particle for each
+     * particle in a cell to the weight of the cell. This way, the load
+     * balancing of a parallel::distributed::Triangulation accounts for the
+     * cost of the particles. Recall that the triangulation assigns a weight
+     * of 1000 to each cell, so a value of 1000 states that a particle is as
+     * expensive as a cell without particles. Calling this function again
+     * replaces the previous connection, and it is disconnected by clear()
+     * and on destruction of this object.
+     */
+    void
+    connect_to_cell_weight_signal (const unsigned int weight_per_particle);
+
+    /**
+     * Serialize the contents of this class that are needed to restore the
+     * particles from a checkpoint written by
+     * parallel::distributed::Triangulation::save(). The particles themselves
+     * are stored in the checkpoint of the triangulation, see
+     * register_store_callback_function().
+     */
+    template <class Archive>
+    void serialize (Archive &ar, const unsigned int version);
+
+  private:
+    /**
+     * Address of the triangulation to work on.
+     */
+    SmartPointer<const Triangulation<dim,spacedim>,ParticleHandler<dim,spacedim> > triangulation;
+
+    /**
+     * Address of the mapping to work on.
+     */
+    SmartPointer<const Mapping<dim,spacedim>,ParticleHandler<dim,spacedim> > mapping;
+
+    /**
+     * The cache of the triangulation that provides the vertex-to-cell map
+     * and the point location facilities used to find the cells of the
+     * particles. It keeps itself up to date when the triangulation changes.
+     */
+    std::unique_ptr<GridTools::Cache<dim,spacedim> > cache;
+
+    /**
+     * The communicator of the triangulation, or MPI_COMM_SELF if the
+     * triangulation is not a parallel::Triangulation.
+     */
+    MPI_Comm mpi_communicator;
+
+    /**
+     * Set of particles currently in the local domain, organized by the
+     * level/index of the cell they are in.
+     */
+    std::multimap<types::LevelInd, Particle<dim,spacedim> > particles;
+
+    /**
+     * This variable stores how many particles are stored globally. It is
+     * calculated by update_cached_numbers().
+     */
+    types::particle_index global_number_of_particles;
+
+    /**
+     * The maximum number of particles per cell in the global domain. This
+     * variable is important to store and load particle data during
+     * repartition and serialization of the solution. Note that the
+     * variable is only updated when it is needed, e.g. after particle
+     * movement or before checkpointing.
+     */
+    types::particle_index global_max_particles_per_cell;
+
+    /**
+     * This variable stores the next free particle index that is available
+     * globally in case new particles need to be generated.
+     */
+    types::particle_index next_free_particle_index;
+
+    /**
+     * This object owns and organizes the memory for all particle
+     * properties.
+     */
+    std::unique_ptr<PropertyPool> property_pool;
+
+    /**
+     * The offset of the particle data within the data attached to the
+     * cells of the triangulation, as returned by
+     * parallel::distributed::Triangulation::register_data_attach().
+     */
+    unsigned int handle;
+
+    /**
+     * The connection to the cell_weight signal of the triangulation, see
+     * connect_to_cell_weight_signal().
+     */
+    boost::signals2::connection cell_weight_connection;
+
+    /**
+     * Return the number of bytes that the data of a single particle
+     * occupies in the data attached to the cells of the triangulation.
+     */
+    std::size_t
+    size_per_particle () const;
+
+    /**
+     * Return the number of particles that will be in the cell @p cell after
+     * the triangulation has been changed, as described by @p status.
+     */
+    unsigned int
+    n_particles_after_refinement (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                  const typename Triangulation<dim,spacedim>::CellStatus     status) const;
+
+    /**
+     * Write the number of particles in the cell @p cell and their data into
+     * @p data. If the children of @p cell are going to be coarsened, the
+     * particles of all children are written, with their reference location
+     * in @p cell.
+     */
+    void
+    store_particles (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                     const typename Triangulation<dim,spacedim>::CellStatus     status,
+                     void                                                      *data);
+
+    /**
+     * Read the particles of the cell @p cell written by store_particles()
+     * and insert them. If @p cell has been refined, each particle is
+     * inserted into the child it is located in.
+     */
+    void
+    load_particles (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                    const typename Triangulation<dim,spacedim>::CellStatus     status,
+                    const void                                                *data);
+
+    /**
+     * Transfer the particles listed in @p particles_to_send to the
+     * processes given as keys. The particles need to have their new
+     * reference location set, and @p new_cells_for_particles contains the
+     * new cells of the particles in the same order. The particles are not
+     * removed from the local container, which is the responsibility of the
+     * caller. The particles received from other processes are inserted
+     * into @p received_particles.
+     */
+    void
+    send_recv_particles (const std::map<dealii::types::subdomain_id, std::vector<particle_iterator> >                                          &particles_to_send,
+                         const std::map<dealii::types::subdomain_id, std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> > &new_cells_for_particles,
+                         std::multimap<types::LevelInd,Particle <dim,spacedim> >                                                      &received_particles);
+  };
+
+
+
+  /* ---------------------- inline and template functions ------------------ */
+
+  template <int dim,int spacedim>
+  template <class Archive>
+  void
+  ParticleHandler<dim,spacedim>::serialize (Archive &ar, const unsigned int)
+  {
+    ar &global_number_of_particles
+    &global_max_particles_per_cell
+    &next_free_particle_index
+    &handle;
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
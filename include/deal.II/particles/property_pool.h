@@ -18,6 +18,9 @@
 
 #include <deal.II/base/array_view.h>
 
+#include <memory>
+#include <vector>
+
 DEAL_II_NAMESPACE_OPEN
 
 namespace Particles
@@ -28,8 +31,13 @@ namespace Particles
    * needs the same amount, it is more efficient to let this be handled by a
    * central manager that does not need to allocate/deallocate memory every
    * time a particle is constructed/destroyed.
-   * The current implementation uses simple new/delete allocation for every
-   * block. Additionally, the current implementation
+   * The current implementation hands out slots from large contiguous chunks
+   * of memory and keeps released slots in a free list for reuse, so that
+   * creating and destroying particles does not touch the heap in the common
+   * case and the properties of particles created together are adjacent in
+   * memory. Handles stay valid until they are released or the pool is
+   * destroyed, except for the ones passed to sort_memory_slots(). The class
+   * is not thread-safe. Additionally, the current implementation
    * assumes the same number of properties per particle, but of course the
    * PropertyType could contain a pointer to dynamically allocated memory
    * with varying sizes per particle (this memory would not be managed by this
@@ -79,10 +87,27 @@ namespace Particles
 
     /**
      * Reserves the dynamic memory needed for storing the properties of
-     * @p size particles.
+     * @p size particles. The additional memory is allocated as a single
+     * contiguous chunk, so that the next slots handed out by
+     * allocate_properties_array() are adjacent in memory.
      */
     void reserve(const std::size_t size);
 
+    /**
+     * Move the properties of the slots given by @p handles into a new
+     * contiguous chunk of memory, in the order in which they appear in the
+     * array, and replace each entry of @p handles by the handle of its new
+     * slot. The old slots are released, and chunks that do not contain any
+     * used slots anymore are returned to the operating system.
+     *
+     * Passing the handles of all particles sorted by the cell they are
+     * located in makes loops over the properties of the particles of a cell
+     * stream through memory. The caller is responsible for handing the new
+     * handles back to the particles, e.g. via Particle::set_handle();
+     * accessing the old handles afterwards is undefined behavior.
+     */
+    void sort_memory_slots(std::vector<Handle> &handles);
+
     /**
      * Returns how many properties are stored per slot in the pool.
      */
@@ -93,6 +118,43 @@ namespace Particles
      * The number of properties that are reserved per particle.
      */
     const unsigned int n_properties;
+
+    /**
+     * The distance in the memory chunks between two consecutive slots. It
+     * equals the number of properties, except when there are no properties,
+     * in which case each slot still occupies one entry so that different
+     * handles remain distinguishable.
+     */
+    const unsigned int slot_size;
+
+    /**
+     * The chunks of memory that slots are handed out from, together with
+     * the number of slots each of them holds.
+     */
+    std::vector<std::pair<std::unique_ptr<double[]>,std::size_t> > memory_chunks;
+
+    /**
+     * The slots that are currently not in use. New slots are taken from the
+     * back of the array. The slots of a new chunk are entered in reverse
+     * order, so that consecutive allocations obtain adjacent slots.
+     */
+    std::vector<Handle> free_slots;
+
+    /**
+     * The total number of slots in all chunks.
+     */
+    std::size_t n_slots;
+
+    /**
+     * Add a new chunk with @p n_new_slots slots to the pool and put them
+     * into the list of free slots.
+     */
+    void add_chunk(const std::size_t n_new_slots);
+
+    /**
+     * Return the memory of all chunks whose slots are all unused.
+     */
+    void release_unused_chunks();
   };
 
 
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2016 by the deal.II authors
+// Copyright (C) 2016 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -292,7 +292,7 @@ SymmetricTensor<4, dim, Number>
 Physics::Elasticity::StandardTensors<dim>::Dev_P (const Tensor<2, dim, Number> &F)
 {
   const Number det_F = determinant(F);
-  Assert(det_F > Number(0.0),
+  Assert(numbers::value_is_greater_than(det_F, 0.0),
          ExcMessage("Deformation gradient has a negative determinant."));
   const Tensor<2,dim,Number> C_ns = transpose(F)*F;
   const SymmetricTensor<2,dim,Number> C = symmetrize(C_ns);
@@ -300,7 +300,7 @@ Physics::Elasticity::StandardTensors<dim>::Dev_P (const Tensor<2, dim, Number> &
 
   // See Wriggers p46 equ 3.125 (but transpose indices)
   SymmetricTensor<4,dim,Number> Dev_P = outer_product(C,C_inv);  // Dev_P = C_x_C_inv
-  Dev_P /= -dim;                                                 // Dev_P = -[1/dim]C_x_C_inv
+  Dev_P /= internal::NumberType<Number>::value(-dim);            // Dev_P = -[1/dim]C_x_C_inv
   Dev_P += SymmetricTensor<4,dim,Number>(S);                     // Dev_P = S - [1/dim]C_x_C_inv
   Dev_P *= std::pow(det_F, -2.0/dim);                            // Dev_P = J^{-2/dim} [S - [1/dim]C_x_C_inv]
 
@@ -316,7 +316,7 @@ SymmetricTensor<4, dim, Number>
 Physics::Elasticity::StandardTensors<dim>::Dev_P_T (const Tensor<2, dim, Number> &F)
 {
   const Number det_F = determinant(F);
-  Assert(det_F > Number(0.0),
+  Assert(numbers::value_is_greater_than(det_F, 0.0),
          ExcMessage("Deformation gradient has a negative determinant."));
   const Tensor<2,dim,Number> C_ns = transpose(F)*F;
   const SymmetricTensor<2,dim,Number> C = symmetrize(C_ns);
@@ -324,7 +324,7 @@ Physics::Elasticity::StandardTensors<dim>::Dev_P_T (const Tensor<2, dim, Number>
 
   // See Wriggers p46 equ 3.125 (not transposed)
   SymmetricTensor<4,dim,Number> Dev_P_T = outer_product(C_inv,C);  // Dev_P = C_inv_x_C
-  Dev_P_T /= -dim;                                                 // Dev_P = -[1/dim]C_inv_x_C
+  Dev_P_T /= internal::NumberType<Number>::value(-dim);            // Dev_P = -[1/dim]C_inv_x_C
   Dev_P_T += SymmetricTensor<4,dim,Number>(S);                     // Dev_P = S - [1/dim]C_inv_x_C
   Dev_P_T *= std::pow(det_F, -2.0/dim);                            // Dev_P = J^{-2/dim} [S - [1/dim]C_inv_x_C]
 
@@ -339,7 +339,7 @@ inline
 SymmetricTensor<2, dim, Number>
 Physics::Elasticity::StandardTensors<dim>::ddet_F_dC (const Tensor<2, dim, Number> &F)
 {
-  return Number(0.5)*determinant(F)*symmetrize(invert(transpose(F)*F));
+  return internal::NumberType<Number>::value(0.5)*determinant(F)*symmetrize(invert(transpose(F)*F));
 }
 
 
@@ -930,7 +930,7 @@ template <typename Number>
 Tensor<2,2,Number>
 Physics::Transformations::Rotations::rotation_matrix_2d (const Number &angle)
 {
-  const double rotation[2][2]
+  const Number rotation[2][2]
   = {{
       std::cos(angle), -std::sin(angle)
     },
@@ -938,7 +938,7 @@ Physics::Transformations::Rotations::rotation_matrix_2d (const Number &angle)
       std::sin(angle), std::cos(angle)
     }
   };
-  return Tensor<2,2> (rotation);
+  return Tensor<2,2,Number> (rotation);
 }
 
 
@@ -948,12 +948,12 @@ Tensor<2,3,Number>
 Physics::Transformations::Rotations::rotation_matrix_3d (const Point<3,Number> &axis,
                                                          const Number          &angle)
 {
-  Assert(std::abs(axis.norm() - 1.0) < 1e-9,
+  Assert(numbers::value_is_less_than(std::abs(axis.norm() - 1.0), 1e-9),
          ExcMessage("The supplied axial vector is not a unit vector."));
   const Number c = std::cos(angle);
   const Number s = std::sin(angle);
   const Number t = 1.-c;
-  const double rotation[3][3]
+  const Number rotation[3][3]
   = {{
       t *axis[0] *axis[0] + c,
       t *axis[0] *axis[1] - s *axis[2],
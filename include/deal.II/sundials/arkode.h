@@ -239,6 +239,14 @@ namespace SUNDIALS
    * To produce output at fixed steps, overload the function
    *  - output_step;
    *
+   * The vectors handled by ARKode store deal.II vectors of type VectorType
+   * with the layout of the initial solution, and all vector operations of
+   * ARKode are carried out by VectorType. Thus, the vectors passed to the
+   * user functions are the vectors of ARKode themselves, and no copies are
+   * made when the functions are called. The function reinit_vector is only
+   * used for temporary vectors in solve_jacobian_system and
+   * solve_mass_system.
+   *
    *
    * To provide a simple example, consider the harmonic oscillator problem:
    * \f[
@@ -78,6 +78,12 @@ namespace SUNDIALS
    * To output steps, connect a function to the signal
    *  - output_step;
    *
+   * The vectors handled by IDA store deal.II vectors of type VectorType with
+   * the layout of the initial solution, and all vector operations of IDA are
+   * carried out by VectorType. Thus, the vectors passed to the user
+   * functions are the vectors of IDA themselves, and no copies are made when
+   * the functions are called.
+   *
    * Citing from the SUNDIALS documentation:
    *
    *   Consider a system of Differential-Algebraic Equations written in the
@@ -183,6 +183,10 @@ namespace SUNDIALS
    * use its internal dense solver for Newton methods, with approximate
    * Jacobian. This may be very expensive for large systems. Fixed point
    * iteration does not require the solution of any linear system.
+   * The dense solver works on the serial vectors of SUNDIALS and can only be
+   * used with serial vector types. Otherwise, the vectors handled by KINSOL
+   * store deal.II vectors of type VectorType, and the vectors passed to the
+   * user functions are the vectors of KINSOL themselves without copies.
    *
    * Also the following functions could be rewritten, to provide additional
    * scaling factors for both the solution and the residual evaluation during
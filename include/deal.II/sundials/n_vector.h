@@ -0,0 +1,70 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sundials_n_vector_h
+#define dealii_sundials_n_vector_h
+
+#include <deal.II/base/config.h>
+#ifdef DEAL_II_WITH_SUNDIALS
+
+#include <deal.II/base/mpi.h>
+
+#include <sundials/sundials_nvector.h>
+
+DEAL_II_NAMESPACE_OPEN
+namespace SUNDIALS
+{
+  namespace internal
+  {
+    /**
+     * Create a SUNDIALS N_Vector that stores a deal.II vector of type
+     * VectorType, initialized with a copy of @p vector. All vector
+     * operations of SUNDIALS act directly on the deal.II vector: linear
+     * combinations, dot products, and norms are forwarded to the member
+     * functions of VectorType, and the remaining element-wise operations
+     * work on the locally owned elements. The vectors created by SUNDIALS
+     * through N_VClone() store deal.II vectors with the same parallel layout
+     * as @p vector, so the callbacks of the solvers can pass the vectors
+     * returned by unwrap_nvector() to the user functions without copying.
+     *
+     * The reductions over the processors use the communicator @p
+     * mpi_communicator. The returned vector is freed with N_VDestroy().
+     *
+     * The supported vector types are Vector<double>, BlockVector<double>,
+     * LinearAlgebra::distributed::Vector<double>,
+     * LinearAlgebra::distributed::BlockVector<double>, and the MPI vectors
+     * and block vectors of the Trilinos and PETSc wrappers.
+     *
+     * The operation N_VGetArrayPointer() is only available for vector types
+     * that store their locally owned elements contiguously, and the vectors
+     * do not support N_VSetArrayPointer(). Therefore, they cannot be used
+     * with the direct linear solvers of SUNDIALS.
+     */
+    template <typename VectorType>
+    N_Vector create_nvector (const VectorType &vector,
+                             const MPI_Comm    mpi_communicator);
+
+    /**
+     * Return the deal.II vector stored in a vector created by
+     * create_nvector() or cloned from one.
+     */
+    template <typename VectorType>
+    VectorType &unwrap_nvector (N_Vector vector);
+  }
+}
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // DEAL_II_WITH_SUNDIALS
+#endif // dealii_sundials_n_vector_h
@@ -0,0 +1,654 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sundials_n_vector_templates_h
+#define dealii_sundials_n_vector_templates_h
+
+#include <deal.II/sundials/n_vector.h>
+
+#ifdef DEAL_II_WITH_SUNDIALS
+
+#include <deal.II/lac/block_vector_base.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/block_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+
+#ifdef DEAL_II_WITH_TRILINOS
+#include <deal.II/lac/trilinos_vector.h>
+#include <deal.II/lac/trilinos_parallel_block_vector.h>
+#endif
+
+#ifdef DEAL_II_WITH_PETSC
+#include <deal.II/lac/petsc_parallel_vector.h>
+#include <deal.II/lac/petsc_parallel_block_vector.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+namespace SUNDIALS
+{
+  namespace internal
+  {
+    namespace NVectorImplementation
+    {
+      /**
+       * The content of the N_Vector: the deal.II vector and the
+       * communicator for the reductions.
+       */
+      template <typename VectorType>
+      struct Content
+      {
+        std::unique_ptr<VectorType> vector;
+        MPI_Comm                    mpi_communicator;
+      };
+
+
+
+      /**
+       * The locally owned elements of a vector as a list of contiguous
+       * arrays, one for vectors and one per block for block vectors. The
+       * arrays of PETSc vectors are obtained with VecGetArray() and returned
+       * in the destructor.
+       */
+      struct LocalElements
+      {
+        std::vector<std::pair<double *, std::size_t> > arrays;
+
+#if defined(DEAL_II_WITH_PETSC) && !defined(PETSC_USE_COMPLEX)
+        std::vector<std::pair<Vec, PetscScalar *> > petsc_arrays;
+
+        ~LocalElements ()
+        {
+          for (unsigned int i=0; i<petsc_arrays.size(); ++i)
+            {
+              const PetscErrorCode ierr = VecRestoreArray (petsc_arrays[i].first,
+                                                           &petsc_arrays[i].second);
+              AssertNothrow (ierr == 0, ExcPETScError(ierr));
+              (void)ierr;
+            }
+        }
+#endif
+      };
+
+
+
+#if defined(DEAL_II_WITH_PETSC) && !defined(PETSC_USE_COMPLEX)
+      inline
+      void
+      gather_local_elements (PETScWrappers::MPI::Vector &vector,
+                             LocalElements              &elements,
+                             std::false_type)
+      {
+        Vec petsc_vector = vector;
+        PetscScalar *values = nullptr;
+        const PetscErrorCode ierr = VecGetArray (petsc_vector, &values);
+        AssertThrow (ierr == 0, ExcPETScError(ierr));
+        elements.petsc_arrays.emplace_back(petsc_vector, values);
+        elements.arrays.emplace_back(values, vector.local_size());
+      }
+#endif
+
+
+
+      template <typename VectorType>
+      void
+      gather_local_elements (VectorType    &vector,
+                             LocalElements &elements,
+                             std::false_type)
+      {
+        elements.arrays.emplace_back(&*vector.begin(),
+                                     vector.end() - vector.begin());
+      }
+
+
+
+      template <typename VectorType>
+      void
+      gather_local_elements (VectorType    &vector,
+                             LocalElements &elements,
+                             std::true_type)
+      {
+        typedef typename VectorType::BlockType BlockType;
+        for (unsigned int b=0; b<vector.n_blocks(); ++b)
+          gather_local_elements
+          (vector.block(b), elements,
+           std::integral_constant<bool,IsBlockVector<BlockType>::value>());
+      }
+
+
+
+      /**
+       * Call @p operation with pointers to the locally owned elements of
+       * the vectors @p z, @p x, and @p y and the number of elements for each
+       * contiguous array. Operations with fewer arguments pass the same
+       * vector several times; every vector is only accessed once.
+       */
+      template <typename VectorType, typename Operation>
+      void
+      apply_to_local_elements (VectorType      &z,
+                               VectorType      &x,
+                               VectorType      &y,
+                               const Operation &operation)
+      {
+        typedef std::integral_constant<bool,IsBlockVector<VectorType>::value> is_block;
+        LocalElements z_elements, x_elements, y_elements;
+        gather_local_elements (z, z_elements, is_block());
+        const LocalElements *x_data = &z_elements;
+        if (&x != &z)
+          {
+            gather_local_elements (x, x_elements, is_block());
+            x_data = &x_elements;
+          }
+        const LocalElements *y_data = &z_elements;
+        if (&y == &x)
+          y_data = x_data;
+        else if (&y != &z)
+          {
+            gather_local_elements (y, y_elements, is_block());
+            y_data = &y_elements;
+          }
+
+        AssertDimension (z_elements.arrays.size(), x_data->arrays.size());
+        AssertDimension (z_elements.arrays.size(), y_data->arrays.size());
+        for (unsigned int a=0; a<z_elements.arrays.size(); ++a)
+          {
+            AssertDimension (z_elements.arrays[a].second, x_data->arrays[a].second);
+            AssertDimension (z_elements.arrays[a].second, y_data->arrays[a].second);
+            operation (z_elements.arrays[a].first,
+                       x_data->arrays[a].first,
+                       y_data->arrays[a].first,
+                       z_elements.arrays[a].second);
+          }
+      }
+
+
+
+      /**
+       * Whether the vector type stores its locally owned elements in one
+       * contiguous array, which is required by N_VGetArrayPointer().
+       */
+      template <typename VectorType>
+      struct HasContiguousStorage
+      {
+        static const bool value = !IsBlockVector<VectorType>::value;
+      };
+
+#if defined(DEAL_II_WITH_PETSC) && !defined(PETSC_USE_COMPLEX)
+      template <>
+      struct HasContiguousStorage<PETScWrappers::MPI::Vector>
+      {
+        static const bool value = false;
+      };
+#endif
+
+
+
+      template <typename VectorType>
+      VectorType &
+      get (N_Vector vector)
+      {
+        Assert (vector != nullptr && vector->content != nullptr,
+                ExcMessage("The N_Vector does not store a deal.II vector"));
+        return *static_cast<Content<VectorType> *>(vector->content)->vector;
+      }
+
+
+
+      template <typename VectorType>
+      MPI_Comm
+      get_communicator (N_Vector vector)
+      {
+        return static_cast<Content<VectorType> *>(vector->content)->mpi_communicator;
+      }
+
+
+
+      inline
+      N_Vector_ID
+      get_vector_id (N_Vector)
+      {
+        return SUNDIALS_NVEC_CUSTOM;
+      }
+
+
+
+      template <typename VectorType>
+      N_Vector
+      clone (N_Vector w)
+      {
+        N_Vector v = new _generic_N_Vector;
+        v->ops = new _generic_N_Vector_Ops(*w->ops);
+        Content<VectorType> *content = new Content<VectorType>;
+        content->vector.reset (new VectorType());
+        content->vector->reinit (get<VectorType>(w), true);
+        content->mpi_communicator = get_communicator<VectorType>(w);
+        v->content = content;
+        return v;
+      }
+
+
+
+      template <typename VectorType>
+      void
+      destroy (N_Vector v)
+      {
+        if (v == nullptr)
+          return;
+        delete static_cast<Content<VectorType> *>(v->content);
+        delete v->ops;
+        delete v;
+      }
+
+
+
+      template <typename VectorType>
+      void
+      space (N_Vector v, long int *lrw, long int *liw)
+      {
+        *lrw = get<VectorType>(v).locally_owned_elements().n_elements();
+        *liw = 1;
+      }
+
+
+
+      template <typename VectorType>
+      realtype *
+      get_array_pointer (N_Vector v)
+      {
+        Assert (HasContiguousStorage<VectorType>::value, ExcInternalError());
+        LocalElements elements;
+        gather_local_elements
+        (get<VectorType>(v), elements,
+         std::integral_constant<bool,IsBlockVector<VectorType>::value>());
+        AssertDimension (elements.arrays.size(), 1);
+        return elements.arrays[0].first;
+      }
+
+
+
+      template <typename VectorType>
+      void
+      linear_sum (realtype a, N_Vector x, realtype b, N_Vector y, N_Vector z)
+      {
+        VectorType &X = get<VectorType>(x);
+        VectorType &Y = get<VectorType>(y);
+        VectorType &Z = get<VectorType>(z);
+        if (&Z == &X && &Z == &Y)
+          Z *= (a+b);
+        else if (&Z == &X)
+          Z.sadd (a, b, Y);
+        else if (&Z == &Y)
+          Z.sadd (b, a, X);
+        else
+          {
+            Z.equ (a, X);
+            Z.add (b, Y);
+          }
+      }
+
+
+
+      template <typename VectorType>
+      void
+      set_constant (realtype c, N_Vector z)
+      {
+        get<VectorType>(z) = c;
+      }
+
+
+
+      template <typename VectorType>
+      void
+      product (N_Vector x, N_Vector y, N_Vector z)
+      {
+        VectorType &X = get<VectorType>(x);
+        VectorType &Y = get<VectorType>(y);
+        VectorType &Z = get<VectorType>(z);
+        if (&Z == &X)
+          Z.scale (Y);
+        else if (&Z == &Y)
+          Z.scale (X);
+        else
+          {
+            Z = X;
+            Z.scale (Y);
+          }
+      }
+
+
+
+      template <typename VectorType>
+      void
+      divide (N_Vector x, N_Vector y, N_Vector z)
+      {
+        apply_to_local_elements
+        (get<VectorType>(z), get<VectorType>(x), get<VectorType>(y),
+         [] (double *Z, const double *X, const double *Y, const std::size_t n)
+        {
+          for (std::size_t i=0; i<n; ++i)
+            Z[i] = X[i] / Y[i];
+        });
+      }
+
+
+
+      template <typename VectorType>
+      void
+      scale (realtype c, N_Vector x, N_Vector z)
+      {
+        VectorType &X = get<VectorType>(x);
+        VectorType &Z = get<VectorType>(z);
+        if (&Z == &X)
+          Z *= c;
+        else
+          Z.equ (c, X);
+      }
+
+
+
+      template <typename VectorType>
+      void
+      absolute_value (N_Vector x, N_Vector z)
+      {
+        apply_to_local_elements
+        (get<VectorType>(z), get<VectorType>(x), get<VectorType>(x),
+         [] (double *Z, const double *X, const double *, const std::size_t n)
+        {
+          for (std::size_t i=0; i<n; ++i)
+            Z[i] = std::abs(X[i]);
+        });
+      }
+
+
+
+      template <typename VectorType>
+      void
+      inverse (N_Vector x, N_Vector z)
+      {
+        apply_to_local_elements
+        (get<VectorType>(z), get<VectorType>(x), get<VectorType>(x),
+         [] (double *Z, const double *X, const double *, const std::size_t n)
+        {
+          for (std::size_t i=0; i<n; ++i)
+            Z[i] = 1. / X[i];
+        });
+      }
+
+
+
+      template <typename VectorType>
+      void
+      add_constant (N_Vector x, realtype b, N_Vector z)
+      {
+        apply_to_local_elements
+        (get<VectorType>(z), get<VectorType>(x), get<VectorType>(x),
+         [b] (double *Z, const double *X, const double *, const std::size_t n)
+        {
+          for (std::size_t i=0; i<n; ++i)
+            Z[i] = X[i] + b;
+        });
+      }
+
+
+
+      template <typename VectorType>
+      realtype
+      dot_product (N_Vector x, N_Vector y)
+      {
+        return get<VectorType>(x) * get<VectorType>(y);
+      }
+
+
+
+      template <typename VectorType>
+      realtype
+      max_norm (N_Vector x)
+      {
+        return get<VectorType>(x).linfty_norm();
+      }
+
+
+
+      template <typename VectorType>
+      realtype
+      weighted_l2_norm_squared (N_Vector x, N_Vector w, N_Vector mask)
+      {
+        double sum = 0;
+        VectorType *M = mask != nullptr ? &get<VectorType>(mask) : &get<VectorType>(x);
+        apply_to_local_elements
+        (*M, get<VectorType>(x), get<VectorType>(w),
+         [&sum, mask] (double *id, const double *X, const double *W, const std::size_t n)
+        {
+          for (std::size_t i=0; i<n; ++i)
+            if (mask == nullptr || id[i] > 0.)
+              sum += (X[i] * W[i]) * (X[i] * W[i]);
+        });
+        return Utilities::MPI::sum (sum, get_communicator<VectorType>(x));
+      }
+
+
+
+      template <typename VectorType>
+      realtype
+      wrms_norm (N_Vector x, N_Vector w)
+      {
+        return std::sqrt(weighted_l2_norm_squared<VectorType>(x, w, nullptr) /
+                         get<VectorType>(x).size());
+      }
+
+
+
+      template <typename VectorType>
+      realtype
+      wrms_norm_mask (N_Vector x, N_Vector w, N_Vector id)
+      {
+        return std::sqrt(weighted_l2_norm_squared<VectorType>(x, w, id) /
+                         get<VectorType>(x).size());
+      }
+
+
+
+      template <typename VectorType>
+      realtype
+      min_element (N_Vector x)
+      {
+        double minimum = std::numeric_limits<double>::max();
+        VectorType &X = get<VectorType>(x);
+        apply_to_local_elements
+        (X, X, X,
+         [&minimum] (double *Z, const double *, const double *, const std::size_t n)
+        {
+          for (std::size_t i=0; i<n; ++i)
+            minimum = std::min(minimum, Z[i]);
+        });
+        return Utilities::MPI::min (minimum, get_communicator<VectorType>(x));
+      }
+
+
+
+      template <typename VectorType>
+      realtype
+      wl2_norm (N_Vector x, N_Vector w)
+      {
+        return std::sqrt(weighted_l2_norm_squared<VectorType>(x, w, nullptr));
+      }
+
+
+
+      template <typename VectorType>
+      realtype
+      l1_norm (N_Vector x)
+      {
+        return get<VectorType>(x).l1_norm();
+      }
+
+
+
+      template <typename VectorType>
+      void
+      compare (realtype c, N_Vector x, N_Vector z)
+      {
+        apply_to_local_elements
+        (get<VectorType>(z), get<VectorType>(x), get<VectorType>(x),
+         [c] (double *Z, const double *X, const double *, const std::size_t n)
+        {
+          for (std::size_t i=0; i<n; ++i)
+            Z[i] = std::abs(X[i]) >= c ? 1. : 0.;
+        });
+      }
+
+
+
+      template <typename VectorType>
+      booleantype
+      inverse_test (N_Vector x, N_Vector z)
+      {
+        int all_nonzero = 1;
+        apply_to_local_elements
+        (get<VectorType>(z), get<VectorType>(x), get<VectorType>(x),
+         [&all_nonzero] (double *Z, const double *X, const double *, const std::size_t n)
+        {
+          for (std::size_t i=0; i<n; ++i)
+            if (X[i] == 0.)
+              all_nonzero = 0;
+            else
+              Z[i] = 1. / X[i];
+        });
+        return Utilities::MPI::min (all_nonzero, get_communicator<VectorType>(x));
+      }
+
+
+
+      template <typename VectorType>
+      booleantype
+      constraint_mask (N_Vector c, N_Vector x, N_Vector m)
+      {
+        // the constraints are encoded as 2: x > 0, 1: x >= 0, -1: x <= 0,
+        // -2: x < 0, and 0: no constraint. The mask is one for the violated
+        // constraints.
+        int all_satisfied = 1;
+        apply_to_local_elements
+        (get<VectorType>(m), get<VectorType>(c), get<VectorType>(x),
+         [&all_satisfied] (double *M, const double *C, const double *X, const std::size_t n)
+        {
+          for (std::size_t i=0; i<n; ++i)
+            {
+              bool violated = false;
+              if (C[i] == 2.)
+                violated = (X[i] <= 0.);
+              else if (C[i] == 1.)
+                violated = (X[i] < 0.);
+              else if (C[i] == -1.)
+                violated = (X[i] > 0.);
+              else if (C[i] == -2.)
+                violated = (X[i] >= 0.);
+              M[i] = violated ? 1. : 0.;
+              if (violated)
+                all_satisfied = 0;
+            }
+        });
+        return Utilities::MPI::min (all_satisfied, get_communicator<VectorType>(x));
+      }
+
+
+
+      template <typename VectorType>
+      realtype
+      min_quotient (N_Vector num, N_Vector denom)
+      {
+        double minimum = std::numeric_limits<double>::max();
+        VectorType &N = get<VectorType>(num);
+        apply_to_local_elements
+        (N, N, get<VectorType>(denom),
+         [&minimum] (double *Num, const double *, const double *Denom, const std::size_t n)
+        {
+          for (std::size_t i=0; i<n; ++i)
+            if (Denom[i] != 0.)
+              minimum = std::min(minimum, Num[i] / Denom[i]);
+        });
+        return Utilities::MPI::min (minimum, get_communicator<VectorType>(num));
+      }
+    }
+
+
+
+    template <typename VectorType>
+    N_Vector create_nvector (const VectorType &vector,
+                             const MPI_Comm    mpi_communicator)
+    {
+      using namespace NVectorImplementation;
+
+      N_Vector v = new _generic_N_Vector;
+
+      // value-initialize the operations such that the optional operations we
+      // do not provide are null pointers
+      v->ops = new _generic_N_Vector_Ops();
+      v->ops->nvgetvectorid     = &get_vector_id;
+      v->ops->nvclone           = &clone<VectorType>;
+      v->ops->nvcloneempty      = nullptr;
+      v->ops->nvdestroy         = &destroy<VectorType>;
+      v->ops->nvspace           = &space<VectorType>;
+      v->ops->nvgetarraypointer = HasContiguousStorage<VectorType>::value ?
+                                  &get_array_pointer<VectorType> : nullptr;
+      v->ops->nvsetarraypointer = nullptr;
+      v->ops->nvlinearsum       = &linear_sum<VectorType>;
+      v->ops->nvconst           = &set_constant<VectorType>;
+      v->ops->nvprod            = &product<VectorType>;
+      v->ops->nvdiv             = &divide<VectorType>;
+      v->ops->nvscale           = &scale<VectorType>;
+      v->ops->nvabs             = &absolute_value<VectorType>;
+      v->ops->nvinv             = &inverse<VectorType>;
+      v->ops->nvaddconst        = &add_constant<VectorType>;
+      v->ops->nvdotprod         = &dot_product<VectorType>;
+      v->ops->nvmaxnorm         = &max_norm<VectorType>;
+      v->ops->nvwrmsnorm        = &wrms_norm<VectorType>;
+      v->ops->nvwrmsnormmask    = &wrms_norm_mask<VectorType>;
+      v->ops->nvmin             = &min_element<VectorType>;
+      v->ops->nvwl2norm         = &wl2_norm<VectorType>;
+      v->ops->nvl1norm          = &l1_norm<VectorType>;
+      v->ops->nvcompare         = &compare<VectorType>;
+      v->ops->nvinvtest         = &inverse_test<VectorType>;
+      v->ops->nvconstrmask      = &constraint_mask<VectorType>;
+      v->ops->nvminquotient     = &min_quotient<VectorType>;
+
+      Content<VectorType> *content = new Content<VectorType>;
+      content->vector.reset (new VectorType(vector));
+      content->mpi_communicator = mpi_communicator;
+      v->content = content;
+
+      return v;
+    }
+
+
+
+    template <typename VectorType>
+    VectorType &unwrap_nvector (N_Vector vector)
+    {
+      return NVectorImplementation::get<VectorType>(vector);
+    }
+  }
+}
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // DEAL_II_WITH_SUNDIALS
+#endif // dealii_sundials_n_vector_templates_h
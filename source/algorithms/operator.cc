@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2010 - 2016 by the deal.II authors
+// Copyright (C) 2010 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -20,6 +20,7 @@
 
 #include <deal.II/algorithms/operator.templates.h>
 #include <deal.II/algorithms/newton.templates.h>
+#include <deal.II/algorithms/jacobian_free_inverse.templates.h>
 #include <deal.II/algorithms/theta_timestepping.templates.h>
 
 #include <deal.II/lac/vector.h>
@@ -51,6 +52,14 @@ namespace Algorithms
   }
 
 #include "operator.inst"
+
+  // the Jacobian-free inverse needs the full set of vector operations used
+  // by SolverGMRES, so it is only instantiated for the vectors of double
+  // precision of deal.II. Other vector types need to include the
+  // .templates.h file
+  template class JacobianFreeInverse<Vector<double> >;
+  template class JacobianFreeInverse<BlockVector<double> >;
+  template class JacobianFreeInverse<LinearAlgebra::distributed::Vector<double> >;
 }
 
 DEAL_II_NAMESPACE_CLOSE
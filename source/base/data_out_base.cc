@@ -35,6 +35,7 @@
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/parameter_handler.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/mpi.h>
 
@@ -256,7 +257,16 @@ namespace
    * by a base64 encoding of the
    * given data. The result is then
    * written to the given stream.
+   *
+   * Large arrays are split into blocks
+   * of vtu_compression_block_size bytes
+   * that are compressed independently
+   * and in parallel, using the
+   * multi-block header of VTK's
+   * compressed binary format.
    */
+  const std::size_t vtu_compression_block_size = 1U<<20;
+
   template <typename T>
   void write_compressed_block (const std::vector<T>        &data,
                                const DataOutBase::VtkFlags &flags,
@@ -264,38 +274,79 @@ namespace
   {
     if (data.size() != 0)
       {
-        // allocate a buffer for compressing
-        // data and do so
-        uLongf compressed_data_length
-          = compressBound (data.size() * sizeof(T));
-        char *compressed_data = new char[compressed_data_length];
-        int err = compress2 ((Bytef *) compressed_data,
-                             &compressed_data_length,
-                             (const Bytef *) data.data(),
-                             data.size() * sizeof(T),
-                             get_zlib_compression_level(flags.compression_level));
-        (void)err;
-        Assert (err == Z_OK, ExcInternalError());
-
-        // now encode the compression header
-        const uint32_t compression_header[4]
-          = { 1,                                   /* number of blocks */
-              (uint32_t)(data.size() * sizeof(T)), /* size of block */
-              (uint32_t)(data.size() * sizeof(T)), /* size of last block */
-              (uint32_t)compressed_data_length
-            }; /* list of compressed sizes of blocks */
-
-        char *encoded_header = encode_block ((char *)&compression_header[0],
-                                             4 * sizeof(compression_header[0]));
+        const std::size_t n_bytes = data.size() * sizeof(T);
+        const std::size_t n_blocks = (n_bytes + vtu_compression_block_size - 1) /
+                                     vtu_compression_block_size;
+        // a single block is written with its actual size to keep small
+        // arrays in the same format as before
+        const std::size_t block_size = (n_blocks == 1 ? n_bytes :
+                                        vtu_compression_block_size);
+        const int compression_level =
+          get_zlib_compression_level(flags.compression_level);
+        const char *uncompressed_data = reinterpret_cast<const char *>(data.data());
+
+        // compress each block into its own buffer
+        std::vector<std::vector<char> > compressed_blocks (n_blocks);
+        parallel::apply_to_subranges
+        (std::size_t(0), n_blocks,
+         [&](const std::size_t begin, const std::size_t end)
+        {
+          for (std::size_t b=begin; b<end; ++b)
+            {
+              const std::size_t size = std::min(block_size, n_bytes - b*block_size);
+              uLongf compressed_length = compressBound (size);
+              compressed_blocks[b].resize (compressed_length);
+              int err = compress2 ((Bytef *) compressed_blocks[b].data(),
+                                   &compressed_length,
+                                   (const Bytef *) (uncompressed_data + b*block_size),
+                                   size,
+                                   compression_level);
+              (void)err;
+              Assert (err == Z_OK, ExcInternalError());
+              compressed_blocks[b].resize (compressed_length);
+            }
+        },
+        1);
+
+        // now encode the compression header: the number of blocks, the
+        // size of a block, the size of the last block, and the list of
+        // compressed sizes of the blocks
+        std::vector<uint32_t> compression_header (3 + n_blocks);
+        compression_header[0] = n_blocks;
+        compression_header[1] = block_size;
+        compression_header[2] = n_bytes - (n_blocks-1)*block_size;
+        std::size_t compressed_data_length = 0;
+        for (std::size_t b=0; b<n_blocks; ++b)
+          {
+            compression_header[3+b] = compressed_blocks[b].size();
+            compressed_data_length += compressed_blocks[b].size();
+          }
+
+        char *encoded_header = encode_block ((char *)compression_header.data(),
+                                             compression_header.size() *
+                                             sizeof(compression_header[0]));
         output_stream << encoded_header;
         delete[] encoded_header;
 
         // next do the compressed
         // data encoding in base64
-        char *encoded_data = encode_block (compressed_data,
-                                           compressed_data_length);
-        delete[] compressed_data;
+        std::vector<char> compressed_data;
+        if (n_blocks == 1)
+          compressed_data.swap (compressed_blocks[0]);
+        else
+          {
+            compressed_data.reserve (compressed_data_length);
+            for (std::size_t b=0; b<n_blocks; ++b)
+              {
+                compressed_data.insert (compressed_data.end(),
+                                        compressed_blocks[b].begin(),
+                                        compressed_blocks[b].end());
+                std::vector<char>().swap (compressed_blocks[b]);
+              }
+          }
 
+        char *encoded_data = encode_block (compressed_data.data(),
+                                           compressed_data.size());
         output_stream << encoded_data;
         delete[] encoded_data;
       }
@@ -1053,6 +1104,12 @@ namespace
     template <typename T>
     std::ostream &operator<< (const std::vector<T> &);
 
+    /**
+     * Write a block of floating point data, converted to single precision
+     * if requested by VtkFlags::single_precision.
+     */
+    void write_float_data (const std::vector<double> &data);
+
   private:
     /**
      * A list of vertices and
@@ -1447,7 +1504,10 @@ namespace
     // compress the data we have in
     // memory and write them to the
     // stream. then release the data
-    *this << vertices << '\n';
+    if (flags.single_precision)
+      *this << std::vector<float>(vertices.begin(), vertices.end()) << '\n';
+    else
+      *this << vertices << '\n';
     vertices.clear ();
 #endif
   }
@@ -1533,6 +1593,17 @@ namespace
 
     return stream;
   }
+
+
+
+  void
+  VtuStream::write_float_data (const std::vector<double> &data)
+  {
+    if (flags.single_precision)
+      *this << std::vector<float>(data.begin(), data.end());
+    else
+      *this << data;
+  }
 }
 
 
@@ -1767,10 +1838,39 @@ namespace DataOutBase
   {}
 
 
+  InSituAdaptor::InSituAdaptor (const unsigned int        output_interval,
+                                const DataOutFilterFlags &flags)
+    :
+    output_interval (output_interval),
+    flags (flags)
+  {
+    Assert (output_interval > 0,
+            ExcMessage ("The output interval must be at least one."));
+  }
+
+
+
+  bool
+  InSituAdaptor::is_output_step (const unsigned int step) const
+  {
+    return (step % output_interval == 0);
+  }
+
+
+
+  const DataOutFilterFlags &
+  InSituAdaptor::get_filter_flags () const
+  {
+    return flags;
+  }
+
+
   DataOutFilterFlags::DataOutFilterFlags (const bool filter_duplicate_vertices,
-                                          const bool xdmf_hdf5_output) :
+                                          const bool xdmf_hdf5_output,
+                                          const bool single_precision) :
     filter_duplicate_vertices(filter_duplicate_vertices),
-    xdmf_hdf5_output(xdmf_hdf5_output)
+    xdmf_hdf5_output(xdmf_hdf5_output),
+    single_precision(single_precision)
   {}
 
 
@@ -1800,6 +1900,11 @@ namespace DataOutBase
     prm.declare_entry ("XDMF HDF5 output", "false",
                        Patterns::Bool(),
                        "Whether the data will be used in an XDMF/HDF5 combination.");
+    prm.declare_entry ("Single precision", "false",
+                       Patterns::Bool(),
+                       "Whether to store node coordinates and data sets as single "
+                       "precision numbers in HDF5 files, which halves the size of "
+                       "the files.");
   }
 
 
@@ -1808,6 +1913,7 @@ namespace DataOutBase
   {
     filter_duplicate_vertices = prm.get_bool ("Filter duplicate vertices");
     xdmf_hdf5_output = prm.get_bool ("XDMF HDF5 output");
+    single_precision = prm.get_bool ("Single precision");
   }
 
 
@@ -2186,12 +2292,16 @@ namespace DataOutBase
   VtkFlags::VtkFlags (const double time,
                       const unsigned int cycle,
                       const bool print_date_and_time,
-                      const VtkFlags::ZlibCompressionLevel compression_level)
+                      const VtkFlags::ZlibCompressionLevel compression_level,
+                      const bool filter_duplicate_vertices,
+                      const bool single_precision)
     :
     time (time),
     cycle (cycle),
     print_date_and_time (print_date_and_time),
-    compression_level (compression_level)
+    compression_level (compression_level),
+    filter_duplicate_vertices (filter_duplicate_vertices),
+    single_precision (single_precision)
   {}
 
 
@@ -5125,6 +5235,8 @@ namespace DataOutBase
   {
     AssertThrow (out, ExcIO());
 
+    const char *float_type = flags.single_precision ? "Float32" : "Float64";
+
 #ifndef DEAL_II_WITH_MPI
     // verify that there are indeed
     // patches to be written out. most
@@ -5166,7 +5278,7 @@ namespace DataOutBase
             // component names with double
             // underscores unless a vector
             // name has been specified
-            out << "    <DataArray type=\"Float64\" Name=\"";
+            out << "    <DataArray type=\"" << float_type << "\" Name=\"";
 
             if (std::get<2>(vector_data_ranges[n_th_vector]) != "")
               out << std::get<2>(vector_data_ranges[n_th_vector]);
@@ -5185,7 +5297,7 @@ namespace DataOutBase
         for (unsigned int data_set=0; data_set<data_names.size(); ++data_set)
           if (data_set_written[data_set] == false)
             {
-              out << "    <DataArray type=\"Float64\" Name=\""
+              out << "    <DataArray type=\"" << float_type << "\" Name=\""
                   << data_names[data_set]
                   << "\"></DataArray>\n";
             }
@@ -5287,6 +5399,17 @@ namespace DataOutBase
     Threads::Task<> reorder_task = Threads::new_task (fun_ptr, patches,
                                                       data_vectors);
 
+    // if duplicate vertices are to be removed, let a DataOutFilter find
+    // the unique points and the numbering of the cell vertices in terms of
+    // them
+    DataOutFilter filter (DataOutFilterFlags(true, false));
+    if (flags.filter_duplicate_vertices)
+      {
+        write_nodes(patches, filter);
+        write_cells(patches, filter);
+        n_nodes = filter.n_nodes();
+      }
+
     ///////////////////////////////
     // first make up a list of used
     // vertices along with their
@@ -5298,9 +5421,21 @@ namespace DataOutBase
     out << "<Piece NumberOfPoints=\"" << n_nodes
         <<"\" NumberOfCells=\"" << n_cells << "\" >\n";
     out << "  <Points>\n";
-    out << "    <DataArray type=\"Float64\" NumberOfComponents=\"3\" format=\""
+    out << "    <DataArray type=\"" << float_type << "\" NumberOfComponents=\"3\" format=\""
         << ascii_or_binary << "\">\n";
-    write_nodes(patches, vtu_out);
+    if (flags.filter_duplicate_vertices)
+      {
+        std::vector<double> node_data;
+        filter.fill_node_data (node_data);
+        std::vector<double> points (3*n_nodes, 0.);
+        for (unsigned int n=0; n<n_nodes; ++n)
+          for (unsigned int d=0; d<spacedim; ++d)
+            points[3*n+d] = node_data[spacedim*n+d];
+        vtu_out.write_float_data (points);
+        out << '\n';
+      }
+    else
+      write_nodes(patches, vtu_out);
     out << "    </DataArray>\n";
     out << "  </Points>\n\n";
     /////////////////////////////////
@@ -5308,7 +5443,15 @@ namespace DataOutBase
     out << "  <Cells>\n";
     out << "    <DataArray type=\"Int32\" Name=\"connectivity\" format=\""
         << ascii_or_binary << "\">\n";
-    write_cells(patches, vtu_out);
+    if (flags.filter_duplicate_vertices)
+      {
+        std::vector<unsigned int> cell_data;
+        filter.fill_cell_data (0, cell_data);
+        vtu_out << std::vector<int32_t> (cell_data.begin(), cell_data.end());
+        out << '\n';
+      }
+    else
+      write_cells(patches, vtu_out);
     out << "    </DataArray>\n";
 
     // XML VTU format uses offsets; this is
@@ -5358,6 +5501,20 @@ namespace DataOutBase
     // data is in place
     reorder_task.join ();
 
+    // with filtered vertices, keep the values of one of the patches at
+    // each point
+    if (flags.filter_duplicate_vertices)
+      {
+        for (unsigned int data_set=0; data_set<n_data_sets; ++data_set)
+          filter.write_data_set (data_names[data_set], 1, data_set, data_vectors);
+        Table<2,double> filtered_data_vectors (n_data_sets, n_nodes);
+        for (unsigned int data_set=0; data_set<n_data_sets; ++data_set)
+          std::copy (filter.get_data_set(data_set),
+                     filter.get_data_set(data_set) + n_nodes,
+                     &filtered_data_vectors[data_set][0]);
+        data_vectors.swap (filtered_data_vectors);
+      }
+
     // then write data.  the
     // 'POINT_DATA' means: node data
     // (as opposed to cell data, which
@@ -5397,7 +5554,7 @@ namespace DataOutBase
         // component names with double
         // underscores unless a vector
         // name has been specified
-        out << "    <DataArray type=\"Float64\" Name=\"";
+        out << "    <DataArray type=\"" << float_type << "\" Name=\"";
 
         if (std::get<2>(vector_data_ranges[n_th_vector]) != "")
           out << std::get<2>(vector_data_ranges[n_th_vector]);
@@ -5451,7 +5608,7 @@ namespace DataOutBase
                 Assert (false, ExcInternalError());
               }
           }
-        vtu_out << data;
+        vtu_out.write_float_data (data);
         out << "    </DataArray>\n";
       }
 
@@ -5459,14 +5616,14 @@ namespace DataOutBase
     for (unsigned int data_set=0; data_set<n_data_sets; ++data_set)
       if (data_set_written[data_set] == false)
         {
-          out << "    <DataArray type=\"Float64\" Name=\""
+          out << "    <DataArray type=\"" << float_type << "\" Name=\""
               << data_names[data_set]
               << "\" format=\""
               << ascii_or_binary << "\">\n";
 
           std::vector<double> data (data_vectors[data_set].begin(),
                                     data_vectors[data_set].end());
-          vtu_out << data;
+          vtu_out.write_float_data (data);
           out << "    </DataArray>\n";
         }
 
@@ -5489,11 +5646,13 @@ namespace DataOutBase
   write_pvtu_record (std::ostream                                                                  &out,
                      const std::vector<std::string>                                                &piece_names,
                      const std::vector<std::string>                                                &data_names,
-                     const std::vector<std::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges)
+                     const std::vector<std::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
+                     const VtkFlags                                                                &flags)
   {
     AssertThrow (out, ExcIO());
 
     const unsigned int n_data_sets = data_names.size();
+    const char *float_type = flags.single_precision ? "Float32" : "Float64";
 
     out << "<?xml version=\"1.0\"?>\n";
 
@@ -5536,7 +5695,7 @@ namespace DataOutBase
         // component names with double
         // underscores unless a vector
         // name has been specified
-        out << "    <PDataArray type=\"Float64\" Name=\"";
+        out << "    <PDataArray type=\"" << float_type << "\" Name=\"";
 
         if (std::get<2>(vector_data_ranges[n_th_vector]) != "")
           out << std::get<2>(vector_data_ranges[n_th_vector]);
@@ -5555,7 +5714,7 @@ namespace DataOutBase
     for (unsigned int data_set=0; data_set<n_data_sets; ++data_set)
       if (data_set_written[data_set] == false)
         {
-          out << "    <PDataArray type=\"Float64\" Name=\""
+          out << "    <PDataArray type=\"" << float_type << "\" Name=\""
               << data_names[data_set]
               << "\" format=\"ascii\"/>\n";
         }
@@ -5563,7 +5722,7 @@ namespace DataOutBase
     out << "    </PPointData>\n";
 
     out << "    <PPoints>\n";
-    out << "      <PDataArray type=\"Float64\" NumberOfComponents=\"3\"/>\n";
+    out << "      <PDataArray type=\"" << float_type << "\" NumberOfComponents=\"3\"/>\n";
     out << "    </PPoints>\n";
 
     for (unsigned int i=0; i<piece_names.size(); ++i)
@@ -6583,6 +6742,124 @@ void DataOutInterface<dim,spacedim>::write_vtu_in_parallel (const char *filename
 }
 
 
+template <int dim, int spacedim>
+std::string
+DataOutInterface<dim,spacedim>::
+write_vtu_with_pvtu_record (const std::string  &directory,
+                            const std::string  &filename_without_extension,
+                            const unsigned int  counter,
+                            const MPI_Comm     &mpi_communicator,
+                            const unsigned int  n_digits_for_counter,
+                            const unsigned int  n_groups) const
+{
+  const unsigned int rank = Utilities::MPI::this_mpi_process(mpi_communicator);
+  const unsigned int n_ranks = Utilities::MPI::n_mpi_processes(mpi_communicator);
+  const unsigned int n_files = ((n_groups == 0 || n_groups > n_ranks) ?
+                                n_ranks : n_groups);
+
+  // use groups of consecutive ranks
+  const unsigned int group =
+    static_cast<unsigned int>((static_cast<unsigned long long>(rank) * n_files) /
+                              n_ranks);
+
+  const std::string base_name = filename_without_extension + "_" +
+                                Utilities::int_to_string(counter, n_digits_for_counter);
+  const unsigned int n_digits_for_group = Utilities::needed_digits(n_files-1);
+  const std::string filename = base_name + "." +
+                               Utilities::int_to_string(group, n_digits_for_group) +
+                               ".vtu";
+
+  if (n_files == n_ranks)
+    {
+      std::ofstream output((directory + filename).c_str());
+      AssertThrow (output, ExcIO());
+      write_vtu (output);
+    }
+  else
+    {
+#ifdef DEAL_II_WITH_MPI
+      MPI_Comm group_communicator;
+      int ierr = MPI_Comm_split(mpi_communicator, group, rank,
+                                &group_communicator);
+      AssertThrowMPI(ierr);
+      const unsigned int group_rank =
+        Utilities::MPI::this_mpi_process(group_communicator);
+      const unsigned int group_size =
+        Utilities::MPI::n_mpi_processes(group_communicator);
+
+      std::stringstream piece;
+      DataOutBase::write_vtu_main (get_patches(), get_dataset_names(),
+                                   get_vector_data_ranges(),
+                                   vtk_flags, piece);
+      const std::string piece_data = piece.str();
+
+      const int piece_tag = 1;
+      if (group_rank == 0)
+        {
+          std::ofstream output((directory + filename).c_str());
+          AssertThrow (output, ExcIO());
+          DataOutBase::write_vtu_header(output, vtk_flags);
+          output << piece_data;
+
+          // receive the pieces of the other processes in the group one
+          // after the other and write them in rank order
+          std::vector<char> buffer;
+          for (unsigned int p=1; p<group_size; ++p)
+            {
+              MPI_Status status;
+              ierr = MPI_Probe(p, piece_tag, group_communicator, &status);
+              AssertThrowMPI(ierr);
+              int size = 0;
+              ierr = MPI_Get_count(&status, MPI_CHAR, &size);
+              AssertThrowMPI(ierr);
+              buffer.resize(size);
+              ierr = MPI_Recv(buffer.data(), size, MPI_CHAR, p, piece_tag,
+                              group_communicator, MPI_STATUS_IGNORE);
+              AssertThrowMPI(ierr);
+              output.write(buffer.data(), size);
+            }
+
+          DataOutBase::write_vtu_footer(output);
+          AssertThrow (output, ExcIO());
+        }
+      else
+        {
+          AssertThrow (piece_data.size() <
+                       static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                       ExcMessage("The output of a single process is too large "
+                                  "to be sent as one MPI message."));
+          ierr = MPI_Send(const_cast<char *>(piece_data.data()), piece_data.size(),
+                          MPI_CHAR, 0, piece_tag, group_communicator);
+          AssertThrowMPI(ierr);
+        }
+
+      ierr = MPI_Comm_free(&group_communicator);
+      AssertThrowMPI(ierr);
+#else
+      // without MPI, there is only one process which writes its own file
+      Assert (false, ExcInternalError());
+#endif
+    }
+
+  const std::string pvtu_filename = base_name + ".pvtu";
+  if (rank == 0)
+    {
+      std::vector<std::string> piece_names;
+      for (unsigned int i=0; i<n_files; ++i)
+        piece_names.push_back(base_name + "." +
+                              Utilities::int_to_string(i, n_digits_for_group) +
+                              ".vtu");
+
+      std::ofstream pvtu_output((directory + pvtu_filename).c_str());
+      AssertThrow (pvtu_output, ExcIO());
+      write_pvtu_record(pvtu_output, piece_names);
+    }
+
+  return pvtu_filename;
+}
+
+
+
 template <int dim, int spacedim>
 void
 DataOutInterface<dim,spacedim>::write_pvtu_record (std::ostream &out,
@@ -6591,7 +6868,8 @@ DataOutInterface<dim,spacedim>::write_pvtu_record (std::ostream &out,
   DataOutBase::write_pvtu_record(out,
                                  piece_names,
                                  get_dataset_names(),
-                                 get_vector_data_ranges());
+                                 get_vector_data_ranges(),
+                                 vtk_flags);
 }
 
 
@@ -6623,6 +6901,21 @@ create_xdmf_entry (const DataOutBase::DataOutFilter &data_filter,
                    const std::string &h5_solution_filename,
                    const double cur_time,
                    MPI_Comm comm) const
+{
+  return create_xdmf_entry(data_filter, h5_mesh_filename, h5_solution_filename, "", "", cur_time, comm);
+}
+
+
+
+template <int dim, int spacedim>
+XDMFEntry DataOutInterface<dim,spacedim>::
+create_xdmf_entry (const DataOutBase::DataOutFilter &data_filter,
+                   const std::string &h5_mesh_filename,
+                   const std::string &h5_solution_filename,
+                   const std::string &h5_mesh_group_name,
+                   const std::string &h5_solution_group_name,
+                   const double cur_time,
+                   MPI_Comm comm) const
 {
   unsigned int    local_node_cell_count[2], global_node_cell_count[2];
   int             myrank;
@@ -6634,6 +6927,8 @@ create_xdmf_entry (const DataOutBase::DataOutFilter &data_filter,
   (void)data_filter;
   (void)h5_mesh_filename;
   (void)h5_solution_filename;
+  (void)h5_mesh_group_name;
+  (void)h5_solution_group_name;
   (void)cur_time;
   (void)comm;
   AssertThrow(false, ExcMessage ("XDMF support requires HDF5 to be turned on."));
@@ -6659,7 +6954,10 @@ create_xdmf_entry (const DataOutBase::DataOutFilter &data_filter,
   // Output the XDMF file only on the root process
   if (myrank == 0)
     {
-      XDMFEntry       entry(h5_mesh_filename, h5_solution_filename, cur_time, global_node_cell_count[0], global_node_cell_count[1], dim, spacedim);
+      XDMFEntry       entry(h5_mesh_filename, h5_solution_filename, h5_mesh_group_name, h5_solution_group_name,
+                            cur_time, global_node_cell_count[0], global_node_cell_count[1], dim, spacedim);
+      if (data_filter.get_flags().single_precision)
+        entry.set_precision(4);
       unsigned int  n_data_sets = data_filter.n_data_sets();
 
       // The vector names generated here must match those generated in the HDF5 file
@@ -6732,6 +7030,43 @@ write_filtered_data (DataOutBase::DataOutFilter &filtered_data) const
                                    filtered_data);
 }
 
+template <int dim, int spacedim>
+void DataOutInterface<dim,spacedim>::
+write_in_situ (DataOutBase::InSituAdaptor &adaptor,
+               const unsigned int          step,
+               const double                time) const
+{
+  DataOutBase::write_in_situ(get_patches(), get_dataset_names(),
+                             get_vector_data_ranges(), step, time,
+                             adaptor);
+}
+
+
+
+template <int dim, int spacedim>
+void DataOutBase::write_in_situ (const std::vector<Patch<dim,spacedim> > &patches,
+                                 const std::vector<std::string>          &data_names,
+                                 const std::vector<std::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
+                                 const unsigned int                       step,
+                                 const double                             time,
+                                 InSituAdaptor                           &adaptor)
+{
+  if (adaptor.is_output_step(step) == false)
+    return;
+
+  DataOutFilter data_filter (adaptor.get_filter_flags());
+  write_filtered_data (patches, data_names, vector_data_ranges, data_filter);
+
+  std::vector<double> node_data;
+  std::vector<unsigned int> cell_data;
+  data_filter.fill_node_data (node_data);
+  data_filter.fill_cell_data (0, cell_data);
+
+  adaptor.execute (step, time, data_filter, node_data, cell_data);
+}
+
+
+
 template <int dim, int spacedim>
 void DataOutBase::write_filtered_data (const std::vector<Patch<dim,spacedim> > &patches,
                                        const std::vector<std::string>          &data_names,
@@ -6850,6 +7185,18 @@ write_hdf5_parallel (const DataOutBase::DataOutFilter &data_filter,
 
 
 
+template <int dim, int spacedim>
+void DataOutInterface<dim,spacedim>::
+write_hdf5_parallel (const DataOutBase::DataOutFilter &data_filter,
+                     const bool write_mesh_file, const std::string &mesh_filename, const std::string &solution_filename,
+                     const std::string &mesh_group_name, const std::string &solution_group_name, MPI_Comm comm) const
+{
+  DataOutBase::write_hdf5_parallel(get_patches(), data_filter, write_mesh_file, mesh_filename, solution_filename,
+                                   mesh_group_name, solution_group_name, comm);
+}
+
+
+
 template <int dim, int spacedim>
 void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &patches,
                                        const DataOutBase::DataOutFilter &data_filter,
@@ -6861,12 +7208,96 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
 
 
 
+template <int dim, int spacedim>
+void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &patches,
+                                       const DataOutBase::DataOutFilter &data_filter,
+                                       const bool write_mesh_file,
+                                       const std::string &mesh_filename,
+                                       const std::string &solution_filename,
+                                       MPI_Comm comm)
+{
+  write_hdf5_parallel(patches, data_filter, write_mesh_file, mesh_filename, solution_filename, "", "", comm);
+}
+
+
+
+#ifdef DEAL_II_WITH_HDF5
+namespace
+{
+  /**
+   * Open the HDF5 file with the given name. If @p append is true and the
+   * file already exists, it is opened for writing while keeping its
+   * contents. Otherwise, any existing file is overwritten. The existence of
+   * the file is determined on the root process only, since the processes
+   * must agree on whether to open or to create the file.
+   */
+  hid_t open_hdf5_file (const std::string &filename,
+                        const bool         append,
+                        const hid_t        file_plist_id,
+                        MPI_Comm           comm)
+  {
+    int file_exists = 0;
+    if (append)
+      {
+        if (Utilities::MPI::this_mpi_process(comm) == 0)
+          file_exists = static_cast<bool>(std::ifstream(filename.c_str()));
+#ifdef DEAL_II_WITH_MPI
+        const int ierr = MPI_Bcast(&file_exists, 1, MPI_INT, 0, comm);
+        AssertThrowMPI(ierr);
+#endif
+      }
+
+    const hid_t file_id = (file_exists ?
+                           H5Fopen(filename.c_str(), H5F_ACC_RDWR, file_plist_id) :
+                           H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, file_plist_id));
+    AssertThrow(file_id >= 0, ExcIO());
+    return file_id;
+  }
+
+
+
+  /**
+   * Open the group with the given name in an HDF5 file, creating it if it
+   * does not exist yet.
+   */
+  hid_t open_hdf5_group (const hid_t        file_id,
+                         const std::string &group_name)
+  {
+    Assert(group_name.find('/') == std::string::npos,
+           ExcMessage("HDF5 group names for DataOutBase must not contain slashes."));
+
+    const htri_t group_exists = H5Lexists(file_id, group_name.c_str(), H5P_DEFAULT);
+    AssertThrow(group_exists >= 0, ExcIO());
+
+    hid_t group_id;
+    if (group_exists > 0)
+#if H5Gopen_vers == 1
+      group_id = H5Gopen(file_id, group_name.c_str());
+#else
+      group_id = H5Gopen(file_id, group_name.c_str(), H5P_DEFAULT);
+#endif
+    else
+#if H5Gcreate_vers == 1
+      group_id = H5Gcreate(file_id, group_name.c_str(), 0);
+#else
+      group_id = H5Gcreate(file_id, group_name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+#endif
+    AssertThrow(group_id >= 0, ExcIO());
+    return group_id;
+  }
+}
+#endif
+
+
+
 template <int dim, int spacedim>
 void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &/*patches*/,
                                        const DataOutBase::DataOutFilter &data_filter,
                                        const bool write_mesh_file,
                                        const std::string &mesh_filename,
                                        const std::string &solution_filename,
+                                       const std::string &mesh_group_name,
+                                       const std::string &solution_group_name,
                                        MPI_Comm comm)
 {
 
@@ -6883,9 +7314,16 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
   (void)write_mesh_file;
   (void)mesh_filename;
   (void)solution_filename;
+  (void)mesh_group_name;
+  (void)solution_group_name;
   (void)comm;
   AssertThrow(false, ExcMessage ("HDF5 support is disabled."));
 #else
+  // the type of the floating point numbers in the file, the data in memory
+  // is converted accordingly before writing
+  const hid_t file_float_type = (data_filter.get_flags().single_precision ?
+                                 H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE);
+
 #ifndef DEAL_II_WITH_MPI
   // verify that there are indeed patches to be written out.
   // most of the times, people just forget to call build_patches when there
@@ -6897,7 +7335,7 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
   (void)comm;
 #endif
 
-  hid_t           h5_mesh_file_id=-1, h5_solution_file_id, file_plist_id, plist_id;
+  hid_t           h5_mesh_file_id=-1, h5_solution_file_id, h5_mesh_location_id=-1, h5_solution_location_id, file_plist_id, plist_id;
   hid_t           node_dataspace, node_dataset, node_file_dataspace, node_memory_dataspace;
   hid_t           cell_dataspace, cell_dataset, cell_file_dataspace, cell_memory_dataspace;
   hid_t           pt_data_dataspace, pt_data_dataset, pt_data_file_dataspace, pt_data_memory_dataspace;
@@ -6960,9 +7398,12 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
 
   if (write_mesh_file)
     {
-      // Overwrite any existing files (change this to an option?)
-      h5_mesh_file_id = H5Fcreate(mesh_filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, file_plist_id);
-      AssertThrow(h5_mesh_file_id >= 0, ExcIO());
+      // Overwrite any existing files, unless the mesh is placed in a group
+      // of a file that we append to
+      h5_mesh_file_id = open_hdf5_file(mesh_filename, !mesh_group_name.empty(), file_plist_id, comm);
+      h5_mesh_location_id = (mesh_group_name.empty() ?
+                             h5_mesh_file_id :
+                             open_hdf5_group(h5_mesh_file_id, mesh_group_name));
 
       // Create the dataspace for the nodes and cells
       // HDF5 only supports 2- or 3-dimensional coordinates
@@ -6978,15 +7419,15 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
 
       // Create the dataset for the nodes and cells
 #if H5Gcreate_vers == 1
-      node_dataset = H5Dcreate(h5_mesh_file_id, "nodes", H5T_NATIVE_DOUBLE, node_dataspace, H5P_DEFAULT);
+      node_dataset = H5Dcreate(h5_mesh_location_id, "nodes", file_float_type, node_dataspace, H5P_DEFAULT);
 #else
-      node_dataset = H5Dcreate(h5_mesh_file_id, "nodes", H5T_NATIVE_DOUBLE, node_dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      node_dataset = H5Dcreate(h5_mesh_location_id, "nodes", file_float_type, node_dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 #endif
       AssertThrow(node_dataset >= 0, ExcIO());
 #if H5Gcreate_vers == 1
-      cell_dataset = H5Dcreate(h5_mesh_file_id, "cells", H5T_NATIVE_UINT, cell_dataspace, H5P_DEFAULT);
+      cell_dataset = H5Dcreate(h5_mesh_location_id, "cells", H5T_NATIVE_UINT, cell_dataspace, H5P_DEFAULT);
 #else
-      cell_dataset = H5Dcreate(h5_mesh_file_id, "cells", H5T_NATIVE_UINT, cell_dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      cell_dataset = H5Dcreate(h5_mesh_location_id, "cells", H5T_NATIVE_UINT, cell_dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 #endif
       AssertThrow(cell_dataset >= 0, ExcIO());
 
@@ -7028,7 +7469,13 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
 
       // And finally, write the node data
       data_filter.fill_node_data(node_data_vec);
-      status = H5Dwrite(node_dataset, H5T_NATIVE_DOUBLE, node_memory_dataspace, node_file_dataspace, plist_id, node_data_vec.data());
+      if (data_filter.get_flags().single_precision)
+        {
+          const std::vector<float> node_data_float(node_data_vec.begin(), node_data_vec.end());
+          status = H5Dwrite(node_dataset, H5T_NATIVE_FLOAT, node_memory_dataspace, node_file_dataspace, plist_id, node_data_float.data());
+        }
+      else
+        status = H5Dwrite(node_dataset, H5T_NATIVE_DOUBLE, node_memory_dataspace, node_file_dataspace, plist_id, node_data_vec.data());
       AssertThrow(status >= 0, ExcIO());
       node_data_vec.clear();
 
@@ -7056,6 +7503,12 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
       status = H5Dclose(cell_dataset);
       AssertThrow(status >= 0, ExcIO());
 
+      if (h5_mesh_location_id != h5_mesh_file_id)
+        {
+          status = H5Gclose(h5_mesh_location_id);
+          AssertThrow(status >= 0, ExcIO());
+        }
+
       // If the filenames are different, we need to close the mesh file
       if (mesh_filename != solution_filename)
         {
@@ -7071,10 +7524,13 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
     }
   else
     {
-      // Otherwise we need to open a new file
-      h5_solution_file_id = H5Fcreate(solution_filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, file_plist_id);
-      AssertThrow(h5_solution_file_id >= 0, ExcIO());
+      // Otherwise we need to open a new file, or append to an existing one
+      // if the solution is placed in a group
+      h5_solution_file_id = open_hdf5_file(solution_filename, !solution_group_name.empty(), file_plist_id, comm);
     }
+  h5_solution_location_id = (solution_group_name.empty() ?
+                             h5_solution_file_id :
+                             open_hdf5_group(h5_solution_file_id, solution_group_name));
 
   // when writing, first write out
   // all vector data, then handle the
@@ -7096,9 +7552,9 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
       AssertThrow(pt_data_dataspace >= 0, ExcIO());
 
 #if H5Gcreate_vers == 1
-      pt_data_dataset = H5Dcreate(h5_solution_file_id, vector_name.c_str(), H5T_NATIVE_DOUBLE, pt_data_dataspace, H5P_DEFAULT);
+      pt_data_dataset = H5Dcreate(h5_solution_location_id, vector_name.c_str(), file_float_type, pt_data_dataspace, H5P_DEFAULT);
 #else
-      pt_data_dataset = H5Dcreate(h5_solution_file_id, vector_name.c_str(), H5T_NATIVE_DOUBLE, pt_data_dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      pt_data_dataset = H5Dcreate(h5_solution_location_id, vector_name.c_str(), file_float_type, pt_data_dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 #endif
       AssertThrow(pt_data_dataset >= 0, ExcIO());
 
@@ -7117,7 +7573,14 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
       AssertThrow(status >= 0, ExcIO());
 
       // And finally, write the data
-      status = H5Dwrite(pt_data_dataset, H5T_NATIVE_DOUBLE, pt_data_memory_dataspace, pt_data_file_dataspace, plist_id, data_filter.get_data_set(i));
+      if (data_filter.get_flags().single_precision)
+        {
+          const double *data = data_filter.get_data_set(i);
+          const std::vector<float> data_float(data, data + local_node_cell_count[0]*pt_data_vector_dim);
+          status = H5Dwrite(pt_data_dataset, H5T_NATIVE_FLOAT, pt_data_memory_dataspace, pt_data_file_dataspace, plist_id, data_float.data());
+        }
+      else
+        status = H5Dwrite(pt_data_dataset, H5T_NATIVE_DOUBLE, pt_data_memory_dataspace, pt_data_file_dataspace, plist_id, data_filter.get_data_set(i));
       AssertThrow(status >= 0, ExcIO());
 
       // Close the dataspaces
@@ -7132,6 +7595,12 @@ void DataOutBase::write_hdf5_parallel (const std::vector<Patch<dim,spacedim> > &
       AssertThrow(status >= 0, ExcIO());
     }
 
+  if (h5_solution_location_id != h5_solution_file_id)
+    {
+      status = H5Gclose(h5_solution_location_id);
+      AssertThrow(status >= 0, ExcIO());
+    }
+
   // Close the file property list
   status = H5Pclose(file_plist_id);
   AssertThrow(status >= 0, ExcIO());
@@ -7661,11 +8130,14 @@ XDMFEntry::XDMFEntry()
   valid(false),
   h5_sol_filename(""),
   h5_mesh_filename(""),
+  h5_sol_group_name(""),
+  h5_mesh_group_name(""),
   entry_time(0.0),
   num_nodes(numbers::invalid_unsigned_int),
   num_cells(numbers::invalid_unsigned_int),
   dimension(numbers::invalid_unsigned_int),
-  space_dimension(numbers::invalid_unsigned_int)
+  space_dimension(numbers::invalid_unsigned_int),
+  precision(8)
 {}
 
 
@@ -7713,14 +8185,40 @@ XDMFEntry::XDMFEntry(const std::string &mesh_filename,
                      const unsigned int dim,
                      const unsigned int spacedim)
   :
+  XDMFEntry(mesh_filename,
+            solution_filename,
+            "",
+            "",
+            time,
+            nodes,
+            cells,
+            dim,
+            spacedim)
+{}
+
+
+
+XDMFEntry::XDMFEntry(const std::string &mesh_filename,
+                     const std::string &solution_filename,
+                     const std::string &mesh_group_name,
+                     const std::string &solution_group_name,
+                     const double time,
+                     const unsigned int nodes,
+                     const unsigned int cells,
+                     const unsigned int dim,
+                     const unsigned int spacedim)
+  :
   valid(true),
   h5_sol_filename(solution_filename),
   h5_mesh_filename(mesh_filename),
+  h5_sol_group_name(solution_group_name),
+  h5_mesh_group_name(mesh_group_name),
   entry_time(time),
   num_nodes(nodes),
   num_cells(cells),
   dimension(dim),
-  space_dimension(spacedim)
+  space_dimension(spacedim),
+  precision(8)
 {}
 
 
@@ -7733,6 +8231,17 @@ XDMFEntry::add_attribute(const std::string &attr_name, const unsigned int dimens
 
 
 
+void
+XDMFEntry::set_precision(const unsigned int n_bytes)
+{
+  Assert (n_bytes == 4 || n_bytes == 8,
+          ExcMessage("Only single (4 bytes) and double (8 bytes) precision "
+                     "are supported."));
+  precision = n_bytes;
+}
+
+
+
 namespace
 {
   /**
@@ -7745,6 +8254,16 @@ namespace
       res += "  ";
     return res;
   }
+
+
+
+  /**
+   * Return the path prefix of the datasets in the given HDF5 group.
+   */
+  std::string hdf5_group_prefix(const std::string &group_name)
+  {
+    return (group_name.empty() ? std::string() : group_name + "/");
+  }
 }
 
 
@@ -7758,8 +8277,8 @@ std::string XDMFEntry::get_xdmf_content(const unsigned int indent_level) const
   ss << indent(indent_level+0) << "<Grid Name=\"mesh\" GridType=\"Uniform\">\n";
   ss << indent(indent_level+1) << "<Time Value=\"" << entry_time << "\"/>\n";
   ss << indent(indent_level+1) << "<Geometry GeometryType=\"" << (space_dimension <= 2 ? "XY" : "XYZ" ) << "\">\n";
-  ss << indent(indent_level+2) << "<DataItem Dimensions=\"" << num_nodes << " " << (space_dimension <= 2 ? 2 : space_dimension) << "\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">\n";
-  ss << indent(indent_level+3) << h5_mesh_filename << ":/nodes\n";
+  ss << indent(indent_level+2) << "<DataItem Dimensions=\"" << num_nodes << " " << (space_dimension <= 2 ? 2 : space_dimension) << "\" NumberType=\"Float\" Precision=\"" << precision << "\" Format=\"HDF\">\n";
+  ss << indent(indent_level+3) << h5_mesh_filename << ":/" << hdf5_group_prefix(h5_mesh_group_name) << "nodes\n";
   ss << indent(indent_level+2) << "</DataItem>\n";
   ss << indent(indent_level+1) << "</Geometry>\n";
   // If we have cells defined, use the topology corresponding to the dimension
@@ -7775,7 +8294,7 @@ std::string XDMFEntry::get_xdmf_content(const unsigned int indent_level) const
         ss << indent(indent_level+1) << "<Topology TopologyType=\"" << "Hexahedron"   << "\" NumberOfElements=\"" << num_cells << "\">\n";
 
       ss << indent(indent_level+2) << "<DataItem Dimensions=\"" << num_cells << " " << (1 << dimension) << "\" NumberType=\"UInt\" Format=\"HDF\">\n";
-      ss << indent(indent_level+3) << h5_mesh_filename << ":/cells\n";
+      ss << indent(indent_level+3) << h5_mesh_filename << ":/" << hdf5_group_prefix(h5_mesh_group_name) << "cells\n";
       ss << indent(indent_level+2) << "</DataItem>\n";
       ss << indent(indent_level+1) << "</Topology>\n";
     }
@@ -7791,8 +8310,8 @@ std::string XDMFEntry::get_xdmf_content(const unsigned int indent_level) const
     {
       ss << indent(indent_level+1) << "<Attribute Name=\"" << it->first << "\" AttributeType=\"" << (it->second > 1 ? "Vector" : "Scalar") << "\" Center=\"Node\">\n";
       // Vectors must have 3 elements even for 2D models
-      ss << indent(indent_level+2) << "<DataItem Dimensions=\"" << num_nodes << " " << (it->second > 1 ? 3 : 1) << "\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">\n";
-      ss << indent(indent_level+3) << h5_sol_filename << ":/" << it->first << "\n";
+      ss << indent(indent_level+2) << "<DataItem Dimensions=\"" << num_nodes << " " << (it->second > 1 ? 3 : 1) << "\" NumberType=\"Float\" Precision=\"" << precision << "\" Format=\"HDF\">\n";
+      ss << indent(indent_level+3) << h5_sol_filename << ":/" << hdf5_group_prefix(h5_sol_group_name) << it->first << "\n";
       ss << indent(indent_level+2) << "</DataItem>\n";
       ss << indent(indent_level+1) << "</Attribute>\n";
     }
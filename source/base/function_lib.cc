@@ -18,6 +18,7 @@
 #include <deal.II/base/point.h>
 #include <deal.II/base/function_lib.h>
 #include <deal.II/base/function_bessel.h>
+#include <deal.II/base/vectorization.h>
 #include <deal.II/lac/vector.h>
 
 #include <cmath>
@@ -38,6 +39,19 @@ namespace Functions
   }
 
 
+
+  template <int dim>
+  VectorizedArray<double>
+  SquareFunction<dim>::vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                                         const unsigned int) const
+  {
+    VectorizedArray<double> result = p[0] * p[0];
+    for (unsigned int d=1; d<dim; ++d)
+      result += p[d] * p[d];
+    return result;
+  }
+
+
   template <int dim>
   void
   SquareFunction<dim>::vector_value (const Point<dim>   &p,
@@ -138,6 +152,17 @@ namespace Functions
 
 
 
+  template <int dim>
+  VectorizedArray<double>
+  Q1WedgeFunction<dim>::vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                                          const unsigned int) const
+  {
+    Assert (dim>=2, ExcInternalError());
+    return p[0]*p[dim>1 ? 1 : 0];
+  }
+
+
+
   template <int dim>
   void
   Q1WedgeFunction<dim>::value_list (const std::vector<Point<dim> > &points,
@@ -282,6 +307,19 @@ namespace Functions
     return 0.;
   }
 
+
+
+  template <int dim>
+  VectorizedArray<double>
+  PillowFunction<dim>::vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                                         const unsigned int) const
+  {
+    VectorizedArray<double> result = 1. - p[0]*p[0];
+    for (unsigned int d=1; d<dim; ++d)
+      result *= 1. - p[d]*p[d];
+    return result + offset;
+  }
+
   template <int dim>
   void
   PillowFunction<dim>::value_list (const std::vector<Point<dim> > &points,
@@ -452,6 +490,19 @@ namespace Functions
     return 0.;
   }
 
+
+
+  template <int dim>
+  VectorizedArray<double>
+  CosineFunction<dim>::vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                                         const unsigned int) const
+  {
+    VectorizedArray<double> result = std::cos(numbers::PI_2*p[0]);
+    for (unsigned int d=1; d<dim; ++d)
+      result *= std::cos(numbers::PI_2*p[d]);
+    return result;
+  }
+
   template <int dim>
   void
   CosineFunction<dim>::value_list (const std::vector<Point<dim> > &points,
@@ -959,6 +1010,19 @@ namespace Functions
     return 0.;
   }
 
+
+
+  template <int dim>
+  VectorizedArray<double>
+  ExpFunction<dim>::vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                                      const unsigned int) const
+  {
+    VectorizedArray<double> sum = p[0];
+    for (unsigned int d=1; d<dim; ++d)
+      sum += p[d];
+    return std::exp(sum);
+  }
+
   template <int dim>
   void
   ExpFunction<dim>::value_list (const std::vector<Point<dim> > &points,
@@ -1844,6 +1908,21 @@ namespace Functions
 
 
 
+  template <int dim>
+  VectorizedArray<double>
+  FourierCosineFunction<dim>::vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                                                const unsigned int                         component) const
+  {
+    (void)component;
+    Assert (component==0, ExcIndexRange(component,0,1));
+    VectorizedArray<double> argument = fourier_coefficients[0] * p[0];
+    for (unsigned int d=1; d<dim; ++d)
+      argument += fourier_coefficients[d] * p[d];
+    return std::cos(argument);
+  }
+
+
+
   template <int dim>
   Tensor<1,dim>
   FourierCosineFunction<dim>::gradient (const Point<dim>   &p,
@@ -1895,6 +1974,21 @@ namespace Functions
 
 
 
+  template <int dim>
+  VectorizedArray<double>
+  FourierSineFunction<dim>::vectorized_value (const Point<dim,VectorizedArray<double> > &p,
+                                              const unsigned int                         component) const
+  {
+    (void)component;
+    Assert (component==0, ExcIndexRange(component,0,1));
+    VectorizedArray<double> argument = fourier_coefficients[0] * p[0];
+    for (unsigned int d=1; d<dim; ++d)
+      argument += fourier_coefficients[d] * p[d];
+    return std::sin(argument);
+  }
+
+
+
   template <int dim>
   Tensor<1,dim>
   FourierSineFunction<dim>::gradient (const Point<dim>   &p,
@@ -432,6 +432,115 @@ void FunctionParser<dim>::vector_value (const Point<dim> &p,
     values(component) = fp.get()[component]->Eval();
 }
 
+
+
+template <int dim>
+void FunctionParser<dim>::value_list (const std::vector<Point<dim> > &points,
+                                      std::vector<double>            &values,
+                                      const unsigned int              component) const
+{
+  Assert (initialized==true, ExcNotInitialized());
+  Assert (component < this->n_components,
+          ExcIndexRange(component, 0, this->n_components));
+  Assert (values.size() == points.size(),
+          ExcDimensionMismatch(values.size(), points.size()));
+
+  // initialize the parser if that hasn't happened yet on the current thread
+  if (fp.get().size() == 0)
+    init_muparser();
+
+  // access the thread-local data only once: each call to get() involves a
+  // lookup in the thread-local storage that is more expensive than the
+  // evaluation of simple expressions
+  std::vector<double> &my_vars = vars.get();
+  const mu::Parser &parser = *fp.get()[component];
+  if (dim != n_vars)
+    my_vars[dim] = this->get_time();
+
+  try
+    {
+      for (unsigned int q=0; q<points.size(); ++q)
+        {
+          for (unsigned int i=0; i<dim; ++i)
+            my_vars[i] = points[q][i];
+          values[q] = parser.Eval();
+        }
+    }
+  catch (mu::ParserError &e)
+    {
+      std::cerr << "Message:  <" << e.GetMsg() << ">\n";
+      std::cerr << "Formula:  <" << e.GetExpr() << ">\n";
+      std::cerr << "Token:    <" << e.GetToken() << ">\n";
+      std::cerr << "Position: <" << e.GetPos() << ">\n";
+      std::cerr << "Errc:     <" << e.GetCode() << ">" << std::endl;
+      AssertThrow(false, ExcParseError(e.GetCode(), e.GetMsg().c_str()));
+    }
+}
+
+
+
+template <int dim>
+void FunctionParser<dim>::vector_value_list (const std::vector<Point<dim> > &points,
+                                             std::vector<Vector<double> >   &values) const
+{
+  Assert (initialized==true, ExcNotInitialized());
+  Assert (values.size() == points.size(),
+          ExcDimensionMismatch(values.size(), points.size()));
+
+  // initialize the parser if that hasn't happened yet on the current thread
+  if (fp.get().size() == 0)
+    init_muparser();
+
+  std::vector<double> &my_vars = vars.get();
+  const auto &parsers = fp.get();
+  if (dim != n_vars)
+    my_vars[dim] = this->get_time();
+
+  for (unsigned int q=0; q<points.size(); ++q)
+    {
+      Assert (values[q].size() == this->n_components,
+              ExcDimensionMismatch (values[q].size(), this->n_components));
+      for (unsigned int i=0; i<dim; ++i)
+        my_vars[i] = points[q][i];
+      for (unsigned int component = 0; component < this->n_components;
+           ++component)
+        values[q](component) = parsers[component]->Eval();
+    }
+}
+
+
+
+template <int dim>
+void FunctionParser<dim>::vector_values (const std::vector<Point<dim> >    &points,
+                                         std::vector<std::vector<double> > &values) const
+{
+  Assert (initialized==true, ExcNotInitialized());
+  Assert (values.size() == this->n_components,
+          ExcDimensionMismatch (values.size(), this->n_components));
+
+  // initialize the parser if that hasn't happened yet on the current thread
+  if (fp.get().size() == 0)
+    init_muparser();
+
+  std::vector<double> &my_vars = vars.get();
+  const auto &parsers = fp.get();
+  if (dim != n_vars)
+    my_vars[dim] = this->get_time();
+
+  for (unsigned int q=0; q<points.size(); ++q)
+    {
+      for (unsigned int i=0; i<dim; ++i)
+        my_vars[i] = points[q][i];
+      for (unsigned int component = 0; component < this->n_components;
+           ++component)
+        {
+          Assert (values[component].size() == points.size(),
+                  ExcDimensionMismatch (values[component].size(), points.size()));
+          values[component][q] = parsers[component]->Eval();
+        }
+    }
+}
+
 #else
 
 
@@ -474,6 +583,30 @@ void FunctionParser<dim>::vector_value (
 }
 
 
+template <int dim>
+void FunctionParser<dim>::value_list (
+  const std::vector<Point<dim> > &, std::vector<double> &, const unsigned int) const
+{
+  Assert(false, ExcNeedsFunctionparser());
+}
+
+
+template <int dim>
+void FunctionParser<dim>::vector_value_list (
+  const std::vector<Point<dim> > &, std::vector<Vector<double> > &) const
+{
+  Assert(false, ExcNeedsFunctionparser());
+}
+
+
+template <int dim>
+void FunctionParser<dim>::vector_values (
+  const std::vector<Point<dim> > &, std::vector<std::vector<double> > &) const
+{
+  Assert(false, ExcNeedsFunctionparser());
+}
+
+
 #endif
 
 // Explicit Instantiations.
@@ -25,6 +25,9 @@
 #  endif
 #  include <Epetra_SerialComm.h>
 #  include <Epetra_Map.h>
+#  ifdef DEAL_II_TRILINOS_WITH_TPETRA
+#    include <Teuchos_DefaultMpiComm.hpp>
+#  endif
 #endif
 
 DEAL_II_NAMESPACE_OPEN
@@ -42,7 +45,8 @@ IndexSet::IndexSet (const Epetra_Map &map)
   :
   is_compressed (true),
   index_space_size (1+map.MaxAllGID64()),
-  largest_range (numbers::invalid_unsigned_int)
+  largest_range (numbers::invalid_unsigned_int),
+  lookup_begin (0)
 {
   Assert(
     map.MinAllGID64() == 0,
@@ -69,7 +73,8 @@ IndexSet::IndexSet (const Epetra_Map &map)
   :
   is_compressed (true),
   index_space_size (1+map.MaxAllGID()),
-  largest_range (numbers::invalid_unsigned_int)
+  largest_range (numbers::invalid_unsigned_int),
+  lookup_begin (0)
 {
   Assert(
     map.MinAllGID() == 0,
@@ -109,17 +114,12 @@ IndexSet::add_range (const size_type begin,
 
   if (begin != end)
     {
-      const Range new_range(begin,end);
-
-      // the new index might be larger than the last index present in the
-      // ranges. Then we can skip the binary search
-      if (ranges.size() == 0 || begin > ranges.back().end)
-        ranges.push_back(new_range);
+      // extend the last range if possible, and otherwise append the range
+      // without sorting, which is left to compress()
+      if (ranges.size() > 0 && begin == ranges.back().end)
+        ranges.back().end = end;
       else
-        ranges.insert (Utilities::lower_bound (ranges.begin(),
-                                               ranges.end(),
-                                               new_range),
-                       new_range);
+        ranges.emplace_back(begin, end);
       is_compressed = false;
     }
 }
@@ -136,6 +136,17 @@ IndexSet::do_compress () const
   // which itself calls the current function)
   Threads::Mutex::ScopedLock lock (compress_mutex);
 
+  // another thread might have compressed the set while we waited for the
+  // lock
+  if (is_compressed.load(std::memory_order_acquire) == true)
+    return;
+
+  // ranges added after the last call to this function are appended in the
+  // order they were given, so sort them first. the check is cheap compared
+  // to sorting and keeps the common case of ascending additions fast
+  if (std::is_sorted(ranges.begin(), ranges.end()) == false)
+    std::sort(ranges.begin(), ranges.end());
+
   // see if any of the contiguous ranges can be merged. do not use
   // std::vector::erase in-place as it is quadratic in the number of
   // ranges. since the ranges are sorted by their first index, determining
@@ -186,7 +197,43 @@ IndexSet::do_compress () const
           largest_range = i - ranges.begin();
         }
     }
-  is_compressed = true;
+
+  // for sets made up of many ranges that lie close to each other, set up a
+  // bitmap for constant-time access. we use it when it takes at most about
+  // four times the memory of the ranges, i.e., for at most 384 indices of
+  // the covered interval per range
+  lookup_bits.clear();
+  lookup_offsets.clear();
+  const unsigned int n_ranges_for_lookup = 16;
+  if (ranges.size() >= n_ranges_for_lookup)
+    {
+      lookup_begin = ranges.front().begin;
+      const size_type n_words = (ranges.back().end - lookup_begin + 63) / 64;
+      if (n_words <= 6 * ranges.size())
+        {
+          lookup_bits.resize(n_words, 0);
+          lookup_offsets.resize(n_words, 0);
+          for (std::vector<Range>::const_iterator i = ranges.begin(); i != ranges.end(); ++i)
+            for (size_type j=i->begin; j<i->end; ++j)
+              lookup_bits[(j-lookup_begin)/64] |= std::uint64_t(1) << ((j-lookup_begin)%64);
+
+          size_type n_before = 0;
+          for (size_type w=0; w<n_words; ++w)
+            {
+              lookup_offsets[w] = n_before;
+              std::uint64_t bits = lookup_bits[w];
+#ifdef __GNUC__
+              n_before += __builtin_popcountll(bits);
+#else
+              for ( ; bits != 0; bits &= bits - 1)
+                ++n_before;
+#endif
+            }
+          Assert(n_before == next_index, ExcInternalError());
+        }
+    }
+
+  is_compressed.store(true, std::memory_order_release);
 
   // check that next_index is correct. needs to be after the previous
   // statement because we otherwise will get into an endless loop
@@ -259,6 +306,7 @@ IndexSet::get_view (const size_type begin,
   Assert (end <= size(),
           ExcMessage ("Given range exceeds index set dimension"));
 
+  compress();
   IndexSet result (end-begin);
   std::vector<Range>::const_iterator r1 = ranges.begin();
 
@@ -364,12 +412,16 @@ IndexSet::pop_back ()
   Assert(is_empty() == false,
          ExcMessage("pop_back() failed, because this IndexSet contains no entries."));
 
+  compress();
   const size_type index = ranges.back().end-1;
   --ranges.back().end;
 
   if (ranges.back().begin == ranges.back().end)
     ranges.pop_back();
 
+  // the lookup table no longer matches the ranges
+  is_compressed = false;
+
   return index;
 }
 
@@ -381,6 +433,7 @@ IndexSet::pop_front ()
   Assert(is_empty() == false,
          ExcMessage("pop_front() failed, because this IndexSet contains no entries."));
 
+  compress();
   const size_type index = ranges.front().begin;
   ++ranges.front().begin;
 
@@ -492,6 +545,7 @@ void
 IndexSet::block_write(std::ostream &out) const
 {
   AssertThrow (out, ExcIO());
+  compress();
   out.write(reinterpret_cast<const char *>(&index_space_size),
             sizeof(index_space_size));
   size_t n_ranges = ranges.size();
@@ -518,7 +572,9 @@ IndexSet::block_read(std::istream &in)
     in.read(reinterpret_cast<char *>(&*ranges.begin()),
             ranges.size() * sizeof(Range));
 
-  do_compress(); // needed so that largest_range can be recomputed
+  // needed so that largest_range can be recomputed
+  is_compressed = false;
+  compress();
 }
 
 
@@ -610,6 +666,61 @@ IndexSet::make_trilinos_map (const MPI_Comm &communicator,
                         );
     }
 }
+
+
+
+#ifdef DEAL_II_TRILINOS_WITH_TPETRA
+Teuchos::RCP<const Tpetra::Map<TrilinosWrappers::types::tpetra_local_ordinal,
+                               TrilinosWrappers::types::tpetra_global_ordinal> >
+IndexSet::make_tpetra_map (const MPI_Comm &communicator,
+                           const bool overlapping) const
+{
+  typedef Tpetra::Map<TrilinosWrappers::types::tpetra_local_ordinal,
+                      TrilinosWrappers::types::tpetra_global_ordinal> MapType;
+  compress ();
+
+#ifdef DEBUG
+  if (!overlapping)
+    {
+      const size_type n_global_elements
+        = Utilities::MPI::sum (n_elements(), communicator);
+      Assert (n_global_elements == size(),
+              ExcMessage ("You are trying to create a Tpetra::Map object "
+                          "that partitions elements of an index set "
+                          "between processors. However, the union of the "
+                          "index sets on different processors does not "
+                          "contain all indices exactly once: the sum of "
+                          "the number of entries the various processors "
+                          "want to store locally is "
+                          + Utilities::to_string (n_global_elements) +
+                          " whereas the total size of the object to be "
+                          "allocated is "
+                          + Utilities::to_string (size()) + "."));
+    }
+#endif
+
+  const Teuchos::RCP<const Teuchos::Comm<int> > comm
+    = Teuchos::rcp (new Teuchos::MpiComm<int> (communicator));
+
+  // Find out if the IndexSet is ascending and 1:1. This corresponds to a
+  // contiguous Tpetra::Map. Overlapping IndexSets are never 1:1.
+  const bool linear = overlapping ? false : is_ascending_and_one_to_one(communicator);
+
+  if (linear)
+    return Teuchos::rcp (new MapType (size(), n_elements(), 0, comm));
+  else
+    {
+      std::vector<size_type> indices;
+      fill_index_vector(indices);
+      const std::vector<TrilinosWrappers::types::tpetra_global_ordinal>
+      global_indices (indices.begin(), indices.end());
+      return Teuchos::rcp (new MapType (Teuchos::OrdinalTraits<Tpetra::global_size_t>::invalid(),
+                                        Teuchos::ArrayView<const TrilinosWrappers::types::tpetra_global_ordinal>
+                                        (global_indices.data(), global_indices.size()),
+                                        0, comm));
+    }
+}
+#endif
 #endif
 
 
@@ -688,8 +799,10 @@ std::size_t
 IndexSet::memory_consumption () const
 {
   return (MemoryConsumption::memory_consumption (ranges) +
-          MemoryConsumption::memory_consumption (is_compressed) +
+          sizeof (is_compressed) +
           MemoryConsumption::memory_consumption (index_space_size) +
+          MemoryConsumption::memory_consumption (lookup_bits) +
+          MemoryConsumption::memory_consumption (lookup_offsets) +
           sizeof (compress_mutex));
 }
 
@@ -0,0 +1,368 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_report.h>
+#include <deal.II/base/utilities.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace internal
+{
+  namespace MemoryReportImplementation
+  {
+    // separators used to flatten the path of an entry, i.e., the names of
+    // the entry and its parents, into a single string
+    const char path_separator = '\x1f';
+    const char entry_separator = '\x1e';
+
+
+
+    // the names of the entries of a report in depth-first order, without
+    // the numbers, used to merge the entries present on different processes
+    struct Node
+    {
+      Node (const std::string &name)
+        :
+        name (name)
+      {}
+
+      Node &find_or_add (const std::string &child_name)
+      {
+        for (std::list<Node>::iterator it=children.begin(); it!=children.end(); ++it)
+          if (it->name == child_name)
+            return *it;
+        children.push_back (Node(child_name));
+        return children.back();
+      }
+
+      std::string     name;
+      std::list<Node> children;
+    };
+
+
+
+    void
+    build_tree (const MemoryReport &report,
+                Node               &node)
+    {
+      for (std::list<MemoryReport>::const_iterator it=report.get_children().begin();
+           it!=report.get_children().end(); ++it)
+        build_tree (*it, node.find_or_add(it->get_name()));
+    }
+
+
+
+    void
+    flatten (const Node                                         &node,
+             const std::string                                  &prefix,
+             const unsigned int                                  depth,
+             std::vector<std::pair<std::string, unsigned int> > &entries)
+    {
+      const std::string path = prefix.empty() ? node.name : prefix + path_separator + node.name;
+      entries.emplace_back (path, depth);
+      for (std::list<Node>::const_iterator it=node.children.begin();
+           it!=node.children.end(); ++it)
+        flatten (*it, path, depth+1, entries);
+    }
+
+
+
+    void
+    collect_bytes (const MemoryReport                 &report,
+                   const std::string                  &prefix,
+                   std::map<std::string, std::size_t> &bytes)
+    {
+      const std::string path = prefix.empty() ? report.get_name() :
+                               prefix + path_separator + report.get_name();
+      bytes[path] += report.total_bytes();
+      for (std::list<MemoryReport>::const_iterator it=report.get_children().begin();
+           it!=report.get_children().end(); ++it)
+        collect_bytes (*it, path, bytes);
+    }
+
+
+
+    std::string
+    last_component (const std::string &path)
+    {
+      const std::string::size_type position = path.rfind(path_separator);
+      return position == std::string::npos ? path : path.substr(position+1);
+    }
+
+
+
+    unsigned int
+    name_width (const std::vector<std::pair<std::string, unsigned int> > &entries)
+    {
+      std::size_t width = 0;
+      for (unsigned int i=0; i<entries.size(); ++i)
+        width = std::max (width, 2*entries[i].second + last_component(entries[i].first).size());
+      // leave room for the header of the table
+      return std::max<std::size_t> (width + 2, 25);
+    }
+
+
+
+    std::vector<std::pair<std::string, unsigned int> >
+    split_entries (const std::string &serialized)
+    {
+      std::vector<std::pair<std::string, unsigned int> > entries;
+      std::string::size_type start = 0;
+      while (start < serialized.size())
+        {
+          std::string::size_type end = serialized.find(entry_separator, start);
+          if (end == std::string::npos)
+            end = serialized.size();
+          const std::string path = serialized.substr(start, end-start);
+          entries.emplace_back (path, std::count(path.begin(), path.end(), path_separator));
+          start = end+1;
+        }
+      return entries;
+    }
+  }
+}
+
+
+
+MemoryReport::MemoryReport (const std::string &name,
+                            const std::size_t  bytes)
+  :
+  name (name),
+  bytes (bytes)
+{}
+
+
+
+MemoryReport &
+MemoryReport::add (const std::string &name,
+                   const std::size_t  bytes)
+{
+  children.push_back (MemoryReport(name, bytes));
+  return children.back();
+}
+
+
+
+MemoryReport &
+MemoryReport::add (const MemoryReport &report)
+{
+  children.push_back (report);
+  return children.back();
+}
+
+
+
+void
+MemoryReport::add_bytes (const std::size_t additional_bytes)
+{
+  bytes += additional_bytes;
+}
+
+
+
+const std::string &
+MemoryReport::get_name () const
+{
+  return name;
+}
+
+
+
+std::size_t
+MemoryReport::total_bytes () const
+{
+  std::size_t result = bytes;
+  for (std::list<MemoryReport>::const_iterator it=children.begin();
+       it!=children.end(); ++it)
+    result += it->total_bytes();
+  return result;
+}
+
+
+
+const std::list<MemoryReport> &
+MemoryReport::get_children () const
+{
+  return children;
+}
+
+
+
+void
+MemoryReport::print (std::ostream &out) const
+{
+  using namespace internal::MemoryReportImplementation;
+
+  Node tree (name);
+  build_tree (*this, tree);
+  std::vector<std::pair<std::string, unsigned int> > entries;
+  flatten (tree, "", 0, entries);
+  std::map<std::string, std::size_t> bytes;
+  collect_bytes (*this, "", bytes);
+
+  const unsigned int width = name_width (entries);
+  const std::ios_base::fmtflags old_flags = out.flags();
+  const std::streamsize old_precision = out.precision();
+  out << std::left << std::setw(width) << "Memory consumption"
+      << std::right << std::setw(12) << "[MB]" << std::endl;
+  out << std::fixed << std::setprecision(3);
+  for (unsigned int i=0; i<entries.size(); ++i)
+    out << std::string(2*entries[i].second, ' ') << std::left
+        << std::setw(width-2*entries[i].second)
+        << last_component(entries[i].first) << std::right << std::setw(12)
+        << 1e-6 * bytes[entries[i].first] << std::endl;
+  out.flags (old_flags);
+  out.precision (old_precision);
+}
+
+
+
+void
+MemoryReport::print (std::ostream   &out,
+                     const MPI_Comm &mpi_comm) const
+{
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes(mpi_comm);
+  if (n_procs == 1)
+    {
+      print (out);
+      return;
+    }
+
+#ifdef DEAL_II_WITH_MPI
+  using namespace internal::MemoryReportImplementation;
+
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process(mpi_comm);
+
+  // collect the names of the entries of all processes on rank 0, merge them
+  // into a single tree, and distribute the merged list of entries
+  Node tree (name);
+  build_tree (*this, tree);
+  std::vector<std::pair<std::string, unsigned int> > entries;
+  flatten (tree, "", 0, entries);
+
+  std::string serialized;
+  for (unsigned int i=0; i<entries.size(); ++i)
+    serialized += (i>0 ? std::string(1, entry_separator) : std::string()) + entries[i].first;
+
+  int my_size = serialized.size();
+  std::vector<int> sizes (my_rank == 0 ? n_procs : 0);
+  int ierr = MPI_Gather (&my_size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, mpi_comm);
+  AssertThrowMPI (ierr);
+
+  std::vector<int> offsets (sizes.size()+1, 0);
+  for (unsigned int p=0; p<sizes.size(); ++p)
+    offsets[p+1] = offsets[p] + sizes[p];
+  std::vector<char> all_names (offsets.back());
+  ierr = MPI_Gatherv (&serialized[0], my_size, MPI_CHAR, all_names.data(),
+                      sizes.data(), offsets.data(), MPI_CHAR, 0, mpi_comm);
+  AssertThrowMPI (ierr);
+
+  if (my_rank == 0)
+    {
+      for (unsigned int p=1; p<n_procs; ++p)
+        {
+          const std::vector<std::pair<std::string, unsigned int> > other_entries =
+            split_entries (std::string(all_names.data()+offsets[p], sizes[p]));
+          for (unsigned int i=0; i<other_entries.size(); ++i)
+            {
+              // walk down from the root, skipping its name
+              Node *node = &tree;
+              std::string::size_type start = other_entries[i].first.find(path_separator);
+              while (start != std::string::npos)
+                {
+                  std::string::size_type end = other_entries[i].first.find(path_separator, start+1);
+                  node = &node->find_or_add (other_entries[i].first.substr
+                                             (start+1, end == std::string::npos ?
+                                              std::string::npos : end-start-1));
+                  start = end;
+                }
+            }
+        }
+      entries.clear();
+      flatten (tree, "", 0, entries);
+      serialized.clear();
+      for (unsigned int i=0; i<entries.size(); ++i)
+        serialized += (i>0 ? std::string(1, entry_separator) : std::string()) + entries[i].first;
+      my_size = serialized.size();
+    }
+
+  ierr = MPI_Bcast (&my_size, 1, MPI_INT, 0, mpi_comm);
+  AssertThrowMPI (ierr);
+  serialized.resize (my_size);
+  ierr = MPI_Bcast (&serialized[0], my_size, MPI_CHAR, 0, mpi_comm);
+  AssertThrowMPI (ierr);
+  if (my_rank != 0)
+    entries = split_entries (serialized);
+
+  // look up the numbers of the present process for the merged entries and
+  // combine them over all processes
+  std::map<std::string, std::size_t> bytes;
+  collect_bytes (*this, "", bytes);
+  std::vector<double> my_values (entries.size());
+  for (unsigned int i=0; i<entries.size(); ++i)
+    {
+      const std::map<std::string, std::size_t>::const_iterator
+      it = bytes.find(entries[i].first);
+      my_values[i] = (it == bytes.end()) ? 0. : 1e-6 * it->second;
+    }
+
+  std::vector<double> min_values (entries.size()), max_values (entries.size()),
+      sum_values (entries.size());
+  ierr = MPI_Reduce (my_values.data(), min_values.data(), my_values.size(),
+                     MPI_DOUBLE, MPI_MIN, 0, mpi_comm);
+  AssertThrowMPI (ierr);
+  ierr = MPI_Reduce (my_values.data(), max_values.data(), my_values.size(),
+                     MPI_DOUBLE, MPI_MAX, 0, mpi_comm);
+  AssertThrowMPI (ierr);
+  ierr = MPI_Reduce (my_values.data(), sum_values.data(), my_values.size(),
+                     MPI_DOUBLE, MPI_SUM, 0, mpi_comm);
+  AssertThrowMPI (ierr);
+
+  if (my_rank == 0)
+    {
+      const unsigned int width = name_width (entries);
+      const std::ios_base::fmtflags old_flags = out.flags();
+      const std::streamsize old_precision = out.precision();
+      out << std::left << std::setw(width) << "Memory consumption [MB]"
+          << std::right << std::setw(12) << "min" << std::setw(12) << "avg"
+          << std::setw(12) << "max" << std::setw(14) << "sum" << std::endl;
+      out << std::fixed << std::setprecision(3);
+      for (unsigned int i=0; i<entries.size(); ++i)
+        out << std::string(2*entries[i].second, ' ') << std::left
+            << std::setw(width-2*entries[i].second)
+            << last_component(entries[i].first) << std::right
+            << std::setw(12) << min_values[i]
+            << std::setw(12) << sum_values[i]/n_procs
+            << std::setw(12) << max_values[i]
+            << std::setw(14) << sum_values[i] << std::endl;
+      out.flags (old_flags);
+      out.precision (old_precision);
+    }
+#else
+  (void)out;
+  Assert (false, ExcInternalError());
+#endif
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
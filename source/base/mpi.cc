@@ -16,14 +16,18 @@
 
 #include <deal.II/base/mpi.h>
 #include <deal.II/base/mpi.templates.h>
+#include <deal.II/base/mpi_progress.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/lac/vector_memory.h>
 #include <deal.II/lac/la_parallel_vector.h>
 #include <deal.II/lac/la_parallel_block_vector.h>
 #include <deal.II/base/multithread_info.h>
+#include <deal.II/base/performance_counters.h>
 
+#include <cstring>
 #include <iostream>
+#include <limits>
 
 #ifdef DEAL_II_WITH_TRILINOS
 #  ifdef DEAL_II_WITH_MPI
@@ -87,6 +91,195 @@ namespace Utilities
     }
 
 
+#if MPI_VERSION < 3
+    namespace
+    {
+      // for MPI versions without a nonblocking barrier, find the processes
+      // that are going to send to the current one by gathering the
+      // destinations of all processes
+      std::vector<unsigned int>
+      gather_point_to_point_origins (const MPI_Comm &mpi_comm,
+                                     const std::vector<unsigned int> &destinations)
+      {
+        const unsigned int myid = Utilities::MPI::this_mpi_process(mpi_comm);
+        const unsigned int n_procs = Utilities::MPI::n_mpi_processes(mpi_comm);
+
+        // let all processors communicate the maximal number of destinations
+        // they have
+        const unsigned int max_n_destinations
+          = Utilities::MPI::max (destinations.size(), mpi_comm);
+
+        if (max_n_destinations==0)
+          // all processes have nothing to send/receive:
+          return std::vector<unsigned int>();
+
+        // now that we know the number of data packets every processor wants to
+        // send, set up a buffer with the maximal size and copy our destinations
+        // in there, padded with -1's
+        std::vector<unsigned int> my_destinations(max_n_destinations,
+                                                  numbers::invalid_unsigned_int);
+        std::copy (destinations.begin(), destinations.end(),
+                   my_destinations.begin());
+
+        // now exchange these (we could communicate less data if we used
+        // MPI_Allgatherv, but we'd have to communicate my_n_destinations to all
+        // processors in this case, which is more expensive than the reduction
+        // operation above in MPI_Allreduce)
+        std::vector<unsigned int> all_destinations (max_n_destinations * n_procs);
+        const int ierr = MPI_Allgather (my_destinations.data(), max_n_destinations, MPI_UNSIGNED,
+                                        all_destinations.data(), max_n_destinations, MPI_UNSIGNED,
+                                        mpi_comm);
+        AssertThrowMPI(ierr);
+
+        // now we know who is going to communicate with whom. collect who is
+        // going to communicate with us!
+        std::vector<unsigned int> origins;
+        for (unsigned int i=0; i<n_procs; ++i)
+          for (unsigned int j=0; j<max_n_destinations; ++j)
+            if (all_destinations[i*max_n_destinations + j] == myid)
+              origins.push_back (i);
+            else if (all_destinations[i*max_n_destinations + j] ==
+                     numbers::invalid_unsigned_int)
+              break;
+
+        return origins;
+      }
+    }
+#endif
+
+
+
+    namespace internal
+    {
+      void sparse_data_exchange (const MPI_Comm                                &mpi_comm,
+                                 const std::vector<unsigned int>               &destinations,
+                                 const std::vector<ArrayView<const char> >     &send_data,
+                                 const std::function<char *(const unsigned int,
+                                                            const unsigned int)> &get_receive_buffer)
+      {
+        AssertDimension(destinations.size(), send_data.size());
+        const unsigned int myid = Utilities::MPI::this_mpi_process(mpi_comm);
+        const unsigned int n_procs = Utilities::MPI::n_mpi_processes(mpi_comm);
+        const int mpi_tag = 4110;
+
+        // start the sends to other processes and copy the data to ourselves
+        std::vector<MPI_Request> send_requests;
+        send_requests.reserve(destinations.size());
+        unsigned int n_sends = 0;
+        for (unsigned int i=0; i<destinations.size(); ++i)
+          {
+            AssertIndexRange(destinations[i], n_procs);
+            AssertThrow (send_data[i].size() <
+                         static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                         ExcMessage("Index overflow: Maximum message size in MPI is 2GB."));
+            if (destinations[i] == myid)
+              {
+                char *receive_buffer = get_receive_buffer(myid, send_data[i].size());
+                if (send_data[i].size() > 0)
+                  std::memcpy(receive_buffer, send_data[i].begin(), send_data[i].size());
+                continue;
+              }
+
+            send_requests.emplace_back();
+            // synchronous sends because the consensus algorithm below
+            // relies on a send being complete only when it has been received
+#if MPI_VERSION >= 3
+            const int ierr = MPI_Issend(const_cast<char *>(send_data[i].begin()),
+                                        send_data[i].size(), MPI_BYTE,
+                                        destinations[i], mpi_tag, mpi_comm,
+                                        &send_requests.back());
+#else
+            const int ierr = MPI_Isend(const_cast<char *>(send_data[i].begin()),
+                                       send_data[i].size(), MPI_BYTE,
+                                       destinations[i], mpi_tag, mpi_comm,
+                                       &send_requests.back());
+#endif
+            AssertThrowMPI(ierr);
+            ++n_sends;
+          }
+        (void)n_sends;
+
+        const auto receive_message = [&](const MPI_Status &status)
+        {
+          int n_bytes = 0;
+          int ierr = MPI_Get_count(&status, MPI_BYTE, &n_bytes);
+          AssertThrowMPI(ierr);
+          char *receive_buffer = get_receive_buffer(status.MPI_SOURCE, n_bytes);
+          ierr = MPI_Recv(receive_buffer, n_bytes, MPI_BYTE, status.MPI_SOURCE,
+                          mpi_tag, mpi_comm, MPI_STATUS_IGNORE);
+          AssertThrowMPI(ierr);
+        };
+
+#if MPI_VERSION >= 3
+        // receive messages until all processes have entered the barrier,
+        // which they do once all their sends have been received
+        MPI_Request barrier_request;
+        bool barrier_started = false;
+        while (true)
+          {
+            int message_arrived = 0;
+            MPI_Status status;
+            int ierr = MPI_Iprobe(MPI_ANY_SOURCE, mpi_tag, mpi_comm,
+                                  &message_arrived, &status);
+            AssertThrowMPI(ierr);
+            if (message_arrived)
+              receive_message(status);
+
+            if (barrier_started)
+              {
+                int all_done = 0;
+                ierr = MPI_Test(&barrier_request, &all_done, MPI_STATUS_IGNORE);
+                AssertThrowMPI(ierr);
+                if (all_done)
+                  break;
+              }
+            else
+              {
+                int all_sent = 0;
+                ierr = MPI_Testall(send_requests.size(), send_requests.data(),
+                                   &all_sent, MPI_STATUSES_IGNORE);
+                AssertThrowMPI(ierr);
+                if (all_sent)
+                  {
+                    ierr = MPI_Ibarrier(mpi_comm, &barrier_request);
+                    AssertThrowMPI(ierr);
+                    barrier_started = true;
+                  }
+              }
+          }
+
+        // a process that has seen the completion of the barrier might
+        // already start another exchange on the same communicator, whose
+        // messages must not be picked up by processes still in the loop
+        // above. a second barrier separates the two exchanges
+        const int ierr = MPI_Barrier(mpi_comm);
+        AssertThrowMPI(ierr);
+#else
+        std::vector<unsigned int> other_destinations;
+        for (unsigned int i=0; i<destinations.size(); ++i)
+          if (destinations[i] != myid)
+            other_destinations.push_back(destinations[i]);
+        const unsigned int n_receives =
+          gather_point_to_point_origins(mpi_comm, other_destinations).size();
+        for (unsigned int i=0; i<n_receives; ++i)
+          {
+            MPI_Status status;
+            const int ierr = MPI_Probe(MPI_ANY_SOURCE, mpi_tag, mpi_comm, &status);
+            AssertThrowMPI(ierr);
+            receive_message(status);
+          }
+        if (send_requests.size() > 0)
+          {
+            const int ierr = MPI_Waitall(send_requests.size(), send_requests.data(),
+                                         MPI_STATUSES_IGNORE);
+            AssertThrowMPI(ierr);
+          }
+#endif
+      }
+    }
+
+
+
     std::vector<unsigned int>
     compute_point_to_point_communication_pattern (const MPI_Comm &mpi_comm,
                                                   const std::vector<unsigned int> &destinations)
@@ -101,45 +294,21 @@ namespace Utilities
           Assert (destinations[i] != myid,
                   ExcMessage ("There is no point in communicating with ourselves."));
         }
+      (void)myid;
+      (void)n_procs;
 
-
-      // let all processors communicate the maximal number of destinations
-      // they have
-      const unsigned int max_n_destinations
-        = Utilities::MPI::max (destinations.size(), mpi_comm);
-
-      if (max_n_destinations==0)
-        // all processes have nothing to send/receive:
-        return std::vector<unsigned int>();
-
-      // now that we know the number of data packets every processor wants to
-      // send, set up a buffer with the maximal size and copy our destinations
-      // in there, padded with -1's
-      std::vector<unsigned int> my_destinations(max_n_destinations,
-                                                numbers::invalid_unsigned_int);
-      std::copy (destinations.begin(), destinations.end(),
-                 my_destinations.begin());
-
-      // now exchange these (we could communicate less data if we used
-      // MPI_Allgatherv, but we'd have to communicate my_n_destinations to all
-      // processors in this case, which is more expensive than the reduction
-      // operation above in MPI_Allreduce)
-      std::vector<unsigned int> all_destinations (max_n_destinations * n_procs);
-      const int ierr = MPI_Allgather (my_destinations.data(), max_n_destinations, MPI_UNSIGNED,
-                                      all_destinations.data(), max_n_destinations, MPI_UNSIGNED,
-                                      mpi_comm);
-      AssertThrowMPI(ierr);
-
-      // now we know who is going to communicate with whom. collect who is
-      // going to communicate with us!
+      // send an empty message to each destination, and record the origin of
+      // each message received. this keeps duplicate entries
       std::vector<unsigned int> origins;
-      for (unsigned int i=0; i<n_procs; ++i)
-        for (unsigned int j=0; j<max_n_destinations; ++j)
-          if (all_destinations[i*max_n_destinations + j] == myid)
-            origins.push_back (i);
-          else if (all_destinations[i*max_n_destinations + j] ==
-                   numbers::invalid_unsigned_int)
-            break;
+      char empty_buffer = 0;
+      internal::sparse_data_exchange
+      (mpi_comm, destinations,
+       std::vector<ArrayView<const char> >(destinations.size()),
+       [&](const unsigned int origin, const unsigned int) -> char *
+      {
+        origins.push_back(origin);
+        return &empty_buffer;
+      });
 
       return origins;
     }
@@ -272,6 +441,27 @@ namespace Utilities
 
 
 
+    namespace internal
+    {
+      void sparse_data_exchange (const MPI_Comm                                &,
+                                 const std::vector<unsigned int>               &destinations,
+                                 const std::vector<ArrayView<const char> >     &send_data,
+                                 const std::function<char *(const unsigned int,
+                                                            const unsigned int)> &get_receive_buffer)
+      {
+        AssertDimension(destinations.size(), send_data.size());
+        for (unsigned int i=0; i<destinations.size(); ++i)
+          {
+            AssertIndexRange(destinations[i], 1);
+            char *receive_buffer = get_receive_buffer(0, send_data[i].size());
+            if (send_data[i].size() > 0)
+              std::memcpy(receive_buffer, send_data[i].begin(), send_data[i].size());
+          }
+      }
+    }
+
+
+
     MinMaxAvg
     min_max_avg(const double my_value,
                 const MPI_Comm &)
@@ -294,7 +484,11 @@ namespace Utilities
 
     MPI_InitFinalize::MPI_InitFinalize (int    &argc,
                                         char ** &argv,
-                                        const unsigned int max_num_threads)
+                                        const unsigned int max_num_threads,
+                                        const bool pin_threads,
+                                        const bool thread_multiple)
+      :
+      thread_multiple_support (false)
     {
       static bool constructor_has_already_run = false;
       (void)constructor_has_already_run;
@@ -318,9 +512,12 @@ namespace Utilities
       // we might use several threads but never call two MPI functions at the
       // same time. For an explanation see on why we do this see
       // http://www.open-mpi.org/community/lists/users/2010/03/12244.php
-      int wanted = MPI_THREAD_SERIALIZED;
+      // unless the user asks for concurrent calls from several threads, e.g.
+      // for the progress engine
+      int wanted = thread_multiple ? MPI_THREAD_MULTIPLE : MPI_THREAD_SERIALIZED;
       ierr = MPI_Init_thread(&argc, &argv, wanted, &provided);
       AssertThrowMPI(ierr);
+      thread_multiple_support = (thread_multiple && provided >= MPI_THREAD_MULTIPLE);
 
       // disable for now because at least some implementations always return
       // MPI_THREAD_SINGLE.
@@ -331,6 +528,7 @@ namespace Utilities
       (void)argc;
       (void)argv;
       (void)ierr;
+      (void)thread_multiple;
 #endif
 
       // we are allowed to call MPI_Init ourselves and PETScInitialize will
@@ -357,24 +555,21 @@ namespace Utilities
       p4est_init (nullptr, SC_LP_SILENT);
 #endif
 
+      PerformanceCounters::initialize();
+
       constructor_has_already_run = true;
 
 
-      // Now also see how many threads we'd like to run
-      if (max_num_threads != numbers::invalid_unsigned_int)
-        {
-          // set maximum number of threads (also respecting the environment
-          // variable that the called function evaluates) based on what the
-          // user asked
-          MultithreadInfo::set_thread_limit(max_num_threads);
-        }
-      else
-        // user wants automatic choice
-        {
+      // Now also see how many threads we'd like to run. for the automatic
+      // choice and for restricting the threads to a set of cores, we need to
+      // know the number of MPI processes on the current node and the
+      // position of the current process among them
+      unsigned int n_local_processes = 1;
+      unsigned int nth_process_on_host = 1;
 #ifdef DEAL_II_WITH_MPI
-          // we need to figure out how many MPI processes there are on the
-          // current node, as well as how many CPU cores we have. for the
-          // first task, check what get_hostname() returns and then to an
+      if (max_num_threads == numbers::invalid_unsigned_int || pin_threads)
+        {
+          // for this, check what get_hostname() returns and then to an
           // allgather so each processor gets the answer
           //
           // in calculating the length of the string, don't forget the
@@ -395,8 +590,8 @@ namespace Utilities
 
           // search how often our own hostname appears and the how-manyth
           // instance the current process represents
-          unsigned int n_local_processes=0;
-          unsigned int nth_process_on_host = 0;
+          n_local_processes = 0;
+          nth_process_on_host = 0;
           for (unsigned int i=0; i<MPI::n_mpi_processes(MPI_COMM_WORLD); ++i)
             if (std::string (all_hostnames.data() + i*max_hostname_size) == hostname)
               {
@@ -405,8 +600,58 @@ namespace Utilities
                   ++nth_process_on_host;
               }
           Assert (nth_process_on_host > 0, ExcInternalError());
+        }
+#endif
 
+      // restrict the threads to a set of cores before the worker threads
+      // get created by set_thread_limit(). if the MPI launcher has bound the
+      // process to some of the cores already, keep these. otherwise, split
+      // the cores of the node in the same way as the number of threads is
+      // computed below, going through the cores in the order of their NUMA
+      // domains so that the cores of a process are close to each other
+      std::vector<unsigned int> cores;
+      if (pin_threads)
+        {
+          cores = MultithreadInfo::available_cores();
+          if (cores.size() == MultithreadInfo::n_cores() && n_local_processes > 1)
+            {
+              std::vector<unsigned int> ordered_cores;
+              const std::vector<std::vector<unsigned int> > domains
+                = MultithreadInfo::numa_domains();
+              for (unsigned int d=0; d<domains.size(); ++d)
+                ordered_cores.insert(ordered_cores.end(), domains[d].begin(),
+                                     domains[d].end());
+
+              const unsigned int n_cores = ordered_cores.size();
+              const unsigned int process = nth_process_on_host - 1;
+              if (n_local_processes >= n_cores)
+                cores.assign(1, ordered_cores[process % n_cores]);
+              else
+                {
+                  const unsigned int chunk = n_cores / n_local_processes;
+                  const unsigned int remainder = n_cores % n_local_processes;
+                  const unsigned int first = process * chunk + std::min(process, remainder);
+                  cores.assign(ordered_cores.begin() + first,
+                               ordered_cores.begin() + first + chunk +
+                               (process < remainder ? 1 : 0));
+                }
+            }
+          MultithreadInfo::set_thread_affinity(cores);
+        }
 
+      if (max_num_threads != numbers::invalid_unsigned_int)
+        {
+          // set maximum number of threads (also respecting the environment
+          // variable that the called function evaluates) based on what the
+          // user asked
+          MultithreadInfo::set_thread_limit(max_num_threads);
+        }
+      else if (pin_threads)
+        // one thread per core of the set
+        MultithreadInfo::set_thread_limit(cores.size());
+      else
+        // user wants automatic choice
+        {
           // compute how many cores each process gets. if the number does not
           // divide evenly, then we get one more core if we are among the
           // first few processes
@@ -422,9 +667,6 @@ namespace Utilities
                         :
                         0),
                        1U);
-#else
-          const unsigned int n_threads = MultithreadInfo::n_cores();
-#endif
 
           // finally set this number of threads
           MultithreadInfo::set_thread_limit(n_threads);
@@ -434,6 +676,10 @@ namespace Utilities
 
     MPI_InitFinalize::~MPI_InitFinalize()
     {
+      // stop the progress thread, which must not call MPI after
+      // MPI_Finalize
+      ProgressEngine::disable();
+
       // make memory pool release all PETSc/Trilinos/MPI-based vectors that
       // are no longer used at this point. this is relevant because the static
       // object destructors run for these vectors at the end of the program
@@ -489,6 +735,8 @@ namespace Utilities
       sc_finalize ();
 #endif
 
+      PerformanceCounters::finalize();
+
 
       // only MPI_Finalize if we are running with MPI. We also need to do this
       // when running PETSc, because we initialize MPI ourselves before
@@ -514,6 +762,14 @@ namespace Utilities
 
 
 
+    bool
+    MPI_InitFinalize::has_thread_multiple_support () const
+    {
+      return thread_multiple_support;
+    }
+
+
+
     bool job_supports_mpi ()
     {
 #ifdef DEAL_II_WITH_MPI
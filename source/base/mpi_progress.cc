@@ -0,0 +1,185 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi_progress.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace Utilities
+{
+  namespace MPI
+  {
+    std::atomic<int> ProgressEngine::current_mode (ProgressEngine::disabled);
+    std::atomic<unsigned int> ProgressEngine::cell_batch_interval (16);
+
+
+    namespace
+    {
+      // the list of outstanding requests and the mutex protecting it. the
+      // mutex is also held while the requests are tested, so that no two
+      // threads use the same request at a time
+      std::mutex requests_mutex;
+
+#ifdef DEAL_II_WITH_MPI
+      std::vector<std::vector<MPI_Request> *> outstanding_requests;
+#endif
+
+      // the progress thread and the flag telling it to stop. the thread
+      // mutex serializes enable() and disable()
+      std::mutex thread_mutex;
+      std::atomic<bool> stop_progress_thread (false);
+#ifdef DEAL_II_WITH_THREADS
+      std::thread progress_thread;
+#endif
+    }
+
+
+
+    void
+    ProgressEngine::enable (const Mode         mode,
+                            const unsigned int poll_interval)
+    {
+      if (mode == disabled)
+        {
+          disable();
+          return;
+        }
+
+      Assert (poll_interval > 0,
+              ExcMessage ("The poll interval must be positive."));
+
+#ifdef DEAL_II_WITH_MPI
+      int provided = MPI_THREAD_SINGLE;
+      const int ierr = MPI_Query_thread (&provided);
+      AssertThrowMPI (ierr);
+      AssertThrow (provided == MPI_THREAD_MULTIPLE,
+                   ExcMessage ("The MPI progress engine tests the requests from "
+                               "other threads than the one that started the "
+                               "communication, which requires MPI to be "
+                               "initialized with MPI_THREAD_MULTIPLE, see "
+                               "the constructor of MPI_InitFinalize."));
+
+      // stop a progress thread of a previous call
+      disable();
+
+      std::lock_guard<std::mutex> lock (thread_mutex);
+      cell_batch_interval = (mode == polling) ? poll_interval : 16;
+      current_mode = mode;
+
+#  ifdef DEAL_II_WITH_THREADS
+      if (mode == thread)
+        {
+          stop_progress_thread = false;
+          progress_thread = std::thread ([poll_interval]()
+          {
+            while (stop_progress_thread.load() == false)
+              {
+                test_requests (true);
+                std::this_thread::sleep_for
+                (std::chrono::microseconds(poll_interval));
+              }
+          });
+        }
+#  endif
+#else
+      (void)poll_interval;
+#endif
+    }
+
+
+
+    void
+    ProgressEngine::disable ()
+    {
+      std::lock_guard<std::mutex> lock (thread_mutex);
+      current_mode = disabled;
+
+#ifdef DEAL_II_WITH_THREADS
+      if (progress_thread.joinable())
+        {
+          stop_progress_thread = true;
+          progress_thread.join();
+        }
+#endif
+
+      // the finish functions still remove their requests, but new exchanges
+      // are not added anymore
+    }
+
+
+
+#ifdef DEAL_II_WITH_MPI
+    void
+    ProgressEngine::add_requests (std::vector<MPI_Request> &requests)
+    {
+      if (current_mode.load() == disabled || requests.empty())
+        return;
+
+      std::lock_guard<std::mutex> lock (requests_mutex);
+      Assert (std::find (outstanding_requests.begin(), outstanding_requests.end(),
+                         &requests) == outstanding_requests.end(),
+              ExcMessage ("The requests have already been added."));
+      outstanding_requests.push_back (&requests);
+    }
+
+
+
+    void
+    ProgressEngine::remove_requests (const std::vector<MPI_Request> &requests)
+    {
+      std::lock_guard<std::mutex> lock (requests_mutex);
+      std::vector<std::vector<MPI_Request> *>::iterator position =
+        std::find (outstanding_requests.begin(), outstanding_requests.end(),
+                   &requests);
+      if (position != outstanding_requests.end())
+        outstanding_requests.erase (position);
+    }
+#endif
+
+
+
+    void
+    ProgressEngine::test_requests (const bool wait_for_lock)
+    {
+#ifdef DEAL_II_WITH_MPI
+      std::unique_lock<std::mutex> lock (requests_mutex, std::defer_lock);
+      if (wait_for_lock)
+        lock.lock();
+      else if (lock.try_lock() == false)
+        return;
+
+      for (unsigned int i=0; i<outstanding_requests.size(); ++i)
+        {
+          std::vector<MPI_Request> &requests = *outstanding_requests[i];
+          int flag = 0;
+          const int ierr = MPI_Testall (requests.size(), requests.data(),
+                                        &flag, MPI_STATUSES_IGNORE);
+          AssertThrowMPI (ierr);
+        }
+#else
+      (void)wait_for_lock;
+#endif
+    }
+  } // end of namespace MPI
+} // end of namespace Utilities
+
+DEAL_II_NAMESPACE_CLOSE
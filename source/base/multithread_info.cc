@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2000 - 2015 by the deal.II authors
+// Copyright (C) 2000 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -25,11 +25,19 @@
 #  include <sys/sysctl.h>
 #endif
 
+#ifdef __linux__
+#  include <sched.h>
+#endif
+
 #include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
 
 #ifdef DEAL_II_WITH_THREADS
 #  include <deal.II/base/thread_management.h>
 #  include <tbb/task_scheduler_init.h>
+#  include <tbb/task_scheduler_observer.h>
 #endif
 
 DEAL_II_NAMESPACE_OPEN
@@ -198,6 +206,214 @@ MultithreadInfo::memory_consumption ()
 }
 
 
+
+namespace
+{
+  // parse a list of cores in the format of the Linux /sys file system, like
+  // "0-3,8,10-11", from the given file. return an empty list if the file
+  // can not be read
+  std::vector<unsigned int>
+  read_core_list (const std::string &file_name)
+  {
+    std::vector<unsigned int> cores;
+    std::ifstream file (file_name.c_str());
+    std::string line;
+    if (!file || !std::getline(file, line))
+      return cores;
+
+    std::istringstream list (line);
+    std::string range;
+    while (std::getline(list, range, ','))
+      {
+        const std::size_t dash = range.find('-');
+        try
+          {
+            const int first = Utilities::string_to_int(range.substr(0, dash));
+            const int last = (dash == std::string::npos ? first :
+                              Utilities::string_to_int(range.substr(dash+1)));
+            for (int core=first; core<=last; ++core)
+              cores.push_back(core);
+          }
+        catch (...)
+          {
+            return std::vector<unsigned int>();
+          }
+      }
+    return cores;
+  }
+
+
+
+  // return the groups of the given cores defined by the lists of the
+  // topology, with the groups sorted by their first core
+  std::vector<std::vector<unsigned int> >
+  group_cores (const std::vector<unsigned int>                &cores,
+               const std::vector<std::vector<unsigned int> > &topology_groups)
+  {
+    std::vector<std::vector<unsigned int> > groups;
+    std::vector<bool> is_grouped (cores.size(), false);
+    for (unsigned int g=0; g<topology_groups.size(); ++g)
+      {
+        std::vector<unsigned int> group;
+        for (unsigned int i=0; i<cores.size(); ++i)
+          if (!is_grouped[i] &&
+              std::find(topology_groups[g].begin(), topology_groups[g].end(),
+                        cores[i]) != topology_groups[g].end())
+            {
+              group.push_back(cores[i]);
+              is_grouped[i] = true;
+            }
+        if (!group.empty())
+          groups.push_back(group);
+      }
+
+    // cores without topology information form a group of their own
+    std::vector<unsigned int> remaining_cores;
+    for (unsigned int i=0; i<cores.size(); ++i)
+      if (!is_grouped[i])
+        remaining_cores.push_back(cores[i]);
+    if (!remaining_cores.empty())
+      groups.push_back(remaining_cores);
+
+    std::sort(groups.begin(), groups.end());
+    return groups;
+  }
+
+
+
+#if defined(DEAL_II_WITH_THREADS) && defined(__linux__)
+  // an observer of the TBB that sets the affinity mask of all threads
+  // entering the task scheduler
+  class AffinityObserver : public tbb::task_scheduler_observer
+  {
+  public:
+    void set_cores (const std::vector<unsigned int> &cores)
+    {
+      {
+        Threads::Mutex::ScopedLock lock(mutex);
+        CPU_ZERO (&mask);
+        for (unsigned int i=0; i<cores.size(); ++i)
+          if (cores[i] < CPU_SETSIZE)
+            CPU_SET (cores[i], &mask);
+        is_restricted = !cores.empty();
+        if (is_restricted)
+          sched_setaffinity (0, sizeof(mask), &mask);
+      }
+
+      // observe() calls on_scheduler_entry() for the calling thread, so the
+      // lock must be released at this point
+      observe (!cores.empty());
+    }
+
+    virtual void on_scheduler_entry (bool)
+    {
+      Threads::Mutex::ScopedLock lock(mutex);
+      if (is_restricted)
+        sched_setaffinity (0, sizeof(mask), &mask);
+    }
+
+  private:
+    Threads::Mutex mutex;
+    cpu_set_t      mask;
+    bool           is_restricted = false;
+  };
+
+  AffinityObserver &get_affinity_observer ()
+  {
+    static AffinityObserver observer;
+    return observer;
+  }
+#endif
+}
+
+
+
+std::vector<unsigned int>
+MultithreadInfo::available_cores ()
+{
+  std::vector<unsigned int> cores;
+#ifdef __linux__
+  cpu_set_t mask;
+  CPU_ZERO (&mask);
+  if (sched_getaffinity (0, sizeof(mask), &mask) == 0)
+    for (unsigned int core=0; core<CPU_SETSIZE; ++core)
+      if (CPU_ISSET (core, &mask))
+        cores.push_back(core);
+#endif
+  if (cores.empty())
+    for (unsigned int core=0; core<n_cores(); ++core)
+      cores.push_back(core);
+  return cores;
+}
+
+
+
+std::vector<std::vector<unsigned int> >
+MultithreadInfo::numa_domains ()
+{
+  std::vector<std::vector<unsigned int> > domains;
+  const std::vector<unsigned int> nodes = read_core_list("/sys/devices/system/node/online");
+  for (unsigned int i=0; i<nodes.size(); ++i)
+    domains.push_back(read_core_list("/sys/devices/system/node/node" +
+                                     Utilities::int_to_string(nodes[i]) +
+                                     "/cpulist"));
+  return group_cores (available_cores(), domains);
+}
+
+
+
+std::vector<std::vector<unsigned int> >
+MultithreadInfo::cache_groups ()
+{
+  const std::vector<unsigned int> cores = available_cores();
+  std::vector<std::vector<unsigned int> > caches;
+  for (unsigned int i=0; i<cores.size(); ++i)
+    {
+      // the entries of the cache directory are ordered by the cache level,
+      // so the last one is the last level cache
+      const std::string cache_directory = "/sys/devices/system/cpu/cpu" +
+                                          Utilities::int_to_string(cores[i]) +
+                                          "/cache/index";
+      std::vector<unsigned int> shared_cores;
+      for (unsigned int index=0; ; ++index)
+        {
+          const std::vector<unsigned int> list
+            = read_core_list(cache_directory + Utilities::int_to_string(index) +
+                             "/shared_cpu_list");
+          if (list.empty())
+            break;
+          shared_cores = list;
+        }
+      if (!shared_cores.empty() &&
+          std::find(caches.begin(), caches.end(), shared_cores) == caches.end())
+        caches.push_back(shared_cores);
+    }
+  return group_cores (cores, caches);
+}
+
+
+
+void
+MultithreadInfo::set_thread_affinity (const std::vector<unsigned int> &cores)
+{
+#if defined(DEAL_II_WITH_THREADS) && defined(__linux__)
+  get_affinity_observer().set_cores(cores);
+#elif defined(__linux__)
+  if (!cores.empty())
+    {
+      cpu_set_t mask;
+      CPU_ZERO (&mask);
+      for (unsigned int i=0; i<cores.size(); ++i)
+        if (cores[i] < CPU_SETSIZE)
+          CPU_SET (cores[i], &mask);
+      sched_setaffinity (0, sizeof(mask), &mask);
+    }
+#else
+  (void)cores;
+#endif
+}
+
+
 const unsigned int MultithreadInfo::n_cpus = MultithreadInfo::get_n_cpus();
 unsigned int MultithreadInfo::n_max_threads = numbers::invalid_unsigned_int;
 
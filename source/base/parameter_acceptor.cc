@@ -52,9 +52,11 @@ void
 ParameterAcceptor::initialize(const std::string &filename,
                               const std::string &output_filename,
                               const ParameterHandler::OutputStyle output_style_for_prm_format,
-                              ParameterHandler &prm)
+                              ParameterHandler &prm,
+                              const MPI_Comm &mpi_communicator)
 {
   declare_all_parameters(prm);
+  const bool is_root = (Utilities::MPI::this_mpi_process(mpi_communicator) == 0);
   if (filename != "")
     {
       // check the extension of input file
@@ -62,14 +64,17 @@ ParameterAcceptor::initialize(const std::string &filename,
         {
           try
             {
-              prm.parse_input(filename);
+              prm.parse_input(filename, mpi_communicator);
             }
           catch (const dealii::PathSearch::ExcFileNotFound &)
             {
-              std::ofstream out(filename);
-              Assert(out, ExcIO());
-              prm.print_parameters(out, ParameterHandler::Text);
-              out.close();
+              if (is_root)
+                {
+                  std::ofstream out(filename);
+                  Assert(out, ExcIO());
+                  prm.print_parameters(out, ParameterHandler::Text);
+                  out.close();
+                }
               AssertThrow(false, ExcMessage("You specified <"+filename+"> as input "+
                                             "parameter file, but it does not exist. " +
                                             "We created it for you."));
@@ -77,24 +82,29 @@ ParameterAcceptor::initialize(const std::string &filename,
         }
       else if (filename.substr(filename.find_last_of('.') + 1) == "xml")
         {
-          std::ifstream is(filename);
-          if (!is)
+          try
+            {
+              prm.parse_input_from_xml(filename, mpi_communicator);
+            }
+          catch (const dealii::ExcIO &)
             {
-              std::ofstream out(filename);
-              Assert(out, ExcIO());
-              prm.print_parameters(out, ParameterHandler::XML);
-              out.close();
+              if (is_root)
+                {
+                  std::ofstream out(filename);
+                  Assert(out, ExcIO());
+                  prm.print_parameters(out, ParameterHandler::XML);
+                  out.close();
+                }
               AssertThrow(false, ExcMessage("You specified <"+filename+"> as input "+
                                             "parameter file, but it does not exist. " +
                                             "We created it for you."));
             }
-          prm.parse_input_from_xml(is);
         }
       else
         AssertThrow(false, ExcMessage("Invalid extension of parameter file. Please use .prm or .xml"));
     }
 
-  if (output_filename != "")
+  if (output_filename != "" && is_root)
     {
       std::ofstream outfile(output_filename.c_str());
       Assert(outfile, ExcIO());
@@ -439,6 +439,94 @@ void ParameterHandler::parse_input (const std::string &filename,
 
 
 
+namespace
+{
+  // read the file with the given name on the root process of the given
+  // communicator and send its content to all other processes. the status of
+  // the root process is sent along, so that all processes can throw the same
+  // exception if the file can not be found or opened
+  std::string
+  read_file_on_root_process (const std::string &filename,
+                             const MPI_Comm    &mpi_communicator,
+                             const bool         use_path_search)
+  {
+    enum Status
+    {
+      file_read = 0,
+      file_not_found = 1,
+      file_not_readable = 2
+    };
+
+    int status = file_read;
+    std::string content;
+    if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
+      {
+        std::string openname = filename;
+        try
+          {
+            if (use_path_search)
+              openname = PathSearch("PARAMETERS").find(filename);
+          }
+        catch (const PathSearch::ExcFileNotFound &)
+          {
+            status = file_not_found;
+          }
+
+        if (status == file_read)
+          {
+            std::ifstream file_stream (openname.c_str());
+            if (file_stream)
+              {
+                std::ostringstream buffer;
+                buffer << file_stream.rdbuf();
+                content = buffer.str();
+              }
+            else
+              status = file_not_readable;
+          }
+      }
+
+#ifdef DEAL_II_WITH_MPI
+    if (Utilities::MPI::n_mpi_processes(mpi_communicator) > 1)
+      {
+        unsigned long long int header[2] = {static_cast<unsigned long long int>(status),
+                                            content.size()
+                                           };
+        int ierr = MPI_Bcast (header, 2, MPI_UNSIGNED_LONG_LONG, 0, mpi_communicator);
+        AssertThrowMPI(ierr);
+        status = header[0];
+        AssertThrow (header[1] < static_cast<unsigned long long int>(std::numeric_limits<int>::max()),
+                     ExcMessage("Parameter files of more than 2 GB can not be broadcast."));
+        content.resize(header[1]);
+        if (header[1] > 0)
+          {
+            ierr = MPI_Bcast (&content[0], header[1], MPI_CHAR, 0, mpi_communicator);
+            AssertThrowMPI(ierr);
+          }
+      }
+#endif
+
+    AssertThrow (status != file_not_found,
+                 PathSearch::ExcFileNotFound(filename, "PARAMETERS"));
+    AssertThrow (status != file_not_readable, ExcIO());
+    return content;
+  }
+}
+
+
+
+void ParameterHandler::parse_input (const std::string &filename,
+                                    const MPI_Comm    &mpi_communicator,
+                                    const std::string &last_line)
+{
+  std::istringstream input_stream (read_file_on_root_process (filename,
+                                                              mpi_communicator,
+                                                              true));
+  parse_input (input_stream, filename, last_line);
+}
+
+
+
 void
 ParameterHandler::parse_input_from_string (const char *s,
                                            const std::string &last_line)
@@ -586,6 +674,17 @@ void ParameterHandler::parse_input_from_xml (std::istream &in)
 
 
 
+void ParameterHandler::parse_input_from_xml (const std::string &filename,
+                                             const MPI_Comm    &mpi_communicator)
+{
+  std::istringstream input_stream (read_file_on_root_process (filename,
+                                                              mpi_communicator,
+                                                              false));
+  parse_input_from_xml (input_stream);
+}
+
+
+
 void ParameterHandler::clear ()
 {
   entries.reset (new boost::property_tree::ptree());
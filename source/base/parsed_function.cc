@@ -169,6 +169,25 @@ namespace Functions
 
 
 
+  template <int dim>
+  void ParsedFunction<dim>::value_list (const std::vector<Point<dim> > &points,
+                                        std::vector<double>            &values,
+                                        const unsigned int              comp) const
+  {
+    function_object.value_list(points, values, comp);
+  }
+
+
+
+  template <int dim>
+  void ParsedFunction<dim>::vector_value_list (const std::vector<Point<dim> > &points,
+                                               std::vector<Vector<double> >   &values) const
+  {
+    function_object.vector_value_list(points, values);
+  }
+
+
+
   template <int dim>
   void ParsedFunction<dim>::set_time (const double newtime)
   {
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2016 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -16,12 +16,103 @@
 #include <deal.II/base/partitioner.h>
 #include <deal.II/base/partitioner.templates.h>
 
+#include <map>
+
 DEAL_II_NAMESPACE_OPEN
 
 namespace Utilities
 {
   namespace MPI
   {
+#ifdef DEAL_II_WITH_MPI
+    PersistentRequests::PersistentRequests ()
+      :
+      partitioner (nullptr),
+      communication_channel (0),
+      number_size (0),
+      send_array (nullptr),
+      receive_array (nullptr),
+      ghost_array_size (0)
+    {}
+
+
+
+    PersistentRequests::~PersistentRequests ()
+    {
+      clear();
+    }
+
+
+
+    void
+    PersistentRequests::clear ()
+    {
+      // the requests of vectors that are destroyed after MPI_Finalize() have
+      // already been deallocated by MPI
+      int finalized = 0;
+      if (requests.size() > 0)
+        {
+          const int ierr = MPI_Finalized(&finalized);
+          AssertThrowMPI(ierr);
+        }
+      if (finalized == 0)
+        for (unsigned int i=0; i<requests.size(); ++i)
+          if (requests[i] != MPI_REQUEST_NULL)
+            {
+              const int ierr = MPI_Request_free(&requests[i]);
+              AssertThrowMPI(ierr);
+            }
+      requests.clear();
+      partitioner = nullptr;
+      send_array = nullptr;
+      receive_array = nullptr;
+    }
+
+
+
+    void
+    PersistentRequests::swap (PersistentRequests &other)
+    {
+      std::swap (requests, other.requests);
+      std::swap (partitioner, other.partitioner);
+      std::swap (communication_channel, other.communication_channel);
+      std::swap (number_size, other.number_size);
+      std::swap (send_array, other.send_array);
+      std::swap (receive_array, other.receive_array);
+      std::swap (ghost_array_size, other.ghost_array_size);
+    }
+
+
+
+    bool
+    PersistentRequests::check_and_bind (const Partitioner *partitioner_in,
+                                        const unsigned int communication_channel_in,
+                                        const std::size_t  number_size_in,
+                                        const void        *send_array_in,
+                                        const void        *receive_array_in,
+                                        const std::size_t  ghost_array_size_in)
+    {
+      if (partitioner_in == partitioner &&
+          communication_channel_in == communication_channel &&
+          number_size_in == number_size &&
+          send_array_in == send_array &&
+          receive_array_in == receive_array &&
+          ghost_array_size_in == ghost_array_size)
+        return true;
+
+      clear();
+      partitioner = partitioner_in;
+      communication_channel = communication_channel_in;
+      number_size = number_size_in;
+      send_array = send_array_in;
+      receive_array = receive_array_in;
+      ghost_array_size = ghost_array_size_in;
+      return false;
+    }
+#endif
+
+
+
     Partitioner::Partitioner ()
       :
       global_size (0),
@@ -261,26 +352,25 @@ namespace Utilities
             n_ghost_indices_data - ghost_targets_temp[n_ghost_targets-1].second;
           ghost_targets_data = ghost_targets_temp;
         }
-      // find the processes that want to import to me
+      // find the processes that want to import to me by sending the number
+      // of ghost indices to each owner in a sparse data exchange
       {
-        std::vector<int> send_buffer (n_procs, 0);
-        std::vector<int> receive_buffer (n_procs, 0);
+        std::map<unsigned int, std::vector<unsigned int> > send_data;
         for (unsigned int i=0; i<n_ghost_targets; i++)
-          send_buffer[ghost_targets_data[i].first] = ghost_targets_data[i].second;
+          send_data[ghost_targets_data[i].first].push_back(ghost_targets_data[i].second);
 
-        const int ierr = MPI_Alltoall (send_buffer.data(), 1, MPI_INT, receive_buffer.data(), 1,
-                                       MPI_INT, communicator);
-        AssertThrowMPI(ierr);
+        const std::map<unsigned int, std::vector<unsigned int> > received_data =
+          Utilities::MPI::sparse_data_exchange(communicator, send_data);
 
-        // allocate memory for import data
+        // allocate memory for import data. the map is sorted by rank
         std::vector<std::pair<unsigned int,unsigned int> > import_targets_temp;
         n_import_indices_data = 0;
-        for (unsigned int i=0; i<n_procs; i++)
-          if (receive_buffer[i] > 0)
-            {
-              n_import_indices_data += receive_buffer[i];
-              import_targets_temp.emplace_back(i, receive_buffer[i]);
-            }
+        for (const auto &rank_and_size : received_data)
+          {
+            AssertDimension(rank_and_size.second.size(), 1);
+            n_import_indices_data += rank_and_size.second[0];
+            import_targets_temp.emplace_back(rank_and_size.first, rank_and_size.second[0]);
+          }
         // copy, don't move, to get deterministic memory usage.
         import_targets_data = import_targets_temp;
       }
@@ -475,6 +565,199 @@ namespace Utilities
       return memory;
     }
 
+
+
+    MemoryReport
+    Partitioner::memory_report() const
+    {
+      MemoryReport report ("Partitioner",
+                           3*sizeof(types::global_dof_index)+4*sizeof(unsigned int)+
+                           sizeof(MPI_Comm));
+      report.add ("index sets",
+                  MemoryConsumption::memory_consumption(locally_owned_range_data) +
+                  MemoryConsumption::memory_consumption(ghost_indices_data) +
+                  MemoryConsumption::memory_consumption(ghost_indices_subset_data));
+      report.add ("import targets and indices",
+                  MemoryConsumption::memory_consumption(import_targets_data) +
+                  MemoryConsumption::memory_consumption(import_indices_data) +
+                  MemoryConsumption::memory_consumption(import_indices_chunks_by_rank_data));
+      report.add ("ghost targets",
+                  MemoryConsumption::memory_consumption(ghost_targets_data) +
+                  MemoryConsumption::memory_consumption(ghost_indices_subset_chunks_by_rank_data));
+      return report;
+    }
+
+
+
+
+#ifdef DEAL_II_WITH_MPI
+
+    SharedMemoryExchange::SharedMemoryExchange (const std::shared_ptr<const Partitioner> &partitioner,
+                                                const MPI_Comm                            communicator_sm)
+      :
+      partitioner (partitioner),
+      communicator_sm (communicator_sm)
+    {
+      Assert (partitioner.get() != nullptr, ExcNotInitialized());
+
+      // collect the rank within the communicator of the partitioner, the
+      // number of locally owned entries and the first locally owned index of
+      // all processes on the node
+      const unsigned int n_procs_sm = n_mpi_processes(communicator_sm);
+      const unsigned int my_rank_sm = this_mpi_process(communicator_sm);
+      const unsigned int my_rank = partitioner->this_mpi_process();
+      const unsigned int my_local_size = partitioner->local_size();
+      const types::global_dof_index my_first_index = partitioner->local_range().first;
+      std::vector<unsigned int> ranks(n_procs_sm), local_sizes(n_procs_sm);
+      std::vector<types::global_dof_index> first_indices(n_procs_sm);
+      int ierr = MPI_Allgather(&my_rank, 1, MPI_UNSIGNED, ranks.data(), 1,
+                               MPI_UNSIGNED, communicator_sm);
+      AssertThrowMPI(ierr);
+      ierr = MPI_Allgather(&my_local_size, 1, MPI_UNSIGNED, local_sizes.data(),
+                           1, MPI_UNSIGNED, communicator_sm);
+      AssertThrowMPI(ierr);
+      ierr = MPI_Allgather(&my_first_index, 1, DEAL_II_DOF_INDEX_MPI_TYPE,
+                           first_indices.data(), 1, DEAL_II_DOF_INDEX_MPI_TYPE,
+                           communicator_sm);
+      AssertThrowMPI(ierr);
+
+      std::map<unsigned int, unsigned int> rank_to_rank_sm;
+      for (unsigned int p=0; p<n_procs_sm; ++p)
+        rank_to_rank_sm[ranks[p]] = p;
+      AssertThrow(rank_to_rank_sm.size() == n_procs_sm &&
+                  rank_to_rank_sm[my_rank] == my_rank_sm,
+                  ExcMessage("The shared memory communicator must contain a "
+                             "subset of the processes of the communicator of "
+                             "the partitioner."));
+
+      // go through the ghost entries owned by each process. the ones from
+      // processes on the node are read directly from their memory, all
+      // others are collected for the remote partitioner. we also record
+      // where the ghosts from the other processes on the node start, to
+      // tell them where to find the data they need to import
+      const IndexSet &ghost_indices = partitioner->ghost_indices();
+      std::vector<types::global_dof_index> remote_ghost_indices;
+      std::vector<unsigned int> ghost_offsets(n_procs_sm, 0);
+      unsigned int offset = 0;
+      for (const auto &ghost_target : partitioner->ghost_targets())
+        {
+          const auto rank_sm = rank_to_rank_sm.find(ghost_target.first);
+          for (unsigned int i=offset; i<offset+ghost_target.second; ++i)
+            {
+              const types::global_dof_index index = ghost_indices.nth_index_in_set(i);
+              if (rank_sm == rank_to_rank_sm.end())
+                remote_ghost_indices.push_back(index);
+              else
+                {
+                  const unsigned int remote_index = index - first_indices[rank_sm->second];
+                  if (ghost_transfers.empty() == false &&
+                      ghost_transfers.back().rank == rank_sm->second &&
+                      ghost_transfers.back().local_start + ghost_transfers.back().length == i &&
+                      ghost_transfers.back().remote_start + ghost_transfers.back().length == remote_index)
+                    ++ghost_transfers.back().length;
+                  else
+                    ghost_transfers.push_back(Transfer{rank_sm->second, i, remote_index, 1});
+                }
+            }
+          if (rank_sm != rank_to_rank_sm.end())
+            ghost_offsets[rank_sm->second] = offset;
+          offset += ghost_target.second;
+        }
+      AssertDimension(offset, partitioner->n_ghost_indices());
+
+      std::vector<unsigned int> all_ghost_offsets(n_procs_sm*n_procs_sm);
+      ierr = MPI_Allgather(ghost_offsets.data(), n_procs_sm, MPI_UNSIGNED,
+                           all_ghost_offsets.data(), n_procs_sm, MPI_UNSIGNED,
+                           communicator_sm);
+      AssertThrowMPI(ierr);
+
+      // the entries imported from another process on the node are the
+      // entries of its ghost array that start at the offset it has sent us.
+      // the import indices are stored in chunks for each process in the
+      // order of the import targets
+      std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
+      import_range = partitioner->import_indices().begin();
+      unsigned int position_in_range = 0;
+      for (const auto &import_target : partitioner->import_targets())
+        {
+          const auto rank_sm = rank_to_rank_sm.find(import_target.first);
+          unsigned int remote_start = rank_sm == rank_to_rank_sm.end() ? 0 :
+                                      local_sizes[rank_sm->second] +
+                                      all_ghost_offsets[rank_sm->second*n_procs_sm+my_rank_sm];
+          unsigned int n_remaining = import_target.second;
+          while (n_remaining > 0)
+            {
+              Assert(import_range != partitioner->import_indices().end(),
+                     ExcInternalError());
+              const unsigned int length =
+                std::min(n_remaining, import_range->second - import_range->first -
+                         position_in_range);
+              if (rank_sm != rank_to_rank_sm.end())
+                {
+                  import_transfers.push_back(Transfer{rank_sm->second,
+                                                      import_range->first+position_in_range,
+                                                      remote_start, length
+                                                     });
+                  remote_start += length;
+                }
+              n_remaining -= length;
+              position_in_range += length;
+              if (position_in_range == import_range->second - import_range->first)
+                {
+                  ++import_range;
+                  position_in_range = 0;
+                }
+            }
+        }
+
+      // set up the partitioner for the exchange with other nodes, with the
+      // ghost indices of the full partitioner as the larger set
+      IndexSet remote_ghosts(partitioner->size());
+      remote_ghosts.add_indices(remote_ghost_indices.begin(), remote_ghost_indices.end());
+      remote_ghosts.compress();
+      std::shared_ptr<Partitioner> remote
+      (new Partitioner(partitioner->locally_owned_range(),
+                       partitioner->get_mpi_communicator()));
+      remote->set_ghost_indices(remote_ghosts, ghost_indices);
+      remote_partitioner = remote;
+    }
+
+
+
+    const std::shared_ptr<const Partitioner> &
+    SharedMemoryExchange::get_partitioner () const
+    {
+      return partitioner;
+    }
+
+
+
+    const Partitioner &
+    SharedMemoryExchange::get_remote_partitioner () const
+    {
+      return *remote_partitioner;
+    }
+
+
+
+    const MPI_Comm &
+    SharedMemoryExchange::get_shared_memory_communicator () const
+    {
+      return communicator_sm;
+    }
+
+
+
+    std::size_t
+    SharedMemoryExchange::memory_consumption () const
+    {
+      return (sizeof(*this) +
+              remote_partitioner->memory_consumption() +
+              (ghost_transfers.capacity() + import_transfers.capacity()) * sizeof(Transfer));
+    }
+
+#endif
+
   } // end of namespace MPI
 
 } // end of namespace Utilities
@@ -484,4 +767,19 @@ namespace Utilities
 // explicit instantiations from .templates.h file
 #include "partitioner.inst"
 
+#ifdef DEAL_II_WITH_MPI
+// the ghost exchange of LinearAlgebra::distributed::Vector<double> in single
+// precision
+template void Utilities::MPI::Partitioner::export_to_ghosted_array_start<double,float>(const unsigned int ,
+    const ArrayView<const double> &,
+    const ArrayView<float> &,
+    const ArrayView<float> &,
+    std::vector<MPI_Request> &) const;
+template void Utilities::MPI::Partitioner::import_from_ghosted_array_finish<double,float>(const VectorOperation::values ,
+    const ArrayView<const float> &,
+    const ArrayView<double> &,
+    const ArrayView<float> &,
+    std::vector<MPI_Request> &) const;
+#endif
+
 DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,79 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/performance_counters.h>
+
+#ifdef DEAL_II_WITH_LIKWID
+
+#include <deal.II/base/thread_local_storage.h>
+
+#include <likwid.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace PerformanceCounters
+{
+  namespace
+  {
+    /**
+     * The marker API needs to be initialized on each thread that enters a
+     * region. Keep track of the threads that have done so.
+     */
+    Threads::ThreadLocalStorage<bool> thread_is_initialized (false);
+  }
+
+
+
+  void
+  initialize ()
+  {
+    likwid_markerInit();
+  }
+
+
+
+  void
+  finalize ()
+  {
+    likwid_markerClose();
+  }
+
+
+
+  void
+  start_region (const char *region_name)
+  {
+    bool &is_initialized = thread_is_initialized.get();
+    if (is_initialized == false)
+      {
+        likwid_markerThreadInit();
+        is_initialized = true;
+      }
+
+    likwid_markerStartRegion(region_name);
+  }
+
+
+
+  void
+  stop_region (const char *region_name)
+  {
+    likwid_markerStopRegion(region_name);
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
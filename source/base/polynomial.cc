@@ -217,27 +217,30 @@ namespace Polynomials
       };
 
     // if there are derivatives needed, then do it properly by the full Horner
-    // scheme
-    const unsigned int m=coefficients.size();
-    std::vector<number> a(coefficients);
-    unsigned int j_faculty=1;
-
-    // loop over all requested derivatives. note that derivatives @p{j>m} are
+    // scheme. compute the scaled derivatives p^(j)(x)/j! in place in the
+    // output array rather than on a copy of the coefficients, which would
+    // require a memory allocation for every call. derivatives @p{j>=m} are
     // necessarily zero, as they differentiate the polynomial more often than
     // the highest power is
+    const unsigned int m=coefficients.size();
     const unsigned int min_valuessize_m=std::min(n_derivatives+1, m);
-    for (unsigned int j=0; j<min_valuessize_m; ++j)
+    values[0] = coefficients[m-1];
+    for (unsigned int j=1; j<=n_derivatives; ++j)
+      values[j] = 0;
+    for (int k=m-2; k>=0; --k)
       {
-        for (int k=m-2; k>=static_cast<int>(j); --k)
-          a[k]+=x*a[k+1];
-        values[j]=static_cast<number>(j_faculty)*a[j];
-
-        j_faculty*=j+1;
+        for (unsigned int j=std::min(min_valuessize_m-1,
+                                     static_cast<unsigned int>(m-1-k)); j>0; --j)
+          values[j] = values[j]*x + values[j-1];
+        values[0] = values[0]*x + coefficients[k];
       }
 
-    // fill higher derivatives by zero
-    for (unsigned int j=min_valuessize_m; j<=n_derivatives; ++j)
-      values[j] = 0;
+    number j_faculty=1;
+    for (unsigned int j=2; j<min_valuessize_m; ++j)
+      {
+        j_faculty *= static_cast<number>(j);
+        values[j] *= j_faculty;
+      }
   }
 
 
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1998 - 2016 by the deal.II authors
+// Copyright (C) 1998 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -23,6 +23,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <iterator>
+#include <limits>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -282,7 +283,7 @@ Quadrature<dim>::Quadrature (const Quadrature<dim> &q)
   is_tensor_product_flag (q.is_tensor_product_flag)
 {
   if (dim>1 && is_tensor_product_flag)
-    tensor_basis = std_cxx14::make_unique<std::array<Quadrature<1>, dim>> (*q.tensor_basis);
+    tensor_basis = q.tensor_basis;
 }
 
 
@@ -295,12 +296,9 @@ Quadrature<dim>::operator= (const Quadrature<dim> &q)
   quadrature_points = q.quadrature_points;
   is_tensor_product_flag = q.is_tensor_product_flag;
   if (dim >1 && is_tensor_product_flag)
-    {
-      if (tensor_basis == nullptr)
-        tensor_basis = std_cxx14::make_unique<std::array<Quadrature<1>, dim>> (*q.tensor_basis);
-      else
-        *tensor_basis = *q.tensor_basis;
-    }
+    tensor_basis = q.tensor_basis;
+  else
+    tensor_basis.reset();
   return *this;
 }
 
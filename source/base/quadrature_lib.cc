@@ -15,11 +15,13 @@
 
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/geometry_info.h>
+#include <deal.II/base/thread_management.h>
 
 #include <cmath>
 #include <limits>
 #include <algorithm>
 #include <functional>
+#include <map>
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -30,6 +32,111 @@ DEAL_II_NAMESPACE_OPEN
 // is for deal_II_dimension >= any_number and not for ==
 
 
+namespace internal
+{
+  namespace QuadratureImplementation
+  {
+    /**
+     * The families of quadrature formulas that are kept in the cache.
+     */
+    enum class RuleType
+    {
+      gauss,
+      gauss_lobatto
+    };
+
+
+
+    /**
+     * A cache of the quadrature formulas of one dimension, keyed by the
+     * family and the number of points in each direction. Entries are never
+     * removed, so pointers to them stay valid until the end of the program.
+     */
+    template <int dim>
+    struct RuleCache
+    {
+      Threads::Mutex mutex;
+
+      std::map<std::pair<RuleType,unsigned int>,
+          std::unique_ptr<const Quadrature<dim> > > rules;
+    };
+
+
+
+    template <int dim>
+    RuleCache<dim> &
+    get_rule_cache ()
+    {
+      static RuleCache<dim> cache;
+      return cache;
+    }
+
+
+
+    /**
+     * Return a pointer to the cached formula, or nullptr if it has not been
+     * computed yet.
+     */
+    template <int dim>
+    const Quadrature<dim> *
+    find_rule (const RuleType     type,
+               const unsigned int n)
+    {
+      RuleCache<dim> &cache = get_rule_cache<dim>();
+      Threads::Mutex::ScopedLock lock (cache.mutex);
+      const auto entry = cache.rules.find (std::make_pair(type, n));
+      return entry == cache.rules.end() ? nullptr : entry->second.get();
+    }
+
+
+
+    /**
+     * Put a copy of the given formula into the cache unless another thread
+     * has done so in the meantime, and return the cached formula.
+     */
+    template <int dim>
+    const Quadrature<dim> &
+    store_rule (const RuleType         type,
+                const unsigned int     n,
+                const Quadrature<dim> &rule)
+    {
+      RuleCache<dim> &cache = get_rule_cache<dim>();
+      Threads::Mutex::ScopedLock lock (cache.mutex);
+      std::unique_ptr<const Quadrature<dim> > &entry
+        = cache.rules[std::make_pair(type, n)];
+      if (entry == nullptr)
+        entry.reset (new Quadrature<dim>(rule));
+      return *entry;
+    }
+
+
+
+    /**
+     * Return the cached tensor product formula of the given family in
+     * dimension @p dim, computing it from the (cached) formulas in lower
+     * dimensions in case it is not available yet. Since the computation of
+     * the tensor product happens outside the lock, two threads may compute
+     * the same formula at the same time, but only one of them is stored.
+     */
+    template <int dim>
+    const Quadrature<dim> &
+    get_tensor_product_rule (const RuleType     type,
+                             const unsigned int n)
+    {
+      if (const Quadrature<dim> *rule = find_rule<dim>(type, n))
+        return *rule;
+
+      if (type == RuleType::gauss)
+        return store_rule<dim>(type, n, Quadrature<dim>(QGauss<dim-1>(n),
+                                                        QGauss<1>(n)));
+      else
+        return store_rule<dim>(type, n, Quadrature<dim>(QGaussLobatto<dim-1>(n),
+                                                        QGaussLobatto<1>(n)));
+    }
+  }
+}
+
+
 
 template <>
 QGauss<0>::QGauss (const unsigned int)
@@ -67,6 +174,14 @@ QGauss<1>::QGauss (const unsigned int n)
   if (n == 0)
     return;
 
+  if (const Quadrature<1> *rule =
+        internal::QuadratureImplementation::find_rule<1>
+        (internal::QuadratureImplementation::RuleType::gauss, n))
+    {
+      Quadrature<1>::operator= (*rule);
+      return;
+    }
+
   const unsigned int m = (n+1)/2;
 
   // tolerance for the Newton
@@ -159,6 +274,9 @@ QGauss<1>::QGauss (const unsigned int n)
       this->weights[i-1] = w;
       this->weights[n-i] = w;
     }
+
+  internal::QuadratureImplementation::store_rule<1>
+  (internal::QuadratureImplementation::RuleType::gauss, n, *this);
 }
 
 
@@ -169,6 +287,14 @@ QGaussLobatto<1>::QGaussLobatto (const unsigned int n)
 {
   Assert (n >= 2, ExcNotImplemented());
 
+  if (const Quadrature<1> *rule =
+        internal::QuadratureImplementation::find_rule<1>
+        (internal::QuadratureImplementation::RuleType::gauss_lobatto, n))
+    {
+      Quadrature<1>::operator= (*rule);
+      return;
+    }
+
   std::vector<long double> points  = compute_quadrature_points(n, 1, 1);
   std::vector<long double> w       = compute_quadrature_weights(points, 0, 0);
 
@@ -179,6 +305,9 @@ QGaussLobatto<1>::QGaussLobatto (const unsigned int n)
       this->quadrature_points[i] = Point<1>(0.5 + 0.5*static_cast<double>(points[i]));
       this->weights[i]           = 0.5*w[i];
     }
+
+  internal::QuadratureImplementation::store_rule<1>
+  (internal::QuadratureImplementation::RuleType::gauss_lobatto, n, *this);
 }
 
 
@@ -969,14 +1098,16 @@ bool QSorted<dim>::compare_weights(const unsigned int a,
 
 template <int dim>
 QGauss<dim>::QGauss (const unsigned int n)
-  :  Quadrature<dim> (QGauss<dim-1>(n), QGauss<1>(n))
+  :  Quadrature<dim> (internal::QuadratureImplementation::get_tensor_product_rule<dim>
+                      (internal::QuadratureImplementation::RuleType::gauss, n))
 {}
 
 
 
 template <int dim>
 QGaussLobatto<dim>::QGaussLobatto (const unsigned int n)
-  :  Quadrature<dim> (QGaussLobatto<dim-1>(n), QGaussLobatto<1>(n))
+  :  Quadrature<dim> (internal::QuadratureImplementation::get_tensor_product_rule<dim>
+                      (internal::QuadratureImplementation::RuleType::gauss_lobatto, n))
 {}
 
 
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2000 - 2016 by the deal.II authors
+// Copyright (C) 2000 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -167,15 +167,8 @@ TensorProductPolynomials<dim,PolynomialType>::compute_grad (const unsigned int
   // the given point in each
   // co-ordinate direction
   double v [dim][2];
-  {
-    std::vector<double> tmp (2);
-    for (unsigned int d=0; d<dim; ++d)
-      {
-        polynomials[indices[d]].value (p(d), tmp);
-        v[d][0] = tmp[0];
-        v[d][1] = tmp[1];
-      }
-  }
+  for (unsigned int d=0; d<dim; ++d)
+    polynomials[indices[d]].value (p(d), 1, &v[d][0]);
 
   Tensor<1,dim> grad;
   for (unsigned int d=0; d<dim; ++d)
@@ -200,16 +193,8 @@ TensorProductPolynomials<dim,PolynomialType>::compute_grad_grad
   compute_index (i, indices);
 
   double v [dim][3];
-  {
-    std::vector<double> tmp (3);
-    for (unsigned int d=0; d<dim; ++d)
-      {
-        polynomials[indices[d]].value (p(d), tmp);
-        v[d][0] = tmp[0];
-        v[d][1] = tmp[1];
-        v[d][2] = tmp[2];
-      }
-  }
+  for (unsigned int d=0; d<dim; ++d)
+    polynomials[indices[d]].value (p(d), 2, &v[d][0]);
 
   Tensor<2,dim> grad_grad;
   for (unsigned int d1=0; d1<dim; ++d1)
@@ -457,9 +442,9 @@ AnisotropicPolynomials<dim>::compute_grad (const unsigned int i,
   // uni-directional derivatives at
   // the given point in each
   // co-ordinate direction
-  std::vector<std::vector<double> > v(dim, std::vector<double> (2));
+  double v [dim][2];
   for (unsigned int d=0; d<dim; ++d)
-    polynomials[d][indices[d]].value(p(d), v[d]);
+    polynomials[d][indices[d]].value(p(d), 1, &v[d][0]);
 
   Tensor<1,dim> grad;
   for (unsigned int d=0; d<dim; ++d)
@@ -481,9 +466,9 @@ AnisotropicPolynomials<dim>::compute_grad_grad (const unsigned int i,
   unsigned int indices[dim];
   compute_index (i, indices);
 
-  std::vector<std::vector<double> > v(dim, std::vector<double> (3));
+  double v [dim][3];
   for (unsigned int d=0; d<dim; ++d)
-    polynomials[d][indices[d]].value(p(d), v[d]);
+    polynomials[d][indices[d]].value(p(d), 2, &v[d][0]);
 
   Tensor<2,dim> grad_grad;
   for (unsigned int d1=0; d1<dim; ++d1)
@@ -551,21 +536,21 @@ compute (const Point<dim>            &p,
     n_values_and_derivatives = 4;
   if (update_4th_derivatives)
     n_values_and_derivatives = 5;
-
-  // compute the values (and
-  // derivatives, if necessary) of
-  // all polynomials at this
-  // evaluation point
-  std::vector<std::vector<std::vector<double> > > v(dim);
+  if (n_values_and_derivatives == 0)
+    return;
+
+  // compute the values (and derivatives, if necessary) of all polynomials
+  // at this evaluation point. the storage for all directions is allocated
+  // in one chunk, and on the stack for moderate polynomial degrees
+  unsigned int offsets[dim+1];
+  offsets[0] = 0;
   for (unsigned int d=0; d<dim; ++d)
-    {
-      v[d].resize (polynomials[d].size());
-      for (unsigned int i=0; i<polynomials[d].size(); ++i)
-        {
-          v[d][i].resize (n_values_and_derivatives, 0.);
-          polynomials[d][i].value(p(d), v[d][i]);
-        };
-    }
+    offsets[d+1] = offsets[d] + polynomials[d].size();
+  boost::container::small_vector<std::array<double,5>, 3*20> v(offsets[dim]);
+  for (unsigned int d=0; d<dim; ++d)
+    for (unsigned int i=0; i<polynomials[d].size(); ++i)
+      polynomials[d][i].value(p(d), n_values_and_derivatives-1,
+                              &v[offsets[d]+i][0]);
 
   for (unsigned int i=0; i<n_tensor_pols; ++i)
     {
@@ -580,7 +565,7 @@ compute (const Point<dim>            &p,
         {
           values[i] = 1;
           for (unsigned int x=0; x<dim; ++x)
-            values[i] *= v[x][indices[x]][0];
+            values[i] *= v[offsets[x]+indices[x]][0];
         }
 
       if (update_grads)
@@ -588,7 +573,7 @@ compute (const Point<dim>            &p,
           {
             grads[i][d] = 1.;
             for (unsigned int x=0; x<dim; ++x)
-              grads[i][d] *= v[x][indices[x]][d==x ? 1 : 0];
+              grads[i][d] *= v[offsets[x]+indices[x]][d==x ? 1 : 0];
           }
 
       if (update_grad_grads)
@@ -603,7 +588,7 @@ compute (const Point<dim>            &p,
                   if (d2==x) ++derivative;
 
                   grad_grads[i][d1][d2]
-                  *= v[x][indices[x]][derivative];
+                  *= v[offsets[x]+indices[x]][derivative];
                 }
             }
 
@@ -621,7 +606,7 @@ compute (const Point<dim>            &p,
                     if (d3==x) ++derivative;
 
                     third_derivatives[i][d1][d2][d3]
-                    *= v[x][indices[x]][derivative];
+                    *= v[offsets[x]+indices[x]][derivative];
                   }
               }
 
@@ -641,7 +626,7 @@ compute (const Point<dim>            &p,
                       if (d4==x) ++derivative;
 
                       fourth_derivatives[i][d1][d2][d3][d4]
-                      *= v[x][indices[x]][derivative];
+                      *= v[offsets[x]+indices[x]][derivative];
                     }
                 }
     }
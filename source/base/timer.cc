@@ -351,7 +351,7 @@ TimerOutput::~TimerOutput()
 {
   try
     {
-      while (active_sections.size() > 0)
+      while (thread_data.get().active_sections.size() > 0)
         leave_subsection();
     }
   catch (...)
@@ -364,44 +364,110 @@ TimerOutput::~TimerOutput()
 
 
 
-void
-TimerOutput::enter_subsection (const std::string &section_name)
+TimerOutput::CallTreeNode::CallTreeNode (const unsigned int section,
+                                         const unsigned int parent)
+  :
+  section (section),
+  parent (parent)
 {
-  Threads::Mutex::ScopedLock lock (mutex);
+  data.total_cpu_time = 0;
+  data.total_wall_time = 0;
+  data.n_calls = 0;
+}
+
+
+
+TimerOutput::ThreadData::ThreadData ()
+{
+  call_tree.emplace_back(numbers::invalid_unsigned_int,
+                         numbers::invalid_unsigned_int);
+}
 
+
+
+TimerOutput::SectionHandle
+TimerOutput::register_section (const std::string &section_name)
+{
   Assert (section_name.empty() == false,
           ExcMessage ("Section string is empty."));
 
-  Assert (std::find (active_sections.begin(), active_sections.end(),
-                     section_name) == active_sections.end(),
-          ExcMessage (std::string("Cannot enter the already active section <")
-                      + section_name + ">."));
+  Threads::Mutex::ScopedLock lock (mutex);
+
+  const auto position = section_indices.find(section_name);
+  if (position != section_indices.end())
+    return SectionHandle(position->second, &position->first);
+
+  const unsigned int index = section_names.size();
+  section_names.push_back(section_name);
+  const auto inserted = section_indices.insert(std::make_pair(section_name, index));
+  return SectionHandle(index, &inserted.first->first);
+}
+
+
 
-  if (sections.find (section_name) == sections.end())
+void
+TimerOutput::enter_subsection (const std::string &section_name)
+{
+  enter_subsection(register_section(section_name));
+}
+
+
+
+void
+TimerOutput::enter_subsection (const SectionHandle &section)
+{
+  Assert (section.index != numbers::invalid_unsigned_int,
+          ExcMessage ("Cannot enter a section through an invalid handle."));
+
+  ThreadData &data = thread_data.get();
+  for (const ActiveSection &active : data.active_sections)
     {
-      if (mpi_communicator != MPI_COMM_SELF)
-        {
-          // create a new timer for this section. the second argument
-          // will ensure that we have an MPI barrier before starting
-          // and stopping a timer, and this ensures that we get the
-          // maximum run time for this section over all processors.
-          // The mpi_communicator from TimerOutput is passed to the
-          // Timer here, so this Timer will collect timing information
-          // among all processes inside mpi_communicator.
-          sections[section_name].timer = Timer(mpi_communicator, true);
-        }
+      (void)active;
+      Assert (active.section != section.index,
+              ExcMessage (std::string("Cannot enter the already active section <")
+                          + *section.name + ">."));
+    }
 
+  // find the node of this section below the node of the innermost active
+  // section, or create it
+  const unsigned int parent = data.active_sections.empty() ? 0 :
+                              data.active_sections.back().node;
+  unsigned int node = numbers::invalid_unsigned_int;
+  for (const unsigned int child : data.call_tree[parent].children)
+    if (data.call_tree[child].section == section.index)
+      {
+        node = child;
+        break;
+      }
+  if (node == numbers::invalid_unsigned_int)
+    {
+      node = data.call_tree.size();
+      data.call_tree.emplace_back(section.index, parent);
+      data.call_tree[parent].children.push_back(node);
+    }
+  ++data.call_tree[node].data.n_calls;
 
-      sections[section_name].total_cpu_time = 0;
-      sections[section_name].total_wall_time = 0;
-      sections[section_name].n_calls = 0;
+  // with a communicator, place a barrier before starting the time
+  // measurement, such that the times are the maximum run time for this
+  // section over all processors
+#ifdef DEAL_II_WITH_MPI
+  if (mpi_communicator != MPI_COMM_SELF)
+    {
+      const int ierr = MPI_Barrier(mpi_communicator);
+      AssertThrowMPI(ierr);
     }
+#endif
 
-  sections[section_name].timer.reset();
-  sections[section_name].timer.start();
-  sections[section_name].n_calls++;
+  PerformanceCounters::start_region(section.name->c_str());
 
-  active_sections.push_back (section_name);
+  ActiveSection active;
+  active.section = section.index;
+  active.name = section.name;
+  active.node = node;
+  active.wall_start_time = std::chrono::steady_clock::now();
+  if (output_type != wall_times)
+    active.cpu_start_time = CPUClock::now();
+  data.active_sections.push_back(active);
 }
 
 
@@ -409,36 +475,75 @@ TimerOutput::enter_subsection (const std::string &section_name)
 void
 TimerOutput::leave_subsection (const std::string &section_name)
 {
-  Assert (!active_sections.empty(),
+  Assert (!thread_data.get().active_sections.empty(),
           ExcMessage("Cannot exit any section because none has been entered!"));
 
-  Threads::Mutex::ScopedLock lock (mutex);
+  // if no string is given, exit the last active section
+  if (section_name == "")
+    {
+      const ActiveSection &active = thread_data.get().active_sections.back();
+      leave_subsection(SectionHandle(active.section, active.name));
+    }
+  else
+    {
+      SectionHandle section;
+      {
+        Threads::Mutex::ScopedLock lock (mutex);
+        const auto position = section_indices.find(section_name);
+        Assert (position != section_indices.end(),
+                ExcMessage ("Cannot delete a section that was never created."));
+        if (position != section_indices.end())
+          section = SectionHandle(position->second, &position->first);
+      }
+      leave_subsection(section);
+    }
+}
+
+
+
+void
+TimerOutput::leave_subsection (const SectionHandle &section)
+{
+  ThreadData &data = thread_data.get();
+  Assert (!data.active_sections.empty(),
+          ExcMessage("Cannot exit any section because none has been entered!"));
+
+  std::vector<ActiveSection>::iterator active = data.active_sections.end();
+  while (active != data.active_sections.begin())
+    if ((--active)->section == section.index)
+      break;
+  Assert (active->section == section.index,
+          ExcMessage ("Cannot delete a section that has not been entered."));
 
-  if (section_name != "")
+#ifdef DEAL_II_WITH_MPI
+  if (mpi_communicator != MPI_COMM_SELF)
     {
-      Assert (sections.find (section_name) != sections.end(),
-              ExcMessage ("Cannot delete a section that was never created."));
-      Assert (std::find (active_sections.begin(), active_sections.end(),
-                         section_name) != active_sections.end(),
-              ExcMessage ("Cannot delete a section that has not been entered."));
+      const int ierr = MPI_Barrier(mpi_communicator);
+      AssertThrowMPI(ierr);
     }
+#endif
+
+  double wall_time = internal::Timer::to_seconds
+                     (std::chrono::steady_clock::now() - active->wall_start_time);
+  double cpu_time = 0;
+  if (output_type != wall_times)
+    cpu_time = internal::Timer::to_seconds(CPUClock::now() - active->cpu_start_time);
 
-  // if no string is given, exit the last
-  // active section.
-  const std::string actual_section_name = (section_name == "" ?
-                                           active_sections.back () :
-                                           section_name);
+  PerformanceCounters::stop_region(active->name->c_str());
 
-  sections[actual_section_name].timer.stop();
-  sections[actual_section_name].total_wall_time
-  += sections[actual_section_name].timer.last_wall_time();
+  // On MPI systems, if constructed with an mpi_communicator like
+  // MPI_COMM_WORLD, use the maximum time over all processors in the
+  // communicator.
+  if (mpi_communicator != MPI_COMM_SELF)
+    {
+      wall_time = Utilities::MPI::max(wall_time, mpi_communicator);
+      if (output_type != wall_times)
+        cpu_time = Utilities::MPI::max(cpu_time, mpi_communicator);
+    }
 
-  // Get cpu time. On MPI systems, if constructed with an mpi_communicator
-  // like MPI_COMM_WORLD, then the Timer will sum up the CPU time between
-  // processors among the provided mpi_communicator. Therefore, no
-  // communication is needed here.
-  const double cpu_time = sections[actual_section_name].timer.last_cpu_time();
-  sections[actual_section_name].total_cpu_time += cpu_time;
+  Section &section_data = data.call_tree[active->node].data;
+  section_data.total_wall_time += wall_time;
+  section_data.total_cpu_time += cpu_time;
 
   // in case we have to print out something, do that here...
   if ((output_frequency == every_call || output_frequency == every_call_and_summary)
@@ -448,7 +553,7 @@ TimerOutput::leave_subsection (const std::string &section_name)
       std::ostringstream cpu;
       cpu << cpu_time << "s";
       std::ostringstream wall;
-      wall << sections[actual_section_name].timer.last_wall_time() << "s";
+      wall << wall_time << "s";
       if (output_type == cpu_times)
         output_time = ", CPU time: " + cpu.str();
       else if (output_type == wall_times)
@@ -456,14 +561,93 @@ TimerOutput::leave_subsection (const std::string &section_name)
       else
         output_time = ", CPU/wall time: " + cpu.str() + " / " + wall.str() + ".";
 
-      out_stream << actual_section_name << output_time
+      Threads::Mutex::ScopedLock lock (mutex);
+      out_stream << *active->name << output_time
                  << std::endl;
     }
 
-  // delete the index from the list of
-  // active ones
-  active_sections.erase (std::find (active_sections.begin(), active_sections.end(),
-                                    actual_section_name));
+  // delete the entry from the list of active ones
+  data.active_sections.erase(active);
+}
+
+
+
+namespace
+{
+  // Add the data of the node @p thread_node of @p thread_tree and all its
+  // descendants to the node @p node of @p tree, creating the children in
+  // @p tree as necessary.
+  template <typename CallTreeNode>
+  void merge_call_tree_node (const std::vector<CallTreeNode> &thread_tree,
+                             const unsigned int               thread_node,
+                             std::vector<CallTreeNode>       &tree,
+                             const unsigned int               node)
+  {
+    tree[node].data.total_cpu_time += thread_tree[thread_node].data.total_cpu_time;
+    tree[node].data.total_wall_time += thread_tree[thread_node].data.total_wall_time;
+    tree[node].data.n_calls += thread_tree[thread_node].data.n_calls;
+
+    for (const unsigned int thread_child : thread_tree[thread_node].children)
+      {
+        const unsigned int section = thread_tree[thread_child].section;
+        unsigned int child = numbers::invalid_unsigned_int;
+        for (const unsigned int c : tree[node].children)
+          if (tree[c].section == section)
+            {
+              child = c;
+              break;
+            }
+        if (child == numbers::invalid_unsigned_int)
+          {
+            child = tree.size();
+            tree.emplace_back(section, node);
+            tree[node].children.push_back(child);
+          }
+        merge_call_tree_node(thread_tree, thread_child, tree, child);
+      }
+  }
+}
+
+
+
+void
+TimerOutput::merge_call_trees (std::vector<CallTreeNode> &call_tree) const
+{
+  call_tree.clear();
+  call_tree.emplace_back(numbers::invalid_unsigned_int,
+                         numbers::invalid_unsigned_int);
+#ifdef DEAL_II_WITH_THREADS
+  for (const ThreadData &data : thread_data.get_implementation())
+    merge_call_tree_node(data.call_tree, 0, call_tree, 0);
+#else
+  merge_call_tree_node(thread_data.get_implementation().call_tree, 0, call_tree, 0);
+#endif
+}
+
+
+
+std::map<std::string, TimerOutput::Section>
+TimerOutput::get_section_data () const
+{
+  std::vector<CallTreeNode> call_tree;
+  merge_call_trees(call_tree);
+
+  Threads::Mutex::ScopedLock lock (mutex);
+  std::map<std::string, Section> sections;
+  for (unsigned int n=1; n<call_tree.size(); ++n)
+    {
+      const std::string &name = section_names[call_tree[n].section];
+      auto position = sections.find(name);
+      if (position == sections.end())
+        sections[name] = call_tree[n].data;
+      else
+        {
+          position->second.total_cpu_time += call_tree[n].data.total_cpu_time;
+          position->second.total_wall_time += call_tree[n].data.total_wall_time;
+          position->second.n_calls += call_tree[n].data.n_calls;
+        }
+    }
+  return sections;
 }
 
 
@@ -472,7 +656,7 @@ std::map<std::string, double>
 TimerOutput::get_summary_data (const OutputData kind) const
 {
   std::map<std::string, double> output;
-  for (const auto &section : sections)
+  for (const auto &section : get_section_data())
     {
       switch (kind)
         {
@@ -505,6 +689,8 @@ TimerOutput::print_summary () const
   const std::streamsize    old_precision = out_stream.get_stream().precision ();
   const std::streamsize    old_width     = out_stream.get_stream().width ();
 
+  const std::map<std::string, Section> sections = get_section_data();
+
   // in case we want to write CPU times
   if (output_type != wall_times)
     {
@@ -663,6 +849,167 @@ TimerOutput::print_summary () const
 
 
 
+void
+TimerOutput::print_call_tree () const
+{
+  const std::istream::fmtflags old_flags = out_stream.get_stream().flags();
+  const std::streamsize    old_precision = out_stream.get_stream().precision ();
+  const std::streamsize    old_width     = out_stream.get_stream().width ();
+
+  std::vector<CallTreeNode> call_tree;
+  merge_call_trees(call_tree);
+  const bool show_cpu_times = (output_type == cpu_times);
+  const double total_time = show_cpu_times ?
+                            Utilities::MPI::sum(timer_all(), mpi_communicator) :
+                            timer_all.wall_time();
+
+  out_stream << "\n\n"
+             << "+---------------------------------------------+------------"
+             << "+------------+\n"
+             << "| Call tree of the sections                   |            "
+             << "|            |\n"
+             << "|                                             |            "
+             << "|            |\n";
+  out_stream << "| Section                         | no. calls |";
+  out_stream << (show_cpu_times ? "   CPU time " : "  wall time ")
+             << "| % of outer |\n";
+  out_stream << "+---------------------------------+-----------+------------"
+             << "+------------+";
+
+  // visit the nodes depth-first, with the children in the order in which
+  // they have been entered first
+  std::vector<std::pair<unsigned int, unsigned int> > nodes_and_depths;
+  for (auto child = call_tree[0].children.rbegin();
+       child != call_tree[0].children.rend(); ++child)
+    nodes_and_depths.emplace_back(*child, 0);
+  while (nodes_and_depths.empty() == false)
+    {
+      const unsigned int node = nodes_and_depths.back().first;
+      const unsigned int depth = nodes_and_depths.back().second;
+      nodes_and_depths.pop_back();
+      for (auto child = call_tree[node].children.rbegin();
+           child != call_tree[node].children.rend(); ++child)
+        nodes_and_depths.emplace_back(*child, depth+1);
+
+      const Section &data = call_tree[node].data;
+      const double time = show_cpu_times ? data.total_cpu_time : data.total_wall_time;
+      const unsigned int parent = call_tree[node].parent;
+      const double outer_time = parent == 0 ? total_time :
+                                (show_cpu_times ?
+                                 call_tree[parent].data.total_cpu_time :
+                                 call_tree[parent].data.total_wall_time);
+
+      std::string name_out;
+      {
+        Threads::Mutex::ScopedLock lock (mutex);
+        name_out = std::string(2*depth, ' ') + section_names[call_tree[node].section];
+      }
+      name_out.resize (32, ' ');
+      out_stream << std::endl;
+      out_stream << "| " << name_out;
+      out_stream << "| ";
+      out_stream << std::setw(9);
+      out_stream << data.n_calls << " |";
+      out_stream << std::setw(10);
+      out_stream << std::setprecision(3);
+      out_stream << time << "s |";
+      out_stream << std::setw(10);
+      if (outer_time != 0)
+        {
+          // if run time was less than 0.1%, just print a zero to avoid
+          // printing silly things such as "2.45e-6%". otherwise print
+          // the actual percentage
+          const double fraction = time/outer_time;
+          if (fraction > 0.001)
+            {
+              out_stream << std::setprecision(2);
+              out_stream << fraction * 100;
+            }
+          else
+            out_stream << 0.0;
+
+          out_stream << "% |";
+        }
+      else
+        out_stream << 0.0 << "% |";
+    }
+  out_stream << std::endl
+             << "+---------------------------------+-----------+"
+             << "------------+------------+\n"
+             << std::endl;
+
+  out_stream.get_stream().precision (old_precision);
+  out_stream.get_stream().width (old_width);
+  out_stream.get_stream().flags (old_flags);
+}
+
+
+
+void
+TimerOutput::print_wall_time_statistics (const MPI_Comm mpi_comm) const
+{
+  const std::istream::fmtflags old_flags = out_stream.get_stream().flags();
+  const std::streamsize    old_precision = out_stream.get_stream().precision ();
+  const std::streamsize    old_width     = out_stream.get_stream().width ();
+
+  const std::map<std::string, Section> sections = get_section_data();
+
+  // all processes need to take part in the reductions below for the same
+  // sections
+  Assert (Utilities::MPI::min(sections.size(), mpi_comm) ==
+          Utilities::MPI::max(sections.size(), mpi_comm),
+          ExcMessage ("The number of sections differs between the processes."));
+
+  const Utilities::MPI::MinMaxAvg total_time =
+    Utilities::MPI::min_max_avg(timer_all.wall_time(), mpi_comm);
+
+  out_stream << "\n\n"
+             << "+---------------------------------+-----------+------------"
+             << "+------+------------+------------+------+\n"
+             << "| Total wallclock time elapsed since start    |";
+  out_stream << std::setw(10) << std::setprecision(3) << std::right;
+  out_stream << total_time.max << "s |      |            |            |      |\n";
+  out_stream << "|                                 |           |            "
+             << "|      |            |            |      |\n";
+  out_stream << "| Section                         | no. calls |   min time "
+             << "| rank |   avg time |   max time | rank |\n";
+  out_stream << "+---------------------------------+-----------+------------"
+             << "+------+------------+------------+------+";
+  for (const auto &section : sections)
+    {
+      const Utilities::MPI::MinMaxAvg data =
+        Utilities::MPI::min_max_avg(section.second.total_wall_time, mpi_comm);
+
+      std::string name_out = section.first;
+      unsigned int pos_non_space = name_out.find_first_not_of (' ');
+      name_out.erase(0, pos_non_space);
+      name_out.resize (32, ' ');
+      out_stream << std::endl;
+      out_stream << "| " << name_out;
+      out_stream << "| ";
+      out_stream << std::setw(9);
+      out_stream << section.second.n_calls << " |";
+      out_stream << std::setw(10) << std::setprecision(3);
+      out_stream << data.min << "s |";
+      out_stream << std::setw(5) << data.min_index << " |";
+      out_stream << std::setw(10) << std::setprecision(3);
+      out_stream << data.avg << "s |";
+      out_stream << std::setw(10) << std::setprecision(3);
+      out_stream << data.max << "s |";
+      out_stream << std::setw(5) << data.max_index << " |";
+    }
+  out_stream << std::endl
+             << "+---------------------------------+-----------+------------"
+             << "+------+------------+------------+------+\n"
+             << std::endl;
+
+  out_stream.get_stream().precision (old_precision);
+  out_stream.get_stream().width (old_width);
+  out_stream.get_stream().flags (old_flags);
+}
+
+
+
 void
 TimerOutput::disable_output ()
 {
@@ -680,9 +1027,9 @@ TimerOutput::enable_output ()
 void
 TimerOutput::reset ()
 {
-  Threads::Mutex::ScopedLock lock (mutex);
-  sections.clear();
-  active_sections.clear();
+  // keep the names of the sections, such that handles of registered
+  // sections stay valid
+  thread_data.clear();
   timer_all.restart();
 }
 
@@ -34,6 +34,7 @@ DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cerrno>
 #include <cmath>
@@ -54,6 +55,16 @@ DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 #  include <stdlib.h>
 #endif
 
+#ifdef DEAL_II_HAVE_MADVISE
+#  include <sys/mman.h>
+#endif
+
+#ifdef DEAL_II_HAVE_NUMA_SYSCALLS
+#  include <linux/mempolicy.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
 
 DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 #ifdef DEAL_II_WITH_TRILINOS
@@ -557,6 +568,53 @@ namespace Utilities
   }
 
 
+
+  template <int dim>
+  std::uint64_t
+  hilbert_index (const std::array<unsigned int,dim> &coordinates,
+                 const unsigned int                  n_bits)
+  {
+    Assert (n_bits > 0 && n_bits <= 32 && n_bits*dim <= 64,
+            ExcMessage("The index along the curve must fit into 64 bits"));
+    std::array<unsigned int,dim> x = coordinates;
+    const unsigned int m = 1U << (n_bits-1);
+
+    // inverse undo of the excess work
+    for (unsigned int q=m; q>1; q>>=1)
+      {
+        const unsigned int p = q-1;
+        for (unsigned int d=0; d<dim; ++d)
+          if (x[d] & q)
+            x[0] ^= p;
+          else
+            {
+              const unsigned int t = (x[0] ^ x[d]) & p;
+              x[0] ^= t;
+              x[d] ^= t;
+            }
+      }
+
+    // Gray encode
+    for (unsigned int d=1; d<dim; ++d)
+      x[d] ^= x[d-1];
+    unsigned int t = 0;
+    for (unsigned int q=m; q>1; q>>=1)
+      if (x[dim-1] & q)
+        t ^= q-1;
+    for (unsigned int d=0; d<dim; ++d)
+      x[d] ^= t;
+
+    // the transposed representation holds the bits of the index
+    // interleaved over the coordinate directions, starting with the most
+    // significant one
+    std::uint64_t index = 0;
+    for (int b=n_bits-1; b>=0; --b)
+      for (unsigned int d=0; d<dim; ++d)
+        index = (index << 1) | ((x[d] >> b) & 1U);
+    return index;
+  }
+
+
   template <typename Integer>
   std::vector<Integer>
   reverse_permutation (const std::vector<Integer> &permutation)
@@ -673,6 +731,25 @@ namespace Utilities
 
 
 
+    unsigned int get_cpu_vectorization_level ()
+    {
+#ifdef DEAL_II_HAVE_BUILTIN_CPU_SUPPORTS
+      __builtin_cpu_init ();
+      if (__builtin_cpu_supports ("avx512f"))
+        return 3;
+      else if (__builtin_cpu_supports ("avx"))
+        return 2;
+      else if (__builtin_cpu_supports ("sse2"))
+        return 1;
+      else
+        return 0;
+#else
+      return DEAL_II_COMPILER_VECTORIZATION_LEVEL;
+#endif
+    }
+
+
+
     std::string get_time ()
     {
       std::time_t  time1= std::time (nullptr);
@@ -703,8 +780,102 @@ namespace Utilities
 
 
 
+    MemoryAllocationPolicy::MemoryAllocationPolicy ()
+      :
+      use_huge_pages (false),
+      numa_placement (first_touch),
+      minimum_size (16*1024*1024)
+    {}
+
+
+
+    namespace
+    {
+      // the global memory allocation policy. posix_memalign() reads it for
+      // every allocation, so we store the fields as separate atomic
+      // variables rather than protecting them by a mutex
+      std::atomic<bool> huge_pages_policy (false);
+      std::atomic<int> numa_placement_policy (MemoryAllocationPolicy::first_touch);
+      std::atomic<std::size_t> minimum_size_policy (16*1024*1024);
+
+      // the size of the huge pages on x86-64 and most other platforms
+      const std::size_t huge_page_size = 2*1024*1024;
+
+      // ask the operating system to interleave the pages of the given
+      // memory block over all NUMA nodes the process is allowed to use
+      void interleave_memory (void *data, const std::size_t size)
+      {
+#ifdef DEAL_II_HAVE_NUMA_SYSCALLS
+        const unsigned long max_node = 1024;
+        unsigned long node_mask[max_node/(8*sizeof(unsigned long))] = {};
+        if (syscall (SYS_get_mempolicy, nullptr, node_mask, max_node, nullptr,
+                     MPOL_F_MEMS_ALLOWED) == 0)
+          {
+            // mbind needs the start address aligned to the size of a page;
+            // the pages only partially covered by the block keep the
+            // default placement
+            const std::size_t page_size = sysconf (_SC_PAGESIZE);
+            const std::size_t start = reinterpret_cast<std::size_t>(data);
+            const std::size_t aligned_start = (start + page_size - 1) / page_size * page_size;
+            if (aligned_start < start + size)
+              syscall (SYS_mbind, reinterpret_cast<void *>(aligned_start),
+                       start + size - aligned_start, MPOL_INTERLEAVE,
+                       node_mask, max_node, 0);
+          }
+#else
+        (void)data;
+        (void)size;
+#endif
+      }
+    }
+
+
+
+    void set_memory_allocation_policy (const MemoryAllocationPolicy &policy)
+    {
+      huge_pages_policy = policy.use_huge_pages;
+      numa_placement_policy = policy.numa_placement;
+      minimum_size_policy = policy.minimum_size;
+    }
+
+
+
+    MemoryAllocationPolicy get_memory_allocation_policy ()
+    {
+      MemoryAllocationPolicy policy;
+      policy.use_huge_pages = huge_pages_policy;
+      policy.numa_placement =
+        static_cast<MemoryAllocationPolicy::NumaPlacement>(numa_placement_policy.load());
+      policy.minimum_size = minimum_size_policy;
+      return policy;
+    }
+
+
+
     void posix_memalign (void **memptr, size_t alignment, size_t size)
     {
+      // avoid assembling the policy object for the many small allocations
+      if (size < minimum_size_policy ||
+          (huge_pages_policy == false &&
+           numa_placement_policy == MemoryAllocationPolicy::first_touch))
+        posix_memalign (memptr, alignment, size, MemoryAllocationPolicy());
+      else
+        posix_memalign (memptr, alignment, size, get_memory_allocation_policy());
+    }
+
+
+
+    void posix_memalign (void **memptr, size_t alignment, size_t size,
+                         const MemoryAllocationPolicy &policy)
+    {
+      const bool apply_policy = (size >= policy.minimum_size);
+#ifdef DEAL_II_HAVE_MADVISE
+      // the kernel can only use huge pages for the parts of the block that
+      // are aligned to the size of huge pages
+      if (apply_policy && policy.use_huge_pages)
+        alignment = std::max (alignment, huge_page_size);
+#endif
+
 #ifndef DEAL_II_MSVC
       const int ierr = ::posix_memalign (memptr, alignment, size);
 
@@ -717,6 +888,18 @@ namespace Utilities
       (void)alignment;
       AssertThrow (*memptr != 0, ExcOutOfMemory());
 #endif
+
+      // the following calls are only advice to the operating system, so we
+      // do not check for errors. the placement on the NUMA nodes must be set
+      // before the pages are first written to
+      if (apply_policy && policy.numa_placement == MemoryAllocationPolicy::interleave)
+        interleave_memory (*memptr, size);
+#ifdef DEAL_II_HAVE_MADVISE
+      if (apply_policy && policy.use_huge_pages)
+        madvise (*memptr, (size / huge_page_size) * huge_page_size, MADV_HUGEPAGE);
+#endif
+      (void)apply_policy;
+      (void)huge_page_size;
     }
 
 
@@ -864,6 +1047,10 @@ namespace Utilities
   template std::string to_string<double> (double, unsigned int);
   template std::string to_string<long double> (long double, unsigned int);
 
+  template std::uint64_t hilbert_index<1> (const std::array<unsigned int,1> &, const unsigned int);
+  template std::uint64_t hilbert_index<2> (const std::array<unsigned int,2> &, const unsigned int);
+  template std::uint64_t hilbert_index<3> (const std::array<unsigned int,3> &, const unsigned int);
+
 }
 
 DEAL_II_NAMESPACE_CLOSE
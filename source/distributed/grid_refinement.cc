@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2000 - 2016 by the deal.II authors
+// Copyright (C) 2000 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -29,6 +29,7 @@
 
 #include <deal.II/distributed/grid_refinement.h>
 
+#include <cmath>
 #include <numeric>
 #include <algorithm>
 #include <limits>
@@ -40,110 +41,39 @@ DEAL_II_NAMESPACE_OPEN
 
 namespace
 {
-  template <typename number>
-  inline
-  number
-  max_element (const Vector<number> &criteria)
-  {
-    return (criteria.size()>0)
-           ?
-           (*std::max_element(criteria.begin(), criteria.end()))
-           :
-           std::numeric_limits<number>::min();
-  }
-
-
-
-  template <typename number>
-  inline
-  number
-  min_element (const Vector<number> &criteria)
-  {
-    return (criteria.size()>0)
-           ?
-           (*std::min_element(criteria.begin(), criteria.end()))
-           :
-           std::numeric_limits<number>::max();
-  }
-
-
   /**
-   * Compute the global max and min
-   * of the criteria vector. These
-   * are returned only on the
-   * processor with rank zero, all
-   * others get a pair of zeros.
+   * Compute the global minimum over the positive indicators and the global
+   * maximum of the criteria vector on all processors, using a single
+   * collective operation. If no indicator is positive, the minimum is
+   * returned as the largest representable number.
    */
   template <typename number>
-  std::pair<number,number>
-  compute_global_min_and_max_at_root (const Vector<number> &criteria,
-                                      MPI_Comm              mpi_communicator)
+  std::pair<double,double>
+  compute_global_min_positive_and_max (const Vector<number> &criteria,
+                                       MPI_Comm              mpi_communicator)
   {
-    // we'd like to compute the
-    // global max and min from the
-    // local ones in one MPI
-    // communication. we can do that
-    // by taking the elementwise
-    // minimum of the local min and
-    // the negative maximum over all
+    // we'd like to compute the global max and min from the local ones in
+    // one MPI communication. we can do that by taking the elementwise
+    // minimum of the local min and the negative maximum over all
     // processors
+    double comp[2] = { std::numeric_limits<double>::max(), 0 };
+    for (unsigned int i=0; i<criteria.size(); ++i)
+      {
+        if (criteria(i) > 0)
+          comp[0] = std::min (comp[0], static_cast<double>(criteria(i)));
+        comp[1] = std::min (comp[1], -static_cast<double>(criteria(i)));
+      }
 
-    const double local_min = min_element (criteria),
-                 local_max = max_element (criteria);
-    double comp[2] = { local_min, -local_max };
     double result[2] = { 0, 0 };
-
-    // compute the minimum on
-    // processor zero
-    const int ierr = MPI_Reduce (comp, result, 2, MPI_DOUBLE,
-                                 MPI_MIN, 0, mpi_communicator);
+    const int ierr = MPI_Allreduce (comp, result, 2, MPI_DOUBLE,
+                                    MPI_MIN, mpi_communicator);
     AssertThrowMPI(ierr);
 
-    // make sure only processor zero
-    // got something
-    if (Utilities::MPI::this_mpi_process (mpi_communicator) != 0)
-      Assert ((result[0] == 0) && (result[1] == 0),
-              ExcInternalError());
-
     return std::make_pair (result[0], -result[1]);
   }
 
 
 
-  /**
-   * Compute the global sum over the elements
-   * of the vectors passed to this function
-   * on all processors. This number is
-   * returned only on the processor with rank
-   * zero, all others get zero.
-   */
-  template <typename number>
-  double
-  compute_global_sum (const Vector<number> &criteria,
-                      MPI_Comm              mpi_communicator)
-  {
-    double my_sum = std::accumulate (criteria.begin(),
-                                     criteria.end(),
-                                     /* do accumulation in the correct data type: */
-                                     number());
-
-    double result = 0;
-    // compute the minimum on
-    // processor zero
-    const int ierr = MPI_Reduce (&my_sum, &result, 1, MPI_DOUBLE,
-                                 MPI_SUM, 0, mpi_communicator);
-    AssertThrowMPI(ierr);
-
-    // make sure only processor zero
-    // got something
-    if (Utilities::MPI::this_mpi_process (mpi_communicator) != 0)
-      Assert (result == 0, ExcInternalError());
-
-    return result;
-  }
-
-
-
   /**
    * Given a vector of refinement criteria
    * for all cells of a mesh (locally owned
@@ -174,47 +104,6 @@ namespace
   }
 
 
-  // we compute refinement
-  // thresholds by bisection of the
-  // interval spanned by the
-  // smallest and largest error
-  // indicator. this leads to a
-  // small problem: if, for
-  // example, we want to coarsen
-  // zero per cent of the cells,
-  // then we need to pick a
-  // threshold equal to the
-  // smallest indicator, but of
-  // course the bisection algorithm
-  // can never find a threshold
-  // equal to one of the end points
-  // of the interval. So we
-  // slightly increase the interval
-  // before we even start
-  void adjust_interesting_range (double (&interesting_range)[2])
-  {
-    Assert (interesting_range[0] <= interesting_range[1],
-            ExcInternalError());
-
-    Assert (interesting_range[0] >= 0,
-            ExcInternalError());
-
-    // adjust the lower bound only
-    // if the end point is not equal
-    // to zero, otherwise it could
-    // happen, that the result
-    // becomes negative
-    if (interesting_range[0] > 0)
-      interesting_range[0] *= 0.99;
-
-    if (interesting_range[1] > 0)
-      interesting_range[1] *= 1.01;
-    else
-      interesting_range[1]
-      += 0.01 * (interesting_range[1] - interesting_range[0]);
-  }
-
-
 
   /**
    * Given a vector of criteria and bottom
@@ -250,202 +139,241 @@ namespace
 
 
 
-  namespace RefineAndCoarsenFixedNumber
+  /**
+   * Functions that compute the thresholds for which the number of cells, or
+   * the sum of the indicators, above the threshold matches a given target.
+   *
+   * The search works on histograms of the indicators: the interval spanned
+   * by the positive indicators is split into logarithmically spaced bins,
+   * each processor counts (or sums up) its own indicators in each bin, and
+   * a single MPI_Allreduce makes the global histogram known everywhere. The
+   * bin in which the cumulative count from the top crosses the target is
+   * then split again in the next round. With n_bins bins, each round
+   * reduces the interval by a factor of n_bins, compared to a factor of two
+   * per collective operation for the bisection used previously, and since
+   * all processors know the global histogram, they all take the same
+   * decisions without further communication. Several thresholds, e.g. the
+   * one for refinement and the one for coarsening, are searched for at the
+   * same time within the same collective operations.
+   */
+  namespace ThresholdSearch
   {
     /**
-     * Compute a threshold value so
-     * that exactly n_target_cells have
-     * a value that is larger.
+     * The number of bins of each histogram. Packing the histograms of the
+     * refinement and coarsening search into one message gives at most
+     * 32 kB, which is still dominated by the latency of the reduction.
      */
-    template <typename number>
-    number
-    compute_threshold (const Vector<number> &criteria,
-                       const std::pair<double,double> global_min_and_max,
-                       const unsigned int    n_target_cells,
-                       MPI_Comm              mpi_communicator)
-    {
-      double interesting_range[2] = { global_min_and_max.first,
-                                      global_min_and_max.second
-                                    };
-      adjust_interesting_range (interesting_range);
+    const unsigned int n_bins = 1024;
 
-      const unsigned int master_mpi_rank = 0;
-      unsigned int iteration = 0;
+    /**
+     * Stop the search as soon as the bin in which the target lies holds at
+     * most this fraction of the total count (or sum) of the indicators.
+     * Since the bin boundary that is closer to the target is taken, the
+     * error in the count (or sum) above the threshold is at most half of
+     * this. For indicators distributed evenly on a logarithmic scale, this
+     * is reached after two rounds.
+     */
+    const double relative_tolerance = 1e-5;
 
-      do
-        {
-          int ierr = MPI_Bcast (interesting_range, 2, MPI_DOUBLE,
-                                master_mpi_rank, mpi_communicator);
-          AssertThrowMPI(ierr);
+    /**
+     * Terminate the search after this many rounds. this is necessary
+     * because oftentimes error indicators on cells have exactly the same
+     * value, and so there may not be a particular value that cuts the
+     * indicators in such a way that we can achieve the desired number of
+     * cells.
+     */
+    const unsigned int max_n_rounds = 4;
 
-          if (interesting_range[0] == interesting_range[1])
-            return interesting_range[0];
-
-          const double test_threshold
-            = (interesting_range[0] > 0
-               ?
-               std::sqrt(interesting_range[0] * interesting_range[1])
-               :
-               (interesting_range[0] + interesting_range[1]) / 2);
-
-          // count how many of our own
-          // elements would be above
-          // this threshold and then
-          // add to it the number for
-          // all the others
-          unsigned int
-          my_count = std::count_if (criteria.begin(),
-                                    criteria.end(),
-                                    std::bind (std::greater<double>(),
-                                               std::placeholders::_1,
-                                               test_threshold));
-
-          unsigned int total_count;
-          ierr = MPI_Reduce (&my_count, &total_count, 1, MPI_UNSIGNED,
-                             MPI_SUM, master_mpi_rank, mpi_communicator);
-          AssertThrowMPI(ierr);
 
-          // now adjust the range. if
-          // we have to many cells, we
-          // take the upper half of the
-          // previous range, otherwise
-          // the lower half. if we have
-          // hit the right number, then
-          // set the range to the exact
-          // value.
-          // slave nodes also update their own interesting_range, however
-          // their results are not significant since the values will be
-          // overwritten by MPI_Bcast from the master node in next loop.
-          if (total_count > n_target_cells)
-            interesting_range[0] = test_threshold;
-          else if (total_count < n_target_cells)
-            interesting_range[1] = test_threshold;
-          else
-            interesting_range[0] = interesting_range[1] = test_threshold;
-
-          // terminate the iteration after 25 go-arounds. this is necessary
-          // because oftentimes error indicators on cells have exactly the
-          // same value, and so there may not be a particular value that cuts
-          // the indicators in such a way that we can achieve the desired
-          // number of cells. using a maximal number of iterations means that
-          // we terminate the iteration after a fixed number N of steps if the
-          // indicators were perfectly badly distributed, and we make at most
-          // a mistake of 1/2^N in the number of cells flagged if indicators
-          // are perfectly equidistributed
-          ++iteration;
-          if (iteration == 25)
-            interesting_range[0] = interesting_range[1] = test_threshold;
-        }
-      while (true);
 
-      Assert (false, ExcInternalError());
-      return -1;
-    }
-  }
+    /**
+     * The state of the search for one threshold. The threshold is known to
+     * lie in the interval (lower, upper], and the count (or sum) of the
+     * indicators larger than upper is content_above.
+     */
+    struct Search
+    {
+      Search (const double target,
+              const std::pair<double,double> &global_min_positive_and_max)
+        :
+        target (target),
+        // slightly increase the interval so that the bins include the
+        // smallest and largest indicator and the threshold can be chosen
+        // below or above all of them, as for the bisection used previously
+        lower (0.99 * global_min_positive_and_max.first),
+        upper (1.01 * global_min_positive_and_max.second),
+        content_above (0),
+        done (global_min_positive_and_max.second == 0),
+        threshold (0)
+      {}
+
+      double target;
+      double lower;
+      double upper;
+      double content_above;
+      bool   done;
+      double threshold;
+    };
+
+
 
+    /**
+     * Compute the boundaries of the logarithmically spaced bins between
+     * lower and upper.
+     */
+    std::vector<double>
+    compute_bin_boundaries (const double lower,
+                            const double upper)
+    {
+      Assert (lower > 0 && lower <= upper, ExcInternalError());
+
+      std::vector<double> boundaries (n_bins+1);
+      const double ratio = upper / lower;
+      for (unsigned int b=0; b<n_bins; ++b)
+        boundaries[b] = lower * std::pow (ratio, static_cast<double>(b)/n_bins);
+      boundaries[n_bins] = upper;
+      return boundaries;
+    }
 
 
 
-  namespace RefineAndCoarsenFixedFraction
-  {
     /**
-     * Compute a threshold value so
-     * that the error accumulated over all criteria[i] so that
-     *     criteria[i] > threshold
-     * is larger than target_error.
+     * Compute the thresholds of all given searches. If @p sum_indicators is
+     * false, the target of each search is the number of cells with an
+     * indicator larger than the threshold. If it is true, the indicators
+     * larger than the threshold are summed up, and the target of each search
+     * is given relative to the global sum of all indicators, which is
+     * computed along with the first histogram.
+     *
+     * Each round costs one collective operation. If all indicators are
+     * zero, all thresholds are zero.
      */
     template <typename number>
-    number
-    compute_threshold (const Vector<number> &criteria,
-                       const std::pair<double,double> global_min_and_max,
-                       const double          target_error,
-                       MPI_Comm              mpi_communicator)
+    void
+    compute_thresholds (const Vector<number> &criteria,
+                        const bool            sum_indicators,
+                        std::vector<Search>  &searches,
+                        MPI_Comm              mpi_communicator)
     {
-      double interesting_range[2] = { global_min_and_max.first,
-                                      global_min_and_max.second
-                                    };
-      adjust_interesting_range (interesting_range);
+      double total = -1;
 
-      const unsigned int master_mpi_rank = 0;
-      unsigned int iteration = 0;
-
-      do
+      for (unsigned int round=0; round<max_n_rounds; ++round)
         {
-          int ierr = MPI_Bcast (interesting_range, 2, MPI_DOUBLE,
-                                master_mpi_rank, mpi_communicator);
-          AssertThrowMPI(ierr);
-
-          if (interesting_range[0] == interesting_range[1])
+          std::vector<unsigned int> active_searches;
+          for (unsigned int s=0; s<searches.size(); ++s)
+            if (searches[s].done == false)
+              active_searches.push_back (s);
+          if (active_searches.empty())
+            return;
+
+          // fill the local histograms of all active searches and sum them
+          // up over all processors. all processors have the same searches
+          // active, so the messages match. when summing up the indicators,
+          // we also count the cells in each bin, in order to stop when the
+          // target lies in a bin with a single cell that can not be split
+          // further
+          const unsigned int stride = sum_indicators ? 2*n_bins : n_bins;
+          std::vector<std::vector<double> > boundaries (active_searches.size());
+          std::vector<double> local_histograms (active_searches.size()*stride, 0.);
+          for (unsigned int a=0; a<active_searches.size(); ++a)
             {
-              // so we have found our threshold. since we adjust
-              // the range at the top of the function to be slightly
-              // larger than the actual extremes of the refinement
-              // criteria values, we can end up in a situation where
-              // the threshold is in fact larger than the maximal
-              // refinement indicator. in such cases, we get no
-              // refinement at all. thus, cap the threshold by the
-              // actual largest value
-              double final_threshold =  std::min (interesting_range[0],
-                                                  global_min_and_max.second);
-              ierr = MPI_Bcast (&final_threshold, 1, MPI_DOUBLE,
-                                master_mpi_rank, mpi_communicator);
-              AssertThrowMPI(ierr);
-
-              return final_threshold;
+              const Search &search = searches[active_searches[a]];
+              boundaries[a] = compute_bin_boundaries (search.lower, search.upper);
+              double *histogram = &local_histograms[a*stride];
+              for (unsigned int i=0; i<criteria.size(); ++i)
+                if (criteria(i) > search.lower && criteria(i) <= search.upper)
+                  {
+                    // the bins are the half-open intervals
+                    // (boundaries[b], boundaries[b+1]]
+                    const unsigned int b
+                      = std::min<unsigned int>
+                        (std::lower_bound (boundaries[a].begin(),
+                                           boundaries[a].end(),
+                                           static_cast<double>(criteria(i)))
+                         - boundaries[a].begin(), n_bins) - 1;
+                    if (sum_indicators)
+                      {
+                        histogram[b] += criteria(i);
+                        histogram[n_bins+b] += 1.;
+                      }
+                    else
+                      histogram[b] += 1.;
+                  }
             }
 
-          const double test_threshold
-            = (interesting_range[0] > 0
-               ?
-               std::sqrt(interesting_range[0] * interesting_range[1])
-               :
-               (interesting_range[0] + interesting_range[1]) / 2);
-
-          // accumulate the error of those our own elements above this
-          // threshold and then add to it the number for all the
-          // others
-          double my_error = 0;
-          for (unsigned int i=0; i<criteria.size(); ++i)
-            if (criteria(i) > test_threshold)
-              my_error += criteria(i);
-
-          double total_error;
-          ierr = MPI_Reduce (&my_error, &total_error, 1, MPI_DOUBLE,
-                             MPI_SUM, master_mpi_rank, mpi_communicator);
+          std::vector<double> histograms (local_histograms.size());
+          const int ierr = MPI_Allreduce (local_histograms.data(), histograms.data(),
+                                          histograms.size(), MPI_DOUBLE,
+                                          MPI_SUM, mpi_communicator);
           AssertThrowMPI(ierr);
 
-          // now adjust the range. if we have to many cells, we take
-          // the upper half of the previous range, otherwise the lower
-          // half. if we have hit the right number, then set the range
-          // to the exact value.
-          // slave nodes also update their own interesting_range, however
-          // their results are not significant since the values will be
-          // overwritten by MPI_Bcast from the master node in next loop.
-          if (total_error > target_error)
-            interesting_range[0] = test_threshold;
-          else if (total_error < target_error)
-            interesting_range[1] = test_threshold;
-          else
-            interesting_range[0] = interesting_range[1] = test_threshold;
-
-          // terminate the iteration after 25 go-arounds. this is
-          // necessary because oftentimes error indicators on cells
-          // have exactly the same value, and so there may not be a
-          // particular value that cuts the indicators in such a way
-          // that we can achieve the desired number of cells. using a
-          // max of 25 iterations means that we terminate the
-          // iteration after 25 steps if the indicators were perfectly
-          // badly distributed, and we make at most a mistake of
-          // 1/2^25 in the number of cells flagged if indicators are
-          // perfectly equidistributed
-          ++iteration;
-          if (iteration == 25)
-            interesting_range[0] = interesting_range[1] = test_threshold;
-        }
-      while (true);
+          // in the first round, all histograms span all positive indicators,
+          // so we can compute the total count (or sum) from any of them
+          if (round == 0)
+            {
+              total = std::accumulate (histograms.begin(),
+                                       histograms.begin()+n_bins, 0.);
+              if (sum_indicators)
+                for (unsigned int s=0; s<searches.size(); ++s)
+                  searches[s].target *= total;
+            }
 
-      Assert (false, ExcInternalError());
-      return -1;
+          for (unsigned int a=0; a<active_searches.size(); ++a)
+            {
+              Search &search = searches[active_searches[a]];
+              const double *histogram = &histograms[a*stride];
+              const double *n_cells = &histogram[stride-n_bins];
+
+              // the count (or sum) of the indicators larger than the
+              // boundaries of the bins
+              std::vector<double> content_above (n_bins+1);
+              content_above[n_bins] = search.content_above;
+              for (unsigned int b=n_bins; b>0; --b)
+                content_above[b-1] = content_above[b] + histogram[b-1];
+
+              // if even the lowest boundary does not give enough cells or
+              // error, take it. this only happens in the first round, when
+              // the target asks for more than the positive indicators
+              if (content_above[0] <= search.target)
+                {
+                  search.threshold = boundaries[a][0];
+                  search.done = true;
+                  continue;
+                }
+
+              // find the bin in which the target lies, i.e., the last bin
+              // whose lower boundary has more than the target above it
+              unsigned int bin = n_bins-1;
+              while (content_above[bin] <= search.target)
+                --bin;
+
+              if ((content_above[bin+1] == search.target)
+                  ||
+                  (histogram[bin] <= relative_tolerance * total)
+                  ||
+                  (n_cells[bin] <= 1)
+                  ||
+                  (round == max_n_rounds-1)
+                  ||
+                  !(boundaries[a][bin] < boundaries[a][bin+1]))
+                {
+                  search.threshold
+                    = ((search.target - content_above[bin+1] <=
+                        content_above[bin] - search.target)
+                       ?
+                       boundaries[a][bin+1]
+                       :
+                       boundaries[a][bin]);
+                  search.done = true;
+                }
+              else
+                {
+                  search.lower = boundaries[a][bin];
+                  search.upper = boundaries[a][bin+1];
+                  search.content_above = content_above[bin+1];
+                }
+            }
+        }
     }
   }
 }
@@ -497,42 +425,37 @@ namespace parallel
 
         MPI_Comm mpi_communicator = tria.get_communicator ();
 
-        // figure out the global
-        // max and min of the
-        // indicators. we don't
-        // need it here, but it's a
-        // collective communication
-        // call
-        const std::pair<typename VectorType::value_type,typename VectorType::value_type> global_min_and_max
-          = compute_global_min_and_max_at_root (locally_owned_indicators,
-                                                mpi_communicator);
-
-
-        double top_threshold, bottom_threshold;
-        top_threshold =
-          RefineAndCoarsenFixedNumber::
-          compute_threshold (locally_owned_indicators,
-                             global_min_and_max,
-                             static_cast<unsigned int>
+        // figure out the global max and the smallest positive indicator,
+        // which span the interval the histograms are built on
+        const std::pair<double,double> global_min_positive_and_max
+          = compute_global_min_positive_and_max (locally_owned_indicators,
+                                                 mpi_communicator);
+
+        // search for the top threshold and, only if necessary, for the
+        // bottom threshold at the same time
+        std::vector<ThresholdSearch::Search> searches;
+        searches.push_back (ThresholdSearch::Search
+                            (static_cast<unsigned int>
                              (adjusted_fractions.first *
                               tria.n_global_active_cells()),
-                             mpi_communicator);
-
-        // compute bottom
-        // threshold only if
-        // necessary. otherwise
-        // use a threshold lower
-        // than the smallest
-        // value we have locally
+                             global_min_positive_and_max));
         if (adjusted_fractions.second > 0)
-          bottom_threshold =
-            RefineAndCoarsenFixedNumber::
-            compute_threshold (locally_owned_indicators,
-                               global_min_and_max,
-                               static_cast<unsigned int>
+          searches.push_back (ThresholdSearch::Search
+                              (static_cast<unsigned int>
                                ((1-adjusted_fractions.second) *
                                 tria.n_global_active_cells()),
-                               mpi_communicator);
+                               global_min_positive_and_max));
+        ThresholdSearch::compute_thresholds (locally_owned_indicators, false,
+                                             searches, mpi_communicator);
+
+        double top_threshold, bottom_threshold;
+        top_threshold = searches[0].threshold;
+
+        // otherwise use a threshold
+        // lower than the smallest
+        // value we have locally
+        if (adjusted_fractions.second > 0)
+          bottom_threshold = searches[1].threshold;
         else
           {
             bottom_threshold = *std::min_element (criteria.begin(),
@@ -576,41 +499,42 @@ namespace parallel
 
         MPI_Comm mpi_communicator = tria.get_communicator ();
 
-        // figure out the global
-        // max and min of the
-        // indicators. we don't
-        // need it here, but it's a
-        // collective communication
-        // call
-        const std::pair<double,double> global_min_and_max
-          = compute_global_min_and_max_at_root (locally_owned_indicators,
-                                                mpi_communicator);
-
-        const double total_error
-          = compute_global_sum (locally_owned_indicators,
-                                mpi_communicator);
+        // figure out the global max and the smallest positive indicator,
+        // which span the interval the histograms are built on. the total
+        // error is computed along with the first histogram
+        const std::pair<double,double> global_min_positive_and_max
+          = compute_global_min_positive_and_max (locally_owned_indicators,
+                                                 mpi_communicator);
+
+        // search for the top threshold and, only if necessary, for the
+        // bottom threshold at the same time. the targets are given relative
+        // to the total error
+        std::vector<ThresholdSearch::Search> searches;
+        searches.push_back (ThresholdSearch::Search
+                            (top_fraction_of_error,
+                             global_min_positive_and_max));
+        if (bottom_fraction_of_error > 0)
+          searches.push_back (ThresholdSearch::Search
+                              (1-bottom_fraction_of_error,
+                               global_min_positive_and_max));
+        ThresholdSearch::compute_thresholds (locally_owned_indicators, true,
+                                             searches, mpi_communicator);
+
+        // since the interval searched in is slightly larger than the actual
+        // extremes of the refinement criteria values, we can end up in a
+        // situation where the threshold is in fact larger than the maximal
+        // refinement indicator. in such cases, we get no refinement at
+        // all. thus, cap the threshold by the actual largest value
         double top_threshold, bottom_threshold;
-        top_threshold =
-          RefineAndCoarsenFixedFraction::
-          compute_threshold (locally_owned_indicators,
-                             global_min_and_max,
-                             top_fraction_of_error *
-                             total_error,
-                             mpi_communicator);
-        // compute bottom
-        // threshold only if
-        // necessary. otherwise
-        // use a threshold lower
-        // than the smallest
+        top_threshold = std::min (searches[0].threshold,
+                                  global_min_positive_and_max.second);
+
+        // otherwise use a threshold
+        // lower than the smallest
         // value we have locally
         if (bottom_fraction_of_error > 0)
-          bottom_threshold =
-            RefineAndCoarsenFixedFraction::
-            compute_threshold (locally_owned_indicators,
-                               global_min_and_max,
-                               (1-bottom_fraction_of_error) *
-                               total_error,
-                               mpi_communicator);
+          bottom_threshold = std::min (searches[1].threshold,
+                                       global_min_positive_and_max.second);
         else
           {
             bottom_threshold = *std::min_element (criteria.begin(),
@@ -0,0 +1,198 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/config.h>
+
+#ifdef DEAL_II_WITH_P4EST
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/distributed/load_balancer.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace parallel
+{
+  namespace distributed
+  {
+    template <int dim, int spacedim>
+    LoadBalancer<dim,spacedim>::LoadBalancer (Triangulation<dim,spacedim> &tria,
+                                              const double migration_cost_per_cell)
+      :
+      triangulation (&tria, typeid(*this).name()),
+      migration_cost_per_cell (migration_cost_per_cell),
+      reference_cost (1.)
+    {
+      Assert (migration_cost_per_cell >= 0,
+              ExcMessage("The migration cost must not be negative"));
+      clear_costs();
+      tria_listener = tria.signals.any_change.connect
+                      (std::bind(&LoadBalancer<dim,spacedim>::clear_costs,
+                                 std::ref(*this)));
+    }
+
+
+
+    template <int dim, int spacedim>
+    LoadBalancer<dim,spacedim>::~LoadBalancer ()
+    {
+      tria_listener.disconnect();
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    LoadBalancer<dim,spacedim>::add_cell_cost
+    (const typename dealii::Triangulation<dim,spacedim>::active_cell_iterator &cell,
+     const double                                                            cost)
+    {
+      Assert (cell->is_locally_owned(),
+              ExcMessage("Costs can only be recorded on locally owned cells"));
+      Assert (cost >= 0, ExcMessage("The cost of a cell must not be negative"));
+      AssertIndexRange (cell->active_cell_index(), cell_costs.size());
+      cell_costs[cell->active_cell_index()] += cost;
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    LoadBalancer<dim,spacedim>::clear_costs ()
+    {
+      cell_costs.assign(triangulation->n_active_cells(), 0.);
+    }
+
+
+
+    template <int dim, int spacedim>
+    double
+    LoadBalancer<dim,spacedim>::imbalance () const
+    {
+      double local_cost = 0;
+      for (unsigned int i=0; i<cell_costs.size(); ++i)
+        local_cost += cell_costs[i];
+      const Utilities::MPI::MinMaxAvg cost =
+        Utilities::MPI::min_max_avg(local_cost,
+                                    triangulation->get_communicator());
+      return cost.avg > 0 ? cost.max / cost.avg : 1.;
+    }
+
+
+
+    template <int dim, int spacedim>
+    bool
+    LoadBalancer<dim,spacedim>::should_repartition (const double n_future_intervals) const
+    {
+      double local_cost = 0;
+      for (unsigned int i=0; i<cell_costs.size(); ++i)
+        local_cost += cell_costs[i];
+      const MPI_Comm &mpi_communicator = triangulation->get_communicator();
+      const Utilities::MPI::MinMaxAvg cost =
+        Utilities::MPI::min_max_avg(local_cost, mpi_communicator);
+      if (cost.max <= cost.avg)
+        return false;
+
+      // estimate the number of cells an overloaded process needs to give
+      // away to reach the average cost, assuming that the cost is evenly
+      // spread over its cells. The process shipping the most cells dictates
+      // the migration time.
+      double cells_to_move = 0;
+      if (local_cost > cost.avg)
+        cells_to_move = (local_cost - cost.avg) / local_cost *
+                        triangulation->n_locally_owned_active_cells();
+      cells_to_move = Utilities::MPI::max(cells_to_move, mpi_communicator);
+
+      const double predicted_gain = (cost.max - cost.avg) * n_future_intervals;
+      return predicted_gain > cells_to_move * migration_cost_per_cell;
+    }
+
+
+
+    template <int dim, int spacedim>
+    bool
+    LoadBalancer<dim,spacedim>::repartition_if_beneficial (const double n_future_intervals)
+    {
+      if (should_repartition(n_future_intervals) == false)
+        return false;
+
+      // scale the weights by the cheapest cell with a non-zero cost, which
+      // gets the reference weight of the triangulation
+      double local_min = std::numeric_limits<double>::max();
+      for (unsigned int i=0; i<cell_costs.size(); ++i)
+        if (cell_costs[i] > 0)
+          local_min = std::min(local_min, cell_costs[i]);
+      reference_cost = -Utilities::MPI::max(-local_min,
+                                            triangulation->get_communicator());
+
+      // only connect the weights for the duration of the repartitioning in
+      // order to not interfere with other users of the signal
+      const boost::signals2::connection weight_connection =
+        triangulation->signals.cell_weight.connect
+        (std::bind(&LoadBalancer<dim,spacedim>::cell_weight,
+                   std::cref(*this),
+                   std::placeholders::_1,
+                   std::placeholders::_2));
+      try
+        {
+          triangulation->repartition();
+        }
+      catch (...)
+        {
+          weight_connection.disconnect();
+          throw;
+        }
+      weight_connection.disconnect();
+
+      clear_costs();
+      return true;
+    }
+
+
+
+    template <int dim, int spacedim>
+    unsigned int
+    LoadBalancer<dim,spacedim>::cell_weight
+    (const typename dealii::Triangulation<dim,spacedim>::cell_iterator &cell,
+     const typename dealii::Triangulation<dim,spacedim>::CellStatus     status) const
+    {
+      Assert ((status == dealii::Triangulation<dim,spacedim>::CELL_PERSIST),
+              ExcInternalError());
+      (void)status;
+
+      // the triangulation adds a weight of 1000 to every cell, so the cell
+      // of cost reference_cost gets no additional weight. Limit the weight in
+      // order to keep the sum over all cells within the range of the 64-bit
+      // integers used by p4est.
+      const double relative_cost = cell_costs[cell->active_cell_index()] / reference_cost;
+      const double weight = std::min(1000. * relative_cost, 1e7);
+      return weight > 1000. ? static_cast<unsigned int>(weight + 0.5) - 1000 : 0;
+    }
+  }
+}
+
+
+#include "load_balancer.inst"
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // DEAL_II_WITH_P4EST
@@ -0,0 +1,185 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/distributed/partition_diagnostics.h>
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <iomanip>
+#include <iostream>
+#include <set>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace parallel
+{
+  template <int dim, int spacedim>
+  PartitionDiagnostics<dim,spacedim>::PartitionDiagnostics (const DoFHandler<dim,spacedim> &dof_handler)
+    :
+    triangulation (&dof_handler.get_triangulation(), typeid(*this).name())
+  {
+    const parallel::Triangulation<dim,spacedim> *parallel_tria =
+      dynamic_cast<const parallel::Triangulation<dim,spacedim>*>(&dof_handler.get_triangulation());
+    const MPI_Comm mpi_communicator = (parallel_tria != nullptr ?
+                                       parallel_tria->get_communicator() :
+                                       MPI_COMM_SELF);
+
+    if (parallel_tria != nullptr)
+      {
+        local_values[owned_cells] = parallel_tria->n_locally_owned_active_cells();
+        local_values[ghost_cells] = parallel_tria->n_ghost_active_cells();
+        local_values[neighbor_processors] = parallel_tria->ghost_owners().size();
+      }
+    else
+      {
+        local_values[owned_cells] = triangulation->n_active_cells();
+        local_values[ghost_cells] = 0;
+        local_values[neighbor_processors] = 0;
+      }
+
+    IndexSet locally_relevant_dofs;
+    DoFTools::extract_locally_relevant_dofs (dof_handler, locally_relevant_dofs);
+    const Utilities::MPI::Partitioner partitioner (dof_handler.locally_owned_dofs(),
+                                                   locally_relevant_dofs,
+                                                   mpi_communicator);
+    local_values[owned_dofs] = partitioner.local_size();
+    local_values[ghost_dofs] = partitioner.n_ghost_indices();
+    local_values[ghost_dof_ratio] = (partitioner.local_size() > 0 ?
+                                     static_cast<double>(partitioner.n_ghost_indices()) /
+                                     partitioner.local_size() :
+                                     0.);
+
+    std::set<unsigned int> partners;
+    for (unsigned int i=0; i<partitioner.ghost_targets().size(); ++i)
+      partners.insert(partitioner.ghost_targets()[i].first);
+    for (unsigned int i=0; i<partitioner.import_targets().size(); ++i)
+      partners.insert(partitioner.import_targets()[i].first);
+    local_values[communication_partners] = partners.size();
+    local_values[exported_entries] = partitioner.n_import_indices();
+    local_values[imported_entries] = partitioner.n_ghost_indices();
+
+    for (unsigned int q=0; q<n_quantities; ++q)
+      global_values[q] = Utilities::MPI::min_max_avg(local_values[q],
+                                                     mpi_communicator);
+  }
+
+
+
+  template <int dim, int spacedim>
+  double
+  PartitionDiagnostics<dim,spacedim>::local_value (const Quantity quantity) const
+  {
+    AssertIndexRange (quantity, n_quantities);
+    return local_values[quantity];
+  }
+
+
+
+  template <int dim, int spacedim>
+  const Utilities::MPI::MinMaxAvg &
+  PartitionDiagnostics<dim,spacedim>::statistics (const Quantity quantity) const
+  {
+    AssertIndexRange (quantity, n_quantities);
+    return global_values[quantity];
+  }
+
+
+
+  template <int dim, int spacedim>
+  const char *
+  PartitionDiagnostics<dim,spacedim>::name (const Quantity quantity)
+  {
+    switch (quantity)
+      {
+      case owned_cells:
+        return "owned cells";
+      case ghost_cells:
+        return "ghost cells";
+      case neighbor_processors:
+        return "neighbor processors";
+      case owned_dofs:
+        return "owned dofs";
+      case ghost_dofs:
+        return "ghost dofs";
+      case ghost_dof_ratio:
+        return "ghost/owned dof ratio";
+      case communication_partners:
+        return "communication partners";
+      case exported_entries:
+        return "exported vector entries";
+      case imported_entries:
+        return "imported vector entries";
+      default:
+        Assert (false, ExcIndexRange(quantity, 0, n_quantities));
+      }
+    return "";
+  }
+
+
+
+  template <int dim, int spacedim>
+  template <class StreamType>
+  void
+  PartitionDiagnostics<dim,spacedim>::print (StreamType &out) const
+  {
+    out << std::left << std::setw(26) << "Partition diagnostics"
+        << std::right << std::setw(12) << "min"
+        << std::setw(8) << "[p]"
+        << std::setw(12) << "avg"
+        << std::setw(12) << "max"
+        << std::setw(8) << "[p]"
+        << std::setw(10) << "max/avg" << std::endl;
+    for (unsigned int q=0; q<n_quantities; ++q)
+      {
+        const Utilities::MPI::MinMaxAvg &stat = global_values[q];
+        out << std::left << std::setw(26) << name(static_cast<Quantity>(q))
+            << std::right << std::setprecision(4)
+            << std::setw(12) << stat.min
+            << std::setw(8) << stat.min_index
+            << std::setw(12) << stat.avg
+            << std::setw(12) << stat.max
+            << std::setw(8) << stat.max_index
+            << std::setw(10) << (stat.avg > 0 ? stat.max/stat.avg : 1.)
+            << std::endl;
+      }
+  }
+
+
+
+  template <int dim, int spacedim>
+  Vector<float>
+  PartitionDiagnostics<dim,spacedim>::cell_field (const Quantity quantity) const
+  {
+    AssertIndexRange (quantity, n_quantities);
+    Vector<float> field (triangulation->n_active_cells());
+    for (typename dealii::Triangulation<dim,spacedim>::active_cell_iterator
+         cell = triangulation->begin_active(); cell != triangulation->end(); ++cell)
+      if (cell->is_locally_owned())
+        field(cell->active_cell_index()) = local_values[quantity];
+    return field;
+  }
+}
+
+
+#include "partition_diagnostics.inst"
+
+DEAL_II_NAMESPACE_CLOSE
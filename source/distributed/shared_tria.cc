@@ -15,6 +15,7 @@
 // ---------------------------------------------------------------------
 
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/mpi.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_accessor.h>
@@ -243,6 +244,17 @@ namespace parallel
 
 
 
+    template <int dim, int spacedim>
+    std::size_t
+    Triangulation<dim,spacedim>::memory_consumption () const
+    {
+      return (dealii::parallel::Triangulation<dim,spacedim>::memory_consumption()
+              + MemoryConsumption::memory_consumption (true_subdomain_ids_of_cells)
+              + MemoryConsumption::memory_consumption (true_level_subdomain_ids_of_cells));
+    }
+
+
+
     template <int dim, int spacedim>
     void
     Triangulation<dim,spacedim>::execute_coarsening_and_refinement ()
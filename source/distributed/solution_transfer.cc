@@ -18,6 +18,7 @@
 
 #ifdef DEAL_II_WITH_P4EST
 
+#include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/block_vector.h>
 #include <deal.II/lac/la_parallel_vector.h>
@@ -31,9 +32,12 @@
 #include <deal.II/distributed/tria.h>
 #include <deal.II/dofs/dof_tools.h>
 #include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
 #include <deal.II/grid/tria_accessor.h>
 #include <deal.II/grid/tria_iterator.h>
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
 
 DEAL_II_NAMESPACE_OPEN
@@ -203,22 +207,60 @@ namespace parallel
     void
     SolutionTransfer<dim, VectorType, DoFHandlerType>::
     pack_callback(const typename Triangulation<dim,DoFHandlerType::space_dimension>::cell_iterator &cell_,
-                  const typename Triangulation<dim,DoFHandlerType::space_dimension>::CellStatus /*status*/,
+                  const typename Triangulation<dim,DoFHandlerType::space_dimension>::CellStatus status,
                   void *data)
     {
-      typename VectorType::value_type *data_store = reinterpret_cast<typename VectorType::value_type *>(data);
+      typedef typename VectorType::value_type Number;
+      Number *data_store = reinterpret_cast<Number *>(data);
 
       typename DoFHandlerType::cell_iterator cell(*cell_, dof_handler);
 
-      const unsigned int dofs_per_cell=cell->get_fe().dofs_per_cell;
-      ::dealii::Vector<typename VectorType::value_type> dofvalues(dofs_per_cell);
-      for (typename std::vector<const VectorType *>::iterator it=input_vectors.begin();
-           it !=input_vectors.end();
-           ++it)
+      if (status == Triangulation<dim,DoFHandlerType::space_dimension>::CELL_COARSEN &&
+          cell->has_children() && cell->child(0)->active())
+        {
+          // the children are about to be coarsened into this cell. restrict
+          // the values of all vectors child by child, so that the
+          // restriction matrix is looked up only once per child, and write
+          // the result directly into the buffer
+          const FiniteElement<dim,DoFHandlerType::space_dimension> &fe = cell->child(0)->get_fe();
+          const unsigned int dofs_per_cell = fe.dofs_per_cell;
+          if (dofs_per_cell == 0)
+            return;
+          cell_values.reinit(dofs_per_cell, true);
+          child_values.reinit(dofs_per_cell, true);
+          std::fill(data_store, data_store + dofs_per_cell*input_vectors.size(), Number());
+
+          for (unsigned int child=0; child<cell->n_children(); ++child)
+            {
+              Assert (cell->child(child)->active(), ExcInternalError());
+              const FullMatrix<double> &restriction =
+                fe.get_restriction_matrix(child, cell->refinement_case());
+              for (unsigned int v=0; v<input_vectors.size(); ++v)
+                {
+                  cell->child(child)->get_dof_values(*input_vectors[v], child_values);
+                  restriction.vmult (cell_values, child_values);
+                  Number *values = data_store + v*dofs_per_cell;
+                  for (unsigned int i=0; i<dofs_per_cell; ++i)
+                    if (fe.restriction_is_additive(i))
+                      values[i] += cell_values(i);
+                    else if (cell_values(i) != Number())
+                      values[i] = cell_values(i);
+                }
+            }
+        }
+      else
         {
-          cell->get_interpolated_dof_values(*(*it), dofvalues);
-          std::memcpy(data_store, &dofvalues(0), sizeof(typename VectorType::value_type)*dofs_per_cell);
-          data_store += dofs_per_cell;
+          const unsigned int dofs_per_cell = cell->get_fe().dofs_per_cell;
+          cell_values.reinit(dofs_per_cell, true);
+          for (unsigned int v=0; v<input_vectors.size(); ++v)
+            {
+              if (cell->active())
+                cell->get_dof_values(*input_vectors[v], cell_values);
+              else
+                cell->get_interpolated_dof_values(*input_vectors[v], cell_values);
+              std::memcpy(data_store, cell_values.begin(), sizeof(Number)*dofs_per_cell);
+              data_store += dofs_per_cell;
+            }
         }
     }
 
@@ -227,24 +269,56 @@ namespace parallel
     void
     SolutionTransfer<dim, VectorType, DoFHandlerType>::unpack_callback
     (const typename Triangulation<dim,DoFHandlerType::space_dimension>::cell_iterator &cell_,
-     const typename Triangulation<dim,DoFHandlerType::space_dimension>::CellStatus    /*status*/,
+     const typename Triangulation<dim,DoFHandlerType::space_dimension>::CellStatus    status,
      const void                                           *data,
      std::vector<VectorType *>                            &all_out)
     {
+      typedef typename VectorType::value_type Number;
+      const Number *data_store = reinterpret_cast<const Number *>(data);
+
       typename DoFHandlerType::cell_iterator
       cell(*cell_, dof_handler);
 
-      const unsigned int dofs_per_cell=cell->get_fe().dofs_per_cell;
-      ::dealii::Vector<typename VectorType::value_type> dofvalues(dofs_per_cell);
-      const typename VectorType::value_type *data_store = reinterpret_cast<const typename VectorType::value_type *>(data);
-
-      for (typename std::vector<VectorType *>::iterator it = all_out.begin();
-           it != all_out.end();
-           ++it)
+      if (status == Triangulation<dim,DoFHandlerType::space_dimension>::CELL_REFINE &&
+          cell->has_children() && cell->child(0)->active())
+        {
+          // the cell has just been refined. prolongate the values of all
+          // vectors child by child, reusing the prolongation matrix for all
+          // vectors
+          const FiniteElement<dim,DoFHandlerType::space_dimension> &fe = cell->child(0)->get_fe();
+          const unsigned int dofs_per_cell = fe.dofs_per_cell;
+          if (dofs_per_cell == 0)
+            return;
+          cell_values.reinit(dofs_per_cell, true);
+          child_values.reinit(dofs_per_cell, true);
+
+          for (unsigned int child=0; child<cell->n_children(); ++child)
+            {
+              Assert (cell->child(child)->active(), ExcInternalError());
+              if (cell->child(child)->is_artificial())
+                continue;
+
+              const FullMatrix<double> &prolongation =
+                fe.get_prolongation_matrix(child, cell->refinement_case());
+              for (unsigned int v=0; v<all_out.size(); ++v)
+                {
+                  std::memcpy(cell_values.begin(), data_store + v*dofs_per_cell,
+                              sizeof(Number)*dofs_per_cell);
+                  prolongation.vmult (child_values, cell_values);
+                  cell->child(child)->set_dof_values(child_values, *all_out[v]);
+                }
+            }
+        }
+      else
         {
-          std::memcpy(&dofvalues(0), data_store, sizeof(typename VectorType::value_type)*dofs_per_cell);
-          cell->set_dof_values_by_interpolation(dofvalues, *(*it));
-          data_store += dofs_per_cell;
+          const unsigned int dofs_per_cell = cell->get_fe().dofs_per_cell;
+          cell_values.reinit(dofs_per_cell, true);
+          for (unsigned int v=0; v<all_out.size(); ++v)
+            {
+              std::memcpy(cell_values.begin(), data_store, sizeof(Number)*dofs_per_cell);
+              cell->set_dof_values_by_interpolation(cell_values, *all_out[v]);
+              data_store += dofs_per_cell;
+            }
         }
     }
 
@@ -19,6 +19,7 @@
 #include <deal.II/base/logstream.h>
 #include <deal.II/lac/sparsity_tools.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_accessor.h>
 #include <deal.II/grid/tria_iterator.h>
@@ -27,6 +28,8 @@
 #include <deal.II/distributed/p4est_wrappers.h>
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <numeric>
 #include <iostream>
 #include <fstream>
@@ -512,6 +515,28 @@ namespace
   }
 
 
+  // mark the coarse cells that contain active cells with refine or coarsen
+  // flags and return whether any flag is set
+  template <int dim, int spacedim>
+  bool
+  mark_coarse_cells_with_flags (const dealii::Triangulation<dim,spacedim> &tria,
+                                std::vector<bool>                         &marked_coarse_cells)
+  {
+    bool any_flag_set = false;
+    for (typename Triangulation<dim,spacedim>::active_cell_iterator
+         cell = tria.begin_active(); cell != tria.end(); ++cell)
+      if (cell->refine_flag_set() || cell->coarsen_flag_set())
+        {
+          typename Triangulation<dim,spacedim>::cell_iterator coarse_cell = cell;
+          while (coarse_cell->level() > 0)
+            coarse_cell = coarse_cell->parent();
+          marked_coarse_cells[coarse_cell->index()] = true;
+          any_flag_set = true;
+        }
+    return any_flag_set;
+  }
+
+
   template <int dim, int spacedim>
   void
   match_quadrant (const dealii::Triangulation<dim,spacedim>      *tria,
@@ -1296,6 +1321,11 @@ namespace parallel
       n_attached_datas(0),
       n_attached_deserialize(0)
     {
+      Assert (!((settings & hilbert_coarse_cell_ordering) &&
+                (settings & graph_partitioned_coarse_cell_ordering)),
+              ExcMessage("The orderings of the coarse cells along a Hilbert "
+                         "curve and by a graph partitioning cannot be "
+                         "combined"));
       parallel_ghost = nullptr;
     }
 
@@ -1732,12 +1762,91 @@ namespace parallel
     void
     Triangulation<dim,spacedim>::setup_coarse_cell_to_p4est_tree_permutation ()
     {
-      DynamicSparsityPattern cell_connectivity;
-      GridTools::get_vertex_connectivity_of_cells (*this, cell_connectivity);
-      coarse_cell_to_p4est_tree_permutation.resize (this->n_cells(0));
-      SparsityTools::
-      reorder_hierarchical (cell_connectivity,
-                            coarse_cell_to_p4est_tree_permutation);
+      const unsigned int n_coarse_cells = this->n_cells(0);
+      coarse_cell_to_p4est_tree_permutation.resize (n_coarse_cells);
+
+      if (settings & hilbert_coarse_cell_ordering)
+        {
+          // sort the coarse cells by the index of their center along a
+          // Hilbert curve through the bounding box of all centers
+          const unsigned int n_bits = std::min(32, 64/spacedim);
+          const double max_coordinate = (n_bits == 32 ?
+                                         4294967295. :
+                                         static_cast<double>((1U << n_bits) - 1));
+          std::vector<Point<spacedim> > centers (n_coarse_cells);
+          Point<spacedim> lower, upper;
+          for (typename Triangulation<dim,spacedim>::cell_iterator
+               cell = this->begin(0); cell != this->end(0); ++cell)
+            {
+              centers[cell->index()] = cell->center();
+              for (unsigned int d=0; d<spacedim; ++d)
+                if (cell == this->begin(0))
+                  lower[d] = upper[d] = centers[cell->index()][d];
+                else
+                  {
+                    lower[d] = std::min(lower[d], centers[cell->index()][d]);
+                    upper[d] = std::max(upper[d], centers[cell->index()][d]);
+                  }
+            }
+
+          std::vector<std::pair<std::uint64_t,unsigned int> > curve_order (n_coarse_cells);
+          for (unsigned int c=0; c<n_coarse_cells; ++c)
+            {
+              std::array<unsigned int,spacedim> coordinates;
+              for (unsigned int d=0; d<spacedim; ++d)
+                {
+                  const double extent = upper[d] - lower[d];
+                  const double scaled = (extent > 0 ?
+                                         (centers[c][d] - lower[d]) / extent :
+                                         0.);
+                  coordinates[d] = static_cast<unsigned int>
+                                   (std::max(0., std::min(1., scaled)) * max_coordinate);
+                }
+              curve_order[c] = std::make_pair(Utilities::hilbert_index<spacedim>(coordinates, n_bits), c);
+            }
+          std::sort (curve_order.begin(), curve_order.end());
+          for (unsigned int c=0; c<n_coarse_cells; ++c)
+            coarse_cell_to_p4est_tree_permutation[curve_order[c].second] = c;
+        }
+      else
+        {
+          DynamicSparsityPattern cell_connectivity;
+          GridTools::get_vertex_connectivity_of_cells (*this, cell_connectivity);
+          SparsityTools::
+          reorder_hierarchical (cell_connectivity,
+                                coarse_cell_to_p4est_tree_permutation);
+
+          if (settings & graph_partitioned_coarse_cell_ordering)
+            {
+              // group the coarse cells by their partition and keep the
+              // hierarchical ordering within each group. all processors
+              // compute the same partitioning from the same coarse mesh
+              SparsityPattern connectivity_pattern;
+              connectivity_pattern.copy_from (cell_connectivity);
+              std::vector<unsigned int> partition_indices (n_coarse_cells);
+              SparsityTools::partition (connectivity_pattern,
+                                        std::min(n_coarse_cells,
+                                                 Utilities::MPI::n_mpi_processes(this->mpi_communicator)),
+                                        partition_indices);
+
+              std::vector<std::pair<unsigned int,types::global_dof_index> >
+              partition_order (n_coarse_cells);
+              for (unsigned int c=0; c<n_coarse_cells; ++c)
+                partition_order[c] =
+                  std::make_pair(partition_indices[c],
+                                 coarse_cell_to_p4est_tree_permutation[c]);
+              std::vector<unsigned int> sorted_cells (n_coarse_cells);
+              for (unsigned int c=0; c<n_coarse_cells; ++c)
+                sorted_cells[c] = c;
+              std::sort (sorted_cells.begin(), sorted_cells.end(),
+                         [&](const unsigned int a, const unsigned int b)
+              {
+                return partition_order[a] < partition_order[b];
+              });
+              for (unsigned int c=0; c<n_coarse_cells; ++c)
+                coarse_cell_to_p4est_tree_permutation[sorted_cells[c]] = c;
+            }
+        }
 
       p4est_tree_to_coarse_cell_permutation
         = Utilities::invert_permutation (coarse_cell_to_p4est_tree_permutation);
@@ -1830,12 +1939,35 @@ namespace parallel
 
       unsigned int version, numcpus, attached_size, attached_count, n_coarse_cells;
       {
-        std::string fname=std::string(filename)+".info";
-        std::ifstream f(fname.c_str());
-        AssertThrow (f, ExcIO());
-        std::string firstline;
-        getline(f, firstline); //skip first line
-        f >> version >> numcpus >> attached_size >> attached_count >> n_coarse_cells;
+        // only read the small .info file on the root process and broadcast
+        // it, rather than opening it on all processes at the same time,
+        // which puts a large load on the metadata servers of parallel file
+        // systems. an invalid version signals that the file could not be
+        // read, so that all processes throw the exception together
+        unsigned int info[5] = {numbers::invalid_unsigned_int, 0, 0, 0, 0};
+        if (this->my_subdomain == 0)
+          {
+            std::string fname=std::string(filename)+".info";
+            std::ifstream f(fname.c_str());
+            if (f)
+              {
+                std::string firstline;
+                getline(f, firstline); //skip first line
+                f >> info[0] >> info[1] >> info[2] >> info[3] >> info[4];
+                if (!f)
+                  info[0] = numbers::invalid_unsigned_int;
+              }
+          }
+        const int ierr = MPI_Bcast(&info[0], 5, MPI_UNSIGNED, 0,
+                                   this->mpi_communicator);
+        AssertThrowMPI(ierr);
+        AssertThrow (info[0] != numbers::invalid_unsigned_int, ExcIO());
+
+        version = info[0];
+        numcpus = info[1];
+        attached_size = info[2];
+        attached_count = info[3];
+        n_coarse_cells = info[4];
       }
 
       Assert(version == 2, ExcMessage("Incompatible version found in .info file."));
@@ -2539,6 +2671,12 @@ namespace parallel
            ++cell)
         cell->recursively_set_subdomain_id(numbers::artificial_subdomain_id);
 
+      // in the first pass, all coarse cells need to be matched against the
+      // p4est forest. since the result of matching a tree only depends on
+      // the deal.II cells in that tree, later passes only need to revisit
+      // the trees which requested changes in the previous pass or whose
+      // cells have been changed by the refinement of the previous pass
+      std::vector<bool> tree_needs_matching (this->n_cells(0), true);
       do
         {
           for (typename Triangulation<dim,spacedim>::cell_iterator
@@ -2546,6 +2684,9 @@ namespace parallel
                cell != this->end(0);
                ++cell)
             {
+              if (tree_needs_matching[cell->index()] == false)
+                continue;
+
               // if this processor stores no part of the forest that comes out
               // of this coarse grid cell, then we need to delete all children
               // of this cell (the coarse grid cell remains)
@@ -2596,23 +2737,23 @@ namespace parallel
               unsigned int coarse_cell_index =
                 p4est_tree_to_coarse_cell_permutation[ghost_tree];
 
-              match_quadrant<dim,spacedim> (this, coarse_cell_index, *quadr, ghost_owner);
+              if (tree_needs_matching[coarse_cell_index])
+                match_quadrant<dim,spacedim> (this, coarse_cell_index, *quadr, ghost_owner);
             }
 
+          // record the trees for which the matching requested changes,
+          // including those that get removed by the smoothing below and
+          // might become possible once the neighbors have been changed
+          std::vector<bool> tree_requested_changes (this->n_cells(0), false);
+          mark_coarse_cells_with_flags (*this, tree_requested_changes);
+
           // fix all the flags to make sure we have a consistent mesh
           this->prepare_coarsening_and_refinement ();
 
-          // see if any flags are still set
-          mesh_changed = false;
-          for (typename Triangulation<dim,spacedim>::active_cell_iterator
-               cell = this->begin_active();
-               cell != this->end();
-               ++cell)
-            if (cell->refine_flag_set() || cell->coarsen_flag_set())
-              {
-                mesh_changed = true;
-                break;
-              }
+          // see if any flags are still set and collect the trees that will
+          // be changed by the refinement
+          mesh_changed = mark_coarse_cells_with_flags (*this, tree_requested_changes);
+          tree_needs_matching.swap (tree_requested_changes);
 
           // actually do the refinement to change the local mesh by
           // calling the base class refinement function directly
@@ -3569,6 +3710,21 @@ namespace parallel
 
 
 
+    template <int dim, int spacedim>
+    MemoryReport
+    Triangulation<dim,spacedim>::memory_report () const
+    {
+      MemoryReport report = dealii::Triangulation<dim,spacedim>::memory_report();
+      const std::size_t p4est = memory_consumption_p4est();
+      report.add ("p4est", p4est);
+      const std::size_t total = memory_consumption();
+      const std::size_t accounted = report.total_bytes();
+      report.add ("parallel data", total > accounted ? total - accounted : 0);
+      return report;
+    }
+
+
+
     template <int dim, int spacedim>
     void
     Triangulation<dim,spacedim>::
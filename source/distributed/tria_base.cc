@@ -110,6 +110,7 @@ namespace parallel
   Triangulation<dim,spacedim>::NumberCache::NumberCache()
     :
     n_global_active_cells(0),
+    n_ghost_active_cells(0),
     n_global_levels(0)
   {}
 
@@ -120,6 +121,13 @@ namespace parallel
     return number_cache.n_locally_owned_active_cells[my_subdomain];
   }
 
+  template <int dim, int spacedim>
+  unsigned int
+  Triangulation<dim,spacedim>::n_ghost_active_cells () const
+  {
+    return number_cache.n_ghost_active_cells;
+  }
+
   template <int dim, int spacedim>
   unsigned int
   Triangulation<dim,spacedim>::n_global_levels () const
@@ -164,6 +172,7 @@ namespace parallel
 
     number_cache.ghost_owners.clear ();
     number_cache.level_ghost_owners.clear ();
+    number_cache.n_ghost_active_cells = 0;
 
     if (this->n_levels() == 0)
       {
@@ -185,7 +194,10 @@ namespace parallel
            cell != this->end();
            ++cell)
         if (cell->is_ghost())
-          number_cache.ghost_owners.insert(cell->subdomain_id());
+          {
+            number_cache.ghost_owners.insert(cell->subdomain_id());
+            ++number_cache.n_ghost_active_cells;
+          }
 
       Assert(number_cache.ghost_owners.size() < Utilities::MPI::n_mpi_processes(mpi_communicator), ExcInternalError());
     }
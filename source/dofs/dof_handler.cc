@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1998 - 2016 by the deal.II authors
+// Copyright (C) 1998 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -260,6 +260,38 @@ namespace internal
       }
 
 
+      /**
+       * Set up the cache for the DoF indices on the cells of the given
+       * level. Only active cells that are not artificial get entries in the
+       * cache, since the cache is never read for other cells.
+       */
+      template <int dim, int spacedim>
+      static
+      void reserve_cell_dof_indices_cache (DoFHandler<dim,spacedim> &dof_handler,
+                                           const unsigned int        level)
+      {
+        internal::DoFHandler::DoFLevel<dim> &dof_level = *dof_handler.levels[level];
+        dof_level.cell_cache_offsets
+          = std::vector<unsigned int> (dof_handler.tria->n_raw_cells(level),
+                                       numbers::invalid_unsigned_int);
+
+        const unsigned int dofs_per_cell = dof_handler.get_fe().dofs_per_cell;
+        unsigned int cache_size = 0;
+        for (typename Triangulation<dim,spacedim>::active_cell_iterator
+             cell = dof_handler.tria->begin_active(level);
+             cell != dof_handler.tria->end_active(level); ++cell)
+          if (!cell->is_artificial())
+            {
+              dof_level.cell_cache_offsets[cell->index()] = cache_size;
+              cache_size += dofs_per_cell;
+            }
+
+        dof_level.cell_dof_indices_cache
+          = std::vector<types::global_dof_index> (cache_size,
+                                                  numbers::invalid_dof_index);
+      }
+
+
       /**
        * Reserve enough space in the
        * <tt>levels[]</tt> objects to store the
@@ -287,10 +319,7 @@ namespace internal
                      dof_handler.get_fe().dofs_per_line,
                      numbers::invalid_dof_index);
 
-            dof_handler.levels.back()->cell_dof_indices_cache
-            .resize (dof_handler.tria->n_raw_cells(i) *
-                     dof_handler.get_fe().dofs_per_cell,
-                     numbers::invalid_dof_index);
+            reserve_cell_dof_indices_cache (dof_handler, i);
           }
       }
 
@@ -313,10 +342,7 @@ namespace internal
                      dof_handler.get_fe().dofs_per_quad,
                      numbers::invalid_dof_index);
 
-            dof_handler.levels.back()->cell_dof_indices_cache
-            .resize (dof_handler.tria->n_raw_cells(i) *
-                     dof_handler.get_fe().dofs_per_cell,
-                     numbers::invalid_dof_index);
+            reserve_cell_dof_indices_cache (dof_handler, i);
           }
 
         dof_handler.faces.reset (new internal::DoFHandler::DoFFaces<2>);
@@ -349,10 +375,7 @@ namespace internal
                      dof_handler.get_fe().dofs_per_hex,
                      numbers::invalid_dof_index);
 
-            dof_handler.levels.back()->cell_dof_indices_cache
-            .resize (dof_handler.tria->n_raw_cells(i) *
-                     dof_handler.get_fe().dofs_per_cell,
-                     numbers::invalid_dof_index);
+            reserve_cell_dof_indices_cache (dof_handler, i);
           }
         dof_handler.faces.reset (new internal::DoFHandler::DoFFaces<3>);
 
@@ -988,6 +1011,39 @@ DoFHandler<dim,spacedim>::memory_consumption () const
 
 
 
+template <int dim, int spacedim>
+MemoryReport
+DoFHandler<dim,spacedim>::memory_report () const
+{
+  MemoryReport report ("DoFHandler");
+  MemoryReport &cell_dofs = report.add ("cell dofs");
+  for (unsigned int i=0; i<levels.size(); ++i)
+    cell_dofs.add ("level " + Utilities::int_to_string(i),
+                   MemoryConsumption::memory_consumption (*levels[i]));
+  if (faces != nullptr)
+    report.add ("face dofs", MemoryConsumption::memory_consumption (*faces));
+  report.add ("vertex dofs", MemoryConsumption::memory_consumption (vertex_dofs));
+
+  MemoryReport &mg_dofs = report.add ("multigrid dofs");
+  for (unsigned int level = 0; level < mg_levels.size (); ++level)
+    mg_dofs.add ("level " + Utilities::int_to_string(level),
+                 mg_levels[level]->memory_consumption ());
+  if (mg_faces != nullptr)
+    mg_dofs.add ("face dofs", MemoryConsumption::memory_consumption (*mg_faces));
+  std::size_t mg_vertex_memory = 0;
+  for (unsigned int i = 0; i < mg_vertex_dofs.size (); ++i)
+    mg_vertex_memory += sizeof (MGVertexDoFs) + (1 + mg_vertex_dofs[i].get_finest_level () - mg_vertex_dofs[i].get_coarsest_level ()) * sizeof (types::global_dof_index);
+  mg_dofs.add ("vertex dofs", mg_vertex_memory);
+
+  report.add ("finite elements", MemoryConsumption::memory_consumption (fe_collection));
+  report.add ("number caches", sizeof (number_cache) +
+              MemoryConsumption::memory_consumption (mg_number_cache) +
+              MemoryConsumption::memory_consumption (block_info_object));
+  return report;
+}
+
+
+
 template <int dim, int spacedim>
 void DoFHandler<dim,spacedim>::distribute_dofs (const FiniteElement<dim,spacedim> &ff)
 {
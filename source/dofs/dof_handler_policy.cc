@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1998 - 2016 by the deal.II authors
+// Copyright (C) 1998 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -19,6 +19,7 @@
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_iterator.h>
 #include <deal.II/dofs/dof_handler.h>
@@ -1510,6 +1511,38 @@ namespace internal
         /* --------------------- renumber_dofs functionality ---------------- */
 
 
+        /**
+         * Translate all valid DoF indices in the given array to their new
+         * numbers, see renumber_dofs() for the meaning of the arguments. The
+         * entries are independent of each other, so the work is split into
+         * chunks that are processed in parallel.
+         */
+        static
+        void
+        renumber_dof_array (const std::vector<types::global_dof_index> &new_numbers,
+                            const IndexSet                             &indices,
+                            std::vector<types::global_dof_index>       &dofs)
+        {
+          parallel::apply_to_subranges
+          (0U, static_cast<unsigned int>(dofs.size()),
+           [&](const unsigned int begin, const unsigned int end)
+          {
+            if (indices.size() == 0)
+              {
+                for (unsigned int i=begin; i<end; ++i)
+                  if (dofs[i] != numbers::invalid_dof_index)
+                    dofs[i] = new_numbers[dofs[i]];
+              }
+            else
+              for (unsigned int i=begin; i<end; ++i)
+                if (dofs[i] != numbers::invalid_dof_index)
+                  dofs[i] = new_numbers[indices.index_within_set(dofs[i])];
+          },
+          4096);
+        }
+
+
+
         /**
          * The part of the renumber_dofs() functionality that is dimension
          * independent because it renumbers the DoF indices on vertices
@@ -1531,21 +1564,24 @@ namespace internal
           // correct but also faster; note, however, that dof numbers
           // may be invalid_dof_index, namely when the appropriate
           // vertex/line/etc is unused
-          for (std::vector<types::global_dof_index>::iterator
-               i=dof_handler.vertex_dofs.begin();
-               i!=dof_handler.vertex_dofs.end(); ++i)
-            if (*i != numbers::invalid_dof_index)
-              *i = (indices.size() == 0)?
-                   (new_numbers[*i]) :
-                   (new_numbers[indices.index_within_set(*i)]);
-            else if (check_validity)
-              // if index is invalid_dof_index: check if this one
-              // really is unused
-              Assert (dof_handler.get_triangulation()
-                      .vertex_used((i-dof_handler.vertex_dofs.begin()) /
-                                   dof_handler.get_fe().dofs_per_vertex)
-                      == false,
-                      ExcInternalError ());
+#ifdef DEBUG
+          if (check_validity)
+            for (std::vector<types::global_dof_index>::iterator
+                 i=dof_handler.vertex_dofs.begin();
+                 i!=dof_handler.vertex_dofs.end(); ++i)
+              if (*i == numbers::invalid_dof_index)
+                // if index is invalid_dof_index: check if this one
+                // really is unused
+                Assert (dof_handler.get_triangulation()
+                        .vertex_used((i-dof_handler.vertex_dofs.begin()) /
+                                     dof_handler.get_fe().dofs_per_vertex)
+                        == false,
+                        ExcInternalError ());
+#else
+          (void)check_validity;
+#endif
+
+          renumber_dof_array (new_numbers, indices, dof_handler.vertex_dofs);
         }
 
 
@@ -1565,13 +1601,8 @@ namespace internal
                             DoFHandler<dim,spacedim>                   &dof_handler)
         {
           for (unsigned int level=0; level<dof_handler.levels.size(); ++level)
-            for (std::vector<types::global_dof_index>::iterator
-                 i=dof_handler.levels[level]->dof_object.dofs.begin();
-                 i!=dof_handler.levels[level]->dof_object.dofs.end(); ++i)
-              if (*i != numbers::invalid_dof_index)
-                *i = ((indices.size() == 0) ?
-                      new_numbers[*i] :
-                      new_numbers[indices.index_within_set(*i)]);
+            renumber_dof_array (new_numbers, indices,
+                                dof_handler.levels[level]->dof_object.dofs);
         }
 
 
@@ -1603,13 +1634,7 @@ namespace internal
                             DoFHandler<2,spacedim>                     &dof_handler)
         {
           // treat dofs on lines
-          for (std::vector<types::global_dof_index>::iterator
-               i=dof_handler.faces->lines.dofs.begin();
-               i!=dof_handler.faces->lines.dofs.end(); ++i)
-            if (*i != numbers::invalid_dof_index)
-              *i = ((indices.size() == 0) ?
-                    new_numbers[*i] :
-                    new_numbers[indices.index_within_set(*i)]);
+          renumber_dof_array (new_numbers, indices, dof_handler.faces->lines.dofs);
         }
 
 
@@ -1622,22 +1647,10 @@ namespace internal
                             DoFHandler<3,spacedim>                     &dof_handler)
         {
           // treat dofs on lines
-          for (std::vector<types::global_dof_index>::iterator
-               i=dof_handler.faces->lines.dofs.begin();
-               i!=dof_handler.faces->lines.dofs.end(); ++i)
-            if (*i != numbers::invalid_dof_index)
-              *i = ((indices.size() == 0) ?
-                    new_numbers[*i] :
-                    new_numbers[indices.index_within_set(*i)]);
+          renumber_dof_array (new_numbers, indices, dof_handler.faces->lines.dofs);
 
           // treat dofs on quads
-          for (std::vector<types::global_dof_index>::iterator
-               i=dof_handler.faces->quads.dofs.begin();
-               i!=dof_handler.faces->quads.dofs.end(); ++i)
-            if (*i != numbers::invalid_dof_index)
-              *i = ((indices.size() == 0) ?
-                    new_numbers[*i] :
-                    new_numbers[indices.index_within_set(*i)]);
+          renumber_dof_array (new_numbers, indices, dof_handler.faces->quads.dofs);
         }
 
 
@@ -1759,53 +1772,10 @@ namespace internal
                             const IndexSet                             &indices,
                             hp::DoFHandler<2,spacedim>                 &dof_handler)
         {
-          const unsigned int dim = 2;
-
-          // deal with DoFs on lines
-          {
-            // save user flags on lines so we can use them to mark lines
-            // we've already treated
-            std::vector<bool> saved_line_user_flags;
-            const_cast<dealii::Triangulation<dim,spacedim>&>(dof_handler.get_triangulation())
-            .save_user_flags_line (saved_line_user_flags);
-            const_cast<dealii::Triangulation<dim,spacedim>&>(dof_handler.get_triangulation())
-            .clear_user_flags_line ();
-
-            for (typename hp::DoFHandler<dim,spacedim>::active_cell_iterator
-                 cell = dof_handler.begin_active(); cell!=dof_handler.end(); ++cell)
-              if (!cell->is_artificial())
-                for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
-                  if (cell->line(l)->user_flag_set() == false)
-                    {
-                      const typename hp::DoFHandler<dim,spacedim>::line_iterator line = cell->line(l);
-                      line->set_user_flag();
-
-                      const unsigned int n_active_fe_indices
-                        = line->n_active_fe_indices ();
-
-                      for (unsigned int f=0; f<n_active_fe_indices; ++f)
-                        {
-                          const unsigned int fe_index
-                            = line->nth_active_fe_index (f);
-
-                          for (unsigned int d=0; d<dof_handler.get_fe(fe_index).dofs_per_line; ++d)
-                            {
-                              const types::global_dof_index old_dof_index = line->dof_index(d,fe_index);
-                              if (old_dof_index != numbers::invalid_dof_index)
-                                line->set_dof_index (d,
-                                                     (indices.size() == 0)?
-                                                     (new_numbers[old_dof_index]) :
-                                                     (new_numbers[indices.index_within_set(old_dof_index)]),
-                                                     fe_index);
-                            }
-                        }
-                    }
-
-            // at the end, restore the user
-            // flags for the lines
-            const_cast<dealii::Triangulation<dim,spacedim>&>(dof_handler.get_triangulation())
-            .load_user_flags_line (saved_line_user_flags);
-          }
+          // the DoF indices of all sets on all lines are stored
+          // contiguously without any other data in between, so we can
+          // treat them just like for the non-hp case
+          renumber_dof_array (new_numbers, indices, dof_handler.faces->lines.dofs);
         }
 
 
@@ -1817,96 +1787,11 @@ namespace internal
                             const IndexSet                             &indices,
                             hp::DoFHandler<3,spacedim>                 &dof_handler)
         {
-          const unsigned int dim = 3;
-
-          // deal with DoFs on lines
-          {
-            // save user flags on lines so we can use them to mark lines
-            // we've already treated
-            std::vector<bool> saved_line_user_flags;
-            const_cast<dealii::Triangulation<dim,spacedim>&>(dof_handler.get_triangulation())
-            .save_user_flags_line (saved_line_user_flags);
-            const_cast<dealii::Triangulation<dim,spacedim>&>(dof_handler.get_triangulation())
-            .clear_user_flags_line ();
-
-            for (typename hp::DoFHandler<dim,spacedim>::active_cell_iterator
-                 cell = dof_handler.begin_active(); cell!=dof_handler.end(); ++cell)
-              if (!cell->is_artificial())
-                for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
-                  if (cell->line(l)->user_flag_set() == false)
-                    {
-                      const typename hp::DoFHandler<dim,spacedim>::line_iterator line = cell->line(l);
-                      line->set_user_flag();
-
-                      const unsigned int n_active_fe_indices
-                        = line->n_active_fe_indices ();
-
-                      for (unsigned int f=0; f<n_active_fe_indices; ++f)
-                        {
-                          const unsigned int fe_index
-                            = line->nth_active_fe_index (f);
-
-                          for (unsigned int d=0; d<dof_handler.get_fe(fe_index).dofs_per_line; ++d)
-                            {
-                              const types::global_dof_index old_dof_index = line->dof_index(d,fe_index);
-                              if (old_dof_index != numbers::invalid_dof_index)
-                                line->set_dof_index (d,
-                                                     (indices.size() == 0)?
-                                                     (new_numbers[old_dof_index]) :
-                                                     (new_numbers[indices.index_within_set(old_dof_index)]),
-                                                     fe_index);
-                            }
-                        }
-                    }
-
-            // at the end, restore the user
-            // flags for the lines
-            const_cast<dealii::Triangulation<dim,spacedim>&>(dof_handler.get_triangulation())
-            .load_user_flags_line (saved_line_user_flags);
-          }
-
-          // then deal with dofs on quads
-          {
-            std::vector<bool> saved_quad_user_flags;
-            const_cast<dealii::Triangulation<dim,spacedim>&>(dof_handler.get_triangulation())
-            .save_user_flags_quad (saved_quad_user_flags);
-            const_cast<dealii::Triangulation<dim,spacedim>&>(dof_handler.get_triangulation())
-            .clear_user_flags_quad ();
-
-            for (typename hp::DoFHandler<dim,spacedim>::active_cell_iterator
-                 cell = dof_handler.begin_active(); cell!=dof_handler.end(); ++cell)
-              if (!cell->is_artificial())
-                for (unsigned int q=0; q<GeometryInfo<dim>::quads_per_cell; ++q)
-                  if (cell->quad(q)->user_flag_set() == false)
-                    {
-                      const typename hp::DoFHandler<dim,spacedim>::quad_iterator quad = cell->quad(q);
-                      quad->set_user_flag();
-
-                      const unsigned int n_active_fe_indices
-                        = quad->n_active_fe_indices ();
-
-                      for (unsigned int f=0; f<n_active_fe_indices; ++f)
-                        {
-                          const unsigned int fe_index
-                            = quad->nth_active_fe_index (f);
-
-                          for (unsigned int d=0; d<dof_handler.get_fe(fe_index).dofs_per_quad; ++d)
-                            {
-                              const types::global_dof_index old_dof_index = quad->dof_index(d,fe_index);
-                              if (old_dof_index != numbers::invalid_dof_index)
-                                quad->set_dof_index (d,
-                                                     (indices.size() == 0)?
-                                                     (new_numbers[old_dof_index]) :
-                                                     (new_numbers[indices.index_within_set(old_dof_index)]),
-                                                     fe_index);
-                            }
-                        }
-                    }
+          // treat dofs on lines
+          renumber_dof_array (new_numbers, indices, dof_handler.faces->lines.dofs);
 
-            // at the end, restore the user flags for the quads
-            const_cast<dealii::Triangulation<dim,spacedim>&>(dof_handler.get_triangulation())
-            .load_user_flags_quad (saved_quad_user_flags);
-          }
+          // treat dofs on quads
+          renumber_dof_array (new_numbers, indices, dof_handler.faces->quads.dofs);
         }
 
 
@@ -54,6 +54,8 @@ DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 
 #include <vector>
+#include <array>
+#include <cstdint>
 #include <map>
 #include <algorithm>
 #include <cmath>
@@ -1218,6 +1220,171 @@ namespace DoFRenumbering
 
 
 
+  namespace
+  {
+    // helper function for hilbert(): number the locally owned degrees of
+    // freedom on the given cells along a Hilbert curve through the cell
+    // centers. The bounding box of the curve is the one of the cells
+    // passed in, so every processor resolves its own part of the mesh with
+    // the full precision of the curve.
+    template <int spacedim, class CellIterator>
+    void
+    compute_hilbert_on_cells (std::vector<types::global_dof_index> &new_indices,
+                              const std::vector<CellIterator>      &cells,
+                              const IndexSet                       &locally_owned)
+    {
+      // use as many bits per coordinate direction as fit into the 64 bit
+      // index, but not more than fit into an unsigned int
+      const unsigned int n_bits = std::min(32, 64/spacedim);
+      const double max_coordinate = (n_bits == 32 ?
+                                     4294967295. :
+                                     static_cast<double>((1U << n_bits) - 1));
+
+      std::vector<Point<spacedim> > centers (cells.size());
+      Point<spacedim> lower, upper;
+      for (unsigned int c=0; c<cells.size(); ++c)
+        {
+          centers[c] = cells[c]->center();
+          for (unsigned int d=0; d<spacedim; ++d)
+            if (c == 0)
+              lower[d] = upper[d] = centers[c][d];
+            else
+              {
+                lower[d] = std::min(lower[d], centers[c][d]);
+                upper[d] = std::max(upper[d], centers[c][d]);
+              }
+        }
+
+      // sort the cells by their index on the curve. the position of the
+      // cell in the original list breaks ties, which makes the resulting
+      // ordering deterministic
+      std::vector<std::pair<std::uint64_t,unsigned int> > curve_order (cells.size());
+      for (unsigned int c=0; c<cells.size(); ++c)
+        {
+          std::array<unsigned int,spacedim> coordinates;
+          for (unsigned int d=0; d<spacedim; ++d)
+            {
+              const double extent = upper[d] - lower[d];
+              const double scaled = (extent > 0 ?
+                                     (centers[c][d] - lower[d]) / extent :
+                                     0.);
+              coordinates[d] = static_cast<unsigned int>
+                               (std::max(0., std::min(1., scaled)) * max_coordinate);
+            }
+          curve_order[c] = std::make_pair(Utilities::hilbert_index<spacedim>(coordinates, n_bits), c);
+        }
+      std::sort (curve_order.begin(), curve_order.end());
+
+      types::global_dof_index next_free = 0;
+      std::vector<types::global_dof_index> local_dof_indices;
+      for (unsigned int c=0; c<curve_order.size(); ++c)
+        {
+          const CellIterator &cell = cells[curve_order[c].second];
+          local_dof_indices.resize (cell->get_fe().dofs_per_cell);
+          cell->get_active_or_mg_dof_indices (local_dof_indices);
+
+          for (unsigned int i=0; i<local_dof_indices.size(); ++i)
+            if (locally_owned.is_element (local_dof_indices[i]))
+              {
+                // this is a locally owned DoF, assign new number if not
+                // assigned a number yet
+                const types::global_dof_index idx
+                  = locally_owned.index_within_set (local_dof_indices[i]);
+                if (new_indices[idx] == numbers::invalid_dof_index)
+                  {
+                    new_indices[idx] = locally_owned.nth_index_in_set (next_free);
+                    ++next_free;
+                  }
+              }
+        }
+
+      // make sure that all local DoFs got new numbers assigned
+      Assert (next_free == locally_owned.n_elements(),
+              ExcMessage ("Traversing over the locally owned cells did not "
+                          "cover all locally owned degrees of freedom."));
+    }
+  }
+
+
+
+  template <typename DoFHandlerType>
+  void
+  hilbert (DoFHandlerType &dof_handler)
+  {
+    std::vector<types::global_dof_index> renumbering (dof_handler.n_locally_owned_dofs(),
+                                                      numbers::invalid_dof_index);
+    compute_hilbert (renumbering, dof_handler);
+
+    dof_handler.renumber_dofs(renumbering);
+  }
+
+
+
+  template <typename DoFHandlerType>
+  void
+  compute_hilbert (std::vector<types::global_dof_index> &new_indices,
+                   const DoFHandlerType                 &dof_handler)
+  {
+    Assert (new_indices.size() == dof_handler.n_locally_owned_dofs(),
+            ExcDimensionMismatch (new_indices.size(),
+                                  dof_handler.n_locally_owned_dofs()));
+    std::fill (new_indices.begin(), new_indices.end(),
+               numbers::invalid_dof_index);
+
+    std::vector<typename DoFHandlerType::active_cell_iterator> cells;
+    for (typename DoFHandlerType::active_cell_iterator
+         cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+      if (cell->is_locally_owned())
+        cells.push_back (cell);
+
+    compute_hilbert_on_cells<DoFHandlerType::space_dimension>
+    (new_indices, cells, dof_handler.locally_owned_dofs());
+  }
+
+
+
+  template <typename DoFHandlerType>
+  void
+  hilbert (DoFHandlerType     &dof_handler,
+           const unsigned int  level)
+  {
+    Assert(dof_handler.n_dofs(level) != numbers::invalid_dof_index,
+           ExcDoFHandlerNotInitialized());
+
+    std::vector<types::global_dof_index> renumbering (dof_handler.n_dofs(level),
+                                                      numbers::invalid_dof_index);
+    compute_hilbert (renumbering, dof_handler, level);
+
+    dof_handler.renumber_dofs(level, renumbering);
+  }
+
+
+
+  template <typename DoFHandlerType>
+  void
+  compute_hilbert (std::vector<types::global_dof_index> &new_indices,
+                   const DoFHandlerType                 &dof_handler,
+                   const unsigned int                    level)
+  {
+    const IndexSet &locally_owned = dof_handler.locally_owned_mg_dofs(level);
+    Assert (new_indices.size() == locally_owned.n_elements(),
+            ExcDimensionMismatch (new_indices.size(),
+                                  locally_owned.n_elements()));
+    std::fill (new_indices.begin(), new_indices.end(),
+               numbers::invalid_dof_index);
+
+    std::vector<typename DoFHandlerType::level_cell_iterator> cells;
+    for (typename DoFHandlerType::level_cell_iterator
+         cell = dof_handler.begin(level); cell != dof_handler.end(level); ++cell)
+      if (cell->is_locally_owned_on_level())
+        cells.push_back (cell);
+
+    compute_hilbert_on_cells<DoFHandlerType::space_dimension>
+    (new_indices, cells, locally_owned);
+  }
+
+
+
   template <typename DoFHandlerType>
   void
   sort_selected_dofs_back (DoFHandlerType          &dof_handler,
@@ -301,6 +301,17 @@ namespace DoFTools
 
 
 
+      /**
+       * A lock for the creation of entries in the caches of split
+       * interpolation matrices and masks used by
+       * make_hp_hanging_node_constraints(). The
+       * caches are filled lazily from several threads, so the functions
+       * below that create an entry first acquire this lock.
+       */
+      Threads::Mutex interpolation_matrix_mutex;
+
+
+
       /**
        * Make sure that the mask exists that determines which dofs will be
        * the masters on refined faces where an fe1 and a fe2 meet.
@@ -312,6 +323,7 @@ namespace DoFTools
                                            const FullMatrix<double> &face_interpolation_matrix,
                                            std::unique_ptr<std::vector<bool> > &master_dof_mask)
       {
+        Threads::Mutex::ScopedLock lock (interpolation_matrix_mutex);
         if (master_dof_mask == nullptr)
           {
             master_dof_mask = std_cxx14::make_unique<std::vector<bool> > (fe1.dofs_per_face);
@@ -324,51 +336,6 @@ namespace DoFTools
 
 
 
-      /**
-       * Make sure that the given @p face_interpolation_matrix pointer
-       * points to a valid matrix. If the pointer is zero beforehand,
-       * create an entry with the correct data. If it is nonzero, don't
-       * touch it.
-       */
-      template <int dim, int spacedim>
-      void
-      ensure_existence_of_face_matrix (const FiniteElement<dim,spacedim> &fe1,
-                                       const FiniteElement<dim,spacedim> &fe2,
-                                       std::unique_ptr<FullMatrix<double> > &matrix)
-      {
-        if (matrix == nullptr)
-          {
-            matrix = std_cxx14::make_unique<FullMatrix<double> > (fe2.dofs_per_face,
-                                                                  fe1.dofs_per_face);
-            fe1.get_face_interpolation_matrix (fe2,
-                                               *matrix);
-          }
-      }
-
-
-
-      /**
-       * Same, but for subface interpolation matrices.
-       */
-      template <int dim, int spacedim>
-      void
-      ensure_existence_of_subface_matrix (const FiniteElement<dim,spacedim> &fe1,
-                                          const FiniteElement<dim,spacedim> &fe2,
-                                          const unsigned int        subface,
-                                          std::unique_ptr<FullMatrix<double> > &matrix)
-      {
-        if (matrix == nullptr)
-          {
-            matrix = std_cxx14::make_unique<FullMatrix<double> > (fe2.dofs_per_face,
-                                                                  fe1.dofs_per_face);
-            fe1.get_subface_interpolation_matrix (fe2,
-                                                  subface,
-                                                  *matrix);
-          }
-      }
-
-
-
       /**
        * Given the face interpolation matrix between two elements, split it
        * into its master and slave parts and invert the master part as
@@ -384,6 +351,7 @@ namespace DoFTools
                 static_cast<signed int>(face_interpolation_matrix.n()),
                 ExcInternalError());
 
+        Threads::Mutex::ScopedLock lock (interpolation_matrix_mutex);
         if (split_matrix == nullptr)
           {
             split_matrix = std_cxx14::make_unique<std::pair<FullMatrix<double>,FullMatrix<double> > >();
@@ -545,6 +513,56 @@ namespace DoFTools
             }
       }
 
+
+
+      /**
+       * Scratch arrays for the worker of make_hp_hanging_node_constraints(),
+       * kept between cells to avoid permanent re-allocation of memory: a
+       * matrix to be used for constraints, arrays that hold master and
+       * slave dof numbers, and a scratch array needed for the complicated
+       * case.
+       */
+      struct HangingNodeScratchData
+      {
+        FullMatrix<double>                   constraint_matrix;
+        std::vector<types::global_dof_index> master_dofs;
+        std::vector<types::global_dof_index> slave_dofs;
+        std::vector<types::global_dof_index> scratch_dofs;
+      };
+
+
+
+      /**
+       * The constraints computed on the faces of one cell by the worker of
+       * make_hp_hanging_node_constraints(), in the form of the arguments to
+       * filter_constraints(). Only the first @p n_constraints entries of the
+       * arrays are valid; the arrays are not shrunk between cells to reuse
+       * their memory.
+       */
+      struct HangingNodeCopyData
+      {
+        void add_constraints (const std::vector<types::global_dof_index> &master,
+                              const std::vector<types::global_dof_index> &slave,
+                              const FullMatrix<double>                   &matrix)
+        {
+          if (n_constraints == master_dofs.size())
+            {
+              master_dofs.emplace_back ();
+              slave_dofs.emplace_back ();
+              face_constraints.emplace_back ();
+            }
+          master_dofs[n_constraints] = master;
+          slave_dofs[n_constraints] = slave;
+          face_constraints[n_constraints] = matrix;
+          ++n_constraints;
+        }
+
+        unsigned int                                       n_constraints = 0;
+        std::vector<std::vector<types::global_dof_index> > master_dofs;
+        std::vector<std::vector<types::global_dof_index> > slave_dofs;
+        std::vector<FullMatrix<double> >                   face_constraints;
+      };
+
     }
 
 
@@ -1035,31 +1053,15 @@ namespace DoFTools
 
       const unsigned int spacedim = DoFHandlerType::space_dimension;
 
+      // the face and subface interpolation matrices between different (or
+      // the same) finite elements as well as the dominating elements are
+      // computed by the collection the first time they are needed and then
+      // kept there, also for later calls of this function. it is safe to
+      // query them from the worker threads below
+      const dealii::hp::FECollection<dim,spacedim> &fe_collection =
+        dof_handler.get_fe_collection ();
 
-      // a matrix to be used for constraints below. declared here and
-      // simply resized down below to avoid permanent re-allocation of
-      // memory
-      FullMatrix<double> constraint_matrix;
-
-      // similarly have arrays that will hold master and slave dof numbers,
-      // as well as a scratch array needed for the complicated case below
-      std::vector<types::global_dof_index> master_dofs;
-      std::vector<types::global_dof_index> slave_dofs;
-      std::vector<types::global_dof_index> scratch_dofs;
-
-      // caches for the face and subface interpolation matrices between
-      // different (or the same) finite elements. we compute them only
-      // once, namely the first time they are needed, and then just reuse
-      // them
-      Table<2,std::unique_ptr<FullMatrix<double> > >
-      face_interpolation_matrices (n_finite_elements (dof_handler),
-                                   n_finite_elements (dof_handler));
-      Table<3,std::unique_ptr<FullMatrix<double> > >
-      subface_interpolation_matrices (n_finite_elements (dof_handler),
-                                      n_finite_elements (dof_handler),
-                                      GeometryInfo<dim>::max_children_per_face);
-
-      // similarly have a cache for the matrices that are split into their
+      // have a cache for the matrices that are split into their
       // master and slave parts, and for which the master part is inverted.
       // these two matrices are derived from the face interpolation matrix
       // as described in the @ref hp_paper "hp paper"
@@ -1074,628 +1076,605 @@ namespace DoFTools
       master_dof_masks (n_finite_elements (dof_handler),
                         n_finite_elements (dof_handler));
 
-      // loop over all faces
+      // loop over all faces, in parallel over the cells. the worker
+      // computes the constraints on the faces of one cell and only stores
+      // them in the copy data object; they are entered into the
+      // ConstraintMatrix by the copier, see below
       //
       // note that even though we may visit a face twice if the neighboring
       // cells are equally refined, we can only visit each face with
       // hanging nodes once
-      typename DoFHandlerType::active_cell_iterator cell = dof_handler.begin_active(),
-                                                    endc = dof_handler.end();
-      for (; cell!=endc; ++cell)
-        {
-          // artificial cells can at best neighbor ghost cells, but we're not
-          // interested in these interfaces
-          if (cell->is_artificial ())
-            continue;
-
-          for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
-            if (cell->face(face)->has_children())
-              {
-                // first of all, make sure that we treat a case which is
-                // possible, i.e. either no dofs on the face at all or no
-                // anisotropic refinement
-                if (cell->get_fe().dofs_per_face == 0)
-                  continue;
+      auto worker
+        = [&] (const typename DoFHandlerType::active_cell_iterator &cell,
+               HangingNodeScratchData                              &scratch,
+               HangingNodeCopyData                                 &copy_data)
+      {
+        copy_data.n_constraints = 0;
 
-                Assert(cell->face(face)->refinement_case()==RefinementCase<dim-1>::isotropic_refinement,
-                       ExcNotImplemented());
+        FullMatrix<double> &constraint_matrix = scratch.constraint_matrix;
+        std::vector<types::global_dof_index> &master_dofs = scratch.master_dofs;
+        std::vector<types::global_dof_index> &slave_dofs = scratch.slave_dofs;
+        std::vector<types::global_dof_index> &scratch_dofs = scratch.scratch_dofs;
 
-                // so now we've found a face of an active cell that has
-                // children. that means that there are hanging nodes here.
+        // artificial cells can at best neighbor ghost cells, but we're not
+        // interested in these interfaces
+        if (cell->is_artificial ())
+          return;
 
-                // in any case, faces can have at most two sets of active
-                // fe indices, but here the face can have only one (namely
-                // the same as that from the cell we're sitting on), and
-                // each of the children can have only one as well. check
-                // this
-                Assert (cell->face(face)->n_active_fe_indices() == 1,
-                        ExcInternalError());
-                Assert (cell->face(face)->fe_index_is_active(cell->active_fe_index())
-                        == true,
+        for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
+          if (cell->face(face)->has_children())
+            {
+              // first of all, make sure that we treat a case which is
+              // possible, i.e. either no dofs on the face at all or no
+              // anisotropic refinement
+              if (cell->get_fe().dofs_per_face == 0)
+                continue;
+
+              Assert(cell->face(face)->refinement_case()==RefinementCase<dim-1>::isotropic_refinement,
+                     ExcNotImplemented());
+
+              // so now we've found a face of an active cell that has
+              // children. that means that there are hanging nodes here.
+
+              // in any case, faces can have at most two sets of active
+              // fe indices, but here the face can have only one (namely
+              // the same as that from the cell we're sitting on), and
+              // each of the children can have only one as well. check
+              // this
+              Assert (cell->face(face)->n_active_fe_indices() == 1,
+                      ExcInternalError());
+              Assert (cell->face(face)->fe_index_is_active(cell->active_fe_index())
+                      == true,
+                      ExcInternalError());
+              for (unsigned int c=0; c<cell->face(face)->n_children(); ++c)
+                Assert (cell->face(face)->child(c)->n_active_fe_indices() == 1,
                         ExcInternalError());
-                for (unsigned int c=0; c<cell->face(face)->n_children(); ++c)
-                  Assert (cell->face(face)->child(c)->n_active_fe_indices() == 1,
-                          ExcInternalError());
-
-                // first find out whether we can constrain each of the
-                // subfaces to the mother face. in the lingo of the hp
-                // paper, this would be the simple case. note that we can
-                // short-circuit this decision if the dof_handler doesn't
-                // support hp at all
-                //
-                // ignore all interfaces with artificial cells
-                FiniteElementDomination::Domination
-                mother_face_dominates = FiniteElementDomination::either_element_can_dominate;
-
-                // auxiliary variable which holds FE indices of the mother face
-                // and its subfaces. This knowledge will be needed in hp-case
-                // with neither_element_dominates.
-                std::set<unsigned int> fe_ind_face_subface;
-                fe_ind_face_subface.insert(cell->active_fe_index());
-
-                if (DoFHandlerSupportsDifferentFEs<DoFHandlerType>::value == true)
-                  for (unsigned int c=0; c<cell->face(face)->number_of_children(); ++c)
-                    if (!cell->neighbor_child_on_subface (face, c)->is_artificial())
-                      {
-                        mother_face_dominates = mother_face_dominates &
-                                                (cell->get_fe().compare_for_face_domination
-                                                 (cell->neighbor_child_on_subface (face, c)->get_fe()));
-                        fe_ind_face_subface.insert(cell->neighbor_child_on_subface (face, c)->active_fe_index());
-                      }
-
-                switch (mother_face_dominates)
-                  {
-                  case FiniteElementDomination::this_element_dominates:
-                  case FiniteElementDomination::either_element_can_dominate:
-                  {
-                    // Case 1 (the simple case and the only case that can
-                    // happen for non-hp DoFHandlers): The coarse element
-                    // dominates the elements on the subfaces (or they are
-                    // all the same)
-                    //
-                    // so we are going to constrain the DoFs on the face
-                    // children against the DoFs on the face itself
-                    master_dofs.resize (cell->get_fe().dofs_per_face);
-
-                    cell->face(face)->get_dof_indices (master_dofs,
-                                                       cell->active_fe_index ());
-
-                    // Now create constraint matrix for the subfaces and
-                    // assemble it. ignore all interfaces with artificial
-                    // cells because we can only get to such interfaces if
-                    // the current cell is a ghost cell
-                    for (unsigned int c=0; c<cell->face(face)->n_children(); ++c)
-                      {
-                        if (cell->neighbor_child_on_subface (face, c)->is_artificial())
-                          continue;
-
-                        const typename DoFHandlerType::active_face_iterator
-                        subface = cell->face(face)->child(c);
-
-                        Assert (subface->n_active_fe_indices() == 1,
-                                ExcInternalError());
-
-                        const unsigned int
-                        subface_fe_index = subface->nth_active_fe_index(0);
-
-                        // we sometime run into the situation where for
-                        // example on one big cell we have a FE_Q(1) and on
-                        // the subfaces we have a mixture of FE_Q(1) and
-                        // FE_Nothing. In that case, the face domination is
-                        // either_element_can_dominate for the whole
-                        // collection of subfaces, but on the particular
-                        // subface between FE_Q(1) and FE_Nothing, there
-                        // are no constraints that we need to take care of.
-                        // in that case, just continue
-                        if (cell->get_fe().compare_for_face_domination
-                            (subface->get_fe(subface_fe_index))
-                            ==
-                            FiniteElementDomination::no_requirements)
-                          continue;
-
-                        // Same procedure as for the mother cell. Extract
-                        // the face DoFs from the cell DoFs.
-                        slave_dofs.resize (subface->get_fe(subface_fe_index)
-                                           .dofs_per_face);
-                        subface->get_dof_indices (slave_dofs, subface_fe_index);
-
-                        for (unsigned int i=0; i<slave_dofs.size(); ++i)
-                          Assert (slave_dofs[i] != numbers::invalid_dof_index,
-                                  ExcInternalError());
-
-                        // Now create the element constraint for this
-                        // subface.
-                        //
-                        // As a side remark, one may wonder the following:
-                        // neighbor_child is clearly computed correctly,
-                        // i.e. taking into account face_orientation (just
-                        // look at the implementation of that function).
-                        // however, we don't care about this here, when we
-                        // ask for subface_interpolation on subface c. the
-                        // question rather is: do we have to translate 'c'
-                        // here as well?
-                        //
-                        // the answer is in fact 'no'. if one does that,
-                        // results are wrong: constraints are added twice
-                        // for the same pair of nodes but with differing
-                        // weights. in addition, one can look at the
-                        // deal.II/project_*_03 tests that look at exactly
-                        // this case: there, we have a mesh with at least
-                        // one face_orientation==false and hanging nodes,
-                        // and the results of those tests show that the
-                        // result of projection verifies the approximation
-                        // properties of a finite element onto that mesh
-                        ensure_existence_of_subface_matrix
-                        (cell->get_fe(),
-                         subface->get_fe(subface_fe_index),
-                         c,
-                         subface_interpolation_matrices
-                         [cell->active_fe_index()][subface_fe_index][c]);
-
-                        // Add constraints to global constraint matrix.
-                        filter_constraints (master_dofs,
-                                            slave_dofs,
-                                            *(subface_interpolation_matrices
-                                              [cell->active_fe_index()][subface_fe_index][c]),
-                                            constraints);
-                      }
-
-                    break;
-                  }
-
-                  case FiniteElementDomination::other_element_dominates:
-                  case FiniteElementDomination::neither_element_dominates:
-                  {
-                    // Case 2 (the "complex" case): at least one (the
-                    // neither_... case) of the finer elements or all of
-                    // them (the other_... case) is dominating. See the hp
-                    // paper for a way how to deal with this situation
-                    //
-                    // since this is something that can only happen for hp
-                    // dof handlers, add a check here...
-                    Assert (DoFHandlerSupportsDifferentFEs<DoFHandlerType>::value == true,
-                            ExcInternalError());
-
-                    const dealii::hp::FECollection<dim,spacedim> &fe_collection =
-                      dof_handler.get_fe_collection ();
-                    // we first have to find the finite element that is
-                    // able to generate a space that all the other ones can
-                    // be constrained to.
-                    // At this point we potentially have different scenarios:
-                    // 1) sub-faces dominate mother face and there is a
-                    // dominating FE among sub faces. We could loop over sub
-                    // faces to find the needed FE index. However, this will not
-                    // work in the case when
-                    // 2) there is no dominating FE among sub faces (e.g. Q1xQ2 vs Q2xQ1),
-                    // but subfaces still dominate mother face (e.g. Q2xQ2).
-                    // To cover this case we would have to use find_least_face_dominating_fe()
-                    // of FECollection with fe_indices of sub faces.
-                    // 3) Finally, it could happen that we got here because
-                    // neither_element_dominates (e.g. Q1xQ1xQ2 and Q1xQ2xQ1 for
-                    // subfaces and Q2xQ1xQ1 for mother face).
-                    // This requires usage of find_least_face_dominating_fe()
-                    // with fe_indices of sub-faces and the mother face.
-                    // Note that the last solution covers the first two scenarios,
-                    // thus we stick with it assuming that we won't lose much time/efficiency.
-                    const unsigned int dominating_fe_index = fe_collection.find_least_face_dominating_fe(fe_ind_face_subface);
-                    AssertThrow(dominating_fe_index != numbers::invalid_unsigned_int,
-                                ExcMessage("Could not find a least face dominating FE."));
-
-                    const FiniteElement<dim,spacedim> &dominating_fe
-                      = dof_handler.get_fe(dominating_fe_index);
-
-                    // first get the interpolation matrix from the mother
-                    // to the virtual dofs
-                    Assert (dominating_fe.dofs_per_face <=
-                            cell->get_fe().dofs_per_face,
-                            ExcInternalError());
-
-                    ensure_existence_of_face_matrix
-                    (dominating_fe,
-                     cell->get_fe(),
-                     face_interpolation_matrices
-                     [dominating_fe_index][cell->active_fe_index()]);
-
-                    // split this matrix into master and slave components.
-                    // invert the master component
-                    ensure_existence_of_master_dof_mask
-                    (cell->get_fe(),
-                     dominating_fe,
-                     (*face_interpolation_matrices
-                      [dominating_fe_index]
-                      [cell->active_fe_index()]),
-                     master_dof_masks
-                     [dominating_fe_index]
-                     [cell->active_fe_index()]);
-
-                    ensure_existence_of_split_face_matrix
-                    (*face_interpolation_matrices
-                     [dominating_fe_index][cell->active_fe_index()],
-                     (*master_dof_masks
-                      [dominating_fe_index][cell->active_fe_index()]),
-                     split_face_interpolation_matrices
-                     [dominating_fe_index][cell->active_fe_index()]);
-
-                    const FullMatrix<double> &restrict_mother_to_virtual_master_inv
-                      = (split_face_interpolation_matrices
-                         [dominating_fe_index][cell->active_fe_index()]->first);
-
-                    const FullMatrix<double> &restrict_mother_to_virtual_slave
-                      = (split_face_interpolation_matrices
-                         [dominating_fe_index][cell->active_fe_index()]->second);
-
-                    // now compute the constraint matrix as the product
-                    // between the inverse matrix and the slave part
-                    constraint_matrix.reinit (cell->get_fe().dofs_per_face -
-                                              dominating_fe.dofs_per_face,
-                                              dominating_fe.dofs_per_face);
-                    restrict_mother_to_virtual_slave
-                    .mmult (constraint_matrix,
-                            restrict_mother_to_virtual_master_inv);
-
-                    // then figure out the global numbers of master and
-                    // slave dofs and apply constraints
-                    scratch_dofs.resize (cell->get_fe().dofs_per_face);
-                    cell->face(face)->get_dof_indices (scratch_dofs,
-                                                       cell->active_fe_index ());
-
-                    // split dofs into master and slave components
-                    master_dofs.clear ();
-                    slave_dofs.clear ();
-                    for (unsigned int i=0; i<cell->get_fe().dofs_per_face; ++i)
-                      if ((*master_dof_masks
-                           [dominating_fe_index][cell->active_fe_index()])[i] == true)
-                        master_dofs.push_back (scratch_dofs[i]);
-                      else
-                        slave_dofs.push_back (scratch_dofs[i]);
-
-                    AssertDimension (master_dofs.size(), dominating_fe.dofs_per_face);
-                    AssertDimension (slave_dofs.size(),
-                                     cell->get_fe().dofs_per_face - dominating_fe.dofs_per_face);
 
-                    filter_constraints (master_dofs,
-                                        slave_dofs,
-                                        constraint_matrix,
-                                        constraints);
-
-
-
-                    // next we have to deal with the subfaces. do as
-                    // discussed in the hp paper
-                    for (unsigned int sf=0;
-                         sf<cell->face(face)->n_children(); ++sf)
-                      {
-                        // ignore interfaces with artificial cells as well
-                        // as interfaces between ghost cells in 2d
-                        if (cell->neighbor_child_on_subface (face, sf)->is_artificial()
-                            ||
-                            (dim==2 && cell->is_ghost()
-                             &&
-                             cell->neighbor_child_on_subface (face, sf)->is_ghost()))
-                          continue;
-
-                        Assert (cell->face(face)->child(sf)
-                                ->n_active_fe_indices() == 1,
-                                ExcInternalError());
-
-                        const unsigned int subface_fe_index
-                          = cell->face(face)->child(sf)->nth_active_fe_index(0);
-                        const FiniteElement<dim,spacedim> &subface_fe
-                          = dof_handler.get_fe(subface_fe_index);
+              // first find out whether we can constrain each of the
+              // subfaces to the mother face. in the lingo of the hp
+              // paper, this would be the simple case. note that we can
+              // short-circuit this decision if the dof_handler doesn't
+              // support hp at all
+              //
+              // ignore all interfaces with artificial cells
+              FiniteElementDomination::Domination
+              mother_face_dominates = FiniteElementDomination::either_element_can_dominate;
+
+              // auxiliary variable which holds FE indices of the mother face
+              // and its subfaces. This knowledge will be needed in hp-case
+              // with neither_element_dominates.
+              std::set<unsigned int> fe_ind_face_subface;
+              fe_ind_face_subface.insert(cell->active_fe_index());
+
+              if (DoFHandlerSupportsDifferentFEs<DoFHandlerType>::value == true)
+                for (unsigned int c=0; c<cell->face(face)->number_of_children(); ++c)
+                  if (!cell->neighbor_child_on_subface (face, c)->is_artificial())
+                    {
+                      mother_face_dominates = mother_face_dominates &
+                                              (cell->get_fe().compare_for_face_domination
+                                               (cell->neighbor_child_on_subface (face, c)->get_fe()));
+                      fe_ind_face_subface.insert(cell->neighbor_child_on_subface (face, c)->active_fe_index());
+                    }
 
-                        // first get the interpolation matrix from the
-                        // subface to the virtual dofs
-                        Assert (dominating_fe.dofs_per_face <=
-                                subface_fe.dofs_per_face,
+              switch (mother_face_dominates)
+                {
+                case FiniteElementDomination::this_element_dominates:
+                case FiniteElementDomination::either_element_can_dominate:
+                {
+                  // Case 1 (the simple case and the only case that can
+                  // happen for non-hp DoFHandlers): The coarse element
+                  // dominates the elements on the subfaces (or they are
+                  // all the same)
+                  //
+                  // so we are going to constrain the DoFs on the face
+                  // children against the DoFs on the face itself
+                  master_dofs.resize (cell->get_fe().dofs_per_face);
+
+                  cell->face(face)->get_dof_indices (master_dofs,
+                                                     cell->active_fe_index ());
+
+                  // Now create constraint matrix for the subfaces and
+                  // assemble it. ignore all interfaces with artificial
+                  // cells because we can only get to such interfaces if
+                  // the current cell is a ghost cell
+                  for (unsigned int c=0; c<cell->face(face)->n_children(); ++c)
+                    {
+                      if (cell->neighbor_child_on_subface (face, c)->is_artificial())
+                        continue;
+
+                      const typename DoFHandlerType::active_face_iterator
+                      subface = cell->face(face)->child(c);
+
+                      Assert (subface->n_active_fe_indices() == 1,
+                              ExcInternalError());
+
+                      const unsigned int
+                      subface_fe_index = subface->nth_active_fe_index(0);
+
+                      // we sometime run into the situation where for
+                      // example on one big cell we have a FE_Q(1) and on
+                      // the subfaces we have a mixture of FE_Q(1) and
+                      // FE_Nothing. In that case, the face domination is
+                      // either_element_can_dominate for the whole
+                      // collection of subfaces, but on the particular
+                      // subface between FE_Q(1) and FE_Nothing, there
+                      // are no constraints that we need to take care of.
+                      // in that case, just continue
+                      if (cell->get_fe().compare_for_face_domination
+                          (subface->get_fe(subface_fe_index))
+                          ==
+                          FiniteElementDomination::no_requirements)
+                        continue;
+
+                      // Same procedure as for the mother cell. Extract
+                      // the face DoFs from the cell DoFs.
+                      slave_dofs.resize (subface->get_fe(subface_fe_index)
+                                         .dofs_per_face);
+                      subface->get_dof_indices (slave_dofs, subface_fe_index);
+
+                      for (unsigned int i=0; i<slave_dofs.size(); ++i)
+                        Assert (slave_dofs[i] != numbers::invalid_dof_index,
                                 ExcInternalError());
-                        ensure_existence_of_subface_matrix
-                        (dominating_fe,
-                         subface_fe,
-                         sf,
-                         subface_interpolation_matrices
-                         [dominating_fe_index][subface_fe_index][sf]);
-
-                        const FullMatrix<double> &restrict_subface_to_virtual
-                          = *(subface_interpolation_matrices
-                              [dominating_fe_index][subface_fe_index][sf]);
-
-                        constraint_matrix.reinit (subface_fe.dofs_per_face,
-                                                  dominating_fe.dofs_per_face);
-
-                        restrict_subface_to_virtual
-                        .mmult (constraint_matrix,
-                                restrict_mother_to_virtual_master_inv);
-
-                        slave_dofs.resize (subface_fe.dofs_per_face);
-                        cell->face(face)->child(sf)->get_dof_indices (slave_dofs,
-                                                                      subface_fe_index);
-
-                        filter_constraints (master_dofs,
-                                            slave_dofs,
-                                            constraint_matrix,
-                                            constraints);
-                      }
 
-                    break;
-                  }
+                      // Now create the element constraint for this
+                      // subface.
+                      //
+                      // As a side remark, one may wonder the following:
+                      // neighbor_child is clearly computed correctly,
+                      // i.e. taking into account face_orientation (just
+                      // look at the implementation of that function).
+                      // however, we don't care about this here, when we
+                      // ask for subface_interpolation on subface c. the
+                      // question rather is: do we have to translate 'c'
+                      // here as well?
+                      //
+                      // the answer is in fact 'no'. if one does that,
+                      // results are wrong: constraints are added twice
+                      // for the same pair of nodes but with differing
+                      // weights. in addition, one can look at the
+                      // deal.II/project_*_03 tests that look at exactly
+                      // this case: there, we have a mesh with at least
+                      // one face_orientation==false and hanging nodes,
+                      // and the results of those tests show that the
+                      // result of projection verifies the approximation
+                      // properties of a finite element onto that mesh
+                      //
+                      // Add constraints to global constraint matrix.
+                      copy_data.add_constraints (master_dofs,
+                                                 slave_dofs,
+                                                 fe_collection.get_subface_interpolation_matrix
+                                                 (cell->active_fe_index(), subface_fe_index, c));
+                    }
 
-                  case FiniteElementDomination::no_requirements:
-                    // there are no continuity requirements between the two
-                    // elements. record no constraints
-                    break;
+                  break;
+                }
 
-                  default:
-                    // we shouldn't get here
-                    Assert (false, ExcInternalError());
-                  }
-              }
-            else
-              {
-                // this face has no children, but it could still be that it
-                // is shared by two cells that use a different fe index
-                Assert (cell->face(face)
-                        ->fe_index_is_active(cell->active_fe_index()) == true,
-                        ExcInternalError());
+                case FiniteElementDomination::other_element_dominates:
+                case FiniteElementDomination::neither_element_dominates:
+                {
+                  // Case 2 (the "complex" case): at least one (the
+                  // neither_... case) of the finer elements or all of
+                  // them (the other_... case) is dominating. See the hp
+                  // paper for a way how to deal with this situation
+                  //
+                  // since this is something that can only happen for hp
+                  // dof handlers, add a check here...
+                  Assert (DoFHandlerSupportsDifferentFEs<DoFHandlerType>::value == true,
+                          ExcInternalError());
 
-                // see if there is a neighbor that is an artificial cell.
-                // in that case, we're not interested in this interface. we
-                // test this case first since artificial cells may not have
-                // an active_fe_index set, etc
-                if (!cell->at_boundary(face)
-                    &&
-                    cell->neighbor(face)->is_artificial())
-                  continue;
+                  // we first have to find the finite element that is
+                  // able to generate a space that all the other ones can
+                  // be constrained to.
+                  // At this point we potentially have different scenarios:
+                  // 1) sub-faces dominate mother face and there is a
+                  // dominating FE among sub faces. We could loop over sub
+                  // faces to find the needed FE index. However, this will not
+                  // work in the case when
+                  // 2) there is no dominating FE among sub faces (e.g. Q1xQ2 vs Q2xQ1),
+                  // but subfaces still dominate mother face (e.g. Q2xQ2).
+                  // To cover this case we would have to use find_least_face_dominating_fe()
+                  // of FECollection with fe_indices of sub faces.
+                  // 3) Finally, it could happen that we got here because
+                  // neither_element_dominates (e.g. Q1xQ1xQ2 and Q1xQ2xQ1 for
+                  // subfaces and Q2xQ1xQ1 for mother face).
+                  // This requires usage of find_least_face_dominating_fe()
+                  // with fe_indices of sub-faces and the mother face.
+                  // Note that the last solution covers the first two scenarios,
+                  // thus we stick with it assuming that we won't lose much time/efficiency.
+                  const unsigned int dominating_fe_index = fe_collection.find_least_face_dominating_fe(fe_ind_face_subface);
+                  AssertThrow(dominating_fe_index != numbers::invalid_unsigned_int,
+                              ExcMessage("Could not find a least face dominating FE."));
+
+                  const FiniteElement<dim,spacedim> &dominating_fe
+                    = dof_handler.get_fe(dominating_fe_index);
+
+                  // first get the interpolation matrix from the mother
+                  // to the virtual dofs
+                  Assert (dominating_fe.dofs_per_face <=
+                          cell->get_fe().dofs_per_face,
+                          ExcInternalError());
 
-                // Only if there is a neighbor with a different
-                // active_fe_index and the same h-level, some action has to
-                // be taken.
-                if ((DoFHandlerSupportsDifferentFEs<DoFHandlerType>::value == true)
-                    &&
-                    !cell->face(face)->at_boundary ()
-                    &&
-                    (cell->neighbor(face)->active_fe_index () !=
-                     cell->active_fe_index ())
-                    &&
-                    (!cell->face(face)->has_children() &&
-                     !cell->neighbor_is_coarser(face) ))
-                  {
-                    const typename DoFHandlerType::level_cell_iterator neighbor = cell->neighbor (face);
+                  // split this matrix into master and slave components.
+                  // invert the master component
+                  ensure_existence_of_master_dof_mask
+                  (cell->get_fe(),
+                   dominating_fe,
+                   fe_collection.get_face_interpolation_matrix
+                   (dominating_fe_index, cell->active_fe_index()),
+                   master_dof_masks
+                   [dominating_fe_index]
+                   [cell->active_fe_index()]);
+
+                  ensure_existence_of_split_face_matrix
+                  (fe_collection.get_face_interpolation_matrix
+                   (dominating_fe_index, cell->active_fe_index()),
+                   (*master_dof_masks
+                    [dominating_fe_index][cell->active_fe_index()]),
+                   split_face_interpolation_matrices
+                   [dominating_fe_index][cell->active_fe_index()]);
+
+                  const FullMatrix<double> &restrict_mother_to_virtual_master_inv
+                    = (split_face_interpolation_matrices
+                       [dominating_fe_index][cell->active_fe_index()]->first);
+
+                  const FullMatrix<double> &restrict_mother_to_virtual_slave
+                    = (split_face_interpolation_matrices
+                       [dominating_fe_index][cell->active_fe_index()]->second);
+
+                  // now compute the constraint matrix as the product
+                  // between the inverse matrix and the slave part
+                  constraint_matrix.reinit (cell->get_fe().dofs_per_face -
+                                            dominating_fe.dofs_per_face,
+                                            dominating_fe.dofs_per_face);
+                  restrict_mother_to_virtual_slave
+                  .mmult (constraint_matrix,
+                          restrict_mother_to_virtual_master_inv);
+
+                  // then figure out the global numbers of master and
+                  // slave dofs and apply constraints
+                  scratch_dofs.resize (cell->get_fe().dofs_per_face);
+                  cell->face(face)->get_dof_indices (scratch_dofs,
+                                                     cell->active_fe_index ());
+
+                  // split dofs into master and slave components
+                  master_dofs.clear ();
+                  slave_dofs.clear ();
+                  for (unsigned int i=0; i<cell->get_fe().dofs_per_face; ++i)
+                    if ((*master_dof_masks
+                         [dominating_fe_index][cell->active_fe_index()])[i] == true)
+                      master_dofs.push_back (scratch_dofs[i]);
+                    else
+                      slave_dofs.push_back (scratch_dofs[i]);
+
+                  AssertDimension (master_dofs.size(), dominating_fe.dofs_per_face);
+                  AssertDimension (slave_dofs.size(),
+                                   cell->get_fe().dofs_per_face - dominating_fe.dofs_per_face);
+
+                  copy_data.add_constraints (master_dofs,
+                                             slave_dofs,
+                                             constraint_matrix);
+
+
+
+                  // next we have to deal with the subfaces. do as
+                  // discussed in the hp paper
+                  for (unsigned int sf=0;
+                       sf<cell->face(face)->n_children(); ++sf)
+                    {
+                      // ignore interfaces with artificial cells as well
+                      // as interfaces between ghost cells in 2d
+                      if (cell->neighbor_child_on_subface (face, sf)->is_artificial()
+                          ||
+                          (dim==2 && cell->is_ghost()
+                           &&
+                           cell->neighbor_child_on_subface (face, sf)->is_ghost()))
+                        continue;
+
+                      Assert (cell->face(face)->child(sf)
+                              ->n_active_fe_indices() == 1,
+                              ExcInternalError());
+
+                      const unsigned int subface_fe_index
+                        = cell->face(face)->child(sf)->nth_active_fe_index(0);
+                      const FiniteElement<dim,spacedim> &subface_fe
+                        = dof_handler.get_fe(subface_fe_index);
+
+                      // first get the interpolation matrix from the
+                      // subface to the virtual dofs
+                      Assert (dominating_fe.dofs_per_face <=
+                              subface_fe.dofs_per_face,
+                              ExcInternalError());
+                      const FullMatrix<double> &restrict_subface_to_virtual
+                        = fe_collection.get_subface_interpolation_matrix
+                          (dominating_fe_index, subface_fe_index, sf);
+
+                      constraint_matrix.reinit (subface_fe.dofs_per_face,
+                                                dominating_fe.dofs_per_face);
+
+                      restrict_subface_to_virtual
+                      .mmult (constraint_matrix,
+                              restrict_mother_to_virtual_master_inv);
+
+                      slave_dofs.resize (subface_fe.dofs_per_face);
+                      cell->face(face)->child(sf)->get_dof_indices (slave_dofs,
+                                                                    subface_fe_index);
+
+                      copy_data.add_constraints (master_dofs,
+                                                 slave_dofs,
+                                                 constraint_matrix);
+                    }
 
-                    // see which side of the face we have to constrain
-                    switch (cell->get_fe().compare_for_face_domination (neighbor->get_fe ()))
-                      {
-                      case FiniteElementDomination::this_element_dominates:
-                      {
-                        // Get DoFs on dominating and dominated side of the
-                        // face
-                        master_dofs.resize (cell->get_fe().dofs_per_face);
-                        cell->face(face)->get_dof_indices (master_dofs,
-                                                           cell->active_fe_index ());
-
-                        // break if the n_master_dofs == 0, because we are
-                        // attempting to constrain to an element that has
-                        // no face dofs
-                        if (master_dofs.size() == 0)
-                          break;
+                  break;
+                }
 
-                        slave_dofs.resize (neighbor->get_fe().dofs_per_face);
-                        cell->face(face)->get_dof_indices (slave_dofs,
-                                                           neighbor->active_fe_index ());
-
-                        // make sure the element constraints for this face
-                        // are available
-                        ensure_existence_of_face_matrix
-                        (cell->get_fe(),
-                         neighbor->get_fe(),
-                         face_interpolation_matrices
-                         [cell->active_fe_index()][neighbor->active_fe_index()]);
-
-                        // Add constraints to global constraint matrix.
-                        filter_constraints (master_dofs,
-                                            slave_dofs,
-                                            *(face_interpolation_matrices
-                                              [cell->active_fe_index()]
-                                              [neighbor->active_fe_index()]),
-                                            constraints);
+                case FiniteElementDomination::no_requirements:
+                  // there are no continuity requirements between the two
+                  // elements. record no constraints
+                  break;
 
-                        break;
-                      }
+                default:
+                  // we shouldn't get here
+                  Assert (false, ExcInternalError());
+                }
+            }
+          else
+            {
+              // this face has no children, but it could still be that it
+              // is shared by two cells that use a different fe index
+              Assert (cell->face(face)
+                      ->fe_index_is_active(cell->active_fe_index()) == true,
+                      ExcInternalError());
+
+              // see if there is a neighbor that is an artificial cell.
+              // in that case, we're not interested in this interface. we
+              // test this case first since artificial cells may not have
+              // an active_fe_index set, etc
+              if (!cell->at_boundary(face)
+                  &&
+                  cell->neighbor(face)->is_artificial())
+                continue;
 
-                      case FiniteElementDomination::other_element_dominates:
-                      {
-                        // we don't do anything here since we will come
-                        // back to this face from the other cell, at which
-                        // time we will fall into the first case clause
-                        // above
-                        break;
-                      }
+              // Only if there is a neighbor with a different
+              // active_fe_index and the same h-level, some action has to
+              // be taken.
+              if ((DoFHandlerSupportsDifferentFEs<DoFHandlerType>::value == true)
+                  &&
+                  !cell->face(face)->at_boundary ()
+                  &&
+                  (cell->neighbor(face)->active_fe_index () !=
+                   cell->active_fe_index ())
+                  &&
+                  (!cell->face(face)->has_children() &&
+                   !cell->neighbor_is_coarser(face) ))
+                {
+                  const typename DoFHandlerType::level_cell_iterator neighbor = cell->neighbor (face);
 
-                      case FiniteElementDomination::either_element_can_dominate:
-                      {
-                        // it appears as if neither element has any
-                        // constraints on its neighbor. this may be because
-                        // neither element has any DoFs on faces at all. or
-                        // that the two elements are actually the same,
-                        // although they happen to run under different
-                        // fe_indices (this is what happens in
-                        // hp/hp_hanging_nodes_01 for example).
-                        //
-                        // another possibility is what happens in crash_13.
-                        // there, we have FESystem(FE_Q(1),FE_DGQ(0)) vs.
-                        // FESystem(FE_Q(1),FE_DGQ(1)). neither of them
-                        // dominates the other.
-                        //
-                        // a final possibility is that we have something like
-                        // FESystem(FE_Q(1),FE_Q(1)) vs
-                        // FESystem(FE_Q(1),FE_Nothing()), see
-                        // hp/fe_nothing_18/19.
-                        //
-                        // in any case, the point is that it doesn't
-                        // matter. there is nothing to do here.
+                  // see which side of the face we have to constrain
+                  switch (cell->get_fe().compare_for_face_domination (neighbor->get_fe ()))
+                    {
+                    case FiniteElementDomination::this_element_dominates:
+                    {
+                      // Get DoFs on dominating and dominated side of the
+                      // face
+                      master_dofs.resize (cell->get_fe().dofs_per_face);
+                      cell->face(face)->get_dof_indices (master_dofs,
+                                                         cell->active_fe_index ());
+
+                      // break if the n_master_dofs == 0, because we are
+                      // attempting to constrain to an element that has
+                      // no face dofs
+                      if (master_dofs.size() == 0)
                         break;
-                      }
-
-                      case FiniteElementDomination::neither_element_dominates:
-                      {
-                        // make sure we don't get here twice from each cell
-                        if (cell < neighbor)
-                          break;
 
-                        // our best bet is to find the common space among other
-                        // FEs in FECollection and then constrain both FEs
-                        // to that one.
-                        // More precisely, we follow the strategy outlined on
-                        // page 17 of the hp paper:
-                        // First we find the dominant FE space S.
-                        // Then we divide our dofs in master and slave such that
-                        // I^{face,master}_{S^{face}->S} is invertible.
-                        // And finally constrain slave dofs to master dofs based
-                        // on the interpolation matrix.
-
-                        const unsigned int this_fe_index = cell->active_fe_index();
-                        const unsigned int neighbor_fe_index = neighbor->active_fe_index();
-                        std::set<unsigned int> fes;
-                        fes.insert(this_fe_index);
-                        fes.insert(neighbor_fe_index);
-                        const dealii::hp::FECollection<dim,spacedim> &fe_collection =
-                          dof_handler.get_fe_collection ();
-                        const unsigned int dominating_fe_index = fe_collection.find_least_face_dominating_fe(fes);
-
-                        AssertThrow(dominating_fe_index != numbers::invalid_unsigned_int,
-                                    ExcMessage("Could not find the dominating FE for "
-                                               +cell->get_fe().get_name()
-                                               +" and "
-                                               +neighbor->get_fe().get_name()
-                                               +" inside FECollection."));
-
-                        const FiniteElement<dim,spacedim> &dominating_fe = fe_collection[dominating_fe_index];
-
-                        // TODO: until we hit the second face, the code is
-                        // a copy-paste from h-refinement case...
-
-                        // first get the interpolation matrix from main FE
-                        // to the virtual dofs
-                        Assert (dominating_fe.dofs_per_face <=
-                                cell->get_fe().dofs_per_face,
-                                ExcInternalError());
+                      slave_dofs.resize (neighbor->get_fe().dofs_per_face);
+                      cell->face(face)->get_dof_indices (slave_dofs,
+                                                         neighbor->active_fe_index ());
 
-                        ensure_existence_of_face_matrix
-                        (dominating_fe,
-                         cell->get_fe(),
-                         face_interpolation_matrices
-                         [dominating_fe_index][cell->active_fe_index()]);
-
-                        // split this matrix into master and slave components.
-                        // invert the master component
-                        ensure_existence_of_master_dof_mask
-                        (cell->get_fe(),
-                         dominating_fe,
-                         (*face_interpolation_matrices
-                          [dominating_fe_index]
-                          [cell->active_fe_index()]),
-                         master_dof_masks
-                         [dominating_fe_index]
-                         [cell->active_fe_index()]);
-
-                        ensure_existence_of_split_face_matrix
-                        (*face_interpolation_matrices
-                         [dominating_fe_index][cell->active_fe_index()],
-                         (*master_dof_masks
-                          [dominating_fe_index][cell->active_fe_index()]),
-                         split_face_interpolation_matrices
-                         [dominating_fe_index][cell->active_fe_index()]);
-
-                        const FullMatrix<double> &restrict_mother_to_virtual_master_inv
-                          = (split_face_interpolation_matrices
-                             [dominating_fe_index][cell->active_fe_index()]->first);
-
-                        const FullMatrix<double> &restrict_mother_to_virtual_slave
-                          = (split_face_interpolation_matrices
-                             [dominating_fe_index][cell->active_fe_index()]->second);
-
-                        // now compute the constraint matrix as the product
-                        // between the inverse matrix and the slave part
-                        constraint_matrix.reinit (cell->get_fe().dofs_per_face -
-                                                  dominating_fe.dofs_per_face,
-                                                  dominating_fe.dofs_per_face);
-                        restrict_mother_to_virtual_slave
-                        .mmult (constraint_matrix,
-                                restrict_mother_to_virtual_master_inv);
-
-                        // then figure out the global numbers of master and
-                        // slave dofs and apply constraints
-                        scratch_dofs.resize (cell->get_fe().dofs_per_face);
-                        cell->face(face)->get_dof_indices (scratch_dofs,
-                                                           cell->active_fe_index ());
-
-                        // split dofs into master and slave components
-                        master_dofs.clear ();
-                        slave_dofs.clear ();
-                        for (unsigned int i=0; i<cell->get_fe().dofs_per_face; ++i)
-                          if ((*master_dof_masks
-                               [dominating_fe_index][cell->active_fe_index()])[i] == true)
-                            master_dofs.push_back (scratch_dofs[i]);
-                          else
-                            slave_dofs.push_back (scratch_dofs[i]);
-
-                        AssertDimension (master_dofs.size(), dominating_fe.dofs_per_face);
-                        AssertDimension (slave_dofs.size(),
-                                         cell->get_fe().dofs_per_face - dominating_fe.dofs_per_face);
-
-                        filter_constraints (master_dofs,
-                                            slave_dofs,
-                                            constraint_matrix,
-                                            constraints);
+                      // Add constraints to global constraint matrix.
+                      copy_data.add_constraints (master_dofs,
+                                                 slave_dofs,
+                                                 fe_collection.get_face_interpolation_matrix
+                                                 (cell->active_fe_index(), neighbor->active_fe_index()));
 
-                        // now do the same for another FE
-                        // this is pretty much the same we do above to
-                        // resolve h-refinement constraints
-                        Assert (dominating_fe.dofs_per_face <=
-                                neighbor->get_fe().dofs_per_face,
-                                ExcInternalError());
+                      break;
+                    }
 
-                        ensure_existence_of_face_matrix
-                        (dominating_fe,
-                         neighbor->get_fe(),
-                         face_interpolation_matrices
-                         [dominating_fe_index][neighbor->active_fe_index()]);
+                    case FiniteElementDomination::other_element_dominates:
+                    {
+                      // we don't do anything here since we will come
+                      // back to this face from the other cell, at which
+                      // time we will fall into the first case clause
+                      // above
+                      break;
+                    }
 
-                        const FullMatrix<double> &restrict_secondface_to_virtual
-                          = *(face_interpolation_matrices
-                              [dominating_fe_index][neighbor->active_fe_index()]);
+                    case FiniteElementDomination::either_element_can_dominate:
+                    {
+                      // it appears as if neither element has any
+                      // constraints on its neighbor. this may be because
+                      // neither element has any DoFs on faces at all. or
+                      // that the two elements are actually the same,
+                      // although they happen to run under different
+                      // fe_indices (this is what happens in
+                      // hp/hp_hanging_nodes_01 for example).
+                      //
+                      // another possibility is what happens in crash_13.
+                      // there, we have FESystem(FE_Q(1),FE_DGQ(0)) vs.
+                      // FESystem(FE_Q(1),FE_DGQ(1)). neither of them
+                      // dominates the other.
+                      //
+                      // a final possibility is that we have something like
+                      // FESystem(FE_Q(1),FE_Q(1)) vs
+                      // FESystem(FE_Q(1),FE_Nothing()), see
+                      // hp/fe_nothing_18/19.
+                      //
+                      // in any case, the point is that it doesn't
+                      // matter. there is nothing to do here.
+                      break;
+                    }
 
-                        constraint_matrix.reinit (neighbor->get_fe().dofs_per_face,
-                                                  dominating_fe.dofs_per_face);
+                    case FiniteElementDomination::neither_element_dominates:
+                    {
+                      // make sure we don't get here twice from each cell
+                      if (cell < neighbor)
+                        break;
 
-                        restrict_secondface_to_virtual
-                        .mmult (constraint_matrix,
-                                restrict_mother_to_virtual_master_inv);
+                      // our best bet is to find the common space among other
+                      // FEs in FECollection and then constrain both FEs
+                      // to that one.
+                      // More precisely, we follow the strategy outlined on
+                      // page 17 of the hp paper:
+                      // First we find the dominant FE space S.
+                      // Then we divide our dofs in master and slave such that
+                      // I^{face,master}_{S^{face}->S} is invertible.
+                      // And finally constrain slave dofs to master dofs based
+                      // on the interpolation matrix.
+
+                      const unsigned int this_fe_index = cell->active_fe_index();
+                      const unsigned int neighbor_fe_index = neighbor->active_fe_index();
+                      std::set<unsigned int> fes;
+                      fes.insert(this_fe_index);
+                      fes.insert(neighbor_fe_index);
+                      const unsigned int dominating_fe_index = fe_collection.find_least_face_dominating_fe(fes);
+
+                      AssertThrow(dominating_fe_index != numbers::invalid_unsigned_int,
+                                  ExcMessage("Could not find the dominating FE for "
+                                             +cell->get_fe().get_name()
+                                             +" and "
+                                             +neighbor->get_fe().get_name()
+                                             +" inside FECollection."));
+
+                      const FiniteElement<dim,spacedim> &dominating_fe = fe_collection[dominating_fe_index];
+
+                      // TODO: until we hit the second face, the code is
+                      // a copy-paste from h-refinement case...
+
+                      // first get the interpolation matrix from main FE
+                      // to the virtual dofs
+                      Assert (dominating_fe.dofs_per_face <=
+                              cell->get_fe().dofs_per_face,
+                              ExcInternalError());
+
+                      // split this matrix into master and slave components.
+                      // invert the master component
+                      ensure_existence_of_master_dof_mask
+                      (cell->get_fe(),
+                       dominating_fe,
+                       fe_collection.get_face_interpolation_matrix
+                       (dominating_fe_index, cell->active_fe_index()),
+                       master_dof_masks
+                       [dominating_fe_index]
+                       [cell->active_fe_index()]);
+
+                      ensure_existence_of_split_face_matrix
+                      (fe_collection.get_face_interpolation_matrix
+                       (dominating_fe_index, cell->active_fe_index()),
+                       (*master_dof_masks
+                        [dominating_fe_index][cell->active_fe_index()]),
+                       split_face_interpolation_matrices
+                       [dominating_fe_index][cell->active_fe_index()]);
+
+                      const FullMatrix<double> &restrict_mother_to_virtual_master_inv
+                        = (split_face_interpolation_matrices
+                           [dominating_fe_index][cell->active_fe_index()]->first);
+
+                      const FullMatrix<double> &restrict_mother_to_virtual_slave
+                        = (split_face_interpolation_matrices
+                           [dominating_fe_index][cell->active_fe_index()]->second);
+
+                      // now compute the constraint matrix as the product
+                      // between the inverse matrix and the slave part
+                      constraint_matrix.reinit (cell->get_fe().dofs_per_face -
+                                                dominating_fe.dofs_per_face,
+                                                dominating_fe.dofs_per_face);
+                      restrict_mother_to_virtual_slave
+                      .mmult (constraint_matrix,
+                              restrict_mother_to_virtual_master_inv);
+
+                      // then figure out the global numbers of master and
+                      // slave dofs and apply constraints
+                      scratch_dofs.resize (cell->get_fe().dofs_per_face);
+                      cell->face(face)->get_dof_indices (scratch_dofs,
+                                                         cell->active_fe_index ());
+
+                      // split dofs into master and slave components
+                      master_dofs.clear ();
+                      slave_dofs.clear ();
+                      for (unsigned int i=0; i<cell->get_fe().dofs_per_face; ++i)
+                        if ((*master_dof_masks
+                             [dominating_fe_index][cell->active_fe_index()])[i] == true)
+                          master_dofs.push_back (scratch_dofs[i]);
+                        else
+                          slave_dofs.push_back (scratch_dofs[i]);
+
+                      AssertDimension (master_dofs.size(), dominating_fe.dofs_per_face);
+                      AssertDimension (slave_dofs.size(),
+                                       cell->get_fe().dofs_per_face - dominating_fe.dofs_per_face);
+
+                      copy_data.add_constraints (master_dofs,
+                                                 slave_dofs,
+                                                 constraint_matrix);
+
+                      // now do the same for another FE
+                      // this is pretty much the same we do above to
+                      // resolve h-refinement constraints
+                      Assert (dominating_fe.dofs_per_face <=
+                              neighbor->get_fe().dofs_per_face,
+                              ExcInternalError());
+
+                      const FullMatrix<double> &restrict_secondface_to_virtual
+                        = fe_collection.get_face_interpolation_matrix
+                          (dominating_fe_index, neighbor->active_fe_index());
+
+                      constraint_matrix.reinit (neighbor->get_fe().dofs_per_face,
+                                                dominating_fe.dofs_per_face);
+
+                      restrict_secondface_to_virtual
+                      .mmult (constraint_matrix,
+                              restrict_mother_to_virtual_master_inv);
+
+                      slave_dofs.resize (neighbor->get_fe().dofs_per_face);
+                      cell->face(face)->get_dof_indices (slave_dofs,
+                                                         neighbor->active_fe_index ());
+
+                      copy_data.add_constraints (master_dofs,
+                                                 slave_dofs,
+                                                 constraint_matrix);
 
-                        slave_dofs.resize (neighbor->get_fe().dofs_per_face);
-                        cell->face(face)->get_dof_indices (slave_dofs,
-                                                           neighbor->active_fe_index ());
+                      break;
+                    }
 
-                        filter_constraints (master_dofs,
-                                            slave_dofs,
-                                            constraint_matrix,
-                                            constraints);
+                    case FiniteElementDomination::no_requirements:
+                    {
+                      // nothing to do here
+                      break;
+                    }
 
-                        break;
-                      }
+                    default:
+                      // we shouldn't get here
+                      Assert (false, ExcInternalError());
+                    }
+                }
+            }
+      };
 
-                      case FiniteElementDomination::no_requirements:
-                      {
-                        // nothing to do here
-                        break;
-                      }
+      // the copier enters the constraints collected on one cell into the
+      // global object. WorkStream calls it in the order of the cells, so the
+      // result is the same as for a loop over all cells on a single thread
+      auto copier
+        = [&constraints] (const HangingNodeCopyData &copy_data)
+      {
+        for (unsigned int i=0; i<copy_data.n_constraints; ++i)
+          filter_constraints (copy_data.master_dofs[i],
+                              copy_data.slave_dofs[i],
+                              copy_data.face_constraints[i],
+                              constraints);
+      };
 
-                      default:
-                        // we shouldn't get here
-                        Assert (false, ExcInternalError());
-                      }
-                  }
-              }
-        }
+      WorkStream::run (dof_handler.begin_active(), dof_handler.end(),
+                       worker, copier,
+                       HangingNodeScratchData(),
+                       HangingNodeCopyData());
     }
   }
 
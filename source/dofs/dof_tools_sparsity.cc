@@ -14,6 +14,7 @@
 // ---------------------------------------------------------------------
 
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/template_constraints.h>
@@ -39,8 +40,15 @@
 #include <deal.II/dofs/dof_tools.h>
 #include <deal.II/numerics/vector_tools.h>
 
+// needed to add entries into the helper classes of
+// make_compressed_sparsity_pattern(). include it last since its namespace
+// internal::ConstraintMatrix collides with the name lookup of the headers
+// above
+#include <deal.II/lac/constraint_matrix.templates.h>
+
 
 #include <algorithm>
+#include <atomic>
 #include <numeric>
 
 DEAL_II_NAMESPACE_OPEN
@@ -109,6 +117,199 @@ namespace DoFTools
 
 
 
+  namespace internal
+  {
+    namespace
+    {
+      // a class with the interface of a sparsity pattern that only counts
+      // how many entries are added into each row. since duplicate entries
+      // are counted several times, this gives an upper bound for the row
+      // lengths. the counters are atomic, so several threads may add into
+      // the same rows at the same time
+      class RowLengthCounter
+      {
+      public:
+        explicit RowLengthCounter (const types::global_dof_index n)
+          :
+          n (n),
+          row_lengths (n)
+        {}
+
+        types::global_dof_index n_rows () const
+        {
+          return n;
+        }
+
+        types::global_dof_index n_cols () const
+        {
+          return n;
+        }
+
+        void add (const types::global_dof_index row,
+                  const types::global_dof_index)
+        {
+          row_lengths[row].fetch_add (1, std::memory_order_relaxed);
+        }
+
+        template <typename ForwardIterator>
+        void add_entries (const types::global_dof_index row,
+                          ForwardIterator                begin,
+                          ForwardIterator                end,
+                          const bool)
+        {
+          row_lengths[row].fetch_add (std::distance(begin, end),
+                                      std::memory_order_relaxed);
+        }
+
+        const types::global_dof_index n;
+        std::vector<std::atomic<unsigned int> > row_lengths;
+      };
+
+
+
+      // a class that forwards the entries to a SparsityPattern, holding the
+      // lock of the respective row while writing into it
+      class LockedSparsityPattern
+      {
+      public:
+        LockedSparsityPattern (SparsityPattern        &sparsity,
+                               Threads::SpinLockTable &row_locks)
+          :
+          sparsity (sparsity),
+          row_locks (row_locks)
+        {}
+
+        types::global_dof_index n_rows () const
+        {
+          return sparsity.n_rows();
+        }
+
+        types::global_dof_index n_cols () const
+        {
+          return sparsity.n_cols();
+        }
+
+        void add (const types::global_dof_index row,
+                  const types::global_dof_index col)
+        {
+          Threads::SpinLockTable::ScopedLock lock (row_locks, row);
+          sparsity.add (row, col);
+        }
+
+        template <typename ForwardIterator>
+        void add_entries (const types::global_dof_index row,
+                          ForwardIterator                begin,
+                          ForwardIterator                end,
+                          const bool                     indices_are_sorted)
+        {
+          Threads::SpinLockTable::ScopedLock lock (row_locks, row);
+          sparsity.add_entries (row, begin, end, indices_are_sorted);
+        }
+
+      private:
+        SparsityPattern        &sparsity;
+        Threads::SpinLockTable &row_locks;
+      };
+
+
+
+      // add the entries of the given cells into the given sparsity
+      // pattern-like object, working on the cells in parallel
+      template <typename CellIterator, typename SparsityPatternType>
+      void
+      add_cell_entries_in_parallel (const std::vector<CellIterator> &cells,
+                                    const unsigned int               max_dofs_per_cell,
+                                    const ConstraintMatrix          &constraints,
+                                    const bool                       keep_constrained_dofs,
+                                    SparsityPatternType             &sparsity)
+      {
+        parallel::apply_to_subranges
+        (0U, static_cast<unsigned int>(cells.size()),
+         [&] (const unsigned int begin,
+              const unsigned int end)
+        {
+          std::vector<types::global_dof_index> dofs_on_this_cell;
+          dofs_on_this_cell.reserve (max_dofs_per_cell);
+          for (unsigned int c=begin; c<end; ++c)
+            {
+              dofs_on_this_cell.resize (cells[c]->get_fe().dofs_per_cell);
+              cells[c]->get_dof_indices (dofs_on_this_cell);
+              constraints.add_entries_local_to_global (dofs_on_this_cell,
+                                                       sparsity,
+                                                       keep_constrained_dofs);
+            }
+        },
+        64);
+      }
+    }
+  }
+
+
+
+  template <typename DoFHandlerType>
+  void
+  make_compressed_sparsity_pattern (const DoFHandlerType      &dof,
+                                    SparsityPattern           &sparsity,
+                                    const ConstraintMatrix    &constraints,
+                                    const bool                 keep_constrained_dofs,
+                                    const types::subdomain_id  subdomain_id)
+  {
+    const types::global_dof_index n_dofs = dof.n_dofs();
+
+    // If we have a distributed::Triangulation only allow locally_owned
+    // subdomain. Not setting a subdomain is also okay, because we skip
+    // ghost cells in the loop below.
+    Assert (
+      (dof.get_triangulation().locally_owned_subdomain() == numbers::invalid_subdomain_id)
+      ||
+      (subdomain_id == numbers::invalid_subdomain_id)
+      ||
+      (subdomain_id == dof.get_triangulation().locally_owned_subdomain()),
+      ExcMessage ("For parallel::distributed::Triangulation objects and "
+                  "associated DoF handler objects, asking for any subdomain other "
+                  "than the locally owned one does not make sense."));
+
+    // collect the cells we work on, so that the two passes below can split
+    // the work among threads
+    std::vector<typename DoFHandlerType::active_cell_iterator> cells;
+    for (typename DoFHandlerType::active_cell_iterator cell = dof.begin_active();
+         cell!=dof.end(); ++cell)
+      if (((subdomain_id == numbers::invalid_subdomain_id)
+           ||
+           (subdomain_id == cell->subdomain_id()))
+          &&
+          cell->is_locally_owned())
+        cells.push_back (cell);
+
+    const unsigned int max_dofs = max_dofs_per_cell(dof);
+
+    // first pass: count the entries that will be added into each row. this
+    // overestimates the row lengths by the entries that several cells add
+    // into the same row, but gives us a single allocation for all rows
+    // rather than growing each row separately
+    std::vector<unsigned int> row_lengths;
+    {
+      internal::RowLengthCounter counter (n_dofs);
+      internal::add_cell_entries_in_parallel (cells, max_dofs, constraints,
+                                              keep_constrained_dofs, counter);
+      row_lengths.resize (n_dofs);
+      for (types::global_dof_index i=0; i<n_dofs; ++i)
+        row_lengths[i] = counter.row_lengths[i].load (std::memory_order_relaxed);
+    }
+
+    // second pass: fill in the entries and squeeze out the ones that were
+    // not used
+    sparsity.reinit (n_dofs, n_dofs, row_lengths);
+    Threads::SpinLockTable row_locks (n_dofs);
+    internal::LockedSparsityPattern locked_sparsity (sparsity, row_locks);
+    internal::add_cell_entries_in_parallel (cells, max_dofs, constraints,
+                                            keep_constrained_dofs,
+                                            locked_sparsity);
+    sparsity.compress ();
+  }
+
+
+
   template <typename DoFHandlerType, typename SparsityPatternType>
   void
   make_sparsity_pattern (const DoFHandlerType      &dof,
@@ -36,6 +36,58 @@ namespace internal
   {
     namespace
     {
+      // the key under which the prolongation or restriction matrices of
+      // all children for one refinement case are stored in
+      // FETools::MatrixCache
+      std::string
+      get_matrix_cache_key (const std::string  &fe_name,
+                            const std::string  &matrix_name,
+                            const unsigned int  refinement_case)
+      {
+        return fe_name + ":" + matrix_name + ":" +
+               Utilities::int_to_string(refinement_case);
+      }
+
+
+
+      // look up the prolongation and restriction matrices for all
+      // refinement cases. only return true if all of them are available
+      bool
+      get_cached_matrices (const std::string                                &fe_name,
+                           std::vector<std::vector<FullMatrix<double> > > &prolongation,
+                           std::vector<std::vector<FullMatrix<double> > > &restriction)
+      {
+        std::vector<std::vector<FullMatrix<double> > > cached_prolongation (prolongation.size());
+        std::vector<std::vector<FullMatrix<double> > > cached_restriction (restriction.size());
+        for (unsigned int i=0; i<prolongation.size(); ++i)
+          if (FETools::MatrixCache::get (get_matrix_cache_key(fe_name, "prolongation", i+1),
+                                         cached_prolongation[i]) == false ||
+              FETools::MatrixCache::get (get_matrix_cache_key(fe_name, "restriction", i+1),
+                                         cached_restriction[i]) == false)
+            return false;
+        prolongation.swap (cached_prolongation);
+        restriction.swap (cached_restriction);
+        return true;
+      }
+
+
+
+      void
+      store_matrices (const std::string                                      &fe_name,
+                      const std::vector<std::vector<FullMatrix<double> > > &prolongation,
+                      const std::vector<std::vector<FullMatrix<double> > > &restriction)
+      {
+        for (unsigned int i=0; i<prolongation.size(); ++i)
+          {
+            FETools::MatrixCache::store (get_matrix_cache_key(fe_name, "prolongation", i+1),
+                                         prolongation[i]);
+            FETools::MatrixCache::store (get_matrix_cache_key(fe_name, "restriction", i+1),
+                                         restriction[i]);
+          }
+      }
+
+
+
       std::vector<Point<1> >
       get_QGaussLobatto_points (const unsigned int degree)
       {
@@ -404,34 +456,54 @@ FE_DGQ<dim,spacedim>
       FE_DGQ<dim,spacedim> &this_nonconst = const_cast<FE_DGQ<dim,spacedim>& >(*this);
       if (refinement_case == RefinementCase<dim>::isotropic_refinement)
         {
-          std::vector<std::vector<FullMatrix<double> > >
-          isotropic_matrices(RefinementCase<dim>::isotropic_refinement);
-          isotropic_matrices.back().
-          resize(GeometryInfo<dim>::n_children(RefinementCase<dim>(refinement_case)),
-                 FullMatrix<double>(this->dofs_per_cell, this->dofs_per_cell));
-          if (dim == spacedim)
-            FETools::compute_embedding_matrices (*this, isotropic_matrices, true);
+          // the matrices only depend on the element, so another object of
+          // the same element might have computed them already
+          const std::string cache_key =
+            internal::FE_DGQ::get_matrix_cache_key (this->get_name(), "prolongation",
+                                                    refinement_case);
+          std::vector<FullMatrix<double> > cached_matrices;
+          if (FETools::MatrixCache::get (cache_key, cached_matrices))
+            this_nonconst.prolongation[refinement_case-1].swap(cached_matrices);
           else
-            FETools::compute_embedding_matrices (FE_DGQ<dim>(this->degree),
-                                                 isotropic_matrices, true);
-          this_nonconst.prolongation[refinement_case-1].swap(isotropic_matrices.back());
+            {
+              std::vector<std::vector<FullMatrix<double> > >
+              isotropic_matrices(RefinementCase<dim>::isotropic_refinement);
+              isotropic_matrices.back().
+              resize(GeometryInfo<dim>::n_children(RefinementCase<dim>(refinement_case)),
+                     FullMatrix<double>(this->dofs_per_cell, this->dofs_per_cell));
+              if (dim == spacedim)
+                FETools::compute_embedding_matrices (*this, isotropic_matrices, true);
+              else
+                FETools::compute_embedding_matrices (FE_DGQ<dim>(this->degree),
+                                                     isotropic_matrices, true);
+              FETools::MatrixCache::store (cache_key, isotropic_matrices.back());
+              this_nonconst.prolongation[refinement_case-1].swap(isotropic_matrices.back());
+            }
         }
       else
         {
           // must compute both restriction and prolongation matrices because
           // we only check for their size and the reinit call initializes them
           // all
-          this_nonconst.reinit_restriction_and_prolongation_matrices();
-          if (dim == spacedim)
+          if (internal::FE_DGQ::get_cached_matrices (this->get_name(),
+                                                     this_nonconst.prolongation,
+                                                     this_nonconst.restriction) == false)
             {
-              FETools::compute_embedding_matrices (*this, this_nonconst.prolongation);
-              FETools::compute_projection_matrices (*this, this_nonconst.restriction);
-            }
-          else
-            {
-              FE_DGQ<dim> tmp(this->degree);
-              FETools::compute_embedding_matrices (tmp, this_nonconst.prolongation);
-              FETools::compute_projection_matrices (tmp, this_nonconst.restriction);
+              this_nonconst.reinit_restriction_and_prolongation_matrices();
+              if (dim == spacedim)
+                {
+                  FETools::compute_embedding_matrices (*this, this_nonconst.prolongation);
+                  FETools::compute_projection_matrices (*this, this_nonconst.restriction);
+                }
+              else
+                {
+                  FE_DGQ<dim> tmp(this->degree);
+                  FETools::compute_embedding_matrices (tmp, this_nonconst.prolongation);
+                  FETools::compute_projection_matrices (tmp, this_nonconst.restriction);
+                }
+              internal::FE_DGQ::store_matrices (this->get_name(),
+                                                this->prolongation,
+                                                this->restriction);
             }
         }
     }
@@ -470,34 +542,52 @@ FE_DGQ<dim,spacedim>
       FE_DGQ<dim,spacedim> &this_nonconst = const_cast<FE_DGQ<dim,spacedim>& >(*this);
       if (refinement_case == RefinementCase<dim>::isotropic_refinement)
         {
-          std::vector<std::vector<FullMatrix<double> > >
-          isotropic_matrices(RefinementCase<dim>::isotropic_refinement);
-          isotropic_matrices.back().
-          resize(GeometryInfo<dim>::n_children(RefinementCase<dim>(refinement_case)),
-                 FullMatrix<double>(this->dofs_per_cell, this->dofs_per_cell));
-          if (dim == spacedim)
-            FETools::compute_projection_matrices (*this, isotropic_matrices, true);
+          const std::string cache_key =
+            internal::FE_DGQ::get_matrix_cache_key (this->get_name(), "restriction",
+                                                    refinement_case);
+          std::vector<FullMatrix<double> > cached_matrices;
+          if (FETools::MatrixCache::get (cache_key, cached_matrices))
+            this_nonconst.restriction[refinement_case-1].swap(cached_matrices);
           else
-            FETools::compute_projection_matrices (FE_DGQ<dim>(this->degree),
-                                                  isotropic_matrices, true);
-          this_nonconst.restriction[refinement_case-1].swap(isotropic_matrices.back());
+            {
+              std::vector<std::vector<FullMatrix<double> > >
+              isotropic_matrices(RefinementCase<dim>::isotropic_refinement);
+              isotropic_matrices.back().
+              resize(GeometryInfo<dim>::n_children(RefinementCase<dim>(refinement_case)),
+                     FullMatrix<double>(this->dofs_per_cell, this->dofs_per_cell));
+              if (dim == spacedim)
+                FETools::compute_projection_matrices (*this, isotropic_matrices, true);
+              else
+                FETools::compute_projection_matrices (FE_DGQ<dim>(this->degree),
+                                                      isotropic_matrices, true);
+              FETools::MatrixCache::store (cache_key, isotropic_matrices.back());
+              this_nonconst.restriction[refinement_case-1].swap(isotropic_matrices.back());
+            }
         }
       else
         {
           // must compute both restriction and prolongation matrices because
           // we only check for their size and the reinit call initializes them
           // all
-          this_nonconst.reinit_restriction_and_prolongation_matrices();
-          if (dim == spacedim)
-            {
-              FETools::compute_embedding_matrices (*this, this_nonconst.prolongation);
-              FETools::compute_projection_matrices (*this, this_nonconst.restriction);
-            }
-          else
+          if (internal::FE_DGQ::get_cached_matrices (this->get_name(),
+                                                     this_nonconst.prolongation,
+                                                     this_nonconst.restriction) == false)
             {
-              FE_DGQ<dim> tmp(this->degree);
-              FETools::compute_embedding_matrices (tmp, this_nonconst.prolongation);
-              FETools::compute_projection_matrices (tmp, this_nonconst.restriction);
+              this_nonconst.reinit_restriction_and_prolongation_matrices();
+              if (dim == spacedim)
+                {
+                  FETools::compute_embedding_matrices (*this, this_nonconst.prolongation);
+                  FETools::compute_projection_matrices (*this, this_nonconst.restriction);
+                }
+              else
+                {
+                  FE_DGQ<dim> tmp(this->degree);
+                  FETools::compute_embedding_matrices (tmp, this_nonconst.prolongation);
+                  FETools::compute_projection_matrices (tmp, this_nonconst.restriction);
+                }
+              internal::FE_DGQ::store_matrices (this->get_name(),
+                                                this->prolongation,
+                                                this->restriction);
             }
         }
     }
@@ -655,7 +655,14 @@ FE_Enriched<dim,spacedim>::multiply_by_enrichment
   Assert (base_no_mult_local_enriched_dofs.size() == fe_data.enrichment.size(),
           ExcDimensionMismatch(base_no_mult_local_enriched_dofs.size(),
                                fe_data.enrichment.size()));
-  // calculate hessians, gradients and values for each function
+  // calculate hessians, gradients and values for each function. the
+  // functions are evaluated at all quadrature points at once, and not at all
+  // if the same function was already evaluated at the same points and the
+  // same time by the previous call on this data object
+  const bool same_points = (fe_data.enrichment_points == mapping_data.quadrature_points);
+  if (!same_points)
+    fe_data.enrichment_points = mapping_data.quadrature_points;
+
   for (unsigned int base_no = 1; base_no < this->n_base_elements(); base_no++)
     {
       Assert (base_no_mult_local_enriched_dofs[base_no].size() == fe_data.enrichment[base_no].size(),
@@ -663,37 +670,46 @@ FE_Enriched<dim,spacedim>::multiply_by_enrichment
                                    fe_data.enrichment[base_no].size()));
       for (unsigned int m=0; m < base_no_mult_local_enriched_dofs[base_no].size(); m++)
         {
-          Assert (enrichments[base_no-1][m](cell) != nullptr,
+          const Function<spacedim> *const enrichment_function = enrichments[base_no-1][m](cell);
+          Assert (enrichment_function != nullptr,
                   ExcMessage("The pointer to the enrichment function is NULL"));
 
-          Assert (enrichments[base_no-1][m](cell)->n_components == 1,
+          Assert (enrichment_function->n_components == 1,
                   ExcMessage("Only scalar-valued enrichment functions are allowed"));
 
+          typename InternalData::EnrichmentValues &enrichment_values = fe_data.enrichment[base_no][m];
+          if (same_points &&
+              enrichment_values.function == enrichment_function &&
+              enrichment_values.time == enrichment_function->get_time())
+            continue;
+          enrichment_values.function = enrichment_function;
+          enrichment_values.time = enrichment_function->get_time();
+
           if (flags & update_hessians)
             {
-              Assert (fe_data.enrichment[base_no][m].hessians.size() == n_q_points,
-                      ExcDimensionMismatch(fe_data.enrichment[base_no][m].hessians.size(),
+              Assert (enrichment_values.hessians.size() == n_q_points,
+                      ExcDimensionMismatch(enrichment_values.hessians.size(),
                                            n_q_points));
-              for (unsigned int q=0; q<n_q_points; q++)
-                fe_data.enrichment[base_no][m].hessians[q]  = enrichments[base_no-1][m](cell)->hessian (mapping_data.quadrature_points[q]);
+              enrichment_function->hessian_list (mapping_data.quadrature_points,
+                                                 enrichment_values.hessians);
             }
 
           if (flags & update_gradients)
             {
-              Assert (fe_data.enrichment[base_no][m].gradients.size() == n_q_points,
-                      ExcDimensionMismatch(fe_data.enrichment[base_no][m].gradients.size(),
+              Assert (enrichment_values.gradients.size() == n_q_points,
+                      ExcDimensionMismatch(enrichment_values.gradients.size(),
                                            n_q_points));
-              for (unsigned int q=0; q<n_q_points; q++)
-                fe_data.enrichment[base_no][m].gradients[q] = enrichments[base_no-1][m](cell)->gradient(mapping_data.quadrature_points[q]);
+              enrichment_function->gradient_list (mapping_data.quadrature_points,
+                                                  enrichment_values.gradients);
             }
 
           if (flags & update_values)
             {
-              Assert (fe_data.enrichment[base_no][m].values.size() == n_q_points,
-                      ExcDimensionMismatch(fe_data.enrichment[base_no][m].values.size(),
+              Assert (enrichment_values.values.size() == n_q_points,
+                      ExcDimensionMismatch(enrichment_values.values.size(),
                                            n_q_points));
-              for (unsigned int q=0; q<n_q_points; q++)
-                fe_data.enrichment[base_no][m].values[q]    = enrichments[base_no-1][m](cell)->value   (mapping_data.quadrature_points[q]);
+              enrichment_function->value_list (mapping_data.quadrature_points,
+                                               enrichment_values.values);
             }
         }
     }
@@ -927,6 +943,15 @@ FE_Enriched<dim,spacedim>::InternalData::InternalData(std::unique_ptr<typename F
 {}
 
 
+
+template <int dim, int spacedim>
+FE_Enriched<dim,spacedim>::InternalData::EnrichmentValues::EnrichmentValues ()
+  :
+  function (nullptr),
+  time (0.)
+{}
+
+
 template <int dim, int spacedim>
 typename FiniteElement<dim,spacedim>::InternalDataBase &
 FE_Enriched<dim,spacedim>::
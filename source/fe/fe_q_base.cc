@@ -67,6 +67,22 @@ namespace internal
 
 
 
+      // the key under which a prolongation or restriction matrix is stored
+      // in FETools::MatrixCache
+      inline
+      std::string
+      get_matrix_cache_key (const std::string  &fe_name,
+                            const std::string  &matrix_name,
+                            const unsigned int  refinement_case,
+                            const unsigned int  child)
+      {
+        return fe_name + ":" + matrix_name + ":" +
+               Utilities::int_to_string(refinement_case) + ":" +
+               Utilities::int_to_string(child);
+      }
+
+
+
       // in get_restriction_matrix() and get_prolongation_matrix(), want to undo
       // tensorization on inner loops for performance reasons. this clears a
       // dim-array
@@ -1181,6 +1197,20 @@ FE_Q_Base<PolynomialType,dim,spacedim>
           this->dofs_per_cell)
         return this->prolongation[refinement_case-1][child];
 
+      // the matrix only depends on the element, so another object of the
+      // same element might have computed it already
+      const std::string cache_key =
+        internal::FE_Q_Base::get_matrix_cache_key (this->get_name(), "prolongation",
+                                                   refinement_case, child);
+      std::vector<FullMatrix<double> > cached_matrix;
+      if (FETools::MatrixCache::get (cache_key, cached_matrix))
+        {
+          AssertDimension (cached_matrix.size(), 1);
+          cached_matrix[0].swap(const_cast<FullMatrix<double> &>
+                                (this->prolongation[refinement_case-1][child]));
+          return this->prolongation[refinement_case-1][child];
+        }
+
       // distinguish q/q_dg0 case: only treat Q dofs first
       const unsigned int q_dofs_per_cell = Utilities::fixed_power<dim>(q_degree+1);
 
@@ -1341,6 +1371,9 @@ FE_Q_Base<PolynomialType,dim,spacedim>
         }
 #endif
 
+      FETools::MatrixCache::store (cache_key,
+                                   std::vector<FullMatrix<double> >(1, prolongate));
+
       // swap matrices
       prolongate.swap(const_cast<FullMatrix<double> &>
                       (this->prolongation[refinement_case-1][child]));
@@ -1375,6 +1408,18 @@ FE_Q_Base<PolynomialType,dim,spacedim>
           this->dofs_per_cell)
         return this->restriction[refinement_case-1][child];
 
+      const std::string cache_key =
+        internal::FE_Q_Base::get_matrix_cache_key (this->get_name(), "restriction",
+                                                   refinement_case, child);
+      std::vector<FullMatrix<double> > cached_matrix;
+      if (FETools::MatrixCache::get (cache_key, cached_matrix))
+        {
+          AssertDimension (cached_matrix.size(), 1);
+          cached_matrix[0].swap(const_cast<FullMatrix<double> &>
+                                (this->restriction[refinement_case-1][child]));
+          return this->restriction[refinement_case-1][child];
+        }
+
       FullMatrix<double> my_restriction(this->dofs_per_cell, this->dofs_per_cell);
       // distinguish q/q_dg0 case
       const unsigned int q_dofs_per_cell = Utilities::fixed_power<dim>(q_degree+1);
@@ -1475,6 +1520,9 @@ FE_Q_Base<PolynomialType,dim,spacedim>
               1./GeometryInfo<dim>::n_children(RefinementCase<dim>(refinement_case));
         }
 
+      FETools::MatrixCache::store (cache_key,
+                                   std::vector<FullMatrix<double> >(1, my_restriction));
+
       // swap the just computed restriction matrix into the
       // element of the vector stored in the base class
       my_restriction.swap(const_cast<FullMatrix<double> &>
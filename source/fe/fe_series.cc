@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2016 by the deal.II authors
+// Copyright (C) 2016 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -17,6 +17,7 @@
 
 #include <deal.II/fe/fe_series.h>
 #include <deal.II/base/numbers.h>
+#include <deal.II/base/thread_management.h>
 
 #include <cctype>
 #include <iostream>
@@ -64,8 +65,8 @@ namespace FESeries
         for (unsigned int k=0; k<N; ++k)
           {
             k_vectors(i,j,k)[0] = 2. * numbers::PI * i;
-            k_vectors(i,j,k)[0] = 2. * numbers::PI * j;
-            k_vectors(i,j,k)[0] = 2. * numbers::PI * k;
+            k_vectors(i,j,k)[1] = 2. * numbers::PI * j;
+            k_vectors(i,j,k)[2] = 2. * numbers::PI * k;
           }
   }
 
@@ -80,7 +81,6 @@ namespace FESeries
     fourier_transform_matrices(fe_collection.size())
   {
     set_k_vectors(k_vectors,N);
-    unrolled_coefficients.resize(k_vectors.n_elements());
   }
 
   template <int dim>
@@ -89,24 +89,51 @@ namespace FESeries
                                Table<dim,std::complex<double> > &fourier_coefficients)
   {
     ensure_existence(cell_active_fe_index);
-    const FullMatrix<std::complex<double> > &matrix = fourier_transform_matrices[cell_active_fe_index];
-
-    std::fill(unrolled_coefficients.begin(),
-              unrolled_coefficients.end(),
-              std::complex<double>(0.));
-
-    Assert (unrolled_coefficients.size() == matrix.m(),
-            ExcInternalError());
+    const Fourier<dim> &series = *this;
+    series.calculate(local_dof_values, cell_active_fe_index, fourier_coefficients);
+  }
 
+  template <int dim>
+  void Fourier<dim>::calculate(const Vector<double>             &local_dof_values,
+                               const unsigned int                cell_active_fe_index,
+                               Table<dim,std::complex<double> > &fourier_coefficients) const
+  {
+    Assert (cell_active_fe_index < fourier_transform_matrices.size(),
+            ExcIndexRange(cell_active_fe_index,0,fourier_transform_matrices.size()));
+    const FullMatrix<std::complex<double> > &matrix = fourier_transform_matrices[cell_active_fe_index];
+    Assert (matrix.m() == k_vectors.n_elements(),
+            ExcMessage("The transformation matrix for this element has not been "
+                       "calculated yet. Call precalculate_all_transformation_matrices() "
+                       "before using the const version of this function."));
+    Assert (fourier_coefficients.n_elements() == matrix.m(),
+            ExcDimensionMismatch(fourier_coefficients.n_elements(),matrix.m()));
     Assert (local_dof_values.size() == matrix.n(),
             ExcDimensionMismatch(local_dof_values.size(),matrix.n()));
 
-    for (unsigned int i = 0; i < unrolled_coefficients.size(); i++)
-      for (unsigned int j = 0; j < local_dof_values.size(); j++)
-        unrolled_coefficients[i] += matrix[i][j] *
-                                    local_dof_values[j];
+    // the table stores its elements contiguously in the same order as the
+    // rows of the transformation matrix, so we can write into it directly
+    std::complex<double> *coefficients = &fourier_coefficients(TableIndices<dim>());
+    for (unsigned int i = 0; i < matrix.m(); i++)
+      {
+        const std::complex<double> *matrix_row = &matrix(i,0);
+        std::complex<double> sum = 0.;
+        for (unsigned int j = 0; j < matrix.n(); j++)
+          sum += matrix_row[j] * local_dof_values[j];
+        coefficients[i] = sum;
+      }
+  }
 
-    fourier_coefficients.fill(unrolled_coefficients.begin());
+  template <int dim>
+  void Fourier<dim>::precalculate_all_transformation_matrices()
+  {
+    Threads::TaskGroup<> tasks;
+    for (unsigned int fe=0; fe<fe_collection->size(); ++fe)
+      if (fourier_transform_matrices[fe].m() == 0)
+        tasks += Threads::new_task ([&,fe] ()
+      {
+        ensure_existence(fe);
+      });
+    tasks.join_all();
   }
 
   template <int dim>
@@ -249,9 +276,7 @@ namespace FESeries
     N(size_in_each_direction),
     fe_collection(&fe_collection),
     q_collection(&q_collection),
-    legendre_transform_matrices(fe_collection.size()),
-    unrolled_coefficients(Utilities::fixed_power<dim>(N),
-                          0.)
+    legendre_transform_matrices(fe_collection.size())
   {
   }
 
@@ -261,24 +286,51 @@ namespace FESeries
                                 Table<dim,double>            &legendre_coefficients)
   {
     ensure_existence(cell_active_fe_index);
-    const FullMatrix<double> &matrix = legendre_transform_matrices[cell_active_fe_index];
-
-    std::fill(unrolled_coefficients.begin(),
-              unrolled_coefficients.end(),
-              0.);
-
-    Assert (unrolled_coefficients.size() == matrix.m(),
-            ExcInternalError());
+    const Legendre<dim> &series = *this;
+    series.calculate(local_dof_values, cell_active_fe_index, legendre_coefficients);
+  }
 
+  template <int dim>
+  void Legendre<dim>::calculate(const dealii::Vector<double> &local_dof_values,
+                                const unsigned int            cell_active_fe_index,
+                                Table<dim,double>            &legendre_coefficients) const
+  {
+    Assert (cell_active_fe_index < legendre_transform_matrices.size(),
+            ExcIndexRange(cell_active_fe_index,0,legendre_transform_matrices.size()));
+    const FullMatrix<double> &matrix = legendre_transform_matrices[cell_active_fe_index];
+    Assert (matrix.m() == Utilities::fixed_power<dim>(N),
+            ExcMessage("The transformation matrix for this element has not been "
+                       "calculated yet. Call precalculate_all_transformation_matrices() "
+                       "before using the const version of this function."));
+    Assert (legendre_coefficients.n_elements() == matrix.m(),
+            ExcDimensionMismatch(legendre_coefficients.n_elements(),matrix.m()));
     Assert (local_dof_values.size() == matrix.n(),
             ExcDimensionMismatch(local_dof_values.size(),matrix.n()));
 
-    for (unsigned int i = 0; i < unrolled_coefficients.size(); i++)
-      for (unsigned int j = 0; j < local_dof_values.size(); j++)
-        unrolled_coefficients[i] += matrix[i][j] *
-                                    local_dof_values[j];
+    // the table stores its elements contiguously in the same order as the
+    // rows of the transformation matrix, so we can write into it directly
+    double *coefficients = &legendre_coefficients(TableIndices<dim>());
+    for (unsigned int i = 0; i < matrix.m(); i++)
+      {
+        const double *matrix_row = &matrix(i,0);
+        double sum = 0.;
+        for (unsigned int j = 0; j < matrix.n(); j++)
+          sum += matrix_row[j] * local_dof_values[j];
+        coefficients[i] = sum;
+      }
+  }
 
-    legendre_coefficients.fill(unrolled_coefficients.begin());
+  template <int dim>
+  void Legendre<dim>::precalculate_all_transformation_matrices()
+  {
+    Threads::TaskGroup<> tasks;
+    for (unsigned int fe=0; fe<fe_collection->size(); ++fe)
+      if (legendre_transform_matrices[fe].m() == 0)
+        tasks += Threads::new_task ([&,fe] ()
+      {
+        ensure_existence(fe);
+      });
+    tasks.join_all();
   }
 
 
@@ -1214,75 +1214,47 @@ compute_fill (const Mapping<dim,spacedim>                      &mapping,
                                          mapping, mapping_internal, mapping_data,
                                          base_fe_data, base_data);
 
-        // now data has been generated, so copy it. we used to work by
-        // looping over all base elements (i.e. this outer loop), then over
-        // multiplicity, then over the shape functions from that base
-        // element, but that requires that we can infer the global number of
-        // a shape function from its number in the base element. for that we
-        // had the component_to_system_table.
+        // now data has been generated, so copy it. we go through the
+        // blocks of rows of the output tables that this base element
+        // contributes to, as collected in initialize(); for the usual
+        // systems with primitive base elements, these blocks contain the
+        // shape functions of the base element that are contiguous in the
+        // numbering of the composed element
         //
-        // however, this does of course no longer work since we have
-        // non-primitive elements. so we go the other way round: loop over
-        // all shape functions of the composed element, and here only treat
-        // those shape functions that belong to a given base element
-        //TODO: Introduce the needed table and loop only over base element shape functions. This here is not efficient at all AND very bad style
-        const UpdateFlags base_flags = base_fe_data.update_each;
-
         // some base element might involve values that depend on the shape
         // of the geometry, so we always need to copy the shape values around
         // also in case we detected a cell similarity (but no heavy work will
         // be done inside the individual elements in case we have a
         // translation and simple elements).
-        for (unsigned int system_index=0; system_index<this->dofs_per_cell;
-             ++system_index)
-          if (this->system_to_base_table[system_index].first.first == base_no)
+        const UpdateFlags base_flags = base_fe_data.update_each;
+        const std::vector<ShapeFunctionCopyRange> &ranges =
+          base_to_system_copy_ranges[base_no];
+
+        for (unsigned int r=0; r<ranges.size(); ++r)
+          for (unsigned int i=0; i<ranges[r].n_rows; ++i)
             {
-              const unsigned int
-              base_index = this->system_to_base_table[system_index].second;
-              Assert (base_index<base_fe.dofs_per_cell, ExcInternalError());
-
-              // now copy. if the shape function is primitive, then there
-              // is only one value to be copied, but for non-primitive
-              // elements, there might be more values to be copied
-              //
-              // so, find out from which index to take this one value, and
-              // to which index to put
-              unsigned int out_index = 0;
-              for (unsigned int i=0; i<system_index; ++i)
-                out_index += this->n_nonzero_components(i);
-              unsigned int in_index = 0;
-              for (unsigned int i=0; i<base_index; ++i)
-                in_index += base_fe.n_nonzero_components(i);
-
-              // then loop over the number of components to be copied
-              Assert (this->n_nonzero_components(system_index) ==
-                      base_fe.n_nonzero_components(base_index),
-                      ExcInternalError());
+              const unsigned int out_index = ranges[r].system_row + i;
+              const unsigned int in_index = ranges[r].base_row + i;
 
               if (base_flags & update_values)
-                for (unsigned int s=0; s<this->n_nonzero_components(system_index); ++s)
-                  for (unsigned int q=0; q<n_q_points; ++q)
-                    output_data.shape_values[out_index+s][q] =
-                      base_data.shape_values(in_index+s,q);
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  output_data.shape_values[out_index][q] =
+                    base_data.shape_values(in_index,q);
 
               if (base_flags & update_gradients)
-                for (unsigned int s=0; s<this->n_nonzero_components(system_index); ++s)
-                  for (unsigned int q=0; q<n_q_points; ++q)
-                    output_data.shape_gradients[out_index+s][q] =
-                      base_data.shape_gradients[in_index+s][q];
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  output_data.shape_gradients[out_index][q] =
+                    base_data.shape_gradients[in_index][q];
 
               if (base_flags & update_hessians)
-                for (unsigned int s=0; s<this->n_nonzero_components(system_index); ++s)
-                  for (unsigned int q=0; q<n_q_points; ++q)
-                    output_data.shape_hessians[out_index+s][q] =
-                      base_data.shape_hessians[in_index+s][q];
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  output_data.shape_hessians[out_index][q] =
+                    base_data.shape_hessians[in_index][q];
 
               if (base_flags & update_3rd_derivatives)
-                for (unsigned int s=0; s<this->n_nonzero_components(system_index); ++s)
-                  for (unsigned int q=0; q<n_q_points; ++q)
-                    output_data.shape_3rd_derivatives[out_index+s][q] =
-                      base_data.shape_3rd_derivatives[in_index+s][q];
-
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  output_data.shape_3rd_derivatives[out_index][q] =
+                    base_data.shape_3rd_derivatives[in_index][q];
             }
       }
 }
@@ -1527,6 +1499,50 @@ void FESystem<dim,spacedim>::initialize (const std::vector<const FiniteElement<d
 
   }
 
+  {
+    // for each base element, collect the rows of the shape function tables
+    // of this element filled by it, merging adjacent ones
+    std::vector<std::vector<unsigned int> > base_row_starts(this->n_base_elements());
+    for (unsigned int base_no=0; base_no<this->n_base_elements(); ++base_no)
+      {
+        const FiniteElement<dim,spacedim> &base_fe = base_element(base_no);
+        base_row_starts[base_no].resize(base_fe.dofs_per_cell);
+        unsigned int row = 0;
+        for (unsigned int i=0; i<base_fe.dofs_per_cell; ++i)
+          {
+            base_row_starts[base_no][i] = row;
+            row += base_fe.n_nonzero_components(i);
+          }
+      }
+
+    base_to_system_copy_ranges.clear();
+    base_to_system_copy_ranges.resize(this->n_base_elements());
+    unsigned int system_row = 0;
+    for (unsigned int system_index=0; system_index<this->dofs_per_cell; ++system_index)
+      {
+        const unsigned int base_no = this->system_to_base_table[system_index].first.first;
+        const unsigned int base_index = this->system_to_base_table[system_index].second;
+        Assert (base_index<base_element(base_no).dofs_per_cell, ExcInternalError());
+        Assert (this->n_nonzero_components(system_index) ==
+                base_element(base_no).n_nonzero_components(base_index),
+                ExcInternalError());
+
+        const unsigned int base_row = base_row_starts[base_no][base_index];
+        const unsigned int n_rows = this->n_nonzero_components(system_index);
+        std::vector<ShapeFunctionCopyRange> &ranges = base_to_system_copy_ranges[base_no];
+        if (ranges.size() > 0 &&
+            ranges.back().system_row + ranges.back().n_rows == system_row &&
+            ranges.back().base_row + ranges.back().n_rows == base_row)
+          ranges.back().n_rows += n_rows;
+        else
+          {
+            const ShapeFunctionCopyRange range = {system_row, base_row, n_rows};
+            ranges.push_back (range);
+          }
+        system_row += n_rows;
+      }
+  }
+
   // now initialize interface constraints, support points, and other tables.
   // (restriction and prolongation matrices are only built on demand.) do
   // this in parallel
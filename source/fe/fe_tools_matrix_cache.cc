@@ -0,0 +1,237 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/fe/fe_tools.h>
+#include <deal.II/lac/full_matrix.h>
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <map>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace FETools
+{
+  namespace MatrixCache
+  {
+    namespace
+    {
+      Threads::Mutex cache_mutex;
+
+      std::map<std::string, std::vector<FullMatrix<double> > > cached_matrices;
+
+      std::string cache_directory;
+
+
+
+      // elements with support points that can not be described by a name
+      // call themselves 'QUnknownNodes', so their names do not identify the
+      // matrices
+      bool
+      key_is_unique (const std::string &key)
+      {
+        return key.find("QUnknownNodes") == std::string::npos;
+      }
+
+
+
+      // translate the key into a file name, replacing all characters that
+      // might not be allowed in file names
+      std::string
+      get_file_name (const std::string &directory,
+                     const std::string &key)
+      {
+        std::string file_name = key;
+        for (unsigned int i=0; i<file_name.size(); ++i)
+          if (!std::isalnum(static_cast<unsigned char>(file_name[i])) &&
+              file_name[i] != '-' && file_name[i] != '.')
+            file_name[i] = '_';
+        return directory + "/" + file_name + ".matrices";
+      }
+
+
+
+      // read the matrices from the given file. the file starts with the key
+      // in order to detect collisions of the file names
+      bool
+      read_matrices (const std::string               &file_name,
+                     const std::string               &key,
+                     std::vector<FullMatrix<double> > &matrices)
+      {
+        std::ifstream in (file_name.c_str(), std::ios::binary);
+        if (!in)
+          return false;
+
+        std::size_t key_size = 0;
+        in.read (reinterpret_cast<char *>(&key_size), sizeof(key_size));
+        if (!in || key_size != key.size())
+          return false;
+        std::string stored_key (key_size, ' ');
+        in.read (&stored_key[0], key_size);
+        if (!in || stored_key != key)
+          return false;
+
+        std::size_t n_matrices = 0;
+        in.read (reinterpret_cast<char *>(&n_matrices), sizeof(n_matrices));
+        if (!in)
+          return false;
+
+        std::vector<FullMatrix<double> > tmp (n_matrices);
+        for (unsigned int i=0; i<n_matrices; ++i)
+          {
+            std::size_t sizes[2] = {0, 0};
+            in.read (reinterpret_cast<char *>(sizes), sizeof(sizes));
+            if (!in)
+              return false;
+            tmp[i].reinit (sizes[0], sizes[1]);
+            if (sizes[0]*sizes[1] > 0)
+              in.read (reinterpret_cast<char *>(&tmp[i](0,0)),
+                       sizes[0]*sizes[1]*sizeof(double));
+            if (!in)
+              return false;
+          }
+        matrices.swap (tmp);
+        return true;
+      }
+
+
+
+      // write the matrices to a temporary file first and then move it to the
+      // final name, such that other processes reading the directory at the
+      // same time never see a partially written file
+      void
+      write_matrices (const std::string                     &file_name,
+                      const std::string                     &key,
+                      const std::vector<FullMatrix<double> > &matrices)
+      {
+        if (std::ifstream(file_name.c_str()))
+          return;
+
+        // make the name of the temporary file unique among the processes of
+        // a parallel job
+        const unsigned int rank = Utilities::MPI::job_supports_mpi() ?
+                                  Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) : 0;
+        const std::string tmp_name = file_name + ".tmp." + Utilities::System::get_hostname() +
+                                     "." + Utilities::int_to_string(rank);
+        {
+          std::ofstream out (tmp_name.c_str(), std::ios::binary);
+          if (!out)
+            return;
+
+          const std::size_t key_size = key.size();
+          out.write (reinterpret_cast<const char *>(&key_size), sizeof(key_size));
+          out.write (key.data(), key_size);
+          const std::size_t n_matrices = matrices.size();
+          out.write (reinterpret_cast<const char *>(&n_matrices), sizeof(n_matrices));
+          for (unsigned int i=0; i<n_matrices; ++i)
+            {
+              const std::size_t sizes[2] = {matrices[i].m(), matrices[i].n()};
+              out.write (reinterpret_cast<const char *>(sizes), sizeof(sizes));
+              if (sizes[0]*sizes[1] > 0)
+                out.write (reinterpret_cast<const char *>(&matrices[i](0,0)),
+                           sizes[0]*sizes[1]*sizeof(double));
+            }
+          if (!out)
+            {
+              out.close ();
+              std::remove (tmp_name.c_str());
+              return;
+            }
+        }
+        if (std::rename (tmp_name.c_str(), file_name.c_str()) != 0)
+          std::remove (tmp_name.c_str());
+      }
+    }
+
+
+
+    void
+    set_directory (const std::string &directory)
+    {
+      Threads::Mutex::ScopedLock lock (cache_mutex);
+      cache_directory = directory;
+    }
+
+
+
+    bool
+    get (const std::string               &key,
+         std::vector<FullMatrix<double> > &matrices)
+    {
+      if (key_is_unique(key) == false)
+        return false;
+
+      std::string directory;
+      {
+        Threads::Mutex::ScopedLock lock (cache_mutex);
+        const auto entry = cached_matrices.find (key);
+        if (entry != cached_matrices.end())
+          {
+            matrices = entry->second;
+            return true;
+          }
+        directory = cache_directory;
+      }
+
+      // read from disk outside the lock and put the result into the
+      // in-memory cache
+      if (directory.empty() ||
+          read_matrices (get_file_name(directory, key), key, matrices) == false)
+        return false;
+
+      Threads::Mutex::ScopedLock lock (cache_mutex);
+      cached_matrices.insert (std::make_pair(key, matrices));
+      return true;
+    }
+
+
+
+    void
+    store (const std::string                     &key,
+           const std::vector<FullMatrix<double> > &matrices)
+    {
+      if (key_is_unique(key) == false)
+        return;
+
+      std::string directory;
+      {
+        Threads::Mutex::ScopedLock lock (cache_mutex);
+        if (cached_matrices.insert (std::make_pair(key, matrices)).second == false)
+          return;
+        directory = cache_directory;
+      }
+
+      if (!directory.empty())
+        write_matrices (get_file_name(directory, key), key, matrices);
+    }
+
+
+
+    void
+    clear ()
+    {
+      Threads::Mutex::ScopedLock lock (cache_mutex);
+      cached_matrices.clear ();
+    }
+  }
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
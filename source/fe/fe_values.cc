@@ -1281,6 +1281,7 @@ namespace FEValuesViews
   get_function_values (const InputVector &fe_function,
                        std::vector<typename ProductType<value_type,typename InputVector::value_type>::type> &values) const
   {
+    fe_values->compute_on_demand (update_values);
     Assert (fe_values->update_flags & update_values,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_values")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1303,6 +1304,7 @@ namespace FEValuesViews
   get_function_values_from_local_dof_values (const InputVector &dof_values,
                                              std::vector<typename OutputType<typename InputVector::value_type>::value_type> &values) const
   {
+    fe_values->compute_on_demand (update_values);
     Assert (fe_values->update_flags & update_values,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_values")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1323,6 +1325,7 @@ namespace FEValuesViews
   get_function_gradients (const InputVector &fe_function,
                           std::vector<typename ProductType<gradient_type,typename InputVector::value_type>::type> &gradients) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1347,6 +1350,7 @@ namespace FEValuesViews
   get_function_gradients_from_local_dof_values(const InputVector &dof_values,
                                                std::vector<typename OutputType<typename InputVector::value_type>::gradient_type> &gradients) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1367,6 +1371,7 @@ namespace FEValuesViews
   get_function_hessians (const InputVector &fe_function,
                          std::vector<typename ProductType<hessian_type,typename InputVector::value_type>::type> &hessians) const
   {
+    fe_values->compute_on_demand (update_hessians);
     Assert (fe_values->update_flags & update_hessians,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_hessians")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1391,6 +1396,7 @@ namespace FEValuesViews
   get_function_hessians_from_local_dof_values(const InputVector &dof_values,
                                               std::vector<typename OutputType<typename InputVector::value_type>::hessian_type> &hessians) const
   {
+    fe_values->compute_on_demand (update_hessians);
     Assert (fe_values->update_flags & update_hessians,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_hessians")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1411,6 +1417,7 @@ namespace FEValuesViews
   get_function_laplacians (const InputVector &fe_function,
                            std::vector<typename ProductType<value_type,typename InputVector::value_type>::type> &laplacians) const
   {
+    fe_values->compute_on_demand (update_hessians);
     Assert (fe_values->update_flags & update_hessians,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_hessians")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1435,6 +1442,7 @@ namespace FEValuesViews
   get_function_laplacians_from_local_dof_values(const InputVector &dof_values,
                                                 std::vector<typename OutputType<typename InputVector::value_type>::laplacian_type> &laplacians) const
   {
+    fe_values->compute_on_demand (update_hessians);
     Assert (fe_values->update_flags & update_hessians,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_hessians")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1455,6 +1463,7 @@ namespace FEValuesViews
   get_function_third_derivatives (const InputVector &fe_function,
                                   std::vector<typename ProductType<third_derivative_type,typename InputVector::value_type>::type> &third_derivatives) const
   {
+    fe_values->compute_on_demand (update_3rd_derivatives);
     Assert (fe_values->update_flags & update_3rd_derivatives,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_3rd_derivatives")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1479,6 +1488,7 @@ namespace FEValuesViews
   get_function_third_derivatives_from_local_dof_values(const InputVector &dof_values,
                                                        std::vector<typename OutputType<typename InputVector::value_type>::third_derivative_type> &third_derivatives) const
   {
+    fe_values->compute_on_demand (update_3rd_derivatives);
     Assert (fe_values->update_flags & update_3rd_derivatives,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_3rd_derivatives")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1499,6 +1509,7 @@ namespace FEValuesViews
   get_function_values (const InputVector &fe_function,
                        std::vector<typename ProductType<value_type,typename InputVector::value_type>::type> &values) const
   {
+    fe_values->compute_on_demand (update_values);
     Assert (fe_values->update_flags & update_values,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_values")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1523,6 +1534,7 @@ namespace FEValuesViews
   get_function_values_from_local_dof_values (const InputVector &dof_values,
                                              std::vector<typename OutputType<typename InputVector::value_type>::value_type> &values) const
   {
+    fe_values->compute_on_demand (update_values);
     Assert (fe_values->update_flags & update_values,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_values")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1543,6 +1555,7 @@ namespace FEValuesViews
   get_function_gradients (const InputVector &fe_function,
                           std::vector<typename ProductType<gradient_type,typename InputVector::value_type>::type> &gradients) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1567,6 +1580,7 @@ namespace FEValuesViews
   get_function_gradients_from_local_dof_values (const InputVector &dof_values,
                                                 std::vector<typename OutputType<typename InputVector::value_type>::gradient_type> &gradients) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1587,6 +1601,7 @@ namespace FEValuesViews
   get_function_symmetric_gradients (const InputVector &fe_function,
                                     std::vector<typename ProductType<symmetric_gradient_type,typename InputVector::value_type>::type> &symmetric_gradients) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1612,6 +1627,7 @@ namespace FEValuesViews
   get_function_symmetric_gradients_from_local_dof_values(const InputVector &dof_values,
                                                          std::vector<typename OutputType<typename InputVector::value_type>::symmetric_gradient_type> &symmetric_gradients) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1633,6 +1649,7 @@ namespace FEValuesViews
   get_function_divergences (const InputVector &fe_function,
                             std::vector<typename ProductType<divergence_type,typename InputVector::value_type>::type> &divergences) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1658,6 +1675,7 @@ namespace FEValuesViews
   get_function_divergences_from_local_dof_values(const InputVector &dof_values,
                                                  std::vector<typename OutputType<typename InputVector::value_type>::divergence_type> &divergences) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1678,6 +1696,7 @@ namespace FEValuesViews
   get_function_curls (const InputVector &fe_function,
                       std::vector<typename ProductType<curl_type,typename InputVector::value_type>::type> &curls) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert (fe_values->present_cell.get () != nullptr,
@@ -1702,6 +1721,7 @@ namespace FEValuesViews
   get_function_curls_from_local_dof_values(const InputVector &dof_values,
                                            std::vector<typename OutputType<typename InputVector::value_type>::curl_type> &curls) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert (fe_values->update_flags & update_gradients,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert (fe_values->present_cell.get () != nullptr,
@@ -1722,6 +1742,7 @@ namespace FEValuesViews
   get_function_hessians (const InputVector &fe_function,
                          std::vector<typename ProductType<hessian_type,typename InputVector::value_type>::type> &hessians) const
   {
+    fe_values->compute_on_demand (update_hessians);
     Assert (fe_values->update_flags & update_hessians,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_hessians")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1746,6 +1767,7 @@ namespace FEValuesViews
   get_function_hessians_from_local_dof_values (const InputVector &dof_values,
                                                std::vector<typename OutputType<typename InputVector::value_type>::hessian_type> &hessians) const
   {
+    fe_values->compute_on_demand (update_hessians);
     Assert (fe_values->update_flags & update_hessians,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_hessians")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1766,6 +1788,7 @@ namespace FEValuesViews
   get_function_laplacians (const InputVector &fe_function,
                            std::vector<typename ProductType<value_type,typename InputVector::value_type>::type> &laplacians) const
   {
+    fe_values->compute_on_demand (update_hessians);
     Assert (fe_values->update_flags & update_hessians,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_hessians")));
     Assert (laplacians.size() == fe_values->n_quadrature_points,
@@ -1794,6 +1817,7 @@ namespace FEValuesViews
   get_function_laplacians_from_local_dof_values(const InputVector &dof_values,
                                                 std::vector<typename OutputType<typename InputVector::value_type>::laplacian_type> &laplacians) const
   {
+    fe_values->compute_on_demand (update_hessians);
     Assert (fe_values->update_flags & update_hessians,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_hessians")));
     Assert (laplacians.size() == fe_values->n_quadrature_points,
@@ -1815,6 +1839,7 @@ namespace FEValuesViews
   get_function_third_derivatives (const InputVector &fe_function,
                                   std::vector<typename ProductType<third_derivative_type,typename InputVector::value_type>::type> &third_derivatives) const
   {
+    fe_values->compute_on_demand (update_3rd_derivatives);
     Assert (fe_values->update_flags & update_3rd_derivatives,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_3rd_derivatives")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1839,6 +1864,7 @@ namespace FEValuesViews
   get_function_third_derivatives_from_local_dof_values(const InputVector &dof_values,
                                                        std::vector<typename OutputType<typename InputVector::value_type>::third_derivative_type> &third_derivatives) const
   {
+    fe_values->compute_on_demand (update_3rd_derivatives);
     Assert (fe_values->update_flags & update_3rd_derivatives,
             (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_3rd_derivatives")));
     Assert (fe_values->present_cell.get() != nullptr,
@@ -1859,6 +1885,7 @@ namespace FEValuesViews
   get_function_values(const InputVector &fe_function,
                       std::vector<typename ProductType<value_type,typename InputVector::value_type>::type> &values) const
   {
+    fe_values->compute_on_demand (update_values);
     Assert(fe_values->update_flags & update_values,
            (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_values")));
     Assert(fe_values->present_cell.get() != nullptr,
@@ -1883,6 +1910,7 @@ namespace FEValuesViews
   get_function_values_from_local_dof_values(const InputVector &dof_values,
                                             std::vector<typename OutputType<typename InputVector::value_type>::value_type> &values) const
   {
+    fe_values->compute_on_demand (update_values);
     Assert(fe_values->update_flags & update_values,
            (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_values")));
     Assert(fe_values->present_cell.get() != nullptr,
@@ -1903,6 +1931,7 @@ namespace FEValuesViews
   get_function_divergences(const InputVector &fe_function,
                            std::vector<typename ProductType<divergence_type,typename InputVector::value_type>::type> &divergences) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert(fe_values->update_flags & update_gradients,
            (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert(fe_values->present_cell.get() != nullptr,
@@ -1928,6 +1957,7 @@ namespace FEValuesViews
   get_function_divergences_from_local_dof_values(const InputVector &dof_values,
                                                  std::vector<typename OutputType<typename InputVector::value_type>::divergence_type> &divergences) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert(fe_values->update_flags & update_gradients,
            (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert(fe_values->present_cell.get() != nullptr,
@@ -1948,6 +1978,7 @@ namespace FEValuesViews
   get_function_values(const InputVector &fe_function,
                       std::vector<typename ProductType<value_type,typename InputVector::value_type>::type> &values) const
   {
+    fe_values->compute_on_demand (update_values);
     Assert(fe_values->update_flags & update_values,
            (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_values")));
     Assert(fe_values->present_cell.get() != nullptr,
@@ -1972,6 +2003,7 @@ namespace FEValuesViews
   get_function_values_from_local_dof_values (const InputVector &dof_values,
                                              std::vector<typename OutputType<typename InputVector::value_type>::value_type> &values) const
   {
+    fe_values->compute_on_demand (update_values);
     Assert(fe_values->update_flags & update_values,
            (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_values")));
     Assert(fe_values->present_cell.get() != nullptr,
@@ -1992,6 +2024,7 @@ namespace FEValuesViews
   get_function_divergences(const InputVector &fe_function,
                            std::vector<typename ProductType<divergence_type,typename InputVector::value_type>::type> &divergences) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert(fe_values->update_flags & update_gradients,
            (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert(fe_values->present_cell.get() != nullptr,
@@ -2017,6 +2050,7 @@ namespace FEValuesViews
   get_function_divergences_from_local_dof_values (const InputVector &dof_values,
                                                   std::vector<typename OutputType<typename InputVector::value_type>::divergence_type> &divergences) const
   {
+    fe_values->compute_on_demand (update_gradients);
     Assert(fe_values->update_flags & update_gradients,
            (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_gradients")));
     Assert(fe_values->present_cell.get() != nullptr,
@@ -2631,6 +2665,10 @@ FEValuesBase<dim,spacedim>::FEValuesBase (const unsigned int n_q_points,
   dofs_per_cell (dofs_per_cell),
   mapping(&mapping, typeid(*this).name()),
   fe(&fe, typeid(*this).name()),
+  requested_update_flags (update_default),
+  lazy_update_flags (update_default),
+  deferred_update_flags (update_default),
+  pending_update_flags (update_default),
   fe_values_views_cache (*this)
 {
   Assert (n_q_points > 0,
@@ -3064,6 +3102,7 @@ void FEValuesBase<dim,spacedim>::get_function_values (
   std::vector<typename InputVector::value_type> &values) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_values);
   Assert (this->update_flags & update_values,
           ExcAccessToUninitializedField("update_values"));
   AssertDimension (fe->n_components(), 1);
@@ -3089,6 +3128,7 @@ void FEValuesBase<dim,spacedim>::get_function_values (
   std::vector<typename InputVector::value_type> &values) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_values);
   Assert (this->update_flags & update_values,
           ExcAccessToUninitializedField("update_values"));
   AssertDimension (fe->n_components(), 1);
@@ -3112,6 +3152,7 @@ void FEValuesBase<dim,spacedim>::get_function_values (
   Assert (present_cell.get() != nullptr,
           ExcMessage ("FEValues object is not reinit'ed to any cell"));
 
+  this->compute_on_demand (update_values);
   Assert (this->update_flags & update_values,
           ExcAccessToUninitializedField("update_values"));
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
@@ -3140,6 +3181,7 @@ void FEValuesBase<dim,spacedim>::get_function_values (
   // number of function values is generated in each point.
   Assert (indices.size() % dofs_per_cell == 0,
           ExcNotMultiple(indices.size(), dofs_per_cell));
+  this->compute_on_demand (update_values);
   Assert (this->update_flags & update_values,
           ExcAccessToUninitializedField("update_values"));
 
@@ -3166,6 +3208,7 @@ void FEValuesBase<dim,spacedim>::get_function_values (
   bool quadrature_points_fastest) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_values);
   Assert (this->update_flags & update_values,
           ExcAccessToUninitializedField("update_values"));
 
@@ -3196,6 +3239,7 @@ FEValuesBase<dim,spacedim>::get_function_gradients (
   std::vector<Tensor<1,spacedim,typename InputVector::value_type> > &gradients) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_gradients);
   Assert (this->update_flags & update_gradients,
           ExcAccessToUninitializedField("update_gradients"));
   AssertDimension (fe->n_components(), 1);
@@ -3220,6 +3264,7 @@ void FEValuesBase<dim,spacedim>::get_function_gradients (
   std::vector<Tensor<1,spacedim,typename InputVector::value_type> > &gradients) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_gradients);
   Assert (this->update_flags & update_gradients,
           ExcAccessToUninitializedField("update_gradients"));
   AssertDimension (fe->n_components(), 1);
@@ -3243,6 +3288,7 @@ FEValuesBase<dim,spacedim>::get_function_gradients (
   std::vector<std::vector<Tensor<1,spacedim,typename InputVector::value_type> > > &gradients) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_gradients);
   Assert (this->update_flags & update_gradients,
           ExcAccessToUninitializedField("update_gradients"));
   Assert (present_cell.get() != nullptr,
@@ -3274,6 +3320,7 @@ void FEValuesBase<dim,spacedim>::get_function_gradients (
   // number of function values is generated in each point.
   Assert (indices.size() % dofs_per_cell == 0,
           ExcNotMultiple(indices.size(), dofs_per_cell));
+  this->compute_on_demand (update_gradients);
   Assert (this->update_flags & update_gradients,
           ExcAccessToUninitializedField("update_gradients"));
 
@@ -3300,6 +3347,7 @@ get_function_hessians (const InputVector                &fe_function,
 {
   typedef typename InputVector::value_type Number;
   AssertDimension (fe->n_components(), 1);
+  this->compute_on_demand (update_hessians);
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
   Assert (present_cell.get() != nullptr,
@@ -3323,6 +3371,7 @@ void FEValuesBase<dim,spacedim>::get_function_hessians (
   std::vector<Tensor<2,spacedim,typename InputVector::value_type> > &hessians) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_hessians);
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
@@ -3347,6 +3396,7 @@ get_function_hessians (const InputVector                         &fe_function,
                        bool quadrature_points_fastest) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_hessians);
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
   Assert (present_cell.get() != nullptr,
@@ -3375,6 +3425,7 @@ void FEValuesBase<dim, spacedim>::get_function_hessians (
   bool quadrature_points_fastest) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_hessians);
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
   Assert (indices.size() % dofs_per_cell == 0,
@@ -3401,6 +3452,7 @@ void FEValuesBase<dim,spacedim>::get_function_laplacians (
   std::vector<typename InputVector::value_type> &laplacians) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_hessians);
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
   AssertDimension (fe->n_components(), 1);
@@ -3425,6 +3477,7 @@ void FEValuesBase<dim,spacedim>::get_function_laplacians (
   std::vector<typename InputVector::value_type> &laplacians) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_hessians);
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
   AssertDimension (fe->n_components(), 1);
@@ -3448,6 +3501,7 @@ void FEValuesBase<dim,spacedim>::get_function_laplacians (
   typedef typename InputVector::value_type Number;
   Assert (present_cell.get() != nullptr,
           ExcMessage ("FEValues object is not reinit'ed to any cell"));
+  this->compute_on_demand (update_hessians);
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
@@ -3474,6 +3528,7 @@ void FEValuesBase<dim,spacedim>::get_function_laplacians (
   // number of function values is generated in each point.
   Assert (indices.size() % dofs_per_cell == 0,
           ExcNotMultiple(indices.size(), dofs_per_cell));
+  this->compute_on_demand (update_hessians);
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
 
@@ -3499,6 +3554,7 @@ void FEValuesBase<dim,spacedim>::get_function_laplacians (
   typedef typename InputVector::value_type Number;
   Assert (indices.size() % dofs_per_cell == 0,
           ExcNotMultiple(indices.size(), dofs_per_cell));
+  this->compute_on_demand (update_hessians);
   Assert (this->update_flags & update_hessians,
           ExcAccessToUninitializedField("update_hessians"));
 
@@ -3522,6 +3578,7 @@ get_function_third_derivatives (const InputVector                &fe_function,
 {
   typedef typename InputVector::value_type Number;
   AssertDimension (fe->n_components(), 1);
+  this->compute_on_demand (update_3rd_derivatives);
   Assert (this->update_flags & update_3rd_derivatives,
           ExcAccessToUninitializedField("update_3rd_derivatives"));
   Assert (present_cell.get() != nullptr,
@@ -3545,6 +3602,7 @@ void FEValuesBase<dim,spacedim>::get_function_third_derivatives (
   std::vector<Tensor<3,spacedim,typename InputVector::value_type> > &third_derivatives) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_3rd_derivatives);
   Assert (this->update_flags & update_3rd_derivatives,
           ExcAccessToUninitializedField("update_3rd_derivatives"));
   AssertDimension (fe_function.size(), present_cell->n_dofs_for_dof_handler());
@@ -3569,6 +3627,7 @@ get_function_third_derivatives (const InputVector                         &fe_fu
                                 bool quadrature_points_fastest) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_3rd_derivatives);
   Assert (this->update_flags & update_3rd_derivatives,
           ExcAccessToUninitializedField("update_3rd_derivatives"));
   Assert (present_cell.get() != nullptr,
@@ -3597,6 +3656,7 @@ void FEValuesBase<dim, spacedim>::get_function_third_derivatives (
   bool quadrature_points_fastest) const
 {
   typedef typename InputVector::value_type Number;
+  this->compute_on_demand (update_3rd_derivatives);
   Assert (this->update_flags & update_3rd_derivatives,
           ExcAccessToUninitializedField("update_3rd_derivatives"));
   Assert (indices.size() % dofs_per_cell == 0,
@@ -3629,6 +3689,7 @@ template <int dim, int spacedim>
 const std::vector<Tensor<1,spacedim> > &
 FEValuesBase<dim,spacedim>::get_all_normal_vectors () const
 {
+  this->compute_on_demand (update_normal_vectors);
   Assert (this->update_flags & update_normal_vectors,
           (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_normal_vectors")));
   return get_normal_vectors();
@@ -3640,6 +3701,7 @@ template <int dim, int spacedim>
 const std::vector<Tensor<1,spacedim> > &
 FEValuesBase<dim,spacedim>::get_normal_vectors () const
 {
+  this->compute_on_demand (update_normal_vectors);
   Assert (this->update_flags & update_normal_vectors,
           (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_normal_vectors")));
 
@@ -3686,6 +3748,75 @@ FEValuesBase<dim,spacedim>::compute_update_flags (const UpdateFlags update_flags
 }
 
 
+
+template <int dim, int spacedim>
+void
+FEValuesBase<dim,spacedim>::set_lazy_update_flags (const UpdateFlags lazy_flags)
+{
+  Assert ((lazy_flags & ~requested_update_flags) == 0,
+          ExcMessage ("Only flags that have been passed to the constructor "
+                      "can be computed on demand."));
+
+  lazy_update_flags = lazy_flags;
+  if (lazy_flags == update_default)
+    {
+      // compute everything on every cell again, using the internal data for
+      // all flags kept so far if there is one
+      if (lazy_mapping_data.get() != nullptr)
+        {
+          mapping_data = std::move (lazy_mapping_data);
+          fe_data = std::move (lazy_fe_data);
+        }
+      deferred_update_flags = update_default;
+    }
+  else
+    {
+      // keep the internal data for all flags to fill the deferred ones on
+      // demand, and get new internal data for the flags still computed in
+      // reinit()
+      if (lazy_mapping_data.get() == nullptr)
+        {
+          lazy_mapping_data = std::move (mapping_data);
+          lazy_fe_data = std::move (fe_data);
+        }
+      const UpdateFlags eager_flags
+        = compute_update_flags (static_cast<UpdateFlags>(requested_update_flags &
+                                                         ~lazy_flags));
+      get_internal_data (eager_flags, mapping_data, fe_data);
+      deferred_update_flags = static_cast<UpdateFlags>(update_flags & ~eager_flags);
+    }
+
+  // the new internal data does not contain any information about the
+  // present cell, so the next cell must not rely on it. the quantities
+  // of the present cell are not affected by any of this
+  pending_update_flags = update_default;
+  cell_similarity = CellSimilarity::invalid_next_cell;
+}
+
+
+
+template <int dim, int spacedim>
+void
+FEValuesBase<dim,spacedim>::compute_pending_update_flags () const
+{
+  Assert (present_cell.get() != nullptr,
+          ExcMessage ("The FEValues object has not been initialized "
+                      "on any cell yet."));
+
+  // fill all quantities of the present cell with the internal data for all
+  // flags. this also overwrites the quantities already computed in reinit()
+  // with the same values, but keeps the interface to the mapping and the
+  // finite element unchanged. the cell similarity of the present cell
+  // refers to the data computed in reinit() and must be kept for the next
+  // cell
+  FEValuesBase<dim,spacedim> &fe_values = const_cast<FEValuesBase<dim,spacedim>&>(*this);
+  fe_values.pending_update_flags = update_default;
+  const CellSimilarity::Similarity similarity = cell_similarity;
+  fe_values.fill_present_cell (*lazy_mapping_data, *lazy_fe_data);
+  fe_values.cell_similarity = similarity;
+}
+
+
 template <int dim, int spacedim>
 void
 FEValuesBase< dim, spacedim >::invalidate_present_cell ()
@@ -3837,7 +3968,9 @@ FEValues<dim,spacedim>::FEValues (const Mapping<dim,spacedim>       &mapping,
                               update_default,
                               mapping,
                               fe),
-  quadrature (q)
+  quadrature (q),
+  max_geometry_cache_size (0),
+  next_geometry_cache_entry (0)
 {
   initialize (update_flags);
 }
@@ -3854,7 +3987,9 @@ FEValues<dim,spacedim>::FEValues (const FiniteElement<dim,spacedim> &fe,
                               update_default,
                               StaticMappingQ1<dim,spacedim>::mapping,
                               fe),
-  quadrature (q)
+  quadrature (q),
+  max_geometry_cache_size (0),
+  next_geometry_cache_entry (0)
 {
   initialize (update_flags);
 }
@@ -3876,6 +4011,7 @@ FEValues<dim,spacedim>::initialize (const UpdateFlags update_flags)
                         "triangulation it refers to is embedded in a higher "
                         "dimensional space."));
 
+  this->requested_update_flags = update_flags;
   const UpdateFlags flags = this->compute_update_flags (update_flags);
 
   // initialize the base classes
@@ -3911,6 +4047,50 @@ FEValues<dim,spacedim>::initialize (const UpdateFlags update_flags)
 }
 
 
+
+template <int dim, int spacedim>
+void
+FEValues<dim,spacedim>::get_internal_data
+(const UpdateFlags                                                        flags,
+ std::unique_ptr<typename Mapping<dim,spacedim>::InternalDataBase>       &mapping_data,
+ std::unique_ptr<typename FiniteElement<dim,spacedim>::InternalDataBase> &fe_data)
+{
+  fe_data.reset (this->fe->get_data (flags,
+                                   *this->mapping,
+                                   this->quadrature,
+                                   this->finite_element_output));
+  if (flags & update_mapping)
+    mapping_data.reset (this->mapping->get_data (flags, this->quadrature));
+  else
+    mapping_data.reset (new typename Mapping<dim,spacedim>::InternalDataBase());
+}
+
+
+
+template <int dim, int spacedim>
+void
+FEValues<dim,spacedim>::fill_present_cell
+(const typename Mapping<dim,spacedim>::InternalDataBase       &mapping_data,
+ const typename FiniteElement<dim,spacedim>::InternalDataBase &fe_data)
+{
+  if (this->update_flags & update_mapping)
+    this->get_mapping().fill_fe_values(*this->present_cell,
+                                              CellSimilarity::none,
+                                              this->quadrature,
+                                              mapping_data,
+                                              this->mapping_output);
+
+  this->get_fe().fill_fe_values(*this->present_cell,
+                                     CellSimilarity::none,
+                                     this->quadrature,
+                                     this->get_mapping(),
+                                     mapping_data,
+                                     this->mapping_output,
+                                     fe_data,
+                                     this->finite_element_output);
+}
+
+
 namespace
 {
   // Reset a unique_ptr. If we can, do not de-allocate the previously
@@ -3999,6 +4179,11 @@ FEValues<dim,spacedim>::reinit
 template <int dim, int spacedim>
 void FEValues<dim,spacedim>::do_reinit ()
 {
+  this->pending_update_flags = this->deferred_update_flags;
+
+  if (max_geometry_cache_size > 0 && reinit_from_geometry_cache ())
+    return;
+
   // first call the mapping and let it generate the data
   // specific to the mapping. also let it inspect the
   // cell similarity flag and, if necessary, update
@@ -4025,6 +4210,106 @@ void FEValues<dim,spacedim>::do_reinit ()
                                 this->mapping_output,
                                 *this->fe_data,
                                 this->finite_element_output);
+
+  if (max_geometry_cache_size > 0)
+    store_in_geometry_cache ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+FEValues<dim,spacedim>::enable_geometry_cache (const unsigned int max_n_cell_shapes)
+{
+  max_geometry_cache_size = (dim == spacedim ? max_n_cell_shapes : 0);
+  next_geometry_cache_entry = 0;
+  geometry_cache.clear ();
+
+  // finite elements that need the location of the quadrature points
+  // to compute their shape functions are not translation invariant,
+  // so don't use the cache for them
+  const UpdateFlags flags_without_points
+    = static_cast<UpdateFlags>(this->update_flags & ~update_quadrature_points);
+  if (this->get_fe().requires_update_flags (flags_without_points)
+      & update_quadrature_points)
+    max_geometry_cache_size = 0;
+}
+
+
+
+template <int dim, int spacedim>
+bool
+FEValues<dim,spacedim>::reinit_from_geometry_cache ()
+{
+  const typename Triangulation<dim,spacedim>::cell_iterator &cell
+    = static_cast<const typename Triangulation<dim,spacedim>::cell_iterator &>
+      (*this->present_cell);
+
+  // use a similar test as TriaAccessor::is_translation_of(), but with a
+  // tolerance relative to the size of the cell rather than to the
+  // distance between the two cells
+  const Point<spacedim> vertex_0 = cell->vertex(0);
+  for (unsigned int e=0; e<geometry_cache.size(); ++e)
+    {
+      const GeometryCacheEntry &entry = geometry_cache[e];
+      const Tensor<1,spacedim> shift = vertex_0 - entry.vertices[0];
+      const double tol_square = 1e-24 * (entry.vertices[1] -
+                                         entry.vertices[0]).norm_square();
+      bool is_translation = true;
+      for (unsigned int v=1; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        if (((cell->vertex(v) - entry.vertices[v]) - shift).norm_square()
+            > tol_square)
+          {
+            is_translation = false;
+            break;
+          }
+      if (is_translation == false)
+        continue;
+
+      this->mapping_output = entry.mapping_output;
+      this->finite_element_output = entry.finite_element_output;
+      for (unsigned int q=0; q<this->mapping_output.quadrature_points.size(); ++q)
+        this->mapping_output.quadrature_points[q] += shift;
+
+      // the internal data of the mapping still refers to the last cell
+      // on which it was computed, so the next cell must not be treated as
+      // a translation of the present one
+      this->cell_similarity = CellSimilarity::invalid_next_cell;
+      return true;
+    }
+
+  return false;
+}
+
+
+
+template <int dim, int spacedim>
+void
+FEValues<dim,spacedim>::store_in_geometry_cache ()
+{
+  // the mapping indicates with this flag that the data computed on the
+  // present cell can not be reused on other cells
+  if (this->cell_similarity == CellSimilarity::invalid_next_cell)
+    return;
+
+  unsigned int index = next_geometry_cache_entry;
+  if (geometry_cache.size() < max_geometry_cache_size)
+    {
+      index = geometry_cache.size();
+      geometry_cache.emplace_back ();
+    }
+  else
+    next_geometry_cache_entry = (next_geometry_cache_entry+1) % max_geometry_cache_size;
+
+  const typename Triangulation<dim,spacedim>::cell_iterator &cell
+    = static_cast<const typename Triangulation<dim,spacedim>::cell_iterator &>
+      (*this->present_cell);
+
+  GeometryCacheEntry &entry = geometry_cache[index];
+  for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+    entry.vertices[v] = cell->vertex(v);
+  entry.mapping_output = this->mapping_output;
+  entry.finite_element_output = this->finite_element_output;
 }
 
 
@@ -4034,7 +4319,10 @@ std::size_t
 FEValues<dim,spacedim>::memory_consumption () const
 {
   return (FEValuesBase<dim,spacedim>::memory_consumption () +
-          MemoryConsumption::memory_consumption (quadrature));
+          MemoryConsumption::memory_consumption (quadrature) +
+          geometry_cache.size() * (sizeof(GeometryCacheEntry) +
+                                   this->mapping_output.memory_consumption() +
+                                   this->finite_element_output.memory_consumption()));
 }
 
 
@@ -4064,6 +4352,7 @@ template <int dim, int spacedim>
 const std::vector<Tensor<1,spacedim> > &
 FEFaceValuesBase<dim,spacedim>::get_boundary_forms () const
 {
+  this->compute_on_demand (update_boundary_forms);
   Assert (this->update_flags & update_boundary_forms,
           (typename FEValuesBase<dim,spacedim>::ExcAccessToUninitializedField("update_boundary_forms")));
   return this->mapping_output.boundary_forms;
@@ -4126,6 +4415,7 @@ template <int dim, int spacedim>
 void
 FEFaceValues<dim,spacedim>::initialize (const UpdateFlags update_flags)
 {
+  this->requested_update_flags = update_flags;
   const UpdateFlags flags = this->compute_update_flags (update_flags);
 
   // initialize the base classes
@@ -4162,6 +4452,50 @@ FEFaceValues<dim,spacedim>::initialize (const UpdateFlags update_flags)
 
 
 
+template <int dim, int spacedim>
+void
+FEFaceValues<dim,spacedim>::get_internal_data
+(const UpdateFlags                                                        flags,
+ std::unique_ptr<typename Mapping<dim,spacedim>::InternalDataBase>       &mapping_data,
+ std::unique_ptr<typename FiniteElement<dim,spacedim>::InternalDataBase> &fe_data)
+{
+  fe_data.reset (this->fe->get_face_data (flags,
+                                   *this->mapping,
+                                   this->quadrature,
+                                   this->finite_element_output));
+  if (flags & update_mapping)
+    mapping_data.reset (this->mapping->get_face_data (flags, this->quadrature));
+  else
+    mapping_data.reset (new typename Mapping<dim,spacedim>::InternalDataBase());
+}
+
+
+
+template <int dim, int spacedim>
+void
+FEFaceValues<dim,spacedim>::fill_present_cell
+(const typename Mapping<dim,spacedim>::InternalDataBase       &mapping_data,
+ const typename FiniteElement<dim,spacedim>::InternalDataBase &fe_data)
+{
+  if (this->update_flags & update_mapping)
+    this->get_mapping().fill_fe_face_values(*this->present_cell,
+                                              present_face_no,
+                                              this->quadrature,
+                                              mapping_data,
+                                              this->mapping_output);
+
+  this->get_fe().fill_fe_face_values(*this->present_cell,
+                                     present_face_no,
+                                     this->quadrature,
+                                     this->get_mapping(),
+                                     mapping_data,
+                                     this->mapping_output,
+                                     fe_data,
+                                     this->finite_element_output);
+}
+
+
+
 template <int dim, int spacedim>
 template <template <int, int> class DoFHandlerType, bool lda>
 void
@@ -4224,6 +4558,8 @@ void FEFaceValues<dim,spacedim>::do_reinit (const unsigned int face_no)
   // first of all, set the present_face_index (if available)
   const typename Triangulation<dim,spacedim>::cell_iterator cell=*this->present_cell;
   this->present_face_index=cell->face_index(face_no);
+  present_face_no = face_no;
+  this->pending_update_flags = this->deferred_update_flags;
 
   if (this->update_flags & update_mapping)
     {
@@ -4293,6 +4629,7 @@ template <int dim, int spacedim>
 void
 FESubfaceValues<dim,spacedim>::initialize (const UpdateFlags update_flags)
 {
+  this->requested_update_flags = update_flags;
   const UpdateFlags flags = this->compute_update_flags (update_flags);
 
   // initialize the base classes
@@ -4329,6 +4666,52 @@ FESubfaceValues<dim,spacedim>::initialize (const UpdateFlags update_flags)
 }
 
 
+
+template <int dim, int spacedim>
+void
+FESubfaceValues<dim,spacedim>::get_internal_data
+(const UpdateFlags                                                        flags,
+ std::unique_ptr<typename Mapping<dim,spacedim>::InternalDataBase>       &mapping_data,
+ std::unique_ptr<typename FiniteElement<dim,spacedim>::InternalDataBase> &fe_data)
+{
+  fe_data.reset (this->fe->get_subface_data (flags,
+                                   *this->mapping,
+                                   this->quadrature,
+                                   this->finite_element_output));
+  if (flags & update_mapping)
+    mapping_data.reset (this->mapping->get_subface_data (flags, this->quadrature));
+  else
+    mapping_data.reset (new typename Mapping<dim,spacedim>::InternalDataBase());
+}
+
+
+
+template <int dim, int spacedim>
+void
+FESubfaceValues<dim,spacedim>::fill_present_cell
+(const typename Mapping<dim,spacedim>::InternalDataBase       &mapping_data,
+ const typename FiniteElement<dim,spacedim>::InternalDataBase &fe_data)
+{
+  if (this->update_flags & update_mapping)
+    this->get_mapping().fill_fe_subface_values(*this->present_cell,
+                                              present_face_no,
+                                              present_subface_no,
+                                              this->quadrature,
+                                              mapping_data,
+                                              this->mapping_output);
+
+  this->get_fe().fill_fe_subface_values(*this->present_cell,
+                                     present_face_no,
+                                     present_subface_no,
+                                     this->quadrature,
+                                     this->get_mapping(),
+                                     mapping_data,
+                                     this->mapping_output,
+                                     fe_data,
+                                     this->finite_element_output);
+}
+
+
 template <int dim, int spacedim>
 template <template <int, int> class DoFHandlerType, bool lda>
 void FESubfaceValues<dim,spacedim>::reinit
@@ -4475,6 +4858,9 @@ void FESubfaceValues<dim,spacedim>::do_reinit (const unsigned int face_no,
              ExcInternalError());
       this->present_face_index=subface_index;
     }
+  present_face_no = face_no;
+  present_subface_no = subface_no;
+  this->pending_update_flags = this->deferred_update_flags;
 
   // now ask the mapping and the finite element to do the actual work
   if (this->update_flags & update_mapping)
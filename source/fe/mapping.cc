@@ -14,9 +14,12 @@
 // ---------------------------------------------------------------------
 
 
+#include <deal.II/base/array_view.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/fe/mapping.h>
 
+#include <limits>
+
 DEAL_II_NAMESPACE_OPEN
 
 
@@ -34,6 +37,29 @@ Mapping<dim, spacedim>::get_vertices (
 }
 
 
+template <int dim, int spacedim>
+void
+Mapping<dim,spacedim>::
+transform_points_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                    const ArrayView<const Point<spacedim> >                   &real_points,
+                                    const ArrayView<Point<dim> >                              &unit_points) const
+{
+  AssertDimension(real_points.size(), unit_points.size());
+  for (unsigned int i=0; i<real_points.size(); ++i)
+    {
+      try
+        {
+          unit_points[i] = transform_real_to_unit_cell(cell, real_points[i]);
+        }
+      catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+        {
+          for (unsigned int d=0; d<dim; ++d)
+            unit_points[i][d] = std::numeric_limits<double>::infinity();
+        }
+    }
+}
+
+
 template <int dim, int spacedim>
 Point<dim-1>
 Mapping<dim,spacedim>::
@@ -43,6 +43,7 @@
 #include <algorithm>
 #include <numeric>
 #include <array>
+#include <limits>
 #include <memory>
 
 
@@ -607,7 +608,14 @@ MappingQGeneric<dim,spacedim>::InternalData::InternalData (const unsigned int po
   n_shape_functions (Utilities::fixed_power<dim>(polynomial_degree+1)),
   line_support_points(QGaussLobatto<1>(polynomial_degree+1)),
   tensor_product_quadrature(false)
-{}
+{
+  const QGaussLobatto<dim> support_quadrature(polynomial_degree+1);
+  std::vector<unsigned int> h2l(support_quadrature.size());
+  FETools::hierarchic_to_lexicographic_numbering<dim>(polynomial_degree, h2l);
+  unit_support_points.resize(support_quadrature.size());
+  for (unsigned int i=0; i<support_quadrature.size(); ++i)
+    unit_support_points[i] = support_quadrature.point(h2l[i]);
+}
 
 
 
@@ -623,6 +631,7 @@ MappingQGeneric<dim,spacedim>::InternalData::memory_consumption () const
           MemoryConsumption::memory_consumption (unit_tangentials) +
           MemoryConsumption::memory_consumption (aux) +
           MemoryConsumption::memory_consumption (mapping_support_points) +
+          MemoryConsumption::memory_consumption (unit_support_points) +
           MemoryConsumption::memory_consumption (cell_of_current_support_points) +
           MemoryConsumption::memory_consumption (volume_elements) +
           MemoryConsumption::memory_consumption (polynomial_degree) +
@@ -2664,6 +2673,233 @@ transform_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_it
 
 
 
+namespace internal
+{
+  namespace MappingQGeneric
+  {
+    namespace
+    {
+      /**
+       * Evaluate the position and the Jacobian of a tensor product mapping
+       * with the given support points in lexicographic ordering at a batch
+       * of points on the unit cell. The one-dimensional basis consists of
+       * the Lagrange polynomials on the points @p nodes, whose inverse
+       * normalization factors are given in @p weights.
+       */
+      template <int dim>
+      void
+      evaluate_tensor_product_mapping (const std::vector<double>                      &nodes,
+                                       const std::vector<double>                      &weights,
+                                       const std::vector<Point<dim> >                 &support_points,
+                                       const Point<dim,VectorizedArray<double> >      &p_unit,
+                                       Point<dim,VectorizedArray<double> >            &p_real,
+                                       Tensor<2,dim,VectorizedArray<double> >         &jacobian)
+      {
+        const unsigned int n = nodes.size();
+        constexpr unsigned int max_nodes = 16;
+        AssertIndexRange(n, max_nodes+1);
+
+        // values and derivatives of the 1d Lagrange polynomials, computed
+        // with the product rule over the linear factors
+        VectorizedArray<double> shapes[dim][max_nodes], derivatives[dim][max_nodes];
+        for (unsigned int d=0; d<dim; ++d)
+          for (unsigned int i=0; i<n; ++i)
+            {
+              VectorizedArray<double> value = make_vectorized_array(weights[i]);
+              VectorizedArray<double> derivative = VectorizedArray<double>();
+              for (unsigned int j=0; j<n; ++j)
+                if (j != i)
+                  {
+                    const VectorizedArray<double> factor = p_unit[d] - nodes[j];
+                    derivative = derivative * factor + value;
+                    value *= factor;
+                  }
+              shapes[d][i] = value;
+              derivatives[d][i] = derivative;
+            }
+
+        // sum factorization: contract direction 0 first, then 1, then 2
+        p_real = Point<dim,VectorizedArray<double> >();
+        jacobian = Tensor<2,dim,VectorizedArray<double> >();
+        for (unsigned int k=0; k<(dim>2 ? n : 1); ++k)
+          {
+            Tensor<1,dim,VectorizedArray<double> > value_k, dx_k, dy_k;
+            for (unsigned int j=0; j<(dim>1 ? n : 1); ++j)
+              {
+                Tensor<1,dim,VectorizedArray<double> > value_j, dx_j;
+                const Point<dim> *points = &support_points[n*(j+n*k)];
+                for (unsigned int i=0; i<n; ++i)
+                  for (unsigned int c=0; c<dim; ++c)
+                    {
+                      value_j[c] += shapes[0][i] * points[i][c];
+                      dx_j[c] += derivatives[0][i] * points[i][c];
+                    }
+                if (dim > 1)
+                  for (unsigned int c=0; c<dim; ++c)
+                    {
+                      value_k[c] += shapes[1][j] * value_j[c];
+                      dx_k[c] += shapes[1][j] * dx_j[c];
+                      dy_k[c] += derivatives[1][j] * value_j[c];
+                    }
+                else
+                  {
+                    value_k = value_j;
+                    dx_k = dx_j;
+                  }
+              }
+            for (unsigned int c=0; c<dim; ++c)
+              if (dim > 2)
+                {
+                  p_real[c] += shapes[2][k] * value_k[c];
+                  jacobian[c][0] += shapes[2][k] * dx_k[c];
+                  jacobian[c][1] += shapes[2][k] * dy_k[c];
+                  jacobian[c][dim-1] += derivatives[2][k] * value_k[c];
+                }
+              else
+                {
+                  p_real[c] = value_k[c];
+                  jacobian[c][0] = dx_k[c];
+                  if (dim > 1)
+                    jacobian[c][dim-1] = dy_k[c];
+                }
+          }
+      }
+    }
+  }
+}
+
+
+
+template <int dim, int spacedim>
+void
+MappingQGeneric<dim,spacedim>::
+transform_points_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                    const ArrayView<const Point<spacedim> >                   &real_points,
+                                    const ArrayView<Point<dim> >                              &unit_points) const
+{
+  AssertDimension(real_points.size(), unit_points.size());
+
+  // the codimension case and very high degrees are handled point by point
+  if (dim != spacedim || polynomial_degree+1 > 16)
+    {
+      Mapping<dim,spacedim>::transform_points_real_to_unit_cell(cell, real_points,
+                                                                unit_points);
+      return;
+    }
+
+  // collect the support points in lexicographic order, cast to
+  // Point<dim> which is the same type as Point<spacedim> here
+  const std::vector<Point<spacedim> > hierarchic_points
+    = this->compute_mapping_support_points(cell);
+  std::vector<unsigned int> h2l(hierarchic_points.size());
+  FETools::hierarchic_to_lexicographic_numbering<dim>(polynomial_degree, h2l);
+  std::vector<Point<dim> > support_points(hierarchic_points.size());
+  for (unsigned int i=0; i<hierarchic_points.size(); ++i)
+    for (unsigned int d=0; d<dim; ++d)
+      support_points[h2l[i]][d] = hierarchic_points[i][d];
+
+  const unsigned int n_nodes = polynomial_degree+1;
+  std::vector<double> nodes(n_nodes), weights(n_nodes, 1.);
+  for (unsigned int i=0; i<n_nodes; ++i)
+    nodes[i] = line_support_points.point(i)[0];
+  for (unsigned int i=0; i<n_nodes; ++i)
+    for (unsigned int j=0; j<n_nodes; ++j)
+      if (j != i)
+        weights[i] /= (nodes[i] - nodes[j]);
+
+  // the affine approximation at the cell center gives the initial guess
+  Point<dim,VectorizedArray<double> > center, center_real;
+  for (unsigned int d=0; d<dim; ++d)
+    center[d] = 0.5;
+  Tensor<2,dim,VectorizedArray<double> > jacobian;
+  internal::MappingQGeneric::evaluate_tensor_product_mapping
+  (nodes, weights, support_points, center, center_real, jacobian);
+  const Tensor<2,dim,VectorizedArray<double> > center_inverse_jacobian = invert(jacobian);
+
+  // tolerance and iteration limit as in the scalar Newton iteration of
+  // transform_real_to_unit_cell()
+  const double eps = 1.e-11;
+  const unsigned int newton_iteration_limit = 20;
+  const unsigned int n_lanes = VectorizedArray<double>::n_array_elements;
+  for (unsigned int start=0; start<real_points.size(); start+=n_lanes)
+    {
+      const unsigned int n_active = std::min<unsigned int>(n_lanes, real_points.size()-start);
+
+      // fill unused lanes with the last point
+      Point<dim,VectorizedArray<double> > p;
+      for (unsigned int v=0; v<n_lanes; ++v)
+        for (unsigned int d=0; d<dim; ++d)
+          p[d][v] = real_points[start+std::min(v, n_active-1)][d];
+
+      Point<dim,VectorizedArray<double> > p_unit = center;
+      const Tensor<1,dim,VectorizedArray<double> > initial_delta
+        = center_inverse_jacobian * (p - center_real);
+      for (unsigned int d=0; d<dim; ++d)
+        p_unit[d] += initial_delta[d];
+
+      bool converged[n_lanes];
+      for (unsigned int v=0; v<n_lanes; ++v)
+        converged[v] = v >= n_active;
+      bool failed[n_lanes] = {};
+
+      for (unsigned int it=0; it<newton_iteration_limit; ++it)
+        {
+          Point<dim,VectorizedArray<double> > p_real;
+          internal::MappingQGeneric::evaluate_tensor_product_mapping
+          (nodes, weights, support_points, p_unit, p_real, jacobian);
+          const VectorizedArray<double> det = determinant(jacobian);
+          const Tensor<1,dim,VectorizedArray<double> > delta
+            = invert(jacobian) * (p_real - p);
+
+          bool all_done = true;
+          for (unsigned int v=0; v<n_lanes; ++v)
+            if (!converged[v] && !failed[v])
+              {
+                if (!(det[v] > 0.))
+                  {
+                    failed[v] = true;
+                    continue;
+                  }
+                double delta_norm_square = 0;
+                for (unsigned int d=0; d<dim; ++d)
+                  {
+                    p_unit[d][v] -= delta[d][v];
+                    delta_norm_square += delta[d][v] * delta[d][v];
+                  }
+                if (delta_norm_square < eps*eps)
+                  converged[v] = true;
+                else if (!(delta_norm_square < 1e10))
+                  failed[v] = true;
+                else
+                  all_done = false;
+              }
+          if (all_done)
+            break;
+        }
+
+      for (unsigned int v=0; v<n_active; ++v)
+        if (converged[v])
+          for (unsigned int d=0; d<dim; ++d)
+            unit_points[start+v][d] = p_unit[d][v];
+        else
+          {
+            // resort to the scalar iteration with line search
+            try
+              {
+                unit_points[start+v] = this->transform_real_to_unit_cell(cell, real_points[start+v]);
+              }
+            catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+              {
+                for (unsigned int d=0; d<dim; ++d)
+                  unit_points[start+v][d] = std::numeric_limits<double>::infinity();
+              }
+          }
+    }
+}
+
+
+
+
 template <int dim, int spacedim>
 UpdateFlags
 MappingQGeneric<dim,spacedim>::requires_update_flags (const UpdateFlags in) const
@@ -2767,6 +3003,162 @@ MappingQGeneric<dim,spacedim>::get_subface_data (const UpdateFlags update_flags,
 
 
 
+namespace internal
+{
+  namespace MappingQGeneric
+  {
+    namespace
+    {
+      /**
+       * Check whether the current mapping support points stored in @p data
+       * are an affine image of the reference cell, i.e., whether the cell is
+       * a parallelogram or parallelepiped that is not curved. If so, return
+       * true and put the constant Jacobian of the transformation into @p
+       * jacobian. The vertices 0 and 2<sup>d</sup> of the cell span the
+       * directions of the Jacobian, and all other support points must match
+       * the affine prediction up to roundoff relative to the cell size.
+       */
+      template <int dim, int spacedim>
+      bool
+      is_affine_cell (const typename dealii::MappingQGeneric<dim,spacedim>::InternalData &data,
+                      DerivativeForm<1,dim,spacedim>                                   &jacobian)
+      {
+        const std::vector<Point<spacedim> > &support_points = data.mapping_support_points;
+        AssertDimension (support_points.size(), data.unit_support_points.size());
+
+        double size_sqr = 0;
+        for (unsigned int d=0; d<dim; ++d)
+          {
+            const Tensor<1,spacedim> direction =
+              support_points[1U<<d] - support_points[0];
+            for (unsigned int e=0; e<spacedim; ++e)
+              jacobian[e][d] = direction[e];
+            size_sqr = std::max(size_sqr, direction.norm_square());
+          }
+
+        for (unsigned int i=1; i<support_points.size(); ++i)
+          {
+            const Point<dim> &unit_point = data.unit_support_points[i];
+            Tensor<1,spacedim> deviation = support_points[i] - support_points[0];
+            for (unsigned int e=0; e<spacedim; ++e)
+              for (unsigned int d=0; d<dim; ++d)
+                deviation[e] -= jacobian[e][d] * unit_point[d];
+            if (deviation.norm_square() > 1e-24 * size_sqr)
+              return false;
+          }
+
+        return true;
+      }
+
+
+
+      /**
+       * Fill all data that fill_fe_values() computes for an affine cell with
+       * the constant Jacobian @p jacobian. Since all derivatives of the
+       * Jacobian vanish on such a cell, the respective fields are set to
+       * zero. This function is only used for dim==spacedim.
+       */
+      template <int dim, int spacedim>
+      void
+      fill_affine_cell_data (const typename dealii::Triangulation<dim,spacedim>::cell_iterator &cell,
+                             const DerivativeForm<1,dim,spacedim>                             &jacobian,
+                             const Quadrature<dim>                                            &quadrature,
+                             const typename dealii::MappingQGeneric<dim,spacedim>::InternalData &data,
+                             internal::FEValues::MappingRelatedData<dim,spacedim>             &output_data)
+      {
+        const UpdateFlags update_flags = data.update_each;
+        const unsigned int n_q_points = quadrature.size();
+        const Point<spacedim> &origin = data.mapping_support_points[0];
+
+        if (update_flags & update_quadrature_points)
+          {
+            AssertDimension (output_data.quadrature_points.size(), n_q_points);
+            for (unsigned int point=0; point<n_q_points; ++point)
+              {
+                Point<spacedim> q_point = origin;
+                for (unsigned int e=0; e<spacedim; ++e)
+                  for (unsigned int d=0; d<dim; ++d)
+                    q_point[e] += jacobian[e][d] * quadrature.point(point)[d];
+                output_data.quadrature_points[point] = q_point;
+              }
+          }
+
+        if (update_flags & update_contravariant_transformation)
+          std::fill (data.contravariant.begin(), data.contravariant.end(), jacobian);
+
+        if (update_flags & update_covariant_transformation)
+          std::fill (data.covariant.begin(), data.covariant.end(),
+                     jacobian.covariant_form());
+
+        if (update_flags & update_volume_elements)
+          std::fill (data.volume_elements.begin(), data.volume_elements.end(),
+                     jacobian.determinant());
+
+        if (update_flags & (update_normal_vectors | update_JxW_values))
+          {
+            AssertDimension (output_data.JxW_values.size(), n_q_points);
+            const double det = jacobian.determinant();
+            Assert (det > 1e-12*Utilities::fixed_power<dim>(cell->diameter()/
+                                                            std::sqrt(double(dim))),
+                    (typename Mapping<dim,spacedim>::ExcDistortedMappedCell(cell->center(), det, 0)));
+            (void)cell;
+
+            const std::vector<double> &weights = quadrature.get_weights();
+            for (unsigned int point=0; point<n_q_points; ++point)
+              output_data.JxW_values[point] = weights[point] * det;
+          }
+
+        if (update_flags & update_jacobians)
+          {
+            AssertDimension (output_data.jacobians.size(), n_q_points);
+            std::fill (output_data.jacobians.begin(), output_data.jacobians.end(),
+                       jacobian);
+          }
+
+        if (update_flags & update_inverse_jacobians)
+          {
+            AssertDimension (output_data.inverse_jacobians.size(), n_q_points);
+            std::fill (output_data.inverse_jacobians.begin(),
+                       output_data.inverse_jacobians.end(),
+                       jacobian.covariant_form().transpose());
+          }
+
+        if (update_flags & update_jacobian_grads)
+          std::fill (output_data.jacobian_grads.begin(),
+                     output_data.jacobian_grads.end(),
+                     DerivativeForm<2,dim,spacedim>());
+
+        if (update_flags & update_jacobian_pushed_forward_grads)
+          std::fill (output_data.jacobian_pushed_forward_grads.begin(),
+                     output_data.jacobian_pushed_forward_grads.end(),
+                     Tensor<3,spacedim>());
+
+        if (update_flags & update_jacobian_2nd_derivatives)
+          std::fill (output_data.jacobian_2nd_derivatives.begin(),
+                     output_data.jacobian_2nd_derivatives.end(),
+                     DerivativeForm<3,dim,spacedim>());
+
+        if (update_flags & update_jacobian_pushed_forward_2nd_derivatives)
+          std::fill (output_data.jacobian_pushed_forward_2nd_derivatives.begin(),
+                     output_data.jacobian_pushed_forward_2nd_derivatives.end(),
+                     Tensor<4,spacedim>());
+
+        if (update_flags & update_jacobian_3rd_derivatives)
+          std::fill (output_data.jacobian_3rd_derivatives.begin(),
+                     output_data.jacobian_3rd_derivatives.end(),
+                     DerivativeForm<4,dim,spacedim>());
+
+        if (update_flags & update_jacobian_pushed_forward_3rd_derivatives)
+          std::fill (output_data.jacobian_pushed_forward_3rd_derivatives.begin(),
+                     output_data.jacobian_pushed_forward_3rd_derivatives.end(),
+                     Tensor<5,spacedim>());
+      }
+    }
+  }
+}
+
+
+
 template <int dim, int spacedim>
 CellSimilarity::Similarity
 MappingQGeneric<dim,spacedim>::
@@ -2803,6 +3195,21 @@ fill_fe_values (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
   const CellSimilarity::Similarity computed_cell_similarity =
     (polynomial_degree == 1 ? cell_similarity : CellSimilarity::none);
 
+  // cells that are an affine image of the reference cell have a constant
+  // Jacobian, so we can skip the evaluation of the polynomial mapping in
+  // each quadrature point. this is the case for most cells of meshes that
+  // are only curved near the boundary
+  if (dim == spacedim)
+    {
+      DerivativeForm<1,dim,spacedim> jacobian;
+      if (internal::MappingQGeneric::is_affine_cell<dim,spacedim>(data, jacobian))
+        {
+          internal::MappingQGeneric::fill_affine_cell_data<dim,spacedim>
+          (cell, jacobian, quadrature, data, output_data);
+          return computed_cell_similarity;
+        }
+    }
+
   if (dim>1 && data.tensor_product_quadrature)
     {
       internal::MappingQGeneric::maybe_update_q_points_Jacobians_and_grads_tensor<dim, spacedim>
@@ -27,7 +27,10 @@
 
 #include <iostream>
 #include <cmath>
+#include <cstdint>
+#include <functional>
 #include <limits>
+#include <numeric>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -1276,6 +1279,145 @@ namespace GridGenerator
 
 
 
+  template <int dim, int spacedim>
+  void
+  subdivided_hyper_rectangle_block (Triangulation<dim,spacedim>     &tria,
+                                    const std::vector<unsigned int> &repetitions,
+                                    const std::vector<unsigned int> &n_blocks,
+                                    const unsigned int               block,
+                                    const Point<dim>                &p_1,
+                                    const Point<dim>                &p_2,
+                                    const bool                       colorize,
+                                    const unsigned int               n_ghost_layers)
+  {
+    Assert(repetitions.size() == dim,
+           ExcInvalidRepetitionsDimension(dim));
+    AssertDimension (n_blocks.size(), dim);
+
+    Point<spacedim> p1, p2;
+    for (unsigned int i=0; i<dim; ++i)
+      {
+        p1(i) = std::min(p_1(i), p_2(i));
+        p2(i) = std::max(p_1(i), p_2(i));
+      }
+
+    // find the position of the block in the lexicographic numbering of the
+    // blocks and the range of cells (including the ghost layers) it covers
+    // in each direction. block j in a direction with n cells and b blocks
+    // starts at cell floor(j*n/b)
+    std::vector<Point<spacedim> > delta(dim);
+    unsigned int first_cell[3], n_cells[3];
+    unsigned int remaining_block = block;
+    for (unsigned int i=0; i<dim; ++i)
+      {
+        Assert (repetitions[i] >= 1, ExcInvalidRepetitions(repetitions[i]));
+        Assert (n_blocks[i] >= 1 && n_blocks[i] <= repetitions[i],
+                ExcMessage("The number of blocks in each direction must be "
+                           "between one and the number of cells."));
+
+        delta[i][i] = (p2[i]-p1[i])/repetitions[i];
+        Assert(delta[i][i]>0.0,
+               ExcMessage("The first dim entries of coordinates of p1 and p2 need to be different."));
+
+        const unsigned int block_index = remaining_block % n_blocks[i];
+        remaining_block /= n_blocks[i];
+        const unsigned int begin = static_cast<std::uint64_t>(block_index) *
+                                   repetitions[i] / n_blocks[i];
+        const unsigned int end = static_cast<std::uint64_t>(block_index+1) *
+                                 repetitions[i] / n_blocks[i];
+        first_cell[i] = begin - std::min(begin, n_ghost_layers);
+        n_cells[i] = std::min(end + n_ghost_layers, repetitions[i]) - first_cell[i];
+      }
+    Assert (remaining_block == 0,
+            ExcIndexRange(block, 0, std::accumulate(n_blocks.begin(), n_blocks.end(),
+                                                    1U, std::multiplies<unsigned int>())));
+    for (unsigned int i=dim; i<3; ++i)
+      {
+        first_cell[i] = 0;
+        n_cells[i] = 1;
+      }
+
+    // generate the points of the local box with the same formula as
+    // subdivided_hyper_rectangle, so that the coordinates match exactly
+    std::vector<Point<spacedim> > points;
+    points.reserve ((n_cells[0]+1)*(dim>1 ? n_cells[1]+1 : 1)*
+                    (dim>2 ? n_cells[2]+1 : 1));
+    for (unsigned int z=first_cell[2]; z<=first_cell[2]+(dim>2 ? n_cells[2] : 0); ++z)
+      for (unsigned int y=first_cell[1]; y<=first_cell[1]+(dim>1 ? n_cells[1] : 0); ++y)
+        for (unsigned int x=first_cell[0]; x<=first_cell[0]+n_cells[0]; ++x)
+          {
+            Point<spacedim> point = p1+(double)x*delta[0];
+            if (dim > 1)
+              point += (double)y*delta[1];
+            if (dim > 2)
+              point += (double)z*delta[2];
+            points.push_back (point);
+          }
+
+    // next create the cells in the lexicographic numbering of the local box
+    const unsigned int n_x  = n_cells[0]+1;
+    const unsigned int n_xy = (n_cells[0]+1)*(n_cells[1]+1);
+    std::vector<CellData<dim> > cells (n_cells[0]*n_cells[1]*n_cells[2]);
+    unsigned int c = 0;
+    for (unsigned int z=0; z<n_cells[2]; ++z)
+      for (unsigned int y=0; y<n_cells[1]; ++y)
+        for (unsigned int x=0; x<n_cells[0]; ++x, ++c)
+          {
+            const unsigned int v = (dim>2 ? z*n_xy : 0) + (dim>1 ? y*n_x : 0) + x;
+            for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
+              cells[c].vertices[i] = v + (i%2) + (dim>1 ? ((i/2)%2)*n_x : 0) +
+                                     (dim>2 ? (i/4)*n_xy : 0);
+            cells[c].material_id = 0;
+          }
+
+    tria.create_triangulation (points, cells, SubCellData());
+
+    // compute the position of each cell in the global mesh from its center,
+    // which gives the block it belongs to and whether its faces are at the
+    // boundary of the global rectangle
+    for (typename Triangulation<dim,spacedim>::active_cell_iterator
+         cell = tria.begin_active(); cell != tria.end(); ++cell)
+      {
+        const Point<spacedim> center = cell->center();
+        unsigned int owner = 0, stride = 1;
+        for (unsigned int i=0; i<dim; ++i)
+          {
+            const unsigned int index =
+              std::min(static_cast<unsigned int>((center[i]-p1[i])/delta[i][i]),
+                       repetitions[i]-1);
+            owner += stride * static_cast<unsigned int>
+                     ((static_cast<std::uint64_t>(index+1)*n_blocks[i]-1) /
+                      repetitions[i]);
+            stride *= n_blocks[i];
+
+            // faces at the boundary of the global rectangle get the same
+            // boundary ids as in subdivided_hyper_rectangle, the ones at the
+            // artificial boundary of the block get zero
+            for (unsigned int f=2*i; f<2*i+2; ++f)
+              if (cell->face(f)->at_boundary())
+                {
+                  const bool at_global_boundary =
+                    (f == 2*i) ? (index == 0) : (index == repetitions[i]-1);
+                  cell->face(f)->set_boundary_id ((at_global_boundary &&
+                                                   (colorize || dim == 1)) ?
+                                                  f : 0);
+                }
+          }
+        cell->set_subdomain_id (owner);
+
+        if (colorize)
+          {
+            types::material_id id = 0;
+            for (unsigned int d=0; d<dim; ++d)
+              if (center(d) > 0)
+                id += (1 << d);
+            cell->set_material_id(id);
+          }
+      }
+  }
+
+
+
   template <int dim>
   void
   subdivided_hyper_rectangle(
@@ -90,10 +90,20 @@ namespace
 
 template <int dim, int spacedim>
 GridIn<dim, spacedim>::GridIn () :
-  tria(nullptr, typeid(*this).name()), default_format(ucd)
+  tria(nullptr, typeid(*this).name()),
+  default_format(ucd),
+  reorder_cells(true)
 {}
 
 
+
+template <int dim, int spacedim>
+void GridIn<dim, spacedim>::set_reorder_cells (const bool reorder)
+{
+  reorder_cells = reorder;
+}
+
+
 template <int dim, int spacedim>
 void GridIn<dim, spacedim>::attach_triangulation (Triangulation<dim, spacedim> &t)
 {
@@ -375,7 +385,8 @@ void GridIn<dim, spacedim>::read_vtk(std::istream &in)
         GridReordering<dim, spacedim>::invert_all_cells_of_negative_grid(vertices,
             cells);
 
-      GridReordering<dim, spacedim>::reorder_cells(cells);
+      if (reorder_cells)
+        GridReordering<dim, spacedim>::reorder_cells(cells);
       tria->create_triangulation_compatibility(vertices,
                                                cells,
                                                subcelldata);
@@ -616,7 +627,8 @@ void GridIn<dim, spacedim>::read_unv(std::istream &in)
     GridReordering<dim, spacedim>::invert_all_cells_of_negative_grid(vertices,
         cells);
 
-  GridReordering<dim, spacedim>::reorder_cells(cells);
+  if (reorder_cells)
+    GridReordering<dim, spacedim>::reorder_cells(cells);
 
   tria->create_triangulation_compatibility(vertices,
                                            cells,
@@ -827,7 +839,8 @@ void GridIn<dim, spacedim>::read_ucd (std::istream                            &i
   // ... and cells
   if (dim==spacedim)
     GridReordering<dim,spacedim>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<dim,spacedim>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<dim,spacedim>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 }
 
@@ -1064,7 +1077,8 @@ void GridIn<dim, spacedim>::read_dbmesh (std::istream &in)
   GridTools::delete_unused_vertices (vertices, cells, subcelldata);
   // ...and cells
   GridReordering<dim,spacedim>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<dim,spacedim>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<dim,spacedim>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 }
 
@@ -1143,7 +1157,8 @@ void GridIn<2>::read_xda (std::istream &in)
   GridTools::delete_unused_vertices (vertices, cells, subcelldata);
   // ... and cells
   GridReordering<2>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<2>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<2>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 }
 
@@ -1221,7 +1236,8 @@ void GridIn<3>::read_xda (std::istream &in)
   GridTools::delete_unused_vertices (vertices, cells, subcelldata);
   // ... and cells
   GridReordering<3>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<3>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<3>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 }
 
@@ -1250,6 +1266,22 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   else
     AssertThrow (false, ExcInvalidGMSHInput(line));
 
+  // whether the nodes and elements are stored in binary form, which is
+  // possible from file format 2 on
+  bool binary = false;
+
+  // in binary files, the data follows directly after the end of the line
+  // that contains the header information. skip exactly this line ending,
+  // since the binary data might start with a byte that looks like
+  // whitespace
+  const auto skip_line_ending = [&in]()
+  {
+    char c = in.get();
+    if (c == '\r')
+      c = in.get();
+    AssertThrow (c == '\n', ExcInvalidGMSHInput(std::string(1,c)));
+  };
+
   // if file format is 2 or greater
   // then we also have to read the
   // rest of the header
@@ -1262,8 +1294,23 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
 
       Assert ( (version >= 2.0) &&
                (version <= 2.2), ExcNotImplemented());
-      Assert (file_type == 0, ExcNotImplemented());
-      Assert (data_size == sizeof(double), ExcNotImplemented());
+      AssertThrow (file_type == 0 || file_type == 1, ExcNotImplemented());
+      AssertThrow (data_size == sizeof(double), ExcNotImplemented());
+
+      if (file_type == 1)
+        {
+          // binary files contain the integer one after the header to detect
+          // the byte order. we only support files written on machines with
+          // the same byte order as the present one
+          binary = true;
+          skip_line_ending();
+          int one = 0;
+          in.read (reinterpret_cast<char *>(&one), sizeof(int));
+          AssertThrow (one == 1,
+                       ExcMessage("The binary gmsh file has been written on "
+                                  "a machine with a different byte order, "
+                                  "which is not supported."));
+        }
 
       // read the end of the header
       // and the first line of the
@@ -1297,25 +1344,76 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   // now read the nodes list
   in >> n_vertices;
   std::vector<Point<spacedim> >     vertices (n_vertices);
-  // set up mapping between numbering
-  // in msh-file (nod) and in the
-  // vertices vector
-  std::map<int,int> vertex_indices;
+  std::vector<int>                  vertex_numbers (n_vertices);
 
+  if (binary)
+    skip_line_ending();
   for (unsigned int vertex=0; vertex<n_vertices; ++vertex)
     {
       int vertex_number;
       double x[3];
 
       // read vertex
-      in >> vertex_number
-         >> x[0] >> x[1] >> x[2];
+      if (binary)
+        {
+          in.read (reinterpret_cast<char *>(&vertex_number), sizeof(int));
+          in.read (reinterpret_cast<char *>(&x[0]), 3*sizeof(double));
+        }
+      else
+        in >> vertex_number
+           >> x[0] >> x[1] >> x[2];
 
       for (unsigned int d=0; d<spacedim; ++d)
         vertices[vertex](d) = x[d];
-      // store mapping
-      vertex_indices[vertex_number] = vertex;
+      vertex_numbers[vertex] = vertex_number;
     }
+  AssertThrow (in, ExcIO());
+
+  // set up mapping between numbering in msh-file (nod) and in the vertices
+  // vector. gmsh usually numbers the nodes consecutively, in which case a
+  // plain vector is used for the lookup, which is much faster and needs much
+  // less memory than a map for large meshes
+  std::vector<unsigned int>         dense_vertex_indices;
+  std::map<int,unsigned int>        vertex_indices;
+  {
+    int min_vertex_number = 0, max_vertex_number = 0;
+    if (n_vertices > 0)
+      {
+        min_vertex_number = *std::min_element(vertex_numbers.begin(),
+                                              vertex_numbers.end());
+        max_vertex_number = *std::max_element(vertex_numbers.begin(),
+                                              vertex_numbers.end());
+      }
+    if (min_vertex_number >= 0 &&
+        static_cast<std::size_t>(max_vertex_number) < 2*static_cast<std::size_t>(n_vertices) + 1000)
+      {
+        dense_vertex_indices.resize (max_vertex_number+1,
+                                     numbers::invalid_unsigned_int);
+        for (unsigned int vertex=0; vertex<n_vertices; ++vertex)
+          dense_vertex_indices[vertex_numbers[vertex]] = vertex;
+      }
+    else
+      for (unsigned int vertex=0; vertex<n_vertices; ++vertex)
+        vertex_indices[vertex_numbers[vertex]] = vertex;
+    std::vector<int>().swap(vertex_numbers);
+  }
+
+  // return the index in the vertices vector of a node number from the file,
+  // or an invalid index if the node does not exist
+  const auto find_vertex = [&](const int vertex_number) -> unsigned int
+  {
+    if (dense_vertex_indices.size() > 0 || vertex_indices.empty())
+      return ((vertex_number >= 0 &&
+               static_cast<std::size_t>(vertex_number) < dense_vertex_indices.size()) ?
+              dense_vertex_indices[vertex_number] :
+              numbers::invalid_unsigned_int);
+    else
+      {
+        const auto it = vertex_indices.find(vertex_number);
+        return (it != vertex_indices.end() ? it->second :
+                numbers::invalid_unsigned_int);
+      }
+  };
 
   // Assert we reached the end of the block
   in >> line;
@@ -1338,239 +1436,285 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   SubCellData                                subcelldata;
   std::map<unsigned int, types::boundary_id> boundary_ids_1d;
 
-  for (unsigned int cell=0; cell<n_cells; ++cell)
-    {
-      // note that since in the input
-      // file we found the number of
-      // cells at the top, there
-      // should still be input here,
-      // so check this:
-      AssertThrow (in, ExcIO());
-
-      unsigned int cell_type;
-      unsigned int material_id;
-      unsigned int nod_num;
-
-      /*
-        For file format version 1, the format of each cell is as follows:
-          elm-number elm-type reg-phys reg-elem number-of-nodes node-number-list
-
-        However, for version 2, the format reads like this:
-          elm-number elm-type number-of-tags < tag > ... node-number-list
+  /*       `ELM-TYPE'
+           defines the geometrical type of the N-th element:
+           `1'
+           Line (2 nodes, 1 edge).
 
-        In the following, we will ignore the element number (we simply enumerate
-        them in the order in which we read them, and we will take reg-phys
-        (version 1) or the first tag (version 2, if any tag is given at all) as
-        material id.
-      */
+           `3'
+           Quadrangle (4 nodes, 4 edges).
 
-      unsigned int elm_number;
-      in >> elm_number     // ELM-NUMBER
-         >> cell_type;     // ELM-TYPE
+           `5'
+           Hexahedron (8 nodes, 12 edges, 6 faces).
 
-      switch (gmsh_file_format)
-        {
-        case 1:
-        {
-          in >> material_id  // REG-PHYS
-             >> dummy        // reg_elm
-             >> nod_num;
-          break;
-        }
+           `15'
+           Point (1 node).
 
-        case 2:
-        {
-          // read the tags; ignore all but the first one which we will
-          // interpret as the material_id (for cells) or boundary_id
-          // (for faces)
-          unsigned int n_tags;
-          in >> n_tags;
-          if (n_tags > 0)
-            in >> material_id;
-          else
-            material_id = 0;
-
-          for (unsigned int i=1; i<n_tags; ++i)
-            in >> dummy;
-
-          nod_num = GeometryInfo<dim>::vertices_per_cell;
-
-          break;
-        }
+     Return zero for all other types, which we do not support.
+  */
+  const auto n_nodes_of_element_type = [](const unsigned int cell_type) -> unsigned int
+  {
+    switch (cell_type)
+      {
+      case 1:
+        return 2;
+      case 3:
+        return 4;
+      case 5:
+        return 8;
+      case 15:
+        return 1;
+      default:
+        return 0;
+      }
+  };
 
-        default:
-          AssertThrow (false, ExcNotImplemented());
-        }
+  // add the element with number @p elm_number (which we only use for error
+  // messages, since we enumerate the cells in the order in which we read
+  // them), given type and node numbers to the list of cells or
+  // subcells
+  const auto add_element = [&](const unsigned int   cell,
+                               const unsigned int   elm_number,
+                               const unsigned int   cell_type,
+                               const unsigned int   material_id,
+                               const std::vector<int> &nodes)
+  {
+    if (((cell_type == 1) && (dim == 1)) ||
+        ((cell_type == 3) && (dim == 2)) ||
+        ((cell_type == 5) && (dim == 3)))
+      // found a cell
+      {
+        AssertThrow (nodes.size() == GeometryInfo<dim>::vertices_per_cell,
+                     ExcMessage ("Number of nodes does not coincide with the "
+                                 "number required for this object"));
 
+        cells.emplace_back ();
 
-      /*       `ELM-TYPE'
-               defines the geometrical type of the N-th element:
-               `1'
-               Line (2 nodes, 1 edge).
+        // to make sure that the cast wont fail
+        Assert(material_id<= std::numeric_limits<types::material_id>::max(),
+               ExcIndexRange(material_id,0,std::numeric_limits<types::material_id>::max()));
+        // we use only material_ids in the range from 0 to numbers::invalid_material_id-1
+        Assert(material_id < numbers::invalid_material_id,
+               ExcIndexRange(material_id,0,numbers::invalid_material_id));
 
-               `3'
-               Quadrangle (4 nodes, 4 edges).
+        cells.back().material_id = static_cast<types::material_id>(material_id);
 
-               `5'
-               Hexahedron (8 nodes, 12 edges, 6 faces).
+        // transform from ucd to
+        // consecutive numbering
+        for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
+          {
+            cells.back().vertices[i] = find_vertex(nodes[i]);
+            AssertThrow (cells.back().vertices[i] != numbers::invalid_unsigned_int,
+                         ExcInvalidVertexIndexGmsh(cell, elm_number,
+                                                   nodes[i]));
+          }
+      }
+    else if ((cell_type == 1) && ((dim == 2) || (dim == 3)))
+      // boundary info
+      {
+        AssertThrow (nodes.size() == 2,
+                     ExcMessage ("Number of nodes does not coincide with the "
+                                 "number required for this object"));
+        subcelldata.boundary_lines.emplace_back ();
+
+        // to make sure that the cast wont fail
+        Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
+               ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
+        // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
+        Assert(material_id < numbers::internal_face_boundary_id,
+               ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
+
+        subcelldata.boundary_lines.back().boundary_id
+          = static_cast<types::boundary_id>(material_id);
+
+        // transform from ucd to
+        // consecutive numbering
+        for (unsigned int i=0; i<2; ++i)
+          {
+            subcelldata.boundary_lines.back().vertices[i] = find_vertex(nodes[i]);
+            // no such vertex index
+            AssertThrow (subcelldata.boundary_lines.back().vertices[i] !=
+                         numbers::invalid_unsigned_int,
+                         ExcInvalidVertexIndex(cell, nodes[i]));
+          }
+      }
+    else if ((cell_type == 3) && (dim == 3))
+      // boundary info
+      {
+        AssertThrow (nodes.size() == 4,
+                     ExcMessage ("Number of nodes does not coincide with the "
+                                 "number required for this object"));
+        subcelldata.boundary_quads.emplace_back ();
+
+        // to make sure that the cast wont fail
+        Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
+               ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
+        // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
+        Assert(material_id < numbers::internal_face_boundary_id,
+               ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
+
+        subcelldata.boundary_quads.back().boundary_id
+          = static_cast<types::boundary_id>(material_id);
+
+        // transform from gmsh to
+        // consecutive numbering
+        for (unsigned int i=0; i<4; ++i)
+          {
+            subcelldata.boundary_quads.back().vertices[i] = find_vertex(nodes[i]);
+            // no such vertex index
+            Assert (subcelldata.boundary_quads.back().vertices[i] !=
+                    numbers::invalid_unsigned_int,
+                    ExcInvalidVertexIndex(cell, nodes[i]));
+          }
+      }
+    else if (cell_type == 15)
+      {
+        // we only care about boundary indicators assigned to individual
+        // vertices in 1d (because otherwise the vertices are not faces)
+        if (dim == 1)
+          boundary_ids_1d[find_vertex(nodes[0])] = material_id;
+      }
+    else
+      // cannot read this, so throw
+      // an exception. treat
+      // triangles and tetrahedra
+      // specially since this
+      // deserves a more explicit
+      // error message
+      {
+        AssertThrow (cell_type != 2,
+                     ExcMessage("Found triangles while reading a file "
+                                "in gmsh format. deal.II does not "
+                                "support triangles"));
+        AssertThrow (cell_type != 11,
+                     ExcMessage("Found tetrahedra while reading a file "
+                                "in gmsh format. deal.II does not "
+                                "support tetrahedra"));
+
+        AssertThrow (false, ExcGmshUnsupportedGeometry(cell_type));
+      }
+  };
 
-               `15'
-               Point (1 node).
+  std::vector<int> nodes;
+  if (binary)
+    {
+      /*
+        In binary files, the elements are given in blocks of elements of the
+        same type with the same number of tags. Each block starts with a
+        header consisting of three integers
+          elm-type number-of-elements-in-block number-of-tags
+        followed by the data of each element
+          elm-number < tag > ... node-number-list
+        Like for the ascii format, we take the first tag as material id.
       */
-
-      if (((cell_type == 1) && (dim == 1)) ||
-          ((cell_type == 3) && (dim == 2)) ||
-          ((cell_type == 5) && (dim == 3)))
-        // found a cell
+      skip_line_ending();
+      std::vector<int> element_data;
+      unsigned int cell = 0;
+      while (cell < n_cells)
         {
-          AssertThrow (nod_num == GeometryInfo<dim>::vertices_per_cell,
-                       ExcMessage ("Number of nodes does not coincide with the "
-                                   "number required for this object"));
-
-          // allocate and read indices
-          cells.emplace_back ();
-          for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
-            in >> cells.back().vertices[i];
-
-          // to make sure that the cast wont fail
-          Assert(material_id<= std::numeric_limits<types::material_id>::max(),
-                 ExcIndexRange(material_id,0,std::numeric_limits<types::material_id>::max()));
-          // we use only material_ids in the range from 0 to numbers::invalid_material_id-1
-          Assert(material_id < numbers::invalid_material_id,
-                 ExcIndexRange(material_id,0,numbers::invalid_material_id));
-
-          cells.back().material_id = static_cast<types::material_id>(material_id);
-
-          // transform from ucd to
-          // consecutive numbering
-          for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
+          int header[3];
+          in.read (reinterpret_cast<char *>(&header[0]), 3*sizeof(int));
+          AssertThrow (in, ExcIO());
+          AssertThrow (header[1] >= 0 && header[2] >= 0 &&
+                       cell + header[1] <= n_cells,
+                       ExcInvalidGMSHInput("binary element block"));
+
+          const unsigned int cell_type = header[0];
+          const unsigned int n_tags = header[2];
+          const unsigned int n_nodes = n_nodes_of_element_type(cell_type);
+          if (n_nodes == 0)
+            // throws the appropriate exception
+            add_element(cell, 0, cell_type, 0, nodes);
+
+          nodes.resize(n_nodes);
+          element_data.resize(1 + n_tags + n_nodes);
+          for (int e=0; e<header[1]; ++e, ++cell)
             {
-              AssertThrow (vertex_indices.find (cells.back().vertices[i]) !=
-                           vertex_indices.end(),
-                           ExcInvalidVertexIndexGmsh(cell, elm_number,
-                                                     cells.back().vertices[i]));
-
-              // vertex with this index exists
-              cells.back().vertices[i] = vertex_indices[cells.back().vertices[i]];
+              in.read (reinterpret_cast<char *>(element_data.data()),
+                       element_data.size()*sizeof(int));
+              AssertThrow (in, ExcIO());
+              std::copy(element_data.begin()+1+n_tags, element_data.end(),
+                        nodes.begin());
+              add_element(cell, element_data[0], cell_type,
+                          n_tags > 0 ? element_data[1] : 0, nodes);
             }
         }
-      else if ((cell_type == 1) && ((dim == 2) || (dim == 3)))
-        // boundary info
-        {
-          subcelldata.boundary_lines.emplace_back ();
-          in >> subcelldata.boundary_lines.back().vertices[0]
-             >> subcelldata.boundary_lines.back().vertices[1];
-
-          // to make sure that the cast wont fail
-          Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
-                 ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
-          // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
-          Assert(material_id < numbers::internal_face_boundary_id,
-                 ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
-
-          subcelldata.boundary_lines.back().boundary_id
-            = static_cast<types::boundary_id>(material_id);
+    }
+  else
+    for (unsigned int cell=0; cell<n_cells; ++cell)
+      {
+        // note that since in the input
+        // file we found the number of
+        // cells at the top, there
+        // should still be input here,
+        // so check this:
+        AssertThrow (in, ExcIO());
+
+        unsigned int cell_type;
+        unsigned int material_id;
+        unsigned int nod_num;
+
+        /*
+          For file format version 1, the format of each cell is as follows:
+            elm-number elm-type reg-phys reg-elem number-of-nodes node-number-list
+
+          However, for version 2, the format reads like this:
+            elm-number elm-type number-of-tags < tag > ... node-number-list
+
+          In the following, we will ignore the element number (we simply enumerate
+          them in the order in which we read them, and we will take reg-phys
+          (version 1) or the first tag (version 2, if any tag is given at all) as
+          material id.
+        */
+
+        unsigned int elm_number;
+        in >> elm_number     // ELM-NUMBER
+           >> cell_type;     // ELM-TYPE
+
+        switch (gmsh_file_format)
+          {
+          case 1:
+          {
+            in >> material_id  // REG-PHYS
+               >> dummy        // reg_elm
+               >> nod_num;
+            break;
+          }
 
-          // transform from ucd to
-          // consecutive numbering
-          for (unsigned int i=0; i<2; ++i)
-            if (vertex_indices.find (subcelldata.boundary_lines.back().vertices[i]) !=
-                vertex_indices.end())
-              // vertex with this index exists
-              subcelldata.boundary_lines.back().vertices[i]
-                = vertex_indices[subcelldata.boundary_lines.back().vertices[i]];
+          case 2:
+          {
+            // read the tags; ignore all but the first one which we will
+            // interpret as the material_id (for cells) or boundary_id
+            // (for faces)
+            unsigned int n_tags;
+            in >> n_tags;
+            if (n_tags > 0)
+              in >> material_id;
             else
-              {
-                // no such vertex index
-                AssertThrow (false,
-                             ExcInvalidVertexIndex(cell,
-                                                   subcelldata.boundary_lines.back().vertices[i]));
-                subcelldata.boundary_lines.back().vertices[i] =
-                  numbers::invalid_unsigned_int;
-              };
-        }
-      else if ((cell_type == 3) && (dim == 3))
-        // boundary info
-        {
-          subcelldata.boundary_quads.emplace_back ();
-          in >> subcelldata.boundary_quads.back().vertices[0]
-             >> subcelldata.boundary_quads.back().vertices[1]
-             >> subcelldata.boundary_quads.back().vertices[2]
-             >> subcelldata.boundary_quads.back().vertices[3];
+              material_id = 0;
 
-          // to make sure that the cast wont fail
-          Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
-                 ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
-          // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
-          Assert(material_id < numbers::internal_face_boundary_id,
-                 ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
+            for (unsigned int i=1; i<n_tags; ++i)
+              in >> dummy;
 
-          subcelldata.boundary_quads.back().boundary_id
-            = static_cast<types::boundary_id>(material_id);
+            nod_num = n_nodes_of_element_type(cell_type);
+            if (nod_num == 0)
+              // throws the appropriate exception
+              add_element(cell, elm_number, cell_type, material_id, nodes);
 
-          // transform from gmsh to
-          // consecutive numbering
-          for (unsigned int i=0; i<4; ++i)
-            if (vertex_indices.find (subcelldata.boundary_quads.back().vertices[i]) !=
-                vertex_indices.end())
-              // vertex with this index exists
-              subcelldata.boundary_quads.back().vertices[i]
-                = vertex_indices[subcelldata.boundary_quads.back().vertices[i]];
-            else
-              {
-                // no such vertex index
-                Assert (false,
-                        ExcInvalidVertexIndex(cell,
-                                              subcelldata.boundary_quads.back().vertices[i]));
-                subcelldata.boundary_quads.back().vertices[i] =
-                  numbers::invalid_unsigned_int;
-              }
+            break;
+          }
 
-        }
-      else if (cell_type == 15)
-        {
-          // read the indices of nodes given
-          unsigned int node_index;
-          switch (gmsh_file_format)
-            {
-            case 1:
-            {
-              for (unsigned int i=0; i<nod_num; ++i)
-                in >> node_index;
-              break;
-            }
-            case 2:
-            {
-              in >> node_index;
-              break;
-            }
-            }
+          default:
+            AssertThrow (false, ExcNotImplemented());
+          }
 
-          // we only care about boundary indicators assigned to individual
-          // vertices in 1d (because otherwise the vertices are not faces)
-          if (dim == 1)
-            boundary_ids_1d[vertex_indices[node_index]] = material_id;
-        }
-      else
-        // cannot read this, so throw
-        // an exception. treat
-        // triangles and tetrahedra
-        // specially since this
-        // deserves a more explicit
-        // error message
-        {
-          AssertThrow (cell_type != 2,
-                       ExcMessage("Found triangles while reading a file "
-                                  "in gmsh format. deal.II does not "
-                                  "support triangles"));
-          AssertThrow (cell_type != 11,
-                       ExcMessage("Found tetrahedra while reading a file "
-                                  "in gmsh format. deal.II does not "
-                                  "support tetrahedra"));
-
-          AssertThrow (false, ExcGmshUnsupportedGeometry(cell_type));
-        }
-    }
+        // read the indices of nodes given
+        nodes.resize(nod_num);
+        for (unsigned int i=0; i<nod_num; ++i)
+          in >> nodes[i];
+
+        add_element(cell, elm_number, cell_type, material_id, nodes);
+      }
 
   // Assert we reached the end of the block
   in >> line;
@@ -1587,13 +1731,19 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   // cells.
   AssertThrow(cells.size() > 0, ExcGmshNoCellInformation());
 
+  // release the memory of the vertex lookup before creating the
+  // triangulation
+  std::vector<unsigned int>().swap(dense_vertex_indices);
+  vertex_indices.clear();
+
   // do some clean-up on
   // vertices...
   GridTools::delete_unused_vertices (vertices, cells, subcelldata);
   // ... and cells
   if (dim==spacedim)
     GridReordering<dim,spacedim>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<dim,spacedim>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<dim,spacedim>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 
   // in 1d, we also have to attach boundary ids to vertices, which does not
@@ -1893,7 +2043,8 @@ void GridIn<2>::read_netcdf (const std::string &filename)
 
   SubCellData subcelldata;
   GridTools::delete_unused_vertices(vertices, cells, subcelldata);
-  GridReordering<dim,spacedim>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<dim,spacedim>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 #endif
 }
@@ -2103,7 +2254,8 @@ void GridIn<3>::read_netcdf (const std::string &filename)
 
   GridTools::delete_unused_vertices(vertices, cells, subcelldata);
   GridReordering<dim,spacedim>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<dim,spacedim>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<dim,spacedim>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 #endif
 }
@@ -2537,7 +2689,8 @@ void GridIn<2>::read_tecplot (std::istream &in)
 
   // do some cleanup on cells
   GridReordering<dim,spacedim>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<dim,spacedim>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<dim,spacedim>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 }
 
@@ -2688,7 +2841,8 @@ void GridIn<dim, spacedim>::read_assimp(const std::string &filename,
     GridReordering<dim, spacedim>::invert_all_cells_of_negative_grid
     (vertices,cells);
 
-  GridReordering<dim, spacedim>::reorder_cells(cells);
+  if (reorder_cells)
+    GridReordering<dim, spacedim>::reorder_cells(cells);
   if (dim == 2)
     tria->create_triangulation_compatibility(vertices, cells, subcelldata);
   else
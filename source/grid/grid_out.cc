@@ -20,11 +20,13 @@
 #include <deal.II/base/quadrature.h>
 #include <deal.II/base/qprojector.h>
 #include <deal.II/base/geometry_info.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/utilities.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_accessor.h>
 #include <deal.II/grid/tria_iterator.h>
 #include <deal.II/fe/mapping.h>
-#include <deal.II/numerics/data_out.h>
 
 #include <fstream>
 #include <cstring>
@@ -81,15 +83,18 @@ namespace GridOutFlags
 
 
   Msh::Msh (const bool write_faces,
-            const bool write_lines) :
+            const bool write_lines,
+            const bool binary) :
     write_faces (write_faces),
-    write_lines (write_lines)
+    write_lines (write_lines),
+    binary (binary)
   {}
 
   void Msh::declare_parameters (ParameterHandler &param)
   {
     param.declare_entry("Write faces", "false", Patterns::Bool());
     param.declare_entry("Write lines", "false", Patterns::Bool());
+    param.declare_entry("Binary", "false", Patterns::Bool());
   }
 
 
@@ -97,6 +102,7 @@ namespace GridOutFlags
   {
     write_faces = param.get_bool("Write faces");
     write_lines = param.get_bool("Write lines");
+    binary = param.get_bool("Binary");
   }
 
 
@@ -974,30 +980,85 @@ void GridOut::write_msh (const Triangulation<dim, spacedim> &tria,
   ...
   $ENDELM
   */
-  out << "$NOD" << '\n'
-      << n_vertices << '\n';
+  const unsigned int n_elements = tria.n_active_cells() + ((msh_flags.write_faces ?
+                                                            n_boundary_faces(tria) : 0) +
+                                                           (msh_flags.write_lines ?
+                                                            n_boundary_lines(tria) : 0));
+  if (msh_flags.binary)
+    {
+      /*
+        The binary files use version 2.2 of the format, where the header
+        line is followed by the integer one in binary form to identify the
+        byte order. The nodes and elements are written as blocks of binary
+        data directly after the line with their number:
+
+        $MeshFormat
+        2.2 1 8
+        <one>
+        $EndMeshFormat
+        $Nodes
+        number-of-nodes
+        <node-number x-coord y-coord z-coord> ...
+        $EndNodes
+        $Elements
+        number-of-elements
+        <elm-type number-of-elements-in-block number-of-tags>
+        <elm-number tag ... node-number-list> ...
+        $EndElements
+      */
+      const int one = 1;
+      out << "$MeshFormat" << '\n'
+          << "2.2 1 " << sizeof(double) << '\n';
+      out.write (reinterpret_cast<const char *>(&one), sizeof(int));
+      out << '\n' << "$EndMeshFormat" << '\n'
+          << "$Nodes" << '\n'
+          << n_vertices << '\n';
+
+      // collect all vertices in a buffer and write them at once
+      const unsigned int node_size = sizeof(int) + 3*sizeof(double);
+      std::vector<char> buffer (n_vertices * node_size);
+      char *node = buffer.data();
+      for (unsigned int i=0; i<vertices.size(); ++i)
+        if (vertex_used[i])
+          {
+            const int vertex_number = i+1;
+            double coordinates[3] = {0., 0., 0.};
+            for (unsigned int d=0; d<spacedim; ++d)
+              coordinates[d] = vertices[i][d];
+            std::memcpy (node, &vertex_number, sizeof(int));
+            std::memcpy (node+sizeof(int), coordinates, 3*sizeof(double));
+            node += node_size;
+          }
+      out.write (buffer.data(), buffer.size());
 
-  // actually write the vertices.
-  // note that we shall number them
-  // with first index 1 instead of 0
-  for (unsigned int i=0; i<vertices.size(); ++i)
-    if (vertex_used[i])
-      {
-        out << i+1                 // vertex index
-            << "  "
-            << vertices[i];
-        for (unsigned int d=spacedim+1; d<=3; ++d)
-          out << " 0";             // fill with zeroes
-        out << '\n';
-      }
+      out << '\n' << "$EndNodes" << '\n'
+          << "$Elements" << '\n'
+          << n_elements << '\n';
+    }
+  else
+    {
+      out << "$NOD" << '\n'
+          << n_vertices << '\n';
+
+      // actually write the vertices.
+      // note that we shall number them
+      // with first index 1 instead of 0
+      for (unsigned int i=0; i<vertices.size(); ++i)
+        if (vertex_used[i])
+          {
+            out << i+1                 // vertex index
+                << "  "
+                << vertices[i];
+            for (unsigned int d=spacedim+1; d<=3; ++d)
+              out << " 0";             // fill with zeroes
+            out << '\n';
+          }
 
-  // Write cells preamble
-  out << "$ENDNOD" << '\n'
-      << "$ELM" << '\n'
-      << tria.n_active_cells() + ((msh_flags.write_faces ?
-                                   n_boundary_faces(tria) : 0) +
-                                  (msh_flags.write_lines ?
-                                   n_boundary_lines(tria) : 0)) << '\n';
+      // Write cells preamble
+      out << "$ENDNOD" << '\n'
+          << "$ELM" << '\n'
+          << n_elements << '\n';
+    }
 
   /*
     elm-type
@@ -1051,20 +1112,44 @@ void GridOut::write_msh (const Triangulation<dim, spacedim> &tria,
 
   // write cells. Enumerate cells
   // consecutively, starting with 1
-  for (cell=tria.begin_active(); cell!=endc; ++cell)
+  if (msh_flags.binary)
     {
-      out << cell->active_cell_index()+1 << ' ' << elm_type << ' '
-          << static_cast<unsigned int>(cell->material_id()) << ' '
-          << cell->subdomain_id() << ' '
-          << GeometryInfo<dim>::vertices_per_cell << ' ';
+      // a single block with all cells, using the material id and the
+      // subdomain id as tags
+      const unsigned int cell_size = 3 + GeometryInfo<dim>::vertices_per_cell;
+      std::vector<int> buffer (3 + tria.n_active_cells() * cell_size);
+      buffer[0] = elm_type;
+      buffer[1] = tria.n_active_cells();
+      buffer[2] = 2;
+      for (cell=tria.begin_active(); cell!=endc; ++cell)
+        {
+          int *element = &buffer[3 + cell->active_cell_index() * cell_size];
+          element[0] = cell->active_cell_index()+1;
+          element[1] = cell->material_id();
+          element[2] = cell->subdomain_id();
+          for (unsigned int vertex=0; vertex<GeometryInfo<dim>::vertices_per_cell;
+               ++vertex)
+            element[3+vertex] = cell->vertex_index(GeometryInfo<dim>::ucd_to_deal[vertex])+1;
+        }
+      if (tria.n_active_cells() > 0)
+        out.write (reinterpret_cast<const char *>(buffer.data()),
+                   buffer.size()*sizeof(int));
+    }
+  else
+    for (cell=tria.begin_active(); cell!=endc; ++cell)
+      {
+        out << cell->active_cell_index()+1 << ' ' << elm_type << ' '
+            << static_cast<unsigned int>(cell->material_id()) << ' '
+            << cell->subdomain_id() << ' '
+            << GeometryInfo<dim>::vertices_per_cell << ' ';
 
-      // Vertex numbering follows UCD conventions.
+        // Vertex numbering follows UCD conventions.
 
-      for (unsigned int vertex=0; vertex<GeometryInfo<dim>::vertices_per_cell;
-           ++vertex)
-        out << cell->vertex_index(GeometryInfo<dim>::ucd_to_deal[vertex])+1 << ' ';
-      out << '\n';
-    }
+        for (unsigned int vertex=0; vertex<GeometryInfo<dim>::vertices_per_cell;
+             ++vertex)
+          out << cell->vertex_index(GeometryInfo<dim>::ucd_to_deal[vertex])+1 << ' ';
+        out << '\n';
+      }
 
   // write faces and lines with non-zero boundary indicator
   unsigned int next_element_index = tria.n_active_cells()+1;
@@ -1077,7 +1162,10 @@ void GridOut::write_msh (const Triangulation<dim, spacedim> &tria,
       next_element_index = write_msh_lines (tria, next_element_index, out);
     }
 
-  out << "$ENDELM\n";
+  if (msh_flags.binary)
+    out << '\n' << "$EndElements" << '\n';
+  else
+    out << "$ENDELM\n";
 
   // make sure everything now gets to
   // disk
@@ -2438,32 +2526,44 @@ namespace
    * This is made particularly simple because the patch only needs to
    * contain geometry info and additional properties of cells
    */
-  template <int dim, int spacedim, typename ITERATOR, typename END>
+  template <int dim, int spacedim>
   void
   generate_triangulation_patches (std::vector<DataOutBase::Patch<dim,spacedim> > &patches,
-                                  ITERATOR cell, END end)
+                                  const Triangulation<dim,spacedim>              &tria)
   {
-    // convert each of the active cells into a patch
-    for (; cell != end; ++cell)
-      {
-        DataOutBase::Patch<dim,spacedim> patch;
-        patch.n_subdivisions = 1;
-        patch.data.reinit (5,GeometryInfo<dim>::vertices_per_cell);
+    // collect the active cells first, such that the patches can be filled
+    // in place and in parallel rather than copying each of them into the
+    // vector
+    std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> cells;
+    cells.reserve (tria.n_active_cells());
+    for (typename Triangulation<dim,spacedim>::active_cell_iterator
+         cell=tria.begin_active(); cell!=tria.end(); ++cell)
+      cells.push_back (cell);
+
+    patches.resize (cells.size());
+    parallel::apply_to_subranges
+    (0U, static_cast<unsigned int>(cells.size()),
+     [&](const unsigned int begin, const unsigned int end)
+    {
+      for (unsigned int c=begin; c<end; ++c)
+        {
+          const typename Triangulation<dim,spacedim>::active_cell_iterator &cell = cells[c];
+          DataOutBase::Patch<dim,spacedim> &patch = patches[c];
+          patch.n_subdivisions = 1;
+          patch.data.reinit (5,GeometryInfo<dim>::vertices_per_cell);
 
-        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
-          {
-            patch.vertices[v] = cell->vertex(v);
-            patch.data(0,v) = cell->level();
-            patch.data(1,v) = static_cast<int>(cell->manifold_id());
-            patch.data(2,v) = cell->material_id();
-            if (!cell->has_children())
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            {
+              patch.vertices[v] = cell->vertex(v);
+              patch.data(0,v) = cell->level();
+              patch.data(1,v) = static_cast<int>(cell->manifold_id());
+              patch.data(2,v) = cell->material_id();
               patch.data(3,v) = static_cast<int>(cell->subdomain_id());
-            else
-              patch.data(3,v) = -1;
-            patch.data(4,v) = static_cast<int>(cell->level_subdomain_id());
-          }
-        patches.push_back (patch);
-      }
+              patch.data(4,v) = static_cast<int>(cell->level_subdomain_id());
+            }
+        }
+    },
+    1000);
   }
 
   std::vector<std::string> triangulation_patch_data_names ()
@@ -2491,8 +2591,7 @@ void GridOut::write_vtk (const Triangulation<dim,spacedim> &tria,
   // the geometry, we also do not have to provide any names, identifying
   // information, etc.
   std::vector<DataOutBase::Patch<dim,spacedim> > patches;
-  patches.reserve (tria.n_active_cells());
-  generate_triangulation_patches(patches, tria.begin_active(), tria.end());
+  generate_triangulation_patches(patches, tria);
   DataOutBase::write_vtk (patches,
                           triangulation_patch_data_names(),
                           std::vector<std::tuple<unsigned int, unsigned int, std::string> >(),
@@ -2515,8 +2614,7 @@ void GridOut::write_vtu (const Triangulation<dim,spacedim> &tria,
   // the geometry, we also do not have to provide any names, identifying
   // information, etc.
   std::vector<DataOutBase::Patch<dim,spacedim> > patches;
-  patches.reserve (tria.n_active_cells());
-  generate_triangulation_patches(patches, tria.begin_active(), tria.end());
+  generate_triangulation_patches(patches, tria);
   DataOutBase::write_vtu (patches,
                           triangulation_patch_data_names(),
                           std::vector<std::tuple<unsigned int, unsigned int, std::string> >(),
@@ -2544,6 +2642,7 @@ void GridOut::write_mesh_per_processor_as_vtu (const Triangulation<dim,spacedim>
 
   const unsigned int n_q_points = GeometryInfo<dim>::vertices_per_cell;
 
+  patches.reserve (view_levels ? tria.n_cells() : tria.n_active_cells());
   typename Triangulation<dim, spacedim>::cell_iterator cell, endc;
   for (cell=tria.begin(), endc=tria.end();
        cell != endc; ++cell)
@@ -2567,7 +2666,8 @@ void GridOut::write_mesh_per_processor_as_vtu (const Triangulation<dim,spacedim>
             continue;
         }
 
-      DataOutBase::Patch<dim,spacedim> patch;
+      patches.emplace_back();
+      DataOutBase::Patch<dim,spacedim> &patch = patches.back();
       patch.data.reinit(n_datasets, n_q_points);
       patch.points_are_available = false;
 
@@ -2587,7 +2687,6 @@ void GridOut::write_mesh_per_processor_as_vtu (const Triangulation<dim,spacedim>
 
       for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
         patch.neighbors[f] = numbers::invalid_unsigned_int;
-      patches.push_back(patch);
     }
 
   const std::string new_file = (filename_without_extension + ".proc" +
@@ -2595,11 +2694,10 @@ void GridOut::write_mesh_per_processor_as_vtu (const Triangulation<dim,spacedim>
                                 ".vtu");
   std::ofstream out(new_file.c_str());
   std::vector<std::tuple<unsigned int, unsigned int, std::string> > vector_data_ranges;
-  DataOutBase::VtkFlags flags;
   DataOutBase::write_vtu (patches,
                           data_names,
                           vector_data_ranges,
-                          flags,
+                          vtu_flags,
                           out);
   //create .pvtu record
   if (tria.locally_owned_subdomain() == 0)
@@ -2620,21 +2718,8 @@ void GridOut::write_mesh_per_processor_as_vtu (const Triangulation<dim,spacedim>
 
       const std::string pvtu_master_filename = (filename_without_extension + ".pvtu");
       std::ofstream pvtu_master (pvtu_master_filename.c_str());
-
-      DataOut<dim, DoFHandler<dim,spacedim> > data_out;
-      data_out.attach_triangulation (tria);
-
-      //We need a dummy vector with the names of the data values in the .vtu files
-      //in order that the .pvtu contains reference these values
-      Vector<float> dummy_vector (tria.n_active_cells());
-      data_out.add_data_vector (dummy_vector, "level");
-      data_out.add_data_vector (dummy_vector, "subdomain");
-      data_out.add_data_vector (dummy_vector, "level_subdomain");
-      data_out.add_data_vector (dummy_vector, "proc_writing");
-
-      data_out.build_patches ();
-
-      data_out.write_pvtu_record (pvtu_master, filenames);
+      DataOutBase::write_pvtu_record (pvtu_master, filenames, data_names,
+                                      vector_data_ranges);
     }
 }
 
@@ -2820,6 +2905,34 @@ GridOut::write_msh_faces (const Triangulation<dim,spacedim> &tria,
   unsigned int current_element_index = next_element_index;
   typename Triangulation<dim,spacedim>::active_face_iterator face, endf;
 
+  if (msh_flags.binary)
+    {
+      // one block with all faces, using the boundary id as the two tags like
+      // for the text format. empty blocks are not written
+      const int header[3] = {(dim == 2 ? 1 : 3),
+                             static_cast<int>(n_boundary_faces(tria)),
+                             2
+                            };
+      if (header[1] == 0)
+        return current_element_index;
+      out.write (reinterpret_cast<const char *>(&header[0]), 3*sizeof(int));
+
+      int element[3 + GeometryInfo<dim>::vertices_per_face];
+      for (face=tria.begin_active_face(), endf=tria.end_face();
+           face != endf; ++face)
+        if (face->at_boundary() &&
+            (face->boundary_id() != 0))
+          {
+            element[0] = current_element_index;
+            element[1] = element[2] = face->boundary_id();
+            for (unsigned int vertex=0; vertex<GeometryInfo<dim>::vertices_per_face; ++vertex)
+              element[3+vertex] = face->vertex_index(GeometryInfo<dim-1>::ucd_to_deal[vertex])+1;
+            out.write (reinterpret_cast<const char *>(&element[0]), sizeof(element));
+            ++current_element_index;
+          }
+      return current_element_index;
+    }
+
   for (face=tria.begin_active_face(), endf=tria.end_face();
        face != endf; ++face)
     if (face->at_boundary() &&
@@ -2872,6 +2985,14 @@ GridOut::write_msh_lines (const Triangulation<dim,spacedim> &tria,
 
   typename Triangulation<dim, spacedim>::active_cell_iterator cell, endc;
 
+  // in binary form, all lines form one block, unless there are none
+  if (msh_flags.binary)
+    {
+      const int header[3] = {1, static_cast<int>(n_boundary_lines(tria)), 2};
+      if (header[1] > 0)
+        out.write (reinterpret_cast<const char *>(&header[0]), 3*sizeof(int));
+    }
+
   for (cell=tria.begin_active(), endc=tria.end();
        cell != endc; ++cell)
     for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
@@ -2881,16 +3002,28 @@ GridOut::write_msh_lines (const Triangulation<dim,spacedim> &tria,
           &&
           (cell->line(l)->user_flag_set() == false))
         {
-          out << next_element_index << " 1 ";
-          out << static_cast<unsigned int>(cell->line(l)->boundary_id())
-              << ' '
-              << static_cast<unsigned int>(cell->line(l)->boundary_id())
-              << " 2 ";
-          // note: vertex numbers are 1-base
-          for (unsigned int vertex=0; vertex<2; ++vertex)
-            out << ' '
-                << cell->line(l)->vertex_index(GeometryInfo<dim-2>::ucd_to_deal[vertex])+1;
-          out << '\n';
+          if (msh_flags.binary)
+            {
+              int element[5];
+              element[0] = current_element_index;
+              element[1] = element[2] = cell->line(l)->boundary_id();
+              for (unsigned int vertex=0; vertex<2; ++vertex)
+                element[3+vertex] = cell->line(l)->vertex_index(GeometryInfo<dim-2>::ucd_to_deal[vertex])+1;
+              out.write (reinterpret_cast<const char *>(&element[0]), sizeof(element));
+            }
+          else
+            {
+              out << next_element_index << " 1 ";
+              out << static_cast<unsigned int>(cell->line(l)->boundary_id())
+                  << ' '
+                  << static_cast<unsigned int>(cell->line(l)->boundary_id())
+                  << " 2 ";
+              // note: vertex numbers are 1-base
+              for (unsigned int vertex=0; vertex<2; ++vertex)
+                out << ' '
+                    << cell->line(l)->vertex_index(GeometryInfo<dim-2>::ucd_to_deal[vertex])+1;
+              out << '\n';
+            }
 
           // move on to the next line
           // but mark the current one
@@ -15,6 +15,8 @@
 
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/bounding_box_tree.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/vector_memory.h>
 #include <deal.II/lac/filtered_matrix.h>
@@ -4956,6 +4958,43 @@ next_cell:
   {
     const auto &mesh = cache.get_triangulation();
     const auto &mapping = cache.get_mapping();
+
+    // the point often lies in the hint cell when tracking points along a
+    // trajectory, so check it before the global search
+    if (cell_hint.state() == IteratorState::valid)
+      {
+        try
+          {
+            const Point<dim> p_unit = mapping.transform_real_to_unit_cell(cell_hint, p);
+            if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
+              return std::make_pair(cell_hint, p_unit);
+          }
+        catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+          {}
+      }
+
+    // query the cells whose bounding box contains the point. The R-tree
+    // does not know about marked vertices, so skip it in that case
+    if (marked_vertices.size() == 0)
+      {
+        const auto &rtree = cache.get_cell_bounding_boxes_rtree();
+        std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> candidates;
+        rtree.find_boxes_containing(p, candidates);
+        for (const auto &cell : candidates)
+          {
+            try
+              {
+                const Point<dim> p_unit = mapping.transform_real_to_unit_cell(cell, p);
+                if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
+                  return std::make_pair(cell, p_unit);
+              }
+            catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+              {}
+          }
+      }
+
+    // the bounding boxes of the vertices need not enclose curved cells, so
+    // fall back to the search around the closest vertex
     const auto &vertex_to_cells = cache.get_vertex_to_cell_map();
     const auto &vertex_to_cell_centers = cache.get_vertex_to_cell_centers_directions();
 
@@ -4965,6 +5004,385 @@ next_cell:
                                          cell_hint,
                                          marked_vertices);
   }
+
+
+  namespace
+  {
+    /**
+     * Locate all points of the given vector in parallel and return, for
+     * each point, the cell containing it and the reference coordinates. The
+     * cell iterator is invalid for points that have not been found. If @p
+     * only_locally_owned is set, only locally owned cells are accepted.
+     */
+    template <int dim, int spacedim>
+    std::vector<std::pair<typename Triangulation<dim,spacedim>::active_cell_iterator, Point<dim> > >
+    locate_points_in_cells (const Cache<dim,spacedim>           &cache,
+                            const std::vector<Point<spacedim> > &points,
+                            const bool                           only_locally_owned)
+    {
+      const auto &mesh = cache.get_triangulation();
+      const auto &mapping = cache.get_mapping();
+
+      // compute the cached data structures before entering the parallel
+      // region, as the cache updates them lazily
+      const auto &rtree = cache.get_cell_bounding_boxes_rtree();
+      const auto &vertex_to_cells = cache.get_vertex_to_cell_map();
+      const auto &vertex_to_cell_centers = cache.get_vertex_to_cell_centers_directions();
+
+      std::vector<std::pair<typename Triangulation<dim,spacedim>::active_cell_iterator, Point<dim> > >
+      cells_and_positions(points.size());
+
+      parallel::apply_to_subranges
+      (0U, static_cast<unsigned int>(points.size()),
+       [&](const unsigned int begin, const unsigned int end)
+      {
+        std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> candidates;
+        for (unsigned int i=begin; i<end; ++i)
+          {
+            rtree.find_boxes_containing(points[i], candidates);
+            bool found = false;
+            for (const auto &cell : candidates)
+              {
+                if (only_locally_owned && !cell->is_locally_owned())
+                  continue;
+                try
+                  {
+                    const Point<dim> p_unit = mapping.transform_real_to_unit_cell(cell, points[i]);
+                    if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
+                      {
+                        cells_and_positions[i] = std::make_pair(cell, p_unit);
+                        found = true;
+                        break;
+                      }
+                  }
+                catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+                  {}
+              }
+
+            // curved cells might extend beyond the bounding box of their
+            // vertices, so try the search around the closest vertex
+            if (found == false)
+              try
+                {
+                  const auto cell_and_position =
+                    find_active_cell_around_point(mapping, mesh, points[i],
+                                                  vertex_to_cells,
+                                                  vertex_to_cell_centers,
+                                                  typename Triangulation<dim,spacedim>::active_cell_iterator(),
+                                                  std::vector<bool>());
+                  if (!only_locally_owned || cell_and_position.first->is_locally_owned())
+                    cells_and_positions[i] = cell_and_position;
+                }
+              catch (ExcPointNotFound<spacedim> &)
+                {}
+          }
+      },
+       64);
+
+      return cells_and_positions;
+    }
+
+
+
+    /**
+     * Return the indices of the points that have been found by
+     * locate_points_in_cells(), sorted by the active cell index of the
+     * cells containing them and by the point index within each cell.
+     */
+    template <int dim, int spacedim>
+    std::vector<unsigned int>
+    sort_points_by_cells
+    (const std::vector<std::pair<typename Triangulation<dim,spacedim>::active_cell_iterator, Point<dim> > > &cells_and_positions)
+    {
+      std::vector<unsigned int> sorted;
+      sorted.reserve(cells_and_positions.size());
+      for (unsigned int i=0; i<cells_and_positions.size(); ++i)
+        if (cells_and_positions[i].first.state() == IteratorState::valid)
+          sorted.push_back(i);
+      std::stable_sort(sorted.begin(), sorted.end(),
+                       [&](const unsigned int a, const unsigned int b)
+      {
+        return cells_and_positions[a].first->active_cell_index() <
+               cells_and_positions[b].first->active_cell_index();
+      });
+      return sorted;
+    }
+  }
+
+
+
+  template<int dim, int spacedim>
+  std::tuple<std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator>,
+      std::vector<std::vector<Point<dim> > >,
+      std::vector<std::vector<unsigned int> > >
+      compute_point_locations (const Cache<dim,spacedim>           &cache,
+                               const std::vector<Point<spacedim> > &points)
+  {
+    const auto cells_and_positions = locate_points_in_cells(cache, points, false);
+    const std::vector<unsigned int> sorted = sort_points_by_cells<dim,spacedim>(cells_and_positions);
+
+    std::tuple<std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator>,
+        std::vector<std::vector<Point<dim> > >,
+        std::vector<std::vector<unsigned int> > > result;
+    auto &cells = std::get<0>(result);
+    auto &qpoints = std::get<1>(result);
+    auto &maps = std::get<2>(result);
+    for (const unsigned int i : sorted)
+      {
+        if (cells.empty() || cells.back() != cells_and_positions[i].first)
+          {
+            cells.push_back(cells_and_positions[i].first);
+            qpoints.emplace_back();
+            maps.emplace_back();
+          }
+        qpoints.back().push_back(cells_and_positions[i].second);
+        maps.back().push_back(i);
+      }
+    return result;
+  }
+
+
+
+  template<int dim, int spacedim>
+  std::vector<BoundingBox<spacedim> >
+  compute_locally_owned_bounding_boxes (const Cache<dim,spacedim> &cache)
+  {
+    const auto &tria = cache.get_triangulation();
+    const auto &mapping = cache.get_mapping();
+
+    std::vector<BoundingBox<spacedim> > bboxes;
+    std::vector<bool> coarse_cell_has_box(tria.n_cells(0), false);
+    std::vector<unsigned int> coarse_cell_to_box(tria.n_cells(0));
+    for (const auto &cell : tria.active_cell_iterators())
+      if (cell->is_locally_owned())
+        {
+          const auto vertices = mapping.get_vertices(cell);
+          std::pair<Point<spacedim>,Point<spacedim> > corners(vertices[0], vertices[0]);
+          for (unsigned int v=1; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            for (unsigned int d=0; d<spacedim; ++d)
+              {
+                corners.first[d] = std::min(corners.first[d], vertices[v][d]);
+                corners.second[d] = std::max(corners.second[d], vertices[v][d]);
+              }
+
+          typename Triangulation<dim,spacedim>::cell_iterator coarse_cell = cell;
+          while (coarse_cell->level() > 0)
+            coarse_cell = coarse_cell->parent();
+          const unsigned int coarse_index = coarse_cell->index();
+          if (coarse_cell_has_box[coarse_index])
+            bboxes[coarse_cell_to_box[coarse_index]].merge_with(BoundingBox<spacedim>(corners));
+          else
+            {
+              coarse_cell_has_box[coarse_index] = true;
+              coarse_cell_to_box[coarse_index] = bboxes.size();
+              bboxes.emplace_back(corners);
+            }
+        }
+    return bboxes;
+  }
+
+
+
+  template<int spacedim>
+  std::vector<std::vector<BoundingBox<spacedim> > >
+  exchange_local_bounding_boxes (const std::vector<BoundingBox<spacedim> > &local_bboxes,
+                                 const MPI_Comm                          &mpi_communicator)
+  {
+#ifndef DEAL_II_WITH_MPI
+    (void)mpi_communicator;
+    return std::vector<std::vector<BoundingBox<spacedim> > >(1, local_bboxes);
+#else
+    const unsigned int n_procs = Utilities::MPI::n_mpi_processes(mpi_communicator);
+
+    // pack the two corner points of all boxes into a vector of doubles
+    std::vector<double> send_data;
+    send_data.reserve(2*spacedim*local_bboxes.size());
+    for (const auto &box : local_bboxes)
+      for (unsigned int i=0; i<2; ++i)
+        for (unsigned int d=0; d<spacedim; ++d)
+          send_data.push_back(i == 0 ? box.get_boundary_points().first[d] :
+                              box.get_boundary_points().second[d]);
+
+    int n_local_data = send_data.size();
+    std::vector<int> n_data(n_procs);
+    int ierr = MPI_Allgather(&n_local_data, 1, MPI_INT, n_data.data(), 1, MPI_INT,
+                             mpi_communicator);
+    AssertThrowMPI(ierr);
+
+    std::vector<int> offsets(n_procs+1, 0);
+    for (unsigned int p=0; p<n_procs; ++p)
+      offsets[p+1] = offsets[p] + n_data[p];
+    std::vector<double> receive_data(offsets[n_procs]);
+    ierr = MPI_Allgatherv(send_data.data(), n_local_data, MPI_DOUBLE,
+                          receive_data.data(), n_data.data(), offsets.data(),
+                          MPI_DOUBLE, mpi_communicator);
+    AssertThrowMPI(ierr);
+
+    std::vector<std::vector<BoundingBox<spacedim> > > global_bboxes(n_procs);
+    for (unsigned int p=0; p<n_procs; ++p)
+      for (int j=offsets[p]; j<offsets[p+1]; j+=2*spacedim)
+        {
+          std::pair<Point<spacedim>,Point<spacedim> > corners;
+          for (unsigned int d=0; d<spacedim; ++d)
+            {
+              corners.first[d] = receive_data[j+d];
+              corners.second[d] = receive_data[j+spacedim+d];
+            }
+          global_bboxes[p].emplace_back(corners);
+        }
+    return global_bboxes;
+#endif
+  }
+
+
+
+  template<int dim, int spacedim>
+  std::tuple<std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator>,
+      std::vector<std::vector<Point<dim> > >,
+      std::vector<std::vector<unsigned int> >,
+      std::vector<std::vector<unsigned int> > >
+      distributed_compute_point_locations (const Cache<dim,spacedim>                               &cache,
+                                           const std::vector<Point<spacedim> >                     &local_points,
+                                           const std::vector<std::vector<BoundingBox<spacedim> > > &global_bboxes)
+  {
+    const parallel::Triangulation<dim,spacedim> *parallel_tria =
+      dynamic_cast<const parallel::Triangulation<dim,spacedim> *>(&cache.get_triangulation());
+    const MPI_Comm mpi_communicator = parallel_tria != nullptr ?
+                                      parallel_tria->get_communicator() :
+                                      MPI_COMM_SELF;
+    const unsigned int n_procs = Utilities::MPI::n_mpi_processes(mpi_communicator);
+    const unsigned int my_rank = Utilities::MPI::this_mpi_process(mpi_communicator);
+    AssertDimension(global_bboxes.size(), n_procs);
+
+    // find the candidate processes of each point with an R-tree of the
+    // bounding boxes of all processes
+    std::vector<std::pair<BoundingBox<spacedim>, unsigned int> > boxes_and_ranks;
+    for (unsigned int p=0; p<n_procs; ++p)
+      for (const auto &box : global_bboxes[p])
+        boxes_and_ranks.emplace_back(box, p);
+    const BoundingBoxTree<spacedim> rank_tree(boxes_and_ranks);
+
+    std::map<unsigned int, std::vector<unsigned int> > points_per_rank;
+    std::vector<unsigned int> ranks;
+    for (unsigned int i=0; i<local_points.size(); ++i)
+      {
+        rank_tree.find_boxes_containing(local_points[i], ranks);
+        std::sort(ranks.begin(), ranks.end());
+        ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+        for (const unsigned int rank : ranks)
+          points_per_rank[rank].push_back(i);
+      }
+
+    // collect the points to be searched on this process: first the own
+    // ones, then the ones received from other processes
+    std::vector<Point<spacedim> > points;
+    std::vector<unsigned int> origin_ranks, origin_indices;
+    const auto own_points = points_per_rank.find(my_rank);
+    if (own_points != points_per_rank.end())
+      for (const unsigned int i : own_points->second)
+        {
+          points.push_back(local_points[i]);
+          origin_ranks.push_back(my_rank);
+          origin_indices.push_back(i);
+        }
+
+#ifdef DEAL_II_WITH_MPI
+    if (n_procs > 1)
+      {
+        // each point is sent as its coordinates followed by its index in
+        // local_points, which is represented exactly by a double
+        const int mpi_tag = 4201;
+        std::vector<unsigned int> destinations;
+        std::vector<std::vector<double> > send_buffers;
+        for (const auto &rank_and_points : points_per_rank)
+          if (rank_and_points.first != my_rank)
+            {
+              destinations.push_back(rank_and_points.first);
+              send_buffers.emplace_back();
+              send_buffers.back().reserve((spacedim+1)*rank_and_points.second.size());
+              for (const unsigned int i : rank_and_points.second)
+                {
+                  for (unsigned int d=0; d<spacedim; ++d)
+                    send_buffers.back().push_back(local_points[i][d]);
+                  send_buffers.back().push_back(i);
+                }
+            }
+
+        const std::vector<unsigned int> sources =
+          Utilities::MPI::compute_point_to_point_communication_pattern(mpi_communicator,
+              destinations);
+
+        std::vector<MPI_Request> requests(destinations.size());
+        for (unsigned int i=0; i<destinations.size(); ++i)
+          {
+            const int ierr = MPI_Isend(send_buffers[i].data(), send_buffers[i].size(),
+                                       MPI_DOUBLE, destinations[i], mpi_tag,
+                                       mpi_communicator, &requests[i]);
+            AssertThrowMPI(ierr);
+          }
+
+        std::vector<double> receive_buffer;
+        for (unsigned int i=0; i<sources.size(); ++i)
+          {
+            MPI_Status status;
+            int ierr = MPI_Probe(MPI_ANY_SOURCE, mpi_tag, mpi_communicator, &status);
+            AssertThrowMPI(ierr);
+            int n_entries;
+            ierr = MPI_Get_count(&status, MPI_DOUBLE, &n_entries);
+            AssertThrowMPI(ierr);
+            receive_buffer.resize(n_entries);
+            ierr = MPI_Recv(receive_buffer.data(), n_entries, MPI_DOUBLE,
+                            status.MPI_SOURCE, mpi_tag, mpi_communicator,
+                            MPI_STATUS_IGNORE);
+            AssertThrowMPI(ierr);
+
+            for (int j=0; j<n_entries; j+=spacedim+1)
+              {
+                Point<spacedim> p;
+                for (unsigned int d=0; d<spacedim; ++d)
+                  p[d] = receive_buffer[j+d];
+                points.push_back(p);
+                origin_ranks.push_back(status.MPI_SOURCE);
+                origin_indices.push_back(static_cast<unsigned int>(receive_buffer[j+spacedim]));
+              }
+          }
+
+        if (requests.size() > 0)
+          {
+            const int ierr = MPI_Waitall(requests.size(), requests.data(),
+                                         MPI_STATUSES_IGNORE);
+            AssertThrowMPI(ierr);
+          }
+      }
+#endif
+
+    const auto cells_and_positions = locate_points_in_cells(cache, points, true);
+    const std::vector<unsigned int> sorted = sort_points_by_cells<dim,spacedim>(cells_and_positions);
+
+    std::tuple<std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator>,
+        std::vector<std::vector<Point<dim> > >,
+        std::vector<std::vector<unsigned int> >,
+        std::vector<std::vector<unsigned int> > > result;
+    auto &cells = std::get<0>(result);
+    auto &qpoints = std::get<1>(result);
+    auto &maps = std::get<2>(result);
+    auto &owners = std::get<3>(result);
+    for (const unsigned int i : sorted)
+      {
+        if (cells.empty() || cells.back() != cells_and_positions[i].first)
+          {
+            cells.push_back(cells_and_positions[i].first);
+            qpoints.emplace_back();
+            maps.emplace_back();
+            owners.emplace_back();
+          }
+        qpoints.back().push_back(cells_and_positions[i].second);
+        maps.back().push_back(origin_indices[i]);
+        owners.back().push_back(origin_ranks[i]);
+      }
+    return result;
+  }
+
 } /* namespace GridTools */
 
 
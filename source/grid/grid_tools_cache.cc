@@ -16,6 +16,8 @@
 #include <deal.II/grid/grid_tools_cache.h>
 #include <deal.II/grid/grid_tools.h>
 
+#include <algorithm>
+
 DEAL_II_NAMESPACE_OPEN
 
 namespace GridTools
@@ -29,19 +31,49 @@ namespace GridTools
     tria(&tria),
     mapping(&mapping)
   {
-    tria_signal = tria.signals.any_change.connect([&]()
+    // instead of the any_change signal, connect to the signals it collects,
+    // in order to update the data incrementally after refinement and to
+    // keep the topological information when the mesh is moved
+    const auto reset = [this]()
     {
       mark_for_update(update_all);
-    });
+      changed_parents.clear();
+      changed_vertices.clear();
+      free_rtree_positions.clear();
+    };
+    tria_signals.push_back(tria.signals.create.connect(reset));
+    tria_signals.push_back(tria.signals.clear.connect(reset));
+    tria_signals.push_back(tria.signals.mesh_movement.connect([this]()
+    {
+      mark_for_update((update_vertex_to_cell_centers_directions & ~update_vertex_to_cell_map) |
+                      update_vertex_kdtree |
+                      update_used_vertices |
+                      update_cell_bounding_boxes_rtree);
+    }));
+    tria_signals.push_back(tria.signals.pre_coarsening_on_cell.connect
+                           ([this](const typename Triangulation<dim,spacedim>::cell_iterator &cell)
+    {
+      pre_coarsening_on_cell(cell);
+    }));
+    tria_signals.push_back(tria.signals.post_refinement_on_cell.connect
+                           ([this](const typename Triangulation<dim,spacedim>::cell_iterator &cell)
+    {
+      post_refinement_on_cell(cell);
+    }));
+    tria_signals.push_back(tria.signals.post_refinement.connect([this]()
+    {
+      post_refinement();
+    }));
   }
 
   template<int dim, int spacedim>
   Cache<dim,spacedim>::~Cache()
   {
-    // Make sure that the signals that was attached to the triangulation
-    // is removed here.
-    if (tria_signal.connected())
-      tria_signal.disconnect();
+    // Make sure that the signals that were attached to the triangulation
+    // are removed here.
+    for (auto &connection : tria_signals)
+      if (connection.connected())
+        connection.disconnect();
   }
 
 
@@ -54,6 +86,268 @@ namespace GridTools
 
 
 
+  template<int dim, int spacedim>
+  void Cache<dim,spacedim>::pre_coarsening_on_cell
+  (const typename Triangulation<dim,spacedim>::cell_iterator &parent)
+  {
+    changed_parents.push_back(parent);
+    for (unsigned int c=0; c<parent->n_children(); ++c)
+      add_changed_vertices(parent->child(c));
+
+    // remove the children from the R-tree. the position of the first child
+    // is kept for the parent, which has roughly the same box
+    if ((update_flags & update_cell_bounding_boxes_rtree) == 0)
+      for (unsigned int c=0; c<parent->n_children(); ++c)
+        {
+          unsigned int &position
+            = rtree_positions[parent->child(c)->level()][parent->child(c)->index()];
+          Assert(position != numbers::invalid_unsigned_int, ExcInternalError());
+          cell_bounding_boxes_rtree.remove(position);
+          if (c == 0)
+            rtree_positions[parent->level()][parent->index()] = position;
+          else
+            free_rtree_positions.push_back(position);
+          position = numbers::invalid_unsigned_int;
+        }
+  }
+
+
+
+  template<int dim, int spacedim>
+  void Cache<dim,spacedim>::post_refinement_on_cell
+  (const typename Triangulation<dim,spacedim>::cell_iterator &parent)
+  {
+    changed_parents.push_back(parent);
+  }
+
+
+
+  template<int dim, int spacedim>
+  void Cache<dim,spacedim>::post_refinement()
+  {
+    std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> new_cells;
+    for (const auto &parent : changed_parents)
+      if (parent->active())
+        new_cells.push_back(parent);
+      else
+        for (unsigned int c=0; c<parent->n_children(); ++c)
+          new_cells.push_back(parent->child(c));
+
+    // for larger changes, computing everything from scratch is faster
+    if (new_cells.size() > tria->n_active_cells()/8)
+      {
+        mark_for_update(update_all);
+        changed_parents.clear();
+        changed_vertices.clear();
+        free_rtree_positions.clear();
+        return;
+      }
+
+    for (const auto &parent : changed_parents)
+      {
+        add_changed_vertices(parent);
+        if (parent->has_children())
+          for (unsigned int c=0; c<parent->n_children(); ++c)
+            add_changed_vertices(parent->child(c));
+      }
+    std::sort(changed_vertices.begin(), changed_vertices.end());
+    changed_vertices.erase(std::unique(changed_vertices.begin(), changed_vertices.end()),
+                           changed_vertices.end());
+
+    update_vertex_information(new_cells);
+
+    if ((update_flags & update_cell_bounding_boxes_rtree) == 0)
+      {
+        rtree_positions.resize(tria->n_levels());
+        for (unsigned int l=0; l<tria->n_levels(); ++l)
+          rtree_positions[l].resize(tria->n_raw_cells(l), numbers::invalid_unsigned_int);
+
+        // the first child of a refined cell takes the position of the
+        // parent, whose box contains the one of the child
+        for (const auto &parent : changed_parents)
+          if (parent->has_children())
+            {
+              unsigned int &position = rtree_positions[parent->level()][parent->index()];
+              Assert(position != numbers::invalid_unsigned_int, ExcInternalError());
+              rtree_positions[parent->child(0)->level()][parent->child(0)->index()] = position;
+              position = numbers::invalid_unsigned_int;
+            }
+
+        for (const auto &cell : new_cells)
+          {
+            unsigned int &position = rtree_positions[cell->level()][cell->index()];
+            const BoundingBox<spacedim> box = compute_cell_bounding_box(cell);
+            if (position == numbers::invalid_unsigned_int && !free_rtree_positions.empty())
+              {
+                position = free_rtree_positions.back();
+                free_rtree_positions.pop_back();
+              }
+            if (position != numbers::invalid_unsigned_int)
+              cell_bounding_boxes_rtree.replace(position, box, cell);
+            else
+              position = cell_bounding_boxes_rtree.insert(box, cell);
+          }
+
+        // queries become slower with every entry that is not sorted into
+        // the tree, so build it again once there are too many of them
+        if (cell_bounding_boxes_rtree.n_unsorted_entries() >
+            cell_bounding_boxes_rtree.size()/8)
+          mark_for_update(update_cell_bounding_boxes_rtree);
+      }
+
+    // the vertices of the triangulation have changed
+    mark_for_update(update_vertex_kdtree);
+
+    changed_parents.clear();
+    changed_vertices.clear();
+    free_rtree_positions.clear();
+  }
+
+
+
+  template<int dim, int spacedim>
+  void Cache<dim,spacedim>::add_changed_vertices
+  (const typename Triangulation<dim,spacedim>::cell_iterator &cell)
+  {
+    for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+      changed_vertices.push_back(cell->vertex_index(v));
+
+    // the hanging nodes on the faces and, in 3d, on the edges of the cell
+    for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+      if (cell->face(f)->has_children())
+        for (unsigned int c=0; c<cell->face(f)->n_children(); ++c)
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_face; ++v)
+            changed_vertices.push_back(cell->face(f)->child(c)->vertex_index(v));
+
+    if (dim==3)
+      for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
+        if (cell->line(l)->has_children())
+          changed_vertices.push_back(cell->line(l)->child(0)->vertex_index(1));
+  }
+
+
+
+  template<int dim, int spacedim>
+  void Cache<dim,spacedim>::update_vertex_information
+  (const std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> &new_cells)
+  {
+    // without an up-to-date vertex to cell map, we can not find the cells
+    // around the changed vertices
+    if (update_flags & update_vertex_to_cell_map)
+      {
+        mark_for_update(update_vertex_to_cell_centers_directions |
+                        update_used_vertices);
+        return;
+      }
+
+    const auto is_changed = [this](const unsigned int vertex)
+    {
+      return std::binary_search(changed_vertices.begin(), changed_vertices.end(),
+                                vertex);
+    };
+
+    // the active cells that can touch one of the changed vertices: the new
+    // cells and the cells that touched them before and are still active.
+    // the iterators of removed cells may point to cells or levels that do
+    // not exist anymore, or to new cells that reuse the storage
+    std::set<typename Triangulation<dim,spacedim>::active_cell_iterator>
+    candidates(new_cells.begin(), new_cells.end());
+    vertex_to_cells.resize(tria->n_vertices());
+    for (const unsigned int vertex : changed_vertices)
+      {
+        for (const auto &cell : vertex_to_cells[vertex])
+          if (cell->level() < static_cast<int>(tria->n_levels()) &&
+              cell->index() < static_cast<int>(tria->n_raw_cells(cell->level())) &&
+              cell->used() && cell->active())
+            candidates.insert(cell);
+        vertex_to_cells[vertex].clear();
+      }
+
+    // apply the same rules as GridTools::vertex_to_cell_map(), restricted
+    // to the changed vertices
+    for (const auto &cell : candidates)
+      {
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          if (is_changed(cell->vertex_index(v)))
+            vertex_to_cells[cell->vertex_index(v)].insert(cell);
+
+        for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+          if ((cell->at_boundary(f)==false) && (cell->neighbor(f)->active()))
+            {
+              const typename Triangulation<dim,spacedim>::active_cell_iterator
+              adjacent_cell = cell->neighbor(f);
+              for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_face; ++v)
+                if (is_changed(cell->face(f)->vertex_index(v)))
+                  vertex_to_cells[cell->face(f)->vertex_index(v)].insert(adjacent_cell);
+            }
+
+        if (dim==3)
+          for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
+            if (cell->line(l)->has_children() &&
+                is_changed(cell->line(l)->child(0)->vertex_index(1)))
+              vertex_to_cells[cell->line(l)->child(0)->vertex_index(1)].insert(cell);
+      }
+
+    if ((update_flags & update_vertex_to_cell_centers_directions) == 0)
+      {
+        const std::vector<Point<spacedim> > &vertices = tria->get_vertices();
+        vertex_to_cell_centers.resize(tria->n_vertices());
+        for (const unsigned int vertex : changed_vertices)
+          {
+            vertex_to_cell_centers[vertex].clear();
+            if (tria->vertex_used(vertex))
+              for (const auto &cell : vertex_to_cells[vertex])
+                {
+                  Tensor<1,spacedim> direction = cell->center() - vertices[vertex];
+                  direction /= direction.norm();
+                  vertex_to_cell_centers[vertex].push_back(direction);
+                }
+          }
+      }
+
+    if ((update_flags & update_used_vertices) == 0)
+      {
+        for (const unsigned int vertex : changed_vertices)
+          used_vertices.erase(vertex);
+        for (const auto &cell : candidates)
+          {
+            const auto vertices = mapping->get_vertices(cell);
+            for (unsigned int v=0; v<vertices.size(); ++v)
+              if (is_changed(cell->vertex_index(v)))
+                used_vertices[cell->vertex_index(v)] = vertices[v];
+          }
+      }
+  }
+
+
+
+  template<int dim, int spacedim>
+  BoundingBox<spacedim>
+  Cache<dim,spacedim>::compute_cell_bounding_box
+  (const typename Triangulation<dim,spacedim>::active_cell_iterator &cell) const
+  {
+    const auto vertices = mapping->get_vertices(cell);
+    std::pair<Point<spacedim>,Point<spacedim> > corners(vertices[0], vertices[0]);
+    for (unsigned int v=1; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+      for (unsigned int d=0; d<spacedim; ++d)
+        {
+          corners.first[d] = std::min(corners.first[d], vertices[v][d]);
+          corners.second[d] = std::max(corners.second[d], vertices[v][d]);
+        }
+
+    // enlarge the box slightly to not miss points on the cell
+    // boundary due to roundoff in the mapping
+    const double tolerance = 1e-10 * corners.first.distance(corners.second);
+    for (unsigned int d=0; d<spacedim; ++d)
+      {
+        corners.first[d] -= tolerance;
+        corners.second[d] += tolerance;
+      }
+    return BoundingBox<spacedim>(corners);
+  }
+
+
+
   template<int dim, int spacedim>
   const std::vector<std::set<typename Triangulation<dim,spacedim>::active_cell_iterator> > &
   Cache<dim,spacedim>::get_vertex_to_cell_map() const
@@ -97,6 +391,36 @@ namespace GridTools
 
 
 
+  template<int dim, int spacedim>
+  const BoundingBoxTree<spacedim, typename Triangulation<dim,spacedim>::active_cell_iterator> &
+  Cache<dim,spacedim>::get_cell_bounding_boxes_rtree() const
+  {
+    if (update_flags & update_cell_bounding_boxes_rtree)
+      {
+        std::vector<std::pair<BoundingBox<spacedim>,
+            typename Triangulation<dim,spacedim>::active_cell_iterator> > boxes;
+        boxes.reserve(tria->n_active_cells());
+        for (const auto &cell : tria->active_cell_iterators())
+          boxes.emplace_back(compute_cell_bounding_box(cell), cell);
+        cell_bounding_boxes_rtree.build(boxes);
+
+        // remember the position of each cell in the tree for the updates
+        // after refinement
+        rtree_positions.resize(tria->n_levels());
+        for (unsigned int l=0; l<tria->n_levels(); ++l)
+          rtree_positions[l].assign(tria->n_raw_cells(l), numbers::invalid_unsigned_int);
+        for (unsigned int p=0; p<cell_bounding_boxes_rtree.n_positions(); ++p)
+          {
+            const auto &cell = cell_bounding_boxes_rtree.get_data(p);
+            rtree_positions[cell->level()][cell->index()] = p;
+          }
+        update_flags = update_flags & ~update_cell_bounding_boxes_rtree;
+      }
+    return cell_bounding_boxes_rtree;
+  }
+
+
+
 #ifdef DEAL_II_WITH_NANOFLANN
   template<int dim, int spacedim>
   const KDTree<spacedim> &Cache<dim,spacedim>::get_vertex_kdtree() const
@@ -0,0 +1,382 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/grid/grid_tools_laplace_transform.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace GridTools
+{
+  namespace
+  {
+    /**
+     * The Laplace operator with the rows and columns of the degrees of
+     * freedom with prescribed values replaced by the identity, which is the
+     * matrix-free analog of FilteredMatrix.
+     */
+    template <typename OperatorType>
+    class FilteredOperator : public Subscriptor
+    {
+    public:
+      typedef typename OperatorType::size_type size_type;
+
+      FilteredOperator (const OperatorType              &laplace_operator,
+                        const std::vector<unsigned int> &fixed_local_indices)
+        :
+        laplace_operator (laplace_operator),
+        fixed_local_indices (fixed_local_indices)
+      {}
+
+      size_type m () const
+      {
+        return laplace_operator.m();
+      }
+
+      size_type n () const
+      {
+        return laplace_operator.n();
+      }
+
+      double el (const size_type row,
+                 const size_type col) const
+      {
+        return laplace_operator.el(row, col);
+      }
+
+      void vmult (LinearAlgebra::distributed::Vector<double>       &dst,
+                  const LinearAlgebra::distributed::Vector<double> &src) const
+      {
+        if (tmp.size() != src.size())
+          tmp.reinit (src, true);
+        tmp = src;
+        for (unsigned int i=0; i<fixed_local_indices.size(); ++i)
+          tmp.local_element(fixed_local_indices[i]) = 0.;
+        laplace_operator.vmult (dst, tmp);
+        for (unsigned int i=0; i<fixed_local_indices.size(); ++i)
+          dst.local_element(fixed_local_indices[i]) =
+            src.local_element(fixed_local_indices[i]);
+      }
+
+      void Tvmult (LinearAlgebra::distributed::Vector<double>       &dst,
+                   const LinearAlgebra::distributed::Vector<double> &src) const
+      {
+        vmult (dst, src);
+      }
+
+    private:
+      const OperatorType              &laplace_operator;
+      const std::vector<unsigned int> &fixed_local_indices;
+      mutable LinearAlgebra::distributed::Vector<double> tmp;
+    };
+
+
+
+    template <int dim>
+    MPI_Comm
+    get_mpi_communicator (const Triangulation<dim> &triangulation)
+    {
+      const parallel::Triangulation<dim> *parallel_triangulation
+        = dynamic_cast<const parallel::Triangulation<dim> *>(&triangulation);
+      if (parallel_triangulation != nullptr)
+        return parallel_triangulation->get_communicator();
+      else
+        return MPI_COMM_SELF;
+    }
+  }
+
+
+
+  template <int dim>
+  LaplaceTransform<dim>::AdditionalData::AdditionalData
+  (const double       tolerance,
+   const unsigned int chebyshev_degree,
+   const bool         update_mapping)
+    :
+    tolerance (tolerance),
+    chebyshev_degree (chebyshev_degree),
+    update_mapping (update_mapping)
+  {}
+
+
+
+  template <int dim>
+  LaplaceTransform<dim>::LaplaceTransform ()
+    :
+    fe (1),
+    last_n_iterations (0)
+  {}
+
+
+
+  template <int dim>
+  LaplaceTransform<dim>::~LaplaceTransform ()
+  {
+    clear ();
+  }
+
+
+
+  template <int dim>
+  void
+  LaplaceTransform<dim>::clear ()
+  {
+    laplace_operator.clear();
+    matrix_free.reset();
+    constraints.clear();
+    locally_relevant_dofs.clear();
+    dof_handler.clear();
+    std::vector<types::global_dof_index>().swap(vertex_dof_indices);
+    coefficient = nullptr;
+    triangulation = nullptr;
+    last_n_iterations = 0;
+  }
+
+
+
+  template <int dim>
+  void
+  LaplaceTransform<dim>::reinit (Triangulation<dim>   &tria,
+                                 const Function<dim>  *coefficient_function,
+                                 const AdditionalData &data)
+  {
+    clear ();
+    triangulation = &tria;
+    coefficient = coefficient_function;
+    additional_data = data;
+
+    dof_handler.initialize (tria, fe);
+    DoFTools::extract_locally_relevant_dofs (dof_handler, locally_relevant_dofs);
+
+    constraints.reinit (locally_relevant_dofs);
+    DoFTools::make_hanging_node_constraints (dof_handler, constraints);
+    constraints.close ();
+
+    typename MatrixFree<dim,double>::AdditionalData mf_data;
+    mf_data.mapping_update_flags = (update_gradients | update_JxW_values |
+                                    update_quadrature_points);
+    matrix_free = std::make_shared<MatrixFree<dim,double> >();
+    matrix_free->reinit (StaticMappingQ1<dim>::mapping, dof_handler,
+                         constraints, QGauss<1>(2), mf_data);
+
+    laplace_operator.initialize (matrix_free);
+    if (coefficient != nullptr)
+      compute_coefficient ();
+    laplace_operator.compute_diagonal ();
+
+    // remember the degree of freedom at each vertex the current process
+    // knows about, such that transform() can translate between vertices and
+    // vector entries without going through the cells
+    vertex_dof_indices.resize (tria.n_vertices(), numbers::invalid_dof_index);
+    for (const auto &cell : dof_handler.active_cell_iterators())
+      if (cell->is_artificial() == false)
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          vertex_dof_indices[cell->vertex_index(v)] = cell->vertex_dof_index(v, 0);
+  }
+
+
+
+  template <int dim>
+  void
+  LaplaceTransform<dim>::compute_coefficient ()
+  {
+    Assert (coefficient != nullptr, ExcInternalError());
+
+    FEEvaluation<dim,1,2,1,double> fe_eval (*matrix_free);
+    std::shared_ptr<Table<2,VectorizedArray<double> > > coefficient_table
+      = std::make_shared<Table<2,VectorizedArray<double> > >();
+    coefficient_table->reinit (matrix_free->n_macro_cells(), fe_eval.n_q_points);
+    for (unsigned int cell=0; cell<matrix_free->n_macro_cells(); ++cell)
+      {
+        fe_eval.reinit (cell);
+        for (unsigned int q=0; q<fe_eval.n_q_points; ++q)
+          {
+            const Point<dim,VectorizedArray<double> > point_batch = fe_eval.quadrature_point(q);
+            VectorizedArray<double> value = make_vectorized_array (1.);
+            for (unsigned int v=0; v<matrix_free->n_components_filled(cell); ++v)
+              {
+                Point<dim> point;
+                for (unsigned int d=0; d<dim; ++d)
+                  point[d] = point_batch[d][v];
+                value[v] = coefficient->value (point);
+              }
+            (*coefficient_table)(cell,q) = value;
+          }
+      }
+    laplace_operator.set_coefficient (coefficient_table);
+  }
+
+
+
+  template <int dim>
+  void
+  LaplaceTransform<dim>::transform (const std::map<unsigned int,Point<dim> > &new_points,
+                                    const bool solve_for_absolute_positions)
+  {
+    Assert (triangulation != nullptr,
+            ExcMessage ("LaplaceTransform::reinit() must be called before "
+                        "transform()."));
+
+    if (additional_data.update_mapping)
+      {
+        matrix_free->update_mapping (StaticMappingQ1<dim>::mapping);
+        if (coefficient != nullptr)
+          compute_coefficient ();
+        laplace_operator.compute_diagonal ();
+      }
+
+    const MPI_Comm mpi_communicator = get_mpi_communicator (*triangulation);
+
+    // collect the prescribed values on the locally relevant degrees of
+    // freedom and sum them up on the owners, together with the number of
+    // contributions for averaging. The vector in position dim holds the
+    // number of contributions
+    std::vector<VectorType> values (dim+1);
+    values[0].reinit (dof_handler.locally_owned_dofs(), locally_relevant_dofs,
+                      mpi_communicator);
+    for (unsigned int d=1; d<=dim; ++d)
+      values[d].reinit (values[0], false);
+
+    const std::vector<Point<dim> > &vertices = triangulation->get_vertices();
+    for (typename std::map<unsigned int,Point<dim> >::const_iterator
+         p = new_points.begin(); p != new_points.end(); ++p)
+      {
+        AssertIndexRange (p->first, vertex_dof_indices.size());
+        const types::global_dof_index dof_index = vertex_dof_indices[p->first];
+        if (dof_index == numbers::invalid_dof_index)
+          continue;
+        for (unsigned int d=0; d<dim; ++d)
+          values[d](dof_index) += (solve_for_absolute_positions ?
+                                   p->second[d] :
+                                   p->second[d] - vertices[p->first][d]);
+        values[dim](dof_index) += 1.;
+      }
+    for (unsigned int d=0; d<=dim; ++d)
+      values[d].compress (VectorOperation::add);
+
+    std::vector<unsigned int> fixed_local_indices;
+    for (unsigned int i=0; i<values[dim].local_size(); ++i)
+      if (values[dim].local_element(i) > 0.)
+        {
+          fixed_local_indices.push_back (i);
+          for (unsigned int d=0; d<dim; ++d)
+            values[d].local_element(i) /= values[dim].local_element(i);
+        }
+
+    // the preconditioner works with the diagonal of the operator, with
+    // unit entries in the rows of the prescribed values
+    std::shared_ptr<DiagonalMatrix<VectorType> > diagonal_inverse
+      = std::make_shared<DiagonalMatrix<VectorType> >();
+    diagonal_inverse->get_vector() =
+      laplace_operator.get_matrix_diagonal_inverse()->get_vector();
+    for (unsigned int i=0; i<fixed_local_indices.size(); ++i)
+      diagonal_inverse->get_vector().local_element(fixed_local_indices[i]) = 1.;
+
+    typedef MatrixFreeOperators::LaplaceOperator<dim,1,2,1,VectorType> LaplaceOperatorType;
+    const FilteredOperator<LaplaceOperatorType> filtered_operator (laplace_operator,
+        fixed_local_indices);
+
+    PreconditionChebyshev<FilteredOperator<LaplaceOperatorType>,VectorType> chebyshev;
+    if (additional_data.chebyshev_degree > 0)
+      {
+        typename PreconditionChebyshev<FilteredOperator<LaplaceOperatorType>,VectorType>::AdditionalData
+        chebyshev_data;
+        chebyshev_data.degree = additional_data.chebyshev_degree;
+        chebyshev_data.smoothing_range = 20.;
+        chebyshev_data.eig_cg_n_iterations = 12;
+        chebyshev_data.preconditioner = diagonal_inverse;
+        chebyshev.initialize (filtered_operator, chebyshev_data);
+      }
+
+    // solve for the correction to the prescribed values in each coordinate
+    // direction, using the prescribed values as Dirichlet data
+    last_n_iterations = 0;
+    VectorType prescribed, solution, rhs;
+    laplace_operator.initialize_dof_vector (prescribed);
+    laplace_operator.initialize_dof_vector (solution);
+    laplace_operator.initialize_dof_vector (rhs);
+    for (unsigned int d=0; d<dim; ++d)
+      {
+        prescribed.copy_locally_owned_data_from (values[d]);
+        laplace_operator.vmult (rhs, prescribed);
+        rhs *= -1.;
+        for (unsigned int i=0; i<fixed_local_indices.size(); ++i)
+          rhs.local_element(fixed_local_indices[i]) = 0.;
+
+        solution = 0.;
+        const double rhs_norm = rhs.l2_norm();
+        if (rhs_norm > 0.)
+          {
+            SolverControl control (rhs.size(), additional_data.tolerance * rhs_norm,
+                                   false, false);
+            SolverCG<VectorType> solver (control);
+            if (additional_data.chebyshev_degree > 0)
+              solver.solve (filtered_operator, solution, rhs, chebyshev);
+            else
+              solver.solve (filtered_operator, solution, rhs, *diagonal_inverse);
+            last_n_iterations += control.last_step();
+          }
+        solution += prescribed;
+        constraints.distribute (solution);
+
+        values[d].copy_locally_owned_data_from (solution);
+        values[d].update_ghost_values ();
+      }
+
+    // change the coordinates of the vertices of all locally owned and ghost
+    // cells according to the computed values
+    std::vector<bool> vertex_touched (triangulation->n_vertices(), false);
+    for (const auto &cell : dof_handler.active_cell_iterators())
+      if (cell->is_artificial() == false)
+        for (unsigned int vertex_no=0;
+             vertex_no<GeometryInfo<dim>::vertices_per_cell; ++vertex_no)
+          if (vertex_touched[cell->vertex_index(vertex_no)] == false)
+            {
+              Point<dim> &v = cell->vertex(vertex_no);
+              const types::global_dof_index dof_index
+                = vertex_dof_indices[cell->vertex_index(vertex_no)];
+              for (unsigned int d=0; d<dim; ++d)
+                if (solve_for_absolute_positions)
+                  v(d) = values[d](dof_index);
+                else
+                  v(d) += values[d](dof_index);
+
+              vertex_touched[cell->vertex_index(vertex_no)] = true;
+            }
+  }
+
+
+
+  template <int dim>
+  unsigned int
+  LaplaceTransform<dim>::n_iterations () const
+  {
+    return last_n_iterations;
+  }
+
+
+#include "grid_tools_laplace_transform.inst"
+
+} // GridTools
+
+DEAL_II_NAMESPACE_CLOSE
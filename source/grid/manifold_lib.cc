@@ -659,6 +659,13 @@ TransfiniteInterpolationManifold<dim,spacedim>
   triangulation.signals.clear.connect
   ([&]() -> void {this->triangulation = nullptr; this->level_coarse = -1;});
   level_coarse = triangulation.last()->level();
+
+  // the cached pull-backs refer to the previous coarse mesh. note that
+  // ThreadLocalStorage::clear() does nothing without threads, so also reset
+  // the object of the present thread
+  pull_back_cache.clear();
+  pull_back_cache.get() = PullBackCache();
+
   coarse_cell_is_flat.resize(triangulation.n_cells(level_coarse), false);
   typename Triangulation<dim,spacedim>::active_cell_iterator
   cell = triangulation.begin(level_coarse),
@@ -1006,6 +1013,45 @@ TransfiniteInterpolationManifold<dim,spacedim>
 
 
 
+template <int dim, int spacedim>
+TransfiniteInterpolationManifold<dim,spacedim>::PullBackCache::PullBackCache()
+  :
+  next_entry (0)
+{}
+
+
+
+template <int dim, int spacedim>
+Point<dim>
+TransfiniteInterpolationManifold<dim,spacedim>
+::cached_pull_back(const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                   const Point<spacedim> &point) const
+{
+  // the surrounding points passed to get_new_points() are typically the
+  // vertices and previously computed points, so they are bitwise identical
+  // between the calls and we can compare for equality
+  const unsigned int max_cache_size = 256;
+  const unsigned int cell_index = cell->index();
+  PullBackCache &cache = pull_back_cache.get();
+  for (unsigned int i=0; i<cache.entries.size(); ++i)
+    if (std::get<0>(cache.entries[i]) == cell_index &&
+        std::get<1>(cache.entries[i]) == point)
+      return std::get<2>(cache.entries[i]);
+
+  const Point<dim> chart_point = pull_back(cell, point);
+  if (cache.entries.size() < max_cache_size)
+    cache.entries.emplace_back(cell_index, point, chart_point);
+  else
+    {
+      cache.entries[cache.next_entry] = std::make_tuple(cell_index, point,
+                                                        chart_point);
+      cache.next_entry = (cache.next_entry+1) % max_cache_size;
+    }
+  return chart_point;
+}
+
+
+
 template <int dim, int spacedim>
 std::array<unsigned int, 10>
 TransfiniteInterpolationManifold<dim,spacedim>
@@ -1106,7 +1152,7 @@ TransfiniteInterpolationManifold<dim, spacedim>
       bool inside_unit_cell = true;
       for (unsigned int i=0; i<surrounding_points.size(); ++i)
         {
-          chart_points[i] = pull_back(cell, surrounding_points[i]);
+          chart_points[i] = cached_pull_back(cell, surrounding_points[i]);
 
           // Tolerance 1e-6 chosen that the method also works with
           // SphericalManifold
@@ -18,6 +18,7 @@
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/geometry_info.h>
+#include <deal.II/base/parallel.h>
 
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_levels.h>
@@ -1046,6 +1047,7 @@ namespace
   }
 
 
+
 }// end of anonymous namespace
 
 
@@ -1293,6 +1295,50 @@ namespace internal
      */
     struct Implementation
     {
+      /**
+       * Compute the locations of the vertices placed in the middle of lines
+       * during refinement. The vertex indices and the child lines have
+       * already been set up in serial, such that the numbering does not
+       * depend on the number of threads. Here, we only ask the manifolds for
+       * the new points, which is the expensive part for curved geometries and
+       * can be done independently for each line. Consequently, the
+       * get_new_point() functions of the manifolds attached to the
+       * triangulation must be safe to be called concurrently.
+       */
+      template <int dim, int spacedim>
+      static
+      void
+      compute_new_line_vertices (Triangulation<dim,spacedim> &triangulation,
+                                 const std::vector<std::pair<typename Triangulation<dim,spacedim>::line_iterator,unsigned int> > &new_line_vertices)
+      {
+        parallel::apply_to_subranges
+        (0U, static_cast<unsigned int>(new_line_vertices.size()),
+         [&](const unsigned int begin, const unsigned int end)
+        {
+          for (unsigned int i=begin; i<end; ++i)
+            {
+              const typename Triangulation<dim,spacedim>::line_iterator &line
+                = new_line_vertices[i].first;
+              Point<spacedim> &vertex = triangulation.vertices[new_line_vertices[i].second];
+
+              // for the case of a domain in an equal-dimensional space we
+              // can ask the line itself. however, if spacedim>dim, we always
+              // have to ask the boundary object for its answer. We use the
+              // same object of the cell (which was stored in
+              // line->user_index() before) unless a manifold_id has been set
+              // on this very line.
+              if (dim == spacedim || dim == 3 ||
+                  line->manifold_id() != numbers::invalid_manifold_id)
+                vertex = line->center(true);
+              else
+                vertex = triangulation.get_manifold(line->user_index()).get_new_point_on_line (line);
+            }
+        },
+        32);
+      }
+
+
+
       /**
        * For a given Triangulation, update that part of the number
        * cache that relates to lines. For 1d, we have to deal with the
@@ -4763,6 +4809,9 @@ namespace internal
             typename Triangulation<dim,spacedim>::raw_line_iterator
             next_unused_line = triangulation.begin_raw_line ();
 
+            std::vector<std::pair<typename Triangulation<dim,spacedim>::line_iterator,unsigned int> >
+            new_line_vertices;
+
             for (; line!=endl; ++line)
               if (line->user_flag_set())
                 {
@@ -4776,30 +4825,11 @@ namespace internal
                           ExcMessage("Internal error: During refinement, the triangulation wants to access an element of the 'vertices' array but it turns out that the array is not large enough."));
                   triangulation.vertices_used[next_unused_vertex] = true;
 
-                  if (spacedim == dim)
-                    {
-                      // for the case of a domain in an
-                      // equal-dimensional space we only have to treat
-                      // boundary lines differently; for interior
-                      // lines we can compute the midpoint as the mean
-                      // of the two vertices: if (line->at_boundary())
-                      triangulation.vertices[next_unused_vertex]
-                        = line->center(true);
-                    }
-                  else
-                    // however, if spacedim>dim, we always have to ask
-                    // the boundary object for its answer. We use the
-                    // same object of the cell (which was stored in
-                    // line->user_index() before) unless a manifold_id
-                    // has been set on this very line.
-                    if (line->manifold_id() == numbers::invalid_manifold_id)
-                      triangulation.vertices[next_unused_vertex]
-                        = triangulation.get_manifold(line->user_index()).get_new_point_on_line (line);
-                    else
-                      triangulation.vertices[next_unused_vertex]
-                        = line->center(true);
+                  // the location of the new vertex is computed for all
+                  // lines at once after this loop
+                  new_line_vertices.emplace_back (line, next_unused_vertex);
 
-                  // now that we created the right point, make up the
+                  // now that we reserved the new point, make up the
                   // two child lines.  To this end, find a pair of
                   // unused lines
                   bool pair_found=false;
@@ -4858,6 +4888,9 @@ namespace internal
                   // refinement
                   line->clear_user_flag ();
                 }
+
+            compute_new_line_vertices (triangulation, new_line_vertices);
+
           }
 
 
@@ -5232,6 +5265,9 @@ namespace internal
             typename Triangulation<dim,spacedim>::raw_line_iterator
             next_unused_line = triangulation.begin_raw_line ();
 
+            std::vector<std::pair<typename Triangulation<dim,spacedim>::line_iterator,unsigned int> >
+            new_line_vertices;
+
             for (; line!=endl; ++line)
               if (line->user_flag_set())
                 {
@@ -5245,10 +5281,11 @@ namespace internal
                           ExcMessage("Internal error: During refinement, the triangulation wants to access an element of the 'vertices' array but it turns out that the array is not large enough."));
                   triangulation.vertices_used[next_unused_vertex] = true;
 
-                  triangulation.vertices[next_unused_vertex]
-                    = line->center(true);
+                  // the location of the new vertex is computed for all
+                  // lines at once after this loop
+                  new_line_vertices.emplace_back (line, next_unused_vertex);
 
-                  // now that we created the right point, make up the
+                  // now that we reserved the new point, make up the
                   // two child lines (++ takes care of the end of the
                   // vector)
                   next_unused_line=triangulation.faces->lines.next_free_pair_object(triangulation);
@@ -5298,6 +5335,9 @@ namespace internal
                   // for refinement
                   line->clear_user_flag ();
                 }
+
+            compute_new_line_vertices (triangulation, new_line_vertices);
+
           }
 
 
@@ -11788,7 +11828,26 @@ template <int dim, int spacedim>
 void
 Triangulation<dim, spacedim>::execute_coarsening_and_refinement ()
 {
-  prepare_coarsening_and_refinement ();
+  // if all active cells are flagged for isotropic refinement, as done by
+  // refine_global(), the smoothing and regularization loops of
+  // prepare_coarsening_and_refinement() can not change any flag: there are
+  // no coarsen flags, the level differences stay the same, and all faces
+  // are refined consistently. the only exceptions are anisotropically
+  // refined meshes and the smoothing flags that remove refined islands, so
+  // skip the rather expensive preparation step in all other cases
+  bool uniform_refinement =
+    (anisotropic_refinement == false) &&
+    (!(smooth_grid & (eliminate_refined_inner_islands |
+                      eliminate_refined_boundary_islands)) ||
+     (smooth_grid & patch_level_1));
+  for (active_cell_iterator cell = begin_active();
+       uniform_refinement == true && cell != end(); ++cell)
+    if (cell->refine_flag_set() != RefinementCase<dim>::isotropic_refinement ||
+        cell->coarsen_flag_set())
+      uniform_refinement = false;
+
+  if (uniform_refinement == false)
+    prepare_coarsening_and_refinement ();
 
   // verify a case with which we have had
   // some difficulty in the past (see the
@@ -13456,6 +13515,37 @@ Triangulation<dim, spacedim>::memory_consumption () const
 
 
 
+template <int dim, int spacedim>
+MemoryReport
+Triangulation<dim, spacedim>::memory_report () const
+{
+  MemoryReport report ("Triangulation");
+  for (unsigned int i=0; i<levels.size(); ++i)
+    {
+      MemoryReport &level = report.add ("level " + Utilities::int_to_string(i));
+      const std::size_t cells = MemoryConsumption::memory_consumption (levels[i]->cells);
+      const std::size_t neighbors = MemoryConsumption::memory_consumption (levels[i]->neighbors);
+      level.add ("cells", cells);
+      level.add ("neighbors", neighbors);
+      level.add ("flags and ids",
+                 MemoryConsumption::memory_consumption (*levels[i]) - cells - neighbors);
+    }
+  if (faces)
+    report.add ("faces", MemoryConsumption::memory_consumption (*faces));
+  report.add ("vertices",
+              MemoryConsumption::memory_consumption (vertices) +
+              MemoryConsumption::memory_consumption (vertices_used));
+
+  // everything else that memory_consumption() counts. call the function
+  // of this class, derived classes add their own data to the report
+  const std::size_t total = Triangulation<dim, spacedim>::memory_consumption ();
+  const std::size_t accounted = report.total_bytes();
+  report.add ("other", total > accounted ? total - accounted : 0);
+  return report;
+}
+
+
+
 
 template <int dim, int spacedim>
 Triangulation<dim, spacedim>::DistortedCellList::~DistortedCellList () noexcept
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2006 - 2014 by the deal.II authors
+// Copyright (C) 2006 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -28,8 +28,10 @@ namespace internal
     std::size_t
     DoFIndicesOnFacesOrEdges<structdim>::memory_consumption () const
     {
-      return (MemoryConsumption::memory_consumption (dofs) +
-              MemoryConsumption::memory_consumption (dof_offsets));
+      return (MemoryConsumption::memory_consumption (object_offsets) +
+              MemoryConsumption::memory_consumption (fe_indices) +
+              MemoryConsumption::memory_consumption (dof_offsets) +
+              MemoryConsumption::memory_consumption (dofs));
     }
 
 
@@ -320,27 +320,22 @@ namespace internal
         reserve_space_faces (DoFHandler<dim,spacedim> &dof_handler)
         {
           // make the code generic between lines and quads
-          std::vector<unsigned int> &face_dof_offsets
+          dealii::internal::hp::DoFIndicesOnFacesOrEdges<dim-1> &face_dofs
             = (dim == 2
                ?
-               reinterpret_cast<dealii::internal::hp::DoFIndicesOnFaces<2>&>(*dof_handler.faces).lines.dof_offsets
+               reinterpret_cast<dealii::internal::hp::DoFIndicesOnFacesOrEdges<dim-1>&>
+               (reinterpret_cast<dealii::internal::hp::DoFIndicesOnFaces<2>&>(*dof_handler.faces).lines)
                :
-               reinterpret_cast<dealii::internal::hp::DoFIndicesOnFaces<3>&>(*dof_handler.faces).quads.dof_offsets);
-
-          std::vector<types::global_dof_index> &face_dof_indices
-            = (dim == 2
-               ?
-               reinterpret_cast<dealii::internal::hp::DoFIndicesOnFaces<2>&>(*dof_handler.faces).lines.dofs
-               :
-               reinterpret_cast<dealii::internal::hp::DoFIndicesOnFaces<3>&>(*dof_handler.faces).quads.dofs);
+               reinterpret_cast<dealii::internal::hp::DoFIndicesOnFacesOrEdges<dim-1>&>
+               (reinterpret_cast<dealii::internal::hp::DoFIndicesOnFaces<3>&>(*dof_handler.faces).quads));
 
           // FACE DOFS
           //
-          // count face dofs, then allocate as much space
-          // as we need and prime the linked list for faces (see the
-          // description in hp::DoFLevel) with the indices we will
-          // need. note that our task is more complicated than for the
-          // cell case above since two adjacent cells may have different
+          // count the sets of face dofs (see the description in
+          // hp::DoFIndicesOnFacesOrEdges), then allocate as much space
+          // as we need and fill in the active_fe_indices of the sets.
+          // note that our task is more complicated than for the cell
+          // case above since two adjacent cells may have different
           // active_fe_indices, in which case we need to allocate
           // *two* sets of face dofs for the same face
           //
@@ -378,9 +373,12 @@ namespace internal
                 Assert (false, ExcNotImplemented());
               }
 
-            // an array to hold how many slots (see the hp::DoFLevel
-            // class) we will have to store on each level
-            unsigned int n_face_slots = 0;
+            // for every face, the number of sets we need is first stored
+            // in the entry after the face and then turned into the start
+            // index of the sets of the face by a prefix sum. all faces
+            // that are not part of an active cell get an empty range
+            face_dofs.object_offsets
+              = std::vector<unsigned int> (dof_handler.tria->n_raw_faces()+1, 0);
 
             for (typename HpDoFHandler<dim,spacedim>::active_cell_iterator
                  cell=dof_handler.begin_active(); cell!=dof_handler.end(); ++cell)
@@ -411,42 +409,23 @@ namespace internal
                            !cell->neighbor(face)->is_artificial()
                            &&
                            (cell->active_fe_index() == cell->neighbor(face)->active_fe_index())))
-                        // ok, one set of dofs. that makes one active_fe_index, 1
-                        // times dofs_per_face dofs, and one stop index
-                        n_face_slots
-                        += 1 + dof_handler.get_fe(cell->active_fe_index()).template n_dofs_per_object<dim-1>() + 1;
+                        face_dofs.object_offsets[cell->face(face)->index()+1] = 1;
 
-                      // otherwise we do indeed need two sets, i.e. two
-                      // active_fe_indices, two sets of dofs, and one stop index:
+                      // otherwise we do indeed need two sets
                       else
-                        n_face_slots
-                        += (2
-                            +
-                            dof_handler.get_fe(cell->active_fe_index()).template n_dofs_per_object<dim-1>()
-                            +
-                            dof_handler.get_fe(cell->neighbor(face)->active_fe_index())
-                            .template n_dofs_per_object<dim-1>()
-                            +
-                            1);
+                        face_dofs.object_offsets[cell->face(face)->index()+1] = 2;
 
                       // mark this face as visited
                       cell->face(face)->set_user_flag ();
                     }
 
-            // now that we know how many face dofs we will have to
-            // have on each level, allocate the memory. note that we
-            // allocate offsets for all faces, though only the active
-            // ones will have a non-invalid value later on
-            face_dof_offsets
-              = std::vector<unsigned int> (dof_handler.tria->n_raw_faces(),
-                                           (unsigned int)(-1));
-            face_dof_indices
-              = std::vector<types::global_dof_index> (n_face_slots,
-                                                      numbers::invalid_dof_index);
+            for (unsigned int f=1; f<face_dofs.object_offsets.size(); ++f)
+              face_dofs.object_offsets[f] += face_dofs.object_offsets[f-1];
 
             // with the memory now allocated, loop over the
-            // dof_handler.cells again and prime the _offset values as
-            // well as the fe_index fields
+            // dof_handler.cells again and fill in the active_fe_indices
+            // of the sets
+            face_dofs.fe_indices.resize (face_dofs.object_offsets.back());
             switch (dim)
               {
               case 2:
@@ -469,95 +448,27 @@ namespace internal
                 Assert (false, ExcNotImplemented());
               }
 
-            unsigned int next_free_face_slot = 0;
-
             for (typename HpDoFHandler<dim,spacedim>::active_cell_iterator
                  cell=dof_handler.begin_active(); cell!=dof_handler.end(); ++cell)
               if (! cell->is_artificial())
                 for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
                   if (! cell->face(face)->user_flag_set())
                     {
-                      // same decision tree as before
-                      if (cell->at_boundary(face)
-                          ||
-                          cell->face(face)->has_children()
-                          ||
-                          cell->neighbor_is_coarser(face)
-                          ||
-                          (!cell->at_boundary(face)
-                           &&
-                           cell->neighbor(face)->is_artificial())
-                          ||
-                          (!cell->at_boundary(face)
-                           &&
-                           !cell->neighbor(face)->is_artificial()
-                           &&
-                           (cell->active_fe_index() == cell->neighbor(face)->active_fe_index())))
-                        {
-                          face_dof_offsets[cell->face(face)->index()]
-                            = next_free_face_slot;
-
-                          // set first slot for this face to
-                          // active_fe_index of this face
-                          face_dof_indices[next_free_face_slot]
-                            = cell->active_fe_index();
-
-                          // the next dofs_per_face indices remain unset
-                          // for the moment (i.e. at invalid_dof_index).
-                          // following this comes the stop index, which
-                          // also is invalid_dof_index and therefore
-                          // does not have to be explicitly set
-
-                          // finally, mark those slots as used
-                          next_free_face_slot
-                          += dof_handler.get_fe(cell->active_fe_index()).template n_dofs_per_object<dim-1>() + 2;
-                        }
-                      else
-                        {
-                          face_dof_offsets[cell->face(face)->index()]
-                            = next_free_face_slot;
-
-                          // set first slot for this face to
-                          // active_fe_index of this face
-                          face_dof_indices[next_free_face_slot]
-                            = cell->active_fe_index();
-
-                          // the next dofs_per_line/quad indices remain unset
-                          // for the moment (i.e. at invalid_dof_index).
-                          //
-                          // then comes the fe_index for the neighboring
-                          // cell:
-                          face_dof_indices[next_free_face_slot
-                                           +
-                                           dof_handler.get_fe(cell->active_fe_index()).template n_dofs_per_object<dim-1>()
-                                           +
-                                           1]
-                            = cell->neighbor(face)->active_fe_index();
-                          // then again a set of dofs that we need not
-                          // set right now
-                          //
-                          // following this comes the stop index, which
-                          // also is invalid_dof_index and therefore
-                          // does not have to be explicitly set
-
-                          // finally, mark those slots as used
-                          next_free_face_slot
-                          += (dof_handler.get_fe(cell->active_fe_index()).template n_dofs_per_object<dim-1>()
-                              +
-                              dof_handler.get_fe(cell->neighbor(face)->active_fe_index())
-                              .template n_dofs_per_object<dim-1>()
-                              +
-                              3);
-                        }
+                      // the first set belongs to the active_fe_index of
+                      // this cell, the second one, if it exists, to the
+                      // one of the neighbor
+                      const unsigned int first_set
+                        = face_dofs.object_offsets[cell->face(face)->index()];
+                      face_dofs.fe_indices[first_set] = cell->active_fe_index();
+                      if (face_dofs.object_offsets[cell->face(face)->index()+1] - first_set == 2)
+                        face_dofs.fe_indices[first_set+1] = cell->neighbor(face)->active_fe_index();
 
                       // mark this face as visited
                       cell->face(face)->set_user_flag ();
                     }
 
-            // we should have moved the cursor for each level to the
-            // total number of dofs on that level. check that
-            Assert (next_free_face_slot == n_face_slots,
-                    ExcInternalError());
+            // finally allocate the dof indices of all sets
+            face_dofs.reserve_dof_indices (*dof_handler.finite_elements);
 
             // at the end, restore the user flags for the faces
             switch (dim)
@@ -699,59 +610,34 @@ namespace internal
                   line_fe_association[cell->active_fe_index()][cell->line_index(l)]
                     = true;
 
-              // first check which of the lines is used at all,
-              // i.e. is associated with a finite element. we do this
-              // since not all lines may actually be used, in which
-              // case we do not have to allocate any memory at all
-              std::vector<bool> line_is_used (dof_handler.tria->n_raw_lines(), false);
-              for (unsigned int line=0; line<dof_handler.tria->n_raw_lines(); ++line)
-                for (unsigned int fe=0; fe<dof_handler.finite_elements->size(); ++fe)
-                  if (line_fe_association[fe][line] == true)
-                    {
-                      line_is_used[line] = true;
-                      break;
-                    }
-
-              // next count how much memory we actually need. for each
-              // line, we need one slot per fe to store the fe_index,
-              // plus dofs_per_line for this fe. in addition, we need
-              // one slot as the end marker for the fe_indices. at the
-              // same time already fill the line_dofs_offsets field
-              dof_handler.faces->lines.dof_offsets
-              .resize (dof_handler.tria->n_raw_lines(),
-                       numbers::invalid_unsigned_int);
-
-              unsigned int line_slots_needed = 0;
+              // next count how many sets of dofs we need for each
+              // line, namely one per fe associated with the line, and
+              // turn the counts into the start indices of the sets of
+              // each line. lines that are not used at all get an empty
+              // range and no memory
+              dealii::internal::hp::DoFIndicesOnFacesOrEdges<1> &line_dofs
+                = dof_handler.faces->lines;
+              line_dofs.object_offsets
+                = std::vector<unsigned int> (dof_handler.tria->n_raw_lines()+1, 0);
               for (unsigned int line=0; line<dof_handler.tria->n_raw_lines(); ++line)
-                if (line_is_used[line] == true)
-                  {
-                    dof_handler.faces->lines.dof_offsets[line] = line_slots_needed;
-
-                    for (unsigned int fe=0; fe<dof_handler.finite_elements->size(); ++fe)
-                      if (line_fe_association[fe][line] == true)
-                        line_slots_needed += dof_handler.get_fe(fe).dofs_per_line + 1;
-                    ++line_slots_needed;
-                  }
+                {
+                  line_dofs.object_offsets[line+1] = line_dofs.object_offsets[line];
+                  for (unsigned int fe=0; fe<dof_handler.finite_elements->size(); ++fe)
+                    if (line_fe_association[fe][line] == true)
+                      ++line_dofs.object_offsets[line+1];
+                }
 
-              // now allocate the space we have determined we need,
-              // and set up the linked lists for each of the lines
-              dof_handler.faces->lines.dofs.resize (line_slots_needed,
-                                                    numbers::invalid_dof_index);
+              // now fill in the fe_index of each set in ascending
+              // order and allocate the space we have determined we need
+              line_dofs.fe_indices.resize (line_dofs.object_offsets.back());
               for (unsigned int line=0; line<dof_handler.tria->n_raw_lines(); ++line)
-                if (line_is_used[line] == true)
-                  {
-                    unsigned int pointer = dof_handler.faces->lines.dof_offsets[line];
-                    for (unsigned int fe=0; fe<dof_handler.finite_elements->size(); ++fe)
-                      if (line_fe_association[fe][line] == true)
-                        {
-                          // if this line uses this fe, then set the
-                          // fe_index and move the pointer ahead
-                          dof_handler.faces->lines.dofs[pointer] = fe;
-                          pointer += dof_handler.get_fe(fe).dofs_per_line + 1;
-                        }
-                    // finally place the end marker
-                    dof_handler.faces->lines.dofs[pointer] = numbers::invalid_dof_index;
-                  }
+                {
+                  unsigned int set = line_dofs.object_offsets[line];
+                  for (unsigned int fe=0; fe<dof_handler.finite_elements->size(); ++fe)
+                    if (line_fe_association[fe][line] == true)
+                      line_dofs.fe_indices[set++] = fe;
+                }
+              line_dofs.reserve_dof_indices (*dof_handler.finite_elements);
             }
 
 
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2003 - 2016 by the deal.II authors
+// Copyright (C) 2003 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -21,69 +21,162 @@ DEAL_II_NAMESPACE_OPEN
 
 namespace hp
 {
+  namespace
+  {
+    /**
+     * Compute the result of FECollection::find_least_face_dominating_fe()
+     * without looking at the stored results.
+     */
+    template <int dim, int spacedim>
+    unsigned int
+    compute_least_face_dominating_fe (const hp::FECollection<dim,spacedim> &fe_collection,
+                                      const std::set<unsigned int>         &fes)
+    {
+      // If the set of elements to be dominated contains only a single element X,
+      // then by definition the dominating set contains this single element X
+      // (because each element can dominate itself). There may also be others,
+      // say Y1...YN. Next you have to find one or more elements in the dominating
+      // set {X,Y1...YN} that is the weakest. Well, you can't find one that is
+      // weaker than X because if it were, it would not dominate X. In other words,
+      // X is guaranteed to be in the subset of {X,Y1...YN} of weakest dominating
+      // elements. Since we only guarantee that the function returns one of them,
+      // we may as well return X right away.
+      if (fes.size()==1)
+        return *fes.begin();
+
+      std::set<unsigned int> candidate_fes;
+
+      // first loop over all FEs and check which can dominate those given in @p fes:
+      for (unsigned int cur_fe = 0; cur_fe < fe_collection.size(); cur_fe++)
+        {
+          FiniteElementDomination::Domination domination = FiniteElementDomination::no_requirements;
+          // check if cur_fe can dominate all FEs in @p fes:
+          for (std::set<unsigned int>::const_iterator it = fes.begin();
+               it!=fes.end(); ++it)
+            {
+              Assert (*it < fe_collection.size(),
+                      ExcIndexRangeType<unsigned int> (*it, 0, fe_collection.size()));
+              domination = domination &
+                           fe_collection[cur_fe].compare_for_face_domination
+                           (fe_collection[*it]);
+            }
+
+          // if we found dominating element, keep them in a set.
+          if (domination == FiniteElementDomination::this_element_dominates ||
+              domination == FiniteElementDomination::either_element_can_dominate /*covers cases like {Q2,Q3,Q1,Q1} with fes={2,3}*/)
+            candidate_fes.insert(cur_fe);
+        }
+
+      // among the ones we found, pick one that is dominated by all others and
+      // thus should represent the largest FE space.
+      if (candidate_fes.size() == 1)
+        {
+          return *candidate_fes.begin();
+        }
+      else
+        for (std::set<unsigned int>::const_iterator it = candidate_fes.begin(); it!=candidate_fes.end(); ++it)
+          {
+            FiniteElementDomination::Domination domination = FiniteElementDomination::no_requirements;
+            for (std::set<unsigned int>::const_iterator ito = candidate_fes.begin(); ito!=candidate_fes.end(); ++ito)
+              if (it != ito)
+                {
+                  domination = domination &
+                               fe_collection[*it].compare_for_face_domination(fe_collection[*ito]);
+                }
+
+            if (domination == FiniteElementDomination::other_element_dominates ||
+                domination == FiniteElementDomination::either_element_can_dominate /*covers cases like candidate_fes={Q1,Q1}*/)
+              return *it;
+          }
+      // We couldn't find the FE, return invalid_unsigned_int :
+      return numbers::invalid_unsigned_int;
+    }
+  }
+
+
+
   template <int dim, int spacedim>
   unsigned int
   FECollection<dim,spacedim>::find_least_face_dominating_fe (const std::set<unsigned int> &fes) const
   {
-    // If the set of elements to be dominated contains only a single element X,
-    // then by definition the dominating set contains this single element X
-    // (because each element can dominate itself). There may also be others,
-    // say Y1...YN. Next you have to find one or more elements in the dominating
-    // set {X,Y1...YN} that is the weakest. Well, you can't find one that is
-    // weaker than X because if it were, it would not dominate X. In other words,
-    // X is guaranteed to be in the subset of {X,Y1...YN} of weakest dominating
-    // elements. Since we only guarantee that the function returns one of them,
-    // we may as well return X right away.
+    // see compute_least_face_dominating_fe() for this shortcut
     if (fes.size()==1)
       return *fes.begin();
 
-    const hp::FECollection<dim,spacedim> &fe_collection = *this;
-    std::set<unsigned int> candidate_fes;
+    {
+      Threads::Mutex::ScopedLock lock (cache_mutex);
+      const typename std::map<std::set<unsigned int>,unsigned int>::const_iterator
+      entry = least_face_dominating_fes.find (fes);
+      if (entry != least_face_dominating_fes.end())
+        return entry->second;
+    }
+
+    // compute the result without holding the lock. another thread may have
+    // done the same in the meantime, but it arrives at the same answer
+    const unsigned int result = compute_least_face_dominating_fe (*this, fes);
+
+    Threads::Mutex::ScopedLock lock (cache_mutex);
+    least_face_dominating_fes.insert (std::make_pair (fes, result));
+    return result;
+  }
 
-    // first loop over all FEs and check which can dominate those given in @p fes:
-    for (unsigned int cur_fe = 0; cur_fe < fe_collection.size(); cur_fe++)
-      {
-        FiniteElementDomination::Domination domination = FiniteElementDomination::no_requirements;
-        // check if cur_fe can dominate all FEs in @p fes:
-        for (std::set<unsigned int>::const_iterator it = fes.begin();
-             it!=fes.end(); ++it)
-          {
-            Assert (*it < fe_collection.size(),
-                    ExcIndexRangeType<unsigned int> (*it, 0, fe_collection.size()));
-            domination = domination &
-                         fe_collection[cur_fe].compare_for_face_domination
-                         (fe_collection[*it]);
-          }
 
-        // if we found dominating element, keep them in a set.
-        if (domination == FiniteElementDomination::this_element_dominates ||
-            domination == FiniteElementDomination::either_element_can_dominate /*covers cases like {Q2,Q3,Q1,Q1} with fes={2,3}*/)
-          candidate_fes.insert(cur_fe);
+
+  template <int dim, int spacedim>
+  const FullMatrix<double> &
+  FECollection<dim,spacedim>::get_face_interpolation_matrix (const unsigned int fe_index,
+                                                             const unsigned int source_fe_index) const
+  {
+    AssertIndexRange (fe_index, size());
+    AssertIndexRange (source_fe_index, size());
+
+    Threads::Mutex::ScopedLock lock (cache_mutex);
+    if (face_interpolation_matrices.size(0) != size())
+      face_interpolation_matrices.reinit (size(), size());
+
+    std::shared_ptr<const FullMatrix<double> > &matrix
+      = face_interpolation_matrices(fe_index, source_fe_index);
+    if (matrix == nullptr)
+      {
+        const FiniteElement<dim,spacedim> &fe = (*this)[fe_index];
+        const FiniteElement<dim,spacedim> &source_fe = (*this)[source_fe_index];
+        std::shared_ptr<FullMatrix<double> > new_matrix
+        (new FullMatrix<double> (source_fe.dofs_per_face, fe.dofs_per_face));
+        fe.get_face_interpolation_matrix (source_fe, *new_matrix);
+        matrix = new_matrix;
       }
+    return *matrix;
+  }
+
 
-    // among the ones we found, pick one that is dominated by all others and
-    // thus should represent the largest FE space.
-    if (candidate_fes.size() == 1)
+
+  template <int dim, int spacedim>
+  const FullMatrix<double> &
+  FECollection<dim,spacedim>::get_subface_interpolation_matrix (const unsigned int fe_index,
+                                                                const unsigned int source_fe_index,
+                                                                const unsigned int subface) const
+  {
+    AssertIndexRange (fe_index, size());
+    AssertIndexRange (source_fe_index, size());
+    AssertIndexRange (subface, GeometryInfo<dim>::max_children_per_face);
+
+    Threads::Mutex::ScopedLock lock (cache_mutex);
+    if (subface_interpolation_matrices.size(0) != size())
+      subface_interpolation_matrices.reinit (TableIndices<3>(size(), size(),
+                                                             GeometryInfo<dim>::max_children_per_face));
+
+    std::shared_ptr<const FullMatrix<double> > &matrix
+      = subface_interpolation_matrices(fe_index, source_fe_index, subface);
+    if (matrix == nullptr)
       {
-        return *candidate_fes.begin();
+        const FiniteElement<dim,spacedim> &fe = (*this)[fe_index];
+        const FiniteElement<dim,spacedim> &source_fe = (*this)[source_fe_index];
+        std::shared_ptr<FullMatrix<double> > new_matrix
+        (new FullMatrix<double> (source_fe.dofs_per_face, fe.dofs_per_face));
+        fe.get_subface_interpolation_matrix (source_fe, subface, *new_matrix);
+        matrix = new_matrix;
       }
-    else
-      for (std::set<unsigned int>::const_iterator it = candidate_fes.begin(); it!=candidate_fes.end(); ++it)
-        {
-          FiniteElementDomination::Domination domination = FiniteElementDomination::no_requirements;
-          for (std::set<unsigned int>::const_iterator ito = candidate_fes.begin(); ito!=candidate_fes.end(); ++ito)
-            if (it != ito)
-              {
-                domination = domination &
-                             fe_collection[*it].compare_for_face_domination(fe_collection[*ito]);
-              }
-
-          if (domination == FiniteElementDomination::other_element_dominates ||
-              domination == FiniteElementDomination::either_element_can_dominate /*covers cases like candidate_fes={Q1,Q1}*/)
-            return *it;
-        }
-    // We couldn't find the FE, return invalid_unsigned_int :
-    return numbers::invalid_unsigned_int;
+    return *matrix;
   }
 
 
@@ -124,6 +217,13 @@ namespace hp
 
     finite_elements
     .push_back (std::shared_ptr<const FiniteElement<dim,spacedim> >(new_fe.clone()));
+
+    // the stored interpolation matrices and dominating elements refer to
+    // the old set of elements
+    Threads::Mutex::ScopedLock lock (cache_mutex);
+    face_interpolation_matrices.reinit (0, 0);
+    subface_interpolation_matrices.reinit (TableIndices<3>(0, 0, 0));
+    least_face_dominating_fes.clear ();
   }
 
 
@@ -330,6 +430,17 @@ namespace hp
     for (unsigned int i=0; i<finite_elements.size(); ++i)
       mem += finite_elements[i]->memory_consumption();
 
+    Threads::Mutex::ScopedLock lock (cache_mutex);
+    for (unsigned int i=0; i<face_interpolation_matrices.size(0); ++i)
+      for (unsigned int j=0; j<face_interpolation_matrices.size(1); ++j)
+        if (face_interpolation_matrices(i,j) != nullptr)
+          mem += face_interpolation_matrices(i,j)->memory_consumption();
+    for (unsigned int i=0; i<subface_interpolation_matrices.size(0); ++i)
+      for (unsigned int j=0; j<subface_interpolation_matrices.size(1); ++j)
+        for (unsigned int c=0; c<subface_interpolation_matrices.size(2); ++c)
+          if (subface_interpolation_matrices(i,j,c) != nullptr)
+            mem += subface_interpolation_matrices(i,j,c)->memory_consumption();
+
     return mem;
   }
 }
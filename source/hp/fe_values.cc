@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2003 - 2015 by the deal.II authors
+// Copyright (C) 2003 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -91,17 +91,51 @@ namespace internal
       // already have an object for
       // this particular combination
       // of indices
-      if (fe_values_table(present_fe_values_index).get() == nullptr)
-        fe_values_table(present_fe_values_index)
+      precalculate_fe_values (fe_index, mapping_index, q_index);
+
+      // now there definitely is one!
+      return *fe_values_table(present_fe_values_index);
+    }
+
+
+
+    template <int dim, int q_dim, class FEValuesType>
+    void
+    FEValuesBase<dim,q_dim,FEValuesType>::precalculate_fe_values
+    (const unsigned int fe_index,
+     const unsigned int mapping_index,
+     const unsigned int q_index)
+    {
+      Assert (fe_index < fe_collection->size(),
+              ExcIndexRange (fe_index, 0, fe_collection->size()));
+      Assert (mapping_index < mapping_collection->size(),
+              ExcIndexRange (mapping_index, 0, mapping_collection->size()));
+      Assert (q_index < q_collection.size(),
+              ExcIndexRange (q_index, 0, q_collection.size()));
+
+      const TableIndices<3> index (fe_index, mapping_index, q_index);
+      if (fe_values_table(index).get() == nullptr)
+        fe_values_table(index)
           =
             std::shared_ptr<FEValuesType>
             (new FEValuesType ((*mapping_collection)[mapping_index],
                                (*fe_collection)[fe_index],
                                q_collection[q_index],
                                update_flags));
+    }
 
-      // now there definitely is one!
-      return *fe_values_table(present_fe_values_index);
+
+
+    template <int dim, int q_dim, class FEValuesType>
+    void
+    FEValuesBase<dim,q_dim,FEValuesType>::precalculate_fe_values ()
+    {
+      // use the same choice of indices as the reinit() functions of the
+      // derived classes with default arguments
+      for (unsigned int fe_index=0; fe_index<fe_collection->size(); ++fe_index)
+        precalculate_fe_values (fe_index,
+                                mapping_collection->size() > 1 ? fe_index : 0,
+                                q_collection.size() > 1 ? fe_index : 0);
     }
   }
 }
@@ -52,6 +52,87 @@ const Table<2,bool> ConstraintMatrix::default_empty_table = Table<2,bool>();
 
 
 
+namespace internals
+{
+  const unsigned int ConstraintLinesCache::block_shift;
+
+
+
+  void
+  ConstraintLinesCache::resize (const size_type new_size)
+  {
+    const size_type n_blocks = (new_size + (size_type(1)<<block_shift) - 1) >> block_shift;
+    if (n_blocks < block_starts.size())
+      {
+        // compact the storage of the blocks we keep
+        std::vector<size_type> new_values;
+        for (size_type b=0; b<n_blocks; ++b)
+          if (block_starts[b] != numbers::invalid_unsigned_int)
+            {
+              const unsigned int start = block_starts[b];
+              block_starts[b] = new_values.size();
+              new_values.insert (new_values.end(), values.begin()+start,
+                                 values.begin()+start+(size_type(1)<<block_shift));
+            }
+        values.swap (new_values);
+      }
+    block_starts.resize (n_blocks, numbers::invalid_unsigned_int);
+
+    // invalidate the entries of the last block beyond the new size
+    if (new_size < n_indices && n_blocks > 0 &&
+        block_starts[n_blocks-1] != numbers::invalid_unsigned_int)
+      for (size_type i=new_size; i<(n_blocks<<block_shift); ++i)
+        values[block_starts[n_blocks-1] + (i & ((size_type(1)<<block_shift)-1))]
+          = numbers::invalid_size_type;
+
+    n_indices = new_size;
+  }
+
+
+
+  void
+  ConstraintLinesCache::reset ()
+  {
+    std::fill (block_starts.begin(), block_starts.end(),
+               numbers::invalid_unsigned_int);
+    values.clear ();
+  }
+
+
+
+  void
+  ConstraintLinesCache::clear ()
+  {
+    n_indices = 0;
+    std::vector<unsigned int> tmp_starts;
+    block_starts.swap (tmp_starts);
+    std::vector<size_type> tmp_values;
+    values.swap (tmp_values);
+  }
+
+
+
+  void
+  ConstraintLinesCache::swap (ConstraintLinesCache &other)
+  {
+    std::swap (n_indices, other.n_indices);
+    block_starts.swap (other.block_starts);
+    values.swap (other.values);
+  }
+
+
+
+  std::size_t
+  ConstraintLinesCache::memory_consumption () const
+  {
+    return (sizeof(*this) +
+            MemoryConsumption::memory_consumption (block_starts) +
+            MemoryConsumption::memory_consumption (values));
+  }
+}
+
+
+
 void
 ConstraintMatrix::copy_from (const ConstraintMatrix &other)
 {
@@ -210,20 +291,19 @@ void ConstraintMatrix::close ()
   // update list of pointers and give the vector a sharp size since we
   // won't modify the size any more after this point.
   {
-    std::vector<size_type> new_lines (lines_cache.size(),
-                                      numbers::invalid_size_type);
+    internals::ConstraintLinesCache new_lines;
+    new_lines.resize (lines_cache.size());
     size_type counter = 0;
     for (std::vector<ConstraintLine>::const_iterator line=lines.begin();
          line!=lines.end(); ++line, ++counter)
-      new_lines[calculate_line_index(line->index)] = counter;
-    std::swap (lines_cache, new_lines);
+      new_lines.set (calculate_line_index(line->index), counter);
+    lines_cache.swap (new_lines);
   }
 
   // in debug mode: check whether we really set the pointers correctly.
-  for (size_type i=0; i<lines_cache.size(); ++i)
-    if (lines_cache[i] != numbers::invalid_size_type)
-      Assert (i == calculate_line_index(lines[lines_cache[i]].index),
-              ExcInternalError());
+  for (size_type i=0; i<lines.size(); ++i)
+    Assert (lines_cache[calculate_line_index(lines[i].index)] == i,
+            ExcInternalError());
 
   // first, strip zero entries, as we have to do that only once
   for (std::vector<ConstraintLine>::iterator line = lines.begin();
@@ -559,7 +639,7 @@ ConstraintMatrix::merge (const ConstraintMatrix &other_constraints,
   {
     // do not bother to resize the lines cache exactly since it is pretty
     // cheap to adjust it along the way.
-    std::fill(lines_cache.begin(), lines_cache.end(), numbers::invalid_size_type);
+    lines_cache.reset();
 
     // reset lines_cache for our own constraints
     size_type index = 0;
@@ -568,8 +648,8 @@ ConstraintMatrix::merge (const ConstraintMatrix &other_constraints,
       {
         size_type local_line_no = calculate_line_index(line->index);
         if (local_line_no >= lines_cache.size())
-          lines_cache.resize(local_line_no+1, numbers::invalid_size_type);
-        lines_cache[local_line_no] = index++;
+          lines_cache.resize(local_line_no+1);
+        lines_cache.set(local_line_no, index++);
       }
 
     // Add other_constraints to lines cache and our list of constraints
@@ -579,16 +659,16 @@ ConstraintMatrix::merge (const ConstraintMatrix &other_constraints,
         const size_type local_line_no = calculate_line_index(line->index);
         if (local_line_no >= lines_cache.size())
           {
-            lines_cache.resize(local_line_no+1, numbers::invalid_size_type);
+            lines_cache.resize(local_line_no+1);
             lines.push_back(*line);
-            lines_cache[local_line_no] = index++;
+            lines_cache.set(local_line_no, index++);
           }
         else if (lines_cache[local_line_no] == numbers::invalid_size_type)
           {
             // there are no constraints for that line yet
             lines.push_back(*line);
             AssertIndexRange(local_line_no, lines_cache.size());
-            lines_cache[local_line_no] = index++;
+            lines_cache.set(local_line_no, index++);
           }
         else
           {
@@ -616,10 +696,9 @@ ConstraintMatrix::merge (const ConstraintMatrix &other_constraints,
       }
 
     // check that we set the pointers correctly
-    for (size_type i=0; i<lines_cache.size(); ++i)
-      if (lines_cache[i] != numbers::invalid_size_type)
-        Assert (i == calculate_line_index(lines[lines_cache[i]].index),
-                ExcInternalError());
+    for (size_type i=0; i<lines.size(); ++i)
+      Assert (lines_cache[calculate_line_index(lines[i].index)] == i,
+              ExcInternalError());
   }
 
   // if the object was sorted before, then make sure it is so afterward as
@@ -632,10 +711,7 @@ ConstraintMatrix::merge (const ConstraintMatrix &other_constraints,
 
 void ConstraintMatrix::shift (const size_type offset)
 {
-  if (local_lines.size() == 0)
-    lines_cache.insert (lines_cache.begin(), offset,
-                        numbers::invalid_size_type);
-  else
+  if (local_lines.size() != 0)
     {
       // shift local_lines
       IndexSet new_local_lines(local_lines.size());
@@ -653,12 +729,22 @@ void ConstraintMatrix::shift (const size_type offset)
         j->first += offset;
     }
 
+  // without local_lines, the cache is indexed by the global index of the
+  // lines, so it needs to be rebuilt for the shifted indices
+  if (local_lines.size() == 0)
+    {
+      internals::ConstraintLinesCache new_lines;
+      new_lines.resize (lines_cache.size() + offset);
+      for (size_type i=0; i<lines.size(); ++i)
+        new_lines.set (lines[i].index, lines_cache[lines[i].index-offset]);
+      lines_cache.swap (new_lines);
+    }
+
 #ifdef DEBUG
   // make sure that lines, lines_cache and local_lines
   // are still linked correctly
-  for (size_type i=0; i<lines_cache.size(); ++i)
-    Assert(lines_cache[i] == numbers::invalid_size_type ||
-           calculate_line_index(lines[lines_cache[i]].index) == i,
+  for (size_type i=0; i<lines.size(); ++i)
+    Assert(lines_cache[calculate_line_index(lines[i].index)] == i,
            ExcInternalError());
 #endif
 }
@@ -672,10 +758,7 @@ void ConstraintMatrix::clear ()
     lines.swap (tmp);
   }
 
-  {
-    std::vector<size_type> tmp;
-    lines_cache.swap (tmp);
-  }
+  lines_cache.clear ();
 
   sorted = false;
 }
@@ -1230,13 +1313,25 @@ std::size_t
 ConstraintMatrix::memory_consumption () const
 {
   return (MemoryConsumption::memory_consumption (lines) +
-          MemoryConsumption::memory_consumption (lines_cache) +
+          lines_cache.memory_consumption() +
           MemoryConsumption::memory_consumption (sorted) +
           MemoryConsumption::memory_consumption (local_lines));
 }
 
 
 
+MemoryReport
+ConstraintMatrix::memory_report () const
+{
+  MemoryReport report ("ConstraintMatrix", MemoryConsumption::memory_consumption (sorted));
+  report.add ("constraint lines", MemoryConsumption::memory_consumption (lines));
+  report.add ("lines cache", lines_cache.memory_consumption());
+  report.add ("local lines", MemoryConsumption::memory_consumption (local_lines));
+  return report;
+}
+
+
+
 void
 ConstraintMatrix::resolve_indices (std::vector<types::global_dof_index> &indices) const
 {
@@ -1317,39 +1412,43 @@ PARALLEL_VECTOR_FUNCTIONS(TrilinosWrappers::MPI::BlockVector);
 
 #define MATRIX_VECTOR_FUNCTIONS(MatrixType, VectorType) \
   template void ConstraintMatrix:: \
-  distribute_local_to_global<MatrixType,VectorType > (const FullMatrix<MatrixType::value_type>        &, \
-                                                      const Vector<VectorType::value_type>            &, \
+  distribute_local_to_global<MatrixType,VectorType > (const internals::LocalMatrixView<MatrixType::value_type> &, \
+                                                      const ArrayView<const VectorType::value_type>   &, \
                                                       const std::vector<ConstraintMatrix::size_type> &, \
                                                       MatrixType                      &, \
                                                       VectorType                      &, \
                                                       bool                             , \
+                                                      Threads::SpinLockTable          *, \
                                                       std::integral_constant<bool, false>) const
 #define MATRIX_FUNCTIONS(MatrixType) \
   template void ConstraintMatrix:: \
-  distribute_local_to_global<MatrixType,Vector<MatrixType::value_type> > (const FullMatrix<MatrixType::value_type>        &, \
-      const Vector<MatrixType::value_type>            &, \
+  distribute_local_to_global<MatrixType,Vector<MatrixType::value_type> > (const internals::LocalMatrixView<MatrixType::value_type> &, \
+      const ArrayView<const MatrixType::value_type>   &, \
       const std::vector<ConstraintMatrix::size_type> &, \
       MatrixType                      &, \
       Vector<MatrixType::value_type>                  &, \
       bool                             , \
+      Threads::SpinLockTable          *, \
       std::integral_constant<bool, false>) const
 #define BLOCK_MATRIX_VECTOR_FUNCTIONS(MatrixType, VectorType)   \
   template void ConstraintMatrix:: \
-  distribute_local_to_global<MatrixType,VectorType > (const FullMatrix<MatrixType::value_type>        &, \
-                                                      const Vector<VectorType::value_type>            &, \
+  distribute_local_to_global<MatrixType,VectorType > (const internals::LocalMatrixView<MatrixType::value_type> &, \
+                                                      const ArrayView<const VectorType::value_type>   &, \
                                                       const std::vector<ConstraintMatrix::size_type> &, \
                                                       MatrixType                      &, \
                                                       VectorType                      &, \
                                                       bool                             , \
+                                                      Threads::SpinLockTable          *, \
                                                       std::integral_constant<bool, true>) const
 #define BLOCK_MATRIX_FUNCTIONS(MatrixType)      \
   template void ConstraintMatrix:: \
-  distribute_local_to_global<MatrixType,Vector<MatrixType::value_type> > (const FullMatrix<MatrixType::value_type>        &, \
-      const Vector<MatrixType::value_type>            &, \
+  distribute_local_to_global<MatrixType,Vector<MatrixType::value_type> > (const internals::LocalMatrixView<MatrixType::value_type> &, \
+      const ArrayView<const MatrixType::value_type>   &, \
       const std::vector<ConstraintMatrix::size_type> &, \
       MatrixType                      &, \
       Vector<MatrixType::value_type>                  &, \
       bool                             , \
+      Threads::SpinLockTable          *, \
       std::integral_constant<bool, true>) const
 
 MATRIX_FUNCTIONS(SparseMatrix<double>);
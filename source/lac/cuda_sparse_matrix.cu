@@ -0,0 +1,402 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/lac/cuda_sparse_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector_memory.h>
+#include <deal.II/base/exceptions.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#ifdef DEAL_II_WITH_CUDA
+
+DEAL_II_NAMESPACE_OPEN
+
+#define BLOCK_SIZE 512
+#define CHUNK_SIZE 8
+
+namespace CUDAWrappers
+{
+  namespace internal
+  {
+    template <typename Number>
+    __global__ void jacobi_precondition(Number       *dst,
+                                        const Number *src,
+                                        const Number *diagonal_inverse,
+                                        const Number  omega,
+                                        const int     N)
+    {
+      const int idx_base = threadIdx.x + blockIdx.x * (blockDim.x*CHUNK_SIZE);
+      for (unsigned int i=0; i<CHUNK_SIZE; ++i)
+        {
+          const int idx = idx_base + i*BLOCK_SIZE;
+          if (idx<N)
+            dst[idx] = omega * diagonal_inverse[idx] * src[idx];
+        }
+    }
+
+
+
+    template <typename Number>
+    __global__ void jacobi_update(Number       *v,
+                                  const Number *b,
+                                  const Number *matrix_times_v,
+                                  const Number *diagonal_inverse,
+                                  const Number  omega,
+                                  const int     N)
+    {
+      const int idx_base = threadIdx.x + blockIdx.x * (blockDim.x*CHUNK_SIZE);
+      for (unsigned int i=0; i<CHUNK_SIZE; ++i)
+        {
+          const int idx = idx_base + i*BLOCK_SIZE;
+          if (idx<N)
+            v[idx] += omega * diagonal_inverse[idx] * (b[idx]-matrix_times_v[idx]);
+        }
+    }
+
+
+
+    // select the cuSPARSE function for the number type
+    inline
+    cusparseStatus_t
+    csrmv(cusparseHandle_t          handle,
+          cusparseOperation_t       operation,
+          const int                 m,
+          const int                 n,
+          const int                 nnz,
+          const float              *alpha,
+          const cusparseMatDescr_t  descriptor,
+          const float              *values,
+          const int                *row_ptr,
+          const int                *column_index,
+          const float              *x,
+          const float              *beta,
+          float                    *y)
+    {
+      return cusparseScsrmv(handle, operation, m, n, nnz, alpha, descriptor,
+                            values, row_ptr, column_index, x, beta, y);
+    }
+
+
+
+    inline
+    cusparseStatus_t
+    csrmv(cusparseHandle_t          handle,
+          cusparseOperation_t       operation,
+          const int                 m,
+          const int                 n,
+          const int                 nnz,
+          const double             *alpha,
+          const cusparseMatDescr_t  descriptor,
+          const double             *values,
+          const int                *row_ptr,
+          const int                *column_index,
+          const double             *x,
+          const double             *beta,
+          double                   *y)
+    {
+      return cusparseDcsrmv(handle, operation, m, n, nnz, alpha, descriptor,
+                            values, row_ptr, column_index, x, beta, y);
+    }
+
+
+
+    template <typename Type>
+    void copy_to_device(const std::vector<Type> &host_data,
+                        Type                   *&device_data)
+    {
+      cudaError_t error_code = cudaMalloc(&device_data,
+                                          host_data.size()*sizeof(Type));
+      AssertCuda(error_code);
+      error_code = cudaMemcpy(device_data, host_data.data(),
+                              host_data.size()*sizeof(Type),
+                              cudaMemcpyHostToDevice);
+      AssertCuda(error_code);
+    }
+  }
+
+
+
+  template <typename Number>
+  SparseMatrix<Number>::SparseMatrix()
+    :
+    n_rows(0),
+    n_cols(0),
+    n_nonzero(0),
+    values_dev(nullptr),
+    column_index_dev(nullptr),
+    row_ptr_dev(nullptr)
+  {
+    cusparseStatus_t status = cusparseCreate(&cusparse_handle);
+    AssertCusparse(status);
+    status = cusparseCreateMatDescr(&descriptor);
+    AssertCusparse(status);
+    status = cusparseSetMatType(descriptor, CUSPARSE_MATRIX_TYPE_GENERAL);
+    AssertCusparse(status);
+    status = cusparseSetMatIndexBase(descriptor, CUSPARSE_INDEX_BASE_ZERO);
+    AssertCusparse(status);
+  }
+
+
+
+  template <typename Number>
+  SparseMatrix<Number>::SparseMatrix(const ::dealii::SparseMatrix<Number> &matrix)
+    :
+    SparseMatrix()
+  {
+    reinit(matrix);
+  }
+
+
+
+  template <typename Number>
+  SparseMatrix<Number>::~SparseMatrix()
+  {
+    clear();
+
+    cusparseStatus_t status = cusparseDestroyMatDescr(descriptor);
+    AssertNothrow(status == CUSPARSE_STATUS_SUCCESS,
+                  ExcCusparseError(status));
+    status = cusparseDestroy(cusparse_handle);
+    AssertNothrow(status == CUSPARSE_STATUS_SUCCESS,
+                  ExcCusparseError(status));
+  }
+
+
+
+  template <typename Number>
+  void SparseMatrix<Number>::clear()
+  {
+    if (values_dev != nullptr)
+      {
+        const cudaError_t error_code = cudaFree(values_dev);
+        AssertCuda(error_code);
+        values_dev = nullptr;
+      }
+    if (column_index_dev != nullptr)
+      {
+        const cudaError_t error_code = cudaFree(column_index_dev);
+        AssertCuda(error_code);
+        column_index_dev = nullptr;
+      }
+    if (row_ptr_dev != nullptr)
+      {
+        const cudaError_t error_code = cudaFree(row_ptr_dev);
+        AssertCuda(error_code);
+        row_ptr_dev = nullptr;
+      }
+    n_rows = n_cols = n_nonzero = 0;
+  }
+
+
+
+  template <typename Number>
+  void SparseMatrix<Number>::reinit(const ::dealii::SparseMatrix<Number> &matrix)
+  {
+    AssertThrow(matrix.m() < static_cast<types::global_dof_index>(std::numeric_limits<int>::max()) &&
+                matrix.n() < static_cast<types::global_dof_index>(std::numeric_limits<int>::max()) &&
+                matrix.n_nonzero_elements() < static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                ExcMessage("The matrix is too large for the 32 bit indices "
+                           "of cuSPARSE."));
+
+    clear();
+
+    // collect the entries row by row, sorted by their column
+    std::vector<int> row_ptr(matrix.m()+1, 0);
+    std::vector<int> column_index;
+    std::vector<Number> values;
+    std::vector<Number> diagonal_inverse_host(matrix.m(), Number(1.));
+    column_index.reserve(matrix.n_nonzero_elements());
+    values.reserve(matrix.n_nonzero_elements());
+    std::vector<std::pair<int,Number> > row_entries;
+    for (types::global_dof_index row=0; row<matrix.m(); ++row)
+      {
+        row_entries.clear();
+        for (typename ::dealii::SparseMatrix<Number>::const_iterator
+             entry = matrix.begin(row); entry != matrix.end(row); ++entry)
+          {
+            row_entries.emplace_back(entry->column(), entry->value());
+            if (entry->column() == row && entry->value() != Number())
+              diagonal_inverse_host[row] = Number(1.)/entry->value();
+          }
+        std::sort(row_entries.begin(), row_entries.end(),
+                  [](const std::pair<int,Number> &a,
+                     const std::pair<int,Number> &b)
+        {
+          return a.first < b.first;
+        });
+        for (unsigned int i=0; i<row_entries.size(); ++i)
+          {
+            column_index.push_back(row_entries[i].first);
+            values.push_back(row_entries[i].second);
+          }
+        row_ptr[row+1] = column_index.size();
+      }
+
+    n_rows = matrix.m();
+    n_cols = matrix.n();
+    n_nonzero = values.size();
+    internal::copy_to_device(values, values_dev);
+    internal::copy_to_device(column_index, column_index_dev);
+    internal::copy_to_device(row_ptr, row_ptr_dev);
+
+    diagonal_inverse.reinit(n_rows, true);
+    if (n_rows > 0)
+      {
+        const cudaError_t error_code =
+          cudaMemcpy(diagonal_inverse.get_values(), diagonal_inverse_host.data(),
+                     n_rows*sizeof(Number), cudaMemcpyHostToDevice);
+        AssertCuda(error_code);
+      }
+  }
+
+
+
+  template <typename Number>
+  void SparseMatrix<Number>::apply(const cusparseOperation_t                          operation,
+                                   const Number                                       beta,
+                                   LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                                   const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const
+  {
+    Assert(&dst != &src, ExcMessage("The source and destination vectors must "
+                                    "be different."));
+    AssertDimension(dst.size(), (operation == CUSPARSE_OPERATION_NON_TRANSPOSE ?
+                                 m() : n()));
+    AssertDimension(src.size(), (operation == CUSPARSE_OPERATION_NON_TRANSPOSE ?
+                                 n() : m()));
+
+    const Number alpha = 1.;
+    const cusparseStatus_t status =
+      internal::csrmv(cusparse_handle, operation, n_rows, n_cols, n_nonzero,
+                      &alpha, descriptor, values_dev, row_ptr_dev,
+                      column_index_dev, src.get_values(), &beta,
+                      dst.get_values());
+    AssertCusparse(status);
+  }
+
+
+
+  template <typename Number>
+  void SparseMatrix<Number>::vmult(LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                                   const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const
+  {
+    apply(CUSPARSE_OPERATION_NON_TRANSPOSE, Number(), dst, src);
+  }
+
+
+
+  template <typename Number>
+  void SparseMatrix<Number>::Tvmult(LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                                    const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const
+  {
+    apply(CUSPARSE_OPERATION_TRANSPOSE, Number(), dst, src);
+  }
+
+
+
+  template <typename Number>
+  void SparseMatrix<Number>::vmult_add(LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                                       const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const
+  {
+    apply(CUSPARSE_OPERATION_NON_TRANSPOSE, Number(1.), dst, src);
+  }
+
+
+
+  template <typename Number>
+  void SparseMatrix<Number>::Tvmult_add(LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                                        const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const
+  {
+    apply(CUSPARSE_OPERATION_TRANSPOSE, Number(1.), dst, src);
+  }
+
+
+
+  template <typename Number>
+  void SparseMatrix<Number>::precondition_Jacobi(LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                                                 const LinearAlgebra::CUDAWrappers::Vector<Number> &src,
+                                                 const Number                                       omega) const
+  {
+    Assert(m() == n(), ExcMessage("The Jacobi preconditioner needs a square matrix."));
+    AssertDimension(dst.size(), m());
+    AssertDimension(src.size(), m());
+
+    if (n_rows == 0)
+      return;
+
+    const int n_blocks = 1 + (n_rows-1)/(CHUNK_SIZE*BLOCK_SIZE);
+    internal::jacobi_precondition<Number> <<<n_blocks,BLOCK_SIZE>>>
+    (dst.get_values(), src.get_values(), diagonal_inverse.get_values(),
+     omega, n_rows);
+
+    // Check that the kernel was launched correctly
+    AssertCuda(cudaGetLastError());
+    // Check that there was no problem during the execution of the kernel
+    AssertCuda(cudaDeviceSynchronize());
+  }
+
+
+
+  template <typename Number>
+  void SparseMatrix<Number>::Jacobi_step(LinearAlgebra::CUDAWrappers::Vector<Number>       &v,
+                                         const LinearAlgebra::CUDAWrappers::Vector<Number> &b,
+                                         const Number                                       omega) const
+  {
+    Assert(m() == n(), ExcMessage("The Jacobi step needs a square matrix."));
+    AssertDimension(v.size(), m());
+    AssertDimension(b.size(), m());
+
+    if (n_rows == 0)
+      return;
+
+    GrowingVectorMemory<LinearAlgebra::CUDAWrappers::Vector<Number> > memory;
+    typename VectorMemory<LinearAlgebra::CUDAWrappers::Vector<Number> >::Pointer
+    matrix_times_v(memory);
+    matrix_times_v->reinit(v, true);
+    vmult(*matrix_times_v, v);
+
+    const int n_blocks = 1 + (n_rows-1)/(CHUNK_SIZE*BLOCK_SIZE);
+    internal::jacobi_update<Number> <<<n_blocks,BLOCK_SIZE>>>
+    (v.get_values(), b.get_values(), matrix_times_v->get_values(),
+     diagonal_inverse.get_values(), omega, n_rows);
+
+    // Check that the kernel was launched correctly
+    AssertCuda(cudaGetLastError());
+    // Check that there was no problem during the execution of the kernel
+    AssertCuda(cudaDeviceSynchronize());
+  }
+
+
+
+  template <typename Number>
+  std::size_t SparseMatrix<Number>::memory_consumption() const
+  {
+    return sizeof(*this) + n_nonzero*(sizeof(Number)+sizeof(int)) +
+           (n_rows+1)*sizeof(int) + diagonal_inverse.memory_consumption();
+  }
+
+
+
+  // explicit instantiation
+  template class SparseMatrix<float>;
+  template class SparseMatrix<double>;
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
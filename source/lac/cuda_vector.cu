@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2016 by the deal.II authors
+// Copyright (C) 2016 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -526,6 +526,26 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number>
+    Vector<Number> &Vector<Number>::operator= (const Vector<Number> &V)
+    {
+      if (&V == this)
+        return *this;
+
+      reinit(V.n_elements, true);
+      if (n_elements > 0)
+        {
+          cudaError_t error_code = cudaMemcpy(val, V.val,
+                                              n_elements*sizeof(Number),
+                                              cudaMemcpyDeviceToDevice);
+          AssertCuda(error_code);
+        }
+
+      return *this;
+    }
+
+
+
     template <typename Number>
     void Vector<Number>::reinit(const size_type n,
                                 const bool      omit_zeroing_entries)
@@ -542,20 +562,24 @@ namespace LinearAlgebra
         }
       else
         {
+          // keep the memory if the size does not change
           if (n_elements != n)
             {
-              cudaError_t error_code = cudaFree(val);
+              if (val != nullptr)
+                {
+                  cudaError_t error_code = cudaFree(val);
+                  AssertCuda(error_code);
+                }
+
+              cudaError_t error_code = cudaMalloc(&val, n*sizeof(Number));
               AssertCuda(error_code);
             }
 
-          cudaError_t error_code = cudaMalloc(&val, n*sizeof(Number));
-          AssertCuda(error_code);
-
           // If necessary set the elements to zero
           if (omit_zeroing_entries == false)
             {
               cudaError_t error_code = cudaMemset(val, 0,
-                                                  n_elements*sizeof(Number));
+                                                  n*sizeof(Number));
               AssertCuda(error_code);
             }
         }
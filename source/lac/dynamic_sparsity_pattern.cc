@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2008 - 2016 by the deal.II authors
+// Copyright (C) 2008 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -24,6 +24,129 @@
 DEAL_II_NAMESPACE_OPEN
 
 
+namespace internal
+{
+  namespace DynamicSparsityPatternImplementation
+  {
+    namespace
+    {
+      // the pool starts with small chunks so that small patterns do not
+      // waste memory, and then doubles the chunk size with the memory in use
+      // up to the maximal size
+      const std::size_t min_chunk_size = std::size_t(1) << 12;
+      const std::size_t max_chunk_size = std::size_t(1) << 24;
+
+      // the smallest block must be able to hold the pointer of the free list
+      const unsigned int min_size_class = 3;
+    }
+
+
+
+    RowPool::RowPool ()
+      :
+      allocated_bytes (0),
+      chunk_position (nullptr),
+      chunk_remaining (0),
+      free_lists (8*sizeof(std::size_t), nullptr)
+    {
+      static_assert((std::size_t(1) << min_size_class) >= sizeof(void *),
+                    "The smallest block must be able to hold a pointer");
+    }
+
+
+
+    unsigned int
+    RowPool::size_class (const std::size_t n_bytes)
+    {
+      unsigned int c = min_size_class;
+      while ((std::size_t(1) << c) < n_bytes)
+        ++c;
+      return c;
+    }
+
+
+
+    void *
+    RowPool::allocate (const std::size_t n_bytes)
+    {
+      const unsigned int c = size_class (n_bytes);
+
+      // first try to reuse a block that has been returned before
+      if (free_lists[c] != nullptr)
+        {
+          void *block = free_lists[c];
+          free_lists[c] = *static_cast<void **>(block);
+          return block;
+        }
+
+      const std::size_t block_size = std::size_t(1) << c;
+      if (chunk_remaining < block_size)
+        {
+          // hand the remainder of the current chunk to the free lists in
+          // pieces of decreasing size. all blocks are powers of two of at
+          // least the smallest size, so the pieces stay aligned
+          for (unsigned int r=size_class(chunk_remaining+1)-1;
+               r>=min_size_class && chunk_remaining > 0; --r)
+            if (chunk_remaining >= (std::size_t(1) << r))
+              {
+                deallocate (chunk_position, std::size_t(1) << r);
+                chunk_position += std::size_t(1) << r;
+                chunk_remaining -= std::size_t(1) << r;
+              }
+
+          const std::size_t chunk_size =
+            std::max(block_size, std::min(std::max(allocated_bytes, min_chunk_size),
+                                          max_chunk_size));
+          chunks.emplace_back (new char[chunk_size]);
+          allocated_bytes += chunk_size;
+          chunk_position = chunks.back().get();
+          chunk_remaining = chunk_size;
+        }
+
+      void *block = chunk_position;
+      chunk_position += block_size;
+      chunk_remaining -= block_size;
+      return block;
+    }
+
+
+
+    void
+    RowPool::deallocate (void              *ptr,
+                         const std::size_t  n_bytes)
+    {
+      if (ptr == nullptr)
+        return;
+      const unsigned int c = size_class (n_bytes);
+      *static_cast<void **>(ptr) = free_lists[c];
+      free_lists[c] = ptr;
+    }
+
+
+
+    void
+    RowPool::release ()
+    {
+      std::vector<std::unique_ptr<char[]> >().swap (chunks);
+      allocated_bytes = 0;
+      chunk_position = nullptr;
+      chunk_remaining = 0;
+      std::fill (free_lists.begin(), free_lists.end(), nullptr);
+    }
+
+
+
+    std::size_t
+    RowPool::memory_consumption () const
+    {
+      return sizeof(*this) + allocated_bytes +
+             chunks.capacity()*sizeof(std::unique_ptr<char[]>) +
+             free_lists.capacity()*sizeof(void *);
+    }
+  }
+}
+
+
 
 template <typename ForwardIterator>
 void
@@ -62,7 +185,7 @@ DynamicSparsityPattern::Line::add_entries (ForwardIterator begin,
       // actually doing something.
       ForwardIterator my_it = begin;
       size_type col = *my_it;
-      std::vector<size_type>::iterator it =
+      DynamicSparsityPatternIterators::RowEntries::iterator it =
         Utilities::lower_bound(entries.begin(), entries.end(), col);
       while (*it == col)
         {
@@ -98,7 +221,7 @@ DynamicSparsityPattern::Line::add_entries (ForwardIterator begin,
       Assert (entries.size() >= (size_type)(it-entries.begin()), ExcInternalError());
 
       // now merge the two lists.
-      std::vector<size_type>::iterator it2 = it + (end-my_it);
+      DynamicSparsityPatternIterators::RowEntries::iterator it2 = it + (end-my_it);
 
       // as long as there are indices both in
       // the end of the entries list and in the
@@ -142,7 +265,7 @@ DynamicSparsityPattern::Line::add_entries (ForwardIterator begin,
     entries.reserve (stop_size);
 
   size_type col = *my_it;
-  std::vector<size_type>::iterator it, it2;
+  DynamicSparsityPatternIterators::RowEntries::iterator it, it2;
   // insert the first element as for one
   // entry only first check the last
   // element (or if line is still empty)
@@ -315,12 +438,32 @@ DynamicSparsityPattern::reinit (const size_type m,
                     "of indices in this IndexSet may be less than the number "
                     "of rows, but the *size* of the IndexSet must be equal.)"));
 
-  std::vector<Line> new_lines (rowset.size()==0 ? rows : rowset.n_elements());
+  // free the old rows before we release the memory of the pool all at once
+  std::vector<Line>().swap (lines);
+  if (row_pool)
+    row_pool->release();
+
+  std::vector<Line> new_lines (rowset.size()==0 ? rows : rowset.n_elements(),
+                               Line(DynamicSparsityPatternIterators::RowEntries::allocator_type(row_pool.get())));
   lines.swap (new_lines);
 }
 
 
 
+void
+DynamicSparsityPattern::set_pooled_row_storage (const bool use_pool)
+{
+  std::vector<Line>().swap (lines);
+  if (use_pool)
+    row_pool.reset (new internal::DynamicSparsityPatternImplementation::RowPool());
+  else
+    row_pool.reset ();
+
+  reinit (rows, cols, rowset);
+}
+
+
+
 void
 DynamicSparsityPattern::compress ()
 {}
@@ -394,7 +537,7 @@ DynamicSparsityPattern::symmetrize ()
       const size_type rowindex =
         rowset.size()==0 ? row : rowset.nth_index_in_set(row);
 
-      for (std::vector<size_type>::const_iterator
+      for (DynamicSparsityPatternIterators::RowEntries::const_iterator
            j=lines[row].entries.begin();
            j != lines[row].entries.end();
            ++j)
@@ -414,7 +557,7 @@ DynamicSparsityPattern::print (std::ostream &out) const
     {
       out << '[' << (rowset.size()==0 ? row : rowset.nth_index_in_set(row));
 
-      for (std::vector<size_type >::const_iterator
+      for (DynamicSparsityPatternIterators::RowEntries::const_iterator
            j=lines[row].entries.begin();
            j != lines[row].entries.end(); ++j)
         out << ',' << *j;
@@ -435,7 +578,7 @@ DynamicSparsityPattern::print_gnuplot (std::ostream &out) const
       const size_type rowindex =
         rowset.size()==0 ? row : rowset.nth_index_in_set(row);
 
-      for (std::vector<size_type >::const_iterator
+      for (DynamicSparsityPatternIterators::RowEntries::const_iterator
            j=lines[row].entries.begin();
            j != lines[row].entries.end(); ++j)
         // while matrix entries are usually
@@ -463,7 +606,7 @@ DynamicSparsityPattern::bandwidth () const
       const size_type rowindex =
         rowset.size()==0 ? row : rowset.nth_index_in_set(row);
 
-      for (std::vector<size_type>::const_iterator
+      for (DynamicSparsityPatternIterators::RowEntries::const_iterator
            j=lines[row].entries.begin();
            j != lines[row].entries.end(); ++j)
         if (static_cast<size_type>(std::abs(static_cast<int>(rowindex-*j))) > b)
@@ -498,8 +641,12 @@ DynamicSparsityPattern::memory_consumption () const
                   + MemoryConsumption::memory_consumption(rowset)
                   - sizeof(rowset);
 
-  for (size_type i=0; i<lines.size(); ++i)
-    mem += MemoryConsumption::memory_consumption (lines[i]);
+  // with a pool, the memory of the rows is accounted for by the pool
+  if (row_pool)
+    mem += row_pool->memory_consumption() + lines.capacity()*sizeof(Line);
+  else
+    for (size_type i=0; i<lines.size(); ++i)
+      mem += MemoryConsumption::memory_consumption (lines[i]);
 
   return mem;
 }
@@ -517,6 +664,10 @@ template void DynamicSparsityPattern::Line::
 add_entries(std::vector<size_type>::iterator,
             std::vector<size_type>::iterator,
             const bool);
+template void DynamicSparsityPattern::Line::
+add_entries(std::vector<size_type>::const_iterator,
+            std::vector<size_type>::const_iterator,
+            const bool);
 #endif
 
 DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,235 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/lac/mapped_vector_memory.h>
+
+#if defined(DEAL_II_HAVE_UNISTD_H) && !defined(DEAL_II_MSVC)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  define DEAL_II_MAPPED_VECTOR_MEMORY
+#endif
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  // the memory of the vectors of the pool is unmapped by the pool, not by
+  // the vectors
+  void do_not_free (void *)
+  {}
+}
+
+
+
+template <typename Number>
+MappedVectorMemory<Number>::MappedVectorMemory (const size_type    vector_size,
+                                                const std::string &directory)
+  :
+  vector_size (vector_size),
+  file_template (directory + "/dealii_vector_XXXXXX")
+{
+#ifndef DEAL_II_MAPPED_VECTOR_MEMORY
+  AssertThrow (false, ExcMessage ("MappedVectorMemory needs the POSIX functions "
+                                  "mkstemp and mmap, which are not available "
+                                  "on this system."));
+#endif
+}
+
+
+
+template <typename Number>
+MappedVectorMemory<Number>::~MappedVectorMemory ()
+{
+#ifdef DEAL_II_MAPPED_VECTOR_MEMORY
+  unsigned int n_in_use = 0;
+  for (unsigned int i=0; i<entries.size(); ++i)
+    {
+      n_in_use += entries[i].in_use;
+      if (entries[i].data != nullptr)
+        munmap (entries[i].data, vector_size*sizeof(Number));
+    }
+  AssertNothrow (n_in_use == 0, StandardExceptions::ExcMemoryLeak(n_in_use));
+#endif
+}
+
+
+
+template <typename Number>
+Vector<Number> *
+MappedVectorMemory<Number>::alloc ()
+{
+  Threads::Mutex::ScopedLock lock(mutex);
+  for (unsigned int i=0; i<entries.size(); ++i)
+    if (entries[i].in_use == false)
+      {
+        entries[i].in_use = true;
+        return entries[i].vector.get();
+      }
+
+  Entry entry;
+  entry.data = nullptr;
+  entry.in_use = true;
+#ifdef DEAL_II_MAPPED_VECTOR_MEMORY
+  if (vector_size > 0)
+    {
+      std::vector<char> file_name (file_template.begin(), file_template.end());
+      file_name.push_back ('\0');
+      const int fd = mkstemp (file_name.data());
+      AssertThrow (fd != -1,
+                   ExcMessage ("Could not create a file for the vector in '" +
+                               file_template + "': " + std::strerror(errno)));
+
+      // remove the file from the file system right away, the data stays
+      // accessible through the mapping and the space is reclaimed once the
+      // mapping is removed
+      unlink (file_name.data());
+      const std::size_t n_bytes = vector_size*sizeof(Number);
+      const int error = ftruncate (fd, n_bytes);
+      void *data = nullptr;
+      if (error == 0)
+        data = mmap (nullptr, n_bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     fd, 0);
+      const int error_number = errno;
+      close (fd);
+      AssertThrow (error == 0 && data != MAP_FAILED,
+                   ExcMessage ("Could not map a file of " +
+                               Utilities::to_string(n_bytes) +
+                               " bytes for the vector: " +
+                               std::strerror(error_number)));
+      entry.data = static_cast<Number *>(data);
+    }
+#endif
+  entry.vector.reset (new Vector<Number>());
+  make_view (entry);
+  entries.push_back (std::move(entry));
+  return entries.back().vector.get();
+}
+
+
+
+template <typename Number>
+void
+MappedVectorMemory<Number>::free (const Vector<Number> *const vector)
+{
+  Threads::Mutex::ScopedLock lock(mutex);
+  Entry *entry = const_cast<Entry *>(find_entry(*vector));
+  Assert (entry != nullptr && entry->in_use,
+          typename VectorMemory<Vector<Number> >::ExcNotAllocatedHere());
+
+  // the user might have reinitialized the vector to a different size, so
+  // point it to the mapped memory again
+  if (vector->begin() != entry->data || vector->size() != vector_size)
+    make_view (*entry);
+  entry->in_use = false;
+}
+
+
+
+template <typename Number>
+void
+MappedVectorMemory<Number>::prefetch (const Vector<Number> &vector) const
+{
+#ifdef DEAL_II_MAPPED_VECTOR_MEMORY
+  Threads::Mutex::ScopedLock lock(mutex);
+  const Entry *entry = find_entry(vector);
+  if (entry != nullptr && entry->data != nullptr &&
+      vector.begin() == entry->data)
+    madvise (entry->data, vector_size*sizeof(Number), MADV_WILLNEED);
+#else
+  (void)vector;
+#endif
+}
+
+
+
+template <typename Number>
+void
+MappedVectorMemory<Number>::evict (const Vector<Number> &vector) const
+{
+#ifdef DEAL_II_MAPPED_VECTOR_MEMORY
+  // for a shared file mapping, modified pages are kept by the file cache and
+  // written to the file rather than discarded
+  Threads::Mutex::ScopedLock lock(mutex);
+  const Entry *entry = find_entry(vector);
+  if (entry != nullptr && entry->data != nullptr &&
+      vector.begin() == entry->data)
+    madvise (entry->data, vector_size*sizeof(Number), MADV_DONTNEED);
+#else
+  (void)vector;
+#endif
+}
+
+
+
+template <typename Number>
+unsigned int
+MappedVectorMemory<Number>::n_vectors () const
+{
+  Threads::Mutex::ScopedLock lock(mutex);
+  return entries.size();
+}
+
+
+
+template <typename Number>
+std::size_t
+MappedVectorMemory<Number>::memory_consumption () const
+{
+  Threads::Mutex::ScopedLock lock(mutex);
+  return sizeof(*this) + entries.capacity()*sizeof(Entry) +
+         entries.size()*sizeof(Vector<Number>) + file_template.capacity();
+}
+
+
+
+template <typename Number>
+const typename MappedVectorMemory<Number>::Entry *
+MappedVectorMemory<Number>::find_entry (const Vector<Number> &vector) const
+{
+  for (unsigned int i=0; i<entries.size(); ++i)
+    if (entries[i].vector.get() == &vector)
+      return &entries[i];
+  Assert (false, typename VectorMemory<Vector<Number> >::ExcNotAllocatedHere());
+  return nullptr;
+}
+
+
+
+template <typename Number>
+void
+MappedVectorMemory<Number>::make_view (Entry &entry) const
+{
+  Vector<Number> &vector = *entry.vector;
+  vector.values = std::unique_ptr<Number[], decltype(&::free)>
+                  (entry.data, &do_not_free);
+  vector.vec_size = entry.data != nullptr ? vector_size : 0;
+  vector.max_vec_size = vector.vec_size;
+  vector.thread_loop_partitioner.reset(new parallel::internal::TBBPartitioner());
+}
+
+
+
+template class MappedVectorMemory<float>;
+template class MappedVectorMemory<double>;
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,133 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/lac/petsc_matrix_free_operator.h>
+
+#ifdef DEAL_II_WITH_PETSC
+
+#include <deal.II/lac/exceptions.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace PETScWrappers
+{
+  namespace
+  {
+    // the name under which the deal.II vector is attached to the PETSc
+    // vector
+    const char *const vector_view_name = "dealii_distributed_vector";
+
+
+
+    PetscErrorCode delete_owned_vector (void *vector)
+    {
+      delete static_cast<LinearAlgebra::distributed::Vector<PetscScalar> *>(vector);
+      return 0;
+    }
+
+
+
+    Vec create_view (LinearAlgebra::distributed::Vector<PetscScalar> &vector,
+                     const bool                                      owns_vector);
+
+
+
+    // the duplicate operation of the PETSc vectors: create a new deal.II
+    // vector with the same layout and let the new PETSc vector own it
+    PetscErrorCode duplicate_vector_view (Vec vector, Vec *new_vector)
+    {
+      const LinearAlgebra::distributed::Vector<PetscScalar> *dealii_vector =
+        get_vector_view (vector);
+      Assert (dealii_vector != nullptr, ExcInternalError());
+
+      LinearAlgebra::distributed::Vector<PetscScalar> *copy =
+        new LinearAlgebra::distributed::Vector<PetscScalar>(dealii_vector->get_partitioner());
+      *new_vector = create_view (*copy, true);
+      return 0;
+    }
+
+
+
+    Vec create_view (LinearAlgebra::distributed::Vector<PetscScalar> &vector,
+                     const bool                                      owns_vector)
+    {
+      const MPI_Comm &communicator = vector.get_mpi_communicator();
+      Vec petsc_vector;
+      PetscErrorCode ierr = VecCreateMPIWithArray (communicator, 1,
+                                                   vector.local_size(),
+                                                   vector.size(),
+                                                   vector.begin(),
+                                                   &petsc_vector);
+      AssertThrow (ierr == 0, ExcPETScError(ierr));
+
+      // attach the deal.II vector to the PETSc vector. The container is
+      // referenced by the PETSc vector, so we can release our reference
+      PetscContainer container;
+      ierr = PetscContainerCreate (communicator, &container);
+      AssertThrow (ierr == 0, ExcPETScError(ierr));
+      ierr = PetscContainerSetPointer (container, &vector);
+      AssertThrow (ierr == 0, ExcPETScError(ierr));
+      if (owns_vector)
+        {
+          ierr = PetscContainerSetUserDestroy (container, &delete_owned_vector);
+          AssertThrow (ierr == 0, ExcPETScError(ierr));
+        }
+      ierr = PetscObjectCompose (reinterpret_cast<PetscObject>(petsc_vector),
+                                 vector_view_name,
+                                 reinterpret_cast<PetscObject>(container));
+      AssertThrow (ierr == 0, ExcPETScError(ierr));
+      ierr = PetscContainerDestroy (&container);
+      AssertThrow (ierr == 0, ExcPETScError(ierr));
+
+      ierr = VecSetOperation (petsc_vector, VECOP_DUPLICATE,
+                              (void( *)(void))&duplicate_vector_view);
+      AssertThrow (ierr == 0, ExcPETScError(ierr));
+
+      return petsc_vector;
+    }
+  }
+
+
+
+  Vec create_vector_view (LinearAlgebra::distributed::Vector<PetscScalar> &vector)
+  {
+    return create_view (vector, false);
+  }
+
+
+
+  LinearAlgebra::distributed::Vector<PetscScalar> *
+  get_vector_view (const Vec &vector)
+  {
+    PetscObject container = nullptr;
+    PetscErrorCode ierr = PetscObjectQuery (reinterpret_cast<PetscObject>(vector),
+                                            vector_view_name, &container);
+    AssertThrow (ierr == 0, ExcPETScError(ierr));
+    if (container == nullptr)
+      return nullptr;
+
+    void *dealii_vector = nullptr;
+    ierr = PetscContainerGetPointer (reinterpret_cast<PetscContainer>(container),
+                                     &dealii_vector);
+    AssertThrow (ierr == 0, ExcPETScError(ierr));
+    return static_cast<LinearAlgebra::distributed::Vector<PetscScalar> *>(dealii_vector);
+  }
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // DEAL_II_WITH_PETSC
@@ -0,0 +1,950 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/lac/precondition_amg.h>
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/thread_local_storage.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  // the number of rows that are worked on by one task in the loops over the
+  // rows of a matrix during the setup
+  const unsigned int grain_size = 256;
+
+  // the number of consecutive rows that are aggregated independently of the
+  // others. as the chunks are fixed, the aggregates do not depend on the
+  // number of threads
+  const unsigned int aggregation_chunk_size = 4096;
+
+
+
+  /**
+   * A matrix in compressed row storage with the columns of each row sorted,
+   * which is used for the matrices of the hierarchy during the setup. In
+   * contrast to SparseMatrix, the rows of a rectangular matrix can be built
+   * in parallel without first setting up a sparsity pattern.
+   */
+  struct CSRMatrix
+  {
+    unsigned int n_rows;
+    unsigned int n_cols;
+    std::vector<std::size_t> row_start;
+    std::vector<unsigned int> columns;
+    std::vector<double> values;
+  };
+
+
+
+  /**
+   * Collects the entries of one row of a matrix product in a dense array of
+   * the size of the number of columns, together with the list of the
+   * columns that have been touched. Rather than clearing the marker array
+   * between rows, the marker of a column is compared with a counter that is
+   * increased for each row.
+   */
+  struct RowAccumulator
+  {
+    RowAccumulator ()
+      :
+      stamp (0)
+    {}
+
+    void start_row (const unsigned int n_cols)
+    {
+      if (marker.size() != n_cols)
+        {
+          marker.clear();
+          marker.resize(n_cols, 0);
+          row_values.resize(n_cols);
+          stamp = 0;
+        }
+      ++stamp;
+      if (stamp == 0)
+        {
+          std::fill(marker.begin(), marker.end(), 0);
+          stamp = 1;
+        }
+      touched.clear();
+    }
+
+    void add (const unsigned int column,
+              const double       value)
+    {
+      if (marker[column] != stamp)
+        {
+          marker[column] = stamp;
+          row_values[column] = value;
+          touched.push_back(column);
+        }
+      else
+        row_values[column] += value;
+    }
+
+    std::vector<double>       row_values;
+    std::vector<unsigned int> marker;
+    std::vector<unsigned int> touched;
+    unsigned int              stamp;
+  };
+
+
+
+  /**
+   * Build a matrix with the given number of rows and columns whose rows are
+   * computed by <tt>row_function(row, accumulator)</tt>. The rows are
+   * computed twice in parallel, first to determine the length of each row
+   * and then to fill the entries.
+   */
+  template <typename RowFunction>
+  void
+  build_csr (const unsigned int  n_rows,
+             const unsigned int  n_cols,
+             const RowFunction  &row_function,
+             CSRMatrix          &result)
+  {
+    result.n_rows = n_rows;
+    result.n_cols = n_cols;
+    result.row_start.resize(n_rows+1);
+    result.row_start[0] = 0;
+
+    Threads::ThreadLocalStorage<RowAccumulator> accumulators;
+    parallel::apply_to_subranges
+    (0U, n_rows,
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      RowAccumulator &accumulator = accumulators.get();
+      for (unsigned int row=begin; row<end; ++row)
+        {
+          accumulator.start_row(n_cols);
+          row_function(row, accumulator);
+          result.row_start[row+1] = accumulator.touched.size();
+        }
+    },
+    grain_size);
+
+    for (unsigned int row=0; row<n_rows; ++row)
+      result.row_start[row+1] += result.row_start[row];
+    result.columns.resize(result.row_start[n_rows]);
+    result.values.resize(result.row_start[n_rows]);
+
+    parallel::apply_to_subranges
+    (0U, n_rows,
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      RowAccumulator &accumulator = accumulators.get();
+      for (unsigned int row=begin; row<end; ++row)
+        {
+          accumulator.start_row(n_cols);
+          row_function(row, accumulator);
+          std::sort(accumulator.touched.begin(), accumulator.touched.end());
+          std::size_t index = result.row_start[row];
+          for (const unsigned int column : accumulator.touched)
+            {
+              result.columns[index] = column;
+              result.values[index] = accumulator.row_values[column];
+              ++index;
+            }
+        }
+    },
+    grain_size);
+  }
+
+
+
+  /**
+   * Copy a SparseMatrix into the CSR format. The diagonal entry of each row
+   * is kept first as in SparseMatrix, which is not a problem for the matrix
+   * products that use this matrix as left factor.
+   */
+  void
+  copy_to_csr (const SparseMatrix<double> &matrix,
+               CSRMatrix                  &result)
+  {
+    const unsigned int n_rows = matrix.m();
+    result.n_rows = n_rows;
+    result.n_cols = matrix.n();
+    result.row_start.resize(n_rows+1);
+    result.row_start[0] = 0;
+    for (unsigned int row=0; row<n_rows; ++row)
+      result.row_start[row+1] = result.row_start[row] + matrix.get_row_length(row);
+    result.columns.resize(result.row_start[n_rows]);
+    result.values.resize(result.row_start[n_rows]);
+
+    parallel::apply_to_subranges
+    (0U, n_rows,
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      for (unsigned int row=begin; row<end; ++row)
+        {
+          std::size_t index = result.row_start[row];
+          for (SparseMatrix<double>::const_iterator entry=matrix.begin(row);
+               entry != matrix.end(row); ++entry, ++index)
+            {
+              result.columns[index] = entry->column();
+              result.values[index] = entry->value();
+            }
+        }
+    },
+    grain_size);
+  }
+
+
+
+  /**
+   * Copy a matrix in CSR format into a sparsity pattern and a sparse matrix.
+   */
+  void
+  copy_from_csr (const CSRMatrix      &csr,
+                 SparsityPattern      &sparsity,
+                 SparseMatrix<double> &matrix)
+  {
+    std::vector<ArrayView<const unsigned int> > rows;
+    rows.reserve(csr.n_rows);
+    for (unsigned int row=0; row<csr.n_rows; ++row)
+      rows.emplace_back(csr.columns.data() + csr.row_start[row],
+                        csr.row_start[row+1] - csr.row_start[row]);
+    sparsity.copy_from(csr.n_rows, csr.n_cols, rows.begin(), rows.end());
+    matrix.reinit(sparsity);
+
+    parallel::apply_to_subranges
+    (0U, csr.n_rows,
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      for (unsigned int row=begin; row<end; ++row)
+        for (std::size_t index=csr.row_start[row]; index<csr.row_start[row+1]; ++index)
+          matrix.set(row, csr.columns[index], csr.values[index]);
+    },
+    grain_size);
+  }
+
+
+
+  /**
+   * Compute the product of two matrices in CSR format.
+   */
+  void
+  multiply (const CSRMatrix &a,
+            const CSRMatrix &b,
+            CSRMatrix       &result)
+  {
+    Assert (a.n_cols == b.n_rows, ExcDimensionMismatch(a.n_cols, b.n_rows));
+    build_csr(a.n_rows, b.n_cols,
+              [&] (const unsigned int row, RowAccumulator &accumulator)
+    {
+      for (std::size_t i=a.row_start[row]; i<a.row_start[row+1]; ++i)
+        {
+          const unsigned int k = a.columns[i];
+          const double a_ik = a.values[i];
+          for (std::size_t j=b.row_start[k]; j<b.row_start[k+1]; ++j)
+            accumulator.add(b.columns[j], a_ik * b.values[j]);
+        }
+    },
+    result);
+  }
+
+
+
+  /**
+   * Compute the transpose of a matrix in CSR format. The columns of the
+   * result are sorted as the rows of the input are traversed in order.
+   */
+  void
+  transpose (const CSRMatrix &matrix,
+             CSRMatrix       &result)
+  {
+    result.n_rows = matrix.n_cols;
+    result.n_cols = matrix.n_rows;
+    result.row_start.clear();
+    result.row_start.resize(result.n_rows+1, 0);
+    for (const unsigned int column : matrix.columns)
+      ++result.row_start[column+1];
+    for (unsigned int row=0; row<result.n_rows; ++row)
+      result.row_start[row+1] += result.row_start[row];
+    result.columns.resize(matrix.columns.size());
+    result.values.resize(matrix.values.size());
+
+    std::vector<std::size_t> position(result.row_start.begin(),
+                                      result.row_start.end()-1);
+    for (unsigned int row=0; row<matrix.n_rows; ++row)
+      for (std::size_t i=matrix.row_start[row]; i<matrix.row_start[row+1]; ++i)
+        {
+          const std::size_t index = position[matrix.columns[i]]++;
+          result.columns[index] = row;
+          result.values[index] = matrix.values[i];
+        }
+  }
+
+
+
+  /**
+   * Return the diagonal of a square matrix in CSR format.
+   */
+  std::vector<double>
+  extract_diagonal (const CSRMatrix &matrix)
+  {
+    std::vector<double> diagonal(matrix.n_rows, 0.);
+    parallel::apply_to_subranges
+    (0U, matrix.n_rows,
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      for (unsigned int row=begin; row<end; ++row)
+        for (std::size_t i=matrix.row_start[row]; i<matrix.row_start[row+1]; ++i)
+          if (matrix.columns[i] == row)
+            diagonal[row] += matrix.values[i];
+    },
+    grain_size);
+    return diagonal;
+  }
+
+
+
+  /**
+   * Group the rows of the matrix into aggregates of strongly coupled rows
+   * and return the number of aggregates. The aggregate of each row is
+   * written into @p aggregate_index, with numbers::invalid_unsigned_int for
+   * the rows that do not have any strong coupling.
+   *
+   * The rows are split into chunks of consecutive rows that are aggregated
+   * independently in parallel, considering only the couplings within the
+   * chunk. Within a chunk, we first form aggregates of a row and its strong
+   * neighbors whenever none of the neighbors is aggregated yet, then attach
+   * the remaining rows to the aggregate of their strongest neighbor, and
+   * finally form aggregates of the rows that are still left.
+   */
+  unsigned int
+  compute_aggregates (const CSRMatrix           &matrix,
+                      const std::vector<double> &diagonal,
+                      const double               threshold,
+                      std::vector<unsigned int> &aggregate_index)
+  {
+    const unsigned int n_rows = matrix.n_rows;
+
+    // the strength of the coupling of each entry, set to zero for the
+    // entries that are not strong
+    std::vector<double> strength(matrix.columns.size(), 0.);
+    parallel::apply_to_subranges
+    (0U, n_rows,
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      for (unsigned int row=begin; row<end; ++row)
+        for (std::size_t i=matrix.row_start[row]; i<matrix.row_start[row+1]; ++i)
+          {
+            const unsigned int column = matrix.columns[i];
+            if (column == row)
+              continue;
+            const double value = std::abs(matrix.values[i]);
+            if (value > 0 &&
+                value >= threshold * std::sqrt(std::abs(diagonal[row] *
+                                                        diagonal[column])))
+              strength[i] = value;
+          }
+    },
+    grain_size);
+
+    aggregate_index.clear();
+    aggregate_index.resize(n_rows, numbers::invalid_unsigned_int);
+
+    const unsigned int n_chunks = (n_rows + aggregation_chunk_size - 1) /
+                                  aggregation_chunk_size;
+    std::vector<unsigned int> n_chunk_aggregates(n_chunks+1, 0);
+
+    parallel::apply_to_subranges
+    (0U, n_chunks,
+     [&] (const unsigned int chunk_begin, const unsigned int chunk_end)
+    {
+      std::vector<unsigned int> new_index;
+      for (unsigned int chunk=chunk_begin; chunk<chunk_end; ++chunk)
+        {
+          const unsigned int begin = chunk * aggregation_chunk_size;
+          const unsigned int end = std::min(n_rows, begin + aggregation_chunk_size);
+          unsigned int n_aggregates = 0;
+
+          // phase 1: aggregates of rows whose strong neighbors are all free
+          for (unsigned int row=begin; row<end; ++row)
+            {
+              if (aggregate_index[row] != numbers::invalid_unsigned_int)
+                continue;
+              bool has_strong = false, neighbors_free = true;
+              for (std::size_t i=matrix.row_start[row]; i<matrix.row_start[row+1]; ++i)
+                if (strength[i] > 0)
+                  {
+                    has_strong = true;
+                    const unsigned int column = matrix.columns[i];
+                    if (column >= begin && column < end &&
+                        aggregate_index[column] != numbers::invalid_unsigned_int)
+                      {
+                        neighbors_free = false;
+                        break;
+                      }
+                  }
+              if (has_strong == false || neighbors_free == false)
+                continue;
+
+              aggregate_index[row] = n_aggregates;
+              for (std::size_t i=matrix.row_start[row]; i<matrix.row_start[row+1]; ++i)
+                if (strength[i] > 0 &&
+                    matrix.columns[i] >= begin && matrix.columns[i] < end)
+                  aggregate_index[matrix.columns[i]] = n_aggregates;
+              ++n_aggregates;
+            }
+
+          // phase 2: attach rows to the aggregate of the strongest neighbor
+          // from phase 1. the assignment is collected first to not let rows
+          // attach to neighbors that were only attached in this phase
+          new_index.assign(aggregate_index.begin()+begin,
+                           aggregate_index.begin()+end);
+          for (unsigned int row=begin; row<end; ++row)
+            {
+              if (aggregate_index[row] != numbers::invalid_unsigned_int)
+                continue;
+              double max_strength = 0;
+              for (std::size_t i=matrix.row_start[row]; i<matrix.row_start[row+1]; ++i)
+                {
+                  const unsigned int column = matrix.columns[i];
+                  if (strength[i] > max_strength &&
+                      column >= begin && column < end &&
+                      aggregate_index[column] != numbers::invalid_unsigned_int)
+                    {
+                      max_strength = strength[i];
+                      new_index[row-begin] = aggregate_index[column];
+                    }
+                }
+            }
+          std::copy(new_index.begin(), new_index.end(),
+                    aggregate_index.begin()+begin);
+
+          // phase 3: aggregates of the remaining rows with strong couplings
+          // and their free strong neighbors
+          for (unsigned int row=begin; row<end; ++row)
+            {
+              if (aggregate_index[row] != numbers::invalid_unsigned_int)
+                continue;
+              bool has_strong = false;
+              for (std::size_t i=matrix.row_start[row]; i<matrix.row_start[row+1]; ++i)
+                if (strength[i] > 0)
+                  {
+                    has_strong = true;
+                    const unsigned int column = matrix.columns[i];
+                    if (column >= begin && column < end &&
+                        aggregate_index[column] == numbers::invalid_unsigned_int)
+                      aggregate_index[column] = n_aggregates;
+                  }
+              if (has_strong)
+                aggregate_index[row] = n_aggregates++;
+            }
+
+          n_chunk_aggregates[chunk+1] = n_aggregates;
+        }
+    },
+    1);
+
+    for (unsigned int chunk=0; chunk<n_chunks; ++chunk)
+      n_chunk_aggregates[chunk+1] += n_chunk_aggregates[chunk];
+
+    parallel::apply_to_subranges
+    (0U, n_rows,
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      for (unsigned int row=begin; row<end; ++row)
+        if (aggregate_index[row] != numbers::invalid_unsigned_int)
+          aggregate_index[row] += n_chunk_aggregates[row/aggregation_chunk_size];
+    },
+    grain_size);
+
+    return n_chunk_aggregates[n_chunks];
+  }
+
+
+
+  /**
+   * Compute the tentative prolongator from the aggregates by
+   * orthonormalizing the vectors of the near null space restricted to each
+   * aggregate. The near null space is stored row by row in @p null_space
+   * with @p n_modes entries per row, and the near null space of the coarse
+   * level, i.e., the coefficients of the orthogonalization, is returned in
+   * @p coarse_null_space. Vectors that are linearly dependent on the
+   * previous ones on an aggregate are dropped, so that the aggregate gets
+   * fewer coarse unknowns. Returns the number of coarse unknowns.
+   */
+  unsigned int
+  compute_tentative_prolongator (const std::vector<unsigned int> &aggregate_index,
+                                 const unsigned int               n_aggregates,
+                                 const std::vector<double>       &null_space,
+                                 const unsigned int               n_modes,
+                                 CSRMatrix                       &prolongator,
+                                 std::vector<double>             &coarse_null_space)
+  {
+    const unsigned int n_rows = aggregate_index.size();
+
+    // sort the rows by aggregates
+    std::vector<unsigned int> aggregate_start(n_aggregates+1, 0);
+    for (unsigned int row=0; row<n_rows; ++row)
+      if (aggregate_index[row] != numbers::invalid_unsigned_int)
+        ++aggregate_start[aggregate_index[row]+1];
+    for (unsigned int a=0; a<n_aggregates; ++a)
+      aggregate_start[a+1] += aggregate_start[a];
+    std::vector<unsigned int> aggregate_rows(aggregate_start[n_aggregates]);
+    {
+      std::vector<unsigned int> position(aggregate_start.begin(),
+                                         aggregate_start.end()-1);
+      for (unsigned int row=0; row<n_rows; ++row)
+        if (aggregate_index[row] != numbers::invalid_unsigned_int)
+          aggregate_rows[position[aggregate_index[row]]++] = row;
+    }
+
+    // orthonormalize the near null space on one aggregate with the modified
+    // Gram-Schmidt method. the basis is stored column by column in q, and
+    // the coefficients in r, with the accepted columns of the input
+    // recorded in the upper triangular matrix r of size n_modes * n_modes
+    const auto orthonormalize
+      = [&] (const unsigned int a,
+             std::vector<double> &q,
+             std::vector<double> &r) -> unsigned int
+    {
+      const unsigned int size = aggregate_start[a+1] - aggregate_start[a];
+      const unsigned int *rows = aggregate_rows.data() + aggregate_start[a];
+      q.resize(size * n_modes);
+      r.assign(n_modes * n_modes, 0.);
+      std::vector<double> v(size);
+      unsigned int n_accepted = 0;
+      for (unsigned int c=0; c<n_modes; ++c)
+        {
+          double original_norm = 0;
+          for (unsigned int i=0; i<size; ++i)
+            {
+              v[i] = null_space[rows[i]*n_modes+c];
+              original_norm += v[i] * v[i];
+            }
+          original_norm = std::sqrt(original_norm);
+          for (unsigned int j=0; j<n_accepted; ++j)
+            {
+              double product = 0;
+              for (unsigned int i=0; i<size; ++i)
+                product += q[j*size+i] * v[i];
+              for (unsigned int i=0; i<size; ++i)
+                v[i] -= product * q[j*size+i];
+              r[j*n_modes+c] = product;
+            }
+          double norm = 0;
+          for (unsigned int i=0; i<size; ++i)
+            norm += v[i] * v[i];
+          norm = std::sqrt(norm);
+          if (norm > 1e-10 * original_norm && norm > 0)
+            {
+              for (unsigned int i=0; i<size; ++i)
+                q[n_accepted*size+i] = v[i] / norm;
+              r[n_accepted*n_modes+c] = norm;
+              ++n_accepted;
+            }
+        }
+      return n_accepted;
+    };
+
+    // first pass: count the coarse unknowns of each aggregate
+    std::vector<unsigned int> coarse_start(n_aggregates+1, 0);
+    parallel::apply_to_subranges
+    (0U, n_aggregates,
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      std::vector<double> q, r;
+      for (unsigned int a=begin; a<end; ++a)
+        coarse_start[a+1] = orthonormalize(a, q, r);
+    },
+    grain_size);
+    for (unsigned int a=0; a<n_aggregates; ++a)
+      coarse_start[a+1] += coarse_start[a];
+    const unsigned int n_coarse = coarse_start[n_aggregates];
+
+    prolongator.n_rows = n_rows;
+    prolongator.n_cols = n_coarse;
+    prolongator.row_start.resize(n_rows+1);
+    prolongator.row_start[0] = 0;
+    for (unsigned int row=0; row<n_rows; ++row)
+      {
+        const unsigned int a = aggregate_index[row];
+        prolongator.row_start[row+1] = prolongator.row_start[row] +
+                                       (a == numbers::invalid_unsigned_int ? 0 :
+                                        coarse_start[a+1] - coarse_start[a]);
+      }
+    prolongator.columns.resize(prolongator.row_start[n_rows]);
+    prolongator.values.resize(prolongator.row_start[n_rows]);
+    coarse_null_space.resize(n_coarse * n_modes);
+
+    // second pass: fill the prolongator and the coarse near null space
+    parallel::apply_to_subranges
+    (0U, n_aggregates,
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      std::vector<double> q, r;
+      for (unsigned int a=begin; a<end; ++a)
+        {
+          const unsigned int n_accepted = orthonormalize(a, q, r);
+          const unsigned int size = aggregate_start[a+1] - aggregate_start[a];
+          for (unsigned int i=0; i<size; ++i)
+            {
+              const unsigned int row = aggregate_rows[aggregate_start[a]+i];
+              std::size_t index = prolongator.row_start[row];
+              for (unsigned int j=0; j<n_accepted; ++j, ++index)
+                {
+                  prolongator.columns[index] = coarse_start[a] + j;
+                  prolongator.values[index] = q[j*size+i];
+                }
+            }
+          for (unsigned int j=0; j<n_accepted; ++j)
+            for (unsigned int c=0; c<n_modes; ++c)
+              coarse_null_space[(coarse_start[a]+j)*n_modes+c] = r[j*n_modes+c];
+        }
+    },
+    grain_size);
+
+    return n_coarse;
+  }
+
+
+
+  /**
+   * Smooth the tentative prolongator by one step of the damped Jacobi
+   * method, $P = (I - \omega D^{-1} A) P_0$ with $\omega = 4/(3\lambda)$
+   * and the bound $\lambda$ on the largest eigenvalue of $D^{-1}A$ from the
+   * Gershgorin theorem.
+   */
+  void
+  smooth_prolongator (const CSRMatrix           &matrix,
+                      const std::vector<double> &diagonal,
+                      const CSRMatrix           &tentative,
+                      CSRMatrix                 &prolongator)
+  {
+    double lambda = 0;
+    for (unsigned int row=0; row<matrix.n_rows; ++row)
+      if (diagonal[row] != 0)
+        {
+          double row_sum = 0;
+          for (std::size_t i=matrix.row_start[row]; i<matrix.row_start[row+1]; ++i)
+            row_sum += std::abs(matrix.values[i]);
+          lambda = std::max(lambda, row_sum / std::abs(diagonal[row]));
+        }
+    const double omega = lambda > 0 ? 4. / (3. * lambda) : 0.;
+
+    build_csr(matrix.n_rows, tentative.n_cols,
+              [&] (const unsigned int row, RowAccumulator &accumulator)
+    {
+      for (std::size_t j=tentative.row_start[row]; j<tentative.row_start[row+1]; ++j)
+        accumulator.add(tentative.columns[j], tentative.values[j]);
+      if (diagonal[row] == 0)
+        return;
+      const double factor = -omega / diagonal[row];
+      for (std::size_t i=matrix.row_start[row]; i<matrix.row_start[row+1]; ++i)
+        {
+          const unsigned int k = matrix.columns[i];
+          const double a_ik = factor * matrix.values[i];
+          for (std::size_t j=tentative.row_start[k]; j<tentative.row_start[k+1]; ++j)
+            accumulator.add(tentative.columns[j], a_ik * tentative.values[j]);
+        }
+    },
+    prolongator);
+  }
+}
+
+
+
+PreconditionAMG::AdditionalData::
+AdditionalData (const unsigned int                     n_cycles,
+                const double                           aggregation_threshold,
+                const std::vector<std::vector<bool> > &constant_modes,
+                const std::vector<Vector<double> >    &near_null_space,
+                const unsigned int                     smoother_sweeps,
+                const double                           smoothing_range,
+                const unsigned int                     coarse_size,
+                const unsigned int                     max_levels)
+  :
+  n_cycles (n_cycles),
+  aggregation_threshold (aggregation_threshold),
+  constant_modes (constant_modes),
+  near_null_space (near_null_space),
+  smoother_sweeps (smoother_sweeps),
+  smoothing_range (smoothing_range),
+  coarse_size (coarse_size),
+  max_levels (max_levels)
+{}
+
+
+
+PreconditionAMG::PreconditionAMG ()
+  :
+  coarse_solve_is_direct (false),
+  n_cycles (1)
+{}
+
+
+
+PreconditionAMG::~PreconditionAMG ()
+{
+  clear();
+}
+
+
+
+void
+PreconditionAMG::clear ()
+{
+  levels.clear();
+  coarse_solve_is_direct = false;
+  coarse_inverse.reinit(0, 0);
+  residual.reinit(0);
+  correction.reinit(0);
+}
+
+
+
+void
+PreconditionAMG::initialize (const SparseMatrix<double> &matrix,
+                             const AdditionalData       &additional_data)
+{
+  Assert (matrix.m() == matrix.n(),
+          ExcDimensionMismatch(matrix.m(), matrix.n()));
+  AssertThrow (matrix.m() < std::numeric_limits<unsigned int>::max(),
+               ExcMessage("PreconditionAMG only supports matrices whose size "
+                          "fits into an unsigned int."));
+  Assert (additional_data.max_levels > 0,
+          ExcMessage("The hierarchy must consist of at least one level."));
+
+  clear();
+  n_cycles = additional_data.n_cycles;
+
+  const unsigned int n_dofs = matrix.m();
+
+  // set up the near null space of the finest level row by row
+  unsigned int n_modes = additional_data.constant_modes.size() +
+                         additional_data.near_null_space.size();
+  std::vector<double> null_space;
+  if (n_modes == 0)
+    {
+      n_modes = 1;
+      null_space.resize(n_dofs, 1.);
+    }
+  else
+    {
+      null_space.resize(n_dofs * n_modes, 0.);
+      unsigned int mode = 0;
+      for (unsigned int c=0; c<additional_data.constant_modes.size(); ++c, ++mode)
+        {
+          AssertDimension (additional_data.constant_modes[c].size(), n_dofs);
+          for (unsigned int i=0; i<n_dofs; ++i)
+            if (additional_data.constant_modes[c][i])
+              null_space[i*n_modes+mode] = 1.;
+        }
+      for (unsigned int c=0; c<additional_data.near_null_space.size(); ++c, ++mode)
+        {
+          AssertDimension (additional_data.near_null_space[c].size(), n_dofs);
+          for (unsigned int i=0; i<n_dofs; ++i)
+            null_space[i*n_modes+mode] = additional_data.near_null_space[c](i);
+        }
+    }
+
+  levels.emplace_back(new Level());
+  levels[0]->level_matrix = &matrix;
+
+  // build the hierarchy by aggregation and Galerkin products
+  CSRMatrix level_matrix;
+  copy_to_csr(matrix, level_matrix);
+  while (levels.size() < additional_data.max_levels &&
+         level_matrix.n_rows > additional_data.coarse_size)
+    {
+      const std::vector<double> diagonal = extract_diagonal(level_matrix);
+
+      std::vector<unsigned int> aggregate_index;
+      const unsigned int n_aggregates
+        = compute_aggregates(level_matrix, diagonal,
+                             additional_data.aggregation_threshold,
+                             aggregate_index);
+      if (n_aggregates == 0)
+        break;
+
+      CSRMatrix tentative;
+      std::vector<double> coarse_null_space;
+      const unsigned int n_coarse
+        = compute_tentative_prolongator(aggregate_index, n_aggregates,
+                                        null_space, n_modes, tentative,
+                                        coarse_null_space);
+
+      // stop when the coarsening stagnates
+      if (n_coarse == 0 || n_coarse > 0.9 * level_matrix.n_rows)
+        break;
+
+      CSRMatrix prolongation, restriction, product, coarse_matrix;
+      smooth_prolongator(level_matrix, diagonal, tentative, prolongation);
+      transpose(prolongation, restriction);
+      multiply(level_matrix, prolongation, product);
+      multiply(restriction, product, coarse_matrix);
+
+      Level &fine = *levels.back();
+      copy_from_csr(prolongation, fine.prolongation_sparsity, fine.prolongation);
+      copy_from_csr(restriction, fine.restriction_sparsity, fine.restriction);
+
+      levels.emplace_back(new Level());
+      Level &coarse = *levels.back();
+      copy_from_csr(coarse_matrix, coarse.sparsity, coarse.matrix);
+      coarse.level_matrix = &coarse.matrix;
+
+      level_matrix = std::move(coarse_matrix);
+      null_space.swap(coarse_null_space);
+    }
+
+  // set up the smoothers and the vectors of the cycle
+  for (unsigned int level=0; level<levels.size(); ++level)
+    {
+      Level &data = *levels[level];
+      const SparseMatrix<double> &system_matrix = *data.level_matrix;
+
+      PreconditionChebyshev<SparseMatrix<double>,Vector<double> >::AdditionalData
+      smoother_data;
+      smoother_data.degree = additional_data.smoother_sweeps;
+      smoother_data.smoothing_range = additional_data.smoothing_range;
+      smoother_data.preconditioner.reset(new DiagonalMatrix<Vector<double> >());
+      Vector<double> &diagonal_inverse = smoother_data.preconditioner->get_vector();
+      diagonal_inverse.reinit(system_matrix.m());
+      for (unsigned int i=0; i<system_matrix.m(); ++i)
+        {
+          const double diagonal = system_matrix.diag_element(i);
+          diagonal_inverse(i) = diagonal != 0. ? 1. / diagonal : 1.;
+        }
+      data.smoother.initialize(system_matrix, smoother_data);
+
+      if (level > 0)
+        {
+          data.rhs.reinit(system_matrix.m());
+          data.solution.reinit(system_matrix.m());
+        }
+      if (level + 1 < levels.size())
+        data.residual.reinit(system_matrix.m());
+    }
+
+  // factorize the coarsest level if it is small enough
+  const SparseMatrix<double> &coarse_matrix = *levels.back()->level_matrix;
+  if (levels.size() > 1 && coarse_matrix.m() <= additional_data.coarse_size)
+    {
+      coarse_inverse.copy_from(coarse_matrix);
+#ifdef DEAL_II_WITH_LAPACK
+      coarse_inverse.compute_inverse_svd(1e-12);
+#else
+      coarse_inverse.gauss_jordan();
+#endif
+      coarse_solve_is_direct = true;
+    }
+
+  if (n_cycles > 1)
+    {
+      residual.reinit(n_dofs);
+      correction.reinit(n_dofs);
+    }
+}
+
+
+
+void
+PreconditionAMG::v_cycle (const unsigned int    level,
+                          Vector<double>       &dst,
+                          const Vector<double> &src) const
+{
+  const Level &data = *levels[level];
+
+  if (level + 1 == levels.size())
+    {
+      if (coarse_solve_is_direct)
+        coarse_inverse.vmult(dst, src);
+      else
+        data.smoother.vmult(dst, src);
+      return;
+    }
+
+  const Level &coarse = *levels[level+1];
+
+  // pre-smoothing with zero starting value
+  data.smoother.vmult(dst, src);
+
+  // restrict the residual and solve on the coarser level
+  data.level_matrix->residual(data.residual, dst, src);
+  data.restriction.vmult(coarse.rhs, data.residual);
+  v_cycle(level+1, coarse.solution, coarse.rhs);
+  data.prolongation.vmult_add(dst, coarse.solution);
+
+  // post-smoothing
+  data.smoother.step(dst, src);
+}
+
+
+
+void
+PreconditionAMG::vmult (Vector<double>       &dst,
+                        const Vector<double> &src) const
+{
+  Assert (levels.size() > 0, ExcNotInitialized());
+  Threads::Mutex::ScopedLock lock(mutex);
+
+  v_cycle(0, dst, src);
+  for (unsigned int cycle=1; cycle<n_cycles; ++cycle)
+    {
+      levels[0]->level_matrix->residual(residual, dst, src);
+      v_cycle(0, correction, residual);
+      dst += correction;
+    }
+}
+
+
+
+void
+PreconditionAMG::Tvmult (Vector<double>       &dst,
+                         const Vector<double> &src) const
+{
+  vmult(dst, src);
+}
+
+
+
+std::size_t
+PreconditionAMG::memory_consumption () const
+{
+  std::size_t memory = sizeof(*this);
+  for (unsigned int level=0; level<levels.size(); ++level)
+    {
+      const Level &data = *levels[level];
+      memory += (sizeof(Level) +
+                 data.sparsity.memory_consumption() +
+                 data.matrix.memory_consumption() +
+                 data.prolongation_sparsity.memory_consumption() +
+                 data.prolongation.memory_consumption() +
+                 data.restriction_sparsity.memory_consumption() +
+                 data.restriction.memory_consumption() +
+                 data.rhs.memory_consumption() +
+                 data.solution.memory_consumption() +
+                 data.residual.memory_consumption() +
+                 data.level_matrix->m() * sizeof(double));
+    }
+  memory += coarse_inverse.m() * coarse_inverse.n() * sizeof(double);
+  memory += residual.memory_consumption() + correction.memory_consumption();
+  return memory;
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2014 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -15,6 +15,7 @@
 
 #include <deal.II/lac/precondition_block.templates.h>
 #include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/chunk_sparse_matrix.h>
 
 DEAL_II_NAMESPACE_OPEN
 #include "precondition_block.inst"
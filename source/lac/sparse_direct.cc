@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2001 - 2016 by the deal.II authors
+// Copyright (C) 2001 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -16,6 +16,8 @@
 #include <deal.II/lac/sparse_direct.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/sparse_matrix.h>
 #include <deal.II/lac/block_sparse_matrix.h>
 #include <deal.II/lac/vector.h>
@@ -202,15 +204,8 @@ sort_arrays (const BlockSparseMatrix<number> &matrix)
 template <class Matrix>
 void
 SparseDirectUMFPACK::
-factorize (const Matrix &matrix)
+copy_matrix_to_arrays (const Matrix &matrix)
 {
-  Assert (matrix.m() == matrix.n(), ExcNotQuadratic())
-
-  clear ();
-
-  _m = matrix.m();
-  _n = matrix.n();
-
   const size_type N = matrix.m();
 
   // copy over the data from the matrix to the data structures UMFPACK
@@ -276,23 +271,103 @@ factorize (const Matrix &matrix)
   // careful for block sparse matrices, so ship this task out to a
   // different function
   sort_arrays (matrix);
+}
 
-  int status;
-  status = umfpack_dl_symbolic (N, N,
-                                Ap.data(), Ai.data(), Ax.data(),
-                                &symbolic_decomposition,
-                                control.data(), nullptr);
+
+
+void
+SparseDirectUMFPACK::compute_symbolic_decomposition ()
+{
+  if (symbolic_decomposition != nullptr)
+    {
+      umfpack_dl_free_symbolic (&symbolic_decomposition);
+      symbolic_decomposition = nullptr;
+    }
+
+  const SuiteSparse_long N = Ap.size()-1;
+  const int status = umfpack_dl_symbolic (N, N,
+                                          Ap.data(), Ai.data(), Ax.data(),
+                                          &symbolic_decomposition,
+                                          control.data(), nullptr);
   AssertThrow (status == UMFPACK_OK,
                ExcUMFPACKError("umfpack_dl_symbolic", status));
+}
+
 
-  status = umfpack_dl_numeric (Ap.data(), Ai.data(), Ax.data(),
-                               symbolic_decomposition,
-                               &numeric_decomposition,
-                               control.data(), nullptr);
+
+void
+SparseDirectUMFPACK::compute_numeric_decomposition ()
+{
+  Assert (symbolic_decomposition != nullptr, ExcNotInitialized());
+
+  if (numeric_decomposition != nullptr)
+    {
+      umfpack_dl_free_numeric (&numeric_decomposition);
+      numeric_decomposition = nullptr;
+    }
+
+  const int status = umfpack_dl_numeric (Ap.data(), Ai.data(), Ax.data(),
+                                         symbolic_decomposition,
+                                         &numeric_decomposition,
+                                         control.data(), nullptr);
   AssertThrow (status == UMFPACK_OK,
                ExcUMFPACKError("umfpack_dl_numeric", status));
+}
+
+
 
-  umfpack_dl_free_symbolic (&symbolic_decomposition) ;
+template <class Matrix>
+void
+SparseDirectUMFPACK::
+factorize (const Matrix &matrix)
+{
+  Assert (matrix.m() == matrix.n(), ExcNotQuadratic())
+
+  clear ();
+
+  _m = matrix.m();
+  _n = matrix.n();
+
+  copy_matrix_to_arrays (matrix);
+
+  // the symbolic decomposition is kept around after the numeric
+  // factorization, so that refactorize() can reuse it for matrices with the
+  // same sparsity pattern
+  compute_symbolic_decomposition ();
+  compute_numeric_decomposition ();
+}
+
+
+
+template <class Matrix>
+void
+SparseDirectUMFPACK::
+refactorize (const Matrix &matrix)
+{
+  Assert (matrix.m() == matrix.n(), ExcNotQuadratic())
+
+  // without a previous factorization or with a different size, there is
+  // nothing to reuse
+  if (symbolic_decomposition == nullptr || matrix.m() != _m)
+    {
+      factorize (matrix);
+      return;
+    }
+
+  // keep the index arrays of the previous factorization to check whether the
+  // symbolic decomposition is still valid. UMFPACK's symbolic analysis only
+  // looks at the positions of the entries, so identical arrays Ap and Ai are
+  // all that is needed to reuse it
+  std::vector<SuiteSparse_long> previous_Ap, previous_Ai;
+  previous_Ap.swap (Ap);
+  previous_Ai.swap (Ai);
+
+  copy_matrix_to_arrays (matrix);
+
+  if (Ap != previous_Ap || Ai != previous_Ai)
+    compute_symbolic_decomposition ();
+
+  compute_numeric_decomposition ();
 }
 
 
@@ -340,6 +415,52 @@ SparseDirectUMFPACK::solve (BlockVector<double> &rhs_and_solution,
 
 
 
+void
+SparseDirectUMFPACK::solve (FullMatrix<double> &rhs_and_solution,
+                            bool                transpose /*=false*/) const
+{
+  // make sure that some kind of factorize() call has happened before
+  Assert (Ap.size() != 0, ExcNotInitialized());
+  Assert (Ai.size() != 0, ExcNotInitialized());
+  Assert (Ai.size() == Ax.size(), ExcNotInitialized());
+  Assert (rhs_and_solution.m() == _m,
+          ExcDimensionMismatch (rhs_and_solution.m(), _m));
+
+  // UMFPACK solves for one right hand side at a time, but the solve phase
+  // only reads from the numeric decomposition and allocates its own
+  // workspace. we can therefore work on several columns concurrently. the
+  // columns of a FullMatrix are not contiguous in memory, so copy each one
+  // into a temporary array
+  const size_type n_rows = rhs_and_solution.m();
+  const int system = transpose ? UMFPACK_A : UMFPACK_At;
+  parallel::apply_to_subranges
+  (0U, static_cast<unsigned int>(rhs_and_solution.n()),
+   [&](const unsigned int begin, const unsigned int end)
+  {
+    std::vector<double> rhs (n_rows), solution (n_rows);
+    for (unsigned int column=begin; column<end; ++column)
+      {
+        for (size_type row=0; row<n_rows; ++row)
+          rhs[row] = rhs_and_solution(row, column);
+
+        const int status
+          = umfpack_dl_solve (system,
+                              Ap.data(), Ai.data(), Ax.data(),
+                              solution.data(), rhs.data(),
+                              numeric_decomposition,
+                              control.data(), nullptr);
+        AssertThrow (status == UMFPACK_OK,
+                     ExcUMFPACKError("umfpack_dl_solve", status));
+
+        for (size_type row=0; row<n_rows; ++row)
+          rhs_and_solution(row, column) = solution[row];
+      }
+  },
+   1);
+}
+
+
+
 template <class Matrix>
 void
 SparseDirectUMFPACK::solve (const Matrix   &matrix,
@@ -387,6 +508,13 @@ void SparseDirectUMFPACK::factorize (const Matrix &)
 }
 
 
+template <class Matrix>
+void SparseDirectUMFPACK::refactorize (const Matrix &)
+{
+  AssertThrow(false, ExcMessage("To call this function you need UMFPACK, but you configured deal.II without passing the necessary switch to 'cmake'. Please consult the installation instructions in doc/readme.html."));
+}
+
+
 void
 SparseDirectUMFPACK::solve (Vector<double> &, bool) const
 {
@@ -402,6 +530,14 @@ SparseDirectUMFPACK::solve (BlockVector<double> &, bool) const
 }
 
 
+
+void
+SparseDirectUMFPACK::solve (FullMatrix<double> &, bool) const
+{
+  AssertThrow(false, ExcMessage("To call this function you need UMFPACK, but you configured deal.II without passing the necessary switch to 'cmake'. Please consult the installation instructions in doc/readme.html."));
+}
+
+
 template <class Matrix>
 void
 SparseDirectUMFPACK::solve (const Matrix &,
@@ -491,19 +627,21 @@ SparseDirectUMFPACK::n () const
 
 
 // explicit instantiations for SparseMatrixUMFPACK
-#define InstantiateUMFPACK(MatrixType)                      \
-  template                                                  \
-  void SparseDirectUMFPACK::factorize (const MatrixType &); \
-  template                                                  \
-  void SparseDirectUMFPACK::solve (const MatrixType &,      \
-                                   Vector<double> &,        \
-                                   bool);                   \
-  template                                                  \
-  void SparseDirectUMFPACK::solve (const MatrixType &,      \
-                                   BlockVector<double> &,   \
-                                   bool);                   \
-  template                                                  \
-  void SparseDirectUMFPACK::initialize (const MatrixType &, \
+#define InstantiateUMFPACK(MatrixType)                        \
+  template                                                    \
+  void SparseDirectUMFPACK::factorize (const MatrixType &);   \
+  template                                                    \
+  void SparseDirectUMFPACK::refactorize (const MatrixType &); \
+  template                                                    \
+  void SparseDirectUMFPACK::solve (const MatrixType &,        \
+                                   Vector<double> &,          \
+                                   bool);                     \
+  template                                                    \
+  void SparseDirectUMFPACK::solve (const MatrixType &,        \
+                                   BlockVector<double> &,     \
+                                   bool);                     \
+  template                                                    \
+  void SparseDirectUMFPACK::initialize (const MatrixType &,   \
                                         const AdditionalData);
 
 InstantiateUMFPACK(SparseMatrix<double>)
@@ -16,6 +16,7 @@
 
 #include <deal.II/base/vector_slice.h>
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/lac/sparsity_tools.h>
 #include <deal.II/lac/full_matrix.h>
@@ -254,6 +255,10 @@ SparsityPattern::reinit (const size_type m,
   rows = m;
   cols = n;
 
+  // the partitioning of the rows onto threads depends on the number of rows,
+  // so start with a new partitioner
+  thread_loop_partitioner.reset(new parallel::internal::TBBPartitioner());
+
   // delete empty matrices
   if ((m==0) || (n==0))
     {
@@ -338,14 +343,25 @@ SparsityPattern::reinit (const size_type m,
           ((vec_len == 1) && (rowstart[rows] == 0)),
           ExcInternalError());
 
-  // preset the column numbers by a value indicating it is not in use
-  std::fill_n (colnums.get(), vec_len, invalid_entry);
-
-  // if diagonal elements are special: let the first entry in each row be the
-  // diagonal value
-  if (store_diagonal_first_in_row)
-    for (size_type i=0; i<rows; i++)
-      colnums[rowstart[i]] = i;
+  // preset the column numbers by a value indicating it is not in use and, if
+  // diagonal elements are special, let the first entry in each row be the
+  // diagonal value. this is the first access to the newly allocated memory,
+  // so do it in parallel with the same row partitioning as later used by the
+  // matrix-vector products of SparseMatrix, such that the memory pages are
+  // placed close to the threads working on them on NUMA systems
+  std::fill (colnums.get()+rowstart[rows], colnums.get()+vec_len, invalid_entry);
+  parallel::apply_to_subranges
+  (0, rows,
+   [this] (const size_type begin, const size_type end)
+  {
+    std::fill (colnums.get()+rowstart[begin], colnums.get()+rowstart[end],
+               invalid_entry);
+    if (store_diagonal_first_in_row)
+      for (size_type i=begin; i<end; ++i)
+        colnums[rowstart[i]] = i;
+  },
+  internal::SparseMatrix::minimum_parallel_grain_size,
+  *thread_loop_partitioner);
 
   compressed = false;
 }
@@ -361,88 +377,96 @@ SparsityPattern::compress ()
   if (compressed)
     return;
 
-  size_type next_free_entry = 0,
-            next_row_start  = 0,
-            row_length      = 0;
-
-  // first find out how many non-zero elements there are, in order to allocate
-  // the right amount of memory
-  const std::size_t nonzero_elements
-    = std::count_if (&colnums[rowstart[0]],
-                     &colnums[rowstart[rows]],
-                     std::bind(std::not_equal_to<size_type>(), std::placeholders::_1, invalid_entry));
-  // now allocate the respective memory
-  std::unique_ptr<size_type[]> new_colnums (new size_type[nonzero_elements]);
-
-
-  // reserve temporary storage to store the entries of one row
-  std::vector<size_type> tmp_entries (max_row_length);
-
-  // Traverse all rows
+  // first find out how many non-zero elements there are in each row, in
+  // order to allocate the right amount of memory. the used entries of a row
+  // come first, so stop at the first unused entry
+  std::vector<std::size_t> new_rowstart (rows+1);
+  new_rowstart[0] = 0;
+  parallel::apply_to_subranges
+  (0, rows,
+   [&] (const size_type begin, const size_type end)
+  {
+    for (size_type line=begin; line<end; ++line)
+      {
+        std::size_t row_length = 0;
+        for (std::size_t j=rowstart[line]; j<rowstart[line+1]; ++j,++row_length)
+          if (colnums[j] == invalid_entry)
+            break;
+        new_rowstart[line+1] = row_length;
+      }
+  },
+  internal::SparseMatrix::minimum_parallel_grain_size,
+  *thread_loop_partitioner);
   for (size_type line=0; line<rows; ++line)
-    {
-      // copy used entries, break if first unused entry is reached
-      row_length = 0;
-      for (size_type j=rowstart[line]; j<rowstart[line+1]; ++j,++row_length)
-        if (colnums[j] != invalid_entry)
-          tmp_entries[row_length] = colnums[j];
-        else
-          break;
-      // now @p{rowstart} is the number of entries in this line
-
-      // Sort only beginning at the second entry, if optimized storage of
-      // diagonal entries is on.
-
-      // if this line is empty or has only one entry, don't sort
-      if (row_length > 1)
-        std::sort ((store_diagonal_first_in_row)
-                   ? tmp_entries.begin()+1
-                   : tmp_entries.begin(),
-                   tmp_entries.begin()+row_length);
-
-      // insert column numbers into the new field
-      for (size_type j=0; j<row_length; ++j)
-        new_colnums[next_free_entry++] = tmp_entries[j];
-
-      // note new start of this and the next row
-      rowstart[line] = next_row_start;
-      next_row_start = next_free_entry;
-
-      // some internal checks: either the matrix is not quadratic, or if it
-      // is, then the first element of this row must be the diagonal element
-      // (i.e. with column index==line number)
-      // this test only makes sense if we have written to the index
-      // rowstart_line in new_colnums which is the case if row_length is not 0,
-      // so check this first
-      Assert ((!store_diagonal_first_in_row) ||
-              (row_length != 0 && new_colnums[rowstart[line]] == line),
-              ExcInternalError());
-      // assert that the first entry does not show up in the remaining ones
-      // and that the remaining ones are unique among themselves (this handles
-      // both cases, quadratic and rectangular matrices)
-      //
-      // the only exception here is if the row contains no entries at all
-      Assert ((rowstart[line] == next_row_start)
-              ||
-              (std::find (&new_colnums[rowstart[line]+1],
-                          &new_colnums[next_row_start],
-                          new_colnums[rowstart[line]]) ==
-               &new_colnums[next_row_start]),
-              ExcInternalError());
-      Assert ((rowstart[line] == next_row_start)
-              ||
-              (std::adjacent_find(&new_colnums[rowstart[line]+1],
-                                  &new_colnums[next_row_start]) ==
-               &new_colnums[next_row_start]),
-              ExcInternalError());
-    };
-
-  // assert that we have used all allocated space, no more and no less
-  Assert (next_free_entry == nonzero_elements,
+    new_rowstart[line+1] += new_rowstart[line];
+  const std::size_t nonzero_elements = new_rowstart[rows];
+  Assert (nonzero_elements ==
+          static_cast<std::size_t>(std::count_if (&colnums[rowstart[0]],
+                                                  &colnums[rowstart[rows]],
+                                                  std::bind(std::not_equal_to<size_type>(),
+                                                            std::placeholders::_1,
+                                                            invalid_entry))),
           ExcInternalError());
 
-  // set iterator-past-the-end
-  rowstart[rows] = next_row_start;
+  // now allocate the respective memory and copy the column numbers of each
+  // row. the copy is the first touch of the new memory, so do it with the row
+  // partitioning of the matrix-vector products
+  std::unique_ptr<size_type[]> new_colnums (new size_type[nonzero_elements]);
+  parallel::apply_to_subranges
+  (0, rows,
+   [&] (const size_type begin, const size_type end)
+  {
+    for (size_type line=begin; line<end; ++line)
+      {
+        const std::size_t row_start = new_rowstart[line];
+        const std::size_t row_end   = new_rowstart[line+1];
+        std::copy (&colnums[rowstart[line]],
+                   &colnums[rowstart[line]] + (row_end-row_start),
+                   &new_colnums[row_start]);
+
+        // Sort only beginning at the second entry, if optimized storage of
+        // diagonal entries is on.
+
+        // if this line is empty or has only one entry, don't sort
+        if (row_end - row_start > 1)
+          std::sort ((store_diagonal_first_in_row)
+                     ? &new_colnums[row_start]+1
+                     : &new_colnums[row_start],
+                     &new_colnums[row_start]+(row_end-row_start));
+
+        // some internal checks: either the matrix is not quadratic, or if it
+        // is, then the first element of this row must be the diagonal element
+        // (i.e. with column index==line number)
+        // this test only makes sense if we have written to the index
+        // row_start in new_colnums which is the case if the row is not empty,
+        // so check this first
+        Assert ((!store_diagonal_first_in_row) ||
+                (row_end != row_start && new_colnums[row_start] == line),
+                ExcInternalError());
+        // assert that the first entry does not show up in the remaining ones
+        // and that the remaining ones are unique among themselves (this
+        // handles both cases, quadratic and rectangular matrices)
+        //
+        // the only exception here is if the row contains no entries at all
+        Assert ((row_start == row_end)
+                ||
+                (std::find (&new_colnums[row_start]+1,
+                            &new_colnums[row_start]+(row_end-row_start),
+                            new_colnums[row_start]) ==
+                 &new_colnums[row_start]+(row_end-row_start)),
+                ExcInternalError());
+        Assert ((row_start == row_end)
+                ||
+                (std::adjacent_find(&new_colnums[row_start]+1,
+                                    &new_colnums[row_start]+(row_end-row_start)) ==
+                 &new_colnums[row_start]+(row_end-row_start)),
+                ExcInternalError());
+      }
+  },
+  internal::SparseMatrix::minimum_parallel_grain_size,
+  *thread_loop_partitioner);
+
+  std::copy (new_rowstart.begin(), new_rowstart.end(), rowstart.get());
 
   // set colnums to the newly allocated array and delete previous content
   // in the process
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2008 - 2016 by the deal.II authors
+// Copyright (C) 2008 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -20,7 +20,9 @@
 #include <deal.II/lac/sparsity_tools.h>
 
 #include <algorithm>
+#include <array>
 #include <functional>
+#include <map>
 #include <set>
 
 #ifdef DEAL_II_WITH_MPI
@@ -513,7 +515,7 @@ namespace SparsityTools
     for (DynamicSparsityPattern::size_type i=0; i<rows_per_cpu.size(); ++i)
       start_index[i+1]=start_index[i]+rows_per_cpu[i];
 
-    typedef std::map<DynamicSparsityPattern::size_type,
+    typedef std::map<unsigned int,
             std::vector<DynamicSparsityPattern::size_type> >
             map_vec_t;
 
@@ -559,78 +561,27 @@ namespace SparsityTools
 
     }
 
-    unsigned int num_receive=0;
-    {
-      std::vector<unsigned int> send_to;
-      send_to.reserve(send_data.size());
-      for (map_vec_t::iterator it=send_data.begin(); it!=send_data.end(); ++it)
-        send_to.push_back(it->first);
-
-      num_receive =
-        Utilities::MPI::
-        compute_point_to_point_communication_pattern(mpi_comm, send_to).size();
-    }
-
-    std::vector<MPI_Request> requests(send_data.size());
+    // exchange the rows with the processes owning them
+    const map_vec_t received_data =
+      Utilities::MPI::sparse_data_exchange(mpi_comm, send_data);
 
-
-    // send data
-    {
-      unsigned int idx=0;
-      for (map_vec_t::iterator it=send_data.begin(); it!=send_data.end(); ++it, ++idx)
-        {
-          const int ierr = MPI_Isend(&(it->second[0]),
-                                     it->second.size(),
-                                     DEAL_II_DOF_INDEX_MPI_TYPE,
-                                     it->first,
-                                     124,
-                                     mpi_comm,
-                                     &requests[idx]);
-          AssertThrowMPI(ierr);
-        }
-    }
-
-    {
-      //receive
-      std::vector<DynamicSparsityPattern::size_type> recv_buf;
-      for (unsigned int index=0; index<num_receive; ++index)
-        {
-          MPI_Status status;
-          int len;
-          int ierr = MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, mpi_comm, &status);
-          AssertThrowMPI(ierr);
-          Assert (status.MPI_TAG==124, ExcInternalError());
-
-          ierr = MPI_Get_count(&status, DEAL_II_DOF_INDEX_MPI_TYPE, &len);
-          AssertThrowMPI(ierr);
-          recv_buf.resize(len);
-          ierr = MPI_Recv(recv_buf.data(), len, DEAL_II_DOF_INDEX_MPI_TYPE, status.MPI_SOURCE,
-                          status.MPI_TAG, mpi_comm, &status);
-          AssertThrowMPI(ierr);
-
-          std::vector<DynamicSparsityPattern::size_type>::const_iterator ptr = recv_buf.begin();
-          std::vector<DynamicSparsityPattern::size_type>::const_iterator end = recv_buf.end();
-          while (ptr!=end)
-            {
-              DynamicSparsityPattern::size_type num=*(ptr++);
-              Assert(ptr!=end, ExcInternalError());
-              DynamicSparsityPattern::size_type row=*(ptr++);
-              for (unsigned int c=0; c<num; ++c)
-                {
-                  Assert(ptr!=end, ExcInternalError());
-                  dsp.add(row, *ptr);
-                  ++ptr;
-                }
-            }
-          Assert(ptr==end, ExcInternalError());
-        }
-    }
-
-    // complete all sends, so that we can safely destroy the buffers.
-    if (requests.size())
+    for (map_vec_t::const_iterator it=received_data.begin(); it!=received_data.end(); ++it)
       {
-        const int ierr = MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
-        AssertThrowMPI(ierr);
+        std::vector<DynamicSparsityPattern::size_type>::const_iterator ptr = it->second.begin();
+        std::vector<DynamicSparsityPattern::size_type>::const_iterator end = it->second.end();
+        while (ptr!=end)
+          {
+            DynamicSparsityPattern::size_type num=*(ptr++);
+            Assert(ptr!=end, ExcInternalError());
+            DynamicSparsityPattern::size_type row=*(ptr++);
+            for (unsigned int c=0; c<num; ++c)
+              {
+                Assert(ptr!=end, ExcInternalError());
+                dsp.add(row, *ptr);
+                ++ptr;
+              }
+          }
+        Assert(ptr==end, ExcInternalError());
       }
 
   }
@@ -642,7 +593,7 @@ namespace SparsityTools
   {
     const unsigned int myid = Utilities::MPI::this_mpi_process(mpi_comm);
 
-    typedef std::map<BlockDynamicSparsityPattern::size_type,
+    typedef std::map<unsigned int,
             std::vector<BlockDynamicSparsityPattern::size_type> >
             map_vec_t;
     map_vec_t send_data;
@@ -690,80 +641,253 @@ namespace SparsityTools
 
     }
 
-    unsigned int num_receive=0;
+    // exchange the rows with the processes owning them
+    const map_vec_t received_data =
+      Utilities::MPI::sparse_data_exchange(mpi_comm, send_data);
+
+    for (map_vec_t::const_iterator it=received_data.begin(); it!=received_data.end(); ++it)
+      {
+        std::vector<BlockDynamicSparsityPattern::size_type>::const_iterator ptr = it->second.begin();
+        std::vector<BlockDynamicSparsityPattern::size_type>::const_iterator end = it->second.end();
+        while (ptr!=end)
+          {
+            BlockDynamicSparsityPattern::size_type num=*(ptr++);
+            Assert(ptr!=end, ExcInternalError());
+            BlockDynamicSparsityPattern::size_type row=*(ptr++);
+            for (unsigned int c=0; c<num; ++c)
+              {
+                Assert(ptr!=end, ExcInternalError());
+                dsp.add(row, *ptr);
+                ++ptr;
+              }
+          }
+        Assert(ptr==end, ExcInternalError());
+      }
+  }
+
+
+  namespace internal
+  {
+    /**
+     * Determine the owners of all elements of @p requested_indices, given
+     * that each process knows only its locally owned set of indices, through
+     * a distributed directory: The index space is split into contiguous
+     * chunks of equal size, and the process with rank p records the owners
+     * of the indices in the p-th chunk. The processes first register their
+     * locally owned ranges with the directory and then ask it for the owners
+     * of the requested indices, which needs three sparse data exchanges but
+     * no information of size proportional to the number of processes.
+     *
+     * The result contains the ranges of @p requested_indices together with
+     * their owner, sorted by the first index of the ranges.
+     */
+    std::vector<std::array<types::global_dof_index,3> >
+    compute_index_owner_ranges (const IndexSet &locally_owned_indices,
+                                const IndexSet &requested_indices,
+                                const MPI_Comm &mpi_comm)
     {
-      std::vector<unsigned int> send_to;
-      send_to.reserve(send_data.size());
-      for (map_vec_t::iterator it=send_data.begin(); it!=send_data.end(); ++it)
-        send_to.push_back(it->first);
-
-      num_receive =
-        Utilities::MPI::
-        compute_point_to_point_communication_pattern(mpi_comm, send_to).size();
+      typedef types::global_dof_index size_type;
+      const unsigned int n_procs = Utilities::MPI::n_mpi_processes(mpi_comm);
+      const size_type size = locally_owned_indices.size();
+      const size_type chunk_size = std::max<size_type>((size + n_procs - 1) / n_procs, 1);
+
+      // split the given ranges at the boundaries of the chunks of the
+      // directory and call the given function with the directory rank, the
+      // beginning and the end of each piece
+      const auto split_by_chunk = [&] (const IndexSet &index_set,
+                                       const std::function<void (const unsigned int,
+                                                                 const size_type,
+                                                                 const size_type)> &action)
+      {
+        for (IndexSet::IntervalIterator interval = index_set.begin_intervals();
+             interval != index_set.end_intervals(); ++interval)
+          {
+            const size_type end = interval->last() + 1;
+            for (size_type begin = *interval->begin(); begin<end; )
+              {
+                const unsigned int rank = begin / chunk_size;
+                const size_type chunk_end = std::min<size_type>((rank+1)*chunk_size, end);
+                action(rank, begin, chunk_end);
+                begin = chunk_end;
+              }
+          }
+      };
+
+      // register the locally owned ranges with the directory
+      std::map<unsigned int, std::vector<size_type> > send_data;
+      split_by_chunk(locally_owned_indices,
+                     [&send_data] (const unsigned int rank, const size_type begin,
+                                   const size_type end)
+      {
+        send_data[rank].push_back(begin);
+        send_data[rank].push_back(end);
+      });
+      std::vector<std::array<size_type,3> > directory;
+      for (const auto &rank_and_ranges : Utilities::MPI::sparse_data_exchange(mpi_comm, send_data))
+        for (unsigned int i=0; i<rank_and_ranges.second.size(); i+=2)
+          directory.push_back({{rank_and_ranges.second[i], rank_and_ranges.second[i+1], rank_and_ranges.first}});
+      std::sort(directory.begin(), directory.end());
+
+      // ask the directory for the owners of the requested ranges
+      send_data.clear();
+      split_by_chunk(requested_indices,
+                     [&send_data] (const unsigned int rank, const size_type begin,
+                                   const size_type end)
+      {
+        send_data[rank].push_back(begin);
+        send_data[rank].push_back(end);
+      });
+      const std::map<unsigned int, std::vector<size_type> > requests
+        = Utilities::MPI::sparse_data_exchange(mpi_comm, send_data);
+
+      // answer with the pieces of the requested ranges and their owners
+      send_data.clear();
+      for (const auto &rank_and_ranges : requests)
+        for (unsigned int i=0; i<rank_and_ranges.second.size(); i+=2)
+          {
+            const size_type begin = rank_and_ranges.second[i];
+            const size_type end = rank_and_ranges.second[i+1];
+            std::vector<std::array<size_type,3> >::const_iterator entry
+              = std::upper_bound(directory.begin(), directory.end(),
+                                 std::array<size_type,3> {{begin, numbers::invalid_dof_index, 0}});
+            if (entry != directory.begin())
+              --entry;
+            for ( ; entry != directory.end() && (*entry)[0] < end; ++entry)
+              if ((*entry)[1] > begin)
+                {
+                  std::vector<size_type> &answer = send_data[rank_and_ranges.first];
+                  answer.push_back(std::max(begin, (*entry)[0]));
+                  answer.push_back(std::min(end, (*entry)[1]));
+                  answer.push_back((*entry)[2]);
+                }
+          }
+
+      std::vector<std::array<size_type,3> > owner_ranges;
+      for (const auto &rank_and_answers : Utilities::MPI::sparse_data_exchange(mpi_comm, send_data))
+        for (unsigned int i=0; i<rank_and_answers.second.size(); i+=3)
+          owner_ranges.push_back({{rank_and_answers.second[i], rank_and_answers.second[i+1],
+                rank_and_answers.second[i+2]
+              }
+            });
+      std::sort(owner_ranges.begin(), owner_ranges.end());
+      return owner_ranges;
     }
 
-    std::vector<MPI_Request> requests(send_data.size());
 
 
-    // send data
+    /**
+     * The implementation of the distribute_sparsity_pattern() functions that
+     * take the locally owned rows, for both DynamicSparsityPattern and
+     * BlockDynamicSparsityPattern.
+     *
+     * The rows are sent as the row index, the number of ranges of
+     * consecutive column indices, and the first index and the length of every
+     * range. Since the columns of finite element matrices usually come in
+     * few contiguous ranges, at least for a good numbering of the degrees of
+     * freedom, this is much shorter than the list of column indices.
+     */
+    template <typename SparsityPatternType>
+    void
+    distribute_sparsity_pattern_by_owned_rows (SparsityPatternType &dsp,
+                                               const IndexSet      &locally_owned_rows,
+                                               const MPI_Comm      &mpi_comm,
+                                               const IndexSet      &locally_relevant_rows)
     {
-      unsigned int idx=0;
-      for (map_vec_t::iterator it=send_data.begin(); it!=send_data.end(); ++it, ++idx)
+      typedef types::global_dof_index size_type;
+      AssertDimension (locally_owned_rows.size(), dsp.n_rows());
+
+      // find the non-empty rows that need to be sent to other processes
+      IndexSet send_rows (dsp.n_rows());
+      {
+        std::vector<size_type> rows;
+        for (IndexSet::ElementIterator row = locally_relevant_rows.begin();
+             row != locally_relevant_rows.end(); ++row)
+          if (!locally_owned_rows.is_element(*row) && dsp.row_length(*row) > 0)
+            rows.push_back(*row);
+        send_rows.add_indices(rows.begin(), rows.end());
+        send_rows.compress();
+      }
+
+      const std::vector<std::array<size_type,3> > owner_ranges
+        = compute_index_owner_ranges(locally_owned_rows, send_rows, mpi_comm);
+
+      std::map<unsigned int, std::vector<size_type> > send_data;
+      for (const std::array<size_type,3> &range : owner_ranges)
         {
-          const int ierr = MPI_Isend(&(it->second[0]),
-                                     it->second.size(),
-                                     DEAL_II_DOF_INDEX_MPI_TYPE,
-                                     it->first,
-                                     124,
-                                     mpi_comm,
-                                     &requests[idx]);
-          AssertThrowMPI(ierr);
+          std::vector<size_type> &dst = send_data[range[2]];
+          for (size_type row=range[0]; row<range[1]; ++row)
+            {
+              const size_type row_length = dsp.row_length(row);
+              dst.push_back(row);
+              const std::size_t n_ranges_position = dst.size();
+              dst.push_back(0);
+              for (size_type c=0; c<row_length; )
+                {
+                  const size_type first_column = dsp.column_number(row, c);
+                  size_type length = 1;
+                  for (++c; c<row_length &&
+                       dsp.column_number(row, c) == first_column+length; ++c)
+                    ++length;
+                  dst.push_back(first_column);
+                  dst.push_back(length);
+                  ++dst[n_ranges_position];
+                }
+            }
         }
-    }
 
-    {
-      //receive
-      std::vector<BlockDynamicSparsityPattern::size_type> recv_buf;
-      for (unsigned int index=0; index<num_receive; ++index)
+      // exchange the rows with the processes owning them
+      const std::map<unsigned int, std::vector<size_type> > received_data =
+        Utilities::MPI::sparse_data_exchange(mpi_comm, send_data);
+
+      std::vector<size_type> columns;
+      for (const auto &rank_and_rows : received_data)
         {
-          MPI_Status status;
-          int len;
-          int ierr = MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, mpi_comm, &status);
-          AssertThrowMPI(ierr);
-          Assert (status.MPI_TAG==124, ExcInternalError());
-
-          ierr = MPI_Get_count(&status, DEAL_II_DOF_INDEX_MPI_TYPE, &len);
-          AssertThrowMPI(ierr);
-          recv_buf.resize(len);
-          ierr = MPI_Recv(recv_buf.data(), len, DEAL_II_DOF_INDEX_MPI_TYPE, status.MPI_SOURCE,
-                          status.MPI_TAG, mpi_comm, &status);
-          AssertThrowMPI(ierr);
-
-          std::vector<BlockDynamicSparsityPattern::size_type>::const_iterator ptr = recv_buf.begin();
-          std::vector<BlockDynamicSparsityPattern::size_type>::const_iterator end = recv_buf.end();
+          std::vector<size_type>::const_iterator ptr = rank_and_rows.second.begin();
+          const std::vector<size_type>::const_iterator end = rank_and_rows.second.end();
           while (ptr!=end)
             {
-              BlockDynamicSparsityPattern::size_type num=*(ptr++);
+              const size_type row = *(ptr++);
               Assert(ptr!=end, ExcInternalError());
-              BlockDynamicSparsityPattern::size_type row=*(ptr++);
-              for (unsigned int c=0; c<num; ++c)
+              const size_type n_ranges = *(ptr++);
+              columns.clear();
+              for (size_type r=0; r<n_ranges; ++r)
                 {
-                  Assert(ptr!=end, ExcInternalError());
-                  dsp.add(row, *ptr);
-                  ++ptr;
+                  Assert(end-ptr >= 2, ExcInternalError());
+                  const size_type first_column = *(ptr++);
+                  const size_type length = *(ptr++);
+                  for (size_type c=0; c<length; ++c)
+                    columns.push_back(first_column+c);
                 }
+              dsp.add_entries(row, columns.begin(), columns.end(), true);
             }
-          Assert(ptr==end, ExcInternalError());
         }
     }
+  }
 
-    // complete all sends, so that we can safely destroy the buffers.
-    if (requests.size())
-      {
-        const int ierr = MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
-        AssertThrowMPI(ierr);
-      }
+
+
+  void distribute_sparsity_pattern
+  (DynamicSparsityPattern &dsp,
+   const IndexSet         &locally_owned_rows,
+   const MPI_Comm         &mpi_comm,
+   const IndexSet         &locally_relevant_rows)
+  {
+    internal::distribute_sparsity_pattern_by_owned_rows (dsp, locally_owned_rows,
+                                                         mpi_comm, locally_relevant_rows);
+  }
+
+
+
+  void distribute_sparsity_pattern
+  (BlockDynamicSparsityPattern &dsp,
+   const IndexSet              &locally_owned_rows,
+   const MPI_Comm              &mpi_comm,
+   const IndexSet              &locally_relevant_rows)
+  {
+    internal::distribute_sparsity_pattern_by_owned_rows (dsp, locally_owned_rows,
+                                                         mpi_comm, locally_relevant_rows);
   }
+
 #endif
 }
 
@@ -0,0 +1,160 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/lac/static_condensation.h>
+#include <deal.II/base/memory_consumption.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <typename Number>
+StaticCondensation<Number>::AdditionalData::AdditionalData
+(const bool store_condensed_matrices)
+  :
+  store_condensed_matrices (store_condensed_matrices)
+{}
+
+
+
+template <typename Number>
+StaticCondensation<Number>::StaticCondensation ()
+{}
+
+
+
+template <typename Number>
+void
+StaticCondensation<Number>::reinit (const unsigned int    n_cells,
+                                    const AdditionalData &data)
+{
+  cell_data.clear();
+  cell_data.resize(n_cells);
+  additional_data = data;
+}
+
+
+
+template <typename Number>
+void
+StaticCondensation<Number>::clear ()
+{
+  std::vector<CellData>().swap(cell_data);
+  additional_data = AdditionalData();
+}
+
+
+
+template <typename Number>
+void
+StaticCondensation<Number>::condense_cell
+(const unsigned int                          cell_index,
+ const FullMatrix<Number>                   &cell_matrix,
+ const Vector<Number>                       &cell_rhs,
+ const std::vector<types::global_dof_index> &interior_dof_indices,
+ const std::vector<types::global_dof_index> &skeleton_dof_indices,
+ FullMatrix<Number>                         &condensed_matrix,
+ Vector<Number>                             &condensed_rhs)
+{
+  AssertIndexRange (cell_index, n_cells());
+  const unsigned int n_interior = interior_dof_indices.size();
+  const unsigned int n_skeleton = skeleton_dof_indices.size();
+  AssertDimension (cell_matrix.m(), n_interior + n_skeleton);
+  AssertDimension (cell_matrix.n(), n_interior + n_skeleton);
+  AssertDimension (cell_rhs.size(), n_interior + n_skeleton);
+
+  CellData &data = cell_data[cell_index];
+  data.interior_dof_indices = interior_dof_indices;
+  data.skeleton_dof_indices = skeleton_dof_indices;
+
+  // split the cell matrix into the four blocks
+  FullMatrix<Number> interior_inverse (n_interior, n_interior);
+  FullMatrix<Number> interior_skeleton (n_interior, n_skeleton);
+  FullMatrix<Number> skeleton_interior (n_skeleton, n_interior);
+  condensed_matrix.reinit (n_skeleton, n_skeleton);
+  for (unsigned int i=0; i<n_interior; ++i)
+    {
+      for (unsigned int j=0; j<n_interior; ++j)
+        interior_inverse(i,j) = cell_matrix(i,j);
+      for (unsigned int j=0; j<n_skeleton; ++j)
+        interior_skeleton(i,j) = cell_matrix(i,n_interior+j);
+    }
+  for (unsigned int i=0; i<n_skeleton; ++i)
+    {
+      for (unsigned int j=0; j<n_interior; ++j)
+        skeleton_interior(i,j) = cell_matrix(n_interior+i,j);
+      for (unsigned int j=0; j<n_skeleton; ++j)
+        condensed_matrix(i,j) = cell_matrix(n_interior+i,n_interior+j);
+    }
+
+  Vector<Number> interior_rhs (n_interior);
+  condensed_rhs.reinit (n_skeleton);
+  for (unsigned int i=0; i<n_interior; ++i)
+    interior_rhs(i) = cell_rhs(i);
+  for (unsigned int i=0; i<n_skeleton; ++i)
+    condensed_rhs(i) = cell_rhs(n_interior+i);
+
+  // store -A_II^{-1} A_IS and A_II^{-1} f_I, such that the condensed matrix
+  // and the reconstruction only need additions
+  data.reconstruction_matrix.reinit (n_interior, n_skeleton);
+  data.reconstruction_rhs.reinit (n_interior);
+  if (n_interior > 0)
+    {
+      interior_inverse.gauss_jordan();
+      interior_inverse.vmult (data.reconstruction_rhs, interior_rhs);
+    }
+  if (n_interior > 0 && n_skeleton > 0)
+    {
+      interior_inverse.mmult (data.reconstruction_matrix, interior_skeleton);
+      data.reconstruction_matrix *= Number(-1.);
+
+      skeleton_interior.mmult (condensed_matrix, data.reconstruction_matrix, true);
+      interior_rhs = data.reconstruction_rhs;
+      interior_rhs *= Number(-1.);
+      skeleton_interior.vmult_add (condensed_rhs, interior_rhs);
+    }
+
+  if (additional_data.store_condensed_matrices)
+    data.condensed_matrix = condensed_matrix;
+  else
+    data.condensed_matrix.reinit (0, 0);
+}
+
+
+
+template <typename Number>
+std::size_t
+StaticCondensation<Number>::memory_consumption () const
+{
+  std::size_t memory = sizeof(*this);
+  for (unsigned int cell=0; cell<n_cells(); ++cell)
+    {
+      const CellData &data = cell_data[cell];
+      memory += (sizeof(CellData) +
+                 MemoryConsumption::memory_consumption(data.interior_dof_indices) +
+                 MemoryConsumption::memory_consumption(data.skeleton_dof_indices) +
+                 data.reconstruction_matrix.memory_consumption() +
+                 data.reconstruction_rhs.memory_consumption() +
+                 data.condensed_matrix.memory_consumption());
+    }
+  return memory;
+}
+
+
+
+// explicit instantiations
+template class StaticCondensation<double>;
+template class StaticCondensation<float>;
+
+DEAL_II_NAMESPACE_CLOSE
@@ -799,6 +799,45 @@ namespace TrilinosWrappers
 
 
 
+  void
+  SolverDirect::solve (dealii::LinearAlgebra::distributed::Vector<double>       &x,
+                       const dealii::LinearAlgebra::distributed::Vector<double> &b)
+  {
+    Assert (linear_problem.get() != nullptr && solver.get() != nullptr,
+            ExcMessage ("The factorization must be computed by initialize() "
+                        "before calling this function."));
+
+    // create views of the vectors in Epetra format, using the maps of the
+    // matrix given to initialize()
+    const Epetra_Operator *matrix = linear_problem->GetOperator();
+    AssertDimension (static_cast<TrilinosWrappers::types::int_type>(x.local_size()),
+                     matrix->OperatorDomainMap().NumMyElements());
+    AssertDimension (static_cast<TrilinosWrappers::types::int_type>(b.local_size()),
+                     matrix->OperatorRangeMap().NumMyElements());
+    Epetra_Vector ep_x (View, matrix->OperatorDomainMap(), x.begin());
+    Epetra_Vector ep_b (View, matrix->OperatorRangeMap(), const_cast<double *>(b.begin()));
+
+    linear_problem->SetLHS(&ep_x);
+    linear_problem->SetRHS(&ep_b);
+
+    ConditionalOStream verbose_cout (std::cout,
+                                     additional_data.output_solver_details);
+
+    verbose_cout << "Starting solve" << std::endl;
+    const int ierr = solver->Solve ();
+    AssertThrow (ierr == 0, ExcTrilinosError (ierr));
+
+    // the vectors only live in this function, so do not keep pointers to
+    // them in the linear problem
+    linear_problem->SetLHS(nullptr);
+    linear_problem->SetRHS(nullptr);
+
+    // Finally, force the SolverControl object to report convergence
+    solver_control.check (0, 0);
+  }
+
+
+
   void
   SolverDirect::do_solve()
   {
@@ -37,6 +37,8 @@ DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 
 #include <boost/container/small_vector.hpp>
 
+#include <algorithm>
+
 DEAL_II_NAMESPACE_OPEN
 
 namespace TrilinosWrappers
@@ -364,6 +366,7 @@ namespace TrilinosWrappers
 
     nonlocal_matrix.reset();
     nonlocal_matrix_exporter.reset();
+    nonlocal_entries.clear();
 
     // check whether we need to update the whole matrix layout (we have
     // different maps or if we detect a row where the columns of the two
@@ -731,6 +734,7 @@ namespace TrilinosWrappers
                               0,
                               Utilities::Trilinos::comm_self());
 
+    nonlocal_entries.clear();
     reinit_matrix (rows, columns, sparsity_pattern, false,
                    column_space_map, matrix, nonlocal_matrix,
                    nonlocal_matrix_exporter);
@@ -744,6 +748,7 @@ namespace TrilinosWrappers
                         const SparsityPatternType &sparsity_pattern,
                         const bool                 exchange_data)
   {
+    nonlocal_entries.clear();
     reinit_matrix (input_map, input_map, sparsity_pattern, exchange_data,
                    column_space_map, matrix, nonlocal_matrix,
                    nonlocal_matrix_exporter);
@@ -766,6 +771,7 @@ namespace TrilinosWrappers
       row_parallel_partitioning.make_trilinos_map (communicator, false);
     Epetra_Map col_map =
       col_parallel_partitioning.make_trilinos_map (communicator, false);
+    nonlocal_entries.clear();
     reinit_matrix (row_map, col_map, sparsity_pattern, exchange_data,
                    column_space_map, matrix, nonlocal_matrix,
                    nonlocal_matrix_exporter);
@@ -785,6 +791,7 @@ namespace TrilinosWrappers
                              const SparsityPatternType &sparsity_pattern,
                              const bool                 exchange_data)
   {
+    nonlocal_entries.clear();
     reinit_matrix (row_map, col_map, sparsity_pattern, exchange_data,
                    column_space_map, matrix, nonlocal_matrix,
                    nonlocal_matrix_exporter);
@@ -803,6 +810,7 @@ namespace TrilinosWrappers
   {
     matrix.reset ();
     nonlocal_matrix_exporter.reset();
+    nonlocal_entries.clear();
 
     // reinit with a (parallel) Trilinos sparsity pattern.
     column_space_map.reset (new Epetra_Map
@@ -830,6 +838,7 @@ namespace TrilinosWrappers
     column_space_map.reset (new Epetra_Map (sparse_matrix.domain_partitioner()));
     matrix.reset ();
     nonlocal_matrix_exporter.reset();
+    nonlocal_entries.clear();
     matrix.reset (new Epetra_FECrsMatrix
                   (Copy, sparse_matrix.trilinos_sparsity_pattern(), false));
 
@@ -1003,6 +1012,7 @@ namespace TrilinosWrappers
 
     nonlocal_matrix.reset();
     nonlocal_matrix_exporter.reset();
+    nonlocal_entries.clear();
     matrix.reset ();
     matrix.reset (new Epetra_FECrsMatrix(Copy, *graph, false));
 
@@ -1048,6 +1058,9 @@ namespace TrilinosWrappers
       }
 
     // flush buffers
+    if (mode == Add)
+      add_staged_nonlocal_entries ();
+
     int ierr;
     if (nonlocal_matrix.get() != nullptr && mode == Add)
       {
@@ -1089,6 +1102,7 @@ namespace TrilinosWrappers
     matrix.reset (new Epetra_FECrsMatrix(View, *column_space_map, 0));
     nonlocal_matrix.reset();
     nonlocal_matrix_exporter.reset();
+    nonlocal_entries.clear();
 
     matrix->FillComplete();
 
@@ -1380,6 +1394,7 @@ namespace TrilinosWrappers
     int ierr;
     if (last_action == Add)
       {
+        add_staged_nonlocal_entries ();
         ierr = matrix->GlobalAssemble (*column_space_map, matrix->RowMap(),
                                        true);
 
@@ -1554,17 +1569,23 @@ namespace TrilinosWrappers
   {
     AssertIndexRange(row, this->m());
     int ierr;
-    if (last_action == Insert)
+
+    // only write to the state variable when it changes, in order to not
+    // interfere with other threads adding into the matrix concurrently
+    if (last_action != Add)
       {
-        // TODO: this could lead to a dead lock when only one processor
-        // calls GlobalAssemble.
-        ierr = matrix->GlobalAssemble(*column_space_map,
-                                      matrix->RowMap(), false);
+        if (last_action == Insert)
+          {
+            // TODO: this could lead to a dead lock when only one processor
+            // calls GlobalAssemble.
+            ierr = matrix->GlobalAssemble(*column_space_map,
+                                          matrix->RowMap(), false);
 
-        AssertThrow (ierr == 0, ExcTrilinosError(ierr));
-      }
+            AssertThrow (ierr == 0, ExcTrilinosError(ierr));
+          }
 
-    last_action = Add;
+        last_action = Add;
+      }
 
     TrilinosWrappers::types::int_type *col_index_ptr;
     TrilinosScalar *col_value_ptr;
@@ -1641,19 +1662,21 @@ namespace TrilinosWrappers
       }
     else
       {
-        // When we're at off-processor data, we have to stick with the
-        // standard SumIntoGlobalValues function. Nevertheless, the way we
-        // call it is the fastest one (any other will lead to repeated
-        // allocation and deallocation of memory in order to call the function
-        // we already use, which is very inefficient if writing one element at
-        // a time).
+        // When we're at off-processor data, handing every contribution to
+        // Epetra_FECrsMatrix is slow because it inserts each entry into its
+        // nonlocal storage separately, and it is not thread-safe. Rather,
+        // append the entries to a plain array of the current thread that is
+        // sorted and submitted row by row in compress(). Since
+        // the entries are only checked against the sparsity pattern of the
+        // owner during compress(), this path does not produce an error code.
         compressed = false;
 
-        ierr = matrix->SumIntoGlobalValues (1,
-                                            (TrilinosWrappers::types::int_type *)&row, n_columns,
-                                            col_index_ptr,
-                                            &col_value_ptr,
-                                            Epetra_FECrsMatrix::ROW_MAJOR);
+        const TrilinosWrappers::types::int_type global_row = row;
+        for (TrilinosWrappers::types::int_type j=0; j<n_columns; ++j)
+          nonlocal_entries.get().push_back (NonlocalEntry(global_row,
+                                                          col_index_ptr[j],
+                                                          col_value_ptr[j]));
+        return;
       }
 
 #ifdef DEBUG
@@ -1694,6 +1717,63 @@ namespace TrilinosWrappers
 
 
 
+  void
+  SparseMatrix::add_staged_nonlocal_entries ()
+  {
+    // collect the entries of all threads
+    std::vector<NonlocalEntry> entries;
+#ifdef DEAL_II_WITH_THREADS
+    for (std::vector<NonlocalEntry> &thread_entries : nonlocal_entries.get_implementation())
+      {
+        entries.insert (entries.end(), thread_entries.begin(), thread_entries.end());
+        // keep the memory of the array, since the next assembly will
+        // typically produce a similar number of entries
+        thread_entries.clear();
+      }
+#else
+    entries.swap (nonlocal_entries.get_implementation());
+#endif
+
+    if (entries.empty())
+      return;
+
+    // sort the entries by row and column and sum up duplicates, such that
+    // every row is handed to Trilinos in one call with sorted column indices
+    std::sort (entries.begin(), entries.end(),
+               [] (const NonlocalEntry &a, const NonlocalEntry &b)
+    {
+      return (a.row < b.row || (a.row == b.row && a.column < b.column));
+    });
+
+    std::vector<TrilinosWrappers::types::int_type> column_indices;
+    std::vector<TrilinosScalar> values;
+    for (std::size_t i=0; i<entries.size(); )
+      {
+        TrilinosWrappers::types::int_type row = entries[i].row;
+        column_indices.clear();
+        values.clear();
+        for ( ; i<entries.size() && entries[i].row == row; ++i)
+          if (!column_indices.empty() &&
+              column_indices.back() == entries[i].column)
+            values.back() += entries[i].value;
+          else
+            {
+              column_indices.push_back (entries[i].column);
+              values.push_back (entries[i].value);
+            }
+
+        TrilinosScalar *value_ptr = values.data();
+        const int ierr = matrix->SumIntoGlobalValues (1, &row, column_indices.size(),
+                                                      column_indices.data(),
+                                                      &value_ptr,
+                                                      Epetra_FECrsMatrix::ROW_MAJOR);
+        Assert (ierr <= 0, ExcAccessToNonPresentElement(row, column_indices[0]));
+        AssertThrow (ierr >= 0, ExcTrilinosError(ierr));
+      }
+  }
+
+
+
   SparseMatrix &
   SparseMatrix::operator = (const double d)
   {
@@ -0,0 +1,74 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/lac/trilinos_tpetra_communication_pattern.h>
+
+#if defined(DEAL_II_TRILINOS_WITH_TPETRA) && defined(DEAL_II_WITH_MPI)
+
+#include <deal.II/base/index_set.h>
+
+#include <memory>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace LinearAlgebra
+{
+  namespace TpetraWrappers
+  {
+    CommunicationPattern::CommunicationPattern(const IndexSet &vector_space_vector_index_set,
+                                               const IndexSet &read_write_vector_index_set,
+                                               const MPI_Comm &communicator)
+    {
+      reinit(vector_space_vector_index_set, read_write_vector_index_set, communicator);
+    }
+
+
+
+    void CommunicationPattern::reinit(const IndexSet &vector_space_vector_index_set,
+                                      const IndexSet &read_write_vector_index_set,
+                                      const MPI_Comm &communicator)
+    {
+      comm = std::make_shared<const MPI_Comm>(communicator);
+
+      // Source map is the one of the vector_space_vector, which must have
+      // uniquely owned GID. Target map is the one of the read_write_vector.
+      const Teuchos::RCP<const MapType> vector_space_vector_map
+        = vector_space_vector_index_set.make_tpetra_map(*comm, false);
+      const Teuchos::RCP<const MapType> read_write_vector_map
+        = read_write_vector_index_set.make_tpetra_map(*comm, true);
+
+      import = Teuchos::rcp (new ImportType(vector_space_vector_map,
+                                            read_write_vector_map));
+    }
+
+
+
+    const MPI_Comm &CommunicationPattern::get_mpi_communicator() const
+    {
+      return *comm;
+    }
+
+
+
+    const ImportType &CommunicationPattern::get_tpetra_import() const
+    {
+      return *import;
+    }
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,443 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/lac/trilinos_tpetra_sparse_matrix.h>
+
+#if defined(DEAL_II_TRILINOS_WITH_TPETRA) && defined(DEAL_II_WITH_MPI)
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+
+#include <boost/container/small_vector.hpp>
+
+DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
+#  include <Teuchos_ArrayRCP.hpp>
+#  include <Teuchos_DefaultMpiComm.hpp>
+DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
+
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace LinearAlgebra
+{
+  namespace TpetraWrappers
+  {
+    namespace
+    {
+      // Translate the global indices owned by the current processor in a
+      // Tpetra::Map into an IndexSet
+      IndexSet
+      map_to_index_set (const MapType &map)
+      {
+        IndexSet is (map.getGlobalNumElements());
+        if (map.getNodeNumElements() == 0)
+          ;
+        else if (map.isContiguous())
+          is.add_range (map.getMinGlobalIndex(), map.getMaxGlobalIndex()+1);
+        else
+          {
+            const Teuchos::ArrayView<const TrilinosWrappers::types::tpetra_global_ordinal>
+            indices = map.getNodeElementList();
+            std::vector<types::global_dof_index> global_indices (indices.begin(),
+                                                                 indices.end());
+            is.add_indices (global_indices.begin(), global_indices.end());
+          }
+        is.compress();
+        return is;
+      }
+    }
+
+
+
+    template <typename Number>
+    SparseMatrix<Number>::SparseMatrix ()
+      :
+      compressed (true)
+    {
+      const Teuchos::RCP<const MapType> map =
+        Teuchos::rcp (new MapType(0, 0, Teuchos::rcp(new Teuchos::MpiComm<int>(MPI_COMM_SELF))));
+      Teuchos::RCP<GraphType> new_graph = Teuchos::rcp (new GraphType(map, size_t(0), Tpetra::StaticProfile));
+      new_graph->fillComplete();
+      graph = new_graph;
+      matrix = Teuchos::rcp (new MatrixType(graph));
+      matrix->fillComplete();
+    }
+
+
+
+    template <typename Number>
+    SparseMatrix<Number>::SparseMatrix (const IndexSet               &row_parallel_partitioning,
+                                        const IndexSet               &col_parallel_partitioning,
+                                        const DynamicSparsityPattern &sparsity_pattern,
+                                        const MPI_Comm               &communicator)
+      :
+      compressed (true)
+    {
+      reinit (row_parallel_partitioning, col_parallel_partitioning,
+              sparsity_pattern, communicator);
+    }
+
+
+
+    template <typename Number>
+    void
+    SparseMatrix<Number>::reinit (const IndexSet               &row_parallel_partitioning,
+                                  const IndexSet               &col_parallel_partitioning,
+                                  const DynamicSparsityPattern &sparsity_pattern,
+                                  const MPI_Comm               &communicator)
+    {
+      AssertDimension (sparsity_pattern.n_rows(), row_parallel_partitioning.size());
+      AssertDimension (sparsity_pattern.n_cols(), col_parallel_partitioning.size());
+
+      const Teuchos::RCP<const MapType> row_map =
+        row_parallel_partitioning.make_tpetra_map (communicator, false);
+      const Teuchos::RCP<const MapType> domain_map =
+        col_parallel_partitioning.make_tpetra_map (communicator, false);
+
+      // count the entries of the locally owned rows, such that Tpetra can
+      // allocate the graph in one go
+      const size_type n_local_rows = row_parallel_partitioning.n_elements();
+      Teuchos::ArrayRCP<size_t> n_entries_per_row (n_local_rows);
+      {
+        size_type local_row = 0;
+        for (IndexSet::ElementIterator row=row_parallel_partitioning.begin();
+             row != row_parallel_partitioning.end(); ++row, ++local_row)
+          n_entries_per_row[local_row] = sparsity_pattern.row_length(*row);
+      }
+
+      Teuchos::RCP<GraphType> new_graph =
+        Teuchos::rcp (new GraphType(row_map, n_entries_per_row.getConst(),
+                                    Tpetra::StaticProfile));
+
+      std::vector<TrilinosWrappers::types::tpetra_global_ordinal> row_indices;
+      for (IndexSet::ElementIterator row=row_parallel_partitioning.begin();
+           row != row_parallel_partitioning.end(); ++row)
+        {
+          row_indices.clear();
+          for (DynamicSparsityPattern::iterator p=sparsity_pattern.begin(*row);
+               p != sparsity_pattern.end(*row); ++p)
+            row_indices.push_back (p->column());
+          if (row_indices.size() > 0)
+            new_graph->insertGlobalIndices (*row,
+                                            Teuchos::ArrayView<const TrilinosWrappers::types::tpetra_global_ordinal>
+                                            (row_indices.data(), row_indices.size()));
+        }
+
+      // the range of the matrix is given by the rows
+      new_graph->fillComplete (domain_map, row_map);
+      graph = new_graph;
+
+      // a matrix on a fixed graph is zero and open for assembly after
+      // construction
+      matrix = Teuchos::rcp (new MatrixType(graph));
+      compressed = true;
+    }
+
+
+
+    template <typename Number>
+    SparseMatrix<Number> &
+    SparseMatrix<Number>::operator = (const Number d)
+    {
+      Assert (d==Number(), ExcScalarAssignmentOnlyForZeroValue());
+      (void)d;
+
+      if (matrix->isFillComplete())
+        matrix->resumeFill();
+      matrix->setAllToScalar (Number());
+      compressed = true;
+
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    void
+    SparseMatrix<Number>::set (const size_type  row,
+                               const size_type  n_cols,
+                               const size_type *col_indices,
+                               const Number    *values)
+    {
+      AssertIndexRange (row, m());
+      Assert (matrix->isFillActive(), ExcNotOpenForAssembly());
+
+      boost::container::small_vector<TrilinosWrappers::types::tpetra_global_ordinal, 100>
+      indices (col_indices, col_indices+n_cols);
+      compressed = false;
+      const TrilinosWrappers::types::tpetra_local_ordinal n_set =
+        matrix->replaceGlobalValues (row,
+                                     Teuchos::ArrayView<const TrilinosWrappers::types::tpetra_global_ordinal>
+                                     (indices.data(), n_cols),
+                                     Teuchos::ArrayView<const Number>(values, n_cols));
+      Assert (graph->getRowMap()->isNodeGlobalElement(row) == false ||
+              n_set == static_cast<TrilinosWrappers::types::tpetra_local_ordinal>(n_cols),
+              ExcAccessToNonPresentElement(row, col_indices[0]));
+      (void)n_set;
+    }
+
+
+
+    template <typename Number>
+    void
+    SparseMatrix<Number>::add (const size_type  row,
+                               const size_type  n_cols,
+                               const size_type *col_indices,
+                               const Number    *values,
+                               const bool       elide_zero_values)
+    {
+      AssertIndexRange (row, m());
+      Assert (matrix->isFillActive(), ExcNotOpenForAssembly());
+
+      boost::container::small_vector<TrilinosWrappers::types::tpetra_global_ordinal, 100>
+      indices (n_cols);
+      boost::container::small_vector<Number, 100> nonzero_values (n_cols);
+      size_type n_columns = 0;
+      for (size_type j=0; j<n_cols; ++j)
+        {
+          AssertIsFinite (values[j]);
+          if (elide_zero_values == false || values[j] != Number())
+            {
+              indices[n_columns] = col_indices[j];
+              nonzero_values[n_columns] = values[j];
+              ++n_columns;
+            }
+        }
+
+      // exit early if there is nothing to do
+      if (n_columns == 0)
+        return;
+
+      compressed = false;
+      const TrilinosWrappers::types::tpetra_local_ordinal n_added =
+        matrix->sumIntoGlobalValues (row,
+                                     Teuchos::ArrayView<const TrilinosWrappers::types::tpetra_global_ordinal>
+                                     (indices.data(), n_columns),
+                                     Teuchos::ArrayView<const Number>(nonzero_values.data(),
+                                                                      n_columns));
+      Assert (graph->getRowMap()->isNodeGlobalElement(row) == false ||
+              n_added == static_cast<TrilinosWrappers::types::tpetra_local_ordinal>(n_columns),
+              ExcAccessToNonPresentElement(row, indices[0]));
+      (void)n_added;
+    }
+
+
+
+    template <typename Number>
+    void
+    SparseMatrix<Number>::compress (const VectorOperation::values)
+    {
+      // fillComplete() exchanges the entries in rows owned by other
+      // processors. For a fixed graph, this does not change the structure of
+      // the matrix.
+      if (matrix->isFillActive())
+        matrix->fillComplete (graph->getDomainMap(), graph->getRangeMap());
+      compressed = true;
+    }
+
+
+
+    template <typename Number>
+    typename SparseMatrix<Number>::size_type
+    SparseMatrix<Number>::m () const
+    {
+      return graph->getGlobalNumRows();
+    }
+
+
+
+    template <typename Number>
+    typename SparseMatrix<Number>::size_type
+    SparseMatrix<Number>::n () const
+    {
+      return graph->getDomainMap()->getGlobalNumElements();
+    }
+
+
+
+    template <typename Number>
+    unsigned int
+    SparseMatrix<Number>::local_size () const
+    {
+      return graph->getNodeNumRows();
+    }
+
+
+
+    template <typename Number>
+    typename SparseMatrix<Number>::size_type
+    SparseMatrix<Number>::n_nonzero_elements () const
+    {
+      return graph->getGlobalNumEntries();
+    }
+
+
+
+    template <typename Number>
+    typename numbers::NumberTraits<Number>::real_type
+    SparseMatrix<Number>::frobenius_norm () const
+    {
+      Assert (matrix->isFillComplete(), ExcNotCompressed());
+      return matrix->getFrobeniusNorm();
+    }
+
+
+
+    template <typename Number>
+    void
+    SparseMatrix<Number>::vmult (Vector<Number>       &dst,
+                                 const Vector<Number> &src) const
+    {
+      Assert (matrix->isFillComplete(), ExcNotCompressed());
+      Assert (src.trilinos_vector().getMap()->isSameAs(*matrix->getDomainMap()),
+              ExcMessage ("Column map of matrix does not fit with vector map!"));
+      Assert (dst.trilinos_vector().getMap()->isSameAs(*matrix->getRangeMap()),
+              ExcMessage ("Row map of matrix does not fit with vector map!"));
+
+      matrix->apply (src.trilinos_vector(), dst.trilinos_vector(),
+                     Teuchos::NO_TRANS, Number(1.), Number());
+    }
+
+
+
+    template <typename Number>
+    void
+    SparseMatrix<Number>::Tvmult (Vector<Number>       &dst,
+                                  const Vector<Number> &src) const
+    {
+      Assert (matrix->isFillComplete(), ExcNotCompressed());
+      Assert (src.trilinos_vector().getMap()->isSameAs(*matrix->getRangeMap()),
+              ExcMessage ("Row map of matrix does not fit with vector map!"));
+      Assert (dst.trilinos_vector().getMap()->isSameAs(*matrix->getDomainMap()),
+              ExcMessage ("Column map of matrix does not fit with vector map!"));
+
+      matrix->apply (src.trilinos_vector(), dst.trilinos_vector(),
+                     Teuchos::TRANS, Number(1.), Number());
+    }
+
+
+
+    template <typename Number>
+    void
+    SparseMatrix<Number>::vmult_add (Vector<Number>       &dst,
+                                     const Vector<Number> &src) const
+    {
+      Assert (matrix->isFillComplete(), ExcNotCompressed());
+      Assert (src.trilinos_vector().getMap()->isSameAs(*matrix->getDomainMap()),
+              ExcMessage ("Column map of matrix does not fit with vector map!"));
+      Assert (dst.trilinos_vector().getMap()->isSameAs(*matrix->getRangeMap()),
+              ExcMessage ("Row map of matrix does not fit with vector map!"));
+
+      matrix->apply (src.trilinos_vector(), dst.trilinos_vector(),
+                     Teuchos::NO_TRANS, Number(1.), Number(1.));
+    }
+
+
+
+    template <typename Number>
+    void
+    SparseMatrix<Number>::Tvmult_add (Vector<Number>       &dst,
+                                      const Vector<Number> &src) const
+    {
+      Assert (matrix->isFillComplete(), ExcNotCompressed());
+      Assert (src.trilinos_vector().getMap()->isSameAs(*matrix->getRangeMap()),
+              ExcMessage ("Row map of matrix does not fit with vector map!"));
+      Assert (dst.trilinos_vector().getMap()->isSameAs(*matrix->getDomainMap()),
+              ExcMessage ("Column map of matrix does not fit with vector map!"));
+
+      matrix->apply (src.trilinos_vector(), dst.trilinos_vector(),
+                     Teuchos::TRANS, Number(1.), Number(1.));
+    }
+
+
+
+    template <typename Number>
+    IndexSet
+    SparseMatrix<Number>::locally_owned_domain_indices () const
+    {
+      return map_to_index_set (*graph->getDomainMap());
+    }
+
+
+
+    template <typename Number>
+    IndexSet
+    SparseMatrix<Number>::locally_owned_range_indices () const
+    {
+      return map_to_index_set (*graph->getRangeMap());
+    }
+
+
+
+    template <typename Number>
+    MPI_Comm
+    SparseMatrix<Number>::get_mpi_communicator () const
+    {
+      const Teuchos::RCP<const Teuchos::MpiComm<int> > mpi_comm
+        = Teuchos::rcp_dynamic_cast<const Teuchos::MpiComm<int> >(graph->getComm());
+      Assert (mpi_comm.is_null() == false, ExcInternalError());
+      return (*mpi_comm->getRawMpiComm())();
+    }
+
+
+
+    template <typename Number>
+    const typename SparseMatrix<Number>::MatrixType &
+    SparseMatrix<Number>::trilinos_matrix () const
+    {
+      return *matrix;
+    }
+
+
+
+    template <typename Number>
+    Teuchos::RCP<typename SparseMatrix<Number>::MatrixType>
+    SparseMatrix<Number>::trilinos_rcp ()
+    {
+      return matrix;
+    }
+
+
+
+    template <typename Number>
+    Teuchos::RCP<const typename SparseMatrix<Number>::MatrixType>
+    SparseMatrix<Number>::trilinos_rcp () const
+    {
+      return matrix.getConst();
+    }
+
+
+
+    template <typename Number>
+    std::size_t
+    SparseMatrix<Number>::memory_consumption () const
+    {
+      return sizeof(*this) +
+             graph->getNodeNumEntries()*(sizeof(Number) +
+                                         sizeof(TrilinosWrappers::types::tpetra_local_ordinal)) +
+             graph->getNodeNumRows()*sizeof(size_t);
+    }
+
+
+
+    // explicit instantiations
+    template class SparseMatrix<double>;
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,607 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/lac/trilinos_tpetra_vector.h>
+
+#if defined(DEAL_II_TRILINOS_WITH_TPETRA) && defined(DEAL_II_WITH_MPI)
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/mpi.h>
+
+#include <boost/io/ios_state.hpp>
+
+#include <deal.II/lac/read_write_vector.h>
+
+DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
+#  include <Teuchos_DefaultMpiComm.hpp>
+DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
+
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace LinearAlgebra
+{
+  namespace TpetraWrappers
+  {
+    template <typename Number>
+    Vector<Number>::Vector()
+      :
+      vector(new VectorType(Teuchos::rcp(new MapType(0, 0, Teuchos::rcp(new Teuchos::MpiComm<int>(MPI_COMM_SELF))))))
+    {}
+
+
+
+    template <typename Number>
+    Vector<Number>::Vector(const Vector<Number> &V)
+      :
+      Subscriptor(),
+      vector(new VectorType(V.trilinos_vector(), Teuchos::Copy))
+    {}
+
+
+
+    template <typename Number>
+    Vector<Number>::Vector(const IndexSet &parallel_partitioner,
+                           const MPI_Comm &communicator)
+      :
+      vector(new VectorType(parallel_partitioner.make_tpetra_map(communicator, false)))
+    {}
+
+
+
+    template <typename Number>
+    void Vector<Number>::reinit(const IndexSet &parallel_partitioner,
+                                const MPI_Comm &communicator,
+                                const bool      omit_zeroing_entries)
+    {
+      Teuchos::RCP<const MapType> input_map =
+        parallel_partitioner.make_tpetra_map(communicator, false);
+      if (vector->getMap()->isSameAs(*input_map)==false)
+        vector = Teuchos::rcp(new VectorType(input_map));
+      else if (omit_zeroing_entries==false)
+        vector->putScalar(0.);
+    }
+
+
+
+    template <typename Number>
+    void Vector<Number>::reinit(const VectorSpaceVector<Number> &V,
+                                const bool omit_zeroing_entries)
+    {
+      // Check that casting will work.
+      Assert(dynamic_cast<const Vector<Number> *>(&V)!=nullptr,
+             ExcVectorTypeNotCompatible());
+
+      // Downcast V. If fails, throws an exception.
+      const Vector<Number> &down_V = dynamic_cast<const Vector<Number> &>(V);
+
+      reinit(down_V.locally_owned_elements(), down_V.get_mpi_communicator(),
+             omit_zeroing_entries);
+    }
+
+
+
+    template <typename Number>
+    Vector<Number> &Vector<Number>::operator= (const Vector<Number> &V)
+    {
+      // Distinguish three cases:
+      //  - First case: both vectors have the same layout.
+      //  - Second case: both vectors have the same size but different layout.
+      //  - Third case: the vectors have different size.
+      if (vector->getMap()->isSameAs(*V.trilinos_vector().getMap()))
+        vector->assign(V.trilinos_vector());
+      else
+        {
+          if (size()==V.size())
+            {
+              ImportType data_exchange(V.trilinos_vector().getMap(),
+                                       vector->getMap());
+              vector->doImport(V.trilinos_vector(), data_exchange, Tpetra::REPLACE);
+            }
+          else
+            vector = Teuchos::rcp(new VectorType(V.trilinos_vector(), Teuchos::Copy));
+        }
+
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    Vector<Number> &Vector<Number>::operator= (const Number s)
+    {
+      Assert(s==Number(), ExcMessage("Only 0 can be assigned to a vector."));
+
+      vector->putScalar(s);
+
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    void Vector<Number>::import(const ReadWriteVector<Number>                  &V,
+                                VectorOperation::values                         operation,
+                                std::shared_ptr<const CommunicationPatternBase> communication_pattern)
+    {
+      // If no communication pattern is given, create one. Otherwise, use the
+      // one given.
+      if (communication_pattern == nullptr)
+        {
+          // The first time import is called, a communication pattern is
+          // created. Check if the communication pattern already exists and if
+          // it can be reused.
+          if ((source_stored_elements.size() != V.get_stored_elements().size()) ||
+              (source_stored_elements != V.get_stored_elements()))
+            create_tpetra_comm_pattern(V.get_stored_elements(),
+                                       get_mpi_communicator());
+        }
+      else
+        {
+          tpetra_comm_pattern =
+            std::dynamic_pointer_cast<const CommunicationPattern> (communication_pattern);
+          AssertThrow(tpetra_comm_pattern != nullptr,
+                      ExcMessage(std::string("The communication pattern is not of type ") +
+                                 "LinearAlgebra::TpetraWrappers::CommunicationPattern."));
+        }
+
+      const ImportType &import = tpetra_comm_pattern->get_tpetra_import();
+
+      // The target map of the importer describes the entries of the
+      // ReadWriteVector, so fill a vector with that layout on the host and
+      // export it into the present vector.
+      VectorType source_vector(import.getTargetMap());
+      source_vector.template sync<Kokkos::HostSpace>();
+      auto x_2d = source_vector.template getLocalView<Kokkos::HostSpace>();
+      auto x_1d = Kokkos::subview(x_2d, Kokkos::ALL(), 0);
+      source_vector.template modify<Kokkos::HostSpace>();
+      const size_t local_length = source_vector.getLocalLength();
+      for (size_t k=0; k<local_length; ++k)
+        x_1d(k) = V.local_element(k);
+      source_vector.template sync<typename VectorType::device_type::memory_space>();
+
+      if (operation==VectorOperation::insert)
+        vector->doExport(source_vector, import, Tpetra::REPLACE);
+      else if (operation==VectorOperation::add)
+        vector->doExport(source_vector, import, Tpetra::ADD);
+      else
+        AssertThrow(false, ExcNotImplemented());
+    }
+
+
+
+    template <typename Number>
+    Vector<Number> &Vector<Number>::operator*= (const Number factor)
+    {
+      AssertIsFinite(factor);
+      vector->scale(factor);
+
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    Vector<Number> &Vector<Number>::operator/= (const Number factor)
+    {
+      AssertIsFinite(factor);
+      Assert(factor!=Number(), ExcZero());
+      *this *= Number(1.)/factor;
+
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    Vector<Number> &Vector<Number>::operator+= (const VectorSpaceVector<Number> &V)
+    {
+      // Check that casting will work.
+      Assert(dynamic_cast<const Vector<Number> *>(&V)!=nullptr,
+             ExcVectorTypeNotCompatible());
+
+      // Downcast V. If fails, throws an exception.
+      const Vector<Number> &down_V = dynamic_cast<const Vector<Number> &>(V);
+      // If the maps are the same we can update right away.
+      if (vector->getMap()->isSameAs(*down_V.trilinos_vector().getMap()))
+        vector->update(1., down_V.trilinos_vector(), 1.);
+      else
+        {
+          Assert(this->size()==down_V.size(),
+                 ExcDimensionMismatch(this->size(), down_V.size()));
+
+          // Bring the vector into the layout of the present one and add it
+          VectorType dummy(vector->getMap(), false);
+          ImportType data_exchange(down_V.trilinos_vector().getMap(),
+                                   vector->getMap());
+          dummy.doImport(down_V.trilinos_vector(), data_exchange, Tpetra::REPLACE);
+
+          vector->update(1., dummy, 1.);
+        }
+
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    Vector<Number> &Vector<Number>::operator-= (const VectorSpaceVector<Number> &V)
+    {
+      this->add(-1.,V);
+
+      return *this;
+    }
+
+
+
+    template <typename Number>
+    Number Vector<Number>::operator* (const VectorSpaceVector<Number> &V) const
+    {
+      // Check that casting will work.
+      Assert(dynamic_cast<const Vector<Number> *>(&V)!=nullptr,
+             ExcVectorTypeNotCompatible());
+
+      // Downcast V. If fails, throws an exception.
+      const Vector<Number> &down_V = dynamic_cast<const Vector<Number> &>(V);
+      Assert(this->size()==down_V.size(),
+             ExcDimensionMismatch(this->size(), down_V.size()));
+      Assert(vector->getMap()->isSameAs(*down_V.trilinos_vector().getMap()),
+             ExcDifferentParallelPartitioning());
+
+      return vector->dot(down_V.trilinos_vector());
+    }
+
+
+
+    template <typename Number>
+    void Vector<Number>::add(const Number a)
+    {
+      AssertIsFinite(a);
+
+      vector->template sync<Kokkos::HostSpace>();
+      auto vector_2d = vector->template getLocalView<Kokkos::HostSpace>();
+      auto vector_1d = Kokkos::subview(vector_2d, Kokkos::ALL(), 0);
+      vector->template modify<Kokkos::HostSpace>();
+      const size_t local_size = vector->getLocalLength();
+      for (size_t i=0; i<local_size; ++i)
+        vector_1d(i) += a;
+      vector->template sync<typename VectorType::device_type::memory_space>();
+    }
+
+
+
+    template <typename Number>
+    void Vector<Number>::add(const Number a, const VectorSpaceVector<Number> &V)
+    {
+      // Check that casting will work.
+      Assert(dynamic_cast<const Vector<Number> *>(&V)!=nullptr,
+             ExcVectorTypeNotCompatible());
+
+      // Downcast V. If fails, throws an exception.
+      const Vector<Number> &down_V = dynamic_cast<const Vector<Number> &>(V);
+      AssertIsFinite(a);
+      Assert(vector->getMap()->isSameAs(*down_V.trilinos_vector().getMap()),
+             ExcDifferentParallelPartitioning());
+
+      vector->update(a, down_V.trilinos_vector(), 1.);
+    }
+
+
+
+    template <typename Number>
+    void Vector<Number>::add(const Number a, const VectorSpaceVector<Number> &V,
+                             const Number b, const VectorSpaceVector<Number> &W)
+    {
+      // Check that casting will work.
+      Assert(dynamic_cast<const Vector<Number> *>(&V)!=nullptr,
+             ExcVectorTypeNotCompatible());
+      // Check that casting will work.
+      Assert(dynamic_cast<const Vector<Number> *>(&W)!=nullptr,
+             ExcVectorTypeNotCompatible());
+
+      // Downcast V. If fails, throws an exception.
+      const Vector<Number> &down_V = dynamic_cast<const Vector<Number> &>(V);
+      // Downcast W. If fails, throws an exception.
+      const Vector<Number> &down_W = dynamic_cast<const Vector<Number> &>(W);
+      Assert(vector->getMap()->isSameAs(*down_V.trilinos_vector().getMap()),
+             ExcDifferentParallelPartitioning());
+      Assert(vector->getMap()->isSameAs(*down_W.trilinos_vector().getMap()),
+             ExcDifferentParallelPartitioning());
+      AssertIsFinite(a);
+      AssertIsFinite(b);
+
+      vector->update(a, down_V.trilinos_vector(), b, down_W.trilinos_vector(), 1.);
+    }
+
+
+
+    template <typename Number>
+    void Vector<Number>::sadd(const Number s, const Number a,
+                              const VectorSpaceVector<Number> &V)
+    {
+      // Check that casting will work.
+      Assert(dynamic_cast<const Vector<Number> *>(&V)!=nullptr,
+             ExcVectorTypeNotCompatible());
+
+      // Downcast V. If fails, throws an exception.
+      const Vector<Number> &down_V = dynamic_cast<const Vector<Number> &>(V);
+      // If the maps are the same, Tpetra can do the operation in one sweep.
+      if (vector->getMap()->isSameAs(*down_V.trilinos_vector().getMap()))
+        vector->update(a, down_V.trilinos_vector(), s);
+      else
+        {
+          *this *= s;
+          Vector<Number> tmp(down_V);
+          tmp *= a;
+          *this += tmp;
+        }
+    }
+
+
+
+    template <typename Number>
+    void Vector<Number>::scale(const VectorSpaceVector<Number> &scaling_factors)
+    {
+      // Check that casting will work.
+      Assert(dynamic_cast<const Vector<Number> *>(&scaling_factors)!=nullptr,
+             ExcVectorTypeNotCompatible());
+
+      // Downcast scaling_factors. If fails, throws an exception.
+      const Vector<Number> &down_scaling_factors =
+        dynamic_cast<const Vector<Number> &>(scaling_factors);
+      Assert(vector->getMap()->isSameAs(*down_scaling_factors.trilinos_vector().getMap()),
+             ExcDifferentParallelPartitioning());
+
+      vector->elementWiseMultiply(1., down_scaling_factors.trilinos_vector(),
+                                  *vector, 0.);
+    }
+
+
+
+    template <typename Number>
+    void Vector<Number>::equ(const Number a, const VectorSpaceVector<Number> &V)
+    {
+      // Check that casting will work.
+      Assert(dynamic_cast<const Vector<Number> *>(&V)!=nullptr,
+             ExcVectorTypeNotCompatible());
+
+      // Downcast V. If fails, throws an exception.
+      const Vector<Number> &down_V = dynamic_cast<const Vector<Number> &>(V);
+      // If we don't have the same map, copy.
+      if (vector->getMap()->isSameAs(*down_V.trilinos_vector().getMap())==false)
+        this->sadd(0., a, V);
+      else
+        // Otherwise, just update
+        vector->update(a, down_V.trilinos_vector(), 0.);
+    }
+
+
+
+    template <typename Number>
+    bool Vector<Number>::all_zero() const
+    {
+      // get a representation of the vector on the host and loop over all the
+      // elements
+      vector->template sync<Kokkos::HostSpace>();
+      auto vector_2d = vector->template getLocalView<Kokkos::HostSpace>();
+      auto vector_1d = Kokkos::subview(vector_2d, Kokkos::ALL(), 0);
+      const size_t local_size = vector->getLocalLength();
+      unsigned int flag = 0;
+      for (size_t i=0; i<local_size; ++i)
+        if (vector_1d(i) != Number())
+          {
+            flag = 1;
+            break;
+          }
+
+      // Check that the vector is zero on _all_ processors.
+      unsigned int num_nonzero = Utilities::MPI::sum(flag, get_mpi_communicator());
+
+      return num_nonzero == 0;
+    }
+
+
+
+    template <typename Number>
+    Number Vector<Number>::mean_value() const
+    {
+      return vector->meanValue();
+    }
+
+
+
+    template <typename Number>
+    typename Vector<Number>::real_type Vector<Number>::l1_norm() const
+    {
+      return vector->norm1();
+    }
+
+
+
+    template <typename Number>
+    typename Vector<Number>::real_type Vector<Number>::l2_norm() const
+    {
+      return vector->norm2();
+    }
+
+
+
+    template <typename Number>
+    typename Vector<Number>::real_type Vector<Number>::linfty_norm() const
+    {
+      return vector->normInf();
+    }
+
+
+
+    template <typename Number>
+    Number Vector<Number>::add_and_dot(const Number a,
+                                       const VectorSpaceVector<Number> &V,
+                                       const VectorSpaceVector<Number> &W)
+    {
+      this->add(a, V);
+
+      return *this * W;
+    }
+
+
+
+    template <typename Number>
+    typename Vector<Number>::size_type Vector<Number>::size() const
+    {
+      return vector->getGlobalLength();
+    }
+
+
+
+    template <typename Number>
+    MPI_Comm Vector<Number>::get_mpi_communicator() const
+    {
+      const Teuchos::RCP<const Teuchos::MpiComm<int> > mpi_comm
+        = Teuchos::rcp_dynamic_cast<const Teuchos::MpiComm<int> >(vector->getMap()->getComm());
+      Assert (mpi_comm.is_null() == false, ExcInternalError());
+      return (*mpi_comm->getRawMpiComm())();
+    }
+
+
+
+    template <typename Number>
+    ::dealii::IndexSet Vector<Number>::locally_owned_elements() const
+    {
+      IndexSet is (size());
+
+      // easy case: local range is contiguous
+      if (vector->getMap()->isContiguous())
+        {
+          if (vector->getMap()->getNodeNumElements() > 0)
+            is.add_range(vector->getMap()->getMinGlobalIndex(),
+                         vector->getMap()->getMaxGlobalIndex()+1);
+        }
+      else if (vector->getMap()->getNodeNumElements() > 0)
+        {
+          const Teuchos::ArrayView<const TrilinosWrappers::types::tpetra_global_ordinal>
+          indices = vector->getMap()->getNodeElementList();
+          std::vector<size_type> vector_indices (indices.begin(), indices.end());
+          is.add_indices(vector_indices.begin(), vector_indices.end());
+        }
+      is.compress();
+
+      return is;
+    }
+
+
+
+    template <typename Number>
+    const typename Vector<Number>::VectorType &
+    Vector<Number>::trilinos_vector() const
+    {
+      return *vector;
+    }
+
+
+
+    template <typename Number>
+    typename Vector<Number>::VectorType &
+    Vector<Number>::trilinos_vector()
+    {
+      return *vector;
+    }
+
+
+
+    template <typename Number>
+    Teuchos::RCP<typename Vector<Number>::VectorType>
+    Vector<Number>::trilinos_rcp()
+    {
+      return vector;
+    }
+
+
+
+    template <typename Number>
+    Teuchos::RCP<const typename Vector<Number>::VectorType>
+    Vector<Number>::trilinos_rcp() const
+    {
+      return vector.getConst();
+    }
+
+
+
+    template <typename Number>
+    void Vector<Number>::print(std::ostream &out,
+                               const unsigned int precision,
+                               const bool scientific,
+                               const bool across) const
+    {
+      AssertThrow(out, ExcIO());
+      boost::io::ios_flags_saver restore_flags(out);
+
+      // Get a representation of the vector on the host and loop over all
+      // the elements
+      vector->template sync<Kokkos::HostSpace>();
+      auto vector_2d = vector->template getLocalView<Kokkos::HostSpace>();
+      auto vector_1d = Kokkos::subview(vector_2d, Kokkos::ALL(), 0);
+      const size_t local_size = vector->getLocalLength();
+
+      out.precision (precision);
+      if (scientific)
+        out.setf(std::ios::scientific, std::ios::floatfield);
+      else
+        out.setf(std::ios::fixed, std::ios::floatfield);
+
+      if (across)
+        for (size_t i=0; i<local_size; ++i)
+          out << vector_1d(i) << ' ';
+      else
+        for (size_t i=0; i<local_size; ++i)
+          out << vector_1d(i) << std::endl;
+      out << std::endl;
+
+      // restore the representation
+      // of the vector
+      AssertThrow(out, ExcIO());
+    }
+
+
+
+    template <typename Number>
+    std::size_t Vector<Number>::memory_consumption() const
+    {
+      return sizeof(*this)
+             + vector->getLocalLength()*(sizeof(Number)+
+                                         sizeof(TrilinosWrappers::types::tpetra_global_ordinal));
+    }
+
+
+
+    template <typename Number>
+    void Vector<Number>::create_tpetra_comm_pattern(const IndexSet &source_index_set,
+                                                    const MPI_Comm &mpi_comm)
+    {
+      source_stored_elements = source_index_set;
+      tpetra_comm_pattern.reset(new CommunicationPattern(locally_owned_elements(),
+                                                         source_index_set, mpi_comm));
+    }
+
+
+
+    // explicit instantiations
+    template class Vector<double>;
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
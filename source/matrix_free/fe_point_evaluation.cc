@@ -0,0 +1,259 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/matrix_free/fe_point_evaluation.h>
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/tensor_product_polynomials.h>
+#include <deal.II/fe/fe_poly.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <cmath>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim>
+FEPointEvaluation<dim>::FEPointEvaluation (const FiniteElement<dim> &fe)
+  :
+  n_components (fe.n_components()),
+  n_shapes_1d (fe.degree+1),
+  dofs_per_cell (fe.dofs_per_cell)
+{
+  AssertThrow (fe.n_base_elements() == 1,
+               ExcMessage("FEPointEvaluation only supports elements built "
+                          "from a single base element"));
+  const FiniteElement<dim> &base = fe.base_element(0);
+  const FE_Poly<TensorProductPolynomials<dim>,dim,dim> *fe_poly =
+    dynamic_cast<const FE_Poly<TensorProductPolynomials<dim>,dim,dim>*>(&base);
+  AssertThrow (fe_poly != nullptr && base.has_support_points() &&
+               base.n_components() == 1,
+               ExcMessage("FEPointEvaluation only supports scalar elements "
+                          "with tensor product shape functions based on "
+                          "Lagrange polynomials, such as FE_Q and FE_DGQ"));
+
+  const unsigned int scalar_dofs = base.dofs_per_cell;
+  AssertDimension (scalar_dofs, Utilities::fixed_power<dim>(n_shapes_1d));
+  const std::vector<unsigned int> scalar_lexicographic =
+    fe_poly->get_poly_space_numbering_inverse();
+
+  // the first n_shapes_1d support points in lexicographic order run along
+  // the x direction and define the one-dimensional Lagrange basis
+  std::vector<Point<1> > points_1d (n_shapes_1d);
+  for (unsigned int i=0; i<n_shapes_1d; ++i)
+    points_1d[i][0] = base.get_unit_support_points()[scalar_lexicographic[i]][0];
+  polynomials_1d = Polynomials::generate_complete_Lagrange_basis(points_1d);
+
+#ifdef DEBUG
+  // check that the tensor product of the one-dimensional polynomials
+  // reproduces the shape functions of the element at the support points
+  for (unsigned int i=0; i<scalar_dofs; ++i)
+    {
+      const Point<dim> &p = base.get_unit_support_points()[scalar_lexicographic[i]];
+      for (unsigned int j=0; j<scalar_dofs; ++j)
+        {
+          double value = 1.;
+          unsigned int index = j;
+          for (unsigned int d=0; d<dim; ++d, index /= n_shapes_1d)
+            value *= polynomials_1d[index%n_shapes_1d].value(p[d]);
+          Assert (std::abs(value-base.shape_value(scalar_lexicographic[j], p)) < 1e-10,
+                  ExcMessage("The shape functions of the element are not "
+                             "tensor products of Lagrange polynomials"));
+        }
+    }
+#endif
+
+  lexicographic_numbering.resize(dofs_per_cell);
+  for (unsigned int c=0; c<n_components; ++c)
+    for (unsigned int i=0; i<scalar_dofs; ++i)
+      lexicographic_numbering[c*scalar_dofs+i] =
+        fe.n_components() == 1 ?
+        scalar_lexicographic[i] :
+        fe.component_to_system_index(c, scalar_lexicographic[i]);
+  lexicographic_values.resize(dofs_per_cell);
+}
+
+
+
+template <int dim>
+void
+FEPointEvaluation<dim>::reinit (const typename Triangulation<dim>::cell_iterator &cell,
+                                const ArrayView<const Point<dim> >             &unit_points)
+{
+  const unsigned int n_q_points = unit_points.size();
+  shapes.resize(n_q_points*dim*n_shapes_1d*2);
+  inverse_jacobians_transposed.resize(n_q_points);
+  values.resize(n_q_points*n_components);
+  gradients.resize(n_q_points*n_components);
+
+  Point<dim> vertices[GeometryInfo<dim>::vertices_per_cell];
+  for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+    vertices[v] = cell->vertex(v);
+
+  for (unsigned int q=0; q<n_q_points; ++q)
+    {
+      for (unsigned int d=0; d<dim; ++d)
+        for (unsigned int i=0; i<n_shapes_1d; ++i)
+          polynomials_1d[i].value(unit_points[q][d], 1,
+                                  &shapes[((q*dim+d)*n_shapes_1d+i)*2]);
+
+      // Jacobian of the d-linear map spanned by the vertices of the cell
+      Tensor<2,dim> jacobian;
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        {
+          const Tensor<1,dim> shape_grad =
+            GeometryInfo<dim>::d_linear_shape_function_gradient(unit_points[q], v);
+          for (unsigned int d=0; d<dim; ++d)
+            for (unsigned int e=0; e<dim; ++e)
+              jacobian[d][e] += vertices[v][d] * shape_grad[e];
+        }
+      inverse_jacobians_transposed[q] = transpose(invert(jacobian));
+    }
+}
+
+
+
+template <int dim>
+void
+FEPointEvaluation<dim>::evaluate (const ArrayView<const double> &dof_values,
+                                  const bool                     evaluate_values,
+                                  const bool                     evaluate_gradients)
+{
+  AssertDimension (dof_values.size(), dofs_per_cell);
+  if (evaluate_values == false && evaluate_gradients == false)
+    return;
+
+  for (unsigned int i=0; i<dofs_per_cell; ++i)
+    lexicographic_values[i] = dof_values[lexicographic_numbering[i]];
+
+  const unsigned int n_y = dim > 1 ? n_shapes_1d : 1;
+  const unsigned int n_z = dim > 2 ? n_shapes_1d : 1;
+  const unsigned int dofs_per_component = dofs_per_cell/n_components;
+
+  for (unsigned int q=0; q<n_points(); ++q)
+    {
+      const double *shape_x = &shapes[q*dim*n_shapes_1d*2];
+      const double *shape_y = dim > 1 ? shape_x + n_shapes_1d*2 : nullptr;
+      const double *shape_z = dim > 2 ? shape_x + 2*n_shapes_1d*2 : nullptr;
+
+      for (unsigned int c=0; c<n_components; ++c)
+        {
+          // contract the coefficients one direction after the other,
+          // starting with the x direction that runs fastest
+          const double *coefficients = &lexicographic_values[c*dofs_per_component];
+          double value = 0;
+          Tensor<1,dim> reference_gradient;
+          for (unsigned int k=0; k<n_z; ++k)
+            {
+              double value_xy = 0, grad_xy_x = 0, grad_xy_y = 0;
+              for (unsigned int j=0; j<n_y; ++j, coefficients += n_shapes_1d)
+                {
+                  double value_x = 0, grad_x = 0;
+                  for (unsigned int i=0; i<n_shapes_1d; ++i)
+                    {
+                      value_x += coefficients[i] * shape_x[2*i];
+                      grad_x += coefficients[i] * shape_x[2*i+1];
+                    }
+                  const double sy = dim > 1 ? shape_y[2*j] : 1.;
+                  const double dsy = dim > 1 ? shape_y[2*j+1] : 0.;
+                  value_xy += value_x * sy;
+                  grad_xy_x += grad_x * sy;
+                  grad_xy_y += value_x * dsy;
+                }
+              const double sz = dim > 2 ? shape_z[2*k] : 1.;
+              value += value_xy * sz;
+              reference_gradient[0] += grad_xy_x * sz;
+              if (dim > 1)
+                reference_gradient[1] += grad_xy_y * sz;
+              if (dim > 2)
+                reference_gradient[dim-1] += value_xy * shape_z[2*k+1];
+            }
+          const unsigned int index = q*n_components+c;
+          if (evaluate_values)
+            values[index] = value;
+          if (evaluate_gradients)
+            gradients[index] = inverse_jacobians_transposed[q] * reference_gradient;
+        }
+    }
+}
+
+
+
+template <int dim>
+void
+FEPointEvaluation<dim>::integrate (const ArrayView<double> &dof_values,
+                                   const bool               integrate_values,
+                                   const bool               integrate_gradients)
+{
+  AssertDimension (dof_values.size(), dofs_per_cell);
+  for (unsigned int i=0; i<dofs_per_cell; ++i)
+    lexicographic_values[i] = 0;
+
+  const unsigned int n_y = dim > 1 ? n_shapes_1d : 1;
+  const unsigned int n_z = dim > 2 ? n_shapes_1d : 1;
+  const unsigned int dofs_per_component = dofs_per_cell/n_components;
+
+  if (integrate_values == true || integrate_gradients == true)
+    for (unsigned int q=0; q<n_points(); ++q)
+      {
+        const double *shape_x = &shapes[q*dim*n_shapes_1d*2];
+        const double *shape_y = dim > 1 ? shape_x + n_shapes_1d*2 : nullptr;
+        const double *shape_z = dim > 2 ? shape_x + 2*n_shapes_1d*2 : nullptr;
+
+        for (unsigned int c=0; c<n_components; ++c)
+          {
+            const unsigned int index = q*n_components+c;
+            const double value = integrate_values ? values[index] : 0.;
+            Tensor<1,dim> reference_gradient;
+            if (integrate_gradients)
+              reference_gradient = transpose(inverse_jacobians_transposed[q]) *
+                                   gradients[index];
+
+            // apply the transpose of the contractions in evaluate() in
+            // reverse order, starting with the z direction
+            double *coefficients = &lexicographic_values[c*dofs_per_component];
+            for (unsigned int k=0; k<n_z; ++k)
+              {
+                const double sz = dim > 2 ? shape_z[2*k] : 1.;
+                const double value_z = dim > 2 ?
+                                       value * sz + reference_gradient[dim-1] * shape_z[2*k+1] :
+                                       value;
+                const double grad_z_x = reference_gradient[0] * sz;
+                const double grad_z_y = dim > 1 ? reference_gradient[1] * sz : 0.;
+                for (unsigned int j=0; j<n_y; ++j, coefficients += n_shapes_1d)
+                  {
+                    const double sy = dim > 1 ? shape_y[2*j] : 1.;
+                    const double dsy = dim > 1 ? shape_y[2*j+1] : 0.;
+                    const double value_y = value_z * sy + grad_z_y * dsy;
+                    const double grad_y_x = grad_z_x * sy;
+                    for (unsigned int i=0; i<n_shapes_1d; ++i)
+                      coefficients[i] += value_y * shape_x[2*i] +
+                                         grad_y_x * shape_x[2*i+1];
+                  }
+              }
+          }
+      }
+
+  for (unsigned int i=0; i<dofs_per_cell; ++i)
+    dof_values[lexicographic_numbering[i]] = lexicographic_values[i];
+}
+
+
+// explicit instantiations
+#include "fe_point_evaluation.inst"
+
+DEAL_II_NAMESPACE_CLOSE
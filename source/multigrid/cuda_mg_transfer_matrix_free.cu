@@ -0,0 +1,660 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/multigrid/cuda_mg_transfer_matrix_free.h>
+
+#ifdef DEAL_II_WITH_CUDA
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/lac/cuda_atomic.cuh>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/multigrid/mg_transfer_internal.h>
+
+#include <cuda_runtime_api.h>
+
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+#define BLOCK_SIZE 512
+#define CHUNK_SIZE 8
+
+namespace CUDAWrappers
+{
+  namespace internal
+  {
+    // position of a degree of freedom of the child patch in 1D, with 0 for
+    // the left vertex, 2 for the right vertex and 1 for all others, which
+    // selects the weight of the degree of freedom
+    __device__ inline unsigned int weight_index_1d(const unsigned int i,
+                                                   const unsigned int n_child_dofs_1d)
+    {
+      return i == 0 ? 0 : (i == n_child_dofs_1d-1 ? 2 : 1);
+    }
+
+
+
+    // Prolongate from the parent cell with index blockIdx.x to its children.
+    // Each thread works on one degree of freedom of the child patch with the
+    // lexicographic index (i,j,k), and the tensor product is applied one
+    // direction after the other in shared memory, using the part of the
+    // patch with indices below degree_size in the directions not yet
+    // worked on
+    template <int dim, typename Number>
+    __global__ void prolongate_add(Number             *dst,
+                                   const Number       *src,
+                                   const unsigned int *child_indices,
+                                   const unsigned int *parent_indices,
+                                   const Number       *weights,
+                                   const Number       *prolongation_matrix_1d,
+                                   const unsigned int  degree_size,
+                                   const unsigned int  n_components,
+                                   const bool          element_is_continuous)
+    {
+      extern __shared__ char shared_memory[];
+
+      const unsigned int n_child_dofs_1d = 2*degree_size - element_is_continuous;
+      const unsigned int n_child_dofs = blockDim.x;
+      const unsigned int n_parent_dofs = dim == 1 ? degree_size :
+                                         (dim == 2 ? degree_size*degree_size :
+                                          degree_size*degree_size*degree_size);
+      Number *matrix = reinterpret_cast<Number *>(shared_memory);
+      Number *values = matrix + degree_size*n_child_dofs_1d;
+      Number *tmp = values + n_child_dofs;
+
+      const unsigned int cell = blockIdx.x;
+      const unsigned int tid = threadIdx.x;
+      const unsigned int i = tid % n_child_dofs_1d;
+      const unsigned int j = dim > 1 ? (tid / n_child_dofs_1d) % n_child_dofs_1d : 0;
+      const unsigned int k = dim > 2 ? tid / (n_child_dofs_1d*n_child_dofs_1d) : 0;
+      const unsigned int stride_j = n_child_dofs_1d;
+      const unsigned int stride_k = n_child_dofs_1d*n_child_dofs_1d;
+
+      for (unsigned int l=tid; l<degree_size*n_child_dofs_1d; l+=blockDim.x)
+        matrix[l] = prolongation_matrix_1d[l];
+
+      Number weight = 1.;
+      if (element_is_continuous)
+        weight = weights[cell*(dim == 1 ? 3 : (dim == 2 ? 9 : 27)) +
+                         9*weight_index_1d(k, n_child_dofs_1d) +
+                         3*weight_index_1d(j, n_child_dofs_1d) +
+                         weight_index_1d(i, n_child_dofs_1d)];
+
+      for (unsigned int c=0; c<n_components; ++c)
+        {
+          // read from the source vector, with zero for constrained entries
+          if (i < degree_size && j < degree_size && k < degree_size)
+            {
+              const unsigned int index =
+                parent_indices[(cell*n_components+c)*n_parent_dofs +
+                               (k*degree_size+j)*degree_size+i];
+              values[tid] = index == numbers::invalid_unsigned_int ?
+                            Number() : src[index];
+            }
+          __syncthreads();
+
+          if (j < degree_size && k < degree_size)
+            {
+              Number sum = Number();
+              for (unsigned int m=0; m<degree_size; ++m)
+                sum += matrix[m*n_child_dofs_1d+i] * values[k*stride_k+j*stride_j+m];
+              tmp[tid] = sum;
+            }
+          __syncthreads();
+
+          if (dim > 1 && k < degree_size)
+            {
+              Number sum = Number();
+              for (unsigned int m=0; m<degree_size; ++m)
+                sum += matrix[m*n_child_dofs_1d+j] * tmp[k*stride_k+m*stride_j+i];
+              values[tid] = sum;
+            }
+          __syncthreads();
+
+          if (dim > 2)
+            {
+              Number sum = Number();
+              for (unsigned int m=0; m<degree_size; ++m)
+                sum += matrix[m*n_child_dofs_1d+k] * values[m*stride_k+j*stride_j+i];
+              tmp[tid] = sum;
+            }
+
+          const Number result = (dim == 2 ? values[tid] : tmp[tid]) * weight;
+          const unsigned int index = child_indices[(cell*n_components+c)*n_child_dofs+tid];
+          LinearAlgebra::CUDAWrappers::atomicAdd_wrapper(&dst[index], result);
+          __syncthreads();
+        }
+    }
+
+
+
+    // Restrict from the children of the parent cell with index blockIdx.x,
+    // the transpose operation of prolongate_add()
+    template <int dim, typename Number>
+    __global__ void restrict_add(Number             *dst,
+                                 const Number       *src,
+                                 const unsigned int *child_indices,
+                                 const unsigned int *parent_indices,
+                                 const Number       *weights,
+                                 const Number       *prolongation_matrix_1d,
+                                 const unsigned int  degree_size,
+                                 const unsigned int  n_components,
+                                 const bool          element_is_continuous)
+    {
+      extern __shared__ char shared_memory[];
+
+      const unsigned int n_child_dofs_1d = 2*degree_size - element_is_continuous;
+      const unsigned int n_child_dofs = blockDim.x;
+      const unsigned int n_parent_dofs = dim == 1 ? degree_size :
+                                         (dim == 2 ? degree_size*degree_size :
+                                          degree_size*degree_size*degree_size);
+      Number *matrix = reinterpret_cast<Number *>(shared_memory);
+      Number *values = matrix + degree_size*n_child_dofs_1d;
+      Number *tmp = values + n_child_dofs;
+
+      const unsigned int cell = blockIdx.x;
+      const unsigned int tid = threadIdx.x;
+      const unsigned int i = tid % n_child_dofs_1d;
+      const unsigned int j = dim > 1 ? (tid / n_child_dofs_1d) % n_child_dofs_1d : 0;
+      const unsigned int k = dim > 2 ? tid / (n_child_dofs_1d*n_child_dofs_1d) : 0;
+      const unsigned int stride_j = n_child_dofs_1d;
+      const unsigned int stride_k = n_child_dofs_1d*n_child_dofs_1d;
+
+      for (unsigned int l=tid; l<degree_size*n_child_dofs_1d; l+=blockDim.x)
+        matrix[l] = prolongation_matrix_1d[l];
+
+      Number weight = 1.;
+      if (element_is_continuous)
+        weight = weights[cell*(dim == 1 ? 3 : (dim == 2 ? 9 : 27)) +
+                         9*weight_index_1d(k, n_child_dofs_1d) +
+                         3*weight_index_1d(j, n_child_dofs_1d) +
+                         weight_index_1d(i, n_child_dofs_1d)];
+
+      for (unsigned int c=0; c<n_components; ++c)
+        {
+          values[tid] = weight *
+                        src[child_indices[(cell*n_components+c)*n_child_dofs+tid]];
+          __syncthreads();
+
+          if (i < degree_size)
+            {
+              Number sum = Number();
+              for (unsigned int m=0; m<n_child_dofs_1d; ++m)
+                sum += matrix[i*n_child_dofs_1d+m] * values[k*stride_k+j*stride_j+m];
+              tmp[tid] = sum;
+            }
+          __syncthreads();
+
+          if (dim > 1 && i < degree_size && j < degree_size)
+            {
+              Number sum = Number();
+              for (unsigned int m=0; m<n_child_dofs_1d; ++m)
+                sum += matrix[j*n_child_dofs_1d+m] * tmp[k*stride_k+m*stride_j+i];
+              values[tid] = sum;
+            }
+          __syncthreads();
+
+          if (dim > 2 && i < degree_size && j < degree_size && k < degree_size)
+            {
+              Number sum = Number();
+              for (unsigned int m=0; m<n_child_dofs_1d; ++m)
+                sum += matrix[k*n_child_dofs_1d+m] * values[m*stride_k+j*stride_j+i];
+              tmp[tid] = sum;
+            }
+
+          // write into the destination vector, skipping constrained entries
+          if (i < degree_size && j < degree_size && k < degree_size)
+            {
+              const unsigned int index =
+                parent_indices[(cell*n_components+c)*n_parent_dofs +
+                               (k*degree_size+j)*degree_size+i];
+              if (index != numbers::invalid_unsigned_int)
+                LinearAlgebra::CUDAWrappers::atomicAdd_wrapper(&dst[index],
+                                                               dim == 2 ? values[tid] : tmp[tid]);
+            }
+          __syncthreads();
+        }
+    }
+
+
+
+    // Copy the entries src[src_indices[i]] into dst[dst_indices[i]], or add
+    // them if add is true
+    template <typename Number, bool add>
+    __global__ void copy_with_indices(Number             *dst,
+                                      const unsigned int *dst_indices,
+                                      const Number       *src,
+                                      const unsigned int *src_indices,
+                                      const unsigned int  n)
+    {
+      const unsigned int idx_base = threadIdx.x + blockIdx.x * (blockDim.x*CHUNK_SIZE);
+      for (unsigned int i=0; i<CHUNK_SIZE; ++i)
+        {
+          const unsigned int idx = idx_base + i*BLOCK_SIZE;
+          if (idx<n)
+            {
+              if (add)
+                dst[dst_indices[idx]] += src[src_indices[idx]];
+              else
+                dst[dst_indices[idx]] = src[src_indices[idx]];
+            }
+        }
+    }
+
+
+
+    template <typename Type>
+    void copy_to_device(const std::vector<Type> &host_data,
+                        Type                   *&device_data)
+    {
+      device_data = nullptr;
+      if (host_data.empty())
+        return;
+      cudaError_t error_code = cudaMalloc(&device_data,
+                                          host_data.size()*sizeof(Type));
+      AssertCuda(error_code);
+      error_code = cudaMemcpy(device_data, host_data.data(),
+                              host_data.size()*sizeof(Type),
+                              cudaMemcpyHostToDevice);
+      AssertCuda(error_code);
+    }
+
+
+
+    template <typename Type>
+    void free_on_device(std::vector<Type *> &device_data)
+    {
+      for (unsigned int i=0; i<device_data.size(); ++i)
+        if (device_data[i] != nullptr)
+          {
+            const cudaError_t error_code = cudaFree(device_data[i]);
+            AssertCuda(error_code);
+            device_data[i] = nullptr;
+          }
+      device_data.clear();
+    }
+  }
+
+
+
+  template <int dim, typename Number>
+  MGTransferMatrixFree<dim,Number>::MGTransferMatrixFree ()
+    :
+    fe_degree(0),
+    element_is_continuous(false),
+    n_components(0),
+    n_child_cell_dofs(0),
+    prolongation_matrix_1d_dev(nullptr)
+  {}
+
+
+
+  template <int dim, typename Number>
+  MGTransferMatrixFree<dim,Number>::MGTransferMatrixFree (const MGConstrainedDoFs &mg_c)
+    :
+    mg_constrained_dofs(&mg_c),
+    fe_degree(0),
+    element_is_continuous(false),
+    n_components(0),
+    n_child_cell_dofs(0),
+    prolongation_matrix_1d_dev(nullptr)
+  {}
+
+
+
+  template <int dim, typename Number>
+  MGTransferMatrixFree<dim,Number>::~MGTransferMatrixFree ()
+  {
+    free();
+  }
+
+
+
+  template <int dim, typename Number>
+  void MGTransferMatrixFree<dim,Number>::initialize_constraints
+  (const MGConstrainedDoFs &mg_c)
+  {
+    mg_constrained_dofs = &mg_c;
+  }
+
+
+
+  template <int dim, typename Number>
+  void MGTransferMatrixFree<dim,Number>::clear ()
+  {
+    free();
+    fe_degree = 0;
+    element_is_continuous = false;
+    n_components = 0;
+    n_child_cell_dofs = 0;
+    n_parent_cells.clear();
+    n_copy_indices.clear();
+    n_level_dofs.clear();
+  }
+
+
+
+  template <int dim, typename Number>
+  void MGTransferMatrixFree<dim,Number>::free ()
+  {
+    if (prolongation_matrix_1d_dev != nullptr)
+      {
+        const cudaError_t error_code = cudaFree(prolongation_matrix_1d_dev);
+        AssertCuda(error_code);
+        prolongation_matrix_1d_dev = nullptr;
+      }
+    internal::free_on_device(child_indices_dev);
+    internal::free_on_device(parent_indices_dev);
+    internal::free_on_device(weights_dev);
+    internal::free_on_device(copy_indices_dev);
+  }
+
+
+
+  template <int dim, typename Number>
+  void MGTransferMatrixFree<dim,Number>::build (const DoFHandler<dim> &mg_dof)
+  {
+    AssertThrow(dynamic_cast<const parallel::Triangulation<dim> *>
+                (&mg_dof.get_triangulation()) == nullptr,
+                ExcMessage("The transfer on the device only works with serial "
+                           "triangulations."));
+
+    clear();
+
+    const unsigned int n_levels = mg_dof.get_triangulation().n_global_levels();
+    n_level_dofs.resize(n_levels);
+    for (unsigned int level=0; level<n_levels; ++level)
+      {
+        n_level_dofs[level] = mg_dof.n_dofs(level);
+        AssertThrow(n_level_dofs[level] < numbers::invalid_unsigned_int,
+                    ExcMessage("The transfer on the device uses 32 bit indices."));
+      }
+
+    // the copy indices between the global and the level vectors, whose
+    // parts for the indices owned by other processors stay empty on serial
+    // meshes
+    {
+      std::vector<std::vector<std::pair<types::global_dof_index, types::global_dof_index> > >
+      copy_indices, copy_indices_global_mine, copy_indices_level_mine;
+      dealii::internal::MGTransfer::fill_copy_indices(mg_dof, mg_constrained_dofs,
+                                                      copy_indices,
+                                                      copy_indices_global_mine,
+                                                      copy_indices_level_mine);
+      n_copy_indices.resize(n_levels);
+      copy_indices_dev.resize(n_levels, nullptr);
+      for (unsigned int level=0; level<n_levels; ++level)
+        {
+          const unsigned int n = copy_indices[level].size();
+          n_copy_indices[level] = n;
+          std::vector<unsigned int> indices(2*n);
+          for (unsigned int i=0; i<n; ++i)
+            {
+              indices[i] = copy_indices[level][i].first;
+              indices[n+i] = copy_indices[level][i].second;
+            }
+          internal::copy_to_device(indices, copy_indices_dev[level]);
+        }
+    }
+
+    // set up the transfer on the host like MGTransferMatrixFree
+    dealii::internal::MGTransfer::ElementInfo<Number> elem_info;
+    std::vector<std::vector<unsigned int> > level_dof_indices;
+    std::vector<std::vector<std::pair<unsigned int,unsigned int> > > parent_child_connect;
+    std::vector<std::vector<std::vector<unsigned short> > > dirichlet_indices;
+    std::vector<std::vector<Number> > weights_on_refined;
+    std::vector<std::vector<std::pair<unsigned int, unsigned int> > > copy_indices_global_mine;
+    MGLevelObject<LinearAlgebra::distributed::Vector<Number> > ghosted_level_vector;
+    dealii::internal::MGTransfer::setup_transfer<dim,Number>(mg_dof,
+                                                             mg_constrained_dofs,
+                                                             elem_info,
+                                                             level_dof_indices,
+                                                             parent_child_connect,
+                                                             n_parent_cells,
+                                                             dirichlet_indices,
+                                                             weights_on_refined,
+                                                             copy_indices_global_mine,
+                                                             ghosted_level_vector);
+
+    fe_degree             = elem_info.fe_degree;
+    element_is_continuous = elem_info.element_is_continuous;
+    n_components          = elem_info.n_components;
+    n_child_cell_dofs     = elem_info.n_child_cell_dofs;
+
+    const unsigned int degree_size = fe_degree + 1;
+    const unsigned int n_child_dofs_1d = 2*degree_size - element_is_continuous;
+    const unsigned int n_scalar_cell_dofs = Utilities::fixed_power<dim>(n_child_dofs_1d);
+    const unsigned int n_parent_dofs = Utilities::fixed_power<dim>(degree_size);
+    AssertThrow(n_scalar_cell_dofs <= 1024,
+                ExcMessage("The transfer on the device runs one thread for "
+                           "each degree of freedom on the children of a cell, "
+                           "which must not exceed 1024."));
+
+    internal::copy_to_device(elem_info.prolongation_matrix_1d,
+                             prolongation_matrix_1d_dev);
+
+    child_indices_dev.resize(n_levels-1, nullptr);
+    parent_indices_dev.resize(n_levels-1, nullptr);
+    weights_dev.resize(n_levels-1, nullptr);
+    for (unsigned int level=0; level<n_levels-1; ++level)
+      {
+        const unsigned int n_cells = n_parent_cells[level];
+        AssertDimension(level_dof_indices[level+1].size(),
+                        n_cells*n_child_cell_dofs);
+        internal::copy_to_device(level_dof_indices[level+1], child_indices_dev[level]);
+
+        // extract the indices of the parent cells from the child patches of
+        // the next coarser level in the order they are read by the kernels,
+        // marking the entries constrained by Dirichlet conditions
+        std::vector<unsigned int> parent_indices(n_cells*n_components*n_parent_dofs);
+        for (unsigned int cell=0; cell<n_cells; ++cell)
+          {
+            const unsigned int shift = dealii::internal::MGTransfer::compute_shift_within_children<dim>
+                                       (parent_child_connect[level][cell].second,
+                                        fe_degree+1-element_is_continuous, fe_degree);
+            const unsigned int *indices = &level_dof_indices[level][parent_child_connect[level][cell].first*n_child_cell_dofs+shift];
+            unsigned int *parent = &parent_indices[cell*n_components*n_parent_dofs];
+            for (unsigned int c=0, m=0; c<n_components; ++c)
+              for (unsigned int k=0; k<(dim>2 ? degree_size : 1); ++k)
+                for (unsigned int j=0; j<(dim>1 ? degree_size : 1); ++j)
+                  for (unsigned int i=0; i<degree_size; ++i, ++m)
+                    parent[m] = indices[c*n_scalar_cell_dofs +
+                                        k*n_child_dofs_1d*n_child_dofs_1d+
+                                        j*n_child_dofs_1d+i];
+            for (unsigned int i=0; i<dirichlet_indices[level][cell].size(); ++i)
+              parent[dirichlet_indices[level][cell][i]] = numbers::invalid_unsigned_int;
+          }
+        internal::copy_to_device(parent_indices, parent_indices_dev[level]);
+
+        if (element_is_continuous)
+          internal::copy_to_device(weights_on_refined[level], weights_dev[level]);
+      }
+  }
+
+
+
+  template <int dim, typename Number>
+  void MGTransferMatrixFree<dim,Number>
+  ::prolongate (const unsigned int                                  to_level,
+                LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const
+  {
+    Assert ((to_level >= 1) && (to_level<=child_indices_dev.size()),
+            ExcIndexRange (to_level, 1, child_indices_dev.size()+1));
+    AssertDimension(dst.size(), n_level_dofs[to_level]);
+    AssertDimension(src.size(), n_level_dofs[to_level-1]);
+
+    dst = 0.;
+    const unsigned int n_cells = n_parent_cells[to_level-1];
+    if (n_cells == 0)
+      return;
+
+    const unsigned int degree_size = fe_degree + 1;
+    const unsigned int n_threads =
+      Utilities::fixed_power<dim>(2*degree_size - element_is_continuous);
+    const std::size_t shared_memory_size =
+      (degree_size*(2*degree_size - element_is_continuous) + 2*n_threads) *
+      sizeof(Number);
+    internal::prolongate_add<dim,Number> <<<n_cells,n_threads,shared_memory_size>>>
+    (dst.get_values(), src.get_values(), child_indices_dev[to_level-1],
+     parent_indices_dev[to_level-1], weights_dev[to_level-1],
+     prolongation_matrix_1d_dev, degree_size, n_components,
+     element_is_continuous);
+
+    // Check that the kernel was launched correctly
+    AssertCuda(cudaGetLastError());
+    // Check that there was no problem during the execution of the kernel
+    AssertCuda(cudaDeviceSynchronize());
+  }
+
+
+
+  template <int dim, typename Number>
+  void MGTransferMatrixFree<dim,Number>
+  ::restrict_and_add (const unsigned int                                  from_level,
+                      LinearAlgebra::CUDAWrappers::Vector<Number>       &dst,
+                      const LinearAlgebra::CUDAWrappers::Vector<Number> &src) const
+  {
+    Assert ((from_level >= 1) && (from_level<=child_indices_dev.size()),
+            ExcIndexRange (from_level, 1, child_indices_dev.size()+1));
+    AssertDimension(dst.size(), n_level_dofs[from_level-1]);
+    AssertDimension(src.size(), n_level_dofs[from_level]);
+
+    const unsigned int n_cells = n_parent_cells[from_level-1];
+    if (n_cells == 0)
+      return;
+
+    const unsigned int degree_size = fe_degree + 1;
+    const unsigned int n_threads =
+      Utilities::fixed_power<dim>(2*degree_size - element_is_continuous);
+    const std::size_t shared_memory_size =
+      (degree_size*(2*degree_size - element_is_continuous) + 2*n_threads) *
+      sizeof(Number);
+    internal::restrict_add<dim,Number> <<<n_cells,n_threads,shared_memory_size>>>
+    (dst.get_values(), src.get_values(), child_indices_dev[from_level-1],
+     parent_indices_dev[from_level-1], weights_dev[from_level-1],
+     prolongation_matrix_1d_dev, degree_size, n_components,
+     element_is_continuous);
+
+    // Check that the kernel was launched correctly
+    AssertCuda(cudaGetLastError());
+    // Check that there was no problem during the execution of the kernel
+    AssertCuda(cudaDeviceSynchronize());
+  }
+
+
+
+  template <int dim, typename Number>
+  void MGTransferMatrixFree<dim,Number>
+  ::copy_to_mg (const DoFHandler<dim>                                        &mg_dof,
+                MGLevelObject<LinearAlgebra::CUDAWrappers::Vector<Number> > &dst,
+                const LinearAlgebra::CUDAWrappers::Vector<Number>           &src) const
+  {
+    (void)mg_dof;
+    AssertIndexRange(dst.max_level(), n_level_dofs.size());
+    AssertDimension(src.size(), mg_dof.n_dofs());
+
+    for (unsigned int level=dst.max_level()+1; level != dst.min_level(); )
+      {
+        --level;
+        if (dst[level].size() != n_level_dofs[level])
+          dst[level].reinit(n_level_dofs[level]);
+        else
+          dst[level] = 0.;
+
+        const unsigned int n = n_copy_indices[level];
+        if (n == 0)
+          continue;
+        const unsigned int n_blocks = 1 + (n-1)/(CHUNK_SIZE*BLOCK_SIZE);
+        internal::copy_with_indices<Number,false> <<<n_blocks,BLOCK_SIZE>>>
+        (dst[level].get_values(), copy_indices_dev[level]+n,
+         src.get_values(), copy_indices_dev[level], n);
+        AssertCuda(cudaGetLastError());
+      }
+    AssertCuda(cudaDeviceSynchronize());
+  }
+
+
+
+  template <int dim, typename Number>
+  void MGTransferMatrixFree<dim,Number>
+  ::copy_from_mg (const DoFHandler<dim>                                              &mg_dof,
+                  LinearAlgebra::CUDAWrappers::Vector<Number>                       &dst,
+                  const MGLevelObject<LinearAlgebra::CUDAWrappers::Vector<Number> > &src) const
+  {
+    dst = 0.;
+    copy_from_mg_add(mg_dof, dst, src);
+  }
+
+
+
+  template <int dim, typename Number>
+  void MGTransferMatrixFree<dim,Number>
+  ::copy_from_mg_add (const DoFHandler<dim>                                              &mg_dof,
+                      LinearAlgebra::CUDAWrappers::Vector<Number>                       &dst,
+                      const MGLevelObject<LinearAlgebra::CUDAWrappers::Vector<Number> > &src) const
+  {
+    (void)mg_dof;
+    AssertIndexRange(src.max_level(), n_level_dofs.size());
+    AssertDimension(dst.size(), mg_dof.n_dofs());
+
+    // each global index appears at most once on a level, so the levels can
+    // be added without atomic operations when working on them one after the
+    // other
+    for (unsigned int level=src.min_level(); level<=src.max_level(); ++level)
+      {
+        AssertDimension(src[level].size(), n_level_dofs[level]);
+        const unsigned int n = n_copy_indices[level];
+        if (n == 0)
+          continue;
+        const unsigned int n_blocks = 1 + (n-1)/(CHUNK_SIZE*BLOCK_SIZE);
+        internal::copy_with_indices<Number,true> <<<n_blocks,BLOCK_SIZE>>>
+        (dst.get_values(), copy_indices_dev[level],
+         src[level].get_values(), copy_indices_dev[level]+n, n);
+        AssertCuda(cudaGetLastError());
+      }
+    AssertCuda(cudaDeviceSynchronize());
+  }
+
+
+
+  template <int dim, typename Number>
+  std::size_t
+  MGTransferMatrixFree<dim,Number>::memory_consumption () const
+  {
+    const unsigned int degree_size = fe_degree + 1;
+    const unsigned int n_parent_dofs = n_components*Utilities::fixed_power<dim>(degree_size);
+    std::size_t memory = sizeof(*this) +
+                         degree_size*(2*degree_size-element_is_continuous)*sizeof(Number);
+    for (unsigned int level=0; level<n_parent_cells.size(); ++level)
+      {
+        memory += n_parent_cells[level]*(n_child_cell_dofs+n_parent_dofs)*sizeof(unsigned int);
+        if (element_is_continuous)
+          memory += n_parent_cells[level]*Utilities::fixed_power<dim>(3)*sizeof(Number);
+      }
+    for (unsigned int level=0; level<n_copy_indices.size(); ++level)
+      memory += 2*n_copy_indices[level]*sizeof(unsigned int);
+    return memory;
+  }
+
+
+
+#include "cuda_mg_transfer_matrix_free.inst"
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2016 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -21,12 +21,22 @@
 #include <deal.II/lac/petsc_parallel_block_vector.h>
 #include <deal.II/lac/trilinos_vector.h>
 #include <deal.II/lac/trilinos_parallel_block_vector.h>
+#include <deal.II/lac/cuda_vector.h>
 #include <deal.II/multigrid/mg_base.h>
 
 
 DEAL_II_NAMESPACE_OPEN
 
 
+template <typename VectorType>
+bool
+MGTransferBase<VectorType>::is_active_on_level (const unsigned int) const
+{
+  return true;
+}
+
+
+
 template <typename VectorType>
 void
 MGSmootherBase<VectorType>::apply (const unsigned int level,
@@ -42,4 +52,15 @@ MGSmootherBase<VectorType>::apply (const unsigned int level,
 
 #include "mg_base.inst"
 
+#ifdef DEAL_II_WITH_CUDA
+template class MGTransferBase<LinearAlgebra::CUDAWrappers::Vector<float> >;
+template class MGMatrixBase<LinearAlgebra::CUDAWrappers::Vector<float> >;
+template class MGSmootherBase<LinearAlgebra::CUDAWrappers::Vector<float> >;
+template class MGCoarseGridBase<LinearAlgebra::CUDAWrappers::Vector<float> >;
+template class MGTransferBase<LinearAlgebra::CUDAWrappers::Vector<double> >;
+template class MGMatrixBase<LinearAlgebra::CUDAWrappers::Vector<double> >;
+template class MGSmootherBase<LinearAlgebra::CUDAWrappers::Vector<double> >;
+template class MGCoarseGridBase<LinearAlgebra::CUDAWrappers::Vector<double> >;
+#endif
+
 DEAL_II_NAMESPACE_CLOSE
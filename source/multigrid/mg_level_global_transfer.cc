@@ -329,6 +329,222 @@ MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::fill_and_com
 
 
 
+template <typename Number>
+template <int dim, int spacedim>
+void
+MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::setup_agglomeration
+(const DoFHandler<dim,spacedim> &mg_dof)
+{
+  agglomerated_partitioners.clear();
+  agglomeration_communicators.clear();
+  agglomeration_exchange_vectors.clear();
+  agglomeration_natural_indices.clear();
+
+  const parallel::Triangulation<dim, spacedim> *ptria =
+    dynamic_cast<const parallel::Triangulation<dim, spacedim> *>
+    (&mg_dof.get_triangulation());
+  if (agglomeration_min_cells == 0 || ptria == nullptr)
+    return;
+
+#ifdef DEAL_II_WITH_MPI
+  const MPI_Comm mpi_communicator = ptria->get_communicator();
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes(mpi_communicator);
+  const unsigned int my_pid = Utilities::MPI::this_mpi_process(mpi_communicator);
+  const unsigned int n_levels = ptria->n_global_levels();
+
+  agglomerated_partitioners.resize(n_levels);
+  agglomeration_communicators.resize(n_levels);
+  agglomeration_exchange_vectors.resize(n_levels);
+  agglomeration_natural_indices.resize(n_levels);
+
+  // go from the finest to the coarsest level, which is never agglomerated,
+  // and reduce the number of participating processors as the number of
+  // cells decreases
+  unsigned int n_active_procs = n_procs;
+  for (unsigned int level=n_levels-1; level > 0; )
+    {
+      --level;
+      const unsigned int n_active_procs_finer = n_active_procs;
+
+      types::global_dof_index n_owned_cells = 0;
+      for (typename Triangulation<dim,spacedim>::cell_iterator
+           cell = ptria->begin(level); cell != ptria->end(level); ++cell)
+        if (cell->level_subdomain_id() == ptria->locally_owned_subdomain())
+          ++n_owned_cells;
+      const types::global_dof_index n_cells =
+        Utilities::MPI::sum(n_owned_cells, mpi_communicator);
+
+      const types::global_dof_index n_target_procs =
+        std::max<types::global_dof_index>(1, n_cells/agglomeration_min_cells);
+      if (n_target_procs < n_active_procs)
+        n_active_procs = static_cast<unsigned int>(n_target_procs);
+      if (n_active_procs == n_procs)
+        continue;
+
+      // create a new sub-communicator only when the number of participating
+      // processors changes
+      const bool is_active = my_pid < n_active_procs;
+      if (n_active_procs == n_active_procs_finer)
+        agglomeration_communicators[level] = agglomeration_communicators[level+1];
+      else
+        {
+          MPI_Comm sub_communicator;
+          const int ierr = MPI_Comm_split(mpi_communicator,
+                                          is_active ? 0 : MPI_UNDEFINED,
+                                          my_pid, &sub_communicator);
+          AssertThrowMPI(ierr);
+          if (is_active)
+            agglomeration_communicators[level].reset(new MPI_Comm(sub_communicator),
+                                                     [](MPI_Comm *comm)
+            {
+              MPI_Comm_free(comm);
+              delete comm;
+            });
+        }
+
+      // distribute the level degrees of freedom in contiguous blocks among
+      // the participating processors
+      const types::global_dof_index n_dofs = mg_dof.n_dofs(level);
+      IndexSet agglomerated_owned(n_dofs);
+      if (is_active)
+        agglomerated_owned.add_range(n_dofs*my_pid/n_active_procs,
+                                     n_dofs*(my_pid+1)/n_active_procs);
+      agglomerated_partitioners[level].reset
+      (new Utilities::MPI::Partitioner(agglomerated_owned,
+                                       is_active ?
+                                       *agglomeration_communicators[level] :
+                                       MPI_COMM_SELF));
+
+      // the exchange vector owns the agglomerated entries and imports the
+      // entries owned in the natural layout
+      const IndexSet &natural_owned = mg_dof.locally_owned_mg_dofs(level);
+      std::shared_ptr<const Utilities::MPI::Partitioner> exchange_partitioner
+      (new Utilities::MPI::Partitioner(agglomerated_owned, natural_owned,
+                                       mpi_communicator));
+      agglomeration_exchange_vectors[level].reinit(exchange_partitioner);
+
+      agglomeration_natural_indices[level].resize(natural_owned.n_elements());
+      for (unsigned int i=0; i<natural_owned.n_elements(); ++i)
+        agglomeration_natural_indices[level][i] =
+          exchange_partitioner->global_to_local(natural_owned.nth_index_in_set(i));
+    }
+#else
+  (void)mg_dof;
+#endif
+}
+
+
+
+template <typename Number>
+MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::MGLevelGlobalTransfer ()
+  :
+  perform_plain_copy (false),
+  perform_renumbered_plain_copy (false),
+  agglomeration_min_cells (0)
+{}
+
+
+
+template <typename Number>
+void
+MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::set_coarse_level_agglomeration
+(const unsigned int min_cells_per_process)
+{
+  agglomeration_min_cells = min_cells_per_process;
+}
+
+
+
+template <typename Number>
+std::shared_ptr<const Utilities::MPI::Partitioner>
+MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::get_agglomerated_partitioner
+(const unsigned int level) const
+{
+  if (level < agglomerated_partitioners.size())
+    return agglomerated_partitioners[level];
+  else
+    return std::shared_ptr<const Utilities::MPI::Partitioner>();
+}
+
+
+
+template <typename Number>
+bool
+MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::level_is_agglomerated
+(const unsigned int level) const
+{
+  return level < agglomerated_partitioners.size() &&
+         agglomerated_partitioners[level].get() != nullptr;
+}
+
+
+
+template <typename Number>
+bool
+MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::is_active_on_level
+(const unsigned int level) const
+{
+  return !level_is_agglomerated(level) ||
+         agglomeration_communicators[level].get() != nullptr;
+}
+
+
+
+template <typename Number>
+void
+MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::copy_to_agglomerated
+(const unsigned int                                level,
+ LinearAlgebra::distributed::Vector<Number>       &dst,
+ const LinearAlgebra::distributed::Vector<Number> &src,
+ const bool                                        add) const
+{
+  Assert(level_is_agglomerated(level), ExcInternalError());
+  LinearAlgebra::distributed::Vector<Number> &exchange =
+    agglomeration_exchange_vectors[level];
+  const std::vector<unsigned int> &natural_indices =
+    agglomeration_natural_indices[level];
+  AssertDimension(natural_indices.size(), src.local_size());
+  AssertDimension(exchange.local_size(), dst.local_size());
+
+  // every entry of the agglomerated layout is owned by exactly one processor
+  // in the natural layout, so adding into a zeroed vector moves the data
+  exchange = 0.;
+  for (unsigned int i=0; i<natural_indices.size(); ++i)
+    exchange.local_element(natural_indices[i]) = src.local_element(i);
+  exchange.compress(VectorOperation::add);
+
+  if (add)
+    for (unsigned int i=0; i<dst.local_size(); ++i)
+      dst.local_element(i) += exchange.local_element(i);
+  else
+    dst.copy_locally_owned_data_from(exchange);
+}
+
+
+
+template <typename Number>
+void
+MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::copy_from_agglomerated
+(const unsigned int                                level,
+ LinearAlgebra::distributed::Vector<Number>       &dst,
+ const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  Assert(level_is_agglomerated(level), ExcInternalError());
+  LinearAlgebra::distributed::Vector<Number> &exchange =
+    agglomeration_exchange_vectors[level];
+  const std::vector<unsigned int> &natural_indices =
+    agglomeration_natural_indices[level];
+  AssertDimension(natural_indices.size(), dst.local_size());
+  AssertDimension(exchange.local_size(), src.local_size());
+
+  exchange.copy_locally_owned_data_from(src);
+  exchange.update_ghost_values();
+  for (unsigned int i=0; i<natural_indices.size(); ++i)
+    dst.local_element(i) = exchange.local_element(natural_indices[i]);
+}
+
+
+
 template <typename Number>
 void
 MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::clear()
@@ -343,6 +559,11 @@ MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::clear()
   ghosted_level_vector.resize(0, 0);
   perform_plain_copy = false;
   perform_renumbered_plain_copy = false;
+  agglomeration_min_cells = 0;
+  agglomerated_partitioners.clear();
+  agglomeration_communicators.clear();
+  agglomeration_exchange_vectors.clear();
+  agglomeration_natural_indices.clear();
 }
 
 
@@ -387,6 +608,9 @@ MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::memory_consu
   for (unsigned int i=ghosted_level_vector.min_level();
        i<=ghosted_level_vector.max_level(); ++i)
     result += ghosted_level_vector[i].memory_consumption();
+  for (unsigned int i=0; i<agglomeration_exchange_vectors.size(); ++i)
+    result += agglomeration_exchange_vectors[i].memory_consumption();
+  result += MemoryConsumption::memory_consumption(agglomeration_natural_indices);
 
   return result;
 }
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2016 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -15,6 +15,7 @@
 
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/work_stream.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/lac/block_sparsity_pattern.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
@@ -548,21 +549,47 @@ namespace MGTools
     Assert (sparsity.n_cols() == n_dofs,
             ExcDimensionMismatch (sparsity.n_cols(), n_dofs));
 
+    // the workers extract and sort the indices of the locally owned cells
+    // in parallel, and the copier adds them to the sparsity pattern row by
+    // row, which is much cheaper than adding the entries one at a time
     const unsigned int dofs_per_cell = dof.get_fe().dofs_per_cell;
-    std::vector<types::global_dof_index> dofs_on_this_cell(dofs_per_cell);
-    typename DoFHandlerType::cell_iterator cell = dof.begin(level),
-                                           endc = dof.end(level);
-    for (; cell!=endc; ++cell)
-      if (dof.get_triangulation().locally_owned_subdomain()==numbers::invalid_subdomain_id
-          || cell->level_subdomain_id()==dof.get_triangulation().locally_owned_subdomain())
+    const types::subdomain_id owned_subdomain
+      = dof.get_triangulation().locally_owned_subdomain();
+    auto worker
+      = [dofs_per_cell, owned_subdomain] (const typename DoFHandlerType::level_cell_iterator &cell,
+                           void *,
+                           std::vector<types::global_dof_index> &dofs_on_this_cell)
+    {
+      if (owned_subdomain==numbers::invalid_subdomain_id
+          || cell->level_subdomain_id()==owned_subdomain)
         {
+          dofs_on_this_cell.resize (dofs_per_cell);
           cell->get_mg_dof_indices (dofs_on_this_cell);
-          // make sparsity pattern for this cell
-          for (unsigned int i=0; i<dofs_per_cell; ++i)
-            for (unsigned int j=0; j<dofs_per_cell; ++j)
-              sparsity.add (dofs_on_this_cell[i],
-                            dofs_on_this_cell[j]);
+          std::sort (dofs_on_this_cell.begin(), dofs_on_this_cell.end());
+          dofs_on_this_cell.erase (std::unique(dofs_on_this_cell.begin(),
+                                               dofs_on_this_cell.end()),
+                                   dofs_on_this_cell.end());
         }
+      else
+        dofs_on_this_cell.clear();
+    };
+
+    auto copier
+      = [&sparsity] (const std::vector<types::global_dof_index> &dofs_on_this_cell)
+    {
+      for (unsigned int i=0; i<dofs_on_this_cell.size(); ++i)
+        sparsity.add_entries (dofs_on_this_cell[i],
+                              dofs_on_this_cell.begin(),
+                              dofs_on_this_cell.end(),
+                              true);
+    };
+
+    WorkStream::run (dof.begin(level), dof.end(level),
+                     worker, copier,
+                     /* scratch_data */ nullptr,
+                     std::vector<types::global_dof_index>(),
+                     2*MultithreadInfo::n_threads(),
+                     /* chunk_size = */ 32);
   }
 
 
@@ -1235,125 +1262,133 @@ namespace MGTools
 
     const unsigned int n_components = DoFTools::n_components(dof);
     const bool         fe_is_system = (n_components != 1);
+    const bool         all_components
+      = (component_mask.n_selected_components(n_components) == n_components);
+    Assert (component_mask.n_selected_components(n_components) > 0,
+            ExcMessage("It's probably worthwhile to select at least one component."));
+
+    // the workers collect the boundary dofs of each cell in parallel into
+    // the copy data, which holds the level of the cell and the indices
+    // found on it. the copier gathers them by level, and they are added to
+    // the index sets at once in the end
+    typedef std::pair<unsigned int, std::vector<types::global_dof_index> > CopyData;
+    std::vector<std::vector<types::global_dof_index> >
+    tmp_boundary_indices (dof.get_triangulation().n_global_levels());
+
+    auto worker
+      = [&] (const typename DoFHandler<dim,spacedim>::level_cell_iterator &cell,
+             std::vector<types::global_dof_index> &local_dofs,
+             CopyData                             &copy_data)
+    {
+      copy_data.second.clear();
+      if (dof.get_triangulation().locally_owned_subdomain()!=numbers::invalid_subdomain_id
+          && cell->level_subdomain_id()==numbers::artificial_subdomain_id)
+        return;
 
-    std::vector<types::global_dof_index> local_dofs;
-    local_dofs.reserve (DoFTools::max_dofs_per_face(dof));
-    std::fill (local_dofs.begin (),
-               local_dofs.end (),
-               numbers::invalid_dof_index);
+      const FiniteElement<dim,spacedim> &fe = cell->get_fe();
+      const unsigned int level = cell->level();
+      copy_data.first = level;
 
-    // First, deal with the simpler case when we have to identify all boundary dofs
-    if (component_mask.n_selected_components(n_components) == n_components)
-      {
-        typename DoFHandler<dim,spacedim>::cell_iterator
-        cell = dof.begin(),
-        endc = dof.end();
-        for (; cell!=endc; ++cell)
-          {
-            if (dof.get_triangulation().locally_owned_subdomain()!=numbers::invalid_subdomain_id
-                && cell->level_subdomain_id()==numbers::artificial_subdomain_id)
+      for (unsigned int face_no = 0; face_no < GeometryInfo<dim>::faces_per_cell;
+           ++face_no)
+        {
+          if (cell->at_boundary(face_no) == false)
+            continue;
+
+          const typename DoFHandler<dim,spacedim>::face_iterator
+          face = cell->face(face_no);
+          const types::boundary_id bi = face->boundary_id();
+          // Face is listed in boundary map
+          if (boundary_ids.find(bi) == boundary_ids.end())
+            continue;
+
+          local_dofs.resize (fe.dofs_per_face);
+          face->get_mg_dof_indices (level, local_dofs);
+
+          // First, deal with the simpler case when we have to identify all
+          // boundary dofs
+          if (all_components)
+            {
+              copy_data.second.insert (copy_data.second.end(),
+                                       local_dofs.begin(), local_dofs.end());
               continue;
-            const FiniteElement<dim> &fe = cell->get_fe();
-            const unsigned int level = cell->level();
-            local_dofs.resize(fe.dofs_per_face);
-
-            for (unsigned int face_no = 0; face_no < GeometryInfo<dim>::faces_per_cell;
-                 ++face_no)
-              if (cell->at_boundary(face_no) == true)
+            }
+
+          for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+            {
+              const ComponentMask &nonzero_component_array
+                = fe.get_nonzero_components (i);
+              // if we want to constrain one of the nonzero components,
+              // we have to constrain all of them
+
+              bool selected = false;
+              for (unsigned int c=0; c<n_components; ++c)
+                if (nonzero_component_array[c] == true
+                    && component_mask[c]== true)
+                  {
+                    selected = true;
+                    break;
+                  }
+              if (selected)
+                for (unsigned int c=0; c<n_components; ++c)
+                  Assert (nonzero_component_array[c] == false || component_mask[c] == true,
+                          ExcMessage ("You are using a non-primitive FiniteElement "
+                                      "and try to constrain just some of its components!"));
+            }
+
+          if (fe_is_system)
+            {
+              for (unsigned int i=0; i<local_dofs.size(); ++i)
                 {
-                  const typename DoFHandler<dim,spacedim>::face_iterator
-                  face = cell->face(face_no);
-                  const types::boundary_id bi = face->boundary_id();
-                  // Face is listed in boundary map
-                  if (boundary_ids.find(bi) != boundary_ids.end())
+                  unsigned int component = numbers::invalid_unsigned_int;
+                  if (fe.is_primitive())
+                    component = fe.face_system_to_component_index(i).first;
+                  else
                     {
-                      face->get_mg_dof_indices(level, local_dofs);
-                      boundary_indices[level].add_indices(local_dofs.begin(), local_dofs.end());
+                      // Just pick the first of the components
+                      // We already know that either all or none
+                      // of the components are selected
+                      const ComponentMask &nonzero_component_array
+                        = fe.get_nonzero_components (i);
+                      for (unsigned int c=0; c<n_components; ++c)
+                        if (nonzero_component_array[c] == true)
+                          {
+                            component = c;
+                            break;
+                          }
                     }
+                  Assert(component!=numbers::invalid_unsigned_int, ExcInternalError());
+                  if (component_mask[component] == true)
+                    copy_data.second.push_back(local_dofs[i]);
                 }
-          }
-      }
-    else
+            }
+          else
+            copy_data.second.insert (copy_data.second.end(),
+                                     local_dofs.begin(), local_dofs.end());
+        }
+    };
+
+    auto copier
+      = [&tmp_boundary_indices] (const CopyData &copy_data)
+    {
+      if (copy_data.second.size() > 0)
+        tmp_boundary_indices[copy_data.first].insert
+        (tmp_boundary_indices[copy_data.first].end(),
+         copy_data.second.begin(), copy_data.second.end());
+    };
+
+    WorkStream::run (dof.begin(), dof.end(),
+                     worker, copier,
+                     std::vector<types::global_dof_index>(), CopyData(),
+                     2*MultithreadInfo::n_threads(),
+                     /* chunk_size = */ 32);
+
+    for (unsigned int l=0; l<dof.get_triangulation().n_global_levels(); ++l)
       {
-        Assert (component_mask.n_selected_components(n_components) > 0,
-                ExcMessage("It's probably worthwhile to select at least one component."));
-
-        typename DoFHandler<dim,spacedim>::cell_iterator
-        cell = dof.begin(),
-        endc = dof.end();
-        for (; cell!=endc; ++cell)
-          if (dof.get_triangulation().locally_owned_subdomain()==numbers::invalid_subdomain_id
-              || cell->level_subdomain_id()!=numbers::artificial_subdomain_id)
-            for (unsigned int face_no = 0; face_no < GeometryInfo<dim>::faces_per_cell;
-                 ++face_no)
-              {
-                if (cell->at_boundary(face_no) == false)
-                  continue;
-
-                const FiniteElement<dim> &fe = cell->get_fe();
-                const unsigned int level = cell->level();
-
-                typename DoFHandler<dim,spacedim>::face_iterator face = cell->face(face_no);
-                const types::boundary_id boundary_component = face->boundary_id();
-                if (boundary_ids.find(boundary_component) != boundary_ids.end())
-                  // we want to constrain this boundary
-                  {
-
-                    for (unsigned int i=0; i<cell->get_fe().dofs_per_cell; ++i)
-                      {
-                        const ComponentMask &nonzero_component_array
-                          = cell->get_fe().get_nonzero_components (i);
-                        // if we want to constrain one of the nonzero components,
-                        // we have to constrain all of them
-
-                        bool selected = false;
-                        for (unsigned int c=0; c<n_components; ++c)
-                          if (nonzero_component_array[c] == true
-                              && component_mask[c]== true)
-                            {
-                              selected = true;
-                              break;
-                            }
-                        if (selected)
-                          for (unsigned int c=0; c<n_components; ++c)
-                            Assert (nonzero_component_array[c] == false || component_mask[c] == true,
-                                    ExcMessage ("You are using a non-primitive FiniteElement "
-                                                "and try to constrain just some of its components!"));
-                      }
-
-                    // get indices, physical location and boundary values of dofs on this face
-                    local_dofs.resize (fe.dofs_per_face);
-                    face->get_mg_dof_indices (level, local_dofs);
-                    if (fe_is_system)
-                      {
-                        for (unsigned int i=0; i<local_dofs.size(); ++i)
-                          {
-                            unsigned int component = numbers::invalid_unsigned_int;
-                            if (fe.is_primitive())
-                              component = fe.face_system_to_component_index(i).first;
-                            else
-                              {
-                                // Just pick the first of the components
-                                // We already know that either all or none
-                                // of the components are selected
-                                const ComponentMask &nonzero_component_array
-                                  = cell->get_fe().get_nonzero_components (i);
-                                for (unsigned int c=0; c<n_components; ++c)
-                                  if (nonzero_component_array[c] == true)
-                                    {
-                                      component = c;
-                                      break;
-                                    }
-                              }
-                            Assert(component!=numbers::invalid_unsigned_int, ExcInternalError());
-                            if (component_mask[component] == true)
-                              boundary_indices[level].add_index(local_dofs[i]);
-                          }
-                      }
-                    else
-                      boundary_indices[level].add_indices(local_dofs.begin(), local_dofs.end());
-                  }
-              }
+        std::sort (tmp_boundary_indices[l].begin(), tmp_boundary_indices[l].end());
+        boundary_indices[l].add_indices (tmp_boundary_indices[l].begin(),
+                                         std::unique(tmp_boundary_indices[l].begin(),
+                                                     tmp_boundary_indices[l].end()));
       }
   }
 
@@ -1444,63 +1479,86 @@ namespace MGTools
     const unsigned int   dofs_per_cell   = fe.dofs_per_cell;
     const unsigned int   dofs_per_face   = fe.dofs_per_face;
 
-    std::vector<types::global_dof_index> local_dof_indices (dofs_per_cell);
-
-    std::vector<bool> cell_dofs(dofs_per_cell, false);
-
-    typename DoFHandler<dim>::cell_iterator cell = mg_dof_handler.begin(),
-                                            endc = mg_dof_handler.end();
-
-    for (; cell!=endc; ++cell)
-      {
-        // Do not look at artificial level cells (in a serial computation we
-        // need to ignore the level_subdomain_id() because it is never set).
-        if (mg_dof_handler.get_triangulation().locally_owned_subdomain()!=numbers::invalid_subdomain_id
-            && cell->level_subdomain_id()==numbers::artificial_subdomain_id)
-          continue;
-
-        bool has_coarser_neighbor = false;
-
-        std::fill (cell_dofs.begin(), cell_dofs.end(), false);
-
-        for (unsigned int face_nr=0; face_nr<GeometryInfo<dim>::faces_per_cell; ++face_nr)
-          {
-            const typename DoFHandler<dim,spacedim>::face_iterator face = cell->face(face_nr);
-            if (!face->at_boundary())
-              {
-                //interior face
-                const typename DoFHandler<dim>::cell_iterator
-                neighbor = cell->neighbor(face_nr);
+    const bool is_parallel
+      = (mg_dof_handler.get_triangulation().locally_owned_subdomain()
+         != numbers::invalid_subdomain_id);
+
+    // the scratch data holds the indices of a cell and the flags marking
+    // the dofs on faces to coarser neighbors, the copy data the level of the
+    // cell and the indices found on it
+    typedef std::pair<std::vector<types::global_dof_index>, std::vector<bool> > ScratchData;
+    typedef std::pair<unsigned int, std::vector<types::global_dof_index> > CopyData;
+
+    auto worker
+      = [&] (const typename DoFHandler<dim,spacedim>::level_cell_iterator &cell,
+             ScratchData &scratch,
+             CopyData    &copy_data)
+    {
+      copy_data.second.clear();
+
+      // Do not look at artificial level cells (in a serial computation we
+      // need to ignore the level_subdomain_id() because it is never set).
+      if (is_parallel
+          && cell->level_subdomain_id()==numbers::artificial_subdomain_id)
+        return;
 
-                // only process cell pairs if one or both of them are owned by me (ignore if running in serial)
-                if (mg_dof_handler.get_triangulation().locally_owned_subdomain()!=numbers::invalid_subdomain_id
-                    &&
-                    neighbor->level_subdomain_id()==numbers::artificial_subdomain_id)
-                  continue;
+      std::vector<bool> &cell_dofs = scratch.second;
+      cell_dofs.assign (dofs_per_cell, false);
+      bool has_coarser_neighbor = false;
 
-                // Do refinement face from the coarse side
-                if (neighbor->level() < cell->level())
-                  {
-                    for (unsigned int j=0; j<dofs_per_face; ++j)
-                      cell_dofs[fe.face_to_cell_index(j,face_nr)] = true;
+      for (unsigned int face_nr=0; face_nr<GeometryInfo<dim>::faces_per_cell; ++face_nr)
+        {
+          const typename DoFHandler<dim,spacedim>::face_iterator face = cell->face(face_nr);
+          if (!face->at_boundary())
+            {
+              //interior face
+              const typename DoFHandler<dim,spacedim>::cell_iterator
+              neighbor = cell->neighbor(face_nr);
+
+              // only process cell pairs if one or both of them are owned by me (ignore if running in serial)
+              if (is_parallel
+                  &&
+                  neighbor->level_subdomain_id()==numbers::artificial_subdomain_id)
+                continue;
 
-                    has_coarser_neighbor = true;
-                  }
-              }
-          }
+              // Do refinement face from the coarse side
+              if (neighbor->level() < cell->level())
+                {
+                  for (unsigned int j=0; j<dofs_per_face; ++j)
+                    cell_dofs[fe.face_to_cell_index(j,face_nr)] = true;
 
-        if (has_coarser_neighbor == false)
-          continue;
+                  has_coarser_neighbor = true;
+                }
+            }
+        }
 
-        const unsigned int level = cell->level();
-        cell->get_mg_dof_indices (local_dof_indices);
+      if (has_coarser_neighbor == false)
+        return;
 
-        for (unsigned int i=0; i<dofs_per_cell; ++i)
-          {
-            if (cell_dofs[i])
-              tmp_interface_dofs[level].push_back(local_dof_indices[i]);
-          }
-      }
+      std::vector<types::global_dof_index> &local_dof_indices = scratch.first;
+      local_dof_indices.resize (dofs_per_cell);
+      cell->get_mg_dof_indices (local_dof_indices);
+
+      copy_data.first = cell->level();
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        if (cell_dofs[i])
+          copy_data.second.push_back(local_dof_indices[i]);
+    };
+
+    auto copier
+      = [&tmp_interface_dofs] (const CopyData &copy_data)
+    {
+      if (copy_data.second.size() > 0)
+        tmp_interface_dofs[copy_data.first].insert
+        (tmp_interface_dofs[copy_data.first].end(),
+         copy_data.second.begin(), copy_data.second.end());
+    };
+
+    WorkStream::run (mg_dof_handler.begin(), mg_dof_handler.end(),
+                     worker, copier,
+                     ScratchData(), CopyData(),
+                     2*MultithreadInfo::n_threads(),
+                     /* chunk_size = */ 32);
 
     for (unsigned int l=0; l<mg_dof_handler.get_triangulation().n_global_levels(); ++l)
       {
@@ -0,0 +1,697 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_tools.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/shape_info.h>
+#include <deal.II/matrix_free/tensor_product_kernels.h>
+#include <deal.II/multigrid/mg_transfer_global_coarsening.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  // Create a 1D copy of the base element of @p fe by substituting the
+  // template argument in the name, as done in MGTransferMatrixFree
+  template <int dim>
+  std::shared_ptr<FiniteElement<1> >
+  get_fe_1d (const FiniteElement<dim> &fe)
+  {
+    AssertDimension(fe.n_base_elements(), 1);
+    std::string fe_name = fe.base_element(0).get_name();
+    const std::size_t template_starts = fe_name.find_first_of('<');
+    Assert (fe_name[template_starts+1] == (dim==1?'1':(dim==2?'2':'3')),
+            ExcInternalError());
+    fe_name[template_starts+1] = '1';
+    std::shared_ptr<FiniteElement<1> > fe_1d(FETools::get_fe_by_name<1,1>(fe_name));
+    AssertDimension(Utilities::fixed_power<dim>(fe_1d->dofs_per_cell)
+                    *fe.element_multiplicity(0), fe.dofs_per_cell);
+    return fe_1d;
+  }
+
+
+
+  // Get the renumbering of the 1D basis functions from the hierarchical
+  // numbering of FE_Q (vertices first) to lexicographic numbering. For
+  // FE_DGQ, this is the identity.
+  std::vector<unsigned int>
+  get_lexicographic_numbering_1d (const FiniteElement<1> &fe)
+  {
+    AssertIndexRange(fe.dofs_per_vertex, 2);
+    std::vector<unsigned int> renumbering(fe.dofs_per_cell);
+    renumbering[0] = 0;
+    for (unsigned int i=0; i<fe.dofs_per_line; ++i)
+      renumbering[i+fe.dofs_per_vertex] =
+        GeometryInfo<1>::vertices_per_cell*fe.dofs_per_vertex + i;
+    if (fe.dofs_per_vertex > 0)
+      renumbering[fe.dofs_per_cell-fe.dofs_per_vertex] = fe.dofs_per_vertex;
+    return renumbering;
+  }
+
+
+
+  // Append the path of @p cell in the refinement tree to @p path in the
+  // format [coarse cell index, number of child indices, child indices from
+  // the coarse cell downwards]. Since all triangulations of the hierarchy
+  // are based on the same coarse mesh, this path identifies the cell on all
+  // processors and all levels, like a CellId.
+  template <int dim>
+  void
+  append_cell_path (const typename DoFHandler<dim>::cell_iterator &cell,
+                    std::vector<unsigned int>                     &path)
+  {
+    typedef typename DoFHandler<dim>::cell_iterator CellIterator;
+    std::vector<unsigned int> children;
+    CellIterator current = cell;
+    while (current->level() > 0)
+      {
+        const CellIterator parent = current->parent();
+        unsigned int child = 0;
+        for ( ; child<parent->n_children(); ++child)
+          if (parent->child(child) == current)
+            break;
+        Assert(child < parent->n_children(), ExcInternalError());
+        children.push_back(child);
+        current = parent;
+      }
+    path.push_back(current->index());
+    path.push_back(children.size());
+    path.insert(path.end(), children.rbegin(), children.rend());
+  }
+
+
+
+  // Follow the path of a fine cell in the coarse triangulation as far as
+  // the coarse mesh is refined. If the cell found is the same as the fine
+  // cell, @p child_index is set to numbers::invalid_unsigned_int, otherwise
+  // to the child number of the fine cell within the coarse cell. Returns
+  // false if the coarse cell is not available on the current processor (in
+  // the artificial region of a parallel triangulation), in which case its
+  // degrees of freedom must be obtained from another processor.
+  template <int dim>
+  bool
+  find_coarse_cell (const DoFHandler<dim>                   &coarse_dof,
+                    const unsigned int                      *path,
+                    typename DoFHandler<dim>::cell_iterator &cell,
+                    unsigned int                            &child_index)
+  {
+    cell = typename DoFHandler<dim>::cell_iterator(&coarse_dof.get_triangulation(),
+                                                   0, path[0], &coarse_dof);
+    const unsigned int n_child_indices = path[1];
+    unsigned int level = 0;
+    for ( ; level<n_child_indices && cell->has_children(); ++level)
+      cell = cell->child(path[2+level]);
+
+    child_index = numbers::invalid_unsigned_int;
+
+    // in the artificial region of a parallel triangulation, the refinement
+    // of the coarse mesh is not known, so let the owner of the cell decide
+    const bool is_parallel =
+      dynamic_cast<const parallel::Triangulation<dim,dim>*>
+      (&coarse_dof.get_triangulation()) != nullptr;
+    if ((cell->has_children() && is_parallel) ||
+        (!cell->has_children() && cell->is_artificial()))
+      return false;
+
+    AssertThrow(!cell->has_children() && level+1 >= n_child_indices,
+                ExcMessage("The triangulations of two consecutive levels must "
+                           "be nested and differ by at most one level of "
+                           "refinement per cell"));
+    if (level < n_child_indices)
+      child_index = path[2+level];
+    return true;
+  }
+
+
+
+#ifdef DEAL_II_WITH_MPI
+  // Obtain the degrees of freedom of the coarse cells that are not present
+  // on the current processor. The paths of these cells are sent to all
+  // processors and the owner of each cell answers with the child index and
+  // the dof indices. This is only done during setup and only for the (few)
+  // fine cells whose coarse cell lies outside the ghost layer of the coarse
+  // triangulation.
+  template <int dim>
+  void
+  import_remote_coarse_cells (const DoFHandler<dim>                &coarse_dof,
+                              const std::vector<unsigned int>      &lexicographic,
+                              const std::vector<unsigned int>      &requests,
+                              const MPI_Comm                        communicator,
+                              std::vector<types::global_dof_index> &coarse_indices,
+                              std::vector<unsigned int>            &child_indices)
+  {
+    const unsigned int n_procs = Utilities::MPI::n_mpi_processes(communicator);
+    const unsigned int my_rank = Utilities::MPI::this_mpi_process(communicator);
+
+    // step 1: collect the requests of all processors
+    int my_size = requests.size();
+    std::vector<int> sizes(n_procs), offsets(n_procs+1, 0);
+    int ierr = MPI_Allgather(&my_size, 1, MPI_INT, sizes.data(), 1, MPI_INT,
+                             communicator);
+    AssertThrowMPI(ierr);
+    for (unsigned int p=0; p<n_procs; ++p)
+      offsets[p+1] = offsets[p] + sizes[p];
+    if (offsets[n_procs] == 0)
+      return;
+
+    std::vector<unsigned int> all_requests(offsets[n_procs]);
+    ierr = MPI_Allgatherv(const_cast<unsigned int *>(requests.data()), my_size,
+                          MPI_UNSIGNED, all_requests.data(), sizes.data(),
+                          offsets.data(), MPI_UNSIGNED, communicator);
+    AssertThrowMPI(ierr);
+
+    // step 2: answer the requests for the coarse cells we own with the list
+    // [fine cell number, child index, dof indices]
+    const unsigned int dofs_per_cell = coarse_dof.get_fe().dofs_per_cell;
+    std::map<unsigned int, std::vector<types::global_dof_index> > answers;
+    std::vector<types::global_dof_index> dof_indices(dofs_per_cell);
+    for (unsigned int p=0; p<n_procs; ++p)
+      if (p != my_rank)
+        for (int pos=offsets[p]; pos<offsets[p+1]; )
+          {
+            const unsigned int fine_cell = all_requests[pos];
+            const unsigned int *path = &all_requests[pos+1];
+            pos += 3 + path[1];
+
+            typename DoFHandler<dim>::cell_iterator cell;
+            unsigned int child_index;
+            if (find_coarse_cell(coarse_dof, path, cell, child_index) &&
+                cell->is_locally_owned())
+              {
+                std::vector<types::global_dof_index> &answer = answers[p];
+                answer.push_back(fine_cell);
+                answer.push_back(child_index);
+                cell->get_dof_indices(dof_indices);
+                answer.insert(answer.end(), dof_indices.begin(), dof_indices.end());
+              }
+          }
+
+    // step 3: send the answers and receive the ones for our requests
+    std::vector<unsigned int> destinations;
+    for (const auto &answer : answers)
+      destinations.push_back(answer.first);
+    std::vector<unsigned int> sources =
+      Utilities::MPI::compute_point_to_point_communication_pattern(communicator,
+          destinations);
+    std::sort(sources.begin(), sources.end());
+
+    std::vector<MPI_Request> mpi_requests(destinations.size());
+    for (unsigned int i=0; i<destinations.size(); ++i)
+      {
+        std::vector<types::global_dof_index> &data = answers[destinations[i]];
+        ierr = MPI_Isend(data.data(), data.size(), DEAL_II_DOF_INDEX_MPI_TYPE,
+                         destinations[i], 73, communicator, &mpi_requests[i]);
+        AssertThrowMPI(ierr);
+      }
+
+    std::vector<types::global_dof_index> receive_buffer;
+    for (unsigned int i=0; i<sources.size(); ++i)
+      {
+        // receive from a specific source to not mix up messages of the
+        // transfer to the next level
+        MPI_Status status;
+        int len;
+        ierr = MPI_Probe(sources[i], 73, communicator, &status);
+        AssertThrowMPI(ierr);
+        ierr = MPI_Get_count(&status, DEAL_II_DOF_INDEX_MPI_TYPE, &len);
+        AssertThrowMPI(ierr);
+        receive_buffer.resize(len);
+        ierr = MPI_Recv(receive_buffer.data(), len, DEAL_II_DOF_INDEX_MPI_TYPE,
+                        status.MPI_SOURCE, status.MPI_TAG, communicator, &status);
+        AssertThrowMPI(ierr);
+
+        Assert(len % (dofs_per_cell+2) == 0, ExcInternalError());
+        for (int pos=0; pos<len; pos+=dofs_per_cell+2)
+          {
+            const unsigned int fine_cell = receive_buffer[pos];
+            AssertIndexRange(fine_cell, child_indices.size());
+            child_indices[fine_cell] = receive_buffer[pos+1];
+            for (unsigned int j=0; j<dofs_per_cell; ++j)
+              coarse_indices[fine_cell*dofs_per_cell+j] =
+                receive_buffer[pos+2+lexicographic[j]];
+          }
+      }
+
+    if (mpi_requests.size() > 0)
+      {
+        ierr = MPI_Waitall(mpi_requests.size(), mpi_requests.data(),
+                           MPI_STATUSES_IGNORE);
+        AssertThrowMPI(ierr);
+      }
+  }
+#endif
+
+
+
+  // Apply the 1D prolongation matrices of the child in all directions for
+  // each component. In the prolongate case, we go from dofs (living on the
+  // parent cell) to quads (living on the child) in the FEEvaluation
+  // terminology. The input is in the first third of @p data, the result is
+  // placed into the last third.
+  template <int dim, typename Eval, typename Number, bool prolongate>
+  void
+  perform_tensorized_op (const Eval         (&evaluators)[2],
+                         const unsigned int  child_index,
+                         const unsigned int  n_dofs,
+                         const unsigned int  n_components,
+                         Number             *data)
+  {
+    const Eval &eval_x = evaluators[child_index & 1];
+    const Eval &eval_y = evaluators[(child_index >> 1) & 1];
+    const Eval &eval_z = evaluators[(child_index >> 2) & 1];
+    Number *t0 = data;
+    Number *t1 = data + n_components*n_dofs;
+    Number *t2 = data + 2*n_components*n_dofs;
+
+    for (unsigned int c=0; c<n_components; ++c, t0 += n_dofs, t2 += n_dofs)
+      {
+        if (dim == 1)
+          eval_x.template values<0,prolongate,false>(t0, t2);
+        else if (dim == 2)
+          {
+            eval_x.template values<0,prolongate,false>(t0, t1);
+            eval_y.template values<1,prolongate,false>(t1, t2);
+          }
+        else if (dim == 3)
+          {
+            eval_x.template values<0,prolongate,false>(t0, t2);
+            eval_y.template values<1,prolongate,false>(t2, t1);
+            eval_z.template values<2,prolongate,false>(t1, t2);
+          }
+        else
+          Assert(false, ExcNotImplemented());
+      }
+  }
+}
+
+
+
+template <int dim, typename Number>
+MGTransferGlobalCoarsening<dim,Number>::MGTransferGlobalCoarsening ()
+  :
+  fe_degree(0),
+  n_components(0)
+{}
+
+
+
+template <int dim, typename Number>
+void MGTransferGlobalCoarsening<dim,Number>::clear ()
+{
+  dof_handlers.clear();
+  level_constraints.clear();
+  fe_degree = 0;
+  n_components = 0;
+  prolongation_matrix_1d[0].clear();
+  prolongation_matrix_1d[1].clear();
+  fine_dof_indices.clear();
+  coarse_dof_indices.clear();
+  child_indices.clear();
+  weights.clear();
+  ghosted_level_vector.resize(0, 0);
+  ghosted_coarse_vector.resize(0, 0);
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferGlobalCoarsening<dim,Number>::build
+(const std::vector<const DoFHandler<dim> *>   &dof_handlers_in,
+ const std::vector<const ConstraintMatrix *> &constraints_in)
+{
+  Assert(dof_handlers_in.size() > 0,
+         ExcMessage("At least one DoFHandler must be given"));
+  Assert(constraints_in.empty() || constraints_in.size() == dof_handlers_in.size(),
+         ExcDimensionMismatch(constraints_in.size(), dof_handlers_in.size()));
+
+  clear();
+  const unsigned int n_levels = dof_handlers_in.size();
+
+  dof_handlers.resize(n_levels);
+  level_constraints.resize(n_levels);
+  fine_dof_indices.resize(n_levels);
+  coarse_dof_indices.resize(n_levels);
+  child_indices.resize(n_levels);
+  weights.resize(n_levels);
+  ghosted_level_vector.resize(0, n_levels-1);
+  ghosted_coarse_vector.resize(0, n_levels-1);
+
+  // step 1: extract the 1D information about the finite element, which must
+  // be the same on all levels
+  const FiniteElement<dim> &fe = dof_handlers_in[0]->get_fe();
+  std::shared_ptr<FiniteElement<1> > fe_1d = get_fe_1d(fe);
+  fe_degree = fe_1d->degree;
+  n_components = fe.element_multiplicity(0);
+  const unsigned int n_dofs_1d = fe_1d->dofs_per_cell;
+  const std::vector<unsigned int> renumbering = get_lexicographic_numbering_1d(*fe_1d);
+  for (unsigned int c=0; c<GeometryInfo<1>::max_children_per_cell; ++c)
+    {
+      prolongation_matrix_1d[c].resize(n_dofs_1d*n_dofs_1d);
+      for (unsigned int i=0; i<n_dofs_1d; ++i)
+        for (unsigned int j=0; j<n_dofs_1d; ++j)
+          prolongation_matrix_1d[c][i*n_dofs_1d+j] =
+            fe_1d->get_prolongation_matrix(c)(renumbering[j],renumbering[i]);
+    }
+
+  const Quadrature<1> dummy_quadrature(std::vector<Point<1> >(1, Point<1>()));
+  internal::MatrixFreeFunctions::ShapeInfo<Number> shape_info;
+  shape_info.reinit(dummy_quadrature, fe, 0);
+  const std::vector<unsigned int> &lexicographic = shape_info.lexicographic_numbering;
+  const unsigned int dofs_per_cell = fe.dofs_per_cell;
+  AssertDimension(lexicographic.size(), dofs_per_cell);
+
+  // step 2: set up the vectors with the locally relevant dofs on each level
+  std::vector<MPI_Comm> communicators(n_levels);
+  for (unsigned int level=0; level<n_levels; ++level)
+    {
+      const DoFHandler<dim> &dof = *dof_handlers_in[level];
+      Assert(dof.get_fe().get_name() == fe.get_name(),
+             ExcMessage("The element must be the same on all levels"));
+      dof_handlers[level] = &dof;
+      if (!constraints_in.empty())
+        level_constraints[level] = constraints_in[level];
+
+      const parallel::Triangulation<dim,dim> *ptria =
+        (dynamic_cast<const parallel::Triangulation<dim,dim>*> (&dof.get_triangulation()));
+      communicators[level] =
+        ptria != nullptr ? ptria->get_communicator() : MPI_COMM_SELF;
+
+      IndexSet relevant_dofs;
+      DoFTools::extract_locally_relevant_dofs(dof, relevant_dofs);
+      ghosted_level_vector[level].reinit(dof.locally_owned_dofs(), relevant_dofs,
+                                         communicators[level]);
+    }
+
+  // step 3: find the coarse cell for each locally owned fine cell and
+  // extract the dof indices on both cells
+  std::vector<types::global_dof_index> dof_indices(dofs_per_cell);
+  std::vector<unsigned int> path;
+  for (unsigned int level=1; level<n_levels; ++level)
+    {
+      const DoFHandler<dim> &fine_dof = *dof_handlers[level];
+      const DoFHandler<dim> &coarse_dof = *dof_handlers[level-1];
+      const Utilities::MPI::Partitioner &fine_partitioner =
+        *ghosted_level_vector[level].get_partitioner();
+
+      std::vector<types::global_dof_index> coarse_indices;
+      std::vector<unsigned int> requests;
+      unsigned int n_cells = 0;
+      for (typename DoFHandler<dim>::active_cell_iterator cell=fine_dof.begin_active();
+           cell != fine_dof.end(); ++cell)
+        if (cell->is_locally_owned())
+          {
+            cell->get_dof_indices(dof_indices);
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              fine_dof_indices[level].push_back
+              (fine_partitioner.global_to_local(dof_indices[lexicographic[i]]));
+
+            path.clear();
+            append_cell_path<dim>(cell, path);
+            typename DoFHandler<dim>::cell_iterator coarse_cell;
+            unsigned int child_index;
+            const bool found = find_coarse_cell(coarse_dof, path.data(),
+                                                coarse_cell, child_index);
+            child_indices[level].push_back(child_index);
+            if (!found)
+              {
+                requests.push_back(n_cells);
+                requests.insert(requests.end(), path.begin(), path.end());
+                coarse_indices.resize(coarse_indices.size()+dofs_per_cell,
+                                      numbers::invalid_dof_index);
+              }
+            else
+              {
+                coarse_cell->get_dof_indices(dof_indices);
+                for (unsigned int i=0; i<dofs_per_cell; ++i)
+                  coarse_indices.push_back(dof_indices[lexicographic[i]]);
+              }
+            ++n_cells;
+          }
+
+      const MPI_Comm communicator = communicators[level-1];
+      if (Utilities::MPI::n_mpi_processes(communicator) > 1)
+        {
+#ifdef DEAL_II_WITH_MPI
+          import_remote_coarse_cells(coarse_dof, lexicographic, requests,
+                                     communicator, coarse_indices,
+                                     child_indices[level]);
+#endif
+        }
+      else
+        AssertDimension(requests.size(), 0);
+      AssertThrow(std::find(coarse_indices.begin(), coarse_indices.end(),
+                            numbers::invalid_dof_index) == coarse_indices.end(),
+                  ExcMessage("Could not find the coarse cell of some locally owned "
+                             "cell on the finer level"));
+
+      // set up the vector for the coarse level with all touched dofs as
+      // ghosts and translate the indices to the local numbering of that
+      // vector
+      std::vector<types::global_dof_index> touched_indices(coarse_indices);
+      std::sort(touched_indices.begin(), touched_indices.end());
+      touched_indices.erase(std::unique(touched_indices.begin(), touched_indices.end()),
+                            touched_indices.end());
+      IndexSet ghost_dofs(coarse_dof.n_dofs());
+      ghost_dofs.add_indices(touched_indices.begin(), touched_indices.end());
+      ghost_dofs.compress();
+      ghosted_coarse_vector[level].reinit(coarse_dof.locally_owned_dofs(), ghost_dofs,
+                                          communicator);
+      const Utilities::MPI::Partitioner &coarse_partitioner =
+        *ghosted_coarse_vector[level].get_partitioner();
+      coarse_dof_indices[level].resize(coarse_indices.size());
+      for (unsigned int i=0; i<coarse_indices.size(); ++i)
+        coarse_dof_indices[level][i] = coarse_partitioner.global_to_local(coarse_indices[i]);
+
+      // compute the weights of the fine degrees of freedom, given by the
+      // inverse of the number of cells sharing the degree of freedom
+      LinearAlgebra::distributed::Vector<Number> &touch_count =
+        ghosted_level_vector[level];
+      touch_count = 0.;
+      for (unsigned int i=0; i<fine_dof_indices[level].size(); ++i)
+        touch_count.local_element(fine_dof_indices[level][i]) += Number(1.);
+      touch_count.compress(VectorOperation::add);
+      touch_count.update_ghost_values();
+
+      const unsigned int n_local = touch_count.local_size() +
+                                   touch_count.get_partitioner()->n_ghost_indices();
+      weights[level].resize(n_local);
+      for (unsigned int i=0; i<n_local; ++i)
+        weights[level][i] = touch_count.local_element(i) > Number(0.) ?
+                            Number(1.)/touch_count.local_element(i) : Number(0.);
+      touch_count.zero_out_ghosts();
+    }
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferGlobalCoarsening<dim,Number>
+::prolongate (const unsigned int                                to_level,
+              LinearAlgebra::distributed::Vector<Number>       &dst,
+              const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  Assert ((to_level >= 1) && (to_level < n_levels()),
+          ExcIndexRange (to_level, 1, n_levels()));
+  AssertDimension(src.local_size(), ghosted_coarse_vector[to_level].local_size());
+  AssertDimension(dst.local_size(), ghosted_level_vector[to_level].local_size());
+
+  LinearAlgebra::distributed::Vector<Number> &ghosted_coarse =
+    ghosted_coarse_vector[to_level];
+  LinearAlgebra::distributed::Vector<Number> &ghosted_fine =
+    ghosted_level_vector[to_level];
+
+  ghosted_coarse.copy_locally_owned_data_from(src);
+  if (level_constraints[to_level-1] != nullptr)
+    level_constraints[to_level-1]->distribute(ghosted_coarse);
+  ghosted_coarse.update_ghost_values();
+  ghosted_fine = 0.;
+
+  const unsigned int n_dofs = Utilities::fixed_power<dim>(fe_degree+1);
+  const unsigned int dofs_per_cell = n_components*n_dofs;
+  const unsigned int n_cells = child_indices[to_level].size();
+
+  typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,-1,0,Number> Evaluator;
+  const Evaluator evaluators[2] =
+  {
+    Evaluator(prolongation_matrix_1d[0], prolongation_matrix_1d[0],
+              prolongation_matrix_1d[0], fe_degree, fe_degree+1),
+    Evaluator(prolongation_matrix_1d[1], prolongation_matrix_1d[1],
+              prolongation_matrix_1d[1], fe_degree, fe_degree+1)
+  };
+
+  AlignedVector<Number> evaluation_data(3*dofs_per_cell);
+  const Number *fine_weights = weights[to_level].begin();
+  for (unsigned int cell=0; cell<n_cells; ++cell)
+    {
+      const unsigned int *coarse_indices =
+        &coarse_dof_indices[to_level][cell*dofs_per_cell];
+      const unsigned int *fine_indices =
+        &fine_dof_indices[to_level][cell*dofs_per_cell];
+      const unsigned int child_index = child_indices[to_level][cell];
+
+      Number *result = &evaluation_data[0];
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        evaluation_data[i] = ghosted_coarse.local_element(coarse_indices[i]);
+      if (child_index != numbers::invalid_unsigned_int)
+        {
+          perform_tensorized_op<dim,Evaluator,Number,true>(evaluators, child_index,
+                                                           n_dofs, n_components,
+                                                           evaluation_data.begin());
+          result = &evaluation_data[2*dofs_per_cell];
+        }
+
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        ghosted_fine.local_element(fine_indices[i]) +=
+          fine_weights[fine_indices[i]] * result[i];
+    }
+
+  ghosted_coarse.zero_out_ghosts();
+  ghosted_fine.compress(VectorOperation::add);
+  if (level_constraints[to_level] != nullptr)
+    level_constraints[to_level]->set_zero(ghosted_fine);
+  dst.copy_locally_owned_data_from(ghosted_fine);
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferGlobalCoarsening<dim,Number>
+::restrict_and_add (const unsigned int                                from_level,
+                    LinearAlgebra::distributed::Vector<Number>       &dst,
+                    const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  Assert ((from_level >= 1) && (from_level < n_levels()),
+          ExcIndexRange (from_level, 1, n_levels()));
+  AssertDimension(src.local_size(), ghosted_level_vector[from_level].local_size());
+  AssertDimension(dst.local_size(), ghosted_coarse_vector[from_level].local_size());
+
+  LinearAlgebra::distributed::Vector<Number> &ghosted_coarse =
+    ghosted_coarse_vector[from_level];
+  LinearAlgebra::distributed::Vector<Number> &ghosted_fine =
+    ghosted_level_vector[from_level];
+
+  ghosted_fine.copy_locally_owned_data_from(src);
+  if (level_constraints[from_level] != nullptr)
+    level_constraints[from_level]->set_zero(ghosted_fine);
+  ghosted_fine.update_ghost_values();
+  ghosted_coarse = 0.;
+
+  const unsigned int n_dofs = Utilities::fixed_power<dim>(fe_degree+1);
+  const unsigned int dofs_per_cell = n_components*n_dofs;
+  const unsigned int n_cells = child_indices[from_level].size();
+
+  typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,-1,0,Number> Evaluator;
+  const Evaluator evaluators[2] =
+  {
+    Evaluator(prolongation_matrix_1d[0], prolongation_matrix_1d[0],
+              prolongation_matrix_1d[0], fe_degree, fe_degree+1),
+    Evaluator(prolongation_matrix_1d[1], prolongation_matrix_1d[1],
+              prolongation_matrix_1d[1], fe_degree, fe_degree+1)
+  };
+
+  AlignedVector<Number> evaluation_data(3*dofs_per_cell);
+  const Number *fine_weights = weights[from_level].begin();
+  for (unsigned int cell=0; cell<n_cells; ++cell)
+    {
+      const unsigned int *coarse_indices =
+        &coarse_dof_indices[from_level][cell*dofs_per_cell];
+      const unsigned int *fine_indices =
+        &fine_dof_indices[from_level][cell*dofs_per_cell];
+      const unsigned int child_index = child_indices[from_level][cell];
+
+      Number *result = &evaluation_data[0];
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        evaluation_data[i] = fine_weights[fine_indices[i]] *
+                             ghosted_fine.local_element(fine_indices[i]);
+      if (child_index != numbers::invalid_unsigned_int)
+        {
+          perform_tensorized_op<dim,Evaluator,Number,false>(evaluators, child_index,
+                                                            n_dofs, n_components,
+                                                            evaluation_data.begin());
+          result = &evaluation_data[2*dofs_per_cell];
+        }
+
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        ghosted_coarse.local_element(coarse_indices[i]) += result[i];
+    }
+
+  ghosted_fine.zero_out_ghosts();
+  ghosted_coarse.compress(VectorOperation::add);
+
+  // resolve the constraints on the coarse level, which is the transpose of
+  // ConstraintMatrix::distribute() in prolongate(). The constraints might
+  // point to dofs outside the ghost range of the transfer vector, so use
+  // the vector with the locally relevant dofs of the coarse level here.
+  if (level_constraints[from_level-1] != nullptr)
+    {
+      LinearAlgebra::distributed::Vector<Number> &coarse_relevant =
+        ghosted_level_vector[from_level-1];
+      coarse_relevant = 0.;
+      std::vector<types::global_dof_index> owned_indices(ghosted_coarse.local_size());
+      for (unsigned int i=0; i<owned_indices.size(); ++i)
+        owned_indices[i] = ghosted_coarse.get_partitioner()->local_range().first + i;
+      level_constraints[from_level-1]->distribute_local_to_global(ghosted_coarse.begin(),
+          ghosted_coarse.begin()+ghosted_coarse.local_size(),
+          owned_indices.begin(),
+          coarse_relevant);
+      coarse_relevant.compress(VectorOperation::add);
+      for (unsigned int i=0; i<dst.local_size(); ++i)
+        dst.local_element(i) += coarse_relevant.local_element(i);
+    }
+  else
+    for (unsigned int i=0; i<dst.local_size(); ++i)
+      dst.local_element(i) += ghosted_coarse.local_element(i);
+}
+
+
+
+template <int dim, typename Number>
+std::size_t
+MGTransferGlobalCoarsening<dim,Number>::memory_consumption() const
+{
+  std::size_t memory = prolongation_matrix_1d[0].memory_consumption();
+  memory += prolongation_matrix_1d[1].memory_consumption();
+  memory += MemoryConsumption::memory_consumption(fine_dof_indices);
+  memory += MemoryConsumption::memory_consumption(coarse_dof_indices);
+  memory += MemoryConsumption::memory_consumption(child_indices);
+  memory += MemoryConsumption::memory_consumption(weights);
+  memory += ghosted_level_vector.memory_consumption();
+  memory += ghosted_coarse_vector.memory_consumption();
+  return memory;
+}
+
+
+
+// explicit instantiations
+#include "mg_transfer_global_coarsening.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -16,6 +16,8 @@
 
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/function.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/vectorization.h>
 #include <deal.II/lac/la_parallel_vector.h>
 #include <deal.II/grid/tria.h>
@@ -34,6 +36,96 @@
 DEAL_II_NAMESPACE_OPEN
 
 
+namespace
+{
+  // Group the parent cells of a level into chunks of cell batches and color
+  // the chunks such that chunks of the same color neither write into the
+  // same entries of the fine level (prolongation) nor into the same entries
+  // of the coarse level (restriction). Returns the chunks as cell ranges for
+  // each color, or an empty vector if the coloring does not succeed
+  template <int dim>
+  std::vector<std::vector<std::pair<unsigned int,unsigned int> > >
+  color_parent_cell_batches (const std::vector<unsigned int>                          &fine_indices,
+                             const std::vector<unsigned int>                          &coarse_indices,
+                             const std::vector<std::pair<unsigned int,unsigned int> > &parent_child_connect,
+                             const unsigned int                                        n_owned_cells,
+                             const unsigned int                                        n_child_cell_dofs,
+                             const unsigned int                                        n_components,
+                             const unsigned int                                        fe_degree,
+                             const bool                                                element_is_continuous,
+                             const unsigned int                                        chunk_size)
+  {
+    typedef std::vector<std::vector<std::pair<unsigned int,unsigned int> > > Colors;
+    Colors colors;
+    const unsigned int degree_size = fe_degree + 1;
+    const unsigned int n_child_dofs_1d = 2*degree_size - element_is_continuous;
+    const unsigned int n_scalar_cell_dofs = Utilities::fixed_power<dim>(n_child_dofs_1d);
+
+    const unsigned int n_fine = fine_indices.empty() ? 0 :
+                                *std::max_element(fine_indices.begin(), fine_indices.end())+1;
+    const unsigned int n_coarse = coarse_indices.empty() ? 0 :
+                                  *std::max_element(coarse_indices.begin(), coarse_indices.end())+1;
+    std::vector<unsigned long long> fine_colors(n_fine, 0), coarse_colors(n_coarse, 0);
+    const unsigned int max_colors = 8*sizeof(unsigned long long);
+
+    for (unsigned int begin=0; begin<n_owned_cells; begin+=chunk_size)
+      {
+        const unsigned int end = std::min(begin+chunk_size, n_owned_cells);
+
+        // collect the colors of the chunks that share entries with this
+        // chunk
+        unsigned long long used_colors = 0;
+        for (unsigned int cell=begin; cell<end; ++cell)
+          {
+            for (unsigned int i=0; i<n_child_cell_dofs; ++i)
+              used_colors |= fine_colors[fine_indices[cell*n_child_cell_dofs+i]];
+            const unsigned int shift = internal::MGTransfer::compute_shift_within_children<dim>
+                                       (parent_child_connect[cell].second,
+                                        fe_degree+1-element_is_continuous, fe_degree);
+            const unsigned int *indices = &coarse_indices[parent_child_connect[cell].first*n_child_cell_dofs+shift];
+            for (unsigned int c=0; c<n_components; ++c)
+              for (unsigned int k=0; k<(dim>2 ? degree_size : 1); ++k)
+                for (unsigned int j=0; j<(dim>1 ? degree_size : 1); ++j)
+                  for (unsigned int i=0; i<degree_size; ++i)
+                    used_colors |= coarse_colors[indices[c*n_scalar_cell_dofs +
+                                                         k*n_child_dofs_1d*n_child_dofs_1d+
+                                                         j*n_child_dofs_1d+i]];
+          }
+
+        unsigned int color = 0;
+        while (color < max_colors && (used_colors & (1ULL << color)) != 0)
+          ++color;
+        if (color == max_colors)
+          return Colors();
+
+        const unsigned long long bit = 1ULL << color;
+        for (unsigned int cell=begin; cell<end; ++cell)
+          {
+            for (unsigned int i=0; i<n_child_cell_dofs; ++i)
+              fine_colors[fine_indices[cell*n_child_cell_dofs+i]] |= bit;
+            const unsigned int shift = internal::MGTransfer::compute_shift_within_children<dim>
+                                       (parent_child_connect[cell].second,
+                                        fe_degree+1-element_is_continuous, fe_degree);
+            const unsigned int *indices = &coarse_indices[parent_child_connect[cell].first*n_child_cell_dofs+shift];
+            for (unsigned int c=0; c<n_components; ++c)
+              for (unsigned int k=0; k<(dim>2 ? degree_size : 1); ++k)
+                for (unsigned int j=0; j<(dim>1 ? degree_size : 1); ++j)
+                  for (unsigned int i=0; i<degree_size; ++i)
+                    coarse_colors[indices[c*n_scalar_cell_dofs +
+                                          k*n_child_dofs_1d*n_child_dofs_1d+
+                                          j*n_child_dofs_1d+i]] |= bit;
+          }
+
+        if (color >= colors.size())
+          colors.resize(color+1);
+        colors[color].push_back(std::make_pair(begin, end));
+      }
+    return colors;
+  }
+}
+
+
+
 template <int dim, typename Number>
 MGTransferMatrixFree<dim,Number>::MGTransferMatrixFree ()
   :
@@ -82,6 +174,7 @@ void MGTransferMatrixFree<dim,Number>::clear ()
   prolongation_matrix_1d.clear();
   evaluation_data.clear();
   weights_on_refined.clear();
+  parent_cell_colors.clear();
 }
 
 
@@ -105,6 +198,7 @@ void MGTransferMatrixFree<dim,Number>::build
                                                    weights_unvectorized,
                                                    this->copy_indices_global_mine,
                                                    this->ghosted_level_vector);
+  this->setup_agglomeration(mg_dof);
   // unpack element info data
   fe_degree                = elem_info.fe_degree;
   element_is_continuous    = elem_info.element_is_continuous;
@@ -139,6 +233,20 @@ void MGTransferMatrixFree<dim,Number>::build
     }
 
   evaluation_data.resize(3*n_child_cell_dofs);
+
+  // color chunks of parent cells for running the transfer with threads
+  parent_cell_colors.clear();
+  parent_cell_colors.resize(n_levels-1);
+  if (MultithreadInfo::n_threads() > 1)
+    for (unsigned int level = 1; level<n_levels; ++level)
+      parent_cell_colors[level-1] =
+        color_parent_cell_batches<dim>(level_dof_indices[level],
+                                       level_dof_indices[level-1],
+                                       parent_child_connect[level-1],
+                                       n_owned_level_cells[level-1],
+                                       n_child_cell_dofs, n_components,
+                                       fe_degree, element_is_continuous,
+                                       16*vec_size);
 }
 
 
@@ -152,57 +260,92 @@ void MGTransferMatrixFree<dim,Number>
   Assert ((to_level >= 1) && (to_level<=level_dof_indices.size()),
           ExcIndexRange (to_level, 1, level_dof_indices.size()+1));
 
-  AssertDimension(this->ghosted_level_vector[to_level].local_size(),
-                  dst.local_size());
-  AssertDimension(this->ghosted_level_vector[to_level-1].local_size(),
-                  src.local_size());
-
-  this->ghosted_level_vector[to_level-1].copy_locally_owned_data_from(src);
-  this->ghosted_level_vector[to_level-1].update_ghost_values();
-  this->ghosted_level_vector[to_level] = 0.;
+  // the transfer works on the natural layout of the level vectors, so the
+  // data of agglomerated levels needs to be moved first. If the given
+  // vectors already have the ghost layout needed by the transfer, we work on
+  // them directly and avoid the copies into the internal vectors
+  const bool src_has_transfer_layout =
+    !this->level_is_agglomerated(to_level-1) &&
+    src.get_partitioner().get() ==
+    this->ghosted_level_vector[to_level-1].get_partitioner().get();
+  const bool dst_has_transfer_layout =
+    !this->level_is_agglomerated(to_level) &&
+    dst.get_partitioner().get() ==
+    this->ghosted_level_vector[to_level].get_partitioner().get();
+  const bool src_had_ghosts = src.has_ghost_elements();
+
+  if (src_has_transfer_layout == false)
+    {
+      if (this->level_is_agglomerated(to_level-1))
+        this->copy_from_agglomerated(to_level-1, this->ghosted_level_vector[to_level-1], src);
+      else
+        {
+          AssertDimension(this->ghosted_level_vector[to_level-1].local_size(),
+                          src.local_size());
+          this->ghosted_level_vector[to_level-1].copy_locally_owned_data_from(src);
+        }
+    }
+  const LinearAlgebra::distributed::Vector<Number> &src_ghosted =
+    src_has_transfer_layout ? src : this->ghosted_level_vector[to_level-1];
+  LinearAlgebra::distributed::Vector<Number> &dst_ghosted =
+    dst_has_transfer_layout ? dst : this->ghosted_level_vector[to_level];
+  src_ghosted.update_ghost_values();
+  dst_ghosted = 0.;
 
   // the implementation in do_prolongate_add is templated in the degree of the
   // element (for efficiency reasons), so we need to find the appropriate
   // kernel here...
   if (fe_degree == 0)
-    do_prolongate_add<0>(to_level, this->ghosted_level_vector[to_level],
-                         this->ghosted_level_vector[to_level-1]);
+    do_prolongate_add<0>(to_level, dst_ghosted,
+                         src_ghosted);
   else if (fe_degree == 1)
-    do_prolongate_add<1>(to_level, this->ghosted_level_vector[to_level],
-                         this->ghosted_level_vector[to_level-1]);
+    do_prolongate_add<1>(to_level, dst_ghosted,
+                         src_ghosted);
   else if (fe_degree == 2)
-    do_prolongate_add<2>(to_level, this->ghosted_level_vector[to_level],
-                         this->ghosted_level_vector[to_level-1]);
+    do_prolongate_add<2>(to_level, dst_ghosted,
+                         src_ghosted);
   else if (fe_degree == 3)
-    do_prolongate_add<3>(to_level, this->ghosted_level_vector[to_level],
-                         this->ghosted_level_vector[to_level-1]);
+    do_prolongate_add<3>(to_level, dst_ghosted,
+                         src_ghosted);
   else if (fe_degree == 4)
-    do_prolongate_add<4>(to_level, this->ghosted_level_vector[to_level],
-                         this->ghosted_level_vector[to_level-1]);
+    do_prolongate_add<4>(to_level, dst_ghosted,
+                         src_ghosted);
   else if (fe_degree == 5)
-    do_prolongate_add<5>(to_level, this->ghosted_level_vector[to_level],
-                         this->ghosted_level_vector[to_level-1]);
+    do_prolongate_add<5>(to_level, dst_ghosted,
+                         src_ghosted);
   else if (fe_degree == 6)
-    do_prolongate_add<6>(to_level, this->ghosted_level_vector[to_level],
-                         this->ghosted_level_vector[to_level-1]);
+    do_prolongate_add<6>(to_level, dst_ghosted,
+                         src_ghosted);
   else if (fe_degree == 7)
-    do_prolongate_add<7>(to_level, this->ghosted_level_vector[to_level],
-                         this->ghosted_level_vector[to_level-1]);
+    do_prolongate_add<7>(to_level, dst_ghosted,
+                         src_ghosted);
   else if (fe_degree == 8)
-    do_prolongate_add<8>(to_level, this->ghosted_level_vector[to_level],
-                         this->ghosted_level_vector[to_level-1]);
+    do_prolongate_add<8>(to_level, dst_ghosted,
+                         src_ghosted);
   else if (fe_degree == 9)
-    do_prolongate_add<9>(to_level, this->ghosted_level_vector[to_level],
-                         this->ghosted_level_vector[to_level-1]);
+    do_prolongate_add<9>(to_level, dst_ghosted,
+                         src_ghosted);
   else if (fe_degree == 10)
-    do_prolongate_add<10>(to_level, this->ghosted_level_vector[to_level],
-                          this->ghosted_level_vector[to_level-1]);
+    do_prolongate_add<10>(to_level, dst_ghosted,
+                          src_ghosted);
   else
-    do_prolongate_add<-1>(to_level, this->ghosted_level_vector[to_level],
-                          this->ghosted_level_vector[to_level-1]);
+    do_prolongate_add<-1>(to_level, dst_ghosted,
+                          src_ghosted);
+
+  dst_ghosted.compress(VectorOperation::add);
+  if (src_has_transfer_layout && !src_had_ghosts)
+    const_cast<LinearAlgebra::distributed::Vector<Number> &>(src).zero_out_ghosts();
 
-  this->ghosted_level_vector[to_level].compress(VectorOperation::add);
-  dst.copy_locally_owned_data_from(this->ghosted_level_vector[to_level]);
+  if (dst_has_transfer_layout)
+    return;
+  if (this->level_is_agglomerated(to_level))
+    this->copy_to_agglomerated(to_level, dst, this->ghosted_level_vector[to_level], false);
+  else
+    {
+      AssertDimension(this->ghosted_level_vector[to_level].local_size(),
+                      dst.local_size());
+      dst.copy_locally_owned_data_from(this->ghosted_level_vector[to_level]);
+    }
 }
 
 
@@ -216,55 +359,93 @@ void MGTransferMatrixFree<dim,Number>
   Assert ((from_level >= 1) && (from_level<=level_dof_indices.size()),
           ExcIndexRange (from_level, 1, level_dof_indices.size()+1));
 
-  AssertDimension(this->ghosted_level_vector[from_level].local_size(),
-                  src.local_size());
-  AssertDimension(this->ghosted_level_vector[from_level-1].local_size(),
-                  dst.local_size());
-
-  this->ghosted_level_vector[from_level].copy_locally_owned_data_from(src);
-  this->ghosted_level_vector[from_level].update_ghost_values();
-  this->ghosted_level_vector[from_level-1] = 0.;
+  // as in prolongate(), work directly on the given vectors if they have the
+  // ghost layout of the transfer. The destination vector then accumulates
+  // the contributions of the transfer into its ghost range, which therefore
+  // is reset to zero first
+  const bool src_has_transfer_layout =
+    !this->level_is_agglomerated(from_level) &&
+    src.get_partitioner().get() ==
+    this->ghosted_level_vector[from_level].get_partitioner().get();
+  const bool dst_has_transfer_layout =
+    !this->level_is_agglomerated(from_level-1) &&
+    dst.get_partitioner().get() ==
+    this->ghosted_level_vector[from_level-1].get_partitioner().get();
+  const bool src_had_ghosts = src.has_ghost_elements();
+
+  if (src_has_transfer_layout == false)
+    {
+      if (this->level_is_agglomerated(from_level))
+        this->copy_from_agglomerated(from_level, this->ghosted_level_vector[from_level], src);
+      else
+        {
+          AssertDimension(this->ghosted_level_vector[from_level].local_size(),
+                          src.local_size());
+          this->ghosted_level_vector[from_level].copy_locally_owned_data_from(src);
+        }
+    }
+  const LinearAlgebra::distributed::Vector<Number> &src_ghosted =
+    src_has_transfer_layout ? src : this->ghosted_level_vector[from_level];
+  LinearAlgebra::distributed::Vector<Number> &dst_ghosted =
+    dst_has_transfer_layout ? dst : this->ghosted_level_vector[from_level-1];
+  src_ghosted.update_ghost_values();
+  if (dst_has_transfer_layout)
+    dst.zero_out_ghosts();
+  else
+    dst_ghosted = 0.;
 
   if (fe_degree == 0)
-    do_restrict_add<0>(from_level, this->ghosted_level_vector[from_level-1],
-                       this->ghosted_level_vector[from_level]);
+    do_restrict_add<0>(from_level, dst_ghosted,
+                       src_ghosted);
   else if (fe_degree == 1)
-    do_restrict_add<1>(from_level, this->ghosted_level_vector[from_level-1],
-                       this->ghosted_level_vector[from_level]);
+    do_restrict_add<1>(from_level, dst_ghosted,
+                       src_ghosted);
   else if (fe_degree == 2)
-    do_restrict_add<2>(from_level, this->ghosted_level_vector[from_level-1],
-                       this->ghosted_level_vector[from_level]);
+    do_restrict_add<2>(from_level, dst_ghosted,
+                       src_ghosted);
   else if (fe_degree == 3)
-    do_restrict_add<3>(from_level, this->ghosted_level_vector[from_level-1],
-                       this->ghosted_level_vector[from_level]);
+    do_restrict_add<3>(from_level, dst_ghosted,
+                       src_ghosted);
   else if (fe_degree == 4)
-    do_restrict_add<4>(from_level, this->ghosted_level_vector[from_level-1],
-                       this->ghosted_level_vector[from_level]);
+    do_restrict_add<4>(from_level, dst_ghosted,
+                       src_ghosted);
   else if (fe_degree == 5)
-    do_restrict_add<5>(from_level, this->ghosted_level_vector[from_level-1],
-                       this->ghosted_level_vector[from_level]);
+    do_restrict_add<5>(from_level, dst_ghosted,
+                       src_ghosted);
   else if (fe_degree == 6)
-    do_restrict_add<6>(from_level, this->ghosted_level_vector[from_level-1],
-                       this->ghosted_level_vector[from_level]);
+    do_restrict_add<6>(from_level, dst_ghosted,
+                       src_ghosted);
   else if (fe_degree == 7)
-    do_restrict_add<7>(from_level, this->ghosted_level_vector[from_level-1],
-                       this->ghosted_level_vector[from_level]);
+    do_restrict_add<7>(from_level, dst_ghosted,
+                       src_ghosted);
   else if (fe_degree == 8)
-    do_restrict_add<8>(from_level, this->ghosted_level_vector[from_level-1],
-                       this->ghosted_level_vector[from_level]);
+    do_restrict_add<8>(from_level, dst_ghosted,
+                       src_ghosted);
   else if (fe_degree == 9)
-    do_restrict_add<9>(from_level, this->ghosted_level_vector[from_level-1],
-                       this->ghosted_level_vector[from_level]);
+    do_restrict_add<9>(from_level, dst_ghosted,
+                       src_ghosted);
   else if (fe_degree == 10)
-    do_restrict_add<10>(from_level, this->ghosted_level_vector[from_level-1],
-                        this->ghosted_level_vector[from_level]);
+    do_restrict_add<10>(from_level, dst_ghosted,
+                        src_ghosted);
   else
     // go to the non-templated version of the evaluator
-    do_restrict_add<-1>(from_level, this->ghosted_level_vector[from_level-1],
-                        this->ghosted_level_vector[from_level]);
+    do_restrict_add<-1>(from_level, dst_ghosted,
+                        src_ghosted);
 
-  this->ghosted_level_vector[from_level-1].compress(VectorOperation::add);
-  dst += this->ghosted_level_vector[from_level-1];
+  dst_ghosted.compress(VectorOperation::add);
+  if (src_has_transfer_layout && !src_had_ghosts)
+    const_cast<LinearAlgebra::distributed::Vector<Number> &>(src).zero_out_ghosts();
+
+  if (dst_has_transfer_layout)
+    return;
+  if (this->level_is_agglomerated(from_level-1))
+    this->copy_to_agglomerated(from_level-1, dst, this->ghosted_level_vector[from_level-1], true);
+  else
+    {
+      AssertDimension(this->ghosted_level_vector[from_level-1].local_size(),
+                      dst.local_size());
+      dst += this->ghosted_level_vector[from_level-1];
+    }
 }
 
 
@@ -316,6 +497,37 @@ namespace
       }
   }
 
+  // Run the given worker on the batches of parent cells of a level. With
+  // threads and a valid coloring, the chunks within a color are distributed
+  // among the threads, each with its own scratch data, while the colors are
+  // worked on one after the other
+  template <typename Number, typename Worker>
+  void
+  loop_over_parent_cell_batches (const std::vector<std::vector<std::pair<unsigned int,unsigned int> > > &colors,
+                                 const unsigned int                       n_owned_cells,
+                                 AlignedVector<VectorizedArray<Number> > &evaluation_data,
+                                 const Worker                            &worker)
+  {
+    if (colors.empty() || MultithreadInfo::n_threads() == 1)
+      {
+        worker(std::make_pair(0U, n_owned_cells), evaluation_data);
+        return;
+      }
+
+    const unsigned int scratch_size = evaluation_data.size();
+    for (unsigned int color=0; color<colors.size(); ++color)
+      parallel::apply_to_subranges
+      (0U, static_cast<unsigned int>(colors[color].size()),
+       [&](const unsigned int begin, const unsigned int end)
+    {
+      AlignedVector<VectorizedArray<Number> > scratch(scratch_size);
+      for (unsigned int i=begin; i<end; ++i)
+        worker(colors[color][i], scratch);
+    }, 1);
+  }
+
+
+
   template <int dim, int degree, typename Number>
   void weight_dofs_on_child (const VectorizedArray<Number> *weights,
                              const unsigned int n_components,
@@ -361,78 +573,86 @@ void MGTransferMatrixFree<dim,Number>
   const unsigned int n_scalar_cell_dofs = Utilities::fixed_power<dim>(n_child_dofs_1d);
   const unsigned int three_to_dim = Utilities::fixed_int_power<3,dim>::value;
 
-  for (unsigned int cell=0; cell < n_owned_level_cells[to_level-1];
-       cell += vec_size)
-    {
-      const unsigned int n_chunks = cell+vec_size > n_owned_level_cells[to_level-1] ?
-                                    n_owned_level_cells[to_level-1] - cell : vec_size;
+  const auto kernel = [&](const std::pair<unsigned int,unsigned int> &cell_range,
+                          AlignedVector<VectorizedArray<Number> > &evaluation_data)
+  {
+    for (unsigned int cell=cell_range.first; cell < cell_range.second;
+         cell += vec_size)
+      {
+        const unsigned int n_chunks = cell+vec_size > cell_range.second ?
+                                      cell_range.second - cell : vec_size;
 
-      // read from source vector
-      for (unsigned int v=0; v<n_chunks; ++v)
-        {
-          const unsigned int shift = internal::MGTransfer::compute_shift_within_children<dim>
-                                     (parent_child_connect[to_level-1][cell+v].second,
-                                      fe_degree+1-element_is_continuous, fe_degree);
-          const unsigned int *indices = &level_dof_indices[to_level-1][parent_child_connect[to_level-1][cell+v].first*n_child_cell_dofs+shift];
-          for (unsigned int c=0, m=0; c<n_components; ++c)
-            {
-              for (unsigned int k=0; k<(dim>2 ? degree_size : 1); ++k)
-                for (unsigned int j=0; j<(dim>1 ? degree_size : 1); ++j)
-                  for (unsigned int i=0; i<degree_size; ++i, ++m)
-                    evaluation_data[m][v] =
-                      src.local_element(indices[c*n_scalar_cell_dofs +
-                                                k*n_child_dofs_1d*n_child_dofs_1d+
-                                                j*n_child_dofs_1d+i]);
+        // read from source vector
+        for (unsigned int v=0; v<n_chunks; ++v)
+          {
+            const unsigned int shift = internal::MGTransfer::compute_shift_within_children<dim>
+                                       (parent_child_connect[to_level-1][cell+v].second,
+                                        fe_degree+1-element_is_continuous, fe_degree);
+            const unsigned int *indices = &level_dof_indices[to_level-1][parent_child_connect[to_level-1][cell+v].first*n_child_cell_dofs+shift];
+            for (unsigned int c=0, m=0; c<n_components; ++c)
+              {
+                for (unsigned int k=0; k<(dim>2 ? degree_size : 1); ++k)
+                  for (unsigned int j=0; j<(dim>1 ? degree_size : 1); ++j)
+                    for (unsigned int i=0; i<degree_size; ++i, ++m)
+                      evaluation_data[m][v] =
+                        src.local_element(indices[c*n_scalar_cell_dofs +
+                                                  k*n_child_dofs_1d*n_child_dofs_1d+
+                                                  j*n_child_dofs_1d+i]);
+
+                // apply Dirichlet boundary conditions on parent cell
+                for (std::vector<unsigned short>::const_iterator i=dirichlet_indices[to_level-1][cell+v].begin(); i!=dirichlet_indices[to_level-1][cell+v].end(); ++i)
+                  evaluation_data[*i][v] = 0.;
+              }
+          }
 
-              // apply Dirichlet boundary conditions on parent cell
-              for (std::vector<unsigned short>::const_iterator i=dirichlet_indices[to_level-1][cell+v].begin(); i!=dirichlet_indices[to_level-1][cell+v].end(); ++i)
-                evaluation_data[*i][v] = 0.;
-            }
-        }
+        AssertDimension(prolongation_matrix_1d.size(),
+                        degree_size * n_child_dofs_1d);
+        // perform tensorized operation
+        if (element_is_continuous)
+          {
+            typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,degree,degree!=-1 ? 2*degree+1 : 0,VectorizedArray<Number> > Evaluator;
+            Evaluator evaluator(prolongation_matrix_1d,
+                                prolongation_matrix_1d,
+                                prolongation_matrix_1d,
+                                fe_degree,
+                                2*fe_degree+1);
+            perform_tensorized_op<dim,Evaluator,Number,true>(evaluator,
+                                                             n_child_cell_dofs,
+                                                             n_components,
+                                                             evaluation_data);
+            weight_dofs_on_child<dim,degree,Number>(&weights_on_refined[to_level-1][(cell/vec_size)*three_to_dim],
+                                                    n_components, fe_degree,
+                                                    &evaluation_data[2*n_child_cell_dofs]);
+          }
+        else
+          {
+            typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,degree,2*(degree+1),VectorizedArray<Number> > Evaluator;
+            Evaluator evaluator(prolongation_matrix_1d,
+                                prolongation_matrix_1d,
+                                prolongation_matrix_1d,
+                                fe_degree,
+                                2*(fe_degree+1));
+            perform_tensorized_op<dim,Evaluator,Number,true>(evaluator,
+                                                             n_child_cell_dofs,
+                                                             n_components,
+                                                             evaluation_data);
+          }
 
-      AssertDimension(prolongation_matrix_1d.size(),
-                      degree_size * n_child_dofs_1d);
-      // perform tensorized operation
-      if (element_is_continuous)
-        {
-          typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,degree,degree!=-1 ? 2*degree+1 : 0,VectorizedArray<Number> > Evaluator;
-          Evaluator evaluator(prolongation_matrix_1d,
-                              prolongation_matrix_1d,
-                              prolongation_matrix_1d,
-                              fe_degree,
-                              2*fe_degree+1);
-          perform_tensorized_op<dim,Evaluator,Number,true>(evaluator,
-                                                           n_child_cell_dofs,
-                                                           n_components,
-                                                           evaluation_data);
-          weight_dofs_on_child<dim,degree,Number>(&weights_on_refined[to_level-1][(cell/vec_size)*three_to_dim],
-                                                  n_components, fe_degree,
-                                                  &evaluation_data[2*n_child_cell_dofs]);
-        }
-      else
-        {
-          typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,degree,2*(degree+1),VectorizedArray<Number> > Evaluator;
-          Evaluator evaluator(prolongation_matrix_1d,
-                              prolongation_matrix_1d,
-                              prolongation_matrix_1d,
-                              fe_degree,
-                              2*(fe_degree+1));
-          perform_tensorized_op<dim,Evaluator,Number,true>(evaluator,
-                                                           n_child_cell_dofs,
-                                                           n_components,
-                                                           evaluation_data);
-        }
+        // write into dst vector
+        const unsigned int *indices = &level_dof_indices[to_level][cell*
+                                                                   n_child_cell_dofs];
+        for (unsigned int v=0; v<n_chunks; ++v)
+          {
+            for (unsigned int i=0; i<n_child_cell_dofs; ++i)
+              dst.local_element(indices[i]) += evaluation_data[2*n_child_cell_dofs+i][v];
+            indices += n_child_cell_dofs;
+          }
+      }
+  };
 
-      // write into dst vector
-      const unsigned int *indices = &level_dof_indices[to_level][cell*
-                                                                 n_child_cell_dofs];
-      for (unsigned int v=0; v<n_chunks; ++v)
-        {
-          for (unsigned int i=0; i<n_child_cell_dofs; ++i)
-            dst.local_element(indices[i]) += evaluation_data[2*n_child_cell_dofs+i][v];
-          indices += n_child_cell_dofs;
-        }
-    }
+  loop_over_parent_cell_batches(parent_cell_colors[to_level-1],
+                                n_owned_level_cells[to_level-1],
+                                evaluation_data, kernel);
 }
 
 
@@ -450,83 +670,91 @@ void MGTransferMatrixFree<dim,Number>
   const unsigned int n_scalar_cell_dofs = Utilities::fixed_power<dim>(n_child_dofs_1d);
   const unsigned int three_to_dim = Utilities::fixed_int_power<3,dim>::value;
 
-  for (unsigned int cell=0; cell < n_owned_level_cells[from_level-1];
-       cell += vec_size)
-    {
-      const unsigned int n_chunks = cell+vec_size > n_owned_level_cells[from_level-1] ?
-                                    n_owned_level_cells[from_level-1] - cell : vec_size;
-
-      // read from source vector
+  const auto kernel = [&](const std::pair<unsigned int,unsigned int> &cell_range,
+                          AlignedVector<VectorizedArray<Number> > &evaluation_data)
+  {
+    for (unsigned int cell=cell_range.first; cell < cell_range.second;
+         cell += vec_size)
       {
-        const unsigned int *indices = &level_dof_indices[from_level][cell*
-                                      n_child_cell_dofs];
-        for (unsigned int v=0; v<n_chunks; ++v)
-          {
-            for (unsigned int i=0; i<n_child_cell_dofs; ++i)
-              evaluation_data[i][v] = src.local_element(indices[i]);
-            indices += n_child_cell_dofs;
-          }
-      }
+        const unsigned int n_chunks = cell+vec_size > cell_range.second ?
+                                      cell_range.second - cell : vec_size;
 
-      AssertDimension(prolongation_matrix_1d.size(),
-                      degree_size * n_child_dofs_1d);
-      // perform tensorized operation
-      if (element_is_continuous)
+        // read from source vector
         {
-          typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,degree,degree!=-1 ? 2*degree+1 : 0,VectorizedArray<Number> > Evaluator;
-          Evaluator evaluator(prolongation_matrix_1d,
-                              prolongation_matrix_1d,
-                              prolongation_matrix_1d,
-                              fe_degree,
-                              2*fe_degree+1);
-          weight_dofs_on_child<dim,degree,Number>(&weights_on_refined[from_level-1][(cell/vec_size)*three_to_dim],
-                                                  n_components, fe_degree,
-                                                  &evaluation_data[0]);
-          perform_tensorized_op<dim,Evaluator,Number,false>(evaluator,
-                                                            n_child_cell_dofs,
-                                                            n_components,
-                                                            evaluation_data);
-        }
-      else
-        {
-          typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,degree,2*(degree+1),VectorizedArray<Number> > Evaluator;
-          Evaluator evaluator(prolongation_matrix_1d,
-                              prolongation_matrix_1d,
-                              prolongation_matrix_1d,
-                              fe_degree,
-                              2*(fe_degree+1));
-          perform_tensorized_op<dim,Evaluator,Number,false>(evaluator,
-                                                            n_child_cell_dofs,
-                                                            n_components,
-                                                            evaluation_data);
-        }
-
-      // write into dst vector
-      for (unsigned int v=0; v<n_chunks; ++v)
-        {
-          const unsigned int shift = internal::MGTransfer::compute_shift_within_children<dim>
-                                     (parent_child_connect[from_level-1][cell+v].second,
-                                      fe_degree+1-element_is_continuous, fe_degree);
-          AssertIndexRange(parent_child_connect[from_level-1][cell+v].first*
-                           n_child_cell_dofs+n_child_cell_dofs-1,
-                           level_dof_indices[from_level-1].size());
-          const unsigned int *indices = &level_dof_indices[from_level-1][parent_child_connect[from_level-1][cell+v].first*n_child_cell_dofs+shift];
-          for (unsigned int c=0, m=0; c<n_components; ++c)
+          const unsigned int *indices = &level_dof_indices[from_level][cell*
+                                        n_child_cell_dofs];
+          for (unsigned int v=0; v<n_chunks; ++v)
             {
-              // apply Dirichlet boundary conditions on parent cell
-              for (std::vector<unsigned short>::const_iterator i=dirichlet_indices[from_level-1][cell+v].begin(); i!=dirichlet_indices[from_level-1][cell+v].end(); ++i)
-                evaluation_data[2*n_child_cell_dofs+(*i)][v] = 0.;
-
-              for (unsigned int k=0; k<(dim>2 ? degree_size : 1); ++k)
-                for (unsigned int j=0; j<(dim>1 ? degree_size : 1); ++j)
-                  for (unsigned int i=0; i<degree_size; ++i, ++m)
-                    dst.local_element(indices[c*n_scalar_cell_dofs +
-                                              k*n_child_dofs_1d*n_child_dofs_1d+
-                                              j*n_child_dofs_1d+i])
-                    += evaluation_data[2*n_child_cell_dofs+m][v];
+              for (unsigned int i=0; i<n_child_cell_dofs; ++i)
+                evaluation_data[i][v] = src.local_element(indices[i]);
+              indices += n_child_cell_dofs;
             }
         }
-    }
+
+        AssertDimension(prolongation_matrix_1d.size(),
+                        degree_size * n_child_dofs_1d);
+        // perform tensorized operation
+        if (element_is_continuous)
+          {
+            typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,degree,degree!=-1 ? 2*degree+1 : 0,VectorizedArray<Number> > Evaluator;
+            Evaluator evaluator(prolongation_matrix_1d,
+                                prolongation_matrix_1d,
+                                prolongation_matrix_1d,
+                                fe_degree,
+                                2*fe_degree+1);
+            weight_dofs_on_child<dim,degree,Number>(&weights_on_refined[from_level-1][(cell/vec_size)*three_to_dim],
+                                                    n_components, fe_degree,
+                                                    &evaluation_data[0]);
+            perform_tensorized_op<dim,Evaluator,Number,false>(evaluator,
+                                                              n_child_cell_dofs,
+                                                              n_components,
+                                                              evaluation_data);
+          }
+        else
+          {
+            typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,degree,2*(degree+1),VectorizedArray<Number> > Evaluator;
+            Evaluator evaluator(prolongation_matrix_1d,
+                                prolongation_matrix_1d,
+                                prolongation_matrix_1d,
+                                fe_degree,
+                                2*(fe_degree+1));
+            perform_tensorized_op<dim,Evaluator,Number,false>(evaluator,
+                                                              n_child_cell_dofs,
+                                                              n_components,
+                                                              evaluation_data);
+          }
+
+        // write into dst vector
+        for (unsigned int v=0; v<n_chunks; ++v)
+          {
+            const unsigned int shift = internal::MGTransfer::compute_shift_within_children<dim>
+                                       (parent_child_connect[from_level-1][cell+v].second,
+                                        fe_degree+1-element_is_continuous, fe_degree);
+            AssertIndexRange(parent_child_connect[from_level-1][cell+v].first*
+                             n_child_cell_dofs+n_child_cell_dofs-1,
+                             level_dof_indices[from_level-1].size());
+            const unsigned int *indices = &level_dof_indices[from_level-1][parent_child_connect[from_level-1][cell+v].first*n_child_cell_dofs+shift];
+            for (unsigned int c=0, m=0; c<n_components; ++c)
+              {
+                // apply Dirichlet boundary conditions on parent cell
+                for (std::vector<unsigned short>::const_iterator i=dirichlet_indices[from_level-1][cell+v].begin(); i!=dirichlet_indices[from_level-1][cell+v].end(); ++i)
+                  evaluation_data[2*n_child_cell_dofs+(*i)][v] = 0.;
+
+                for (unsigned int k=0; k<(dim>2 ? degree_size : 1); ++k)
+                  for (unsigned int j=0; j<(dim>1 ? degree_size : 1); ++j)
+                    for (unsigned int i=0; i<degree_size; ++i, ++m)
+                      dst.local_element(indices[c*n_scalar_cell_dofs +
+                                                k*n_child_dofs_1d*n_child_dofs_1d+
+                                                j*n_child_dofs_1d+i])
+                      += evaluation_data[2*n_child_cell_dofs+m][v];
+              }
+          }
+      }
+  };
+
+  loop_over_parent_cell_batches(parent_cell_colors[from_level-1],
+                                n_owned_level_cells[from_level-1],
+                                evaluation_data, kernel);
 }
 
 
@@ -543,6 +771,7 @@ MGTransferMatrixFree<dim,Number>::memory_consumption() const
   memory += MemoryConsumption::memory_consumption(evaluation_data);
   memory += MemoryConsumption::memory_consumption(weights_on_refined);
   memory += MemoryConsumption::memory_consumption(dirichlet_indices);
+  memory += MemoryConsumption::memory_consumption(parent_cell_colors);
   return memory;
 }
 
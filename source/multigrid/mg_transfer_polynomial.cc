@@ -0,0 +1,450 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_tools.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/shape_info.h>
+#include <deal.II/matrix_free/tensor_product_kernels.h>
+#include <deal.II/multigrid/mg_transfer_polynomial.h>
+
+#include <algorithm>
+#include <memory>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  // Create a 1D copy of the base element of @p fe by substituting the
+  // template argument in the name, as done in MGTransferMatrixFree
+  template <int dim>
+  std::shared_ptr<FiniteElement<1> >
+  get_fe_1d (const FiniteElement<dim> &fe)
+  {
+    AssertDimension(fe.n_base_elements(), 1);
+    std::string fe_name = fe.base_element(0).get_name();
+    const std::size_t template_starts = fe_name.find_first_of('<');
+    Assert (fe_name[template_starts+1] == (dim==1?'1':(dim==2?'2':'3')),
+            ExcInternalError());
+    fe_name[template_starts+1] = '1';
+    std::shared_ptr<FiniteElement<1> > fe_1d(FETools::get_fe_by_name<1,1>(fe_name));
+    AssertDimension(Utilities::fixed_power<dim>(fe_1d->dofs_per_cell)
+                    *fe.element_multiplicity(0), fe.dofs_per_cell);
+    return fe_1d;
+  }
+
+
+
+  // Get the renumbering of the 1D basis functions from the hierarchical
+  // numbering of FE_Q (vertices first) to lexicographic numbering. For
+  // FE_DGQ, this is the identity.
+  std::vector<unsigned int>
+  get_lexicographic_numbering_1d (const FiniteElement<1> &fe)
+  {
+    AssertIndexRange(fe.dofs_per_vertex, 2);
+    std::vector<unsigned int> renumbering(fe.dofs_per_cell);
+    renumbering[0] = 0;
+    for (unsigned int i=0; i<fe.dofs_per_line; ++i)
+      renumbering[i+fe.dofs_per_vertex] =
+        GeometryInfo<1>::vertices_per_cell*fe.dofs_per_vertex + i;
+    if (fe.dofs_per_vertex > 0)
+      renumbering[fe.dofs_per_cell-fe.dofs_per_vertex] = fe.dofs_per_vertex;
+    return renumbering;
+  }
+
+
+
+  // Apply the 1D kernels of the evaluator in all directions for each
+  // component. In the prolongate case, we go from dofs (coarse degree) to
+  // quads (fine degree) in the FEEvaluation terminology. The input is in the
+  // first third of @p data, the result is placed into the last third.
+  template <int dim, typename Eval, typename Number, bool prolongate>
+  void
+  perform_tensorized_op (const Eval         &evaluator,
+                         const unsigned int  n_coarse_dofs,
+                         const unsigned int  n_fine_dofs,
+                         const unsigned int  n_components,
+                         const unsigned int  stride,
+                         Number             *data)
+  {
+    Number *t0 = data;
+    Number *t1 = data + stride;
+    Number *t2 = data + 2*stride;
+
+    for (unsigned int c=0; c<n_components; ++c)
+      {
+        if (dim == 1)
+          evaluator.template values<0,prolongate,false>(t0, t2);
+        else if (dim == 2)
+          {
+            evaluator.template values<0,prolongate,false>(t0, t1);
+            evaluator.template values<1,prolongate,false>(t1, t2);
+          }
+        else if (dim == 3)
+          {
+            evaluator.template values<0,prolongate,false>(t0, t2);
+            evaluator.template values<1,prolongate,false>(t2, t1);
+            evaluator.template values<2,prolongate,false>(t1, t2);
+          }
+        else
+          Assert(false, ExcNotImplemented());
+        if (prolongate)
+          {
+            t0 += n_coarse_dofs;
+            t2 += n_fine_dofs;
+          }
+        else
+          {
+            t0 += n_fine_dofs;
+            t2 += n_coarse_dofs;
+          }
+      }
+  }
+}
+
+
+
+template <int dim, typename Number>
+MGTransferPolynomialMatrixFree<dim,Number>::MGTransferPolynomialMatrixFree ()
+  :
+  n_components(0)
+{}
+
+
+
+template <int dim, typename Number>
+void MGTransferPolynomialMatrixFree<dim,Number>::clear ()
+{
+  dof_handlers.clear();
+  level_constraints.clear();
+  fe_degrees.clear();
+  n_components = 0;
+  prolongation_matrices_1d.clear();
+  level_dof_indices.clear();
+  global_level_dof_indices.clear();
+  weights.clear();
+  ghosted_level_vector.resize(0, 0);
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferPolynomialMatrixFree<dim,Number>::build
+(const std::vector<const DoFHandler<dim> *>   &dof_handlers_in,
+ const std::vector<const ConstraintMatrix *> &constraints_in)
+{
+  Assert(dof_handlers_in.size() > 0,
+         ExcMessage("At least one DoFHandler must be given"));
+  Assert(constraints_in.empty() || constraints_in.size() == dof_handlers_in.size(),
+         ExcDimensionMismatch(constraints_in.size(), dof_handlers_in.size()));
+
+  clear();
+  const unsigned int n_levels = dof_handlers_in.size();
+  const Triangulation<dim> &tria = dof_handlers_in[0]->get_triangulation();
+  const parallel::Triangulation<dim,dim> *ptria =
+    (dynamic_cast<const parallel::Triangulation<dim,dim>*> (&tria));
+  const MPI_Comm communicator =
+    ptria != nullptr ? ptria->get_communicator() : MPI_COMM_SELF;
+
+  dof_handlers.resize(n_levels);
+  level_constraints.resize(n_levels);
+  fe_degrees.resize(n_levels);
+  prolongation_matrices_1d.resize(n_levels-1);
+  level_dof_indices.resize(n_levels);
+  global_level_dof_indices.resize(n_levels);
+  weights.resize(n_levels);
+  ghosted_level_vector.resize(0, n_levels-1);
+
+  // step 1: extract the 1D elements and the indices on all levels
+  std::vector<std::shared_ptr<FiniteElement<1> > > fe_1d(n_levels);
+  for (unsigned int level=0; level<n_levels; ++level)
+    {
+      const DoFHandler<dim> &dof = *dof_handlers_in[level];
+      Assert(&dof.get_triangulation() == &tria,
+             ExcMessage("All DoFHandler objects must be based on the same "
+                        "triangulation"));
+      dof_handlers[level] = &dof;
+      if (!constraints_in.empty())
+        level_constraints[level] = constraints_in[level];
+
+      const FiniteElement<dim> &fe = dof.get_fe();
+      fe_1d[level] = get_fe_1d(fe);
+      fe_degrees[level] = fe_1d[level]->degree;
+      Assert(fe_1d[level]->dofs_per_vertex == fe_1d[0]->dofs_per_vertex,
+             ExcMessage("The elements on all levels must be either continuous "
+                        "or discontinuous"));
+      if (level == 0)
+        n_components = fe.element_multiplicity(0);
+      else
+        {
+          AssertDimension(n_components, fe.element_multiplicity(0));
+          Assert(fe_degrees[level] >= fe_degrees[level-1],
+                 ExcMessage("The DoFHandler objects must be sorted by "
+                            "increasing polynomial degree"));
+        }
+
+      // the lexicographic numbering of all components as used by the
+      // matrix-free framework
+      const Quadrature<1> dummy_quadrature(std::vector<Point<1> >(1, Point<1>()));
+      internal::MatrixFreeFunctions::ShapeInfo<Number> shape_info;
+      shape_info.reinit(dummy_quadrature, fe, 0);
+      const std::vector<unsigned int> &lexicographic = shape_info.lexicographic_numbering;
+      AssertDimension(lexicographic.size(), fe.dofs_per_cell);
+
+      IndexSet relevant_dofs;
+      DoFTools::extract_locally_relevant_dofs(dof, relevant_dofs);
+      ghosted_level_vector[level].reinit(dof.locally_owned_dofs(), relevant_dofs,
+                                         communicator);
+      const Utilities::MPI::Partitioner &partitioner =
+        *ghosted_level_vector[level].get_partitioner();
+
+      std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+      for (typename DoFHandler<dim>::active_cell_iterator cell=dof.begin_active();
+           cell != dof.end(); ++cell)
+        if (cell->is_locally_owned())
+          {
+            cell->get_dof_indices(dof_indices);
+            for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+              {
+                const types::global_dof_index index = dof_indices[lexicographic[i]];
+                global_level_dof_indices[level].push_back(index);
+                level_dof_indices[level].push_back(partitioner.global_to_local(index));
+              }
+          }
+    }
+
+  // step 2: compute the weights of the fine degrees of freedom, given by
+  // the inverse of the number of cells sharing the degree of freedom
+  for (unsigned int level=1; level<n_levels; ++level)
+    {
+      LinearAlgebra::distributed::Vector<Number> &touch_count =
+        ghosted_level_vector[level];
+      touch_count = 0.;
+      for (unsigned int i=0; i<level_dof_indices[level].size(); ++i)
+        touch_count.local_element(level_dof_indices[level][i]) += Number(1.);
+      touch_count.compress(VectorOperation::add);
+      touch_count.update_ghost_values();
+
+      const unsigned int n_local = touch_count.local_size() +
+                                   touch_count.get_partitioner()->n_ghost_indices();
+      weights[level].resize(n_local);
+      for (unsigned int i=0; i<n_local; ++i)
+        weights[level][i] = touch_count.local_element(i) > Number(0.) ?
+                            Number(1.)/touch_count.local_element(i) : Number(0.);
+      touch_count.zero_out_ghosts();
+    }
+
+  // step 3: compute the 1D embedding matrices between consecutive levels
+  // and bring them into lexicographic order
+  for (unsigned int level=1; level<n_levels; ++level)
+    {
+      const FiniteElement<1> &fe_coarse = *fe_1d[level-1];
+      const FiniteElement<1> &fe_fine = *fe_1d[level];
+      FullMatrix<double> projection(fe_fine.dofs_per_cell, fe_coarse.dofs_per_cell);
+      FETools::get_projection_matrix(fe_coarse, fe_fine, projection);
+
+      const std::vector<unsigned int> renumber_coarse =
+        get_lexicographic_numbering_1d(fe_coarse);
+      const std::vector<unsigned int> renumber_fine =
+        get_lexicographic_numbering_1d(fe_fine);
+      prolongation_matrices_1d[level-1].resize(fe_coarse.dofs_per_cell *
+                                               fe_fine.dofs_per_cell);
+      for (unsigned int i=0; i<fe_coarse.dofs_per_cell; ++i)
+        for (unsigned int j=0; j<fe_fine.dofs_per_cell; ++j)
+          prolongation_matrices_1d[level-1][i*fe_fine.dofs_per_cell+j] =
+            projection(renumber_fine[j], renumber_coarse[i]);
+    }
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferPolynomialMatrixFree<dim,Number>
+::prolongate (const unsigned int                                to_level,
+              LinearAlgebra::distributed::Vector<Number>       &dst,
+              const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  Assert ((to_level >= 1) && (to_level < n_levels()),
+          ExcIndexRange (to_level, 1, n_levels()));
+  AssertDimension(src.local_size(), ghosted_level_vector[to_level-1].local_size());
+  AssertDimension(dst.local_size(), ghosted_level_vector[to_level].local_size());
+
+  LinearAlgebra::distributed::Vector<Number> &ghosted_coarse =
+    ghosted_level_vector[to_level-1];
+  LinearAlgebra::distributed::Vector<Number> &ghosted_fine =
+    ghosted_level_vector[to_level];
+
+  ghosted_coarse.copy_locally_owned_data_from(src);
+  if (level_constraints[to_level-1] != nullptr)
+    level_constraints[to_level-1]->distribute(ghosted_coarse);
+  ghosted_coarse.update_ghost_values();
+  ghosted_fine = 0.;
+
+  const unsigned int n_coarse_dofs = Utilities::fixed_power<dim>(fe_degrees[to_level-1]+1);
+  const unsigned int n_fine_dofs = Utilities::fixed_power<dim>(fe_degrees[to_level]+1);
+  const unsigned int coarse_dofs_per_cell = n_components*n_coarse_dofs;
+  const unsigned int fine_dofs_per_cell = n_components*n_fine_dofs;
+  const unsigned int n_cells = level_dof_indices[to_level].size()/fine_dofs_per_cell;
+  AssertDimension(n_cells*coarse_dofs_per_cell, level_dof_indices[to_level-1].size());
+
+  const AlignedVector<Number> &matrix_1d = prolongation_matrices_1d[to_level-1];
+  typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,-1,0,Number> Evaluator;
+  Evaluator evaluator(matrix_1d, matrix_1d, matrix_1d,
+                      fe_degrees[to_level-1], fe_degrees[to_level]+1);
+
+  AlignedVector<Number> evaluation_data(3*fine_dofs_per_cell);
+  const Number *fine_weights = weights[to_level].begin();
+  for (unsigned int cell=0; cell<n_cells; ++cell)
+    {
+      const unsigned int *coarse_indices =
+        &level_dof_indices[to_level-1][cell*coarse_dofs_per_cell];
+      for (unsigned int i=0; i<coarse_dofs_per_cell; ++i)
+        evaluation_data[i] = ghosted_coarse.local_element(coarse_indices[i]);
+
+      perform_tensorized_op<dim,Evaluator,Number,true>(evaluator, n_coarse_dofs,
+                                                       n_fine_dofs, n_components,
+                                                       fine_dofs_per_cell,
+                                                       evaluation_data.begin());
+
+      const unsigned int *fine_indices =
+        &level_dof_indices[to_level][cell*fine_dofs_per_cell];
+      const Number *result = &evaluation_data[2*fine_dofs_per_cell];
+      for (unsigned int i=0; i<fine_dofs_per_cell; ++i)
+        ghosted_fine.local_element(fine_indices[i]) +=
+          fine_weights[fine_indices[i]] * result[i];
+    }
+
+  ghosted_coarse.zero_out_ghosts();
+  ghosted_fine.compress(VectorOperation::add);
+  if (level_constraints[to_level] != nullptr)
+    level_constraints[to_level]->set_zero(ghosted_fine);
+  dst.copy_locally_owned_data_from(ghosted_fine);
+}
+
+
+
+template <int dim, typename Number>
+void MGTransferPolynomialMatrixFree<dim,Number>
+::restrict_and_add (const unsigned int                                from_level,
+                    LinearAlgebra::distributed::Vector<Number>       &dst,
+                    const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  Assert ((from_level >= 1) && (from_level < n_levels()),
+          ExcIndexRange (from_level, 1, n_levels()));
+  AssertDimension(src.local_size(), ghosted_level_vector[from_level].local_size());
+  AssertDimension(dst.local_size(), ghosted_level_vector[from_level-1].local_size());
+
+  LinearAlgebra::distributed::Vector<Number> &ghosted_coarse =
+    ghosted_level_vector[from_level-1];
+  LinearAlgebra::distributed::Vector<Number> &ghosted_fine =
+    ghosted_level_vector[from_level];
+
+  ghosted_fine.copy_locally_owned_data_from(src);
+  if (level_constraints[from_level] != nullptr)
+    level_constraints[from_level]->set_zero(ghosted_fine);
+  ghosted_fine.update_ghost_values();
+  ghosted_coarse = 0.;
+
+  const unsigned int n_coarse_dofs = Utilities::fixed_power<dim>(fe_degrees[from_level-1]+1);
+  const unsigned int n_fine_dofs = Utilities::fixed_power<dim>(fe_degrees[from_level]+1);
+  const unsigned int coarse_dofs_per_cell = n_components*n_coarse_dofs;
+  const unsigned int fine_dofs_per_cell = n_components*n_fine_dofs;
+  const unsigned int n_cells = level_dof_indices[from_level].size()/fine_dofs_per_cell;
+  AssertDimension(n_cells*coarse_dofs_per_cell, level_dof_indices[from_level-1].size());
+
+  const AlignedVector<Number> &matrix_1d = prolongation_matrices_1d[from_level-1];
+  typedef internal::EvaluatorTensorProduct<internal::evaluate_general,dim,-1,0,Number> Evaluator;
+  Evaluator evaluator(matrix_1d, matrix_1d, matrix_1d,
+                      fe_degrees[from_level-1], fe_degrees[from_level]+1);
+
+  AlignedVector<Number> evaluation_data(3*fine_dofs_per_cell);
+  const Number *fine_weights = weights[from_level].begin();
+  const ConstraintMatrix *coarse_constraints = level_constraints[from_level-1];
+  for (unsigned int cell=0; cell<n_cells; ++cell)
+    {
+      const unsigned int *fine_indices =
+        &level_dof_indices[from_level][cell*fine_dofs_per_cell];
+      for (unsigned int i=0; i<fine_dofs_per_cell; ++i)
+        evaluation_data[i] = fine_weights[fine_indices[i]] *
+                             ghosted_fine.local_element(fine_indices[i]);
+
+      perform_tensorized_op<dim,Evaluator,Number,false>(evaluator, n_coarse_dofs,
+                                                        n_fine_dofs, n_components,
+                                                        fine_dofs_per_cell,
+                                                        evaluation_data.begin());
+
+      const Number *result = &evaluation_data[2*fine_dofs_per_cell];
+      if (coarse_constraints != nullptr)
+        {
+          // resolve the constraints on the coarse level, which is the
+          // transpose of ConstraintMatrix::distribute() in prolongate()
+          const types::global_dof_index *coarse_indices =
+            &global_level_dof_indices[from_level-1][cell*coarse_dofs_per_cell];
+          coarse_constraints->distribute_local_to_global(result,
+                                                         result+coarse_dofs_per_cell,
+                                                         coarse_indices,
+                                                         ghosted_coarse);
+        }
+      else
+        {
+          const unsigned int *coarse_indices =
+            &level_dof_indices[from_level-1][cell*coarse_dofs_per_cell];
+          for (unsigned int i=0; i<coarse_dofs_per_cell; ++i)
+            ghosted_coarse.local_element(coarse_indices[i]) += result[i];
+        }
+    }
+
+  ghosted_fine.zero_out_ghosts();
+  ghosted_coarse.compress(VectorOperation::add);
+
+  // add the locally owned range only, as dst might have been set up with a
+  // different set of ghost entries than the vector we hold here
+  for (unsigned int i=0; i<dst.local_size(); ++i)
+    dst.local_element(i) += ghosted_coarse.local_element(i);
+}
+
+
+
+template <int dim, typename Number>
+std::size_t
+MGTransferPolynomialMatrixFree<dim,Number>::memory_consumption() const
+{
+  std::size_t memory = MemoryConsumption::memory_consumption(fe_degrees);
+  memory += MemoryConsumption::memory_consumption(prolongation_matrices_1d);
+  memory += MemoryConsumption::memory_consumption(level_dof_indices);
+  memory += MemoryConsumption::memory_consumption(global_level_dof_indices);
+  memory += MemoryConsumption::memory_consumption(weights);
+  memory += ghosted_level_vector.memory_consumption();
+  return memory;
+}
+
+
+
+// explicit instantiations
+#include "mg_transfer_polynomial.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
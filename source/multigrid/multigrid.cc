@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2000 - 2016 by the deal.II authors
+// Copyright (C) 2000 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -24,6 +24,7 @@
 #include <deal.II/lac/trilinos_parallel_block_vector.h>
 #include <deal.II/lac/sparse_matrix.h>
 #include <deal.II/lac/block_sparse_matrix.h>
+#include <deal.II/lac/cuda_vector.h>
 #include <deal.II/multigrid/mg_transfer.h>
 #include <deal.II/multigrid/mg_transfer_block.h>
 #include <deal.II/multigrid/mg_transfer_component.h>
@@ -318,5 +319,10 @@ template class MGTransferSelect<double>;
 template class MGTransferBlockSelect<float>;
 template class MGTransferBlockSelect<double>;
 
+#ifdef DEAL_II_WITH_CUDA
+template class Multigrid<LinearAlgebra::CUDAWrappers::Vector<float> >;
+template class Multigrid<LinearAlgebra::CUDAWrappers::Vector<double> >;
+#endif
+
 
 DEAL_II_NAMESPACE_CLOSE
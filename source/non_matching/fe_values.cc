@@ -0,0 +1,200 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/non_matching/fe_values.h>
+#include <deal.II/fe/mapping_q1.h>
+
+DEAL_II_NAMESPACE_OPEN
+namespace NonMatching
+{
+
+  template <int dim>
+  FEValues<dim>::FEValues (const Mapping<dim>                     &mapping,
+                           const FiniteElement<dim>               &fe,
+                           const UpdateFlags                       update_flags,
+                           const DiscreteQuadratureGenerator<dim> &quadrature_generator)
+    :
+    mapping (&mapping),
+    fe (&fe),
+    update_flags (update_flags),
+    quadrature_generator (&quadrature_generator),
+    regular_fe_values (mapping, fe, quadrature_generator.get_regular_quadrature(),
+                       update_flags),
+    surface_quadrature (nullptr),
+    current_location (LocationToLevelSet::unassigned)
+  {}
+
+
+
+  template <int dim>
+  FEValues<dim>::FEValues (const FiniteElement<dim>               &fe,
+                           const UpdateFlags                       update_flags,
+                           const DiscreteQuadratureGenerator<dim> &quadrature_generator)
+    :
+    FEValues (StaticMappingQ1<dim>::mapping, fe, update_flags,
+              quadrature_generator)
+  {}
+
+
+
+  template <int dim>
+  void
+  FEValues<dim>::reinit (const typename DoFHandler<dim>::active_cell_iterator &cell)
+  {
+    current_location = quadrature_generator->location (cell);
+    Assert (current_location != LocationToLevelSet::unassigned,
+            ExcMessage ("The quadrature generator has no quadratures for this "
+                        "cell. Did you call reinit() on the quadrature "
+                        "generator, and is the cell locally owned?"));
+
+    if (current_location == LocationToLevelSet::intersected)
+      {
+        reinit_cut_cell_fe_values (cell, quadrature_generator->get_inside_quadrature(cell),
+                                   update_flags, inside_fe_values);
+        reinit_cut_cell_fe_values (cell, quadrature_generator->get_outside_quadrature(cell),
+                                   update_flags, outside_fe_values);
+
+        // the surface element is computed from the Jacobian
+        surface_quadrature = &quadrature_generator->get_surface_quadrature(cell);
+        reinit_cut_cell_fe_values (cell, *surface_quadrature,
+                                   update_flags | update_jacobians,
+                                   surface_fe_values);
+      }
+    else
+      {
+        // all shape data is already available, only the mapping data
+        // changes
+        regular_fe_values.reinit (cell);
+        surface_quadrature = nullptr;
+      }
+  }
+
+
+
+  template <int dim>
+  void
+  FEValues<dim>::
+  reinit_cut_cell_fe_values (const typename DoFHandler<dim>::active_cell_iterator &cell,
+                             const Quadrature<dim>                               &quadrature,
+                             const UpdateFlags                                    flags,
+                             std::unique_ptr<dealii::FEValues<dim> >             &fe_values)
+  {
+    if (quadrature.size() == 0)
+      fe_values.reset ();
+    else
+      {
+        fe_values.reset (new dealii::FEValues<dim> (*mapping, *fe, quadrature, flags));
+        fe_values->reinit (cell);
+      }
+  }
+
+
+
+  template <int dim>
+  LocationToLevelSet
+  FEValues<dim>::get_location () const
+  {
+    return current_location;
+  }
+
+
+
+  template <int dim>
+  const dealii::FEValues<dim> *
+  FEValues<dim>::get_inside_fe_values () const
+  {
+    switch (current_location)
+      {
+      case LocationToLevelSet::inside:
+        return &regular_fe_values;
+      case LocationToLevelSet::intersected:
+        return inside_fe_values.get();
+      default:
+        return nullptr;
+      }
+  }
+
+
+
+  template <int dim>
+  const dealii::FEValues<dim> *
+  FEValues<dim>::get_outside_fe_values () const
+  {
+    switch (current_location)
+      {
+      case LocationToLevelSet::outside:
+        return &regular_fe_values;
+      case LocationToLevelSet::intersected:
+        return outside_fe_values.get();
+      default:
+        return nullptr;
+      }
+  }
+
+
+
+  template <int dim>
+  const dealii::FEValues<dim> *
+  FEValues<dim>::get_surface_fe_values () const
+  {
+    if (current_location == LocationToLevelSet::intersected)
+      return surface_fe_values.get();
+    else
+      return nullptr;
+  }
+
+
+
+  template <int dim>
+  double
+  FEValues<dim>::surface_JxW (const unsigned int quadrature_point) const
+  {
+    Assert (get_surface_fe_values() != nullptr,
+            ExcMessage ("The current cell has no surface quadrature points."));
+    AssertIndexRange (quadrature_point, surface_quadrature->size());
+
+    const DerivativeForm<1,dim,dim> &jacobian =
+      surface_fe_values->jacobian (quadrature_point);
+    const Tensor<1,dim> scaled_normal =
+      apply_transformation (jacobian.covariant_form(),
+                            surface_quadrature->normal_vector(quadrature_point));
+    return std::abs(jacobian.determinant()) * scaled_normal.norm() *
+           surface_quadrature->weight (quadrature_point);
+  }
+
+
+
+  template <int dim>
+  Tensor<1,dim>
+  FEValues<dim>::surface_normal (const unsigned int quadrature_point) const
+  {
+    Assert (get_surface_fe_values() != nullptr,
+            ExcMessage ("The current cell has no surface quadrature points."));
+    AssertIndexRange (quadrature_point, surface_quadrature->size());
+
+    const Tensor<1,dim> normal =
+      apply_transformation (surface_fe_values->jacobian(quadrature_point).covariant_form(),
+                            surface_quadrature->normal_vector(quadrature_point));
+    return normal / normal.norm();
+  }
+
+
+
+  template class FEValues<1>;
+  template class FEValues<2>;
+  template class FEValues<3>;
+
+}
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,325 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/non_matching/mesh_coupling.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/fe/fe_nothing.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+DEAL_II_NAMESPACE_OPEN
+namespace NonMatching
+{
+
+  template <int dim, int spacedim>
+  MeshCoupling<dim,spacedim>::MeshCoupling
+  (const Triangulation<dim,spacedim> &first_triangulation,
+   const Triangulation<spacedim>     &second_triangulation,
+   const Quadrature<dim>             &quadrature,
+   const Mapping<dim,spacedim>       &first_mapping,
+   const Mapping<spacedim>           &second_mapping)
+    :
+    first_triangulation (&first_triangulation),
+    first_mapping (&first_mapping),
+    quadrature (quadrature),
+    second_cache (second_triangulation, second_mapping),
+    up_to_date (false)
+  {
+    const parallel::Triangulation<spacedim> *second_parallel_tria =
+      dynamic_cast<const parallel::Triangulation<spacedim> *>(&second_triangulation);
+    if (second_parallel_tria != nullptr)
+      {
+        const parallel::Triangulation<dim,spacedim> *first_parallel_tria =
+          dynamic_cast<const parallel::Triangulation<dim,spacedim> *>(&first_triangulation);
+        AssertThrow (first_parallel_tria != nullptr,
+                     ExcMessage("If the second triangulation is distributed, the "
+                                "first one must be distributed, too."));
+#ifdef DEAL_II_WITH_MPI
+        int result;
+        const int ierr = MPI_Comm_compare(first_parallel_tria->get_communicator(),
+                                          second_parallel_tria->get_communicator(),
+                                          &result);
+        AssertThrowMPI(ierr);
+        AssertThrow (result == MPI_IDENT || result == MPI_CONGRUENT,
+                     ExcMessage("Both triangulations must be distributed among "
+                                "the same processes."));
+#endif
+      }
+
+    // the cache of the second mesh updates itself, so we only need to
+    // remember that the cell pairs are outdated
+    const auto outdate = [this]()
+    {
+      up_to_date = false;
+    };
+    tria_signals.push_back(first_triangulation.signals.any_change.connect(outdate));
+    tria_signals.push_back(first_triangulation.signals.mesh_movement.connect(outdate));
+    tria_signals.push_back(second_triangulation.signals.any_change.connect(outdate));
+    tria_signals.push_back(second_triangulation.signals.mesh_movement.connect(outdate));
+  }
+
+
+
+  template <int dim, int spacedim>
+  MeshCoupling<dim,spacedim>::~MeshCoupling ()
+  {
+    for (auto &connection : tria_signals)
+      if (connection.connected())
+        connection.disconnect();
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  MeshCoupling<dim,spacedim>::update ()
+  {
+    if (up_to_date)
+      return;
+
+    cell_pairs.clear();
+
+    const Triangulation<spacedim> &second_triangulation = second_cache.get_triangulation();
+    const parallel::Triangulation<spacedim> *parallel_tria =
+      dynamic_cast<const parallel::Triangulation<spacedim> *>(&second_triangulation);
+    const MPI_Comm mpi_communicator = parallel_tria != nullptr ?
+                                      parallel_tria->get_communicator() :
+                                      MPI_COMM_SELF;
+    const unsigned int my_rank = Utilities::MPI::this_mpi_process(mpi_communicator);
+
+    // map the quadrature formula to the locally owned cells of the first
+    // mesh. FE_Nothing lets FEValues compute the geometry only
+    const FE_Nothing<dim,spacedim> fe_nothing;
+    FEValues<dim,spacedim> fe_values (*first_mapping, fe_nothing, quadrature,
+                                      update_quadrature_points | update_JxW_values);
+    const unsigned int n_q_points = quadrature.size();
+
+    std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> first_cells;
+    std::vector<Point<spacedim> > points;
+    std::vector<double> JxW;
+    for (const auto &cell : first_triangulation->active_cell_iterators())
+      if (cell->is_locally_owned())
+        {
+          fe_values.reinit(cell);
+          first_cells.push_back(cell);
+          for (unsigned int q=0; q<n_q_points; ++q)
+            {
+              points.push_back(fe_values.quadrature_point(q));
+              JxW.push_back(fe_values.JxW(q));
+            }
+        }
+
+    // locate the points among the locally owned cells of the second mesh on
+    // all processes
+    const std::vector<std::vector<BoundingBox<spacedim> > > global_bboxes =
+      GridTools::exchange_local_bounding_boxes(GridTools::compute_locally_owned_bounding_boxes(second_cache),
+                                               mpi_communicator);
+    const auto located =
+      GridTools::distributed_compute_point_locations(second_cache, points, global_bboxes);
+    const auto &located_cells = std::get<0>(located);
+    const auto &located_unit_points = std::get<1>(located);
+    const auto &located_indices = std::get<2>(located);
+    const auto &located_ranks = std::get<3>(located);
+
+    // the cell of the second mesh assigned to each of the points. Points on
+    // the interface between the parts of several processes are assigned to
+    // the process of lowest rank, such that they are only counted once
+    std::vector<unsigned int> second_owners (points.size(), numbers::invalid_unsigned_int);
+    std::vector<CellId::binary_type> second_ids (points.size());
+    std::vector<Point<spacedim> > second_unit_points (points.size());
+    std::vector<typename Triangulation<spacedim>::active_cell_iterator> second_cells (points.size());
+    const auto assign_point = [&](const unsigned int                index,
+                                  const unsigned int                rank,
+                                  const CellId::binary_type        &id,
+                                  const Point<spacedim>            &unit_point)
+    {
+      AssertIndexRange (index, points.size());
+      if (rank >= second_owners[index])
+        return false;
+      second_owners[index] = rank;
+      second_ids[index] = id;
+      second_unit_points[index] = unit_point;
+      return true;
+    };
+
+    std::vector<CellId::binary_type> located_ids (located_cells.size());
+    for (unsigned int c=0; c<located_cells.size(); ++c)
+      {
+        located_ids[c] = located_cells[c]->id().template to_binary<spacedim>();
+        for (unsigned int j=0; j<located_indices[c].size(); ++j)
+          if (located_ranks[c][j] == my_rank &&
+              assign_point(located_indices[c][j], my_rank, located_ids[c],
+                           located_unit_points[c][j]))
+            second_cells[located_indices[c][j]] = located_cells[c];
+      }
+
+#ifdef DEAL_II_WITH_MPI
+    const unsigned int n_procs = Utilities::MPI::n_mpi_processes(mpi_communicator);
+    if (n_procs > 1)
+      {
+        // send the points located for other processes back to them, each
+        // as its index in the vector of points of the sending process, the
+        // identifier of the cell, and the reference coordinates, all of
+        // which are represented exactly by doubles
+        const int mpi_tag = 4202;
+        const unsigned int n_id_entries = std::tuple_size<CellId::binary_type>::value;
+        const unsigned int stride = 1 + n_id_entries + spacedim;
+        std::map<unsigned int, std::vector<double> > data_per_rank;
+        for (unsigned int c=0; c<located_cells.size(); ++c)
+          for (unsigned int j=0; j<located_indices[c].size(); ++j)
+            if (located_ranks[c][j] != my_rank)
+              {
+                std::vector<double> &buffer = data_per_rank[located_ranks[c][j]];
+                buffer.push_back(located_indices[c][j]);
+                for (const unsigned int entry : located_ids[c])
+                  buffer.push_back(entry);
+                for (unsigned int d=0; d<spacedim; ++d)
+                  buffer.push_back(located_unit_points[c][j][d]);
+              }
+
+        std::vector<unsigned int> destinations;
+        for (const auto &rank_and_data : data_per_rank)
+          destinations.push_back(rank_and_data.first);
+        const std::vector<unsigned int> sources =
+          Utilities::MPI::compute_point_to_point_communication_pattern(mpi_communicator,
+              destinations);
+
+        std::vector<MPI_Request> requests(destinations.size());
+        for (unsigned int i=0; i<destinations.size(); ++i)
+          {
+            std::vector<double> &buffer = data_per_rank[destinations[i]];
+            const int ierr = MPI_Isend(buffer.data(), buffer.size(), MPI_DOUBLE,
+                                       destinations[i], mpi_tag,
+                                       mpi_communicator, &requests[i]);
+            AssertThrowMPI(ierr);
+          }
+
+        std::vector<double> receive_buffer;
+        for (unsigned int i=0; i<sources.size(); ++i)
+          {
+            MPI_Status status;
+            int ierr = MPI_Probe(MPI_ANY_SOURCE, mpi_tag, mpi_communicator, &status);
+            AssertThrowMPI(ierr);
+            int n_entries;
+            ierr = MPI_Get_count(&status, MPI_DOUBLE, &n_entries);
+            AssertThrowMPI(ierr);
+            receive_buffer.resize(n_entries);
+            ierr = MPI_Recv(receive_buffer.data(), n_entries, MPI_DOUBLE,
+                            status.MPI_SOURCE, mpi_tag, mpi_communicator,
+                            MPI_STATUS_IGNORE);
+            AssertThrowMPI(ierr);
+
+            for (int j=0; j<n_entries; j+=stride)
+              {
+                CellId::binary_type id;
+                for (unsigned int e=0; e<n_id_entries; ++e)
+                  id[e] = static_cast<unsigned int>(receive_buffer[j+1+e]);
+                Point<spacedim> unit_point;
+                for (unsigned int d=0; d<spacedim; ++d)
+                  unit_point[d] = receive_buffer[j+1+n_id_entries+d];
+                assign_point(static_cast<unsigned int>(receive_buffer[j]),
+                             status.MPI_SOURCE, id, unit_point);
+              }
+          }
+
+        if (requests.size() > 0)
+          {
+            const int ierr = MPI_Waitall(requests.size(), requests.data(),
+                                         MPI_STATUSES_IGNORE);
+            AssertThrowMPI(ierr);
+          }
+
+        // cells of other processes are only available as iterators if they
+        // are ghost cells here
+        std::map<CellId::binary_type,
+            typename Triangulation<spacedim>::active_cell_iterator> ghost_cells;
+        for (const auto &cell : second_triangulation.active_cell_iterators())
+          if (cell->is_ghost())
+            ghost_cells.emplace(cell->id().template to_binary<spacedim>(), cell);
+        for (unsigned int i=0; i<points.size(); ++i)
+          if (second_owners[i] != numbers::invalid_unsigned_int &&
+              second_owners[i] != my_rank)
+            {
+              const auto ghost = ghost_cells.find(second_ids[i]);
+              if (ghost != ghost_cells.end())
+                second_cells[i] = ghost->second;
+            }
+      }
+#endif
+
+    // group the points of each cell of the first mesh by the cell of the
+    // second mesh they lie in, keeping the order of the quadrature points
+    std::vector<unsigned int> cell_points;
+    for (unsigned int c=0; c<first_cells.size(); ++c)
+      {
+        cell_points.clear();
+        for (unsigned int q=0; q<n_q_points; ++q)
+          if (second_owners[c*n_q_points+q] != numbers::invalid_unsigned_int)
+            cell_points.push_back(c*n_q_points+q);
+        std::sort(cell_points.begin(), cell_points.end(),
+                  [&](const unsigned int a, const unsigned int b)
+        {
+          return (std::tie(second_owners[a], second_ids[a], a) <
+                  std::tie(second_owners[b], second_ids[b], b));
+        });
+
+        for (unsigned int i=0; i<cell_points.size(); ++i)
+          {
+            const unsigned int index = cell_points[i];
+            if (i == 0 ||
+                second_owners[index] != second_owners[cell_points[i-1]] ||
+                second_ids[index] != second_ids[cell_points[i-1]])
+              {
+                cell_pairs.emplace_back();
+                CellPair &pair = cell_pairs.back();
+                pair.first_cell = first_cells[c];
+                pair.second_cell = second_cells[index];
+                pair.second_cell_id = CellId(second_ids[index]);
+                pair.second_cell_owner = second_owners[index];
+              }
+            CellPair &pair = cell_pairs.back();
+            pair.first_unit_points.push_back(quadrature.point(index-c*n_q_points));
+            pair.second_unit_points.push_back(second_unit_points[index]);
+            pair.JxW.push_back(JxW[index]);
+          }
+      }
+
+    up_to_date = true;
+  }
+
+
+
+  template <int dim, int spacedim>
+  unsigned int
+  MeshCoupling<dim,spacedim>::n_quadrature_points () const
+  {
+    Assert (up_to_date,
+            ExcMessage("The cell pairs are outdated, call update() first."));
+    unsigned int n_points = 0;
+    for (const CellPair &pair : cell_pairs)
+      n_points += pair.JxW.size();
+    return n_points;
+  }
+
+}
+
+#include "mesh_coupling.inst"
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,943 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/non_matching/quadrature_generator.h>
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/la_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+namespace NonMatching
+{
+
+  AdditionalQGeneratorData::
+  AdditionalQGeneratorData (const unsigned int max_box_splits,
+                            const double       lower_bound_implicit_function,
+                            const double       min_relative_derivative,
+                            const double       min_distance_between_roots,
+                            const double       limit_to_be_definite,
+                            const double       root_finder_tolerance,
+                            const unsigned int max_root_finder_iterations)
+    :
+    max_box_splits (max_box_splits),
+    lower_bound_implicit_function (lower_bound_implicit_function),
+    min_relative_derivative (min_relative_derivative),
+    min_distance_between_roots (min_distance_between_roots),
+    limit_to_be_definite (limit_to_be_definite),
+    root_finder_tolerance (root_finder_tolerance),
+    max_root_finder_iterations (max_root_finder_iterations)
+  {}
+
+
+
+  namespace internal
+  {
+    namespace QuadratureGeneratorImplementation
+    {
+      namespace
+      {
+        /**
+         * The restriction of a function to the hyperplane where the given
+         * coordinate takes a fixed value.
+         */
+        template <int dim>
+        class CoordinateRestriction : public Function<dim-1>
+        {
+        public:
+          CoordinateRestriction (const Function<dim> &function,
+                                 const unsigned int   direction,
+                                 const double         coordinate_value)
+            :
+            function (function),
+            direction (direction),
+            coordinate_value (coordinate_value)
+          {}
+
+          virtual double value (const Point<dim-1>  &point,
+                                const unsigned int   component = 0) const
+          {
+            return function.value (create_point(point), component);
+          }
+
+          virtual Tensor<1,dim-1> gradient (const Point<dim-1>  &point,
+                                            const unsigned int   component = 0) const
+          {
+            const Tensor<1,dim> full_gradient =
+              function.gradient (create_point(point), component);
+            Tensor<1,dim-1> result;
+            for (unsigned int d=0, c=0; d<dim; ++d)
+              if (d != direction)
+                result[c++] = full_gradient[d];
+            return result;
+          }
+
+          virtual SymmetricTensor<2,dim-1> hessian (const Point<dim-1>  &point,
+                                                    const unsigned int   component = 0) const
+          {
+            const SymmetricTensor<2,dim> full_hessian =
+              function.hessian (create_point(point), component);
+            SymmetricTensor<2,dim-1> result;
+            for (unsigned int d1=0, c1=0; d1<dim; ++d1)
+              if (d1 != direction)
+                {
+                  for (unsigned int d2=d1, c2=c1; d2<dim; ++d2)
+                    if (d2 != direction)
+                      result[c1][c2++] = full_hessian[d1][d2];
+                  ++c1;
+                }
+            return result;
+          }
+
+        private:
+          Point<dim> create_point (const Point<dim-1> &point) const
+          {
+            Point<dim> result;
+            for (unsigned int d=0, c=0; d<dim; ++d)
+              result[d] = (d == direction) ? coordinate_value : point[c++];
+            return result;
+          }
+
+          const Function<dim> &function;
+          const unsigned int   direction;
+          const double         coordinate_value;
+        };
+
+
+
+        /**
+         * Estimate the range of the values and the gradient of a function on
+         * a box by a second order Taylor expansion around the center of the
+         * box. The value bounds are widened by the values at the vertices.
+         */
+        template <int dim>
+        void
+        estimate_function_bounds (const Function<dim>                        &function,
+                                  const BoundingBox<dim>                     &box,
+                                  std::pair<double,double>                   &value_bounds,
+                                  std::array<std::pair<double,double>,dim>   &gradient_bounds)
+        {
+          const std::pair<Point<dim>,Point<dim> > &corners = box.get_boundary_points();
+          Point<dim> center;
+          double half_side[dim];
+          for (unsigned int d=0; d<dim; ++d)
+            {
+              center[d] = 0.5 * (corners.first[d] + corners.second[d]);
+              half_side[d] = 0.5 * (corners.second[d] - corners.first[d]);
+            }
+
+          const double value = function.value (center);
+          const Tensor<1,dim> gradient = function.gradient (center);
+          const SymmetricTensor<2,dim> hessian = function.hessian (center);
+
+          double value_delta = 0;
+          for (unsigned int d1=0; d1<dim; ++d1)
+            {
+              double gradient_delta = 0;
+              for (unsigned int d2=0; d2<dim; ++d2)
+                gradient_delta += std::abs(hessian[d1][d2]) * half_side[d2];
+              gradient_bounds[d1] = std::make_pair (gradient[d1] - gradient_delta,
+                                                    gradient[d1] + gradient_delta);
+              value_delta += std::abs(gradient[d1]) * half_side[d1] +
+                             0.5 * gradient_delta * half_side[d1];
+            }
+          value_bounds = std::make_pair (value - value_delta, value + value_delta);
+
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            {
+              Point<dim> vertex;
+              for (unsigned int d=0; d<dim; ++d)
+                vertex[d] = (v & (1U << d)) ? corners.second[d] : corners.first[d];
+              const double vertex_value = function.value (vertex);
+              value_bounds.first = std::min (value_bounds.first, vertex_value);
+              value_bounds.second = std::max (value_bounds.second, vertex_value);
+            }
+        }
+
+
+
+        /**
+         * Return the coordinate direction in which the derivatives of all
+         * functions are bounded away from zero, or -1 if there is no such
+         * direction. If there are several, choose the one where the smallest
+         * derivative is largest relative to the size of the gradient, and
+         * return this ratio in @p relative_derivative. A small ratio means
+         * that the zero contour is steep as a function over the face
+         * perpendicular to the direction.
+         */
+        template <int dim>
+        int
+        find_height_direction (const std::vector<std::array<std::pair<double,double>,dim> > &gradient_bounds,
+                               const double lower_bound,
+                               double      &relative_derivative)
+        {
+          int height_direction = -1;
+          relative_derivative = 0;
+          for (unsigned int d=0; d<dim; ++d)
+            {
+              double smallest_derivative = std::numeric_limits<double>::max();
+              double smallest_ratio = std::numeric_limits<double>::max();
+              for (unsigned int i=0; i<gradient_bounds.size(); ++i)
+                {
+                  const std::pair<double,double> &bounds = gradient_bounds[i][d];
+                  const double derivative = bounds.first > 0 ? bounds.first :
+                                            (bounds.second < 0 ? -bounds.second : 0.);
+                  double gradient_size = 0;
+                  for (unsigned int e=0; e<dim; ++e)
+                    gradient_size = std::max (gradient_size,
+                                              std::max (std::abs(gradient_bounds[i][e].first),
+                                                        std::abs(gradient_bounds[i][e].second)));
+                  smallest_derivative = std::min (smallest_derivative, derivative);
+                  smallest_ratio = std::min (smallest_ratio, derivative / gradient_size);
+                }
+              if (smallest_derivative > lower_bound &&
+                  smallest_ratio > relative_derivative)
+                {
+                  relative_derivative = smallest_ratio;
+                  height_direction = d;
+                }
+            }
+          return height_direction;
+        }
+
+
+
+        /**
+         * Return the direction with the largest estimated derivative, which
+         * is used when no direction with monotone functions is found.
+         */
+        template <int dim>
+        unsigned int
+        find_largest_derivative_direction (const std::vector<std::array<std::pair<double,double>,dim> > &gradient_bounds)
+        {
+          unsigned int direction = 0;
+          double largest_derivative = -1;
+          for (unsigned int d=0; d<dim; ++d)
+            {
+              double derivative = 0;
+              for (unsigned int i=0; i<gradient_bounds.size(); ++i)
+                derivative += std::abs (gradient_bounds[i][d].first +
+                                        gradient_bounds[i][d].second);
+              if (derivative > largest_derivative)
+                {
+                  largest_derivative = derivative;
+                  direction = d;
+                }
+            }
+          return direction;
+        }
+
+
+
+        /**
+         * Find the root of a function along the coordinate direction @p
+         * direction in the interval [a,b], where the function values @p
+         * f_a and @p f_b have different signs, by the Illinois variant of
+         * the regula falsi method.
+         */
+        template <int dim>
+        double
+        find_root_in_bracket (const Function<dim>            &function,
+                              Point<dim>                     &point,
+                              const unsigned int              direction,
+                              double                          a,
+                              double                          b,
+                              double                          f_a,
+                              double                          f_b,
+                              const AdditionalQGeneratorData &data)
+        {
+          int last_side = 0;
+          double root = a;
+          for (unsigned int it=0; it<data.max_root_finder_iterations; ++it)
+            {
+              const double old_root = root;
+              root = (f_a * b - f_b * a) / (f_a - f_b);
+              if (it > 0 && std::abs(root - old_root) < data.root_finder_tolerance)
+                break;
+
+              point[direction] = root;
+              const double f_root = function.value (point);
+              if (f_root == 0)
+                break;
+              else if ((f_root > 0) == (f_b > 0))
+                {
+                  b = root;
+                  f_b = f_root;
+                  if (last_side == -1)
+                    f_a *= 0.5;
+                  last_side = -1;
+                }
+              else
+                {
+                  a = root;
+                  f_a = f_root;
+                  if (last_side == 1)
+                    f_b *= 0.5;
+                  last_side = 1;
+                }
+            }
+          return root;
+        }
+
+
+
+        /**
+         * Append the roots of a function along the coordinate direction @p
+         * direction in [lower,upper] to @p roots. If the function is not
+         * known to be monotone, the interval is split into several pieces
+         * that are searched for sign changes individually.
+         */
+        template <int dim>
+        void
+        find_roots_on_line (const Function<dim>            &function,
+                            Point<dim>                      point,
+                            const unsigned int              direction,
+                            const double                    lower,
+                            const double                    upper,
+                            const unsigned int              n_intervals,
+                            const AdditionalQGeneratorData &data,
+                            std::vector<double>            &roots)
+        {
+          double t_0 = lower;
+          point[direction] = t_0;
+          double f_0 = function.value (point);
+          for (unsigned int i=0; i<n_intervals; ++i)
+            {
+              const double t_1 = lower + (upper - lower) * (i + 1) / n_intervals;
+              point[direction] = t_1;
+              const double f_1 = function.value (point);
+              if (f_0 == 0)
+                roots.push_back (t_0);
+              else if (f_1 != 0 && (f_0 > 0) != (f_1 > 0))
+                roots.push_back (find_root_in_bracket (function, point, direction,
+                                                       t_0, t_1, f_0, f_1, data));
+              t_0 = t_1;
+              f_0 = f_1;
+            }
+          if (f_0 == 0)
+            roots.push_back (upper);
+        }
+      }
+
+
+
+      template <int dim>
+      void
+      PointsAndWeights<dim>::push_back (const Point<dim> &point,
+                                        const double      weight)
+      {
+        points.push_back (point);
+        weights.push_back (weight);
+      }
+
+
+
+      template <int dim>
+      void
+      PointsAndWeights<dim>::clear ()
+      {
+        points.clear ();
+        weights.clear ();
+      }
+
+
+
+      template <int dim>
+      void
+      QPartitioning<dim>::clear ()
+      {
+        negative.clear ();
+        positive.clear ();
+        indefinite.clear ();
+        surface.clear ();
+        surface_normals.clear ();
+      }
+
+
+
+      template <int dim>
+      QGeneratorBase<dim>::QGeneratorBase (const Quadrature<1>             &quadrature_1D,
+                                           const AdditionalQGeneratorData &additional_data)
+        :
+        quadrature_1D (quadrature_1D),
+        tensor_quadrature (quadrature_1D),
+        additional_data (additional_data)
+      {
+        Assert (quadrature_1D.size() > 0,
+                ExcMessage ("The one-dimensional quadrature must not be empty."));
+      }
+
+
+
+      template <int dim>
+      void
+      QGeneratorBase<dim>::clear ()
+      {
+        q_partitioning.clear ();
+      }
+
+
+
+      template <int dim>
+      bool
+      QGeneratorBase<dim>::
+      sort_by_sign (const std::vector<const Function<dim> *>                &level_sets,
+                    const BoundingBox<dim>                                  &box,
+                    std::vector<const Function<dim> *>                      &indefinite_level_sets,
+                    std::vector<std::array<std::pair<double,double>,dim> > &gradient_bounds)
+      {
+        indefinite_level_sets.clear ();
+        gradient_bounds.clear ();
+
+        bool all_negative = true, all_positive = true;
+        std::pair<double,double> value_bounds;
+        std::array<std::pair<double,double>,dim> function_gradient_bounds;
+        for (unsigned int i=0; i<level_sets.size(); ++i)
+          {
+            estimate_function_bounds<dim> (*level_sets[i], box, value_bounds,
+                                           function_gradient_bounds);
+            if (value_bounds.first > additional_data.limit_to_be_definite)
+              all_negative = false;
+            else if (value_bounds.second < -additional_data.limit_to_be_definite)
+              all_positive = false;
+            else
+              {
+                indefinite_level_sets.push_back (level_sets[i]);
+                gradient_bounds.push_back (function_gradient_bounds);
+              }
+          }
+
+        if (indefinite_level_sets.size() > 0)
+          return false;
+
+        // all functions have a definite sign, so fill the whole box by a
+        // tensor product quadrature
+        PointsAndWeights<dim> &region = all_negative ? q_partitioning.negative :
+                                        (all_positive ? q_partitioning.positive :
+                                         q_partitioning.indefinite);
+        const std::pair<Point<dim>,Point<dim> > &corners = box.get_boundary_points();
+        const double volume = box.volume();
+        for (unsigned int q=0; q<tensor_quadrature.size(); ++q)
+          {
+            Point<dim> point;
+            for (unsigned int d=0; d<dim; ++d)
+              point[d] = corners.first[d] + (corners.second[d] - corners.first[d]) *
+                         tensor_quadrature.point(q)[d];
+            region.push_back (point, tensor_quadrature.weight(q) * volume);
+          }
+        return true;
+      }
+
+
+
+      template <int dim>
+      void
+      QGeneratorBase<dim>::
+      add_line_quadrature (const std::vector<const Function<dim> *> &level_sets,
+                           const std::vector<const Function<dim> *> &indefinite_level_sets,
+                           Point<dim>                                point,
+                           const unsigned int                        direction,
+                           const double                              lower,
+                           const double                              upper,
+                           const double                              weight,
+                           const bool                                monotone,
+                           const bool                                create_surface)
+      {
+        // a monotone function has at most one root, otherwise search the
+        // subintervals between the 1D quadrature points individually
+        const unsigned int n_intervals = monotone ? 1 : quadrature_1D.size() + 1;
+        roots.clear ();
+        for (unsigned int i=0; i<indefinite_level_sets.size(); ++i)
+          find_roots_on_line (*indefinite_level_sets[i], point, direction, lower,
+                              upper, n_intervals, additional_data, roots);
+        std::sort (roots.begin(), roots.end());
+        const double min_distance = additional_data.min_distance_between_roots;
+        roots.erase (std::unique (roots.begin(), roots.end(),
+                                  [min_distance] (const double a, const double b)
+        {
+          return std::abs(b - a) < min_distance;
+        }),
+        roots.end());
+
+        // the surface element of the zero contour, seen as the graph of a
+        // height function over the face, is |grad psi| / |d_k psi| times the
+        // surface element of the face
+        if (create_surface)
+          {
+            Assert (level_sets.size() == 1, ExcInternalError());
+            for (unsigned int r=0; r<roots.size(); ++r)
+              {
+                point[direction] = roots[r];
+                const Tensor<1,dim> gradient = level_sets[0]->gradient (point);
+                const double gradient_norm = gradient.norm();
+                if (std::abs(gradient[direction]) <=
+                    additional_data.lower_bound_implicit_function)
+                  continue;
+                q_partitioning.surface.push_back (point,
+                                                  weight * gradient_norm /
+                                                  std::abs(gradient[direction]));
+                q_partitioning.surface_normals.push_back (gradient / gradient_norm);
+              }
+          }
+
+        // place the 1D quadrature on the intervals between the roots and
+        // sort the points by the signs of the level set functions in the
+        // middle of the interval
+        double start = lower;
+        for (unsigned int r=0; r<=roots.size(); ++r)
+          {
+            const double end = (r < roots.size()) ? roots[r] : upper;
+            const double length = end - start;
+            if (length > min_distance)
+              {
+                point[direction] = 0.5 * (start + end);
+                bool all_negative = true, all_positive = true;
+                for (unsigned int i=0; i<level_sets.size(); ++i)
+                  if (level_sets[i]->value (point) < 0)
+                    all_positive = false;
+                  else
+                    all_negative = false;
+                PointsAndWeights<dim> &region = all_negative ? q_partitioning.negative :
+                                                (all_positive ? q_partitioning.positive :
+                                                 q_partitioning.indefinite);
+                for (unsigned int q=0; q<quadrature_1D.size(); ++q)
+                  {
+                    point[direction] = start + length * quadrature_1D.point(q)[0];
+                    region.push_back (point, weight * length * quadrature_1D.weight(q));
+                  }
+              }
+            start = end;
+          }
+      }
+
+
+
+      template <int dim>
+      QGenerator<dim>::QGenerator (const Quadrature<1>             &quadrature_1D,
+                                   const AdditionalQGeneratorData &additional_data)
+        :
+        QGeneratorBase<dim> (quadrature_1D, additional_data),
+        low_dim_generator (quadrature_1D, additional_data)
+      {}
+
+
+
+      template <int dim>
+      void
+      QGenerator<dim>::generate (const std::vector<const Function<dim> *> &level_sets,
+                                 const BoundingBox<dim>                   &box,
+                                 const unsigned int                        n_box_splits,
+                                 const bool                                create_surface)
+      {
+        std::vector<const Function<dim> *> indefinite_level_sets;
+        std::vector<std::array<std::pair<double,double>,dim> > gradient_bounds;
+        if (this->sort_by_sign (level_sets, box, indefinite_level_sets,
+                                gradient_bounds))
+          return;
+
+        double relative_derivative = 0;
+        int height_direction =
+          find_height_direction<dim> (gradient_bounds,
+                                      this->additional_data.lower_bound_implicit_function,
+                                      relative_derivative);
+
+        // split the box into its 2^dim children if no height direction
+        // exists. also split if the zero contour is too steep over the face,
+        // because the height function is then close to a singularity and the
+        // quadrature on the face converges slowly
+        if ((height_direction < 0 ||
+             relative_derivative < this->additional_data.min_relative_derivative) &&
+            n_box_splits < this->additional_data.max_box_splits)
+          {
+            const std::pair<Point<dim>,Point<dim> > &corners = box.get_boundary_points();
+            for (unsigned int c=0; c<GeometryInfo<dim>::max_children_per_cell; ++c)
+              {
+                std::pair<Point<dim>,Point<dim> > child_corners = corners;
+                for (unsigned int d=0; d<dim; ++d)
+                  {
+                    const double center = 0.5 * (corners.first[d] + corners.second[d]);
+                    if (c & (1U << d))
+                      child_corners.first[d] = center;
+                    else
+                      child_corners.second[d] = center;
+                  }
+                generate (level_sets, BoundingBox<dim>(child_corners),
+                          n_box_splits + 1, create_surface);
+              }
+            return;
+          }
+
+        const bool monotone = height_direction >= 0;
+        if (monotone == false)
+          height_direction = find_largest_derivative_direction<dim> (gradient_bounds);
+
+        create_up_through_dimension (level_sets, indefinite_level_sets, box,
+                                     height_direction, monotone, create_surface);
+      }
+
+
+
+      template <int dim>
+      void
+      QGenerator<dim>::
+      create_up_through_dimension (const std::vector<const Function<dim> *> &level_sets,
+                                   const std::vector<const Function<dim> *> &indefinite_level_sets,
+                                   const BoundingBox<dim>                   &box,
+                                   const unsigned int                        height_direction,
+                                   const bool                                monotone,
+                                   const bool                                create_surface)
+      {
+        const std::pair<Point<dim>,Point<dim> > &corners = box.get_boundary_points();
+        const double lower = corners.first[height_direction];
+        const double upper = corners.second[height_direction];
+
+        std::pair<Point<dim-1>,Point<dim-1> > face_corners;
+        for (unsigned int d=0, c=0; d<dim; ++d)
+          if (d != height_direction)
+            {
+              face_corners.first[c] = corners.first[d];
+              face_corners.second[c] = corners.second[d];
+              ++c;
+            }
+
+        // the kinks of the integrand along the face are where the zero
+        // contour hits the bottom or the top face, so create a quadrature on
+        // the face that is adapted to the restrictions to these two faces
+        std::vector<std::unique_ptr<CoordinateRestriction<dim> > > restrictions;
+        std::vector<const Function<dim-1> *> face_level_sets;
+        for (unsigned int i=0; i<indefinite_level_sets.size(); ++i)
+          for (unsigned int side=0; side<2; ++side)
+            {
+              restrictions.emplace_back
+              (new CoordinateRestriction<dim> (*indefinite_level_sets[i],
+                                               height_direction,
+                                               side == 0 ? lower : upper));
+              face_level_sets.push_back (restrictions.back().get());
+            }
+
+        low_dim_generator.clear ();
+        low_dim_generator.generate (face_level_sets,
+                                    BoundingBox<dim-1>(face_corners), 0, false);
+
+        // on the face, all regions are needed regardless of the sign
+        const QPartitioning<dim-1> &face_partitioning = low_dim_generator.q_partitioning;
+        for (const PointsAndWeights<dim-1> *face_points :
+             {
+               &face_partitioning.negative, &face_partitioning.positive,
+               &face_partitioning.indefinite
+             })
+          for (unsigned int q=0; q<face_points->points.size(); ++q)
+            {
+              Point<dim> point;
+              for (unsigned int d=0, c=0; d<dim; ++d)
+                point[d] = (d == height_direction) ? lower : face_points->points[q][c++];
+              this->add_line_quadrature (level_sets, indefinite_level_sets, point,
+                                         height_direction, lower, upper,
+                                         face_points->weights[q], monotone,
+                                         create_surface);
+            }
+      }
+
+
+
+      QGenerator<1>::QGenerator (const Quadrature<1>             &quadrature_1D,
+                                 const AdditionalQGeneratorData &additional_data)
+        :
+        QGeneratorBase<1> (quadrature_1D, additional_data)
+      {}
+
+
+
+      void
+      QGenerator<1>::generate (const std::vector<const Function<1> *> &level_sets,
+                               const BoundingBox<1>                   &box,
+                               const unsigned int,
+                               const bool                              create_surface)
+      {
+        std::vector<const Function<1> *> indefinite_level_sets;
+        std::vector<std::array<std::pair<double,double>,1> > gradient_bounds;
+        if (this->sort_by_sign (level_sets, box, indefinite_level_sets,
+                                gradient_bounds))
+          return;
+
+        const std::pair<Point<1>,Point<1> > &corners = box.get_boundary_points();
+        double relative_derivative = 0;
+        const bool monotone =
+          find_height_direction<1> (gradient_bounds,
+                                    additional_data.lower_bound_implicit_function,
+                                    relative_derivative) == 0;
+        add_line_quadrature (level_sets, indefinite_level_sets, corners.first, 0,
+                             corners.first[0], corners.second[0], 1., monotone,
+                             create_surface);
+      }
+    }
+  }
+
+
+
+  template <int dim>
+  QuadratureGenerator<dim>::QuadratureGenerator (const Quadrature<1>             &quadrature_1D,
+                                                 const AdditionalQGeneratorData &additional_data)
+    :
+    q_generator (quadrature_1D, additional_data),
+    location (LocationToLevelSet::unassigned)
+  {}
+
+
+
+  template <int dim>
+  void
+  QuadratureGenerator<dim>::generate (const Function<dim>    &level_set,
+                                      const BoundingBox<dim> &box)
+  {
+    q_generator.clear ();
+    q_generator.generate (std::vector<const Function<dim> *>(1, &level_set),
+                          box, 0, true);
+
+    const internal::QuadratureGeneratorImplementation::QPartitioning<dim> &partitioning =
+      q_generator.q_partitioning;
+    Assert (partitioning.indefinite.points.empty(), ExcInternalError());
+    inside_quadrature = Quadrature<dim> (partitioning.negative.points,
+                                         partitioning.negative.weights);
+    outside_quadrature = Quadrature<dim> (partitioning.positive.points,
+                                          partitioning.positive.weights);
+    surface_quadrature = ImmersedSurfaceQuadrature<dim> (partitioning.surface.points,
+                                                         partitioning.surface.weights,
+                                                         partitioning.surface_normals);
+
+    if (surface_quadrature.size() == 0 && outside_quadrature.size() == 0)
+      location = LocationToLevelSet::inside;
+    else if (surface_quadrature.size() == 0 && inside_quadrature.size() == 0)
+      location = LocationToLevelSet::outside;
+    else
+      location = LocationToLevelSet::intersected;
+  }
+
+
+
+  template <int dim>
+  const Quadrature<dim> &
+  QuadratureGenerator<dim>::get_inside_quadrature () const
+  {
+    return inside_quadrature;
+  }
+
+
+
+  template <int dim>
+  const Quadrature<dim> &
+  QuadratureGenerator<dim>::get_outside_quadrature () const
+  {
+    return outside_quadrature;
+  }
+
+
+
+  template <int dim>
+  const ImmersedSurfaceQuadrature<dim> &
+  QuadratureGenerator<dim>::get_surface_quadrature () const
+  {
+    return surface_quadrature;
+  }
+
+
+
+  template <int dim>
+  LocationToLevelSet
+  QuadratureGenerator<dim>::get_location () const
+  {
+    return location;
+  }
+
+
+
+  namespace
+  {
+    /**
+     * A scalar finite element field on a single cell, evaluated in the
+     * reference coordinates of the cell.
+     */
+    template <int dim>
+    class RefSpaceFEFieldFunction : public Function<dim>
+    {
+    public:
+      RefSpaceFEFieldFunction (const FiniteElement<dim> &fe)
+        :
+        fe (fe),
+        local_dof_values (fe.dofs_per_cell)
+      {}
+
+      virtual double value (const Point<dim>   &point,
+                            const unsigned int  = 0) const
+      {
+        double result = 0;
+        for (unsigned int i=0; i<local_dof_values.size(); ++i)
+          result += local_dof_values(i) * fe.shape_value (i, point);
+        return result;
+      }
+
+      virtual Tensor<1,dim> gradient (const Point<dim>   &point,
+                                      const unsigned int  = 0) const
+      {
+        Tensor<1,dim> result;
+        for (unsigned int i=0; i<local_dof_values.size(); ++i)
+          result += local_dof_values(i) * fe.shape_grad (i, point);
+        return result;
+      }
+
+      virtual SymmetricTensor<2,dim> hessian (const Point<dim>   &point,
+                                              const unsigned int  = 0) const
+      {
+        Tensor<2,dim> result;
+        for (unsigned int i=0; i<local_dof_values.size(); ++i)
+          result += local_dof_values(i) * fe.shape_grad_grad (i, point);
+        return symmetrize (result);
+      }
+
+      const FiniteElement<dim> &fe;
+      Vector<double>            local_dof_values;
+    };
+  }
+
+
+
+  template <int dim>
+  DiscreteQuadratureGenerator<dim>::
+  DiscreteQuadratureGenerator (const Quadrature<1>             &quadrature_1D,
+                               const AdditionalQGeneratorData &additional_data)
+    :
+    quadrature_1D (quadrature_1D),
+    additional_data (additional_data),
+    regular_quadrature (quadrature_1D)
+  {}
+
+
+
+  template <int dim>
+  template <typename VectorType>
+  void
+  DiscreteQuadratureGenerator<dim>::reinit (const DoFHandler<dim> &dof_handler,
+                                            const VectorType      &level_set)
+  {
+    const FiniteElement<dim> &fe = dof_handler.get_fe();
+    AssertThrow (fe.n_components() == 1,
+                 ExcMessage ("The level set function must be described by a "
+                             "scalar finite element."));
+
+    const unsigned int n_active_cells = dof_handler.get_triangulation().n_active_cells();
+    cell_locations.assign (n_active_cells, LocationToLevelSet::unassigned);
+    cut_cell_quadratures.clear ();
+    cut_cell_quadratures.resize (n_active_cells);
+
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> cells;
+    for (typename DoFHandler<dim>::active_cell_iterator cell = dof_handler.begin_active();
+         cell != dof_handler.end(); ++cell)
+      if (cell->is_locally_owned())
+        cells.push_back (cell);
+
+    Point<dim> unit_upper_corner;
+    for (unsigned int d=0; d<dim; ++d)
+      unit_upper_corner[d] = 1.;
+    const BoundingBox<dim> unit_box (std::make_pair (Point<dim>(), unit_upper_corner));
+
+    // every range of cells gets its own generator and function object, and
+    // writes to the entries of its own cells only
+    parallel::apply_to_subranges
+    (0U, static_cast<unsigned int>(cells.size()),
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      QuadratureGenerator<dim> generator (quadrature_1D, additional_data);
+      RefSpaceFEFieldFunction<dim> cell_level_set (fe);
+      Vector<typename VectorType::value_type> local_values (fe.dofs_per_cell);
+      for (unsigned int i=begin; i<end; ++i)
+        {
+          cells[i]->get_dof_values (level_set, local_values);
+          cell_level_set.local_dof_values = local_values;
+          generator.generate (cell_level_set, unit_box);
+
+          const unsigned int index = cells[i]->active_cell_index();
+          cell_locations[index] = generator.get_location();
+          if (cell_locations[index] == LocationToLevelSet::intersected)
+            {
+              cut_cell_quadratures[index].reset (new CutCellQuadratures());
+              cut_cell_quadratures[index]->inside = generator.get_inside_quadrature();
+              cut_cell_quadratures[index]->outside = generator.get_outside_quadrature();
+              cut_cell_quadratures[index]->surface = generator.get_surface_quadrature();
+            }
+        }
+    },
+    16);
+  }
+
+
+
+  template <int dim>
+  const Quadrature<dim> &
+  DiscreteQuadratureGenerator<dim>::get_regular_quadrature () const
+  {
+    return regular_quadrature;
+  }
+
+
+
+  template <int dim>
+  unsigned int
+  DiscreteQuadratureGenerator<dim>::n_intersected_cells () const
+  {
+    return std::count (cell_locations.begin(), cell_locations.end(),
+                       LocationToLevelSet::intersected);
+  }
+
+
+
+  namespace internal
+  {
+    namespace QuadratureGeneratorImplementation
+    {
+      template struct PointsAndWeights<1>;
+      template struct PointsAndWeights<2>;
+      template struct PointsAndWeights<3>;
+      template struct QPartitioning<1>;
+      template struct QPartitioning<2>;
+      template struct QPartitioning<3>;
+      template class QGeneratorBase<1>;
+      template class QGeneratorBase<2>;
+      template class QGeneratorBase<3>;
+      template class QGenerator<2>;
+      template class QGenerator<3>;
+    }
+  }
+
+  template class QuadratureGenerator<1>;
+  template class QuadratureGenerator<2>;
+  template class QuadratureGenerator<3>;
+
+  template class DiscreteQuadratureGenerator<1>;
+  template class DiscreteQuadratureGenerator<2>;
+  template class DiscreteQuadratureGenerator<3>;
+
+}
+
+// explicit instantiations of the member templates
+#include "quadrature_generator.inst"
+
+DEAL_II_NAMESPACE_CLOSE
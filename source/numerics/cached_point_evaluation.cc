@@ -0,0 +1,267 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/numerics/cached_point_evaluation.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/grid_tools_cache.h>
+
+#include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, int spacedim>
+CachedPointEvaluation<dim,spacedim>::
+CachedPointEvaluation (const Mapping<dim,spacedim>        &mapping,
+                       const DoFHandler<dim,spacedim>     &dof_handler,
+                       const std::vector<Point<spacedim> > &points)
+  :
+  dof_handler (&dof_handler),
+  mpi_communicator (MPI_COMM_SELF),
+  n_requested_points (points.size()),
+  dofs_per_cell (dof_handler.get_fe().dofs_per_cell),
+  n_components (dof_handler.get_fe().n_components())
+{
+  const Triangulation<dim,spacedim> &tria = dof_handler.get_triangulation();
+  if (const parallel::Triangulation<dim,spacedim> *parallel_tria =
+        dynamic_cast<const parallel::Triangulation<dim,spacedim> *>(&tria))
+    mpi_communicator = parallel_tria->get_communicator();
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process(mpi_communicator);
+
+  const GridTools::Cache<dim,spacedim> cache(tria, mapping);
+  const auto point_locations =
+    GridTools::distributed_compute_point_locations
+    (cache, points,
+     GridTools::exchange_local_bounding_boxes
+     (GridTools::compute_locally_owned_bounding_boxes(cache), mpi_communicator));
+  const auto &cells = std::get<0>(point_locations);
+  const auto &reference_points = std::get<1>(point_locations);
+  const auto &origin_indices = std::get<2>(point_locations);
+  const auto &origin_ranks = std::get<3>(point_locations);
+
+  // evaluate the shape functions at the points of each cell, with the
+  // points of a cell as the quadrature points of an FEValues object
+  cell_point_ranges.resize(1, 0);
+  dof_indices.resize(cells.size()*dofs_per_cell);
+  std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
+  for (unsigned int c=0; c<cells.size(); ++c)
+    {
+      const typename DoFHandler<dim,spacedim>::active_cell_iterator
+      cell (&tria, cells[c]->level(), cells[c]->index(), &dof_handler);
+      cell->get_dof_indices(local_dof_indices);
+      std::copy(local_dof_indices.begin(), local_dof_indices.end(),
+                dof_indices.begin()+c*dofs_per_cell);
+
+      const unsigned int n_cell_points = reference_points[c].size();
+      FEValues<dim,spacedim> fe_values(mapping, dof_handler.get_fe(),
+                                       Quadrature<dim>(reference_points[c]),
+                                       update_values);
+      fe_values.reinit(cell);
+      const unsigned int offset = cell_point_ranges.back();
+      shape_values.resize((offset+n_cell_points)*dofs_per_cell*n_components);
+      for (unsigned int q=0; q<n_cell_points; ++q)
+        {
+          double *shape = &shape_values[(offset+q)*dofs_per_cell*n_components];
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            for (unsigned int d=0; d<n_components; ++d)
+              shape[i*n_components+d] = fe_values.shape_value_component(i, q, d);
+          send_indices[origin_ranks[c][q]].push_back(offset+q);
+        }
+      cell_point_ranges.push_back(offset+n_cell_points);
+    }
+
+  // tell the processes that asked for the points evaluated here which of
+  // their points are evaluated by which process
+  std::map<unsigned int, std::vector<unsigned int> > evaluated_origin_indices;
+  for (unsigned int c=0; c<cells.size(); ++c)
+    for (unsigned int q=0; q<origin_indices[c].size(); ++q)
+      evaluated_origin_indices[origin_ranks[c][q]].push_back(origin_indices[c][q]);
+
+  const auto own_indices = evaluated_origin_indices.find(my_rank);
+  if (own_indices != evaluated_origin_indices.end())
+    receive_indices[my_rank] = own_indices->second;
+
+#ifdef DEAL_II_WITH_MPI
+  if (Utilities::MPI::n_mpi_processes(mpi_communicator) > 1)
+    {
+      const int mpi_tag = 4202;
+      std::vector<unsigned int> destinations;
+      for (const auto &rank_and_indices : evaluated_origin_indices)
+        if (rank_and_indices.first != my_rank)
+          destinations.push_back(rank_and_indices.first);
+      const std::vector<unsigned int> sources =
+        Utilities::MPI::compute_point_to_point_communication_pattern(mpi_communicator,
+            destinations);
+
+      std::vector<MPI_Request> requests(destinations.size());
+      for (unsigned int i=0; i<destinations.size(); ++i)
+        {
+          std::vector<unsigned int> &send_buffer = evaluated_origin_indices[destinations[i]];
+          const int ierr = MPI_Isend(send_buffer.data(), send_buffer.size(),
+                                     MPI_UNSIGNED, destinations[i], mpi_tag,
+                                     mpi_communicator, &requests[i]);
+          AssertThrowMPI(ierr);
+        }
+
+      for (unsigned int i=0; i<sources.size(); ++i)
+        {
+          MPI_Status status;
+          int ierr = MPI_Probe(MPI_ANY_SOURCE, mpi_tag, mpi_communicator, &status);
+          AssertThrowMPI(ierr);
+          int n_entries;
+          ierr = MPI_Get_count(&status, MPI_UNSIGNED, &n_entries);
+          AssertThrowMPI(ierr);
+          std::vector<unsigned int> &receive_buffer = receive_indices[status.MPI_SOURCE];
+          receive_buffer.resize(n_entries);
+          ierr = MPI_Recv(receive_buffer.data(), n_entries, MPI_UNSIGNED,
+                          status.MPI_SOURCE, mpi_tag, mpi_communicator,
+                          MPI_STATUS_IGNORE);
+          AssertThrowMPI(ierr);
+        }
+
+      if (requests.size() > 0)
+        {
+          const int ierr = MPI_Waitall(requests.size(), requests.data(),
+                                       MPI_STATUSES_IGNORE);
+          AssertThrowMPI(ierr);
+        }
+    }
+#endif
+
+  // keep only the evaluation of the process with the lowest rank for each
+  // point. std::map runs through the ranks in ascending order.
+  std::vector<bool> point_found(n_requested_points, false);
+  for (auto &rank_and_indices : receive_indices)
+    for (unsigned int &index : rank_and_indices.second)
+      {
+        AssertIndexRange(index, n_requested_points);
+        if (point_found[index])
+          index = numbers::invalid_unsigned_int;
+        else
+          point_found[index] = true;
+      }
+
+  for (unsigned int i=0; i<n_requested_points; ++i)
+    AssertThrow(point_found[i],
+                ExcMessage("The point " + Utilities::to_string(i) +
+                           " passed to CachedPointEvaluation does not lie "
+                           "in any locally owned cell of the mesh."));
+}
+
+
+
+template <int dim, int spacedim>
+void
+CachedPointEvaluation<dim,spacedim>::
+communicate_values (const std::vector<double>    &evaluated_values,
+                    std::vector<Vector<double> > &values) const
+{
+  values.resize(n_requested_points);
+  for (unsigned int i=0; i<n_requested_points; ++i)
+    values[i].reinit(n_components, true);
+
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process(mpi_communicator);
+
+  // copy the values of the points requested by this process directly
+  const auto own_send = send_indices.find(my_rank);
+  if (own_send != send_indices.end())
+    {
+      const std::vector<unsigned int> &targets = receive_indices.find(my_rank)->second;
+      AssertDimension(targets.size(), own_send->second.size());
+      for (unsigned int j=0; j<targets.size(); ++j)
+        if (targets[j] != numbers::invalid_unsigned_int)
+          for (unsigned int d=0; d<n_components; ++d)
+            values[targets[j]](d) = evaluated_values[own_send->second[j]*n_components+d];
+    }
+
+#ifdef DEAL_II_WITH_MPI
+  if (Utilities::MPI::n_mpi_processes(mpi_communicator) > 1)
+    {
+      const int mpi_tag = 4203;
+      std::vector<std::vector<double> > send_buffers;
+      std::vector<MPI_Request> requests;
+      send_buffers.reserve(send_indices.size());
+      requests.reserve(send_indices.size());
+      for (const auto &rank_and_indices : send_indices)
+        if (rank_and_indices.first != my_rank)
+          {
+            send_buffers.emplace_back();
+            send_buffers.back().reserve(rank_and_indices.second.size()*n_components);
+            for (const unsigned int q : rank_and_indices.second)
+              for (unsigned int d=0; d<n_components; ++d)
+                send_buffers.back().push_back(evaluated_values[q*n_components+d]);
+
+            requests.emplace_back();
+            const int ierr = MPI_Isend(send_buffers.back().data(),
+                                       send_buffers.back().size(),
+                                       MPI_DOUBLE, rank_and_indices.first, mpi_tag,
+                                       mpi_communicator, &requests.back());
+            AssertThrowMPI(ierr);
+          }
+
+      std::vector<double> receive_buffer;
+      for (const auto &rank_and_indices : receive_indices)
+        if (rank_and_indices.first != my_rank)
+          {
+            const std::vector<unsigned int> &targets = rank_and_indices.second;
+            receive_buffer.resize(targets.size()*n_components);
+            const int ierr = MPI_Recv(receive_buffer.data(), receive_buffer.size(),
+                                      MPI_DOUBLE, rank_and_indices.first, mpi_tag,
+                                      mpi_communicator, MPI_STATUS_IGNORE);
+            AssertThrowMPI(ierr);
+            for (unsigned int j=0; j<targets.size(); ++j)
+              if (targets[j] != numbers::invalid_unsigned_int)
+                for (unsigned int d=0; d<n_components; ++d)
+                  values[targets[j]](d) = receive_buffer[j*n_components+d];
+          }
+
+      if (requests.size() > 0)
+        {
+          const int ierr = MPI_Waitall(requests.size(), requests.data(),
+                                       MPI_STATUSES_IGNORE);
+          AssertThrowMPI(ierr);
+        }
+    }
+#endif
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+CachedPointEvaluation<dim,spacedim>::memory_consumption () const
+{
+  std::size_t memory = (sizeof(*this) +
+                        MemoryConsumption::memory_consumption(dof_indices) +
+                        MemoryConsumption::memory_consumption(cell_point_ranges) +
+                        MemoryConsumption::memory_consumption(shape_values));
+  for (const auto &rank_and_indices : send_indices)
+    memory += MemoryConsumption::memory_consumption(rank_and_indices.second);
+  for (const auto &rank_and_indices : receive_indices)
+    memory += MemoryConsumption::memory_consumption(rank_and_indices.second);
+  return memory;
+}
+
+
+// explicit instantiations
+#include "cached_point_evaluation.inst"
+
+DEAL_II_NAMESPACE_CLOSE
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 1999 - 2016 by the deal.II authors
+// Copyright (C) 1999 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -13,6 +13,7 @@
 //
 // ---------------------------------------------------------------------
 
+#include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/work_stream.h>
 #include <deal.II/numerics/data_out.h>
 #include <deal.II/grid/tria.h>
@@ -22,9 +23,12 @@
 #include <deal.II/grid/tria_iterator.h>
 #include <deal.II/fe/fe.h>
 #include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/hp/fe_values.h>
 #include <deal.II/fe/mapping_q1.h>
+#include <deal.II/matrix_free/shape_info.h>
+#include <deal.II/matrix_free/tensor_product_kernels.h>
 
 #include <sstream>
 
@@ -54,6 +58,91 @@ namespace internal
                                       false),
       cell_to_patch_index_map (&cell_to_patch_index_map)
     {}
+
+
+
+    namespace
+    {
+      /**
+       * Set up the one-dimensional shape information for evaluating a data
+       * vector on the patch points by sum factorization. This is not possible
+       * for surfaces embedded in higher dimensions, so return a null pointer.
+       */
+      template <int dim, int spacedim>
+      std::shared_ptr<const MatrixFreeFunctions::ShapeInfo<double> >
+      create_tensor_product_shape_info (const dealii::hp::FECollection<dim,spacedim> &,
+                                        const unsigned int)
+      {
+        return std::shared_ptr<const MatrixFreeFunctions::ShapeInfo<double> >();
+      }
+
+
+
+      template <int dim>
+      std::shared_ptr<const MatrixFreeFunctions::ShapeInfo<double> >
+      create_tensor_product_shape_info (const dealii::hp::FECollection<dim,dim> &fe_collection,
+                                        const unsigned int                      n_subdivisions)
+      {
+        if (fe_collection.size() != 1)
+          return std::shared_ptr<const MatrixFreeFunctions::ShapeInfo<double> >();
+
+        // only the tensor product elements whose polynomial space is spanned
+        // by full 1D Lagrange polynomials are supported, possibly with
+        // several copies of the same element in an FESystem
+        const FiniteElement<dim> &fe = fe_collection[0];
+        if (fe.n_base_elements() != 1)
+          return std::shared_ptr<const MatrixFreeFunctions::ShapeInfo<double> >();
+        const FiniteElement<dim> &base = fe.base_element(0);
+        if (base.n_components() != 1 || base.has_support_points() == false ||
+            (dynamic_cast<const FE_Q<dim> *>(&base) == nullptr &&
+             dynamic_cast<const FE_DGQ<dim> *>(&base) == nullptr))
+          return std::shared_ptr<const MatrixFreeFunctions::ShapeInfo<double> >();
+
+        std::shared_ptr<MatrixFreeFunctions::ShapeInfo<double> > shape_info
+        (new MatrixFreeFunctions::ShapeInfo<double>());
+        shape_info->reinit (QIterated<1>(QTrapez<1>(), n_subdivisions), fe);
+        return shape_info;
+      }
+
+
+
+      /**
+       * Evaluate the values of a scalar tensor product polynomial given by
+       * the coefficients in lexicographic order on all points of a patch,
+       * using the two arrays @p tmp and @p values of size
+       * max(n_dofs_1d,n_points_1d)^dim as intermediate storage. The result
+       * is placed in @p values.
+       */
+      template <int dim>
+      void
+      evaluate_tensor_product_values (const MatrixFreeFunctions::ShapeInfo<double> &shape_info,
+                                      const double                                 *dof_values,
+                                      double                                       *tmp,
+                                      double                                       *values)
+      {
+        const EvaluatorTensorProduct<evaluate_general,dim,-1,0,double>
+        eval (shape_info.shape_values, shape_info.shape_gradients,
+              shape_info.shape_hessians, shape_info.fe_degree,
+              shape_info.n_q_points_1d);
+        switch (dim)
+          {
+          case 1:
+            eval.template values<0,true,false>(dof_values, values);
+            break;
+          case 2:
+            eval.template values<0,true,false>(dof_values, tmp);
+            eval.template values<1,true,false>(tmp, values);
+            break;
+          case 3:
+            eval.template values<0,true,false>(dof_values, values);
+            eval.template values<1,true,false>(values, tmp);
+            eval.template values<2,true,false>(tmp, values);
+            break;
+          default:
+            Assert (false, ExcNotImplemented());
+          }
+      }
+    }
   }
 }
 
@@ -173,9 +262,14 @@ build_one_patch
                                                                               this->dof_data[dataset]->dof_handler);
                   scratch_data.patch_values_scalar.template set_cell<DoFHandlerType> (dh_cell);
 
-                  postprocessor->
-                  evaluate_scalar_field(scratch_data.patch_values_scalar,
-                                        scratch_data.postprocessed_values[dataset]);
+                  if (postprocessor->uses_block_evaluation())
+                    scratch_data.template evaluate_postprocessor_block<DoFHandlerType>
+                    (*postprocessor, dh_cell, n_components,
+                     this->dof_data[dataset]->n_output_variables);
+                  else
+                    postprocessor->
+                    evaluate_scalar_field(scratch_data.patch_values_scalar,
+                                          scratch_data.postprocessed_values[dataset]);
                 }
               else
                 {
@@ -202,17 +296,73 @@ build_one_patch
                                                                               this->dof_data[dataset]->dof_handler);
                   scratch_data.patch_values_system.template set_cell<DoFHandlerType> (dh_cell);
 
-                  postprocessor->
-                  evaluate_vector_field(scratch_data.patch_values_system,
-                                        scratch_data.postprocessed_values[dataset]);
+                  if (postprocessor->uses_block_evaluation())
+                    scratch_data.template evaluate_postprocessor_block<DoFHandlerType>
+                    (*postprocessor, dh_cell, n_components,
+                     this->dof_data[dataset]->n_output_variables);
+                  else
+                    postprocessor->
+                    evaluate_vector_field(scratch_data.patch_values_system,
+                                          scratch_data.postprocessed_values[dataset]);
                 }
 
-              for (unsigned int q=0; q<n_q_points; ++q)
-                for (unsigned int component=0;
-                     component<this->dof_data[dataset]->n_output_variables;
-                     ++component)
-                  patch.data(offset+component,q)
-                    = scratch_data.postprocessed_values[dataset][q](component);
+              if (postprocessor->uses_block_evaluation())
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  for (unsigned int component=0;
+                       component<this->dof_data[dataset]->n_output_variables;
+                       ++component)
+                    patch.data(offset+component,q)
+                      = scratch_data.postprocessed_block(q,component);
+              else
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  for (unsigned int component=0;
+                       component<this->dof_data[dataset]->n_output_variables;
+                       ++component)
+                    patch.data(offset+component,q)
+                      = scratch_data.postprocessed_values[dataset][q](component);
+            }
+          else if (scratch_data.tensor_product_shape_info[dataset] &&
+                   cell_and_index->first->active())
+            {
+              // the data vector is based on a tensor product element, so we
+              // can evaluate it on the (many) patch points by sum
+              // factorization with the 1D shape functions rather than
+              // summing over all shape functions in all points the way
+              // FEValues does
+              const internal::MatrixFreeFunctions::ShapeInfo<double> &shape_info
+                = *scratch_data.tensor_product_shape_info[dataset];
+              Assert (shape_info.n_q_points == n_q_points, ExcInternalError());
+
+              const typename DoFHandlerType::active_cell_iterator dh_cell(&cell_and_index->first->get_triangulation(),
+                                                                          cell_and_index->first->level(),
+                                                                          cell_and_index->first->index(),
+                                                                          this->dof_data[dataset]->dof_handler);
+              this->dof_data[dataset]->get_dof_values (dh_cell, scratch_data.dof_indices,
+                                                       scratch_data.dof_values);
+
+              const unsigned int dofs_per_component = shape_info.dofs_per_cell;
+              Assert (shape_info.lexicographic_numbering.size() ==
+                      n_components*dofs_per_component, ExcInternalError());
+              const unsigned int buffer_size
+                = Utilities::fixed_power<DoFHandlerType::dimension>
+                  (std::max(shape_info.fe_degree+1, shape_info.n_q_points_1d));
+              std::vector<double> &lexicographic_values = scratch_data.lexicographic_dof_values;
+              lexicographic_values.resize (dofs_per_component);
+              scratch_data.tensor_product_values[0].resize (buffer_size);
+              scratch_data.tensor_product_values[1].resize (buffer_size);
+
+              for (unsigned int component=0; component<n_components; ++component)
+                {
+                  for (unsigned int i=0; i<dofs_per_component; ++i)
+                    lexicographic_values[i] = scratch_data.dof_values
+                                              [shape_info.lexicographic_numbering[component*dofs_per_component+i]];
+                  internal::DataOut::evaluate_tensor_product_values<DoFHandlerType::dimension>
+                  (shape_info, lexicographic_values.data(),
+                   scratch_data.tensor_product_values[0].data(),
+                   scratch_data.tensor_product_values[1].data());
+                  for (unsigned int q=0; q<n_q_points; ++q)
+                    patch.data(offset+component,q) = scratch_data.tensor_product_values[1][q];
+                }
             }
           else
             // now we use the given data vector without modifications. again,
@@ -449,6 +599,20 @@ void DataOut<dim,DoFHandlerType>::build_patches
                update_flags,
                cell_to_patch_index_map);
 
+  // for data vectors without postprocessor and based on tensor product
+  // elements, the values on the patch points can be evaluated much faster by
+  // sum factorization than via FEValues, in particular for many subdivisions
+  thread_data.tensor_product_shape_info.resize (this->dof_data.size());
+  {
+    const std::vector<std::shared_ptr<dealii::hp::FECollection<DoFHandlerType::dimension,
+          DoFHandlerType::space_dimension> > > fes = this->get_fes();
+    for (unsigned int dataset=0; dataset<this->dof_data.size(); ++dataset)
+      if (this->dof_data[dataset]->postprocessor == nullptr)
+        thread_data.tensor_product_shape_info[dataset]
+          = internal::DataOut::create_tensor_product_shape_info (*fes[dataset],
+                                                                 n_subdivisions);
+  }
+
   // now build the patches in parallel
   if (all_cells.size() > 0)
     WorkStream::run (&all_cells[0],
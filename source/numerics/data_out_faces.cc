@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2000 - 2016 by the deal.II authors
+// Copyright (C) 2000 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -175,9 +175,14 @@ build_one_patch (const FaceDescriptor *cell_and_face,
                                                                               this->dof_data[dataset]->dof_handler);
                   data.patch_values_scalar.template set_cell<DoFHandlerType> (dh_cell);
 
-                  postprocessor->
-                  evaluate_scalar_field(data.patch_values_scalar,
-                                        data.postprocessed_values[dataset]);
+                  if (postprocessor->uses_block_evaluation())
+                    data.template evaluate_postprocessor_block<DoFHandlerType>
+                    (*postprocessor, dh_cell, n_components,
+                     this->dof_data[dataset]->n_output_variables);
+                  else
+                    postprocessor->
+                    evaluate_scalar_field(data.patch_values_scalar,
+                                          data.postprocessed_values[dataset]);
                 }
               else
                 {
@@ -206,16 +211,28 @@ build_one_patch (const FaceDescriptor *cell_and_face,
                                                                               this->dof_data[dataset]->dof_handler);
                   data.patch_values_system.template set_cell<DoFHandlerType> (dh_cell);
 
-                  postprocessor->
-                  evaluate_vector_field(data.patch_values_system,
-                                        data.postprocessed_values[dataset]);
+                  if (postprocessor->uses_block_evaluation())
+                    data.template evaluate_postprocessor_block<DoFHandlerType>
+                    (*postprocessor, dh_cell, n_components,
+                     this->dof_data[dataset]->n_output_variables);
+                  else
+                    postprocessor->
+                    evaluate_vector_field(data.patch_values_system,
+                                          data.postprocessed_values[dataset]);
                 }
 
-              for (unsigned int q=0; q<n_q_points; ++q)
-                for (unsigned int component=0;
-                     component<this->dof_data[dataset]->n_output_variables; ++component)
-                  patch.data(offset+component,q)
-                    = data.postprocessed_values[dataset][q](component);
+              if (postprocessor->uses_block_evaluation())
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  for (unsigned int component=0;
+                       component<this->dof_data[dataset]->n_output_variables; ++component)
+                    patch.data(offset+component,q)
+                      = data.postprocessed_block(q,component);
+              else
+                for (unsigned int q=0; q<n_q_points; ++q)
+                  for (unsigned int component=0;
+                       component<this->dof_data[dataset]->n_output_variables; ++component)
+                    patch.data(offset+component,q)
+                      = data.postprocessed_values[dataset][q](component);
             }
           else
             // now we use the given data vector without modifications. again,
@@ -221,9 +221,14 @@ build_one_patch (const cell_iterator
                                                                                   this->dof_data[dataset]->dof_handler);
                       data.patch_values_scalar.template set_cell<DoFHandlerType> (dh_cell);
 
-                      postprocessor->
-                      evaluate_scalar_field(data.patch_values_scalar,
-                                            data.postprocessed_values[dataset]);
+                      if (postprocessor->uses_block_evaluation())
+                        data.template evaluate_postprocessor_block<DoFHandlerType>
+                        (*postprocessor, dh_cell, n_components,
+                         this->dof_data[dataset]->n_output_variables);
+                      else
+                        postprocessor->
+                        evaluate_scalar_field(data.patch_values_scalar,
+                                              data.postprocessed_values[dataset]);
                     }
                   else
                     {
@@ -250,11 +255,26 @@ build_one_patch (const cell_iterator
                                                                                   this->dof_data[dataset]->dof_handler);
                       data.patch_values_system.template set_cell<DoFHandlerType> (dh_cell);
 
-                      postprocessor->
-                      evaluate_vector_field(data.patch_values_system,
-                                            data.postprocessed_values[dataset]);
+                      if (postprocessor->uses_block_evaluation())
+                        data.template evaluate_postprocessor_block<DoFHandlerType>
+                        (*postprocessor, dh_cell, n_components,
+                         this->dof_data[dataset]->n_output_variables);
+                      else
+                        postprocessor->
+                        evaluate_vector_field(data.patch_values_system,
+                                              data.postprocessed_values[dataset]);
                     }
 
+                  // the block interface writes into a table, so copy its
+                  // result to where the loop below expects it
+                  if (postprocessor->uses_block_evaluation())
+                    for (unsigned int q=0; q<data.postprocessed_block.size(0); ++q)
+                      for (unsigned int component=0;
+                           component<this->dof_data[dataset]->n_output_variables;
+                           ++component)
+                        data.postprocessed_values[dataset][q](component)
+                          = data.postprocessed_block(q,component);
+
                   for (unsigned int component=0;
                        component<this->dof_data[dataset]->n_output_variables;
                        ++component)
@@ -1,6 +1,6 @@
 // ---------------------------------------------------------------------
 //
-// Copyright (C) 2007 - 2016 by the deal.II authors
+// Copyright (C) 2007 - 2017 by the deal.II authors
 //
 // This file is part of the deal.II library.
 //
@@ -43,6 +43,26 @@ evaluate_vector_field (const DataPostprocessorInputs::Vector<dim> &,
 
 
 
+template <int dim>
+bool
+DataPostprocessor<dim>::uses_block_evaluation () const
+{
+  return false;
+}
+
+
+
+template <int dim>
+void
+DataPostprocessor<dim>::
+evaluate_field_block (const DataPostprocessorInputs::Block<dim> &,
+                      Table<2,double> &) const
+{
+  AssertThrow(false,ExcPureFunctionCalled());
+}
+
+
+
 template <int dim>
 std::vector<DataComponentInterpretation::DataComponentInterpretation>
 DataPostprocessor<dim>::get_data_component_interpretation () const
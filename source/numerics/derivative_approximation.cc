@@ -726,13 +726,41 @@ namespace DerivativeApproximation
   }
 }
 
-// Dummy structures and dummy function used for WorkStream
+// Data structures used for WorkStream
 namespace DerivativeApproximation
 {
   namespace internal
   {
     namespace Assembler
     {
+      /**
+       * Scratch data holding the FEValues object used to evaluate the
+       * solution on the cells, so that it is set up only once per thread
+       * rather than once per cell.
+       */
+      template <int dim>
+      struct ScratchData
+      {
+        ScratchData (const hp::MappingCollection<dim> &mapping_collection,
+                 const hp::FECollection<dim>      &fe_collection,
+                 const hp::QCollection<dim>       &q_collection,
+                 const UpdateFlags                 update_flags)
+          :
+          fe_values (mapping_collection, fe_collection, q_collection,
+                     update_flags)
+        {}
+
+        ScratchData (const ScratchData &scratch)
+          :
+          fe_values (scratch.fe_values.get_mapping_collection(),
+                     scratch.fe_values.get_fe_collection(),
+                     scratch.fe_values.get_quadrature_collection(),
+                     scratch.fe_values.get_update_flags())
+        {}
+
+        hp::FEValues<dim> fe_values;
+      };
+
       struct Scratch
       {
         Scratch() = default;
@@ -754,48 +782,49 @@ namespace DerivativeApproximation
   namespace internal
   {
     /**
-    * Compute the derivative approximation on one cell. This computes the full
-    * derivative tensor.
-    */
-    template <class DerivativeDescription, int dim, template <int, int> class DoFHandlerType,
-              class InputVector, int spacedim>
-    void
-    approximate_cell (const Mapping<dim,spacedim>        &mapping,
-                      const DoFHandlerType<dim,spacedim> &dof_handler,
-                      const InputVector                  &solution,
-                      const unsigned int                  component,
-                      const TriaActiveIterator<dealii::DoFCellAccessor<DoFHandlerType<dim, spacedim>,
-                      false> >  &cell,
-                      typename DerivativeDescription::Derivative    &derivative)
+     * Evaluate the projected derivative of the solution at the center of the
+     * cell the FEValues object of @p fe_values was last reinitialized with,
+     * and return it together with the location of the center.
+     */
+    template <class DerivativeDescription, int dim, class InputVector>
+    std::pair<Point<dim>,typename DerivativeDescription::ProjectedDerivative>
+    get_midpoint_value (const hp::FEValues<dim> &fe_values,
+                        const InputVector       &solution,
+                        const unsigned int       component)
     {
-      QMidpoint<dim> midpoint_rule;
+      const FEValues<dim> &fe_midpoint_value = fe_values.get_present_fe_values();
+      return std::make_pair (fe_midpoint_value.quadrature_point(0),
+                             typename DerivativeDescription::ProjectedDerivative
+                             (DerivativeDescription::get_projected_derivative
+                              (fe_midpoint_value, solution, component)));
+    }
 
-      // create collection objects from
-      // single quadratures, mappings,
-      // and finite elements. if we have
-      // an hp DoFHandler,
-      // dof_handler.get_fe() returns a
-      // collection of which we do a
-      // shallow copy instead
-      const hp::QCollection<dim>       q_collection (midpoint_rule);
-      const hp::FECollection<dim>     &fe_collection = dof_handler.get_fe_collection();
-      const hp::MappingCollection<dim> mapping_collection (mapping);
 
-      hp::FEValues<dim> x_fe_midpoint_value (mapping_collection, fe_collection,
-                                             q_collection,
-                                             DerivativeDescription::update_flags |
-                                             update_quadrature_points);
+
+    /**
+     * Compute the derivative approximation on one cell from the values of
+     * the projected derivative at the centers of the cell and its neighbors.
+     * The function object @p get_cell_value returns the center of a given
+     * cell and the value there, either from a cache or by evaluating the
+     * solution.
+     */
+    template <class DerivativeDescription, int dim, class MeshType,
+              typename CellValueFunction>
+    void
+    approximate_cell_from_values (const typename MeshType::active_cell_iterator &cell,
+                                  const CellValueFunction                       &get_cell_value,
+                                  typename DerivativeDescription::Derivative    &derivative)
+    {
+      typedef typename MeshType::active_cell_iterator CellIterator;
 
       // matrix Y=sum_i y_i y_i^T
       Tensor<2,dim> Y;
 
-
       // vector to hold iterators to all
       // active neighbors of a cell
       // reserve the maximal number of
       // active neighbors
-      std::vector<TriaActiveIterator<dealii::DoFCellAccessor<DoFHandlerType<dim, spacedim>,
-          false> > > active_neighbors;
+      std::vector<CellIterator> active_neighbors;
 
       active_neighbors.reserve (GeometryInfo<dim>::faces_per_cell *
                                 GeometryInfo<dim>::max_children_per_face);
@@ -806,20 +835,14 @@ namespace DerivativeApproximation
       // derivatives
       typename DerivativeDescription::Derivative projected_derivative;
 
-      // reinit fe values object...
-      x_fe_midpoint_value.reinit (cell);
-      const FEValues<dim> &fe_midpoint_value
-        = x_fe_midpoint_value.get_present_fe_values();
-
-      // ...and get the value of the
-      // projected derivative...
+      // get the value of the projected
+      // derivative and the place where
+      // it lives
+      const std::pair<Point<dim>,typename DerivativeDescription::ProjectedDerivative>
+      this_value = get_cell_value (cell);
+      const Point<dim> this_center = this_value.first;
       const typename DerivativeDescription::ProjectedDerivative
-      this_midpoint_value
-        = DerivativeDescription::get_projected_derivative (fe_midpoint_value,
-                                                           solution,
-                                                           component);
-      // ...and the place where it lives
-      const Point<dim> this_center = fe_midpoint_value.quadrature_point(0);
+      this_midpoint_value = this_value.second;
 
       // loop over all neighbors and
       // accumulate the difference
@@ -833,35 +856,20 @@ namespace DerivativeApproximation
       // first collect all neighbor
       // cells in a vector, and then
       // collect the data from them
-      GridTools::get_active_neighbors<DoFHandlerType<dim,spacedim> >(cell, active_neighbors);
+      GridTools::get_active_neighbors<MeshType> (cell, active_neighbors);
 
       // now loop over all active
       // neighbors and collect the
       // data we need
-      typename std::vector<TriaActiveIterator<dealii::DoFCellAccessor<DoFHandlerType<dim, spacedim>,
-               false> > >::const_iterator
-               neighbor_ptr = active_neighbors.begin();
-      for (; neighbor_ptr!=active_neighbors.end(); ++neighbor_ptr)
+      for (typename std::vector<CellIterator>::const_iterator
+           neighbor_ptr = active_neighbors.begin();
+           neighbor_ptr!=active_neighbors.end(); ++neighbor_ptr)
         {
-          const TriaActiveIterator < dealii::DoFCellAccessor < DoFHandlerType < dim, spacedim >, false > >
-          neighbor = *neighbor_ptr;
-
-          // reinit fe values object...
-          x_fe_midpoint_value.reinit (neighbor);
-          const FEValues<dim> &neighbor_fe_midpoint_value
-            = x_fe_midpoint_value.get_present_fe_values();
-
-          // ...and get the value of the
-          // solution...
+          const std::pair<Point<dim>,typename DerivativeDescription::ProjectedDerivative>
+          neighbor_value = get_cell_value (*neighbor_ptr);
+          const Point<dim> neighbor_center = neighbor_value.first;
           const typename DerivativeDescription::ProjectedDerivative
-          neighbor_midpoint_value
-            = DerivativeDescription::get_projected_derivative (neighbor_fe_midpoint_value,
-                                                               solution, component);
-
-          // ...and the place where it lives
-          const Point<dim>
-          neighbor_center = neighbor_fe_midpoint_value.quadrature_point(0);
-
+          neighbor_midpoint_value = neighbor_value.second;
 
           // vector for the
           // normalized
@@ -922,31 +930,167 @@ namespace DerivativeApproximation
 
 
 
+    /**
+    * Compute the derivative approximation on one cell. This computes the full
+    * derivative tensor.
+    */
+    template <class DerivativeDescription, int dim, template <int, int> class DoFHandlerType,
+              class InputVector, int spacedim>
+    void
+    approximate_cell (const Mapping<dim,spacedim>        &mapping,
+                      const DoFHandlerType<dim,spacedim> &dof_handler,
+                      const InputVector                  &solution,
+                      const unsigned int                  component,
+                      const TriaActiveIterator<dealii::DoFCellAccessor<DoFHandlerType<dim, spacedim>,
+                      false> >  &cell,
+                      typename DerivativeDescription::Derivative    &derivative)
+    {
+      QMidpoint<dim> midpoint_rule;
+
+      // create collection objects from
+      // single quadratures, mappings,
+      // and finite elements. if we have
+      // an hp DoFHandler,
+      // dof_handler.get_fe() returns a
+      // collection of which we do a
+      // shallow copy instead
+      const hp::QCollection<dim>       q_collection (midpoint_rule);
+      const hp::FECollection<dim>     &fe_collection = dof_handler.get_fe_collection();
+      const hp::MappingCollection<dim> mapping_collection (mapping);
+
+      hp::FEValues<dim> x_fe_midpoint_value (mapping_collection, fe_collection,
+                                             q_collection,
+                                             DerivativeDescription::update_flags |
+                                             update_quadrature_points);
+
+      typedef TriaActiveIterator<dealii::DoFCellAccessor<DoFHandlerType<dim, spacedim>,
+              false> > CellIterator;
+
+      // only the present cell and its
+      // neighbors are needed, so
+      // evaluate the solution on the
+      // fly
+      approximate_cell_from_values<DerivativeDescription,dim,DoFHandlerType<dim,spacedim> >
+      (cell,
+       [&](const CellIterator &c)
+      {
+        x_fe_midpoint_value.reinit (c);
+        return get_midpoint_value<DerivativeDescription> (x_fe_midpoint_value,
+                                                          solution, component);
+      },
+      derivative);
+    }
+
+
+
+    /**
+     * Evaluate the projected derivative at the center of a given cell and
+     * store it together with the center in @p cell_values at the position
+     * given by the active cell index. This is done for all cells except the
+     * artificial ones, since the locally owned cells need the values on
+     * their ghost neighbors.
+     */
+    template <class DerivativeDescription, int dim,
+              template <int, int> class DoFHandlerType, class InputVector, int spacedim>
+    void
+    evaluate_midpoint_value
+    (const TriaActiveIterator<dealii::DoFCellAccessor<DoFHandlerType<dim, spacedim>, false> > &cell,
+     Assembler::ScratchData<dim>                                                                   &scratch,
+     Assembler::CopyData &,
+     const InputVector                                                                         &solution,
+     const unsigned int                                                                         component,
+     std::vector<std::pair<Point<dim>,typename DerivativeDescription::ProjectedDerivative> >    &cell_values)
+    {
+      if (cell->is_artificial() == false)
+        {
+          scratch.fe_values.reinit (cell);
+          cell_values[cell->active_cell_index()]
+            = get_midpoint_value<DerivativeDescription> (scratch.fe_values,
+                                                         solution, component);
+        }
+    }
+
+
+
+    /**
+     * Evaluate the projected derivative at the centers of all cells that are
+     * not artificial, running in parallel on several threads. Each cell is
+     * visited only once, rather than once for itself and once for each of its
+     * neighbors as when calling approximate_cell() on every cell.
+     */
+    template <class DerivativeDescription, int dim,
+              template <int, int> class DoFHandlerType, class InputVector, int spacedim>
+    void
+    compute_midpoint_values
+    (const Mapping<dim,spacedim>                                                           &mapping,
+     const DoFHandlerType<dim,spacedim>                                                    &dof_handler,
+     const InputVector                                                                     &solution,
+     const unsigned int                                                                     component,
+     std::vector<std::pair<Point<dim>,typename DerivativeDescription::ProjectedDerivative> > &cell_values)
+    {
+      const QMidpoint<dim>             midpoint_rule;
+      const hp::QCollection<dim>       q_collection (midpoint_rule);
+      const hp::MappingCollection<dim> mapping_collection (mapping);
+
+      cell_values.resize (dof_handler.get_triangulation().n_active_cells());
+
+      typedef TriaActiveIterator<dealii::DoFCellAccessor
+      <DoFHandlerType<dim, spacedim>, false> > CellIterator;
+
+      // There is no need for a copier because every cell writes to its own
+      // entry of cell_values
+      WorkStream::run(CellIterator(dof_handler.begin_active()),
+                      CellIterator(dof_handler.end()),
+                      static_cast<std::function<void (CellIterator const &,
+                                                      Assembler::ScratchData<dim> &, Assembler::CopyData &)> >
+                      (std::bind(&evaluate_midpoint_value<DerivativeDescription,dim,DoFHandlerType,
+                                 InputVector,spacedim>,
+                                 std::placeholders::_1,
+                                 std::placeholders::_2,
+                                 std::placeholders::_3,
+                                 std::cref(solution),component,
+                                 std::ref(cell_values))),
+                      std::function<void (internal::Assembler::CopyData const &)> (),
+                      Assembler::ScratchData<dim> (mapping_collection,
+                                               dof_handler.get_fe_collection(),
+                                               q_collection,
+                                               DerivativeDescription::update_flags |
+                                               update_quadrature_points),
+                      internal::Assembler::CopyData ());
+    }
+
+
+
     /**
      * Compute the derivative approximation on a given cell.  Fill the @p
      * derivative_norm vector with the norm of the computed derivative tensors
      * on the cell.
      */
     template <class DerivativeDescription, int dim,
-              template <int, int> class DoFHandlerType, class InputVector, int spacedim>
+              template <int, int> class DoFHandlerType, int spacedim>
     void
     approximate
     (SynchronousIterators<std::tuple<TriaActiveIterator < dealii::DoFCellAccessor < DoFHandlerType < dim, spacedim >, false > >, Vector<float>::iterator> > const &cell,
-     const Mapping<dim,spacedim>        &mapping,
-     const DoFHandlerType<dim,spacedim> &dof_handler,
-     const InputVector                  &solution,
-     const unsigned int                  component)
+     const std::vector<std::pair<Point<dim>,typename DerivativeDescription::ProjectedDerivative> > &cell_values)
     {
       // if the cell is not locally owned, then there is nothing to do
       if (std::get<0>(*cell)->is_locally_owned() == false)
         *std::get<1>(*cell) = 0;
       else
         {
+          typedef TriaActiveIterator<dealii::DoFCellAccessor
+          <DoFHandlerType<dim, spacedim>, false> > CellIterator;
+
           typename DerivativeDescription::Derivative derivative;
           // call the function doing the actual
           // work on this cell
-          approximate_cell<DerivativeDescription,dim,DoFHandlerType,InputVector, spacedim>
-          (mapping,dof_handler,solution,component,std::get<0>(*cell),derivative);
+          approximate_cell_from_values<DerivativeDescription,dim,DoFHandlerType<dim,spacedim> >
+          (std::get<0>(*cell),
+           [&](const CellIterator &c)
+          {
+            return cell_values[c->active_cell_index()];
+          },
+          derivative);
 
           // evaluate the norm and fill the vector
           //*derivative_norm_on_this_cell
@@ -962,6 +1106,9 @@ namespace DerivativeApproximation
      * threads and doing some administration that is independent of the actual
      * derivative to be computed.
      *
+     * The values at the cell centers are computed once for all cells first,
+     * and then combined on each cell with the values of its neighbors.
+     *
      * The @p component argument denotes which component of the solution vector
      * we are to work on.
      */
@@ -980,6 +1127,11 @@ namespace DerivativeApproximation
       Assert (component < dof_handler.get_fe(0).n_components(),
               ExcIndexRange (component, 0, dof_handler.get_fe(0).n_components()));
 
+      std::vector<std::pair<Point<dim>,typename DerivativeDescription::ProjectedDerivative> >
+      cell_values;
+      compute_midpoint_values<DerivativeDescription> (mapping, dof_handler, solution,
+                                                      component, cell_values);
+
       typedef std::tuple<TriaActiveIterator<dealii::DoFCellAccessor
       <DoFHandlerType<dim, spacedim>, false> >,
       Vector<float>::iterator> Iterators;
@@ -995,15 +1147,155 @@ namespace DerivativeApproximation
                       static_cast<std::function<void (SynchronousIterators<Iterators> const &,
                                                       Assembler::Scratch const &, Assembler::CopyData &)> >
                       (std::bind(&approximate<DerivativeDescription,dim,DoFHandlerType,
-                                 InputVector,spacedim>,
+                                 spacedim>,
                                  std::placeholders::_1,
-                                 std::cref(mapping),
-                                 std::cref(dof_handler),
-                                 std::cref(solution),component)),
+                                 std::cref(cell_values))),
                       std::function<void (internal::Assembler::CopyData const &)> (),
                       internal::Assembler::Scratch (),internal::Assembler::CopyData ());
     }
 
+
+
+    /**
+     * Compute the gradient recovered on the patch of a given cell and the
+     * norm of its difference to the gradient of the finite element solution
+     * on the cell, see the documentation of
+     * DerivativeApproximation::estimate_recovered_gradient_error().
+     */
+    template <int dim, template <int, int> class DoFHandlerType, class InputVector, int spacedim>
+    void
+    estimate_recovery_cell
+    (SynchronousIterators<std::tuple<TriaActiveIterator < dealii::DoFCellAccessor < DoFHandlerType < dim, spacedim >, false > >, Vector<float>::iterator> > const &cell_and_error,
+     Assembler::ScratchData<dim>                                                        &scratch,
+     Assembler::CopyData &,
+     const InputVector                                                              &solution,
+     const unsigned int                                                              component,
+     const std::vector<std::pair<Point<dim>,typename SecondDerivative<dim>::ProjectedDerivative> > &cell_gradients)
+    {
+      typedef TriaActiveIterator<dealii::DoFCellAccessor
+      <DoFHandlerType<dim, spacedim>, false> > CellIterator;
+      const CellIterator &cell = std::get<0>(*cell_and_error);
+
+      if (cell->is_locally_owned() == false)
+        {
+          *std::get<1>(*cell_and_error) = 0;
+          return;
+        }
+
+      std::vector<CellIterator> patch;
+      patch.reserve (GeometryInfo<dim>::faces_per_cell *
+                     GeometryInfo<dim>::max_children_per_face + 1);
+      GridTools::get_active_neighbors<DoFHandlerType<dim,spacedim> > (cell, patch);
+      patch.push_back (cell);
+
+      // fit the linear function g(x) = a + (x-x_K) B to the gradients g_i at
+      // the centers x_i of the cells of the patch in the least squares
+      // sense. with y_i = x_i-x_K, eliminating a from the normal equations
+      // leaves the system C B = M with the covariance C of the y_i
+      const Point<dim> this_center = cell_gradients[cell->active_cell_index()].first;
+      const double n_points = patch.size();
+      Tensor<1,dim> sum_y, sum_g;
+      Tensor<2,dim> sum_yy, sum_yg;
+      for (unsigned int i=0; i<patch.size(); ++i)
+        {
+          const std::pair<Point<dim>,Tensor<1,dim> > &value
+            = cell_gradients[patch[i]->active_cell_index()];
+          const Tensor<1,dim> y = value.first - this_center;
+          sum_y += y;
+          sum_g += value.second;
+          sum_yy += outer_product(y, y);
+          sum_yg += outer_product(y, value.second);
+        }
+      const Tensor<2,dim> covariance = sum_yy - outer_product(sum_y, sum_y) / n_points;
+      AssertThrow (determinant(covariance) != 0,
+                   ExcInsufficientDirections());
+      const Tensor<2,dim> B = invert(covariance) *
+                              (sum_yg - outer_product(sum_y, sum_g) / n_points);
+      const Tensor<1,dim> a = (sum_g - sum_y * B) / n_points;
+
+      // integrate the difference between the recovered gradient and the
+      // gradient of the solution over the cell
+      scratch.fe_values.reinit (cell);
+      const FEValues<dim> &fe_values = scratch.fe_values.get_present_fe_values();
+      const unsigned int n_q_points = fe_values.n_quadrature_points;
+      const unsigned int n_components = fe_values.get_fe().n_components();
+      std::vector<std::vector<Tensor<1,dim,typename InputVector::value_type> > > gradients
+      (n_q_points, std::vector<Tensor<1,dim,typename InputVector::value_type> >(n_components));
+      fe_values.get_function_gradients (solution, gradients);
+
+      double error = 0;
+      for (unsigned int q=0; q<n_q_points; ++q)
+        {
+          const Tensor<1,dim> recovered_gradient
+            = a + (fe_values.quadrature_point(q) - this_center) * B;
+          error += (recovered_gradient -
+                    Tensor<1,dim>(gradients[q][component])).norm_square() *
+                   fe_values.JxW(q);
+        }
+      *std::get<1>(*cell_and_error) = std::sqrt(error);
+    }
+
+
+
+    /**
+     * Main function of the gradient recovery error estimator, see the
+     * documentation of DerivativeApproximation::estimate_recovered_gradient_error().
+     */
+    template <int dim, template <int, int> class DoFHandlerType, class InputVector, int spacedim>
+    void
+    estimate_recovered_gradient_error (const Mapping<dim,spacedim>        &mapping,
+                                       const DoFHandlerType<dim,spacedim> &dof_handler,
+                                       const InputVector                  &solution,
+                                       const unsigned int                  component,
+                                       Vector<float>                      &error_per_cell)
+    {
+      Assert (error_per_cell.size() == dof_handler.get_triangulation().n_active_cells(),
+              ExcVectorLengthVsNActiveCells (error_per_cell.size(),
+                                             dof_handler.get_triangulation().n_active_cells()));
+      Assert (component < dof_handler.get_fe(0).n_components(),
+              ExcIndexRange (component, 0, dof_handler.get_fe(0).n_components()));
+
+      // the gradients at the cell centers are the projected derivatives of
+      // the second derivative approximation
+      std::vector<std::pair<Point<dim>,typename SecondDerivative<dim>::ProjectedDerivative> >
+      cell_gradients;
+      compute_midpoint_values<SecondDerivative<dim> > (mapping, dof_handler, solution,
+                                                       component, cell_gradients);
+
+      const hp::FECollection<dim> &fe_collection = dof_handler.get_fe_collection();
+      unsigned int max_degree = 0;
+      for (unsigned int i=0; i<fe_collection.size(); ++i)
+        max_degree = std::max (max_degree, fe_collection[i].degree);
+      const hp::QCollection<dim>       q_collection (QGauss<dim>(max_degree+1));
+      const hp::MappingCollection<dim> mapping_collection (mapping);
+
+      typedef std::tuple<TriaActiveIterator<dealii::DoFCellAccessor
+      <DoFHandlerType<dim, spacedim>, false> >,
+      Vector<float>::iterator> Iterators;
+      SynchronousIterators<Iterators> begin(Iterators(dof_handler.begin_active(),
+                                                      error_per_cell.begin())),
+                                                                            end(Iterators(dof_handler.end(),
+                                                                                error_per_cell.end()));
+
+      WorkStream::run(begin,
+                      end,
+                      static_cast<std::function<void (SynchronousIterators<Iterators> const &,
+                                                      Assembler::ScratchData<dim> &, Assembler::CopyData &)> >
+                      (std::bind(&estimate_recovery_cell<dim,DoFHandlerType,InputVector,spacedim>,
+                                 std::placeholders::_1,
+                                 std::placeholders::_2,
+                                 std::placeholders::_3,
+                                 std::cref(solution),component,
+                                 std::cref(cell_gradients))),
+                      std::function<void (internal::Assembler::CopyData const &)> (),
+                      Assembler::ScratchData<dim> (mapping_collection, fe_collection,
+                                               q_collection,
+                                               update_gradients |
+                                               update_quadrature_points |
+                                               update_JxW_values),
+                      internal::Assembler::CopyData ());
+    }
+
   } // namespace internal
 
 } // namespace DerivativeApproximation
@@ -1075,6 +1367,37 @@ namespace DerivativeApproximation
   }
 
 
+  template <int dim, template <int, int> class DoFHandlerType, class InputVector, int spacedim>
+  void
+  estimate_recovered_gradient_error (const Mapping<dim,spacedim>        &mapping,
+                                     const DoFHandlerType<dim,spacedim> &dof_handler,
+                                     const InputVector                  &solution,
+                                     Vector<float>                      &error_per_cell,
+                                     const unsigned int                  component)
+  {
+    internal::estimate_recovered_gradient_error (mapping,
+                                                 dof_handler,
+                                                 solution,
+                                                 component,
+                                                 error_per_cell);
+  }
+
+
+  template <int dim, template <int, int> class DoFHandlerType, class InputVector, int spacedim>
+  void
+  estimate_recovered_gradient_error (const DoFHandlerType<dim,spacedim> &dof_handler,
+                                     const InputVector                  &solution,
+                                     Vector<float>                      &error_per_cell,
+                                     const unsigned int                  component)
+  {
+    internal::estimate_recovered_gradient_error (StaticMappingQ1<dim>::mapping,
+                                                 dof_handler,
+                                                 solution,
+                                                 component,
+                                                 error_per_cell);
+  }
+
+
   template <typename DoFHandlerType, class InputVector, int order>
   void
   approximate_derivative_tensor
@@ -3,6 +3,10 @@
 #ifdef DEAL_II_WITH_NANOFLANN
 
 #include<deal.II/base/std_cxx14/memory.h>
+#include <deal.II/base/parallel.h>
+
+#include <algorithm>
+#include <limits>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -78,6 +82,148 @@ void KDTree<dim>::set_points(const std::vector<Point<dim> > &pts)
 }
 
 
+template <int dim>
+std::vector<std::vector<std::pair<unsigned int, double> > >
+KDTree<dim>::get_points_within_ball(const std::vector<Point<dim> > &targets,
+                                    const double &radius,
+                                    const bool sorted) const
+{
+  Assert(adaptor, ExcNotInitialized());
+  Assert(kdtree, ExcInternalError());
+
+  // the queries of nanoflann only read from the tree, so they can run
+  // concurrently
+  std::vector<std::vector<std::pair<unsigned int, double> > > matches(targets.size());
+  parallel::apply_to_subranges
+  (0U, static_cast<unsigned int>(targets.size()),
+   [&](const unsigned int begin, const unsigned int end)
+  {
+    for (unsigned int i=begin; i<end; ++i)
+      matches[i] = get_points_within_ball(targets[i], radius, sorted);
+  },
+  32);
+
+  return matches;
+}
+
+
+
+template <int dim>
+std::vector<std::vector<std::pair<unsigned int, double> > >
+KDTree<dim>::get_closest_points(const std::vector<Point<dim> > &targets,
+                                const unsigned int n_points) const
+{
+  Assert(adaptor, ExcNotInitialized());
+  Assert(kdtree, ExcInternalError());
+
+  std::vector<std::vector<std::pair<unsigned int, double> > > matches(targets.size());
+  parallel::apply_to_subranges
+  (0U, static_cast<unsigned int>(targets.size()),
+   [&](const unsigned int begin, const unsigned int end)
+  {
+    for (unsigned int i=begin; i<end; ++i)
+      matches[i] = get_closest_points(targets[i], n_points);
+  },
+  32);
+
+  return matches;
+}
+
+
+
+template <int dim>
+void KDTree<dim>::update_points(const std::vector<Point<dim> > &pts)
+{
+  // a tree built for a different vector of points refers to the wrong
+  // data, so build a new one
+  if (!adaptor || &adaptor->points != &pts ||
+      kdtree->refit(pts) == false)
+    set_points(pts);
+}
+
+
+
+template <int dim>
+KDTree<dim>::NanoFlannKDTree::NanoFlannKDTree
+(const int                                        dimension,
+ const PointCloudAdaptor                         &adaptor,
+ const nanoflann::KDTreeSingleIndexAdaptorParams &params)
+  :
+  BaseType(dimension, adaptor, params)
+{}
+
+
+
+template <int dim>
+bool KDTree<dim>::NanoFlannKDTree::refit(const std::vector<Point<dim> > &points)
+{
+  // the indices stored in the leaves refer to the points at the time the
+  // tree was built
+  if (this->root_node == nullptr || this->vind.size() != points.size())
+    return false;
+
+  std::array<std::pair<double,double>,dim> box;
+  const bool success = refit_node(this->root_node, points, box);
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      this->root_bbox[d].low = box[d].first;
+      this->root_bbox[d].high = box[d].second;
+    }
+  return success;
+}
+
+
+
+template <int dim>
+bool
+KDTree<dim>::NanoFlannKDTree::refit_node(typename BaseType::Node                  *node,
+                                         const std::vector<Point<dim> >           &points,
+                                         std::array<std::pair<double,double>,dim> &box)
+{
+  // leaves hold a range of the permuted point indices, in the same way as
+  // the tree is built by nanoflann
+  if (node->child1 == nullptr && node->child2 == nullptr)
+    {
+      for (unsigned int d=0; d<dim; ++d)
+        box[d] = std::make_pair(std::numeric_limits<double>::max(),
+                                -std::numeric_limits<double>::max());
+      for (unsigned int i=node->node_type.lr.left; i<node->node_type.lr.right; ++i)
+        {
+          const Point<dim> &p = points[this->vind[i]];
+          for (unsigned int d=0; d<dim; ++d)
+            {
+              box[d].first = std::min(box[d].first, p[d]);
+              box[d].second = std::max(box[d].second, p[d]);
+            }
+        }
+      return true;
+    }
+
+  // the search of nanoflann relies on all points of the first child being
+  // at most at divlow and all points of the second one at least at divhigh
+  // in the split direction. if the two ranges overlap, the moved points
+  // are not separated by the split anymore. continue the refit anyway to
+  // keep the tree in a consistent state, it is rebuilt afterwards
+  std::array<std::pair<double,double>,dim> box2;
+  bool success = refit_node(node->child1, points, box);
+  success = refit_node(node->child2, points, box2) && success;
+
+  const int direction = node->node_type.sub.divfeat;
+  node->node_type.sub.divlow = box[direction].second;
+  node->node_type.sub.divhigh = box2[direction].first;
+  if (node->node_type.sub.divlow > node->node_type.sub.divhigh)
+    success = false;
+
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      box[d].first = std::min(box[d].first, box2[d].first);
+      box[d].second = std::max(box[d].second, box2[d].second);
+    }
+  return success;
+}
+
+
+
 template class KDTree<1>;
 template class KDTree<2>;
 template class KDTree<3>;
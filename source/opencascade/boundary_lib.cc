@@ -18,6 +18,8 @@
 
 #ifdef DEAL_II_WITH_OPENCASCADE
 
+#include <deal.II/base/parallel.h>
+
 DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 
 #include <GCPnts_AbscissaPoint.hxx>
@@ -75,6 +77,40 @@ namespace OpenCASCADE
       Handle_Adaptor3d_HCurve adapt = curve_adaptor(sh);
       return GCPnts_AbscissaPoint::Length(adapt->GetCurve());
     }
+
+
+
+    /**
+     * Compute the weighted averages of the surrounding points and project
+     * them onto the boundary. The OpenCASCADE projections are expensive
+     * compared to the averaging and independent of each other, so they are
+     * distributed among the threads.
+     */
+    template <int dim, int spacedim>
+    void get_new_points_in_parallel(const Boundary<dim,spacedim>           &boundary,
+                                    const ArrayView<const Point<spacedim>> &surrounding_points,
+                                    const Table<2,double>                  &weights,
+                                    ArrayView<Point<spacedim>>              new_points)
+    {
+      AssertDimension(surrounding_points.size(), weights.size(1));
+      AssertDimension(new_points.size(), weights.size(0));
+
+      const std::size_t n_points = surrounding_points.size();
+      parallel::apply_to_subranges
+      (0U, static_cast<unsigned int>(weights.size(0)),
+       [&](const unsigned int begin, const unsigned int end)
+      {
+        for (unsigned int row=begin; row<end; ++row)
+          {
+            Point<spacedim> new_point;
+            for (unsigned int p=0; p<n_points; ++p)
+              new_point += surrounding_points[p] * weights(row,p);
+            new_points[row] = boundary.project_to_manifold(surrounding_points,
+                                                           new_point);
+          }
+      },
+      1);
+    }
   }
 
   /*============================== NormalProjectionBoundary ==============================*/
@@ -82,7 +118,8 @@ namespace OpenCASCADE
   NormalProjectionBoundary<dim,spacedim>::NormalProjectionBoundary(const TopoDS_Shape &sh,
       const double tolerance) :
     sh(sh),
-    tolerance(tolerance)
+    tolerance(tolerance),
+    search_tree(sh, tolerance)
   {
     Assert(spacedim == 3, ExcNotImplemented());
   }
@@ -96,12 +133,23 @@ namespace OpenCASCADE
     (void)surrounding_points;
 #ifdef DEBUG
     for (unsigned int i=0; i<surrounding_points.size(); ++i)
-      Assert(closest_point(sh, surrounding_points[i], tolerance)
+      Assert(search_tree.closest_point(surrounding_points[i])
              .distance(surrounding_points[i]) <
              std::max(tolerance*surrounding_points[i].norm(), tolerance),
              ExcPointNotOnManifold(surrounding_points[i]));
 #endif
-    return closest_point(sh, candidate,tolerance);
+    return search_tree.closest_point(candidate);
+  }
+
+
+  template <int dim, int spacedim>
+  void
+  NormalProjectionBoundary<dim,spacedim>::
+  get_new_points (const ArrayView<const Point<spacedim>> &surrounding_points,
+                  const Table<2,double>                  &weights,
+                  ArrayView<Point<spacedim>>              new_points) const
+  {
+    get_new_points_in_parallel(*this, surrounding_points, weights, new_points);
   }
 
 
@@ -112,7 +160,8 @@ namespace OpenCASCADE
       const double tolerance) :
     sh(sh),
     direction(direction),
-    tolerance(tolerance)
+    tolerance(tolerance),
+    search_tree(sh, tolerance)
   {
     Assert(spacedim == 3, ExcNotImplemented());
   }
@@ -126,22 +175,34 @@ namespace OpenCASCADE
     (void)surrounding_points;
 #ifdef DEBUG
     for (unsigned int i=0; i<surrounding_points.size(); ++i)
-      Assert(closest_point(sh, surrounding_points[i],tolerance)
+      Assert(search_tree.closest_point(surrounding_points[i])
              .distance(surrounding_points[i]) <
              std::max(tolerance*surrounding_points[i].norm(), tolerance),
              ExcPointNotOnManifold(surrounding_points[i]));
 #endif
-    return line_intersection(sh, candidate, direction, tolerance);
+    return search_tree.line_intersection(candidate, direction);
   }
 
 
 
+  template <int dim, int spacedim>
+  void
+  DirectionalProjectionBoundary<dim,spacedim>::
+  get_new_points (const ArrayView<const Point<spacedim>> &surrounding_points,
+                  const Table<2,double>                  &weights,
+                  ArrayView<Point<spacedim>>              new_points) const
+  {
+    get_new_points_in_parallel(*this, surrounding_points, weights, new_points);
+  }
+
+
   /*============================== NormalToMeshProjectionBoundary ==============================*/
   template <int dim, int spacedim>
   NormalToMeshProjectionBoundary<dim,spacedim>::NormalToMeshProjectionBoundary(const TopoDS_Shape &sh,
       const double tolerance) :
     sh(sh),
-    tolerance(tolerance)
+    tolerance(tolerance),
+    search_tree(sh, tolerance)
   {
     Assert(spacedim == 3, ExcNotImplemented());
     Assert(std::get<0>(count_elements(sh)) > 0,
@@ -159,7 +220,7 @@ namespace OpenCASCADE
 #ifdef DEBUG
     for (unsigned int i=0; i<surrounding_points.size(); ++i)
       {
-        Assert(closest_point(sh, surrounding_points[i], tolerance)
+        Assert(search_tree.closest_point(surrounding_points[i])
                .distance(surrounding_points[i]) <
                std::max(tolerance*surrounding_points[i].norm(), tolerance),
                ExcPointNotOnManifold(surrounding_points[i]));
@@ -174,9 +235,7 @@ namespace OpenCASCADE
           {
             std::tuple<Point<3>,  Tensor<1,3>, double, double>
             p_and_diff_forms =
-              closest_point_and_differential_forms(sh,
-                                                   surrounding_points[i],
-                                                   tolerance);
+              search_tree.closest_point_and_differential_forms(surrounding_points[i]);
             average_normal += std::get<1>(p_and_diff_forms);
           }
 
@@ -233,7 +292,18 @@ namespace OpenCASCADE
       }
       }
 
-    return line_intersection(sh, candidate, average_normal, tolerance);
+    return search_tree.line_intersection(candidate, average_normal);
+  }
+
+
+  template <int dim, int spacedim>
+  void
+  NormalToMeshProjectionBoundary<dim,spacedim>::
+  get_new_points (const ArrayView<const Point<spacedim>> &surrounding_points,
+                  const Table<2,double>                  &weights,
+                  ArrayView<Point<spacedim>>              new_points) const
+  {
+    get_new_points_in_parallel(*this, surrounding_points, weights, new_points);
   }
 
 
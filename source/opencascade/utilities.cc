@@ -21,8 +21,11 @@
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/exceptions.h>
 
+#include <boost/container/small_vector.hpp>
+
 #include <cstdio>
 #include <iostream>
+#include <limits>
 #include <set>
 
 DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
@@ -58,6 +61,7 @@ DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 #include <GeomAPI_ProjectPointOnSurf.hxx>
 #include <GeomAPI_ProjectPointOnCurve.hxx>
 #include <IntCurvesFace_ShapeIntersector.hxx>
+#include <IntCurvesFace_Intersector.hxx>
 
 #include <BRepTools.hxx>
 #include <BRepAdaptor_Curve.hxx>
@@ -68,6 +72,8 @@ DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 #include <BRepBuilderAPI_Transform.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
 #include <BRepAlgo_Section.hxx>
+#include <BRepBndLib.hxx>
+#include <Bnd_Box.hxx>
 
 #include <Geom_Plane.hxx>
 #include <Geom_BoundedCurve.hxx>
@@ -462,6 +468,59 @@ namespace OpenCASCADE
     return out_shape;
   }
 
+  namespace
+  {
+    // project the point onto the untrimmed surface the face is defined on
+    // and return the distance
+    double project_to_face (const TopoDS_Face &face,
+                            const Point<3>    &origin,
+                            const double       tolerance,
+                            gp_Pnt            &projection,
+                            double            &u,
+                            double            &v)
+    {
+      // the projection function needs a surface, so we obtain the
+      // surface upon which the face is defined
+      Handle(Geom_Surface) SurfToProj = BRep_Tool::Surface(face);
+
+      ShapeAnalysis_Surface projector(SurfToProj);
+      gp_Pnt2d proj_params = projector.ValueOfUV(point(origin), tolerance);
+
+      SurfToProj->D0(proj_params.X(),proj_params.Y(),projection);
+      u = proj_params.X();
+      v = proj_params.Y();
+      return point(projection).distance(origin);
+    }
+
+
+
+    // project the point onto the curve of a non-degenerate edge and return
+    // the distance, or a negative number if no projection was found
+    double project_to_edge (const TopoDS_Edge &edge,
+                            const Point<3>    &origin,
+                            gp_Pnt            &projection,
+                            double            &u)
+    {
+      TopLoc_Location L;
+      Standard_Real First;
+      Standard_Real Last;
+
+      // the projection function needs a Curve, so we obtain the
+      // curve upon which the edge is defined
+      Handle(Geom_Curve) CurveToProj = BRep_Tool::Curve(edge,L,First,Last);
+
+      GeomAPI_ProjectPointOnCurve Proj(point(origin),CurveToProj);
+      if (Proj.NbPoints() == 0)
+        return -1.;
+
+      projection = Proj.NearestPoint();
+      u = Proj.LowerDistanceParameter();
+      return Proj.LowerDistance();
+    }
+  }
+
+
+
   std::tuple<Point<3>, TopoDS_Shape, double, double>
   project_point_and_pull_back(const TopoDS_Shape &in_shape,
                               const Point<3> &origin,
@@ -484,23 +543,16 @@ namespace OpenCASCADE
       {
         TopoDS_Face face = TopoDS::Face(exp.Current());
 
-        // the projection function needs a surface, so we obtain the
-        // surface upon which the face is defined
-        Handle(Geom_Surface) SurfToProj = BRep_Tool::Surface(face);
-
-        ShapeAnalysis_Surface projector(SurfToProj);
-        gp_Pnt2d proj_params = projector.ValueOfUV(point(origin), tolerance);
-
-        SurfToProj->D0(proj_params.X(),proj_params.Y(),tmp_proj);
-
-        double distance = point(tmp_proj).distance(origin);
+        double tmp_u = 0, tmp_v = 0;
+        const double distance = project_to_face(face, origin, tolerance,
+                                                tmp_proj, tmp_u, tmp_v);
         if (distance < minDistance)
           {
             minDistance = distance;
             Pproj = tmp_proj;
             out_shape = face;
-            u=proj_params.X();
-            v=proj_params.Y();
+            u=tmp_u;
+            v=tmp_v;
             ++counter;
           }
         ++face_counter;
@@ -516,22 +568,14 @@ namespace OpenCASCADE
           TopoDS_Edge edge = TopoDS::Edge(exp.Current());
           if (!BRep_Tool::Degenerated(edge))
             {
-              TopLoc_Location L;
-              Standard_Real First;
-              Standard_Real Last;
-
-              // the projection function needs a Curve, so we obtain the
-              // curve upon which the edge is defined
-              Handle(Geom_Curve) CurveToProj = BRep_Tool::Curve(edge,L,First,Last);
-
-              GeomAPI_ProjectPointOnCurve Proj(point(origin),CurveToProj);
-              unsigned int num_proj_points = Proj.NbPoints();
-              if ((num_proj_points > 0) && (Proj.LowerDistance() < minDistance))
+              double tmp_u = 0;
+              const double distance = project_to_edge(edge, origin, tmp_proj, tmp_u);
+              if ((distance >= 0) && (distance < minDistance))
                 {
-                  minDistance = Proj.LowerDistance();
-                  Pproj = Proj.NearestPoint();
+                  minDistance = distance;
+                  Pproj = tmp_proj;
                   out_shape = edge;
-                  u=Proj.LowerDistanceParameter();
+                  u=tmp_u;
                   ++counter;
                 }
             }
@@ -665,6 +709,377 @@ namespace OpenCASCADE
     tria.create_triangulation(vertices, cells, t);
   }
 
+
+
+  namespace
+  {
+    // return the square of the distance between a point and an axis-aligned
+    // box, which is zero for points inside the box
+    double distance_square_to_box (const Point<3> &p,
+                                   const Point<3> &lower_corner,
+                                   const Point<3> &upper_corner)
+    {
+      double distance_square = 0;
+      for (unsigned int d=0; d<3; ++d)
+        if (p[d] < lower_corner[d])
+          distance_square += (lower_corner[d]-p[d])*(lower_corner[d]-p[d]);
+        else if (p[d] > upper_corner[d])
+          distance_square += (p[d]-upper_corner[d])*(p[d]-upper_corner[d]);
+      return distance_square;
+    }
+
+
+
+    // check whether the infinite line through the origin along the given
+    // direction intersects an axis-aligned box
+    bool line_intersects_box (const Point<3>    &origin,
+                              const Tensor<1,3> &direction,
+                              const Point<3>    &lower_corner,
+                              const Point<3>    &upper_corner)
+    {
+      double t_min = -std::numeric_limits<double>::max();
+      double t_max = std::numeric_limits<double>::max();
+      for (unsigned int d=0; d<3; ++d)
+        if (std::abs(direction[d]) < 1e-14)
+          {
+            if (origin[d] < lower_corner[d] || origin[d] > upper_corner[d])
+              return false;
+          }
+        else
+          {
+            double t1 = (lower_corner[d]-origin[d])/direction[d];
+            double t2 = (upper_corner[d]-origin[d])/direction[d];
+            if (t1 > t2)
+              std::swap(t1, t2);
+            t_min = std::max(t_min, t1);
+            t_max = std::min(t_max, t2);
+            if (t_min > t_max)
+              return false;
+          }
+      return true;
+    }
+  }
+
+
+
+  ShapeSearchTree::ShapeSearchTree (const TopoDS_Shape &shape,
+                                    const double        tolerance)
+    :
+    shape(shape),
+    tolerance(tolerance),
+    last_entity(0)
+  {
+    // the same entities as in project_point_and_pull_back(): the faces, or
+    // the non-degenerate edges if there are no faces
+    std::vector<TopoDS_Shape> unsorted_entities;
+    TopExp_Explorer exp;
+    for (exp.Init(shape, TopAbs_FACE); exp.More(); exp.Next())
+      unsorted_entities.push_back(exp.Current());
+    if (unsorted_entities.empty())
+      for (exp.Init(shape, TopAbs_EDGE); exp.More(); exp.Next())
+        if (!BRep_Tool::Degenerated(TopoDS::Edge(exp.Current())))
+          unsorted_entities.push_back(exp.Current());
+
+    if (unsorted_entities.empty())
+      return;
+
+    std::vector<std::pair<Point<3>,Point<3> > > unsorted_boxes(unsorted_entities.size());
+    for (unsigned int i=0; i<unsorted_entities.size(); ++i)
+      {
+        Bnd_Box box;
+        BRepBndLib::Add(unsorted_entities[i], box);
+        if (box.IsVoid())
+          {
+            // no bounds available, so the entity must always be visited
+            for (unsigned int d=0; d<3; ++d)
+              {
+                unsorted_boxes[i].first[d] = -std::numeric_limits<double>::max();
+                unsorted_boxes[i].second[d] = std::numeric_limits<double>::max();
+              }
+          }
+        else
+          {
+            box.Enlarge(tolerance);
+            double x_min, y_min, z_min, x_max, y_max, z_max;
+            box.Get(x_min, y_min, z_min, x_max, y_max, z_max);
+            unsorted_boxes[i].first = Point<3>(x_min, y_min, z_min);
+            unsorted_boxes[i].second = Point<3>(x_max, y_max, z_max);
+          }
+      }
+
+    // build the tree on a list of indices and then sort the entities
+    // accordingly, such that each node covers a contiguous range
+    entity_boxes.swap(unsorted_boxes);
+    std::vector<unsigned int> indices(unsorted_entities.size());
+    for (unsigned int i=0; i<indices.size(); ++i)
+      indices[i] = i;
+    nodes.reserve(2*indices.size());
+    build_tree(indices, 0, indices.size());
+
+    entities.resize(indices.size());
+    unsorted_boxes.resize(indices.size());
+    for (unsigned int i=0; i<indices.size(); ++i)
+      {
+        entities[i] = unsorted_entities[indices[i]];
+        unsorted_boxes[i] = entity_boxes[indices[i]];
+      }
+    entity_boxes.swap(unsorted_boxes);
+  }
+
+
+
+  unsigned int
+  ShapeSearchTree::build_tree (std::vector<unsigned int> &indices,
+                               const unsigned int         begin,
+                               const unsigned int         end)
+  {
+    Node node;
+    node.begin = begin;
+    node.end = end;
+    node.children[0] = node.children[1] = numbers::invalid_unsigned_int;
+    node.lower_corner = entity_boxes[indices[begin]].first;
+    node.upper_corner = entity_boxes[indices[begin]].second;
+    for (unsigned int i=begin+1; i<end; ++i)
+      for (unsigned int d=0; d<3; ++d)
+        {
+          node.lower_corner[d] = std::min(node.lower_corner[d],
+                                          entity_boxes[indices[i]].first[d]);
+          node.upper_corner[d] = std::max(node.upper_corner[d],
+                                          entity_boxes[indices[i]].second[d]);
+        }
+
+    const unsigned int index = nodes.size();
+    nodes.push_back(node);
+
+    // leaves hold up to four entities, for which the projections are cheaper
+    // than further box tests
+    if (end-begin > 4)
+      {
+        unsigned int direction = 0;
+        for (unsigned int d=1; d<3; ++d)
+          if (node.upper_corner[d]-node.lower_corner[d] >
+              node.upper_corner[direction]-node.lower_corner[direction])
+            direction = d;
+
+        const unsigned int middle = (begin+end)/2;
+        std::nth_element(indices.begin()+begin, indices.begin()+middle,
+                         indices.begin()+end,
+                         [&](const unsigned int a, const unsigned int b)
+        {
+          return (entity_boxes[a].first[direction] + entity_boxes[a].second[direction] <
+                  entity_boxes[b].first[direction] + entity_boxes[b].second[direction]);
+        });
+
+        const unsigned int child_0 = build_tree(indices, begin, middle);
+        const unsigned int child_1 = build_tree(indices, middle, end);
+        nodes[index].children[0] = child_0;
+        nodes[index].children[1] = child_1;
+      }
+    return index;
+  }
+
+
+
+  double
+  ShapeSearchTree::project_to_entity (const unsigned int index,
+                                      const Point<3>    &origin,
+                                      Point<3>          &projection,
+                                      double            &u,
+                                      double            &v) const
+  {
+    gp_Pnt tmp_proj(0.0,0.0,0.0);
+    double distance = -1.;
+    if (entities[index].ShapeType() == TopAbs_FACE)
+      distance = project_to_face(TopoDS::Face(entities[index]), origin,
+                                 tolerance, tmp_proj, u, v);
+    else
+      {
+        distance = project_to_edge(TopoDS::Edge(entities[index]), origin,
+                                   tmp_proj, u);
+        v = 0;
+      }
+    projection = point(tmp_proj);
+    return distance;
+  }
+
+
+
+  std::tuple<Point<3>, TopoDS_Shape, double, double>
+  ShapeSearchTree::project_point_and_pull_back (const Point<3> &origin) const
+  {
+    Assert(entities.size() > 0, ExcMessage("Could not find projection points."));
+
+    Point<3> best_point = origin;
+    double best_distance = std::numeric_limits<double>::max();
+    double best_u = 0, best_v = 0;
+    unsigned int best_entity = numbers::invalid_unsigned_int;
+
+    // start with the entity of the last query of this thread, which gives a
+    // small distance in most cases and thus prunes most of the tree
+    unsigned int &last = last_entity.get();
+    if (last >= entities.size())
+      last = 0;
+    {
+      double u = 0, v = 0;
+      Point<3> projection;
+      const double distance = project_to_entity(last, origin, projection, u, v);
+      if (distance >= 0)
+        {
+          best_point = projection;
+          best_distance = distance;
+          best_u = u;
+          best_v = v;
+          best_entity = last;
+        }
+    }
+
+    boost::container::small_vector<unsigned int, 64> stack(1, 0U);
+    while (!stack.empty())
+      {
+        const Node &node = nodes[stack.back()];
+        stack.pop_back();
+        if (distance_square_to_box(origin, node.lower_corner, node.upper_corner) >=
+            best_distance*best_distance)
+          continue;
+
+        if (node.children[0] == numbers::invalid_unsigned_int)
+          {
+            for (unsigned int i=node.begin; i<node.end; ++i)
+              if (i != last &&
+                  distance_square_to_box(origin, entity_boxes[i].first,
+                                         entity_boxes[i].second) <
+                  best_distance*best_distance)
+                {
+                  double u = 0, v = 0;
+                  Point<3> projection;
+                  const double distance = project_to_entity(i, origin, projection, u, v);
+                  if (distance >= 0 && distance < best_distance)
+                    {
+                      best_point = projection;
+                      best_distance = distance;
+                      best_u = u;
+                      best_v = v;
+                      best_entity = i;
+                    }
+                }
+          }
+        else
+          {
+            // visit the closer child first, i.e., put it on top of the stack
+            const Node &child_0 = nodes[node.children[0]];
+            const Node &child_1 = nodes[node.children[1]];
+            if (distance_square_to_box(origin, child_0.lower_corner, child_0.upper_corner) <
+                distance_square_to_box(origin, child_1.lower_corner, child_1.upper_corner))
+              {
+                stack.push_back(node.children[1]);
+                stack.push_back(node.children[0]);
+              }
+            else
+              {
+                stack.push_back(node.children[0]);
+                stack.push_back(node.children[1]);
+              }
+          }
+      }
+
+    Assert(best_entity != numbers::invalid_unsigned_int,
+           ExcMessage("Could not find projection points."));
+    last = best_entity;
+    return std::tuple<Point<3>, TopoDS_Shape, double, double>
+           (best_point, entities[best_entity], best_u, best_v);
+  }
+
+
+
+  Point<3>
+  ShapeSearchTree::closest_point (const Point<3> &origin) const
+  {
+    return std::get<0>(project_point_and_pull_back(origin));
+  }
+
+
+
+  std::tuple<Point<3>, Tensor<1,3>, double, double>
+  ShapeSearchTree::closest_point_and_differential_forms (const Point<3> &origin) const
+  {
+    const std::tuple<Point<3>, TopoDS_Shape, double, double>
+    shape_and_params = project_point_and_pull_back(origin);
+
+    Assert(std::get<1>(shape_and_params).ShapeType() == TopAbs_FACE,
+           ExcMessage("Could not find normal: the shape containing the closest point has 0 faces."));
+
+    return push_forward_and_differential_forms(TopoDS::Face(std::get<1>(shape_and_params)),
+                                               std::get<2>(shape_and_params),
+                                               std::get<3>(shape_and_params),
+                                               tolerance);
+  }
+
+
+
+  Point<3>
+  ShapeSearchTree::line_intersection (const Point<3>    &origin,
+                                      const Tensor<1,3> &direction) const
+  {
+    if (entities.empty() || entities[0].ShapeType() != TopAbs_FACE)
+      return OpenCASCADE::line_intersection(shape, origin, direction, tolerance);
+
+    // collect the faces whose bounding box is hit by the line, sorted by
+    // their distance to the origin
+    boost::container::small_vector<std::pair<double,unsigned int>, 32> candidates;
+    boost::container::small_vector<unsigned int, 64> stack(1, 0U);
+    while (!stack.empty())
+      {
+        const Node &node = nodes[stack.back()];
+        stack.pop_back();
+        if (!line_intersects_box(origin, direction, node.lower_corner, node.upper_corner))
+          continue;
+
+        if (node.children[0] == numbers::invalid_unsigned_int)
+          {
+            for (unsigned int i=node.begin; i<node.end; ++i)
+              if (line_intersects_box(origin, direction, entity_boxes[i].first,
+                                      entity_boxes[i].second))
+                candidates.push_back(std::make_pair(distance_square_to_box(origin,
+                                                    entity_boxes[i].first,
+                                                    entity_boxes[i].second),
+                                                    i));
+          }
+        else
+          {
+            stack.push_back(node.children[0]);
+            stack.push_back(node.children[1]);
+          }
+      }
+    std::sort(candidates.begin(), candidates.end());
+
+    const gp_Lin line(gp_Ax1(point(origin), gp_Dir(direction[0], direction[1], direction[2])));
+    double minDistance = 1e7;
+    Point<3> result;
+    for (unsigned int c=0; c<candidates.size(); ++c)
+      {
+        // the remaining faces are farther away than the closest intersection
+        if (candidates[c].first >= minDistance*minDistance)
+          break;
+
+        IntCurvesFace_Intersector intersector(TopoDS::Face(entities[candidates[c].second]),
+                                              tolerance);
+        intersector.Perform(line,-RealLast(),+RealLast());
+        Assert(intersector.IsDone(), ExcMessage("Could not project point."));
+
+        for (int i=0; i<intersector.NbPnt(); ++i)
+          {
+            const double distance = point(origin).Distance(intersector.Pnt(i+1));
+            if (distance < minDistance)
+              {
+                minDistance = distance;
+                result = point(intersector.Pnt(i+1));
+              }
+          }
+      }
+
+    return result;
+  }
+
 } // end namespace
 
 DEAL_II_NAMESPACE_CLOSE
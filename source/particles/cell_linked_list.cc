@@ -0,0 +1,310 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/particles/cell_linked_list.h>
+#include <deal.II/particles/particle_handler.h>
+
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <algorithm>
+#include <cmath>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Particles
+{
+  namespace
+  {
+    /**
+     * Return the square of the distance between a point and a box given by
+     * its lower left and upper right corners.
+     */
+    template <int spacedim>
+    inline
+    double
+    distance_square_to_box (const Point<spacedim>                              &point,
+                            const std::pair<Point<spacedim>,Point<spacedim> > &box)
+    {
+      double distance_square = 0;
+      for (unsigned int d=0; d<spacedim; ++d)
+        {
+          const double difference = std::max (std::max (box.first[d] - point[d],
+                                                        point[d] - box.second[d]),
+                                              0.);
+          distance_square += difference * difference;
+        }
+      return distance_square;
+    }
+  }
+
+
+
+  template <int dim,int spacedim>
+  CellLinkedList<dim,spacedim>::CellLinkedList ()
+    :
+    n_active_cells (0)
+  {}
+
+
+
+  template <int dim,int spacedim>
+  void
+  CellLinkedList<dim,spacedim>::reinit
+  (const Triangulation<dim,spacedim>                                             &triangulation,
+   const std::vector<Point<spacedim> >                                           &points,
+   const std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> &cells)
+  {
+    n_active_cells = triangulation.n_active_cells();
+
+    // collect the cells around the vertices of each cell. the map of
+    // GridTools also contains the cells adjacent over hanging vertices, but
+    // only at the vertices of the refined side, so add each pair in both
+    // directions
+    const std::vector<std::set<typename Triangulation<dim,spacedim>::active_cell_iterator> >
+    vertex_to_cells = GridTools::vertex_to_cell_map (triangulation);
+
+    std::vector<std::vector<unsigned int> > cell_neighbors (n_active_cells);
+    vertex_boxes.resize (n_active_cells);
+    for (typename Triangulation<dim,spacedim>::active_cell_iterator
+         cell = triangulation.begin_active(); cell != triangulation.end(); ++cell)
+      {
+        const unsigned int index = cell->active_cell_index();
+        std::pair<Point<spacedim>,Point<spacedim> > &box = vertex_boxes[index];
+        box.first = box.second = cell->vertex(0);
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          {
+            for (unsigned int d=0; d<spacedim; ++d)
+              {
+                box.first[d] = std::min (box.first[d], cell->vertex(v)[d]);
+                box.second[d] = std::max (box.second[d], cell->vertex(v)[d]);
+              }
+
+            for (typename std::set<typename Triangulation<dim,spacedim>::active_cell_iterator>::const_iterator
+                 neighbor = vertex_to_cells[cell->vertex_index(v)].begin();
+                 neighbor != vertex_to_cells[cell->vertex_index(v)].end(); ++neighbor)
+              if (*neighbor != cell)
+                {
+                  cell_neighbors[index].push_back ((*neighbor)->active_cell_index());
+                  cell_neighbors[(*neighbor)->active_cell_index()].push_back (index);
+                }
+          }
+      }
+
+    neighbor_start.resize (n_active_cells+1);
+    neighbor_start[0] = 0;
+    neighbors.clear();
+    for (unsigned int c=0; c<n_active_cells; ++c)
+      {
+        std::sort (cell_neighbors[c].begin(), cell_neighbors[c].end());
+        neighbors.insert (neighbors.end(), cell_neighbors[c].begin(),
+                          std::unique (cell_neighbors[c].begin(),
+                                       cell_neighbors[c].end()));
+        neighbor_start[c+1] = neighbors.size();
+      }
+
+    update_points (points, cells);
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  CellLinkedList<dim,spacedim>::reinit
+  (const Triangulation<dim,spacedim>   &triangulation,
+   const ParticleHandler<dim,spacedim> &particle_handler)
+  {
+    std::vector<Point<spacedim> > points;
+    std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> cells;
+    points.reserve (particle_handler.n_locally_owned_particles());
+    cells.reserve (particle_handler.n_locally_owned_particles());
+    for (typename ParticleHandler<dim,spacedim>::particle_iterator
+         particle = particle_handler.begin(); particle != particle_handler.end(); ++particle)
+      {
+        points.push_back (particle->get_location());
+        cells.push_back (particle->get_surrounding_cell (triangulation));
+      }
+
+    reinit (triangulation, points, cells);
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  CellLinkedList<dim,spacedim>::update_points
+  (const std::vector<Point<spacedim> >                                           &points,
+   const std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> &cells)
+  {
+    Assert (neighbor_start.size() == n_active_cells+1,
+            ExcNotInitialized());
+    AssertDimension (points.size(), cells.size());
+
+    point_cells.resize (points.size());
+    for (unsigned int i=0; i<cells.size(); ++i)
+      {
+        AssertIndexRange (cells[i]->active_cell_index(), n_active_cells);
+        point_cells[i] = cells[i]->active_cell_index();
+      }
+
+    // sort the points by cells with a counting sort
+    point_start.assign (n_active_cells+1, 0);
+    for (unsigned int i=0; i<point_cells.size(); ++i)
+      ++point_start[point_cells[i]+1];
+    for (unsigned int c=0; c<n_active_cells; ++c)
+      point_start[c+1] += point_start[c];
+
+    std::vector<unsigned int> next_position (point_start.begin(),
+                                             point_start.end()-1);
+    sorted_points.resize (points.size());
+    point_indices.resize (points.size());
+    for (unsigned int i=0; i<points.size(); ++i)
+      {
+        const unsigned int position = next_position[point_cells[i]]++;
+        sorted_points[position] = points[i];
+        point_indices[position] = i;
+      }
+
+    // enlarge the boxes of the cells by their points, which may lie outside
+    // the box of the vertices of curved cells
+    cell_boxes = vertex_boxes;
+    for (unsigned int c=0; c<n_active_cells; ++c)
+      for (unsigned int j=point_start[c]; j<point_start[c+1]; ++j)
+        for (unsigned int d=0; d<spacedim; ++d)
+          {
+            cell_boxes[c].first[d] = std::min (cell_boxes[c].first[d],
+                                               sorted_points[j][d]);
+            cell_boxes[c].second[d] = std::max (cell_boxes[c].second[d],
+                                                sorted_points[j][d]);
+          }
+  }
+
+
+
+  template <int dim,int spacedim>
+  std::vector<std::pair<unsigned int, double> >
+  CellLinkedList<dim,spacedim>::get_points_within_ball
+  (const Point<spacedim>                                            &target,
+   const typename Triangulation<dim,spacedim>::active_cell_iterator &cell,
+   const double                                                      radius,
+   const bool                                                        sorted) const
+  {
+    Assert (neighbor_start.size() == n_active_cells+1,
+            ExcNotInitialized());
+    AssertIndexRange (cell->active_cell_index(), n_active_cells);
+    Assert (radius > 0,
+            ExcMessage ("Radius is expected to be positive."));
+
+    std::vector<unsigned int> visited_cells;
+    std::vector<std::pair<unsigned int, double> > matches;
+    search_ball (target, cell->active_cell_index(), radius, visited_cells, matches);
+
+    if (sorted)
+      std::sort (matches.begin(), matches.end(),
+                 [](const std::pair<unsigned int, double> &a,
+                    const std::pair<unsigned int, double> &b)
+      {
+        return a.second < b.second;
+      });
+
+    return matches;
+  }
+
+
+
+  template <int dim,int spacedim>
+  std::vector<std::vector<std::pair<unsigned int, double> > >
+  CellLinkedList<dim,spacedim>::get_points_within_ball (const double radius,
+                                                        const bool   sorted) const
+  {
+    Assert (neighbor_start.size() == n_active_cells+1,
+            ExcNotInitialized());
+    Assert (radius > 0,
+            ExcMessage ("Radius is expected to be positive."));
+
+    // work on the cells in parallel, so that the points of a cell, which
+    // visit the same cells, are searched one after the other
+    std::vector<std::vector<std::pair<unsigned int, double> > > matches (sorted_points.size());
+    parallel::apply_to_subranges
+    (0U, n_active_cells,
+     [&](const unsigned int begin, const unsigned int end)
+    {
+      std::vector<unsigned int> visited_cells;
+      for (unsigned int c=begin; c<end; ++c)
+        for (unsigned int j=point_start[c]; j<point_start[c+1]; ++j)
+          {
+            std::vector<std::pair<unsigned int, double> > &point_matches =
+              matches[point_indices[j]];
+            search_ball (sorted_points[j], c, radius, visited_cells, point_matches);
+            if (sorted)
+              std::sort (point_matches.begin(), point_matches.end(),
+                         [](const std::pair<unsigned int, double> &a,
+                            const std::pair<unsigned int, double> &b)
+            {
+              return a.second < b.second;
+            });
+          }
+    },
+    16);
+
+    return matches;
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  CellLinkedList<dim,spacedim>::search_ball
+  (const Point<spacedim>                          &target,
+   const unsigned int                              cell_index,
+   const double                                    radius,
+   std::vector<unsigned int>                      &visited_cells,
+   std::vector<std::pair<unsigned int, double> >  &matches) const
+  {
+    const double radius_square = radius * radius;
+
+    // breadth-first search through the cells whose boxes intersect the
+    // ball. the number of visited cells is small for radii of the order of
+    // the cell size, so a linear search for cells already visited is
+    // cheaper than a lookup table for all cells
+    visited_cells.clear();
+    visited_cells.push_back (cell_index);
+    for (unsigned int k=0; k<visited_cells.size(); ++k)
+      {
+        const unsigned int c = visited_cells[k];
+        for (unsigned int j=point_start[c]; j<point_start[c+1]; ++j)
+          {
+            const double distance_square = target.distance_square (sorted_points[j]);
+            if (distance_square <= radius_square)
+              matches.emplace_back (point_indices[j], std::sqrt(distance_square));
+          }
+
+        for (unsigned int n=neighbor_start[c]; n<neighbor_start[c+1]; ++n)
+          if (distance_square_to_box (target, cell_boxes[neighbors[n]]) <= radius_square &&
+              std::find (visited_cells.begin(), visited_cells.end(), neighbors[n]) ==
+              visited_cells.end())
+            visited_cells.push_back (neighbors[n]);
+      }
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+DEAL_II_NAMESPACE_OPEN
+
+#include "cell_linked_list.inst"
+
+DEAL_II_NAMESPACE_CLOSE
@@ -319,6 +319,24 @@ namespace Particles
     return (property_pool != NULL)
            && (properties != PropertyPool::invalid_handle);
   }
+
+
+
+  template <int dim, int spacedim>
+  PropertyPool::Handle
+  Particle<dim,spacedim>::get_handle () const
+  {
+    return properties;
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  Particle<dim,spacedim>::set_handle (const PropertyPool::Handle new_handle)
+  {
+    properties = new_handle;
+  }
 }
 
 DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,873 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/particles/particle_handler.h>
+
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/grid/cell_id.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/distributed/tria.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Particles
+{
+  template <int dim,int spacedim>
+  ParticleHandler<dim,spacedim>::ParticleHandler ()
+    :
+    triangulation(),
+    mapping(),
+    mpi_communicator(MPI_COMM_SELF),
+    particles(),
+    global_number_of_particles(0),
+    global_max_particles_per_cell(0),
+    next_free_particle_index(0),
+    property_pool(new PropertyPool(0)),
+    handle(numbers::invalid_unsigned_int)
+  {}
+
+
+
+  template <int dim,int spacedim>
+  ParticleHandler<dim,spacedim>::ParticleHandler (const Triangulation<dim,spacedim> &triangulation,
+                                                  const Mapping<dim,spacedim>       &mapping,
+                                                  const unsigned int                 n_properties)
+    :
+    ParticleHandler()
+  {
+    initialize(triangulation, mapping, n_properties);
+  }
+
+
+
+  template <int dim,int spacedim>
+  ParticleHandler<dim,spacedim>::~ParticleHandler ()
+  {
+    cell_weight_connection.disconnect();
+
+    // the particles return their properties to the pool on destruction, so
+    // they need to be deleted before the pool
+    clear_particles();
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::initialize (const Triangulation<dim,spacedim> &new_triangulation,
+                                             const Mapping<dim,spacedim>       &new_mapping,
+                                             const unsigned int                 n_properties)
+  {
+    clear();
+
+    triangulation = &new_triangulation;
+    mapping = &new_mapping;
+    cache.reset(new GridTools::Cache<dim,spacedim>(new_triangulation, new_mapping));
+
+    const parallel::Triangulation<dim,spacedim> *parallel_triangulation
+      = dynamic_cast<const parallel::Triangulation<dim,spacedim> *>(&new_triangulation);
+    if (parallel_triangulation != nullptr)
+      mpi_communicator = parallel_triangulation->get_communicator();
+    else
+      mpi_communicator = MPI_COMM_SELF;
+
+    property_pool.reset(new PropertyPool(n_properties));
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::clear ()
+  {
+    clear_particles();
+    global_number_of_particles = 0;
+    next_free_particle_index = 0;
+    global_max_particles_per_cell = 0;
+
+    cell_weight_connection.disconnect();
+    handle = numbers::invalid_unsigned_int;
+
+    cache.reset();
+    mapping = nullptr;
+    triangulation = nullptr;
+    mpi_communicator = MPI_COMM_SELF;
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::clear_particles ()
+  {
+    particles.clear();
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::update_cached_numbers ()
+  {
+    types::particle_index locally_highest_index = 0;
+    types::particle_index local_max_particles_per_cell = 0;
+
+    // the particles of a cell are adjacent in the container, so count the
+    // length of the runs with the same key
+    types::particle_index n_particles_in_current_cell = 0;
+    for (auto particle = particles.begin(); particle != particles.end(); ++particle)
+      {
+        locally_highest_index = std::max(locally_highest_index,
+                                         particle->second.get_id());
+        if (particle != particles.begin() &&
+            std::prev(particle)->first == particle->first)
+          ++n_particles_in_current_cell;
+        else
+          n_particles_in_current_cell = 1;
+        local_max_particles_per_cell = std::max(local_max_particles_per_cell,
+                                                n_particles_in_current_cell);
+      }
+
+    global_number_of_particles
+      = Utilities::MPI::sum (static_cast<types::particle_index>(particles.size()),
+                             mpi_communicator);
+    global_max_particles_per_cell
+      = Utilities::MPI::max (local_max_particles_per_cell, mpi_communicator);
+
+    if (global_number_of_particles == 0)
+      next_free_particle_index = 0;
+    else
+      next_free_particle_index
+        = Utilities::MPI::max (locally_highest_index, mpi_communicator) + 1;
+  }
+
+
+
+  template <int dim,int spacedim>
+  typename ParticleHandler<dim,spacedim>::particle_iterator
+  ParticleHandler<dim,spacedim>::begin () const
+  {
+    return (const_cast<ParticleHandler<dim,spacedim> *> (this))->begin();
+  }
+
+
+
+  template <int dim,int spacedim>
+  typename ParticleHandler<dim,spacedim>::particle_iterator
+  ParticleHandler<dim,spacedim>::begin ()
+  {
+    return particle_iterator(particles, particles.begin());
+  }
+
+
+
+  template <int dim,int spacedim>
+  typename ParticleHandler<dim,spacedim>::particle_iterator
+  ParticleHandler<dim,spacedim>::end () const
+  {
+    return (const_cast<ParticleHandler<dim,spacedim> *> (this))->end();
+  }
+
+
+
+  template <int dim,int spacedim>
+  typename ParticleHandler<dim,spacedim>::particle_iterator
+  ParticleHandler<dim,spacedim>::end ()
+  {
+    return particle_iterator(particles, particles.end());
+  }
+
+
+
+  template <int dim,int spacedim>
+  typename ParticleHandler<dim,spacedim>::particle_iterator_range
+  ParticleHandler<dim,spacedim>::particles_in_cell (const typename Triangulation<dim,spacedim>::active_cell_iterator &cell)
+  {
+    const types::LevelInd level_index (cell->level(), cell->index());
+
+    const auto particles_in_cell = particles.equal_range(level_index);
+    return boost::make_iterator_range(particle_iterator(particles, particles_in_cell.first),
+                                      particle_iterator(particles, particles_in_cell.second));
+  }
+
+
+
+  template <int dim,int spacedim>
+  unsigned int
+  ParticleHandler<dim,spacedim>::n_particles_in_cell (const typename Triangulation<dim,spacedim>::active_cell_iterator &cell) const
+  {
+    return particles.count(types::LevelInd(cell->level(), cell->index()));
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::remove_particle (const particle_iterator &particle)
+  {
+    particles.erase(particle->particle);
+  }
+
+
+
+  template <int dim,int spacedim>
+  typename ParticleHandler<dim,spacedim>::particle_iterator
+  ParticleHandler<dim,spacedim>::insert_particle (const Particle<dim,spacedim>                                    &particle,
+                                                  const typename Triangulation<dim,spacedim>::active_cell_iterator &cell)
+  {
+    Assert (cell->is_locally_owned(),
+            ExcMessage("Particles can only be inserted into locally owned cells."));
+
+    // do not copy the particle directly, since its properties may be stored
+    // in another pool
+    const auto it = particles.emplace(types::LevelInd(cell->level(), cell->index()),
+                                      Particle<dim,spacedim>(particle.get_location(),
+                                                             particle.get_reference_location(),
+                                                             particle.get_id()));
+    it->second.set_property_pool(*property_pool);
+
+    // all particles of this class store properties if the pool has some, so
+    // that they can be transferred between processes
+    if (particle.has_properties())
+      it->second.set_properties(particle.get_properties());
+    else if (property_pool->n_properties_per_slot() > 0)
+      {
+        const std::vector<double> zero_properties (property_pool->n_properties_per_slot(), 0.);
+        it->second.set_properties(make_array_view(zero_properties));
+      }
+
+    return particle_iterator(particles, it);
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::insert_particles (const std::multimap<typename Triangulation<dim,spacedim>::active_cell_iterator,
+                                                   Particle<dim,spacedim> > &new_particles)
+  {
+    for (const auto &particle : new_particles)
+      insert_particle(particle.second, particle.first);
+
+    update_cached_numbers();
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::insert_particles (const std::vector<Point<spacedim> > &positions)
+  {
+    Assert (cache != nullptr, ExcNotInitialized());
+
+    update_cached_numbers();
+
+    // the particle of positions[i] gets the index next_free_particle_index +
+    // i + the number of positions on the processes of lower rank
+    types::particle_index local_start_index = 0;
+#ifdef DEAL_II_WITH_MPI
+    if (Utilities::MPI::job_supports_mpi())
+      {
+        const types::particle_index n_local_positions = positions.size();
+        types::particle_index prefix_sum = 0;
+        const int ierr = MPI_Scan(&n_local_positions, &prefix_sum, 1,
+                                  PARTICLE_INDEX_MPI_TYPE, MPI_SUM,
+                                  mpi_communicator);
+        AssertThrowMPI(ierr);
+        local_start_index = prefix_sum - n_local_positions;
+      }
+#endif
+    local_start_index += next_free_particle_index;
+
+    const auto point_locations = GridTools::compute_point_locations(*cache, positions);
+    const auto &cells = std::get<0>(point_locations);
+    const auto &reference_locations = std::get<1>(point_locations);
+    const auto &point_indices = std::get<2>(point_locations);
+
+    const std::vector<double> zero_properties (property_pool->n_properties_per_slot(), 0.);
+    for (unsigned int c=0; c<cells.size(); ++c)
+      if (cells[c]->is_locally_owned())
+        {
+          const types::LevelInd level_index (cells[c]->level(), cells[c]->index());
+          for (unsigned int p=0; p<point_indices[c].size(); ++p)
+            {
+              const auto it = particles.emplace(level_index,
+                                                Particle<dim,spacedim>(positions[point_indices[c][p]],
+                                                                       reference_locations[c][p],
+                                                                       local_start_index + point_indices[c][p]));
+              it->second.set_property_pool(*property_pool);
+              if (zero_properties.size() > 0)
+                it->second.set_properties(make_array_view(zero_properties));
+            }
+        }
+
+    update_cached_numbers();
+  }
+
+
+
+  template <int dim,int spacedim>
+  types::particle_index
+  ParticleHandler<dim,spacedim>::n_global_particles () const
+  {
+    return global_number_of_particles;
+  }
+
+
+
+  template <int dim,int spacedim>
+  types::particle_index
+  ParticleHandler<dim,spacedim>::n_global_max_particles_per_cell () const
+  {
+    return global_max_particles_per_cell;
+  }
+
+
+
+  template <int dim,int spacedim>
+  types::particle_index
+  ParticleHandler<dim,spacedim>::n_locally_owned_particles () const
+  {
+    return particles.size();
+  }
+
+
+
+  template <int dim,int spacedim>
+  types::particle_index
+  ParticleHandler<dim,spacedim>::get_next_free_particle_index () const
+  {
+    return next_free_particle_index;
+  }
+
+
+
+  template <int dim,int spacedim>
+  unsigned int
+  ParticleHandler<dim,spacedim>::n_properties_per_particle () const
+  {
+    return property_pool->n_properties_per_slot();
+  }
+
+
+
+  template <int dim,int spacedim>
+  PropertyPool &
+  ParticleHandler<dim,spacedim>::get_property_pool () const
+  {
+    return *property_pool;
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::sort_particles_into_subdomains_and_cells ()
+  {
+    Assert (cache != nullptr, ExcNotInitialized());
+
+    // first find the particles that left their cell, and update the
+    // reference location of the other ones
+    std::vector<particle_iterator> particles_out_of_cell;
+    for (particle_iterator it=begin(); it!=end(); ++it)
+      {
+        const typename Triangulation<dim,spacedim>::active_cell_iterator
+        cell = it->get_surrounding_cell(*triangulation);
+
+        try
+          {
+            const Point<dim> p_unit = mapping->transform_real_to_unit_cell(cell, it->get_location());
+            if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
+              {
+                it->set_reference_location(p_unit);
+                continue;
+              }
+          }
+        catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+          {}
+
+        particles_out_of_cell.push_back(it);
+      }
+
+    const std::vector<std::set<typename Triangulation<dim,spacedim>::active_cell_iterator> >
+    &vertex_to_cells = cache->get_vertex_to_cell_map();
+    const std::vector<std::vector<Tensor<1,spacedim> > >
+    &vertex_to_cell_centers = cache->get_vertex_to_cell_centers_directions();
+
+    std::multimap<types::LevelInd, Particle<dim,spacedim> > sorted_particles;
+    std::map<dealii::types::subdomain_id, std::vector<particle_iterator> > moved_particles;
+    std::map<dealii::types::subdomain_id, std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> > moved_cells;
+
+    std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> neighbor_cells;
+    std::vector<std::pair<double,unsigned int> > search_order;
+    for (particle_iterator &it : particles_out_of_cell)
+      {
+        const Point<spacedim> location = it->get_location();
+        const typename Triangulation<dim,spacedim>::active_cell_iterator
+        old_cell = it->get_surrounding_cell(*triangulation);
+
+        // the particle most likely moved into one of the cells around the
+        // vertex of the old cell closest to it. search these cells in the
+        // order of how well the direction from the vertex to their center
+        // aligns with the direction to the particle
+        const unsigned int closest_vertex
+          = GridTools::find_closest_vertex_of_cell<dim,spacedim>(old_cell, location);
+        const unsigned int closest_vertex_index = old_cell->vertex_index(closest_vertex);
+        Tensor<1,spacedim> vertex_to_particle = location - old_cell->vertex(closest_vertex);
+        const double distance = vertex_to_particle.norm();
+        if (distance > 0)
+          vertex_to_particle /= distance;
+
+        neighbor_cells.assign(vertex_to_cells[closest_vertex_index].begin(),
+                              vertex_to_cells[closest_vertex_index].end());
+        search_order.resize(neighbor_cells.size());
+        for (unsigned int i=0; i<neighbor_cells.size(); ++i)
+          search_order[i] = std::make_pair(-(vertex_to_cell_centers[closest_vertex_index][i]
+                                             * vertex_to_particle), i);
+        std::sort(search_order.begin(), search_order.end());
+
+        typename Triangulation<dim,spacedim>::active_cell_iterator current_cell;
+        Point<dim> current_reference_position;
+        bool found_cell = false;
+        for (unsigned int i=0; i<search_order.size(); ++i)
+          {
+            const typename Triangulation<dim,spacedim>::active_cell_iterator
+            cell = neighbor_cells[search_order[i].second];
+            try
+              {
+                const Point<dim> p_unit = mapping->transform_real_to_unit_cell(cell, location);
+                if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
+                  {
+                    current_cell = cell;
+                    current_reference_position = p_unit;
+                    found_cell = true;
+                    break;
+                  }
+              }
+            catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+              {}
+          }
+
+        // the particle moved further than the cells around the vertex, so
+        // use the global search
+        if (!found_cell)
+          {
+            try
+              {
+                const std::pair<const typename Triangulation<dim,spacedim>::active_cell_iterator, Point<dim> >
+                current_cell_and_position = GridTools::find_active_cell_around_point(*cache, location, old_cell);
+                current_cell = current_cell_and_position.first;
+                current_reference_position = current_cell_and_position.second;
+              }
+            catch (GridTools::ExcPointNotFound<spacedim> &)
+              {
+                // the particle left the domain; it is deleted below together
+                // with the other particles that left their cell
+                continue;
+              }
+          }
+
+        if (current_cell->is_locally_owned())
+          {
+            it->set_reference_location(current_reference_position);
+            sorted_particles.emplace(types::LevelInd(current_cell->level(), current_cell->index()),
+                                     std::move(it->particle->second));
+          }
+        else if (current_cell->is_ghost())
+          {
+            it->set_reference_location(current_reference_position);
+            moved_particles[current_cell->subdomain_id()].push_back(it);
+            moved_cells[current_cell->subdomain_id()].push_back(current_cell);
+          }
+        // particles in artificial cells have moved out of the part of the
+        // mesh known to this process and get lost
+      }
+
+    if (dynamic_cast<const parallel::Triangulation<dim,spacedim> *>(&*triangulation) != nullptr)
+      send_recv_particles(moved_particles, moved_cells, sorted_particles);
+
+    for (particle_iterator &it : particles_out_of_cell)
+      particles.erase(it->particle);
+
+    particles.insert(std::make_move_iterator(sorted_particles.begin()),
+                     std::make_move_iterator(sorted_particles.end()));
+
+    update_cached_numbers();
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::sort_property_pool_by_cells ()
+  {
+    std::vector<PropertyPool::Handle> handles;
+    handles.reserve(particles.size());
+    for (const auto &particle : particles)
+      if (particle.second.has_properties())
+        handles.push_back(particle.second.get_handle());
+
+    property_pool->sort_memory_slots(handles);
+
+    unsigned int index = 0;
+    for (auto &particle : particles)
+      if (particle.second.has_properties())
+        particle.second.set_handle(handles[index++]);
+  }
+
+
+
+  template <int dim,int spacedim>
+  std::size_t
+  ParticleHandler<dim,spacedim>::serialized_size_in_bytes () const
+  {
+    std::size_t size = 0;
+    for (const auto &particle : particles)
+      size += particle.second.serialized_size_in_bytes();
+    return size;
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::register_store_callback_function (const bool serialization)
+  {
+#ifdef DEAL_II_WITH_P4EST
+    parallel::distributed::Triangulation<dim,spacedim> *distributed_triangulation
+      = const_cast<parallel::distributed::Triangulation<dim,spacedim> *>
+        (dynamic_cast<const parallel::distributed::Triangulation<dim,spacedim> *>(&*triangulation));
+    AssertThrow (distributed_triangulation != nullptr,
+                 ExcMessage("The transfer of particles through mesh changes "
+                            "requires a parallel::distributed::Triangulation."));
+
+    update_cached_numbers();
+
+    // coarsening collects the particles of all children in the parent
+    const std::size_t transfer_size_per_cell
+      = sizeof(unsigned int) +
+        size_per_particle() * global_max_particles_per_cell *
+        (serialization ? 1 : GeometryInfo<dim>::max_children_per_cell);
+
+    handle = distributed_triangulation->register_data_attach
+             (transfer_size_per_cell,
+              [this](const typename parallel::distributed::Triangulation<dim,spacedim>::cell_iterator &cell,
+                     const typename parallel::distributed::Triangulation<dim,spacedim>::CellStatus     status,
+                     void                                                                              *data)
+    {
+      this->store_particles(cell, status, data);
+    });
+#else
+    (void)serialization;
+    AssertThrow (false,
+                 ExcMessage("The transfer of particles through mesh changes "
+                            "requires deal.II to be configured with p4est."));
+#endif
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::register_load_callback_function (const bool serialization)
+  {
+    // the data layout does not depend on whether we deserialize or
+    // transfer through mesh changes, but keep the argument symmetric to
+    // register_store_callback_function()
+    (void)serialization;
+
+#ifdef DEAL_II_WITH_P4EST
+    parallel::distributed::Triangulation<dim,spacedim> *distributed_triangulation
+      = const_cast<parallel::distributed::Triangulation<dim,spacedim> *>
+        (dynamic_cast<const parallel::distributed::Triangulation<dim,spacedim> *>(&*triangulation));
+    AssertThrow (distributed_triangulation != nullptr,
+                 ExcMessage("The transfer of particles through mesh changes "
+                            "requires a parallel::distributed::Triangulation."));
+    Assert (handle != numbers::invalid_unsigned_int,
+            ExcMessage("The particles need to be stored with "
+                       "register_store_callback_function() before they can "
+                       "be loaded."));
+
+    // the keys of the old particles refer to cells that may not exist
+    // anymore
+    clear_particles();
+
+    distributed_triangulation->notify_ready_to_unpack
+    (handle,
+     [this](const typename parallel::distributed::Triangulation<dim,spacedim>::cell_iterator &cell,
+            const typename parallel::distributed::Triangulation<dim,spacedim>::CellStatus     status,
+            const void                                                                        *data)
+    {
+      this->load_particles(cell, status, data);
+    });
+
+    handle = numbers::invalid_unsigned_int;
+    update_cached_numbers();
+#else
+    AssertThrow (false,
+                 ExcMessage("The transfer of particles through mesh changes "
+                            "requires deal.II to be configured with p4est."));
+#endif
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::connect_to_cell_weight_signal (const unsigned int weight_per_particle)
+  {
+    Assert (triangulation != nullptr, ExcNotInitialized());
+
+    cell_weight_connection.disconnect();
+    cell_weight_connection = triangulation->signals.cell_weight.connect
+                             ([this,weight_per_particle](const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                                         const typename Triangulation<dim,spacedim>::CellStatus     status)
+                              -> unsigned int
+    {
+      return weight_per_particle * this->n_particles_after_refinement(cell, status);
+    });
+  }
+
+
+
+  template <int dim,int spacedim>
+  std::size_t
+  ParticleHandler<dim,spacedim>::size_per_particle () const
+  {
+    // this is the size written by Particle::write_data()
+    return sizeof(types::particle_index) +
+           sizeof(Point<spacedim>) +
+           sizeof(Point<dim>) +
+           property_pool->n_properties_per_slot() * sizeof(double);
+  }
+
+
+
+  template <int dim,int spacedim>
+  unsigned int
+  ParticleHandler<dim,spacedim>::n_particles_after_refinement (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+      const typename Triangulation<dim,spacedim>::CellStatus     status) const
+  {
+    switch (status)
+      {
+      case Triangulation<dim,spacedim>::CELL_PERSIST:
+      case Triangulation<dim,spacedim>::CELL_REFINE:
+        return particles.count(types::LevelInd(cell->level(), cell->index()));
+
+      case Triangulation<dim,spacedim>::CELL_COARSEN:
+      {
+        unsigned int n_particles = 0;
+        for (unsigned int child=0; child<cell->n_children(); ++child)
+          n_particles += particles.count(types::LevelInd(cell->child(child)->level(),
+                                                         cell->child(child)->index()));
+        return n_particles;
+      }
+
+      default:
+        Assert (false, ExcInternalError());
+        return 0;
+      }
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::store_particles (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                                  const typename Triangulation<dim,spacedim>::CellStatus     status,
+                                                  void                                                      *data)
+  {
+    unsigned int *n_particles = static_cast<unsigned int *>(data);
+    *n_particles = 0;
+    data = static_cast<void *>(n_particles + 1);
+
+    switch (status)
+      {
+      case Triangulation<dim,spacedim>::CELL_PERSIST:
+      case Triangulation<dim,spacedim>::CELL_REFINE:
+      {
+        const auto particles_in_cell
+          = particles.equal_range(types::LevelInd(cell->level(), cell->index()));
+        for (auto particle = particles_in_cell.first;
+             particle != particles_in_cell.second; ++particle, ++(*n_particles))
+          particle->second.write_data(data);
+        break;
+      }
+
+      case Triangulation<dim,spacedim>::CELL_COARSEN:
+      {
+        // the particles of the children get their reference location in
+        // the parent cell. the particles are discarded when loading anyway
+        for (unsigned int child=0; child<cell->n_children(); ++child)
+          {
+            const auto particles_in_cell
+              = particles.equal_range(types::LevelInd(cell->child(child)->level(),
+                                                      cell->child(child)->index()));
+            for (auto particle = particles_in_cell.first;
+                 particle != particles_in_cell.second; ++particle, ++(*n_particles))
+              {
+                Particle<dim,spacedim> &coarsened_particle = particle->second;
+                coarsened_particle.set_reference_location
+                (mapping->transform_real_to_unit_cell(cell, coarsened_particle.get_location()));
+                coarsened_particle.write_data(data);
+              }
+          }
+        break;
+      }
+
+      default:
+        Assert (false, ExcInternalError());
+      }
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::load_particles (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                                 const typename Triangulation<dim,spacedim>::CellStatus     status,
+                                                 const void                                                *data)
+  {
+    const unsigned int *n_particles = static_cast<const unsigned int *>(data);
+    data = static_cast<const void *>(n_particles + 1);
+
+    for (unsigned int i=0; i<*n_particles; ++i)
+      {
+        Particle<dim,spacedim> particle (data, *property_pool);
+
+        if (status != Triangulation<dim,spacedim>::CELL_REFINE)
+          {
+            particles.emplace(types::LevelInd(cell->level(), cell->index()),
+                              std::move(particle));
+            continue;
+          }
+
+        // find the child the particle is located in. if the particle lies
+        // in none of them because of roundoff, take the closest one
+        unsigned int closest_child = 0;
+        Point<dim> closest_reference_location;
+        double closest_distance = std::numeric_limits<double>::max();
+        for (unsigned int child=0; child<cell->n_children(); ++child)
+          {
+            try
+              {
+                const Point<dim> p_unit
+                  = mapping->transform_real_to_unit_cell(cell->child(child), particle.get_location());
+                const double distance = GeometryInfo<dim>::distance_to_unit_cell(p_unit);
+                if (distance < closest_distance)
+                  {
+                    closest_child = child;
+                    closest_reference_location = p_unit;
+                    closest_distance = distance;
+                  }
+                if (distance == 0.)
+                  break;
+              }
+            catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+              {}
+          }
+        Assert (closest_distance < std::numeric_limits<double>::max(),
+                ExcInternalError());
+
+        particle.set_reference_location(closest_reference_location);
+        particles.emplace(types::LevelInd(cell->child(closest_child)->level(),
+                                          cell->child(closest_child)->index()),
+                          std::move(particle));
+      }
+  }
+
+
+
+  template <int dim,int spacedim>
+  void
+  ParticleHandler<dim,spacedim>::send_recv_particles (const std::map<dealii::types::subdomain_id, std::vector<particle_iterator> >                                          &particles_to_send,
+                                                      const std::map<dealii::types::subdomain_id, std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> > &new_cells_for_particles,
+                                                      std::multimap<types::LevelInd,Particle <dim,spacedim> >                                                      &received_particles)
+  {
+#ifdef DEAL_II_WITH_MPI
+    const std::size_t cellid_size = sizeof(CellId::binary_type);
+
+    // pack all particles for the same process into one message, each
+    // particle preceded by the id of its new cell
+    std::map<unsigned int, std::vector<char> > send_data;
+    for (const auto &destination : particles_to_send)
+      {
+        Assert (new_cells_for_particles.find(destination.first) != new_cells_for_particles.end(),
+                ExcInternalError());
+        const std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator>
+        &cells = new_cells_for_particles.find(destination.first)->second;
+        AssertDimension (cells.size(), destination.second.size());
+
+        std::size_t buffer_size = 0;
+        for (const particle_iterator &particle : destination.second)
+          buffer_size += cellid_size + particle->serialized_size_in_bytes();
+
+        std::vector<char> &buffer = send_data[destination.first];
+        buffer.resize(buffer_size);
+        void *data = static_cast<void *>(buffer.data());
+        for (unsigned int i=0; i<cells.size(); ++i)
+          {
+            const CellId::binary_type cellid = cells[i]->id().template to_binary<dim>();
+            std::memcpy(data, &cellid, cellid_size);
+            data = static_cast<char *>(data) + cellid_size;
+            destination.second[i]->write_data(data);
+          }
+        Assert (data == static_cast<void *>(buffer.data() + buffer_size),
+                ExcInternalError());
+      }
+
+    const std::map<unsigned int, std::vector<char> > received_data
+      = Utilities::MPI::sparse_data_exchange(mpi_communicator, send_data);
+
+    for (const auto &origin : received_data)
+      {
+        const void *data = static_cast<const void *>(origin.second.data());
+        const void *const data_end = static_cast<const void *>(origin.second.data() +
+                                                               origin.second.size());
+        while (data < data_end)
+          {
+            CellId::binary_type binary_cellid;
+            std::memcpy(&binary_cellid, data, cellid_size);
+            data = static_cast<const char *>(data) + cellid_size;
+
+            const typename Triangulation<dim,spacedim>::active_cell_iterator
+            cell = CellId(binary_cellid).to_cell(*triangulation);
+            Assert (cell->is_locally_owned(), ExcInternalError());
+            received_particles.emplace(types::LevelInd(cell->level(), cell->index()),
+                                       Particle<dim,spacedim>(data, *property_pool));
+          }
+        Assert (data == data_end, ExcInternalError());
+      }
+#else
+    (void)particles_to_send;
+    (void)new_cells_for_particles;
+    (void)received_particles;
+#endif
+  }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+DEAL_II_NAMESPACE_OPEN
+
+#include "particle_handler.inst"
+
+DEAL_II_NAMESPACE_CLOSE
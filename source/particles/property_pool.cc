@@ -15,6 +15,10 @@
 
 
 #include <deal.II/particles/property_pool.h>
+#include <deal.II/base/types.h>
+
+#include <algorithm>
+#include <functional>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -25,7 +29,9 @@ namespace Particles
 
   PropertyPool::PropertyPool (const unsigned int n_properties_per_slot)
     :
-    n_properties (n_properties_per_slot)
+    n_properties (n_properties_per_slot),
+    slot_size (std::max(n_properties_per_slot, 1U)),
+    n_slots (0)
   {}
 
 
@@ -33,7 +39,14 @@ namespace Particles
   PropertyPool::Handle
   PropertyPool::allocate_properties_array ()
   {
-    return new double[n_properties];
+    // grow geometrically, so that the number of chunks stays logarithmic in
+    // the number of particles
+    if (free_slots.empty())
+      add_chunk(std::max<std::size_t>(n_slots, 64));
+
+    const Handle handle = free_slots.back();
+    free_slots.pop_back();
+    return handle;
   }
 
 
@@ -41,7 +54,9 @@ namespace Particles
   void
   PropertyPool::deallocate_properties_array (Handle handle)
   {
-    delete[] handle;
+    Assert (handle != invalid_handle,
+            ExcMessage("Trying to deallocate an invalid handle."));
+    free_slots.push_back(handle);
   }
 
 
@@ -57,7 +72,126 @@ namespace Particles
   void
   PropertyPool::reserve(const std::size_t size)
   {
-    (void)size;
+    if (size > n_slots)
+      add_chunk(size - n_slots);
+  }
+
+
+
+  void
+  PropertyPool::sort_memory_slots(std::vector<Handle> &handles)
+  {
+    if (handles.empty())
+      return;
+
+    // put the new slots at the back of the free list, in reverse order, so
+    // that they are taken in the order of the given handles
+    add_chunk(handles.size());
+    const std::vector<Handle> old_handles = handles;
+    for (std::size_t i=0; i<handles.size(); ++i)
+      {
+        Assert (handles[i] != invalid_handle,
+                ExcMessage("Trying to sort an invalid handle."));
+        handles[i] = free_slots.back();
+        free_slots.pop_back();
+        std::copy(old_handles[i], old_handles[i]+n_properties, handles[i]);
+      }
+
+    // the old slots are the first candidates for release, so hand them out
+    // only after all other free slots
+    free_slots.insert(free_slots.begin(), old_handles.rbegin(), old_handles.rend());
+
+    release_unused_chunks();
+  }
+
+
+
+  void
+  PropertyPool::add_chunk(const std::size_t n_new_slots)
+  {
+    if (n_new_slots == 0)
+      return;
+
+    memory_chunks.emplace_back(std::unique_ptr<double[]>(new double[n_new_slots*slot_size]),
+                               n_new_slots);
+    n_slots += n_new_slots;
+
+    double *const chunk = memory_chunks.back().first.get();
+    free_slots.reserve(free_slots.size() + n_new_slots);
+    for (std::size_t i=n_new_slots; i>0; --i)
+      free_slots.push_back(chunk + (i-1)*slot_size);
+  }
+
+
+
+  void
+  PropertyPool::release_unused_chunks()
+  {
+    // sort the chunks by their start address to find the chunk of a slot by
+    // binary search. std::less gives a total order also for pointers into
+    // different arrays
+    std::vector<std::pair<const double *,unsigned int> > chunk_starts;
+    chunk_starts.reserve(memory_chunks.size());
+    for (unsigned int c=0; c<memory_chunks.size(); ++c)
+      chunk_starts.emplace_back(memory_chunks[c].first.get(), c);
+    const auto compare_start = [](const std::pair<const double *,unsigned int> &a,
+                                  const std::pair<const double *,unsigned int> &b)
+    {
+      return std::less<const double *>()(a.first, b.first);
+    };
+    std::sort(chunk_starts.begin(), chunk_starts.end(), compare_start);
+
+    // the chunk a slot belongs to, or numbers::invalid_unsigned_int for
+    // memory that was not obtained from this pool
+    const auto find_chunk = [&](const double *slot) -> unsigned int
+    {
+      auto it = std::upper_bound(chunk_starts.begin(), chunk_starts.end(),
+                                 std::make_pair(slot, 0U), compare_start);
+      if (it == chunk_starts.begin())
+        return numbers::invalid_unsigned_int;
+      --it;
+      const std::size_t chunk_length = memory_chunks[it->second].second * slot_size;
+      if (std::less<const double *>()(slot, it->first + chunk_length))
+        return it->second;
+      return numbers::invalid_unsigned_int;
+    };
+
+    std::vector<std::size_t> n_free_slots_in_chunk(memory_chunks.size(), 0);
+    for (const Handle slot : free_slots)
+      {
+        const unsigned int c = find_chunk(slot);
+        if (c != numbers::invalid_unsigned_int)
+          ++n_free_slots_in_chunk[c];
+      }
+
+    std::vector<bool> release_chunk(memory_chunks.size(), false);
+    bool any_release = false;
+    for (unsigned int c=0; c<memory_chunks.size(); ++c)
+      if (n_free_slots_in_chunk[c] == memory_chunks[c].second)
+        {
+          release_chunk[c] = true;
+          any_release = true;
+        }
+    if (any_release == false)
+      return;
+
+    // remove the slots of released chunks from the free list, keeping the
+    // order of the other slots
+    free_slots.erase(std::remove_if(free_slots.begin(), free_slots.end(),
+                                    [&](const Handle slot)
+    {
+      const unsigned int c = find_chunk(slot);
+      return c != numbers::invalid_unsigned_int && release_chunk[c];
+    }),
+    free_slots.end());
+
+    unsigned int n_kept = 0;
+    for (unsigned int c=0; c<memory_chunks.size(); ++c)
+      if (release_chunk[c])
+        n_slots -= memory_chunks[c].second;
+      else
+        memory_chunks[n_kept++] = std::move(memory_chunks[c]);
+    memory_chunks.resize(n_kept);
   }
 
 
@@ -30,7 +30,7 @@
 #include <deal.II/lac/petsc_parallel_vector.h>
 #endif
 #include <deal.II/base/utilities.h>
-#include <deal.II/sundials/copy.h>
+#include <deal.II/sundials/n_vector.templates.h>
 
 #include <iostream>
 #include <iomanip>
@@ -55,19 +55,10 @@ namespace SUNDIALS
                                    void *user_data)
     {
       ARKode<VectorType> &solver = *static_cast<ARKode<VectorType> *>(user_data);
-      GrowingVectorMemory<VectorType> mem;
-
-      typename VectorMemory<VectorType>::Pointer src_yy(mem);
-      solver.reinit_vector(*src_yy);
-
-      typename VectorMemory<VectorType>::Pointer dst_yp(mem);
-      solver.reinit_vector(*dst_yp);
-
-      copy(*src_yy, yy);
 
-      int err = solver.explicit_function(tt, *src_yy, *dst_yp);
-
-      copy(yp, *dst_yp);
+      int err = solver.explicit_function(tt,
+                                         unwrap_nvector<VectorType>(yy),
+                                         unwrap_nvector<VectorType>(yp));
 
       return err;
     }
@@ -81,19 +72,10 @@ namespace SUNDIALS
                                    void *user_data)
     {
       ARKode<VectorType> &solver = *static_cast<ARKode<VectorType> *>(user_data);
-      GrowingVectorMemory<VectorType> mem;
-
-      typename VectorMemory<VectorType>::Pointer src_yy(mem);
-      solver.reinit_vector(*src_yy);
 
-      typename VectorMemory<VectorType>::Pointer dst_yp(mem);
-      solver.reinit_vector(*dst_yp);
-
-      copy(*src_yy, yy);
-
-      int err = solver.implicit_function(tt, *src_yy, *dst_yp);
-
-      copy(yp, *dst_yp);
+      int err = solver.implicit_function(tt,
+                                         unwrap_nvector<VectorType>(yy),
+                                         unwrap_nvector<VectorType>(yp));
 
       return err;
     }
@@ -111,22 +93,12 @@ namespace SUNDIALS
                                 N_Vector)
     {
       ARKode<VectorType> &solver = *static_cast<ARKode<VectorType> *>(arkode_mem->ark_user_data);
-      GrowingVectorMemory<VectorType> mem;
-
-      typename VectorMemory<VectorType>::Pointer src_ypred(mem);
-      solver.reinit_vector(*src_ypred);
-
-      typename VectorMemory<VectorType>::Pointer src_fpred(mem);
-      solver.reinit_vector(*src_fpred);
-
-      copy(*src_ypred, ypred);
-      copy(*src_fpred, fpred);
 
       int err = solver.setup_jacobian(convfail,
                                       arkode_mem->ark_tn,
                                       arkode_mem->ark_gamma,
-                                      *src_ypred,
-                                      *src_fpred,
+                                      unwrap_nvector<VectorType>(ypred),
+                                      unwrap_nvector<VectorType>(fpred),
                                       (bool &)*jcurPtr);
 
       return err;
@@ -144,27 +116,18 @@ namespace SUNDIALS
       ARKode<VectorType> &solver = *static_cast<ARKode<VectorType> *>(arkode_mem->ark_user_data);
       GrowingVectorMemory<VectorType> mem;
 
-      typename VectorMemory<VectorType>::Pointer src(mem);
-      solver.reinit_vector(*src);
-
-      typename VectorMemory<VectorType>::Pointer src_ycur(mem);
-      solver.reinit_vector(*src_ycur);
-
-      typename VectorMemory<VectorType>::Pointer src_fcur(mem);
-      solver.reinit_vector(*src_fcur);
-
+      // the right hand side is overwritten by the solution, so we need one
+      // temporary vector
+      VectorType &src = unwrap_nvector<VectorType>(b);
       typename VectorMemory<VectorType>::Pointer dst(mem);
       solver.reinit_vector(*dst);
 
-      copy(*src, b);
-      copy(*src_ycur, ycur);
-      copy(*src_fcur, fcur);
-
       int err = solver.solve_jacobian_system(arkode_mem->ark_tn,
                                              arkode_mem->ark_gamma,
-                                             *src_ycur, *src_fcur,
-                                             *src,*dst);
-      copy(b, *dst);
+                                             unwrap_nvector<VectorType>(ycur),
+                                             unwrap_nvector<VectorType>(fcur),
+                                             src,*dst);
+      src = *dst;
 
       return err;
     }
@@ -192,16 +155,12 @@ namespace SUNDIALS
       ARKode<VectorType> &solver = *static_cast<ARKode<VectorType> *>(arkode_mem->ark_user_data);
       GrowingVectorMemory<VectorType> mem;
 
-      typename VectorMemory<VectorType>::Pointer src(mem);
-      solver.reinit_vector(*src);
-
+      VectorType &src = unwrap_nvector<VectorType>(b);
       typename VectorMemory<VectorType>::Pointer dst(mem);
       solver.reinit_vector(*dst);
 
-      copy(*src, b);
-
-      int err = solver.solve_mass_system(*src,*dst);
-      copy(b, *dst);
+      int err = solver.solve_mass_system(src,*dst);
+      src = *dst;
 
       return err;
     }
@@ -212,6 +171,8 @@ namespace SUNDIALS
                              const MPI_Comm mpi_comm) :
     data(data),
     arkode_mem(nullptr),
+    yy(nullptr),
+    abs_tolls(nullptr),
     communicator(Utilities::MPI::duplicate_communicator(mpi_comm))
   {
     set_functions_to_trigger_an_assert();
@@ -232,9 +193,6 @@ namespace SUNDIALS
   template <typename VectorType>
   unsigned int ARKode<VectorType>::solve_ode(VectorType &solution)
   {
-
-    unsigned int system_size = solution.size();
-
     double t = data.initial_time;
     double h = data.initial_step_size;
     unsigned int step_number = 0;
@@ -242,31 +200,6 @@ namespace SUNDIALS
     int status;
     (void)status;
 
-    // The solution is stored in
-    // solution. Here we take only a
-    // view of it.
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        const IndexSet is = solution.locally_owned_elements();
-        const size_t local_system_size = is.n_elements();
-
-        yy        = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        abs_tolls = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-      }
-    else
-#endif
-      {
-        Assert(is_serial_vector<VectorType>::value,
-               ExcInternalError("Trying to use a serial code with a parallel vector."));
-        yy        = N_VNew_Serial(system_size);
-        abs_tolls = N_VNew_Serial(system_size);
-      }
     reset(data.initial_time,
           data.initial_step_size,
           solution);
@@ -287,7 +220,7 @@ namespace SUNDIALS
         status = ARKodeGetLastStep(arkode_mem, &h);
         AssertARKode(status);
 
-        copy(solution, yy);
+        solution = unwrap_nvector<VectorType>(yy);
 
         while (solver_should_restart(t, solution))
           reset(t, h, solution);
@@ -299,18 +232,10 @@ namespace SUNDIALS
       }
 
     // Free the vectors which are no longer used.
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        N_VDestroy_Parallel(yy);
-        N_VDestroy_Parallel(abs_tolls);
-      }
-    else
-#endif
-      {
-        N_VDestroy_Serial(yy);
-        N_VDestroy_Serial(abs_tolls);
-      }
+    N_VDestroy(yy);
+    N_VDestroy(abs_tolls);
+    yy = nullptr;
+    abs_tolls = nullptr;
 
     return step_number;
   }
@@ -320,9 +245,6 @@ namespace SUNDIALS
                                  const double &current_time_step,
                                  const VectorType &solution)
   {
-
-    unsigned int system_size;
-
     if (arkode_mem)
       ARKodeFree(&arkode_mem);
 
@@ -331,46 +253,17 @@ namespace SUNDIALS
     // Free the vectors which are no longer used.
     if (yy)
       {
-#ifdef DEAL_II_WITH_MPI
-        if (is_serial_vector<VectorType>::value == false)
-          {
-            N_VDestroy_Parallel(yy);
-            N_VDestroy_Parallel(abs_tolls);
-          }
-        else
-#endif
-          {
-            N_VDestroy_Serial(yy);
-            N_VDestroy_Serial(abs_tolls);
-          }
+        N_VDestroy(yy);
+        N_VDestroy(abs_tolls);
       }
 
     int status;
     (void)status;
-    system_size = solution.size();
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        const IndexSet is = solution.locally_owned_elements();
-        const size_t local_system_size = is.n_elements();
-
-        yy        = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        abs_tolls = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-      }
-    else
-#endif
-      {
-        yy        = N_VNew_Serial(system_size);
-        abs_tolls = N_VNew_Serial(system_size);
-      }
 
-    copy(yy, solution);
+    // The vectors of ARKode store deal.II vectors with the layout of the
+    // solution, which are passed to the user functions without copying.
+    yy        = create_nvector(solution, communicator);
+    abs_tolls = create_nvector(solution, communicator);
 
     Assert(explicit_function || implicit_function,
            ExcFunctionNotProvided("explicit_function || implicit_function"));
@@ -383,7 +276,7 @@ namespace SUNDIALS
 
     if (get_local_tolerances)
       {
-        copy(abs_tolls, get_local_tolerances());
+        unwrap_nvector<VectorType>(abs_tolls) = get_local_tolerances();
         status = ARKodeSVtolerances(arkode_mem, data.relative_tolerance, abs_tolls);
         AssertARKode(status);
       }
@@ -467,6 +360,7 @@ namespace SUNDIALS
 
   template class ARKode<Vector<double> >;
   template class ARKode<BlockVector<double> >;
+  template class ARKode<LinearAlgebra::distributed::Vector<double> >;
 
 #ifdef DEAL_II_WITH_MPI
 
@@ -1,6 +1,6 @@
 //-----------------------------------------------------------
 //
-//    Copyright (C) 2015 by the deal.II authors
+//    Copyright (C) 2015 - 2017 by the deal.II authors
 //
 //    This file is part of the deal.II library.
 //
@@ -30,7 +30,7 @@
 #include <deal.II/lac/petsc_parallel_vector.h>
 #endif
 #include <deal.II/base/utilities.h>
-#include <deal.II/sundials/copy.h>
+#include <deal.II/sundials/n_vector.templates.h>
 
 #include <iostream>
 #include <iomanip>
@@ -49,23 +49,11 @@ namespace SUNDIALS
                        N_Vector rr, void *user_data)
     {
       IDA<VectorType> &solver = *static_cast<IDA<VectorType> *>(user_data);
-      GrowingVectorMemory<VectorType> mem;
-
-      typename VectorMemory<VectorType>::Pointer src_yy(mem);
-      solver.reinit_vector(*src_yy);
-
-      typename VectorMemory<VectorType>::Pointer src_yp(mem);
-      solver.reinit_vector(*src_yp);
-
-      typename VectorMemory<VectorType>::Pointer residual(mem);
-      solver.reinit_vector(*residual);
-
-      copy(*src_yy, yy);
-      copy(*src_yp, yp);
-
-      int err = solver.residual(tt, *src_yy, *src_yp, *residual);
 
-      copy(rr, *residual);
+      int err = solver.residual(tt,
+                                unwrap_nvector<VectorType>(yy),
+                                unwrap_nvector<VectorType>(yp),
+                                unwrap_nvector<VectorType>(rr));
 
       return err;
     }
@@ -86,20 +74,10 @@ namespace SUNDIALS
       (void) tmp3;
       (void) resp;
       IDA<VectorType> &solver = *static_cast<IDA<VectorType> *>(IDA_mem->ida_user_data);
-      GrowingVectorMemory<VectorType> mem;
-
-      typename VectorMemory<VectorType>::Pointer src_yy(mem);
-      solver.reinit_vector(*src_yy);
-
-      typename VectorMemory<VectorType>::Pointer src_yp(mem);
-      solver.reinit_vector(*src_yp);
-
-      copy(*src_yy, yy);
-      copy(*src_yp, yp);
 
       int err = solver.setup_jacobian(IDA_mem->ida_tn,
-                                      *src_yy,
-                                      *src_yp,
+                                      unwrap_nvector<VectorType>(yy),
+                                      unwrap_nvector<VectorType>(yp),
                                       IDA_mem->ida_cj);
 
       return err;
@@ -121,16 +99,14 @@ namespace SUNDIALS
       IDA<VectorType> &solver = *static_cast<IDA<VectorType> *>(IDA_mem->ida_user_data);
       GrowingVectorMemory<VectorType> mem;
 
-      typename VectorMemory<VectorType>::Pointer src(mem);
-      solver.reinit_vector(*src);
-
+      // the right hand side is overwritten by the solution, so we need one
+      // temporary vector
+      VectorType &src = unwrap_nvector<VectorType>(b);
       typename VectorMemory<VectorType>::Pointer dst(mem);
       solver.reinit_vector(*dst);
 
-      copy(*src, b);
-
-      int err = solver.solve_jacobian_system(*src,*dst);
-      copy(b, *dst);
+      int err = solver.solve_jacobian_system(src,*dst);
+      src = *dst;
 
       return err;
     }
@@ -142,6 +118,10 @@ namespace SUNDIALS
                        const MPI_Comm mpi_comm) :
     data(data),
     ida_mem(nullptr),
+    yy(nullptr),
+    yp(nullptr),
+    abs_tolls(nullptr),
+    diff_id(nullptr),
     communicator(Utilities::MPI::duplicate_communicator(mpi_comm))
   {
     set_functions_to_trigger_an_assert();
@@ -164,8 +144,6 @@ namespace SUNDIALS
                                           VectorType &solution_dot)
   {
 
-    unsigned int system_size = solution.size();
-
     double t = data.initial_time;
     double h = data.initial_step_size;
     unsigned int step_number = 0;
@@ -173,41 +151,6 @@ namespace SUNDIALS
     int status;
     (void)status;
 
-    // The solution is stored in
-    // solution. Here we take only a
-    // view of it.
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        const IndexSet is = solution.locally_owned_elements();
-        const size_t local_system_size = is.n_elements();
-
-        yy        = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        yp        = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        diff_id   = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        abs_tolls = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-      }
-    else
-#endif
-      {
-        Assert(is_serial_vector<VectorType>::value,
-               ExcInternalError("Trying to use a serial code with a parallel vector."));
-        yy        = N_VNew_Serial(system_size);
-        yp        = N_VNew_Serial(system_size);
-        diff_id   = N_VNew_Serial(system_size);
-        abs_tolls = N_VNew_Serial(system_size);
-      }
     reset(data.initial_time,
           data.initial_step_size,
           solution,
@@ -228,8 +171,8 @@ namespace SUNDIALS
         status = IDAGetLastStep(ida_mem, &h);
         AssertIDA(status);
 
-        copy(solution, yy);
-        copy(solution_dot, yp);
+        solution = unwrap_nvector<VectorType>(yy);
+        solution_dot = unwrap_nvector<VectorType>(yp);
 
         while (solver_should_restart(t, solution, solution_dot))
           reset(t, h, solution, solution_dot);
@@ -240,22 +183,14 @@ namespace SUNDIALS
       }
 
     // Free the vectors which are no longer used.
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        N_VDestroy_Parallel(yy);
-        N_VDestroy_Parallel(yp);
-        N_VDestroy_Parallel(abs_tolls);
-        N_VDestroy_Parallel(diff_id);
-      }
-    else
-#endif
-      {
-        N_VDestroy_Serial(yy);
-        N_VDestroy_Serial(yp);
-        N_VDestroy_Serial(abs_tolls);
-        N_VDestroy_Serial(diff_id);
-      }
+    N_VDestroy(yy);
+    N_VDestroy(yp);
+    N_VDestroy(abs_tolls);
+    N_VDestroy(diff_id);
+    yy = nullptr;
+    yp = nullptr;
+    abs_tolls = nullptr;
+    diff_id = nullptr;
 
     return step_number;
   }
@@ -267,7 +202,6 @@ namespace SUNDIALS
                               VectorType &solution_dot)
   {
 
-    unsigned int system_size;
     bool first_step = (current_time == data.initial_time);
 
     if (ida_mem)
@@ -279,68 +213,28 @@ namespace SUNDIALS
     // Free the vectors which are no longer used.
     if (yy)
       {
-#ifdef DEAL_II_WITH_MPI
-        if (is_serial_vector<VectorType>::value == false)
-          {
-            N_VDestroy_Parallel(yy);
-            N_VDestroy_Parallel(yp);
-            N_VDestroy_Parallel(abs_tolls);
-            N_VDestroy_Parallel(diff_id);
-          }
-        else
-#endif
-          {
-            N_VDestroy_Serial(yy);
-            N_VDestroy_Serial(yp);
-            N_VDestroy_Serial(abs_tolls);
-            N_VDestroy_Serial(diff_id);
-          }
+        N_VDestroy(yy);
+        N_VDestroy(yp);
+        N_VDestroy(abs_tolls);
+        N_VDestroy(diff_id);
       }
 
     int status;
     (void)status;
-    system_size = solution.size();
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        const IndexSet is = solution.locally_owned_elements();
-        const size_t local_system_size = is.n_elements();
-
-        yy        = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        yp        = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        diff_id   = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-        abs_tolls = N_VNew_Parallel(communicator,
-                                    local_system_size,
-                                    system_size);
-
-      }
-    else
-#endif
-      {
-        yy        = N_VNew_Serial(system_size);
-        yp        = N_VNew_Serial(system_size);
-        diff_id   = N_VNew_Serial(system_size);
-        abs_tolls = N_VNew_Serial(system_size);
-      }
 
-    copy(yy, solution);
-    copy(yp, solution_dot);
+    // The vectors of IDA store deal.II vectors with the layout of the
+    // solution, which are passed to the user functions without copying.
+    yy        = create_nvector(solution, communicator);
+    yp        = create_nvector(solution_dot, communicator);
+    diff_id   = create_nvector(solution, communicator);
+    abs_tolls = create_nvector(solution, communicator);
 
     status = IDAInit(ida_mem, t_dae_residual<VectorType>, current_time, yy, yp);
     AssertIDA(status);
 
     if (get_local_tolerances)
       {
-        copy(abs_tolls, get_local_tolerances());
+        unwrap_nvector<VectorType>(abs_tolls) = get_local_tolerances();
         status = IDASVtolerances(ida_mem, data.relative_tolerance, abs_tolls);
         AssertIDA(status);
       }
@@ -366,7 +260,7 @@ namespace SUNDIALS
         for (auto i = dc.begin(); i != dc.end(); ++i)
           diff_comp_vector[*i] = 1.0;
 
-        copy(diff_id, diff_comp_vector);
+        unwrap_nvector<VectorType>(diff_id) = diff_comp_vector;
         status = IDASetId(ida_mem, diff_id);
         AssertIDA(status);
       }
@@ -410,8 +304,8 @@ namespace SUNDIALS
         status = IDAGetConsistentIC(ida_mem, yy, yp);
         AssertIDA(status);
 
-        copy(solution, yy);
-        copy(solution_dot, yp);
+        solution = unwrap_nvector<VectorType>(yy);
+        solution_dot = unwrap_nvector<VectorType>(yp);
       }
     else if (type == AdditionalData::use_y_diff)
       {
@@ -421,8 +315,8 @@ namespace SUNDIALS
         status = IDAGetConsistentIC(ida_mem, yy, yp);
         AssertIDA(status);
 
-        copy(solution, yy);
-        copy(solution_dot, yp);
+        solution = unwrap_nvector<VectorType>(yy);
+        solution_dot = unwrap_nvector<VectorType>(yp);
       }
   }
 
@@ -490,6 +384,7 @@ namespace SUNDIALS
 
   template class IDA<Vector<double> >;
   template class IDA<BlockVector<double> >;
+  template class IDA<LinearAlgebra::distributed::Vector<double> >;
 
 #ifdef DEAL_II_WITH_MPI
 
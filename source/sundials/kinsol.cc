@@ -30,7 +30,7 @@
 #include <deal.II/lac/petsc_parallel_vector.h>
 #endif
 #include <deal.II/base/utilities.h>
-#include <deal.II/sundials/copy.h>
+#include <deal.II/sundials/n_vector.templates.h>
 
 #include <kinsol/kinsol_dense.h>
 
@@ -45,53 +45,86 @@ namespace SUNDIALS
 
   namespace
   {
+    // The dense direct solver of KINSOL needs the serial vectors of
+    // SUNDIALS, which are copied from and to the deal.II vectors. In all
+    // other cases, the vectors of KINSOL store deal.II vectors.
     template<typename VectorType>
-    int t_kinsol_function(N_Vector yy,
-                          N_Vector FF,
-                          void *user_data)
+    void copy_from_serial(VectorType &dst, const N_Vector &src)
     {
-      KINSOL<VectorType> &solver = *static_cast<KINSOL<VectorType> *>(user_data);
-      GrowingVectorMemory<VectorType> mem;
+      AssertDimension(static_cast<std::size_t>(NV_LENGTH_S(src)), dst.size());
+      for (unsigned int i=0; i<dst.size(); ++i)
+        dst[i] = NV_Ith_S(src, i);
+    }
 
-      typename VectorMemory<VectorType>::Pointer src_yy(mem);
-      solver.reinit_vector(*src_yy);
 
-      typename VectorMemory<VectorType>::Pointer dst_FF(mem);
-      solver.reinit_vector(*dst_FF);
 
-      copy(*src_yy, yy);
+    template<typename VectorType>
+    void copy_to_serial(N_Vector &dst, const VectorType &src)
+    {
+      AssertDimension(static_cast<std::size_t>(NV_LENGTH_S(dst)), src.size());
+      for (unsigned int i=0; i<src.size(); ++i)
+        NV_Ith_S(dst, i) = src[i];
+    }
 
+
+
+    template<typename VectorType>
+    int evaluate_kinsol_function(KINSOL<VectorType> &solver,
+                                 const VectorType   &src,
+                                 VectorType         &dst)
+    {
       int err = 0;
       if (solver.residual)
-        err = solver.residual(*src_yy, *dst_FF);
+        err = solver.residual(src, dst);
       else if (solver.iteration_function)
-        err = solver.iteration_function(*src_yy, *dst_FF);
+        err = solver.iteration_function(src, dst);
       else
         Assert(false, ExcInternalError());
-
-      copy(FF, *dst_FF);
-
       return err;
     }
 
 
 
     template<typename VectorType>
-    int t_kinsol_setup_jacobian(KINMem kinsol_mem)
+    int t_kinsol_function(N_Vector yy,
+                          N_Vector FF,
+                          void *user_data)
     {
-      KINSOL<VectorType> &solver = *static_cast<KINSOL<VectorType> *>(kinsol_mem->kin_user_data);
-      GrowingVectorMemory<VectorType> mem;
+      KINSOL<VectorType> &solver = *static_cast<KINSOL<VectorType> *>(user_data);
+
+      if (N_VGetVectorID(yy) == SUNDIALS_NVEC_SERIAL)
+        {
+          GrowingVectorMemory<VectorType> mem;
+
+          typename VectorMemory<VectorType>::Pointer src_yy(mem);
+          solver.reinit_vector(*src_yy);
+
+          typename VectorMemory<VectorType>::Pointer dst_FF(mem);
+          solver.reinit_vector(*dst_FF);
 
-      typename VectorMemory<VectorType>::Pointer src_ycur(mem);
-      solver.reinit_vector(*src_ycur);
+          copy_from_serial(*src_yy, yy);
 
-      typename VectorMemory<VectorType>::Pointer src_fcur(mem);
-      solver.reinit_vector(*src_fcur);
+          int err = evaluate_kinsol_function(solver, *src_yy, *dst_FF);
 
-      copy(*src_ycur, kinsol_mem->kin_uu);
-      copy(*src_fcur, kinsol_mem->kin_fval);
+          copy_to_serial(FF, *dst_FF);
+
+          return err;
+        }
+
+      return evaluate_kinsol_function(solver,
+                                      unwrap_nvector<VectorType>(yy),
+                                      unwrap_nvector<VectorType>(FF));
+    }
+
+
+
+    template<typename VectorType>
+    int t_kinsol_setup_jacobian(KINMem kinsol_mem)
+    {
+      KINSOL<VectorType> &solver = *static_cast<KINSOL<VectorType> *>(kinsol_mem->kin_user_data);
 
-      int err = solver.setup_jacobian(*src_ycur, *src_fcur);
+      int err = solver.setup_jacobian(unwrap_nvector<VectorType>(kinsol_mem->kin_uu),
+                                      unwrap_nvector<VectorType>(kinsol_mem->kin_fval));
       return err;
     }
 
@@ -105,28 +138,11 @@ namespace SUNDIALS
                                 realtype *sFdotJp)
     {
       KINSOL<VectorType> &solver = *static_cast<KINSOL<VectorType> *>(kinsol_mem->kin_user_data);
-      GrowingVectorMemory<VectorType> mem;
-
-      typename VectorMemory<VectorType>::Pointer src_ycur(mem);
-      solver.reinit_vector(*src_ycur);
-
-      typename VectorMemory<VectorType>::Pointer src_fcur(mem);
-      solver.reinit_vector(*src_fcur);
-
-      copy(*src_ycur, kinsol_mem->kin_uu);
-      copy(*src_fcur, kinsol_mem->kin_fval);
-
-      typename VectorMemory<VectorType>::Pointer src(mem);
-      solver.reinit_vector(*src);
-
-      typename VectorMemory<VectorType>::Pointer dst(mem);
-      solver.reinit_vector(*dst);
 
-      copy(*src, b);
-
-      int err = solver.solve_jacobian_system(*src_ycur, *src_fcur,
-                                             *src,*dst);
-      copy(x, *dst);
+      int err = solver.solve_jacobian_system(unwrap_nvector<VectorType>(kinsol_mem->kin_uu),
+                                             unwrap_nvector<VectorType>(kinsol_mem->kin_fval),
+                                             unwrap_nvector<VectorType>(b),
+                                             unwrap_nvector<VectorType>(x));
 
       *sJpnorm = N_VWL2Norm(b, kinsol_mem->kin_fscale);
       N_VProd(b, kinsol_mem->kin_fscale, b);
@@ -165,48 +181,45 @@ namespace SUNDIALS
   {
     unsigned int system_size = initial_guess_and_solution.size();
 
-    // The solution is stored in
-    // solution. Here we take only a
-    // view of it.
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
+    // The dense direct solver of KINSOL is used if no linear solver is
+    // provided. It requires the serial vectors of SUNDIALS, whereas the
+    // vectors store deal.II vectors otherwise.
+    const bool use_dense_solver = !solve_jacobian_system;
+    if (use_dense_solver)
       {
-        const IndexSet is = initial_guess_and_solution.locally_owned_elements();
-        const unsigned int local_system_size = is.n_elements();
-
-        solution        = N_VNew_Parallel(communicator,
-                                          local_system_size,
-                                          system_size);
-
-        u_scale = N_VNew_Parallel(communicator,
-                                  local_system_size,
-                                  system_size);
-        N_VConst_Parallel( 1.e0, u_scale );
-
-        f_scale = N_VNew_Parallel(communicator,
-                                  local_system_size,
-                                  system_size);
-        N_VConst_Parallel( 1.e0, f_scale );
-      }
-    else
-#endif
-      {
-        Assert(is_serial_vector<VectorType>::value,
-               ExcInternalError("Trying to use a serial code with a parallel vector."));
+        AssertThrow(is_serial_vector<VectorType>::value,
+                    ExcMessage("The dense direct solver of KINSOL can only be "
+                               "used with serial vectors. Provide the function "
+                               "solve_jacobian_system for parallel vectors."));
         solution = N_VNew_Serial(system_size);
         u_scale  = N_VNew_Serial(system_size);
-        N_VConst_Serial( 1.e0, u_scale );
         f_scale  = N_VNew_Serial(system_size);
-        N_VConst_Serial( 1.e0, f_scale );
+        copy_to_serial(solution, initial_guess_and_solution);
+      }
+    else
+      {
+        solution = create_nvector(initial_guess_and_solution, communicator);
+        u_scale  = create_nvector(initial_guess_and_solution, communicator);
+        f_scale  = create_nvector(initial_guess_and_solution, communicator);
       }
+    N_VConst( 1.e0, u_scale );
+    N_VConst( 1.e0, f_scale );
 
     if (get_solution_scaling)
-      copy(u_scale, get_solution_scaling());
+      {
+        if (use_dense_solver)
+          copy_to_serial(u_scale, get_solution_scaling());
+        else
+          unwrap_nvector<VectorType>(u_scale) = get_solution_scaling();
+      }
 
     if (get_function_scaling)
-      copy(f_scale, get_function_scaling());
-
-    copy(solution, initial_guess_and_solution);
+      {
+        if (use_dense_solver)
+          copy_to_serial(f_scale, get_function_scaling());
+        else
+          unwrap_nvector<VectorType>(f_scale) = get_function_scaling();
+      }
 
     if (kinsol_mem)
       KINFree(&kinsol_mem);
@@ -247,7 +260,7 @@ namespace SUNDIALS
     status = KINSetRelErrFunc(kinsol_mem, data.dq_relative_error);
     AssertKINSOL(status);
 
-    if (solve_jacobian_system)
+    if (use_dense_solver == false)
       {
         KINMem KIN_mem = (KINMem) kinsol_mem;
         KIN_mem->kin_lsolve = t_kinsol_solve_jacobian<VectorType>;
@@ -275,23 +288,15 @@ namespace SUNDIALS
     status = KINSol(kinsol_mem, solution, (int) data.strategy, u_scale, f_scale);
     AssertKINSOL(status);
 
-    copy(initial_guess_and_solution, solution );
+    if (use_dense_solver)
+      copy_from_serial(initial_guess_and_solution, solution);
+    else
+      initial_guess_and_solution = unwrap_nvector<VectorType>(solution);
 
     // Free the vectors which are no longer used.
-#ifdef DEAL_II_WITH_MPI
-    if (is_serial_vector<VectorType>::value == false)
-      {
-        N_VDestroy_Parallel(solution);
-        N_VDestroy_Parallel(u_scale);
-        N_VDestroy_Parallel(f_scale);
-      }
-    else
-#endif
-      {
-        N_VDestroy_Serial(solution);
-        N_VDestroy_Serial(u_scale);
-        N_VDestroy_Serial(f_scale);
-      }
+    N_VDestroy(solution);
+    N_VDestroy(u_scale);
+    N_VDestroy(f_scale);
 
     long nniters;
     status = KINGetNumNonlinSolvIters(kinsol_mem, &nniters);
@@ -316,6 +321,7 @@ namespace SUNDIALS
 
   template class KINSOL<Vector<double> >;
   template class KINSOL<BlockVector<double> >;
+  template class KINSOL<LinearAlgebra::distributed::Vector<double> >;
 
 #ifdef DEAL_II_WITH_MPI
 
@@ -0,0 +1,142 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// solve the five-point finite difference discretization of the Laplacian
+// with SolverCG and PreconditionAMG, for several sizes and settings of
+// PreconditionAMG::AdditionalData, and record the number of levels and
+// iterations
+
+#include "../tests.h"
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/precondition_amg.h>
+
+
+void
+make_laplace_matrix (const unsigned int    n,
+                     SparsityPattern      &sparsity,
+                     SparseMatrix<double> &matrix)
+{
+  const unsigned int size = n*n;
+  DynamicSparsityPattern dsp (size, size);
+  for (unsigned int i=0; i<n; ++i)
+    for (unsigned int j=0; j<n; ++j)
+      {
+        const unsigned int row = i*n+j;
+        dsp.add (row, row);
+        if (i > 0)
+          dsp.add (row, row-n);
+        if (i < n-1)
+          dsp.add (row, row+n);
+        if (j > 0)
+          dsp.add (row, row-1);
+        if (j < n-1)
+          dsp.add (row, row+1);
+      }
+  sparsity.copy_from (dsp);
+  matrix.reinit (sparsity);
+  for (unsigned int row=0; row<size; ++row)
+    for (SparseMatrix<double>::iterator it=matrix.begin(row);
+         it!=matrix.end(row); ++it)
+      it->value() = (it->column() == row ? 4. : -1.);
+}
+
+
+
+void
+solve (const SparseMatrix<double>              &matrix,
+       const PreconditionAMG::AdditionalData &data,
+       const std::string                       &description)
+{
+  PreconditionAMG amg;
+  amg.initialize (matrix, data);
+
+  Vector<double> rhs (matrix.m()), solution (matrix.m());
+  rhs = 1.;
+
+  SolverControl control (200, 1e-10 * rhs.l2_norm());
+  SolverCG<> solver (control);
+  solver.solve (matrix, solution, rhs, amg);
+
+  // check the solution against the residual computed by hand
+  Vector<double> residual (matrix.m());
+  matrix.residual (residual, solution, rhs);
+
+  deallog << description << ": " << amg.n_levels() << " levels, "
+          << control.last_step() << " iterations, residual "
+          << (residual.l2_norm() <= 1e-10 * rhs.l2_norm() ? "OK" : "FAILED")
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+  // do not print the steps of the solver
+  deallog.depth_file(1);
+
+  for (unsigned int n=32; n<=128; n*=2)
+    {
+      SparsityPattern sparsity;
+      SparseMatrix<double> matrix;
+      make_laplace_matrix (n, sparsity, matrix);
+      deallog << "Size " << matrix.m() << std::endl;
+
+      {
+        SolverControl control (1000, 1e-10 * std::sqrt(double(matrix.m())));
+        SolverCG<> solver (control);
+        Vector<double> rhs (matrix.m()), solution (matrix.m());
+        rhs = 1.;
+        solver.solve (matrix, solution, rhs, PreconditionIdentity());
+        deallog << "No preconditioner: " << control.last_step()
+                << " iterations" << std::endl;
+      }
+
+      solve (matrix, PreconditionAMG::AdditionalData(), "Default");
+
+      PreconditionAMG::AdditionalData data;
+      data.coarse_size = 50;
+      solve (matrix, data, "coarse_size=50");
+
+      data.n_cycles = 2;
+      solve (matrix, data, "coarse_size=50, n_cycles=2");
+
+      data = PreconditionAMG::AdditionalData();
+      data.coarse_size = 50;
+      data.smoother_sweeps = 4;
+      solve (matrix, data, "coarse_size=50, smoother_sweeps=4");
+
+      // a threshold larger than the ratio of the off-diagonal entries to
+      // the diagonal, 1/4, leaves all unknowns unaggregated, such that no
+      // coarse level is created
+      data = PreconditionAMG::AdditionalData();
+      data.coarse_size = 50;
+      data.aggregation_threshold = 0.3;
+      solve (matrix, data, "coarse_size=50, aggregation_threshold=0.3");
+
+      data = PreconditionAMG::AdditionalData();
+      data.coarse_size = 50;
+      data.max_levels = 2;
+      solve (matrix, data, "coarse_size=50, max_levels=2");
+    }
+}
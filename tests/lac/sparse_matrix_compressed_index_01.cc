@@ -0,0 +1,148 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check SparseMatrixCompressedIndex against SparseMatrix for a banded
+// matrix, which uses 16 bit column offsets, and for the same matrix with
+// one row whose columns span more than 2^16 entries, which switches to 32
+// bit offsets
+
+#include "../tests.h"
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparse_matrix_compressed_index.h>
+#include <deal.II/lac/vector.h>
+
+
+template <typename number>
+void test (const bool long_row)
+{
+  const unsigned int n = 70000;
+  DynamicSparsityPattern dsp (n, n);
+  for (unsigned int i=0; i<n; ++i)
+    for (unsigned int j=(i<3 ? 0 : i-3); j<std::min(n, i+4); ++j)
+      dsp.add (i, j);
+  if (long_row)
+    {
+      // the distance between the first and the last column of row 5 is
+      // larger than what fits into 16 bits
+      dsp.add (5, 66000);
+      dsp.add (5, n-1);
+    }
+  SparsityPattern sparsity;
+  sparsity.copy_from (dsp);
+
+  SparseMatrix<number> matrix (sparsity);
+  for (unsigned int i=0; i<n; ++i)
+    for (typename SparseMatrix<number>::iterator it=matrix.begin(i);
+         it != matrix.end(i); ++it)
+      it->value() = (it->column() == i ?
+                     number(8.) :
+                     -number(1. + (i + 2*it->column()) % 5) / number(4.));
+
+  SparseMatrixCompressedIndex<number> compressed;
+  compressed.reinit (matrix);
+  deallog << "Bits per index: " << compressed.bits_per_index() << std::endl;
+  AssertThrow (compressed.m() == n && compressed.n() == n,
+               ExcInternalError());
+  AssertThrow (compressed.n_nonzero_elements() == matrix.n_nonzero_elements(),
+               ExcInternalError());
+
+  // the entries must be decoded to the same columns in the same order
+  bool entries_match = true;
+  for (unsigned int i=0; i<n; ++i)
+    {
+      typename SparseMatrix<number>::const_iterator it = matrix.begin(i);
+      typename SparseMatrixCompressedIndex<number>::const_iterator
+      c_it = compressed.begin(i);
+      for ( ; it != matrix.end(i); ++it, ++c_it)
+        if (c_it == compressed.end(i) ||
+            c_it->row() != i ||
+            c_it->column() != it->column() ||
+            c_it->value() != it->value())
+          entries_match = false;
+      if (c_it != compressed.end(i))
+        entries_match = false;
+    }
+  deallog << "Iterators: " << (entries_match ? "OK" : "FAILED") << std::endl;
+
+  deallog << "el(5,6) = " << compressed.el(5,6)
+          << ", el(5,n-1) = " << compressed.el(5,n-1)
+          << ", el(5,100) = " << compressed.el(5,100)
+          << ", diag_element(5) = " << compressed.diag_element(5)
+          << std::endl;
+
+  Vector<number> src (n), ref (n), dst (n);
+  for (unsigned int i=0; i<n; ++i)
+    src(i) = number(1. + i % 13) / number(7.);
+
+  const double tolerance = std::numeric_limits<number>::epsilon() * 100.;
+
+  matrix.vmult (ref, src);
+  compressed.vmult (dst, src);
+  dst -= ref;
+  deallog << "vmult: "
+          << (dst.linfty_norm() / ref.linfty_norm() < tolerance ? "OK" : "FAILED")
+          << std::endl;
+
+  compressed.vmult (dst, src);
+  compressed.vmult_add (dst, src);
+  dst.add (-2., ref);
+  deallog << "vmult_add: "
+          << (dst.linfty_norm() / ref.linfty_norm() < tolerance ? "OK" : "FAILED")
+          << std::endl;
+
+  matrix.Tvmult (ref, src);
+  compressed.Tvmult (dst, src);
+  dst -= ref;
+  deallog << "Tvmult: "
+          << (dst.linfty_norm() / ref.linfty_norm() < tolerance ? "OK" : "FAILED")
+          << std::endl;
+
+  matrix.precondition_Jacobi (ref, src, number(0.8));
+  compressed.precondition_Jacobi (dst, src, number(0.8));
+  dst -= ref;
+  deallog << "precondition_Jacobi: "
+          << (dst.linfty_norm() / ref.linfty_norm() < tolerance ? "OK" : "FAILED")
+          << std::endl;
+
+  // new values on the same sparsity pattern
+  matrix *= number(2.);
+  compressed.copy_from (matrix);
+  matrix.vmult (ref, src);
+  compressed.vmult (dst, src);
+  dst -= ref;
+  deallog << "vmult after copy_from: "
+          << (dst.linfty_norm() / ref.linfty_norm() < tolerance ? "OK" : "FAILED")
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push("double");
+  test<double> (false);
+  test<double> (true);
+  deallog.pop();
+  deallog.push("float");
+  test<float> (false);
+  test<float> (true);
+  deallog.pop();
+}
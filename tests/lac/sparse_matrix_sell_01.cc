@@ -0,0 +1,139 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check SparseMatrixSELL::vmult, vmult_add, Tvmult, and Tvmult_add against
+// SparseMatrix on a matrix with rows of very different lengths, some of
+// them longer than the chunk size, for several windows of the sorting by
+// row length
+
+#include "../tests.h"
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparse_matrix_sell.h>
+#include <deal.II/lac/vector.h>
+
+
+template <typename number>
+void test (const unsigned int n_rows,
+           const unsigned int n_cols)
+{
+  // row i has 1 + (7*i)%23 entries, so the row lengths within every chunk
+  // differ and sorting them changes the layout
+  DynamicSparsityPattern dsp (n_rows, n_cols);
+  for (unsigned int i=0; i<n_rows; ++i)
+    {
+      const unsigned int length = 1 + (7*i) % 23;
+      for (unsigned int k=0; k<length; ++k)
+        dsp.add (i, (i + 13*k) % n_cols);
+    }
+  SparsityPattern sparsity;
+  sparsity.copy_from (dsp);
+
+  SparseMatrix<number> matrix (sparsity);
+  for (unsigned int i=0; i<n_rows; ++i)
+    for (typename SparseMatrix<number>::iterator it=matrix.begin(i);
+         it != matrix.end(i); ++it)
+      it->value() = number(1. + (3*i + 5*it->column()) % 17) / number(4.);
+
+  Vector<number> src (n_cols), src_t (n_rows);
+  for (unsigned int i=0; i<n_cols; ++i)
+    src(i) = number(1. + i % 11) / number(3.);
+  for (unsigned int i=0; i<n_rows; ++i)
+    src_t(i) = number(2. + i % 7) / number(5.);
+
+  Vector<number> ref (n_rows), ref_t (n_cols);
+  matrix.vmult (ref, src);
+  matrix.Tvmult (ref_t, src_t);
+
+  deallog << "Matrix " << n_rows << "x" << n_cols << ", "
+          << sparsity.n_nonzero_elements() << " nonzero entries, max row length "
+          << sparsity.max_entries_per_row() << std::endl;
+
+  const unsigned int sigmas[] = {1, 8, 128, numbers::invalid_unsigned_int};
+  for (unsigned int s=0; s<4; ++s)
+    {
+      SparseMatrixSELL<number> sell;
+      sell.reinit (matrix, sigmas[s]);
+      AssertThrow (sell.m() == n_rows && sell.n() == n_cols,
+                   ExcInternalError());
+      AssertThrow (sell.n_stored_elements() >= sparsity.n_nonzero_elements(),
+                   ExcInternalError());
+
+      Vector<number> dst (n_rows), dst_t (n_cols);
+      sell.vmult (dst, src);
+      dst -= ref;
+      const double error = dst.linfty_norm() / ref.linfty_norm();
+
+      sell.Tvmult (dst_t, src_t);
+      dst_t -= ref_t;
+      const double error_t = dst_t.linfty_norm() / ref_t.linfty_norm();
+
+      // the _add variants on top of the result of vmult/Tvmult
+      sell.vmult (dst, src);
+      sell.vmult_add (dst, src);
+      dst.add (-2., ref);
+      const double error_add = dst.linfty_norm() / ref.linfty_norm();
+
+      sell.Tvmult (dst_t, src_t);
+      sell.Tvmult_add (dst_t, src_t);
+      dst_t.add (-2., ref_t);
+      const double error_add_t = dst_t.linfty_norm() / ref_t.linfty_norm();
+
+      const double tolerance = std::numeric_limits<number>::epsilon() * 100.;
+      deallog << "sigma = "
+              << (sigmas[s] == numbers::invalid_unsigned_int ?
+                  std::string("all rows") : Utilities::int_to_string(sigmas[s]))
+              << ": vmult " << (error < tolerance ? "OK" : "FAILED")
+              << ", vmult_add " << (error_add < tolerance ? "OK" : "FAILED")
+              << ", Tvmult " << (error_t < tolerance ? "OK" : "FAILED")
+              << ", Tvmult_add " << (error_add_t < tolerance ? "OK" : "FAILED")
+              << std::endl;
+    }
+
+  // set up the layout from the sparsity pattern and transfer the values
+  // afterwards
+  SparseMatrixSELL<number> sell;
+  sell.reinit (sparsity, 16);
+  Vector<number> dst (n_rows);
+  sell.vmult (dst, src);
+  deallog << "Zero matrix from sparsity pattern: " << dst.linfty_norm()
+          << std::endl;
+  sell.copy_from (matrix);
+  sell.vmult (dst, src);
+  dst -= ref;
+  deallog << "After copy_from: "
+          << (dst.linfty_norm() / ref.linfty_norm() <
+              std::numeric_limits<number>::epsilon() * 100. ? "OK" : "FAILED")
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push("double");
+  test<double> (97, 97);
+  test<double> (200, 61);
+  deallog.pop();
+  deallog.push("float");
+  test<float> (97, 97);
+  test<float> (61, 200);
+  deallog.pop();
+}
@@ -0,0 +1,167 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that the solution of the condensed skeleton system of
+// StaticCondensation followed by the reconstruction of the interior unknowns
+// reproduces the solution of the full system, for a chain of one
+// dimensional cells with interior degrees of freedom that share their end
+// points. Also check vmult() with the stored condensed matrices against the
+// assembled skeleton matrix and solve with the object as matrix in SolverCG.
+
+#include "../tests.h"
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/static_condensation.h>
+
+
+void test (const unsigned int n_cells,
+           const unsigned int n_interior)
+{
+  // the skeleton unknowns are the n_cells+1 end points of the cells,
+  // numbered first, followed by the interior unknowns of each cell
+  const unsigned int n_skeleton = n_cells + 1;
+  const unsigned int n_total = n_skeleton + n_cells * n_interior;
+  const unsigned int dofs_per_cell = n_interior + 2;
+
+  FullMatrix<double> full_matrix (n_total, n_total);
+  Vector<double> full_rhs (n_total);
+
+  StaticCondensation<double> condensation;
+  condensation.reinit (n_cells,
+                       StaticCondensation<double>::AdditionalData(true));
+  FullMatrix<double> skeleton_matrix (n_skeleton, n_skeleton);
+  Vector<double> skeleton_rhs (n_skeleton);
+
+  FullMatrix<double> cell_matrix (dofs_per_cell, dofs_per_cell);
+  Vector<double> cell_rhs (dofs_per_cell);
+  FullMatrix<double> condensed_matrix;
+  Vector<double> condensed_rhs;
+  std::vector<types::global_dof_index> interior_indices (n_interior);
+  std::vector<types::global_dof_index> skeleton_indices (2);
+  for (unsigned int c=0; c<n_cells; ++c)
+    {
+      // a symmetric and diagonally dominant cell matrix that differs
+      // between the cells, with the interior unknowns first
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        {
+          for (unsigned int j=0; j<dofs_per_cell; ++j)
+            cell_matrix(i,j) = (i == j ?
+                                (4. + i) * (1. + 0.1*c) :
+                                -1. / (1. + std::abs(int(i)-int(j)) + 0.1*c));
+          cell_rhs(i) = 1. + 0.25*((i+c) % 3);
+        }
+
+      for (unsigned int i=0; i<n_interior; ++i)
+        interior_indices[i] = n_skeleton + c*n_interior + i;
+      skeleton_indices[0] = c;
+      skeleton_indices[1] = c+1;
+
+      std::vector<types::global_dof_index> cell_indices (interior_indices);
+      cell_indices.insert (cell_indices.end(), skeleton_indices.begin(),
+                           skeleton_indices.end());
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        {
+          for (unsigned int j=0; j<dofs_per_cell; ++j)
+            full_matrix(cell_indices[i], cell_indices[j]) += cell_matrix(i,j);
+          full_rhs(cell_indices[i]) += cell_rhs(i);
+        }
+
+      condensation.condense_cell (c, cell_matrix, cell_rhs,
+                                  interior_indices, skeleton_indices,
+                                  condensed_matrix, condensed_rhs);
+      AssertThrow (condensed_matrix.m() == 2 && condensed_matrix.n() == 2 &&
+                   condensed_rhs.size() == 2, ExcInternalError());
+      for (unsigned int i=0; i<2; ++i)
+        {
+          for (unsigned int j=0; j<2; ++j)
+            skeleton_matrix(skeleton_indices[i], skeleton_indices[j])
+            += condensed_matrix(i,j);
+          skeleton_rhs(skeleton_indices[i]) += condensed_rhs(i);
+        }
+    }
+
+  // reference solution of the full system
+  Vector<double> full_solution (n_total);
+  full_matrix.gauss_jordan ();
+  full_matrix.vmult (full_solution, full_rhs);
+
+  // solve the skeleton system, copy its solution into the vector of all
+  // unknowns, and reconstruct the interior unknowns in the same vector
+  FullMatrix<double> skeleton_inverse (skeleton_matrix);
+  skeleton_inverse.gauss_jordan ();
+  Vector<double> skeleton_solution (n_skeleton);
+  skeleton_inverse.vmult (skeleton_solution, skeleton_rhs);
+
+  Vector<double> solution (n_total);
+  for (unsigned int i=0; i<n_skeleton; ++i)
+    solution(i) = skeleton_solution(i);
+  condensation.reconstruct (solution, solution);
+  solution -= full_solution;
+  deallog << "Cells: " << n_cells << ", interior unknowns per cell: "
+          << n_interior << std::endl;
+  deallog << "Error of condensed solve and reconstruction: "
+          << filter_out_small_numbers(solution.linfty_norm() /
+                                      full_solution.linfty_norm(), 1e-12)
+          << std::endl;
+
+  // the condensed operator applied cell by cell
+  Vector<double> src (n_skeleton), dst (n_skeleton), ref (n_skeleton);
+  for (unsigned int i=0; i<n_skeleton; ++i)
+    src(i) = 1. + i % 4;
+  skeleton_matrix.vmult (ref, src);
+  condensation.vmult (dst, src);
+  dst -= ref;
+  deallog << "Error of vmult: "
+          << filter_out_small_numbers(dst.linfty_norm() / ref.linfty_norm(),
+                                      1e-12)
+          << std::endl;
+
+  Vector<double> diagonal (n_skeleton);
+  condensation.compute_diagonal (diagonal);
+  for (unsigned int i=0; i<n_skeleton; ++i)
+    diagonal(i) -= skeleton_matrix(i,i);
+  deallog << "Error of compute_diagonal: "
+          << filter_out_small_numbers(diagonal.linfty_norm(), 1e-12)
+          << std::endl;
+
+  // solve with the object as matrix
+  Vector<double> cg_solution (n_skeleton);
+  SolverControl control (100, 1e-13 * skeleton_rhs.l2_norm());
+  SolverCG<> solver (control);
+  solver.solve (condensation, cg_solution, skeleton_rhs,
+                PreconditionIdentity());
+  cg_solution -= skeleton_solution;
+  deallog << "Error of SolverCG on the condensed operator: "
+          << filter_out_small_numbers(cg_solution.linfty_norm() /
+                                      skeleton_solution.linfty_norm(), 1e-10)
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+  deallog.depth_file(1);
+
+  test (1, 3);
+  test (5, 3);
+  test (12, 7);
+}
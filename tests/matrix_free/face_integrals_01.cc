@@ -0,0 +1,264 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// compare the values, gradients, normal vectors and JxW values of
+// FEFaceEvaluation as well as the integration against the test functions
+// with FEFaceValues and FESubfaceValues on the interior and the exterior
+// side of the inner faces and on the boundary faces of a deformed mesh with
+// hanging nodes
+
+#include "../tests.h"
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_generic.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+
+template <int dim>
+Point<dim> deform (const Point<dim> &p)
+{
+  Point<dim> q = p;
+  q[0] += 0.08 * std::sin(numbers::PI * p[dim-1]) * (1.-p[0]*p[0]);
+  q[dim-1] += 0.05 * std::cos(0.5*numbers::PI * p[0]);
+  return q;
+}
+
+
+
+// compare the data of lane @p lane of @p phi, evaluated for the function
+// @p u, with the data of @p fe_values on the same face, matching the
+// quadrature points by their location. If @p integrated is false, the
+// values, gradients, normal vectors and JxW values are compared, otherwise
+// the result of integrating the values and the gradients of @p u against
+// the test functions. Returns the maximal difference.
+template <int dim, typename FEFaceEval>
+double
+compare (const FEFaceEval        &phi,
+         const unsigned int       lane,
+         const FEValuesBase<dim> &fe_values,
+         const Vector<double>    &u,
+         const double             diameter,
+         const bool               integrated)
+{
+  const unsigned int dofs_per_cell = fe_values.dofs_per_cell;
+  std::vector<double> values (fe_values.n_quadrature_points);
+  std::vector<Tensor<1,dim> > gradients (fe_values.n_quadrature_points);
+  fe_values.get_function_values (u, values);
+  fe_values.get_function_gradients (u, gradients);
+
+  double error = 0.;
+  std::vector<double> reference (dofs_per_cell);
+  for (unsigned int q=0; q<phi.n_q_points; ++q)
+    {
+      Point<dim> point;
+      for (unsigned int d=0; d<dim; ++d)
+        point[d] = phi.quadrature_point(q)[d][lane];
+      unsigned int q2 = 0;
+      for ( ; q2<fe_values.n_quadrature_points; ++q2)
+        if (point.distance(fe_values.quadrature_point(q2)) < 1e-12 * diameter)
+          break;
+      if (q2 == fe_values.n_quadrature_points)
+        return 1.;
+
+      if (integrated)
+        {
+          for (unsigned int i=0; i<dofs_per_cell; ++i)
+            reference[i] += (values[q2] * fe_values.shape_value(i,q2) +
+                             gradients[q2] * fe_values.shape_grad(i,q2)) *
+                            fe_values.JxW(q2);
+          continue;
+        }
+
+      Tensor<1,dim> gradient, normal;
+      for (unsigned int d=0; d<dim; ++d)
+        {
+          gradient[d] = phi.get_gradient(q)[d][lane];
+          normal[d] = phi.get_normal_vector(q)[d][lane];
+        }
+      error = std::max (error, std::abs(phi.get_value(q)[lane] - values[q2]));
+      error = std::max (error, (gradient - gradients[q2]).norm() * diameter);
+      error = std::max (error,
+                        std::abs(phi.get_normal_derivative(q)[lane] -
+                                 gradients[q2]*fe_values.normal_vector(q2)) *
+                        diameter);
+      error = std::max (error, (normal - fe_values.normal_vector(q2)).norm());
+      error = std::max (error,
+                        std::abs(phi.JxW(q)[lane] - fe_values.JxW(q2)) /
+                        std::pow(diameter, dim-1));
+    }
+
+  if (integrated)
+    for (unsigned int i=0; i<dofs_per_cell; ++i)
+      error = std::max (error, std::abs(phi.begin_dof_values()[i][lane] -
+                                        reference[i]));
+  return error;
+}
+
+
+
+template <int dim, typename FEFaceEval>
+void submit_evaluated_data (FEFaceEval &phi)
+{
+  for (unsigned int q=0; q<phi.n_q_points; ++q)
+    {
+      phi.submit_value (phi.get_value(q), q);
+      phi.submit_gradient (phi.get_gradient(q), q);
+    }
+  phi.integrate (true, true);
+}
+
+
+
+template <int dim, int fe_degree>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria, -1., 1.);
+  tria.refine_global (3-dim/2);
+  tria.begin_active()->set_refine_flag();
+  std::next (tria.begin_active(), tria.n_active_cells()/2+1)->set_refine_flag();
+  tria.execute_coarsening_and_refinement ();
+  GridTools::transform (&deform<dim>, tria);
+
+  FE_DGQ<dim> fe (fe_degree);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs (fe);
+  ConstraintMatrix constraints;
+  constraints.close ();
+  MappingQGeneric<dim> mapping (1);
+
+  const UpdateFlags face_flags = update_values | update_gradients |
+                                 update_JxW_values | update_normal_vectors |
+                                 update_quadrature_points;
+  typename MatrixFree<dim>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim>::AdditionalData::none;
+  data.mapping_update_flags_inner_faces = face_flags;
+  data.mapping_update_flags_boundary_faces = face_flags;
+  MatrixFree<dim> matrix_free;
+  matrix_free.reinit (mapping, dof, constraints, QGauss<1>(fe_degree+1), data);
+
+  Vector<double> u (dof.n_dofs());
+  for (unsigned int i=0; i<u.size(); ++i)
+    u(i) = std::sin (0.3 + 1.7*i);
+
+  QGauss<dim-1> quadrature (fe_degree+1);
+  FEFaceValues<dim> fe_face_values (mapping, fe, quadrature, face_flags);
+  FESubfaceValues<dim> fe_subface_values (mapping, fe, quadrature, face_flags);
+  FEFaceEvaluation<dim,fe_degree> phi_m (matrix_free, true);
+  FEFaceEvaluation<dim,fe_degree> phi_p (matrix_free, false);
+
+  const unsigned int n_lanes = VectorizedArray<double>::n_array_elements;
+  unsigned int n_inner_faces = 0, n_hanging_faces = 0, n_boundary_faces = 0;
+  double errors[3][2] = {{0., 0.}, {0., 0.}, {0., 0.}};
+  for (unsigned int face=0; face<matrix_free.n_inner_face_batches()+
+       matrix_free.n_boundary_face_batches(); ++face)
+    {
+      const bool is_inner_face = face < matrix_free.n_inner_face_batches();
+      const internal::MatrixFreeFunctions::FaceToCellTopology<n_lanes> &info =
+        matrix_free.get_face_info (face);
+
+      phi_m.reinit (face);
+      phi_m.read_dof_values (u);
+      phi_m.evaluate (true, true);
+      if (is_inner_face)
+        {
+          phi_p.reinit (face);
+          phi_p.read_dof_values (u);
+          phi_p.evaluate (true, true);
+        }
+
+      // first compare the evaluated data, then integrate and compare again
+      for (unsigned int integrated=0; integrated<2; ++integrated)
+        {
+          if (integrated)
+            {
+              submit_evaluated_data<dim> (phi_m);
+              if (is_inner_face)
+                submit_evaluated_data<dim> (phi_p);
+            }
+          for (unsigned int v=0; v<info.n_filled_lanes; ++v)
+            {
+              const typename DoFHandler<dim>::cell_iterator cell_m =
+                matrix_free.get_cell_iterator (info.cells_interior[v] / n_lanes,
+                                               info.cells_interior[v] % n_lanes);
+              const double diameter = cell_m->diameter();
+              fe_face_values.reinit (cell_m, info.interior_face_no);
+              const unsigned int side = is_inner_face ? 0 : 2;
+              errors[side][integrated] =
+                std::max (errors[side][integrated],
+                          compare (phi_m, v, fe_face_values, u, diameter, integrated));
+              if (!is_inner_face)
+                {
+                  n_boundary_faces += 1-integrated;
+                  continue;
+                }
+
+              n_inner_faces += 1-integrated;
+              const typename DoFHandler<dim>::cell_iterator cell_p =
+                matrix_free.get_cell_iterator (info.cells_exterior[v] / n_lanes,
+                                               info.cells_exterior[v] % n_lanes);
+              double error_p;
+              if (info.subface_index == info.invalid_subface_index)
+                {
+                  fe_face_values.reinit (cell_p, info.exterior_face_no);
+                  error_p = compare (phi_p, v, fe_face_values, u, diameter,
+                                     integrated);
+                }
+              else
+                {
+                  n_hanging_faces += 1-integrated;
+                  fe_subface_values.reinit (cell_p, info.exterior_face_no,
+                                            info.subface_index);
+                  error_p = compare (phi_p, v, fe_subface_values, u, diameter,
+                                     integrated);
+                }
+              errors[1][integrated] = std::max (errors[1][integrated], error_p);
+            }
+        }
+    }
+
+  deallog << fe.get_name() << " on " << tria.n_active_cells() << " cells: "
+          << n_inner_faces << " inner faces (" << n_hanging_faces
+          << " with hanging nodes), " << n_boundary_faces
+          << " boundary faces" << std::endl;
+  const char *names[3] = {"interior side", "exterior side", "boundary faces"};
+  for (unsigned int side=0; side<3; ++side)
+    deallog << names[side] << ": evaluate "
+            << (errors[side][0] < 1e-12 ? "OK" : "FAILED")
+            << ", integrate " << (errors[side][1] < 1e-12 ? "OK" : "FAILED")
+            << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2,1>();
+  test<2,2>();
+  test<2,3>();
+  test<3,1>();
+  test<3,2>();
+}
@@ -0,0 +1,348 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// apply the symmetric interior penalty discretization of the Laplacian with
+// MatrixFree::loop() on a deformed mesh with hanging nodes and compare the
+// result of the cell, inner face and boundary face operations with the
+// matrix assembled by FEValues, FEFaceValues and FESubfaceValues
+
+#include "../tests.h"
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_generic.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+
+template <int dim>
+Point<dim> deform (const Point<dim> &p)
+{
+  Point<dim> q = p;
+  q[0] += 0.08 * std::sin(numbers::PI * p[dim-1]) * (1.-p[0]*p[0]);
+  q[dim-1] += 0.05 * std::cos(0.5*numbers::PI * p[0]);
+  return q;
+}
+
+
+
+template <int dim, int fe_degree>
+class LaplaceOperator
+{
+public:
+  LaplaceOperator (const MatrixFree<dim> &matrix_free,
+                   const double           penalty)
+    :
+    matrix_free (matrix_free),
+    penalty (penalty)
+  {}
+
+  void vmult (Vector<double>       &dst,
+              const Vector<double> &src) const
+  {
+    dst = 0.;
+    matrix_free.loop (&LaplaceOperator::local_apply_cell,
+                      &LaplaceOperator::local_apply_face,
+                      &LaplaceOperator::local_apply_boundary,
+                      this, dst, src);
+  }
+
+private:
+  void local_apply_cell (const MatrixFree<dim>                       &data,
+                         Vector<double>                              &dst,
+                         const Vector<double>                        &src,
+                         const std::pair<unsigned int,unsigned int> &cell_range) const
+  {
+    FEEvaluation<dim,fe_degree> phi (data);
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+      {
+        phi.reinit (cell);
+        phi.read_dof_values (src);
+        phi.evaluate (false, true);
+        for (unsigned int q=0; q<phi.n_q_points; ++q)
+          phi.submit_gradient (phi.get_gradient(q), q);
+        phi.integrate (false, true);
+        phi.distribute_local_to_global (dst);
+      }
+  }
+
+  void local_apply_face (const MatrixFree<dim>                       &data,
+                         Vector<double>                              &dst,
+                         const Vector<double>                        &src,
+                         const std::pair<unsigned int,unsigned int> &face_range) const
+  {
+    FEFaceEvaluation<dim,fe_degree> phi_m (data, true);
+    FEFaceEvaluation<dim,fe_degree> phi_p (data, false);
+    for (unsigned int face=face_range.first; face<face_range.second; ++face)
+      {
+        phi_m.reinit (face);
+        phi_m.read_dof_values (src);
+        phi_m.evaluate (true, true);
+        phi_p.reinit (face);
+        phi_p.read_dof_values (src);
+        phi_p.evaluate (true, true);
+        for (unsigned int q=0; q<phi_m.n_q_points; ++q)
+          {
+            // the normal derivative on the exterior side is taken with
+            // respect to the outer normal of the exterior cell
+            const VectorizedArray<double> jump = phi_m.get_value(q) - phi_p.get_value(q);
+            const VectorizedArray<double> average_normal_derivative =
+              0.5 * (phi_m.get_normal_derivative(q) - phi_p.get_normal_derivative(q));
+            const VectorizedArray<double> flux = penalty * jump - average_normal_derivative;
+            phi_m.submit_value (flux, q);
+            phi_p.submit_value (-flux, q);
+            phi_m.submit_normal_derivative (-0.5*jump, q);
+            phi_p.submit_normal_derivative (0.5*jump, q);
+          }
+        phi_m.integrate (true, true);
+        phi_m.distribute_local_to_global (dst);
+        phi_p.integrate (true, true);
+        phi_p.distribute_local_to_global (dst);
+      }
+  }
+
+  void local_apply_boundary (const MatrixFree<dim>                       &data,
+                             Vector<double>                              &dst,
+                             const Vector<double>                        &src,
+                             const std::pair<unsigned int,unsigned int> &face_range) const
+  {
+    // homogeneous Dirichlet conditions imposed weakly by the mirror
+    // principle u^+ = -u^-
+    FEFaceEvaluation<dim,fe_degree> phi (data, true);
+    for (unsigned int face=face_range.first; face<face_range.second; ++face)
+      {
+        phi.reinit (face);
+        phi.read_dof_values (src);
+        phi.evaluate (true, true);
+        for (unsigned int q=0; q<phi.n_q_points; ++q)
+          {
+            const VectorizedArray<double> value = phi.get_value(q);
+            phi.submit_value (2.*penalty*value - phi.get_normal_derivative(q), q);
+            phi.submit_normal_derivative (-value, q);
+          }
+        phi.integrate (true, true);
+        phi.distribute_local_to_global (dst);
+      }
+  }
+
+  const MatrixFree<dim> &matrix_free;
+  const double penalty;
+};
+
+
+
+// find the quadrature point of @p fe_p at the same location as each of the
+// quadrature points of @p fe_m, since the two sides of a face need not
+// enumerate the points in the same order
+template <int dim>
+std::vector<unsigned int>
+match_quadrature_points (const FEValuesBase<dim> &fe_m,
+                         const FEValuesBase<dim> &fe_p)
+{
+  std::vector<unsigned int> permutation (fe_m.n_quadrature_points);
+  for (unsigned int q=0; q<fe_m.n_quadrature_points; ++q)
+    {
+      unsigned int q2 = 0;
+      while (q2<fe_p.n_quadrature_points &&
+             fe_m.quadrature_point(q).distance(fe_p.quadrature_point(q2)) > 1e-12)
+        ++q2;
+      AssertIndexRange (q2, fe_p.n_quadrature_points);
+      permutation[q] = q2;
+    }
+  return permutation;
+}
+
+
+
+// add the face terms between the test functions of @p fe_test and the trial
+// functions of @p fe_trial to @p matrix, where the jump is taken with the
+// signs @p sign_test and @p sign_trial and @p fe_m defines the quadrature
+// points and the normal
+template <int dim>
+void assemble_face_block (const FEValuesBase<dim>                    &fe_m,
+                          const FEValuesBase<dim>                    &fe_test,
+                          const std::vector<unsigned int>            &q_test,
+                          const FEValuesBase<dim>                    &fe_trial,
+                          const std::vector<unsigned int>            &q_trial,
+                          const double                                sign_test,
+                          const double                                sign_trial,
+                          const double                                penalty,
+                          const std::vector<types::global_dof_index> &test_indices,
+                          const std::vector<types::global_dof_index> &trial_indices,
+                          FullMatrix<double>                         &matrix)
+{
+  for (unsigned int q=0; q<fe_m.n_quadrature_points; ++q)
+    {
+      const Tensor<1,dim> normal = fe_m.normal_vector(q);
+      const unsigned int qi = q_test[q], qj = q_trial[q];
+      for (unsigned int i=0; i<fe_test.dofs_per_cell; ++i)
+        for (unsigned int j=0; j<fe_trial.dofs_per_cell; ++j)
+          matrix(test_indices[i], trial_indices[j]) +=
+            (penalty * sign_test * sign_trial *
+             fe_test.shape_value(i,qi) * fe_trial.shape_value(j,qj)
+             -
+             0.5 * sign_test * fe_test.shape_value(i,qi) *
+             (fe_trial.shape_grad(j,qj) * normal)
+             -
+             0.5 * sign_trial * fe_trial.shape_value(j,qj) *
+             (fe_test.shape_grad(i,qi) * normal)) * fe_m.JxW(q);
+    }
+}
+
+
+
+template <int dim, int fe_degree>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria, -1., 1.);
+  tria.refine_global (4-dim);
+  tria.begin_active()->set_refine_flag();
+  std::next (tria.begin_active(), tria.n_active_cells()/2+1)->set_refine_flag();
+  tria.execute_coarsening_and_refinement ();
+  GridTools::transform (&deform<dim>, tria);
+
+  FE_DGQ<dim> fe (fe_degree);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs (fe);
+  ConstraintMatrix constraints;
+  constraints.close ();
+  MappingQGeneric<dim> mapping (1);
+  const double penalty = 10. * (fe_degree+1) * (fe_degree+1);
+
+  const UpdateFlags face_flags = update_values | update_gradients |
+                                 update_JxW_values | update_normal_vectors;
+  typename MatrixFree<dim>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim>::AdditionalData::none;
+  data.mapping_update_flags_inner_faces = face_flags;
+  data.mapping_update_flags_boundary_faces = face_flags;
+  MatrixFree<dim> matrix_free;
+  matrix_free.reinit (mapping, dof, constraints, QGauss<1>(fe_degree+1), data);
+
+  // assemble the matrix, visiting each inner face from the finer side or
+  // from the cell with the smaller id
+  FullMatrix<double> matrix (dof.n_dofs(), dof.n_dofs());
+  QGauss<dim-1> face_quadrature (fe_degree+1);
+  FEValues<dim> fe_values (mapping, fe, QGauss<dim>(fe_degree+1),
+                           update_gradients | update_JxW_values);
+  FEFaceValues<dim> fe_face_m (mapping, fe, face_quadrature,
+                               face_flags | update_quadrature_points);
+  FEFaceValues<dim> fe_face_p (mapping, fe, face_quadrature,
+                               face_flags | update_quadrature_points);
+  FESubfaceValues<dim> fe_subface_p (mapping, fe, face_quadrature,
+                                     face_flags | update_quadrature_points);
+  std::vector<types::global_dof_index> indices_m (fe.dofs_per_cell),
+      indices_p (fe.dofs_per_cell);
+  std::vector<unsigned int> identity (face_quadrature.size());
+  for (unsigned int q=0; q<identity.size(); ++q)
+    identity[q] = q;
+  for (typename DoFHandler<dim>::active_cell_iterator cell=dof.begin_active();
+       cell!=dof.end(); ++cell)
+    {
+      cell->get_dof_indices (indices_m);
+      fe_values.reinit (cell);
+      for (unsigned int q=0; q<fe_values.n_quadrature_points; ++q)
+        for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+          for (unsigned int j=0; j<fe.dofs_per_cell; ++j)
+            matrix(indices_m[i], indices_m[j]) +=
+              fe_values.shape_grad(i,q) * fe_values.shape_grad(j,q) *
+              fe_values.JxW(q);
+
+      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+        if (cell->at_boundary(f))
+          {
+            // the mirror principle doubles the jump of both the solution
+            // and the test functions
+            fe_face_m.reinit (cell, f);
+            assemble_face_block (fe_face_m, fe_face_m, identity, fe_face_m,
+                                 identity, 2., 2., 0.5*penalty, indices_m,
+                                 indices_m, matrix);
+          }
+        else if (cell->neighbor(f)->has_children() == false)
+          {
+            const typename DoFHandler<dim>::cell_iterator neighbor = cell->neighbor(f);
+            const FEValuesBase<dim> *fe_p = nullptr;
+            if (cell->neighbor_is_coarser(f))
+              {
+                const std::pair<unsigned int,unsigned int> neighbor_face =
+                  cell->neighbor_of_coarser_neighbor(f);
+                fe_subface_p.reinit (neighbor, neighbor_face.first,
+                                     neighbor_face.second);
+                fe_p = &fe_subface_p;
+              }
+            else if (cell->id() < neighbor->id())
+              {
+                fe_face_p.reinit (neighbor, cell->neighbor_of_neighbor(f));
+                fe_p = &fe_face_p;
+              }
+            else
+              continue;
+
+            fe_face_m.reinit (cell, f);
+            neighbor->get_dof_indices (indices_p);
+            const std::vector<unsigned int> permutation =
+              match_quadrature_points (fe_face_m, *fe_p);
+            assemble_face_block (fe_face_m, fe_face_m, identity, fe_face_m,
+                                 identity, 1., 1., penalty, indices_m,
+                                 indices_m, matrix);
+            assemble_face_block (fe_face_m, fe_face_m, identity, *fe_p,
+                                 permutation, 1., -1., penalty, indices_m,
+                                 indices_p, matrix);
+            assemble_face_block (fe_face_m, *fe_p, permutation, fe_face_m,
+                                 identity, -1., 1., penalty, indices_p,
+                                 indices_m, matrix);
+            assemble_face_block (fe_face_m, *fe_p, permutation, *fe_p,
+                                 permutation, -1., -1., penalty, indices_p,
+                                 indices_p, matrix);
+          }
+    }
+
+  Vector<double> src (dof.n_dofs()), result (dof.n_dofs()),
+         reference (dof.n_dofs());
+  for (unsigned int i=0; i<src.size(); ++i)
+    src(i) = std::sin (0.3 + 1.7*i);
+  matrix.vmult (reference, src);
+
+  LaplaceOperator<dim,fe_degree> laplace (matrix_free, penalty);
+  laplace.vmult (result, src);
+  result -= reference;
+
+  deallog << fe.get_name() << " on " << tria.n_active_cells()
+          << " cells, relative error matrix-free vs assembled: "
+          << filter_out_small_numbers (result.linfty_norm() /
+                                       reference.linfty_norm(), 1e-12)
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2,1>();
+  test<2,2>();
+  test<2,3>();
+  test<3,1>();
+  test<3,2>();
+}
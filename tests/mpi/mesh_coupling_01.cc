@@ -0,0 +1,182 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// couple two non-matching distributed meshes with NonMatching::MeshCoupling
+// and compare the coupling matrix between the Q1 basis functions of both
+// meshes with the one computed on serial copies of the meshes. Since the
+// numbering of the degrees of freedom differs between the serial and the
+// distributed meshes, the entries of the matrix are identified by the
+// locations of the vertices the basis functions belong to. The second mesh
+// is a structured mesh with cells of size h, so the vertices of its cells
+// can be computed from the location of a point and its reference
+// coordinates in the cell, also for cells that are not available on the
+// current processor.
+
+#include "../tests.h"
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/non_matching/mesh_coupling.h>
+
+#include <array>
+#include <map>
+
+
+template <int dim>
+using MatrixKey = std::array<long long, 2*dim>;
+
+
+
+template <int dim>
+void
+fill_mesh (Triangulation<dim> &first,
+           Triangulation<dim> &second,
+           const double        h)
+{
+  GridGenerator::hyper_cube (first);
+  first.refine_global (3);
+  for (typename Triangulation<dim>::active_cell_iterator cell=first.begin_active();
+       cell!=first.end(); ++cell)
+    if (cell->is_locally_owned() && cell->center()[0] < 0.3)
+      cell->set_refine_flag();
+  first.execute_coarsening_and_refinement ();
+
+  std::vector<unsigned int> subdivisions (dim, 5);
+  Point<dim> lower, upper;
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      lower[d] = -0.2;
+      upper[d] = -0.2 + 10 * h;
+    }
+  GridGenerator::subdivided_hyper_rectangle (second, subdivisions, lower, upper);
+  second.refine_global (1);
+}
+
+
+
+// compute the entries of the coupling matrix of the locally owned cells of
+// the first mesh and the number of cell pairs and quadrature points
+template <int dim>
+std::map<MatrixKey<dim>,double>
+compute_coupling_matrix (const Triangulation<dim> &first,
+                         const Triangulation<dim> &second,
+                         const double              h,
+                         unsigned int             &n_pairs,
+                         unsigned int             &n_points)
+{
+  NonMatching::MeshCoupling<dim> coupling (first, second,
+                                           QIterated<dim>(QGauss<1>(2), 2));
+  coupling.update ();
+  n_pairs = coupling.get_cell_pairs().size();
+  n_points = coupling.n_quadrature_points();
+
+  const FE_Q<dim> fe (1);
+  const MappingQ1<dim> mapping;
+  std::map<MatrixKey<dim>,double> matrix;
+  for (const auto &pair : coupling.get_cell_pairs())
+    for (unsigned int q=0; q<pair.JxW.size(); ++q)
+      {
+        const Point<dim> unit_point = pair.second_unit_points[q];
+        const Point<dim> point =
+          mapping.transform_unit_to_real_cell (pair.first_cell,
+                                               pair.first_unit_points[q]);
+        for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+          for (unsigned int j=0; j<fe.dofs_per_cell; ++j)
+            {
+              MatrixKey<dim> key;
+              for (unsigned int d=0; d<dim; ++d)
+                {
+                  const double second_vertex =
+                    point[d] + (GeometryInfo<dim>::unit_cell_vertex(j)[d] -
+                                unit_point[d]) * h;
+                  key[d] = std::llround (pair.first_cell->vertex(i)[d] * 1e6);
+                  key[dim+d] = std::llround (second_vertex * 1e6);
+                }
+              matrix[key] += fe.shape_value(i, pair.first_unit_points[q]) *
+                             fe.shape_value(j, unit_point) * pair.JxW[q];
+            }
+      }
+  return matrix;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  const double h = 0.125;
+  unsigned int n_pairs, n_points;
+
+  Triangulation<dim> serial_first, serial_second;
+  fill_mesh (serial_first, serial_second, h);
+  const std::map<MatrixKey<dim>,double> reference =
+    compute_coupling_matrix (serial_first, serial_second, h, n_pairs, n_points);
+  deallog << "Serial: " << n_pairs << " cell pairs with " << n_points
+          << " quadrature points, " << reference.size() << " matrix entries"
+          << std::endl;
+
+  parallel::distributed::Triangulation<dim> first (MPI_COMM_WORLD);
+  parallel::distributed::Triangulation<dim> second (MPI_COMM_WORLD);
+  fill_mesh (first, second, h);
+  const std::map<MatrixKey<dim>,double> matrix =
+    compute_coupling_matrix (first, second, h, n_pairs, n_points);
+  deallog << "Distributed: "
+          << Utilities::MPI::sum (n_pairs, MPI_COMM_WORLD) << " cell pairs with "
+          << Utilities::MPI::sum (n_points, MPI_COMM_WORLD)
+          << " quadrature points" << std::endl;
+
+  // sum the entries of all processors in the order of the reference and
+  // count the entries not present in the reference
+  std::vector<double> entries (reference.size());
+  unsigned int n_unknown_entries = 0;
+  for (const auto &entry : matrix)
+    {
+      const auto position = reference.find (entry.first);
+      if (position == reference.end())
+        ++n_unknown_entries;
+      else
+        entries[std::distance(reference.begin(), position)] += entry.second;
+    }
+  Utilities::MPI::sum (entries, MPI_COMM_WORLD, entries);
+
+  double error = 0., sum = 0.;
+  unsigned int index = 0;
+  for (const auto &entry : reference)
+    {
+      error = std::max (error, std::abs(entries[index++] - entry.second));
+      sum += entry.second;
+    }
+  deallog << "Sum of all entries: " << sum << std::endl;
+  deallog << "Entries not in the reference: "
+          << Utilities::MPI::sum (n_unknown_entries, MPI_COMM_WORLD)
+          << ", maximal difference to the reference: "
+          << filter_out_small_numbers (error, 1e-13) << std::endl;
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  MPILogInitAll log;
+
+  test<2> ();
+  test<3> ();
+}
@@ -0,0 +1,207 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check the blocked SparseMatrix::vmult and vmult_add for
+// LinearAlgebra::distributed::MultiVector against SparseMatrix::vmult
+// applied to each column, and the column operations of a MultiVector
+// distributed among all processes against the ones of
+// LinearAlgebra::distributed::Vector
+
+#include "../tests.h"
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/la_parallel_multi_vector.h>
+
+
+void test_spmv (const unsigned int n_vectors)
+{
+  // SparseMatrix only works on sequential vectors, so every process runs
+  // the same check on its own
+  const unsigned int n = 157;
+  DynamicSparsityPattern dsp (n, n);
+  for (unsigned int i=0; i<n; ++i)
+    for (unsigned int k=0; k<1+i%9; ++k)
+      dsp.add (i, (i + 17*k) % n);
+  SparsityPattern sparsity;
+  sparsity.copy_from (dsp);
+  SparseMatrix<double> matrix (sparsity);
+  for (unsigned int i=0; i<n; ++i)
+    for (SparseMatrix<double>::iterator it=matrix.begin(i); it!=matrix.end(i); ++it)
+      it->value() = 1. + (i + 3*it->column()) % 7;
+
+  IndexSet all (n);
+  all.add_range (0, n);
+  std::shared_ptr<const Utilities::MPI::Partitioner> partitioner
+  (new Utilities::MPI::Partitioner (all, MPI_COMM_SELF));
+
+  LinearAlgebra::distributed::MultiVector<double> src (partitioner, n_vectors),
+                dst (partitioner, n_vectors);
+  for (unsigned int i=0; i<n; ++i)
+    for (unsigned int c=0; c<n_vectors; ++c)
+      src(i,c) = 1. + (i + 5*c) % 11;
+
+  matrix.vmult (dst, src);
+  double error = 0;
+  ::dealii::Vector<double> col_src (n), col_dst (n);
+  for (unsigned int c=0; c<n_vectors; ++c)
+    {
+      for (unsigned int i=0; i<n; ++i)
+        col_src(i) = src(i,c);
+      matrix.vmult (col_dst, col_src);
+      for (unsigned int i=0; i<n; ++i)
+        error = std::max (error, std::abs(dst(i,c) - col_dst(i)));
+    }
+  deallog << "SpMV with " << n_vectors << " columns: "
+          << (error < 1e-12 ? "OK" : "FAILED") << std::endl;
+
+  matrix.vmult_add (dst, src);
+  error = 0;
+  for (unsigned int c=0; c<n_vectors; ++c)
+    {
+      for (unsigned int i=0; i<n; ++i)
+        col_src(i) = src(i,c);
+      matrix.vmult (col_dst, col_src);
+      for (unsigned int i=0; i<n; ++i)
+        error = std::max (error, std::abs(dst(i,c) - 2.*col_dst(i)));
+    }
+  deallog << "SpMV add with " << n_vectors << " columns: "
+          << (error < 1e-12 ? "OK" : "FAILED") << std::endl;
+}
+
+
+
+void test_distributed (const unsigned int n_vectors)
+{
+  const unsigned int my_id = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+
+  // contiguous ranges of different sizes, with the first index of the next
+  // process and the last of the previous one as ghosts
+  const unsigned int n = 20 * n_procs + 3;
+  const unsigned int begin = 20*my_id + (my_id > 0 ? 3 : 0);
+  const unsigned int end = 20*(my_id+1) + 3;
+  IndexSet owned (n), ghosts (n);
+  owned.add_range (begin, end);
+  if (begin > 0)
+    ghosts.add_index (begin-1);
+  if (end < n)
+    ghosts.add_index (end);
+  std::shared_ptr<const Utilities::MPI::Partitioner> partitioner
+  (new Utilities::MPI::Partitioner (owned, ghosts, MPI_COMM_WORLD));
+
+  LinearAlgebra::distributed::MultiVector<double> u (partitioner, n_vectors),
+                v (partitioner, n_vectors);
+  std::vector<LinearAlgebra::distributed::Vector<double> >
+  u_col (n_vectors), v_col (n_vectors);
+  for (unsigned int c=0; c<n_vectors; ++c)
+    {
+      u_col[c].reinit (partitioner);
+      v_col[c].reinit (partitioner);
+      for (unsigned int i=begin; i<end; ++i)
+        {
+          u_col[c](i) = 1. + (i + c) % 5;
+          v_col[c](i) = 0.5 * ((2*i + 3*c) % 7);
+        }
+      u.insert_column (c, u_col[c]);
+      v.insert_column (c, v_col[c]);
+    }
+
+  std::vector<double> products, norms;
+  u.inner_products (v, products);
+  u.l2_norms (norms);
+  double error = 0;
+  for (unsigned int c=0; c<n_vectors; ++c)
+    error = std::max (error,
+                      std::abs(products[c] - (u_col[c] * v_col[c])) +
+                      std::abs(norms[c] - u_col[c].l2_norm()));
+  deallog << "Inner products and norms with " << n_vectors << " columns: "
+          << (error < 1e-10 ? "OK" : "FAILED") << std::endl;
+
+  std::vector<double> factors (n_vectors);
+  for (unsigned int c=0; c<n_vectors; ++c)
+    factors[c] = 0.5 + c;
+  u.add (factors, v);
+  u.sadd (factors, v);
+  error = 0;
+  LinearAlgebra::distributed::Vector<double> column (partitioner);
+  for (unsigned int c=0; c<n_vectors; ++c)
+    {
+      u_col[c].add (factors[c], v_col[c]);
+      u_col[c].sadd (factors[c], 1., v_col[c]);
+      u.extract_column (c, column);
+      column -= u_col[c];
+      error = std::max (error, column.linfty_norm());
+    }
+  deallog << "add and sadd with " << n_vectors << " columns: "
+          << (error < 1e-10 ? "OK" : "FAILED") << std::endl;
+
+  // the ghost exchange of all columns at once
+  u.update_ghost_values ();
+  error = 0;
+  for (unsigned int c=0; c<n_vectors; ++c)
+    {
+      u_col[c].update_ghost_values ();
+      for (unsigned int i=0; i<ghosts.n_elements(); ++i)
+        error = std::max (error,
+                          std::abs(u(ghosts.nth_index_in_set(i), c) -
+                                   u_col[c](ghosts.nth_index_in_set(i))));
+    }
+  deallog << "Ghost values with " << n_vectors << " columns: "
+          << (error < 1e-12 ? "OK" : "FAILED") << std::endl;
+
+  // add to the ghost entries and send them to their owners
+  u.zero_out_ghosts ();
+  for (unsigned int c=0; c<n_vectors; ++c)
+    {
+      u_col[c].zero_out_ghosts ();
+      for (unsigned int i=0; i<ghosts.n_elements(); ++i)
+        {
+          u(ghosts.nth_index_in_set(i), c) = 1. + c;
+          u_col[c](ghosts.nth_index_in_set(i)) = 1. + c;
+        }
+      u_col[c].compress (VectorOperation::add);
+    }
+  u.compress (VectorOperation::add);
+  error = 0;
+  for (unsigned int c=0; c<n_vectors; ++c)
+    {
+      u.extract_column (c, column);
+      column -= u_col[c];
+      error = std::max (error, column.linfty_norm());
+    }
+  deallog << "compress with " << n_vectors << " columns: "
+          << (error < 1e-12 ? "OK" : "FAILED") << std::endl;
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  MPILogInitAll log;
+
+  for (unsigned int n_vectors=1; n_vectors<=5; n_vectors+=2)
+    {
+      test_spmv (n_vectors);
+      test_distributed (n_vectors);
+    }
+}
@@ -0,0 +1,147 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that SolverMultiVectorCG on a distributed MultiVector computes the
+// same solutions as SolverCG applied to each column separately, for a one
+// dimensional finite difference Laplacian distributed among all processes
+// and several right hand sides
+
+#include "../tests.h"
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/la_parallel_multi_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_multi_vector_cg.h>
+
+
+// the operator 2.05*u_i - u_{i-1} - u_{i+1} with zero values outside the
+// domain, reading the neighbors across process boundaries from the ghosts
+class LaplaceOperator
+{
+public:
+  LaplaceOperator (const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner)
+    :
+    partitioner (partitioner)
+  {}
+
+  void vmult (LinearAlgebra::distributed::Vector<double>       &dst,
+              const LinearAlgebra::distributed::Vector<double> &src) const
+  {
+    src.update_ghost_values();
+    const IndexSet &owned = partitioner->locally_owned_range();
+    for (unsigned int i=owned.nth_index_in_set(0);
+         i<=owned.nth_index_in_set(owned.n_elements()-1); ++i)
+      dst(i) = 2.05 * src(i)
+               - (i > 0 ? src(i-1) : 0.)
+               - (i+1 < partitioner->size() ? src(i+1) : 0.);
+    const_cast<LinearAlgebra::distributed::Vector<double> &>(src).zero_out_ghosts();
+  }
+
+  void vmult (LinearAlgebra::distributed::MultiVector<double>       &dst,
+              const LinearAlgebra::distributed::MultiVector<double> &src) const
+  {
+    src.update_ghost_values();
+    const IndexSet &owned = partitioner->locally_owned_range();
+    for (unsigned int i=owned.nth_index_in_set(0);
+         i<=owned.nth_index_in_set(owned.n_elements()-1); ++i)
+      for (unsigned int c=0; c<src.n_vectors(); ++c)
+        dst(i,c) = 2.05 * src(i,c)
+                   - (i > 0 ? src(i-1,c) : 0.)
+                   - (i+1 < partitioner->size() ? src(i+1,c) : 0.);
+    const_cast<LinearAlgebra::distributed::MultiVector<double> &>(src).zero_out_ghosts();
+  }
+
+private:
+  std::shared_ptr<const Utilities::MPI::Partitioner> partitioner;
+};
+
+
+
+void test (const unsigned int n_vectors)
+{
+  const unsigned int my_id = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+
+  const unsigned int n = 120;
+  const unsigned int begin = my_id * n / n_procs;
+  const unsigned int end = (my_id+1) * n / n_procs;
+  IndexSet owned (n), ghosts (n);
+  owned.add_range (begin, end);
+  if (begin > 0)
+    ghosts.add_index (begin-1);
+  if (end < n)
+    ghosts.add_index (end);
+  std::shared_ptr<const Utilities::MPI::Partitioner> partitioner
+  (new Utilities::MPI::Partitioner (owned, ghosts, MPI_COMM_WORLD));
+  LaplaceOperator laplace (partitioner);
+
+  // monomials of increasing degree as right hand sides
+  LinearAlgebra::distributed::MultiVector<double> rhs (partitioner, n_vectors),
+                solution (partitioner, n_vectors);
+  for (unsigned int i=begin; i<end; ++i)
+    for (unsigned int c=0; c<n_vectors; ++c)
+      rhs(i,c) = std::pow ((i+1.) / n, double(c)) + (c == 3 ? 0.5 * (i%2) : 0.);
+
+  SolverControl control (500, 1e-10);
+  SolverMultiVectorCG<double> multi_solver (control);
+  multi_solver.solve (laplace, solution, rhs, PreconditionIdentity());
+  const unsigned int multi_steps = control.last_step();
+
+  double error = 0;
+  unsigned int max_steps = 0;
+  LinearAlgebra::distributed::Vector<double> column_rhs (partitioner),
+        column_solution (partitioner), reference (partitioner);
+  for (unsigned int c=0; c<n_vectors; ++c)
+    {
+      rhs.extract_column (c, column_rhs);
+      reference = 0.;
+      SolverControl column_control (500, 1e-10);
+      SolverCG<LinearAlgebra::distributed::Vector<double> >
+      solver (column_control);
+      solver.solve (laplace, reference, column_rhs, PreconditionIdentity());
+      deallog << "SolverCG for column " << c << ": "
+              << column_control.last_step() << " iterations" << std::endl;
+      max_steps = std::max (max_steps, column_control.last_step());
+
+      solution.extract_column (c, column_solution);
+      column_solution -= reference;
+      error = std::max (error, column_solution.linfty_norm() /
+                        reference.linfty_norm());
+    }
+  deallog << "SolverMultiVectorCG with " << n_vectors << " columns: "
+          << multi_steps << " iterations, "
+          << (multi_steps == max_steps ? "same" : "different")
+          << " as the slowest column, solution "
+          << (error < 1e-8 ? "OK" : "FAILED") << std::endl;
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  MPILogInitAll log;
+  // do not print the steps of the solvers
+  deallog.depth_file(1);
+
+  test (1);
+  test (2);
+  test (4);
+}
@@ -0,0 +1,162 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check MGTransferGlobalCoarsening on a hierarchy of three independently
+// partitioned distributed triangulations, the finest one with hanging
+// nodes: the prolongation of a linear function must be exact, and the
+// restriction must be the transpose of the prolongation
+
+#include "../tests.h"
+#include <deal.II/base/function_lib.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/multigrid/mg_transfer_global_coarsening.h>
+#include <deal.II/numerics/vector_tools.h>
+
+
+template <int dim>
+class LinearFunction : public Function<dim>
+{
+public:
+  virtual double value (const Point<dim> &p,
+                        const unsigned int = 0) const
+  {
+    double result = 1.;
+    for (unsigned int d=0; d<dim; ++d)
+      result += (d+1.) * p[d];
+    return result;
+  }
+};
+
+
+
+template <int dim>
+void test (const FiniteElement<dim> &fe)
+{
+  // level 0 and 1 are globally refined, level 2 adds a refinement of the
+  // cells close to the origin
+  const unsigned int n_levels = 3;
+  std::vector<std::shared_ptr<parallel::distributed::Triangulation<dim> > > trias;
+  for (unsigned int level=0; level<n_levels; ++level)
+    {
+      trias.push_back (std::make_shared<parallel::distributed::Triangulation<dim> >
+                       (MPI_COMM_WORLD));
+      GridGenerator::hyper_cube (*trias.back(), -1., 1.);
+      trias.back()->refine_global (std::min(level, 1U) + 1);
+      if (level == 2)
+        {
+          for (typename Triangulation<dim>::active_cell_iterator
+               cell=trias.back()->begin_active(); cell!=trias.back()->end(); ++cell)
+            if (cell->is_locally_owned() && cell->center().norm() < 0.8)
+              cell->set_refine_flag();
+          trias.back()->execute_coarsening_and_refinement();
+        }
+    }
+
+  std::vector<std::shared_ptr<DoFHandler<dim> > > dof_handlers;
+  std::vector<std::shared_ptr<ConstraintMatrix> > constraints;
+  std::vector<const DoFHandler<dim> *> dof_pointers;
+  std::vector<const ConstraintMatrix *> constraint_pointers;
+  for (unsigned int level=0; level<n_levels; ++level)
+    {
+      dof_handlers.push_back (std::make_shared<DoFHandler<dim> > (*trias[level]));
+      dof_handlers.back()->distribute_dofs (fe);
+      IndexSet relevant_dofs;
+      DoFTools::extract_locally_relevant_dofs (*dof_handlers.back(), relevant_dofs);
+      constraints.push_back (std::make_shared<ConstraintMatrix> (relevant_dofs));
+      DoFTools::make_hanging_node_constraints (*dof_handlers.back(),
+                                               *constraints.back());
+      constraints.back()->close();
+      dof_pointers.push_back (dof_handlers.back().get());
+      constraint_pointers.push_back (constraints.back().get());
+    }
+
+  MGTransferGlobalCoarsening<dim,double> transfer;
+  transfer.build (dof_pointers, constraint_pointers);
+  deallog << fe.get_name() << ": " << transfer.n_levels() << " levels with ";
+  for (unsigned int level=0; level<n_levels; ++level)
+    deallog << dof_handlers[level]->n_dofs() << (level+1<n_levels ? ", " : "");
+  deallog << " dofs" << std::endl;
+
+  std::vector<LinearAlgebra::distributed::Vector<double> > vectors (n_levels);
+  for (unsigned int level=0; level<n_levels; ++level)
+    vectors[level].reinit (dof_handlers[level]->locally_owned_dofs(),
+                           MPI_COMM_WORLD);
+
+  for (unsigned int level=1; level<n_levels; ++level)
+    {
+      // prolongate the interpolant of a linear function, which is contained
+      // in the finite element space on both levels
+      LinearAlgebra::distributed::Vector<double> coarse (vectors[level-1]),
+                  fine (vectors[level]), reference (vectors[level]);
+      VectorTools::interpolate (*dof_handlers[level-1], LinearFunction<dim>(),
+                                coarse);
+      VectorTools::interpolate (*dof_handlers[level], LinearFunction<dim>(),
+                                reference);
+      transfer.prolongate (level, fine, coarse);
+
+      // the constrained entries are zero after prolongation and are
+      // recovered from the hanging node constraints
+      LinearAlgebra::distributed::Vector<double>
+      ghosted (dof_handlers[level]->locally_owned_dofs(),
+               constraints[level]->get_local_lines(), MPI_COMM_WORLD);
+      ghosted = fine;
+      constraints[level]->distribute (ghosted);
+      fine = ghosted;
+      fine -= reference;
+      deallog << "Level " << level << ": prolongation of linear function "
+              << (fine.linfty_norm() < 1e-12 * reference.linfty_norm() ?
+                  "exact" : "FAILED") << std::endl;
+
+      // compare (P u, v) on the fine level against (u, R v) on the coarse
+      // level for vectors with entries depending on the index
+      LinearAlgebra::distributed::Vector<double> u (vectors[level-1]),
+                  v (vectors[level]), Pu (vectors[level]), Rv (vectors[level-1]);
+      for (unsigned int i=0; i<u.local_size(); ++i)
+        u.local_element(i) = std::sin (1. + u.get_partitioner()->local_to_global(i));
+      for (unsigned int i=0; i<v.local_size(); ++i)
+        v.local_element(i) = std::cos (2. + v.get_partitioner()->local_to_global(i));
+      transfer.prolongate (level, Pu, u);
+      Rv = 0.;
+      transfer.restrict_and_add (level, Rv, v);
+      const double fine_product = Pu * v;
+      const double coarse_product = u * Rv;
+      deallog << "Level " << level << ": restriction is transpose of prolongation: "
+              << (std::abs(fine_product - coarse_product) <
+                  1e-12 * std::abs(fine_product) ? "OK" : "FAILED")
+              << std::endl;
+    }
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  MPILogInitAll log;
+
+  test<2> (FE_Q<2>(1));
+  test<2> (FE_Q<2>(3));
+  test<2> (FE_DGQ<2>(2));
+  test<3> (FE_Q<3>(2));
+}
@@ -0,0 +1,220 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// integrate 1 and x_0^2 with the quadratures of NonMatching::QuadratureGenerator
+// over the inside, the outside, and the surface of a sphere and a plane,
+// summing over a uniform subdivision of the box [-1,1]^dim, and compare
+// against the exact areas, volumes, and moments
+
+#include "../tests.h"
+#include <deal.II/base/bounding_box.h>
+#include <deal.II/base/function.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/non_matching/quadrature_generator.h>
+
+
+// the signed distance to a sphere of the given radius around the origin
+template <int dim>
+class Sphere : public Function<dim>
+{
+public:
+  Sphere (const double radius)
+    :
+    radius (radius)
+  {}
+
+  virtual double value (const Point<dim> &p,
+                        const unsigned int = 0) const
+  {
+    return p.norm() - radius;
+  }
+
+  virtual Tensor<1,dim> gradient (const Point<dim> &p,
+                                  const unsigned int = 0) const
+  {
+    return p / p.norm();
+  }
+
+  virtual SymmetricTensor<2,dim> hessian (const Point<dim> &p,
+                                          const unsigned int = 0) const
+  {
+    const double norm = p.norm();
+    SymmetricTensor<2,dim> result;
+    for (unsigned int d=0; d<dim; ++d)
+      for (unsigned int e=d; e<dim; ++e)
+        result[d][e] = ((d == e ? 1. : 0.) - p[d]*p[e]/(norm*norm)) / norm;
+    return result;
+  }
+
+private:
+  const double radius;
+};
+
+
+
+// the plane x_0 + x_1 = offset, with the inside below it
+template <int dim>
+class Plane : public Function<dim>
+{
+public:
+  Plane (const double offset)
+    :
+    offset (offset)
+  {}
+
+  virtual double value (const Point<dim> &p,
+                        const unsigned int = 0) const
+  {
+    return (p[0] + p[1] - offset) / std::sqrt(2.);
+  }
+
+  virtual Tensor<1,dim> gradient (const Point<dim> &,
+                                  const unsigned int = 0) const
+  {
+    Tensor<1,dim> result;
+    result[0] = result[1] = 1. / std::sqrt(2.);
+    return result;
+  }
+
+  virtual SymmetricTensor<2,dim> hessian (const Point<dim> &,
+                                          const unsigned int = 0) const
+  {
+    return SymmetricTensor<2,dim>();
+  }
+
+private:
+  const double offset;
+};
+
+
+
+template <int dim, typename QuadratureType>
+void
+integrate (const QuadratureType &quadrature,
+           double               &measure,
+           double               &moment)
+{
+  for (unsigned int q=0; q<quadrature.size(); ++q)
+    {
+      measure += quadrature.weight(q);
+      moment += quadrature.weight(q) * quadrature.point(q)[0] * quadrature.point(q)[0];
+    }
+}
+
+
+
+template <int dim>
+void
+test (const Function<dim>  &level_set,
+      const unsigned int    n_subdivisions,
+      const unsigned int    n_points,
+      const double          exact[6])
+{
+  NonMatching::QuadratureGenerator<dim> generator ((QGauss<1>(n_points)));
+
+  double inside[2] = {0, 0}, outside[2] = {0, 0}, surface[2] = {0, 0};
+  unsigned int n_intersected = 0;
+  const double h = 2. / n_subdivisions;
+  for (unsigned int b=0; b<Utilities::fixed_power<dim>(n_subdivisions); ++b)
+    {
+      Point<dim> lower, upper;
+      for (unsigned int d=0, index=b; d<dim; ++d, index/=n_subdivisions)
+        {
+          lower[d] = -1. + h * (index % n_subdivisions);
+          upper[d] = lower[d] + h;
+        }
+      generator.generate (level_set, BoundingBox<dim>(std::make_pair(lower, upper)));
+      if (generator.get_location() == NonMatching::LocationToLevelSet::intersected)
+        ++n_intersected;
+
+      integrate<dim> (generator.get_inside_quadrature(), inside[0], inside[1]);
+      integrate<dim> (generator.get_outside_quadrature(), outside[0], outside[1]);
+      integrate<dim> (generator.get_surface_quadrature(), surface[0], surface[1]);
+
+      // the normals are unit vectors parallel to the gradient
+      const NonMatching::ImmersedSurfaceQuadrature<dim> &surface_quadrature =
+        generator.get_surface_quadrature();
+      for (unsigned int q=0; q<surface_quadrature.size(); ++q)
+        {
+          Tensor<1,dim> gradient = level_set.gradient(surface_quadrature.point(q));
+          gradient /= gradient.norm();
+          AssertThrow ((surface_quadrature.get_normal_vectors()[q] - gradient).norm()
+                       < 1e-10, ExcInternalError());
+          AssertThrow (std::abs(level_set.value(surface_quadrature.point(q)))
+                       < 1e-10, ExcInternalError());
+        }
+    }
+
+  deallog << n_subdivisions << "^" << dim << " boxes, " << n_intersected
+          << " intersected, " << n_points << " points per direction" << std::endl;
+  const double *computed[3] = {inside, outside, surface};
+  const char *names[3] = {"inside", "outside", "surface"};
+  for (unsigned int region=0; region<3; ++region)
+    deallog << "  " << names[region] << ": error of measure "
+            << filter_out_small_numbers(std::abs(computed[region][0] - exact[2*region]), 1e-12)
+            << ", error of x_0^2 moment "
+            << filter_out_small_numbers(std::abs(computed[region][1] - exact[2*region+1]), 1e-12)
+            << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+  deallog << std::setprecision(3);
+
+  const double pi = numbers::PI;
+  const double r = 0.75;
+
+  {
+    deallog.push("2d circle");
+    // the integral of x^2 over [-1,1]^2 is 4/3
+    const double exact[6] = {pi*r*r, pi*std::pow(r,4)/4.,
+                             4.-pi*r*r, 4./3.-pi*std::pow(r,4)/4.,
+                             2.*pi*r, pi*std::pow(r,3)
+                            };
+    test (Sphere<2>(r), 4, 4, exact);
+    test (Sphere<2>(r), 8, 4, exact);
+    test (Sphere<2>(r), 8, 8, exact);
+    deallog.pop();
+  }
+
+  {
+    deallog.push("2d plane");
+    // the part of [-1,1]^2 with x+y < 0.5
+    const double s = 1.5;
+    const double exact[6] = {4.-s*s/2., 4./3.-27./64.,
+                             s*s/2., 27./64.,
+                             std::sqrt(2.)*s, std::sqrt(2.)*(s*s*s/3. - s*s + s)
+                            };
+    test (Plane<2>(0.5), 4, 3, exact);
+    deallog.pop();
+  }
+
+  {
+    deallog.push("3d sphere");
+    // the integral of x^2 over [-1,1]^3 is 8/3
+    const double exact[6] = {4./3.*pi*r*r*r, 4./15.*pi*std::pow(r,5),
+                             8.-4./3.*pi*r*r*r, 8./3.-4./15.*pi*std::pow(r,5),
+                             4.*pi*r*r, 4./3.*pi*std::pow(r,4)
+                            };
+    test (Sphere<3>(r), 4, 4, exact);
+    test (Sphere<3>(r), 8, 4, exact);
+    deallog.pop();
+  }
+}
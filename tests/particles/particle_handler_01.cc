@@ -0,0 +1,145 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// insert particles into a ParticleHandler on a serial triangulation, check
+// that they are sorted into the cells containing them, move them, and check
+// that sort_particles_into_subdomains_and_cells() finds their new cells and
+// removes the particles that left the domain
+
+#include "../tests.h"
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/particles/particle_handler.h>
+
+
+template <int dim>
+void
+check_cells (const Triangulation<dim>           &tria,
+             const Mapping<dim>                 &mapping,
+             Particles::ParticleHandler<dim>    &particle_handler)
+{
+  // every particle must be located in its cell at the right reference
+  // location, and the particles in each cell must add up to all particles
+  unsigned int n_wrong = 0, n_in_cells = 0;
+  for (typename Particles::ParticleHandler<dim>::particle_iterator
+       particle = particle_handler.begin();
+       particle != particle_handler.end(); ++particle)
+    {
+      const typename Triangulation<dim>::active_cell_iterator
+      cell = particle->get_surrounding_cell(tria);
+      const Point<dim> real =
+        mapping.transform_unit_to_real_cell (cell, particle->get_reference_location());
+      if (real.distance(particle->get_location()) > 1e-10 ||
+          !GeometryInfo<dim>::is_inside_unit_cell(particle->get_reference_location(), 1e-10))
+        ++n_wrong;
+      // the property stores the particle index
+      if (particle->get_properties()[0] != particle->get_id())
+        ++n_wrong;
+    }
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    n_in_cells += particle_handler.n_particles_in_cell(cell);
+
+  deallog << "Particles: " << particle_handler.n_locally_owned_particles()
+          << ", in cells: " << n_in_cells
+          << ", max per cell: " << particle_handler.n_global_max_particles_per_cell()
+          << ", wrongly located: " << n_wrong << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  MappingQ1<dim> mapping;
+  Particles::ParticleHandler<dim> particle_handler (tria, mapping, 1);
+
+  // a regular lattice of points inside the unit cube
+  std::vector<Point<dim> > positions;
+  const unsigned int n_per_direction = 7;
+  for (unsigned int i=0; i<Utilities::fixed_power<dim>(n_per_direction); ++i)
+    {
+      Point<dim> p;
+      for (unsigned int d=0, index=i; d<dim; ++d, index/=n_per_direction)
+        p[d] = (0.5 + index % n_per_direction) / n_per_direction;
+      positions.push_back (p);
+    }
+  particle_handler.insert_particles (positions);
+  deallog << "Inserted: " << particle_handler.n_global_particles()
+          << ", next free index: " << particle_handler.get_next_free_particle_index()
+          << std::endl;
+
+  for (typename Particles::ParticleHandler<dim>::particle_iterator
+       particle = particle_handler.begin();
+       particle != particle_handler.end(); ++particle)
+    particle->get_properties()[0] = particle->get_id();
+  check_cells (tria, mapping, particle_handler);
+
+  // move all particles by a small step first, which keeps most of them in
+  // their cell or moves them to a neighbor, and then by a large step that
+  // moves some of them out of the domain
+  Tensor<1,dim> shift;
+  for (unsigned int d=0; d<dim; ++d)
+    shift[d] = 0.07 * (d+1);
+  for (unsigned int step=0; step<2; ++step)
+    {
+      unsigned int n_remaining = 0;
+      for (typename Particles::ParticleHandler<dim>::particle_iterator
+           particle = particle_handler.begin();
+           particle != particle_handler.end(); ++particle)
+        {
+          const Point<dim> new_location = particle->get_location() + shift;
+          particle->set_location (new_location);
+          bool inside = true;
+          for (unsigned int d=0; d<dim; ++d)
+            if (new_location[d] > 1.)
+              inside = false;
+          if (inside)
+            ++n_remaining;
+        }
+      particle_handler.sort_particles_into_subdomains_and_cells();
+      deallog << "After move " << step << ": " << n_remaining
+              << " particles expected inside" << std::endl;
+      check_cells (tria, mapping, particle_handler);
+      shift *= 3.;
+    }
+
+  // sorting the property pool keeps the properties with their particles
+  particle_handler.sort_property_pool_by_cells();
+  check_cells (tria, mapping, particle_handler);
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3>();
+  deallog.pop();
+}
@@ -0,0 +1,132 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// insert particles into a ParticleHandler on a distributed triangulation
+// and move them such that many of them end up in the cells of another
+// process, which makes sort_particles_into_subdomains_and_cells() send them
+// to their new owners by Utilities::MPI::sparse_data_exchange(). Check that
+// no particle is lost and that every particle is stored on
+// the owner of its cell.
+
+#include "../tests.h"
+#include <deal.II/distributed/tria.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/particles/particle_handler.h>
+
+
+template <int dim>
+void
+check (const parallel::distributed::Triangulation<dim> &tria,
+       Particles::ParticleHandler<dim>                 &particle_handler,
+       const unsigned int                               n_expected)
+{
+  unsigned int n_wrong = 0;
+  for (typename Particles::ParticleHandler<dim>::particle_iterator
+       particle = particle_handler.begin();
+       particle != particle_handler.end(); ++particle)
+    {
+      const typename Triangulation<dim>::active_cell_iterator
+      cell = particle->get_surrounding_cell(tria);
+      if (!cell->is_locally_owned() ||
+          !cell->point_inside(particle->get_location()))
+        ++n_wrong;
+      if (particle->get_properties()[0] != particle->get_id())
+        ++n_wrong;
+    }
+
+  deallog << "Global particles: " << particle_handler.n_global_particles()
+          << " (expected " << n_expected << "), locally owned particles sum up to "
+          << Utilities::MPI::sum (particle_handler.n_locally_owned_particles(),
+                                  MPI_COMM_WORLD)
+          << ", wrongly placed: " << Utilities::MPI::sum (n_wrong, MPI_COMM_WORLD)
+          << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  parallel::distributed::Triangulation<dim> tria (MPI_COMM_WORLD);
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (3);
+
+  MappingQ1<dim> mapping;
+  Particles::ParticleHandler<dim> particle_handler (tria, mapping, 1);
+
+  // all processes pass the same positions, and each inserts the ones in
+  // its locally owned cells
+  std::vector<Point<dim> > positions;
+  const unsigned int n_per_direction = 6;
+  for (unsigned int i=0; i<Utilities::fixed_power<dim>(n_per_direction); ++i)
+    {
+      Point<dim> p;
+      for (unsigned int d=0, index=i; d<dim; ++d, index/=n_per_direction)
+        p[d] = (0.3 + index % n_per_direction) / (n_per_direction + 1.);
+      positions.push_back (p);
+    }
+  particle_handler.insert_particles (positions);
+  for (typename Particles::ParticleHandler<dim>::particle_iterator
+       particle = particle_handler.begin();
+       particle != particle_handler.end(); ++particle)
+    particle->get_properties()[0] = particle->get_id();
+  check (tria, particle_handler, positions.size());
+
+  // move the particles by less than the size of a cell, such that the new
+  // cell is a neighbor and thus either locally owned or a ghost cell
+  Tensor<1,dim> shift;
+  shift[0] = 0.1;
+  shift[dim-1] += 0.04;
+  for (unsigned int step=0; step<3; ++step)
+    {
+      for (typename Particles::ParticleHandler<dim>::particle_iterator
+           particle = particle_handler.begin();
+           particle != particle_handler.end(); ++particle)
+        particle->set_location (particle->get_location() + shift);
+      particle_handler.sort_particles_into_subdomains_and_cells();
+
+      // particles moved out of the domain are removed
+      unsigned int n_inside = 0;
+      for (unsigned int i=0; i<positions.size(); ++i)
+        {
+          const Point<dim> p = positions[i] + (step+1.) * shift;
+          bool inside = true;
+          for (unsigned int d=0; d<dim; ++d)
+            if (p[d] > 1.)
+              inside = false;
+          if (inside)
+            ++n_inside;
+        }
+      check (tria, particle_handler, n_inside);
+    }
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  MPILogInitAll log;
+
+  deallog.push("2d");
+  test<2>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3>();
+  deallog.pop();
+}
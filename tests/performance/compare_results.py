@@ -0,0 +1,96 @@
+#!/usr/bin/python
+
+## ---------------------------------------------------------------------
+##
+## Copyright (C) 2017 by the deal.II authors
+##
+## This file is part of the deal.II library.
+##
+## The deal.II library is free software; you can use it, redistribute
+## it, and/or modify it under the terms of the GNU Lesser General
+## Public License as published by the Free Software Foundation; either
+## version 2.1 of the License, or (at your option) any later version.
+## The full text of the license can be found in the file LICENSE at
+## the top level of the deal.II distribution.
+##
+## ---------------------------------------------------------------------
+
+#
+# Compare the JSON files written by the performance benchmarks against the
+# files of a baseline run with the same name:
+#
+#   compare_results.py [--tolerance=0.1] <baseline directory> <file.json>...
+#
+# Instead of single files, a directory containing the JSON files of the
+# current run can be given. For every measurement, the median timing is
+# compared to the baseline and the script exits with a nonzero status if
+# any of them is slower by more than the given relative tolerance.
+# Measurements without a baseline are reported but do not fail.
+#
+
+from __future__ import print_function
+
+import glob
+import json
+import os
+import sys
+
+
+def load(filename):
+    with open(filename) as f:
+        data = json.load(f)
+    return data["benchmark"], dict((m["name"], m) for m in data["measurements"])
+
+
+def main(argv):
+    tolerance = 0.1
+    args = []
+    for arg in argv[1:]:
+        if arg.startswith("--tolerance="):
+            tolerance = float(arg[len("--tolerance="):])
+        else:
+            args.append(arg)
+
+    if len(args) < 2:
+        print("Usage: compare_results.py [--tolerance=<t>] <baseline dir> <file.json>...")
+        return 2
+
+    baseline_dir = args[0]
+    files = []
+    for arg in args[1:]:
+        if os.path.isdir(arg):
+            files.extend(sorted(glob.glob(os.path.join(arg, "*.json"))))
+        else:
+            files.append(arg)
+
+    n_regressions = 0
+    print("%-45s %12s %12s %8s" % ("measurement", "baseline [s]", "current [s]", "ratio"))
+    for filename in files:
+        benchmark, current = load(filename)
+        baseline_file = os.path.join(baseline_dir, os.path.basename(filename))
+        baseline = load(baseline_file)[1] if os.path.exists(baseline_file) else {}
+
+        for name in sorted(current):
+            label = benchmark + "/" + name
+            median = current[name]["median"]
+            if name not in baseline:
+                print("%-45s %12s %12.4g %8s" % (label, "-", median, "new"))
+                continue
+
+            reference = baseline[name]["median"]
+            ratio = median / reference if reference > 0 else float("inf")
+            status = ""
+            if ratio > 1. + tolerance:
+                status = "  <-- regression"
+                n_regressions += 1
+            print("%-45s %12.4g %12.4g %8.3f%s" % (label, reference, median, ratio, status))
+
+    if n_regressions > 0:
+        print("\n%d measurement(s) slower than the baseline by more than %g%%"
+              % (n_regressions, 100. * tolerance))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
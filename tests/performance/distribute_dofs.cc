@@ -0,0 +1,64 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// Benchmark DoFHandler::distribute_dofs for Q1 and Q3 elements on a
+// uniformly refined cube in 3D
+
+#include "performance_test.h"
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+
+using namespace dealii;
+
+
+int main (int argc, char **argv)
+{
+  Performance::Benchmark benchmark ("distribute_dofs", argc, argv);
+
+  const unsigned int dim = 3;
+  const unsigned int n_refinements = 5;
+  benchmark.add_parameter("dim", dim);
+  benchmark.add_parameter("refinements", n_refinements);
+
+  Triangulation<dim> triangulation;
+  GridGenerator::hyper_cube (triangulation);
+  triangulation.refine_global (n_refinements);
+  benchmark.add_parameter("n_cells", triangulation.n_active_cells());
+
+  const unsigned int degrees[] = {1, 3};
+  for (unsigned int d=0; d<2; ++d)
+    {
+      FE_Q<dim> fe (degrees[d]);
+      DoFHandler<dim> dof_handler (triangulation);
+      dof_handler.distribute_dofs (fe);
+      const types::global_dof_index n_dofs = dof_handler.n_dofs();
+      benchmark.add_parameter("n_dofs_q" + Utilities::int_to_string(degrees[d]),
+                              n_dofs);
+
+      benchmark.measure ("q" + Utilities::int_to_string(degrees[d]),
+                         [&] ()
+      {
+        dof_handler.clear ();
+      },
+      [&] ()
+      {
+        dof_handler.distribute_dofs (fe);
+      },
+      0, n_dofs);
+    }
+}
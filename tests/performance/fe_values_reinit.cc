@@ -0,0 +1,89 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// Benchmark FEValues::reinit with values, gradients and JxW values for Q2 on
+// a uniformly refined cube in 3D, both on a Cartesian and a deformed mesh
+
+#include "performance_test.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+
+using namespace dealii;
+
+const unsigned int dim = 3;
+
+
+double
+sweep (const DoFHandler<dim> &dof_handler,
+       FEValues<dim>         &fe_values)
+{
+  // accumulate a value to keep the compiler from skipping the computations
+  double sum = 0;
+  for (DoFHandler<dim>::active_cell_iterator
+       cell=dof_handler.begin_active(); cell!=dof_handler.end(); ++cell)
+    {
+      fe_values.reinit (cell);
+      sum += fe_values.JxW(0) + fe_values.shape_grad(0,0)[0];
+    }
+  return sum;
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Performance::Benchmark benchmark ("fe_values_reinit", argc, argv);
+
+  const unsigned int degree = 2;
+  const unsigned int n_refinements = 4;
+  benchmark.add_parameter("dim", dim);
+  benchmark.add_parameter("degree", degree);
+  benchmark.add_parameter("refinements", n_refinements);
+
+  Triangulation<dim> triangulation;
+  GridGenerator::hyper_cube (triangulation);
+  triangulation.refine_global (n_refinements);
+
+  FE_Q<dim> fe (degree);
+  DoFHandler<dim> dof_handler (triangulation);
+  dof_handler.distribute_dofs (fe);
+  benchmark.add_parameter("n_cells", triangulation.n_active_cells());
+  benchmark.add_parameter("n_dofs", dof_handler.n_dofs());
+
+  FEValues<dim> fe_values (fe, QGauss<dim>(degree+1),
+                           update_values | update_gradients | update_JxW_values);
+
+  double sum = 0;
+  benchmark.measure ("cartesian", [&] ()
+  {
+    sum += sweep (dof_handler, fe_values);
+  },
+  0, dof_handler.n_dofs());
+
+  GridTools::distort_random (0.2, triangulation, true);
+  benchmark.measure ("deformed", [&] ()
+  {
+    sum += sweep (dof_handler, fe_values);
+  },
+  0, dof_handler.n_dofs());
+
+  std::cout << "checksum: " << sum << std::endl;
+}
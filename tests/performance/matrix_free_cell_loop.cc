@@ -0,0 +1,108 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// Benchmark MatrixFree::cell_loop with the evaluation of a Laplace operator
+// of degree 4 on a uniformly refined cube in 3D
+
+#include "performance_test.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q_generic.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+
+using namespace dealii;
+
+const unsigned int dim = 3;
+const unsigned int degree = 4;
+typedef LinearAlgebra::distributed::Vector<double> VectorType;
+
+
+void
+local_laplace (const MatrixFree<dim,double>                &data,
+               VectorType                                  &dst,
+               const VectorType                            &src,
+               const std::pair<unsigned int, unsigned int> &cell_range)
+{
+  FEEvaluation<dim,degree> phi (data);
+  for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+    {
+      phi.reinit (cell);
+      phi.read_dof_values (src);
+      phi.evaluate (false, true);
+      for (unsigned int q=0; q<phi.n_q_points; ++q)
+        phi.submit_gradient (phi.get_gradient(q), q);
+      phi.integrate (false, true);
+      phi.distribute_local_to_global (dst);
+    }
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Performance::Benchmark benchmark ("matrix_free_cell_loop", argc, argv);
+
+  const unsigned int n_refinements = 4;
+  benchmark.add_parameter("dim", dim);
+  benchmark.add_parameter("degree", degree);
+  benchmark.add_parameter("refinements", n_refinements);
+
+  Triangulation<dim> triangulation;
+  GridGenerator::hyper_cube (triangulation);
+  triangulation.refine_global (n_refinements);
+
+  FE_Q<dim> fe (degree);
+  DoFHandler<dim> dof_handler (triangulation);
+  dof_handler.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  constraints.close ();
+
+  MatrixFree<dim,double> matrix_free;
+  matrix_free.reinit (MappingQGeneric<dim>(1), dof_handler, constraints,
+                      QGauss<1>(degree+1),
+                      MatrixFree<dim,double>::AdditionalData());
+
+  VectorType src, dst;
+  matrix_free.initialize_dof_vector (src);
+  matrix_free.initialize_dof_vector (dst);
+  for (unsigned int i=0; i<src.local_size(); ++i)
+    src.local_element(i) = 1. + i%13;
+
+  benchmark.add_parameter("n_dofs", dof_handler.n_dofs());
+
+  const std::function<void (const MatrixFree<dim,double> &,
+                            VectorType &,
+                            const VectorType &,
+                            const std::pair<unsigned int, unsigned int> &)>
+  cell_operation = &local_laplace;
+
+  // read the source vector, and read and write the destination vector that
+  // the loop adds into
+  const double bytes = 3. * src.local_size() * sizeof(double);
+  benchmark.measure ("laplace", [&] ()
+  {
+    for (unsigned int i=0; i<10; ++i)
+      matrix_free.cell_loop (cell_operation, dst, src);
+  },
+  10*bytes, 10.*dof_handler.n_dofs());
+}
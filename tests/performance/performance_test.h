@@ -0,0 +1,256 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_tests_performance_test_h
+#define dealii_tests_performance_test_h
+
+// Common infrastructure of the performance benchmarks: parsing of the
+// command line, timing of repeated runs of a kernel, and output of the
+// results as a JSON file that can be compared against a baseline with
+// compare_results.py.
+//
+// Every benchmark accepts the arguments
+//   --output=<file>      name of the JSON file (default: <benchmark>.json)
+//   --repetitions=<n>    number of timed runs of each kernel (default: 10)
+//   --threads=<n>        number of threads (default: 1)
+// plus the options of the form --<key>=<value> it declares itself.
+//
+// For benchmarks running with MPI, the timings are the maximum over all
+// processes of the communicator passed to set_communicator(), and only the
+// first process writes the output file.
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/utilities.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace Performance
+{
+  class Benchmark
+  {
+  public:
+    /**
+     * Constructor. Parse the command line. Besides the common arguments,
+     * the keys listed in @p options are accepted; their values can be
+     * queried through get_option().
+     */
+    Benchmark (const std::string              &name,
+               int                             argc,
+               char                          **argv,
+               const std::vector<std::string> &options = std::vector<std::string>())
+      :
+      name (name),
+      output_file (name + ".json"),
+      n_repetitions (10),
+      n_threads (1),
+      communicator (MPI_COMM_SELF)
+    {
+      for (int i=1; i<argc; ++i)
+        {
+          const std::string arg (argv[i]);
+          const std::string::size_type equal = arg.find('=');
+          const std::string key = (arg.find("--") == 0 && equal != std::string::npos) ?
+                                  arg.substr(2, equal-2) : "";
+          const std::string value = key.empty() ? "" : arg.substr(equal+1);
+          if (key == "output")
+            output_file = value;
+          else if (key == "repetitions")
+            n_repetitions = std::max(1, dealii::Utilities::string_to_int(value));
+          else if (key == "threads")
+            n_threads = std::max(1, dealii::Utilities::string_to_int(value));
+          else if (!key.empty() &&
+                   std::find(options.begin(), options.end(), key) != options.end())
+            option_values[key] = value;
+          else
+            {
+              std::cerr << "Unknown argument " << arg << std::endl
+                        << "Usage: " << argv[0]
+                        << " [--output=<file>] [--repetitions=<n>] [--threads=<n>]";
+              for (unsigned int o=0; o<options.size(); ++o)
+                std::cerr << " [--" << options[o] << "=<value>]";
+              std::cerr << std::endl;
+              std::exit(1);
+            }
+        }
+
+      dealii::MultithreadInfo::set_thread_limit(n_threads);
+      add_parameter("threads", n_threads);
+      add_parameter("repetitions", n_repetitions);
+    }
+
+    ~Benchmark ()
+    {
+      if (dealii::Utilities::MPI::this_mpi_process(communicator) != 0)
+        return;
+
+      std::ofstream out(output_file.c_str());
+      out << std::setprecision(8)
+          << "{\n"
+          << "  \"benchmark\": \"" << name << "\",\n"
+          << "  \"parameters\": {";
+      for (unsigned int i=0; i<parameters.size(); ++i)
+        out << (i>0 ? "," : "") << "\n    \"" << parameters[i].first
+            << "\": " << parameters[i].second;
+      out << "\n  },\n"
+          << "  \"measurements\": [";
+      for (unsigned int i=0; i<measurements.size(); ++i)
+        {
+          const Measurement &m = measurements[i];
+          out << (i>0 ? "," : "") << "\n    {\n"
+              << "      \"name\": \"" << m.name << "\",\n"
+              << "      \"repetitions\": " << m.timings.size() << ",\n"
+              << "      \"min\": " << m.timings.front() << ",\n"
+              << "      \"median\": " << m.timings[m.timings.size()/2] << ",\n"
+              << "      \"max\": " << m.timings.back();
+          if (m.bytes > 0)
+            out << ",\n      \"GB/s\": " << 1e-9 * m.bytes / m.timings.front();
+          if (m.dofs > 0)
+            out << ",\n      \"DoFs/s\": " << m.dofs / m.timings.front();
+          out << "\n    }";
+        }
+      out << "\n  ]\n"
+          << "}\n";
+    }
+
+    /**
+     * Return the value given for the option @p key on the command line, or
+     * @p default_value if it was not given.
+     */
+    std::string get_option (const std::string &key,
+                            const std::string &default_value) const
+    {
+      const std::map<std::string, std::string>::const_iterator
+      it = option_values.find(key);
+      return it == option_values.end() ? default_value : it->second;
+    }
+
+    /**
+     * Return the number of timed runs of each kernel.
+     */
+    int get_n_repetitions () const
+    {
+      return n_repetitions;
+    }
+
+    /**
+     * Synchronize the timings across the processes of @p comm. The
+     * processes start each run of a kernel together, and the time of a run
+     * is the maximum over all processes.
+     */
+    void set_communicator (const MPI_Comm &comm)
+    {
+      communicator = comm;
+    }
+
+    /**
+     * Record a numeric parameter of the benchmark, like the mesh size or
+     * the polynomial degree, in the output file.
+     */
+    template <typename T>
+    void add_parameter (const std::string &key,
+                        const T           &value)
+    {
+      std::ostringstream str;
+      str << value;
+      parameters.emplace_back(key, str.str());
+    }
+
+    /**
+     * Run @p setup and then time @p kernel, n_repetitions times, after one
+     * untimed warm-up run. The derived throughput numbers are based on the
+     * fastest run, using @p bytes as the memory transferred and @p dofs as
+     * the number of degrees of freedom processed by one run of the kernel.
+     */
+    void measure (const std::string           &measurement_name,
+                  const std::function<void()> &setup,
+                  const std::function<void()> &kernel,
+                  const double                 bytes = 0,
+                  const double                 dofs = 0)
+    {
+      Measurement m;
+      m.name = measurement_name;
+      m.bytes = bytes;
+      m.dofs = dofs;
+
+      setup();
+      kernel();
+      for (int r=0; r<n_repetitions; ++r)
+        {
+          setup();
+#ifdef DEAL_II_WITH_MPI
+          MPI_Barrier(communicator);
+#endif
+          const auto start = std::chrono::steady_clock::now();
+          kernel();
+          const auto end = std::chrono::steady_clock::now();
+          m.timings.push_back(dealii::Utilities::MPI::max
+                              (std::chrono::duration<double>(end-start).count(),
+                               communicator));
+        }
+      std::sort(m.timings.begin(), m.timings.end());
+
+      if (dealii::Utilities::MPI::this_mpi_process(communicator) == 0)
+        std::cout << name << "/" << measurement_name << ": min "
+                  << m.timings.front() << "s, median "
+                  << m.timings[m.timings.size()/2] << "s" << std::endl;
+      measurements.push_back(m);
+    }
+
+    /**
+     * Same as above for kernels that need no setup before each run.
+     */
+    void measure (const std::string           &measurement_name,
+                  const std::function<void()> &kernel,
+                  const double                 bytes = 0,
+                  const double                 dofs = 0)
+    {
+      measure(measurement_name, [] () {}, kernel, bytes, dofs);
+    }
+
+  private:
+    struct Measurement
+    {
+      std::string         name;
+      std::vector<double> timings;
+      double              bytes;
+      double              dofs;
+    };
+
+    const std::string name;
+    std::string       output_file;
+    int               n_repetitions;
+    int               n_threads;
+    MPI_Comm          communicator;
+
+    std::map<std::string, std::string>                option_values;
+    std::vector<std::pair<std::string, std::string> > parameters;
+    std::vector<Measurement>                          measurements;
+  };
+}
+
+#endif
@@ -0,0 +1,565 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// Scaling benchmark of a conjugate gradient solver preconditioned by
+// matrix-free geometric multigrid for the Poisson equation on a cube in 3D,
+// following step-37. For each polynomial degree, the mesh is chosen such
+// that the number of degrees of freedom is close to a target size, and the
+// time to solve the linear system is measured. The time spent in the
+// components of the solver is collected with TimerOutput and printed as
+// minimum, average and maximum over the processes.
+//
+// Besides the common arguments of the benchmarks, the following options are
+// accepted:
+//   --mode=<weak|strong>  whether --size is the number of degrees of freedom
+//                         per process (weak scaling) or in total (strong
+//                         scaling); the default is weak
+//   --size=<n>            target number of degrees of freedom (default:
+//                         200000)
+//   --degrees=<list>      comma-separated list of polynomial degrees
+//                         between 1 and 8 (default: 1,2,3,4,5,6,7,8)
+//
+// A scaling study runs the benchmark with increasing numbers of processes,
+// for example
+//   for p in 1 2 4 8 16; do
+//     mpirun -np $p ./poisson_scaling.release --mode=strong
+//       --size=8000000 --output=strong-$p.json
+//   done
+// The DoFs/s entries of the output are the number of degrees of freedom
+// solved for per second and per process.
+
+#include "performance_test.h"
+
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/function.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/multigrid/multigrid.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+#include <deal.II/multigrid/mg_tools.h>
+#include <deal.II/multigrid/mg_coarse.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_matrix.h>
+#include <deal.II/numerics/vector_tools.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/operators.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+
+#include <cmath>
+
+using namespace dealii;
+
+
+namespace PoissonScaling
+{
+  const unsigned int dim = 3;
+
+  typedef LinearAlgebra::distributed::Vector<double> VectorType;
+  typedef LinearAlgebra::distributed::Vector<float>  LevelVectorType;
+
+
+
+  // The wrappers below forward to the actual components of the solver and
+  // measure the time spent in them.
+  template <typename OperatorType>
+  class TimedOperator
+  {
+  public:
+    TimedOperator (const OperatorType &op,
+                   TimerOutput        &timer)
+      :
+      op (op),
+      timer (timer)
+    {}
+
+    void vmult (VectorType       &dst,
+                const VectorType &src) const
+    {
+      TimerOutput::Scope scope (timer, "fine operator");
+      op.vmult (dst, src);
+    }
+
+  private:
+    const OperatorType &op;
+    TimerOutput        &timer;
+  };
+
+
+
+  class TimedLevelMatrix : public MGMatrixBase<LevelVectorType>
+  {
+  public:
+    TimedLevelMatrix (const MGMatrixBase<LevelVectorType> &matrix,
+                      TimerOutput                         &timer)
+      :
+      matrix (matrix),
+      timer (timer)
+    {}
+
+    virtual void vmult (const unsigned int     level,
+                        LevelVectorType       &dst,
+                        const LevelVectorType &src) const
+    {
+      TimerOutput::Scope scope (timer, "level operator");
+      matrix.vmult (level, dst, src);
+    }
+
+    virtual void vmult_add (const unsigned int     level,
+                            LevelVectorType       &dst,
+                            const LevelVectorType &src) const
+    {
+      TimerOutput::Scope scope (timer, "level operator");
+      matrix.vmult_add (level, dst, src);
+    }
+
+    virtual void Tvmult (const unsigned int     level,
+                         LevelVectorType       &dst,
+                         const LevelVectorType &src) const
+    {
+      TimerOutput::Scope scope (timer, "level operator");
+      matrix.Tvmult (level, dst, src);
+    }
+
+    virtual void Tvmult_add (const unsigned int     level,
+                             LevelVectorType       &dst,
+                             const LevelVectorType &src) const
+    {
+      TimerOutput::Scope scope (timer, "level operator");
+      matrix.Tvmult_add (level, dst, src);
+    }
+
+    virtual unsigned int get_minlevel () const
+    {
+      return matrix.get_minlevel();
+    }
+
+    virtual unsigned int get_maxlevel () const
+    {
+      return matrix.get_maxlevel();
+    }
+
+  private:
+    const MGMatrixBase<LevelVectorType> &matrix;
+    TimerOutput                         &timer;
+  };
+
+
+
+  class TimedSmoother : public MGSmootherBase<LevelVectorType>
+  {
+  public:
+    TimedSmoother (const MGSmootherBase<LevelVectorType> &smoother,
+                   TimerOutput                           &timer)
+      :
+      smoother (smoother),
+      timer (timer)
+    {}
+
+    virtual void clear ()
+    {}
+
+    virtual void smooth (const unsigned int     level,
+                         LevelVectorType       &u,
+                         const LevelVectorType &rhs) const
+    {
+      TimerOutput::Scope scope (timer, "smoother");
+      smoother.smooth (level, u, rhs);
+    }
+
+    virtual void apply (const unsigned int     level,
+                        LevelVectorType       &u,
+                        const LevelVectorType &rhs) const
+    {
+      TimerOutput::Scope scope (timer, "smoother");
+      smoother.apply (level, u, rhs);
+    }
+
+  private:
+    const MGSmootherBase<LevelVectorType> &smoother;
+    TimerOutput                           &timer;
+  };
+
+
+
+  class TimedCoarseSolver : public MGCoarseGridBase<LevelVectorType>
+  {
+  public:
+    TimedCoarseSolver (const MGCoarseGridBase<LevelVectorType> &coarse,
+                       TimerOutput                             &timer)
+      :
+      coarse (coarse),
+      timer (timer)
+    {}
+
+    virtual void operator() (const unsigned int     level,
+                             LevelVectorType       &dst,
+                             const LevelVectorType &src) const
+    {
+      TimerOutput::Scope scope (timer, "coarse solve");
+      coarse (level, dst, src);
+    }
+
+  private:
+    const MGCoarseGridBase<LevelVectorType> &coarse;
+    TimerOutput                             &timer;
+  };
+
+
+
+  class TimedTransfer : public MGTransferMatrixFree<dim,float>
+  {
+  public:
+    TimedTransfer (const MGConstrainedDoFs &mg_constrained_dofs,
+                   TimerOutput             &timer)
+      :
+      MGTransferMatrixFree<dim,float> (mg_constrained_dofs),
+      timer (timer)
+    {}
+
+    virtual void prolongate (const unsigned int     to_level,
+                             LevelVectorType       &dst,
+                             const LevelVectorType &src) const
+    {
+      TimerOutput::Scope scope (timer, "transfer");
+      MGTransferMatrixFree<dim,float>::prolongate (to_level, dst, src);
+    }
+
+    virtual void restrict_and_add (const unsigned int     from_level,
+                                   LevelVectorType       &dst,
+                                   const LevelVectorType &src) const
+    {
+      TimerOutput::Scope scope (timer, "transfer");
+      MGTransferMatrixFree<dim,float>::restrict_and_add (from_level, dst, src);
+    }
+
+  private:
+    TimerOutput &timer;
+  };
+
+
+
+  // Create a mesh of unit cubes with 1 to 3 coarse cells per direction and
+  // a number of global refinements such that a continuous element of the
+  // given degree has close to target_size degrees of freedom.
+  template <typename TriangulationType>
+  void
+  create_mesh (TriangulationType  &triangulation,
+               const unsigned int  degree,
+               const double        target_size)
+  {
+    std::vector<unsigned int> best_repetitions (dim, 1);
+    unsigned int best_refinements = 0;
+    double best_deviation = std::numeric_limits<double>::max();
+    for (unsigned int r0=1; r0<=3; ++r0)
+      for (unsigned int r1=1; r1<=r0; ++r1)
+        for (unsigned int r2=1; r2<=r1; ++r2)
+          for (unsigned int refinements=0; refinements<12; ++refinements)
+            {
+              const unsigned int repetitions[] = {r0, r1, r2};
+              double n_dofs = 1;
+              for (unsigned int d=0; d<dim; ++d)
+                n_dofs *= repetitions[d] * degree * (1U << refinements) + 1.;
+              const double deviation = std::abs(std::log(n_dofs/target_size));
+              if (deviation < best_deviation)
+                {
+                  best_deviation = deviation;
+                  best_repetitions.assign(repetitions, repetitions+dim);
+                  best_refinements = refinements;
+                }
+            }
+
+    Point<dim> upper_right;
+    for (unsigned int d=0; d<dim; ++d)
+      upper_right[d] = best_repetitions[d];
+    GridGenerator::subdivided_hyper_rectangle (triangulation, best_repetitions,
+                                               Point<dim>(), upper_right);
+    triangulation.refine_global (best_refinements);
+  }
+
+
+
+  // Measure the time for importing the ghost values and for sending the
+  // contributions to ghost entries back to their owners, i.e., the
+  // communication of one operator application, on the vector @p vec.
+  template <typename Number>
+  double
+  time_ghost_exchange (LinearAlgebra::distributed::Vector<Number> &vec,
+                       const MPI_Comm                              comm)
+  {
+    const unsigned int n_exchanges = 20;
+    Timer timer (comm, true);
+    for (unsigned int i=0; i<n_exchanges; ++i)
+      {
+        vec.update_ghost_values ();
+        vec.compress (VectorOperation::add);
+      }
+    timer.stop ();
+    return timer.wall_time() / n_exchanges;
+  }
+
+
+
+  template <int degree>
+  void
+  run (Performance::Benchmark &benchmark,
+       const double            target_size)
+  {
+    const MPI_Comm comm = MPI_COMM_WORLD;
+    ConditionalOStream pcout (std::cout, Utilities::MPI::this_mpi_process(comm) == 0);
+
+#ifdef DEAL_II_WITH_P4EST
+    parallel::distributed::Triangulation<dim>
+    triangulation (comm,
+                   Triangulation<dim>::limit_level_difference_at_vertices,
+                   parallel::distributed::Triangulation<dim>::construct_multigrid_hierarchy);
+#else
+    Triangulation<dim> triangulation (Triangulation<dim>::limit_level_difference_at_vertices);
+#endif
+
+    TimerOutput timer (comm, pcout, TimerOutput::never, TimerOutput::wall_times);
+
+    FE_Q<dim> fe (degree);
+    DoFHandler<dim> dof_handler (triangulation);
+    ConstraintMatrix constraints;
+    MGConstrainedDoFs mg_constrained_dofs;
+
+    typedef MatrixFreeOperators::LaplaceOperator<dim,degree,degree+1,1,VectorType> SystemMatrixType;
+    typedef MatrixFreeOperators::LaplaceOperator<dim,degree,degree+1,1,LevelVectorType> LevelMatrixType;
+    SystemMatrixType system_matrix;
+    MGLevelObject<LevelMatrixType> mg_matrices;
+    VectorType solution, system_rhs;
+
+    {
+      TimerOutput::Scope scope (timer, "setup");
+      create_mesh (triangulation, degree, target_size);
+      dof_handler.distribute_dofs (fe);
+      dof_handler.distribute_mg_dofs ();
+
+      IndexSet locally_relevant_dofs;
+      DoFTools::extract_locally_relevant_dofs (dof_handler, locally_relevant_dofs);
+      constraints.reinit (locally_relevant_dofs);
+      VectorTools::interpolate_boundary_values (dof_handler, 0,
+                                                Functions::ZeroFunction<dim>(),
+                                                constraints);
+      constraints.close ();
+
+      typename MatrixFree<dim,double>::AdditionalData additional_data;
+      additional_data.tasks_parallel_scheme = MatrixFree<dim,double>::AdditionalData::none;
+      additional_data.mapping_update_flags = update_gradients | update_JxW_values;
+      std::shared_ptr<MatrixFree<dim,double> > system_mf_storage (new MatrixFree<dim,double>());
+      system_mf_storage->reinit (dof_handler, constraints, QGauss<1>(degree+1),
+                                 additional_data);
+      system_matrix.initialize (system_mf_storage);
+      system_matrix.initialize_dof_vector (solution);
+      system_matrix.initialize_dof_vector (system_rhs);
+      system_rhs = 1.;
+      constraints.set_zero (system_rhs);
+
+      const unsigned int n_levels = triangulation.n_global_levels();
+      mg_matrices.resize (0, n_levels-1);
+      std::set<types::boundary_id> dirichlet_boundary;
+      dirichlet_boundary.insert (0);
+      mg_constrained_dofs.initialize (dof_handler);
+      mg_constrained_dofs.make_zero_boundary_constraints (dof_handler, dirichlet_boundary);
+      for (unsigned int level=0; level<n_levels; ++level)
+        {
+          IndexSet relevant_dofs;
+          DoFTools::extract_locally_relevant_level_dofs (dof_handler, level, relevant_dofs);
+          ConstraintMatrix level_constraints;
+          level_constraints.reinit (relevant_dofs);
+          level_constraints.add_lines (mg_constrained_dofs.get_boundary_indices(level));
+          level_constraints.close ();
+
+          typename MatrixFree<dim,float>::AdditionalData level_data;
+          level_data.tasks_parallel_scheme = MatrixFree<dim,float>::AdditionalData::none;
+          level_data.mapping_update_flags = update_gradients | update_JxW_values;
+          level_data.level_mg_handler = level;
+          std::shared_ptr<MatrixFree<dim,float> > mg_mf_storage_level (new MatrixFree<dim,float>());
+          mg_mf_storage_level->reinit (dof_handler, level_constraints,
+                                       QGauss<1>(degree+1), level_data);
+          mg_matrices[level].initialize (mg_mf_storage_level, mg_constrained_dofs, level);
+          mg_matrices[level].compute_diagonal ();
+        }
+    }
+
+    TimedTransfer mg_transfer (mg_constrained_dofs, timer);
+    typedef PreconditionChebyshev<LevelMatrixType,LevelVectorType> SmootherType;
+    mg::SmootherRelaxation<SmootherType, LevelVectorType> mg_smoother;
+    {
+      TimerOutput::Scope scope (timer, "setup");
+      mg_transfer.build (dof_handler);
+
+      MGLevelObject<typename SmootherType::AdditionalData> smoother_data;
+      smoother_data.resize (0, triangulation.n_global_levels()-1);
+      for (unsigned int level=0; level<triangulation.n_global_levels(); ++level)
+        {
+          if (level > 0)
+            {
+              smoother_data[level].smoothing_range = 15.;
+              smoother_data[level].degree = 5;
+              smoother_data[level].eig_cg_n_iterations = 10;
+            }
+          else
+            {
+              smoother_data[0].smoothing_range = 1e-3;
+              smoother_data[0].degree = numbers::invalid_unsigned_int;
+              smoother_data[0].eig_cg_n_iterations = mg_matrices[0].m();
+            }
+          smoother_data[level].preconditioner = mg_matrices[level].get_matrix_diagonal_inverse();
+        }
+      mg_smoother.initialize (mg_matrices, smoother_data);
+    }
+
+    MGCoarseGridApplySmoother<LevelVectorType> mg_coarse;
+    mg_coarse.initialize (mg_smoother);
+    mg::Matrix<LevelVectorType> mg_matrix (mg_matrices);
+
+    TimedLevelMatrix timed_mg_matrix (mg_matrix, timer);
+    TimedSmoother timed_smoother (mg_smoother, timer);
+    TimedCoarseSolver timed_coarse (mg_coarse, timer);
+    Multigrid<LevelVectorType> mg (timed_mg_matrix, timed_coarse, mg_transfer,
+                                   timed_smoother, timed_smoother);
+    PreconditionMG<dim, LevelVectorType, TimedTransfer>
+    preconditioner (dof_handler, mg, mg_transfer);
+
+    TimedOperator<SystemMatrixType> timed_system_matrix (system_matrix, timer);
+    SolverControl solver_control (200, 1e-10*system_rhs.l2_norm());
+    SolverCG<VectorType> cg (solver_control);
+
+    const unsigned int n_processes = Utilities::MPI::n_mpi_processes(comm);
+    pcout << "Degree " << degree << ": " << dof_handler.n_dofs() << " DoFs, "
+          << triangulation.n_global_active_cells() << " cells, "
+          << triangulation.n_global_levels() << " levels, "
+          << n_processes << " processes" << std::endl;
+
+    const std::string name = "degree_" + Utilities::int_to_string(degree);
+    benchmark.add_parameter (name + "_n_dofs", dof_handler.n_dofs());
+    benchmark.add_parameter (name + "_n_levels", triangulation.n_global_levels());
+    benchmark.measure (name, [&] ()
+    {
+      solution = 0;
+    },
+    [&] ()
+    {
+      TimerOutput::Scope scope (timer, "solve");
+      cg.solve (timed_system_matrix, solution, system_rhs, preconditioner);
+    },
+    0, static_cast<double>(dof_handler.n_dofs()) / n_processes);
+    benchmark.add_parameter (name + "_iterations", solver_control.last_step());
+
+    pcout << "Accumulated times over all solves, including the warm-up:" << std::endl;
+    timer.print_wall_time_statistics (comm);
+
+    // the communication is hidden in the operator evaluation, so measure it
+    // separately for each level
+    pcout << "Time for the ghost exchange of one operator application:" << std::endl;
+    pcout << "  fine: " << time_ghost_exchange (solution, comm) << "s" << std::endl;
+    for (unsigned int level=mg_matrices.max_level()+1; level-- > mg_matrices.min_level(); )
+      {
+        LevelVectorType vec;
+        mg_matrices[level].initialize_dof_vector (vec);
+        pcout << "  level " << level << ": " << time_ghost_exchange (vec, comm)
+              << "s" << std::endl;
+      }
+    pcout << std::endl;
+  }
+}
+
+
+
+int main (int argc, char **argv)
+{
+  try
+    {
+      Utilities::MPI::MPI_InitFinalize mpi_init (argc, argv, 1);
+
+      std::vector<std::string> options;
+      options.push_back ("mode");
+      options.push_back ("size");
+      options.push_back ("degrees");
+      Performance::Benchmark benchmark ("poisson_scaling", argc, argv, options);
+      benchmark.set_communicator (MPI_COMM_WORLD);
+
+      const std::string mode = benchmark.get_option ("mode", "weak");
+      AssertThrow (mode == "weak" || mode == "strong",
+                   ExcMessage ("The option --mode must be either weak or strong"));
+      const double size = Utilities::string_to_double (benchmark.get_option ("size", "200000"));
+      const std::vector<int> degrees =
+        Utilities::string_to_int (Utilities::split_string_list (benchmark.get_option ("degrees",
+                                  "1,2,3,4,5,6,7,8")));
+
+      const unsigned int n_processes = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+      const double target_size = (mode == "weak") ? size * n_processes : size;
+      benchmark.add_parameter ("dim", PoissonScaling::dim);
+      benchmark.add_parameter ("n_processes", n_processes);
+      benchmark.add_parameter ("weak_scaling", mode == "weak" ? 1 : 0);
+      benchmark.add_parameter ("target_size", target_size);
+
+      for (unsigned int i=0; i<degrees.size(); ++i)
+        switch (degrees[i])
+          {
+          case 1:
+            PoissonScaling::run<1> (benchmark, target_size);
+            break;
+          case 2:
+            PoissonScaling::run<2> (benchmark, target_size);
+            break;
+          case 3:
+            PoissonScaling::run<3> (benchmark, target_size);
+            break;
+          case 4:
+            PoissonScaling::run<4> (benchmark, target_size);
+            break;
+          case 5:
+            PoissonScaling::run<5> (benchmark, target_size);
+            break;
+          case 6:
+            PoissonScaling::run<6> (benchmark, target_size);
+            break;
+          case 7:
+            PoissonScaling::run<7> (benchmark, target_size);
+            break;
+          case 8:
+            PoissonScaling::run<8> (benchmark, target_size);
+            break;
+          default:
+            AssertThrow (false, ExcMessage ("Only degrees between 1 and 8 are supported"));
+          }
+    }
+  catch (std::exception &exc)
+    {
+      std::cerr << std::endl << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      std::cerr << "Exception on processing: " << std::endl
+                << exc.what() << std::endl
+                << "Aborting!" << std::endl
+                << "----------------------------------------------------"
+                << std::endl;
+      return 1;
+    }
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// Benchmark Triangulation::execute_coarsening_and_refinement: global
+// refinement through refinement flags, adaptive refinement of a part of the
+// cells, and coarsening of all cells of the finest level, in 3D
+
+#include "performance_test.h"
+
+#include <deal.II/base/point.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+
+using namespace dealii;
+
+const unsigned int dim = 3;
+
+
+int main (int argc, char **argv)
+{
+  Performance::Benchmark benchmark ("refinement", argc, argv);
+
+  const unsigned int n_refinements = 4;
+  benchmark.add_parameter("dim", dim);
+  benchmark.add_parameter("refinements", n_refinements);
+
+  Triangulation<dim> triangulation (Triangulation<dim>::limit_level_difference_at_vertices);
+
+  const auto reset = [&] ()
+  {
+    triangulation.clear ();
+    GridGenerator::hyper_cube (triangulation);
+    triangulation.refine_global (n_refinements);
+  };
+
+  benchmark.measure ("refine_all", [&] ()
+  {
+    reset ();
+    triangulation.set_all_refine_flags ();
+  },
+  [&] ()
+  {
+    triangulation.execute_coarsening_and_refinement ();
+  });
+
+  // refine the cells within a ball, which requires the smoothing of the mesh
+  benchmark.measure ("refine_adaptive", [&] ()
+  {
+    reset ();
+    for (Triangulation<dim>::active_cell_iterator
+         cell=triangulation.begin_active(); cell!=triangulation.end(); ++cell)
+      if (cell->center().norm() < 0.6)
+        cell->set_refine_flag ();
+  },
+  [&] ()
+  {
+    triangulation.execute_coarsening_and_refinement ();
+  });
+
+  benchmark.measure ("coarsen_all", [&] ()
+  {
+    reset ();
+    triangulation.refine_global (1);
+    for (Triangulation<dim>::active_cell_iterator
+         cell=triangulation.begin_active(); cell!=triangulation.end(); ++cell)
+      cell->set_coarsen_flag ();
+  },
+  [&] ()
+  {
+    triangulation.execute_coarsening_and_refinement ();
+  });
+
+  benchmark.add_parameter("n_cells", triangulation.n_active_cells());
+}
@@ -0,0 +1,80 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+// Benchmark SparseMatrix::vmult for the sparsity pattern of a Q2 element on
+// a uniformly refined cube in 3D
+
+#include "performance_test.h"
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+using namespace dealii;
+
+
+int main (int argc, char **argv)
+{
+  Performance::Benchmark benchmark ("sparse_matrix_vmult", argc, argv);
+
+  const unsigned int dim = 3;
+  const unsigned int degree = 2;
+  const unsigned int n_refinements = 4;
+  benchmark.add_parameter("dim", dim);
+  benchmark.add_parameter("degree", degree);
+  benchmark.add_parameter("refinements", n_refinements);
+
+  Triangulation<dim> triangulation;
+  GridGenerator::hyper_cube (triangulation);
+  triangulation.refine_global (n_refinements);
+
+  FE_Q<dim> fe (degree);
+  DoFHandler<dim> dof_handler (triangulation);
+  dof_handler.distribute_dofs (fe);
+
+  DynamicSparsityPattern dsp (dof_handler.n_dofs());
+  DoFTools::make_sparsity_pattern (dof_handler, dsp);
+  SparsityPattern sparsity;
+  sparsity.copy_from (dsp);
+
+  SparseMatrix<double> matrix (sparsity);
+  for (SparseMatrix<double>::size_type row=0; row<matrix.m(); ++row)
+    for (SparseMatrix<double>::iterator it=matrix.begin(row); it!=matrix.end(row); ++it)
+      it->value() = (it->column() == row) ? 8. : -1./(1.+row%7);
+
+  Vector<double> src (dof_handler.n_dofs()), dst (dof_handler.n_dofs());
+  for (unsigned int i=0; i<src.size(); ++i)
+    src(i) = 1. + i%13;
+
+  benchmark.add_parameter("n_dofs", dof_handler.n_dofs());
+  benchmark.add_parameter("n_nonzeros", matrix.n_nonzero_elements());
+
+  // matrix values and column indices, row starts, and the two vectors
+  const double bytes = matrix.n_nonzero_elements() * (sizeof(double) + sizeof(unsigned int))
+                       + (matrix.m()+1) * sizeof(std::size_t)
+                       + 2. * src.size() * sizeof(double);
+  benchmark.measure ("vmult", [&] ()
+  {
+    for (unsigned int i=0; i<10; ++i)
+      matrix.vmult (dst, src);
+  },
+  10*bytes, 10.*dof_handler.n_dofs());
+}
@@ -0,0 +1,39 @@
+## ---------------------------------------------------------------------
+##
+## Copyright (C) 2013 - 2017 by the deal.II authors
+##
+## This file is part of the deal.II library.
+##
+## The deal.II library is free software; you can use it, redistribute
+## it, and/or modify it under the terms of the GNU Lesser General
+## Public License as published by the Free Software Foundation; either
+## version 2.1 of the License, or (at your option) any later version.
+## The full text of the license can be found in the file LICENSE at
+## the top level of the deal.II distribution.
+##
+## ---------------------------------------------------------------------
+
+#
+# Common setup of the testsuite subprojects. Every tests/<category>
+# directory contains a CMakeLists.txt file of the form
+#
+#   CMAKE_MINIMUM_REQUIRED(VERSION 2.8.12)
+#   INCLUDE(../setup_testsubproject.cmake)
+#   PROJECT(testsuite CXX)
+#   DEAL_II_PICKUP_TESTS()
+#
+# that is configured by the setup_tests target of the toplevel testsuite.
+#
+
+FIND_PACKAGE(deal.II 9.0.0 REQUIRED HINTS ${DEAL_II_DIR} $ENV{DEAL_II_DIR})
+
+SET(CMAKE_CXX_COMPILER ${DEAL_II_CXX_COMPILER} CACHE STRING "CXX Compiler.")
+
+#
+# Silence the output of the build of the tests, the results are reported
+# by the run and diff stages of run_test.cmake:
+#
+SET_PROPERTY(GLOBAL PROPERTY RULE_MESSAGES OFF)
+SET_PROPERTY(GLOBAL PROPERTY TARGET_MESSAGES OFF)
+
+SET(CMAKE_BUILD_TYPE ${DEAL_II_BUILD_TYPE} CACHE STRING "" FORCE)
@@ -0,0 +1,171 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2004 - 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_tests_h
+#define dealii_tests_h
+
+// common definitions used in all the tests
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/utilities.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+
+// implicitly use the deal.II namespace everywhere, without us having to say
+// so in each and every testcase
+using namespace dealii;
+
+
+// The output of the tests is compared with numdiff against the .output
+// files in the source directory. Suppress numbers that are zero up to
+// round-off before printing them, such that the output does not depend on
+// the compiler and the processor.
+inline
+double
+filter_out_small_numbers (const double number,
+                          const double tolerance = 1e-10)
+{
+  if (std::abs(number) < tolerance)
+    return 0.;
+  else
+    return number;
+}
+
+
+
+// Return whether a and b agree up to the given relative tolerance.
+inline
+bool
+numbers_are_close (const double a,
+                   const double b,
+                   const double tolerance = 1e-12)
+{
+  return std::abs(a-b) <= tolerance * std::max(1., std::max(std::abs(a),
+                                                             std::abs(b)));
+}
+
+
+
+// Check that the number of iterations of a solver lies within a given
+// range instead of printing the number itself, since the iteration count
+// of many preconditioners varies slightly between platforms.
+#define check_solver_within_range(SOLVER_COMMAND, CONTROL_COMMAND, MIN_ALLOWED, MAX_ALLOWED) \
+  {                                                                              \
+    const unsigned int previous_depth = deallog.depth_file(0);                   \
+    try                                                                          \
+      {                                                                          \
+        SOLVER_COMMAND;                                                          \
+      }                                                                          \
+    catch (SolverControl::NoConvergence &exc)                                    \
+      {}                                                                         \
+    deallog.depth_file(previous_depth);                                          \
+    const unsigned int steps = CONTROL_COMMAND;                                  \
+    if (steps >= MIN_ALLOWED && steps <= MAX_ALLOWED)                            \
+      {                                                                          \
+        deallog << "Solver stopped within " << MIN_ALLOWED << " - "              \
+                << MAX_ALLOWED << " iterations" << std::endl;                    \
+      }                                                                          \
+    else                                                                         \
+      {                                                                          \
+        deallog << "Solver stopped after " << steps << " iterations"             \
+                << std::endl;                                                    \
+      }                                                                          \
+  }
+
+
+
+// Every test writes its result to the file "output" in the directory it is
+// run in, which is then compared against the .output file of the test by
+// run_test.cmake.
+std::ofstream deallogfile;
+std::string deallogname;
+
+inline
+void
+initlog (const bool console = false)
+{
+  deallogname = "output";
+  deallogfile.open(deallogname.c_str());
+  deallog.attach(deallogfile, false);
+  deallog.depth_console(console ? 10 : 0);
+  deal_II_exceptions::suppress_stacktrace_in_exceptions();
+}
+
+
+
+// For tests running on several MPI processes, only the first process writes
+// to the output file, unless @p all_processes is set. The output of the
+// other processes is written to the files "output.<rank>", of which
+// run_test.cmake only collects the one of the first process.
+inline
+void
+mpi_initlog (const bool console = false,
+             const bool all_processes = false)
+{
+#ifdef DEAL_II_WITH_MPI
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  if (myid == 0 || all_processes)
+    {
+      deallogname = (myid == 0 ?
+                     std::string("output") :
+                     "output." + Utilities::int_to_string(myid));
+      deallogfile.open(deallogname.c_str());
+      deallog.attach(deallogfile, false);
+      deallog.depth_console(console ? 10 : 0);
+    }
+  deal_II_exceptions::suppress_stacktrace_in_exceptions();
+#else
+  (void)all_processes;
+  // can't use this initialization without MPI
+  (void)console;
+  Assert(false, ExcInternalError());
+#endif
+}
+
+
+
+// Helper object that sets up the log file for MPI tests and, on
+// destruction, prints "OK" on all processes that write to a file. Use it
+// as
+//   Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+//   MPILogInitAll log;
+struct MPILogInitAll
+{
+  MPILogInitAll (const bool console = false)
+  {
+    mpi_initlog(console);
+  }
+
+  ~MPILogInitAll ()
+  {
+    if (deallogfile.is_open())
+      deallog << "OK" << std::endl;
+  }
+};
+
+
+
+#endif // dealii_tests_h
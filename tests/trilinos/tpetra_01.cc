@@ -0,0 +1,124 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check the vector operations of LinearAlgebra::TpetraWrappers::Vector, the
+// import into a ReadWriteVector with ghost entries, and the assembly and the
+// matrix-vector products of LinearAlgebra::TpetraWrappers::SparseMatrix for
+// the 1D Laplacian assembled element by element, such that the elements on
+// the interface between two processors add to rows owned by the neighbor
+
+#include "../tests.h"
+#include <deal.II/base/index_set.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/read_write_vector.h>
+#include <deal.II/lac/trilinos_tpetra_sparse_matrix.h>
+#include <deal.II/lac/trilinos_tpetra_vector.h>
+
+
+void test ()
+{
+  const unsigned int n = 100;
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+  const unsigned int my_id = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const unsigned int begin = my_id * n / n_procs, end = (my_id+1) * n / n_procs;
+  IndexSet locally_owned (n);
+  locally_owned.add_range (begin, end);
+
+  // vector with entries i+1
+  LinearAlgebra::ReadWriteVector<double> read_write (locally_owned);
+  for (unsigned int i=begin; i<end; ++i)
+    read_write(i) = i+1.;
+  LinearAlgebra::TpetraWrappers::Vector<double> v (locally_owned, MPI_COMM_WORLD);
+  v.import (read_write, VectorOperation::insert);
+  deallog << "size: " << v.size() << std::endl;
+  deallog << "l1 norm: " << v.l1_norm() << std::endl;
+  deallog << "l2 norm: " << v.l2_norm() << std::endl;
+  deallog << "linfty norm: " << v.linfty_norm() << std::endl;
+  deallog << "mean value: " << v.mean_value() << std::endl;
+  deallog << "v*v: " << v*v << std::endl;
+
+  LinearAlgebra::TpetraWrappers::Vector<double> w (v);
+  w *= 2.;
+  w.add (-1., v);
+  w -= v;
+  deallog << "2v-v-v is zero: " << (w.all_zero() ? "true" : "false") << std::endl;
+  w.sadd (3., 2., v);
+  deallog << "2v: l2 norm " << w.l2_norm() << std::endl;
+  deallog << "add_and_dot: " << w.add_and_dot (-1., v, v) << std::endl;
+
+  // import the owned entries and the first entry of the next processor
+  IndexSet relevant (locally_owned);
+  relevant.add_index ((end) % n);
+  LinearAlgebra::ReadWriteVector<double> ghosted (relevant);
+  ghosted.import (v, VectorOperation::insert);
+  bool ghosts_ok = true;
+  for (IndexSet::ElementIterator i=relevant.begin(); i!=relevant.end(); ++i)
+    if (ghosted(*i) != *i+1.)
+      ghosts_ok = false;
+  deallog << "import with ghost entries: "
+          << (Utilities::MPI::min (int(ghosts_ok), MPI_COMM_WORLD) ? "OK" : "FAILED")
+          << std::endl;
+
+  // assemble the Laplacian with Dirichlet conditions from the elements
+  // [i,i+1] whose first vertex is locally owned
+  DynamicSparsityPattern dsp (n, n);
+  for (unsigned int i=0; i<n; ++i)
+    for (unsigned int j=(i>0 ? i-1 : 0); j<std::min(n, i+2); ++j)
+      dsp.add (i, j);
+  LinearAlgebra::TpetraWrappers::SparseMatrix<double> matrix (locally_owned,
+                                                              locally_owned,
+                                                              dsp,
+                                                              MPI_COMM_WORLD);
+  for (unsigned int i=begin; i<std::min(end, n-1); ++i)
+    {
+      const types::global_dof_index indices[2] = {i, i+1};
+      const double values[2][2] = {{1., -1.}, {-1., 1.}};
+      for (unsigned int r=0; r<2; ++r)
+        matrix.add (indices[r], 2, indices, values[r]);
+    }
+  if (begin == 0)
+    matrix.add (0, 0, 1.);
+  if (end == n)
+    matrix.add (n-1, n-1, 1.);
+  matrix.compress (VectorOperation::add);
+
+  deallog << "matrix size: " << matrix.m() << " x " << matrix.n()
+          << ", nonzero elements: " << matrix.n_nonzero_elements() << std::endl;
+  deallog << "frobenius norm: " << matrix.frobenius_norm() << std::endl;
+
+  // the product of the linear vector is nonzero only in the last row
+  LinearAlgebra::TpetraWrappers::Vector<double> result (locally_owned,
+                                                        MPI_COMM_WORLD);
+  matrix.vmult (result, v);
+  deallog << "vmult: l2 norm " << result.l2_norm()
+          << ", l1 norm " << result.l1_norm() << std::endl;
+  matrix.Tvmult_add (result, v);
+  deallog << "Tvmult_add: l2 norm " << result.l2_norm() << std::endl;
+  matrix.Tvmult (result, v);
+  matrix.vmult_add (result, v);
+  deallog << "vmult_add: l2 norm " << result.l2_norm() << std::endl;
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  MPILogInitAll log;
+
+  test ();
+}